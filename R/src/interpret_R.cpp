@@ -408,6 +408,102 @@ bool ConvertDoublesToDoubles(const SEXP items, size_t * const pcItems, const Flo
    return false;
 }
 
+bool ConvertBinnedDataToColumns(
+   const SEXP binnedData, 
+   const size_t cFeatures, 
+   const size_t cSamples, 
+   const EbmNativeBinnedColumn * * const pRet
+) {
+   // R keeps a matrix column by column, so the bins of each feature are cSamples consecutive items.  Integer and raw 
+   // vectors are described to ebm_native in place as 4 and 1 byte unsigned bins, which avoids converting and copying 
+   // the whole matrix.  Negative integers, including NA, read as unsigned values that are larger than any bin count, 
+   // so ebm_native rejects them.  Doubles have no bin format in ebm_native, so we convert those to IntEbmType
+   EBM_ASSERT(nullptr != binnedData);
+   EBM_ASSERT(nullptr != pRet);
+
+   const char * pData;
+   size_t cBytesPerBin;
+   const int type = TYPEOF(binnedData);
+   if(INTSXP == type) {
+      static_assert(sizeof(int) == sizeof(uint32_t), "R integers need to be 4 bytes for ebm_native to read them in place");
+      pData = reinterpret_cast<const char *>(INTEGER(binnedData));
+      cBytesPerBin = sizeof(int);
+   } else if(RAWSXP == type) {
+      pData = reinterpret_cast<const char *>(RAW(binnedData));
+      cBytesPerBin = sizeof(Rbyte);
+   } else {
+      size_t cItems;
+      const IntEbmType * aItems;
+      if(ConvertDoublesToIndexes(binnedData, &cItems, &aItems)) {
+         // we've already logged any errors
+         return true;
+      }
+      pData = reinterpret_cast<const char *>(aItems);
+      cBytesPerBin = sizeof(IntEbmType);
+   }
+
+   const R_xlen_t countItemsR = xlength(binnedData);
+   if(!IsNumberConvertable<size_t, R_xlen_t>(countItemsR)) {
+      LOG_0(TraceLevelError, "ERROR ConvertBinnedDataToColumns !IsNumberConvertable<size_t, R_xlen_t>(countItemsR)");
+      return true;
+   }
+   if(IsMultiplyError(cSamples, cFeatures)) {
+      LOG_0(TraceLevelError, "ERROR ConvertBinnedDataToColumns IsMultiplyError(cSamples, cFeatures)");
+      return true;
+   }
+   if(cSamples * cFeatures != static_cast<size_t>(countItemsR)) {
+      LOG_0(TraceLevelError, "ERROR ConvertBinnedDataToColumns cSamples * cFeatures != countItemsR");
+      return true;
+   }
+
+   EbmNativeBinnedColumn * aColumns = nullptr;
+   if(0 != cSamples && 0 != cFeatures) {
+      aColumns = reinterpret_cast<EbmNativeBinnedColumn *>(R_alloc(cFeatures, static_cast<int>(sizeof(EbmNativeBinnedColumn))));
+      // R_alloc doesn't return nullptr, so we don't need to check aColumns
+      const size_t cBytesColumn = cSamples * cBytesPerBin;
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         aColumns[iFeature].data = pData + iFeature * cBytesColumn;
+         aColumns[iFeature].countBytesPerBin = static_cast<IntEbmType>(cBytesPerBin);
+         aColumns[iFeature].countBytesStride = static_cast<IntEbmType>(cBytesPerBin);
+      }
+   }
+   *pRet = aColumns;
+   return false;
+}
+
+bool PackBinnedColumns(
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const aFeatures,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const aFeatureGroups,
+   const IntEbmType * const aFeatureGroupIndexes,
+   const IntEbmType countSamples,
+   const EbmNativeBinnedColumn * const aColumns,
+   PEbmPackedData * const pRet
+) {
+   // the booster reads the packed data in place, so the columns never get widened into an IntEbmType matrix.  A data 
+   // set without samples has nothing to pack, and the booster accepts nullptr for it
+   EBM_ASSERT(nullptr != pRet);
+   PEbmPackedData packedData = nullptr;
+   if(0 != countSamples) {
+      packedData = CreatePackedDataFromColumns(
+         countFeatures, 
+         aFeatures, 
+         countFeatureGroups, 
+         aFeatureGroups, 
+         aFeatureGroupIndexes, 
+         countSamples, 
+         aColumns
+      );
+      if(nullptr == packedData) {
+         // ebm_native has already logged any errors
+         return true;
+      }
+   }
+   *pRet = packedData;
+   return false;
+}
+
 SEXP InitializeBoostingClassification_R(
    SEXP countTargetClasses,
    SEXP features,
@@ -485,13 +581,6 @@ SEXP InitializeBoostingClassification_R(
       return R_NilValue;
    }
 
-   size_t cTrainingBinnedData;
-   const IntEbmType * aTrainingBinnedData;
-   if(ConvertDoublesToIndexes(trainingBinnedData, &cTrainingBinnedData, &aTrainingBinnedData)) {
-      // we've already logged any errors
-      return R_NilValue;
-   }
-
    size_t cTrainingSamples;
    const IntEbmType * aTrainingTargets;
    if(ConvertDoublesToIndexes(trainingTargets, &cTrainingSamples, &aTrainingTargets)) {
@@ -500,12 +589,9 @@ SEXP InitializeBoostingClassification_R(
    }
    const IntEbmType countTrainingSamples = static_cast<IntEbmType>(cTrainingSamples);
 
-   if(IsMultiplyError(cTrainingSamples, cFeatures)) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassification_R IsMultiplyError(cTrainingSamples, cFeatures)");
-      return R_NilValue;
-   }
-   if(cTrainingSamples * cFeatures != cTrainingBinnedData) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassification_R cTrainingSamples * cFeatures != cTrainingBinnedData");
+   const EbmNativeBinnedColumn * aTrainingColumns;
+   if(ConvertBinnedDataToColumns(trainingBinnedData, cFeatures, cTrainingSamples, &aTrainingColumns)) {
+      // we've already logged any errors
       return R_NilValue;
    }
 
@@ -524,13 +610,6 @@ SEXP InitializeBoostingClassification_R(
       return R_NilValue;
    }
 
-   size_t cValidationBinnedData;
-   const IntEbmType * aValidationBinnedData;
-   if(ConvertDoublesToIndexes(validationBinnedData, &cValidationBinnedData, &aValidationBinnedData)) {
-      // we've already logged any errors
-      return R_NilValue;
-   }
-
    size_t cValidationSamples;
    const IntEbmType * aValidationTargets;
    if(ConvertDoublesToIndexes(validationTargets, &cValidationSamples, &aValidationTargets)) {
@@ -539,12 +618,9 @@ SEXP InitializeBoostingClassification_R(
    }
    const IntEbmType countValidationSamples = static_cast<IntEbmType>(cValidationSamples);
 
-   if(IsMultiplyError(cValidationSamples, cFeatures)) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassification_R IsMultiplyError(cValidationSamples, cFeatures)");
-      return R_NilValue;
-   }
-   if(cValidationSamples * cFeatures != cValidationBinnedData) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassification_R cValidationSamples * cFeatures != cValidationBinnedData");
+   const EbmNativeBinnedColumn * aValidationColumns;
+   if(ConvertBinnedDataToColumns(validationBinnedData, cFeatures, cValidationSamples, &aValidationColumns)) {
+      // we've already logged any errors
       return R_NilValue;
    }
 
@@ -582,7 +658,23 @@ SEXP InitializeBoostingClassification_R(
    // Casting to unsigned avoids undefined behavior issues with casting between signed values.  
    const IntEbmType randomSeedLocal = static_cast<IntEbmType>(static_cast<unsigned int>(INTEGER(randomSeed)[0]));
 
-   PEbmBoosting pEbmBoosting = InitializeBoostingClassification(
+   PEbmPackedData trainingPackedData;
+   if(PackBinnedColumns(countFeatures, aFeatures, countFeatureGroups, aFeatureGroups, aFeatureGroupIndexes, 
+      countTrainingSamples, aTrainingColumns, &trainingPackedData)) 
+   {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   PEbmPackedData validationPackedData;
+   if(PackBinnedColumns(countFeatures, aFeatures, countFeatureGroups, aFeatureGroups, aFeatureGroupIndexes, 
+      countValidationSamples, aValidationColumns, &validationPackedData)) 
+   {
+      // we've already logged any errors
+      ClosePackedData(trainingPackedData);
+      return R_NilValue;
+   }
+
+   PEbmBoosting pEbmBoosting = InitializeBoostingClassificationPacked(
       static_cast<IntEbmType>(cTargetClasses), 
       countFeatures, 
       aFeatures, 
@@ -590,16 +682,22 @@ SEXP InitializeBoostingClassification_R(
       aFeatureGroups, 
       aFeatureGroupIndexes, 
       countTrainingSamples, 
-      aTrainingBinnedData, 
+      trainingPackedData, 
+      nullptr, 
       aTrainingTargets, 
       aTrainingPredictorScores, 
       countValidationSamples, 
-      aValidationBinnedData, 
+      validationPackedData, 
+      nullptr, 
       aValidationTargets, 
       aValidationPredictorScores, 
       countInnerBagsLocal, 
-      randomSeedLocal
+      randomSeedLocal, 
+      nullptr
    );
+   // the booster holds its own references to the packed data, so we can let go of ours whether or not it succeeded
+   ClosePackedData(validationPackedData);
+   ClosePackedData(trainingPackedData);
 
    if(nullptr == pEbmBoosting) {
       return R_NilValue;
@@ -673,13 +771,6 @@ SEXP InitializeBoostingRegression_R(
       return R_NilValue;
    }
 
-   size_t cTrainingBinnedData;
-   const IntEbmType * aTrainingBinnedData;
-   if(ConvertDoublesToIndexes(trainingBinnedData, &cTrainingBinnedData, &aTrainingBinnedData)) {
-      // we've already logged any errors
-      return R_NilValue;
-   }
-
    size_t cTrainingSamples;
    const FloatEbmType * aTrainingTargets;
    if(ConvertDoublesToDoubles(trainingTargets, &cTrainingSamples, &aTrainingTargets)) {
@@ -688,12 +779,9 @@ SEXP InitializeBoostingRegression_R(
    }
    const IntEbmType countTrainingSamples = static_cast<IntEbmType>(cTrainingSamples);
 
-   if(IsMultiplyError(cTrainingSamples, cFeatures)) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingRegression_R IsMultiplyError(cTrainingSamples, cFeatures)");
-      return R_NilValue;
-   }
-   if(cTrainingSamples * cFeatures != cTrainingBinnedData) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingRegression_R cTrainingSamples * cFeatures != cTrainingBinnedData");
+   const EbmNativeBinnedColumn * aTrainingColumns;
+   if(ConvertBinnedDataToColumns(trainingBinnedData, cFeatures, cTrainingSamples, &aTrainingColumns)) {
+      // we've already logged any errors
       return R_NilValue;
    }
 
@@ -708,13 +796,6 @@ SEXP InitializeBoostingRegression_R(
       return R_NilValue;
    }
 
-   size_t cValidationBinnedData;
-   const IntEbmType * aValidationBinnedData;
-   if(ConvertDoublesToIndexes(validationBinnedData, &cValidationBinnedData, &aValidationBinnedData)) {
-      // we've already logged any errors
-      return R_NilValue;
-   }
-
    size_t cValidationSamples;
    const FloatEbmType * aValidationTargets;
    if(ConvertDoublesToDoubles(validationTargets, &cValidationSamples, &aValidationTargets)) {
@@ -723,12 +804,9 @@ SEXP InitializeBoostingRegression_R(
    }
    const IntEbmType countValidationSamples = static_cast<IntEbmType>(cValidationSamples);
 
-   if(IsMultiplyError(cValidationSamples, cFeatures)) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingRegression_R IsMultiplyError(cValidationSamples, cFeatures)");
-      return R_NilValue;
-   }
-   if(cValidationSamples * cFeatures != cValidationBinnedData) {
-      LOG_0(TraceLevelError, "ERROR InitializeBoostingRegression_R cValidationSamples * cFeatures != cValidationBinnedData");
+   const EbmNativeBinnedColumn * aValidationColumns;
+   if(ConvertBinnedDataToColumns(validationBinnedData, cFeatures, cValidationSamples, &aValidationColumns)) {
+      // we've already logged any errors
       return R_NilValue;
    }
 
@@ -762,23 +840,45 @@ SEXP InitializeBoostingRegression_R(
    // Casting to unsigned avoids undefined behavior issues with casting between signed values.  
    const IntEbmType randomSeedLocal = static_cast<IntEbmType>(static_cast<unsigned int>(INTEGER(randomSeed)[0]));
 
-   PEbmBoosting pEbmBoosting = InitializeBoostingRegression(
+   PEbmPackedData trainingPackedData;
+   if(PackBinnedColumns(countFeatures, aFeatures, countFeatureGroups, aFeatureGroups, aFeatureGroupIndexes, 
+      countTrainingSamples, aTrainingColumns, &trainingPackedData)) 
+   {
+      // we've already logged any errors
+      return R_NilValue;
+   }
+   PEbmPackedData validationPackedData;
+   if(PackBinnedColumns(countFeatures, aFeatures, countFeatureGroups, aFeatureGroups, aFeatureGroupIndexes, 
+      countValidationSamples, aValidationColumns, &validationPackedData)) 
+   {
+      // we've already logged any errors
+      ClosePackedData(trainingPackedData);
+      return R_NilValue;
+   }
+
+   PEbmBoosting pEbmBoosting = InitializeBoostingRegressionPacked(
       countFeatures, 
       aFeatures, 
       countFeatureGroups, 
       aFeatureGroups, 
       aFeatureGroupIndexes, 
       countTrainingSamples, 
-      aTrainingBinnedData, 
+      trainingPackedData, 
+      nullptr, 
       aTrainingTargets, 
       aTrainingPredictorScores, 
       countValidationSamples, 
-      aValidationBinnedData, 
+      validationPackedData, 
+      nullptr, 
       aValidationTargets, 
       aValidationPredictorScores, 
       countInnerBagsLocal, 
-      randomSeedLocal
+      randomSeedLocal, 
+      nullptr
    );
+   // the booster holds its own references to the packed data, so we can let go of ours whether or not it succeeded
+   ClosePackedData(validationPackedData);
+   ClosePackedData(trainingPackedData);
 
    if(nullptr == pEbmBoosting) {
       return R_NilValue;
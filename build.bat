@@ -7,10 +7,14 @@ REM Visual Studio Community can be downloaded for free here:  https://visualstud
 SET root_path=%~dp0
 
 SET build_32_bit=0
+SET run_bench=0
 for %%x in (%*) do (
    IF "%%x"=="-32bit" (
       SET build_32_bit=1
    )
+   IF "%%x"=="-bench" (
+      SET run_bench=1
+   )
 )
 
 MSBuild.exe "%root_path%shared\ebm_native\ebm_native.vcxproj" /p:Configuration=Release /p:Platform=x64 /p:EnableClangTidyCodeAnalysis=True /p:RunCodeAnalysis=True
@@ -36,4 +40,13 @@ IF %build_32_bit% EQU 1 (
    )
 )
 
+IF %run_bench% EQU 1 (
+   REM the results are one JSON object per line, which we keep so they can be compared against the previous release
+   CALL "%root_path%shared\ebm_native\ebm_native_bench\ebm_native_bench.bat" -nobuildebmnative -output "%root_path%tmp\ebm_native_bench.json"
+   IF ERRORLEVEL 1 (
+      ECHO ebm_native_bench returned an error
+      EXIT /B 1
+   )
+)
+
 EXIT /B 0
@@ -47,31 +47,40 @@ python_lib="$root_path/python/interpret-core/interpret/lib"
 staging_path="$root_path/staging"
 
 build_32_bit=0
+run_bench=0
 for arg in "$@"; do
    if [ "$arg" = "-32bit" ]; then
       build_32_bit=1
    fi
+   if [ "$arg" = "-bench" ]; then
+      run_bench=1
+   fi
 done
 
 # re-enable these warnings when they are better supported by g++ or clang: -Wduplicated-cond -Wduplicated-branches -Wrestrict
 compile_all=""
+compile_all="$compile_all \"$src_path/AlignedMemory.cpp\""
 compile_all="$compile_all \"$src_path/ApplyModelUpdate.cpp\""
 compile_all="$compile_all \"$src_path/ApplyModelUpdateTraining.cpp\""
 compile_all="$compile_all \"$src_path/ApplyModelUpdateValidation.cpp\""
 compile_all="$compile_all \"$src_path/BinBoosting.cpp\""
 compile_all="$compile_all \"$src_path/BinInteraction.cpp\""
+compile_all="$compile_all \"$src_path/BinningFeatures.cpp\""
 compile_all="$compile_all \"$src_path/BinningQuantile.cpp\""
 compile_all="$compile_all \"$src_path/BinningUniform.cpp\""
 compile_all="$compile_all \"$src_path/BinningWinsorized.cpp\""
 compile_all="$compile_all \"$src_path/Booster.cpp\""
+compile_all="$compile_all \"$src_path/BoostingCheckpoint.cpp\""
 compile_all="$compile_all \"$src_path/CalculateInteractionScore.cpp\""
 compile_all="$compile_all \"$src_path/CachedThreadResourcesBoosting.cpp\""
 compile_all="$compile_all \"$src_path/CachedThreadResourcesInteraction.cpp\""
 compile_all="$compile_all \"$src_path/DataSetBoosting.cpp\""
 compile_all="$compile_all \"$src_path/DataSetInteraction.cpp\""
 compile_all="$compile_all \"$src_path/Discretization.cpp\""
+compile_all="$compile_all \"$src_path/EstimateMemory.cpp\""
 compile_all="$compile_all \"$src_path/FeatureGroup.cpp\""
 compile_all="$compile_all \"$src_path/FindBestBoostingSplitsPairs.cpp\""
+compile_all="$compile_all \"$src_path/FindBestInteractionGainMulti.cpp\""
 compile_all="$compile_all \"$src_path/FindBestInteractionGainPairs.cpp\""
 compile_all="$compile_all \"$src_path/GenerateModelFeatureGroupUpdate.cpp\""
 compile_all="$compile_all \"$src_path/GrowDecisionTree.cpp\""
@@ -79,16 +88,28 @@ compile_all="$compile_all \"$src_path/InitializeResiduals.cpp\""
 compile_all="$compile_all \"$src_path/InteractionDetection.cpp\""
 compile_all="$compile_all \"$src_path/InterpretableNumerics.cpp\""
 compile_all="$compile_all \"$src_path/Logging.cpp\""
+compile_all="$compile_all \"$src_path/ModelFile.cpp\""
+compile_all="$compile_all \"$src_path/PackedData.cpp\""
+compile_all="$compile_all \"$src_path/PackedDataBuilder.cpp\""
+compile_all="$compile_all \"$src_path/Predict.cpp\""
+compile_all="$compile_all \"$src_path/QuantileSketch.cpp\""
 compile_all="$compile_all \"$src_path/RandomExternal.cpp\""
 compile_all="$compile_all \"$src_path/RandomStream.cpp\""
+compile_all="$compile_all \"$src_path/SampleDeduplication.cpp\""
 compile_all="$compile_all \"$src_path/SamplingSet.cpp\""
 compile_all="$compile_all \"$src_path/SegmentedTensor.cpp\""
+compile_all="$compile_all \"$src_path/SimdKernels.cpp\""
+compile_all="$compile_all \"$src_path/SimdKernelsAvx2.cpp\""
+compile_all="$compile_all \"$src_path/SimdKernelsAvx512.cpp\""
+compile_all="$compile_all \"$src_path/SimdKernelsNeon.cpp\""
+compile_all="$compile_all \"$src_path/SimdKernelsSse42.cpp\""
 compile_all="$compile_all \"$src_path/SumHistogramBuckets.cpp\""
 compile_all="$compile_all \"$src_path/TensorTotalsBuild.cpp\""
+compile_all="$compile_all \"$src_path/ThreadPool.cpp\""
 compile_all="$compile_all -I\"$src_path\""
 compile_all="$compile_all -I\"$src_path/inc\""
 compile_all="$compile_all -Wall -Wextra -Wno-parentheses -Wold-style-cast -Wdouble-promotion -Wshadow -Wformat=2 -std=c++11"
-compile_all="$compile_all -fvisibility=hidden -fvisibility-inlines-hidden -fno-math-errno -fno-trapping-math -march=core2 -DEBM_NATIVE_EXPORTS -fpic"
+compile_all="$compile_all -fvisibility=hidden -fvisibility-inlines-hidden -fno-math-errno -fno-trapping-math -ffp-contract=off -march=core2 -pthread -DEBM_NATIVE_EXPORTS -fpic"
 
 if [ "$os_type" = "Darwin" ]; then
    # reference on rpath & install_name: https://www.mikeash.com/pyblog/friday-qa-2009-11-06-linking-and-install-names.html
@@ -380,3 +401,14 @@ else
    printf "%s\n" "OS $os_type not recognized.  We support $clang_pp_bin on macOS and $g_pp_bin on Linux"
    exit 1
 fi
+
+if [ $run_bench -eq 1 ]; then
+   # the results are one JSON object per line, which we keep so they can be compared against the previous release
+   printf "%s\n" "Running ebm_native_bench"
+   [ -d "$root_path/tmp" ] || mkdir -p "$root_path/tmp"
+   /bin/sh "$src_path/ebm_native_bench/ebm_native_bench.sh" -nobuildebmnative -output "$root_path/tmp/ebm_native_bench.json"
+   ret_code=$?
+   if [ $ret_code -ne 0 ]; then 
+      exit $ret_code
+   fi
+fi
@@ -9,11 +9,11 @@ from .postprocessing import multiclass_postprocess
 from ...utils import unify_data, autogen_schema
 from ...api.base import ExplainerMixin
 from ...api.templates import FeatureValueExplanation
-from ...provider.compute import JobLibProvider
 from ...utils import gen_name_from_class, gen_global_selector, gen_local_selector
 
 import numpy as np
 from warnings import warn
+from joblib import effective_n_jobs
 
 from sklearn.base import is_classifier
 from sklearn.utils.validation import check_is_fitted
@@ -373,18 +373,93 @@ class BaseCoreEBM:
         self.random_state = random_state
 
     def fit_parallel(self, X, y, n_classes):
-        self.n_classes_ = n_classes
+        X_train, X_val, y_train, y_val, main_feature_indices = self._fit_prepare(
+            X, y, n_classes
+        )
 
-        # Split data into train/val
+        # Train main effects
+        self._fit_main(main_feature_indices, X_train, y_train, X_val, y_val)
 
-        X_train, X_val, y_train, y_val = EBMUtils.ebm_train_test_split(
-            X,
-            y,
-            test_size=self.validation_size,
-            random_state=self.random_state,
-            is_classification=self.model_type == "classification",
+        # Build interaction terms, if required
+        self.inter_indices_, self.inter_scores_ = self._build_interactions(
+            X_train, y_train
+        )
+
+        self.inter_episode_idx_ = 0
+        if len(self.inter_indices_) != 0:
+            self._staged_fit_interactions(
+                X_train, y_train, X_val, y_val, self.inter_indices_
+            )
+
+        return self
+
+    @staticmethod
+    def fit_concurrent(estimators, X, y, n_classes, n_concurrent):
+        """ Fits each estimator like fit_parallel does, but inside this process
+            with the boosting of up to n_concurrent estimators running at the
+            same time on the native thread pool.
+        """
+
+        splits = []
+        main_jobs = []
+        for estimator in estimators:
+            (
+                X_train,
+                X_val,
+                y_train,
+                y_val,
+                main_feature_indices,
+            ) = estimator._fit_prepare(X, y, n_classes)
+            splits.append((X_train, X_val, y_train, y_val))
+            main_jobs.append(
+                estimator._main_job(
+                    main_feature_indices, X_train, y_train, X_val, y_val
+                )
+            )
+
+        # Train main effects
+        log.info("Train main effects")
+        results = BaseCoreEBM._cyclic_gradient_boost_concurrent(
+            estimators, main_jobs, n_concurrent
         )
 
+        inter_estimators = []
+        inter_jobs = []
+        for estimator, job, result, (X_train, X_val, y_train, y_val) in zip(
+            estimators, main_jobs, results, splits
+        ):
+            estimator._set_main_result(job["feature_groups"], result)
+
+            # Build interaction terms, if required
+            estimator.inter_indices_, estimator.inter_scores_ = estimator._build_interactions(
+                X_train, y_train
+            )
+
+            estimator.inter_episode_idx_ = 0
+            if len(estimator.inter_indices_) != 0:
+                inter_estimators.append(estimator)
+                inter_jobs.append(
+                    estimator._interaction_job(
+                        X_train, y_train, X_val, y_val, estimator.inter_indices_
+                    )
+                )
+
+        if len(inter_jobs) != 0:
+            log.info("Training interactions")
+            results = BaseCoreEBM._cyclic_gradient_boost_concurrent(
+                inter_estimators, inter_jobs, n_concurrent
+            )
+            for estimator, job, result in zip(inter_estimators, inter_jobs, results):
+                estimator._set_interaction_result(job["feature_groups"], result)
+
+        return estimators
+
+    def _fit_prepare(self, X, y, n_classes):
+        self.n_classes_ = n_classes
+
+        # Split data into train/val
+        X_train, X_val, y_train, y_val = self._split_train_val(X, y)
+
         # Define features
         self.features_ = EBMUtils.gen_features(self.col_types, self.col_n_bins)
         # Build EBM allocation code
@@ -412,52 +487,55 @@ class BaseCoreEBM:
         self.feature_groups_ = []
         self.model_ = []
 
-        # Train main effects
-        self._fit_main(main_feature_indices, X_train, y_train, X_val, y_val)
+        return X_train, X_val, y_train, y_val, main_feature_indices
+
+    def _boost_params(self):
+        return {
+            "model_type": self.model_type,
+            "n_classes": self.n_classes_,
+            "features": self.features_,
+            "n_inner_bags": self.inner_bags,
+            "learning_rate": self.learning_rate,
+            "max_leaves": self.max_leaves,
+            "min_samples_leaf": self.min_samples_leaf,
+            "max_rounds": self.max_rounds,
+            "early_stopping_tolerance": self.early_stopping_tolerance,
+            "early_stopping_rounds": self.early_stopping_rounds,
+        }
 
-        # Build interaction terms, if required
-        self.inter_indices_, self.inter_scores_ = self._build_interactions(
-            X_train, y_train
+    @staticmethod
+    def _cyclic_gradient_boost_concurrent(estimators, jobs, n_concurrent):
+        # the outer bags of an EBM share every boosting parameter except the data and random_state
+        return NativeHelper.cyclic_gradient_boost_concurrent(
+            jobs=jobs, n_concurrent=n_concurrent, **estimators[0]._boost_params()
         )
 
-        self.inter_episode_idx_ = 0
-        if len(self.inter_indices_) != 0:
-            self._staged_fit_interactions(
-                X_train, y_train, X_val, y_val, self.inter_indices_
-            )
+    def _main_job(self, main_feature_groups, X_train, y_train, X_val, y_val):
+        return {
+            "feature_groups": main_feature_groups,
+            "X_train": X_train,
+            "y_train": y_train,
+            "scores_train": None,
+            "X_val": X_val,
+            "y_val": y_val,
+            "scores_val": None,
+            "random_state": self.random_state,
+            "name": "Main",
+        }
 
-        return self
+    def _set_main_result(self, main_feature_groups, result):
+        (self.model_, self.current_metric_, self.main_episode_idx_,) = result
+        self.feature_groups_ = main_feature_groups
 
     def _fit_main(self, main_feature_groups, X_train, y_train, X_val, y_val):
         log.info("Train main effects")
 
-        (
-            self.model_,
-            self.current_metric_,
-            self.main_episode_idx_,
-        ) = NativeHelper.cyclic_gradient_boost(
-            model_type=self.model_type,
-            n_classes=self.n_classes_,
-            features=self.features_,
-            feature_groups=main_feature_groups,
-            X_train=X_train,
-            y_train=y_train,
-            scores_train=None,
-            X_val=X_val,
-            y_val=y_val,
-            scores_val=None,
-            n_inner_bags=self.inner_bags,
-            random_state=self.random_state,
-            learning_rate=self.learning_rate,
-            max_leaves=self.max_leaves,
-            min_samples_leaf=self.min_samples_leaf,
-            max_rounds=self.max_rounds,
-            early_stopping_tolerance=self.early_stopping_tolerance,
-            early_stopping_rounds=self.early_stopping_rounds,
-            name="Main",
+        result = NativeHelper.cyclic_gradient_boost(
+            **self._boost_params(),
+            **self._main_job(main_feature_groups, X_train, y_train, X_val, y_val)
         )
 
-        self.feature_groups_ = main_feature_groups
+        self._set_main_result(main_feature_groups, result)
 
         return
 
@@ -493,12 +571,7 @@ class BaseCoreEBM:
 
         return final_indices, final_scores
 
-    def _staged_fit_interactions(
-        self, X_train, y_train, X_val, y_val, inter_indices=[]
-    ):
-
-        log.info("Training interactions")
-
+    def _interaction_job(self, X_train, y_train, X_val, y_val, inter_indices):
         scores_train = EBMUtils.decision_function(
             X_train, self.feature_groups_, self.model_, self.intercept_
         )
@@ -506,37 +579,48 @@ class BaseCoreEBM:
             X_val, self.feature_groups_, self.model_, self.intercept_
         )
 
-        (
-            model_update,
-            self.current_metric_,
-            self.inter_episode_idx_,
-        ) = NativeHelper.cyclic_gradient_boost(
-            model_type=self.model_type,
-            n_classes=self.n_classes_,
-            features=self.features_,
-            feature_groups=inter_indices,
-            X_train=X_train,
-            y_train=y_train,
-            scores_train=scores_train,
-            X_val=X_val,
-            y_val=y_val,
-            scores_val=scores_val,
-            n_inner_bags=self.inner_bags,
-            random_state=self.random_state,
-            learning_rate=self.learning_rate,
-            max_leaves=self.max_leaves,
-            min_samples_leaf=self.min_samples_leaf,
-            max_rounds=self.max_rounds,
-            early_stopping_tolerance=self.early_stopping_tolerance,
-            early_stopping_rounds=self.early_stopping_rounds,
-            name="Pair",
-        )
+        return {
+            "feature_groups": inter_indices,
+            "X_train": X_train,
+            "y_train": y_train,
+            "scores_train": scores_train,
+            "X_val": X_val,
+            "y_val": y_val,
+            "scores_val": scores_val,
+            "random_state": self.random_state,
+            "name": "Pair",
+        }
+
+    def _set_interaction_result(self, inter_indices, result):
+        (model_update, self.current_metric_, self.inter_episode_idx_,) = result
 
         self.model_.extend(model_update)
         self.feature_groups_.extend(inter_indices)
 
+    def _staged_fit_interactions(
+        self, X_train, y_train, X_val, y_val, inter_indices=[]
+    ):
+
+        log.info("Training interactions")
+
+        result = NativeHelper.cyclic_gradient_boost(
+            **self._boost_params(),
+            **self._interaction_job(X_train, y_train, X_val, y_val, inter_indices)
+        )
+
+        self._set_interaction_result(inter_indices, result)
+
         return
 
+    def _split_train_val(self, X, y):
+        return EBMUtils.ebm_train_test_split(
+            X,
+            y,
+            test_size=self.validation_size,
+            random_state=self.random_state,
+            is_classification=self.model_type == "classification",
+        )
+
     def staged_fit_interactions_parallel(self, X, y, inter_indices=[]):
 
         log.info("Splitting train/test for interactions")
@@ -545,17 +629,39 @@ class BaseCoreEBM:
         # NOTE: ideally we would store the train/validation split in the
         #       remote processes, but joblib doesn't have a concept
         #       of keeping remote state, so we re-split our sets
-        X_train, X_val, y_train, y_val = EBMUtils.ebm_train_test_split(
-            X,
-            y,
-            test_size=self.validation_size,
-            random_state=self.random_state,
-            is_classification=self.model_type == "classification",
-        )
+        X_train, X_val, y_train, y_val = self._split_train_val(X, y)
 
         self._staged_fit_interactions(X_train, y_train, X_val, y_val, inter_indices)
         return self
 
+    @staticmethod
+    def staged_fit_interactions_concurrent(
+        estimators, X, y, n_concurrent, inter_indices=[]
+    ):
+        """ Retrains the interactions of each estimator like
+            staged_fit_interactions_parallel does, with up to n_concurrent
+            estimators boosting at the same time.
+        """
+
+        log.info("Training interactions")
+
+        jobs = []
+        for estimator in estimators:
+            X_train, X_val, y_train, y_val = estimator._split_train_val(X, y)
+            jobs.append(
+                estimator._interaction_job(
+                    X_train, y_train, X_val, y_val, inter_indices
+                )
+            )
+
+        results = BaseCoreEBM._cyclic_gradient_boost_concurrent(
+            estimators, jobs, n_concurrent
+        )
+        for estimator, result in zip(estimators, results):
+            estimator._set_interaction_result(inter_indices, result)
+
+        return estimators
+
 
 class BaseEBM(BaseEstimator):
     """Client facing SK EBM."""
@@ -774,17 +880,14 @@ class BaseEBM(BaseEstimator):
         else:
             self.intercept_ = np.float64(0)
 
-        provider = JobLibProvider(n_jobs=self.n_jobs)
+        # the outer bags boost concurrently on the native thread pool of this process, which
+        # avoids sending a copy of X to a separate process for each outer bag
+        n_concurrent = effective_n_jobs(self.n_jobs)
 
-        def train_model(estimator, X, y, n_classes):
-            return estimator.fit_parallel(X, y, n_classes)
-
-        train_model_args_iter = (
-            (estimators[i], X, y, n_classes) for i in range(self.outer_bags)
+        estimators = BaseCoreEBM.fit_concurrent(
+            estimators, X, y, n_classes, n_concurrent
         )
 
-        estimators = provider.parallel(train_model, train_model_args_iter)
-
         if isinstance(self.interactions, int) and self.interactions > 0:
             # Select merged pairs
             pair_indices = self._select_merged_pairs(estimators, X, y)
@@ -804,16 +907,9 @@ class BaseEBM(BaseEstimator):
 
             if len(pair_indices) != 0:
                 # Retrain interactions for base models
-                def staged_fit_fn(estimator, X, y, inter_indices=[]):
-                    return estimator.staged_fit_interactions_parallel(
-                        X, y, inter_indices
-                    )
-
-                staged_fit_args_iter = (
-                    (estimators[i], X, y, pair_indices) for i in range(self.outer_bags)
+                estimators = BaseCoreEBM.staged_fit_interactions_concurrent(
+                    estimators, X, y, n_concurrent, pair_indices
                 )
-
-                estimators = provider.parallel(staged_fit_fn, staged_fit_args_iter)
         elif isinstance(self.interactions, int) and self.interactions == 0:
             pair_indices = []
         elif isinstance(self.interactions, list):
@@ -63,6 +63,16 @@ class Native:
             ("countFeaturesInGroup", ct.c_longlong)
         ]
 
+    class EbmNativeBinnedColumn(ct.Structure):
+        _fields_ = [
+            # const void * data;
+            ("data", ct.c_void_p),
+            # int64_t countBytesPerBin;
+            ("countBytesPerBin", ct.c_longlong),
+            # int64_t countBytesStride;
+            ("countBytesStride", ct.c_longlong),
+        ]
+
     # const signed char TraceLevelOff = 0;
     TraceLevelOff = 0
     # const signed char TraceLevelError = 1;
@@ -75,6 +85,12 @@ class Native:
     TraceLevelVerbose = 4
 
     _LogFuncType = ct.CFUNCTYPE(None, ct.c_char, ct.c_char_p)
+    _BoostingProgressFuncType = ct.CFUNCTYPE(
+        ct.c_longlong, ct.c_longlong, ct.c_double, ct.c_void_p
+    )
+    _HistogramReduceFuncType = ct.CFUNCTYPE(
+        ct.c_longlong, ct.c_longlong, ct.POINTER(ct.c_double), ct.c_void_p
+    )
 
     def __init__(self):
         pass
@@ -91,6 +107,35 @@ class Native:
             ct.c_char
         ]
         self.lib.SetTraceLevel.restype = None
+        self.lib.SetHugePages.argtypes = [
+            # int64_t hugePages
+            ct.c_longlong
+        ]
+        self.lib.SetHugePages.restype = None
+        self.lib.SetNumaPlacement.argtypes = [
+            # int64_t numaPlacement
+            ct.c_longlong
+        ]
+        self.lib.SetNumaPlacement.restype = None
+        self.lib.GetMemoryStatistics.argtypes = [
+            # int64_t memorySubsystem
+            ct.c_longlong,
+            # int64_t * countBytesCurrentOut
+            ct.POINTER(ct.c_longlong),
+            # int64_t * countBytesPeakOut
+            ct.POINTER(ct.c_longlong),
+        ]
+        self.lib.GetMemoryStatistics.restype = ct.c_longlong
+        self.lib.SetLogBuffer.argtypes = [
+            # int64_t countMessages
+            ct.c_longlong
+        ]
+        self.lib.SetLogBuffer.restype = ct.c_longlong
+        self.lib.DrainLogMessages.argtypes = [
+            # int64_t * countDroppedOut
+            ct.POINTER(ct.c_longlong)
+        ]
+        self.lib.DrainLogMessages.restype = ct.c_longlong
 
         self.lib.Discretize.argtypes = [
             # int64_t countSamples
@@ -106,6 +151,312 @@ class Native:
         ]
         self.lib.Discretize.restype = ct.c_longlong
 
+        self.lib.DiscretizeFeatures.argtypes = [
+            # int64_t countSamples
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t * discretizedOut (column major)
+            ndpointer(dtype=ct.c_longlong, ndim=2, flags="F_CONTIGUOUS"),
+        ]
+        self.lib.DiscretizeFeatures.restype = ct.c_longlong
+
+        self.lib.PredictBatchClassification.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * probabilitiesOut
+            ndpointer(dtype=np.float64, ndim=2, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.PredictBatchClassification.restype = ct.c_longlong
+
+        self.lib.PredictBatchRegression.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * predictionsOut
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.PredictBatchRegression.restype = ct.c_longlong
+
+        self.lib.ExplainBatchClassification.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * explanationsOut
+            ndpointer(dtype=np.float64, ndim=3, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.ExplainBatchClassification.restype = ct.c_longlong
+
+        self.lib.ExplainBatchRegression.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * explanationsOut
+            ndpointer(dtype=np.float64, ndim=3, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.ExplainBatchRegression.restype = ct.c_longlong
+
+        self.lib.ScoreModelVariantsClassification.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # int64_t * targets
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countVariants
+            ct.c_longlong,
+            # int64_t * variantFeatureGroups
+            ndpointer(dtype=ct.c_longlong, ndim=2, flags="C_CONTIGUOUS"),
+            # double * metricsOut
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.ScoreModelVariantsClassification.restype = ct.c_longlong
+
+        self.lib.ScoreModelVariantsRegression.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * targets
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countVariants
+            ct.c_longlong,
+            # int64_t * variantFeatureGroups
+            ndpointer(dtype=ct.c_longlong, ndim=2, flags="C_CONTIGUOUS"),
+            # double * metricsOut
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.ScoreModelVariantsRegression.restype = ct.c_longlong
+
+        self.lib.SaveModelClassification.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.SaveModelClassification.restype = ct.c_longlong
+
+        self.lib.SaveModelRegression.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * modelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.SaveModelRegression.restype = ct.c_longlong
+
+        self.lib.SaveBoostingModel.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t * countBinCuts
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double * binCutsLowerBoundInclusive
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # double * intercept
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.SaveBoostingModel.restype = ct.c_longlong
+
+        self.lib.OpenModel.argtypes = [
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.OpenModel.restype = ct.c_void_p
+
+        self.lib.PredictModel.argtypes = [
+            # void * model
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_longlong,
+            # double * featureValues (column major)
+            ndpointer(dtype=np.float64, ndim=2, flags="F_CONTIGUOUS"),
+            # double * predictionsOut
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.PredictModel.restype = ct.c_longlong
+
+        self.lib.CloseModel.argtypes = [
+            # void * model
+            ct.c_void_p,
+        ]
+        self.lib.CloseModel.restype = None
+
+        self.lib.SaveBoostingCheckpoint.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.SaveBoostingCheckpoint.restype = ct.c_longlong
+
+        self.lib.LoadBoostingCheckpoint.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.LoadBoostingCheckpoint.restype = ct.c_longlong
+
         self.lib.InitializeBoostingClassification.argtypes = [
             # int64_t countTargetClasses
             ct.c_longlong,
@@ -180,9 +531,614 @@ class Native:
             # double * optionalTempParams
             ct.POINTER(ct.c_double),
         ]
-        self.lib.InitializeBoostingRegression.restype = ct.c_void_p
+        self.lib.InitializeBoostingRegression.restype = ct.c_void_p
+
+        self.lib.InitializeBoostingClassificationWeighted.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t * trainingBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * trainingTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * trainingPredictorScores
+            # scores can either be 1 or 2 dimensional
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # int64_t * trainingWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t * validationBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * validationTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * validationPredictorScores
+            # scores can either be 1 or 2 dimensional
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # int64_t * validationWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingClassificationWeighted.restype = ct.c_void_p
+
+        self.lib.InitializeBoostingRegressionWeighted.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t * trainingBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # double * trainingTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * trainingPredictorScores
+            ndpointer(dtype=np.float64, ndim=1),
+            # int64_t * trainingWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t * validationBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # double * validationTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * validationPredictorScores
+            ndpointer(dtype=np.float64, ndim=1),
+            # int64_t * validationWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingRegressionWeighted.restype = ct.c_void_p
+
+        self.lib.InitializeBoostingClassificationWarmStart.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * initialModelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t * trainingBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * trainingTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * trainingPredictorScores (None to start from zeros)
+            ct.c_void_p,
+            # int64_t * trainingWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t * validationBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * validationTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * validationPredictorScores (None to start from zeros)
+            ct.c_void_p,
+            # int64_t * validationWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingClassificationWarmStart.restype = ct.c_void_p
+
+        self.lib.InitializeBoostingRegressionWarmStart.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * initialModelFeatureGroupTensors
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t * trainingBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # double * trainingTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * trainingPredictorScores (None to start from zeros)
+            ct.c_void_p,
+            # int64_t * trainingWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t * validationBinnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # double * validationTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * validationPredictorScores (None to start from zeros)
+            ct.c_void_p,
+            # int64_t * validationWeights (None to weight every sample by 1)
+            ct.c_void_p,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingRegressionWarmStart.restype = ct.c_void_p
+
+        self.lib.EstimateBoostingMemoryClassification.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+            # int64_t * countBytesOut
+            ndpointer(dtype=np.int64, ndim=1),
+        ]
+        self.lib.EstimateBoostingMemoryClassification.restype = ct.c_longlong
+
+        self.lib.EstimateBoostingMemoryRegression.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+            # int64_t * countBytesOut
+            ndpointer(dtype=np.int64, ndim=1),
+        ]
+        self.lib.EstimateBoostingMemoryRegression.restype = ct.c_longlong
+
+        self.lib.InitializeBoostingClassificationPacked.argtypes = [
+            # int64_t countTargetClasses
+            ct.c_longlong,
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # void * trainingPackedData
+            ct.c_void_p,
+            # int64_t * trainingSampleMask (None to use every sample)
+            ct.c_void_p,
+            # int64_t * trainingTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * trainingPredictorScores
+            # scores can either be 1 or 2 dimensional
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # void * validationPackedData
+            ct.c_void_p,
+            # int64_t * validationSampleMask (None to use every sample)
+            ct.c_void_p,
+            # int64_t * validationTargets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * validationPredictorScores
+            # scores can either be 1 or 2 dimensional
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingClassificationPacked.restype = ct.c_void_p
+
+        self.lib.InitializeBoostingRegressionPacked.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countTrainingSamples
+            ct.c_longlong,
+            # void * trainingPackedData
+            ct.c_void_p,
+            # int64_t * trainingSampleMask (None to use every sample)
+            ct.c_void_p,
+            # double * trainingTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * trainingPredictorScores
+            ndpointer(dtype=np.float64, ndim=1),
+            # int64_t countValidationSamples
+            ct.c_longlong,
+            # void * validationPackedData
+            ct.c_void_p,
+            # int64_t * validationSampleMask (None to use every sample)
+            ct.c_void_p,
+            # double * validationTargets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * validationPredictorScores
+            ndpointer(dtype=np.float64, ndim=1),
+            # int64_t countInnerBags
+            ct.c_longlong,
+            # int64_t randomSeed
+            ct.c_longlong,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeBoostingRegressionPacked.restype = ct.c_void_p
+
+        self.lib.SaveBoostingPackedData.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # char * trainingFilePath
+            ct.c_char_p,
+            # char * validationFilePath
+            ct.c_char_p,
+        ]
+        self.lib.SaveBoostingPackedData.restype = ct.c_longlong
+
+        self.lib.OpenPackedData.argtypes = [
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.OpenPackedData.restype = ct.c_void_p
+
+        self.lib.CreatePackedData.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countSamples
+            ct.c_longlong,
+            # int64_t * binnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.CreatePackedData.restype = ct.c_void_p
+
+        self.lib.CreatePackedDataFromColumns.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countSamples
+            ct.c_longlong,
+            # EbmNativeBinnedColumn * columns
+            ct.POINTER(self.EbmNativeBinnedColumn),
+        ]
+        self.lib.CreatePackedDataFromColumns.restype = ct.c_void_p
+
+        self.lib.BeginPackedData.argtypes = [
+            # int64_t countFeatures
+            ct.c_longlong,
+            # EbmNativeFeature * features
+            ct.POINTER(self.EbmNativeFeature),
+            # int64_t countFeatureGroups
+            ct.c_longlong,
+            # EbmNativeFeatureGroup * featureGroups
+            ct.POINTER(self.EbmNativeFeatureGroup),
+            # int64_t * featureGroupIndexes
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countSamples
+            ct.c_longlong,
+        ]
+        self.lib.BeginPackedData.restype = ct.c_void_p
+
+        self.lib.AppendPackedData.argtypes = [
+            # void * packedDataBuilder
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_longlong,
+            # EbmNativeBinnedColumn * columns
+            ct.POINTER(self.EbmNativeBinnedColumn),
+        ]
+        self.lib.AppendPackedData.restype = ct.c_longlong
+
+        self.lib.FinishPackedData.argtypes = [
+            # void * packedDataBuilder
+            ct.c_void_p
+        ]
+        self.lib.FinishPackedData.restype = ct.c_void_p
+
+        self.lib.FreePackedDataBuilder.argtypes = [
+            # void * packedDataBuilder
+            ct.c_void_p
+        ]
+        self.lib.FreePackedDataBuilder.restype = None
+
+        self.lib.SavePackedData.argtypes = [
+            # void * packedData
+            ct.c_void_p,
+            # char * filePath
+            ct.c_char_p,
+        ]
+        self.lib.SavePackedData.restype = ct.c_longlong
+
+        self.lib.ClosePackedData.argtypes = [
+            # void * packedData
+            ct.c_void_p,
+        ]
+        self.lib.ClosePackedData.restype = None
+
+        self.lib.GenerateModelFeatureGroupUpdate.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # double learningRate
+            ct.c_double,
+            # int64_t countTreeSplitsMax
+            ct.c_longlong,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # double * trainingWeights
+            # ndpointer(dtype=np.float64, ndim=1),
+            ct.c_void_p,
+            # double * validationWeights
+            # ndpointer(dtype=np.float64, ndim=1),
+            ct.c_void_p,
+            # double * gainOut
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.GenerateModelFeatureGroupUpdate.restype = ct.POINTER(ct.c_double)
+
+        self.lib.GenerateModelFeatureGroupUpdateSlot.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexSlot
+            ct.c_longlong,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # double learningRate
+            ct.c_double,
+            # int64_t countTreeSplitsMax
+            ct.c_longlong,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # double * trainingWeights
+            # ndpointer(dtype=np.float64, ndim=1),
+            ct.c_void_p,
+            # double * validationWeights
+            # ndpointer(dtype=np.float64, ndim=1),
+            ct.c_void_p,
+            # double * gainOut
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.GenerateModelFeatureGroupUpdateSlot.restype = ct.POINTER(ct.c_double)
+
+        self.lib.GenerateModelFeatureGroupUpdateSlots.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t countSlots
+            ct.c_longlong,
+            # int64_t * indexesFeatureGroup
+            ndpointer(dtype=ct.c_longlong, ndim=1, flags="C_CONTIGUOUS"),
+            # double learningRate
+            ct.c_double,
+            # int64_t countTreeSplitsMax
+            ct.c_longlong,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # double ** modelFeatureGroupUpdateTensorsOut
+            ct.POINTER(ct.POINTER(ct.c_double)),
+            # double * gainsOut
+            ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.GenerateModelFeatureGroupUpdateSlots.restype = ct.c_longlong
+
+        self.lib.ApplyModelFeatureGroupUpdate.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # double * modelFeatureGroupUpdateTensor
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # double * validationMetricOut
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.ApplyModelFeatureGroupUpdate.restype = ct.c_longlong
+
+        self.lib.BoostingRun.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t countRoundsMax
+            ct.c_longlong,
+            # double learningRate
+            ct.c_double,
+            # int64_t countTreeSplitsMax
+            ct.c_longlong,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # int64_t earlyStoppingRounds
+            ct.c_longlong,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t (* fn)(int64_t indexRound, double validationMetric, void * progressContext) progressFunction
+            self._BoostingProgressFuncType,
+            # void * progressContext
+            ct.c_void_p,
+            # double * validationMetricOut
+            ct.POINTER(ct.c_double),
+            # int64_t * indexRoundOut
+            ct.POINTER(ct.c_longlong),
+        ]
+        self.lib.BoostingRun.restype = ct.c_longlong
+
+        self.lib.AppendBoostingTrainingSamplesClassification.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_longlong,
+            # int64_t * binnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # int64_t * targets
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * predictorScores
+            # scores can either be 1 or 2 dimensional
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+        ]
+        self.lib.AppendBoostingTrainingSamplesClassification.restype = ct.c_longlong
+
+        self.lib.AppendBoostingTrainingSamplesRegression.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t countSamples
+            ct.c_longlong,
+            # int64_t * binnedData
+            ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS"),
+            # double * targets
+            ndpointer(dtype=np.float64, ndim=1),
+            # double * predictorScores
+            ndpointer(dtype=np.float64, ndim=1),
+        ]
+        self.lib.AppendBoostingTrainingSamplesRegression.restype = ct.c_longlong
+
+        self.lib.SetBoostingHistogramReduce.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t (* fn)(int64_t countValues, double * values, void * reduceContext) reduceFunction
+            self._HistogramReduceFuncType,
+            # void * reduceContext
+            ct.c_void_p,
+        ]
+        self.lib.SetBoostingHistogramReduce.restype = ct.c_longlong
+
+        self.lib.GetBestModelFeatureGroup.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+        ]
+        self.lib.GetBestModelFeatureGroup.restype = ct.POINTER(ct.c_double)
+
+        self.lib.GetCurrentModelFeatureGroup.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+        ]
+        self.lib.GetCurrentModelFeatureGroup.restype = ct.POINTER(ct.c_double)
+
+        self.lib.CopyBestModelFeatureGroup.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # int64_t * countBytesStrides
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * tensorOut
+            ct.c_void_p,
+        ]
+        self.lib.CopyBestModelFeatureGroup.restype = ct.c_longlong
+
+        self.lib.CopyCurrentModelFeatureGroup.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # int64_t * countBytesStrides
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * tensorOut
+            ct.c_void_p,
+        ]
+        self.lib.CopyCurrentModelFeatureGroup.restype = ct.c_longlong
+
+        self.lib.MergeBestModelFeatureGroup.argtypes = [
+            # int64_t countBoosters
+            ct.c_longlong,
+            # void ** ebmBoostings
+            ct.POINTER(ct.c_void_p),
+            # int64_t indexFeatureGroup
+            ct.c_longlong,
+            # double * meanOut
+            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
+            # double * standardDeviationOut
+            ct.c_void_p,
+        ]
+        self.lib.MergeBestModelFeatureGroup.restype = ct.c_longlong
 
-        self.lib.GenerateModelFeatureGroupUpdate.argtypes = [
+        self.lib.BoostingStepAsync.argtypes = [
             # void * ebmBoosting
             ct.c_void_p,
             # int64_t indexFeatureGroup
@@ -194,49 +1150,77 @@ class Native:
             # int64_t countSamplesRequiredForChildSplitMin
             ct.c_longlong,
             # double * trainingWeights
-            # ndpointer(dtype=np.float64, ndim=1),
             ct.c_void_p,
             # double * validationWeights
-            # ndpointer(dtype=np.float64, ndim=1),
             ct.c_void_p,
-            # double * gainOut
-            ct.POINTER(ct.c_double),
         ]
-        self.lib.GenerateModelFeatureGroupUpdate.restype = ct.POINTER(ct.c_double)
+        self.lib.BoostingStepAsync.restype = ct.c_void_p
 
-        self.lib.ApplyModelFeatureGroupUpdate.argtypes = [
+        self.lib.BoostingRunAsync.argtypes = [
             # void * ebmBoosting
             ct.c_void_p,
-            # int64_t indexFeatureGroup
+            # int64_t countRoundsMax
             ct.c_longlong,
-            # double * modelFeatureGroupUpdateTensor
-            ndpointer(dtype=np.float64, flags="C_CONTIGUOUS"),
-            # double * validationMetricOut
-            ct.POINTER(ct.c_double),
+            # double learningRate
+            ct.c_double,
+            # int64_t countTreeSplitsMax
+            ct.c_longlong,
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # int64_t earlyStoppingRounds
+            ct.c_longlong,
+            # double earlyStoppingTolerance
+            ct.c_double,
+            # int64_t (* fn)(int64_t indexRound, double validationMetric, void * progressContext) progressFunction
+            self._BoostingProgressFuncType,
+            # void * progressContext
+            ct.c_void_p,
+            # int64_t * indexRoundOut
+            ct.POINTER(ct.c_longlong),
         ]
-        self.lib.ApplyModelFeatureGroupUpdate.restype = ct.c_longlong
+        self.lib.BoostingRunAsync.restype = ct.c_void_p
 
-        self.lib.GetBestModelFeatureGroup.argtypes = [
-            # void * ebmBoosting
-            ct.c_void_p,
-            # int64_t indexFeatureGroup
+        self.lib.WaitForWork.argtypes = [
+            # int64_t countWorks
             ct.c_longlong,
+            # void ** works
+            ct.POINTER(ct.c_void_p),
+            # int64_t isWaitAll
+            ct.c_longlong,
+            # int64_t * indexCompletedOut
+            ct.POINTER(ct.c_longlong),
         ]
-        self.lib.GetBestModelFeatureGroup.restype = ct.POINTER(ct.c_double)
+        self.lib.WaitForWork.restype = ct.c_longlong
 
-        self.lib.GetCurrentModelFeatureGroup.argtypes = [
-            # void * ebmBoosting
+        self.lib.FinishWork.argtypes = [
+            # void * work
             ct.c_void_p,
-            # int64_t indexFeatureGroup
-            ct.c_longlong,
+            # double * metricOut
+            ct.POINTER(ct.c_double),
         ]
-        self.lib.GetCurrentModelFeatureGroup.restype = ct.POINTER(ct.c_double)
+        self.lib.FinishWork.restype = ct.c_longlong
+
+        self.lib.ShutdownThreadPool.argtypes = []
+        self.lib.ShutdownThreadPool.restype = ct.c_longlong
 
         self.lib.FreeBoosting.argtypes = [
             # void * ebmBoosting
             ct.c_void_p
         ]
         self.lib.FreeBoosting.restype = None
+        self.lib.GetPerformanceCounters.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # int64_t performanceCounter
+            ct.c_longlong,
+            # int64_t * countCallsOut
+            ct.POINTER(ct.c_longlong),
+            # int64_t * countNanosecondsOut
+            ct.POINTER(ct.c_longlong),
+            # int64_t * countBytesScannedOut
+            ct.POINTER(ct.c_longlong),
+        ]
+        self.lib.GetPerformanceCounters.restype = ct.c_longlong
 
         self.lib.InitializeInteractionClassification.argtypes = [
             # int64_t countTargetClasses
@@ -277,6 +1261,14 @@ class Native:
         ]
         self.lib.InitializeInteractionRegression.restype = ct.c_void_p
 
+        self.lib.InitializeInteractionFromBoosting.argtypes = [
+            # void * ebmBoosting
+            ct.c_void_p,
+            # double * optionalTempParams
+            ct.POINTER(ct.c_double),
+        ]
+        self.lib.InitializeInteractionFromBoosting.restype = ct.c_void_p
+
         self.lib.CalculateInteractionScore.argtypes = [
             # void * ebmInteraction
             ct.c_void_p,
@@ -291,6 +1283,38 @@ class Native:
         ]
         self.lib.CalculateInteractionScore.restype = ct.c_longlong
 
+        self.lib.CalculateInteractionScorePairs.argtypes = [
+            # void * ebmInteraction
+            ct.c_void_p,
+            # int64_t countPairs
+            ct.c_longlong,
+            # int64_t * featureIndexPairs
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # double * interactionScoresOut
+            ndpointer(dtype=np.float64, ndim=1),
+        ]
+        self.lib.CalculateInteractionScorePairs.restype = ct.c_longlong
+
+        self.lib.CalculateInteractionScoreTopPairs.argtypes = [
+            # void * ebmInteraction
+            ct.c_void_p,
+            # int64_t countPairs
+            ct.c_longlong,
+            # int64_t * featureIndexPairs
+            ndpointer(dtype=np.int64, ndim=1),
+            # int64_t countSamplesRequiredForChildSplitMin
+            ct.c_longlong,
+            # int64_t countTopPairs
+            ct.c_longlong,
+            # int64_t * topPairIndexesOut
+            ndpointer(dtype=np.int64, ndim=1),
+            # double * topInteractionScoresOut
+            ndpointer(dtype=np.float64, ndim=1),
+        ]
+        self.lib.CalculateInteractionScoreTopPairs.restype = ct.c_longlong
+
         self.lib.FreeInteraction.argtypes = [
             # void * ebmInteraction
             ct.c_void_p
@@ -426,6 +1450,31 @@ class Native:
 
         return feature_ar
 
+    @staticmethod
+    def is_binned_data_c(X):
+        # the non-packed initialization functions take a C-ordered int64 matrix
+        return X.dtype == np.int64 and X.flags.c_contiguous
+
+    @staticmethod
+    def convert_binned_columns_to_c(X):
+        # Create C form of the columns of X without copying them.  X has one row per feature
+        # the native code reads unsigned bins of 1, 2 or 4 bytes and int64 bins at any stride, so
+        # only other dtypes need to be converted, and then only one feature at a time
+
+        columns = []
+        columns_ar = (Native.EbmNativeBinnedColumn * X.shape[0])()
+        for idx in range(X.shape[0]):
+            column = X[idx]
+            if column.dtype not in (np.uint8, np.uint16, np.uint32, np.int64):
+                column = column.astype(np.int64)
+            # keep a reference so that the column lives as long as the C form that points into it
+            columns.append(column)
+            columns_ar[idx].data = column.ctypes.data
+            columns_ar[idx].countBytesPerBin = column.dtype.itemsize
+            columns_ar[idx].countBytesStride = column.strides[0]
+
+        return columns_ar, columns
+
     @staticmethod
     def convert_feature_groups_to_c(feature_groups):
         # Create C form of feature_groups
@@ -496,8 +1545,9 @@ class NativeEBMBoosting:
             random_state: Random seed as integer.
         """
 
-        # first set the one thing that we will close on
+        # first set the things that we will close on
         self._booster_pointer = None
+        self._run_work = None
 
         # check inputs for important inputs or things that would segfault in C
         if not isinstance(features, list):  # pragma: no cover
@@ -607,6 +1657,28 @@ class NativeEBMBoosting:
                 *optional_temp_params
             )
 
+        if not (
+            Native.is_binned_data_c(X_train) and Native.is_binned_data_c(X_val)
+        ):
+            # strided or narrow binned data is packed straight from its columns instead of first
+            # being converted into a contiguous int64 matrix
+            self._initialize_packed(
+                feature_array,
+                feature_groups_array,
+                feature_group_indexes,
+                X_train,
+                y_train,
+                scores_train,
+                X_val,
+                y_val,
+                scores_val,
+                n_inner_bags,
+                random_state,
+                optional_temp_params,
+            )
+            log.info("Allocation boosting end")
+            return
+
         # Allocate external resources
         if model_type == "classification":
             self._booster_pointer = self._native.lib.InitializeBoostingClassification(
@@ -656,9 +1728,113 @@ class NativeEBMBoosting:
 
         log.info("Allocation boosting end")
 
+    def _create_packed_data(
+        self, feature_array, feature_groups_array, feature_group_indexes, X
+    ):
+        columns_array, columns = Native.convert_binned_columns_to_c(X)
+        packed_data_pointer = self._native.lib.CreatePackedDataFromColumns(
+            len(feature_array),
+            feature_array,
+            len(feature_groups_array),
+            feature_groups_array,
+            feature_group_indexes,
+            X.shape[1],
+            columns_array,
+        )
+        if not packed_data_pointer:  # pragma: no cover
+            raise MemoryError("Out of memory in CreatePackedDataFromColumns")
+        return packed_data_pointer
+
+    def _initialize_packed(
+        self,
+        feature_array,
+        feature_groups_array,
+        feature_group_indexes,
+        X_train,
+        y_train,
+        scores_train,
+        X_val,
+        y_val,
+        scores_val,
+        n_inner_bags,
+        random_state,
+        optional_temp_params,
+    ):
+        training_packed_data = None
+        validation_packed_data = None
+        try:
+            training_packed_data = self._create_packed_data(
+                feature_array, feature_groups_array, feature_group_indexes, X_train
+            )
+            validation_packed_data = self._create_packed_data(
+                feature_array, feature_groups_array, feature_group_indexes, X_val
+            )
+
+            if self._model_type == "classification":
+                self._booster_pointer = self._native.lib.InitializeBoostingClassificationPacked(
+                    self._n_classes,
+                    len(feature_array),
+                    feature_array,
+                    len(feature_groups_array),
+                    feature_groups_array,
+                    feature_group_indexes,
+                    len(y_train),
+                    training_packed_data,
+                    None,
+                    y_train,
+                    scores_train,
+                    len(y_val),
+                    validation_packed_data,
+                    None,
+                    y_val,
+                    scores_val,
+                    n_inner_bags,
+                    random_state,
+                    optional_temp_params,
+                )
+                if not self._booster_pointer:  # pragma: no cover
+                    raise MemoryError(
+                        "Out of memory in InitializeBoostingClassificationPacked"
+                    )
+            elif self._model_type == "regression":
+                self._booster_pointer = self._native.lib.InitializeBoostingRegressionPacked(
+                    len(feature_array),
+                    feature_array,
+                    len(feature_groups_array),
+                    feature_groups_array,
+                    feature_group_indexes,
+                    len(y_train),
+                    training_packed_data,
+                    None,
+                    y_train,
+                    scores_train,
+                    len(y_val),
+                    validation_packed_data,
+                    None,
+                    y_val,
+                    scores_val,
+                    n_inner_bags,
+                    random_state,
+                    optional_temp_params,
+                )
+                if not self._booster_pointer:  # pragma: no cover
+                    raise MemoryError(
+                        "Out of memory in InitializeBoostingRegressionPacked"
+                    )
+            else:  # pragma: no cover
+                raise AttributeError("Unrecognized model_type")
+        finally:
+            # the booster holds its own reference to the packed data
+            self._native.lib.ClosePackedData(training_packed_data)
+            self._native.lib.ClosePackedData(validation_packed_data)
+
     def close(self):
         """ Deallocates C objects used to boost EBM. """
         log.info("Deallocation boosting start")
+        if self._run_work is not None:
+            # FreeBoosting would wait for the run too, but the work token needs to be released
+            self._native.lib.FinishWork(self._run_work, None)
+            self._run_work = None
         self._native.lib.FreeBoosting(self._booster_pointer)
         log.info("Deallocation boosting end")
 
@@ -718,6 +1894,161 @@ class NativeEBMBoosting:
         # log.debug("Boosting step end")
         return metric_output.value
 
+    def boosting_run(
+        self,
+        learning_rate,
+        max_leaves,
+        min_samples_leaf,
+        max_rounds,
+        early_stopping_tolerance,
+        early_stopping_rounds,
+        progress_callback=None,
+    ):
+
+        """ Conducts up to max_rounds cyclic rounds of boosting steps
+            over every feature group inside the native library.
+
+        Args:
+            learning_rate: Learning rate as a float.
+            max_leaves: Max leaf nodes on feature step.
+            min_samples_leaf: Min observations required to split.
+            max_rounds: Max number of rounds over all feature groups.
+            early_stopping_tolerance: Min improvement of the validation
+                metric that resets the early stopping count.
+            early_stopping_rounds: Number of rounds without improvement
+                before stopping, or negative to disable early stopping.
+            progress_callback: Optional function called with the round index
+                and the best validation metric after each round. Boosting stops
+                if it returns True.
+
+        Returns:
+            Best validation loss and the index of the last round.
+        """
+
+        if progress_callback is None:
+            typed_progress_func = self._native._BoostingProgressFuncType()
+        else:
+
+            def native_progress(index_round, metric, context):
+                return 1 if progress_callback(index_round, metric) else 0
+
+            typed_progress_func = self._native._BoostingProgressFuncType(
+                native_progress
+            )
+
+        metric_output = ct.c_double(0.0)
+        index_round_output = ct.c_longlong(0)
+        return_code = self._native.lib.BoostingRun(
+            self._booster_pointer,
+            max_rounds,
+            learning_rate,
+            max_leaves - 1,
+            min_samples_leaf,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            typed_progress_func,
+            None,
+            ct.byref(metric_output),
+            ct.byref(index_round_output),
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in BoostingRun")
+
+        return metric_output.value, index_round_output.value
+
+    def boosting_run_async(
+        self,
+        learning_rate,
+        max_leaves,
+        min_samples_leaf,
+        max_rounds,
+        early_stopping_tolerance,
+        early_stopping_rounds,
+        progress_callback=None,
+    ):
+
+        """ Starts boosting_run on the native thread pool and returns immediately.
+            Runs on different boosters execute at the same time.
+
+        Args:
+            The same as boosting_run, although progress_callback is called
+            from a native thread.
+
+        Returns:
+            The native work pointer, which wait_for_boosting_runs accepts.
+        """
+
+        if self._run_work is not None:  # pragma: no cover
+            raise Exception("the previous boosting run has not been finished")
+
+        if progress_callback is None:
+            typed_progress_func = self._native._BoostingProgressFuncType()
+        else:
+
+            def native_progress(index_round, metric, context):
+                return 1 if progress_callback(index_round, metric) else 0
+
+            typed_progress_func = self._native._BoostingProgressFuncType(
+                native_progress
+            )
+
+        # the native thread writes into these until the run finishes, so we hold on to them
+        self._run_progress_func = typed_progress_func
+        self._run_index_round = ct.c_longlong(0)
+        self._run_work = self._native.lib.BoostingRunAsync(
+            self._booster_pointer,
+            max_rounds,
+            learning_rate,
+            max_leaves - 1,
+            min_samples_leaf,
+            early_stopping_rounds,
+            early_stopping_tolerance,
+            typed_progress_func,
+            None,
+            ct.byref(self._run_index_round),
+        )
+        if self._run_work is None:  # pragma: no cover
+            raise Exception("Out of memory in BoostingRunAsync")
+
+        return self._run_work
+
+    def finish_boosting_run(self):
+        """ Waits for the run that boosting_run_async started.
+
+        Returns:
+            Best validation loss and the index of the last round.
+        """
+
+        metric_output = ct.c_double(0.0)
+        return_code = self._native.lib.FinishWork(
+            self._run_work, ct.byref(metric_output)
+        )
+        self._run_work = None
+        self._run_progress_func = None
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in BoostingRun")
+
+        return metric_output.value, self._run_index_round.value
+
+    @staticmethod
+    def wait_for_boosting_runs(works):
+        """ Blocks until at least one of the works from boosting_run_async completes.
+
+        Returns:
+            The index of a completed work.
+        """
+
+        native = Native.get_native_singleton()
+        works_array = (ct.c_void_p * len(works))(*works)
+        index_completed = ct.c_longlong(-1)
+        return_code = native.lib.WaitForWork(
+            len(works), works_array, 0, ct.byref(index_completed)
+        )
+        if return_code != 0 or index_completed.value < 0:  # pragma: no cover
+            raise Exception("WaitForWork failed")
+
+        return index_completed.value
+
     def _get_feature_group_shape(self, feature_group_index):
         # TODO PK do this once during construction so that we don't have to do it again
         #         and so that we don't have to store self._features & self._feature_groups
@@ -739,6 +2070,32 @@ class NativeEBMBoosting:
         shape = tuple(dimensions)
         return shape
 
+    def _copy_model_feature_group(self, copy_function, feature_group_index):
+        # the native tensors have the first feature changing fastest.  We return pairs indexed by
+        # [feature 0, feature 1] and other groups indexed by their features in reverse order, so we ask
+        # the native code to write straight into that layout instead of copying and transposing here
+        n_features = len(self._feature_groups[feature_group_index])
+        shape = self._get_feature_group_shape(feature_group_index)
+        if n_features == 2:
+            shape = (shape[1], shape[0]) + shape[2:]
+        array = np.empty(shape, dtype=np.double, order="C")
+
+        n_scores = EBMUtils.get_count_scores_c(self._n_classes)
+        strides = []
+        for dimension in range(n_features):
+            axis = dimension if n_features == 2 else n_features - 1 - dimension
+            strides.append(array.strides[axis])
+        strides.append(array.strides[-1] if n_scores > 1 else array.itemsize)
+        strides = np.array(strides, dtype=np.int64)
+
+        return_code = copy_function(
+            self._booster_pointer, feature_group_index, strides, array.ctypes.data
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Copying the model of feature group {0} failed".format(feature_group_index))
+
+        return array
+
     def _get_best_model_feature_group(self, feature_group_index):
         """ Returns best model/function according to validation set
             for a given feature group.
@@ -766,24 +2123,10 @@ class NativeEBMBoosting:
             # TODO PK make sure the None value here is handled by our caller
             return None
 
-        array_p = self._native.lib.GetBestModelFeatureGroup(
-            self._booster_pointer, feature_group_index
+        return self._copy_model_feature_group(
+            self._native.lib.CopyBestModelFeatureGroup, feature_group_index
         )
 
-        if not array_p:  # pragma: no cover
-            raise MemoryError("Out of memory in GetBestModelFeatureGroup")
-
-        shape = self._get_feature_group_shape(feature_group_index)
-
-        array = Native.make_ndarray(array_p, shape, dtype=np.double)
-        if len(self._feature_groups[feature_group_index]) == 2:
-            if 2 < self._n_classes:
-                array = np.ascontiguousarray(np.transpose(array, (1, 0, 2)))
-            else:
-                array = np.ascontiguousarray(np.transpose(array, (1, 0)))
-
-        return array
-
     def get_best_model(self):
         model = []
         for index in range(len(self._feature_groups)):
@@ -819,24 +2162,10 @@ class NativeEBMBoosting:
             # TODO PK make sure the None value here is handled by our caller
             return None
 
-        array_p = self._native.lib.GetCurrentModelFeatureGroup(
-            self._booster_pointer, feature_group_index
+        return self._copy_model_feature_group(
+            self._native.lib.CopyCurrentModelFeatureGroup, feature_group_index
         )
 
-        if not array_p:  # pragma: no cover
-            raise MemoryError("Out of memory in GetCurrentModelFeatureGroup")
-
-        shape = self._get_feature_group_shape(feature_group_index)
-
-        array = Native.make_ndarray(array_p, shape, dtype=np.double)
-        if len(self._feature_groups[feature_group_index]) == 2:
-            if 2 < self._n_classes:
-                array = np.ascontiguousarray(np.transpose(array, (1, 0, 2)))
-            else:
-                array = np.ascontiguousarray(np.transpose(array, (1, 0)))
-
-        return array
-
     # TODO: Needs test.
     def get_current_model(self):
         model = []
@@ -901,6 +2230,9 @@ class NativeEBMInteraction:
         # Store args
         feature_array = Native.convert_features_to_c(features)
 
+        # boosting reads strided columns, but our interaction initialization needs a C-ordered int64 matrix
+        X = np.ascontiguousarray(X, dtype=np.int64)
+
         n_scores = EBMUtils.get_count_scores_c(n_classes)
         if scores is None:  # pragma: no cover
             scores = np.zeros(len(y) * n_scores, dtype=np.float64, order="C")
@@ -985,6 +2317,47 @@ class NativeEBMInteraction:
         log.info("Fast interaction score end")
         return score.value
 
+    def get_interaction_scores_pairs(self, feature_index_pairs, min_samples_leaf):
+        """ Provides scores for many pairs of features in one native call. Higher is better."""
+        log.info("Fast interaction pair scores start")
+        feature_index_pairs = np.array(feature_index_pairs, dtype=np.int64).reshape(-1)
+        scores = np.zeros(len(feature_index_pairs) // 2, dtype=np.float64, order="C")
+        return_code = self._native.lib.CalculateInteractionScorePairs(
+            self._interaction_pointer,
+            len(scores),
+            feature_index_pairs,
+            min_samples_leaf,
+            scores,
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in CalculateInteractionScorePairs")
+
+        log.info("Fast interaction pair scores end")
+        return scores
+
+    def get_interaction_top_pairs(self, feature_index_pairs, min_samples_leaf, top_k):
+        """ Provides the indexes and scores of the best top_k pairs of features, best first."""
+        log.info("Fast interaction top pairs start")
+        feature_index_pairs = np.array(feature_index_pairs, dtype=np.int64).reshape(-1)
+        count_pairs = len(feature_index_pairs) // 2
+        count_top = min(top_k, count_pairs)
+        indexes = np.zeros(count_top, dtype=np.int64, order="C")
+        scores = np.zeros(count_top, dtype=np.float64, order="C")
+        return_code = self._native.lib.CalculateInteractionScoreTopPairs(
+            self._interaction_pointer,
+            count_pairs,
+            feature_index_pairs,
+            min_samples_leaf,
+            count_top,
+            indexes,
+            scores,
+        )
+        if return_code != 0:  # pragma: no cover
+            raise Exception("Out of memory in CalculateInteractionScoreTopPairs")
+
+        log.info("Fast interaction top pairs end")
+        return indexes, scores
+
 
 class NativeHelper:
     @staticmethod
@@ -1011,8 +2384,6 @@ class NativeHelper:
         optional_temp_params=None,
     ):
 
-        min_metric = np.inf
-        episode_index = 0
         with closing(
             NativeEBMBoosting(
                 model_type,
@@ -1030,43 +2401,28 @@ class NativeHelper:
                 optional_temp_params,
             )
         ) as native_ebm_boosting:
-            no_change_run_length = 0
-            bp_metric = np.inf
             log.info("Start boosting {0}".format(name))
-            for episode_index in range(max_rounds):
-                if episode_index % 10 == 0:
-                    log.debug("Sweep Index for {0}: {1}".format(name, episode_index))
-                    log.debug("Metric: {0}".format(min_metric))
-
-                for feature_group_index in range(len(feature_groups)):
-                    curr_metric = native_ebm_boosting.boosting_step(
-                        feature_group_index=feature_group_index,
-                        learning_rate=learning_rate,
-                        max_leaves=max_leaves,
-                        min_samples_leaf=min_samples_leaf,
-                    )
-
-                    min_metric = min(curr_metric, min_metric)
-
-                # TODO PK this early_stopping_tolerance is a little inconsistent
-                #      since it triggers intermittently and only re-triggers if the
-                #      threshold is re-passed, but not based on a smooth windowed set
-                #      of checks.  We can do better by keeping a list of the last
-                #      number of measurements to have a consistent window of values.
-                #      If we only cared about the metric at the start and end of the epoch
-                #      window a circular buffer would be best choice with O(1).
-                if no_change_run_length == 0:
-                    bp_metric = min_metric
-                if min_metric + early_stopping_tolerance < bp_metric:
-                    no_change_run_length = 0
-                else:
-                    no_change_run_length += 1
 
-                if (
-                    early_stopping_rounds >= 0
-                    and no_change_run_length >= early_stopping_rounds
-                ):
-                    break
+            progress_callback = None
+            if log.isEnabledFor(logging.DEBUG):
+
+                def progress_callback(index_round, metric):
+                    if index_round % 10 == 0:
+                        log.debug("Sweep Index for {0}: {1}".format(name, index_round))
+                        log.debug("Metric: {0}".format(metric))
+                    return False
+
+            # the rounds and the early stopping checks run natively, which
+            # saves us a ctypes transition for every boosting step
+            min_metric, episode_index = native_ebm_boosting.boosting_run(
+                learning_rate=learning_rate,
+                max_leaves=max_leaves,
+                min_samples_leaf=min_samples_leaf,
+                max_rounds=max_rounds,
+                early_stopping_tolerance=early_stopping_tolerance,
+                early_stopping_rounds=early_stopping_rounds,
+                progress_callback=progress_callback,
+            )
 
             log.info(
                 "End boosting {0}, Best Metric: {1}, Num Rounds: {2}".format(
@@ -1079,6 +2435,96 @@ class NativeHelper:
 
         return model_update, min_metric, episode_index
 
+    @staticmethod
+    def cyclic_gradient_boost_concurrent(
+        model_type,
+        n_classes,
+        features,
+        jobs,
+        n_inner_bags,
+        learning_rate,
+        max_leaves,
+        min_samples_leaf,
+        max_rounds,
+        early_stopping_tolerance,
+        early_stopping_rounds,
+        n_concurrent,
+        optional_temp_params=None,
+    ):
+        """ Boosts a model for each job inside this process, with up to
+            n_concurrent boosters running at the same time on the native
+            thread pool. Each model is identical to the one that
+            cyclic_gradient_boost returns, but we avoid the process fan-out
+            of joblib and the copy of the data that each process needs.
+
+        Args:
+            jobs: List of dicts with the feature_groups, X_train, y_train,
+                scores_train, X_val, y_val, scores_val, random_state and name
+                arguments of cyclic_gradient_boost.
+            n_concurrent: Max number of boosters that exist at once.
+            The other arguments are those of cyclic_gradient_boost.
+
+        Returns:
+            A list with the model_update, min_metric and episode_index of each job.
+        """
+
+        results = [None] * len(jobs)
+        # pairs of the job index and the booster for the runs in progress
+        running = []
+        next_job = 0
+        try:
+            while next_job < len(jobs) or len(running) != 0:
+                # boosters are created as the earlier ones finish, so we never hold more
+                # than n_concurrent copies of the data
+                while next_job < len(jobs) and len(running) < max(n_concurrent, 1):
+                    job = jobs[next_job]
+                    native_ebm_boosting = NativeEBMBoosting(
+                        model_type,
+                        n_classes,
+                        features,
+                        job["feature_groups"],
+                        job["X_train"],
+                        job["y_train"],
+                        job["scores_train"],
+                        job["X_val"],
+                        job["y_val"],
+                        job["scores_val"],
+                        n_inner_bags,
+                        job["random_state"],
+                        optional_temp_params,
+                    )
+                    running.append((next_job, native_ebm_boosting))
+                    next_job += 1
+
+                    log.info("Start boosting {0}".format(job["name"]))
+                    native_ebm_boosting.boosting_run_async(
+                        learning_rate=learning_rate,
+                        max_leaves=max_leaves,
+                        min_samples_leaf=min_samples_leaf,
+                        max_rounds=max_rounds,
+                        early_stopping_tolerance=early_stopping_tolerance,
+                        early_stopping_rounds=early_stopping_rounds,
+                    )
+
+                index_running = NativeEBMBoosting.wait_for_boosting_runs(
+                    [x[1]._run_work for x in running]
+                )
+                index_job, native_ebm_boosting = running.pop(index_running)
+                with closing(native_ebm_boosting):
+                    min_metric, episode_index = native_ebm_boosting.finish_boosting_run()
+                    log.info(
+                        "End boosting {0}, Best Metric: {1}, Num Rounds: {2}".format(
+                            jobs[index_job]["name"], min_metric, episode_index
+                        )
+                    )
+                    model_update = native_ebm_boosting.get_best_model()
+                results[index_job] = (model_update, min_metric, episode_index)
+        finally:
+            for _, native_ebm_boosting in running:
+                native_ebm_boosting.close()
+
+        return results
+
     @staticmethod
     def get_interactions(
         n_interactions,
@@ -1099,10 +2545,22 @@ class NativeHelper:
                 model_type, n_classes, features, X, y, scores, optional_temp_params
             )
         ) as native_ebm_interactions:
-            for feature_group in iter_feature_groups:
-                score = native_ebm_interactions.get_interaction_score(
-                    feature_group, min_samples_leaf,
+            feature_groups = list(iter_feature_groups)
+            # pairs are scored together so that the native code can share its passes over the data
+            pairs = [x for x in feature_groups if len(x) == 2]
+            pair_scores = {}
+            if len(pairs) != 0:
+                scores = native_ebm_interactions.get_interaction_scores_pairs(
+                    pairs, min_samples_leaf,
                 )
+                pair_scores = dict(zip(map(tuple, pairs), scores))
+            for feature_group in feature_groups:
+                if len(feature_group) == 2:
+                    score = float(pair_scores[tuple(feature_group)])
+                else:
+                    score = native_ebm_interactions.get_interaction_score(
+                        feature_group, min_samples_leaf,
+                    )
                 interaction_scores.append((feature_group, score))
 
         ranked_scores = list(
@@ -106,14 +106,11 @@ class EBMUtils:
         if not is_train:
             X_train, y_train = None, None
 
-        # TODO PK doing a fortran re-ordering here (and an extra copy) isn't the most efficient way
-        #         push the re-ordering right to our first call to fit(..) AND stripe convert
-        #         groups of rows at once and they process them in fortran order after that
-        # change to Fortran ordering on our data, which is more efficient in terms of memory accesses
-        # AND our C code expects it in that ordering
+        # our C code expects one row per feature.  The transpose is a view, and boosting packs the
+        # strided rows directly, so we don't copy the data here
         if X_train is not None:
-            X_train = np.ascontiguousarray(X_train.T)
-        X_val = np.ascontiguousarray(X_val.T)
+            X_train = X_train.T
+        X_val = X_val.T
 
         return X_train, X_val, y_train, y_val
 
@@ -127,7 +124,7 @@ class EBMUtils:
                 # NOTE: Ordinal only handled at native, override.
                 # 'type': col_types[col_idx],
                 "type": "continuous",
-                # NOTE: Missing not implemented at native, always set to false.
+                # NOTE: Native handles missing in bin 0, but our binning doesn't emit a missing bin yet.
                 "has_missing": False,
                 "n_bins": col_n_bins[col_idx],
             }
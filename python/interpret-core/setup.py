@@ -50,7 +50,7 @@ package_data = {
     ]
 }
 sklearn_dep = "scikit-learn>=0.18.1"
-joblib_dep = "joblib>=0.11"
+joblib_dep = "joblib>=0.12"
 extras = {
     # Core
     "required": [
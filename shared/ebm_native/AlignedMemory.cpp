@@ -0,0 +1,307 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdint.h> // uintptr_t
+#include <atomic>
+#include <limits> // numeric_limits
+
+#ifdef __linux__
+#include <sys/mman.h> // mmap, munmap, madvise
+#include <sys/syscall.h> // SYS_mbind, SYS_get_mempolicy
+#include <unistd.h> // syscall
+#endif // __linux__
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
+
+// huge pages are 2MB on the platforms that we support.  Smaller allocations would waste most of their huge page
+constexpr static size_t k_cBytesHugePage = size_t { 2 } * 1024 * 1024;
+// when we map memory only to interleave it we round up to ordinary pages instead.  The kernel rounds up further if 
+// its pages are bigger
+constexpr static size_t k_cBytesPage = size_t { 4096 };
+
+// we keep this just before the memory that we return, so AlignedFree can find what it needs to release
+struct AllocationHeader final {
+   void * m_pAllocation;
+   size_t m_cBytesAllocation;
+   MemorySubsystem m_memorySubsystem;
+   bool m_bMapped;
+};
+static_assert(sizeof(AllocationHeader) <= k_cBytesAlignment, "AllocationHeader needs to fit within our alignment");
+static_assert(std::is_standard_layout<AllocationHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<AllocationHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<AllocationHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// these have static storage and are therefore zero before anything can allocate
+static std::atomic<size_t> g_acBytesCurrent[k_cMemorySubsystems];
+static std::atomic<size_t> g_acBytesPeak[k_cMemorySubsystems];
+static std::atomic<IntEbmType> g_hugePages { HugePagesOff };
+static std::atomic<IntEbmType> g_numaPlacement { NumaPlacementFirstTouch };
+
+static void AddBytes(const MemorySubsystem memorySubsystem, const size_t cBytes) {
+   const size_t iMemorySubsystem = static_cast<size_t>(memorySubsystem);
+   EBM_ASSERT(iMemorySubsystem < k_cMemorySubsystems);
+   // the statistics are only reported, so they don't need to order any of our other memory operations
+   const size_t cBytesCurrent = g_acBytesCurrent[iMemorySubsystem].fetch_add(cBytes, std::memory_order_relaxed) + cBytes;
+   size_t cBytesPeak = g_acBytesPeak[iMemorySubsystem].load(std::memory_order_relaxed);
+   // compare_exchange_weak reloads cBytesPeak on failure, so we stop once any thread has recorded a peak at least this high
+   while(cBytesPeak < cBytesCurrent &&
+      !g_acBytesPeak[iMemorySubsystem].compare_exchange_weak(cBytesPeak, cBytesCurrent, std::memory_order_relaxed)) {
+   }
+}
+
+static void SubtractBytes(const MemorySubsystem memorySubsystem, const size_t cBytes) {
+   const size_t iMemorySubsystem = static_cast<size_t>(memorySubsystem);
+   EBM_ASSERT(iMemorySubsystem < k_cMemorySubsystems);
+   EBM_ASSERT(cBytes <= g_acBytesCurrent[iMemorySubsystem].load(std::memory_order_relaxed));
+   g_acBytesCurrent[iMemorySubsystem].fetch_sub(cBytes, std::memory_order_relaxed);
+}
+
+#ifdef __linux__
+#if defined(SYS_mbind) && defined(SYS_get_mempolicy)
+// the values of MPOL_INTERLEAVE and MPOL_F_MEMS_ALLOWED in linux/mempolicy.h.  They are part of the kernel ABI, and 
+// defining them here means that we don't need the libnuma headers to build
+constexpr static long k_mpolInterleave = 3;
+constexpr static unsigned long k_mpolFlagMemsAllowed = 1 << 2;
+// enough bits for the largest node count that linux kernels are normally configured for
+constexpr static size_t k_cNumaNodesMax = 1024;
+constexpr static size_t k_cBitsPerNodeMaskUnit = sizeof(unsigned long) * 8;
+
+// spreads the pages of a mapping that nobody has touched yet round robin over the NUMA nodes that we are allowed to 
+// use.  This is only a placement hint, so if the kernel refuses we keep the default first touch placement
+static void InterleaveNumaNodes(void * const pMapped, const size_t cBytes) {
+   unsigned long aNodeMask[k_cNumaNodesMax / k_cBitsPerNodeMaskUnit];
+   int mode;
+   if(0 != syscall(SYS_get_mempolicy, &mode, aNodeMask, k_cNumaNodesMax, nullptr, k_mpolFlagMemsAllowed)) {
+      LOG_0(TraceLevelInfo, "INFO InterleaveNumaNodes get_mempolicy failed.  Using first touch placement");
+      return;
+   }
+   size_t cNodes = 0;
+   for(size_t iUnit = 0; iUnit < k_cNumaNodesMax / k_cBitsPerNodeMaskUnit; ++iUnit) {
+      unsigned long nodeMaskUnit = aNodeMask[iUnit];
+      while(0 != nodeMaskUnit) {
+         nodeMaskUnit &= nodeMaskUnit - 1;
+         ++cNodes;
+      }
+   }
+   if(cNodes <= size_t { 1 }) {
+      // single node machines are the common case, and there is nothing to spread over
+      return;
+   }
+   // the kernel drops the last bit of maxnode for mbind, so we pass one more than the bits in our mask
+   if(0 != syscall(SYS_mbind, pMapped, cBytes, k_mpolInterleave, aNodeMask, k_cNumaNodesMax + 1, 0)) {
+      LOG_0(TraceLevelInfo, "INFO InterleaveNumaNodes mbind failed.  Using first touch placement");
+   }
+}
+#else // defined(SYS_mbind) && defined(SYS_get_mempolicy)
+static void InterleaveNumaNodes(void * const pMapped, const size_t cBytes) {
+   UNUSED(pMapped);
+   UNUSED(cBytes);
+   LOG_0(TraceLevelInfo, "INFO InterleaveNumaNodes this platform does not have mbind.  Using first touch placement");
+}
+#endif // defined(SYS_mbind) && defined(SYS_get_mempolicy)
+
+// returns nullptr if we can't map the pages, in which case our caller uses malloc instead
+static void * MapPages(const IntEbmType hugePages, const size_t cBytes) {
+   void * pMapped = MAP_FAILED;
+#ifdef MAP_HUGETLB
+   if(HugePagesExplicit == hugePages) {
+      pMapped = mmap(nullptr, cBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if(MAP_FAILED == pMapped) {
+         // this happens whenever the administrator hasn't reserved enough huge pages, so it isn't an error
+         LOG_0(TraceLevelInfo, "INFO MapHugePages explicit huge pages are unavailable.  Using transparent huge pages");
+      }
+   }
+#else // MAP_HUGETLB
+   UNUSED(hugePages);
+#endif // MAP_HUGETLB
+   if(MAP_FAILED == pMapped) {
+      pMapped = mmap(nullptr, cBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if(MAP_FAILED == pMapped) {
+         LOG_0(TraceLevelWarning, "WARNING MapHugePages mmap");
+         return nullptr;
+      }
+#ifdef MADV_HUGEPAGE
+      if(HugePagesOff != hugePages) {
+         // this is only advice.  Kernels that have transparent huge pages disabled ignore it, which is fine
+         madvise(pMapped, cBytes, MADV_HUGEPAGE);
+      }
+#endif // MADV_HUGEPAGE
+   }
+   return pMapped;
+}
+#endif // __linux__
+
+// the page size that we map cBytes with, or 0 if cBytes comes from malloc instead
+static size_t GetMappedPageSize(const MemorySubsystem memorySubsystem, const size_t cBytes) {
+#ifdef __linux__
+   const IntEbmType hugePages = g_hugePages.load(std::memory_order_relaxed);
+   // each thread buffer is only used by the thread that owns it, so first touch already places it on the right node
+   const bool bInterleave = MemorySubsystem::ThreadBuffers != memorySubsystem &&
+      NumaPlacementFirstTouch != g_numaPlacement.load(std::memory_order_relaxed);
+   if((HugePagesOff != hugePages || bInterleave) && k_cBytesHugePage <= cBytes) {
+      return HugePagesOff != hugePages ? k_cBytesHugePage : k_cBytesPage;
+   }
+#else // __linux__
+   UNUSED(memorySubsystem);
+   UNUSED(cBytes);
+#endif // __linux__
+   return 0;
+}
+
+extern size_t GetAlignedMallocBytes(const MemorySubsystem memorySubsystem, const size_t cBytes) {
+   EBM_ASSERT(static_cast<size_t>(memorySubsystem) < k_cMemorySubsystems);
+   if(0 == cBytes) {
+      return 0;
+   }
+   if(IsAddError(cBytes, k_cBytesAlignment + (k_cBytesAlignment - 1))) {
+      return std::numeric_limits<size_t>::max();
+   }
+   const size_t cBytesPage = GetMappedPageSize(memorySubsystem, cBytes);
+   if(0 != cBytesPage) {
+      const size_t cBytesPages = cBytes + k_cBytesAlignment;
+      if(!IsAddError(cBytesPages, cBytesPage - 1)) {
+         return (cBytesPages + (cBytesPage - 1)) / cBytesPage * cBytesPage;
+      }
+   }
+   return cBytes + k_cBytesAlignment + (k_cBytesAlignment - 1);
+}
+
+extern void * AlignedMalloc(const MemorySubsystem memorySubsystem, const size_t cBytes) {
+   EBM_ASSERT(static_cast<size_t>(memorySubsystem) < k_cMemorySubsystems);
+   if(UNLIKELY(0 == cBytes)) {
+      return nullptr;
+   }
+   // we need room for our header, plus up to k_cBytesAlignment - 1 bytes to align the memory that we return
+   if(UNLIKELY(IsAddError(cBytes, k_cBytesAlignment + (k_cBytesAlignment - 1)))) {
+      return nullptr;
+   }
+
+   void * pAllocation = nullptr;
+   size_t cBytesAllocation = 0;
+   bool bMapped = false;
+   char * pRet = nullptr;
+
+#ifdef __linux__
+   const size_t cBytesPage = GetMappedPageSize(memorySubsystem, cBytes);
+   if(0 != cBytesPage) {
+      const IntEbmType hugePages = g_hugePages.load(std::memory_order_relaxed);
+      const bool bInterleave = MemorySubsystem::ThreadBuffers != memorySubsystem &&
+         NumaPlacementFirstTouch != g_numaPlacement.load(std::memory_order_relaxed);
+      // mmap memory is page aligned, so our header takes the first k_cBytesAlignment bytes and the rest is aligned
+      const size_t cBytesPages = cBytes + k_cBytesAlignment;
+      if(!IsAddError(cBytesPages, cBytesPage - 1)) {
+         cBytesAllocation = (cBytesPages + (cBytesPage - 1)) / cBytesPage * cBytesPage;
+         pAllocation = MapPages(hugePages, cBytesAllocation);
+         if(nullptr != pAllocation) {
+            if(bInterleave) {
+               InterleaveNumaNodes(pAllocation, cBytesAllocation);
+            }
+            bMapped = true;
+            pRet = static_cast<char *>(pAllocation) + k_cBytesAlignment;
+         }
+      }
+   }
+#endif // __linux__
+
+   if(nullptr == pAllocation) {
+      cBytesAllocation = cBytes + k_cBytesAlignment + (k_cBytesAlignment - 1);
+      pAllocation = malloc(cBytesAllocation);
+      if(UNLIKELY(nullptr == pAllocation)) {
+         return nullptr;
+      }
+      const uintptr_t iHeaderEnd = reinterpret_cast<uintptr_t>(pAllocation) + sizeof(AllocationHeader);
+      const uintptr_t iRetUnaligned = iHeaderEnd + (k_cBytesAlignment - 1);
+      pRet = reinterpret_cast<char *>(iRetUnaligned - iRetUnaligned % k_cBytesAlignment);
+   }
+   EBM_ASSERT(0 == reinterpret_cast<uintptr_t>(pRet) % k_cBytesAlignment);
+
+   // sizeof(AllocationHeader) is a multiple of its alignment and pRet is aligned more strictly, so the header is aligned
+   AllocationHeader * const pHeader = reinterpret_cast<AllocationHeader *>(pRet - sizeof(AllocationHeader));
+   pHeader->m_pAllocation = pAllocation;
+   pHeader->m_cBytesAllocation = cBytesAllocation;
+   pHeader->m_memorySubsystem = memorySubsystem;
+   pHeader->m_bMapped = bMapped;
+
+   // we count the bytes that we hold, including our header and any huge page rounding, since that's what the host sees
+   AddBytes(memorySubsystem, cBytesAllocation);
+   return pRet;
+}
+
+extern void AlignedFree(void * const p) {
+   if(nullptr != p) {
+      const AllocationHeader * const pHeader =
+         reinterpret_cast<const AllocationHeader *>(static_cast<char *>(p) - sizeof(AllocationHeader));
+      SubtractBytes(pHeader->m_memorySubsystem, pHeader->m_cBytesAllocation);
+#ifdef __linux__
+      if(pHeader->m_bMapped) {
+         munmap(pHeader->m_pAllocation, pHeader->m_cBytesAllocation);
+         return;
+      }
+#else // __linux__
+      EBM_ASSERT(!pHeader->m_bMapped);
+#endif // __linux__
+      free(pHeader->m_pAllocation);
+   }
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetHugePages(IntEbmType hugePages) {
+   if(HugePagesOff != hugePages && HugePagesTransparent != hugePages && HugePagesExplicit != hugePages) {
+      LOG_0(TraceLevelError, "ERROR SetHugePages hugePages must be HugePagesOff, HugePagesTransparent or HugePagesExplicit");
+      return;
+   }
+   LOG_N(TraceLevelInfo, "SetHugePages hugePages=%" IntEbmTypePrintf, hugePages);
+   // memory that we already allocated keeps the pages that it has, which AlignedFree handles
+   g_hugePages.store(hugePages, std::memory_order_relaxed);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetNumaPlacement(IntEbmType numaPlacement) {
+   if(NumaPlacementFirstTouch != numaPlacement && NumaPlacementInterleave != numaPlacement && 
+      NumaPlacementInterleavePinned != numaPlacement) 
+   {
+      LOG_0(TraceLevelError, 
+         "ERROR SetNumaPlacement numaPlacement must be NumaPlacementFirstTouch, NumaPlacementInterleave or NumaPlacementInterleavePinned");
+      return;
+   }
+   LOG_N(TraceLevelInfo, "SetNumaPlacement numaPlacement=%" IntEbmTypePrintf, numaPlacement);
+   // like SetHugePages, memory that we already allocated stays where it is
+   g_numaPlacement.store(numaPlacement, std::memory_order_relaxed);
+}
+
+extern IntEbmType GetNumaPlacement() {
+   return g_numaPlacement.load(std::memory_order_relaxed);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetMemoryStatistics(
+   IntEbmType memorySubsystem,
+   IntEbmType * countBytesCurrentOut,
+   IntEbmType * countBytesPeakOut
+) {
+   if(memorySubsystem < 0 || static_cast<IntEbmType>(k_cMemorySubsystems) <= memorySubsystem) {
+      LOG_0(TraceLevelError, "ERROR GetMemoryStatistics memorySubsystem is not a valid MemorySubsystem* value");
+      return 1;
+   }
+   const size_t iMemorySubsystem = static_cast<size_t>(memorySubsystem);
+
+   if(nullptr != countBytesCurrentOut) {
+      const size_t cBytesCurrent = g_acBytesCurrent[iMemorySubsystem].load(std::memory_order_relaxed);
+      *countBytesCurrentOut = IsNumberConvertable<IntEbmType>(cBytesCurrent) ?
+         static_cast<IntEbmType>(cBytesCurrent) : std::numeric_limits<IntEbmType>::max();
+   }
+   if(nullptr != countBytesPeakOut) {
+      const size_t cBytesPeak = g_acBytesPeak[iMemorySubsystem].load(std::memory_order_relaxed);
+      *countBytesPeakOut = IsNumberConvertable<IntEbmType>(cBytesPeak) ?
+         static_cast<IntEbmType>(cBytesPeak) : std::numeric_limits<IntEbmType>::max();
+   }
+   return 0;
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef ALIGNED_MEMORY_H
+#define ALIGNED_MEMORY_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h" // MemorySubsystem*
+#include "EbmInternal.h" // INLINE_ALWAYS
+
+// every buffer from AlignedMalloc starts on a cache line, which is also the widest SIMD load that we make
+constexpr size_t k_cBytesAlignment = 64;
+
+// the subsystems that we keep memory statistics for.  These match the MemorySubsystem* constants in ebm_native.h
+enum class MemorySubsystem : size_t {
+   DataSet = static_cast<size_t>(MemorySubsystemDataSet),
+   PackedData = static_cast<size_t>(MemorySubsystemPackedData),
+   ThreadBuffers = static_cast<size_t>(MemorySubsystemThreadBuffers),
+};
+constexpr size_t k_cMemorySubsystems = 3;
+
+// AlignedMalloc is for our largest and hottest buffers.  It returns k_cBytesAlignment aligned memory that is
+// counted against memorySubsystem, and which might be backed by huge pages if SetHugePages asked for them or 
+// interleaved over the NUMA nodes if SetNumaPlacement asked for that.  The
+// memory MUST be released with AlignedFree and not free.  Returns nullptr on error, including for zero bytes
+extern void * AlignedMalloc(const MemorySubsystem memorySubsystem, const size_t cBytes);
+// it's legal to call AlignedFree on nullptr, just like for free()
+extern void AlignedFree(void * const p);
+// the bytes that AlignedMalloc would count against memorySubsystem for a buffer of cBytes with the current huge page
+// and NUMA settings, assuming that any mapping it asks for succeeds.  Returns the size_t maximum on overflow
+extern size_t GetAlignedMallocBytes(const MemorySubsystem memorySubsystem, const size_t cBytes);
+
+// the NumaPlacement* value from the last SetNumaPlacement call
+extern IntEbmType GetNumaPlacement();
+
+template<typename T>
+INLINE_ALWAYS T * AlignedMalloc(const MemorySubsystem memorySubsystem, const size_t cItems) {
+   static_assert(!std::is_same<T, void>::value, "use the untyped AlignedMalloc for void buffers");
+   if(UNLIKELY(IsMultiplyError(cItems, sizeof(T)))) {
+      return nullptr;
+   }
+   return static_cast<T *>(AlignedMalloc(memorySubsystem, cItems * sizeof(T)));
+}
+
+#endif // ALIGNED_MEMORY_H
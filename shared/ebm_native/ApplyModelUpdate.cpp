@@ -29,6 +29,8 @@ extern FloatEbmType ApplyModelUpdateValidation(
    const FloatEbmType * const aModelFeatureGroupUpdateTensor
 );
 
+extern FloatEbmType ApplyPendingModelUpdatesValidation(EbmBoostingState * const pEbmBoostingState);
+
 // a*PredictorScores = logOdds for binary classification
 // a*PredictorScores = logWeights for multiclass classification
 // a*PredictorScores = predictedValue for regression
@@ -62,15 +64,21 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
    // This is an acceptable compromise.  We protect our models since the user might want to extract them AFTER we overlfow our measurment metric
    // so we don't want to overflow the values to NaN or +-infinity there, and it's very cheap for us to check for overflows when applying the model
    pEbmBoostingState->GetCurrentModel()[iFeatureGroup]->AddExpandedWithBadValueProtection(aModelFeatureGroupUpdateTensor);
+   pEbmBoostingState->SetFeatureGroupChanged(iFeatureGroup);
 
    const FeatureGroup * const pFeatureGroup = pEbmBoostingState->GetFeatureGroups()[iFeatureGroup];
 
    if(0 != pEbmBoostingState->GetTrainingSet()->GetCountSamples()) {
+      PERFORMANCE_COUNTER_START(startApplyModelUpdateTraining);
       ApplyModelUpdateTraining(
          pEbmBoostingState,
          pFeatureGroup,
          aModelFeatureGroupUpdateTensor
       );
+      // we read the inputs and the targets, and update the scores and the residuals
+      PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startApplyModelUpdateTraining, PerformanceCounterApplyModelUpdateTraining,
+         GetPerformanceCounterSampleBytes(pEbmBoostingState->GetTrainingSet()->GetCountSamples(), pFeatureGroup,
+            size_t { 1 } + size_t { 2 } * GetVectorLength(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())));
    }
 
    FloatEbmType modelMetric = FloatEbmType { 0 };
@@ -86,11 +94,26 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
       // but it isn't guaranteed, so let's check for zero samples in the validation set this better way
       // https://stackoverflow.com/questions/31225264/what-is-the-result-of-comparing-a-number-with-nan
 
-      modelMetric = ApplyModelUpdateValidation(
-         pEbmBoostingState,
-         pFeatureGroup,
-         aModelFeatureGroupUpdateTensor
-      );
+      PERFORMANCE_COUNTER_START(startApplyModelUpdateValidation);
+      if(pEbmBoostingState->IsValidationDeferred()) {
+         pEbmBoostingState->AddPendingValidationUpdate(iFeatureGroup, aModelFeatureGroupUpdateTensor);
+         if(nullptr == pValidationMetricReturn) {
+            LOG_0(TraceLevelVerbose, "Exited ApplyModelFeatureGroupUpdateInternal with a deferred validation update");
+            return 0;
+         }
+         modelMetric = ApplyPendingModelUpdatesValidation(pEbmBoostingState);
+      } else {
+         modelMetric = ApplyModelUpdateValidation(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+      // we read the inputs and the targets, and update the scores.  Pending updates can read the inputs of several 
+      // feature groups, but we only count those of this one
+      PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startApplyModelUpdateValidation, PerformanceCounterApplyModelUpdateValidation,
+         GetPerformanceCounterSampleBytes(pEbmBoostingState->GetValidationSet()->GetCountSamples(), pFeatureGroup,
+            size_t { 1 } + GetVectorLength(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())));
 
       EBM_ASSERT(!std::isnan(modelMetric)); // NaNs can happen, but we should have converted them
       EBM_ASSERT(!std::isinf(modelMetric)); // +infinity can happen, but we should have converted it
@@ -103,20 +126,14 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
          // we keep on improving, so this is more likely than not, and we'll exit if it becomes negative a lot
          pEbmBoostingState->SetBestModelMetric(modelMetric);
 
-         // TODO : in the future don't copy over all SegmentedTensors.  We only need to copy the ones that changed, which we can detect if we 
-         // use a linked list and array lookup for the same data structure
-         size_t iModel = 0;
-         size_t iModelEnd = pEbmBoostingState->GetCountFeatureGroups();
-         do {
-            if(pEbmBoostingState->GetBestModel()[iModel]->Copy(*pEbmBoostingState->GetCurrentModel()[iModel])) {
-               if(nullptr != pValidationMetricReturn) {
-                  *pValidationMetricReturn = FloatEbmType { 0 }; // on error set it to something instead of random bits
-               }
-               LOG_0(TraceLevelVerbose, "Exited ApplyModelFeatureGroupUpdateInternal with memory allocation error in copy");
-               return 1;
+         // only the feature groups that changed since the last improvement differ from the best model
+         if(pEbmBoostingState->CopyChangedToBestModel()) {
+            if(nullptr != pValidationMetricReturn) {
+               *pValidationMetricReturn = FloatEbmType { 0 }; // on error set it to something instead of random bits
             }
-            ++iModel;
-         } while(iModel != iModelEnd);
+            LOG_0(TraceLevelVerbose, "Exited ApplyModelFeatureGroupUpdateInternal with memory allocation error in copy");
+            return 1;
+         }
       }
    }
    if(nullptr != pValidationMetricReturn) {
@@ -128,10 +145,9 @@ static IntEbmType ApplyModelFeatureGroupUpdateInternal(
 }
 
 // we made this a global because if we had put this variable inside the EbmBoostingState object, then we would need to dereference that before 
-// getting the count.  By making this global we can send a log message incase a bad EbmBoostingState object is sent into us
-// we only decrease the count if the count is non-zero, so at worst if there is a race condition then we'll output this log message more 
-// times than desired, but we can live with that
-static int g_cLogApplyModelFeatureGroupUpdateParametersMessages = 10;
+// getting the count.  By making this global we can send a log message incase a bad EbmBoostingState object is sent into us.
+// Concurrent slots call us from several threads, so the count is atomic
+static std::atomic<int> g_cLogApplyModelFeatureGroupUpdateParametersMessages { 10 };
 
 EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ApplyModelFeatureGroupUpdate(
    PEbmBoosting ebmBoosting,
@@ -26,7 +26,8 @@ public:
 
    ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
    ) {
@@ -50,10 +51,10 @@ public:
       const size_t cSamples = pTrainingSet->GetCountSamples();
       EBM_ASSERT(0 < cSamples);
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
       const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer();
-      FloatEbmType * pPredictorScores = pTrainingSet->GetPredictorScores();
-      const FloatEbmType * const pPredictorScoresEnd = pPredictorScores + cSamples * cVectorLength;
+      TFloat * pPredictorScores = pTrainingSet->GetPredictorScores<TFloat>();
+      const TFloat * const pPredictorScoresEnd = pPredictorScores + cSamples * cVectorLength;
       do {
          size_t targetData = static_cast<size_t>(*pTargetData);
          ++pTargetData;
@@ -68,8 +69,8 @@ public:
             const FloatEbmType smallChangeToPredictorScores = *pValues;
             ++pValues;
             // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-            const FloatEbmType predictorScore = *pPredictorScores + smallChangeToPredictorScores;
-            *pPredictorScores = predictorScore;
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<TFloat>(predictorScore);
             ++pPredictorScores;
             const FloatEbmType oneExp = EbmExp(predictorScore);
             *pExpVector = oneExp;
@@ -87,7 +88,7 @@ public:
                iVector
             );
             ++pExpVector;
-            *pResidualError = residualError;
+            *pResidualError = static_cast<TFloat>(residualError);
             ++pResidualError;
             ++iVector;
          } while(iVector < cVectorLength);
@@ -106,6 +107,24 @@ public:
          }
       } while(pPredictorScoresEnd != pPredictorScores);
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      // the training set stores its residuals and scores as float or FloatEbmType, but we compute in FloatEbmType
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 
 #ifndef EXPAND_BINARY_LOGITS
@@ -115,7 +134,8 @@ public:
 
    ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
    ) {
@@ -123,23 +143,40 @@ public:
       const size_t cSamples = pTrainingSet->GetCountSamples();
       EBM_ASSERT(0 < cSamples);
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
       const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer();
-      FloatEbmType * pPredictorScores = pTrainingSet->GetPredictorScores();
-      const FloatEbmType * const pPredictorScoresEnd = pPredictorScores + cSamples;
+      TFloat * pPredictorScores = pTrainingSet->GetPredictorScores<TFloat>();
+      const TFloat * const pPredictorScoresEnd = pPredictorScores + cSamples;
       const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[0];
       do {
          size_t targetData = static_cast<size_t>(*pTargetData);
          ++pTargetData;
          // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-         const FloatEbmType predictorScore = *pPredictorScores + smallChangeToPredictorScores;
-         *pPredictorScores = predictorScore;
+         const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+         *pPredictorScores = static_cast<TFloat>(predictorScore);
          ++pPredictorScores;
          const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData);
-         *pResidualError = residualError;
+         *pResidualError = static_cast<TFloat>(residualError);
          ++pResidualError;
       } while(pPredictorScoresEnd != pPredictorScores);
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 #endif // EXPAND_BINARY_LOGITS
 
@@ -149,7 +186,8 @@ public:
 
    ApplyModelUpdateTrainingZeroFeatures() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
    ) {
@@ -157,16 +195,33 @@ public:
       const size_t cSamples = pTrainingSet->GetCountSamples();
       EBM_ASSERT(0 < cSamples);
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cSamples;
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
+      const TFloat * const pResidualErrorEnd = pResidualError + cSamples;
       const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[0];
       do {
          // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-         const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegression(*pResidualError - smallChangeToPrediction);
-         *pResidualError = residualError;
+         const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
+         *pResidualError = static_cast<TFloat>(residualError);
          ++pResidualError;
       } while(pResidualErrorEnd != pResidualError);
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
@@ -184,7 +239,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          ApplyModelUpdateTrainingZeroFeatures<compilerLearningTypeOrCountTargetClassesPossible>::Func(
@@ -230,7 +285,8 @@ public:
 
    ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
@@ -267,15 +323,15 @@ public:
       EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
       const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
       const StorageDataType * pInputData = pTrainingSet->GetInputDataPointer(pFeatureGroup);
       const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer();
-      FloatEbmType * pPredictorScores = pTrainingSet->GetPredictorScores();
+      TFloat * pPredictorScores = pTrainingSet->GetPredictorScores<TFloat>();
 
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples * cVectorLength;
-      const FloatEbmType * pPredictorScoresExit = pPredictorScoresTrueEnd;
-      const FloatEbmType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      const TFloat * const pPredictorScoresTrueEnd = pPredictorScores + cSamples * cVectorLength;
+      const TFloat * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const TFloat * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
       if(cSamples <= cItemsPerBitPackedDataUnit) {
          goto one_last_loop;
       }
@@ -304,8 +360,8 @@ public:
                const FloatEbmType smallChangeToPredictorScores = *pValues;
                ++pValues;
                // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-               const FloatEbmType predictorScore = *pPredictorScores + smallChangeToPredictorScores;
-               *pPredictorScores = predictorScore;
+               const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+               *pPredictorScores = static_cast<TFloat>(predictorScore);
                ++pPredictorScores;
                const FloatEbmType oneExp = EbmExp(predictorScore);
                *pExpVector = oneExp;
@@ -323,7 +379,7 @@ public:
                   iVector
                );
                ++pExpVector;
-               *pResidualError = residualError;
+               *pResidualError = static_cast<TFloat>(residualError);
                ++pResidualError;
                ++iVector;
             } while(iVector < cVectorLength);
@@ -352,6 +408,26 @@ public:
          goto one_last_loop;
       }
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 
 #ifndef EXPAND_BINARY_LOGITS
@@ -361,7 +437,8 @@ public:
 
    ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
@@ -384,15 +461,15 @@ public:
       EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
       const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
       const StorageDataType * pInputData = pTrainingSet->GetInputDataPointer(pFeatureGroup);
       const StorageDataType * pTargetData = pTrainingSet->GetTargetDataPointer();
-      FloatEbmType * pPredictorScores = pTrainingSet->GetPredictorScores();
+      TFloat * pPredictorScores = pTrainingSet->GetPredictorScores<TFloat>();
 
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pPredictorScoresTrueEnd = pPredictorScores + cSamples;
-      const FloatEbmType * pPredictorScoresExit = pPredictorScoresTrueEnd;
-      const FloatEbmType * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
+      const TFloat * const pPredictorScoresTrueEnd = pPredictorScores + cSamples;
+      const TFloat * pPredictorScoresExit = pPredictorScoresTrueEnd;
+      const TFloat * pPredictorScoresInnerEnd = pPredictorScoresTrueEnd;
       if(cSamples <= cItemsPerBitPackedDataUnit) {
          goto one_last_loop;
       }
@@ -416,12 +493,12 @@ public:
 
             const FloatEbmType smallChangeToPredictorScores = aModelFeatureGroupUpdateTensor[iTensorBin];
             // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-            const FloatEbmType predictorScore = *pPredictorScores + smallChangeToPredictorScores;
-            *pPredictorScores = predictorScore;
+            const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + smallChangeToPredictorScores;
+            *pPredictorScores = static_cast<TFloat>(predictorScore);
             ++pPredictorScores;
             const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData);
 
-            *pResidualError = residualError;
+            *pResidualError = static_cast<TFloat>(residualError);
             ++pResidualError;
 
             iTensorBinCombined >>= cBitsPerItemMax;
@@ -435,6 +512,26 @@ public:
          goto one_last_loop;
       }
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 #endif // EXPAND_BINARY_LOGITS
 
@@ -444,7 +541,8 @@ public:
 
    ApplyModelUpdateTrainingInternal() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<typename TFloat>
+   static void FuncStorage(
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const FloatEbmType * const aModelFeatureGroupUpdateTensor
@@ -468,13 +566,13 @@ public:
       const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
 
 
-      FloatEbmType * pResidualError = pTrainingSet->GetResidualPointer();
+      TFloat * pResidualError = pTrainingSet->GetResidualPointer<TFloat>();
       const StorageDataType * pInputData = pTrainingSet->GetInputDataPointer(pFeatureGroup);
 
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pResidualErrorTrueEnd = pResidualError + cSamples;
-      const FloatEbmType * pResidualErrorExit = pResidualErrorTrueEnd;
-      const FloatEbmType * pResidualErrorInnerEnd = pResidualErrorTrueEnd;
+      const TFloat * const pResidualErrorTrueEnd = pResidualError + cSamples;
+      const TFloat * pResidualErrorExit = pResidualErrorTrueEnd;
+      const TFloat * pResidualErrorInnerEnd = pResidualErrorTrueEnd;
       if(cSamples <= cItemsPerBitPackedDataUnit) {
          goto one_last_loop;
       }
@@ -495,9 +593,9 @@ public:
 
             const FloatEbmType smallChangeToPrediction = aModelFeatureGroupUpdateTensor[iTensorBin];
             // this will apply a small fix to our existing TrainingPredictorScores, either positive or negative, whichever is needed
-            const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegression(*pResidualError - smallChangeToPrediction);
+            const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegression(static_cast<FloatEbmType>(*pResidualError) - smallChangeToPrediction);
 
-            *pResidualError = residualError;
+            *pResidualError = static_cast<TFloat>(residualError);
             ++pResidualError;
 
             iTensorBinCombined >>= cBitsPerItemMax;
@@ -511,6 +609,76 @@ public:
          goto one_last_loop;
       }
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class ApplyModelUpdateTrainingNormalPacking final {
+public:
+
+   ApplyModelUpdateTrainingNormalPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      // the aligned packings put whole nibbles, bytes, shorts or ints in each slot, so specializing on them lets the compiler 
+      // turn our shifts and masks into plain extractions.  Every other packing uses the dynamic loop
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      if(k_cItemsPerBitPackedDataUnitAligned4 == cItemsPerBitPackedDataUnit) {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned4>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned8 == cItemsPerBitPackedDataUnit) {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned8>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned16 == cItemsPerBitPackedDataUnit) {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned16>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned32 == cItemsPerBitPackedDataUnit) {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned32>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
 };
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
@@ -529,10 +697,10 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         ApplyModelUpdateTrainingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         ApplyModelUpdateTrainingNormalPacking<compilerLearningTypeOrCountTargetClassesPossible>::Func(
             pEbmBoostingState,
             pFeatureGroup,
             aModelFeatureGroupUpdateTensor
@@ -565,7 +733,7 @@ public:
       EBM_ASSERT(IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      ApplyModelUpdateTrainingInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+      ApplyModelUpdateTrainingNormalPacking<k_dynamicClassification>::Func(
          pEbmBoostingState,
          pFeatureGroup,
          aModelFeatureGroupUpdateTensor
@@ -645,7 +813,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          ApplyModelUpdateTrainingSIMDPacking<
@@ -695,6 +863,280 @@ public:
    }
 };
 
+class ApplyModelUpdateTrainingClassMajor final {
+public:
+
+   ApplyModelUpdateTrainingClassMajor() = delete; // this is a static class.  Do not construct
+
+   template<typename TFloat>
+   static void FuncStorage(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(ptrdiff_t { 3 } <= runtimeLearningTypeOrCountTargetClasses);
+      DataSetByFeatureGroup * const pTrainingSet = pEbmBoostingState->GetTrainingSet();
+      EBM_ASSERT(pTrainingSet->IsClassMajor());
+
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      const size_t cSamples = pTrainingSet->GetCountSamples();
+      EBM_ASSERT(0 < cSamples);
+
+      // a feature group without features has a single tensor bin, so every sample uses the first update vector
+      const size_t cFeatures = pFeatureGroup->GetCountFeatures();
+      const size_t cItemsPerBitPackedDataUnit = 0 == cFeatures ? size_t { 1 } : pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+      const StorageDataType * pInputData = 0 == cFeatures ? nullptr : pTrainingSet->GetInputDataPointer(pFeatureGroup);
+      const StorageDataType * const aTargetData = pTrainingSet->GetTargetDataPointer();
+      TFloat * const aResidualErrors = pTrainingSet->GetResidualPointer<TFloat>();
+      TFloat * const aPredictorScores = pTrainingSet->GetPredictorScores<TFloat>();
+
+      // aExps holds the exps of a block one class after the other, followed by the sum of the exps of each sample
+      size_t * const aTensorBins = pTrainingSet->GetClassMajorTensorBins();
+      FloatEbmType * const aExps = pTrainingSet->GetClassMajorExps();
+      FloatEbmType * const aSumExps = aExps + k_cSamplesClassMajorBlock * cVectorLength;
+
+      size_t iTensorBinCombined = 0;
+      size_t cItemsRemaining = 0;
+      size_t iSampleBlock = 0;
+      do {
+         const size_t cSamplesBlock = 
+            k_cSamplesClassMajorBlock < cSamples - iSampleBlock ? k_cSamplesClassMajorBlock : cSamples - iSampleBlock;
+
+         // unpack the bins of the block once instead of once per class.  We keep the position in the current data 
+         // unit between blocks since blocks don't need to end on a data unit boundary
+         for(size_t iSample = 0; iSample < cSamplesBlock; ++iSample) {
+            size_t iTensorBin = 0;
+            if(nullptr != pInputData) {
+               if(0 == cItemsRemaining) {
+                  iTensorBinCombined = static_cast<size_t>(*pInputData);
+                  ++pInputData;
+                  cItemsRemaining = cItemsPerBitPackedDataUnit;
+               }
+               iTensorBin = maskBits & iTensorBinCombined;
+               iTensorBinCombined >>= cBitsPerItemMax;
+               --cItemsRemaining;
+            }
+            aTensorBins[iSample] = iTensorBin * cVectorLength;
+            aSumExps[iSample] = FloatEbmType { 0 };
+         }
+
+         // each class walks contiguous scores and exps.  The exps of a sample are still summed in class order, so the
+         // sums are bit for bit the same as the sample-major loop
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            TFloat * const pPredictorScores = aPredictorScores + iVector * cSamples + iSampleBlock;
+            FloatEbmType * const pExps = aExps + iVector * k_cSamplesClassMajorBlock;
+            const FloatEbmType * const pValues = aModelFeatureGroupUpdateTensor + iVector;
+            for(size_t iSample = 0; iSample < cSamplesBlock; ++iSample) {
+               const FloatEbmType predictorScore = static_cast<FloatEbmType>(pPredictorScores[iSample]) + pValues[aTensorBins[iSample]];
+               pPredictorScores[iSample] = static_cast<TFloat>(predictorScore);
+               const FloatEbmType oneExp = EbmExp(predictorScore);
+               pExps[iSample] = oneExp;
+               aSumExps[iSample] += oneExp;
+            }
+         }
+
+         const StorageDataType * const pTargetData = aTargetData + iSampleBlock;
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            TFloat * const pResidualError = aResidualErrors + iVector * cSamples + iSampleBlock;
+            const FloatEbmType * const pExps = aExps + iVector * k_cSamplesClassMajorBlock;
+            if(static_cast<ptrdiff_t>(iVector) == k_iZeroResidual) {
+               // see ApplyModelUpdateTrainingInternal for why zeroing one residual removes a degree of freedom
+               for(size_t iSample = 0; iSample < cSamplesBlock; ++iSample) {
+                  pResidualError[iSample] = TFloat { 0 };
+               }
+            } else {
+               for(size_t iSample = 0; iSample < cSamplesBlock; ++iSample) {
+                  const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorMulticlass(
+                     aSumExps[iSample],
+                     pExps[iSample],
+                     static_cast<size_t>(pTargetData[iSample]),
+                     iVector
+                  );
+                  pResidualError[iSample] = static_cast<TFloat>(residualError);
+               }
+            }
+         }
+
+         iSampleBlock += cSamplesBlock;
+      } while(cSamples != iSampleBlock);
+   }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
+};
+
+// we take the sparse path once at least 1 / k_cSparseApplyZeroBinsDivisor of the tensor bins don't change.  Our bins 
+// usually come from quantile cuts and hold similar numbers of samples, so the fraction of zero bins is a good estimate of 
+// the fraction of samples that we skip, and skipping fewer than that doesn't pay for the extra branch per sample
+static constexpr size_t k_cSparseApplyZeroBinsDivisor = 2;
+
+class ApplyModelUpdateTrainingSparse final {
+   // Late in boosting most updates only move a few segments of the tensor and leave the rest at zero.  A sample in a
+   // tensor bin with a zero update keeps it's score, and it's residual is already the one that we'd compute from that 
+   // score, so we skip those samples instead of recomputing identical values.  Only the samples in the changed 
+   // segments pay for the exp and the stores.
+
+   INLINE_ALWAYS static bool IsZeroVector(const FloatEbmType * const aValues, const size_t cVectorLength) {
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         if(FloatEbmType { 0 } != aValues[iVector]) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+public:
+
+   ApplyModelUpdateTrainingSparse() = delete; // this is a static class.  Do not construct
+
+   // returns the number of tensor bins whose update vector is all zeros
+   static size_t CountZeroBins(
+      const size_t cVectorLength,
+      const size_t cTensorBins,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      size_t cZeroBins = 0;
+      const FloatEbmType * pValues = aModelFeatureGroupUpdateTensor;
+      const FloatEbmType * const pValuesEnd = aModelFeatureGroupUpdateTensor + cTensorBins * cVectorLength;
+      do {
+         cZeroBins += IsZeroVector(pValues, cVectorLength) ? size_t { 1 } : size_t { 0 };
+         pValues += cVectorLength;
+      } while(pValuesEnd != pValues);
+      return cZeroBins;
+   }
+
+   template<typename TFloat>
+   static void FuncStorage(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+      DataSetByFeatureGroup * const pTrainingSet = pEbmBoostingState->GetTrainingSet();
+      EBM_ASSERT(!pTrainingSet->IsClassMajor());
+      FloatEbmType * const aExpVector = pEbmBoostingState->GetCachedThreadResources()->GetTempFloatVector();
+
+      const bool bRegression = IsRegression(runtimeLearningTypeOrCountTargetClasses);
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      const size_t cSamples = pTrainingSet->GetCountSamples();
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(0 < pFeatureGroup->GetCountFeatures());
+
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+      TFloat * const aResidualErrors = pTrainingSet->GetResidualPointer<TFloat>();
+      const StorageDataType * pInputData = pTrainingSet->GetInputDataPointer(pFeatureGroup);
+      // regression only keeps residuals
+      const StorageDataType * const aTargetData = bRegression ? nullptr : pTrainingSet->GetTargetDataPointer();
+      TFloat * const aPredictorScores = bRegression ? nullptr : pTrainingSet->GetPredictorScores<TFloat>();
+
+      size_t iSample = 0;
+      do {
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         ++pInputData;
+         const size_t iSampleUnitEnd = 
+            cItemsPerBitPackedDataUnit < cSamples - iSample ? iSample + cItemsPerBitPackedDataUnit : cSamples;
+         do {
+            const size_t iTensorBin = maskBits & iTensorBinCombined;
+            iTensorBinCombined >>= cBitsPerItemMax;
+            const FloatEbmType * const pValues = &aModelFeatureGroupUpdateTensor[iTensorBin * cVectorLength];
+            if(UNPREDICTABLE(!IsZeroVector(pValues, cVectorLength))) {
+               // these are the same calculations as the dense loops, so the changed samples get identical results
+               TFloat * const pResidualError = &aResidualErrors[iSample * cVectorLength];
+               if(bRegression) {
+                  const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegression(
+                     static_cast<FloatEbmType>(*pResidualError) - pValues[0]);
+                  *pResidualError = static_cast<TFloat>(residualError);
+               } else {
+                  const size_t targetData = static_cast<size_t>(aTargetData[iSample]);
+                  TFloat * const pPredictorScores = &aPredictorScores[iSample * cVectorLength];
+                  if(1 == cVectorLength) {
+                     const FloatEbmType predictorScore = static_cast<FloatEbmType>(*pPredictorScores) + pValues[0];
+                     *pPredictorScores = static_cast<TFloat>(predictorScore);
+                     const FloatEbmType residualError = 
+                        EbmStatistics::ComputeResidualErrorBinaryClassification(predictorScore, targetData);
+                     *pResidualError = static_cast<TFloat>(residualError);
+                  } else {
+                     FloatEbmType sumExp = FloatEbmType { 0 };
+                     for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                        const FloatEbmType predictorScore = static_cast<FloatEbmType>(pPredictorScores[iVector]) + pValues[iVector];
+                        pPredictorScores[iVector] = static_cast<TFloat>(predictorScore);
+                        const FloatEbmType oneExp = EbmExp(predictorScore);
+                        aExpVector[iVector] = oneExp;
+                        sumExp += oneExp;
+                     }
+                     for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                        const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorMulticlass(
+                           sumExp,
+                           aExpVector[iVector],
+                           targetData,
+                           iVector
+                        );
+                        pResidualError[iVector] = static_cast<TFloat>(residualError);
+                     }
+                     // see ApplyModelUpdateTrainingInternal for why zeroing one residual removes a degree of freedom
+                     constexpr bool bZeroingResiduals = 0 <= k_iZeroResidual;
+                     if(bZeroingResiduals) {
+                        pResidualError[k_iZeroResidual] = 0;
+                     }
+                  }
+               }
+            }
+            ++iSample;
+         } while(iSampleUnitEnd != iSample);
+      } while(cSamples != iSample);
+   }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      if(pEbmBoostingState->GetTrainingSet()->IsFloat32()) {
+         FuncStorage<float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         FuncStorage<FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
+};
+
 extern void ApplyModelUpdateTraining(
    EbmBoostingState * const pEbmBoostingState,
    const FeatureGroup * const pFeatureGroup,
@@ -703,8 +1145,46 @@ extern void ApplyModelUpdateTraining(
    LOG_0(TraceLevelVerbose, "Entered ApplyModelUpdateTraining");
 
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   // our model tensors fit into memory, so this can't overflow
+   size_t cTensorBins = 1;
+   const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
+   const FeatureGroupEntry * const pFeatureGroupEntryEnd = pFeatureGroupEntry + pFeatureGroup->GetCountFeatures();
+   for(; pFeatureGroupEntryEnd != pFeatureGroupEntry; ++pFeatureGroupEntry) {
+      cTensorBins *= pFeatureGroupEntry->m_pFeature->GetCountBins();
+   }
+   const size_t cZeroBins = ApplyModelUpdateTrainingSparse::CountZeroBins(cVectorLength, cTensorBins, aModelFeatureGroupUpdateTensor);
+   if(cTensorBins == cZeroBins) {
+      // no sample changes, so our scores, residuals and any cached denominators are already correct
+      LOG_0(TraceLevelVerbose, "Exited ApplyModelUpdateTraining with an all zero update");
+      return;
+   }
 
-   if(0 == pFeatureGroup->GetCountFeatures()) {
+   // the booster only keeps SIMD kernels if they support our target type
+   const SimdKernels * const pSimdKernels = pEbmBoostingState->GetSimdKernels();
+   if(nullptr != pSimdKernels) {
+      // the SIMD kernels don't compute exactly the same residuals as our scalar code, so we keep all the samples on
+      // them instead of mixing in the sparse path
+      pSimdKernels->ApplyModelUpdateTraining(
+         runtimeLearningTypeOrCountTargetClasses,
+         pFeatureGroup,
+         pEbmBoostingState->GetTrainingSet(),
+         aModelFeatureGroupUpdateTensor
+      );
+   } else if(pEbmBoostingState->GetTrainingSet()->IsClassMajor()) {
+      ApplyModelUpdateTrainingClassMajor::Func(
+         pEbmBoostingState,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor
+      );
+   } else if(0 != pFeatureGroup->GetCountFeatures() && cTensorBins / k_cSparseApplyZeroBinsDivisor <= cZeroBins) {
+      ApplyModelUpdateTrainingSparse::Func(
+         pEbmBoostingState,
+         pFeatureGroup,
+         aModelFeatureGroupUpdateTensor
+      );
+   } else if(0 == pFeatureGroup->GetCountFeatures()) {
       if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
          ApplyModelUpdateTrainingZeroFeaturesTarget<2>::Func(
             pEbmBoostingState,
@@ -763,7 +1243,7 @@ extern void ApplyModelUpdateTraining(
             );
          } else {
             EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-            ApplyModelUpdateTrainingInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            ApplyModelUpdateTrainingNormalPacking<k_regression>::Func(
                pEbmBoostingState,
                pFeatureGroup,
                aModelFeatureGroupUpdateTensor
@@ -772,5 +1252,11 @@ extern void ApplyModelUpdateTraining(
       }
    }
 
+   DataSetByFeatureGroup * const pTrainingSet = pEbmBoostingState->GetTrainingSet();
+   if(pTrainingSet->IsDenominatorsCached()) {
+      // the residuals changed above, so refresh the denominators once here instead of recomputing them in every bag
+      pTrainingSet->UpdateDenominators(cVectorLength);
+   }
+
    LOG_0(TraceLevelVerbose, "Exited ApplyModelUpdateTraining");
 }
@@ -165,7 +165,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          return ApplyModelUpdateValidationZeroFeatures<compilerLearningTypeOrCountTargetClassesPossible>::Func(
@@ -472,6 +472,56 @@ public:
    }
 };
 
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class ApplyModelUpdateValidationNormalPacking final {
+public:
+
+   ApplyModelUpdateValidationNormalPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      // the aligned packings put whole nibbles, bytes, shorts or ints in each slot, so specializing on them lets the compiler 
+      // turn our shifts and masks into plain extractions.  Every other packing uses the dynamic loop
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      if(k_cItemsPerBitPackedDataUnitAligned4 == cItemsPerBitPackedDataUnit) {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned4>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned8 == cItemsPerBitPackedDataUnit) {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned8>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned16 == cItemsPerBitPackedDataUnit) {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned16>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned32 == cItemsPerBitPackedDataUnit) {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned32>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      } else {
+         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            aModelFeatureGroupUpdateTensor
+         );
+      }
+   }
+};
+
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
 class ApplyModelUpdateValidationNormalTarget final {
 public:
@@ -488,10 +538,10 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         return ApplyModelUpdateValidationInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         return ApplyModelUpdateValidationNormalPacking<compilerLearningTypeOrCountTargetClassesPossible>::Func(
             pEbmBoostingState,
             pFeatureGroup,
             aModelFeatureGroupUpdateTensor
@@ -524,7 +574,7 @@ public:
       EBM_ASSERT(IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      return ApplyModelUpdateValidationInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+      return ApplyModelUpdateValidationNormalPacking<k_dynamicClassification>::Func(
          pEbmBoostingState,
          pFeatureGroup,
          aModelFeatureGroupUpdateTensor
@@ -604,7 +654,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          return ApplyModelUpdateValidationSIMDPacking<
@@ -654,6 +704,213 @@ public:
    }
 };
 
+// unpacks the tensor bins of one feature group from the bit packed validation data, one sample at a time
+class ValidationBinCursor final {
+public:
+
+   const StorageDataType * m_pInputData;
+   size_t m_iTensorBinCombined;
+   size_t m_cItemsRemaining;
+   size_t m_cItemsPerBitPackedDataUnit;
+   size_t m_cBitsPerItemMax;
+   size_t m_maskBits;
+   const FloatEbmType * m_aModelFeatureGroupUpdateTensor;
+
+   ValidationBinCursor() = default; // preserve our POD status
+   ~ValidationBinCursor() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void Initialize(
+      const DataSetByFeatureGroup * const pValidationSet,
+      const FeatureGroup * const pFeatureGroup,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) {
+      // feature groups without features have a single tensor bin and no input data
+      m_pInputData = nullptr;
+      m_iTensorBinCombined = 0;
+      m_cItemsRemaining = 0;
+      m_cItemsPerBitPackedDataUnit = 0;
+      m_cBitsPerItemMax = 0;
+      m_maskBits = 0;
+      m_aModelFeatureGroupUpdateTensor = aModelFeatureGroupUpdateTensor;
+      if(0 != pFeatureGroup->GetCountFeatures()) {
+         m_pInputData = pValidationSet->GetInputDataPointer(pFeatureGroup);
+         m_cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+         EBM_ASSERT(1 <= m_cItemsPerBitPackedDataUnit);
+         EBM_ASSERT(m_cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+         m_cBitsPerItemMax = GetCountBits(m_cItemsPerBitPackedDataUnit);
+         EBM_ASSERT(1 <= m_cBitsPerItemMax);
+         EBM_ASSERT(m_cBitsPerItemMax <= k_cBitsForStorageType);
+         m_maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - m_cBitsPerItemMax);
+      }
+   }
+
+   // returns the update values of the next sample
+   INLINE_ALWAYS const FloatEbmType * Next(const size_t cVectorLength) {
+      size_t iTensorBin = 0;
+      if(nullptr != m_pInputData) {
+         if(0 == m_cItemsRemaining) {
+            m_iTensorBinCombined = static_cast<size_t>(*m_pInputData);
+            ++m_pInputData;
+            m_cItemsRemaining = m_cItemsPerBitPackedDataUnit;
+         }
+         iTensorBin = m_maskBits & m_iTensorBinCombined;
+         m_iTensorBinCombined >>= m_cBitsPerItemMax;
+         --m_cItemsRemaining;
+      }
+      return &m_aModelFeatureGroupUpdateTensor[iTensorBin * cVectorLength];
+   }
+};
+static_assert(std::is_standard_layout<ValidationBinCursor>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ValidationBinCursor>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<ValidationBinCursor>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// the number of feature group updates that we apply to the validation set in each pass of ApplyModelUpdatesValidationScalar
+static constexpr size_t k_cValidationUpdatesPerPass = 16;
+
+// applies the updates of cUpdates feature groups to the validation set in a single pass, and returns the metric if
+// bMetric is true.  Masked validation sets share their PackedData with the boosters of other outer bags, so the 
+// samples outside of our mask belong to other boosters.  We skip them entirely and divide by the number of samples in 
+// the mask.  Weighted validation sets contribute each metric in proportion to its weight and divide by the total 
+// weight instead.  This is scalar code for every learning type, since it is only used when sharing data between 
+// outer bags, with weights, or when several deferred updates are applied together
+static FloatEbmType ApplyModelUpdatesValidationScalar(
+   EbmBoostingState * const pEbmBoostingState,
+   const size_t cUpdates,
+   const FeatureGroup * const * const apFeatureGroups,
+   const FloatEbmType * const * const aaModelFeatureGroupUpdateTensors,
+   const bool bMetric
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   DataSetByFeatureGroup * const pValidationSet = pEbmBoostingState->GetValidationSet();
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cSamples = pValidationSet->GetCountSamples();
+   EBM_ASSERT(0 < cSamples);
+   const size_t * const aSampleMaskBits = pValidationSet->GetSampleMaskBits();
+   const size_t * const aWeights = pValidationSet->GetWeights();
+
+   EBM_ASSERT(1 <= cUpdates);
+   EBM_ASSERT(cUpdates <= k_cValidationUpdatesPerPass);
+   ValidationBinCursor aCursors[k_cValidationUpdatesPerPass];
+   for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+      aCursors[iUpdate].Initialize(pValidationSet, apFeatureGroups[iUpdate], aaModelFeatureGroupUpdateTensors[iUpdate]);
+   }
+
+   const StorageDataType * const aTargetData = IsClassification(runtimeLearningTypeOrCountTargetClasses) ?
+      pValidationSet->GetTargetDataPointer() : nullptr;
+   FloatEbmType * const aPredictorScores = IsClassification(runtimeLearningTypeOrCountTargetClasses) ?
+      pValidationSet->GetPredictorScores() : nullptr;
+   FloatEbmType * const aResidualErrors = IsClassification(runtimeLearningTypeOrCountTargetClasses) ?
+      nullptr : pValidationSet->GetResidualPointer();
+
+   FloatEbmType sumMetric = FloatEbmType { 0 };
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // every sample moves the cursors, including the ones outside of our mask
+      const FloatEbmType * apValues[k_cValidationUpdatesPerPass];
+      for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+         apValues[iUpdate] = aCursors[iUpdate].Next(cVectorLength);
+      }
+      if(nullptr != aSampleMaskBits && 
+         0 == ((aSampleMaskBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 })) {
+         continue;
+      }
+      const FloatEbmType weight = nullptr == aWeights ? FloatEbmType { 1 } : static_cast<FloatEbmType>(aWeights[iSample]);
+
+      if(IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+         FloatEbmType residualError = aResidualErrors[iSample];
+         for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+            residualError -= *apValues[iUpdate];
+         }
+         residualError = EbmStatistics::ComputeResidualErrorRegression(residualError);
+         aResidualErrors[iSample] = residualError;
+         if(bMetric) {
+            const FloatEbmType sampleSquaredError = EbmStatistics::ComputeSingleSampleSquaredErrorRegression(residualError);
+            EBM_ASSERT(std::isnan(sampleSquaredError) || FloatEbmType { 0 } <= sampleSquaredError);
+            sumMetric += weight * sampleSquaredError;
+         }
+#ifndef EXPAND_BINARY_LOGITS
+      } else if(IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         FloatEbmType predictorScore = aPredictorScores[iSample];
+         for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+            predictorScore += *apValues[iUpdate];
+         }
+         aPredictorScores[iSample] = predictorScore;
+         if(bMetric) {
+            const size_t targetData = static_cast<size_t>(aTargetData[iSample]);
+            const FloatEbmType sampleLogLoss = 
+               EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(predictorScore, targetData);
+            EBM_ASSERT(std::isnan(sampleLogLoss) || FloatEbmType { 0 } <= sampleLogLoss);
+            sumMetric += weight * sampleLogLoss;
+         }
+#endif // EXPAND_BINARY_LOGITS
+      } else {
+         FloatEbmType * const pPredictorScores = &aPredictorScores[iSample * cVectorLength];
+         for(size_t iUpdate = 0; iUpdate < cUpdates; ++iUpdate) {
+            const FloatEbmType * const pValues = apValues[iUpdate];
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pPredictorScores[iVector] += pValues[iVector];
+            }
+         }
+         if(bMetric) {
+            const size_t targetData = static_cast<size_t>(aTargetData[iSample]);
+            FloatEbmType itemExp = FloatEbmType { 0 };
+            FloatEbmType sumExp = FloatEbmType { 0 };
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               const FloatEbmType oneExp = EbmExp(pPredictorScores[iVector]);
+               itemExp = iVector == targetData ? oneExp : itemExp;
+               sumExp += oneExp;
+            }
+            const FloatEbmType sampleLogLoss = EbmStatistics::ComputeSingleSampleLogLossMulticlass(sumExp, itemExp);
+            EBM_ASSERT(std::isnan(sampleLogLoss) || -k_epsilonLogLoss <= sampleLogLoss);
+            sumMetric += weight * sampleLogLoss;
+         }
+      }
+   }
+   // GetWeightTotal() is GetCountSamplesIncluded() without weights
+   return sumMetric / pValidationSet->GetWeightTotal();
+}
+
+// converts NaN and overflowed metrics to the worst possible metric, and small negative metrics from floating point
+// instability to zero
+static FloatEbmType CleanValidationMetric(const ptrdiff_t runtimeLearningTypeOrCountTargetClasses, FloatEbmType ret) {
+   EBM_ASSERT(std::isnan(ret) || -k_epsilonLogLoss <= ret);
+   // comparing to max is a good way to check for +infinity without using infinity, which can be problematic on
+   // some compilers with some compiler settings.  Using <= helps avoid optimization away because the compiler
+   // might assume that nothing is larger than max if it thinks there's no +infinity
+   if(UNLIKELY(UNLIKELY(std::isnan(ret)) || UNLIKELY(std::numeric_limits<FloatEbmType>::max() <= ret))) {
+      // set the metric so high that this round of boosting will be rejected.  The worst metric is std::numeric_limits<FloatEbmType>::max(),
+      // Set it to that so that this round of boosting won't be accepted if our caller is using early stopping
+      ret = std::numeric_limits<FloatEbmType>::max();
+   } else {
+      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+         if(UNLIKELY(ret < FloatEbmType { 0 })) {
+            // regression can't be negative since squares are pretty well insulated from ever doing that
+
+            // Multiclass can return small negative numbers, so we need to clean up the value retunred so that it isn't negative
+
+            // binary classification can't return a negative number provided the log function
+            // doesn't ever return a negative number for numbers exactly equal to 1 or higher
+            // BUT we're going to be using or trying approximate log functions, and those might not
+            // be guaranteed to return a positive or zero number, so let's just always check for numbers less than zero and round up
+            EBM_ASSERT(IsMulticlass(runtimeLearningTypeOrCountTargetClasses));
+
+            // because of floating point inexact reasons, ComputeSingleSampleLogLossMulticlass can return a negative number
+            // so correct this before we return.  Any negative numbers were really meant to be zero
+            ret = FloatEbmType { 0 };
+         }
+      }
+   }
+   EBM_ASSERT(!std::isnan(ret));
+   EBM_ASSERT(!std::isinf(ret));
+   EBM_ASSERT(FloatEbmType { 0 } <= ret);
+   return ret;
+}
+
 extern FloatEbmType ApplyModelUpdateValidation(
    EbmBoostingState * const pEbmBoostingState,
    const FeatureGroup * const pFeatureGroup,
@@ -664,7 +921,25 @@ extern FloatEbmType ApplyModelUpdateValidation(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
 
    FloatEbmType ret;
-   if(0 == pFeatureGroup->GetCountFeatures()) {
+   // the booster only keeps SIMD kernels if they support our target type
+   const SimdKernels * const pSimdKernels = pEbmBoostingState->GetSimdKernels();
+   const DataSetByFeatureGroup * const pValidationSet = pEbmBoostingState->GetValidationSet();
+   if(nullptr != pValidationSet->GetSampleMaskBits() || nullptr != pValidationSet->GetWeights()) {
+      ret = ApplyModelUpdatesValidationScalar(
+         pEbmBoostingState,
+         1,
+         &pFeatureGroup,
+         &aModelFeatureGroupUpdateTensor,
+         true
+      );
+   } else if(nullptr != pSimdKernels) {
+      ret = pSimdKernels->ApplyModelUpdateValidation(
+         runtimeLearningTypeOrCountTargetClasses,
+         pFeatureGroup,
+         pEbmBoostingState->GetValidationSet(),
+         aModelFeatureGroupUpdateTensor
+      );
+   } else if(0 == pFeatureGroup->GetCountFeatures()) {
       if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
          ret = ApplyModelUpdateValidationZeroFeaturesTarget<2>::Func(
             pEbmBoostingState,
@@ -723,7 +998,7 @@ extern FloatEbmType ApplyModelUpdateValidation(
             );
          } else {
             EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-            ret = ApplyModelUpdateValidationInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            ret = ApplyModelUpdateValidationNormalPacking<k_regression>::Func(
                pEbmBoostingState,
                pFeatureGroup,
                aModelFeatureGroupUpdateTensor
@@ -732,38 +1007,58 @@ extern FloatEbmType ApplyModelUpdateValidation(
       }
    }
 
-   EBM_ASSERT(std::isnan(ret) || -k_epsilonLogLoss <= ret);
-   // comparing to max is a good way to check for +infinity without using infinity, which can be problematic on
-   // some compilers with some compiler settings.  Using <= helps avoid optimization away because the compiler
-   // might assume that nothing is larger than max if it thinks there's no +infinity
-   if(UNLIKELY(UNLIKELY(std::isnan(ret)) || UNLIKELY(std::numeric_limits<FloatEbmType>::max() <= ret))) {
-      // set the metric so high that this round of boosting will be rejected.  The worst metric is std::numeric_limits<FloatEbmType>::max(),
-      // Set it to that so that this round of boosting won't be accepted if our caller is using early stopping
-      ret = std::numeric_limits<FloatEbmType>::max();
-   } else {
-      if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
-         if(UNLIKELY(ret < FloatEbmType { 0 })) {
-            // regression can't be negative since squares are pretty well insulated from ever doing that
+   ret = CleanValidationMetric(runtimeLearningTypeOrCountTargetClasses, ret);
 
-            // Multiclass can return small negative numbers, so we need to clean up the value retunred so that it isn't negative
+   LOG_0(TraceLevelVerbose, "Exited ApplyModelUpdateValidation");
 
-            // binary classification can't return a negative number provided the log function
-            // doesn't ever return a negative number for numbers exactly equal to 1 or higher
-            // BUT we're going to be using or trying approximate log functions, and those might not
-            // be guaranteed to return a positive or zero number, so let's just always check for numbers less than zero and round up
-            EBM_ASSERT(IsMulticlass(runtimeLearningTypeOrCountTargetClasses));
+   return ret;
+}
 
-            // because of floating point inexact reasons, ComputeSingleSampleLogLossMulticlass can return a negative number
-            // so correct this before we return.  Any negative numbers were really meant to be zero
-            ret = FloatEbmType { 0 };
-         }
-      }
-   }
-   EBM_ASSERT(!std::isnan(ret));
-   EBM_ASSERT(!std::isinf(ret));
-   EBM_ASSERT(FloatEbmType { 0 } <= ret);
+extern FloatEbmType ApplyPendingModelUpdatesValidation(EbmBoostingState * const pEbmBoostingState) {
+   LOG_0(TraceLevelVerbose, "Entered ApplyPendingModelUpdatesValidation");
 
-   LOG_0(TraceLevelVerbose, "Exited ApplyModelUpdateValidation");
+   const size_t cPendingFeatureGroups = pEbmBoostingState->GetCountPendingFeatureGroups();
+   EBM_ASSERT(1 <= cPendingFeatureGroups);
+   const size_t * const aiPendingFeatureGroups = pEbmBoostingState->GetPendingFeatureGroups();
+   FeatureGroup * const * const apFeatureGroups = pEbmBoostingState->GetFeatureGroups();
+   SegmentedTensor * const * const apPendingValidationUpdates = pEbmBoostingState->GetPendingValidationUpdates();
+
+   FloatEbmType ret;
+   if(size_t { 1 } == cPendingFeatureGroups) {
+      // a single update can use our fastest kernels
+      const size_t iFeatureGroup = aiPendingFeatureGroups[0];
+      ret = ApplyModelUpdateValidation(
+         pEbmBoostingState,
+         apFeatureGroups[iFeatureGroup],
+         apPendingValidationUpdates[iFeatureGroup]->GetValuePointer()
+      );
+   } else {
+      // the metric is expensive to calculate for classification, so we only calculate it in the last pass, and 
+      // the earlier passes only update the scores
+      size_t iPending = 0;
+      do {
+         const FeatureGroup * apFeatureGroupsPass[k_cValidationUpdatesPerPass];
+         const FloatEbmType * aaModelFeatureGroupUpdateTensorsPass[k_cValidationUpdatesPerPass];
+         size_t cUpdates = 0;
+         do {
+            const size_t iFeatureGroup = aiPendingFeatureGroups[iPending];
+            apFeatureGroupsPass[cUpdates] = apFeatureGroups[iFeatureGroup];
+            aaModelFeatureGroupUpdateTensorsPass[cUpdates] = apPendingValidationUpdates[iFeatureGroup]->GetValuePointer();
+            ++cUpdates;
+            ++iPending;
+         } while(cUpdates < k_cValidationUpdatesPerPass && iPending < cPendingFeatureGroups);
+         ret = ApplyModelUpdatesValidationScalar(
+            pEbmBoostingState,
+            cUpdates,
+            apFeatureGroupsPass,
+            aaModelFeatureGroupUpdateTensorsPass,
+            cPendingFeatureGroups == iPending
+         );
+      } while(iPending < cPendingFeatureGroups);
+      ret = CleanValidationMetric(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses(), ret);
+   }
+   pEbmBoostingState->ClearPendingValidationUpdates();
 
+   LOG_0(TraceLevelVerbose, "Exited ApplyPendingModelUpdatesValidation");
    return ret;
 }
@@ -5,6 +5,7 @@
 #include "PrecompiledHeader.h"
 
 #include <stddef.h> // size_t, ptrdiff_t
+#include <algorithm> // std::min, std::max
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
@@ -15,11 +16,88 @@
 #include "FeatureAtomic.h"
 #include "FeatureGroup.h"
 #include "DataSetBoosting.h"
+#include "SamplingSet.h"
 
 #include "Booster.h"
 
 #include "HistogramTargetEntry.h"
 #include "HistogramBucket.h"
+#include "ThreadPool.h"
+
+template<bool bClassification, bool bCachedDenominators, size_t compilerCountItems, typename TFloat>
+INLINE_ALWAYS static void AddResidualsToVectorEntries(
+   const size_t runtimeCountItems,
+   const size_t cClassStride,
+   const FloatEbmType cFloatOccurences,
+   const TFloat * const aResidualError,
+   const TFloat * const aDenominator,
+   HistogramBucketVectorEntry<bClassification> * const aHistogramBucketVectorEntry
+) {
+   // zero means that the count is only known at runtime
+   const size_t cItems = 0 == compilerCountItems ? runtimeCountItems : compilerCountItems;
+   EBM_ASSERT(1 <= cItems);
+   size_t iItem = 0;
+   do {
+      const FloatEbmType residualError = aResidualError[iItem * cClassStride];
+      aHistogramBucketVectorEntry[iItem].m_sumResidualError += cFloatOccurences * residualError;
+      if(bClassification) {
+         // the denominator only depends on the residual, so it can optionally be computed once per residual update 
+         // instead of once per SamplingSet.  That trades CPU for memory bandwidth
+         FloatEbmType denominator;
+         if(bCachedDenominators) {
+            denominator = aDenominator[iItem * cClassStride];
+         } else {
+            denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
+         }
+         aHistogramBucketVectorEntry[iItem].SetSumDenominator(
+            aHistogramBucketVectorEntry[iItem].GetSumDenominator() + cFloatOccurences * denominator
+         );
+      }
+      ++iItem;
+      // if we use this specific format where (iItem < cItems) then the compiler collapses alway the loop for small cItems values
+      // if we make this (iItem != cItems) then the loop is not collapsed
+   } while(iItem < cItems);
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, bool bCachedDenominators, typename TFloat>
+INLINE_ALWAYS static void AddResidualsToVector(
+   const size_t cVectorLength,
+   const size_t cClassStride,
+   const FloatEbmType cFloatOccurences,
+   const TFloat * const aResidualError,
+   const TFloat * const aDenominator,
+   HistogramBucketVectorEntry<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketVectorEntry
+) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+   if(k_dynamicClassification != compilerLearningTypeOrCountTargetClasses) {
+      AddResidualsToVectorEntries<bClassification, bCachedDenominators, GetVectorLength(compilerLearningTypeOrCountTargetClasses)>(
+         cVectorLength, cClassStride, cFloatOccurences, aResidualError, aDenominator, aHistogramBucketVectorEntry);
+      return;
+   }
+   // we don't know the number of classes at compile time, but whole tiles still get loops that the compiler can unroll
+   size_t iVector = 0;
+   while(iVector + k_cTargetClassesTile <= cVectorLength) {
+      AddResidualsToVectorEntries<bClassification, bCachedDenominators, k_cTargetClassesTile>(
+         k_cTargetClassesTile,
+         cClassStride,
+         cFloatOccurences,
+         aResidualError + iVector * cClassStride,
+         bCachedDenominators ? aDenominator + iVector * cClassStride : nullptr,
+         aHistogramBucketVectorEntry + iVector
+      );
+      iVector += k_cTargetClassesTile;
+   }
+   if(iVector != cVectorLength) {
+      AddResidualsToVectorEntries<bClassification, bCachedDenominators, 0>(
+         cVectorLength - iVector,
+         cClassStride,
+         cFloatOccurences,
+         aResidualError + iVector * cClassStride,
+         bCachedDenominators ? aDenominator + iVector * cClassStride : nullptr,
+         aHistogramBucketVectorEntry + iVector
+      );
+   }
+}
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 class BinBoostingZeroDimensions final {
@@ -27,9 +105,12 @@ public:
 
    BinBoostingZeroDimensions() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators, typename TFloat>
+   static void FuncSampling(
       EbmBoostingState * const pEbmBoostingState,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const pHistogramBucketEntryBase
    ) {
       constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
@@ -48,13 +129,31 @@ public:
       const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
       EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
 
-      const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
+      // we process the contiguous range of samples [iSampleBegin, iSampleBegin + cSamplesShard)
+      const size_t cSamples = cSamplesShard;
       EBM_ASSERT(0 < cSamples);
-
-      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
-      const FloatEbmType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer();
+      EBM_ASSERT(iSampleBegin + cSamples <= pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples());
+
+      // when sampling without replacement we read one inclusion bit per sample instead of a full count, and 
+      // without bagging every sample occurs exactly once so there is nothing to read at all
+      EBM_ASSERT(occurrenceStorage == pTrainingSet->GetOccurrenceStorage());
+      const size_t * const aIncludedBits = 
+         OccurrenceStorage::IncludedBits == occurrenceStorage ? pTrainingSet->GetIncludedBits() : nullptr;
+      size_t iSample = iSampleBegin;
+      const size_t * pCountOccurrences = OccurrenceStorage::Counts == occurrenceStorage ? 
+         pTrainingSet->GetCountOccurrences() + iSampleBegin : nullptr;
+      // only multiclass training sets can be class-major, so the strides stay compile time constants otherwise
+      const bool bClassMajor = IsMulticlass(compilerLearningTypeOrCountTargetClasses) && 
+         pTrainingSet->GetDataSetByFeatureGroup()->IsClassMajor();
+      const size_t cSampleStride = bClassMajor ? size_t { 1 } : cVectorLength;
+      const size_t cClassStride = bClassMajor ? pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples() : size_t { 1 };
+      const TFloat * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer<TFloat>() + cSampleStride * iSampleBegin;
+      // if the denominators were cached when the residuals were last updated we read them instead of recomputing them
+      EBM_ASSERT(bCachedDenominators == pTrainingSet->GetDataSetByFeatureGroup()->IsDenominatorsCached());
+      const TFloat * pDenominator = bCachedDenominators ? 
+         pTrainingSet->GetDataSetByFeatureGroup()->GetDenominatorPointer<TFloat>() + cSampleStride * iSampleBegin : nullptr;
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cVectorLength * cSamples;
+      const TFloat * const pResidualErrorEnd = pResidualError + cSampleStride * cSamples;
 
       HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry =
          pHistogramBucketEntry->GetHistogramBucketVectorEntry();
@@ -68,16 +167,21 @@ public:
          //   pressure related, and even then we could store the count for a single bit aleviating the memory pressure greatly, if we use the right 
          //   sampling method 
 
-         // TODO : try using a sampling method with non-repeating samples, and put the count into a bit.  Then unwind that loop either at the byte level 
-         //   (8 times) or the uint64_t level.  This can be done without branching and doesn't require random number generators
+         // when sampling without replacement the count is stored in a single bit (see SamplingSet::GetIncludedBits).
+         // TODO : unwind that loop either at the byte level (8 times) or the uint64_t level
 
-         const size_t cOccurences = *pCountOccurrences;
-         ++pCountOccurrences;
+         size_t cOccurences = 1;
+         if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+            // the bit is converted into a 0 or 1 multiplier, so there is no data dependent branch in here
+            cOccurences = (aIncludedBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 };
+            ++iSample;
+         } else if(OccurrenceStorage::Counts == occurrenceStorage) {
+            cOccurences = *pCountOccurrences;
+            ++pCountOccurrences;
+         }
          pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
          const FloatEbmType cFloatOccurences = static_cast<FloatEbmType>(cOccurences);
 
-         size_t iVector = 0;
-
 #ifndef NDEBUG
 #ifdef EXPAND_BINARY_LOGITS
          constexpr bool bExpandBinaryLogits = true;
@@ -85,31 +189,20 @@ public:
          constexpr bool bExpandBinaryLogits = false;
 #endif // EXPAND_BINARY_LOGITS
          FloatEbmType residualTotalDebug = 0;
-#endif // NDEBUG
-         do {
-            const FloatEbmType residualError = *pResidualError;
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            const FloatEbmType residualError = pResidualError[iVector * cClassStride];
             EBM_ASSERT(!bClassification ||
                ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
                static_cast<ptrdiff_t>(iVector) != k_iZeroResidual || 0 == residualError);
-#ifndef NDEBUG
             residualTotalDebug += residualError;
+         }
 #endif // NDEBUG
-            pHistogramBucketVectorEntry[iVector].m_sumResidualError += cFloatOccurences * residualError;
-            if(bClassification) {
-               // TODO : this code gets executed for each SamplingSet set.  I could probably execute it once and then all the 
-               //   SamplingSet sets would have this value, but I would need to store the computation in a new memory place, and it might make 
-               //   more sense to calculate this values in the CPU rather than put more pressure on memory.  I think controlling this should be done in a 
-               //   MACRO and we should use a class to hold the residualError and this computation from that value and then comment out the computation if 
-               //   not necssary and access it through an accessor so that we can make the change entirely via macro
-               const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
-               pHistogramBucketVectorEntry[iVector].SetSumDenominator(pHistogramBucketVectorEntry[iVector].GetSumDenominator() + cFloatOccurences * denominator);
-            }
-            ++pResidualError;
-            ++iVector;
-            // if we use this specific format where (iVector < cVectorLength) then the compiler collapses alway the loop for small cVectorLength values
-            // if we make this (iVector != cVectorLength) then the loop is not collapsed
-            // the compiler seems to not mind if we make this a for loop or do loop in terms of collapsing away the loop
-         } while(iVector < cVectorLength);
+         AddResidualsToVector<compilerLearningTypeOrCountTargetClasses, bCachedDenominators>(
+            cVectorLength, cClassStride, cFloatOccurences, pResidualError, pDenominator, pHistogramBucketVectorEntry);
+         pResidualError += cSampleStride;
+         if(bCachedDenominators) {
+            pDenominator += cSampleStride;
+         }
 
          EBM_ASSERT(
             !bClassification ||
@@ -121,6 +214,62 @@ public:
       } while(pResidualErrorEnd != pResidualError);
       LOG_0(TraceLevelVerbose, "Exited BinDataSetTrainingZeroDimensions");
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const pHistogramBucketEntryBase
+   ) {
+      const OccurrenceStorage occurrenceStorage = pTrainingSet->GetOccurrenceStorage();
+      if(OccurrenceStorage::Flat == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::Flat>(pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      } else if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::IncludedBits>(pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      } else {
+         EBM_ASSERT(OccurrenceStorage::Counts == occurrenceStorage);
+         FuncDenominators<OccurrenceStorage::Counts>(pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      }
+   }
+
+private:
+
+   template<OccurrenceStorage occurrenceStorage>
+   INLINE_ALWAYS static void FuncDenominators(
+      EbmBoostingState * const pEbmBoostingState,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const pHistogramBucketEntryBase
+   ) {
+      // regression doesn't use denominators, so we never cache them and don't need that specialization
+      if(IsClassification(compilerLearningTypeOrCountTargetClasses) && 
+         pTrainingSet->GetDataSetByFeatureGroup()->IsDenominatorsCached()) 
+      {
+         FuncStorage<occurrenceStorage, true>(pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      } else {
+         FuncStorage<occurrenceStorage, false>(pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      }
+   }
+
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators>
+   INLINE_ALWAYS static void FuncStorage(
+      EbmBoostingState * const pEbmBoostingState,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const pHistogramBucketEntryBase
+   ) {
+      // float storage only changes what we read.  The histograms always accumulate in FloatEbmType
+      if(pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32()) {
+         FuncSampling<occurrenceStorage, bCachedDenominators, float>(
+            pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      } else {
+         FuncSampling<occurrenceStorage, bCachedDenominators, FloatEbmType>(
+            pEbmBoostingState, pTrainingSet, iSampleBegin, cSamplesShard, pHistogramBucketEntryBase);
+      }
+   }
 };
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
@@ -132,6 +281,8 @@ public:
    INLINE_ALWAYS static void Func(
       EbmBoostingState * const pEbmBoostingState,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const pHistogramBucketEntryBase
    ) {
       static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
@@ -139,18 +290,22 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinBoostingZeroDimensions<compilerLearningTypeOrCountTargetClassesPossible>::Func(
             pEbmBoostingState,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             pHistogramBucketEntryBase
          );
       } else {
          BinBoostingZeroDimensionsTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
             pEbmBoostingState,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             pHistogramBucketEntryBase
          );
       }
@@ -166,6 +321,8 @@ public:
    INLINE_ALWAYS static void Func(
       EbmBoostingState * const pEbmBoostingState,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const pHistogramBucketEntryBase
    ) {
       static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
@@ -176,6 +333,8 @@ public:
       BinBoostingZeroDimensions<k_dynamicClassification>::Func(
          pEbmBoostingState,
          pTrainingSet,
+         iSampleBegin,
+         cSamplesShard,
          pHistogramBucketEntryBase
       );
    }
@@ -187,10 +346,13 @@ public:
 
    BinBoostingInternal() = delete; // this is a static class.  Do not construct
 
-   static void Func(
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators, typename TFloat>
+   static void FuncSampling(
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -224,21 +386,42 @@ public:
       EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
       const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
 
-      const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
+      // we process the contiguous range of samples [iSampleBegin, iSampleBegin + cSamplesShard).  Shards always
+      // begin on a packed data unit boundary, and only the last shard can end in a partially filled unit
+      const size_t cSamples = cSamplesShard;
       EBM_ASSERT(0 < cSamples);
-
-      const size_t * pCountOccurrences = pTrainingSet->GetCountOccurrences();
-      const StorageDataType * pInputData = pTrainingSet->GetDataSetByFeatureGroup()->GetInputDataPointer(pFeatureGroup);
-      const FloatEbmType * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer();
+      EBM_ASSERT(0 == iSampleBegin % cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(iSampleBegin + cSamples <= pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples());
+
+      // when sampling without replacement we read one inclusion bit per sample instead of a full count, and 
+      // without bagging every sample occurs exactly once so there is nothing to read at all
+      EBM_ASSERT(occurrenceStorage == pTrainingSet->GetOccurrenceStorage());
+      const size_t * const aIncludedBits = 
+         OccurrenceStorage::IncludedBits == occurrenceStorage ? pTrainingSet->GetIncludedBits() : nullptr;
+      size_t iSample = iSampleBegin;
+      const size_t * pCountOccurrences = OccurrenceStorage::Counts == occurrenceStorage ? 
+         pTrainingSet->GetCountOccurrences() + iSampleBegin : nullptr;
+      const StorageDataType * pInputData = pTrainingSet->GetDataSetByFeatureGroup()->GetInputDataPointer(pFeatureGroup) + 
+         iSampleBegin / cItemsPerBitPackedDataUnit;
+      // only multiclass training sets can be class-major, so the strides stay compile time constants otherwise
+      const bool bClassMajor = IsMulticlass(compilerLearningTypeOrCountTargetClasses) && 
+         pTrainingSet->GetDataSetByFeatureGroup()->IsClassMajor();
+      const size_t cSampleStride = bClassMajor ? size_t { 1 } : cVectorLength;
+      const size_t cClassStride = bClassMajor ? pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples() : size_t { 1 };
+      const TFloat * pResidualError = pTrainingSet->GetDataSetByFeatureGroup()->GetResidualPointer<TFloat>() + cSampleStride * iSampleBegin;
+      // if the denominators were cached when the residuals were last updated we read them instead of recomputing them
+      EBM_ASSERT(bCachedDenominators == pTrainingSet->GetDataSetByFeatureGroup()->IsDenominatorsCached());
+      const TFloat * pDenominator = bCachedDenominators ? 
+         pTrainingSet->GetDataSetByFeatureGroup()->GetDenominatorPointer<TFloat>() + cSampleStride * iSampleBegin : nullptr;
 
       // this shouldn't overflow since we're accessing existing memory
-      const FloatEbmType * const pResidualErrorTrueEnd = pResidualError + cVectorLength * cSamples;
-      const FloatEbmType * pResidualErrorExit = pResidualErrorTrueEnd;
+      const TFloat * const pResidualErrorTrueEnd = pResidualError + cSampleStride * cSamples;
+      const TFloat * pResidualErrorExit = pResidualErrorTrueEnd;
       size_t cItemsRemaining = cSamples;
       if(cSamples <= cItemsPerBitPackedDataUnit) {
          goto one_last_loop;
       }
-      pResidualErrorExit = pResidualErrorTrueEnd - cVectorLength * ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
+      pResidualErrorExit = pResidualErrorTrueEnd - cSampleStride * ((cSamples - 1) % cItemsPerBitPackedDataUnit + 1);
       EBM_ASSERT(pResidualError < pResidualErrorExit);
       EBM_ASSERT(pResidualErrorExit < pResidualErrorTrueEnd);
 
@@ -251,8 +434,8 @@ public:
          // stored in memory if shouldn't increase the time spent fetching it by 2 times, unless our bottleneck when threading is overwhelmingly memory pressure
          // related, and even then we could store the count for a single bit aleviating the memory pressure greatly, if we use the right sampling method 
 
-         // TODO : try using a sampling method with non-repeating samples, and put the count into a bit.  Then unwind that loop either at the byte level 
-         //   (8 times) or the uint64_t level.  This can be done without branching and doesn't require random number generators
+         // when sampling without replacement the count is stored in a single bit (see SamplingSet::GetIncludedBits).
+         // TODO : unwind that loop either at the byte level (8 times) or the uint64_t level
 
          cItemsRemaining = cItemsPerBitPackedDataUnit;
          // TODO : jumping back into this loop and changing cItemsRemaining to a dynamic value that isn't compile time determinable
@@ -271,15 +454,20 @@ public:
             );
 
             ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
-            const size_t cOccurences = *pCountOccurrences;
-            ++pCountOccurrences;
+            size_t cOccurences = 1;
+            if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+               // the bit is converted into a 0 or 1 multiplier, so there is no data dependent branch in here
+               cOccurences = (aIncludedBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 };
+               ++iSample;
+            } else if(OccurrenceStorage::Counts == occurrenceStorage) {
+               cOccurences = *pCountOccurrences;
+               ++pCountOccurrences;
+            }
             pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + cOccurences);
             const FloatEbmType cFloatOccurences = static_cast<FloatEbmType>(cOccurences);
             HistogramBucketVectorEntry<bClassification> * pHistogramBucketVectorEntry = 
                pHistogramBucketEntry->GetHistogramBucketVectorEntry();
 
-            size_t iVector = 0;
-
 #ifndef NDEBUG
 #ifdef EXPAND_BINARY_LOGITS
             constexpr bool bExpandBinaryLogits = true;
@@ -287,36 +475,23 @@ public:
             constexpr bool bExpandBinaryLogits = false;
 #endif // EXPAND_BINARY_LOGITS
             FloatEbmType residualTotalDebug = 0;
-#endif // NDEBUG
-            do {
-               const FloatEbmType residualError = *pResidualError;
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               const FloatEbmType residualError = pResidualError[iVector * cClassStride];
                EBM_ASSERT(
                   !bClassification ||
                   ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses && !bExpandBinaryLogits ||
                   static_cast<ptrdiff_t>(iVector) != k_iZeroResidual ||
                   0 == residualError
                );
-#ifndef NDEBUG
                residualTotalDebug += residualError;
+            }
 #endif // NDEBUG
-               pHistogramBucketVectorEntry[iVector].m_sumResidualError += cFloatOccurences * residualError;
-               if(bClassification) {
-                  // TODO : this code gets executed for each SamplingSet set.  I could probably execute it once and then all the
-                  //   SamplingSet sets would have this value, but I would need to store the computation in a new memory place, and it might 
-                  //   make more sense to calculate this values in the CPU rather than put more pressure on memory.  I think controlling this should be 
-                  //   done in a MACRO and we should use a class to hold the residualError and this computation from that value and then comment out the 
-                  //   computation if not necssary and access it through an accessor so that we can make the change entirely via macro
-                  const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
-                  pHistogramBucketVectorEntry[iVector].SetSumDenominator(
-                     pHistogramBucketVectorEntry[iVector].GetSumDenominator() + cFloatOccurences * denominator
-                  );
-               }
-               ++pResidualError;
-               ++iVector;
-               // if we use this specific format where (iVector < cVectorLength) then the compiler collapses alway the loop for small cVectorLength values
-               // if we make this (iVector != cVectorLength) then the loop is not collapsed
-               // the compiler seems to not mind if we make this a for loop or do loop in terms of collapsing away the loop
-            } while(iVector < cVectorLength);
+            AddResidualsToVector<compilerLearningTypeOrCountTargetClasses, bCachedDenominators>(
+               cVectorLength, cClassStride, cFloatOccurences, pResidualError, pDenominator, pHistogramBucketVectorEntry);
+            pResidualError += cSampleStride;
+            if(bCachedDenominators) {
+               pDenominator += cSampleStride;
+            }
 
             EBM_ASSERT(
                !bClassification ||
@@ -336,8 +511,8 @@ public:
       if(pResidualErrorTrueEnd != pResidualError) {
          LOG_0(TraceLevelVerbose, "Handling last BinDataSetTraining loop");
 
-         EBM_ASSERT(0 == (pResidualErrorTrueEnd - pResidualError) % cVectorLength);
-         cItemsRemaining = (pResidualErrorTrueEnd - pResidualError) / cVectorLength;
+         EBM_ASSERT(0 == (pResidualErrorTrueEnd - pResidualError) % cSampleStride);
+         cItemsRemaining = (pResidualErrorTrueEnd - pResidualError) / cSampleStride;
          EBM_ASSERT(0 < cItemsRemaining);
          EBM_ASSERT(cItemsRemaining <= cItemsPerBitPackedDataUnit);
 
@@ -348,6 +523,227 @@ public:
 
       LOG_0(TraceLevelVerbose, "Exited BinDataSetTraining");
    }
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      const OccurrenceStorage occurrenceStorage = pTrainingSet->GetOccurrenceStorage();
+      if(OccurrenceStorage::Flat == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::Flat>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::IncludedBits>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         EBM_ASSERT(OccurrenceStorage::Counts == occurrenceStorage);
+         FuncDenominators<OccurrenceStorage::Counts>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+
+private:
+
+   template<OccurrenceStorage occurrenceStorage>
+   INLINE_ALWAYS static void FuncDenominators(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      // regression doesn't use denominators, so we never cache them and don't need that specialization
+      if(IsClassification(compilerLearningTypeOrCountTargetClasses) && 
+         pTrainingSet->GetDataSetByFeatureGroup()->IsDenominatorsCached()) 
+      {
+         FuncStorage<occurrenceStorage, true>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         FuncStorage<occurrenceStorage, false>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators>
+   INLINE_ALWAYS static void FuncStorage(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      if(pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32()) {
+         FuncSampling<occurrenceStorage, bCachedDenominators, float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         FuncSampling<occurrenceStorage, bCachedDenominators, FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinBoostingNormalPacking final {
+public:
+
+   BinBoostingNormalPacking() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      // the aligned packings put whole nibbles, bytes, shorts or ints in each slot, so specializing on them lets the compiler 
+      // turn our shifts and masks into plain extractions.  Every other packing uses the dynamic loop
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+      if(k_cItemsPerBitPackedDataUnitAligned4 == cItemsPerBitPackedDataUnit) {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned4>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned8 == cItemsPerBitPackedDataUnit) {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned8>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned16 == cItemsPerBitPackedDataUnit) {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned16>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(k_cItemsPerBitPackedDataUnitAligned32 == cItemsPerBitPackedDataUnit) {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitAligned32>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         BinBoostingInternal<compilerLearningTypeOrCountTargetClasses, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
 };
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
@@ -360,6 +756,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -370,13 +768,15 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         BinBoostingInternal<compilerLearningTypeOrCountTargetClassesPossible, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+         BinBoostingNormalPacking<compilerLearningTypeOrCountTargetClassesPossible>::Func(
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -387,6 +787,8 @@ public:
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -406,6 +808,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -416,10 +820,12 @@ public:
       EBM_ASSERT(IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses());
 
-      BinBoostingInternal<k_dynamicClassification, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+      BinBoostingNormalPacking<k_dynamicClassification>::Func(
          pEbmBoostingState,
          pFeatureGroup,
          pTrainingSet,
+         iSampleBegin,
+         cSamplesShard,
          aHistogramBucketBase
 #ifndef NDEBUG
          , aHistogramBucketsEndDebug
@@ -438,6 +844,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -453,6 +861,8 @@ public:
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -466,6 +876,8 @@ public:
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -485,6 +897,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -496,6 +910,8 @@ public:
          pEbmBoostingState,
          pFeatureGroup,
          pTrainingSet,
+         iSampleBegin,
+         cSamplesShard,
          aHistogramBucketBase
 #ifndef NDEBUG
          , aHistogramBucketsEndDebug
@@ -514,6 +930,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -524,7 +942,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinBoostingSIMDPacking<
@@ -534,6 +952,8 @@ public:
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -544,6 +964,8 @@ public:
             pEbmBoostingState,
             pFeatureGroup,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
 #ifndef NDEBUG
             , aHistogramBucketsEndDebug
@@ -563,6 +985,8 @@ public:
       EbmBoostingState * const pEbmBoostingState,
       const FeatureGroup * const pFeatureGroup,
       const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
       HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
       , const unsigned char * const aHistogramBucketsEndDebug
@@ -577,6 +1001,8 @@ public:
          pEbmBoostingState,
          pFeatureGroup,
          pTrainingSet,
+         iSampleBegin,
+         cSamplesShard,
          aHistogramBucketBase
 #ifndef NDEBUG
          , aHistogramBucketsEndDebug
@@ -585,16 +1011,262 @@ public:
    }
 };
 
-extern void BinBoosting(
+// the first of the ascending samples in [pSample, pSampleEnd) that is iSample or later
+INLINE_ALWAYS static const size_t * FindSample(const size_t * pSample, const size_t * pSampleEnd, const size_t iSample) {
+   while(pSample != pSampleEnd) {
+      const size_t * const pMid = pSample + (pSampleEnd - pSample) / 2;
+      if(*pMid < iSample) {
+         pSample = pMid + 1;
+      } else {
+         pSampleEnd = pMid;
+      }
+   }
+   return pSample;
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinBoostingSampleIndex final {
+public:
+
+   BinBoostingSampleIndex() = delete; // this is a static class.  Do not construct
+
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators, typename TFloat>
+   static void FuncSampling(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      LOG_0(TraceLevelVerbose, "Entered BinBoostingSampleIndex");
+
+      HistogramBucket<bClassification> * const aHistogramBuckets =
+         aHistogramBucketBase->GetHistogramBucket<bClassification>();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
+      const DataSetByFeatureGroup * const pDataSet = pTrainingSet->GetDataSetByFeatureGroup();
+      EBM_ASSERT(0 < cSamplesShard);
+      EBM_ASSERT(iSampleBegin + cSamplesShard <= pDataSet->GetCountSamples());
+      const size_t iSampleEnd = iSampleBegin + cSamplesShard;
+
+      EBM_ASSERT(1 == pFeatureGroup->GetCountFeatures());
+      const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
+      const size_t * const aOffsets = pDataSet->GetSampleIndex(pFeatureGroup);
+      EBM_ASSERT(nullptr != aOffsets);
+      const size_t * const aSamples = aOffsets + cBins + 1;
+
+      EBM_ASSERT(occurrenceStorage == pTrainingSet->GetOccurrenceStorage());
+      const size_t * const aIncludedBits = 
+         OccurrenceStorage::IncludedBits == occurrenceStorage ? pTrainingSet->GetIncludedBits() : nullptr;
+      const size_t * const aCountOccurrences = 
+         OccurrenceStorage::Counts == occurrenceStorage ? pTrainingSet->GetCountOccurrences() : nullptr;
+      // only multiclass training sets can be class-major, so the strides stay compile time constants otherwise
+      const bool bClassMajor = IsMulticlass(compilerLearningTypeOrCountTargetClasses) && pDataSet->IsClassMajor();
+      const size_t cSampleStride = bClassMajor ? size_t { 1 } : cVectorLength;
+      const size_t cClassStride = bClassMajor ? pDataSet->GetCountSamples() : size_t { 1 };
+      const TFloat * const aResidualErrors = pDataSet->GetResidualPointer<TFloat>();
+      EBM_ASSERT(bCachedDenominators == pDataSet->IsDenominatorsCached());
+      const TFloat * const aDenominators = bCachedDenominators ? pDataSet->GetDenominatorPointer<TFloat>() : nullptr;
+
+      // each bucket gets its samples in the same ascending order as the scan of BinBoostingInternal, so the sums are
+      // identical to it, and a shard only needs to find where its contiguous range starts and ends in each bin
+      for(size_t iBin = 0; iBin < cBins; ++iBin) {
+         const size_t * const pBinEnd = aSamples + aOffsets[iBin + 1];
+         const size_t * pSample = FindSample(aSamples + aOffsets[iBin], pBinEnd, iSampleBegin);
+         const size_t * const pSampleEnd = FindSample(pSample, pBinEnd, iSampleEnd);
+         if(pSample == pSampleEnd) {
+            continue;
+         }
+
+         HistogramBucket<bClassification> * const pHistogramBucketEntry = 
+            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, iBin);
+         ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
+         HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry = 
+            pHistogramBucketEntry->GetHistogramBucketVectorEntry();
+         size_t cSamplesInBucket = pHistogramBucketEntry->GetCountSamplesInBucket();
+         do {
+            const size_t iSample = *pSample;
+            size_t cOccurences = 1;
+            if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+               cOccurences = (aIncludedBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 };
+            } else if(OccurrenceStorage::Counts == occurrenceStorage) {
+               cOccurences = aCountOccurrences[iSample];
+            }
+            cSamplesInBucket += cOccurences;
+            AddResidualsToVector<compilerLearningTypeOrCountTargetClasses, bCachedDenominators>(
+               cVectorLength, 
+               cClassStride, 
+               static_cast<FloatEbmType>(cOccurences), 
+               aResidualErrors + cSampleStride * iSample, 
+               bCachedDenominators ? aDenominators + cSampleStride * iSample : nullptr, 
+               pHistogramBucketVectorEntry
+            );
+            ++pSample;
+         } while(pSampleEnd != pSample);
+         pHistogramBucketEntry->SetCountSamplesInBucket(cSamplesInBucket);
+      }
+
+      LOG_0(TraceLevelVerbose, "Exited BinBoostingSampleIndex");
+   }
+
+   template<OccurrenceStorage occurrenceStorage, bool bCachedDenominators>
+   INLINE_ALWAYS static void FuncStorage(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      if(pTrainingSet->GetDataSetByFeatureGroup()->IsFloat32()) {
+         FuncSampling<occurrenceStorage, bCachedDenominators, float>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         FuncSampling<occurrenceStorage, bCachedDenominators, FloatEbmType>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+
+   template<OccurrenceStorage occurrenceStorage>
+   INLINE_ALWAYS static void FuncDenominators(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      if(IsClassification(compilerLearningTypeOrCountTargetClasses) && 
+         pTrainingSet->GetDataSetByFeatureGroup()->IsDenominatorsCached()) 
+      {
+         FuncStorage<occurrenceStorage, true>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         FuncStorage<occurrenceStorage, false>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+
+   static void Func(
+      EbmBoostingState * const pEbmBoostingState,
+      const FeatureGroup * const pFeatureGroup,
+      const SamplingSet * const pTrainingSet,
+      const size_t iSampleBegin,
+      const size_t cSamplesShard,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      const OccurrenceStorage occurrenceStorage = pTrainingSet->GetOccurrenceStorage();
+      if(OccurrenceStorage::Flat == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::Flat>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(OccurrenceStorage::IncludedBits == occurrenceStorage) {
+         FuncDenominators<OccurrenceStorage::IncludedBits>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         EBM_ASSERT(OccurrenceStorage::Counts == occurrenceStorage);
+         FuncDenominators<OccurrenceStorage::Counts>(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
+            aHistogramBucketBase
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+static void BinBoostingShard(
    EbmBoostingState * const pEbmBoostingState,
    const FeatureGroup * const pFeatureGroup,
    const SamplingSet * const pTrainingSet,
+   const size_t iSampleBegin,
+   const size_t cSamplesShard,
    HistogramBucketBase * const aHistogramBucketBase
 #ifndef NDEBUG
    , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
 ) {
-   LOG_0(TraceLevelVerbose, "Entered BinBoosting");
+   LOG_0(TraceLevelVerbose, "Entered BinBoostingShard");
 
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
 
@@ -603,6 +1275,8 @@ extern void BinBoosting(
          BinBoostingZeroDimensionsTarget<2>::Func(
             pEbmBoostingState,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
          );
       } else {
@@ -610,12 +1284,54 @@ extern void BinBoosting(
          BinBoostingZeroDimensions<k_regression>::Func(
             pEbmBoostingState,
             pTrainingSet,
+            iSampleBegin,
+            cSamplesShard,
             aHistogramBucketBase
          );
       }
    } else {
       EBM_ASSERT(1 <= pFeatureGroup->GetCountFeatures());
-      if(k_bUseSIMD) {
+      if(nullptr != pTrainingSet->GetDataSetByFeatureGroup()->GetSampleIndex(pFeatureGroup)) {
+         // the index doesn't depend on the packing, so we only specialize binary classification, which is common 
+         // enough to deserve it, and every other number of classes shares one kernel
+         if(IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+            BinBoostingSampleIndex<k_regression>::Func(
+               pEbmBoostingState,
+               pFeatureGroup,
+               pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
+               aHistogramBucketBase
+#ifndef NDEBUG
+               , aHistogramBucketsEndDebug
+#endif // NDEBUG
+            );
+         } else if(ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses) {
+            BinBoostingSampleIndex<2>::Func(
+               pEbmBoostingState,
+               pFeatureGroup,
+               pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
+               aHistogramBucketBase
+#ifndef NDEBUG
+               , aHistogramBucketsEndDebug
+#endif // NDEBUG
+            );
+         } else {
+            BinBoostingSampleIndex<k_dynamicClassification>::Func(
+               pEbmBoostingState,
+               pFeatureGroup,
+               pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
+               aHistogramBucketBase
+#ifndef NDEBUG
+               , aHistogramBucketsEndDebug
+#endif // NDEBUG
+            );
+         }
+      } else if(k_bUseSIMD) {
          // TODO : enable SIMD(AVX-512) to work
 
          // 64 - do 8 at a time and unroll the loop 8 times.  These are bool features and are common.  Put the unrolled inner loop into a function
@@ -633,6 +1349,8 @@ extern void BinBoosting(
                pEbmBoostingState,
                pFeatureGroup,
                pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
                aHistogramBucketBase
 #ifndef NDEBUG
                , aHistogramBucketsEndDebug
@@ -644,6 +1362,8 @@ extern void BinBoosting(
                pEbmBoostingState,
                pFeatureGroup,
                pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
                aHistogramBucketBase
 #ifndef NDEBUG
                , aHistogramBucketsEndDebug
@@ -662,6 +1382,8 @@ extern void BinBoosting(
                pEbmBoostingState,
                pFeatureGroup,
                pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
                aHistogramBucketBase
 #ifndef NDEBUG
                , aHistogramBucketsEndDebug
@@ -669,10 +1391,12 @@ extern void BinBoosting(
             );
          } else {
             EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-            BinBoostingInternal<k_regression, k_cItemsPerBitPackedDataUnitDynamic>::Func(
+            BinBoostingNormalPacking<k_regression>::Func(
                pEbmBoostingState,
                pFeatureGroup,
                pTrainingSet,
+               iSampleBegin,
+               cSamplesShard,
                aHistogramBucketBase
 #ifndef NDEBUG
                , aHistogramBucketsEndDebug
@@ -682,5 +1406,411 @@ extern void BinBoosting(
       }
    }
 
+   LOG_0(TraceLevelVerbose, "Exited BinBoostingShard");
+}
+
+class BinBoostingShardContext final {
+public:
+   EbmBoostingState * m_pEbmBoostingState;
+   const FeatureGroup * m_pFeatureGroup;
+   const SamplingSet * m_pTrainingSet;
+   size_t m_cSamples;
+   size_t m_cSamplesPerShard;
+   size_t m_cVectorLength;
+   size_t m_cHistogramBuckets;
+   size_t m_cBytesPerHistogramBucket;
+   size_t m_cBytesPerHistogram;
+   // shard zero bins directly into the caller's histogram.  Shards 1 and above use the private histograms
+   // which are laid out one after another in m_aShardHistogramBuckets
+   HistogramBucketBase * m_aHistogramBucketBase;
+   unsigned char * m_aShardHistogramBuckets;
+#ifndef NDEBUG
+   const unsigned char * m_aHistogramBucketsEndDebug;
+#endif // NDEBUG
+};
+
+template<bool bClassification>
+static void ZeroHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const size_t cBytesPerHistogramBucket,
+   HistogramBucketBase * const aHistogramBucketBase
+) {
+   HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<bClassification>();
+   for(size_t iBucket = 0; iBucket < cHistogramBuckets; ++iBucket) {
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, iBucket)->Zero(cVectorLength);
+   }
+}
+
+template<bool bClassification>
+static void AddHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const size_t cBytesPerHistogramBucket,
+   HistogramBucketBase * const aHistogramBucketBaseTo,
+   const HistogramBucketBase * const aHistogramBucketBaseFrom
+) {
+   HistogramBucket<bClassification> * const aHistogramBucketsTo = aHistogramBucketBaseTo->GetHistogramBucket<bClassification>();
+   const HistogramBucket<bClassification> * const aHistogramBucketsFrom = 
+      aHistogramBucketBaseFrom->GetHistogramBucket<bClassification>();
+   for(size_t iBucket = 0; iBucket < cHistogramBuckets; ++iBucket) {
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsTo, iBucket)->Add(
+         *GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsFrom, iBucket),
+         cVectorLength
+      );
+   }
+}
+
+// each reduce task adds this many bytes of every shard histogram.  Smaller histograms are reduced by the calling thread 
+// since launching tasks would cost more than the additions that they would share
+constexpr size_t k_cBytesShardReduceChunk = size_t { 64 } * 1024;
+
+class ReduceShardHistogramsContext final {
+public:
+   bool m_bClassification;
+   size_t m_cVectorLength;
+   size_t m_cHistogramBuckets;
+   size_t m_cBytesPerHistogramBucket;
+   size_t m_cBytesPerHistogram;
+   HistogramBucketBase * m_aHistogramBucketBase;
+   unsigned char * m_aShardHistogramBuckets;
+   size_t m_cShards;
+   // each group is a run of consecutive shards, one group per NUMA node that our threads are pinned to
+   size_t m_cShardsPerGroup;
+   size_t m_cGroups;
+   size_t m_cBucketsPerChunk;
+   size_t m_cChunks;
+};
+
+static HistogramBucketBase * GetShardHistogram(const ReduceShardHistogramsContext * const pReduceContext, const size_t iShard) {
+   if(size_t { 0 } == iShard) {
+      return pReduceContext->m_aHistogramBucketBase;
+   }
+   return reinterpret_cast<HistogramBucketBase *>(
+      pReduceContext->m_aShardHistogramBuckets + pReduceContext->m_cBytesPerHistogram * (iShard - 1));
+}
+
+static void AddShardHistogramChunk(
+   const ReduceShardHistogramsContext * const pReduceContext,
+   const size_t iChunk,
+   const size_t iShardTo,
+   const size_t iShardFrom
+) {
+   const size_t iBucketBegin = iChunk * pReduceContext->m_cBucketsPerChunk;
+   EBM_ASSERT(iBucketBegin < pReduceContext->m_cHistogramBuckets);
+   const size_t cHistogramBuckets = std::min(pReduceContext->m_cBucketsPerChunk, pReduceContext->m_cHistogramBuckets - iBucketBegin);
+   const size_t cBytesBegin = iBucketBegin * pReduceContext->m_cBytesPerHistogramBucket;
+
+   HistogramBucketBase * const aHistogramBucketBaseTo = reinterpret_cast<HistogramBucketBase *>(
+      reinterpret_cast<unsigned char *>(GetShardHistogram(pReduceContext, iShardTo)) + cBytesBegin);
+   const HistogramBucketBase * const aHistogramBucketBaseFrom = reinterpret_cast<const HistogramBucketBase *>(
+      reinterpret_cast<const unsigned char *>(GetShardHistogram(pReduceContext, iShardFrom)) + cBytesBegin);
+   if(pReduceContext->m_bClassification) {
+      AddHistogramBuckets<true>(
+         pReduceContext->m_cVectorLength,
+         cHistogramBuckets,
+         pReduceContext->m_cBytesPerHistogramBucket,
+         aHistogramBucketBaseTo,
+         aHistogramBucketBaseFrom
+      );
+   } else {
+      AddHistogramBuckets<false>(
+         pReduceContext->m_cVectorLength,
+         cHistogramBuckets,
+         pReduceContext->m_cBytesPerHistogramBucket,
+         aHistogramBucketBaseTo,
+         aHistogramBucketBaseFrom
+      );
+   }
+}
+
+// the first level adds the shards of each group into the group's first shard.  There is one task per group and chunk
+static void ReduceShardHistogramsGroupTask(void * const pContext, const size_t iTask) {
+   const ReduceShardHistogramsContext * const pReduceContext = static_cast<const ReduceShardHistogramsContext *>(pContext);
+
+   const size_t iGroup = iTask / pReduceContext->m_cChunks;
+   const size_t iChunk = iTask % pReduceContext->m_cChunks;
+   EBM_ASSERT(iGroup < pReduceContext->m_cGroups);
+   const size_t iShardBegin = iGroup * pReduceContext->m_cShardsPerGroup;
+   const size_t iShardEnd = std::min(iShardBegin + pReduceContext->m_cShardsPerGroup, pReduceContext->m_cShards);
+
+   // floating point addition isn't associative, so every bucket adds the shards in shard order.  This is the same 
+   // order as adding whole histograms one after another, so splitting the buckets over tasks doesn't change our sums 
+   // and they depend only on the number of shards and groups and not on which threads happened to execute them.  
+   // With a single group this is the whole reduction
+   for(size_t iShard = iShardBegin + 1; iShard < iShardEnd; ++iShard) {
+      AddShardHistogramChunk(pReduceContext, iChunk, iShardBegin, iShard);
+   }
+}
+
+// the second level adds the group totals into shard zero in group order, so only one partial histogram per node has 
+// to cross between the nodes instead of every shard histogram
+static void ReduceShardHistogramsNodeTask(void * const pContext, const size_t iChunk) {
+   const ReduceShardHistogramsContext * const pReduceContext = static_cast<const ReduceShardHistogramsContext *>(pContext);
+
+   for(size_t iGroup = 1; iGroup < pReduceContext->m_cGroups; ++iGroup) {
+      AddShardHistogramChunk(pReduceContext, iChunk, 0, iGroup * pReduceContext->m_cShardsPerGroup);
+   }
+}
+
+static void BinBoostingShardTask(void * const pContext, const size_t iShard) {
+   const BinBoostingShardContext * const pShardContext = static_cast<const BinBoostingShardContext *>(pContext);
+
+   const size_t iSampleBegin = pShardContext->m_cSamplesPerShard * iShard;
+   EBM_ASSERT(iSampleBegin < pShardContext->m_cSamples);
+   const size_t cSamplesRemaining = pShardContext->m_cSamples - iSampleBegin;
+   const size_t cSamplesShard = 
+      cSamplesRemaining < pShardContext->m_cSamplesPerShard ? cSamplesRemaining : pShardContext->m_cSamplesPerShard;
+
+   HistogramBucketBase * aHistogramBucketBase = pShardContext->m_aHistogramBucketBase;
+#ifndef NDEBUG
+   const unsigned char * aHistogramBucketsEndDebug = pShardContext->m_aHistogramBucketsEndDebug;
+#endif // NDEBUG
+   if(size_t { 0 } != iShard) {
+      unsigned char * const pShardHistogram = 
+         pShardContext->m_aShardHistogramBuckets + pShardContext->m_cBytesPerHistogram * (iShard - 1);
+      aHistogramBucketBase = reinterpret_cast<HistogramBucketBase *>(pShardHistogram);
+#ifndef NDEBUG
+      aHistogramBucketsEndDebug = nullptr == aHistogramBucketsEndDebug ? nullptr : pShardHistogram + pShardContext->m_cBytesPerHistogram;
+#endif // NDEBUG
+
+      const size_t cBytesPerHistogramBucket = pShardContext->m_cBytesPerHistogramBucket;
+      if(IsClassification(pShardContext->m_pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())) {
+         ZeroHistogramBuckets<true>(
+            pShardContext->m_cVectorLength,
+            pShardContext->m_cHistogramBuckets,
+            cBytesPerHistogramBucket,
+            aHistogramBucketBase
+         );
+      } else {
+         ZeroHistogramBuckets<false>(
+            pShardContext->m_cVectorLength,
+            pShardContext->m_cHistogramBuckets,
+            cBytesPerHistogramBucket,
+            aHistogramBucketBase
+         );
+      }
+   }
+
+   BinBoostingShard(
+      pShardContext->m_pEbmBoostingState,
+      pShardContext->m_pFeatureGroup,
+      pShardContext->m_pTrainingSet,
+      iSampleBegin,
+      cSamplesShard,
+      aHistogramBucketBase
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+}
+
+extern void BinBoosting(
+   EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const FeatureGroup * const pFeatureGroup,
+   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   LOG_0(TraceLevelVerbose, "Entered BinBoosting");
+
+   const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
+   EBM_ASSERT(0 < cSamples);
+
+   // shards need to begin on a packed data unit boundary, so we divide up units instead of samples
+   size_t cItemsPerBitPackedDataUnit = 1;
+   size_t cHistogramBuckets = 1;
+   if(nullptr != pFeatureGroup) {
+      cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+         // we check for simple multiplication overflow from m_cBins in EbmBoostingState->Initialize when we unpack featureGroupIndexes
+         EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, cBins));
+         cHistogramBuckets *= cBins;
+      }
+   }
+   EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+   const size_t cDataUnits = (cSamples - 1) / cItemsPerBitPackedDataUnit + 1;
+
+   size_t cShards = pEbmBoostingState->GetCountShards();
+   EBM_ASSERT(1 <= cShards);
+   cShards = cDataUnits < cShards ? cDataUnits : cShards;
+   const size_t cDataUnitsPerShard = (cDataUnits - 1) / cShards + 1;
+   // rounding up the units per shard can leave the last shards empty, so recompute the number that have work
+   cShards = (cDataUnits - 1) / cDataUnitsPerShard + 1;
+
+   unsigned char * aShardHistogramBuckets = nullptr;
+   size_t cBytesPerHistogram = 0;
+   if(size_t { 1 } < cShards) {
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+      const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // our caller allocated these already
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      // our caller allocated a histogram of this size already, so it can't overflow
+      EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, cBytesPerHistogramBucket));
+      cBytesPerHistogram = cHistogramBuckets * cBytesPerHistogramBucket;
+      if(IsMultiplyError(cBytesPerHistogram, cShards - 1)) {
+         LOG_0(TraceLevelWarning, "WARNING BinBoosting IsMultiplyError(cBytesPerHistogram, cShards - 1).  Binning in a single shard");
+      } else {
+         aShardHistogramBuckets = static_cast<unsigned char *>(
+            pCachedThreadResources->GetShardHistogramBuffer(cBytesPerHistogram * (cShards - 1))
+         );
+         if(nullptr == aShardHistogramBuckets) {
+            LOG_0(TraceLevelWarning, "WARNING BinBoosting nullptr == aShardHistogramBuckets.  Binning in a single shard");
+         }
+      }
+
+      if(nullptr != aShardHistogramBuckets) {
+         BinBoostingShardContext shardContext;
+         shardContext.m_pEbmBoostingState = pEbmBoostingState;
+         shardContext.m_pFeatureGroup = pFeatureGroup;
+         shardContext.m_pTrainingSet = pTrainingSet;
+         shardContext.m_cSamples = cSamples;
+         shardContext.m_cSamplesPerShard = cDataUnitsPerShard * cItemsPerBitPackedDataUnit;
+         shardContext.m_cVectorLength = cVectorLength;
+         shardContext.m_cHistogramBuckets = cHistogramBuckets;
+         shardContext.m_cBytesPerHistogramBucket = cBytesPerHistogramBucket;
+         shardContext.m_cBytesPerHistogram = cBytesPerHistogram;
+         shardContext.m_aHistogramBucketBase = aHistogramBucketBase;
+         shardContext.m_aShardHistogramBuckets = aShardHistogramBuckets;
+#ifndef NDEBUG
+         shardContext.m_aHistogramBucketsEndDebug = aHistogramBucketsEndDebug;
+#endif // NDEBUG
+
+         ThreadPool::ParallelFor(cShards, BinBoostingShardTask, &shardContext);
+
+         // large histograms split their buckets into chunks which are reduced in parallel, so no single thread has to 
+         // add up every shard histogram on its own
+         ReduceShardHistogramsContext reduceContext;
+         reduceContext.m_bClassification = bClassification;
+         reduceContext.m_cVectorLength = cVectorLength;
+         reduceContext.m_cHistogramBuckets = cHistogramBuckets;
+         reduceContext.m_cBytesPerHistogramBucket = cBytesPerHistogramBucket;
+         reduceContext.m_cBytesPerHistogram = cBytesPerHistogram;
+         reduceContext.m_aHistogramBucketBase = aHistogramBucketBase;
+         reduceContext.m_aShardHistogramBuckets = aShardHistogramBuckets;
+         reduceContext.m_cShards = cShards;
+         // without pinned threads there is a single group, and the reduction adds every shard into shard zero just 
+         // like it would on one node
+         const size_t cNodes = ThreadPool::GetCountNumaNodes();
+         EBM_ASSERT(1 <= cNodes);
+         const size_t cShardsPerGroup = (cShards - 1) / std::min(cNodes, cShards) + 1;
+         reduceContext.m_cShardsPerGroup = cShardsPerGroup;
+         const size_t cGroups = (cShards - 1) / cShardsPerGroup + 1;
+         reduceContext.m_cGroups = cGroups;
+         const size_t cBucketsPerChunk = std::max(size_t { 1 }, k_cBytesShardReduceChunk / cBytesPerHistogramBucket);
+         reduceContext.m_cBucketsPerChunk = cBucketsPerChunk;
+         const size_t cChunks = (cHistogramBuckets - 1) / cBucketsPerChunk + 1;
+         reduceContext.m_cChunks = cChunks;
+         // cGroups * cChunks can't overflow since every group and chunk is at least a shard and a bucket of memory
+         const size_t cGroupTasks = cGroups * cChunks;
+         if(size_t { 1 } < cGroupTasks) {
+            ThreadPool::ParallelFor(cGroupTasks, ReduceShardHistogramsGroupTask, &reduceContext);
+         } else {
+            ReduceShardHistogramsGroupTask(&reduceContext, 0);
+         }
+         if(size_t { 1 } < cGroups) {
+            if(size_t { 1 } < cChunks) {
+               ThreadPool::ParallelFor(cChunks, ReduceShardHistogramsNodeTask, &reduceContext);
+            } else {
+               ReduceShardHistogramsNodeTask(&reduceContext, 0);
+            }
+         }
+
+         LOG_0(TraceLevelVerbose, "Exited BinBoosting");
+         return;
+      }
+   }
+
+   BinBoostingShard(
+      pEbmBoostingState,
+      pFeatureGroup,
+      pTrainingSet,
+      0,
+      cSamples,
+      aHistogramBucketBase
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+
    LOG_0(TraceLevelVerbose, "Exited BinBoosting");
 }
+
+// the samples of each block stay in L1/L2 while every feature group of a BinBoostingMultiple batch bins them
+constexpr size_t k_cBinBoostingMultipleBlockSamples = 2048;
+
+extern void BinBoostingMultiple(
+   EbmBoostingState * const pEbmBoostingState,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroups,
+   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const * const aHistogramBucketBases
+#ifndef NDEBUG
+   , const unsigned char * const * const aHistogramBucketsEndsDebug
+#endif // NDEBUG
+) {
+   LOG_0(TraceLevelVerbose, "Entered BinBoostingMultiple");
+
+   const size_t cSamples = pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples();
+   EBM_ASSERT(0 < cSamples);
+
+   // indexed feature groups read their samples bin by bin instead of walking the residuals, so a single call over 
+   // all the samples gives them nothing to share with the other feature groups
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroups[iFeatureGroup];
+      EBM_ASSERT(nullptr != pFeatureGroup);
+      if(nullptr != pTrainingSet->GetDataSetByFeatureGroup()->GetSampleIndex(pFeatureGroup)) {
+         BinBoostingShard(
+            pEbmBoostingState,
+            pFeatureGroup,
+            pTrainingSet,
+            0,
+            cSamples,
+            aHistogramBucketBases[iFeatureGroup]
+#ifndef NDEBUG
+            , aHistogramBucketsEndsDebug[iFeatureGroup]
+#endif // NDEBUG
+         );
+      }
+   }
+
+   // each feature group bins the blocks in sample order, which adds to every bucket in the same order as BinBoosting 
+   // with a single shard, so the histograms are identical to binning each feature group separately.  Ranges have to 
+   // begin on a packed data unit boundary, so every feature group rounds the block boundaries down to its own units
+   for(size_t iBlockBegin = 0; iBlockBegin < cSamples; iBlockBegin += k_cBinBoostingMultipleBlockSamples) {
+      const size_t cSamplesRemaining = cSamples - iBlockBegin;
+      const bool bLastBlock = cSamplesRemaining <= k_cBinBoostingMultipleBlockSamples;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = apFeatureGroups[iFeatureGroup];
+         if(nullptr != pTrainingSet->GetDataSetByFeatureGroup()->GetSampleIndex(pFeatureGroup)) {
+            continue;
+         }
+         const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+         EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+         const size_t iSampleBegin = iBlockBegin / cItemsPerBitPackedDataUnit * cItemsPerBitPackedDataUnit;
+         const size_t iSampleEnd = bLastBlock ? cSamples : 
+            (iBlockBegin + k_cBinBoostingMultipleBlockSamples) / cItemsPerBitPackedDataUnit * cItemsPerBitPackedDataUnit;
+         if(iSampleBegin < iSampleEnd) {
+            BinBoostingShard(
+               pEbmBoostingState,
+               pFeatureGroup,
+               pTrainingSet,
+               iSampleBegin,
+               iSampleEnd - iSampleBegin,
+               aHistogramBucketBases[iFeatureGroup]
+#ifndef NDEBUG
+               , aHistogramBucketsEndsDebug[iFeatureGroup]
+#endif // NDEBUG
+            );
+         }
+      }
+   }
+
+   LOG_0(TraceLevelVerbose, "Exited BinBoostingMultiple");
+}
@@ -36,11 +36,12 @@ public:
 #endif // NDEBUG
    ) {
       constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+      constexpr bool bNeedDenominator = k_bInteractionNeedDenominator;
 
       LOG_0(TraceLevelVerbose, "Entered BinDataSetInteraction");
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets = 
-         aHistogramBucketBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * const aHistogramBuckets = 
+         aHistogramBucketBase->GetHistogramBucket<bNeedDenominator>();
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
 
@@ -49,8 +50,8 @@ public:
          runtimeLearningTypeOrCountTargetClasses
       );
       const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
-      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
-      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
 
       const DataSetByFeature * const pDataSet = pEbmInteractionState->GetDataSetByFeature();
       const FloatEbmType * pResidualError = pDataSet->GetResidualPointer();
@@ -59,6 +60,20 @@ public:
       EBM_ASSERT(2 <= pFeatureGroup->GetCountFeatures()); // for interactions, we just return 0 for interactions with zero features
       const size_t cDimensions = GET_ATTRIBUTE_COMBINATION_DIMENSIONS(compilerCountDimensions, pFeatureGroup->GetCountFeatures());
 
+      // the input data and the bucket stride of each dimension don't change between samples.  With a compile time 
+      // cDimensions these stay in registers and the loop over the dimensions below unrolls
+      const StorageDataType * apInputData[k_cDimensionsMax];
+      size_t acBins[k_cDimensionsMax];
+      size_t acBucketStrides[k_cDimensionsMax];
+      size_t cBucketsStride = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const Feature * const pInputFeature = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature;
+         apInputData[iDimension] = pDataSet->GetInputDataPointer(pInputFeature);
+         acBins[iDimension] = pInputFeature->GetCountBins();
+         acBucketStrides[iDimension] = cBucketsStride;
+         cBucketsStride *= acBins[iDimension];
+      }
+
       for(size_t iSample = 0; pResidualErrorEnd != pResidualError; ++iSample) {
          // this loop gets about twice as slow if you add a single unpredictable branching if statement based on count, even if you still access all the memory
          // in complete sequential order, so we'll probably want to use non-branching instructions for any solution like conditional selection or multiplication
@@ -74,29 +89,23 @@ public:
          // TODO : we can elminate the inner vector loop for regression at least, and also if we add a templated bool for binary class.  Propegate this change 
          //   to all places that we loop on the vector
 
-         size_t cBuckets = 1;
          size_t iBucket = 0;
          size_t iDimension = 0;
          do {
-            const Feature * const pInputFeature = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature;
-            const size_t cBins = pInputFeature->GetCountBins();
-            const StorageDataType * pInputData = pDataSet->GetInputDataPointer(pInputFeature);
-            pInputData += iSample;
-            StorageDataType iBinOriginal = *pInputData;
+            const StorageDataType iBinOriginal = apInputData[iDimension][iSample];
             EBM_ASSERT(IsNumberConvertable<size_t>(iBinOriginal));
-            size_t iBin = static_cast<size_t>(iBinOriginal);
-            EBM_ASSERT(iBin < cBins);
-            iBucket += cBuckets * iBin;
-            cBuckets *= cBins;
+            const size_t iBin = static_cast<size_t>(iBinOriginal);
+            EBM_ASSERT(iBin < acBins[iDimension]);
+            iBucket += acBucketStrides[iDimension] * iBin;
             ++iDimension;
          } while(iDimension < cDimensions);
 
-         HistogramBucket<bClassification> * pHistogramBucketEntry =
-            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aHistogramBuckets, iBucket);
+         HistogramBucket<bNeedDenominator> * pHistogramBucketEntry =
+            GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, aHistogramBuckets, iBucket);
          ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
          pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + 1);
 
-         HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry =
+         HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntry =
             pHistogramBucketEntry->GetHistogramBucketVectorEntry();
 
          for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
@@ -112,26 +121,6 @@ public:
                   !std::isinf(residualError) && 
                   FloatEbmType { -1 } - k_epsilonResidualError <= residualError && residualError <= FloatEbmType { 1 }
                   );
-
-               // TODO : this code gets executed for each SamplingSet set.  I could probably execute it once and then all the SamplingSet
-               //   sets would have this value, but I would need to store the computation in a new memory place, and it might make more sense to calculate this 
-               //   values in the CPU rather than put more pressure on memory.  I think controlling this should be done in a MACRO and we should use a class to 
-               //   hold the residualError and this computation from that value and then comment out the computation if not necssary and access it through an 
-               //   accessor so that we can make the change entirely via macro
-               const FloatEbmType denominator = EbmStatistics::ComputeNewtonRaphsonStep(residualError);
-               EBM_ASSERT(
-                  std::isnan(denominator) ||
-                  !std::isinf(denominator) && -k_epsilonResidualError <= denominator && denominator <= FloatEbmType { 0.25 }
-               ); // since any one denominatory is limited to -1 <= denominator <= 1, the sum must be representable by a 64 bit number, 
-
-               const FloatEbmType oldDenominator = pHistogramBucketVectorEntry[iVector].GetSumDenominator();
-               // since any one denominatory is limited to -1 <= denominator <= 1, the sum must be representable by a 64 bit number, 
-               EBM_ASSERT(std::isnan(oldDenominator) || !std::isinf(oldDenominator) && -k_epsilonResidualError <= oldDenominator);
-               const FloatEbmType newDenominator = oldDenominator + denominator;
-               // since any one denominatory is limited to -1 <= denominator <= 1, the sum must be representable by a 64 bit number, 
-               EBM_ASSERT(std::isnan(newDenominator) || !std::isinf(newDenominator) && -k_epsilonResidualError <= newDenominator);
-               // which will always be representable by a float or double, so we can't overflow to inifinity or -infinity
-               pHistogramBucketVectorEntry[iVector].SetSumDenominator(newDenominator);
             }
             ++pResidualError;
          }
@@ -199,14 +188,25 @@ public:
    ) {
       EBM_ASSERT(2 <= pFeatureGroup->GetCountFeatures());
       EBM_ASSERT(pFeatureGroup->GetCountFeatures() <= k_cDimensionsMax);
-      BinInteractionInternal<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions>::Func(
-         pEbmInteractionState,
-         pFeatureGroup,
-         aHistogramBuckets
+      if(k_cCompilerOptimizedCountDimensionsExtra == pFeatureGroup->GetCountFeatures()) {
+         BinInteractionInternal<compilerLearningTypeOrCountTargetClasses, k_cCompilerOptimizedCountDimensionsExtra>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            aHistogramBuckets
 #ifndef NDEBUG
-         , aHistogramBucketsEndDebug
+            , aHistogramBucketsEndDebug
 #endif // NDEBUG
-      );
+         );
+      } else {
+         BinInteractionInternal<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            aHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
    }
 };
 
@@ -229,7 +229,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          BinInteractionDimensions<compilerLearningTypeOrCountTargetClassesPossible, 2>::Func(
@@ -314,3 +314,211 @@ extern void BinInteraction(
       );
    }
 }
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class BinInteractionPairsInternal final {
+public:
+
+   BinInteractionPairsInternal() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const DataSetByFeature * const pDataSet,
+      const Feature * const pFeature0,
+      const size_t cPairs,
+      const Feature * const * const apFeatures1,
+      HistogramBucketBase * const * const aaHistogramBucketBase
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      constexpr bool bNeedDenominator = k_bInteractionNeedDenominator;
+
+      LOG_0(TraceLevelVerbose, "Entered BinInteractionPairsInternal");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
+
+      const FloatEbmType * pResidualError = pDataSet->GetResidualPointer();
+      const FloatEbmType * const pResidualErrorEnd = pResidualError + cVectorLength * pDataSet->GetCountSamples();
+
+      EBM_ASSERT(1 <= cPairs);
+      const size_t cBins0 = pFeature0->GetCountBins();
+      const StorageDataType * const aInputData0 = pDataSet->GetInputDataPointer(pFeature0);
+
+      // every pair shares the first feature, so we read the first feature's column and the residuals once per sample
+      // instead of once per pair.  The second feature varies per pair, so it's the only extra column that we stream
+      for(size_t iSample = 0; pResidualErrorEnd != pResidualError; ++iSample) {
+         const StorageDataType iBinOriginal0 = aInputData0[iSample];
+         EBM_ASSERT(IsNumberConvertable<size_t>(iBinOriginal0));
+         const size_t iBin0 = static_cast<size_t>(iBinOriginal0);
+         EBM_ASSERT(iBin0 < cBins0);
+
+         for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+            const Feature * const pFeature1 = apFeatures1[iPair];
+            const StorageDataType iBinOriginal1 = pDataSet->GetInputDataPointer(pFeature1)[iSample];
+            EBM_ASSERT(IsNumberConvertable<size_t>(iBinOriginal1));
+            const size_t iBin1 = static_cast<size_t>(iBinOriginal1);
+            EBM_ASSERT(iBin1 < pFeature1->GetCountBins());
+            const size_t iBucket = iBin0 + cBins0 * iBin1;
+
+            HistogramBucket<bNeedDenominator> * const pHistogramBucketEntry = GetHistogramBucketByIndex<bNeedDenominator>(
+               cBytesPerHistogramBucket,
+               aaHistogramBucketBase[iPair]->GetHistogramBucket<bNeedDenominator>(),
+               iBucket
+            );
+            ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntry, aHistogramBucketsEndDebug);
+            pHistogramBucketEntry->SetCountSamplesInBucket(pHistogramBucketEntry->GetCountSamplesInBucket() + 1);
+
+            HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntry =
+               pHistogramBucketEntry->GetHistogramBucketVectorEntry();
+
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               const FloatEbmType residualError = pResidualError[iVector];
+               pHistogramBucketVectorEntry[iVector].m_sumResidualError += residualError;
+            }
+         }
+         pResidualError += cVectorLength;
+      }
+      LOG_0(TraceLevelVerbose, "Exited BinInteractionPairsInternal");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class BinInteractionPairsTarget final {
+public:
+
+   BinInteractionPairsTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const DataSetByFeature * const pDataSet,
+      const Feature * const pFeature0,
+      const size_t cPairs,
+      const Feature * const * const apFeatures1,
+      HistogramBucketBase * const * const aaHistogramBuckets
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         BinInteractionPairsInternal<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pEbmInteractionState,
+            pDataSet,
+            pFeature0,
+            cPairs,
+            apFeatures1,
+            aaHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         BinInteractionPairsTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pEbmInteractionState,
+            pDataSet,
+            pFeature0,
+            cPairs,
+            apFeatures1,
+            aaHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<>
+class BinInteractionPairsTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   BinInteractionPairsTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static void Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const DataSetByFeature * const pDataSet,
+      const Feature * const pFeature0,
+      const size_t cPairs,
+      const Feature * const * const apFeatures1,
+      HistogramBucketBase * const * const aaHistogramBuckets
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      BinInteractionPairsInternal<k_dynamicClassification>::Func(
+         pEbmInteractionState,
+         pDataSet,
+         pFeature0,
+         cPairs,
+         apFeatures1,
+         aaHistogramBuckets
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   }
+};
+
+// bins several pairs that share their first feature in a single pass over the samples of pDataSet, which is either
+// the full data set of pEbmInteractionState or its screening subset.  Each histogram is laid out exactly as 
+// BinInteraction would lay out the 2 dimensional tensor of { pFeature0, apFeatures1[iPair] }
+extern void BinInteractionPairs(
+   EbmInteractionState * const pEbmInteractionState,
+   const DataSetByFeature * const pDataSet,
+   const Feature * const pFeature0,
+   const size_t cPairs,
+   const Feature * const * const apFeatures1,
+   HistogramBucketBase * const * const aaHistogramBuckets
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      BinInteractionPairsTarget<2>::Func(
+         pEbmInteractionState,
+         pDataSet,
+         pFeature0,
+         cPairs,
+         apFeatures1,
+         aaHistogramBuckets
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   } else {
+      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+      BinInteractionPairsInternal<k_regression>::Func(
+         pEbmInteractionState,
+         pDataSet,
+         pFeature0,
+         cPairs,
+         apFeatures1,
+         aaHistogramBuckets
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   }
+}
@@ -0,0 +1,385 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memmove
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "ThreadPool.h"
+
+extern IntEbmType GenerateQuantileBinCutsInternal(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut,
+   FloatEbmType * aFeatureValuesScratch
+);
+
+extern IntEbmType GenerateWinsorizedBinCutsInternal(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut,
+   FloatEbmType * aFeatureValuesScratch
+);
+
+class BinCutsFeaturesContext final {
+public:
+
+   BinCutsFeaturesContext() = default; // preserve our POD status
+   ~BinCutsFeaturesContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   IntEbmType m_binningType;
+   IntEbmType m_countSamples;
+   IntEbmType m_countSamplesPerBinMin;
+   IntEbmType m_isHumanized;
+   IntEbmType m_randomSeed;
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   size_t m_cTasks;
+
+   const FloatEbmType * m_aFeatureValues;
+   IntEbmType * m_aCountBinCutsInOut;
+   FloatEbmType * m_aBinCutsLowerBoundInclusiveOut;
+   IntEbmType * m_aCountMissingValuesOut;
+   FloatEbmType * m_aMinNonInfinityValueOut;
+   IntEbmType * m_aCountNegativeInfinityOut;
+   FloatEbmType * m_aMaxNonInfinityValueOut;
+   IntEbmType * m_aCountPositiveInfinityOut;
+
+   // cFeatures items which hold the index where each feature writes its cuts inside m_aBinCutsLowerBoundInclusiveOut
+   const size_t * m_aiBinCutsStart;
+   // cFeatures items which hold the return value of the single feature binning function
+   IntEbmType * m_aRet;
+   // cTasks sets of cSamples items that the tasks copy and sort each of their features into.  nullptr for uniform
+   // binning, which doesn't need to sort
+   FloatEbmType * m_aScratch;
+};
+static_assert(std::is_standard_layout<BinCutsFeaturesContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BinCutsFeaturesContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BinCutsFeaturesContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+template<typename T>
+INLINE_ALWAYS static T * OptionalItem(T * const a, const size_t iItem) {
+   return nullptr == a ? nullptr : a + iItem;
+}
+
+static void BinCutsFeaturesTask(void * const pContextVoid, const size_t iTask) {
+   const BinCutsFeaturesContext * const pContext = static_cast<const BinCutsFeaturesContext *>(pContextVoid);
+   const size_t cSamples = pContext->m_cSamples;
+   FloatEbmType * const aScratch = OptionalItem(pContext->m_aScratch, iTask * cSamples);
+   for(size_t iFeature = iTask; iFeature < pContext->m_cFeatures; iFeature += pContext->m_cTasks) {
+      const FloatEbmType * const aFeatureValues = pContext->m_aFeatureValues + iFeature * cSamples;
+      IntEbmType * const pCountBinCutsInOut = pContext->m_aCountBinCutsInOut + iFeature;
+      FloatEbmType * const aBinCutsOut = OptionalItem(pContext->m_aBinCutsLowerBoundInclusiveOut,
+         pContext->m_aiBinCutsStart[iFeature]);
+      IntEbmType * const pCountMissingValuesOut = OptionalItem(pContext->m_aCountMissingValuesOut, iFeature);
+      FloatEbmType * const pMinNonInfinityValueOut = OptionalItem(pContext->m_aMinNonInfinityValueOut, iFeature);
+      IntEbmType * const pCountNegativeInfinityOut = OptionalItem(pContext->m_aCountNegativeInfinityOut, iFeature);
+      FloatEbmType * const pMaxNonInfinityValueOut = OptionalItem(pContext->m_aMaxNonInfinityValueOut, iFeature);
+      IntEbmType * const pCountPositiveInfinityOut = OptionalItem(pContext->m_aCountPositiveInfinityOut, iFeature);
+
+      IntEbmType ret;
+      if(BinningTypeQuantile == pContext->m_binningType) {
+         ret = GenerateQuantileBinCutsInternal(
+            pContext->m_countSamples,
+            aFeatureValues,
+            pContext->m_countSamplesPerBinMin,
+            pContext->m_isHumanized,
+            pContext->m_randomSeed,
+            pCountBinCutsInOut,
+            aBinCutsOut,
+            pCountMissingValuesOut,
+            pMinNonInfinityValueOut,
+            pCountNegativeInfinityOut,
+            pMaxNonInfinityValueOut,
+            pCountPositiveInfinityOut,
+            aScratch
+         );
+      } else if(BinningTypeWinsorized == pContext->m_binningType) {
+         ret = GenerateWinsorizedBinCutsInternal(
+            pContext->m_countSamples,
+            aFeatureValues,
+            pCountBinCutsInOut,
+            aBinCutsOut,
+            pCountMissingValuesOut,
+            pMinNonInfinityValueOut,
+            pCountNegativeInfinityOut,
+            pMaxNonInfinityValueOut,
+            pCountPositiveInfinityOut,
+            aScratch
+         );
+      } else {
+         EBM_ASSERT(BinningTypeUniform == pContext->m_binningType);
+         GenerateUniformBinCuts(
+            pContext->m_countSamples,
+            aFeatureValues,
+            pCountBinCutsInOut,
+            aBinCutsOut,
+            pCountMissingValuesOut,
+            pMinNonInfinityValueOut,
+            pCountNegativeInfinityOut,
+            pMaxNonInfinityValueOut,
+            pCountPositiveInfinityOut
+         );
+         ret = IntEbmType { 0 };
+      }
+      pContext->m_aRet[iFeature] = ret;
+   }
+}
+
+static IntEbmType GenerateBinCutsFeaturesInternal(
+   const IntEbmType binningType,
+   const IntEbmType countSamples,
+   const IntEbmType countFeatures,
+   const FloatEbmType * const featureValues,
+   const IntEbmType countSamplesPerBinMin,
+   const IntEbmType isHumanized,
+   const IntEbmType randomSeed,
+   IntEbmType * const countBinCutsInOut,
+   FloatEbmType * const binCutsLowerBoundInclusiveOut,
+   IntEbmType * const countMissingValuesOut,
+   FloatEbmType * const minNonInfinityValueOut,
+   IntEbmType * const countNegativeInfinityOut,
+   FloatEbmType * const maxNonInfinityValueOut,
+   IntEbmType * const countPositiveInfinityOut
+) {
+   if(UNLIKELY(BinningTypeQuantile != binningType && BinningTypeWinsorized != binningType &&
+      BinningTypeUniform != binningType)
+   ) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures binningType must be one of the BinningType* values");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(countSamples < IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures countSamples cannot be negative");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(countFeatures < IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures countFeatures cannot be negative");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(IntEbmType { 0 } == countFeatures)) {
+      return IntEbmType { 0 };
+   }
+   if(UNLIKELY(!IsNumberConvertable<size_t>(countSamples) || !IsNumberConvertable<size_t>(countFeatures))) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateBinCutsFeatures countSamples or countFeatures was too large to fit into memory");
+      return IntEbmType { 1 };
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(UNLIKELY(IsMultiplyError(cSamples, cFeatures))) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateBinCutsFeatures countSamples * countFeatures was too large to fit into memory");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(nullptr == countBinCutsInOut)) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures countBinCutsInOut cannot be null");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(size_t { 0 } != cSamples && nullptr == featureValues)) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures featureValues cannot be null if there are samples");
+      return IntEbmType { 1 };
+   }
+
+   size_t * const aiBinCutsStart = EbmMalloc<size_t>(cFeatures);
+   if(UNLIKELY(nullptr == aiBinCutsStart)) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateBinCutsFeatures nullptr == aiBinCutsStart");
+      return IntEbmType { 1 };
+   }
+   size_t iBinCutsNext = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType countBinCutsMax = countBinCutsInOut[iFeature];
+      if(UNLIKELY(countBinCutsMax < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBinCutsMax) ||
+         IsAddError(iBinCutsNext, static_cast<size_t>(countBinCutsMax)))
+      ) {
+         LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures countBinCutsInOut must be positive and fit into memory");
+         free(aiBinCutsStart);
+         return IntEbmType { 1 };
+      }
+      aiBinCutsStart[iFeature] = iBinCutsNext;
+      iBinCutsNext += static_cast<size_t>(countBinCutsMax);
+   }
+   if(UNLIKELY(size_t { 0 } != iBinCutsNext && nullptr == binCutsLowerBoundInclusiveOut)) {
+      LOG_0(TraceLevelError, "ERROR GenerateBinCutsFeatures binCutsLowerBoundInclusiveOut cannot be null if there are cuts");
+      free(aiBinCutsStart);
+      return IntEbmType { 1 };
+   }
+
+   IntEbmType * const aRet = EbmMalloc<IntEbmType>(cFeatures);
+   if(UNLIKELY(nullptr == aRet)) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateBinCutsFeatures nullptr == aRet");
+      free(aiBinCutsStart);
+      return IntEbmType { 1 };
+   }
+
+   const size_t cThreads = ThreadPool::GetCountThreads();
+   const size_t cTasks = cFeatures < cThreads ? cFeatures : cThreads;
+
+   // the single feature functions copy their input into a buffer before sorting it.  We allocate one buffer per
+   // task up front and reuse it for each of the task's features instead of allocating one per feature
+   FloatEbmType * aScratch = nullptr;
+   if(BinningTypeUniform != binningType && size_t { 0 } != cSamples) {
+      aScratch = EbmMalloc<FloatEbmType>(cTasks, cSamples * sizeof(*aScratch));
+      if(UNLIKELY(nullptr == aScratch)) {
+         LOG_0(TraceLevelWarning, "WARNING GenerateBinCutsFeatures nullptr == aScratch");
+         free(aRet);
+         free(aiBinCutsStart);
+         return IntEbmType { 1 };
+      }
+   }
+
+   BinCutsFeaturesContext context;
+   context.m_binningType = binningType;
+   context.m_countSamples = countSamples;
+   context.m_countSamplesPerBinMin = countSamplesPerBinMin;
+   context.m_isHumanized = isHumanized;
+   context.m_randomSeed = randomSeed;
+   context.m_cSamples = cSamples;
+   context.m_cFeatures = cFeatures;
+   context.m_cTasks = cTasks;
+   context.m_aFeatureValues = featureValues;
+   context.m_aCountBinCutsInOut = countBinCutsInOut;
+   context.m_aBinCutsLowerBoundInclusiveOut = binCutsLowerBoundInclusiveOut;
+   context.m_aCountMissingValuesOut = countMissingValuesOut;
+   context.m_aMinNonInfinityValueOut = minNonInfinityValueOut;
+   context.m_aCountNegativeInfinityOut = countNegativeInfinityOut;
+   context.m_aMaxNonInfinityValueOut = maxNonInfinityValueOut;
+   context.m_aCountPositiveInfinityOut = countPositiveInfinityOut;
+   context.m_aiBinCutsStart = aiBinCutsStart;
+   context.m_aRet = aRet;
+   context.m_aScratch = aScratch;
+
+   ThreadPool::ParallelFor(cTasks, BinCutsFeaturesTask, &context);
+
+   IntEbmType ret = IntEbmType { 0 };
+   // each feature wrote its cuts at the start of the space reserved by its maximum, so pack them back to back in
+   // the format that DiscretizeFeatures accepts.  The packed position never passes the reserved position, so we
+   // can move them in place from the first feature to the last
+   size_t iBinCutsPacked = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      if(UNLIKELY(IntEbmType { 0 } != aRet[iFeature])) {
+         // any error messages were written to the log by the single feature function
+         ret = IntEbmType { 1 };
+      }
+      const size_t cBinCuts = static_cast<size_t>(countBinCutsInOut[iFeature]);
+      EBM_ASSERT(iBinCutsPacked <= aiBinCutsStart[iFeature]);
+      if(iBinCutsPacked != aiBinCutsStart[iFeature] && size_t { 0 } != cBinCuts) {
+         memmove(binCutsLowerBoundInclusiveOut + iBinCutsPacked, binCutsLowerBoundInclusiveOut + aiBinCutsStart[iFeature],
+            sizeof(*binCutsLowerBoundInclusiveOut) * cBinCuts);
+      }
+      iBinCutsPacked += cBinCuts;
+   }
+
+   free(aScratch);
+   free(aRet);
+   free(aiBinCutsStart);
+   return ret;
+}
+
+static std::atomic<int> g_cLogEnterGenerateBinCutsFeaturesParametersMessages { 25 };
+static std::atomic<int> g_cLogExitGenerateBinCutsFeaturesParametersMessages { 25 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateBinCutsFeatures(
+   IntEbmType binningType,
+   IntEbmType countSamples,
+   IntEbmType countFeatures,
+   const FloatEbmType * featureValues,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterGenerateBinCutsFeaturesParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered GenerateBinCutsFeatures: "
+      "binningType=%" IntEbmTypePrintf ", "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "countSamplesPerBinMin=%" IntEbmTypePrintf ", "
+      "isHumanized=%s, "
+      "randomSeed=%" IntEbmTypePrintf ", "
+      "countBinCutsInOut=%p, "
+      "binCutsLowerBoundInclusiveOut=%p, "
+      "countMissingValuesOut=%p, "
+      "minNonInfinityValueOut=%p, "
+      "countNegativeInfinityOut=%p, "
+      "maxNonInfinityValueOut=%p, "
+      "countPositiveInfinityOut=%p"
+      ,
+      binningType,
+      countSamples,
+      countFeatures,
+      static_cast<const void *>(featureValues),
+      countSamplesPerBinMin,
+      ObtainTruth(isHumanized),
+      randomSeed,
+      static_cast<void *>(countBinCutsInOut),
+      static_cast<void *>(binCutsLowerBoundInclusiveOut),
+      static_cast<void *>(countMissingValuesOut),
+      static_cast<void *>(minNonInfinityValueOut),
+      static_cast<void *>(countNegativeInfinityOut),
+      static_cast<void *>(maxNonInfinityValueOut),
+      static_cast<void *>(countPositiveInfinityOut)
+   );
+
+   const IntEbmType ret = GenerateBinCutsFeaturesInternal(
+      binningType,
+      countSamples,
+      countFeatures,
+      featureValues,
+      countSamplesPerBinMin,
+      isHumanized,
+      randomSeed,
+      countBinCutsInOut,
+      binCutsLowerBoundInclusiveOut,
+      countMissingValuesOut,
+      minNonInfinityValueOut,
+      countNegativeInfinityOut,
+      maxNonInfinityValueOut,
+      countPositiveInfinityOut
+   );
+
+   LOG_COUNTED_N(
+      &g_cLogExitGenerateBinCutsFeaturesParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited GenerateBinCutsFeatures: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+
+   return ret;
+}
@@ -8,9 +8,6 @@
 #include <limits> // std::numeric_limits
 #include <algorithm> // std::sort
 #include <cmath> // std::round
-#include <vector> // std::vector (used in std::priority_queue)
-#include <queue> // std::priority_queue
-#include <set> // std::set
 #include <string.h> // strchr, memmove
 
 #include "ebm_native.h"
@@ -62,6 +59,8 @@ extern size_t RemoveMissingValuesAndReplaceInfinities(
    IntEbmType * const pCountPositiveInfinityOut
 ) noexcept;
 
+extern void SortFeatureValues(const size_t cSamples, FloatEbmType * const aValues) noexcept;
+
 INLINE_ALWAYS constexpr static FloatEbmType GetTweakingMultiplePositive(const size_t iTweak) noexcept {
    return FloatEbmType { 1 } + tweakIncrement * static_cast<FloatEbmType>(iTweak);
 }
@@ -118,6 +117,9 @@ struct CutPoint final {
    // comparing two BinCuts that have the same distance to their endpoints
    size_t         m_uniqueTiebreaker;
 
+   // our position within the IntrusiveHeap while we're in it
+   size_t         m_iHeap;
+
    INLINE_ALWAYS void SetCut() noexcept {
       m_cPredeterminedMovementOnCut = k_movementDoneCut;
    }
@@ -169,6 +171,9 @@ struct CuttingRange final {
 
    FloatEbmType   m_avgCuttableRangeWidthAfterAddingOneCut;
    size_t         m_cRangesMax;
+
+   // our position within the IntrusiveHeap while we're in it
+   size_t         m_iHeap;
 };
 static_assert(std::is_standard_layout<CuttingRange>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -208,6 +213,128 @@ public:
    }
 };
 
+// IntrusiveHeap is a binary heap of pointers that orders items with TCompare, so the item that TCompare
+// places first is on top.  It never allocates.  The caller provides the array of pointers, which needs room for
+// every item that can be in the heap at the same time, and each item records its own position in m_iHeap so that
+// we can erase any item, not just the top one.  Our comparisons are strict total orders thanks to the
+// m_uniqueTiebreaker values, so we get the same items in the same order that a std::set would give us.
+template<typename T, typename TCompare>
+class IntrusiveHeap final {
+   T ** m_apItems;
+   size_t m_cItems;
+
+   INLINE_ALWAYS void Place(T * const pItem, const size_t iHeap) noexcept {
+      m_apItems[iHeap] = pItem;
+      pItem->m_iHeap = iHeap;
+   }
+
+   // moves pItem up from the hole at iHeap until its parent comes before it, then puts it there
+   INLINE_ALWAYS void SiftUp(T * const pItem, size_t iHeap) noexcept {
+      const TCompare compare;
+      while(size_t { 0 } != iHeap) {
+         const size_t iParent = (iHeap - size_t { 1 }) >> 1;
+         T * const pParent = m_apItems[iParent];
+         if(!compare(pItem, pParent)) {
+            break;
+         }
+         Place(pParent, iHeap);
+         iHeap = iParent;
+      }
+      Place(pItem, iHeap);
+   }
+
+   // moves pItem down from the hole at iHeap until it comes before both of its children, then puts it there
+   INLINE_ALWAYS void SiftDown(T * const pItem, size_t iHeap) noexcept {
+      const TCompare compare;
+      while(true) {
+         size_t iChild = (iHeap << 1) + size_t { 1 };
+         if(m_cItems <= iChild) {
+            break;
+         }
+         T * pChild = m_apItems[iChild];
+         const size_t iChildHigh = iChild + size_t { 1 };
+         if(iChildHigh < m_cItems) {
+            T * const pChildHigh = m_apItems[iChildHigh];
+            if(compare(pChildHigh, pChild)) {
+               iChild = iChildHigh;
+               pChild = pChildHigh;
+            }
+         }
+         if(!compare(pChild, pItem)) {
+            break;
+         }
+         Place(pChild, iHeap);
+         iHeap = iChild;
+      }
+      Place(pItem, iHeap);
+   }
+
+public:
+
+   IntrusiveHeap() = default; // preserve our POD status
+   ~IntrusiveHeap() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void Initialize(T ** const apItems) noexcept {
+      EBM_ASSERT(nullptr != apItems);
+      m_apItems = apItems;
+      m_cItems = size_t { 0 };
+   }
+
+   INLINE_ALWAYS bool IsEmpty() const noexcept {
+      return size_t { 0 } == m_cItems;
+   }
+
+   INLINE_ALWAYS size_t GetCount() const noexcept {
+      return m_cItems;
+   }
+
+   INLINE_ALWAYS T ** GetItems() const noexcept {
+      return m_apItems;
+   }
+
+   INLINE_ALWAYS bool IsContained(const T * const pItem) const noexcept {
+      return pItem->m_iHeap < m_cItems && pItem == m_apItems[pItem->m_iHeap];
+   }
+
+   INLINE_ALWAYS T * GetTop() const noexcept {
+      EBM_ASSERT(!IsEmpty());
+      return m_apItems[0];
+   }
+
+   INLINE_ALWAYS void Insert(T * const pItem) noexcept {
+      // the caller sized our array to hold everything that can be in the heap at the same time
+      const size_t iHeap = m_cItems;
+      ++m_cItems;
+      SiftUp(pItem, iHeap);
+   }
+
+   INLINE_ALWAYS void Erase(T * const pItem) noexcept {
+      EBM_ASSERT(IsContained(pItem));
+      const size_t iHeap = pItem->m_iHeap;
+      --m_cItems;
+      if(LIKELY(iHeap != m_cItems)) {
+         // fill the hole with our last item, which can belong either above or below the hole
+         T * const pLast = m_apItems[m_cItems];
+         if(size_t { 0 } != iHeap && TCompare()(pLast, m_apItems[(iHeap - size_t { 1 }) >> 1])) {
+            SiftUp(pLast, iHeap);
+         } else {
+            SiftDown(pLast, iHeap);
+         }
+      }
+   }
+};
+static_assert(std::is_standard_layout<IntrusiveHeap<CutPoint, CompareCutPoint>>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<IntrusiveHeap<CutPoint, CompareCutPoint>>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<IntrusiveHeap<CutPoint, CompareCutPoint>>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+typedef IntrusiveHeap<CutPoint, CompareCutPoint> CutPointHeap;
+typedef IntrusiveHeap<CuttingRange, CompareCuttingRange> CuttingRangeHeap;
+
 INLINE_RELEASE_UNTEMPLATED size_t CalculateRangesMaximizeMin(
    const FloatEbmType sideDistance, 
    const FloatEbmType totalDistance, 
@@ -808,7 +935,7 @@ static void BuildNeighbourhoodPlan(
 }
 
 static bool CutCuttingRange(
-   std::set<CutPoint *, CompareCutPoint> * const pBestBinCuts,
+   CutPointHeap * const pBestBinCuts,
 
    const size_t cSamples,
    const bool bSymmetryReversal,
@@ -830,659 +957,651 @@ static bool CutCuttingRange(
    EBM_ASSERT(cCuttableItems <= cSamples);
    EBM_ASSERT(nullptr != aNeighbourJumps);
 
-   // TODO: someday, for performance, it might make sense to use a non-allocating tree, like:
-   //       https://github.com/attractivechaos/klib/blob/master/kavl.h
-
-   try {
-      while(!pBestBinCuts->empty()) {
-         // We've located our desired cut points previously.  Sometimes those desired cut points
-         // are placed in the bulk of a long run of identical values and we have to decide if we'll be putting
-         // the cut at the start or the end of those long runs of identical values.
-         //
-         // Before this function in the call stack, we do some expensive exploration of the hardest cut point placement
-         // decisions that we need to make.  We do a full exploration of both the lower and higher placements of the long 
-         // runs, but that grows at O(2^N), so we need to limit this full exploration to just a few choices
-         //
-         // This function being lower in the stack needs to decide whether to place the cut at the lower or higher
-         // position without the benefit of an in-depth exploration of both options across all possible other cut points 
-         // (local exploration is still ok though).  We need to choose one side and live with that decision, so we 
-         // look at all our potential cuts, and we greedily pick out the cut that is 
-         // really nice on one side, but really bad on the other, and we keep greedily picking cuts this way until they 
-         // are all selected.  We use a priority queue to efficiently find the most important cut at any given time.
-         // Now we have an O(N * log(N)) algorithm in principal, but it's still a bit worse than that.
-         //
-         // After we decide whether to put the cut at the start or end of a run, we're actualizing the location of 
-         // the cut and we'll be changing the size of the runs to our left and right since they'll either have
-         // actualized or desired cut points, or the immutable ends as neighbours.  We'd prefer to spread out the
-         // movement between our desired and actual cut points into all our potential neighbours instead of to the 
-         // immediately bordering ranges.  Ideally, we'd like to spread out and re-calculate all other cut points 
-         // until we reach the immovable boundaries of an already decided cut, or the ends, after we've decided 
-         // on each cut. So, if we had 255 cuts, we'd choose one, then re-calculate the cut points of the remaining 
-         // 254, but that is clearly bad computationally, since then our algorithm would be O(N^2 * log(N)).  For low 
-         // numbers like 255 it might be fine, but our user could choose much larger numbers of cuts, and then 
-         // it would become intractable.
-         //
-         // Instead of re-calculating all remaining 255 cut points though, we instead choose a window 
-         // of influence.  So, if our influence window was set to 50 cut points, then even if we had to move one 
-         // cut point by a large amount of almost a complete cut range, we'd only impact the neighboring 50 ranges 
-         // by 2% (1/50).
-         //
-         // After we choose whether to go to the start or the end, we then choose an anchor point 50 to the 
-         // left and another one 50 to the right, unless we hit a materialized cut point, or the end, which we can't 
-         // move.  All the 50 items to the left and right either grow a bit smaller, or a bit bigger anchored to 
-         // the influence region ends.
-         //
-         // After calculating the new sizes of the ranges and the new desired cut points, we can then remove
-         // the 50-ish items on both sides from our priority queue, which in fact needs to be a tree so that we can
-         // remove items that aren't just the lowest value, and we can re-add them to the tree with their new
-         // recalculated priority score.
-         //
-         // But the scores of the desired cut points outside of our window have changed slightly too!  
-         // The 50th, 51st, 52nd, etc, items to the left and the right weren't moved, but they can still "see" cut 
-         // points that are within our influence window of desired cut points that we changed, so their priorty 
-         // scores need to change.  Once we get to twice the window size though, the items beyond that can't be 
-         // affected, so we only need to update items within a four time range of our window size, 
-         // two on the left and two on the right.
-         //
-         // If we have our window set to larger than the number of cuts, then we'll effectively be re-doing all
-         // the cuts, which might be ok for small N.  In that case all the cuts would always have the same width
-         // In our modified world, we get divergence over time, but since we're limiting our change to a small
-         // percentage, we shouldn't get too far out of whack.  Also, we'll quickly put down actualized cutting points such
-         // that afer a few we'll probably find ourselves close to a previous cut point and we'll proceed by
-         // updating all the priority scores exactly since we'll hit the already decided cuts before the 
-         // influence window length
-         //
-         // initially, we have pre-calculated which direction each cut should go, and we've calculated how many
-         // cut points should move between our right and left sides, and we also previously calculated a priority for
-         // making decisions. When we pull one potential cut point off the queue, we need to nuke all our decisions
-         // within the 50 item window on both sides (or until we hit an imovable boundary) and then we need to
-         // recalculate for each cut which way it should go and what it's priority is
-         //
-         // At this point we're re-doing our cuts within the 50 item cut window and we need to decide two things:
-         //   1) calculate the direction we'd go for each new cut point, and how many cuts we'd move from our right 
-         //      and left to the other side
-         //   2) Calculate the priority of making the decision
-         //
-         // If we do a full local exploration of where we're going to do our cuts for any single cut, then we can
-         // do a better job at calculating the priority, since we'll know how many cuts will be moved from right to left
-         //
-         // When doing a local exploration, examine going right left on each N segments to each side
-         //
-         // So, our process is:
-         //    1) Pull a high priority item from the queue (which has a pre-calculated direction to cut and all other
-         //       cutting decisions already calculated beforehand)
-         //    1) execute our pre-determined cut placement AND move cuts from one side to the other if called for in our pre-plan
-         //    2) re-calculate the aspirational cut points and for each of those do a first pass combination exploration
-         //       to choose the best materialied cut point based on just ourselves
-         //    3) Re-pass through our semi-materialized cuts points and jiggle them as necessary against their neighbours
-         //       since the "view of the world" is different for each cut point and they don't match perfectly even if
-         //       they are often close.
-         //    4) Pass from the center to the outer-outer boundary (twice the boundary distance), and remove cuts from
-         //       our priority queue, then calculate our new priority which is based on the squared change in all
-         //       aspirational cut point (either real or just assuming equal cutting after the cut)
-         //       And re-add them with our newly calculated priority, which can examine any cuts within
-         //       the N item window at any point (but won't change them)
-
-         // all fields of our pCutBest should have been filled with initialized data previously
-         CutPoint * const pCutBest = *pBestBinCuts->begin();
+   while(!pBestBinCuts->IsEmpty()) {
+      // We've located our desired cut points previously.  Sometimes those desired cut points
+      // are placed in the bulk of a long run of identical values and we have to decide if we'll be putting
+      // the cut at the start or the end of those long runs of identical values.
+      //
+      // Before this function in the call stack, we do some expensive exploration of the hardest cut point placement
+      // decisions that we need to make.  We do a full exploration of both the lower and higher placements of the long 
+      // runs, but that grows at O(2^N), so we need to limit this full exploration to just a few choices
+      //
+      // This function being lower in the stack needs to decide whether to place the cut at the lower or higher
+      // position without the benefit of an in-depth exploration of both options across all possible other cut points 
+      // (local exploration is still ok though).  We need to choose one side and live with that decision, so we 
+      // look at all our potential cuts, and we greedily pick out the cut that is 
+      // really nice on one side, but really bad on the other, and we keep greedily picking cuts this way until they 
+      // are all selected.  We use a priority queue to efficiently find the most important cut at any given time.
+      // Now we have an O(N * log(N)) algorithm in principal, but it's still a bit worse than that.
+      //
+      // After we decide whether to put the cut at the start or end of a run, we're actualizing the location of 
+      // the cut and we'll be changing the size of the runs to our left and right since they'll either have
+      // actualized or desired cut points, or the immutable ends as neighbours.  We'd prefer to spread out the
+      // movement between our desired and actual cut points into all our potential neighbours instead of to the 
+      // immediately bordering ranges.  Ideally, we'd like to spread out and re-calculate all other cut points 
+      // until we reach the immovable boundaries of an already decided cut, or the ends, after we've decided 
+      // on each cut. So, if we had 255 cuts, we'd choose one, then re-calculate the cut points of the remaining 
+      // 254, but that is clearly bad computationally, since then our algorithm would be O(N^2 * log(N)).  For low 
+      // numbers like 255 it might be fine, but our user could choose much larger numbers of cuts, and then 
+      // it would become intractable.
+      //
+      // Instead of re-calculating all remaining 255 cut points though, we instead choose a window 
+      // of influence.  So, if our influence window was set to 50 cut points, then even if we had to move one 
+      // cut point by a large amount of almost a complete cut range, we'd only impact the neighboring 50 ranges 
+      // by 2% (1/50).
+      //
+      // After we choose whether to go to the start or the end, we then choose an anchor point 50 to the 
+      // left and another one 50 to the right, unless we hit a materialized cut point, or the end, which we can't 
+      // move.  All the 50 items to the left and right either grow a bit smaller, or a bit bigger anchored to 
+      // the influence region ends.
+      //
+      // After calculating the new sizes of the ranges and the new desired cut points, we can then remove
+      // the 50-ish items on both sides from our priority queue, which in fact needs to track the position of each
+      // item so that we can remove items that aren't just the top value, and we can re-add them to the queue
+      // with their new recalculated priority score.
+      //
+      // But the scores of the desired cut points outside of our window have changed slightly too!  
+      // The 50th, 51st, 52nd, etc, items to the left and the right weren't moved, but they can still "see" cut 
+      // points that are within our influence window of desired cut points that we changed, so their priorty 
+      // scores need to change.  Once we get to twice the window size though, the items beyond that can't be 
+      // affected, so we only need to update items within a four time range of our window size, 
+      // two on the left and two on the right.
+      //
+      // If we have our window set to larger than the number of cuts, then we'll effectively be re-doing all
+      // the cuts, which might be ok for small N.  In that case all the cuts would always have the same width
+      // In our modified world, we get divergence over time, but since we're limiting our change to a small
+      // percentage, we shouldn't get too far out of whack.  Also, we'll quickly put down actualized cutting points such
+      // that afer a few we'll probably find ourselves close to a previous cut point and we'll proceed by
+      // updating all the priority scores exactly since we'll hit the already decided cuts before the 
+      // influence window length
+      //
+      // initially, we have pre-calculated which direction each cut should go, and we've calculated how many
+      // cut points should move between our right and left sides, and we also previously calculated a priority for
+      // making decisions. When we pull one potential cut point off the queue, we need to nuke all our decisions
+      // within the 50 item window on both sides (or until we hit an imovable boundary) and then we need to
+      // recalculate for each cut which way it should go and what it's priority is
+      //
+      // At this point we're re-doing our cuts within the 50 item cut window and we need to decide two things:
+      //   1) calculate the direction we'd go for each new cut point, and how many cuts we'd move from our right 
+      //      and left to the other side
+      //   2) Calculate the priority of making the decision
+      //
+      // If we do a full local exploration of where we're going to do our cuts for any single cut, then we can
+      // do a better job at calculating the priority, since we'll know how many cuts will be moved from right to left
+      //
+      // When doing a local exploration, examine going right left on each N segments to each side
+      //
+      // So, our process is:
+      //    1) Pull a high priority item from the queue (which has a pre-calculated direction to cut and all other
+      //       cutting decisions already calculated beforehand)
+      //    1) execute our pre-determined cut placement AND move cuts from one side to the other if called for in our pre-plan
+      //    2) re-calculate the aspirational cut points and for each of those do a first pass combination exploration
+      //       to choose the best materialied cut point based on just ourselves
+      //    3) Re-pass through our semi-materialized cuts points and jiggle them as necessary against their neighbours
+      //       since the "view of the world" is different for each cut point and they don't match perfectly even if
+      //       they are often close.
+      //    4) Pass from the center to the outer-outer boundary (twice the boundary distance), and remove cuts from
+      //       our priority queue, then calculate our new priority which is based on the squared change in all
+      //       aspirational cut point (either real or just assuming equal cutting after the cut)
+      //       And re-add them with our newly calculated priority, which can examine any cuts within
+      //       the N item window at any point (but won't change them)
+
+      // all fields of our pCutBest should have been filled with initialized data previously
+      CutPoint * const pCutBest = pBestBinCuts->GetTop();
 
 #ifdef LOG_SUPERVERBOSE_DISCRETIZATION_ORDERED
-         LOG_N(TraceLevelVerbose, "Dequeue CutPoint: %zu, %zu, %" FloatEbmTypePrintf ", %td, %" FloatEbmTypePrintf,
-            pCutBest->m_uniqueTiebreaker,
-            pCutBest->m_iVal,
-            pCutBest->m_iValAspirationalFloat,
-            pCutBest->m_cPredeterminedMovementOnCut,
-            pCutBest->m_priority
-         );
+      LOG_N(TraceLevelVerbose, "Dequeue CutPoint: %zu, %zu, %" FloatEbmTypePrintf ", %td, %" FloatEbmTypePrintf,
+         pCutBest->m_uniqueTiebreaker,
+         pCutBest->m_iVal,
+         pCutBest->m_iValAspirationalFloat,
+         pCutBest->m_cPredeterminedMovementOnCut,
+         pCutBest->m_priority
+      );
 #endif // LOG_SUPERVERBOSE_DISCRETIZATION_ORDERED
 
-         EBM_ASSERT(nullptr != pCutBest->m_pPrev);
-         EBM_ASSERT(nullptr != pCutBest->m_pNext);
-         EBM_ASSERT(!pCutBest->IsCut()); // this checks m_cPredeterminedMovementOnCut
-
-         // we can't move past our outer boundaries
-         EBM_ASSERT(-ptrdiff_t { k_cutExploreDistance } < pCutBest->m_cPredeterminedMovementOnCut &&
-            pCutBest->m_cPredeterminedMovementOnCut < ptrdiff_t { k_cutExploreDistance });
+      EBM_ASSERT(nullptr != pCutBest->m_pPrev);
+      EBM_ASSERT(nullptr != pCutBest->m_pNext);
+      EBM_ASSERT(!pCutBest->IsCut()); // this checks m_cPredeterminedMovementOnCut
 
-         EBM_ASSERT(!std::isnan(pCutBest->m_iValAspirationalFloat));
-         EBM_ASSERT(!std::isinf(pCutBest->m_iValAspirationalFloat));
-         EBM_ASSERT(FloatEbmType { 0 } < pCutBest->m_iValAspirationalFloat);
+      // we can't move past our outer boundaries
+      EBM_ASSERT(-ptrdiff_t { k_cutExploreDistance } < pCutBest->m_cPredeterminedMovementOnCut &&
+         pCutBest->m_cPredeterminedMovementOnCut < ptrdiff_t { k_cutExploreDistance });
 
-         EBM_ASSERT(!std::isnan(pCutBest->m_priority));
-         EBM_ASSERT(!std::isinf(pCutBest->m_priority));
+      EBM_ASSERT(!std::isnan(pCutBest->m_iValAspirationalFloat));
+      EBM_ASSERT(!std::isinf(pCutBest->m_iValAspirationalFloat));
+      EBM_ASSERT(FloatEbmType { 0 } < pCutBest->m_iValAspirationalFloat);
 
-         const size_t iVal = pCutBest->m_iVal; // preserve the location of our cut in case we end up moving
-         if(k_valNotLegal == iVal) {
-            // k_valNoCutsPossible means there are no legal cuts, and also that all the remaining items 
-            // in the queue are also uncuttable, so exit.
-            EBM_ASSERT(k_priorityNoCutsPossible == pCutBest->m_priority);
-            break;
-         }
-         EBM_ASSERT(FloatEbmType { 0 } <= pCutBest->m_priority);
+      EBM_ASSERT(!std::isnan(pCutBest->m_priority));
+      EBM_ASSERT(!std::isinf(pCutBest->m_priority));
 
-         // find our visibility window region
-         CutPoint * pCutLowModificationExclusiveBoundary = pCutBest;
-         size_t cRangesLowModification = k_cutExploreDistance;
-         ptrdiff_t cPredeterminedMovementOnCutLowLow;
-         do {
-            pCutLowModificationExclusiveBoundary = pCutLowModificationExclusiveBoundary->m_pPrev;
-            cPredeterminedMovementOnCutLowLow = pCutLowModificationExclusiveBoundary->m_cPredeterminedMovementOnCut;
-            --cRangesLowModification;
-         } while(LIKELY(LIKELY(k_movementDoneCut != cPredeterminedMovementOnCutLowLow) && 
-            LIKELY(size_t { 0 } != cRangesLowModification)));
-
-         cRangesLowModification = k_cutExploreDistance - cRangesLowModification;
-         EBM_ASSERT(1 <= cRangesLowModification);
-         EBM_ASSERT(cRangesLowModification <= k_cutExploreDistance);
-         EBM_ASSERT(-pCutBest->m_cPredeterminedMovementOnCut < static_cast<ptrdiff_t>(cRangesLowModification));
-
-         EBM_ASSERT(FloatEbmType { 0 } <= pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat);
-
-         // this should be exact, since we would have set it like this
-         EBM_ASSERT(!pCutLowModificationExclusiveBoundary->IsCut() || pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat == static_cast<FloatEbmType>(pCutLowModificationExclusiveBoundary->m_iVal));
-         EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iVal <= pCutBest->m_iVal);
-         EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat < pCutBest->m_iValAspirationalFloat);
-
-         CutPoint * pCutHighModificationExclusiveBoundary = pCutBest;
-         size_t cRangesHighModification = k_cutExploreDistance;
-         ptrdiff_t cPredeterminedMovementOnCutHighHigh;
-         do {
-            pCutHighModificationExclusiveBoundary = pCutHighModificationExclusiveBoundary->m_pNext;
-            cPredeterminedMovementOnCutHighHigh = pCutHighModificationExclusiveBoundary->m_cPredeterminedMovementOnCut;
-            --cRangesHighModification;
-         } while(LIKELY(LIKELY(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh) && 
-            LIKELY(size_t { 0 } != cRangesHighModification)));
+      const size_t iVal = pCutBest->m_iVal; // preserve the location of our cut in case we end up moving
+      if(k_valNotLegal == iVal) {
+         // k_valNoCutsPossible means there are no legal cuts, and also that all the remaining items 
+         // in the queue are also uncuttable, so exit.
+         EBM_ASSERT(k_priorityNoCutsPossible == pCutBest->m_priority);
+         break;
+      }
+      EBM_ASSERT(FloatEbmType { 0 } <= pCutBest->m_priority);
 
-         cRangesHighModification = k_cutExploreDistance - cRangesHighModification;
-         EBM_ASSERT(1 <= cRangesHighModification);
-         EBM_ASSERT(cRangesHighModification <= k_cutExploreDistance);
-         EBM_ASSERT(pCutBest->m_cPredeterminedMovementOnCut < static_cast<ptrdiff_t>(cRangesHighModification));
+      // find our visibility window region
+      CutPoint * pCutLowModificationExclusiveBoundary = pCutBest;
+      size_t cRangesLowModification = k_cutExploreDistance;
+      ptrdiff_t cPredeterminedMovementOnCutLowLow;
+      do {
+         pCutLowModificationExclusiveBoundary = pCutLowModificationExclusiveBoundary->m_pPrev;
+         cPredeterminedMovementOnCutLowLow = pCutLowModificationExclusiveBoundary->m_cPredeterminedMovementOnCut;
+         --cRangesLowModification;
+      } while(LIKELY(LIKELY(k_movementDoneCut != cPredeterminedMovementOnCutLowLow) && 
+         LIKELY(size_t { 0 } != cRangesLowModification)));
+
+      cRangesLowModification = k_cutExploreDistance - cRangesLowModification;
+      EBM_ASSERT(1 <= cRangesLowModification);
+      EBM_ASSERT(cRangesLowModification <= k_cutExploreDistance);
+      EBM_ASSERT(-pCutBest->m_cPredeterminedMovementOnCut < static_cast<ptrdiff_t>(cRangesLowModification));
+
+      EBM_ASSERT(FloatEbmType { 0 } <= pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat);
+
+      // this should be exact, since we would have set it like this
+      EBM_ASSERT(!pCutLowModificationExclusiveBoundary->IsCut() || pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat == static_cast<FloatEbmType>(pCutLowModificationExclusiveBoundary->m_iVal));
+      EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iVal <= pCutBest->m_iVal);
+      EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat < pCutBest->m_iValAspirationalFloat);
+
+      CutPoint * pCutHighModificationExclusiveBoundary = pCutBest;
+      size_t cRangesHighModification = k_cutExploreDistance;
+      ptrdiff_t cPredeterminedMovementOnCutHighHigh;
+      do {
+         pCutHighModificationExclusiveBoundary = pCutHighModificationExclusiveBoundary->m_pNext;
+         cPredeterminedMovementOnCutHighHigh = pCutHighModificationExclusiveBoundary->m_cPredeterminedMovementOnCut;
+         --cRangesHighModification;
+      } while(LIKELY(LIKELY(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh) && 
+         LIKELY(size_t { 0 } != cRangesHighModification)));
 
-         EBM_ASSERT(FloatEbmType { 0 } < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
+      cRangesHighModification = k_cutExploreDistance - cRangesHighModification;
+      EBM_ASSERT(1 <= cRangesHighModification);
+      EBM_ASSERT(cRangesHighModification <= k_cutExploreDistance);
+      EBM_ASSERT(pCutBest->m_cPredeterminedMovementOnCut < static_cast<ptrdiff_t>(cRangesHighModification));
 
-         // this should be exact, since we would have set it like this
-         EBM_ASSERT(!pCutHighModificationExclusiveBoundary->IsCut() || pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat == static_cast<FloatEbmType>(pCutHighModificationExclusiveBoundary->m_iVal));
-         EBM_ASSERT(pCutBest->m_iVal <= pCutHighModificationExclusiveBoundary->m_iVal);
-         EBM_ASSERT(pCutBest->m_iValAspirationalFloat < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
+      EBM_ASSERT(FloatEbmType { 0 } < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
 
-         // we're allowed to move cuts between our sides before cutting, so let's find our new home
-         ptrdiff_t cPredeterminedMovementOnCut = pCutBest->m_cPredeterminedMovementOnCut;
+      // this should be exact, since we would have set it like this
+      EBM_ASSERT(!pCutHighModificationExclusiveBoundary->IsCut() || pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat == static_cast<FloatEbmType>(pCutHighModificationExclusiveBoundary->m_iVal));
+      EBM_ASSERT(pCutBest->m_iVal <= pCutHighModificationExclusiveBoundary->m_iVal);
+      EBM_ASSERT(pCutBest->m_iValAspirationalFloat < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
 
-         CutPoint * pCutCur = pCutBest;
+      // we're allowed to move cuts between our sides before cutting, so let's find our new home
+      ptrdiff_t cPredeterminedMovementOnCut = pCutBest->m_cPredeterminedMovementOnCut;
 
-         CutPoint * pCutLowLowVisibilityInclusiveBoundary = pCutLowModificationExclusiveBoundary;
-         size_t cRangesLowLowPlan = cRangesLowModification;
+      CutPoint * pCutCur = pCutBest;
 
-         CutPoint * pCutHighHighVisibilityInclusiveBoundary = pCutHighModificationExclusiveBoundary;
-         size_t cRangesHighHighPlan = cRangesHighModification;
+      CutPoint * pCutLowLowVisibilityInclusiveBoundary = pCutLowModificationExclusiveBoundary;
+      size_t cRangesLowLowPlan = cRangesLowModification;
 
-         cRangesLowModification = 
-            static_cast<size_t>(static_cast<ptrdiff_t>(cRangesLowModification) + cPredeterminedMovementOnCut);
-         cRangesHighModification = 
-            static_cast<size_t>(static_cast<ptrdiff_t>(cRangesHighModification) - cPredeterminedMovementOnCut);
+      CutPoint * pCutHighHighVisibilityInclusiveBoundary = pCutHighModificationExclusiveBoundary;
+      size_t cRangesHighHighPlan = cRangesHighModification;
 
-         EBM_ASSERT(size_t { 1 } <= cRangesLowModification);
-         EBM_ASSERT(size_t { 1 } <= cRangesHighModification);
+      cRangesLowModification = 
+         static_cast<size_t>(static_cast<ptrdiff_t>(cRangesLowModification) + cPredeterminedMovementOnCut);
+      cRangesHighModification = 
+         static_cast<size_t>(static_cast<ptrdiff_t>(cRangesHighModification) - cPredeterminedMovementOnCut);
 
-         if(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut)) {
+      EBM_ASSERT(size_t { 1 } <= cRangesLowModification);
+      EBM_ASSERT(size_t { 1 } <= cRangesHighModification);
 
-            // If we push cuts either left or right, we don't change the window bounds within which we modify
-            // the aspirational cuts, because if we did, then there would be no bounds on where we can 
-            // 100% guarantee that no changes will affect outside regions
-            // we do however keep track of our visibility bounds since we'll use that when computing
-            // the plan and the priority of our cuts since those can observe other aspirational cuts
-            // outside of the bounds which we modify the aspirational cuts
+      if(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut)) {
 
-            if(UNPREDICTABLE(cPredeterminedMovementOnCut < ptrdiff_t { 0 })) {
-               do {
-                  pCutCur = pCutCur->m_pPrev;
-                  EBM_ASSERT(!pCutCur->IsCut());
-
-                  if(k_movementDoneCut != cPredeterminedMovementOnCutLowLow) {
-                     pCutLowLowVisibilityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary->m_pPrev;
-                     cPredeterminedMovementOnCutLowLow = pCutLowLowVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-                  } else {
-                     // we've hit a cut boundary which we can't move, so we get closer to it
-                     EBM_ASSERT(2 <= cRangesLowLowPlan);
-                     --cRangesLowLowPlan;
-                  }
-                  EBM_ASSERT((k_movementDoneCut == cPredeterminedMovementOnCutLowLow) == pCutLowLowVisibilityInclusiveBoundary->IsCut());
-
-                  if(k_cutExploreDistance == cRangesHighHighPlan) {
-                     pCutHighHighVisibilityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary->m_pPrev;
-                     EBM_ASSERT(!pCutHighHighVisibilityInclusiveBoundary->IsCut());
-                  } else {
-                     EBM_ASSERT(pCutHighHighVisibilityInclusiveBoundary->IsCut());
-                     ++cRangesHighHighPlan;
-                  }
+         // If we push cuts either left or right, we don't change the window bounds within which we modify
+         // the aspirational cuts, because if we did, then there would be no bounds on where we can 
+         // 100% guarantee that no changes will affect outside regions
+         // we do however keep track of our visibility bounds since we'll use that when computing
+         // the plan and the priority of our cuts since those can observe other aspirational cuts
+         // outside of the bounds which we modify the aspirational cuts
 
-                  ++cPredeterminedMovementOnCut;
-               } while(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut));
-               cPredeterminedMovementOnCutHighHigh = pCutHighHighVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-            } else {
-               do {
-                  pCutCur = pCutCur->m_pNext;
-                  EBM_ASSERT(!pCutCur->IsCut());
-
-                  if(k_cutExploreDistance == cRangesLowLowPlan) {
-                     pCutLowLowVisibilityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary->m_pNext;
-                     EBM_ASSERT(!pCutLowLowVisibilityInclusiveBoundary->IsCut());
-                  } else {
-                     EBM_ASSERT(pCutLowLowVisibilityInclusiveBoundary->IsCut());
-                     ++cRangesLowLowPlan;
-                  }
+         if(UNPREDICTABLE(cPredeterminedMovementOnCut < ptrdiff_t { 0 })) {
+            do {
+               pCutCur = pCutCur->m_pPrev;
+               EBM_ASSERT(!pCutCur->IsCut());
 
-                  if(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh) {
-                     pCutHighHighVisibilityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary->m_pNext;
-                     cPredeterminedMovementOnCutHighHigh = pCutHighHighVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-                  } else {
-                     // we've hit a cut boundary which we can't move, so we get closer to it
-                     EBM_ASSERT(2 <= cRangesHighHighPlan);
-                     --cRangesHighHighPlan;
-                  }
-                  EBM_ASSERT((k_movementDoneCut == cPredeterminedMovementOnCutHighHigh) == pCutHighHighVisibilityInclusiveBoundary->IsCut());
+               if(k_movementDoneCut != cPredeterminedMovementOnCutLowLow) {
+                  pCutLowLowVisibilityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary->m_pPrev;
+                  cPredeterminedMovementOnCutLowLow = pCutLowLowVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
+               } else {
+                  // we've hit a cut boundary which we can't move, so we get closer to it
+                  EBM_ASSERT(2 <= cRangesLowLowPlan);
+                  --cRangesLowLowPlan;
+               }
+               EBM_ASSERT((k_movementDoneCut == cPredeterminedMovementOnCutLowLow) == pCutLowLowVisibilityInclusiveBoundary->IsCut());
 
-                  --cPredeterminedMovementOnCut;
-               } while(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut));
-               cPredeterminedMovementOnCutLowLow = pCutLowLowVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-            }
-         }
+               if(k_cutExploreDistance == cRangesHighHighPlan) {
+                  pCutHighHighVisibilityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary->m_pPrev;
+                  EBM_ASSERT(!pCutHighHighVisibilityInclusiveBoundary->IsCut());
+               } else {
+                  EBM_ASSERT(pCutHighHighVisibilityInclusiveBoundary->IsCut());
+                  ++cRangesHighHighPlan;
+               }
 
-         EBM_ASSERT(size_t { 1 } <= cRangesLowLowPlan);
-         EBM_ASSERT(size_t { 1 } <= cRangesHighHighPlan);
-
-         EBM_ASSERT(!pCutCur->IsCut());
-
-         pCutCur->SetCut();
-
-         const FloatEbmType iValFloat = static_cast<FloatEbmType>(iVal);
-
-         pCutCur->m_iValAspirationalFloat = iValFloat;
-         pCutCur->m_iVal = iVal;
-
-         // TODO: We've just finished materializing the cut based on the plan we developed earlier.  We'll
-         // now go and re-do our aspirational cut plan for all the aspirational cuts within our visibility windows
-         // on each side.  Before we do that though, we can do a quick check to find out what the maximum number of 
-         // cuts we could place is between our new materialized cut and our visibility windows.  If it's not possible
-         // even in theory to place 20 cuts on our low side, then our aspirational plans shouldn't even consider that
-         // Also, if we delete/move aspirational cuts early, there's a higher chance that we'll be able to re-use them
-         // in a good place.  See the DetermineRangesMax(...) function on how to do this.
-         // There's actually two subtle issues here that we need to handle differently:
-         //  1) we need to determine if we should delete any cuts on our left or right.  To do this go from our
-         //     materialized cut and jump by cSamplesPerBinMin using aNeighbourJumps until we hit the aspirational
-         //     or materialized window.  If the window is aspirational we can either use the edge that's within the
-         //     aspirational window or the one right outside if we want more certainty, but in either case it's not a
-         //     100% guarantee since we might not even cut on the range that our aspirational cut falls on.  I lean towards
-         //     using our inner window and pruning early so that we get the cuts to useful place early.  The alternate
-         //     viewpoint is to only trim when we hit a materialized boundary before our visibility window.
-         //     since cuts could eventually be pushed into the open ended range potentially, but in general we should
-         //     think that if cuts can't be used within our range for a long distance we'd want to reallocate them
-         //     even if they could be pushed since it changes the density within our visibility window and
-         //     if we pushed them to a point outside then we'be be increasing the density there, so better to change
-         //     the densities in a more controlled way beforehand
-         //  2) We want to know how many potential cuts there are on each side of each aspirational cut that we're
-         //     we're considering.  Since we're processing like 20-50 of these, we can slide the value window
-         //     with cSamplesPerBinMin as we slide the visiblility windows to the left or right
-         //
-         // We only need to know if we have more than k_cutExploreDistance items, since we can't have more than
-         // that number of cuts until our border.  We can allocate a fixed size array on the stack with 
-         // k_cutExploreDistance size_t indexes and fill these from the lower and higher sides, and then if we
-         // cross any of those indexes we know if we've gone below a limit.
-
-
-         FloatEbmType stepPoint = pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat;
-         FloatEbmType stepLength;
-         if(pCutLowModificationExclusiveBoundary->IsCut()) {
-            EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iVal < iVal);
-            stepLength = static_cast<FloatEbmType>(iVal - pCutLowModificationExclusiveBoundary->m_iVal);
+               ++cPredeterminedMovementOnCut;
+            } while(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut));
+            cPredeterminedMovementOnCutHighHigh = pCutHighHighVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
          } else {
-            EBM_ASSERT(stepPoint < iValFloat);
-            stepLength = iValFloat - stepPoint;
-         }
-         stepLength /= static_cast<FloatEbmType>(cRangesLowModification);
-
-         CutPoint * pCutAspirational = pCutCur;
-         while(LIKELY(size_t { 0 } != --cRangesLowModification)) {
-            pCutAspirational = pCutAspirational->m_pPrev;
-            const FloatEbmType iValAspirationalFloat = stepPoint + 
-               stepLength * static_cast<FloatEbmType>(cRangesLowModification);
-            pCutAspirational->m_iValAspirationalFloat = iValAspirationalFloat;
-         }
+            do {
+               pCutCur = pCutCur->m_pNext;
+               EBM_ASSERT(!pCutCur->IsCut());
 
-         stepPoint = iValFloat;
-         if(pCutHighModificationExclusiveBoundary->IsCut()) {
-            EBM_ASSERT(iVal < pCutHighModificationExclusiveBoundary->m_iVal);
-            stepLength = static_cast<FloatEbmType>(pCutHighModificationExclusiveBoundary->m_iVal - iVal);
-         } else {
-            EBM_ASSERT(iValFloat < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
-            stepLength = pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat - stepPoint;
-         }
-         stepLength /= static_cast<FloatEbmType>(cRangesHighModification);
-
-         pCutAspirational = pCutHighModificationExclusiveBoundary;
-         while(size_t { 0 } != --cRangesHighModification) {
-            pCutAspirational = pCutAspirational->m_pPrev;
-            const FloatEbmType iValAspirationalFloat = stepPoint + 
-               stepLength * static_cast<FloatEbmType>(cRangesHighModification);
-            pCutAspirational->m_iValAspirationalFloat = iValAspirationalFloat;
+               if(k_cutExploreDistance == cRangesLowLowPlan) {
+                  pCutLowLowVisibilityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary->m_pNext;
+                  EBM_ASSERT(!pCutLowLowVisibilityInclusiveBoundary->IsCut());
+               } else {
+                  EBM_ASSERT(pCutLowLowVisibilityInclusiveBoundary->IsCut());
+                  ++cRangesLowLowPlan;
+               }
+
+               if(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh) {
+                  pCutHighHighVisibilityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary->m_pNext;
+                  cPredeterminedMovementOnCutHighHigh = pCutHighHighVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
+               } else {
+                  // we've hit a cut boundary which we can't move, so we get closer to it
+                  EBM_ASSERT(2 <= cRangesHighHighPlan);
+                  --cRangesHighHighPlan;
+               }
+               EBM_ASSERT((k_movementDoneCut == cPredeterminedMovementOnCutHighHigh) == pCutHighHighVisibilityInclusiveBoundary->IsCut());
+
+               --cPredeterminedMovementOnCut;
+            } while(UNLIKELY(ptrdiff_t { 0 } != cPredeterminedMovementOnCut));
+            cPredeterminedMovementOnCutLowLow = pCutLowLowVisibilityInclusiveBoundary->m_cPredeterminedMovementOnCut;
          }
+      }
 
-         CutPoint * pCutLowLowPlanInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary;
-         CutPoint * pCutLowHighPlanInclusiveBoundary = pCutCur;
-         size_t cRangesLowHighPlan = size_t { 0 };
+      EBM_ASSERT(size_t { 1 } <= cRangesLowLowPlan);
+      EBM_ASSERT(size_t { 1 } <= cRangesHighHighPlan);
 
-         size_t iValLowLowPlan = LIKELY(k_movementDoneCut == cPredeterminedMovementOnCutLowLow) ? 
-            pCutLowLowPlanInclusiveBoundary->m_iVal : k_valNotLegal;
-         size_t iValLowHighPlan = iVal;
+      EBM_ASSERT(!pCutCur->IsCut());
 
-         CutPoint * pCutLowPlanCur = pCutCur;
+      pCutCur->SetCut();
 
-         while(true) {
-            if(UNLIKELY(k_valNotLegal == iValLowLowPlan)) {
-               EBM_ASSERT(!pCutLowLowPlanInclusiveBoundary->IsCut());
-               pCutLowLowPlanInclusiveBoundary = pCutLowLowPlanInclusiveBoundary->m_pPrev;
-               if(UNLIKELY(pCutLowLowPlanInclusiveBoundary->IsCut())) {
-                  iValLowLowPlan = pCutLowLowPlanInclusiveBoundary->m_iVal;
-               }
-            } else {
-               EBM_ASSERT(pCutLowLowPlanInclusiveBoundary->IsCut());
-               --cRangesLowLowPlan;
-               if(UNLIKELY(0 == cRangesLowLowPlan)) {
-                  // we've reached the hard boundary of a materialized cut
-                  break;
-               }
+      const FloatEbmType iValFloat = static_cast<FloatEbmType>(iVal);
+
+      pCutCur->m_iValAspirationalFloat = iValFloat;
+      pCutCur->m_iVal = iVal;
+
+      // TODO: We've just finished materializing the cut based on the plan we developed earlier.  We'll
+      // now go and re-do our aspirational cut plan for all the aspirational cuts within our visibility windows
+      // on each side.  Before we do that though, we can do a quick check to find out what the maximum number of 
+      // cuts we could place is between our new materialized cut and our visibility windows.  If it's not possible
+      // even in theory to place 20 cuts on our low side, then our aspirational plans shouldn't even consider that
+      // Also, if we delete/move aspirational cuts early, there's a higher chance that we'll be able to re-use them
+      // in a good place.  See the DetermineRangesMax(...) function on how to do this.
+      // There's actually two subtle issues here that we need to handle differently:
+      //  1) we need to determine if we should delete any cuts on our left or right.  To do this go from our
+      //     materialized cut and jump by cSamplesPerBinMin using aNeighbourJumps until we hit the aspirational
+      //     or materialized window.  If the window is aspirational we can either use the edge that's within the
+      //     aspirational window or the one right outside if we want more certainty, but in either case it's not a
+      //     100% guarantee since we might not even cut on the range that our aspirational cut falls on.  I lean towards
+      //     using our inner window and pruning early so that we get the cuts to useful place early.  The alternate
+      //     viewpoint is to only trim when we hit a materialized boundary before our visibility window.
+      //     since cuts could eventually be pushed into the open ended range potentially, but in general we should
+      //     think that if cuts can't be used within our range for a long distance we'd want to reallocate them
+      //     even if they could be pushed since it changes the density within our visibility window and
+      //     if we pushed them to a point outside then we'be be increasing the density there, so better to change
+      //     the densities in a more controlled way beforehand
+      //  2) We want to know how many potential cuts there are on each side of each aspirational cut that we're
+      //     we're considering.  Since we're processing like 20-50 of these, we can slide the value window
+      //     with cSamplesPerBinMin as we slide the visiblility windows to the left or right
+      //
+      // We only need to know if we have more than k_cutExploreDistance items, since we can't have more than
+      // that number of cuts until our border.  We can allocate a fixed size array on the stack with 
+      // k_cutExploreDistance size_t indexes and fill these from the lower and higher sides, and then if we
+      // cross any of those indexes we know if we've gone below a limit.
+
+
+      FloatEbmType stepPoint = pCutLowModificationExclusiveBoundary->m_iValAspirationalFloat;
+      FloatEbmType stepLength;
+      if(pCutLowModificationExclusiveBoundary->IsCut()) {
+         EBM_ASSERT(pCutLowModificationExclusiveBoundary->m_iVal < iVal);
+         stepLength = static_cast<FloatEbmType>(iVal - pCutLowModificationExclusiveBoundary->m_iVal);
+      } else {
+         EBM_ASSERT(stepPoint < iValFloat);
+         stepLength = iValFloat - stepPoint;
+      }
+      stepLength /= static_cast<FloatEbmType>(cRangesLowModification);
+
+      CutPoint * pCutAspirational = pCutCur;
+      while(LIKELY(size_t { 0 } != --cRangesLowModification)) {
+         pCutAspirational = pCutAspirational->m_pPrev;
+         const FloatEbmType iValAspirationalFloat = stepPoint + 
+            stepLength * static_cast<FloatEbmType>(cRangesLowModification);
+         pCutAspirational->m_iValAspirationalFloat = iValAspirationalFloat;
+      }
+
+      stepPoint = iValFloat;
+      if(pCutHighModificationExclusiveBoundary->IsCut()) {
+         EBM_ASSERT(iVal < pCutHighModificationExclusiveBoundary->m_iVal);
+         stepLength = static_cast<FloatEbmType>(pCutHighModificationExclusiveBoundary->m_iVal - iVal);
+      } else {
+         EBM_ASSERT(iValFloat < pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat);
+         stepLength = pCutHighModificationExclusiveBoundary->m_iValAspirationalFloat - stepPoint;
+      }
+      stepLength /= static_cast<FloatEbmType>(cRangesHighModification);
+
+      pCutAspirational = pCutHighModificationExclusiveBoundary;
+      while(size_t { 0 } != --cRangesHighModification) {
+         pCutAspirational = pCutAspirational->m_pPrev;
+         const FloatEbmType iValAspirationalFloat = stepPoint + 
+            stepLength * static_cast<FloatEbmType>(cRangesHighModification);
+         pCutAspirational->m_iValAspirationalFloat = iValAspirationalFloat;
+      }
+
+      CutPoint * pCutLowLowPlanInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary;
+      CutPoint * pCutLowHighPlanInclusiveBoundary = pCutCur;
+      size_t cRangesLowHighPlan = size_t { 0 };
+
+      size_t iValLowLowPlan = LIKELY(k_movementDoneCut == cPredeterminedMovementOnCutLowLow) ? 
+         pCutLowLowPlanInclusiveBoundary->m_iVal : k_valNotLegal;
+      size_t iValLowHighPlan = iVal;
+
+      CutPoint * pCutLowPlanCur = pCutCur;
+
+      while(true) {
+         if(UNLIKELY(k_valNotLegal == iValLowLowPlan)) {
+            EBM_ASSERT(!pCutLowLowPlanInclusiveBoundary->IsCut());
+            pCutLowLowPlanInclusiveBoundary = pCutLowLowPlanInclusiveBoundary->m_pPrev;
+            if(UNLIKELY(pCutLowLowPlanInclusiveBoundary->IsCut())) {
+               iValLowLowPlan = pCutLowLowPlanInclusiveBoundary->m_iVal;
+            }
+         } else {
+            EBM_ASSERT(pCutLowLowPlanInclusiveBoundary->IsCut());
+            --cRangesLowLowPlan;
+            if(UNLIKELY(0 == cRangesLowLowPlan)) {
+               // we've reached the hard boundary of a materialized cut
+               break;
             }
+         }
 
-            if(UNLIKELY(k_cutExploreDistance == cRangesLowHighPlan)) {
-               pCutLowHighPlanInclusiveBoundary = pCutLowHighPlanInclusiveBoundary->m_pPrev;
-               EBM_ASSERT(!pCutLowHighPlanInclusiveBoundary->IsCut());
-               iValLowHighPlan = k_valNotLegal;
-               if(UNLIKELY(pCutLowHighPlanInclusiveBoundary == pCutLowModificationExclusiveBoundary)) {
-                  // we've reached the boundary of where we changed the aspirational cuts, so no changes should
-                  // occur beyond this point
-                  break;
-               }
-            } else {
-               EBM_ASSERT(pCutLowHighPlanInclusiveBoundary->IsCut());
-               EBM_ASSERT(k_valNotLegal != iValLowHighPlan);
-               ++cRangesLowHighPlan;
+         if(UNLIKELY(k_cutExploreDistance == cRangesLowHighPlan)) {
+            pCutLowHighPlanInclusiveBoundary = pCutLowHighPlanInclusiveBoundary->m_pPrev;
+            EBM_ASSERT(!pCutLowHighPlanInclusiveBoundary->IsCut());
+            iValLowHighPlan = k_valNotLegal;
+            if(UNLIKELY(pCutLowHighPlanInclusiveBoundary == pCutLowModificationExclusiveBoundary)) {
+               // we've reached the boundary of where we changed the aspirational cuts, so no changes should
+               // occur beyond this point
+               break;
             }
+         } else {
+            EBM_ASSERT(pCutLowHighPlanInclusiveBoundary->IsCut());
+            EBM_ASSERT(k_valNotLegal != iValLowHighPlan);
+            ++cRangesLowHighPlan;
+         }
 
-            pCutLowPlanCur = pCutLowPlanCur->m_pPrev;
-            EBM_ASSERT(!pCutLowPlanCur->IsCut()); // we should have exited on 0 == cRangesLowLowPlan beforehand
+         pCutLowPlanCur = pCutLowPlanCur->m_pPrev;
+         EBM_ASSERT(!pCutLowPlanCur->IsCut()); // we should have exited on 0 == cRangesLowLowPlan beforehand
 
-            BuildNeighbourhoodPlan(
-               cSamples,
-               bSymmetryReversal,
+         BuildNeighbourhoodPlan(
+            cSamples,
+            bSymmetryReversal,
 
-               cSamplesPerBinMin,
-               iValuesStart,
-               cCuttableItems,
-               aNeighbourJumps,
+            cSamplesPerBinMin,
+            iValuesStart,
+            cCuttableItems,
+            aNeighbourJumps,
 
-               cRangesLowLowPlan,
-               iValLowLowPlan,
-               pCutLowLowPlanInclusiveBoundary->m_iValAspirationalFloat,
+            cRangesLowLowPlan,
+            iValLowLowPlan,
+            pCutLowLowPlanInclusiveBoundary->m_iValAspirationalFloat,
 
-               cRangesLowHighPlan,
-               iValLowHighPlan,
-               pCutLowHighPlanInclusiveBoundary->m_iValAspirationalFloat,
+            cRangesLowHighPlan,
+            iValLowHighPlan,
+            pCutLowHighPlanInclusiveBoundary->m_iValAspirationalFloat,
 
-               pCutLowPlanCur
-            );
-         }
+            pCutLowPlanCur
+         );
+      }
 
-         CutPoint * pCutHighHighPlanInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary;
-         CutPoint * pCutHighLowPlanInclusiveBoundary = pCutCur;
-         size_t cRangesHighLowPlan = size_t { 0 };
+      CutPoint * pCutHighHighPlanInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary;
+      CutPoint * pCutHighLowPlanInclusiveBoundary = pCutCur;
+      size_t cRangesHighLowPlan = size_t { 0 };
 
-         size_t iValHighHighPlan = LIKELY(k_movementDoneCut == cPredeterminedMovementOnCutHighHigh) ? 
-            pCutHighHighPlanInclusiveBoundary->m_iVal : k_valNotLegal;
-         size_t iValHighLowPlan = iVal;
+      size_t iValHighHighPlan = LIKELY(k_movementDoneCut == cPredeterminedMovementOnCutHighHigh) ? 
+         pCutHighHighPlanInclusiveBoundary->m_iVal : k_valNotLegal;
+      size_t iValHighLowPlan = iVal;
 
-         CutPoint * pCutHighPlanCur = pCutCur;
+      CutPoint * pCutHighPlanCur = pCutCur;
 
-         while(true) {
-            if(UNLIKELY(k_valNotLegal == iValHighHighPlan)) {
-               EBM_ASSERT(!pCutHighHighPlanInclusiveBoundary->IsCut());
-               pCutHighHighPlanInclusiveBoundary = pCutHighHighPlanInclusiveBoundary->m_pNext;
-               if(UNLIKELY(pCutHighHighPlanInclusiveBoundary->IsCut())) {
-                  iValHighHighPlan = pCutHighHighPlanInclusiveBoundary->m_iVal;
-               }
-            } else {
-               EBM_ASSERT(pCutHighHighPlanInclusiveBoundary->IsCut());
-               --cRangesHighHighPlan;
-               if(UNLIKELY(0 == cRangesHighHighPlan)) {
-                  // we've reached the hard boundary of a materialized cut
-                  break;
-               }
+      while(true) {
+         if(UNLIKELY(k_valNotLegal == iValHighHighPlan)) {
+            EBM_ASSERT(!pCutHighHighPlanInclusiveBoundary->IsCut());
+            pCutHighHighPlanInclusiveBoundary = pCutHighHighPlanInclusiveBoundary->m_pNext;
+            if(UNLIKELY(pCutHighHighPlanInclusiveBoundary->IsCut())) {
+               iValHighHighPlan = pCutHighHighPlanInclusiveBoundary->m_iVal;
             }
+         } else {
+            EBM_ASSERT(pCutHighHighPlanInclusiveBoundary->IsCut());
+            --cRangesHighHighPlan;
+            if(UNLIKELY(0 == cRangesHighHighPlan)) {
+               // we've reached the hard boundary of a materialized cut
+               break;
+            }
+         }
 
-            if(UNLIKELY(k_cutExploreDistance == cRangesHighLowPlan)) {
-               pCutHighLowPlanInclusiveBoundary = pCutHighLowPlanInclusiveBoundary->m_pNext;
-               EBM_ASSERT(!pCutHighLowPlanInclusiveBoundary->IsCut());
-               iValHighLowPlan = k_valNotLegal;
-               if(UNLIKELY(pCutHighLowPlanInclusiveBoundary == pCutHighModificationExclusiveBoundary)) {
-                  // we've reached the boundary of where we changed the aspirational cuts, so no changes should
-                  // occur beyond this point
-                  break;
-               }
-            } else {
-               EBM_ASSERT(pCutHighLowPlanInclusiveBoundary->IsCut());
-               EBM_ASSERT(k_valNotLegal != iValHighLowPlan);
-               ++cRangesHighLowPlan;
+         if(UNLIKELY(k_cutExploreDistance == cRangesHighLowPlan)) {
+            pCutHighLowPlanInclusiveBoundary = pCutHighLowPlanInclusiveBoundary->m_pNext;
+            EBM_ASSERT(!pCutHighLowPlanInclusiveBoundary->IsCut());
+            iValHighLowPlan = k_valNotLegal;
+            if(UNLIKELY(pCutHighLowPlanInclusiveBoundary == pCutHighModificationExclusiveBoundary)) {
+               // we've reached the boundary of where we changed the aspirational cuts, so no changes should
+               // occur beyond this point
+               break;
             }
+         } else {
+            EBM_ASSERT(pCutHighLowPlanInclusiveBoundary->IsCut());
+            EBM_ASSERT(k_valNotLegal != iValHighLowPlan);
+            ++cRangesHighLowPlan;
+         }
 
-            pCutHighPlanCur = pCutHighPlanCur->m_pNext;
-            EBM_ASSERT(!pCutHighPlanCur->IsCut()); // we should have exited on 0 == cRangesHighHighPlan beforehand
+         pCutHighPlanCur = pCutHighPlanCur->m_pNext;
+         EBM_ASSERT(!pCutHighPlanCur->IsCut()); // we should have exited on 0 == cRangesHighHighPlan beforehand
 
-            BuildNeighbourhoodPlan(
-               cSamples,
-               bSymmetryReversal,
+         BuildNeighbourhoodPlan(
+            cSamples,
+            bSymmetryReversal,
 
-               cSamplesPerBinMin,
-               iValuesStart,
-               cCuttableItems,
-               aNeighbourJumps,
+            cSamplesPerBinMin,
+            iValuesStart,
+            cCuttableItems,
+            aNeighbourJumps,
 
-               cRangesHighLowPlan,
-               iValHighLowPlan,
-               pCutHighLowPlanInclusiveBoundary->m_iValAspirationalFloat,
+            cRangesHighLowPlan,
+            iValHighLowPlan,
+            pCutHighLowPlanInclusiveBoundary->m_iValAspirationalFloat,
 
-               cRangesHighHighPlan,
-               iValHighHighPlan,
-               pCutHighHighPlanInclusiveBoundary->m_iValAspirationalFloat,
+            cRangesHighHighPlan,
+            iValHighHighPlan,
+            pCutHighHighPlanInclusiveBoundary->m_iValAspirationalFloat,
 
-               pCutHighPlanCur
-            );
-         }
+            pCutHighPlanCur
+         );
+      }
 
-         // TODO: For each cut point we've examined our neighbourhood and selected a right/left decison that we can live with
-         // for that cut point independent of all the other ones.  We can then maybe do an analysis to see if our
-         // ideas for the neighbours match up with theirs and do some jiggering if the outcome within a window is bad
-         // this allows us to see a bigger area, so we have to be careful that changes don't cascade beyond our visibility
-         // window.  Perhaps we allow changes to ASPIRATIONAL cuts within our hard change boundary, but don't
-         // change things outside of this window.
-
-         EBM_ASSERT(pBestBinCuts->end() != pBestBinCuts->find(pCutCur));
-         pBestBinCuts->erase(pCutCur);
-
-         // Ok, so now we've computed our aspirational cut points, and decided where we'd go for each cut point if we
-         // were forced to select a cut point now.  We now need to calculate the PRIORITY for all our cut points
-         // 
-         // Initially we have a lot of options when deciding cuts.  As time goes on, we get less options.  We want our
-         // first cut to minimize the danger that later cuts will force us into a bad position.  
-
-         // When calculating the pririty of a cut point a couple of things come to mind:
-         //   - if we have a large open space of many un-materialized cuts, an aspiration cut in the middle that falls 
-         //     into a big range is not a threat yet since we can deftly avoid it by changing by small amounts the
-         //     aspirational cuts on both ends, BUT if someone puts down a ham-fisted cut right down next to it then
-         //     we'll have a problem
-         //   - even if the cuts in the center are good, a cut in the center next to a large range of equal values could
-         //     create a problem for us easily (so we should include metrics on the goodness of cuts)
-         //   - our cut materializer needs to be smart and examine the local space before it finalizes a cut, so that
-         //     we avoid the largest risks around putting down ham-fisted cuts.  So, with this combination we can relax
-         //     and not worry about the asipirational cuts in the middle of a large un-materialized section, whether
-         //     they fall onto a currently bad cut or not
-         //   - the asipirational cuts near the boundaries of materialized cuts are the most problematic, especially
-         //     if they currently happen to be hard decision cuts.  We probably want to make the hard decisions early
-         //     when we have the most flexibility to address them
-         //   - so, our algorithm will tend to first materialize the cuts near existing boundaries and move inwards as
-         //     spaces that were previously not problems become more constrained
-         //   - we might or might not want to include results from our decisions about where we'll put cuts.  For
-         //     instance, let's say a potential cut point has one good option and one terrible option.  We may want
-         //     to materialize the good option so that a neighbour cut doesn't force us to take the terrible option
-         //     But this issue is reduced if before we materialize cuts we do an exploration of of the local space to
-         //     avoid hurting neighbours.
-         //   - in general, because cuts tend to disrupt many other aspirational cuts, we should probably weigh the exact
-         //     cut plan less and concentrate of making the most disruptive cuts first.  We might find that our carefully
-         //     crafted plan for future cuts is irrelevant and we no longer even make cuts on ranges that we thought
-         //     were important previously.
-         //   - by choosing the most disruptive cuts first, we'll probably get to a point quickly were most of our
-         //     remaining potential cuts are non-conrovertial.  All the hard decisions will be made early and we'll be
-         //     left with the cuts that jiggle the remaining cuts less.
-         //
-         //
-         //
-         // TODO: CONSIDER (very tentatively) incorporating how bad it would be if we were forced to choose the worse side to cut on
-         // if that's a bad scenario, we should probably try increasing our priority for our aspirational cut point
-         // since we want that one to be materialized first. 
-         // There are a lot of metrics we might use.  Three ideas:
-         //   1) Look at how bad the best solution for any particular cut is.. if it's bad it's probably because the
-         //      alternatives were worse
-         //   2) Look at how bad the worst solution for any particular cut is.. we don't want to be forced to take the
-         //      worst
-         //   3) * take the aspirational cut, take the best matrialized cut, calculate what percentage we need to
-         //      stretch from either boundary (the low boundary and the high boundary).  Take the one that has the highest
-         //      percentage stretch
-         //
-         // I like #3 (it's the one we have implemented now), because after we choose each cut everything 
-         // within the visibility windows gets re-shuffed.  We might not even fall on some of the problematic 
-         // ranges anymore.  Choosing the cuts with the highest "tension" causes
-         // us to decide the longest ranges that are the closest to one of our existing imovable boundaries thus
-         // we're nailing down the ones that'll cause the most movement first while we have the most room, and it also
-         // captures the idea that these are bad ones that need to be selected.  It'll tend to try deciding cuts
-         // near our existing edge boundaries first instead of the ones in the center.  This is good since the ones at
-         // the boundaries are more critical.  As we materialize cuts we'll get closer to the center and those will start
-         // to want attention
-
-         CutPoint * pCutLowLowPriorityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary;
-         CutPoint * pCutLowHighPriorityInclusiveBoundary = pCutCur;
-         size_t cRangesLowHighPriority = 0;
-         CutPoint * pCutLowPriorityCur = pCutCur;
-
-         while(true) {
-            pCutLowPriorityCur = pCutLowPriorityCur->m_pPrev;
-            if(PREDICTABLE(k_movementDoneCut != cPredeterminedMovementOnCutLowLow)) {
-               EBM_ASSERT(!pCutLowLowPriorityInclusiveBoundary->IsCut());
-               pCutLowLowPriorityInclusiveBoundary = pCutLowLowPriorityInclusiveBoundary->m_pPrev;
-               cPredeterminedMovementOnCutLowLow = pCutLowLowPriorityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-            } else {
-               EBM_ASSERT(pCutLowLowPriorityInclusiveBoundary->IsCut());
-               if(UNLIKELY(pCutLowPriorityCur == pCutLowLowPriorityInclusiveBoundary)) {
-                  EBM_ASSERT(pCutLowPriorityCur->IsCut());
-                  break;
-               }
+      // TODO: For each cut point we've examined our neighbourhood and selected a right/left decison that we can live with
+      // for that cut point independent of all the other ones.  We can then maybe do an analysis to see if our
+      // ideas for the neighbours match up with theirs and do some jiggering if the outcome within a window is bad
+      // this allows us to see a bigger area, so we have to be careful that changes don't cascade beyond our visibility
+      // window.  Perhaps we allow changes to ASPIRATIONAL cuts within our hard change boundary, but don't
+      // change things outside of this window.
+
+      EBM_ASSERT(pBestBinCuts->IsContained(pCutCur));
+      pBestBinCuts->Erase(pCutCur);
+
+      // Ok, so now we've computed our aspirational cut points, and decided where we'd go for each cut point if we
+      // were forced to select a cut point now.  We now need to calculate the PRIORITY for all our cut points
+      // 
+      // Initially we have a lot of options when deciding cuts.  As time goes on, we get less options.  We want our
+      // first cut to minimize the danger that later cuts will force us into a bad position.  
+
+      // When calculating the pririty of a cut point a couple of things come to mind:
+      //   - if we have a large open space of many un-materialized cuts, an aspiration cut in the middle that falls 
+      //     into a big range is not a threat yet since we can deftly avoid it by changing by small amounts the
+      //     aspirational cuts on both ends, BUT if someone puts down a ham-fisted cut right down next to it then
+      //     we'll have a problem
+      //   - even if the cuts in the center are good, a cut in the center next to a large range of equal values could
+      //     create a problem for us easily (so we should include metrics on the goodness of cuts)
+      //   - our cut materializer needs to be smart and examine the local space before it finalizes a cut, so that
+      //     we avoid the largest risks around putting down ham-fisted cuts.  So, with this combination we can relax
+      //     and not worry about the asipirational cuts in the middle of a large un-materialized section, whether
+      //     they fall onto a currently bad cut or not
+      //   - the asipirational cuts near the boundaries of materialized cuts are the most problematic, especially
+      //     if they currently happen to be hard decision cuts.  We probably want to make the hard decisions early
+      //     when we have the most flexibility to address them
+      //   - so, our algorithm will tend to first materialize the cuts near existing boundaries and move inwards as
+      //     spaces that were previously not problems become more constrained
+      //   - we might or might not want to include results from our decisions about where we'll put cuts.  For
+      //     instance, let's say a potential cut point has one good option and one terrible option.  We may want
+      //     to materialize the good option so that a neighbour cut doesn't force us to take the terrible option
+      //     But this issue is reduced if before we materialize cuts we do an exploration of of the local space to
+      //     avoid hurting neighbours.
+      //   - in general, because cuts tend to disrupt many other aspirational cuts, we should probably weigh the exact
+      //     cut plan less and concentrate of making the most disruptive cuts first.  We might find that our carefully
+      //     crafted plan for future cuts is irrelevant and we no longer even make cuts on ranges that we thought
+      //     were important previously.
+      //   - by choosing the most disruptive cuts first, we'll probably get to a point quickly were most of our
+      //     remaining potential cuts are non-conrovertial.  All the hard decisions will be made early and we'll be
+      //     left with the cuts that jiggle the remaining cuts less.
+      //
+      //
+      //
+      // TODO: CONSIDER (very tentatively) incorporating how bad it would be if we were forced to choose the worse side to cut on
+      // if that's a bad scenario, we should probably try increasing our priority for our aspirational cut point
+      // since we want that one to be materialized first. 
+      // There are a lot of metrics we might use.  Three ideas:
+      //   1) Look at how bad the best solution for any particular cut is.. if it's bad it's probably because the
+      //      alternatives were worse
+      //   2) Look at how bad the worst solution for any particular cut is.. we don't want to be forced to take the
+      //      worst
+      //   3) * take the aspirational cut, take the best matrialized cut, calculate what percentage we need to
+      //      stretch from either boundary (the low boundary and the high boundary).  Take the one that has the highest
+      //      percentage stretch
+      //
+      // I like #3 (it's the one we have implemented now), because after we choose each cut everything 
+      // within the visibility windows gets re-shuffed.  We might not even fall on some of the problematic 
+      // ranges anymore.  Choosing the cuts with the highest "tension" causes
+      // us to decide the longest ranges that are the closest to one of our existing imovable boundaries thus
+      // we're nailing down the ones that'll cause the most movement first while we have the most room, and it also
+      // captures the idea that these are bad ones that need to be selected.  It'll tend to try deciding cuts
+      // near our existing edge boundaries first instead of the ones in the center.  This is good since the ones at
+      // the boundaries are more critical.  As we materialize cuts we'll get closer to the center and those will start
+      // to want attention
+
+      CutPoint * pCutLowLowPriorityInclusiveBoundary = pCutLowLowVisibilityInclusiveBoundary;
+      CutPoint * pCutLowHighPriorityInclusiveBoundary = pCutCur;
+      size_t cRangesLowHighPriority = 0;
+      CutPoint * pCutLowPriorityCur = pCutCur;
+
+      while(true) {
+         pCutLowPriorityCur = pCutLowPriorityCur->m_pPrev;
+         if(PREDICTABLE(k_movementDoneCut != cPredeterminedMovementOnCutLowLow)) {
+            EBM_ASSERT(!pCutLowLowPriorityInclusiveBoundary->IsCut());
+            pCutLowLowPriorityInclusiveBoundary = pCutLowLowPriorityInclusiveBoundary->m_pPrev;
+            cPredeterminedMovementOnCutLowLow = pCutLowLowPriorityInclusiveBoundary->m_cPredeterminedMovementOnCut;
+         } else {
+            EBM_ASSERT(pCutLowLowPriorityInclusiveBoundary->IsCut());
+            if(UNLIKELY(pCutLowPriorityCur == pCutLowLowPriorityInclusiveBoundary)) {
+               EBM_ASSERT(pCutLowPriorityCur->IsCut());
+               break;
             }
-            EBM_ASSERT(!pCutLowPriorityCur->IsCut());
+         }
+         EBM_ASSERT(!pCutLowPriorityCur->IsCut());
 
-            if(PREDICTABLE(k_cutExploreDistance == cRangesLowHighPriority)) {
-               pCutLowHighPriorityInclusiveBoundary = pCutLowHighPriorityInclusiveBoundary->m_pPrev;
-               EBM_ASSERT(!pCutLowHighPriorityInclusiveBoundary->IsCut());
-               if(UNLIKELY(pCutLowHighPriorityInclusiveBoundary == pCutLowModificationExclusiveBoundary)) {
+         if(PREDICTABLE(k_cutExploreDistance == cRangesLowHighPriority)) {
+            pCutLowHighPriorityInclusiveBoundary = pCutLowHighPriorityInclusiveBoundary->m_pPrev;
+            EBM_ASSERT(!pCutLowHighPriorityInclusiveBoundary->IsCut());
+            if(UNLIKELY(pCutLowHighPriorityInclusiveBoundary == pCutLowModificationExclusiveBoundary)) {
 
 #ifndef NDEBUG
 
-                  FloatEbmType debugPriority = CalculatePriority(
-                     pCutLowLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
-                     pCutLowHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
-                     pCutLowPriorityCur
-                  );
+               FloatEbmType debugPriority = CalculatePriority(
+                  pCutLowLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
+                  pCutLowHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
+                  pCutLowPriorityCur
+               );
 
-                  // these should be calculated via the same pathway, so should be identical
-                  EBM_ASSERT(debugPriority == pCutLowPriorityCur->m_priority);
+               // these should be calculated via the same pathway, so should be identical
+               EBM_ASSERT(debugPriority == pCutLowPriorityCur->m_priority);
 
 #endif // NDEBUG
 
-                  break;
-               }
-            } else {
-               EBM_ASSERT(pCutLowHighPriorityInclusiveBoundary->IsCut());
-               ++cRangesLowHighPriority;
+               break;
             }
+         } else {
+            EBM_ASSERT(pCutLowHighPriorityInclusiveBoundary->IsCut());
+            ++cRangesLowHighPriority;
+         }
 
-            EBM_ASSERT(pBestBinCuts->end() != pBestBinCuts->find(pCutLowPriorityCur));
-            pBestBinCuts->erase(pCutLowPriorityCur);
+         EBM_ASSERT(pBestBinCuts->IsContained(pCutLowPriorityCur));
+         pBestBinCuts->Erase(pCutLowPriorityCur);
 
-            pCutLowPriorityCur->m_priority = CalculatePriority(
-               pCutLowLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
-               pCutLowHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
-               pCutLowPriorityCur
-            );
+         pCutLowPriorityCur->m_priority = CalculatePriority(
+            pCutLowLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
+            pCutLowHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
+            pCutLowPriorityCur
+         );
 
-            pBestBinCuts->insert(pCutLowPriorityCur);
-         }
+         pBestBinCuts->Insert(pCutLowPriorityCur);
+      }
 
-         CutPoint * pCutHighHighPriorityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary;
-         CutPoint * pCutHighLowPriorityInclusiveBoundary = pCutCur;
-         size_t cRangesHighLowPriority = 0;
-         CutPoint * pCutHighPriorityCur = pCutCur;
-
-         while(true) {
-            pCutHighPriorityCur = pCutHighPriorityCur->m_pNext;
-            if(PREDICTABLE(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh)) {
-               EBM_ASSERT(!pCutHighHighPriorityInclusiveBoundary->IsCut());
-               pCutHighHighPriorityInclusiveBoundary = pCutHighHighPriorityInclusiveBoundary->m_pNext;
-               cPredeterminedMovementOnCutHighHigh = pCutHighHighPriorityInclusiveBoundary->m_cPredeterminedMovementOnCut;
-            } else {
-               EBM_ASSERT(pCutHighHighPriorityInclusiveBoundary->IsCut());
-               if(UNLIKELY(pCutHighPriorityCur == pCutHighHighPriorityInclusiveBoundary)) {
-                  EBM_ASSERT(pCutHighPriorityCur->IsCut());
-                  break;
-               }
+      CutPoint * pCutHighHighPriorityInclusiveBoundary = pCutHighHighVisibilityInclusiveBoundary;
+      CutPoint * pCutHighLowPriorityInclusiveBoundary = pCutCur;
+      size_t cRangesHighLowPriority = 0;
+      CutPoint * pCutHighPriorityCur = pCutCur;
+
+      while(true) {
+         pCutHighPriorityCur = pCutHighPriorityCur->m_pNext;
+         if(PREDICTABLE(k_movementDoneCut != cPredeterminedMovementOnCutHighHigh)) {
+            EBM_ASSERT(!pCutHighHighPriorityInclusiveBoundary->IsCut());
+            pCutHighHighPriorityInclusiveBoundary = pCutHighHighPriorityInclusiveBoundary->m_pNext;
+            cPredeterminedMovementOnCutHighHigh = pCutHighHighPriorityInclusiveBoundary->m_cPredeterminedMovementOnCut;
+         } else {
+            EBM_ASSERT(pCutHighHighPriorityInclusiveBoundary->IsCut());
+            if(UNLIKELY(pCutHighPriorityCur == pCutHighHighPriorityInclusiveBoundary)) {
+               EBM_ASSERT(pCutHighPriorityCur->IsCut());
+               break;
             }
-            EBM_ASSERT(!pCutHighPriorityCur->IsCut());
+         }
+         EBM_ASSERT(!pCutHighPriorityCur->IsCut());
 
-            if(PREDICTABLE(k_cutExploreDistance == cRangesHighLowPriority)) {
-               pCutHighLowPriorityInclusiveBoundary = pCutHighLowPriorityInclusiveBoundary->m_pNext;
-               EBM_ASSERT(!pCutHighLowPriorityInclusiveBoundary->IsCut());
-               if(UNLIKELY(pCutHighLowPriorityInclusiveBoundary == pCutHighModificationExclusiveBoundary)) {
+         if(PREDICTABLE(k_cutExploreDistance == cRangesHighLowPriority)) {
+            pCutHighLowPriorityInclusiveBoundary = pCutHighLowPriorityInclusiveBoundary->m_pNext;
+            EBM_ASSERT(!pCutHighLowPriorityInclusiveBoundary->IsCut());
+            if(UNLIKELY(pCutHighLowPriorityInclusiveBoundary == pCutHighModificationExclusiveBoundary)) {
 
 #ifndef NDEBUG
 
-                  FloatEbmType debugPriority = CalculatePriority(
-                     pCutHighLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
-                     pCutHighHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
-                     pCutHighPriorityCur
-                  );
+               FloatEbmType debugPriority = CalculatePriority(
+                  pCutHighLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
+                  pCutHighHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
+                  pCutHighPriorityCur
+               );
 
-                  // these should be calculated via the same pathway, so should be identical
-                  EBM_ASSERT(debugPriority == pCutHighPriorityCur->m_priority);
+               // these should be calculated via the same pathway, so should be identical
+               EBM_ASSERT(debugPriority == pCutHighPriorityCur->m_priority);
 
 #endif // NDEBUG
 
-                  break;
-               }
-            } else {
-               EBM_ASSERT(pCutHighLowPriorityInclusiveBoundary->IsCut());
-               ++cRangesHighLowPriority;
+               break;
             }
+         } else {
+            EBM_ASSERT(pCutHighLowPriorityInclusiveBoundary->IsCut());
+            ++cRangesHighLowPriority;
+         }
 
-            EBM_ASSERT(pBestBinCuts->end() != pBestBinCuts->find(pCutHighPriorityCur));
-            pBestBinCuts->erase(pCutHighPriorityCur);
+         EBM_ASSERT(pBestBinCuts->IsContained(pCutHighPriorityCur));
+         pBestBinCuts->Erase(pCutHighPriorityCur);
 
-            pCutHighPriorityCur->m_priority = CalculatePriority(
-               pCutHighLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
-               pCutHighHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
-               pCutHighPriorityCur
-            );
+         pCutHighPriorityCur->m_priority = CalculatePriority(
+            pCutHighLowPriorityInclusiveBoundary->m_iValAspirationalFloat,
+            pCutHighHighPriorityInclusiveBoundary->m_iValAspirationalFloat,
+            pCutHighPriorityCur
+         );
 
-            pBestBinCuts->insert(pCutHighPriorityCur);
-         }
+         pBestBinCuts->Insert(pCutHighPriorityCur);
       }
-   } catch(...) {
-      LOG_0(TraceLevelWarning, "WARNING CutSegment exception");
-      return true;
    }
 
    IronCuts();
@@ -1491,7 +1610,7 @@ static bool CutCuttingRange(
 }
 
 static bool TreeSearchCutSegment(
-   std::set<CutPoint *, CompareCutPoint> * pBestBinCuts,
+   CutPointHeap * const pBestBinCuts,
 
    const size_t cSamples,
    const bool bSymmetryReversal,
@@ -1505,172 +1624,167 @@ static bool TreeSearchCutSegment(
    // for efficiency we include space for the end point cuts even if they don't exist
    CutPoint * const aCutsWithENDPOINTS
 ) noexcept {
-   try {
-      EBM_ASSERT(nullptr != pBestBinCuts);
-      EBM_ASSERT(pBestBinCuts->empty());
-
-      EBM_ASSERT(2 <= cSamples); // we need at least 2 to split, otherwise we'd have exited before calling here
-      EBM_ASSERT(1 <= cSamplesPerBinMin);
-
-      EBM_ASSERT(nullptr != aNeighbourJumps);
-
-      EBM_ASSERT(2 <= cRanges);
-      EBM_ASSERT(cSamplesPerBinMin <= cCuttableItems / cRanges);
-      EBM_ASSERT(nullptr != aCutsWithENDPOINTS);
-
-      // - TODO: EXPLORING BOTH SIDES
-      //   - this function calls CutSegment, which greedily materializes cuts, so when it's unsure about a cut
-      //     it needs to be conservative and pick the least likley cut to cause problems down the road
-      //   - at this higher level, we can try cutting both low AND high AND skip the cut.  We use CutCuttingRange to
-      //     do the full exploration of both options and then we pick the better one.
-      //   - we can also explore N steps in the future to pick the best first step, then delete the worst 1st step
-      //     and keep all the work we did along the choice that we made (the remaining 128 options) then we can pick
-      //     the best step from all those 128 options and continue this way.  Since we do a complete recalculation
-      //     of all the BinCuts we can only do this several times, but it allows us to have 2 levels of fallback
-
-      //   - we can design an algorithm that divides into 255 and chooses the worst one and then does a complete fit on either direction.Best fit is recorded
-      //     then we re-do all 254 other cuts on BOTH sides.  We can only do a set number of these, so after 8 levels we'd have 256 attempts.  That might be acceptable
-      //   - the algorithm that we have below plays it safe since it needs to live with it's decions.  This more spectlative algorithm above can be more
-      //     risky since it plays both directions a bad play won't undermine it.  As such, we should try and chose the worst decion without regard to position
-      //     so in other words, try to choose the range that we have a drop point in in the middle where we need to move the most to get away from the 
-      //     best drops.  We can also try going left, going right, OR not choosing.  Don't traverse down the NO choice path, so we add 50% load, but we don't grow at 3^N, and we'll 
-      //     also explore the no choice at the root option
-      //
+   EBM_ASSERT(nullptr != pBestBinCuts);
+   EBM_ASSERT(pBestBinCuts->IsEmpty());
 
-      //constexpr size_t k_CutExploreDepth = 8;
-      //constexpr size_t k_CutExplorations = size_t { 1 } << k_CutExploreDepth;
+   EBM_ASSERT(2 <= cSamples); // we need at least 2 to split, otherwise we'd have exited before calling here
+   EBM_ASSERT(1 <= cSamplesPerBinMin);
 
-      CutPoint * pCutCur = &aCutsWithENDPOINTS[0];
-      CutPoint * pCutNext = &aCutsWithENDPOINTS[1];
+   EBM_ASSERT(nullptr != aNeighbourJumps);
 
-      pCutCur->m_pNext = pCutNext;
-      pCutCur->SetCut();
-      pCutCur->m_iValAspirationalFloat = FloatEbmType { 0 };
-      pCutCur->m_iVal = size_t { 0 };
-
-      const FloatEbmType stepInit = static_cast<FloatEbmType>(cCuttableItems) / static_cast<FloatEbmType>(cRanges);
-      EBM_ASSERT(cSamplesPerBinMin <= 1.00001 * stepInit);
-
-      const FloatEbmType cCuttableItemsFloat = static_cast<FloatEbmType>(cCuttableItems);
-      size_t iCutCur = 1;
-      size_t iValLow = size_t { 0 };
-      FloatEbmType iValAspirationalLowFloat = FloatEbmType { 0 };
-      size_t cRangesHigh = k_cutExploreDistance;
-      size_t iValHigh = k_valNotLegal;
-      do {
-         pCutNext->m_pPrev = pCutCur;
-         pCutCur = pCutNext;
-         ++pCutNext;
-         pCutCur->m_pNext = pCutNext;
-
-         size_t cRangesLow;
-         const ptrdiff_t iRangeLow = 
-            static_cast<ptrdiff_t>(iCutCur) - static_cast<ptrdiff_t>(k_cutExploreDistance);
-         if(UNLIKELY(iRangeLow <= ptrdiff_t { 0 })) {
-            cRangesLow = iCutCur;
-            EBM_ASSERT(size_t { 0 } == iValLow);
-            EBM_ASSERT(FloatEbmType { 0 } == iValAspirationalLowFloat);
-         } else {
-            cRangesLow = k_cutExploreDistance;
-            iValLow = k_valNotLegal;
-            iValAspirationalLowFloat = stepInit * static_cast<FloatEbmType>(static_cast<size_t>(iRangeLow));
-         }
+   EBM_ASSERT(2 <= cRanges);
+   EBM_ASSERT(cSamplesPerBinMin <= cCuttableItems / cRanges);
+   EBM_ASSERT(nullptr != aCutsWithENDPOINTS);
+
+   // - TODO: EXPLORING BOTH SIDES
+   //   - this function calls CutSegment, which greedily materializes cuts, so when it's unsure about a cut
+   //     it needs to be conservative and pick the least likley cut to cause problems down the road
+   //   - at this higher level, we can try cutting both low AND high AND skip the cut.  We use CutCuttingRange to
+   //     do the full exploration of both options and then we pick the better one.
+   //   - we can also explore N steps in the future to pick the best first step, then delete the worst 1st step
+   //     and keep all the work we did along the choice that we made (the remaining 128 options) then we can pick
+   //     the best step from all those 128 options and continue this way.  Since we do a complete recalculation
+   //     of all the BinCuts we can only do this several times, but it allows us to have 2 levels of fallback
+
+   //   - we can design an algorithm that divides into 255 and chooses the worst one and then does a complete fit on either direction.Best fit is recorded
+   //     then we re-do all 254 other cuts on BOTH sides.  We can only do a set number of these, so after 8 levels we'd have 256 attempts.  That might be acceptable
+   //   - the algorithm that we have below plays it safe since it needs to live with it's decions.  This more spectlative algorithm above can be more
+   //     risky since it plays both directions a bad play won't undermine it.  As such, we should try and chose the worst decion without regard to position
+   //     so in other words, try to choose the range that we have a drop point in in the middle where we need to move the most to get away from the 
+   //     best drops.  We can also try going left, going right, OR not choosing.  Don't traverse down the NO choice path, so we add 50% load, but we don't grow at 3^N, and we'll 
+   //     also explore the no choice at the root option
+   //
 
-         FloatEbmType iValAspirationalHighFloat;
-         size_t iRangeHigh = iCutCur + k_cutExploreDistance;
-         if(UNLIKELY(cRanges <= iRangeHigh)) {
-            cRangesHigh = cRanges - iCutCur;
-            iValHigh = cCuttableItems;
-            iValAspirationalHighFloat = cCuttableItemsFloat;
-         } else {
-            EBM_ASSERT(k_cutExploreDistance == cRangesHigh);
-            EBM_ASSERT(k_valNotLegal == iValHigh);
-            iValAspirationalHighFloat = stepInit * static_cast<FloatEbmType>(iRangeHigh);
-         }
+   //constexpr size_t k_CutExploreDepth = 8;
+   //constexpr size_t k_CutExplorations = size_t { 1 } << k_CutExploreDepth;
 
-         const FloatEbmType iValAspirationalCurFloat = stepInit * static_cast<FloatEbmType>(iCutCur);
-         pCutCur->m_iValAspirationalFloat = iValAspirationalCurFloat;
+   CutPoint * pCutCur = &aCutsWithENDPOINTS[0];
+   CutPoint * pCutNext = &aCutsWithENDPOINTS[1];
 
-         EBM_ASSERT(pCutCur->m_uniqueTiebreaker < cRanges);
+   pCutCur->m_pNext = pCutNext;
+   pCutCur->SetCut();
+   pCutCur->m_iValAspirationalFloat = FloatEbmType { 0 };
+   pCutCur->m_iVal = size_t { 0 };
 
-         BuildNeighbourhoodPlan(
-            cSamples,
-            bSymmetryReversal,
-            cSamplesPerBinMin,
-            iValuesStart,
-            cCuttableItems,
-            aNeighbourJumps,
-            cRangesLow,
-            iValLow,
-            iValAspirationalLowFloat,
-            cRangesHigh,
-            iValHigh,
-            iValAspirationalHighFloat,
-            pCutCur
-         );
-         ++iCutCur;
-      } while(iCutCur < cRanges);
+   const FloatEbmType stepInit = static_cast<FloatEbmType>(cCuttableItems) / static_cast<FloatEbmType>(cRanges);
+   EBM_ASSERT(cSamplesPerBinMin <= 1.00001 * stepInit);
 
+   const FloatEbmType cCuttableItemsFloat = static_cast<FloatEbmType>(cCuttableItems);
+   size_t iCutCur = 1;
+   size_t iValLow = size_t { 0 };
+   FloatEbmType iValAspirationalLowFloat = FloatEbmType { 0 };
+   size_t cRangesHigh = k_cutExploreDistance;
+   size_t iValHigh = k_valNotLegal;
+   do {
       pCutNext->m_pPrev = pCutCur;
-      pCutNext->m_pNext = nullptr;
-      pCutNext->SetCut();
-      pCutNext->m_iValAspirationalFloat = cCuttableItemsFloat;
-      pCutNext->m_iVal = cCuttableItems;
+      pCutCur = pCutNext;
+      ++pCutNext;
+      pCutCur->m_pNext = pCutNext;
+
+      size_t cRangesLow;
+      const ptrdiff_t iRangeLow = 
+         static_cast<ptrdiff_t>(iCutCur) - static_cast<ptrdiff_t>(k_cutExploreDistance);
+      if(UNLIKELY(iRangeLow <= ptrdiff_t { 0 })) {
+         cRangesLow = iCutCur;
+         EBM_ASSERT(size_t { 0 } == iValLow);
+         EBM_ASSERT(FloatEbmType { 0 } == iValAspirationalLowFloat);
+      } else {
+         cRangesLow = k_cutExploreDistance;
+         iValLow = k_valNotLegal;
+         iValAspirationalLowFloat = stepInit * static_cast<FloatEbmType>(static_cast<size_t>(iRangeLow));
+      }
 
+      FloatEbmType iValAspirationalHighFloat;
+      size_t iRangeHigh = iCutCur + k_cutExploreDistance;
+      if(UNLIKELY(cRanges <= iRangeHigh)) {
+         cRangesHigh = cRanges - iCutCur;
+         iValHigh = cCuttableItems;
+         iValAspirationalHighFloat = cCuttableItemsFloat;
+      } else {
+         EBM_ASSERT(k_cutExploreDistance == cRangesHigh);
+         EBM_ASSERT(k_valNotLegal == iValHigh);
+         iValAspirationalHighFloat = stepInit * static_cast<FloatEbmType>(iRangeHigh);
+      }
+
+      const FloatEbmType iValAspirationalCurFloat = stepInit * static_cast<FloatEbmType>(iCutCur);
+      pCutCur->m_iValAspirationalFloat = iValAspirationalCurFloat;
+
+      EBM_ASSERT(pCutCur->m_uniqueTiebreaker < cRanges);
+
+      BuildNeighbourhoodPlan(
+         cSamples,
+         bSymmetryReversal,
+         cSamplesPerBinMin,
+         iValuesStart,
+         cCuttableItems,
+         aNeighbourJumps,
+         cRangesLow,
+         iValLow,
+         iValAspirationalLowFloat,
+         cRangesHigh,
+         iValHigh,
+         iValAspirationalHighFloat,
+         pCutCur
+      );
+      ++iCutCur;
+   } while(iCutCur < cRanges);
+
+   pCutNext->m_pPrev = pCutCur;
+   pCutNext->m_pNext = nullptr;
+   pCutNext->SetCut();
+   pCutNext->m_iValAspirationalFloat = cCuttableItemsFloat;
+   pCutNext->m_iVal = cCuttableItems;
 
-      // now calculate priorities
-      CutPoint * pCutLow = &aCutsWithENDPOINTS[0];
-      CutPoint * pCutCenter = &aCutsWithENDPOINTS[1];
-      const size_t iRangeHigh = cRanges <= size_t { 1 } + k_cutExploreDistance ? 
-         cRanges : size_t { 1 } + k_cutExploreDistance;
-      CutPoint * pCutHigh = &aCutsWithENDPOINTS[iRangeHigh];
+
+   // now calculate priorities
+   CutPoint * pCutLow = &aCutsWithENDPOINTS[0];
+   CutPoint * pCutCenter = &aCutsWithENDPOINTS[1];
+   const size_t iRangeHigh = cRanges <= size_t { 1 } + k_cutExploreDistance ? 
+      cRanges : size_t { 1 } + k_cutExploreDistance;
+   CutPoint * pCutHigh = &aCutsWithENDPOINTS[iRangeHigh];
 
 #ifndef NDEBUG
 
-      EBM_ASSERT(aCutsWithENDPOINTS[0].m_pNext == pCutCenter); // this will fail if we remove items above in the future
-      CutPoint * pCutDebug = pCutCenter;
-      for(size_t cDebugRemaining = k_cutExploreDistance; nullptr != pCutDebug->m_pNext && 0 < cDebugRemaining ; 
-         --cDebugRemaining) 
-      {
-         pCutDebug = pCutDebug->m_pNext;
-      }
-      // this will fail if we remove items above in the future
-      EBM_ASSERT(pCutDebug == pCutHigh);
+   EBM_ASSERT(aCutsWithENDPOINTS[0].m_pNext == pCutCenter); // this will fail if we remove items above in the future
+   CutPoint * pCutDebug = pCutCenter;
+   for(size_t cDebugRemaining = k_cutExploreDistance; nullptr != pCutDebug->m_pNext && 0 < cDebugRemaining ; 
+      --cDebugRemaining) 
+   {
+      pCutDebug = pCutDebug->m_pNext;
+   }
+   // this will fail if we remove items above in the future
+   EBM_ASSERT(pCutDebug == pCutHigh);
 
 #endif // NDEBUG
 
-      size_t cLowRanges = 1;
-      do {
-         // in the future we might write code above that removes BinCuts, which if it were true could mean no legal cuts
-         EBM_ASSERT(nullptr != pCutCenter->m_pNext);
-         EBM_ASSERT(pCutLow < pCutCenter);
-         EBM_ASSERT(pCutCenter < pCutHigh);
-
-         pCutCenter->m_priority = CalculatePriority(
-            pCutLow->m_iValAspirationalFloat,
-            pCutHigh->m_iValAspirationalFloat,
-            pCutCenter
-         );
+   size_t cLowRanges = 1;
+   do {
+      // in the future we might write code above that removes BinCuts, which if it were true could mean no legal cuts
+      EBM_ASSERT(nullptr != pCutCenter->m_pNext);
+      EBM_ASSERT(pCutLow < pCutCenter);
+      EBM_ASSERT(pCutCenter < pCutHigh);
+
+      pCutCenter->m_priority = CalculatePriority(
+         pCutLow->m_iValAspirationalFloat,
+         pCutHigh->m_iValAspirationalFloat,
+         pCutCenter
+      );
 
-         EBM_ASSERT(!pCutCenter->IsCut());
-         pBestBinCuts->insert(pCutCenter);
+      EBM_ASSERT(!pCutCenter->IsCut());
+      pBestBinCuts->Insert(pCutCenter);
 
-         if(UNLIKELY(k_cutExploreDistance != cLowRanges)) {
-            ++cLowRanges;
-         } else {
-            pCutLow = pCutLow->m_pNext;
-         }
+      if(UNLIKELY(k_cutExploreDistance != cLowRanges)) {
+         ++cLowRanges;
+      } else {
+         pCutLow = pCutLow->m_pNext;
+      }
 
-         if(UNLIKELY(pCutNext != pCutHigh)) {
-            pCutHigh = pCutHigh->m_pNext;
-         }
+      if(UNLIKELY(pCutNext != pCutHigh)) {
+         pCutHigh = pCutHigh->m_pNext;
+      }
 
-         pCutCenter = pCutCenter->m_pNext;
-      } while(pCutNext != pCutCenter);
-   } catch(...) {
-      LOG_0(TraceLevelWarning, "WARNING TreeSearchCutSegment exception");
-      return true;
-   }
+      pCutCenter = pCutCenter->m_pNext;
+   } while(pCutNext != pCutCenter);
 
    return CutCuttingRange(
       pBestBinCuts,
@@ -1684,7 +1798,7 @@ static bool TreeSearchCutSegment(
 }
 
 INLINE_RELEASE_UNTEMPLATED static bool TradeCutSegment(
-   std::set<CutPoint *, CompareCutPoint> * const pBestBinCuts,
+   CutPointHeap * const pBestBinCuts,
 
    const size_t cSamples,
    const bool bSymmetryReversal,
@@ -1792,17 +1906,16 @@ INLINE_RELEASE_UNTEMPLATED static size_t DetermineRangesMax(
 }
 
 static bool AddCutToRanges(
-   std::set<CuttingRange *, CompareCuttingRange> & queue
+   CuttingRangeHeap * const pQueue
 ) {
-   EBM_ASSERT(!queue.empty());
+   EBM_ASSERT(!pQueue->IsEmpty());
 
-   auto iterator = queue.begin();
-   CuttingRange * const pCuttingRangeAdd = *iterator;
+   CuttingRange * const pCuttingRangeAdd = pQueue->GetTop();
    if(k_illegalAvgCuttableRangeWidthAfterAddingOneCut == pCuttingRangeAdd->m_avgCuttableRangeWidthAfterAddingOneCut) {
       // nothing remaining in the queue can accept new cuts
       return true;
    }
-   queue.erase(iterator);
+   pQueue->Erase(pCuttingRangeAdd);
 
    // this is how many ranges we were assigned before deciding that this range would recieve a new cut
    const size_t cRangesPrev = pCuttingRangeAdd->m_cRangesAssigned;
@@ -1829,12 +1942,12 @@ static bool AddCutToRanges(
       // priorities, unlike for BinCuts
    }
    pCuttingRangeAdd->m_avgCuttableRangeWidthAfterAddingOneCut = avgRangeWidthAfterAddingOneCut;
-   queue.insert(pCuttingRangeAdd);
+   pQueue->Insert(pCuttingRangeAdd);
    return false;
 }
 
 static void StuffCutsIntoCuttingRanges(
-   std::set<CuttingRange *, CompareCuttingRange> & queue,
+   CuttingRangeHeap * const pQueue,
    const size_t cCuttingRanges,
    CuttingRange * const aCuttingRange,
    const size_t cSamplesPerBinMin,
@@ -1909,7 +2022,7 @@ static void StuffCutsIntoCuttingRanges(
       }
       pCuttingRangeInit->m_avgCuttableRangeWidthAfterAddingOneCut = avgRangeWidthAfterAddingOneCut;
       pCuttingRangeInit->m_cRangesMax = cRangesMax;
-      queue.insert(pCuttingRangeInit);
+      pQueue->Insert(pCuttingRangeInit);
 
       ++pCuttingRangeInit;
    } while(LIKELY(pCuttingRangeEnd != pCuttingRangeInit));
@@ -1935,7 +2048,7 @@ static void StuffCutsIntoCuttingRanges(
    cRemainingCuts -= cCuttingRanges;
    // the queue can initially be empty if all the ranges are too short to make them cSamplesPerBinMin
    while(LIKELY(0 != cRemainingCuts)) {
-      if(AddCutToRanges(queue)) {
+      if(AddCutToRanges(pQueue)) {
          break;
       }
       --cRemainingCuts;
@@ -2472,11 +2585,10 @@ INLINE_RELEASE_UNTEMPLATED static size_t PossiblyRemoveCutForMissing(
    return cBinCutsMax;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterGenerateQuantileBinCutsParametersMessages = 25;
-static int g_cLogExitGenerateQuantileBinCutsParametersMessages = 25;
+static std::atomic<int> g_cLogEnterGenerateQuantileBinCutsParametersMessages { 25 };
+static std::atomic<int> g_cLogExitGenerateQuantileBinCutsParametersMessages { 25 };
 
-EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQuantileBinCuts(
+extern IntEbmType GenerateQuantileBinCutsInternal(
    IntEbmType countSamples,
    const FloatEbmType * featureValues,
    IntEbmType countSamplesPerBinMin,
@@ -2488,7 +2600,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
    FloatEbmType * minNonInfinityValueOut,
    IntEbmType * countNegativeInfinityOut,
    FloatEbmType * maxNonInfinityValueOut,
-   IntEbmType * countPositiveInfinityOut
+   IntEbmType * countPositiveInfinityOut,
+   FloatEbmType * aFeatureValuesScratch
 ) {
    LOG_COUNTED_N(
       &g_cLogEnterGenerateQuantileBinCutsParametersMessages,
@@ -2584,7 +2697,11 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
          const size_t cSamplesIncludingMissingValues = static_cast<size_t>(countSamples);
 
-         FloatEbmType * const aFeatureValues = EbmMalloc<FloatEbmType>(cSamplesIncludingMissingValues);
+         // batched callers hand us a scratch buffer of countSamples items that they reuse between features
+         FloatEbmType * const aFeatureValuesAllocated = nullptr != aFeatureValuesScratch ? nullptr :
+            EbmMalloc<FloatEbmType>(cSamplesIncludingMissingValues);
+         FloatEbmType * const aFeatureValues = nullptr != aFeatureValuesScratch ? aFeatureValuesScratch :
+            aFeatureValuesAllocated;
          if(UNLIKELY(nullptr == aFeatureValues)) {
             LOG_0(TraceLevelError, "ERROR GenerateQuantileBinCuts nullptr == aFeatureValues");
 
@@ -2621,7 +2738,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          countMissingValuesRet = static_cast<IntEbmType>(cMissingValues);
 
          if(UNLIKELY(cSamples <= size_t { 1 })) {
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             // we can't really split 0 or 1 samples.  Now that we know our min, max, etc values, we can exit
             // or if there was only 1 non-missing value
             countBinCutsRet = IntEbmType { 0 };
@@ -2633,7 +2750,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          const IntEbmType countBinCuts = *countBinCutsInOut;
 
          if(UNLIKELY(countBinCuts <= IntEbmType { 0 })) {
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 0 };
             if(UNLIKELY(countBinCuts < IntEbmType { 0 })) {
@@ -2647,7 +2764,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
             // if we have a potential bin cut, then binCutsLowerBoundInclusiveOut shouldn't be nullptr
             LOG_0(TraceLevelError, "ERROR GenerateQuantileBinCuts nullptr == binCutsLowerBoundInclusiveOut");
 
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
 
@@ -2667,7 +2784,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
             // in order to make any cuts.  Anything less and we should just return now.
             // We also use this as a comparison to ensure that countSamplesPerBinMin is convertible to a size_t
 
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 0 };
             goto exit_with_log;
@@ -2707,13 +2824,13 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          // of pointers below of FloatEbmType * to index into aFeatureValues 
          if(UNLIKELY(IsMultiplyError(cBinCutsMax, std::max(sizeof(*binCutsLowerBoundInclusiveOut), sizeof(FloatEbmType *))))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsMultiplyError(cBinCutsMax, std::max(sizeof(*binCutsLowerBoundInclusiveOut), sizeof(FloatEbmType *)))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
          }
 
-         std::sort(aFeatureValues, aFeatureValues + cSamples);
+         SortFeatureValues(cSamples, aFeatureValues);
 
          EBM_ASSERT(cBinCutsMax < cSamples); // so we can add 1 to cBinCutsMax safely
          const size_t cUncuttableRangeLengthMin = 
@@ -2734,7 +2851,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          // cSamples is a size_t
          EBM_ASSERT(cCuttingRanges <= cBinCutsMax + size_t { 1 });
          if(UNLIKELY(size_t { 0 } == cCuttingRanges)) {
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 0 };
             goto exit_with_log;
@@ -2742,7 +2859,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
          if(UNLIKELY(IsMultiplyError(cSamples, sizeof(NeighbourJump)))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsMultiplyError(cSamples, sizeof(NeighbourJump))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
@@ -2762,7 +2879,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          const size_t cBinCutsWithEndpointsMax = cBinCutsMax + size_t { 2 };
          if(UNLIKELY(IsMultiplyError(cBinCutsWithEndpointsMax, sizeof(CutPoint)))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsMultiplyError(cBinCutsWithEndpointsMax, sizeof(CutPoint))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
@@ -2771,20 +2888,33 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
          if(UNLIKELY(IsMultiplyError(cCuttingRanges, sizeof(CuttingRange)))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsMultiplyError(cCuttingRanges, sizeof(CuttingRange))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
          }
          const size_t cBytesCuttingRanges = cCuttingRanges * sizeof(CuttingRange);
 
+         // our heaps hold pointers into aBinCuts and aCuttingRange, so they need no allocations of their own.  We
+         // only put the cuts between the endpoints into the CutPoint heap, so it needs room for cBinCutsMax items
+         static_assert(sizeof(CutPoint *) == sizeof(FloatEbmType *), "we reuse the multiplication check above");
+         const size_t cBytesCutPointPointers = cBinCutsMax * sizeof(CutPoint *);
+         if(UNLIKELY(IsMultiplyError(cCuttingRanges, sizeof(CuttingRange *)))) {
+            LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsMultiplyError(cCuttingRanges, sizeof(CuttingRange *))");
+            free(aFeatureValuesAllocated);
+            countBinCutsRet = IntEbmType { 0 };
+            ret = IntEbmType { 1 };
+            goto exit_with_log;
+         }
+         const size_t cBytesCuttingRangePointers = cCuttingRanges * sizeof(CuttingRange *);
+
 
          const size_t cBytesToNeighbourJump = size_t { 0 };
          const size_t cBytesToValueCutPointers = cBytesToNeighbourJump + cBytesNeighbourJumps;
 
          if(UNLIKELY(IsAddError(cBytesToValueCutPointers, cBytesValueCutPointers))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsAddError(cBytesToValueCutPointers, cBytesValueCutPointers))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
@@ -2793,7 +2923,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
          if(UNLIKELY(IsAddError(cBytesToBinCuts, cBytesBinCuts))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsAddError(cBytesToBinCuts, cBytesBinCuts))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
@@ -2802,17 +2932,35 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
          if(UNLIKELY(IsAddError(cBytesToCuttingRange, cBytesCuttingRanges))) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsAddError(cBytesToCuttingRange, cBytesCuttingRanges))");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
+            countBinCutsRet = IntEbmType { 0 };
+            ret = IntEbmType { 1 };
+            goto exit_with_log;
+         }
+         const size_t cBytesToCutPointPointers = cBytesToCuttingRange + cBytesCuttingRanges;
+
+         if(UNLIKELY(IsAddError(cBytesToCutPointPointers, cBytesCutPointPointers))) {
+            LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsAddError(cBytesToCutPointPointers, cBytesCutPointPointers))");
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
          }
-         const size_t cBytesToEnd = cBytesToCuttingRange + cBytesCuttingRanges;
+         const size_t cBytesToCuttingRangePointers = cBytesToCutPointPointers + cBytesCutPointPointers;
+
+         if(UNLIKELY(IsAddError(cBytesToCuttingRangePointers, cBytesCuttingRangePointers))) {
+            LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts IsAddError(cBytesToCuttingRangePointers, cBytesCuttingRangePointers))");
+            free(aFeatureValuesAllocated);
+            countBinCutsRet = IntEbmType { 0 };
+            ret = IntEbmType { 1 };
+            goto exit_with_log;
+         }
+         const size_t cBytesToEnd = cBytesToCuttingRangePointers + cBytesCuttingRangePointers;
 
          char * const pMem = static_cast<char *>(malloc(cBytesToEnd));
          if(UNLIKELY(nullptr == pMem)) {
             LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts nullptr == pMem");
-            free(aFeatureValues);
+            free(aFeatureValuesAllocated);
             countBinCutsRet = IntEbmType { 0 };
             ret = IntEbmType { 1 };
             goto exit_with_log;
@@ -2822,6 +2970,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          const FloatEbmType ** const apValueCutTops = reinterpret_cast<const FloatEbmType **>(pMem + cBytesToValueCutPointers);
          CutPoint * const aBinCuts = reinterpret_cast<CutPoint *>(pMem + cBytesToBinCuts);
          CuttingRange * const aCuttingRange = reinterpret_cast<CuttingRange *>(pMem + cBytesToCuttingRange);
+         CutPoint ** const apCutPointHeap = reinterpret_cast<CutPoint **>(pMem + cBytesToCutPointPointers);
+         CuttingRange ** const apCuttingRangeHeap = reinterpret_cast<CuttingRange **>(pMem + cBytesToCuttingRangePointers);
 
          ConstructJumps(cSamples, aFeatureValues, aNeighbourJumps);
 
@@ -2838,253 +2988,249 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          FillCuttingRangeNeighbours(cSamples, aFeatureValues, cCuttingRanges, aCuttingRange);
 
          const FloatEbmType ** ppValueCutTop = apValueCutTops;
-         try {
-            std::set<CuttingRange *, CompareCuttingRange> priorityQueue;
-            StuffCutsIntoCuttingRanges(
-               priorityQueue,
-               cCuttingRanges,
-               aCuttingRange,
-               cSamplesPerBinMin,
-               cBinCutsMax
-            );
-            do {
-               EBM_ASSERT(!priorityQueue.empty());
-               // remove the item that is the worst CuttingRange for us to add a new cut to.  We'll keep
-               // the cutting ranges that are closest to the threshold for adding new cuts in the queue so that
-               // if we can't use all our cuts, we can move the cuts to the next best choice
-               auto iterator = prev(priorityQueue.end());
-               CuttingRange * const pCuttingRange = *iterator;
-               priorityQueue.erase(iterator);
+         CuttingRangeHeap priorityQueue;
+         priorityQueue.Initialize(apCuttingRangeHeap);
+         StuffCutsIntoCuttingRanges(
+            &priorityQueue,
+            cCuttingRanges,
+            aCuttingRange,
+            cSamplesPerBinMin,
+            cBinCutsMax
+         );
+
+         // from here on we only remove the worst CuttingRange, and nothing changes the priority of the ones that
+         // remain, so sorting them once visits them in the same order as repeatedly removing the lowest item
+         CuttingRange ** const apCuttingRangeFirst = priorityQueue.GetItems();
+         CuttingRange ** ppCuttingRange = apCuttingRangeFirst + priorityQueue.GetCount();
+         std::sort(apCuttingRangeFirst, ppCuttingRange, CompareCuttingRange());
+         do {
+            EBM_ASSERT(apCuttingRangeFirst < ppCuttingRange);
+            // remove the item that is the worst CuttingRange for us to add a new cut to.  We'll keep
+            // the cutting ranges that are closest to the threshold for adding new cuts in the queue so that
+            // if we can't use all our cuts, we can move the cuts to the next best choice
+            --ppCuttingRange;
+            CuttingRange * const pCuttingRange = *ppCuttingRange;
 
-               const size_t cRanges = pCuttingRange->m_cRangesAssigned;
+            const size_t cRanges = pCuttingRange->m_cRangesAssigned;
 
 #ifdef LOG_SUPERVERBOSE_DISCRETIZATION_ORDERED
-               LOG_N(TraceLevelVerbose, "Dequque CuttingRange: %zu, %zu, %zu, %zu, %zu, %zu, %zu, %" FloatEbmTypePrintf,
-                  pCuttingRange->m_uniqueTiebreaker,
-                  pCuttingRange->m_cRangesAssigned,
-                  pCuttingRange->m_cCuttableValues,
-                  static_cast<size_t>(pCuttingRange->m_pCuttableValuesFirst - aFeatureValues),
-                  pCuttingRange->m_cUncuttableHighValues,
-                  pCuttingRange->m_cUncuttableLowValues,
-                  pCuttingRange->m_cRangesMax,
-                  pCuttingRange->m_avgCuttableRangeWidthAfterAddingOneCut
-               );
+            LOG_N(TraceLevelVerbose, "Dequque CuttingRange: %zu, %zu, %zu, %zu, %zu, %zu, %zu, %" FloatEbmTypePrintf,
+               pCuttingRange->m_uniqueTiebreaker,
+               pCuttingRange->m_cRangesAssigned,
+               pCuttingRange->m_cCuttableValues,
+               static_cast<size_t>(pCuttingRange->m_pCuttableValuesFirst - aFeatureValues),
+               pCuttingRange->m_cUncuttableHighValues,
+               pCuttingRange->m_cUncuttableLowValues,
+               pCuttingRange->m_cRangesMax,
+               pCuttingRange->m_avgCuttableRangeWidthAfterAddingOneCut
+            );
 #endif // LOG_SUPERVERBOSE_DISCRETIZATION_ORDERED
 
-               if(PREDICTABLE(size_t { 1 } < cRanges)) {
-                  // we have cuts on our ends, either explicit or implicit at the tail ends that don't have unsplitable
-                  // ranges on the tails, and at least one cut in our center, so we have to make decisions
-                  std::set<CutPoint *, CompareCutPoint> bestBinCuts;
+            if(PREDICTABLE(size_t { 1 } < cRanges)) {
+               // we have cuts on our ends, either explicit or implicit at the tail ends that don't have unsplitable
+               // ranges on the tails, and at least one cut in our center, so we have to make decisions
+               CutPointHeap bestBinCuts;
+               bestBinCuts.Initialize(apCutPointHeap);
 
 #ifdef NEVER
-                  // TODO : in the future fill this priority queue with the average length within our
-                  //        visibility window AFTER a new cut would be added.  We calculate this value per
-                  //        CutPoint and we do it at the same time we're calculating the cut priority, which
-                  //        is good since we'll already have the visibility windows calculated and all that.
-                  //        One wrinkle is that we want to be able to insert a cut into a range that no longer
-                  //        has any internal cuts.  So for instance if we had a range from 50 to 100 with
-                  //        materialized cuts on both 50 and 100, and no allocated cuts between them, in
-                  //        the future if cuts become plentiful, then we want to create a new cut between
-                  //        those materialized cuts.  I believe the best way to handle this is to check
-                  //        when materializing a cut if both our lower and higher cut points are aspirational
-                  //        or materialized.  If they are both materialized, then insert our new materialized
-                  //        cut into the open space priority queue AND the cut to the left (which represents)
-                  //        the lower range.  Or if that's too complicated then take the maximum min from both
-                  //        our sides and insert ourselves with that.  We can always examine the left and right
-                  //        on extraction to determine which side we should go to.
-                  //        Inisde CalculateRangesMaximizeMin, we might notice that one of our sides doesn't
-                  //        work very well with a certain number of cuts.  We should speculatively move
-                  //        one of our cuts from that side to a new set of ranges (encoded as BinCuts)
-                  //        We still do the low/high cut number optimization with our left and right windows
-                  //        when planning since it's more efficient, and no changes should leak information
-                  //        outside those windows otherwise it would become an N^2 algorithm.
-                  //        We use our doubly linked list to move non-materialized cut points long distances
-                  //        from one part of the cutting range to annother if necessary.
-                  //        We should also use the doubly linked list to delete BinCuts that we can't use
-                  //        if there is no place to put them
-
-                  std::set<CutPoint *, CompareCutPoint> fillTheVoids;
+               // TODO : in the future fill this priority queue with the average length within our
+               //        visibility window AFTER a new cut would be added.  We calculate this value per
+               //        CutPoint and we do it at the same time we're calculating the cut priority, which
+               //        is good since we'll already have the visibility windows calculated and all that.
+               //        One wrinkle is that we want to be able to insert a cut into a range that no longer
+               //        has any internal cuts.  So for instance if we had a range from 50 to 100 with
+               //        materialized cuts on both 50 and 100, and no allocated cuts between them, in
+               //        the future if cuts become plentiful, then we want to create a new cut between
+               //        those materialized cuts.  I believe the best way to handle this is to check
+               //        when materializing a cut if both our lower and higher cut points are aspirational
+               //        or materialized.  If they are both materialized, then insert our new materialized
+               //        cut into the open space priority queue AND the cut to the left (which represents)
+               //        the lower range.  Or if that's too complicated then take the maximum min from both
+               //        our sides and insert ourselves with that.  We can always examine the left and right
+               //        on extraction to determine which side we should go to.
+               //        Inisde CalculateRangesMaximizeMin, we might notice that one of our sides doesn't
+               //        work very well with a certain number of cuts.  We should speculatively move
+               //        one of our cuts from that side to a new set of ranges (encoded as BinCuts)
+               //        We still do the low/high cut number optimization with our left and right windows
+               //        when planning since it's more efficient, and no changes should leak information
+               //        outside those windows otherwise it would become an N^2 algorithm.
+               //        We use our doubly linked list to move non-materialized cut points long distances
+               //        from one part of the cutting range to annother if necessary.
+               //        We should also use the doubly linked list to delete BinCuts that we can't use
+               //        if there is no place to put them
+
+               CutPointHeap fillTheVoids;
 #endif // NEVER
 
-                  FillTiebreakers(bSymmetryReversal, &randomStream, cRanges - size_t { 1 }, aBinCuts + 1);
-                  if(TradeCutSegment(
-                     &bestBinCuts,
-                     cSamples,
-                     bSymmetryReversal,
-                     cSamplesPerBinMin,
-                     pCuttingRange->m_pCuttableValuesFirst - aFeatureValues,
-                     pCuttingRange->m_cCuttableValues,
-                     aNeighbourJumps,
-                     cRanges,
-                     // for efficiency we include space for the end point cuts even if they don't exist
-                     aBinCuts
-                  )) {
-                     // any error messages should have been written to the log inside TradeCutSegment
-
-                     free(pMem);
-                     free(aFeatureValues);
-
-                     countBinCutsRet = IntEbmType { 0 };
-                     ret = IntEbmType { 1 };
-                     goto exit_with_log;
-                  }
+               FillTiebreakers(bSymmetryReversal, &randomStream, cRanges - size_t { 1 }, aBinCuts + 1);
+               if(TradeCutSegment(
+                  &bestBinCuts,
+                  cSamples,
+                  bSymmetryReversal,
+                  cSamplesPerBinMin,
+                  pCuttingRange->m_pCuttableValuesFirst - aFeatureValues,
+                  pCuttingRange->m_cCuttableValues,
+                  aNeighbourJumps,
+                  cRanges,
+                  // for efficiency we include space for the end point cuts even if they don't exist
+                  aBinCuts
+               )) {
+                  // any error messages should have been written to the log inside TradeCutSegment
+
+                  free(pMem);
+                  free(aFeatureValuesAllocated);
+
+                  countBinCutsRet = IntEbmType { 0 };
+                  ret = IntEbmType { 1 };
+                  goto exit_with_log;
+               }
 
-                  const FloatEbmType * const pCuttableValuesStart = pCuttingRange->m_pCuttableValuesFirst;
+               const FloatEbmType * const pCuttableValuesStart = pCuttingRange->m_pCuttableValuesFirst;
 
-                  if(0 != pCuttingRange->m_cUncuttableLowValues) {
-                     // if it's zero then it's an implicit cut and we shouldn't put one there, 
-                     // otherwise put in the cut
-                     const FloatEbmType * const pCut = pCuttableValuesStart;
-                     EBM_ASSERT(aFeatureValues < pCut);
-                     EBM_ASSERT(pCut < aFeatureValues + countSamples);
-                     *ppValueCutTop = pCut;
-                     ++ppValueCutTop;
-                  }
-
-                  const CutPoint * pCutPoint = aBinCuts->m_pNext;
-                  const CutPoint * pNext = pCutPoint->m_pNext;
-                  while(LIKELY(nullptr != pNext)) {
-                     const size_t iVal = pCutPoint->m_iVal;
-                     if(LIKELY(k_valNotLegal != iVal)) {
-                        const FloatEbmType * const pCut = pCuttableValuesStart + iVal;
-                        EBM_ASSERT(aFeatureValues < pCut);
-                        EBM_ASSERT(pCut < aFeatureValues + countSamples);
-                        EBM_ASSERT(pCuttingRange->m_pCuttableValuesFirst < pCut);
-                        EBM_ASSERT(pCut < pCuttingRange->m_pCuttableValuesFirst + pCuttingRange->m_cCuttableValues);
-                        *ppValueCutTop = pCut;
-                        ++ppValueCutTop;
-                     }
-                     pCutPoint = pNext;
-                     pNext = pCutPoint->m_pNext;
-                  }
+               if(0 != pCuttingRange->m_cUncuttableLowValues) {
+                  // if it's zero then it's an implicit cut and we shouldn't put one there, 
+                  // otherwise put in the cut
+                  const FloatEbmType * const pCut = pCuttableValuesStart;
+                  EBM_ASSERT(aFeatureValues < pCut);
+                  EBM_ASSERT(pCut < aFeatureValues + countSamples);
+                  *ppValueCutTop = pCut;
+                  ++ppValueCutTop;
+               }
 
-                  if(0 != pCuttingRange->m_cUncuttableHighValues) {
-                     // if it's zero then it's an implicit cut and we shouldn't put one there, 
-                     // otherwise put in the cut
-                     const FloatEbmType * const pCut =
-                        pCuttableValuesStart + pCuttingRange->m_cCuttableValues;
-                     EBM_ASSERT(aFeatureValues < pCut);
-                     EBM_ASSERT(pCut < aFeatureValues + countSamples);
-                     *ppValueCutTop = pCut;
-                     ++ppValueCutTop;
-                  }
-               } else if(PREDICTABLE(size_t { 1 } == cRanges)) {
-                  // we have cuts on both our ends (either explicit or implicit), so
-                  // we don't have to make any hard decisions, but we do have to be careful of the scenarios
-                  // where some of our cuts are implicit
-
-                  if(0 != pCuttingRange->m_cUncuttableLowValues) {
-                     // if it's zero then it's an implicit cut and we shouldn't put one there, 
-                     // otherwise put in the cut
-                     const FloatEbmType * const pCut = pCuttingRange->m_pCuttableValuesFirst;
-                     EBM_ASSERT(aFeatureValues < pCut);
-                     EBM_ASSERT(pCut < aFeatureValues + countSamples);
-                     *ppValueCutTop = pCut;
-                     ++ppValueCutTop;
-                  }
-                  if(0 != pCuttingRange->m_cUncuttableHighValues) {
-                     // if it's zero then it's an implicit cut and we shouldn't put one there, 
-                     // otherwise put in the cut
-                     const FloatEbmType * const pCut =
-                        pCuttingRange->m_pCuttableValuesFirst + pCuttingRange->m_cCuttableValues;
+               const CutPoint * pCutPoint = aBinCuts->m_pNext;
+               const CutPoint * pNext = pCutPoint->m_pNext;
+               while(LIKELY(nullptr != pNext)) {
+                  const size_t iVal = pCutPoint->m_iVal;
+                  if(LIKELY(k_valNotLegal != iVal)) {
+                     const FloatEbmType * const pCut = pCuttableValuesStart + iVal;
                      EBM_ASSERT(aFeatureValues < pCut);
                      EBM_ASSERT(pCut < aFeatureValues + countSamples);
+                     EBM_ASSERT(pCuttingRange->m_pCuttableValuesFirst < pCut);
+                     EBM_ASSERT(pCut < pCuttingRange->m_pCuttableValuesFirst + pCuttingRange->m_cCuttableValues);
                      *ppValueCutTop = pCut;
                      ++ppValueCutTop;
                   }
-               } else {
-                  EBM_ASSERT(0 == cRanges);
-                  // we have only 1 cut to place, and no cuts on our boundaries, so we need to figure out
-                  // where in our range to place it, taking into consideration that we might have neighbours on our
-                  // sides that could be large
-
-                  // if we had implicit cuts on both ends and zero assigned cuts, we'd have 1 range and would
-                  // be handled above
-                  EBM_ASSERT(0 != pCuttingRange->m_cUncuttableLowValues || 0 != pCuttingRange->m_cUncuttableHighValues);
-
-                  // if one side or the other was an implicit cut, then we have zero cuts left after
-                  // the implicit cut is accounted for, so do nothing
-                  if(LIKELY(LIKELY(0 != pCuttingRange->m_cUncuttableLowValues) && 
-                     LIKELY(0 != pCuttingRange->m_cUncuttableHighValues))) {
-                     // even though we could reduce our squared error length more, it probably makes sense to 
-                     // include a little bit of our available numbers on one long range and the other, so let's put
-                     // the cut in the middle and only make the low/high decision to settle long-ish ranges
-                     // in the center
-
-                     const FloatEbmType * pCut = pCuttingRange->m_pCuttableValuesFirst;
-                     const size_t cCuttableItems = pCuttingRange->m_cCuttableValues;
-                        
-                     const size_t iRangeFirst = pCuttingRange->m_pCuttableValuesFirst - aFeatureValues;
-                     const size_t iCenterOfRange = iRangeFirst + (cCuttableItems >> 1);
-
-                     // unlike in BuildNeighbourhoodPlan, we don't need to worry about the scenario that
-                     // a jumping range falls on the exact iCenterOfRange value, since for our purposes here
-                     // if we have a perfect answer that is perfectly in the center, then we always select that
-                     // one since we have no exclusion criteria here.  We never will seriously consider the 
-                     // iStartNext value if iStartCur is a perfectly centered match.
-                     // So we don't need to inject some randomness here, unlike in BuildNeighbourhoodPlan
-
-                     const NeighbourJump * const pNeighbourJump = &aNeighbourJumps[iCenterOfRange];
-
-                     const size_t iStartCur = pNeighbourJump->m_iStartCur;
-                     const size_t iStartNext = pNeighbourJump->m_iStartNext;
-
-                     const ptrdiff_t cDistanceLow1 = static_cast<ptrdiff_t>(iStartCur - iRangeFirst);
-                     EBM_ASSERT(ptrdiff_t { 0 } <= cDistanceLow1);
-                     EBM_ASSERT(cDistanceLow1 <= static_cast<ptrdiff_t>(cCuttableItems >> 1));
-                     // cDistanceHigh1 can be negative if cCuttableItems is zero since then iStartNext
-                     // will reflect the boundary of the point after the unsplittable range above
-                     // our cut point, but since our cDistanceLow1 will be zero, it'll work out without
-                     // a special check
-                     const ptrdiff_t cDistanceHigh1 = static_cast<ptrdiff_t>(iRangeFirst + cCuttableItems) 
-                        - static_cast<ptrdiff_t>(iStartNext);
-                     EBM_ASSERT(cDistanceHigh1 <= static_cast<ptrdiff_t>(cCuttableItems >> 1));
-                     EBM_ASSERT(size_t { 1 } == cCuttableItems % size_t { 2 } ||
-                        cDistanceHigh1 < static_cast<ptrdiff_t>(cCuttableItems >> 1));
-
-                     size_t iResult = UNPREDICTABLE(cDistanceHigh1 < cDistanceLow1) ? iStartCur : iStartNext;
-                     if(UNLIKELY(cDistanceHigh1 == cDistanceLow1)) {
-                        // per above, we can't get the situation where iCenterOfRange is the perfect center
-                        // past our if check above for cDistanceHigh1 == cDistanceLow1
-                        EBM_ASSERT(static_cast<size_t>(cDistanceLow1) * size_t { 2 } != cCuttableItems);
-
-                        // we're equidistant to both edges.  Next try to see which is closer to the outer
-                        // edge if we include the uncuttable ranges beyond
-                        const size_t cDistanceLow2 = pCuttingRange->m_cUncuttableLowValues;
-                        const size_t cDistanceHigh2 = pCuttingRange->m_cUncuttableHighValues;
-                        iResult = UNPREDICTABLE(cDistanceHigh2 < cDistanceLow2) ? iStartCur : iStartNext;
-                        if(UNLIKELY(cDistanceHigh2 == cDistanceLow2)) {
-                           // next, let's try to the edges of our full array
-                           const size_t cDistanceLow3 = iStartCur;
-                           const size_t cDistanceHigh3 = cSamples - iStartNext;
-                           iResult = UNPREDICTABLE(cDistanceHigh3 < cDistanceLow3) ? iStartCur : iStartNext;
-                           if(UNLIKELY(cDistanceHigh3 == cDistanceLow3)) {
-                              // wow, we're at the center of the entire array AND the center of the outer
-                              // unsplittable ranges, AND the center of the splitable ranges.  Our final fallback
-                              // is to resort to our symmetric determination (PLUS randomness)
-
-                              bool bLocalSymmetryReversal = randomStream.Next() != bSymmetryReversal;
-                              iResult = UNPREDICTABLE(bLocalSymmetryReversal) ? iStartCur : iStartNext;
-                           }
+                  pCutPoint = pNext;
+                  pNext = pCutPoint->m_pNext;
+               }
+
+               if(0 != pCuttingRange->m_cUncuttableHighValues) {
+                  // if it's zero then it's an implicit cut and we shouldn't put one there, 
+                  // otherwise put in the cut
+                  const FloatEbmType * const pCut =
+                     pCuttableValuesStart + pCuttingRange->m_cCuttableValues;
+                  EBM_ASSERT(aFeatureValues < pCut);
+                  EBM_ASSERT(pCut < aFeatureValues + countSamples);
+                  *ppValueCutTop = pCut;
+                  ++ppValueCutTop;
+               }
+            } else if(PREDICTABLE(size_t { 1 } == cRanges)) {
+               // we have cuts on both our ends (either explicit or implicit), so
+               // we don't have to make any hard decisions, but we do have to be careful of the scenarios
+               // where some of our cuts are implicit
+
+               if(0 != pCuttingRange->m_cUncuttableLowValues) {
+                  // if it's zero then it's an implicit cut and we shouldn't put one there, 
+                  // otherwise put in the cut
+                  const FloatEbmType * const pCut = pCuttingRange->m_pCuttableValuesFirst;
+                  EBM_ASSERT(aFeatureValues < pCut);
+                  EBM_ASSERT(pCut < aFeatureValues + countSamples);
+                  *ppValueCutTop = pCut;
+                  ++ppValueCutTop;
+               }
+               if(0 != pCuttingRange->m_cUncuttableHighValues) {
+                  // if it's zero then it's an implicit cut and we shouldn't put one there, 
+                  // otherwise put in the cut
+                  const FloatEbmType * const pCut =
+                     pCuttingRange->m_pCuttableValuesFirst + pCuttingRange->m_cCuttableValues;
+                  EBM_ASSERT(aFeatureValues < pCut);
+                  EBM_ASSERT(pCut < aFeatureValues + countSamples);
+                  *ppValueCutTop = pCut;
+                  ++ppValueCutTop;
+               }
+            } else {
+               EBM_ASSERT(0 == cRanges);
+               // we have only 1 cut to place, and no cuts on our boundaries, so we need to figure out
+               // where in our range to place it, taking into consideration that we might have neighbours on our
+               // sides that could be large
+
+               // if we had implicit cuts on both ends and zero assigned cuts, we'd have 1 range and would
+               // be handled above
+               EBM_ASSERT(0 != pCuttingRange->m_cUncuttableLowValues || 0 != pCuttingRange->m_cUncuttableHighValues);
+
+               // if one side or the other was an implicit cut, then we have zero cuts left after
+               // the implicit cut is accounted for, so do nothing
+               if(LIKELY(LIKELY(0 != pCuttingRange->m_cUncuttableLowValues) && 
+                  LIKELY(0 != pCuttingRange->m_cUncuttableHighValues))) {
+                  // even though we could reduce our squared error length more, it probably makes sense to 
+                  // include a little bit of our available numbers on one long range and the other, so let's put
+                  // the cut in the middle and only make the low/high decision to settle long-ish ranges
+                  // in the center
+
+                  const FloatEbmType * pCut = pCuttingRange->m_pCuttableValuesFirst;
+                  const size_t cCuttableItems = pCuttingRange->m_cCuttableValues;
+                     
+                  const size_t iRangeFirst = pCuttingRange->m_pCuttableValuesFirst - aFeatureValues;
+                  const size_t iCenterOfRange = iRangeFirst + (cCuttableItems >> 1);
+
+                  // unlike in BuildNeighbourhoodPlan, we don't need to worry about the scenario that
+                  // a jumping range falls on the exact iCenterOfRange value, since for our purposes here
+                  // if we have a perfect answer that is perfectly in the center, then we always select that
+                  // one since we have no exclusion criteria here.  We never will seriously consider the 
+                  // iStartNext value if iStartCur is a perfectly centered match.
+                  // So we don't need to inject some randomness here, unlike in BuildNeighbourhoodPlan
+
+                  const NeighbourJump * const pNeighbourJump = &aNeighbourJumps[iCenterOfRange];
+
+                  const size_t iStartCur = pNeighbourJump->m_iStartCur;
+                  const size_t iStartNext = pNeighbourJump->m_iStartNext;
+
+                  const ptrdiff_t cDistanceLow1 = static_cast<ptrdiff_t>(iStartCur - iRangeFirst);
+                  EBM_ASSERT(ptrdiff_t { 0 } <= cDistanceLow1);
+                  EBM_ASSERT(cDistanceLow1 <= static_cast<ptrdiff_t>(cCuttableItems >> 1));
+                  // cDistanceHigh1 can be negative if cCuttableItems is zero since then iStartNext
+                  // will reflect the boundary of the point after the unsplittable range above
+                  // our cut point, but since our cDistanceLow1 will be zero, it'll work out without
+                  // a special check
+                  const ptrdiff_t cDistanceHigh1 = static_cast<ptrdiff_t>(iRangeFirst + cCuttableItems) 
+                     - static_cast<ptrdiff_t>(iStartNext);
+                  EBM_ASSERT(cDistanceHigh1 <= static_cast<ptrdiff_t>(cCuttableItems >> 1));
+                  EBM_ASSERT(size_t { 1 } == cCuttableItems % size_t { 2 } ||
+                     cDistanceHigh1 < static_cast<ptrdiff_t>(cCuttableItems >> 1));
+
+                  size_t iResult = UNPREDICTABLE(cDistanceHigh1 < cDistanceLow1) ? iStartCur : iStartNext;
+                  if(UNLIKELY(cDistanceHigh1 == cDistanceLow1)) {
+                     // per above, we can't get the situation where iCenterOfRange is the perfect center
+                     // past our if check above for cDistanceHigh1 == cDistanceLow1
+                     EBM_ASSERT(static_cast<size_t>(cDistanceLow1) * size_t { 2 } != cCuttableItems);
+
+                     // we're equidistant to both edges.  Next try to see which is closer to the outer
+                     // edge if we include the uncuttable ranges beyond
+                     const size_t cDistanceLow2 = pCuttingRange->m_cUncuttableLowValues;
+                     const size_t cDistanceHigh2 = pCuttingRange->m_cUncuttableHighValues;
+                     iResult = UNPREDICTABLE(cDistanceHigh2 < cDistanceLow2) ? iStartCur : iStartNext;
+                     if(UNLIKELY(cDistanceHigh2 == cDistanceLow2)) {
+                        // next, let's try to the edges of our full array
+                        const size_t cDistanceLow3 = iStartCur;
+                        const size_t cDistanceHigh3 = cSamples - iStartNext;
+                        iResult = UNPREDICTABLE(cDistanceHigh3 < cDistanceLow3) ? iStartCur : iStartNext;
+                        if(UNLIKELY(cDistanceHigh3 == cDistanceLow3)) {
+                           // wow, we're at the center of the entire array AND the center of the outer
+                           // unsplittable ranges, AND the center of the splitable ranges.  Our final fallback
+                           // is to resort to our symmetric determination (PLUS randomness)
+
+                           bool bLocalSymmetryReversal = randomStream.Next() != bSymmetryReversal;
+                           iResult = UNPREDICTABLE(bLocalSymmetryReversal) ? iStartCur : iStartNext;
                         }
                      }
-                     pCut = aFeatureValues + iResult;
-                     EBM_ASSERT(aFeatureValues < pCut);
-                     *ppValueCutTop = pCut;
-                     ++ppValueCutTop;
                   }
+                  pCut = aFeatureValues + iResult;
+                  EBM_ASSERT(aFeatureValues < pCut);
+                  *ppValueCutTop = pCut;
+                  ++ppValueCutTop;
                }
-            } while(!priorityQueue.empty());
-         } catch(...) {
-            LOG_0(TraceLevelWarning, "WARNING GenerateQuantileBinCuts exception");
-
-            free(pMem);
-            free(aFeatureValues);
-
-            countBinCutsRet = IntEbmType { 0 };
-            ret = IntEbmType { 1 };
-            goto exit_with_log;
-         }
+            }
+         } while(apCuttingRangeFirst != ppCuttingRange);
 
          EBM_ASSERT(apValueCutTops <= ppValueCutTop);
          const size_t cBinCutsRet = ppValueCutTop - apValueCutTops;
@@ -3293,7 +3439,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
          EBM_ASSERT(countBinCutsRet <= countBinCuts);
 
          free(pMem);
-         free(aFeatureValues);
+         free(aFeatureValuesAllocated);
 
          ret = IntEbmType { 0 };
       }
@@ -3344,3 +3490,34 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQ
 
    return ret;
 }
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQuantileBinCuts(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+) {
+   return GenerateQuantileBinCutsInternal(
+      countSamples,
+      featureValues,
+      countSamplesPerBinMin,
+      isHumanized,
+      randomSeed,
+      countBinCutsInOut,
+      binCutsLowerBoundInclusiveOut,
+      countMissingValuesOut,
+      minNonInfinityValueOut,
+      countNegativeInfinityOut,
+      maxNonInfinityValueOut,
+      countPositiveInfinityOut,
+      nullptr
+   );
+}
@@ -108,9 +108,8 @@ INLINE_RELEASE_UNTEMPLATED static size_t DetermineBounds(
    return cSamplesWithoutMissing;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterGenerateUniformBinCutsParametersMessages = 25;
-static int g_cLogExitGenerateUniformBinCutsParametersMessages = 25;
+static std::atomic<int> g_cLogEnterGenerateUniformBinCutsParametersMessages { 25 };
+static std::atomic<int> g_cLogExitGenerateUniformBinCutsParametersMessages { 25 };
 
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION GenerateUniformBinCuts(
    IntEbmType countSamples,
@@ -21,16 +21,17 @@ extern size_t RemoveMissingValuesAndReplaceInfinities(
    IntEbmType * const pCountPositiveInfinityOut
 ) noexcept;
 
+extern void SortFeatureValues(const size_t cSamples, FloatEbmType * const aValues) noexcept;
+
 extern FloatEbmType ArithmeticMean(
    const FloatEbmType low,
    const FloatEbmType high
 ) noexcept;
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterGenerateWinsorizedBinCutsParametersMessages = 25;
-static int g_cLogExitGenerateWinsorizedBinCutsParametersMessages = 25;
+static std::atomic<int> g_cLogEnterGenerateWinsorizedBinCutsParametersMessages { 25 };
+static std::atomic<int> g_cLogExitGenerateWinsorizedBinCutsParametersMessages { 25 };
 
-EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateWinsorizedBinCuts(
+extern IntEbmType GenerateWinsorizedBinCutsInternal(
    IntEbmType countSamples,
    const FloatEbmType * featureValues,
    IntEbmType * countBinCutsInOut,
@@ -39,7 +40,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
    FloatEbmType * minNonInfinityValueOut,
    IntEbmType * countNegativeInfinityOut,
    FloatEbmType * maxNonInfinityValueOut,
-   IntEbmType * countPositiveInfinityOut
+   IntEbmType * countPositiveInfinityOut,
+   FloatEbmType * aFeatureValuesScratch
 ) {
    LOG_COUNTED_N(
       &g_cLogEnterGenerateWinsorizedBinCutsParametersMessages,
@@ -125,7 +127,11 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
 
          const size_t cSamplesIncludingMissingValues = static_cast<size_t>(countSamples);
 
-         FloatEbmType * const aFeatureValues = EbmMalloc<FloatEbmType>(cSamplesIncludingMissingValues);
+         // batched callers hand us a scratch buffer of countSamples items that they reuse between features
+         FloatEbmType * const aFeatureValuesAllocated = nullptr != aFeatureValuesScratch ? nullptr :
+            EbmMalloc<FloatEbmType>(cSamplesIncludingMissingValues);
+         FloatEbmType * const aFeatureValues = nullptr != aFeatureValuesScratch ? aFeatureValuesScratch :
+            aFeatureValuesAllocated;
          if(UNLIKELY(nullptr == aFeatureValues)) {
             LOG_0(TraceLevelError, "ERROR GenerateWinsorizedBinCuts nullptr == aFeatureValues");
 
@@ -167,7 +173,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
             const IntEbmType countBinCuts = *countBinCutsInOut;
 
             if(UNLIKELY(countBinCuts <= IntEbmType { 0 })) {
-               free(aFeatureValues);
+               free(aFeatureValuesAllocated);
                ret = IntEbmType { 0 };
                if(UNLIKELY(countBinCuts < IntEbmType { 0 })) {
                   LOG_0(TraceLevelError, "ERROR GenerateWinsorizedBinCuts countBinCuts can't be negative.");
@@ -178,7 +184,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
 
             if(UNLIKELY(!IsNumberConvertable<size_t>(countBinCuts))) {
                LOG_0(TraceLevelWarning, "WARNING GenerateWinsorizedBinCuts !IsNumberConvertable<size_t>(countBinCuts)");
-               free(aFeatureValues);
+               free(aFeatureValuesAllocated);
                ret = IntEbmType { 1 };
                goto exit_with_log;
             }
@@ -186,7 +192,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
 
             if(UNLIKELY(IsMultiplyError(sizeof(*binCutsLowerBoundInclusiveOut), cBinCuts))) {
                LOG_0(TraceLevelError, "ERROR GenerateWinsorizedBinCuts countBinCuts was too large to fit into binCutsLowerBoundInclusiveOut");
-               free(aFeatureValues);
+               free(aFeatureValuesAllocated);
                ret = IntEbmType { 1 };
                goto exit_with_log;
             }
@@ -194,7 +200,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
             if(UNLIKELY(nullptr == binCutsLowerBoundInclusiveOut)) {
                // if we have a potential bin cut, then binCutsLowerBoundInclusiveOut shouldn't be nullptr
                LOG_0(TraceLevelError, "ERROR GenerateWinsorizedBinCuts nullptr == binCutsLowerBoundInclusiveOut");
-               free(aFeatureValues);
+               free(aFeatureValuesAllocated);
                ret = IntEbmType { 1 };
                goto exit_with_log;
             }
@@ -205,7 +211,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
             // uniform we just need to find a single cut between values and we can divide the space up between
             // uniform bins between those values.
 
-            std::sort(aFeatureValues, aFeatureValues + cSamples);
+            SortFeatureValues(cSamples, aFeatureValues);
 
             if(UNLIKELY(size_t { 1 } == cBinCuts)) {
                // if we're only given 1 cut, then we need do so something special since we can't have an upper and
@@ -480,7 +486,7 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
                }
             }
          }
-         free(aFeatureValues);
+         free(aFeatureValuesAllocated);
          ret = IntEbmType { 0 };
       }
 
@@ -530,3 +536,28 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateW
 
    return ret;
 }
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateWinsorizedBinCuts(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+) {
+   return GenerateWinsorizedBinCutsInternal(
+      countSamples,
+      featureValues,
+      countBinCutsInOut,
+      binCutsLowerBoundInclusiveOut,
+      countMissingValuesOut,
+      minNonInfinityValueOut,
+      countNegativeInfinityOut,
+      maxNonInfinityValueOut,
+      countPositiveInfinityOut,
+      nullptr
+   );
+}
@@ -6,7 +6,9 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
 #include <limits> // numeric_limits
+#include <chrono> // steady_clock
 
 #include "ebm_native.h"
 #include "EbmInternal.h"
@@ -20,10 +22,17 @@
 // FeatureGroup.h depends on FeatureInternal.h
 #include "FeatureGroup.h"
 // dataset depends on features
+#include "PackedData.h"
+#include "PackedDataBuilder.h"
+#include "ModelFile.h"
 #include "DataSetBoosting.h"
 // samples is somewhat independent from datasets, but relies on an indirect coupling with them
+#include "SampleDeduplication.h"
 #include "SamplingSet.h"
+#include "HistogramBucket.h"
+#include "TreeNode.h"
 #include "TreeSweep.h"
+#include "ThreadPool.h"
 
 #include "Booster.h"
 
@@ -35,11 +44,14 @@ extern void InitializeResiduals(
    FloatEbmType * const aTempFloatVector,
    FloatEbmType * pResidualError
 );
-
-INLINE_ALWAYS static size_t GetCountItemsBitPacked(const size_t cBits) {
-   EBM_ASSERT(size_t { 1 } <= cBits);
-   return k_cBitsForStorageType / cBits;
-}
+extern void InitializeResiduals(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   float * pResidualError
+);
 
 void EbmBoostingState::DeleteSegmentedTensors(const size_t cFeatureGroups, SegmentedTensor ** const apSegmentedTensors) {
    LOG_0(TraceLevelInfo, "Entered DeleteSegmentedTensors");
@@ -128,7 +140,13 @@ void EbmBoostingState::Free(EbmBoostingState * const pBoostingState) {
       pBoostingState->m_trainingSet.Destruct();
       pBoostingState->m_validationSet.Destruct();
 
-      CachedBoostingThreadResources::Free(pBoostingState->m_pCachedThreadResources);
+      if(nullptr != pBoostingState->m_apCachedThreadResources) {
+         const size_t cCachedThreadResources = pBoostingState->m_cSlots * pBoostingState->m_cCachedThreadResourcesPerSlot;
+         for(size_t iCachedThreadResources = 0; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+            CachedBoostingThreadResources::Free(pBoostingState->m_apCachedThreadResources[iCachedThreadResources]);
+         }
+         free(pBoostingState->m_apCachedThreadResources);
+      }
 
       SamplingSet::FreeSamplingSets(pBoostingState->m_cSamplingSets, pBoostingState->m_apSamplingSets);
 
@@ -138,14 +156,114 @@ void EbmBoostingState::Free(EbmBoostingState * const pBoostingState) {
 
       DeleteSegmentedTensors(pBoostingState->m_cFeatureGroups, pBoostingState->m_apCurrentModel);
       DeleteSegmentedTensors(pBoostingState->m_cFeatureGroups, pBoostingState->m_apBestModel);
-      SegmentedTensor::Free(pBoostingState->m_pSmallChangeToModelOverwriteSingleSamplingSet);
-      SegmentedTensor::Free(pBoostingState->m_pSmallChangeToModelAccumulatedFromSamplingSets);
+      free(pBoostingState->m_aiChangedFeatureGroups);
+      free(pBoostingState->m_abChangedFeatureGroup);
+      DeleteSegmentedTensors(pBoostingState->m_cFeatureGroups, pBoostingState->m_apPendingValidationUpdates);
+      free(pBoostingState->m_aiPendingFeatureGroups);
+      free(pBoostingState->m_abPendingFeatureGroup);
+      free(pBoostingState->m_aScheduleGains);
+      free(pBoostingState->m_acScheduleRoundsSkipped);
+      if(nullptr != pBoostingState->m_apSmallChangeToModelAccumulatedFromSamplingSets) {
+         for(size_t iSlot = 0; iSlot < pBoostingState->m_cSlots; ++iSlot) {
+            SegmentedTensor::Free(pBoostingState->m_apSmallChangeToModelAccumulatedFromSamplingSets[iSlot]);
+         }
+         free(pBoostingState->m_apSmallChangeToModelAccumulatedFromSamplingSets);
+      }
+#ifdef EBM_PERFORMANCE_COUNTERS
+      free(pBoostingState->m_aPerformanceCounters);
+#endif // EBM_PERFORMANCE_COUNTERS
 
       free(pBoostingState);
    }
    LOG_0(TraceLevelInfo, "Exited EbmBoostingState::Free");
 }
 
+void EbmBoostingState::ClearChangedFeatureGroups() {
+   while(0 != m_cChangedFeatureGroups) {
+      --m_cChangedFeatureGroups;
+      m_abChangedFeatureGroup[m_aiChangedFeatureGroups[m_cChangedFeatureGroups]] = false;
+   }
+}
+
+bool EbmBoostingState::CopyChangedToBestModel() {
+   EBM_ASSERT(nullptr != m_apCurrentModel);
+   EBM_ASSERT(nullptr != m_apBestModel);
+
+   // on error we keep the remaining feature groups in the list, so the next improvement tries them again
+   while(0 != m_cChangedFeatureGroups) {
+      const size_t iFeatureGroup = m_aiChangedFeatureGroups[m_cChangedFeatureGroups - 1];
+      EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+      if(m_apBestModel[iFeatureGroup]->Copy(*m_apCurrentModel[iFeatureGroup])) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::CopyChangedToBestModel m_apBestModel[iFeatureGroup]->Copy");
+         return true;
+      }
+      m_abChangedFeatureGroup[iFeatureGroup] = false;
+      --m_cChangedFeatureGroups;
+   }
+   return false;
+}
+
+FloatEbmType EbmBoostingState::GetScheduleGainThreshold() const {
+   EBM_ASSERT(IsBoostingScheduled());
+
+   FloatEbmType gainMax = FloatEbmType { 0 };
+   for(size_t iFeatureGroup = 0; iFeatureGroup < m_cFeatureGroups; ++iFeatureGroup) {
+      gainMax = gainMax < m_aScheduleGains[iFeatureGroup] ? m_aScheduleGains[iFeatureGroup] : gainMax;
+   }
+   // m_scheduleGainFraction is at most 1, so the group with the largest gain is always boosted
+   return m_scheduleGainFraction * gainMax;
+}
+
+void EbmBoostingState::AddPendingValidationUpdate(
+   const size_t iFeatureGroup, 
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor
+) {
+   EBM_ASSERT(m_bDeferValidation);
+   EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+   EBM_ASSERT(nullptr != aModelFeatureGroupUpdateTensor);
+
+   const FeatureGroup * const pFeatureGroup = m_apFeatureGroups[iFeatureGroup];
+   size_t cValues = GetVectorLength(m_runtimeLearningTypeOrCountTargetClasses);
+   for(size_t iDimension = 0; iDimension < pFeatureGroup->GetCountFeatures(); ++iDimension) {
+      // our models have this many values already, so this can't overflow
+      cValues *= pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+   }
+
+   FloatEbmType * const aPendingValues = m_apPendingValidationUpdates[iFeatureGroup]->GetValuePointer();
+   if(m_abPendingFeatureGroup[iFeatureGroup]) {
+      for(size_t iValue = 0; iValue < cValues; ++iValue) {
+         aPendingValues[iValue] += aModelFeatureGroupUpdateTensor[iValue];
+      }
+   } else {
+      memcpy(aPendingValues, aModelFeatureGroupUpdateTensor, sizeof(*aPendingValues) * cValues);
+      m_abPendingFeatureGroup[iFeatureGroup] = true;
+      EBM_ASSERT(m_cPendingFeatureGroups < m_cFeatureGroups);
+      m_aiPendingFeatureGroups[m_cPendingFeatureGroups] = iFeatureGroup;
+      ++m_cPendingFeatureGroups;
+   }
+}
+
+void EbmBoostingState::ClearPendingValidationUpdates() {
+   while(0 != m_cPendingFeatureGroups) {
+      --m_cPendingFeatureGroups;
+      m_abPendingFeatureGroup[m_aiPendingFeatureGroups[m_cPendingFeatureGroups]] = false;
+   }
+}
+
+// the number of distinct samples in each bag when we sample fractionIncluded of the training samples without 
+// replacement, or 0 if fractionIncluded is 0 and we sample with replacement.  With a sample mask we only draw from the 
+// samples that belong to our training set, and a sample with weight w counts as w samples
+static size_t GetCountSamplesIncluded(const FloatEbmType fractionIncluded, const size_t cTrainingSamplesIncluded) {
+   if(FloatEbmType { 0 } == fractionIncluded) {
+      return 0;
+   }
+   size_t cSamplesIncluded = static_cast<size_t>(fractionIncluded * static_cast<FloatEbmType>(cTrainingSamplesIncluded));
+   // we need at least 1 sample in each bag, and rounding can't take us above cTrainingSamplesIncluded, but be safe
+   cSamplesIncluded = 0 == cSamplesIncluded ? size_t { 1 } : cSamplesIncluded;
+   cSamplesIncluded = cTrainingSamplesIncluded < cSamplesIncluded ? cTrainingSamplesIncluded : cSamplesIncluded;
+   return cSamplesIncluded;
+}
+
 EbmBoostingState * EbmBoostingState::Allocate(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
    const size_t cFeatures,
@@ -158,16 +276,21 @@ EbmBoostingState * EbmBoostingState::Allocate(
    const size_t cTrainingSamples, 
    const void * const aTrainingTargets, 
    const IntEbmType * const aTrainingBinnedData, 
+   PackedData * const pTrainingPackedData, 
+   const IntEbmType * const aTrainingSampleMask, 
    const FloatEbmType * const aTrainingPredictorScores, 
+   const IntEbmType * const aTrainingWeights, 
    const size_t cValidationSamples, 
    const void * const aValidationTargets, 
    const IntEbmType * const aValidationBinnedData, 
+   PackedData * const pValidationPackedData, 
+   const IntEbmType * const aValidationSampleMask, 
    const FloatEbmType * const aValidationPredictorScores,
+   const IntEbmType * const aValidationWeights,
    const IntEbmType randomSeed
 ) {
    // optionalTempParams isn't used by default.  It's meant to provide an easy way for python or other higher
    // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.
-   UNUSED(optionalTempParams);
 
    LOG_0(TraceLevelInfo, "Entered EbmBoostingState::Initialize");
 
@@ -178,23 +301,124 @@ EbmBoostingState * EbmBoostingState::Allocate(
    }
    pBooster->InitializeZero();
 
-   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-
-   pBooster->m_pSmallChangeToModelOverwriteSingleSamplingSet = 
-      SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
-   if(UNLIKELY(nullptr == pBooster->m_pSmallChangeToModelOverwriteSingleSamplingSet)) {
-      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_pSmallChangeToModelOverwriteSingleSamplingSet");
+#ifdef EBM_PERFORMANCE_COUNTERS
+   PerformanceCounterValues * const aPerformanceCounters = EbmMalloc<PerformanceCounterValues>(k_cPerformanceCounters);
+   if(UNLIKELY(nullptr == aPerformanceCounters)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == aPerformanceCounters");
       EbmBoostingState::Free(pBooster);
       return nullptr;
    }
+   for(size_t iPerformanceCounter = 0; iPerformanceCounter < k_cPerformanceCounters; ++iPerformanceCounter) {
+      aPerformanceCounters[iPerformanceCounter].m_cCalls.store(0, std::memory_order_relaxed);
+      aPerformanceCounters[iPerformanceCounter].m_cNanoseconds.store(0, std::memory_order_relaxed);
+      aPerformanceCounters[iPerformanceCounter].m_cBytesScanned.store(0, std::memory_order_relaxed);
+   }
+   pBooster->m_aPerformanceCounters = aPerformanceCounters;
+#endif // EBM_PERFORMANCE_COUNTERS
+
+   const FloatEbmType countShards = GetTempParam(optionalTempParams, TempParamBoostingCountShards, FloatEbmType { 1 });
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 1 } <= countShards)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize countShards must be 1 or more.  Using 1 shard");
+   } else if(static_cast<FloatEbmType>(k_cBoostingShardsMax) <= countShards) {
+      pBooster->m_cShards = k_cBoostingShardsMax;
+   } else {
+      pBooster->m_cShards = static_cast<size_t>(countShards);
+   }
+
+   const FloatEbmType countPairCutsPerTask = GetTempParam(
+      optionalTempParams,
+      TempParamBoostingPairCutsPerTask,
+      static_cast<FloatEbmType>(k_cPairCutsPerTaskDefault)
+   );
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 1 } <= countPairCutsPerTask)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize countPairCutsPerTask must be 1 or more.  Using the default");
+   } else if(static_cast<FloatEbmType>(std::numeric_limits<size_t>::max()) <= countPairCutsPerTask) {
+      pBooster->m_cPairCutsPerTask = std::numeric_limits<size_t>::max();
+   } else {
+      pBooster->m_cPairCutsPerTask = static_cast<size_t>(countPairCutsPerTask);
+   }
+
+   const FloatEbmType scheduleGainFraction = GetTempParam(
+      optionalTempParams,
+      TempParamBoostingScheduleGainFraction,
+      FloatEbmType { 0 }
+   );
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 0 } <= scheduleGainFraction && scheduleGainFraction <= FloatEbmType { 1 })) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize scheduleGainFraction must be from 0 to 1.  Boosting every feature group");
+   } else {
+      pBooster->m_scheduleGainFraction = scheduleGainFraction;
+   }
+
+   const FloatEbmType countScheduleReprobeRounds = GetTempParam(
+      optionalTempParams,
+      TempParamBoostingScheduleReprobeRounds,
+      static_cast<FloatEbmType>(k_cScheduleReprobeRoundsDefault)
+   );
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 1 } <= countScheduleReprobeRounds)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize countScheduleReprobeRounds must be 1 or more.  Using the default");
+   } else if(static_cast<FloatEbmType>(std::numeric_limits<size_t>::max()) <= countScheduleReprobeRounds) {
+      pBooster->m_cScheduleReprobeRounds = std::numeric_limits<size_t>::max();
+   } else {
+      pBooster->m_cScheduleReprobeRounds = static_cast<size_t>(countScheduleReprobeRounds);
+   }
+
+   const FloatEbmType simd = GetTempParam(optionalTempParams, TempParamBoostingSimd, FloatEbmType { 0 });
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 0 } <= simd)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize simd must be 0 or more.  Not using SIMD");
+   } else if(FloatEbmType { 1 } <= simd && SimdKernels::IsSupported(runtimeLearningTypeOrCountTargetClasses)) {
+      const SimdInstructionSet maxInstructionSet = FloatEbmType { 2 } <= simd ? SimdInstructionSet::Avx512 : SimdInstructionSet::Avx2;
+      // this stays nullptr if the CPU doesn't support any of the allowed instruction sets
+      pBooster->m_pSimdKernels = SimdKernels::GetBestAvailable(maxInstructionSet);
+   }
+
+   FloatEbmType alignedPackingGrowthMax = GetTempParam(optionalTempParams, TempParamBoostingAlignedPacking, FloatEbmType { 0 });
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 0 } <= alignedPackingGrowthMax)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize alignedPacking must be 0 or more.  Not aligning the bit packing");
+      alignedPackingGrowthMax = FloatEbmType { 0 };
+   }
+   // packed data was bit packed when it was created, so the feature groups need to take their packing from it
+   const PackedData * const pPackedDataLayout = nullptr != pTrainingPackedData ? pTrainingPackedData : pValidationPackedData;
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   size_t cSlots = 1;
+   const FloatEbmType countSlots = GetTempParam(optionalTempParams, TempParamBoostingConcurrentSlots, FloatEbmType { 1 });
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 1 } <= countSlots)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize countSlots must be 1 or more.  Using 1 slot");
+   } else if(static_cast<FloatEbmType>(k_cBoostingSlotsMax) <= countSlots) {
+      cSlots = k_cBoostingSlotsMax;
+   } else {
+      cSlots = static_cast<size_t>(countSlots);
+   }
 
-   pBooster->m_pSmallChangeToModelAccumulatedFromSamplingSets = 
-      SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
-   if(UNLIKELY(nullptr == pBooster->m_pSmallChangeToModelAccumulatedFromSamplingSets)) {
-      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_pSmallChangeToModelAccumulatedFromSamplingSets");
+   pBooster->m_apSmallChangeToModelAccumulatedFromSamplingSets = EbmMalloc<SegmentedTensor *>(cSlots);
+   if(UNLIKELY(nullptr == pBooster->m_apSmallChangeToModelAccumulatedFromSamplingSets)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_apSmallChangeToModelAccumulatedFromSamplingSets");
       EbmBoostingState::Free(pBooster);
       return nullptr;
    }
+   for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+      // set these to nullptr first so that we can free a partially allocated array
+      pBooster->m_apSmallChangeToModelAccumulatedFromSamplingSets[iSlot] = nullptr;
+   }
+   pBooster->m_cSlots = cSlots;
+   for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+      SegmentedTensor * const pSmallChangeToModelAccumulatedFromSamplingSets = 
+         SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
+      if(UNLIKELY(nullptr == pSmallChangeToModelAccumulatedFromSamplingSets)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == pSmallChangeToModelAccumulatedFromSamplingSets");
+         EbmBoostingState::Free(pBooster);
+         return nullptr;
+      }
+      pBooster->m_apSmallChangeToModelAccumulatedFromSamplingSets[iSlot] = pSmallChangeToModelAccumulatedFromSamplingSets;
+   }
 
    LOG_0(TraceLevelInfo, "EbmBoostingState::Initialize starting feature processing");
    if(0 != cFeatures) {
@@ -258,9 +482,6 @@ EbmBoostingState * EbmBoostingState::Allocate(
 
          pBooster->m_aFeatures[iFeatureInitialize].Initialize(cBins, iFeatureInitialize, featureType, bMissing);
 
-         EBM_ASSERT(EBM_FALSE == pFeatureInitialize->hasMissing); // TODO : implement this, then remove this assert
-         EBM_ASSERT(FeatureTypeOrdinal == pFeatureInitialize->featureType); // TODO : implement this, then remove this assert
-
          ++iFeatureInitialize;
          ++pFeatureInitialize;
       } while(pFeatureEnd != pFeatureInitialize);
@@ -269,6 +490,11 @@ EbmBoostingState * EbmBoostingState::Allocate(
 
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    size_t cBytesArrayEquivalentSplitMax = 0;
+   // the worst case scratch space that boosting any of our feature groups needs, so that our thread resources never grow
+   size_t cBytesThreadByteBuffer1Max = 0;
+   size_t cBytesThreadByteBuffer2Max = 0;
+   size_t cBytesShardHistogramBufferMax = 0;
+   size_t cBytesTreeNodeHeapMax = 0;
 
    EBM_ASSERT(nullptr == pBooster->m_apCurrentModel);
    EBM_ASSERT(nullptr == pBooster->m_apBestModel);
@@ -290,6 +516,24 @@ EbmBoostingState * EbmBoostingState::Allocate(
       }
       size_t cBytesPerSweepTreeNode = GetSweepTreeNodeSize(bClassification, cVectorLength);
 
+      if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize GetHistogramBucketSizeOverflow(bClassification, cVectorLength)");
+         EbmBoostingState::Free(pBooster);
+         return nullptr;
+      }
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      if(GetTreeNodeSizeOverflow(bClassification, cVectorLength)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize GetTreeNodeSizeOverflow(bClassification, cVectorLength)");
+         EbmBoostingState::Free(pBooster);
+         return nullptr;
+      }
+      const size_t cBytesPerTreeNode = GetTreeNodeSize(bClassification, cVectorLength);
+      const size_t cBytesPerTreeNodePointer = bClassification ? sizeof(TreeNode<true> *) : sizeof(TreeNode<false> *);
+
+      // zero dimensional feature groups bin into a single bucket
+      cBytesThreadByteBuffer1Max = cBytesPerHistogramBucket;
+      size_t cHistogramBucketsMax = 1;
+
       const IntEbmType * pFeatureGroupIndex = featureGroupIndexes;
       size_t iFeatureGroup = 0;
       do {
@@ -375,6 +619,7 @@ EbmBoostingState * EbmBoostingState::Allocate(
             EBM_ASSERT(nullptr != featureGroupIndexes);
             size_t cEquivalentSplits = 1;
             size_t cTensorBins = 1;
+            size_t cAuxillaryBucketsForBuildFastTotals = 0;
             FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
             do {
                const IntEbmType indexFeatureInterop = *pFeatureGroupIndex;
@@ -395,6 +640,9 @@ EbmBoostingState * EbmBoostingState::Allocate(
                      EbmBoostingState::Free(pBooster);
                      return nullptr;
                   }
+                  // this is the same auxillary space that BoostMultiDimensional reserves.  Since cBins is 2 or more, it grows slower 
+                  // than cTensorBins, which we just checked for overflow
+                  cAuxillaryBucketsForBuildFastTotals += cTensorBins;
                   cTensorBins *= cBins;
                   cEquivalentSplits *= cBins - 1; // we can only split between the bins
                }
@@ -419,16 +667,119 @@ EbmBoostingState * EbmBoostingState::Allocate(
                cBytesArrayEquivalentSplitMax = cBytesArrayEquivalentSplit;
             }
 
+            size_t cHistogramBuckets = cTensorBins;
+            if(1 == cSignificantFeaturesInGroup) {
+               // GrowDecisionTree needs at most 2 * cTensorBins - 1 TreeNodes, and its heap never holds more than cTensorBins nodes
+               if(IsMultiplyError(cTensorBins, size_t { 2 }) || IsMultiplyError(cBytesPerTreeNode, (cTensorBins << 1) - 1)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cBytesPerTreeNode, (cTensorBins << 1) - 1)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               const size_t cBytesTreeNodes = cBytesPerTreeNode * ((cTensorBins << 1) - 1);
+               if(cBytesThreadByteBuffer2Max < cBytesTreeNodes) {
+                  cBytesThreadByteBuffer2Max = cBytesTreeNodes;
+               }
+               if(IsMultiplyError(cBytesPerTreeNodePointer, cTensorBins)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cBytesPerTreeNodePointer, cTensorBins)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               const size_t cBytesTreeNodeHeap = cBytesPerTreeNodePointer * cTensorBins;
+               if(cBytesTreeNodeHeapMax < cBytesTreeNodeHeap) {
+                  cBytesTreeNodeHeapMax = cBytesTreeNodeHeap;
+               }
+            } else {
+               // we need to reserve 4 PAST the pointer we pass into SweepMultiDiemensional, which is the same as BoostMultiDimensional
+               const size_t cAuxillaryBucketsForSplitting = 24;
+               const size_t cAuxillaryBuckets = cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ? 
+                  cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals;
+               if(IsAddError(cHistogramBuckets, cAuxillaryBuckets)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsAddError(cHistogramBuckets, cAuxillaryBuckets)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               cHistogramBuckets += cAuxillaryBuckets;
+            }
+            if(IsMultiplyError(cHistogramBuckets, cBytesPerHistogramBucket)) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cHistogramBuckets, cBytesPerHistogramBucket)");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            size_t cBytesHistogramBuckets = cHistogramBuckets * cBytesPerHistogramBucket;
+            if(1 == cSignificantFeaturesInGroup &&
+               FeatureType::Nominal == pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetFeatureType()) {
+               // GrowDecisionTree reorders nominal buckets by their residuals after the original buckets
+               if(GetNominalBucketScratchSizeOverflow(cBytesPerHistogramBucket, cVectorLength)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize GetNominalBucketScratchSizeOverflow(cBytesPerHistogramBucket, cVectorLength)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               const size_t cBytesPerNominalBucket = GetNominalBucketScratchSize(cBytesPerHistogramBucket, cVectorLength);
+               if(IsMultiplyError(cTensorBins, cBytesPerNominalBucket)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cTensorBins, cBytesPerNominalBucket)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               const size_t cBytesNominal = cTensorBins * cBytesPerNominalBucket;
+               if(IsAddError(cBytesHistogramBuckets, cBytesNominal)) {
+                  LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsAddError(cBytesHistogramBuckets, cBytesNominal)");
+                  EbmBoostingState::Free(pBooster);
+                  return nullptr;
+               }
+               cBytesHistogramBuckets += cBytesNominal;
+            }
+            if(cBytesThreadByteBuffer1Max < cBytesHistogramBuckets) {
+               cBytesThreadByteBuffer1Max = cBytesHistogramBuckets;
+            }
+            if(cHistogramBucketsMax < cTensorBins) {
+               cHistogramBucketsMax = cTensorBins;
+            }
+
             // if cSignificantFeaturesInGroup is zero, don't both initializing pFeatureGroup->GetCountItemsPerBitPackedDataUnit()
             const size_t cBitsRequiredMin = CountBitsRequired(cTensorBins - 1);
             EBM_ASSERT(1 <= cBitsRequiredMin); // 1 < cTensorBins otherwise we'd have filtered it out above
-            pFeatureGroup->SetCountItemsPerBitPackedDataUnit(GetCountItemsBitPacked(cBitsRequiredMin));
+            size_t cItemsPerBitPackedDataUnit = GetCountItemsBitPacked(cBitsRequiredMin);
+            if(nullptr != pPackedDataLayout) {
+               // PackedData::IsValid only checked the packing against the bins in the file.  If those bins don't
+               // match ours then we keep our own packing and PackedData::IsMismatched reports the difference later
+               if(iFeatureGroup < pPackedDataLayout->GetCountFeatureGroups()) {
+                  const uint64_t cItemsPacked = pPackedDataLayout->GetCountItemsPerBitPackedDataUnit(iFeatureGroup);
+                  if(0 != cItemsPacked && cItemsPacked <= static_cast<uint64_t>(cItemsPerBitPackedDataUnit)) {
+                     cItemsPerBitPackedDataUnit = static_cast<size_t>(cItemsPacked);
+                  }
+               }
+            } else if(FloatEbmType { 0 } != alignedPackingGrowthMax) {
+               // rounding the items up to 4, 8, 16 or 32 bits keeps the shifts in unpacking on nibble or byte 
+               // boundaries, but it only pays while the extra data units don't cost more memory bandwidth than we save
+               const size_t cItemsAligned = GetCountItemsBitPackedAligned(cBitsRequiredMin);
+               EBM_ASSERT(1 <= cItemsAligned);
+               EBM_ASSERT(cItemsAligned <= cItemsPerBitPackedDataUnit);
+               if(static_cast<FloatEbmType>(cItemsPerBitPackedDataUnit) <= 
+                  alignedPackingGrowthMax * static_cast<FloatEbmType>(cItemsAligned)
+               ) {
+                  cItemsPerBitPackedDataUnit = cItemsAligned;
+               }
+            }
+            pFeatureGroup->SetCountItemsPerBitPackedDataUnit(cItemsPerBitPackedDataUnit);
          }
          pFeatureGroupIndex = pFeatureGroupIndexEnd;
 
          ++iFeatureGroup;
       } while(iFeatureGroup < cFeatureGroups);
 
+      const size_t cShards = pBooster->m_cShards;
+      if(size_t { 1 } < cShards) {
+         // BinBoosting gives every shard beyond the first a private copy of the main histogram.  We checked the main 
+         // histogram for overflow above, and if the copies overflow then BinBoosting falls back to a single shard
+         EBM_ASSERT(!IsMultiplyError(cHistogramBucketsMax, cBytesPerHistogramBucket));
+         const size_t cBytesPerHistogram = cHistogramBucketsMax * cBytesPerHistogramBucket;
+         if(IsMultiplyError(cBytesPerHistogram, cShards - 1)) {
+            LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cBytesPerHistogram, cShards - 1)");
+         } else {
+            cBytesShardHistogramBufferMax = cBytesPerHistogram * (cShards - 1);
+         }
+      }
+
       if(!bClassification || ptrdiff_t { 2 } <= runtimeLearningTypeOrCountTargetClasses) {
          pBooster->m_apCurrentModel = InitializeSegmentedTensors(cFeatureGroups, pBooster->m_apFeatureGroups, cVectorLength);
          if(nullptr == pBooster->m_apCurrentModel) {
@@ -442,31 +793,133 @@ EbmBoostingState * EbmBoostingState::Allocate(
             EbmBoostingState::Free(pBooster);
             return nullptr;
          }
+         pBooster->m_aiChangedFeatureGroups = EbmMalloc<size_t>(cFeatureGroups);
+         if(nullptr == pBooster->m_aiChangedFeatureGroups) {
+            LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_aiChangedFeatureGroups");
+            EbmBoostingState::Free(pBooster);
+            return nullptr;
+         }
+         pBooster->m_abChangedFeatureGroup = EbmMalloc<bool>(cFeatureGroups);
+         if(nullptr == pBooster->m_abChangedFeatureGroup) {
+            LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_abChangedFeatureGroup");
+            EbmBoostingState::Free(pBooster);
+            return nullptr;
+         }
+         // both models start at zero, so nothing has changed yet
+         for(size_t iFeatureGroupChanged = 0; iFeatureGroupChanged < cFeatureGroups; ++iFeatureGroupChanged) {
+            pBooster->m_abChangedFeatureGroup[iFeatureGroupChanged] = false;
+         }
+
+         if(FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingDeferValidation, FloatEbmType { 0 })) {
+            pBooster->m_apPendingValidationUpdates = 
+               InitializeSegmentedTensors(cFeatureGroups, pBooster->m_apFeatureGroups, cVectorLength);
+            if(nullptr == pBooster->m_apPendingValidationUpdates) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_apPendingValidationUpdates");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            pBooster->m_aiPendingFeatureGroups = EbmMalloc<size_t>(cFeatureGroups);
+            if(nullptr == pBooster->m_aiPendingFeatureGroups) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_aiPendingFeatureGroups");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            pBooster->m_abPendingFeatureGroup = EbmMalloc<bool>(cFeatureGroups);
+            if(nullptr == pBooster->m_abPendingFeatureGroup) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_abPendingFeatureGroup");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            for(size_t iFeatureGroupPending = 0; iFeatureGroupPending < cFeatureGroups; ++iFeatureGroupPending) {
+               pBooster->m_abPendingFeatureGroup[iFeatureGroupPending] = false;
+            }
+            pBooster->m_bDeferValidation = true;
+         }
+
+         if(FloatEbmType { 0 } != pBooster->m_scheduleGainFraction) {
+            pBooster->m_aScheduleGains = EbmMalloc<FloatEbmType>(cFeatureGroups);
+            if(nullptr == pBooster->m_aScheduleGains) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_aScheduleGains");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            pBooster->m_acScheduleRoundsSkipped = EbmMalloc<size_t>(cFeatureGroups);
+            if(nullptr == pBooster->m_acScheduleRoundsSkipped) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_acScheduleRoundsSkipped");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+            // no group has a gain yet, so every group is due on the first round
+            for(size_t iFeatureGroupScheduled = 0; iFeatureGroupScheduled < cFeatureGroups; ++iFeatureGroupScheduled) {
+               pBooster->m_aScheduleGains[iFeatureGroupScheduled] = FloatEbmType { 0 };
+               pBooster->m_acScheduleRoundsSkipped[iFeatureGroupScheduled] = pBooster->m_cScheduleReprobeRounds;
+            }
+         }
       }
    }
    LOG_0(TraceLevelInfo, "EbmBoostingState::Initialize finished feature group processing");
 
-   pBooster->m_pCachedThreadResources = CachedBoostingThreadResources::Allocate(
-      runtimeLearningTypeOrCountTargetClasses,
-      cBytesArrayEquivalentSplitMax
-   );
-   if(UNLIKELY(nullptr == pBooster->m_pCachedThreadResources)) {
-      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_pCachedThreadResources");
+   const size_t cCachedThreadResourcesPerSlot = size_t { 0 } == cSamplingSets ? size_t { 1 } : cSamplingSets;
+   // cSamplingSets is an IntEbmType that we checked converts to size_t, and cSlots is small, but be safe
+   if(UNLIKELY(IsMultiplyError(cCachedThreadResourcesPerSlot, cSlots))) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize IsMultiplyError(cCachedThreadResourcesPerSlot, cSlots)");
+      EbmBoostingState::Free(pBooster);
+      return nullptr;
+   }
+   const size_t cCachedThreadResources = cCachedThreadResourcesPerSlot * cSlots;
+   pBooster->m_apCachedThreadResources = EbmMalloc<CachedBoostingThreadResources *>(cCachedThreadResources);
+   if(UNLIKELY(nullptr == pBooster->m_apCachedThreadResources)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_apCachedThreadResources");
       EbmBoostingState::Free(pBooster);
       return nullptr;
    }
+   for(size_t iCachedThreadResources = 0; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+      // set these to nullptr first so that we can free a partially allocated array
+      pBooster->m_apCachedThreadResources[iCachedThreadResources] = nullptr;
+   }
+   pBooster->m_cCachedThreadResourcesPerSlot = cCachedThreadResourcesPerSlot;
+   for(size_t iCachedThreadResources = 0; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+      CachedBoostingThreadResources * const pCachedThreadResources = CachedBoostingThreadResources::Allocate(
+         runtimeLearningTypeOrCountTargetClasses,
+         cBytesArrayEquivalentSplitMax,
+         cBytesThreadByteBuffer1Max,
+         cBytesThreadByteBuffer2Max,
+         cBytesShardHistogramBufferMax,
+         cBytesTreeNodeHeapMax
+      );
+      if(UNLIKELY(nullptr == pCachedThreadResources)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == pCachedThreadResources");
+         EbmBoostingState::Free(pBooster);
+         return nullptr;
+      }
+      pBooster->m_apCachedThreadResources[iCachedThreadResources] = pCachedThreadResources;
+   }
+
+   // regression has no denominators, so there is nothing to cache
+   const bool bCacheDenominators = bClassification && 
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingCacheDenominators, FloatEbmType { 0 });
+   // only the training set is boosted often enough for its bandwidth to matter, and keeping the validation set in 
+   // FloatEbmType keeps our metric and early stopping decisions precise
+   const bool bTrainingFloat32 = 
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingSinglePrecision, FloatEbmType { 0 });
 
    if(pBooster->m_trainingSet.Initialize(
       true, 
+      bCacheDenominators, 
       bClassification, 
       bClassification, 
+      bTrainingFloat32, 
       cFeatureGroups, 
       pBooster->m_apFeatureGroups,
       cTrainingSamples, 
       aTrainingBinnedData, 
+      nullptr, 
       aTrainingTargets, 
       aTrainingPredictorScores, 
-      runtimeLearningTypeOrCountTargetClasses
+      runtimeLearningTypeOrCountTargetClasses,
+      pTrainingPackedData,
+      aTrainingSampleMask,
+      aTrainingWeights
    )) {
       LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize m_trainingSet.Initialize");
       EbmBoostingState::Free(pBooster);
@@ -475,15 +928,21 @@ EbmBoostingState * EbmBoostingState::Allocate(
 
    if(pBooster->m_validationSet.Initialize(
       !bClassification, 
+      false, 
       bClassification, 
       bClassification, 
+      false, 
       cFeatureGroups, 
       pBooster->m_apFeatureGroups,
       cValidationSamples, 
       aValidationBinnedData, 
+      nullptr, 
       aValidationTargets, 
       aValidationPredictorScores, 
-      runtimeLearningTypeOrCountTargetClasses
+      runtimeLearningTypeOrCountTargetClasses,
+      pValidationPackedData,
+      aValidationSampleMask,
+      aValidationWeights
    )) {
       LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize m_validationSet.Initialize");
       EbmBoostingState::Free(pBooster);
@@ -495,7 +954,28 @@ EbmBoostingState * EbmBoostingState::Allocate(
    EBM_ASSERT(nullptr == pBooster->m_apSamplingSets);
    if(0 != cTrainingSamples) {
       pBooster->m_cSamplingSets = cSamplingSets;
-      pBooster->m_apSamplingSets = SamplingSet::GenerateSamplingSets(&pBooster->m_randomStream, &pBooster->m_trainingSet, cSamplingSets);
+      const FloatEbmType fractionIncluded = 
+         GetTempParam(optionalTempParams, TempParamBoostingFractionWithoutReplacement, FloatEbmType { 0 });
+      if(FloatEbmType { 0 } != fractionIncluded) {
+         // the negated comparison also catches NaN
+         if(!(FloatEbmType { 0 } < fractionIncluded && fractionIncluded <= FloatEbmType { 1 })) {
+            LOG_0(TraceLevelWarning, 
+               "WARNING EbmBoostingState::Initialize fractionIncluded must be in (0, 1].  Sampling with replacement");
+         } else {
+            pBooster->m_fractionIncluded = fractionIncluded;
+         }
+      }
+      pBooster->m_bBlockDraws = 
+         FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingBlockDraws, FloatEbmType { 0 });
+      const size_t cSamplesIncluded = 
+         GetCountSamplesIncluded(pBooster->m_fractionIncluded, pBooster->m_trainingSet.GetWeightTotal());
+      pBooster->m_apSamplingSets = SamplingSet::GenerateSamplingSets(
+         &pBooster->m_randomStream, 
+         &pBooster->m_trainingSet, 
+         cSamplingSets, 
+         cSamplesIncluded,
+         pBooster->m_bBlockDraws
+      );
       if(UNLIKELY(nullptr == pBooster->m_apSamplingSets)) {
          LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize nullptr == m_apSamplingSets");
          EbmBoostingState::Free(pBooster);
@@ -503,28 +983,70 @@ EbmBoostingState * EbmBoostingState::Allocate(
       }
    }
 
+   // the first bag continues our stream, which keeps our results identical to when the bags were boosted serially 
+   // with a shared stream if there is only 1 bag.  The others get their own seeds so that they can run in any order.  
+   // The bags of the first slot are seeded first, so adding slots doesn't change the results of the first slot
+   pBooster->m_apCachedThreadResources[0]->GetRandomStream()->Initialize(pBooster->m_randomStream);
+   for(size_t iCachedThreadResources = 1; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+      pBooster->m_apCachedThreadResources[iCachedThreadResources]->GetRandomStream()->Initialize(pBooster->m_randomStream.NextEbmInt());
+   }
+
    if(bClassification) {
       if(0 != cTrainingSamples) {
-         InitializeResiduals(
-            runtimeLearningTypeOrCountTargetClasses,
-            cTrainingSamples,
-            aTrainingTargets,
-            aTrainingPredictorScores,
-            pBooster->GetCachedThreadResources()->GetTempFloatVector(),
-            pBooster->m_trainingSet.GetResidualPointer()
-         );
+         if(bTrainingFloat32) {
+            InitializeResiduals(
+               runtimeLearningTypeOrCountTargetClasses,
+               cTrainingSamples,
+               aTrainingTargets,
+               aTrainingPredictorScores,
+               pBooster->GetCachedThreadResources()->GetTempFloatVector(),
+               pBooster->m_trainingSet.GetResidualPointer<float>()
+            );
+         } else {
+            InitializeResiduals(
+               runtimeLearningTypeOrCountTargetClasses,
+               cTrainingSamples,
+               aTrainingTargets,
+               aTrainingPredictorScores,
+               pBooster->GetCachedThreadResources()->GetTempFloatVector(),
+               pBooster->m_trainingSet.GetResidualPointer()
+            );
+         }
+         if(ptrdiff_t { 3 } <= runtimeLearningTypeOrCountTargetClasses &&
+            FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingClassMajor, FloatEbmType { 0 })
+         ) {
+            if(pBooster->m_trainingSet.TransposeToClassMajor(cVectorLength)) {
+               LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize m_trainingSet.TransposeToClassMajor");
+               EbmBoostingState::Free(pBooster);
+               return nullptr;
+            }
+         }
+         if(pBooster->m_trainingSet.IsDenominatorsCached()) {
+            pBooster->m_trainingSet.UpdateDenominators(cVectorLength);
+         }
       }
    } else {
       EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
       if(0 != cTrainingSamples) {
-         InitializeResiduals(
-            k_regression,
-            cTrainingSamples,
-            aTrainingTargets,
-            aTrainingPredictorScores,
-            nullptr,
-            pBooster->m_trainingSet.GetResidualPointer()
-         );
+         if(bTrainingFloat32) {
+            InitializeResiduals(
+               k_regression,
+               cTrainingSamples,
+               aTrainingTargets,
+               aTrainingPredictorScores,
+               nullptr,
+               pBooster->m_trainingSet.GetResidualPointer<float>()
+            );
+         } else {
+            InitializeResiduals(
+               k_regression,
+               cTrainingSamples,
+               aTrainingTargets,
+               aTrainingPredictorScores,
+               nullptr,
+               pBooster->m_trainingSet.GetResidualPointer()
+            );
+         }
       }
       if(0 != cValidationSamples) {
          InitializeResiduals(
@@ -538,6 +1060,23 @@ EbmBoostingState * EbmBoostingState::Allocate(
       }
    }
 
+   if(0 != cTrainingSamples) {
+      const FloatEbmType sampleIndexBinsMax = 
+         GetTempParam(optionalTempParams, TempParamBoostingSampleIndexBinsMax, FloatEbmType { 0 });
+      // the negated comparison also catches NaN
+      if(!(FloatEbmType { 0 } <= sampleIndexBinsMax)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize sampleIndexBinsMax must be 0 or more.  Not indexing the samples");
+      } else if(FloatEbmType { 1 } <= sampleIndexBinsMax) {
+         const size_t cBinsMax = static_cast<FloatEbmType>(std::numeric_limits<size_t>::max()) <= sampleIndexBinsMax ?
+            std::numeric_limits<size_t>::max() : static_cast<size_t>(sampleIndexBinsMax);
+         if(pBooster->m_trainingSet.ConstructSampleIndexes(cFeatureGroups, pBooster->m_apFeatureGroups, cBinsMax)) {
+            LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::Initialize m_trainingSet.ConstructSampleIndexes");
+            EbmBoostingState::Free(pBooster);
+            return nullptr;
+         }
+      }
+   }
+
    pBooster->m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
    pBooster->m_bestModelMetric = FloatEbmType { std::numeric_limits<FloatEbmType>::max() };
 
@@ -545,6 +1084,272 @@ EbmBoostingState * EbmBoostingState::Allocate(
    return pBooster;
 }
 
+bool EbmBoostingState::AppendTrainingSamples(
+   const size_t cSamples,
+   const IntEbmType * const aBinnedData,
+   const void * const aTargets,
+   const FloatEbmType * const aPredictorScores
+) {
+   LOG_0(TraceLevelInfo, "Entered EbmBoostingState::AppendTrainingSamples");
+
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(nullptr != aTargets);
+
+   if(0 == m_trainingSet.GetCountSamples()) {
+      LOG_0(TraceLevelError, "ERROR EbmBoostingState::AppendTrainingSamples there are no training samples to append to");
+      return true;
+   }
+   if(m_trainingSet.IsPackedData() || nullptr != m_trainingSet.GetSampleMaskBits() || nullptr != m_trainingSet.GetWeights()) {
+      // deduplicated training sets have weights, and new samples would need to be merged into them
+      LOG_0(TraceLevelError, 
+         "ERROR EbmBoostingState::AppendTrainingSamples the training set cannot have packed data, a sample mask or weights");
+      return true;
+   }
+
+   const bool bClassification = IsClassification(m_runtimeLearningTypeOrCountTargetClasses);
+   const size_t cVectorLength = GetVectorLength(m_runtimeLearningTypeOrCountTargetClasses);
+   EBM_ASSERT(!IsMultiplyError(cVectorLength, cSamples)); // our caller checked this
+   const size_t cScores = cVectorLength * cSamples;
+   FloatEbmType * const aScores = EbmMalloc<FloatEbmType>(cScores);
+   if(nullptr == aScores) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::AppendTrainingSamples nullptr == aScores");
+      return true;
+   }
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      aScores[iScore] = nullptr == aPredictorScores ? FloatEbmType { 0 } : aPredictorScores[iScore];
+   }
+   // the new samples need to start where the existing samples are, so they get the scores of the current model.  The 
+   // expanded tensors are indexed the same way as our bit packed data, which skips features with 1 bin
+   if(nullptr != m_apCurrentModel) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < m_cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = m_apFeatureGroups[iFeatureGroup];
+         const FloatEbmType * const aValues = m_apCurrentModel[iFeatureGroup]->GetValuePointer();
+         const size_t cFeatures = pFeatureGroup->GetCountFeatures();
+         const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+         for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+            size_t iTensor = 0;
+            size_t tensorMultiple = 1;
+            for(size_t iDimension = 0; iDimension < cFeatures; ++iDimension) {
+               const Feature * const pFeature = aFeatureGroupEntries[iDimension].m_pFeature;
+               EBM_ASSERT(nullptr != aBinnedData); // our caller checked this since we have features
+               const IntEbmType indexBin = aBinnedData[pFeature->GetIndexFeatureData() * cSamples + iSample];
+               if(indexBin < IntEbmType { 0 } || !IsNumberConvertable<size_t>(indexBin) || 
+                  pFeature->GetCountBins() <= static_cast<size_t>(indexBin)
+               ) {
+                  LOG_0(TraceLevelError, "ERROR EbmBoostingState::AppendTrainingSamples binnedData must be less than the number of bins");
+                  free(aScores);
+                  return true;
+               }
+               // the tensor already fits into memory, so this can't overflow
+               iTensor += tensorMultiple * static_cast<size_t>(indexBin);
+               tensorMultiple *= pFeature->GetCountBins();
+            }
+            const FloatEbmType * const pValues = aValues + iTensor * cVectorLength;
+            FloatEbmType * const pScores = aScores + iSample * cVectorLength;
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pScores[iVector] += pValues[iVector];
+            }
+         }
+      }
+   }
+
+   DataSetByFeatureGroup appendedSet;
+   appendedSet.InitializeZero();
+   if(appendedSet.Initialize(
+      true,
+      false,
+      bClassification,
+      bClassification,
+      m_trainingSet.IsFloat32(),
+      m_cFeatureGroups,
+      m_apFeatureGroups,
+      cSamples,
+      aBinnedData,
+      nullptr,
+      aTargets,
+      aScores,
+      m_runtimeLearningTypeOrCountTargetClasses,
+      nullptr,
+      nullptr,
+      nullptr
+   )) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::AppendTrainingSamples appendedSet.Initialize");
+      appendedSet.Destruct();
+      free(aScores);
+      return true;
+   }
+   FloatEbmType * const aTempFloatVector = bClassification ? GetCachedThreadResources()->GetTempFloatVector() : nullptr;
+   if(appendedSet.IsFloat32()) {
+      InitializeResiduals(
+         m_runtimeLearningTypeOrCountTargetClasses,
+         cSamples,
+         aTargets,
+         aScores,
+         aTempFloatVector,
+         appendedSet.GetResidualPointer<float>()
+      );
+   } else {
+      InitializeResiduals(
+         m_runtimeLearningTypeOrCountTargetClasses,
+         cSamples,
+         aTargets,
+         aScores,
+         aTempFloatVector,
+         appendedSet.GetResidualPointer()
+      );
+   }
+   free(aScores);
+
+   DataSetByFeatureGroup concatenatedSet;
+   concatenatedSet.InitializeZero();
+   const bool bConcatenateError = 
+      concatenatedSet.InitializeConcatenated(&m_trainingSet, &appendedSet, m_apFeatureGroups, cVectorLength);
+   appendedSet.Destruct();
+   if(bConcatenateError) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::AppendTrainingSamples concatenatedSet.InitializeConcatenated");
+      concatenatedSet.Destruct();
+      return true;
+   }
+
+   // our bags point at m_trainingSet, so we draw them after swapping the concatenated samples in, and swap the 
+   // previous samples back if we can't
+   DataSetByFeatureGroup previousSet = m_trainingSet;
+   m_trainingSet = concatenatedSet;
+   SamplingSet ** const apSamplingSets = SamplingSet::GenerateSamplingSets(
+      &m_randomStream,
+      &m_trainingSet,
+      m_cSamplingSets,
+      GetCountSamplesIncluded(m_fractionIncluded, m_trainingSet.GetWeightTotal()),
+      m_bBlockDraws
+   );
+   if(nullptr == apSamplingSets) {
+      LOG_0(TraceLevelWarning, "WARNING EbmBoostingState::AppendTrainingSamples nullptr == apSamplingSets");
+      m_trainingSet.Destruct();
+      m_trainingSet = previousSet;
+      return true;
+   }
+   previousSet.Destruct();
+   SamplingSet::FreeSamplingSets(m_cSamplingSets, m_apSamplingSets);
+   m_apSamplingSets = apSamplingSets;
+
+   LOG_0(TraceLevelInfo, "Exited EbmBoostingState::AppendTrainingSamples");
+   return false;
+}
+
+static bool IsWeightsInvalid(const size_t cSamples, const IntEbmType * const aWeights) {
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(aWeights[iSample] < 0) {
+         return true;
+      }
+   }
+   return false;
+}
+
+// returns the scores of aPredictorScoresFrom, or of zeros if it's nullptr, with the tensors of a model on our feature 
+// groups added to them.  The tensors have the layout of GetCurrentModelFeatureGroup, one feature group after another, 
+// and aTensors can be nullptr to add nothing.  Our caller has checked the counts, but not the feature groups.  Returns 
+// nullptr on error
+static FloatEbmType * ScoreInitialModel(
+   const size_t cVectorLength,
+   const size_t cFeatures,
+   const EbmNativeFeature * const aFeatures,
+   const size_t cFeatureGroups,
+   const EbmNativeFeatureGroup * const aFeatureGroups,
+   const IntEbmType * const aFeatureGroupIndexes,
+   const FloatEbmType * const aTensors,
+   const size_t cSamples,
+   const IntEbmType * const aBinnedData,
+   const FloatEbmType * const aPredictorScoresFrom
+) {
+   LOG_0(TraceLevelInfo, "Entered ScoreInitialModel");
+
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(!IsMultiplyError(cVectorLength, cSamples)); // our caller checked this
+   const size_t cScores = cVectorLength * cSamples;
+   FloatEbmType * const aScores = EbmMalloc<FloatEbmType>(cScores);
+   if(nullptr == aScores) {
+      LOG_0(TraceLevelWarning, "WARNING ScoreInitialModel nullptr == aScores");
+      return nullptr;
+   }
+   for(size_t iScore = 0; iScore < cScores; ++iScore) {
+      aScores[iScore] = nullptr == aPredictorScoresFrom ? FloatEbmType { 0 } : aPredictorScoresFrom[iScore];
+   }
+   if(nullptr == aTensors) {
+      LOG_0(TraceLevelInfo, "Exited ScoreInitialModel without tensors");
+      return aScores;
+   }
+
+   // we add the feature groups in order for every sample, like PredictBatch, so that our scores match its scores
+   const FloatEbmType * pTensor = aTensors;
+   const IntEbmType * piFeature = aFeatureGroupIndexes;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const IntEbmType countDimensions = aFeatureGroups[iFeatureGroup].countFeaturesInGroup;
+      if(countDimensions < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countDimensions) || 
+         k_cDimensionsMax < static_cast<size_t>(countDimensions) || 
+         (IntEbmType { 0 } != countDimensions && nullptr == aFeatureGroupIndexes)
+      ) {
+         LOG_0(TraceLevelError, "ERROR ScoreInitialModel countFeaturesInGroup must be positive and within k_cDimensionsMax");
+         free(aScores);
+         return nullptr;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      size_t acBins[k_cDimensionsMax];
+      const IntEbmType * aiBins[k_cDimensionsMax];
+      size_t cTensorBins = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType indexFeature = piFeature[iDimension];
+         if(indexFeature < IntEbmType { 0 } || !IsNumberConvertable<size_t>(indexFeature) || 
+            cFeatures <= static_cast<size_t>(indexFeature)
+         ) {
+            LOG_0(TraceLevelError, "ERROR ScoreInitialModel featureGroupIndexes must index into features");
+            free(aScores);
+            return nullptr;
+         }
+         const size_t iFeature = static_cast<size_t>(indexFeature);
+         const IntEbmType countBins = aFeatures[iFeature].countBins;
+         if(countBins < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBins) || 
+            IsMultiplyError(cTensorBins * cVectorLength, static_cast<size_t>(countBins))
+         ) {
+            LOG_0(TraceLevelError, "ERROR ScoreInitialModel countBins must be positive and the tensor must fit into memory");
+            free(aScores);
+            return nullptr;
+         }
+         acBins[iDimension] = static_cast<size_t>(countBins);
+         cTensorBins *= acBins[iDimension];
+         EBM_ASSERT(nullptr != aBinnedData); // our caller checked this since we have features
+         aiBins[iDimension] = aBinnedData + iFeature * cSamples;
+      }
+
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         // the first dimension is the fastest changing one
+         size_t iTensorBin = 0;
+         size_t cTensorBinsPrev = 1;
+         bool bUnknown = false;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const IntEbmType indexBin = aiBins[iDimension][iSample];
+            // the data set reports bins outside of their feature as an error after we return, so here we only 
+            // keep them from reading outside of the tensor
+            bUnknown = bUnknown || indexBin < IntEbmType { 0 } || !IsNumberConvertable<size_t>(indexBin) || 
+               acBins[iDimension] <= static_cast<size_t>(indexBin);
+            iTensorBin += bUnknown ? size_t { 0 } : static_cast<size_t>(indexBin) * cTensorBinsPrev;
+            cTensorBinsPrev *= acBins[iDimension];
+         }
+         if(!bUnknown) {
+            const FloatEbmType * const pValues = pTensor + iTensorBin * cVectorLength;
+            FloatEbmType * const pScores = aScores + iSample * cVectorLength;
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pScores[iVector] += pValues[iVector];
+            }
+         }
+      }
+      pTensor += cTensorBins * cVectorLength;
+      piFeature += cDimensions;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited ScoreInitialModel");
+   return aScores;
+}
+
 // a*PredictorScores = logOdds for binary classification
 // a*PredictorScores = logWeights for multiclass classification
 // a*PredictorScores = predictedValue for regression
@@ -555,15 +1360,22 @@ static EbmBoostingState * AllocateBoosting(
    const IntEbmType countFeatureGroups, 
    const EbmNativeFeatureGroup * const featureGroups, 
    const IntEbmType * const featureGroupIndexes, 
+   const FloatEbmType * const initialModelFeatureGroupTensors, 
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses, 
    const IntEbmType countTrainingSamples, 
    const void * const trainingTargets, 
    const IntEbmType * const trainingBinnedData, 
+   PackedData * const pTrainingPackedData, 
+   const IntEbmType * const trainingSampleMask, 
    const FloatEbmType * const trainingPredictorScores, 
+   const IntEbmType * const trainingWeights, 
    const IntEbmType countValidationSamples, 
    const void * const validationTargets, 
    const IntEbmType * const validationBinnedData, 
+   PackedData * const pValidationPackedData, 
+   const IntEbmType * const validationSampleMask, 
    const FloatEbmType * const validationPredictorScores, 
+   const IntEbmType * const validationWeights, 
    const IntEbmType countInnerBags,
    const FloatEbmType * const optionalTempParams
 ) {
@@ -595,12 +1407,12 @@ static EbmBoostingState * AllocateBoosting(
       LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingTargets cannot be nullptr if 0 < countTrainingSamples");
       return nullptr;
    }
-   if(0 != countTrainingSamples && 0 != countFeatures && nullptr == trainingBinnedData) {
+   if(0 != countTrainingSamples && 0 != countFeatures && nullptr == trainingBinnedData && nullptr == pTrainingPackedData) {
       LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingBinnedData cannot be nullptr if 0 < countTrainingSamples AND 0 < countFeatures");
       return nullptr;
    }
-   if(0 != countTrainingSamples && nullptr == trainingPredictorScores) {
-      LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingPredictorScores cannot be nullptr if 0 < countTrainingSamples");
+   if(0 != countTrainingSamples && nullptr == trainingPredictorScores && nullptr == initialModelFeatureGroupTensors) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingPredictorScores cannot be nullptr if 0 < countTrainingSamples without an initial model");
       return nullptr;
    }
    if(countValidationSamples < 0) {
@@ -611,12 +1423,12 @@ static EbmBoostingState * AllocateBoosting(
       LOG_0(TraceLevelError, "ERROR AllocateBoosting validationTargets cannot be nullptr if 0 < countValidationSamples");
       return nullptr;
    }
-   if(0 != countValidationSamples && 0 != countFeatures && nullptr == validationBinnedData) {
+   if(0 != countValidationSamples && 0 != countFeatures && nullptr == validationBinnedData && nullptr == pValidationPackedData) {
       LOG_0(TraceLevelError, "ERROR AllocateBoosting validationBinnedData cannot be nullptr if 0 < countValidationSamples AND 0 < countFeatures");
       return nullptr;
    }
-   if(0 != countValidationSamples && nullptr == validationPredictorScores) {
-      LOG_0(TraceLevelError, "ERROR AllocateBoosting validationPredictorScores cannot be nullptr if 0 < countValidationSamples");
+   if(0 != countValidationSamples && nullptr == validationPredictorScores && nullptr == initialModelFeatureGroupTensors) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoosting validationPredictorScores cannot be nullptr if 0 < countValidationSamples without an initial model");
       return nullptr;
    }
    if(countInnerBags < 0) {
@@ -670,25 +1482,139 @@ static EbmBoostingState * AllocateBoosting(
       return nullptr;
    }
 
-   EbmBoostingState * const pEbmBoostingState = EbmBoostingState::Allocate(
-      runtimeLearningTypeOrCountTargetClasses,
-      cFeatures,
-      cFeatureGroups,
-      cInnerBags,
-      optionalTempParams,
-      features,
+   if(nullptr != trainingWeights && IsWeightsInvalid(cTrainingSamples, trainingWeights)) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoosting trainingWeights cannot be negative");
+      return nullptr;
+   }
+   if(nullptr != validationWeights && IsWeightsInvalid(cValidationSamples, validationWeights)) {
+      LOG_0(TraceLevelError, "ERROR AllocateBoosting validationWeights cannot be negative");
+      return nullptr;
+   }
+
+   // the initial model is added to the scores before anything else reads them, so deduplication and the residuals 
+   // treat its scores exactly like scores that our caller computed.  Classification with fewer than 2 classes has no 
+   // model, so its tensors have nothing to add
+   const FloatEbmType * const aInitialTensors = 
+      IsClassification(runtimeLearningTypeOrCountTargetClasses) && runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 } ?
+      nullptr : initialModelFeatureGroupTensors;
+   FloatEbmType * aTrainingScoresInitial = nullptr;
+   FloatEbmType * aValidationScoresInitial = nullptr;
+   if(nullptr != initialModelFeatureGroupTensors) {
+      if(nullptr != pTrainingPackedData || nullptr != pValidationPackedData) {
+         LOG_0(TraceLevelError, "ERROR AllocateBoosting an initial model can only score binned data");
+         return nullptr;
+      }
+      if(0 != cTrainingSamples) {
+         aTrainingScoresInitial = ScoreInitialModel(cVectorLength, cFeatures, features, cFeatureGroups, featureGroups, 
+            featureGroupIndexes, aInitialTensors, cTrainingSamples, trainingBinnedData, trainingPredictorScores);
+         if(nullptr == aTrainingScoresInitial) {
+            LOG_0(TraceLevelWarning, "WARNING AllocateBoosting ScoreInitialModel training");
+            return nullptr;
+         }
+      }
+      if(0 != cValidationSamples) {
+         aValidationScoresInitial = ScoreInitialModel(cVectorLength, cFeatures, features, cFeatureGroups, featureGroups, 
+            featureGroupIndexes, aInitialTensors, cValidationSamples, validationBinnedData, validationPredictorScores);
+         if(nullptr == aValidationScoresInitial) {
+            LOG_0(TraceLevelWarning, "WARNING AllocateBoosting ScoreInitialModel validation");
+            free(aTrainingScoresInitial);
+            return nullptr;
+         }
+      }
+   }
+
+   // packed data can be shared with other boosters, so we only collapse duplicate samples in data that we pack
+   const bool bDeduplicate = 
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingDeduplicate, FloatEbmType { 0 });
+   DeduplicatedSamples trainingDeduplicated;
+   trainingDeduplicated.InitializeZero();
+   DeduplicatedSamples validationDeduplicated;
+   validationDeduplicated.InitializeZero();
+
+   const void * aTrainingTargets = trainingTargets;
+   const IntEbmType * aTrainingBinnedData = trainingBinnedData;
+   const FloatEbmType * aTrainingPredictorScores = nullptr == aTrainingScoresInitial ? trainingPredictorScores : aTrainingScoresInitial;
+   const IntEbmType * aTrainingWeights = trainingWeights;
+   if(bDeduplicate && nullptr == pTrainingPackedData && 0 != cTrainingSamples) {
+      if(trainingDeduplicated.Initialize(
+         runtimeLearningTypeOrCountTargetClasses, 
+         cFeatures, 
+         cTrainingSamples, 
+         trainingBinnedData, 
+         trainingTargets, 
+         aTrainingPredictorScores, 
+         trainingWeights
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING AllocateBoosting trainingDeduplicated.Initialize");
+         free(aTrainingScoresInitial);
+         free(aValidationScoresInitial);
+         return nullptr;
+      }
+      cTrainingSamples = trainingDeduplicated.GetCountSamples();
+      aTrainingTargets = trainingDeduplicated.GetTargets();
+      aTrainingBinnedData = trainingDeduplicated.GetBinnedData();
+      aTrainingPredictorScores = trainingDeduplicated.GetPredictorScores();
+      aTrainingWeights = trainingDeduplicated.GetWeights();
+   }
+
+   const void * aValidationTargets = validationTargets;
+   const IntEbmType * aValidationBinnedData = validationBinnedData;
+   const FloatEbmType * aValidationPredictorScores = 
+      nullptr == aValidationScoresInitial ? validationPredictorScores : aValidationScoresInitial;
+   const IntEbmType * aValidationWeights = validationWeights;
+   if(bDeduplicate && nullptr == pValidationPackedData && 0 != cValidationSamples) {
+      if(validationDeduplicated.Initialize(
+         runtimeLearningTypeOrCountTargetClasses, 
+         cFeatures, 
+         cValidationSamples, 
+         validationBinnedData, 
+         validationTargets, 
+         aValidationPredictorScores, 
+         validationWeights
+      )) {
+         LOG_0(TraceLevelWarning, "WARNING AllocateBoosting validationDeduplicated.Initialize");
+         trainingDeduplicated.Destruct();
+         free(aTrainingScoresInitial);
+         free(aValidationScoresInitial);
+         return nullptr;
+      }
+      cValidationSamples = validationDeduplicated.GetCountSamples();
+      aValidationTargets = validationDeduplicated.GetTargets();
+      aValidationBinnedData = validationDeduplicated.GetBinnedData();
+      aValidationPredictorScores = validationDeduplicated.GetPredictorScores();
+      aValidationWeights = validationDeduplicated.GetWeights();
+   }
+
+   // the booster copies everything that it needs out of the deduplicated samples
+   EbmBoostingState * const pEbmBoostingState = EbmBoostingState::Allocate(
+      runtimeLearningTypeOrCountTargetClasses,
+      cFeatures,
+      cFeatureGroups,
+      cInnerBags,
+      optionalTempParams,
+      features,
       featureGroups,
       featureGroupIndexes,
       cTrainingSamples,
-      trainingTargets,
-      trainingBinnedData,
-      trainingPredictorScores,
+      aTrainingTargets,
+      aTrainingBinnedData,
+      pTrainingPackedData,
+      trainingSampleMask,
+      aTrainingPredictorScores,
+      aTrainingWeights,
       cValidationSamples,
-      validationTargets,
-      validationBinnedData,
-      validationPredictorScores,
+      aValidationTargets,
+      aValidationBinnedData,
+      pValidationPackedData,
+      validationSampleMask,
+      aValidationPredictorScores,
+      aValidationWeights,
       randomSeed
    );
+   trainingDeduplicated.Destruct();
+   validationDeduplicated.Destruct();
+   free(aTrainingScoresInitial);
+   free(aValidationScoresInitial);
    if(UNLIKELY(nullptr == pEbmBoostingState)) {
       LOG_0(TraceLevelWarning, "WARNING AllocateBoosting pEbmBoostingState->Initialize");
       return nullptr;
@@ -758,15 +1684,22 @@ EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION Initial
       countFeatureGroups, 
       featureGroups, 
       featureGroupIndexes, 
+      nullptr, 
       runtimeLearningTypeOrCountTargetClasses, 
       countTrainingSamples, 
       trainingTargets, 
       trainingBinnedData, 
+      nullptr, 
+      nullptr, 
       trainingPredictorScores, 
+      nullptr, 
       countValidationSamples, 
       validationTargets, 
       validationBinnedData, 
+      nullptr, 
+      nullptr, 
       validationPredictorScores, 
+      nullptr, 
       countInnerBags,
       optionalTempParams
    ));
@@ -821,15 +1754,22 @@ EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION Initial
       countFeatureGroups, 
       featureGroups, 
       featureGroupIndexes, 
+      nullptr, 
       k_regression, 
       countTrainingSamples, 
       trainingTargets, 
       trainingBinnedData, 
+      nullptr, 
+      nullptr, 
       trainingPredictorScores, 
+      nullptr, 
       countValidationSamples, 
       validationTargets, 
       validationBinnedData, 
+      nullptr, 
+      nullptr, 
       validationPredictorScores, 
+      nullptr, 
       countInnerBags,
       optionalTempParams
    ));
@@ -837,170 +1777,1886 @@ EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION Initial
    return pEbmBoosting;
 }
 
-EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingStep(
-   PEbmBoosting ebmBoosting,
-   IntEbmType indexFeatureGroup,
-   FloatEbmType learningRate,
-   IntEbmType countTreeSplitsMax,
-   IntEbmType countSamplesRequiredForChildSplitMin,
-   const FloatEbmType * trainingWeights,
-   const FloatEbmType * validationWeights,
-   FloatEbmType * validationMetricOut
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationWeighted(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
 ) {
-   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
-   if(nullptr == pEbmBoostingState) {
-      LOG_0(TraceLevelError, "ERROR BoostingStep ebmBoosting cannot be nullptr");
-      return 1;
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingClassificationWeighted: countTargetClasses=%" IntEbmTypePrintf ", countFeatures=%" 
+      IntEbmTypePrintf ", features=%p, countFeatureGroups=%" IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%" 
+      IntEbmTypePrintf ", trainingBinnedData=%p, trainingTargets=%p, trainingPredictorScores=%p, trainingWeights=%p, countValidationSamples=%" 
+      IntEbmTypePrintf ", validationBinnedData=%p, validationTargets=%p, validationPredictorScores=%p, validationWeights=%p, countInnerBags=%" 
+      IntEbmTypePrintf ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countTargetClasses, 
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countTrainingSamples, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      static_cast<const void *>(trainingWeights), 
+      countValidationSamples, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      static_cast<const void *>(validationWeights), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
+      );
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationWeighted countTargetClasses can't be negative");
+      return nullptr;
    }
-
-   if(IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())) {
-      // we need to special handle this case because if we call GenerateModelUpdate, we'll get back a nullptr for the model (since there is no model) 
-      // and we'll return 1 from this function.  We'd like to return 0 (success) here, so we handle it ourselves
-      if(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses() <= ptrdiff_t { 1 }) {
-         // if there is only 1 target class for classification, then we can predict the output with 100% accuracy.  The model is a tensor with zero 
-         // length array logits, which means for our representation that we have zero items in the array total.
-         // since we can predit the output with 100% accuracy, our gain will be 0.
-         if(nullptr != validationMetricOut) {
-            *validationMetricOut = FloatEbmType { 0 };
-         }
-         LOG_0(TraceLevelWarning, "WARNING BoostingStep pEbmBoostingState->m_runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 }");
-         return 0;
-      }
+   if(0 == countTargetClasses && (0 != countTrainingSamples || 0 != countValidationSamples)) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationWeighted countTargetClasses can't be zero unless there are no training and no validation cases");
+      return nullptr;
    }
-
-   FloatEbmType gain; // we toss this value, but we still need to get it
-   FloatEbmType * pModelFeatureGroupUpdateTensor = GenerateModelFeatureGroupUpdate(
-      ebmBoosting, 
-      indexFeatureGroup, 
-      learningRate, 
-      countTreeSplitsMax, 
-      countSamplesRequiredForChildSplitMin, 
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING InitializeBoostingClassificationWeighted !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return nullptr;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      runtimeLearningTypeOrCountTargetClasses, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      nullptr, 
+      nullptr, 
+      trainingPredictorScores, 
       trainingWeights, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      nullptr, 
+      nullptr, 
+      validationPredictorScores, 
       validationWeights, 
-      &gain
-   );
-   if(nullptr == pModelFeatureGroupUpdateTensor) {
-      // if we get back a nullptr from GenerateModelFeatureGroupUpdate it either means that there's only
-      // 1 class in our classification problem, or it means we encountered an error.  We assume here that
-      // it was an error since the caller can check ahead of time if there was only 1 class before calling us
-      if(nullptr != validationMetricOut) {
-         *validationMetricOut = FloatEbmType { 0 };
-      }
-      return 1;
-   }
-   return ApplyModelFeatureGroupUpdate(ebmBoosting, indexFeatureGroup, pModelFeatureGroupUpdateTensor, validationMetricOut);
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingClassificationWeighted %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
 }
 
-EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetBestModelFeatureGroup(
-   PEbmBoosting ebmBoosting,
-   IntEbmType indexFeatureGroup
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionWeighted(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
 ) {
-   LOG_N(
-      TraceLevelInfo, 
-      "Entered GetBestModelFeatureGroup: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf, 
-      static_cast<void *>(ebmBoosting), 
-      indexFeatureGroup
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingRegressionWeighted: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%" IntEbmTypePrintf 
+      ", trainingBinnedData=%p, trainingTargets=%p, trainingPredictorScores=%p, trainingWeights=%p, countValidationSamples=%" IntEbmTypePrintf 
+      ", validationBinnedData=%p, validationTargets=%p, validationPredictorScores=%p, validationWeights=%p, countInnerBags=%" IntEbmTypePrintf 
+      ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countTrainingSamples, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      static_cast<const void *>(trainingWeights), 
+      countValidationSamples, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      static_cast<const void *>(validationWeights), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
    );
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      k_regression, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      nullptr, 
+      nullptr, 
+      trainingPredictorScores, 
+      trainingWeights, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      nullptr, 
+      nullptr, 
+      validationPredictorScores, 
+      validationWeights, 
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingRegressionWeighted %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
+}
 
-   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
-   if(nullptr == pEbmBoostingState) {
-      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup ebmBoosting cannot be nullptr");
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationWarmStart(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * initialModelFeatureGroupTensors,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+) {
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingClassificationWarmStart: countTargetClasses=%" IntEbmTypePrintf ", countFeatures=%" 
+      IntEbmTypePrintf ", features=%p, countFeatureGroups=%" IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, "
+      "initialModelFeatureGroupTensors=%p, countTrainingSamples=%" IntEbmTypePrintf ", trainingBinnedData=%p, trainingTargets=%p, "
+      "trainingPredictorScores=%p, trainingWeights=%p, countValidationSamples=%" IntEbmTypePrintf ", validationBinnedData=%p, "
+      "validationTargets=%p, validationPredictorScores=%p, validationWeights=%p, countInnerBags=%" IntEbmTypePrintf 
+      ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countTargetClasses, 
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      static_cast<const void *>(initialModelFeatureGroupTensors), 
+      countTrainingSamples, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      static_cast<const void *>(trainingWeights), 
+      countValidationSamples, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      static_cast<const void *>(validationWeights), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
+      );
+   if(nullptr == initialModelFeatureGroupTensors) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationWarmStart initialModelFeatureGroupTensors cannot be nullptr");
       return nullptr;
    }
-   if(indexFeatureGroup < 0) {
-      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup indexFeatureGroup must be positive");
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationWarmStart countTargetClasses can't be negative");
       return nullptr;
    }
-   if(!IsNumberConvertable<size_t>(indexFeatureGroup)) {
-      // we wouldn't have allowed the creation of an feature set larger than size_t
-      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup indexFeatureGroup is too high to index");
+   if(0 == countTargetClasses && (0 != countTrainingSamples || 0 != countValidationSamples)) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationWarmStart countTargetClasses can't be zero unless there are no training and no validation cases");
       return nullptr;
    }
-   size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
-   if(pEbmBoostingState->GetCountFeatureGroups() <= iFeatureGroup) {
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING InitializeBoostingClassificationWarmStart !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return nullptr;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      initialModelFeatureGroupTensors, 
+      runtimeLearningTypeOrCountTargetClasses, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      nullptr, 
+      nullptr, 
+      trainingPredictorScores, 
+      trainingWeights, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      nullptr, 
+      nullptr, 
+      validationPredictorScores, 
+      validationWeights, 
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingClassificationWarmStart %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionWarmStart(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * initialModelFeatureGroupTensors,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+) {
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingRegressionWarmStart: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, initialModelFeatureGroupTensors=%p, countTrainingSamples=%" 
+      IntEbmTypePrintf ", trainingBinnedData=%p, trainingTargets=%p, trainingPredictorScores=%p, trainingWeights=%p, countValidationSamples=%" 
+      IntEbmTypePrintf ", validationBinnedData=%p, validationTargets=%p, validationPredictorScores=%p, validationWeights=%p, countInnerBags=%" 
+      IntEbmTypePrintf ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      static_cast<const void *>(initialModelFeatureGroupTensors), 
+      countTrainingSamples, 
+      static_cast<const void *>(trainingBinnedData), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      static_cast<const void *>(trainingWeights), 
+      countValidationSamples, 
+      static_cast<const void *>(validationBinnedData), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      static_cast<const void *>(validationWeights), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
+   );
+   if(nullptr == initialModelFeatureGroupTensors) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingRegressionWarmStart initialModelFeatureGroupTensors cannot be nullptr");
+      return nullptr;
+   }
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      initialModelFeatureGroupTensors, 
+      k_regression, 
+      countTrainingSamples, 
+      trainingTargets, 
+      trainingBinnedData, 
+      nullptr, 
+      nullptr, 
+      trainingPredictorScores, 
+      trainingWeights, 
+      countValidationSamples, 
+      validationTargets, 
+      validationBinnedData, 
+      nullptr, 
+      nullptr, 
+      validationPredictorScores, 
+      validationWeights, 
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingRegressionWarmStart %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationPacked(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   PEbmPackedData trainingPackedData,
+   const IntEbmType * trainingSampleMask,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   PEbmPackedData validationPackedData,
+   const IntEbmType * validationSampleMask,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+) {
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingClassificationPacked: countTargetClasses=%" IntEbmTypePrintf ", countFeatures=%" IntEbmTypePrintf 
+      ", features=%p, countFeatureGroups=%" IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%" 
+      IntEbmTypePrintf ", trainingPackedData=%p, trainingSampleMask=%p, trainingTargets=%p, trainingPredictorScores=%p, countValidationSamples=%" 
+      IntEbmTypePrintf ", validationPackedData=%p, validationSampleMask=%p, validationTargets=%p, validationPredictorScores=%p, countInnerBags=%" 
+      IntEbmTypePrintf ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countTargetClasses, 
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countTrainingSamples, 
+      static_cast<void *>(trainingPackedData), 
+      static_cast<const void *>(trainingSampleMask), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      countValidationSamples, 
+      static_cast<void *>(validationPackedData), 
+      static_cast<const void *>(validationSampleMask), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
+      );
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationPacked countTargetClasses can't be negative");
+      return nullptr;
+   }
+   if(0 == countTargetClasses && (0 != countTrainingSamples || 0 != countValidationSamples)) {
+      LOG_0(TraceLevelError, "ERROR InitializeBoostingClassificationPacked countTargetClasses can't be zero unless there are no training and no validation cases");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING InitializeBoostingClassificationPacked !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return nullptr;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(countTargetClasses);
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      runtimeLearningTypeOrCountTargetClasses, 
+      countTrainingSamples, 
+      trainingTargets, 
+      nullptr, 
+      reinterpret_cast<PackedData *>(trainingPackedData), 
+      trainingSampleMask, 
+      trainingPredictorScores, 
+      nullptr, 
+      countValidationSamples, 
+      validationTargets, 
+      nullptr, 
+      reinterpret_cast<PackedData *>(validationPackedData), 
+      validationSampleMask, 
+      validationPredictorScores, 
+      nullptr, 
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingClassificationPacked %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionPacked(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   PEbmPackedData trainingPackedData,
+   const IntEbmType * trainingSampleMask,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   PEbmPackedData validationPackedData,
+   const IntEbmType * validationSampleMask,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+) {
+   LOG_N(TraceLevelInfo, "Entered InitializeBoostingRegressionPacked: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%" IntEbmTypePrintf 
+      ", trainingPackedData=%p, trainingSampleMask=%p, trainingTargets=%p, trainingPredictorScores=%p, countValidationSamples=%" IntEbmTypePrintf 
+      ", validationPackedData=%p, validationSampleMask=%p, validationTargets=%p, validationPredictorScores=%p, countInnerBags=%" IntEbmTypePrintf 
+      ", randomSeed=%" IntEbmTypePrintf ", optionalTempParams=%p",
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countTrainingSamples, 
+      static_cast<void *>(trainingPackedData), 
+      static_cast<const void *>(trainingSampleMask), 
+      static_cast<const void *>(trainingTargets), 
+      static_cast<const void *>(trainingPredictorScores), 
+      countValidationSamples, 
+      static_cast<void *>(validationPackedData), 
+      static_cast<const void *>(validationSampleMask), 
+      static_cast<const void *>(validationTargets), 
+      static_cast<const void *>(validationPredictorScores), 
+      countInnerBags, 
+      randomSeed,
+      static_cast<const void *>(optionalTempParams)
+   );
+   const PEbmBoosting pEbmBoosting = reinterpret_cast<PEbmBoosting>(AllocateBoosting(
+      randomSeed, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      k_regression, 
+      countTrainingSamples, 
+      trainingTargets, 
+      nullptr, 
+      reinterpret_cast<PackedData *>(trainingPackedData), 
+      trainingSampleMask, 
+      trainingPredictorScores, 
+      nullptr, 
+      countValidationSamples, 
+      validationTargets, 
+      nullptr, 
+      reinterpret_cast<PackedData *>(validationPackedData), 
+      validationSampleMask, 
+      validationPredictorScores, 
+      nullptr, 
+      countInnerBags,
+      optionalTempParams
+   ));
+   LOG_N(TraceLevelInfo, "Exited InitializeBoostingRegressionPacked %p", static_cast<void *>(pEbmBoosting));
+   return pEbmBoosting;
+}
+
+static IntEbmType AppendBoostingSamples(
+   PEbmBoosting ebmBoosting,
+   const bool bClassification,
+   const IntEbmType countSamples,
+   const IntEbmType * const binnedData,
+   const void * const targets,
+   const FloatEbmType * const predictorScores
+) {
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples ebmBoosting cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(bClassification != IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())) {
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples the samples need to be for the learning type of the booster");
+      return IntEbmType { 1 };
+   }
+   if(countSamples < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples countSamples must be positive");
+      return IntEbmType { 1 };
+   }
+   if(IntEbmType { 0 } == countSamples) {
+      LOG_0(TraceLevelInfo, "AppendBoostingSamples there are no samples to append");
+      return IntEbmType { 0 };
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      // the caller should not have been able to allocate enough memory in "targets" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples !IsNumberConvertable<size_t>(countSamples)");
+      return IntEbmType { 1 };
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(nullptr == targets) {
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples targets cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == binnedData && 0 != pEbmBoostingState->GetCountFeatures()) {
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples binnedData cannot be nullptr if 0 < countFeatures");
+      return IntEbmType { 1 };
+   }
+   if(IsMultiplyError(GetVectorLength(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()), cSamples)) {
+      // the caller should not have been able to allocate enough memory in "predictorScores" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR AppendBoostingSamples IsMultiplyError(cVectorLength, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(pEbmBoostingState->AppendTrainingSamples(cSamples, binnedData, targets, predictorScores)) {
+      LOG_0(TraceLevelWarning, "WARNING AppendBoostingSamples pEbmBoostingState->AppendTrainingSamples");
+      return IntEbmType { 1 };
+   }
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendBoostingTrainingSamplesClassification(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const IntEbmType * targets,
+   const FloatEbmType * predictorScores
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered AppendBoostingTrainingSamplesClassification: ebmBoosting=%p, countSamples=%" IntEbmTypePrintf 
+      ", binnedData=%p, targets=%p, predictorScores=%p",
+      static_cast<void *>(ebmBoosting), 
+      countSamples, 
+      static_cast<const void *>(binnedData), 
+      static_cast<const void *>(targets), 
+      static_cast<const void *>(predictorScores)
+   );
+   const IntEbmType ret = AppendBoostingSamples(ebmBoosting, true, countSamples, binnedData, targets, predictorScores);
+   LOG_N(TraceLevelInfo, "Exited AppendBoostingTrainingSamplesClassification %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendBoostingTrainingSamplesRegression(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const FloatEbmType * targets,
+   const FloatEbmType * predictorScores
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered AppendBoostingTrainingSamplesRegression: ebmBoosting=%p, countSamples=%" IntEbmTypePrintf 
+      ", binnedData=%p, targets=%p, predictorScores=%p",
+      static_cast<void *>(ebmBoosting), 
+      countSamples, 
+      static_cast<const void *>(binnedData), 
+      static_cast<const void *>(targets), 
+      static_cast<const void *>(predictorScores)
+   );
+   const IntEbmType ret = AppendBoostingSamples(ebmBoosting, false, countSamples, binnedData, targets, predictorScores);
+   LOG_N(TraceLevelInfo, "Exited AppendBoostingTrainingSamplesRegression %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+// BoostingStep, which also returns the gain of the update in pGainOut for BoostingRun to schedule feature groups with
+static IntEbmType BoostingStepWithGain(
+   const PEbmBoosting ebmBoosting,
+   const IntEbmType indexFeatureGroup,
+   const FloatEbmType learningRate,
+   const IntEbmType countTreeSplitsMax,
+   const IntEbmType countSamplesRequiredForChildSplitMin,
+   const FloatEbmType * const trainingWeights,
+   const FloatEbmType * const validationWeights,
+   FloatEbmType * const pGainOut,
+   FloatEbmType * const validationMetricOut
+) {
+   EBM_ASSERT(nullptr != pGainOut);
+   *pGainOut = FloatEbmType { 0 };
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR BoostingStep ebmBoosting cannot be nullptr");
+      return 1;
+   }
+
+   if(IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())) {
+      // we need to special handle this case because if we call GenerateModelUpdate, we'll get back a nullptr for the model (since there is no model) 
+      // and we'll return 1 from this function.  We'd like to return 0 (success) here, so we handle it ourselves
+      if(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses() <= ptrdiff_t { 1 }) {
+         // if there is only 1 target class for classification, then we can predict the output with 100% accuracy.  The model is a tensor with zero 
+         // length array logits, which means for our representation that we have zero items in the array total.
+         // since we can predit the output with 100% accuracy, our gain will be 0.
+         if(nullptr != validationMetricOut) {
+            *validationMetricOut = FloatEbmType { 0 };
+         }
+         LOG_0(TraceLevelWarning, "WARNING BoostingStep pEbmBoostingState->m_runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 }");
+         return 0;
+      }
+   }
+
+   FloatEbmType * pModelFeatureGroupUpdateTensor = GenerateModelFeatureGroupUpdate(
+      ebmBoosting, 
+      indexFeatureGroup, 
+      learningRate, 
+      countTreeSplitsMax, 
+      countSamplesRequiredForChildSplitMin, 
+      trainingWeights, 
+      validationWeights, 
+      pGainOut
+   );
+   if(nullptr == pModelFeatureGroupUpdateTensor) {
+      // if we get back a nullptr from GenerateModelFeatureGroupUpdate it either means that there's only
+      // 1 class in our classification problem, or it means we encountered an error.  We assume here that
+      // it was an error since the caller can check ahead of time if there was only 1 class before calling us
+      if(nullptr != validationMetricOut) {
+         *validationMetricOut = FloatEbmType { 0 };
+      }
+      return 1;
+   }
+   return ApplyModelFeatureGroupUpdate(ebmBoosting, indexFeatureGroup, pModelFeatureGroupUpdateTensor, validationMetricOut);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingStep(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * validationWeights,
+   FloatEbmType * validationMetricOut
+) {
+   FloatEbmType gain; // we toss this value, but we still need to get it
+   return BoostingStepWithGain(
+      ebmBoosting,
+      indexFeatureGroup,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      trainingWeights,
+      validationWeights,
+      &gain,
+      validationMetricOut
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingRun(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countRoundsMax,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType earlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   BOOSTING_PROGRESS_FUNCTION progressFunction,
+   void * progressContext,
+   FloatEbmType * validationMetricOut,
+   IntEbmType * indexRoundOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered BoostingRun: ebmBoosting=%p, countRoundsMax=%" IntEbmTypePrintf ", learningRate=%" FloatEbmTypePrintf
+      ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf
+      ", earlyStoppingRounds=%" IntEbmTypePrintf ", earlyStoppingTolerance=%" FloatEbmTypePrintf
+      ", progressFunction=%s, progressContext=%p, validationMetricOut=%p, indexRoundOut=%p",
+      static_cast<void *>(ebmBoosting),
+      countRoundsMax,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      earlyStoppingRounds,
+      earlyStoppingTolerance,
+      nullptr == progressFunction ? "nullptr" : "provided",
+      progressContext,
+      static_cast<void *>(validationMetricOut),
+      static_cast<void *>(indexRoundOut)
+   );
+
+   FloatEbmType metricMin = std::numeric_limits<FloatEbmType>::infinity();
+   IntEbmType iRound = 0;
+   if(nullptr != validationMetricOut) {
+      *validationMetricOut = metricMin;
+   }
+   if(nullptr != indexRoundOut) {
+      *indexRoundOut = iRound;
+   }
+
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR BoostingRun ebmBoosting cannot be nullptr");
+      return 1;
+   }
+   if(countRoundsMax < 0) {
+      LOG_0(TraceLevelError, "ERROR BoostingRun countRoundsMax cannot be negative");
+      return 1;
+   }
+   // BoostingStep checks the remaining parameters on our first step
+   const IntEbmType countFeatureGroups = static_cast<IntEbmType>(pEbmBoostingState->GetCountFeatureGroups());
+   // with deferred validation we only ask for the metric at the end of each round, which lets the validation set 
+   // take all the updates of a round in one pass
+   const bool bDeferValidation = pEbmBoostingState->IsValidationDeferred();
+   const bool bScheduled = pEbmBoostingState->IsBoostingScheduled();
+
+   // we stop once earlyStoppingRounds rounds in a row fail to improve on the best metric from the start of that
+   // window by more than earlyStoppingTolerance.  This matches the loop that python used before it called us
+   IntEbmType cRoundsNoChange = 0;
+   FloatEbmType metricWindowStart = metricMin;
+   for(; iRound < countRoundsMax; ++iRound) {
+      // a scheduled booster decides which feature groups to boost from the gains at the start of the round, so a 
+      // group that gains a lot this round doesn't push the groups after it out of the same round
+      const FloatEbmType gainThreshold = bScheduled ? pEbmBoostingState->GetScheduleGainThreshold() : FloatEbmType { 0 };
+      IntEbmType iFeatureGroupLast = countFeatureGroups - 1;
+      if(bScheduled) {
+         while(0 < iFeatureGroupLast && 
+            !pEbmBoostingState->IsFeatureGroupScheduled(static_cast<size_t>(iFeatureGroupLast), gainThreshold)) 
+         {
+            --iFeatureGroupLast;
+         }
+      }
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < countFeatureGroups; ++iFeatureGroup) {
+         if(bScheduled && !pEbmBoostingState->IsFeatureGroupScheduled(static_cast<size_t>(iFeatureGroup), gainThreshold)) {
+            pEbmBoostingState->SkipScheduledFeatureGroup(static_cast<size_t>(iFeatureGroup));
+            continue;
+         }
+         const bool bMetric = !bDeferValidation || iFeatureGroupLast == iFeatureGroup;
+         FloatEbmType gain;
+         FloatEbmType metric;
+         const IntEbmType error = BoostingStepWithGain(
+            ebmBoosting,
+            iFeatureGroup,
+            learningRate,
+            countTreeSplitsMax,
+            countSamplesRequiredForChildSplitMin,
+            nullptr,
+            nullptr,
+            &gain,
+            bMetric ? &metric : nullptr
+         );
+         if(0 != error) {
+            LOG_N(TraceLevelWarning, "WARNING BoostingRun BoostingStep failed in round %" IntEbmTypePrintf, iRound);
+            return error;
+         }
+         if(bScheduled) {
+            pEbmBoostingState->SetScheduledFeatureGroupGain(static_cast<size_t>(iFeatureGroup), gain);
+         }
+         if(bMetric) {
+            metricMin = metric < metricMin ? metric : metricMin;
+         }
+      }
+
+      if(nullptr != validationMetricOut) {
+         *validationMetricOut = metricMin;
+      }
+      if(nullptr != indexRoundOut) {
+         *indexRoundOut = iRound;
+      }
+
+      if(0 == cRoundsNoChange) {
+         metricWindowStart = metricMin;
+      }
+      if(metricMin + earlyStoppingTolerance < metricWindowStart) {
+         cRoundsNoChange = 0;
+      } else {
+         ++cRoundsNoChange;
+      }
+
+      if(nullptr != progressFunction && 0 != (*progressFunction)(iRound, metricMin, progressContext)) {
+         LOG_N(TraceLevelInfo, "INFO BoostingRun progressFunction stopped boosting after round %" IntEbmTypePrintf, iRound);
+         break;
+      }
+      if(0 <= earlyStoppingRounds && earlyStoppingRounds <= cRoundsNoChange) {
+         break;
+      }
+   }
+
+   LOG_N(TraceLevelInfo, "Exited BoostingRun metric=%" FloatEbmTypePrintf, metricMin);
+   return 0;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SetBoostingHistogramReduce(
+   PEbmBoosting ebmBoosting,
+   HISTOGRAM_REDUCE_FUNCTION reduceFunction,
+   void * reduceContext
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SetBoostingHistogramReduce: ebmBoosting=%p, reduceFunction=%s, reduceContext=%p",
+      static_cast<void *>(ebmBoosting),
+      nullptr == reduceFunction ? "nullptr" : "provided",
+      reduceContext
+   );
+
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR SetBoostingHistogramReduce ebmBoosting cannot be nullptr");
+      return 1;
+   }
+   // without training samples we return zero updates without building histograms, so this node would never take part 
+   // in the reductions that the other nodes are waiting on
+   if(nullptr != reduceFunction && nullptr == pEbmBoostingState->GetSamplingSets()) {
+      LOG_0(TraceLevelError, "ERROR SetBoostingHistogramReduce every node needs at least one training sample");
+      return 1;
+   }
+   pEbmBoostingState->SetHistogramReduce(reduceFunction, reduceContext);
+
+   LOG_0(TraceLevelInfo, "Exited SetBoostingHistogramReduce");
+   return 0;
+}
+
+class BoostingStepWork final {
+public:
+   // m_asyncWork needs to be first since the thread pool hands us back a pointer to it
+   AsyncWork m_asyncWork;
+
+   PEbmBoosting m_ebmBoosting;
+   IntEbmType m_indexFeatureGroup;
+   FloatEbmType m_learningRate;
+   IntEbmType m_countTreeSplitsMax;
+   IntEbmType m_countSamplesRequiredForChildSplitMin;
+   const FloatEbmType * m_trainingWeights;
+   const FloatEbmType * m_validationWeights;
+
+   BoostingStepWork() = default; // preserve our POD status
+   ~BoostingStepWork() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+};
+static_assert(std::is_standard_layout<BoostingStepWork>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BoostingStepWork>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BoostingStepWork>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static IntEbmType BoostingStepWorkFunction(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut) {
+   const BoostingStepWork * const pBoostingStepWork = reinterpret_cast<const BoostingStepWork *>(pAsyncWork);
+   return BoostingStep(
+      pBoostingStepWork->m_ebmBoosting,
+      pBoostingStepWork->m_indexFeatureGroup,
+      pBoostingStepWork->m_learningRate,
+      pBoostingStepWork->m_countTreeSplitsMax,
+      pBoostingStepWork->m_countSamplesRequiredForChildSplitMin,
+      pBoostingStepWork->m_trainingWeights,
+      pBoostingStepWork->m_validationWeights,
+      pMetricOut
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmWork EBM_NATIVE_CALLING_CONVENTION BoostingStepAsync(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * validationWeights
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered BoostingStepAsync: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf ", learningRate=%" FloatEbmTypePrintf 
+      ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf 
+      ", trainingWeights=%p, validationWeights=%p",
+      static_cast<void *>(ebmBoosting),
+      indexFeatureGroup,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      static_cast<const void *>(trainingWeights),
+      static_cast<const void *>(validationWeights)
+   );
+
+   // the remaining parameters are checked by BoostingStep when the work executes, and any errors found there
+   // are returned to our caller through FinishWork
+   if(nullptr == ebmBoosting) {
+      LOG_0(TraceLevelError, "ERROR BoostingStepAsync ebmBoosting cannot be nullptr");
+      return nullptr;
+   }
+
+   BoostingStepWork * const pBoostingStepWork = EbmMalloc<BoostingStepWork>();
+   if(UNLIKELY(nullptr == pBoostingStepWork)) {
+      LOG_0(TraceLevelWarning, "WARNING BoostingStepAsync nullptr == pBoostingStepWork");
+      return nullptr;
+   }
+   // a single EbmBoostingState is not thread safe, so serialize all work on the same booster
+   pBoostingStepWork->m_asyncWork.Initialize(ebmBoosting, BoostingStepWorkFunction);
+   pBoostingStepWork->m_ebmBoosting = ebmBoosting;
+   pBoostingStepWork->m_indexFeatureGroup = indexFeatureGroup;
+   pBoostingStepWork->m_learningRate = learningRate;
+   pBoostingStepWork->m_countTreeSplitsMax = countTreeSplitsMax;
+   pBoostingStepWork->m_countSamplesRequiredForChildSplitMin = countSamplesRequiredForChildSplitMin;
+   pBoostingStepWork->m_trainingWeights = trainingWeights;
+   pBoostingStepWork->m_validationWeights = validationWeights;
+
+   if(UNLIKELY(ThreadPool::Submit(&pBoostingStepWork->m_asyncWork))) {
+      LOG_0(TraceLevelWarning, "WARNING BoostingStepAsync ThreadPool::Submit(&pBoostingStepWork->m_asyncWork)");
+      free(pBoostingStepWork);
+      return nullptr;
+   }
+
+   const PEbmWork work = reinterpret_cast<PEbmWork>(&pBoostingStepWork->m_asyncWork);
+   LOG_N(TraceLevelInfo, "Exited BoostingStepAsync %p", static_cast<void *>(work));
+   return work;
+}
+
+class BoostingRunWork final {
+public:
+   // m_asyncWork needs to be first since the thread pool hands us back a pointer to it
+   AsyncWork m_asyncWork;
+
+   PEbmBoosting m_ebmBoosting;
+   IntEbmType m_countRoundsMax;
+   FloatEbmType m_learningRate;
+   IntEbmType m_countTreeSplitsMax;
+   IntEbmType m_countSamplesRequiredForChildSplitMin;
+   IntEbmType m_earlyStoppingRounds;
+   FloatEbmType m_earlyStoppingTolerance;
+   BOOSTING_PROGRESS_FUNCTION m_progressFunction;
+   void * m_progressContext;
+   IntEbmType * m_indexRoundOut;
+
+   BoostingRunWork() = default; // preserve our POD status
+   ~BoostingRunWork() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+};
+static_assert(std::is_standard_layout<BoostingRunWork>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BoostingRunWork>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BoostingRunWork>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static IntEbmType BoostingRunWorkFunction(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut) {
+   const BoostingRunWork * const pBoostingRunWork = reinterpret_cast<const BoostingRunWork *>(pAsyncWork);
+   return BoostingRun(
+      pBoostingRunWork->m_ebmBoosting,
+      pBoostingRunWork->m_countRoundsMax,
+      pBoostingRunWork->m_learningRate,
+      pBoostingRunWork->m_countTreeSplitsMax,
+      pBoostingRunWork->m_countSamplesRequiredForChildSplitMin,
+      pBoostingRunWork->m_earlyStoppingRounds,
+      pBoostingRunWork->m_earlyStoppingTolerance,
+      pBoostingRunWork->m_progressFunction,
+      pBoostingRunWork->m_progressContext,
+      pMetricOut,
+      pBoostingRunWork->m_indexRoundOut
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmWork EBM_NATIVE_CALLING_CONVENTION BoostingRunAsync(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countRoundsMax,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType earlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   BOOSTING_PROGRESS_FUNCTION progressFunction,
+   void * progressContext,
+   IntEbmType * indexRoundOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered BoostingRunAsync: ebmBoosting=%p, countRoundsMax=%" IntEbmTypePrintf ", learningRate=%" FloatEbmTypePrintf
+      ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf
+      ", earlyStoppingRounds=%" IntEbmTypePrintf ", earlyStoppingTolerance=%" FloatEbmTypePrintf
+      ", progressFunction=%s, progressContext=%p, indexRoundOut=%p",
+      static_cast<void *>(ebmBoosting),
+      countRoundsMax,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      earlyStoppingRounds,
+      earlyStoppingTolerance,
+      nullptr == progressFunction ? "nullptr" : "provided",
+      progressContext,
+      static_cast<void *>(indexRoundOut)
+   );
+
+   // the remaining parameters are checked by BoostingRun when the work executes, and any errors found there
+   // are returned to our caller through FinishWork
+   if(nullptr == ebmBoosting) {
+      LOG_0(TraceLevelError, "ERROR BoostingRunAsync ebmBoosting cannot be nullptr");
+      return nullptr;
+   }
+
+   BoostingRunWork * const pBoostingRunWork = EbmMalloc<BoostingRunWork>();
+   if(UNLIKELY(nullptr == pBoostingRunWork)) {
+      LOG_0(TraceLevelWarning, "WARNING BoostingRunAsync nullptr == pBoostingRunWork");
+      return nullptr;
+   }
+   // the whole run is a single work item, so a booster's rounds stay in order while different boosters run on 
+   // different threads
+   pBoostingRunWork->m_asyncWork.Initialize(ebmBoosting, BoostingRunWorkFunction);
+   pBoostingRunWork->m_ebmBoosting = ebmBoosting;
+   pBoostingRunWork->m_countRoundsMax = countRoundsMax;
+   pBoostingRunWork->m_learningRate = learningRate;
+   pBoostingRunWork->m_countTreeSplitsMax = countTreeSplitsMax;
+   pBoostingRunWork->m_countSamplesRequiredForChildSplitMin = countSamplesRequiredForChildSplitMin;
+   pBoostingRunWork->m_earlyStoppingRounds = earlyStoppingRounds;
+   pBoostingRunWork->m_earlyStoppingTolerance = earlyStoppingTolerance;
+   pBoostingRunWork->m_progressFunction = progressFunction;
+   pBoostingRunWork->m_progressContext = progressContext;
+   pBoostingRunWork->m_indexRoundOut = indexRoundOut;
+
+   if(UNLIKELY(ThreadPool::Submit(&pBoostingRunWork->m_asyncWork))) {
+      LOG_0(TraceLevelWarning, "WARNING BoostingRunAsync ThreadPool::Submit(&pBoostingRunWork->m_asyncWork)");
+      free(pBoostingRunWork);
+      return nullptr;
+   }
+
+   const PEbmWork work = reinterpret_cast<PEbmWork>(&pBoostingRunWork->m_asyncWork);
+   LOG_N(TraceLevelInfo, "Exited BoostingRunAsync %p", static_cast<void *>(work));
+   return work;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetBestModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered GetBestModelFeatureGroup: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf, 
+      static_cast<void *>(ebmBoosting), 
+      indexFeatureGroup
+   );
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup ebmBoosting cannot be nullptr");
+      return nullptr;
+   }
+   if(indexFeatureGroup < 0) {
+      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup indexFeatureGroup must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(indexFeatureGroup)) {
+      // we wouldn't have allowed the creation of an feature set larger than size_t
+      LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup indexFeatureGroup is too high to index");
+      return nullptr;
+   }
+   size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
+   if(pEbmBoostingState->GetCountFeatureGroups() <= iFeatureGroup) {
       LOG_0(TraceLevelError, "ERROR GetBestModelFeatureGroup indexFeatureGroup above the number of feature groups that we have");
       return nullptr;
    }
-   if(nullptr == pEbmBoostingState->GetBestModel()) {
-      // if pEbmBoostingState->m_apBestModel is nullptr, then either:
-      //    1) m_cFeatureGroups was 0, in which case this function would have undefined behavior since the caller needs to indicate a valid 
-      //       indexFeatureGroup, which is impossible, so we can do anything we like, include the below actions.
-      //    2) m_runtimeLearningTypeOrCountTargetClasses was either 1 or 0 (and the learning type is classification), 
-      //       which is legal, which we need to handle here
-      // for classification, if there is only 1 possible target class, then the probability of that class is 100%.  If there were logits in this model, 
-      // they'd all be infinity, but you could alternatively think of this model as having zero logits, since the number of logits can be one 
-      // less than the number of target classification classes.  A model with zero logits is empty, and has zero items.  We want to return a tensor 
-      // with 0 items in it, so we could either return a pointer to some random memory that can't be accessed, or we can return nullptr.  
-      // We return a nullptr in the hopes that our caller will either handle it or throw a nicer exception.
+   if(nullptr == pEbmBoostingState->GetBestModel()) {
+      // if pEbmBoostingState->m_apBestModel is nullptr, then either:
+      //    1) m_cFeatureGroups was 0, in which case this function would have undefined behavior since the caller needs to indicate a valid 
+      //       indexFeatureGroup, which is impossible, so we can do anything we like, include the below actions.
+      //    2) m_runtimeLearningTypeOrCountTargetClasses was either 1 or 0 (and the learning type is classification), 
+      //       which is legal, which we need to handle here
+      // for classification, if there is only 1 possible target class, then the probability of that class is 100%.  If there were logits in this model, 
+      // they'd all be infinity, but you could alternatively think of this model as having zero logits, since the number of logits can be one 
+      // less than the number of target classification classes.  A model with zero logits is empty, and has zero items.  We want to return a tensor 
+      // with 0 items in it, so we could either return a pointer to some random memory that can't be accessed, or we can return nullptr.  
+      // We return a nullptr in the hopes that our caller will either handle it or throw a nicer exception.
+
+      LOG_0(TraceLevelInfo, "Exited GetBestModelFeatureGroup no model");
+      return nullptr;
+   }
+
+   SegmentedTensor * pBestModel = pEbmBoostingState->GetBestModel()[iFeatureGroup];
+   EBM_ASSERT(nullptr != pBestModel);
+   EBM_ASSERT(pBestModel->GetExpanded()); // the model should have been expanded at startup
+   FloatEbmType * pRet = pBestModel->GetValuePointer();
+   EBM_ASSERT(nullptr != pRet);
+
+   LOG_N(TraceLevelInfo, "Exited GetBestModelFeatureGroup %p", static_cast<void *>(pRet));
+   return pRet;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetCurrentModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup
+) {
+   LOG_N(
+      TraceLevelInfo, 
+      "Entered GetCurrentModelFeatureGroup: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf, 
+      static_cast<void *>(ebmBoosting), 
+      indexFeatureGroup
+   );
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup ebmBoosting cannot be nullptr");
+      return nullptr;
+   }
+   if(indexFeatureGroup < 0) {
+      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(indexFeatureGroup)) {
+      // we wouldn't have allowed the creation of an feature set larger than size_t
+      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup is too high to index");
+      return nullptr;
+   }
+   size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
+   if(pEbmBoostingState->GetCountFeatureGroups() <= iFeatureGroup) {
+      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup above the number of feature groups that we have");
+      return nullptr;
+   }
+   if(nullptr == pEbmBoostingState->GetCurrentModel()) {
+      // if pEbmBoostingState->m_apCurrentModel is nullptr, then either:
+      //    1) m_cFeatureGroups was 0, in which case this function would have undefined behavior since the caller needs to indicate a valid 
+      //       indexFeatureGroup, which is impossible, so we can do anything we like, include the below actions.
+      //    2) m_runtimeLearningTypeOrCountTargetClasses was either 1 or 0 (and the learning type is classification), which is legal, 
+      //       which we need to handle here
+      // for classification, if there is only 1 possible target class, then the probability of that class is 100%.  If there were logits 
+      // in this model, they'd all be infinity, but you could alternatively think of this model as having zero logits, since the number of 
+      // logits can be one less than the number of target classification classes.  A model with zero logits is empty, and has zero items.  
+      // We want to return a tensor with 0 items in it, so we could either return a pointer to some random memory that can't be accessed, 
+      // or we can return nullptr.  We return a nullptr in the hopes that our caller will either handle it or throw a nicer exception.
+
+      LOG_0(TraceLevelInfo, "Exited GetCurrentModelFeatureGroup no model");
+      return nullptr;
+   }
+
+   SegmentedTensor * pCurrentModel = pEbmBoostingState->GetCurrentModel()[iFeatureGroup];
+   EBM_ASSERT(nullptr != pCurrentModel);
+   EBM_ASSERT(pCurrentModel->GetExpanded()); // the model should have been expanded at startup
+   FloatEbmType * pRet = pCurrentModel->GetValuePointer();
+   EBM_ASSERT(nullptr != pRet);
+
+   LOG_N(TraceLevelInfo, "Exited GetCurrentModelFeatureGroup %p", static_cast<void *>(pRet));
+   return pRet;
+}
+
+// writes the expanded tensor of pFeatureGroup into tensorOut.  aStrides has one byte stride per feature of the group 
+// followed by the stride between the scores of a cell, or is nullptr for the layout of our own tensors
+static void CopyModelTensor(
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cVectorLength,
+   const FloatEbmType * const aValues,
+   const ptrdiff_t * const aStrides,
+   FloatEbmType * const tensorOut
+) {
+   const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+   const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+   if(nullptr == aStrides) {
+      size_t cValues = cVectorLength;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         // our tensor already holds this many values, so this can't overflow
+         cValues *= aFeatureGroupEntries[iDimension].m_pFeature->GetCountBins();
+      }
+      memcpy(tensorOut, aValues, sizeof(*aValues) * cValues);
+      return;
+   }
+
+   const ptrdiff_t strideScore = aStrides[cDimensions];
+   size_t aiBins[k_cDimensionsMax];
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      aiBins[iDimension] = 0;
+   }
+   // we track the byte offset of the current cell instead of a pointer so that we never form a pointer outside of 
+   // tensorOut while moving between cells
+   ptrdiff_t offsetCell = 0;
+   const FloatEbmType * pValue = aValues;
+   while(true) {
+      ptrdiff_t offset = offsetCell;
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         *reinterpret_cast<FloatEbmType *>(reinterpret_cast<char *>(tensorOut) + offset) = *pValue;
+         ++pValue;
+         offset += strideScore;
+      }
+
+      // our tensors have the first feature changing fastest
+      size_t iDimension = 0;
+      while(true) {
+         if(cDimensions == iDimension) {
+            return;
+         }
+         const size_t cBins = aFeatureGroupEntries[iDimension].m_pFeature->GetCountBins();
+         ++aiBins[iDimension];
+         offsetCell += aStrides[iDimension];
+         if(cBins != aiBins[iDimension]) {
+            break;
+         }
+         offsetCell -= aStrides[iDimension] * static_cast<ptrdiff_t>(cBins);
+         aiBins[iDimension] = 0;
+         ++iDimension;
+      }
+   }
+}
+
+static IntEbmType CopyModelFeatureGroup(
+   const char * const sFunctionName,
+   const PEbmBoosting ebmBoosting,
+   const bool bBestModel,
+   const IntEbmType indexFeatureGroup,
+   const IntEbmType * const countBytesStrides,
+   FloatEbmType * const tensorOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered %s: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf ", countBytesStrides=%p, tensorOut=%p",
+      sFunctionName,
+      static_cast<void *>(ebmBoosting),
+      indexFeatureGroup,
+      static_cast<const void *>(countBytesStrides),
+      static_cast<void *>(tensorOut)
+   );
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_N(TraceLevelError, "ERROR %s ebmBoosting cannot be nullptr", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   if(indexFeatureGroup < 0) {
+      LOG_N(TraceLevelError, "ERROR %s indexFeatureGroup must be positive", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(indexFeatureGroup) || pEbmBoostingState->GetCountFeatureGroups() <= static_cast<size_t>(indexFeatureGroup)) {
+      LOG_N(TraceLevelError, "ERROR %s indexFeatureGroup above the number of feature groups that we have", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   const size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
+   SegmentedTensor * const * const apModel = bBestModel ? pEbmBoostingState->GetBestModel() : pEbmBoostingState->GetCurrentModel();
+   if(nullptr == apModel) {
+      // classification with 0 or 1 target classes has models with zero logits, so there is nothing to write.  See 
+      // GetBestModelFeatureGroup
+      LOG_N(TraceLevelInfo, "Exited %s no model", sFunctionName);
+      return IntEbmType { 0 };
+   }
+   if(nullptr == tensorOut) {
+      LOG_N(TraceLevelError, "ERROR %s tensorOut cannot be nullptr", sFunctionName);
+      return IntEbmType { 1 };
+   }
+
+   const FeatureGroup * const pFeatureGroup = pEbmBoostingState->GetFeatureGroups()[iFeatureGroup];
+   ptrdiff_t aStrides[k_cDimensionsMax + 1];
+   if(nullptr != countBytesStrides) {
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+      for(size_t iStride = 0; iStride <= cDimensions; ++iStride) {
+         const IntEbmType countBytesStride = countBytesStrides[iStride];
+         if(!IsNumberConvertable<ptrdiff_t>(countBytesStride)) {
+            LOG_N(TraceLevelError, "ERROR %s countBytesStrides has a stride that we can't address", sFunctionName);
+            return IntEbmType { 1 };
+         }
+         aStrides[iStride] = static_cast<ptrdiff_t>(countBytesStride);
+      }
+   }
+
+   SegmentedTensor * const pModel = apModel[iFeatureGroup];
+   EBM_ASSERT(nullptr != pModel);
+   EBM_ASSERT(pModel->GetExpanded()); // the model should have been expanded at startup
+   CopyModelTensor(
+      pFeatureGroup,
+      GetVectorLength(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()),
+      pModel->GetValuePointer(),
+      nullptr == countBytesStrides ? nullptr : aStrides,
+      tensorOut
+   );
+
+   LOG_N(TraceLevelInfo, "Exited %s", sFunctionName);
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CopyBestModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   const IntEbmType * countBytesStrides,
+   FloatEbmType * tensorOut
+) {
+   return CopyModelFeatureGroup("CopyBestModelFeatureGroup", ebmBoosting, true, indexFeatureGroup, countBytesStrides, tensorOut);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CopyCurrentModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   const IntEbmType * countBytesStrides,
+   FloatEbmType * tensorOut
+) {
+   return CopyModelFeatureGroup("CopyCurrentModelFeatureGroup", ebmBoosting, false, indexFeatureGroup, countBytesStrides, tensorOut);
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION MergeBestModelFeatureGroup(
+   IntEbmType countBoosters,
+   const PEbmBoosting * ebmBoostings,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType * meanOut,
+   FloatEbmType * standardDeviationOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered MergeBestModelFeatureGroup: countBoosters=%" IntEbmTypePrintf ", ebmBoostings=%p, indexFeatureGroup=%" 
+      IntEbmTypePrintf ", meanOut=%p, standardDeviationOut=%p",
+      countBoosters,
+      static_cast<const void *>(ebmBoostings),
+      indexFeatureGroup,
+      static_cast<void *>(meanOut),
+      static_cast<void *>(standardDeviationOut)
+   );
+
+   if(countBoosters <= 0 || !IsNumberConvertable<size_t>(countBoosters)) {
+      LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup countBoosters must be positive");
+      return IntEbmType { 1 };
+   }
+   const size_t cBoosters = static_cast<size_t>(countBoosters);
+   if(nullptr == ebmBoostings) {
+      LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup ebmBoostings cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(indexFeatureGroup < 0 || !IsNumberConvertable<size_t>(indexFeatureGroup)) {
+      LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup indexFeatureGroup must be positive");
+      return IntEbmType { 1 };
+   }
+   const size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
+
+   // the outer bags of one model share their features and feature groups but not their samples, so we only require 
+   // the tensors to have the same shape
+   const EbmBoostingState * const pEbmBoostingStateFirst = reinterpret_cast<const EbmBoostingState *>(ebmBoostings[0]);
+   for(size_t iBooster = 0; iBooster < cBoosters; ++iBooster) {
+      const EbmBoostingState * const pEbmBoostingState = reinterpret_cast<const EbmBoostingState *>(ebmBoostings[iBooster]);
+      if(nullptr == pEbmBoostingState) {
+         LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup ebmBoostings cannot contain nullptr");
+         return IntEbmType { 1 };
+      }
+      if(pEbmBoostingState->GetCountFeatureGroups() <= iFeatureGroup) {
+         LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup indexFeatureGroup above the number of feature groups that we have");
+         return IntEbmType { 1 };
+      }
+      if(pEbmBoostingStateFirst->GetRuntimeLearningTypeOrCountTargetClasses() != 
+         pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()) 
+      {
+         LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup the boosters need to have the same learning type");
+         return IntEbmType { 1 };
+      }
+      const FeatureGroup * const pFeatureGroupFirst = pEbmBoostingStateFirst->GetFeatureGroups()[iFeatureGroup];
+      const FeatureGroup * const pFeatureGroup = pEbmBoostingState->GetFeatureGroups()[iFeatureGroup];
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+      if(pFeatureGroupFirst->GetCountFeatures() != cDimensions) {
+         LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup the feature groups need to have the same features");
+         return IntEbmType { 1 };
+      }
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         if(pFeatureGroupFirst->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins() != 
+            pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins()) 
+         {
+            LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup the feature groups need to have the same bins");
+            return IntEbmType { 1 };
+         }
+      }
+   }
 
-      LOG_0(TraceLevelInfo, "Exited GetBestModelFeatureGroup no model");
-      return nullptr;
+   if(nullptr == pEbmBoostingStateFirst->GetBestModel()) {
+      // classification with 0 or 1 target classes has no logits, so there is nothing to write.  See 
+      // GetBestModelFeatureGroup
+      LOG_0(TraceLevelInfo, "Exited MergeBestModelFeatureGroup no model");
+      return IntEbmType { 0 };
+   }
+   if(nullptr == meanOut) {
+      LOG_0(TraceLevelError, "ERROR MergeBestModelFeatureGroup meanOut cannot be nullptr");
+      return IntEbmType { 1 };
    }
 
-   SegmentedTensor * pBestModel = pEbmBoostingState->GetBestModel()[iFeatureGroup];
-   EBM_ASSERT(nullptr != pBestModel);
-   EBM_ASSERT(pBestModel->GetExpanded()); // the model should have been expanded at startup
-   FloatEbmType * pRet = pBestModel->GetValuePointer();
-   EBM_ASSERT(nullptr != pRet);
+   const FeatureGroup * const pFeatureGroup = pEbmBoostingStateFirst->GetFeatureGroups()[iFeatureGroup];
+   size_t cValues = GetVectorLength(pEbmBoostingStateFirst->GetRuntimeLearningTypeOrCountTargetClasses());
+   for(size_t iDimension = 0; iDimension < pFeatureGroup->GetCountFeatures(); ++iDimension) {
+      // our models have this many values already, so this can't overflow
+      cValues *= pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+   }
 
-   LOG_N(TraceLevelInfo, "Exited GetBestModelFeatureGroup %p", static_cast<void *>(pRet));
-   return pRet;
+   // we sum the boosters in order and take the deviations from the mean in a second pass, which is exact for identical 
+   // models and matches numpy's average and std (with ddof=0) to within rounding
+   const FloatEbmType countBoostersFloat = static_cast<FloatEbmType>(cBoosters);
+   for(size_t iValue = 0; iValue < cValues; ++iValue) {
+      FloatEbmType sum = FloatEbmType { 0 };
+      for(size_t iBooster = 0; iBooster < cBoosters; ++iBooster) {
+         const EbmBoostingState * const pEbmBoostingState = reinterpret_cast<const EbmBoostingState *>(ebmBoostings[iBooster]);
+         sum += pEbmBoostingState->GetBestModel()[iFeatureGroup]->GetValuePointer()[iValue];
+      }
+      const FloatEbmType mean = sum / countBoostersFloat;
+      meanOut[iValue] = mean;
+      if(nullptr != standardDeviationOut) {
+         FloatEbmType sumSquares = FloatEbmType { 0 };
+         for(size_t iBooster = 0; iBooster < cBoosters; ++iBooster) {
+            const EbmBoostingState * const pEbmBoostingState = reinterpret_cast<const EbmBoostingState *>(ebmBoostings[iBooster]);
+            const FloatEbmType deviation = pEbmBoostingState->GetBestModel()[iFeatureGroup]->GetValuePointer()[iValue] - mean;
+            sumSquares += deviation * deviation;
+         }
+         standardDeviationOut[iValue] = std::sqrt(sumSquares / countBoostersFloat);
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited MergeBestModelFeatureGroup");
+   return IntEbmType { 0 };
 }
 
-EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetCurrentModelFeatureGroup(
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingPackedData(
    PEbmBoosting ebmBoosting,
-   IntEbmType indexFeatureGroup
+   const char * trainingFilePath,
+   const char * validationFilePath
 ) {
-   LOG_N(
-      TraceLevelInfo, 
-      "Entered GetCurrentModelFeatureGroup: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf, 
+   LOG_N(TraceLevelInfo, "Entered SaveBoostingPackedData: ebmBoosting=%p, trainingFilePath=%p, validationFilePath=%p", 
       static_cast<void *>(ebmBoosting), 
-      indexFeatureGroup
+      static_cast<const void *>(trainingFilePath), 
+      static_cast<const void *>(validationFilePath)
    );
 
    EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
    if(nullptr == pEbmBoostingState) {
-      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup ebmBoosting cannot be nullptr");
+      LOG_0(TraceLevelError, "ERROR SaveBoostingPackedData ebmBoosting cannot be nullptr");
+      return 1;
+   }
+   // the bit packed data doesn't change after initialization, so we can save it even while boosting is running
+   if(nullptr != trainingFilePath) {
+      if(pEbmBoostingState->GetTrainingSet()->Save(trainingFilePath, pEbmBoostingState->GetFeatureGroups())) {
+         LOG_0(TraceLevelWarning, "WARNING SaveBoostingPackedData GetTrainingSet()->Save");
+         return 1;
+      }
+   }
+   if(nullptr != validationFilePath) {
+      if(pEbmBoostingState->GetValidationSet()->Save(validationFilePath, pEbmBoostingState->GetFeatureGroups())) {
+         LOG_0(TraceLevelWarning, "WARNING SaveBoostingPackedData GetValidationSet()->Save");
+         return 1;
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited SaveBoostingPackedData");
+   return 0;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingModel(
+   PEbmBoosting ebmBoosting,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   const FloatEbmType * intercept,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered SaveBoostingModel: ebmBoosting=%p, countBinCuts=%p, binCutsLowerBoundInclusive=%p, "
+      "intercept=%p, filePath=%p",
+      static_cast<void *>(ebmBoosting),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      static_cast<const void *>(intercept),
+      static_cast<const void *>(filePath)
+   );
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR SaveBoostingModel ebmBoosting cannot be nullptr");
+      return 1;
+   }
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR SaveBoostingModel filePath cannot be nullptr");
+      return 1;
+   }
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cFeatures = pEbmBoostingState->GetCountFeatures();
+   const size_t cFeatureGroups = pEbmBoostingState->GetCountFeatureGroups();
+   const Feature * const aFeatures = pEbmBoostingState->GetFeatures();
+   const FeatureGroup * const * const apFeatureGroups = pEbmBoostingState->GetFeatureGroups();
+   // classification with 0 or 1 target classes has no model, so it saves no tensors
+   SegmentedTensor * const * const apBestModel = pEbmBoostingState->GetBestModel();
+
+   size_t cFeatureGroupIndexes = 0;
+   size_t cTensorValues = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroups[iFeatureGroup];
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+      cFeatureGroupIndexes += cDimensions;
+      if(nullptr != apBestModel) {
+         // we already hold these tensors in memory, so their sizes can't overflow
+         size_t cTensorBins = cVectorLength;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            cTensorBins *= pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+         }
+         cTensorValues += cTensorBins;
+      }
+   }
+
+   // EbmMalloc can return nullptr for zero items, so we allocate at least one of each
+   EbmNativeFeature * const aNativeFeatures = EbmMalloc<EbmNativeFeature>(0 == cFeatures ? size_t { 1 } : cFeatures);
+   EbmNativeFeatureGroup * const aNativeFeatureGroups = 
+      EbmMalloc<EbmNativeFeatureGroup>(0 == cFeatureGroups ? size_t { 1 } : cFeatureGroups);
+   IntEbmType * const aFeatureGroupIndexes = EbmMalloc<IntEbmType>(0 == cFeatureGroupIndexes ? size_t { 1 } : cFeatureGroupIndexes);
+   FloatEbmType * const aTensors = EbmMalloc<FloatEbmType>(0 == cTensorValues ? size_t { 1 } : cTensorValues);
+
+   IntEbmType ret = 1;
+   if(nullptr == aNativeFeatures || nullptr == aNativeFeatureGroups || nullptr == aFeatureGroupIndexes || nullptr == aTensors) {
+      LOG_0(TraceLevelWarning, "WARNING SaveBoostingModel out of memory");
+   } else {
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const Feature * const pFeature = &aFeatures[iFeature];
+         aNativeFeatures[iFeature].featureType = FeatureType::Nominal == pFeature->GetFeatureType() ? 
+            FeatureTypeNominal : FeatureTypeOrdinal;
+         aNativeFeatures[iFeature].hasMissing = pFeature->GetIsMissing() ? EBM_TRUE : EBM_FALSE;
+         aNativeFeatures[iFeature].countBins = static_cast<IntEbmType>(pFeature->GetCountBins());
+      }
+      IntEbmType * pFeatureGroupIndex = aFeatureGroupIndexes;
+      FloatEbmType * pTensor = aTensors;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = apFeatureGroups[iFeatureGroup];
+         const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+         aNativeFeatureGroups[iFeatureGroup].countFeaturesInGroup = static_cast<IntEbmType>(cDimensions);
+         size_t cTensorBins = cVectorLength;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const Feature * const pFeature = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature;
+            *pFeatureGroupIndex = static_cast<IntEbmType>(pFeature->GetIndexFeatureData());
+            ++pFeatureGroupIndex;
+            cTensorBins *= pFeature->GetCountBins();
+         }
+         if(nullptr != apBestModel) {
+            EBM_ASSERT(apBestModel[iFeatureGroup]->GetExpanded()); // the model should have been expanded at startup
+            CopyModelTensor(pFeatureGroup, cVectorLength, apBestModel[iFeatureGroup]->GetValuePointer(), nullptr, pTensor);
+            pTensor += cTensorBins;
+         }
+      }
+
+      if(ModelFile::Write(filePath, runtimeLearningTypeOrCountTargetClasses, cFeatures, aNativeFeatures, countBinCuts, 
+         binCutsLowerBoundInclusive, cFeatureGroups, aNativeFeatureGroups, aFeatureGroupIndexes, aTensors, intercept)
+      ) {
+         LOG_0(TraceLevelWarning, "WARNING SaveBoostingModel ModelFile::Write");
+      } else {
+         ret = 0;
+      }
+   }
+   free(aTensors);
+   free(aFeatureGroupIndexes);
+   free(aNativeFeatureGroups);
+   free(aNativeFeatures);
+
+   LOG_N(TraceLevelInfo, "Exited SaveBoostingModel %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+static PackedData * PackBinnedData(
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const size_t cSamples,
+   const IntEbmType * const binnedData,
+   const EbmNativeBinnedColumn * const columns
+) {
+   // the packed data needs to be bit packed the way a default booster would pack it, so let a booster without any 
+   // samples check the features and feature groups and work out the packing for us
+   EbmBoostingState * const pEbmBoostingState = AllocateBoosting(
+      0, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      k_regression, 
+      0, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      0, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      0,
+      nullptr
+   );
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelWarning, "WARNING PackBinnedData nullptr == pEbmBoostingState");
       return nullptr;
    }
-   if(indexFeatureGroup < 0) {
-      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup must be positive");
+
+   PackedData * pPackedData = nullptr;
+   DataSetByFeatureGroup dataSet;
+   dataSet.InitializeZero();
+   if(dataSet.Initialize(
+      false, 
+      false, 
+      false, 
+      false, 
+      false, 
+      pEbmBoostingState->GetCountFeatureGroups(), 
+      pEbmBoostingState->GetFeatureGroups(), 
+      cSamples, 
+      binnedData, 
+      columns, 
+      nullptr, 
+      nullptr, 
+      k_regression, 
+      nullptr, 
+      nullptr, 
+      nullptr
+   )) {
+      LOG_0(TraceLevelWarning, "WARNING PackBinnedData dataSet.Initialize");
+   } else {
+      pPackedData = dataSet.CreatePackedData(pEbmBoostingState->GetFeatureGroups());
+   }
+   dataSet.Destruct();
+   EbmBoostingState::Free(pEbmBoostingState);
+   return pPackedData;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmPackedData EBM_NATIVE_CALLING_CONVENTION CreatePackedData(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData
+) {
+   LOG_N(TraceLevelInfo, "Entered CreatePackedData: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countSamples=%" IntEbmTypePrintf ", binnedData=%p",
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countSamples, 
+      static_cast<const void *>(binnedData)
+   );
+
+   if(countSamples <= 0) {
+      LOG_0(TraceLevelError, "ERROR CreatePackedData countSamples must be positive");
       return nullptr;
    }
-   if(!IsNumberConvertable<size_t>(indexFeatureGroup)) {
-      // we wouldn't have allowed the creation of an feature set larger than size_t
-      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup is too high to index");
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      // the caller should not have been able to allocate enough memory in "binnedData" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR CreatePackedData !IsNumberConvertable<size_t>(countSamples)");
       return nullptr;
    }
-   size_t iFeatureGroup = static_cast<size_t>(indexFeatureGroup);
-   if(pEbmBoostingState->GetCountFeatureGroups() <= iFeatureGroup) {
-      LOG_0(TraceLevelError, "ERROR GetCurrentModelFeatureGroup indexFeatureGroup above the number of feature groups that we have");
+   if(0 != countFeatures && nullptr == binnedData) {
+      LOG_0(TraceLevelError, "ERROR CreatePackedData binnedData cannot be nullptr if 0 < countFeatures");
       return nullptr;
    }
-   if(nullptr == pEbmBoostingState->GetCurrentModel()) {
-      // if pEbmBoostingState->m_apCurrentModel is nullptr, then either:
-      //    1) m_cFeatureGroups was 0, in which case this function would have undefined behavior since the caller needs to indicate a valid 
-      //       indexFeatureGroup, which is impossible, so we can do anything we like, include the below actions.
-      //    2) m_runtimeLearningTypeOrCountTargetClasses was either 1 or 0 (and the learning type is classification), which is legal, 
-      //       which we need to handle here
-      // for classification, if there is only 1 possible target class, then the probability of that class is 100%.  If there were logits 
-      // in this model, they'd all be infinity, but you could alternatively think of this model as having zero logits, since the number of 
-      // logits can be one less than the number of target classification classes.  A model with zero logits is empty, and has zero items.  
-      // We want to return a tensor with 0 items in it, so we could either return a pointer to some random memory that can't be accessed, 
-      // or we can return nullptr.  We return a nullptr in the hopes that our caller will either handle it or throw a nicer exception.
+   const size_t cSamples = static_cast<size_t>(countSamples);
 
-      LOG_0(TraceLevelInfo, "Exited GetCurrentModelFeatureGroup no model");
+   PackedData * const pPackedData = PackBinnedData(
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      cSamples, 
+      binnedData, 
+      nullptr
+   );
+
+   const PEbmPackedData packedData = reinterpret_cast<PEbmPackedData>(pPackedData);
+   LOG_N(TraceLevelInfo, "Exited CreatePackedData %p", static_cast<void *>(packedData));
+   return packedData;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmPackedData EBM_NATIVE_CALLING_CONVENTION CreatePackedDataFromColumns(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples,
+   const EbmNativeBinnedColumn * columns
+) {
+   LOG_N(TraceLevelInfo, "Entered CreatePackedDataFromColumns: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countSamples=%" IntEbmTypePrintf ", columns=%p",
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countSamples, 
+      static_cast<const void *>(columns)
+   );
+
+   if(countSamples <= 0) {
+      LOG_0(TraceLevelError, "ERROR CreatePackedDataFromColumns countSamples must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR CreatePackedDataFromColumns !IsNumberConvertable<size_t>(countSamples)");
       return nullptr;
    }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(0 != countFeatures) {
+      // AllocateBoosting checks countFeatures for us, but we need to read the columns before then
+      if(countFeatures < 0 || !IsNumberConvertable<size_t>(countFeatures)) {
+         LOG_0(TraceLevelError, "ERROR CreatePackedDataFromColumns countFeatures must be positive and fit in memory");
+         return nullptr;
+      }
+      if(IsColumnsInvalid(static_cast<size_t>(countFeatures), columns, cSamples)) {
+         LOG_0(TraceLevelError, "ERROR CreatePackedDataFromColumns IsColumnsInvalid");
+         return nullptr;
+      }
+   }
 
-   SegmentedTensor * pCurrentModel = pEbmBoostingState->GetCurrentModel()[iFeatureGroup];
-   EBM_ASSERT(nullptr != pCurrentModel);
-   EBM_ASSERT(pCurrentModel->GetExpanded()); // the model should have been expanded at startup
-   FloatEbmType * pRet = pCurrentModel->GetValuePointer();
-   EBM_ASSERT(nullptr != pRet);
+   PackedData * const pPackedData = PackBinnedData(
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      cSamples, 
+      nullptr, 
+      columns
+   );
 
-   LOG_N(TraceLevelInfo, "Exited GetCurrentModelFeatureGroup %p", static_cast<void *>(pRet));
-   return pRet;
+   const PEbmPackedData packedData = reinterpret_cast<PEbmPackedData>(pPackedData);
+   LOG_N(TraceLevelInfo, "Exited CreatePackedDataFromColumns %p", static_cast<void *>(packedData));
+   return packedData;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmPackedDataBuilder EBM_NATIVE_CALLING_CONVENTION BeginPackedData(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples
+) {
+   LOG_N(TraceLevelInfo, "Entered BeginPackedData: countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" 
+      IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countSamples=%" IntEbmTypePrintf,
+      countFeatures, 
+      static_cast<const void *>(features), 
+      countFeatureGroups, 
+      static_cast<const void *>(featureGroups), 
+      static_cast<const void *>(featureGroupIndexes), 
+      countSamples
+   );
+
+   if(countSamples <= 0) {
+      LOG_0(TraceLevelError, "ERROR BeginPackedData countSamples must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR BeginPackedData !IsNumberConvertable<size_t>(countSamples)");
+      return nullptr;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+
+   // like PackBinnedData, a booster without any samples checks the features and feature groups for us
+   EbmBoostingState * const pEbmBoostingState = AllocateBoosting(
+      0, 
+      countFeatures, 
+      features, 
+      countFeatureGroups, 
+      featureGroups, 
+      featureGroupIndexes, 
+      nullptr, 
+      k_regression, 
+      0, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      0, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      nullptr, 
+      0,
+      nullptr
+   );
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelWarning, "WARNING BeginPackedData nullptr == pEbmBoostingState");
+      return nullptr;
+   }
+
+   // PackedDataBuilder::Allocate owns pEbmBoostingState now, even if it fails
+   PackedDataBuilder * const pPackedDataBuilder = PackedDataBuilder::Allocate(pEbmBoostingState, cSamples);
+
+   const PEbmPackedDataBuilder packedDataBuilder = reinterpret_cast<PEbmPackedDataBuilder>(pPackedDataBuilder);
+   LOG_N(TraceLevelInfo, "Exited BeginPackedData %p", static_cast<void *>(packedDataBuilder));
+   return packedDataBuilder;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendPackedData(
+   PEbmPackedDataBuilder packedDataBuilder,
+   IntEbmType countSamples,
+   const EbmNativeBinnedColumn * columns
+) {
+   LOG_N(TraceLevelInfo, "Entered AppendPackedData: packedDataBuilder=%p, countSamples=%" IntEbmTypePrintf ", columns=%p",
+      static_cast<void *>(packedDataBuilder), 
+      countSamples, 
+      static_cast<const void *>(columns)
+   );
+
+   PackedDataBuilder * const pPackedDataBuilder = reinterpret_cast<PackedDataBuilder *>(packedDataBuilder);
+   if(nullptr == pPackedDataBuilder) {
+      LOG_0(TraceLevelError, "ERROR AppendPackedData packedDataBuilder cannot be nullptr");
+      return 1;
+   }
+   if(countSamples <= 0) {
+      // an empty chunk is harmless, since a reader can return one at the end of its data
+      if(0 == countSamples) {
+         LOG_0(TraceLevelInfo, "INFO AppendPackedData empty chunk");
+         return 0;
+      }
+      LOG_0(TraceLevelError, "ERROR AppendPackedData countSamples cannot be negative");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR AppendPackedData !IsNumberConvertable<size_t>(countSamples)");
+      return 1;
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   const size_t cFeatures = pPackedDataBuilder->GetCountFeatures();
+   if(0 != cFeatures && IsColumnsInvalid(cFeatures, columns, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR AppendPackedData IsColumnsInvalid");
+      return 1;
+   }
+   if(pPackedDataBuilder->Append(cSamples, columns)) {
+      LOG_0(TraceLevelWarning, "WARNING AppendPackedData pPackedDataBuilder->Append");
+      return 1;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited AppendPackedData");
+   return 0;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmPackedData EBM_NATIVE_CALLING_CONVENTION FinishPackedData(
+   PEbmPackedDataBuilder packedDataBuilder
+) {
+   LOG_N(TraceLevelInfo, "Entered FinishPackedData: packedDataBuilder=%p", static_cast<void *>(packedDataBuilder));
+
+   const PackedDataBuilder * const pPackedDataBuilder = reinterpret_cast<const PackedDataBuilder *>(packedDataBuilder);
+   if(nullptr == pPackedDataBuilder) {
+      LOG_0(TraceLevelError, "ERROR FinishPackedData packedDataBuilder cannot be nullptr");
+      return nullptr;
+   }
+   PackedData * const pPackedData = pPackedDataBuilder->Finish();
+
+   const PEbmPackedData packedData = reinterpret_cast<PEbmPackedData>(pPackedData);
+   LOG_N(TraceLevelInfo, "Exited FinishPackedData %p", static_cast<void *>(packedData));
+   return packedData;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreePackedDataBuilder(
+   PEbmPackedDataBuilder packedDataBuilder
+) {
+   LOG_N(TraceLevelInfo, "Entered FreePackedDataBuilder: packedDataBuilder=%p", static_cast<void *>(packedDataBuilder));
+
+   PackedDataBuilder::Free(reinterpret_cast<PackedDataBuilder *>(packedDataBuilder));
+
+   LOG_0(TraceLevelInfo, "Exited FreePackedDataBuilder");
 }
 
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeBoosting(
@@ -1010,8 +3666,83 @@ EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeBoosting(
 
    EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
 
+   if(nullptr != pEbmBoostingState) {
+      // our caller might not have finished all the asynchronous work that uses this booster
+      ThreadPool::WaitForSerializationKey(ebmBoosting);
+   }
+
    // it's legal to call free on nullptr, just like for free().  This is checked inside EbmBoostingState::Free()
    EbmBoostingState::Free(pEbmBoostingState);
 
    LOG_0(TraceLevelInfo, "Exited FreeBoosting");
 }
+
+#ifdef EBM_PERFORMANCE_COUNTERS
+extern uint64_t GetPerformanceCounterNanoseconds() {
+   // steady_clock never goes backwards, which matters more to us than matching the wall clock
+   return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+#endif // EBM_PERFORMANCE_COUNTERS
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetPerformanceCounters(
+   PEbmBoosting ebmBoosting,
+   IntEbmType performanceCounter,
+   IntEbmType * countCallsOut,
+   IntEbmType * countNanosecondsOut,
+   IntEbmType * countBytesScannedOut
+) {
+   LOG_N(TraceLevelInfo, "Entered GetPerformanceCounters: ebmBoosting=%p, performanceCounter=%" IntEbmTypePrintf 
+      ", countCallsOut=%p, countNanosecondsOut=%p, countBytesScannedOut=%p", 
+      static_cast<void *>(ebmBoosting), 
+      performanceCounter, 
+      static_cast<void *>(countCallsOut), 
+      static_cast<void *>(countNanosecondsOut), 
+      static_cast<void *>(countBytesScannedOut)
+   );
+
+   if(nullptr != countCallsOut) {
+      *countCallsOut = 0;
+   }
+   if(nullptr != countNanosecondsOut) {
+      *countNanosecondsOut = 0;
+   }
+   if(nullptr != countBytesScannedOut) {
+      *countBytesScannedOut = 0;
+   }
+
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR GetPerformanceCounters ebmBoosting cannot be nullptr");
+      return 1;
+   }
+   if(performanceCounter < 0 || static_cast<IntEbmType>(k_cPerformanceCounters) <= performanceCounter) {
+      LOG_0(TraceLevelError, "ERROR GetPerformanceCounters performanceCounter is not a valid PerformanceCounter* value");
+      return 1;
+   }
+
+#ifdef EBM_PERFORMANCE_COUNTERS
+   const PerformanceCounterValues * const pValues = pEbmBoostingState->GetPerformanceCounterValues(performanceCounter);
+   const uint64_t cCalls = pValues->m_cCalls.load(std::memory_order_relaxed);
+   const uint64_t cNanoseconds = pValues->m_cNanoseconds.load(std::memory_order_relaxed);
+   const uint64_t cBytesScanned = pValues->m_cBytesScanned.load(std::memory_order_relaxed);
+   if(nullptr != countCallsOut) {
+      *countCallsOut = IsNumberConvertable<IntEbmType>(cCalls) ?
+         static_cast<IntEbmType>(cCalls) : std::numeric_limits<IntEbmType>::max();
+   }
+   if(nullptr != countNanosecondsOut) {
+      *countNanosecondsOut = IsNumberConvertable<IntEbmType>(cNanoseconds) ?
+         static_cast<IntEbmType>(cNanoseconds) : std::numeric_limits<IntEbmType>::max();
+   }
+   if(nullptr != countBytesScannedOut) {
+      *countBytesScannedOut = IsNumberConvertable<IntEbmType>(cBytesScanned) ?
+         static_cast<IntEbmType>(cBytesScanned) : std::numeric_limits<IntEbmType>::max();
+   }
+
+   LOG_0(TraceLevelInfo, "Exited GetPerformanceCounters");
+   return 0;
+#else // EBM_PERFORMANCE_COUNTERS
+   LOG_0(TraceLevelInfo, "INFO GetPerformanceCounters the library was compiled without EBM_PERFORMANCE_COUNTERS");
+   return 1;
+#endif // EBM_PERFORMANCE_COUNTERS
+}
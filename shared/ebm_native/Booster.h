@@ -6,6 +6,7 @@
 #define EBM_BOOSTING_STATE_H
 
 #include <stdlib.h> // free
+#include <string.h> // memset
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 
@@ -25,6 +26,17 @@
 #include "DataSetBoosting.h"
 // samples is somewhat independent from datasets, but relies on an indirect coupling with them
 #include "SamplingSet.h"
+#include "SimdKernels.h"
+#include "PerformanceCounters.h"
+
+// we cap the number of BinBoosting shards since each one beyond the first requires it's own histogram
+constexpr size_t k_cBoostingShardsMax = 256;
+// each slot beyond the first requires it's own copy of the per-bag resources
+constexpr size_t k_cBoostingSlotsMax = 64;
+// a pair sweep costs a handful of tensor lookups per cut combination, so fewer than this isn't worth a thread
+constexpr size_t k_cPairCutsPerTaskDefault = 4096;
+// a skipped feature group is boosted again after this many rounds in case it has started to matter
+constexpr size_t k_cScheduleReprobeRoundsDefault = 10;
 
 class EbmBoostingState final {
    ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
@@ -40,20 +52,73 @@ class EbmBoostingState final {
 
    size_t m_cSamplingSets;
    SamplingSet ** m_apSamplingSets;
+   // the fraction of the training samples in each bag when we sample without replacement, or 0 with replacement.  We 
+   // keep it to redraw the bags when training samples are appended
+   FloatEbmType m_fractionIncluded;
+   // true if bags with replacement draw in parallel blocks, which we also need to redraw the bags the same way
+   bool m_bBlockDraws;
 
    SegmentedTensor ** m_apCurrentModel;
    SegmentedTensor ** m_apBestModel;
 
+   // the feature groups whose current model changed since we last copied the current model into the best model.  
+   // m_aiChangedFeatureGroups lists them and m_abChangedFeatureGroup makes sure each one appears only once, so an 
+   // improving step only copies what changed instead of every SegmentedTensor in the model
+   size_t m_cChangedFeatureGroups;
+   size_t * m_aiChangedFeatureGroups;
+   bool * m_abChangedFeatureGroup;
+
    FloatEbmType m_bestModelMetric;
 
-   // m_pSmallChangeToModelOverwriteSingleSamplingSet, m_pSmallChangeToModelAccumulatedFromSamplingSets and m_aEquivalentSplits should eventually move into 
-   // the per-chunk class and we'll need a per-chunk m_randomStream that is initialized with it's own predictable seed 
-   SegmentedTensor * m_pSmallChangeToModelOverwriteSingleSamplingSet;
-   SegmentedTensor * m_pSmallChangeToModelAccumulatedFromSamplingSets;
+   // if m_bDeferValidation is set, model updates that are applied without asking for the validation metric are summed 
+   // into m_apPendingValidationUpdates, and the next request for the metric applies all of them to the validation set 
+   // in a single pass.  m_aiPendingFeatureGroups lists the feature groups with pending updates and 
+   // m_abPendingFeatureGroup makes sure each one appears only once
+   bool m_bDeferValidation;
+   SegmentedTensor ** m_apPendingValidationUpdates;
+   size_t m_cPendingFeatureGroups;
+   size_t * m_aiPendingFeatureGroups;
+   bool * m_abPendingFeatureGroup;
+
+   // if m_aScheduleGains is not nullptr BoostingRun skips the feature groups whose last gain was below 
+   // m_scheduleGainFraction times the largest last gain of any group.  m_acScheduleRoundsSkipped counts the rounds
+   // that each group has been skipped in a row, and a group is boosted once that reaches m_cScheduleReprobeRounds
+   FloatEbmType m_scheduleGainFraction;
+   size_t m_cScheduleReprobeRounds;
+   FloatEbmType * m_aScheduleGains;
+   size_t * m_acScheduleRoundsSkipped;
+
+   // each slot can generate a model update at the same time as the other slots, so each one accumulates it's update 
+   // into it's own tensor.  m_apSmallChangeToModelAccumulatedFromSamplingSets has m_cSlots items
+   size_t m_cSlots;
+   SegmentedTensor ** m_apSmallChangeToModelAccumulatedFromSamplingSets;
+
+   // we have one CachedBoostingThreadResources per inner bag (or 1 if there is no inner bagging) so that the inner bags 
+   // can be boosted in parallel.  Each one holds the per-bag m_pSmallChangeToModelOverwriteSingleSamplingSet and RandomStream.  
+   // Every slot has it's own set of them, with the bags of slot iSlot starting at iSlot * m_cCachedThreadResourcesPerSlot
+   size_t m_cCachedThreadResourcesPerSlot;
+   CachedBoostingThreadResources ** m_apCachedThreadResources;
+
+   // this stream is only used to generate our sampling sets and the seeds of the per-bag streams
+   RandomStream m_randomStream;
 
-   CachedBoostingThreadResources * m_pCachedThreadResources;
+   size_t m_cShards;
 
-   RandomStream m_randomStream;
+   // the fewest cut combinations that each task of a parallel pair sweep evaluates, or 0 to sweep pairs serially
+   size_t m_cPairCutsPerTask;
+
+   // nullptr if we apply model updates with our scalar code
+   const SimdKernels * m_pSimdKernels;
+
+   // if m_histogramReduceFunction is not nullptr our training samples are one shard of a dataset that is spread over 
+   // several nodes, and every histogram is summed with the histograms of the other nodes before we look for splits
+   HISTOGRAM_REDUCE_FUNCTION m_histogramReduceFunction;
+   void * m_histogramReduceContext;
+
+#ifdef EBM_PERFORMANCE_COUNTERS
+   // k_cPerformanceCounters items
+   PerformanceCounterValues * m_aPerformanceCounters;
+#endif // EBM_PERFORMANCE_COUNTERS
 
    static void DeleteSegmentedTensors(const size_t cFeatureGroups, SegmentedTensor ** const apSegmentedTensors);
 
@@ -84,22 +149,61 @@ public:
 
       m_cSamplingSets = 0;
       m_apSamplingSets = nullptr;
+      m_fractionIncluded = FloatEbmType { 0 };
+      m_bBlockDraws = false;
 
       m_apCurrentModel = nullptr;
       m_apBestModel = nullptr;
 
+      m_cChangedFeatureGroups = 0;
+      m_aiChangedFeatureGroups = nullptr;
+      m_abChangedFeatureGroup = nullptr;
+
       m_bestModelMetric = FloatEbmType { 0 };
 
-      m_pSmallChangeToModelOverwriteSingleSamplingSet = nullptr;
-      m_pSmallChangeToModelAccumulatedFromSamplingSets = nullptr;
+      m_bDeferValidation = false;
+      m_apPendingValidationUpdates = nullptr;
+      m_cPendingFeatureGroups = 0;
+      m_aiPendingFeatureGroups = nullptr;
+      m_abPendingFeatureGroup = nullptr;
+
+      m_scheduleGainFraction = FloatEbmType { 0 };
+      m_cScheduleReprobeRounds = k_cScheduleReprobeRoundsDefault;
+      m_aScheduleGains = nullptr;
+      m_acScheduleRoundsSkipped = nullptr;
+
+      m_cSlots = 0;
+      m_apSmallChangeToModelAccumulatedFromSamplingSets = nullptr;
 
-      m_pCachedThreadResources = nullptr;
+      m_cCachedThreadResourcesPerSlot = 0;
+      m_apCachedThreadResources = nullptr;
+
+      m_cShards = 1;
+
+      m_cPairCutsPerTask = k_cPairCutsPerTaskDefault;
+
+      m_pSimdKernels = nullptr;
+
+      m_histogramReduceFunction = nullptr;
+      m_histogramReduceContext = nullptr;
+
+#ifdef EBM_PERFORMANCE_COUNTERS
+      m_aPerformanceCounters = nullptr;
+#endif // EBM_PERFORMANCE_COUNTERS
    }
 
    INLINE_ALWAYS ptrdiff_t GetRuntimeLearningTypeOrCountTargetClasses() const {
       return m_runtimeLearningTypeOrCountTargetClasses;
    }
 
+   INLINE_ALWAYS size_t GetCountFeatures() const {
+      return m_cFeatures;
+   }
+
+   INLINE_ALWAYS const Feature * GetFeatures() const {
+      return m_aFeatures;
+   }
+
    INLINE_ALWAYS size_t GetCountFeatureGroups() const {
       return m_cFeatureGroups;
    }
@@ -132,6 +236,33 @@ public:
       return m_apBestModel;
    }
 
+   // call this whenever the current model of a feature group changes, or the best model won't pick up the change
+   INLINE_ALWAYS void SetFeatureGroupChanged(const size_t iFeatureGroup) {
+      EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+      EBM_ASSERT(nullptr != m_abChangedFeatureGroup);
+      EBM_ASSERT(nullptr != m_aiChangedFeatureGroups);
+      if(!m_abChangedFeatureGroup[iFeatureGroup]) {
+         m_abChangedFeatureGroup[iFeatureGroup] = true;
+         EBM_ASSERT(m_cChangedFeatureGroups < m_cFeatureGroups);
+         m_aiChangedFeatureGroups[m_cChangedFeatureGroups] = iFeatureGroup;
+         ++m_cChangedFeatureGroups;
+      }
+   }
+
+   INLINE_ALWAYS size_t GetCountChangedFeatureGroups() const {
+      return m_cChangedFeatureGroups;
+   }
+
+   INLINE_ALWAYS const size_t * GetChangedFeatureGroups() const {
+      return m_aiChangedFeatureGroups;
+   }
+
+   // forgets which feature groups changed without copying them, for when the best model is restored from elsewhere
+   void ClearChangedFeatureGroups();
+
+   // copies the changed feature groups of the current model into the best model.  Returns true on error
+   bool CopyChangedToBestModel();
+
    INLINE_ALWAYS FloatEbmType GetBestModelMetric() const {
       return m_bestModelMetric;
    }
@@ -140,21 +271,132 @@ public:
       m_bestModelMetric = bestModelMetric;
    }
 
-   INLINE_ALWAYS SegmentedTensor * GetSmallChangeToModelOverwriteSingleSamplingSet() {
-      return m_pSmallChangeToModelOverwriteSingleSamplingSet;
+   INLINE_ALWAYS bool IsValidationDeferred() const {
+      return m_bDeferValidation;
    }
 
-   INLINE_ALWAYS SegmentedTensor * GetSmallChangeToModelAccumulatedFromSamplingSets() {
-      return m_pSmallChangeToModelAccumulatedFromSamplingSets;
+   // adds the expanded tensor aModelFeatureGroupUpdateTensor to the updates that the validation set hasn't seen yet
+   void AddPendingValidationUpdate(const size_t iFeatureGroup, const FloatEbmType * const aModelFeatureGroupUpdateTensor);
+
+   INLINE_ALWAYS size_t GetCountPendingFeatureGroups() const {
+      return m_cPendingFeatureGroups;
+   }
+
+   INLINE_ALWAYS const size_t * GetPendingFeatureGroups() const {
+      return m_aiPendingFeatureGroups;
+   }
+
+   INLINE_ALWAYS SegmentedTensor * const * GetPendingValidationUpdates() const {
+      return m_apPendingValidationUpdates;
+   }
+
+   // call this once the validation set holds every pending update
+   void ClearPendingValidationUpdates();
+
+   INLINE_ALWAYS bool IsBoostingScheduled() const {
+      return nullptr != m_aScheduleGains;
    }
 
+   // the gain below which BoostingRun skips a feature group that isn't due to be probed again this round
+   FloatEbmType GetScheduleGainThreshold() const;
+
+   INLINE_ALWAYS bool IsFeatureGroupScheduled(const size_t iFeatureGroup, const FloatEbmType gainThreshold) const {
+      EBM_ASSERT(IsBoostingScheduled());
+      EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+      return gainThreshold <= m_aScheduleGains[iFeatureGroup] || 
+         m_cScheduleReprobeRounds <= m_acScheduleRoundsSkipped[iFeatureGroup];
+   }
+
+   INLINE_ALWAYS void SkipScheduledFeatureGroup(const size_t iFeatureGroup) {
+      EBM_ASSERT(IsBoostingScheduled());
+      EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+      ++m_acScheduleRoundsSkipped[iFeatureGroup];
+   }
+
+   // BoostingCheckpoint saves and restores these so that a resumed booster skips the same feature groups
+   INLINE_ALWAYS FloatEbmType * GetScheduleGains() {
+      return m_aScheduleGains;
+   }
+
+   INLINE_ALWAYS size_t * GetScheduleRoundsSkipped() {
+      return m_acScheduleRoundsSkipped;
+   }
+
+   INLINE_ALWAYS void SetScheduledFeatureGroupGain(const size_t iFeatureGroup, const FloatEbmType gain) {
+      EBM_ASSERT(IsBoostingScheduled());
+      EBM_ASSERT(iFeatureGroup < m_cFeatureGroups);
+      m_aScheduleGains[iFeatureGroup] = gain;
+      m_acScheduleRoundsSkipped[iFeatureGroup] = 0;
+   }
+
+   // appends cSamples training samples, scores them with the current model and redraws our bags over all of the 
+   // training samples.  aTargets holds IntEbmType for classification and FloatEbmType for regression.  
+   // aPredictorScores can be nullptr for zeros.  Returns true on error, in which case we keep our previous samples
+   bool AppendTrainingSamples(
+      const size_t cSamples,
+      const IntEbmType * const aBinnedData,
+      const void * const aTargets,
+      const FloatEbmType * const aPredictorScores
+   );
+
+   INLINE_ALWAYS size_t GetCountSlots() const {
+      return m_cSlots;
+   }
+
+   INLINE_ALWAYS size_t GetCountCachedThreadResourcesPerSlot() const {
+      return m_cCachedThreadResourcesPerSlot;
+   }
+
+   INLINE_ALWAYS SegmentedTensor * GetSmallChangeToModelAccumulatedFromSamplingSets(const size_t iSlot) {
+      EBM_ASSERT(iSlot < m_cSlots);
+      return m_apSmallChangeToModelAccumulatedFromSamplingSets[iSlot];
+   }
+
+   // the resources of the first bag of the first slot are also used for the work that happens outside of the bags, 
+   // like applying updates
    INLINE_ALWAYS CachedBoostingThreadResources * GetCachedThreadResources() const {
-      return m_pCachedThreadResources;
+      return m_apCachedThreadResources[0];
+   }
+
+   INLINE_ALWAYS CachedBoostingThreadResources * GetCachedThreadResources(const size_t iSlot, const size_t iSamplingSet) const {
+      EBM_ASSERT(iSlot < m_cSlots);
+      EBM_ASSERT(iSamplingSet < m_cCachedThreadResourcesPerSlot);
+      return m_apCachedThreadResources[iSlot * m_cCachedThreadResourcesPerSlot + iSamplingSet];
+   }
+
+   INLINE_ALWAYS size_t GetCountShards() const {
+      return m_cShards;
+   }
+
+   INLINE_ALWAYS size_t GetCountPairCutsPerTask() const {
+      return m_cPairCutsPerTask;
+   }
+
+   INLINE_ALWAYS const SimdKernels * GetSimdKernels() const {
+      return m_pSimdKernels;
+   }
+
+   INLINE_ALWAYS HISTOGRAM_REDUCE_FUNCTION GetHistogramReduceFunction() const {
+      return m_histogramReduceFunction;
+   }
+
+   INLINE_ALWAYS void * GetHistogramReduceContext() const {
+      return m_histogramReduceContext;
+   }
+
+   INLINE_ALWAYS void SetHistogramReduce(const HISTOGRAM_REDUCE_FUNCTION histogramReduceFunction, void * const histogramReduceContext) {
+      m_histogramReduceFunction = histogramReduceFunction;
+      m_histogramReduceContext = histogramReduceContext;
    }
 
-   INLINE_ALWAYS RandomStream * GetRandomStream() {
-      return &m_randomStream;
+#ifdef EBM_PERFORMANCE_COUNTERS
+   INLINE_ALWAYS PerformanceCounterValues * GetPerformanceCounterValues(const IntEbmType performanceCounter) {
+      EBM_ASSERT(0 <= performanceCounter);
+      EBM_ASSERT(static_cast<size_t>(performanceCounter) < k_cPerformanceCounters);
+      EBM_ASSERT(nullptr != m_aPerformanceCounters);
+      return &m_aPerformanceCounters[static_cast<size_t>(performanceCounter)];
    }
+#endif // EBM_PERFORMANCE_COUNTERS
 
    static void Free(EbmBoostingState * const pBoostingState);
 
@@ -170,11 +412,17 @@ public:
       const size_t cTrainingSamples, 
       const void * const aTrainingTargets, 
       const IntEbmType * const aTrainingBinnedData, 
+      PackedData * const pTrainingPackedData, 
+      const IntEbmType * const aTrainingSampleMask, 
       const FloatEbmType * const aTrainingPredictorScores, 
+      const IntEbmType * const aTrainingWeights, 
       const size_t cValidationSamples, 
       const void * const aValidationTargets, 
       const IntEbmType * const aValidationBinnedData, 
+      PackedData * const pValidationPackedData, 
+      const IntEbmType * const aValidationSampleMask, 
       const FloatEbmType * const aValidationPredictorScores,
+      const IntEbmType * const aValidationWeights,
       const IntEbmType randomSeed
    );
 };
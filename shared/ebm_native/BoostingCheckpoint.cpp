@@ -0,0 +1,475 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy, memcmp
+#include <stdio.h> // FILE, fopen, fwrite, fclose
+#include <limits> // std::numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "RandomStream.h"
+#include "SegmentedTensor.h"
+#include "FeatureAtomic.h"
+#include "FeatureGroup.h"
+#include "DataSetBoosting.h"
+#include "Booster.h"
+
+extern const char * MapFile(const char * const filePath, size_t * const pcBytesOut);
+extern void UnmapFile(const char * const pMapped, const size_t cBytes);
+
+// A checkpoint holds everything that changes while we boost, so a booster that is initialized with the same data,
+// parameters and seed continues from a checkpoint with the same results as the booster that wrote it.  The features,
+// feature groups, bags and datasets have to be rebuilt by InitializeBoosting*, and we only check that their sizes match.
+//
+// Layout: BoostingCheckpointHeader, then these arrays back to back
+//   m_cTensorValues FloatEbmType values of the current model, one feature group after another
+//   m_cTensorValues FloatEbmType values of the best model
+//   m_cChangedFeatureGroups uint64_t indexes of the feature groups that the best model hasn't copied yet
+//   m_cRandomStreams * k_cRandomStreamStateItems uint64_t states of the per-bag streams
+//   if m_bScheduled, m_cFeatureGroups FloatEbmType last gains of the feature groups that BoostingRun schedules by, 
+//     then m_cFeatureGroups uint64_t counts of the rounds that each group has been skipped in a row
+//   the training residuals, then the cached training denominators if m_bTrainingDenominators, then the training
+//     predictor scores for classification.  Each has m_cTrainingSamples * vector length items of
+//     m_cBytesTrainingValue bytes, in the order of m_bTrainingClassMajor, and is zero padded to 8 bytes
+//   the validation residuals for regression or predictor scores for classification, as FloatEbmType
+// The files are in the native byte order, like the model files.
+
+constexpr uint64_t k_boostingCheckpointMagic = uint64_t { 0x3154504B434D4245 }; // "EBMCKPT1" in little endian
+// version 2 added the BoostingRun schedule
+constexpr uint64_t k_boostingCheckpointVersion = 2;
+
+struct BoostingCheckpointHeader final {
+   BoostingCheckpointHeader() = default; // preserve our POD status
+   ~BoostingCheckpointHeader() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_magic;
+   uint64_t m_version;
+   uint64_t m_cBytesFloat;
+   uint64_t m_cBytesFile;
+   // -1 for regression, or otherwise the number of target classes
+   int64_t m_learningTypeOrCountTargetClasses;
+   uint64_t m_cFeatureGroups;
+   // 0 for classification with fewer than 2 classes, which has no model and saves no sample arrays
+   uint64_t m_cVectorLength;
+   uint64_t m_cTensorValues;
+   uint64_t m_cSamplingSets;
+   uint64_t m_cTrainingSamples;
+   uint64_t m_cBytesTrainingValue;
+   uint64_t m_bTrainingClassMajor;
+   uint64_t m_bTrainingDenominators;
+   uint64_t m_cValidationSamples;
+   uint64_t m_cRandomStreams;
+   uint64_t m_cChangedFeatureGroups;
+   uint64_t m_bScheduled;
+   FloatEbmType m_bestModelMetric;
+};
+static_assert(std::is_standard_layout<BoostingCheckpointHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<BoostingCheckpointHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<BoostingCheckpointHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static_assert(sizeof(FloatEbmType) == sizeof(uint64_t), "the checkpoint file needs 8 byte FloatEbmType");
+static_assert(0 == sizeof(BoostingCheckpointHeader) % sizeof(uint64_t),
+   "BoostingCheckpointHeader should only hold 8 byte items");
+
+// the training arrays can hold 4 byte floats, so we pad them to keep the arrays after them aligned
+INLINE_RELEASE_UNTEMPLATED static size_t GetPaddedBytes(const size_t cBytes) {
+   return (cBytes + (sizeof(uint64_t) - 1)) & ~(sizeof(uint64_t) - 1);
+}
+
+INLINE_RELEASE_UNTEMPLATED static size_t GetCheckpointVectorLength(const ptrdiff_t runtimeLearningTypeOrCountTargetClasses) {
+   // classification with 0 or 1 target classes has no model, like the model files
+   return IsClassification(runtimeLearningTypeOrCountTargetClasses) && runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 } ?
+      size_t { 0 } : GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+}
+
+INLINE_RELEASE_UNTEMPLATED static size_t GetCountTensorValues(
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cVectorLength
+) {
+   // our models already hold this many values, so this can't overflow
+   size_t cTensorValues = cVectorLength;
+   for(size_t iDimension = 0; iDimension < pFeatureGroup->GetCountFeatures(); ++iDimension) {
+      cTensorValues *= pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+   }
+   return cTensorValues;
+}
+
+// the residuals, denominators and predictor scores that we copy byte for byte.  Returns the number of arrays
+static size_t GetSampleArrays(
+   EbmBoostingState * const pBooster,
+   const size_t cVectorLength,
+   void * * const apArraysOut,
+   size_t * const acBytesOut
+) {
+   if(0 == cVectorLength) {
+      return 0;
+   }
+   const bool bClassification = IsClassification(pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+   size_t cArrays = 0;
+
+   DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+   const size_t cTrainingSamples = pTrainingSet->GetCountSamples();
+   if(0 != cTrainingSamples) {
+      const bool bFloat32 = pTrainingSet->IsFloat32();
+      // we hold these arrays in memory already, so they can't overflow
+      const size_t cBytes = cTrainingSamples * cVectorLength * (bFloat32 ? sizeof(float) : sizeof(FloatEbmType));
+
+      apArraysOut[cArrays] = bFloat32 ? static_cast<void *>(pTrainingSet->GetResidualPointer<float>()) :
+         static_cast<void *>(pTrainingSet->GetResidualPointer<FloatEbmType>());
+      acBytesOut[cArrays] = cBytes;
+      ++cArrays;
+
+      if(pTrainingSet->IsDenominatorsCached()) {
+         apArraysOut[cArrays] = bFloat32 ? static_cast<void *>(pTrainingSet->GetDenominatorPointer<float>()) :
+            static_cast<void *>(pTrainingSet->GetDenominatorPointer<FloatEbmType>());
+         acBytesOut[cArrays] = cBytes;
+         ++cArrays;
+      }
+      if(bClassification) {
+         apArraysOut[cArrays] = bFloat32 ? static_cast<void *>(pTrainingSet->GetPredictorScores<float>()) :
+            static_cast<void *>(pTrainingSet->GetPredictorScores<FloatEbmType>());
+         acBytesOut[cArrays] = cBytes;
+         ++cArrays;
+      }
+   }
+
+   DataSetByFeatureGroup * const pValidationSet = pBooster->GetValidationSet();
+   const size_t cValidationSamples = pValidationSet->GetCountSamples();
+   if(0 != cValidationSamples) {
+      EBM_ASSERT(!pValidationSet->IsFloat32());
+      apArraysOut[cArrays] = bClassification ? static_cast<void *>(pValidationSet->GetPredictorScores()) :
+         static_cast<void *>(pValidationSet->GetResidualPointer());
+      acBytesOut[cArrays] = cValidationSamples * cVectorLength * sizeof(FloatEbmType);
+      ++cArrays;
+   }
+   return cArrays;
+}
+
+// the training set can hold residuals, denominators and predictor scores, and the validation set one more
+constexpr size_t k_cSampleArraysMax = 4;
+
+// fills the header that pBooster writes with cChangedFeatureGroups changed feature groups.  Everything in the file
+// is already in memory, so the sizes can't overflow
+static void FillHeader(
+   EbmBoostingState * const pBooster,
+   const size_t cChangedFeatureGroups,
+   BoostingCheckpointHeader * const pHeader
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBooster->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetCheckpointVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cFeatureGroups = pBooster->GetCountFeatureGroups();
+   const DataSetByFeatureGroup * const pTrainingSet = pBooster->GetTrainingSet();
+
+   size_t cTensorValues = 0;
+   if(0 != cVectorLength) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         cTensorValues += GetCountTensorValues(pBooster->GetFeatureGroups()[iFeatureGroup], cVectorLength);
+      }
+   }
+   const size_t cRandomStreams = pBooster->GetCountSlots() * pBooster->GetCountCachedThreadResourcesPerSlot();
+   const size_t cScheduleItems = pBooster->IsBoostingScheduled() ? size_t { 2 } * cFeatureGroups : size_t { 0 };
+
+   size_t cBytesFile = sizeof(BoostingCheckpointHeader) + (size_t { 2 } * cTensorValues + cChangedFeatureGroups + 
+      cRandomStreams * k_cRandomStreamStateItems + cScheduleItems) * sizeof(uint64_t);
+   void * apArrays[k_cSampleArraysMax];
+   size_t acBytes[k_cSampleArraysMax];
+   const size_t cArrays = GetSampleArrays(pBooster, cVectorLength, apArrays, acBytes);
+   for(size_t iArray = 0; iArray < cArrays; ++iArray) {
+      cBytesFile += GetPaddedBytes(acBytes[iArray]);
+   }
+
+   pHeader->m_magic = k_boostingCheckpointMagic;
+   pHeader->m_version = k_boostingCheckpointVersion;
+   pHeader->m_cBytesFloat = uint64_t { sizeof(FloatEbmType) };
+   pHeader->m_cBytesFile = static_cast<uint64_t>(cBytesFile);
+   pHeader->m_learningTypeOrCountTargetClasses = static_cast<int64_t>(runtimeLearningTypeOrCountTargetClasses);
+   pHeader->m_cFeatureGroups = static_cast<uint64_t>(cFeatureGroups);
+   pHeader->m_cVectorLength = static_cast<uint64_t>(cVectorLength);
+   pHeader->m_cTensorValues = static_cast<uint64_t>(cTensorValues);
+   pHeader->m_cSamplingSets = static_cast<uint64_t>(pBooster->GetCountSamplingSets());
+   pHeader->m_cTrainingSamples = static_cast<uint64_t>(pTrainingSet->GetCountSamples());
+   pHeader->m_cBytesTrainingValue = pTrainingSet->IsFloat32() ? uint64_t { sizeof(float) } : uint64_t { sizeof(FloatEbmType) };
+   pHeader->m_bTrainingClassMajor = pTrainingSet->IsClassMajor() ? uint64_t { 1 } : uint64_t { 0 };
+   pHeader->m_bTrainingDenominators = pTrainingSet->IsDenominatorsCached() ? uint64_t { 1 } : uint64_t { 0 };
+   pHeader->m_cValidationSamples = static_cast<uint64_t>(pBooster->GetValidationSet()->GetCountSamples());
+   pHeader->m_cRandomStreams = static_cast<uint64_t>(cRandomStreams);
+   pHeader->m_cChangedFeatureGroups = static_cast<uint64_t>(cChangedFeatureGroups);
+   pHeader->m_bScheduled = pBooster->IsBoostingScheduled() ? uint64_t { 1 } : uint64_t { 0 };
+   pHeader->m_bestModelMetric = pBooster->GetBestModelMetric();
+}
+
+// returns true on error
+static bool WriteBytes(FILE * const pFile, const void * const aBytes, const size_t cBytes) {
+   return 0 != cBytes && cBytes != fwrite(aBytes, 1, cBytes, pFile);
+}
+
+// returns true on error
+static bool WriteCheckpoint(EbmBoostingState * const pBooster, const char * const filePath) {
+   LOG_0(TraceLevelInfo, "Entered WriteCheckpoint");
+
+   const size_t cVectorLength = GetCheckpointVectorLength(pBooster->GetRuntimeLearningTypeOrCountTargetClasses());
+   const size_t cFeatureGroups = pBooster->GetCountFeatureGroups();
+   const size_t cChangedFeatureGroups = 0 == cVectorLength ? size_t { 0 } : pBooster->GetCountChangedFeatureGroups();
+
+   BoostingCheckpointHeader header;
+   FillHeader(pBooster, cChangedFeatureGroups, &header);
+
+   FILE * const pFile = fopen(filePath, "wb");
+   if(nullptr == pFile) {
+      LOG_0(TraceLevelWarning, "WARNING WriteCheckpoint fopen");
+      return true;
+   }
+   bool bError = WriteBytes(pFile, &header, sizeof(header));
+   if(0 != cVectorLength) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const size_t cTensorValues = GetCountTensorValues(pBooster->GetFeatureGroups()[iFeatureGroup], cVectorLength);
+         bError = bError || WriteBytes(pFile, pBooster->GetCurrentModel()[iFeatureGroup]->GetValuePointer(),
+            sizeof(FloatEbmType) * cTensorValues);
+      }
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const size_t cTensorValues = GetCountTensorValues(pBooster->GetFeatureGroups()[iFeatureGroup], cVectorLength);
+         bError = bError || WriteBytes(pFile, pBooster->GetBestModel()[iFeatureGroup]->GetValuePointer(),
+            sizeof(FloatEbmType) * cTensorValues);
+      }
+   }
+   for(size_t iChanged = 0; iChanged < cChangedFeatureGroups; ++iChanged) {
+      const uint64_t indexFeatureGroup = static_cast<uint64_t>(pBooster->GetChangedFeatureGroups()[iChanged]);
+      bError = bError || WriteBytes(pFile, &indexFeatureGroup, sizeof(indexFeatureGroup));
+   }
+   for(size_t iSlot = 0; iSlot < pBooster->GetCountSlots(); ++iSlot) {
+      for(size_t iBag = 0; iBag < pBooster->GetCountCachedThreadResourcesPerSlot(); ++iBag) {
+         uint64_t aState[k_cRandomStreamStateItems];
+         pBooster->GetCachedThreadResources(iSlot, iBag)->GetRandomStream()->GetState(aState);
+         bError = bError || WriteBytes(pFile, aState, sizeof(aState));
+      }
+   }
+   if(pBooster->IsBoostingScheduled()) {
+      bError = bError || WriteBytes(pFile, pBooster->GetScheduleGains(), sizeof(FloatEbmType) * cFeatureGroups);
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const uint64_t cRoundsSkipped = static_cast<uint64_t>(pBooster->GetScheduleRoundsSkipped()[iFeatureGroup]);
+         bError = bError || WriteBytes(pFile, &cRoundsSkipped, sizeof(cRoundsSkipped));
+      }
+   }
+   void * apArrays[k_cSampleArraysMax];
+   size_t acBytes[k_cSampleArraysMax];
+   const size_t cArrays = GetSampleArrays(pBooster, cVectorLength, apArrays, acBytes);
+   for(size_t iArray = 0; iArray < cArrays; ++iArray) {
+      static constexpr char k_aPadding[sizeof(uint64_t)] {};
+      bError = bError || WriteBytes(pFile, apArrays[iArray], acBytes[iArray]) ||
+         WriteBytes(pFile, k_aPadding, GetPaddedBytes(acBytes[iArray]) - acBytes[iArray]);
+   }
+   if(0 != fclose(pFile)) {
+      bError = true;
+   }
+   if(bError) {
+      LOG_0(TraceLevelWarning, "WARNING WriteCheckpoint could not write the file");
+      return true;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited WriteCheckpoint");
+   return false;
+}
+
+// checks the whole mapped checkpoint against pBooster before copying anything, so that a checkpoint of a different
+// booster leaves pBooster untouched.  Returns true on error
+static bool ReadCheckpoint(EbmBoostingState * const pBooster, const char * const pMapped, const size_t cBytesMapped) {
+   LOG_0(TraceLevelInfo, "Entered ReadCheckpoint");
+
+   if(cBytesMapped < sizeof(BoostingCheckpointHeader)) {
+      LOG_0(TraceLevelError, "ERROR ReadCheckpoint file too small for the header");
+      return true;
+   }
+   BoostingCheckpointHeader header;
+   memcpy(&header, pMapped, sizeof(header));
+
+   const size_t cFeatureGroups = pBooster->GetCountFeatureGroups();
+   if(k_boostingCheckpointMagic != header.m_magic || k_boostingCheckpointVersion != header.m_version) {
+      LOG_0(TraceLevelError, "ERROR ReadCheckpoint not a boosting checkpoint of this version and byte order");
+      return true;
+   }
+   if(static_cast<uint64_t>(cFeatureGroups) < header.m_cChangedFeatureGroups) {
+      LOG_0(TraceLevelError, "ERROR ReadCheckpoint more changed feature groups than feature groups");
+      return true;
+   }
+   const size_t cChangedFeatureGroups = static_cast<size_t>(header.m_cChangedFeatureGroups);
+
+   // the best metric is the only header item that we can't derive from the booster
+   BoostingCheckpointHeader headerExpected;
+   FillHeader(pBooster, cChangedFeatureGroups, &headerExpected);
+   headerExpected.m_bestModelMetric = header.m_bestModelMetric;
+   if(0 != memcmp(&header, &headerExpected, sizeof(header))) {
+      LOG_0(TraceLevelError, "ERROR ReadCheckpoint the checkpoint was written by a booster with different data or parameters");
+      return true;
+   }
+   if(static_cast<uint64_t>(cBytesMapped) != header.m_cBytesFile) {
+      LOG_0(TraceLevelError, "ERROR ReadCheckpoint the file size does not match it's header");
+      return true;
+   }
+
+   const size_t cVectorLength = static_cast<size_t>(header.m_cVectorLength);
+   const size_t cTensorValues = static_cast<size_t>(header.m_cTensorValues);
+   const char * const pCurrentModel = pMapped + sizeof(BoostingCheckpointHeader);
+   const char * const pBestModel = pCurrentModel + sizeof(FloatEbmType) * cTensorValues;
+   const char * const pChangedFeatureGroups = pBestModel + sizeof(FloatEbmType) * cTensorValues;
+   const char * const pRandomStreams = pChangedFeatureGroups + sizeof(uint64_t) * cChangedFeatureGroups;
+
+   const char * pChanged = pChangedFeatureGroups;
+   for(size_t iChanged = 0; iChanged < cChangedFeatureGroups; ++iChanged) {
+      uint64_t indexFeatureGroup;
+      memcpy(&indexFeatureGroup, pChanged, sizeof(indexFeatureGroup));
+      if(static_cast<uint64_t>(cFeatureGroups) <= indexFeatureGroup) {
+         LOG_0(TraceLevelError, "ERROR ReadCheckpoint changed feature group index out of range");
+         return true;
+      }
+      pChanged += sizeof(indexFeatureGroup);
+   }
+
+   // nothing below can fail
+   if(0 != cVectorLength) {
+      const char * pValues = pCurrentModel;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const size_t cBytes = sizeof(FloatEbmType) * GetCountTensorValues(pBooster->GetFeatureGroups()[iFeatureGroup], cVectorLength);
+         memcpy(pBooster->GetCurrentModel()[iFeatureGroup]->GetValuePointer(), pValues, cBytes);
+         pValues += cBytes;
+      }
+      EBM_ASSERT(pBestModel == pValues);
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const size_t cBytes = sizeof(FloatEbmType) * GetCountTensorValues(pBooster->GetFeatureGroups()[iFeatureGroup], cVectorLength);
+         memcpy(pBooster->GetBestModel()[iFeatureGroup]->GetValuePointer(), pValues, cBytes);
+         pValues += cBytes;
+      }
+
+      pBooster->ClearChangedFeatureGroups();
+      pChanged = pChangedFeatureGroups;
+      for(size_t iChanged = 0; iChanged < cChangedFeatureGroups; ++iChanged) {
+         uint64_t indexFeatureGroup;
+         memcpy(&indexFeatureGroup, pChanged, sizeof(indexFeatureGroup));
+         pBooster->SetFeatureGroupChanged(static_cast<size_t>(indexFeatureGroup));
+         pChanged += sizeof(indexFeatureGroup);
+      }
+   }
+   pBooster->SetBestModelMetric(header.m_bestModelMetric);
+
+   // the checkpoint holds validation values that already include every update, so nothing can be pending
+   if(pBooster->IsValidationDeferred()) {
+      pBooster->ClearPendingValidationUpdates();
+   }
+
+   const char * pRandomStream = pRandomStreams;
+   for(size_t iSlot = 0; iSlot < pBooster->GetCountSlots(); ++iSlot) {
+      for(size_t iBag = 0; iBag < pBooster->GetCountCachedThreadResourcesPerSlot(); ++iBag) {
+         uint64_t aState[k_cRandomStreamStateItems];
+         memcpy(aState, pRandomStream, sizeof(aState));
+         pBooster->GetCachedThreadResources(iSlot, iBag)->GetRandomStream()->SetState(aState);
+         pRandomStream += sizeof(aState);
+      }
+   }
+
+   const char * pArray = pRandomStream;
+   if(pBooster->IsBoostingScheduled()) {
+      memcpy(pBooster->GetScheduleGains(), pArray, sizeof(FloatEbmType) * cFeatureGroups);
+      pArray += sizeof(FloatEbmType) * cFeatureGroups;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         uint64_t cRoundsSkipped;
+         memcpy(&cRoundsSkipped, pArray, sizeof(cRoundsSkipped));
+         // the count only grows by one per round, so anything beyond size_t means the group is long overdue
+         pBooster->GetScheduleRoundsSkipped()[iFeatureGroup] = 
+            static_cast<uint64_t>(std::numeric_limits<size_t>::max()) < cRoundsSkipped ? 
+            std::numeric_limits<size_t>::max() : static_cast<size_t>(cRoundsSkipped);
+         pArray += sizeof(cRoundsSkipped);
+      }
+   }
+
+   void * apArrays[k_cSampleArraysMax];
+   size_t acBytes[k_cSampleArraysMax];
+   const size_t cArrays = GetSampleArrays(pBooster, cVectorLength, apArrays, acBytes);
+   for(size_t iArray = 0; iArray < cArrays; ++iArray) {
+      memcpy(apArrays[iArray], pArray, acBytes[iArray]);
+      pArray += GetPaddedBytes(acBytes[iArray]);
+   }
+   EBM_ASSERT(pMapped + cBytesMapped == pArray);
+
+   LOG_0(TraceLevelInfo, "Exited ReadCheckpoint");
+   return false;
+}
+
+// pending validation updates would need their own arrays in the file, so we refuse to save them.  Returns true on error
+static bool CheckCheckpointable(const char * const sFunctionName, const EbmBoostingState * const pBooster) {
+   if(0 != pBooster->GetCountPendingFeatureGroups()) {
+      LOG_N(TraceLevelError, "ERROR %s the validation set has pending updates.  Get the validation metric first", sFunctionName);
+      return true;
+   }
+   return false;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingCheckpoint(
+   PEbmBoosting ebmBoosting,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered SaveBoostingCheckpoint: ebmBoosting=%p, filePath=%p",
+      static_cast<void *>(ebmBoosting), static_cast<const void *>(filePath));
+
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR SaveBoostingCheckpoint ebmBoosting cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR SaveBoostingCheckpoint filePath cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(CheckCheckpointable("SaveBoostingCheckpoint", pEbmBoostingState)) {
+      return IntEbmType { 1 };
+   }
+   if(WriteCheckpoint(pEbmBoostingState, filePath)) {
+      LOG_0(TraceLevelWarning, "WARNING SaveBoostingCheckpoint WriteCheckpoint");
+      return IntEbmType { 1 };
+   }
+
+   LOG_0(TraceLevelInfo, "Exited SaveBoostingCheckpoint");
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION LoadBoostingCheckpoint(
+   PEbmBoosting ebmBoosting,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered LoadBoostingCheckpoint: ebmBoosting=%p, filePath=%p",
+      static_cast<void *>(ebmBoosting), static_cast<const void *>(filePath));
+
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR LoadBoostingCheckpoint ebmBoosting cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR LoadBoostingCheckpoint filePath cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+
+   size_t cBytesMapped;
+   const char * const pMapped = MapFile(filePath, &cBytesMapped);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING LoadBoostingCheckpoint MapFile");
+      return IntEbmType { 1 };
+   }
+   const bool bError = ReadCheckpoint(pEbmBoostingState, pMapped, cBytesMapped);
+   UnmapFile(pMapped, cBytesMapped);
+   if(bError) {
+      return IntEbmType { 1 };
+   }
+
+   LOG_0(TraceLevelInfo, "Exited LoadBoostingCheckpoint");
+   return IntEbmType { 0 };
+}
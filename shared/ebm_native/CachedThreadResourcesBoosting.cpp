@@ -9,21 +9,45 @@
 
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
 
 #include "HistogramTargetEntry.h"
+#include "SegmentedTensor.h"
 
 #include "CachedThreadResourcesBoosting.h"
 
+INLINE_ALWAYS static size_t GetArenaBufferSize(const size_t cBytes) {
+   // our caller checks for overflow
+   return (cBytes + (k_cBytesAlignment - 1)) / k_cBytesAlignment * k_cBytesAlignment;
+}
+
+// each buffer in our arena starts on a cache line so that the buffers don't share lines with each other.  Adds a 
+// buffer of cBytes to the arena size, rounded up to the next arena boundary.  Returns true on overflow
+static bool AddArenaBuffer(size_t * const pcBytesArena, const size_t cBytes) {
+   if(IsAddError(cBytes, k_cBytesAlignment - 1)) {
+      return true;
+   }
+   const size_t cBytesRounded = GetArenaBufferSize(cBytes);
+   if(IsAddError(*pcBytesArena, cBytesRounded)) {
+      return true;
+   }
+   *pcBytesArena += cBytesRounded;
+   return false;
+}
+
 void CachedBoostingThreadResources::Free(CachedBoostingThreadResources * const pCachedResources) {
    LOG_0(TraceLevelInfo, "Entered CachedBoostingThreadResources::Free");
 
    if(nullptr != pCachedResources) {
-      free(pCachedResources->m_aThreadByteBuffer1);
-      free(pCachedResources->m_aThreadByteBuffer2);
+      // the thread byte buffers, shard histograms and tree node heap all live inside the arena
+      AlignedFree(pCachedResources->m_aArena);
       free(pCachedResources->m_aSumHistogramBucketVectorEntry);
       free(pCachedResources->m_aSumHistogramBucketVectorEntry1);
       free(pCachedResources->m_aTempFloatVector);
       free(pCachedResources->m_aEquivalentSplits);
+      SegmentedTensor::Free(pCachedResources->m_pSmallChangeToModelOverwriteSingleSamplingSet);
+      free(pCachedResources->m_aHistogramReduceValues);
+      free(pCachedResources->m_aSweepScores);
 
       free(pCachedResources);
    }
@@ -31,9 +55,41 @@ void CachedBoostingThreadResources::Free(CachedBoostingThreadResources * const p
    LOG_0(TraceLevelInfo, "Exited CachedBoostingThreadResources::Free");
 }
 
+FloatEbmType * CachedBoostingThreadResources::GetHistogramReduceValues(const size_t cValues) {
+   if(UNLIKELY(m_cHistogramReduceValuesCapacity < cValues)) {
+      free(m_aHistogramReduceValues);
+      m_cHistogramReduceValuesCapacity = 0;
+      m_aHistogramReduceValues = EbmMalloc<FloatEbmType>(cValues);
+      if(UNLIKELY(nullptr == m_aHistogramReduceValues)) {
+         LOG_0(TraceLevelWarning, "WARNING CachedBoostingThreadResources::GetHistogramReduceValues nullptr == m_aHistogramReduceValues");
+         return nullptr;
+      }
+      m_cHistogramReduceValuesCapacity = cValues;
+   }
+   return m_aHistogramReduceValues;
+}
+
+FloatEbmType * CachedBoostingThreadResources::GetSweepScores(const size_t cValues) {
+   if(UNLIKELY(m_cSweepScoresCapacity < cValues)) {
+      free(m_aSweepScores);
+      m_cSweepScoresCapacity = 0;
+      m_aSweepScores = EbmMalloc<FloatEbmType>(cValues);
+      if(UNLIKELY(nullptr == m_aSweepScores)) {
+         LOG_0(TraceLevelWarning, "WARNING CachedBoostingThreadResources::GetSweepScores nullptr == m_aSweepScores");
+         return nullptr;
+      }
+      m_cSweepScoresCapacity = cValues;
+   }
+   return m_aSweepScores;
+}
+
 CachedBoostingThreadResources * CachedBoostingThreadResources::Allocate(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
-   const size_t cBytesArrayEquivalentSplitMax
+   const size_t cBytesArrayEquivalentSplitMax,
+   const size_t cBytesThreadByteBuffer1Max,
+   const size_t cBytesThreadByteBuffer2Max,
+   const size_t cBytesShardHistogramBufferMax,
+   const size_t cBytesTreeNodeHeapMax
 ) {
    LOG_0(TraceLevelInfo, "Entered CachedBoostingThreadResources::Allocate");
 
@@ -56,6 +112,12 @@ CachedBoostingThreadResources * CachedBoostingThreadResources::Allocate(
             FloatEbmType * const aTempFloatVector = EbmMalloc<FloatEbmType>(cVectorLength);
             if(LIKELY(nullptr != aTempFloatVector)) {
                pNew->m_aTempFloatVector = aTempFloatVector;
+               SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet = 
+                  SegmentedTensor::Allocate(k_cDimensionsMax, cVectorLength);
+               if(UNLIKELY(nullptr == pSmallChangeToModelOverwriteSingleSamplingSet)) {
+                  goto exit_error;
+               }
+               pNew->m_pSmallChangeToModelOverwriteSingleSamplingSet = pSmallChangeToModelOverwriteSingleSamplingSet;
                if(0 != cBytesArrayEquivalentSplitMax) {
                   void * aEquivalentSplits = EbmMalloc<void>(cBytesArrayEquivalentSplitMax);
                   if(UNLIKELY(nullptr == aEquivalentSplits)) {
@@ -64,6 +126,40 @@ CachedBoostingThreadResources * CachedBoostingThreadResources::Allocate(
                   pNew->m_aEquivalentSplits = aEquivalentSplits;
                }
 
+               size_t cBytesArena = 0;
+               if(UNLIKELY(AddArenaBuffer(&cBytesArena, cBytesThreadByteBuffer1Max) ||
+                  AddArenaBuffer(&cBytesArena, cBytesThreadByteBuffer2Max) ||
+                  AddArenaBuffer(&cBytesArena, cBytesShardHistogramBufferMax) ||
+                  AddArenaBuffer(&cBytesArena, cBytesTreeNodeHeapMax))) {
+                  LOG_0(TraceLevelWarning, "WARNING CachedBoostingThreadResources::Allocate arena size overflow");
+                  goto exit_error;
+               }
+               LOG_N(TraceLevelInfo, "CachedBoostingThreadResources::Allocate arena of %zu bytes", cBytesArena);
+               // AlignedMalloc starts the arena on a cache line, and we round each buffer up to the next one
+               char * pArena = nullptr;
+               if(0 != cBytesArena) {
+                  pArena = static_cast<char *>(AlignedMalloc(MemorySubsystem::ThreadBuffers, cBytesArena));
+                  if(UNLIKELY(nullptr == pArena)) {
+                     goto exit_error;
+                  }
+                  pNew->m_aArena = pArena;
+               }
+
+               pNew->m_aThreadByteBuffer1 = reinterpret_cast<HistogramBucketBase *>(pArena);
+               pNew->m_cThreadByteBufferCapacity1 = cBytesThreadByteBuffer1Max;
+               pArena += GetArenaBufferSize(cBytesThreadByteBuffer1Max);
+
+               pNew->m_aThreadByteBuffer2 = pArena;
+               pNew->m_cThreadByteBufferCapacity2 = cBytesThreadByteBuffer2Max;
+               pArena += GetArenaBufferSize(cBytesThreadByteBuffer2Max);
+
+               pNew->m_aShardHistogramBuffer = pArena;
+               pNew->m_cShardHistogramBufferCapacity = cBytesShardHistogramBufferMax;
+               pArena += GetArenaBufferSize(cBytesShardHistogramBufferMax);
+
+               pNew->m_aTreeNodeHeap = pArena;
+               pNew->m_cTreeNodeHeapCapacity = cBytesTreeNodeHeapMax;
+
                LOG_0(TraceLevelInfo, "Exited CachedBoostingThreadResources::Allocate");
                return pNew;
             }
@@ -75,39 +171,3 @@ CachedBoostingThreadResources * CachedBoostingThreadResources::Allocate(
    LOG_0(TraceLevelWarning, "WARNING Exited CachedBoostingThreadResources::Allocate with error");
    return nullptr;
 }
-
-HistogramBucketBase * CachedBoostingThreadResources::GetThreadByteBuffer1(const size_t cBytesRequired) {
-   HistogramBucketBase * aBuffer = m_aThreadByteBuffer1;
-   if(UNLIKELY(m_cThreadByteBufferCapacity1 < cBytesRequired)) {
-      m_cThreadByteBufferCapacity1 = cBytesRequired << 1;
-      LOG_N(TraceLevelInfo, "Growing CachedBoostingThreadResources::ThreadByteBuffer1 to %zu", m_cThreadByteBufferCapacity1);
-
-      free(aBuffer);
-      aBuffer = static_cast<HistogramBucketBase *>(EbmMalloc<void>(m_cThreadByteBufferCapacity1));
-      m_aThreadByteBuffer1 = aBuffer;
-   }
-   return aBuffer;
-}
-
-bool CachedBoostingThreadResources::GrowThreadByteBuffer2(const size_t cByteBoundaries) {
-   // by adding cByteBoundaries and shifting our existing size, we do 2 things:
-   //   1) we ensure that if we have zero size, we'll get some size that we'll get a non-zero size after the shift
-   //   2) we'll always get back an odd number of items, which is good because we always have an odd number of TreeNodeChilden
-   EBM_ASSERT(0 == m_cThreadByteBufferCapacity2 % cByteBoundaries);
-   m_cThreadByteBufferCapacity2 = cByteBoundaries + (m_cThreadByteBufferCapacity2 << 1);
-   LOG_N(TraceLevelInfo, "Growing CachedBoostingThreadResources::ThreadByteBuffer2 to %zu", m_cThreadByteBufferCapacity2);
-
-   // our tree objects have internal pointers, so we're going to dispose of our work anyways
-   // We can't use realloc since there is no way to check if the array was re-allocated or not without 
-   // invoking undefined behavior, so we don't get a benefit if the array can be resized with realloc
-
-   void * aBuffer = m_aThreadByteBuffer2;
-   free(aBuffer);
-   aBuffer = EbmMalloc<void>(m_cThreadByteBufferCapacity2);
-   m_aThreadByteBuffer2 = aBuffer;
-   if(UNLIKELY(nullptr == aBuffer)) {
-      return true;
-   }
-   return false;
-}
-
@@ -12,11 +12,17 @@
 #include "Logging.h" // EBM_ASSERT & LOG
 
 #include "HistogramTargetEntry.h"
+#include "RandomStream.h"
 
 struct HistogramBucketBase;
+class SegmentedTensor;
 
 class CachedBoostingThreadResources final {
-   // TODO: can I preallocate m_aThreadByteBuffer1 and m_aThreadByteBuffer2 without resorting to grow them if I examine my inputs
+   // we allocate one of these per inner bag so that the bags can be boosted in parallel without sharing any mutable state
+
+   // the scratch buffers below are sized for the worst case of our feature groups when we're allocated, and all of them are 
+   // carved out of this single allocation, so boosting never needs to grow them
+   void * m_aArena;
 
    HistogramBucketBase * m_aThreadByteBuffer1;
    size_t m_cThreadByteBufferCapacity1;
@@ -24,12 +30,39 @@ class CachedBoostingThreadResources final {
    void * m_aThreadByteBuffer2;
    size_t m_cThreadByteBufferCapacity2;
 
+   // holds the private histograms of the sample shards beyond the first when BinBoosting is sharded
+   void * m_aShardHistogramBuffer;
+   size_t m_cShardHistogramBufferCapacity;
+
+   // the priority queue of TreeNode pointers that GrowDecisionTree keeps as a heap, so growing a tree allocates nothing
+   void * m_aTreeNodeHeap;
+   size_t m_cTreeNodeHeapCapacity;
+
    FloatEbmType * m_aTempFloatVector;
    void * m_aEquivalentSplits; // we use different structures for mains and multidimension and between classification and regression
 
    HistogramBucketVectorEntryBase * m_aSumHistogramBucketVectorEntry;
    HistogramBucketVectorEntryBase * m_aSumHistogramBucketVectorEntry1;
 
+   SegmentedTensor * m_pSmallChangeToModelOverwriteSingleSamplingSet;
+
+   // holds the flattened histogram that we pass to the histogram reduce function.  Unlike our other buffers it's 
+   // only needed by those boosters, so it starts empty and grows as needed
+   size_t m_cHistogramReduceValuesCapacity;
+   FloatEbmType * m_aHistogramReduceValues;
+
+   // holds the running sums and node splitting scores of a single feature sweep when we use the SIMD kernels.  Like 
+   // the histogram reduce values it starts empty and grows as needed
+   size_t m_cSweepScoresCapacity;
+   FloatEbmType * m_aSweepScores;
+
+   // each bag has it's own predictably seeded stream so that our results don't depend on the order that bags execute in
+   RandomStream m_randomStream;
+
+   // the results of the last boosting step on this bag, which are combined in bag order after all bags complete
+   FloatEbmType m_gain;
+   bool m_bError;
+
 public:
 
    CachedBoostingThreadResources() = default; // preserve our POD status
@@ -38,23 +71,43 @@ public:
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    INLINE_ALWAYS void InitializeZero() {
+      m_aArena = nullptr;
       m_aThreadByteBuffer1 = nullptr;
       m_cThreadByteBufferCapacity1 = 0;
       m_aThreadByteBuffer2 = nullptr;
       m_cThreadByteBufferCapacity2 = 0;
+      m_aShardHistogramBuffer = nullptr;
+      m_cShardHistogramBufferCapacity = 0;
+      m_aTreeNodeHeap = nullptr;
+      m_cTreeNodeHeapCapacity = 0;
       m_aTempFloatVector = nullptr;
       m_aEquivalentSplits = nullptr;
       m_aSumHistogramBucketVectorEntry = nullptr;
       m_aSumHistogramBucketVectorEntry1 = nullptr;
+      m_pSmallChangeToModelOverwriteSingleSamplingSet = nullptr;
+      m_cHistogramReduceValuesCapacity = 0;
+      m_aHistogramReduceValues = nullptr;
+      m_cSweepScoresCapacity = 0;
+      m_aSweepScores = nullptr;
+      m_gain = FloatEbmType { 0 };
+      m_bError = false;
    }
 
    static void Free(CachedBoostingThreadResources * const pCachedResources);
    static CachedBoostingThreadResources * Allocate(
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
-      const size_t cBytesArrayEquivalentSplitMax
+      const size_t cBytesArrayEquivalentSplitMax,
+      const size_t cBytesThreadByteBuffer1Max,
+      const size_t cBytesThreadByteBuffer2Max,
+      const size_t cBytesShardHistogramBufferMax,
+      const size_t cBytesTreeNodeHeapMax
    );
-   HistogramBucketBase * GetThreadByteBuffer1(const size_t cBytesRequired);
-   bool GrowThreadByteBuffer2(const size_t cByteBoundaries);
+
+   INLINE_ALWAYS HistogramBucketBase * GetThreadByteBuffer1(const size_t cBytesRequired) {
+      UNUSED(cBytesRequired);
+      EBM_ASSERT(cBytesRequired <= m_cThreadByteBufferCapacity1);
+      return m_aThreadByteBuffer1;
+   }
 
    INLINE_ALWAYS void * GetThreadByteBuffer2() {
       return m_aThreadByteBuffer2;
@@ -64,6 +117,17 @@ public:
       return m_cThreadByteBufferCapacity2;
    }
 
+   // returns nullptr if we couldn't size the shard histograms at allocation, in which case our caller bins in a single shard
+   INLINE_ALWAYS void * GetShardHistogramBuffer(const size_t cBytesRequired) {
+      return UNLIKELY(m_cShardHistogramBufferCapacity < cBytesRequired) ? nullptr : m_aShardHistogramBuffer;
+   }
+
+   INLINE_ALWAYS void * GetTreeNodeHeap(const size_t cBytesRequired) {
+      UNUSED(cBytesRequired);
+      EBM_ASSERT(cBytesRequired <= m_cTreeNodeHeapCapacity);
+      return m_aTreeNodeHeap;
+   }
+
    INLINE_ALWAYS FloatEbmType * GetTempFloatVector() {
       return m_aTempFloatVector;
    }
@@ -72,6 +136,33 @@ public:
       return m_aEquivalentSplits;
    }
 
+   INLINE_ALWAYS SegmentedTensor * GetSmallChangeToModelOverwriteSingleSamplingSet() {
+      return m_pSmallChangeToModelOverwriteSingleSamplingSet;
+   }
+
+   // returns a buffer of at least cValues, or nullptr if we can't allocate it
+   FloatEbmType * GetHistogramReduceValues(const size_t cValues);
+
+   // returns a buffer of at least cValues, or nullptr if we can't allocate it
+   FloatEbmType * GetSweepScores(const size_t cValues);
+
+   INLINE_ALWAYS RandomStream * GetRandomStream() {
+      return &m_randomStream;
+   }
+
+   INLINE_ALWAYS FloatEbmType GetGain() const {
+      return m_gain;
+   }
+
+   INLINE_ALWAYS bool IsError() const {
+      return m_bError;
+   }
+
+   INLINE_ALWAYS void SetResult(const bool bError, const FloatEbmType gain) {
+      m_bError = bError;
+      m_gain = gain;
+   }
+
    INLINE_ALWAYS HistogramBucketVectorEntryBase * GetSumHistogramBucketVectorEntryArray() {
       return m_aSumHistogramBucketVectorEntry;
    }
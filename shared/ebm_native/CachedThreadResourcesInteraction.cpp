@@ -9,25 +9,37 @@
 
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
 
 #include "CachedThreadResourcesInteraction.h"
 
 void CachedInteractionThreadResources::Free(CachedInteractionThreadResources * const pCachedResources) {
    LOG_0(TraceLevelInfo, "Entered CachedInteractionThreadResources::Free");
 
-   free(pCachedResources->m_aThreadByteBuffer1);
+   AlignedFree(pCachedResources->m_aThreadByteBuffer1);
 
    free(pCachedResources);
 
    LOG_0(TraceLevelInfo, "Exited CachedInteractionThreadResources::Free");
 }
 
-CachedInteractionThreadResources * CachedInteractionThreadResources::Allocate() {
+CachedInteractionThreadResources * CachedInteractionThreadResources::Allocate(const size_t cBytesInitial) {
    LOG_0(TraceLevelInfo, "Entered CachedInteractionThreadResources::Allocate");
 
    CachedInteractionThreadResources * const pNew = EbmMalloc<CachedInteractionThreadResources>();
    if(nullptr != pNew) {
       pNew->InitializeZero();
+      if(0 != cBytesInitial) {
+         // unlike GetThreadByteBuffer1 we don't double this since we already know the largest size that we need
+         HistogramBucketBase * const aBuffer = static_cast<HistogramBucketBase *>(AlignedMalloc(MemorySubsystem::ThreadBuffers, cBytesInitial));
+         if(nullptr == aBuffer) {
+            LOG_0(TraceLevelWarning, "WARNING CachedInteractionThreadResources::Allocate nullptr == aBuffer");
+            free(pNew);
+            return nullptr;
+         }
+         pNew->m_aThreadByteBuffer1 = aBuffer;
+         pNew->m_cThreadByteBufferCapacity1 = cBytesInitial;
+      }
    }
 
    LOG_0(TraceLevelInfo, "Exited CachedInteractionThreadResources::Allocate");
@@ -41,8 +53,8 @@ HistogramBucketBase * CachedInteractionThreadResources::GetThreadByteBuffer1(con
       m_cThreadByteBufferCapacity1 = cBytesRequired << 1;
       LOG_N(TraceLevelInfo, "Growing CachedInteractionThreadResources::ThreadByteBuffer1 to %zu", m_cThreadByteBufferCapacity1);
 
-      free(aBuffer);
-      aBuffer = static_cast<HistogramBucketBase *>(EbmMalloc<void>(m_cThreadByteBufferCapacity1));
+      AlignedFree(aBuffer);
+      aBuffer = static_cast<HistogramBucketBase *>(AlignedMalloc(MemorySubsystem::ThreadBuffers, m_cThreadByteBufferCapacity1));
       m_aThreadByteBuffer1 = aBuffer;
    }
    return aBuffer;
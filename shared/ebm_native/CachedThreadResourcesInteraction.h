@@ -30,7 +30,9 @@ public:
    }
 
    static void Free(CachedInteractionThreadResources * const pCachedResources);
-   static CachedInteractionThreadResources * Allocate();
+   // cBytesInitial is the largest buffer that we expect to need.  Allocating it up front means that scoring pairs
+   // never needs to allocate, but GetThreadByteBuffer1 still grows the buffer for unusually large feature groups
+   static CachedInteractionThreadResources * Allocate(const size_t cBytesInitial);
    HistogramBucketBase * GetThreadByteBuffer1(const size_t cBytesRequired);
 
 };
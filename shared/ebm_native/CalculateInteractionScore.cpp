@@ -6,10 +6,13 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
+#include <algorithm> // std::sort, std::push_heap, std::pop_heap
+#include <functional> // std::greater
 
 #include "ebm_native.h"
 #include "EbmInternal.h"
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "EbmStatisticUtils.h"
 // feature includes
 #include "FeatureAtomic.h"
 #include "FeatureGroup.h"
@@ -20,6 +23,7 @@
 #include "InteractionDetection.h"
 
 #include "TensorTotalsSum.h"
+#include "ThreadPool.h"
 
 extern void BinInteraction(
    EbmInteractionState * const pEbmInteractionState,
@@ -30,6 +34,18 @@ extern void BinInteraction(
 #endif // NDEBUG
 );
 
+extern void BinInteractionPairs(
+   EbmInteractionState * const pEbmInteractionState,
+   const DataSetByFeature * const pDataSet,
+   const Feature * const pFeature0,
+   const size_t cPairs,
+   const Feature * const * const apFeatures1,
+   HistogramBucketBase * const * const aaHistogramBuckets
+#ifndef NDEBUG
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+);
+
 extern FloatEbmType FindBestInteractionGainPairs(
    EbmInteractionState * const pEbmInteractionState,
    const FeatureGroup * const pFeatureGroup,
@@ -42,22 +58,28 @@ extern FloatEbmType FindBestInteractionGainPairs(
 #endif // NDEBUG
 );
 
-static bool CalculateInteractionScoreInternal(
-   CachedInteractionThreadResources * const pCachedThreadResources,
+extern FloatEbmType FindBestInteractionGainMulti(
    EbmInteractionState * const pEbmInteractionState,
    const FeatureGroup * const pFeatureGroup,
    const size_t cSamplesRequiredForChildSplitMin,
-   FloatEbmType * const pInteractionScoreReturn
-) {
-   // TODO : we NEVER use the denominator term in HistogramBucketVectorEntry when calculating interaction scores, but we're spending time calculating 
-   // it, and it's taking up precious memory.  We should eliminate the denominator term HERE in our datastructures OR we should think whether we can 
-   // use the denominator as part of the gain function!!!
-
-   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
-   const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
-
-   LOG_0(TraceLevelVerbose, "Entered CalculateInteractionScoreInternal");
+   HistogramBucketBase * pAuxiliaryBucketZone,
+   HistogramBucketBase * const aHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+   , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+);
 
+// returns true if the histograms for pFeatureGroup can't be allocated.  The buffer holds the main tensor, then the
+// auxiliary zone, and then the mirrored totals if the feature group uses them
+extern bool GetInteractionBucketCounts(
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cBytesPerHistogramBucket,
+   size_t * const pcTotalBucketsMainSpaceOut,
+   size_t * const pcAuxillaryBucketsOut,
+   size_t * const pcBytesBufferOut
+) {
    const size_t cDimensions = pFeatureGroup->GetCountFeatures();
    EBM_ASSERT(1 <= cDimensions); // situations with 0 dimensions should have been filtered out before this function was called (but still inside the C++)
 
@@ -78,7 +100,7 @@ static bool CalculateInteractionScoreInternal(
          // unlike in the boosting code where we check at allocation time if the tensor created overflows on multiplication
          // we don't know what group of features our caller will give us for calculating the interaction scores,
          // so we need to check if our caller gave us a tensor that overflows multiplication
-         LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal IsMultiplyError(cTotalBucketsMainSpace, cBins)");
+         LOG_0(TraceLevelWarning, "WARNING GetInteractionBucketCounts IsMultiplyError(cTotalBucketsMainSpace, cBins)");
          return true;
       }
       cTotalBucketsMainSpace *= cBins;
@@ -90,156 +112,250 @@ static bool CalculateInteractionScoreInternal(
    const size_t cAuxillaryBuckets =
       cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ? cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals;
    if(IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)");
+      LOG_0(TraceLevelWarning, "WARNING GetInteractionBucketCounts IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)");
       return true;
    }
-   const size_t cTotalBuckets = cTotalBucketsMainSpace + cAuxillaryBuckets;
-
-   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      LOG_0(
-         TraceLevelWarning,
-         "WARNING CalculateInteractionScoreInternal GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)"
-      );
-      return true;
+   size_t cTotalBuckets = cTotalBucketsMainSpace + cAuxillaryBuckets;
+   if(IsTensorTotalsMirrored(cDimensions)) {
+      // the mirrored totals go after the auxiliary zone
+      if(IsAddError(cTotalBuckets, cTotalBucketsMainSpace)) {
+         LOG_0(TraceLevelWarning, "WARNING GetInteractionBucketCounts IsAddError(cTotalBuckets, cTotalBucketsMainSpace)");
+         return true;
+      }
+      cTotalBuckets += cTotalBucketsMainSpace;
    }
-   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
    if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
+      LOG_0(TraceLevelWarning, "WARNING GetInteractionBucketCounts IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
       return true;
    }
-   const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
 
-   // this doesn't need to be freed since it's tracked and re-used by the class CachedInteractionThreadResources
-   HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal nullptr == aHistogramBuckets");
-      return true;
-   }
+   *pcTotalBucketsMainSpaceOut = cTotalBucketsMainSpace;
+   *pcAuxillaryBucketsOut = cAuxillaryBuckets;
+   *pcBytesBufferOut = cTotalBuckets * cBytesPerHistogramBucket;
+   return false;
+}
 
-   if(bClassification) {
-      HistogramBucket<true> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<true>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<true> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
-   } else {
-      HistogramBucket<false> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<false>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<false> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
-      }
+// our buffers are re-used between feature groups, so they hold the tensor totals of the last feature group that
+// used them.  We only zero the binned tensor and the parts of the auxiliary zone that TensorTotalsBuild expects to be
+// zero.  Everything else is overwritten before it's read
+static void ZeroInteractionBuckets(
+   const size_t cVectorLength,
+   const size_t cBytesPerHistogramBucket,
+   const size_t cDimensions,
+   const size_t cTotalBucketsMainSpace,
+   const size_t cAuxillaryBuckets,
+   HistogramBucketBase * const aHistogramBuckets
+) {
+   const size_t cTotalBuckets = cTotalBucketsMainSpace + 
+      (IsTensorTotalsAuxiliaryZeroRequired(cDimensions) ? cAuxillaryBuckets : size_t { 0 });
+   HistogramBucket<k_bInteractionNeedDenominator> * const aHistogramBucketsLocal = 
+      aHistogramBuckets->GetHistogramBucket<k_bInteractionNeedDenominator>();
+   for(size_t i = 0; i < cTotalBuckets; ++i) {
+      HistogramBucket<k_bInteractionNeedDenominator> * const pHistogramBucket =
+         GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
+      pHistogramBucket->Zero(cVectorLength);
    }
+}
 
-   HistogramBucketBase * pAuxiliaryBucketZone =
-      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, cTotalBucketsMainSpace);
-
+// builds the tensor totals from histograms that have already been binned and finds the best interaction gain.  This
+// doesn't touch anything mutable in pEbmInteractionState, so different threads can score different histograms
+static FloatEbmType ScoreInteractionBuckets(
+   EbmInteractionState * const pEbmInteractionState,
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cSamplesRequiredForChildSplitMin,
+   const size_t cTotalBucketsMainSpace,
+   const size_t cAuxillaryBuckets,
+   HistogramBucketBase * const aHistogramBuckets
 #ifndef NDEBUG
-   const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
+   , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
 
-   BinInteraction(
-      pEbmInteractionState,
-      pFeatureGroup,
-      aHistogramBuckets
-#ifndef NDEBUG
-      , aHistogramBucketsEndDebug
-#endif // NDEBUG
-   );
+   const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+   const bool bMirrored = IsTensorTotalsMirrored(cDimensions);
+
+   HistogramBucketBase * pAuxiliaryBucketZone =
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, cTotalBucketsMainSpace);
+
+   HistogramBucketBase * const aHistogramBucketsMirror = bMirrored ? 
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, cTotalBucketsMainSpace + cAuxillaryBuckets) : nullptr;
 
 #ifndef NDEBUG
    // make a copy of the original binned buckets for debugging purposes
-   size_t cTotalBucketsDebug = 1;
-   for(size_t iDimensionDebug = 0; iDimensionDebug < cDimensions; ++iDimensionDebug) {
-      const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimensionDebug].m_pFeature->GetCountBins();
-      EBM_ASSERT(!IsMultiplyError(cTotalBucketsDebug, cBins)); // we checked this above
-      cTotalBucketsDebug *= cBins;
-   }
-   // we wouldn't have been able to allocate our main buffer above if this wasn't ok
-   EBM_ASSERT(!IsMultiplyError(cTotalBucketsDebug, cBytesPerHistogramBucket));
+   // we wouldn't have been able to allocate our main buffer if this wasn't ok
+   EBM_ASSERT(!IsMultiplyError(cTotalBucketsMainSpace, cBytesPerHistogramBucket));
    HistogramBucketBase * const aHistogramBucketsDebugCopy =
-      EbmMalloc<HistogramBucketBase>(cTotalBucketsDebug, cBytesPerHistogramBucket);
+      EbmMalloc<HistogramBucketBase>(cTotalBucketsMainSpace, cBytesPerHistogramBucket);
    if(nullptr != aHistogramBucketsDebugCopy) {
       // if we can't allocate, don't fail.. just stop checking
-      const size_t cBytesBufferDebug = cTotalBucketsDebug * cBytesPerHistogramBucket;
+      const size_t cBytesBufferDebug = cTotalBucketsMainSpace * cBytesPerHistogramBucket;
       memcpy(aHistogramBucketsDebugCopy, aHistogramBuckets, cBytesBufferDebug);
    }
 #endif // NDEBUG
 
    TensorTotalsBuild(
       runtimeLearningTypeOrCountTargetClasses,
+      k_bInteractionNeedDenominator,
       pFeatureGroup,
       pAuxiliaryBucketZone,
-      aHistogramBuckets
+      aHistogramBuckets,
+      aHistogramBucketsMirror
 #ifndef NDEBUG
       , aHistogramBucketsDebugCopy
       , aHistogramBucketsEndDebug
 #endif // NDEBUG
    );
 
-   if(2 == cDimensions) {
-      LOG_0(TraceLevelVerbose, "CalculateInteractionScoreInternal Starting bin sweep loop");
+   FloatEbmType bestSplittingScore = FloatEbmType { 0 };
+   if(2 == cDimensions || bMirrored) {
+      LOG_0(TraceLevelVerbose, "ScoreInteractionBuckets Starting bin sweep loop");
 
-      FloatEbmType bestSplittingScore = FindBestInteractionGainPairs(
-         pEbmInteractionState,
-         pFeatureGroup,
-         cSamplesRequiredForChildSplitMin,
-         pAuxiliaryBucketZone,
-         aHistogramBuckets
+      if(2 == cDimensions) {
+         bestSplittingScore = FindBestInteractionGainPairs(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets
 #ifndef NDEBUG
-         , aHistogramBucketsDebugCopy
-         , aHistogramBucketsEndDebug
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
 #endif // NDEBUG
-      );
+         );
+      } else {
+         bestSplittingScore = FindBestInteractionGainMulti(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets,
+            aHistogramBucketsMirror
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
 
-      LOG_0(TraceLevelVerbose, "CalculateInteractionScoreInternal Done bin sweep loop");
+      LOG_0(TraceLevelVerbose, "ScoreInteractionBuckets Done bin sweep loop");
 
-      if(nullptr != pInteractionScoreReturn) {
-         // we started our score at zero, and didn't replace with anything lower, so it can't be below zero
-         // if we collected a NaN value, then we kept it
-         EBM_ASSERT(std::isnan(bestSplittingScore) || FloatEbmType { 0 } <= bestSplittingScore);
-         EBM_ASSERT((!bClassification) || !std::isinf(bestSplittingScore));
+      // we started our score at zero, and didn't replace with anything lower, so it can't be below zero
+      // if we collected a NaN value, then we kept it
+      EBM_ASSERT(std::isnan(bestSplittingScore) || FloatEbmType { 0 } <= bestSplittingScore);
+      EBM_ASSERT((!IsClassification(runtimeLearningTypeOrCountTargetClasses)) || !std::isinf(bestSplittingScore));
 
-         // if bestSplittingScore was NaN we make it zero so that it's not included.  If infinity, also don't include it since we overloaded something
-         // even though bestSplittingScore shouldn't be +-infinity for classification, we check it for +-infinity 
-         // here since it's most efficient to check that the exponential is all ones, which is the case only for +-infinity and NaN, but not others
+      // if bestSplittingScore was NaN we make it zero so that it's not included.  If infinity, also don't include it since we overloaded something
+      // even though bestSplittingScore shouldn't be +-infinity for classification, we check it for +-infinity 
+      // here since it's most efficient to check that the exponential is all ones, which is the case only for +-infinity and NaN, but not others
 
-         // comparing to max is a good way to check for +infinity without using infinity, which can be problematic on
-         // some compilers with some compiler settings.  Using <= helps avoid optimization away because the compiler
-         // might assume that nothing is larger than max if it thinks there's no +infinity
+      // comparing to max is a good way to check for +infinity without using infinity, which can be problematic on
+      // some compilers with some compiler settings.  Using <= helps avoid optimization away because the compiler
+      // might assume that nothing is larger than max if it thinks there's no +infinity
 
-         if(UNLIKELY(UNLIKELY(std::isnan(bestSplittingScore)) || 
-            UNLIKELY(std::numeric_limits<FloatEbmType>::max() <= bestSplittingScore))) {
-            bestSplittingScore = FloatEbmType { 0 };
-         }
-         *pInteractionScoreReturn = bestSplittingScore;
+      if(UNLIKELY(UNLIKELY(std::isnan(bestSplittingScore)) || 
+         UNLIKELY(std::numeric_limits<FloatEbmType>::max() <= bestSplittingScore))) {
+         bestSplittingScore = FloatEbmType { 0 };
       }
    } else {
-      EBM_ASSERT(false); // we only support pairs currently
-      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal 2 != cDimensions");
+      EBM_ASSERT(false); // we only support 2 or more dimensions currently
+      LOG_0(TraceLevelWarning, "WARNING ScoreInteractionBuckets cDimensions < 2");
 
       // TODO: handle this better
-      if(nullptr != pInteractionScoreReturn) {
-         // for now, just return any interactions that have other than 2 dimensions as zero, which means they won't be considered
-         *pInteractionScoreReturn = FloatEbmType { 0 };
-      }
+      // for now, just return any interactions that have less than 2 dimensions as zero, which means they won't be considered
    }
 
 #ifndef NDEBUG
    free(aHistogramBucketsDebugCopy);
 #endif // NDEBUG
 
+   return bestSplittingScore;
+}
+
+static bool CalculateInteractionScoreInternal(
+   CachedInteractionThreadResources * const pCachedThreadResources,
+   EbmInteractionState * const pEbmInteractionState,
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cSamplesRequiredForChildSplitMin,
+   FloatEbmType * const pInteractionScoreReturn
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   LOG_0(TraceLevelVerbose, "Entered CalculateInteractionScoreInternal");
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   if(GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)) {
+      LOG_0(
+         TraceLevelWarning,
+         "WARNING CalculateInteractionScoreInternal GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)"
+      );
+      return true;
+   }
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
+
+   size_t cTotalBucketsMainSpace;
+   size_t cAuxillaryBuckets;
+   size_t cBytesBuffer;
+   if(GetInteractionBucketCounts(pFeatureGroup, cBytesPerHistogramBucket, &cTotalBucketsMainSpace, &cAuxillaryBuckets, &cBytesBuffer)) {
+      return true;
+   }
+
+   // this doesn't need to be freed since it's tracked and re-used by the class CachedInteractionThreadResources
+   HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
+   if(UNLIKELY(nullptr == aHistogramBuckets)) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreInternal nullptr == aHistogramBuckets");
+      return true;
+   }
+
+   ZeroInteractionBuckets(
+      cVectorLength, 
+      cBytesPerHistogramBucket, 
+      pFeatureGroup->GetCountFeatures(), 
+      cTotalBucketsMainSpace, 
+      cAuxillaryBuckets, 
+      aHistogramBuckets
+   );
+
+#ifndef NDEBUG
+   const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
+#endif // NDEBUG
+
+   BinInteraction(
+      pEbmInteractionState,
+      pFeatureGroup,
+      aHistogramBuckets
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+
+   const FloatEbmType bestSplittingScore = ScoreInteractionBuckets(
+      pEbmInteractionState,
+      pFeatureGroup,
+      cSamplesRequiredForChildSplitMin,
+      cTotalBucketsMainSpace,
+      cAuxillaryBuckets,
+      aHistogramBuckets
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+   if(nullptr != pInteractionScoreReturn) {
+      *pInteractionScoreReturn = bestSplittingScore;
+   }
+
    LOG_0(TraceLevelVerbose, "Exited CalculateInteractionScoreInternal");
    return false;
 }
 
 // we made this a global because if we had put this variable inside the EbmInteractionState object, then we would need to dereference that before getting 
-// the count.  By making this global we can send a log message incase a bad EbmInteractionState object is sent into us we only decrease the count if the 
-// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
-static int g_cLogCalculateInteractionScoreParametersMessages = 10;
+// the count.  By making this global we can send a log message incase a bad EbmInteractionState object is sent into us.  Any thread can call us, 
+// so the count is atomic
+static std::atomic<int> g_cLogCalculateInteractionScoreParametersMessages { 10 };
 
 EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScore(
    PEbmInteraction ebmInteraction,
@@ -404,22 +520,16 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
       return 0;
    }
 
-   // TODO : be smarter about our CachedInteractionThreadResources, otherwise why have it?
-   CachedInteractionThreadResources * const pCachedThreadResources = CachedInteractionThreadResources::Allocate();
-   if(nullptr == pCachedThreadResources) {
-      return 1;
-   }
-
+   // we run on the caller's thread, so we use the first thread's buffer.  It was sized for the largest pair when
+   // pEbmInteractionState was created
    IntEbmType ret = CalculateInteractionScoreInternal(
-      pCachedThreadResources,
+      pEbmInteractionState->GetCachedThreadResources(0),
       pEbmInteractionState,
       pFeatureGroup,
       cSamplesRequiredForChildSplitMin,
       interactionScoreOut
    );
 
-   CachedInteractionThreadResources::Free(pCachedThreadResources);
-
    if(0 != ret) {
       LOG_N(TraceLevelWarning, "WARNING CalculateInteractionScore returned %" IntEbmTypePrintf, ret);
    }
@@ -438,3 +548,836 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Calculate
    }
    return ret;
 }
+
+class InteractionPairsContext final {
+public:
+
+   InteractionPairsContext() = default; // preserve our POD status
+   ~InteractionPairsContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   EbmInteractionState * m_pEbmInteractionState;
+   const DataSetByFeature * m_pDataSet;
+   size_t m_cSamplesRequiredForChildSplitMin;
+   const IntEbmType * m_aFeatureIndexPairs;
+   FloatEbmType * m_aInteractionScoresOut;
+
+   // m_aiPairs holds the indexes of the pairs that need scanning, sorted by their first feature.  Scan iScan covers
+   // m_aiPairs[m_aiScansStart[iScan]] up to but not including m_aiPairs[m_aiScansStart[iScan + 1]]
+   const size_t * m_aiPairs;
+   const size_t * m_aiScansStart;
+   size_t m_cScans;
+   size_t m_cTasks;
+
+   size_t m_cBytesScanMax;
+
+   // CalculateInteractionScoreTopPairs only needs the best m_cTopPairs scores, so each task keeps the best scores that
+   // it has found in a min heap of m_cTopPairs items at m_aTopScores + iTask * m_cTopPairs, and skips the cut sweep of
+   // pairs whose bound can't beat the worst of them.  Each task also gets m_cBinsMax items of m_aBoundScratch for
+   // BoundInteractionBuckets.  0 == m_cTopPairs scores every pair
+   size_t m_cTopPairs;
+   FloatEbmType * m_aTopScores;
+   size_t m_cBinsMax;
+   FloatEbmType * m_aBoundScratch;
+};
+static_assert(std::is_standard_layout<InteractionPairsContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<InteractionPairsContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<InteractionPairsContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class InteractionPairsFirstFeatureLess final {
+   const IntEbmType * const m_aFeatureIndexPairs;
+
+public:
+
+   InteractionPairsFirstFeatureLess(const IntEbmType * const aFeatureIndexPairs) : 
+      m_aFeatureIndexPairs(aFeatureIndexPairs) {
+   }
+
+   INLINE_ALWAYS bool operator() (const size_t iPair1, const size_t iPair2) const {
+      // the pair index breaks ties so that our scans don't depend on the std::sort implementation
+      const IntEbmType iFeature1 = m_aFeatureIndexPairs[iPair1 << 1];
+      const IntEbmType iFeature2 = m_aFeatureIndexPairs[iPair2 << 1];
+      return iFeature1 < iFeature2 || iFeature1 == iFeature2 && iPair1 < iPair2;
+   }
+};
+
+class InteractionPairsScoreGreater final {
+   const FloatEbmType * const m_aInteractionScores;
+
+public:
+
+   InteractionPairsScoreGreater(const FloatEbmType * const aInteractionScores) :
+      m_aInteractionScores(aInteractionScores) {
+   }
+
+   INLINE_ALWAYS bool operator() (const size_t iPair1, const size_t iPair2) const {
+      // our scores are never NaN.  The pair index breaks ties so that our candidates don't depend on the sort
+      const FloatEbmType score1 = m_aInteractionScores[iPair1];
+      const FloatEbmType score2 = m_aInteractionScores[iPair2];
+      return score2 < score1 || score1 == score2 && iPair1 < iPair2;
+   }
+};
+
+// the pairs that the top pairs search skipped.  Real scores are never negative
+constexpr FloatEbmType k_interactionScorePruned = FloatEbmType { -1 };
+
+// the bounds and the scores sum the same cells in a different order, so we only skip a pair if its bound is below
+// the worst of the top scores by more than the rounding could account for
+constexpr FloatEbmType k_interactionBoundSlack = FloatEbmType { 1e-9 };
+
+// the best over the cuts of the inner dimension of the partition that cuts every row of the outer dimension at that
+// cut.  aBoundScratch needs cInner - 1 items
+static FloatEbmType BoundInteractionBucketsDimension(
+   const size_t cVectorLength,
+   const size_t cBytesPerHistogramBucket,
+   const size_t cOuter,
+   const size_t cStrideOuter,
+   const size_t cInner,
+   const size_t cStrideInner,
+   const HistogramBucket<k_bInteractionNeedDenominator> * const aHistogramBuckets,
+   FloatEbmType * const aBoundScratch
+) {
+   EBM_ASSERT(2 <= cInner);
+   for(size_t iBin = 1; iBin < cInner; ++iBin) {
+      aBoundScratch[iBin - 1] = FloatEbmType { 0 };
+   }
+   for(size_t iOuter = 0; iOuter < cOuter; ++iOuter) {
+      const size_t iBinStart = iOuter * cStrideOuter;
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         FloatEbmType sumResidualErrorTotal = FloatEbmType { 0 };
+         size_t cSamplesTotal = 0;
+         for(size_t iInner = 0; iInner < cInner; ++iInner) {
+            const HistogramBucket<k_bInteractionNeedDenominator> * const pHistogramBucket = GetHistogramBucketByIndex(
+               cBytesPerHistogramBucket, aHistogramBuckets, iBinStart + iInner * cStrideInner);
+            sumResidualErrorTotal += pHistogramBucket->GetHistogramBucketVectorEntry()[iVector].m_sumResidualError;
+            cSamplesTotal += pHistogramBucket->GetCountSamplesInBucket();
+         }
+         FloatEbmType sumResidualErrorLow = FloatEbmType { 0 };
+         size_t cSamplesLow = 0;
+         for(size_t iCut = 0; iCut < cInner - 1; ++iCut) {
+            const HistogramBucket<k_bInteractionNeedDenominator> * const pHistogramBucket = GetHistogramBucketByIndex(
+               cBytesPerHistogramBucket, aHistogramBuckets, iBinStart + iCut * cStrideInner);
+            sumResidualErrorLow += pHistogramBucket->GetHistogramBucketVectorEntry()[iVector].m_sumResidualError;
+            cSamplesLow += pHistogramBucket->GetCountSamplesInBucket();
+            const size_t cSamplesHigh = cSamplesTotal - cSamplesLow;
+            // empty cells have nothing to add, and ComputeNodeSplittingScore needs at least 1 sample
+            if(0 != cSamplesLow) {
+               aBoundScratch[iCut] += EbmStatistics::ComputeNodeSplittingScore(
+                  sumResidualErrorLow, static_cast<FloatEbmType>(cSamplesLow));
+            }
+            if(0 != cSamplesHigh) {
+               aBoundScratch[iCut] += EbmStatistics::ComputeNodeSplittingScore(
+                  sumResidualErrorTotal - sumResidualErrorLow, static_cast<FloatEbmType>(cSamplesHigh));
+            }
+         }
+      }
+   }
+   FloatEbmType bound = aBoundScratch[0];
+   for(size_t iCut = 1; iCut < cInner - 1; ++iCut) {
+      // propagate NaN values so that we never skip a pair because of them
+      bound = aBoundScratch[iCut] <= bound ? bound : aBoundScratch[iCut];
+   }
+   return bound;
+}
+
+// an upper bound on what FindBestInteractionGainPairs finds in the binned histogram of a pair, which has to be called
+// before TensorTotalsBuild turns the cells into totals.  The quadrants of the cuts (iBin1, iBin2) merge the cells of
+// the partition that cuts every bin of the first feature at iBin2, and merging cells never raises the sum of
+// sumResidualError^2 / cSamples, so the best such partition over iBin2 bounds every cut.  The same holds with the
+// features swapped, and we return the smaller of the two bounds.  This costs a pass over the cells for each dimension,
+// which is much cheaper than the cut sweep of FindBestInteractionGainPairs.  aBoundScratch needs as many items as
+// the larger of the two features has bins
+static FloatEbmType BoundInteractionBuckets(
+   const size_t cVectorLength,
+   const size_t cBytesPerHistogramBucket,
+   const size_t cBins0,
+   const size_t cBins1,
+   const HistogramBucketBase * const aHistogramBucketsBase,
+   FloatEbmType * const aBoundScratch
+) {
+   const HistogramBucket<k_bInteractionNeedDenominator> * const aHistogramBuckets =
+      aHistogramBucketsBase->GetHistogramBucket<k_bInteractionNeedDenominator>();
+   const FloatEbmType bound0 = BoundInteractionBucketsDimension(
+      cVectorLength, cBytesPerHistogramBucket, cBins0, 1, cBins1, cBins0, aHistogramBuckets, aBoundScratch);
+   const FloatEbmType bound1 = BoundInteractionBucketsDimension(
+      cVectorLength, cBytesPerHistogramBucket, cBins1, cBins0, cBins0, 1, aHistogramBuckets, aBoundScratch);
+   return bound1 < bound0 ? bound1 : bound0;
+}
+
+static void ScoreInteractionPairsScan(
+   const InteractionPairsContext * const pContext, 
+   const size_t iScan, 
+   unsigned char * const pScratch,
+   FloatEbmType * const aTopScores,
+   FloatEbmType * const aBoundScratch
+) {
+   EbmInteractionState * const pEbmInteractionState = pContext->m_pEbmInteractionState;
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
+
+   const size_t * const aiPairsScan = &pContext->m_aiPairs[pContext->m_aiScansStart[iScan]];
+   const size_t cPairs = pContext->m_aiScansStart[iScan + 1] - pContext->m_aiScansStart[iScan];
+   EBM_ASSERT(1 <= cPairs);
+   EBM_ASSERT(cPairs <= k_cInteractionPairsPerScanMax);
+
+   const Feature * const aFeatures = pEbmInteractionState->GetFeatures();
+   const IntEbmType * const aFeatureIndexPairs = pContext->m_aFeatureIndexPairs;
+   const Feature * const pFeature0 = &aFeatures[static_cast<size_t>(aFeatureIndexPairs[aiPairsScan[0] << 1])];
+
+   char FeatureGroupBuffer[FeatureGroup::GetFeatureGroupCountBytes(2)];
+   FeatureGroup * const pFeatureGroup = reinterpret_cast<FeatureGroup *>(&FeatureGroupBuffer);
+   pFeatureGroup->Initialize(2, 0);
+   FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+   aFeatureGroupEntries[0].m_pFeature = pFeature0;
+
+   // the compiler can't see that we fill one entry per pair below, so zero these to keep it from warning
+   const Feature * apFeatures1[k_cInteractionPairsPerScanMax] = {};
+   HistogramBucketBase * aaHistogramBuckets[k_cInteractionPairsPerScanMax] = {};
+   size_t acTotalBucketsMainSpace[k_cInteractionPairsPerScanMax];
+   size_t acAuxillaryBuckets[k_cInteractionPairsPerScanMax];
+#ifndef NDEBUG
+   const unsigned char * aHistogramBucketsEndDebug[k_cInteractionPairsPerScanMax];
+#endif // NDEBUG
+
+   unsigned char * pBuffer = pScratch;
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      const IntEbmType * const pFeatureIndexPair = &aFeatureIndexPairs[aiPairsScan[iPair] << 1];
+      EBM_ASSERT(aFeatureIndexPairs[aiPairsScan[0] << 1] == pFeatureIndexPair[0]);
+      const Feature * const pFeature1 = &aFeatures[static_cast<size_t>(pFeatureIndexPair[1])];
+      apFeatures1[iPair] = pFeature1;
+      aFeatureGroupEntries[1].m_pFeature = pFeature1;
+
+      size_t cBytesBuffer;
+      // we checked every pair before launching our tasks
+      const bool bError = GetInteractionBucketCounts(
+         pFeatureGroup, 
+         cBytesPerHistogramBucket, 
+         &acTotalBucketsMainSpace[iPair], 
+         &acAuxillaryBuckets[iPair], 
+         &cBytesBuffer
+      );
+      EBM_ASSERT(!bError);
+      UNUSED(bError);
+
+      HistogramBucketBase * const aHistogramBuckets = reinterpret_cast<HistogramBucketBase *>(pBuffer);
+      ZeroInteractionBuckets(
+         cVectorLength, 
+         cBytesPerHistogramBucket, 
+         2, 
+         acTotalBucketsMainSpace[iPair], 
+         acAuxillaryBuckets[iPair], 
+         aHistogramBuckets
+      );
+      aaHistogramBuckets[iPair] = aHistogramBuckets;
+      pBuffer += cBytesBuffer;
+#ifndef NDEBUG
+      aHistogramBucketsEndDebug[iPair] = pBuffer;
+#endif // NDEBUG
+   }
+   EBM_ASSERT(static_cast<size_t>(pBuffer - pScratch) <= pContext->m_cBytesScanMax);
+
+   BinInteractionPairs(
+      pEbmInteractionState,
+      pContext->m_pDataSet,
+      pFeature0,
+      cPairs,
+      apFeatures1,
+      aaHistogramBuckets
+#ifndef NDEBUG
+      , pBuffer
+#endif // NDEBUG
+   );
+
+   const size_t cTopPairs = pContext->m_cTopPairs;
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      aFeatureGroupEntries[1].m_pFeature = apFeatures1[iPair];
+      if(0 != cTopPairs) {
+         const FloatEbmType bound = BoundInteractionBuckets(
+            cVectorLength,
+            cBytesPerHistogramBucket,
+            pFeature0->GetCountBins(),
+            apFeatures1[iPair]->GetCountBins(),
+            aaHistogramBuckets[iPair],
+            aBoundScratch
+         );
+         // our heap starts out filled with zeros, and bounds are never negative, so we only skip pairs once we have 
+         // found cTopPairs scores.  A NaN bound is never skipped
+         if(bound + bound * k_interactionBoundSlack < aTopScores[0]) {
+            pContext->m_aInteractionScoresOut[aiPairsScan[iPair]] = k_interactionScorePruned;
+            continue;
+         }
+      }
+      const FloatEbmType score = ScoreInteractionBuckets(
+         pEbmInteractionState,
+         pFeatureGroup,
+         pContext->m_cSamplesRequiredForChildSplitMin,
+         acTotalBucketsMainSpace[iPair],
+         acAuxillaryBuckets[iPair],
+         aaHistogramBuckets[iPair]
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug[iPair]
+#endif // NDEBUG
+      );
+      pContext->m_aInteractionScoresOut[aiPairsScan[iPair]] = score;
+      if(0 != cTopPairs && aTopScores[0] < score) {
+         std::pop_heap(aTopScores, aTopScores + cTopPairs, std::greater<FloatEbmType>());
+         aTopScores[cTopPairs - 1] = score;
+         std::push_heap(aTopScores, aTopScores + cTopPairs, std::greater<FloatEbmType>());
+      }
+   }
+}
+
+static void ScoreInteractionPairsTask(void * const pContextVoid, const size_t iTask) {
+   const InteractionPairsContext * const pContext = static_cast<const InteractionPairsContext *>(pContextVoid);
+   // we grew every task's buffer before launching the tasks, so this can't allocate
+   unsigned char * const pScratch = reinterpret_cast<unsigned char *>(
+      pContext->m_pEbmInteractionState->GetCachedThreadResources(iTask)->GetThreadByteBuffer1(pContext->m_cBytesScanMax)
+   );
+   EBM_ASSERT(nullptr != pScratch);
+   FloatEbmType * const aTopScores = 
+      nullptr == pContext->m_aTopScores ? nullptr : pContext->m_aTopScores + iTask * pContext->m_cTopPairs;
+   FloatEbmType * const aBoundScratch = 
+      nullptr == pContext->m_aBoundScratch ? nullptr : pContext->m_aBoundScratch + iTask * pContext->m_cBinsMax;
+   // each task goes through its scans in order, so the pairs that we skip only depend on the number of tasks, and
+   // the best scores never depend on them
+   for(size_t iScan = iTask; iScan < pContext->m_cScans; iScan += pContext->m_cTasks) {
+      ScoreInteractionPairsScan(pContext, iScan, pScratch, aTopScores, aBoundScratch);
+   }
+}
+
+// scores the cPairsToScan pairs whose indexes are at the start of aiPairs on the samples in pDataSet.  aiPairs needs
+// room for cPairsToScan * 2 + 1 items since we re-order the pair indexes and put our scan boundaries after them.  If
+// cTopPairs is not zero, pairs that can't be among the best cTopPairs get k_interactionScorePruned instead of a score
+static bool ScoreInteractionPairs(
+   EbmInteractionState * const pEbmInteractionState,
+   const DataSetByFeature * const pDataSet,
+   const IntEbmType * const featureIndexPairs,
+   const size_t cSamplesRequiredForChildSplitMin,
+   const size_t cBytesPerHistogramBucket,
+   const size_t cPairsToScan,
+   const size_t cTopPairs,
+   size_t * const aiPairs,
+   FloatEbmType * const interactionScoresOut
+) {
+   EBM_ASSERT(1 <= cPairsToScan);
+   EBM_ASSERT(1 <= pDataSet->GetCountSamples());
+
+   const Feature * const aFeatures = pEbmInteractionState->GetFeatures();
+   size_t * const aiScansStart = aiPairs + cPairsToScan;
+
+   // sorting by the first feature puts all the pairs that can share a scan next to each other
+   std::sort(aiPairs, aiPairs + cPairsToScan, InteractionPairsFirstFeatureLess(featureIndexPairs));
+
+   char FeatureGroupBuffer[FeatureGroup::GetFeatureGroupCountBytes(2)];
+   FeatureGroup * const pFeatureGroup = reinterpret_cast<FeatureGroup *>(&FeatureGroupBuffer);
+   pFeatureGroup->Initialize(2, 0);
+   FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+
+   size_t cScans = 0;
+   size_t cBytesScanMax = 0;
+   size_t cBytesScan = 0;
+   size_t cPairsInScan = 0;
+   size_t cBinsMax = 0;
+   for(size_t iPairSorted = 0; iPairSorted < cPairsToScan; ++iPairSorted) {
+      const IntEbmType * const pFeatureIndexPair = &featureIndexPairs[aiPairs[iPairSorted] << 1];
+      aFeatureGroupEntries[0].m_pFeature = &aFeatures[static_cast<size_t>(pFeatureIndexPair[0])];
+      aFeatureGroupEntries[1].m_pFeature = &aFeatures[static_cast<size_t>(pFeatureIndexPair[1])];
+      const size_t cBins0 = aFeatureGroupEntries[0].m_pFeature->GetCountBins();
+      const size_t cBins1 = aFeatureGroupEntries[1].m_pFeature->GetCountBins();
+      cBinsMax = cBinsMax < cBins0 ? cBins0 : cBinsMax;
+      cBinsMax = cBinsMax < cBins1 ? cBins1 : cBinsMax;
+
+      size_t cTotalBucketsMainSpace;
+      size_t cAuxillaryBuckets;
+      size_t cBytesPair;
+      if(GetInteractionBucketCounts(pFeatureGroup, cBytesPerHistogramBucket, &cTotalBucketsMainSpace, &cAuxillaryBuckets, &cBytesPair)) {
+         return true;
+      }
+
+      if(0 == cPairsInScan || 
+         featureIndexPairs[aiPairs[iPairSorted - 1] << 1] != pFeatureIndexPair[0] ||
+         k_cInteractionPairsPerScanMax == cPairsInScan ||
+         k_cBytesInteractionScanBudget < cBytesScan || 
+         k_cBytesInteractionScanBudget - cBytesScan < cBytesPair
+      ) {
+         // start a new scan
+         aiScansStart[cScans] = iPairSorted;
+         ++cScans;
+         cBytesScan = 0;
+         cPairsInScan = 0;
+      }
+      // the first pair of a scan can exceed our budget, but every later pair fits within it, so this can't overflow
+      EBM_ASSERT(!IsAddError(cBytesScan, cBytesPair));
+      cBytesScan += cBytesPair;
+      ++cPairsInScan;
+      cBytesScanMax = cBytesScanMax < cBytesScan ? cBytesScan : cBytesScanMax;
+   }
+   EBM_ASSERT(1 <= cScans);
+   EBM_ASSERT(cScans <= cPairsToScan);
+   aiScansStart[cScans] = cPairsToScan;
+
+   const size_t cThreads = pEbmInteractionState->GetCountCachedThreadResources();
+   const size_t cTasks = cScans < cThreads ? cScans : cThreads;
+
+   for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+      // our buffers were sized for scans of distinct features, so this only allocates for pairs of a feature with itself
+      if(nullptr == pEbmInteractionState->GetCachedThreadResources(iTask)->GetThreadByteBuffer1(cBytesScanMax)) {
+         LOG_0(TraceLevelWarning, "WARNING ScoreInteractionPairs nullptr == GetThreadByteBuffer1(cBytesScanMax)");
+         return true;
+      }
+   }
+
+   FloatEbmType * aTopScores = nullptr;
+   FloatEbmType * aBoundScratch = nullptr;
+   if(0 != cTopPairs) {
+      if(IsMultiplyError(cTasks, cTopPairs) || IsMultiplyError(cTasks, cBinsMax)) {
+         LOG_0(TraceLevelWarning, "WARNING ScoreInteractionPairs IsMultiplyError(cTasks, cTopPairs) || IsMultiplyError(cTasks, cBinsMax)");
+         return true;
+      }
+      aTopScores = EbmMalloc<FloatEbmType>(cTasks * cTopPairs);
+      aBoundScratch = EbmMalloc<FloatEbmType>(cTasks * cBinsMax);
+      if(nullptr == aTopScores || nullptr == aBoundScratch) {
+         LOG_0(TraceLevelWarning, "WARNING ScoreInteractionPairs nullptr == aTopScores || nullptr == aBoundScratch");
+         free(aTopScores);
+         free(aBoundScratch);
+         return true;
+      }
+      for(size_t iTopScore = 0; iTopScore < cTasks * cTopPairs; ++iTopScore) {
+         aTopScores[iTopScore] = FloatEbmType { 0 };
+      }
+   }
+
+   InteractionPairsContext context;
+   context.m_pEbmInteractionState = pEbmInteractionState;
+   context.m_pDataSet = pDataSet;
+   context.m_cSamplesRequiredForChildSplitMin = cSamplesRequiredForChildSplitMin;
+   context.m_aFeatureIndexPairs = featureIndexPairs;
+   context.m_aInteractionScoresOut = interactionScoresOut;
+   context.m_aiPairs = aiPairs;
+   context.m_aiScansStart = aiScansStart;
+   context.m_cScans = cScans;
+   context.m_cTasks = cTasks;
+   context.m_cBytesScanMax = cBytesScanMax;
+   context.m_cTopPairs = cTopPairs;
+   context.m_aTopScores = aTopScores;
+   context.m_cBinsMax = cBinsMax;
+   context.m_aBoundScratch = aBoundScratch;
+
+   ThreadPool::ParallelFor(cTasks, ScoreInteractionPairsTask, &context);
+
+   free(aTopScores);
+   free(aBoundScratch);
+   return false;
+}
+
+// checks every pair of featureIndexPairs and counts the pairs that need scanning, which are the pairs where both 
+// features have at least 2 bins.  Returns true on error
+static bool CountInteractionPairsScanned(
+   const EbmInteractionState * const pEbmInteractionState,
+   const size_t cPairs,
+   const IntEbmType * const featureIndexPairs,
+   size_t * const pcPairsScannedOut
+) {
+   const Feature * const aFeatures = pEbmInteractionState->GetFeatures();
+   size_t cPairsScanned = 0;
+   const IntEbmType * const pFeatureIndexPairsEnd = featureIndexPairs + (cPairs << 1);
+   for(const IntEbmType * pFeatureIndex = featureIndexPairs; pFeatureIndexPairsEnd != pFeatureIndex; pFeatureIndex += 2) {
+      if(pFeatureIndex[0] < 0 || pFeatureIndex[1] < 0) {
+         LOG_0(TraceLevelError, "ERROR CountInteractionPairsScanned featureIndexPairs value cannot be negative");
+         return true;
+      }
+      if(!IsNumberConvertable<size_t>(pFeatureIndex[0]) || !IsNumberConvertable<size_t>(pFeatureIndex[1])) {
+         LOG_0(TraceLevelError, "ERROR CountInteractionPairsScanned featureIndexPairs value too big to reference memory");
+         return true;
+      }
+      const size_t iFeature0 = static_cast<size_t>(pFeatureIndex[0]);
+      const size_t iFeature1 = static_cast<size_t>(pFeatureIndex[1]);
+      if(pEbmInteractionState->GetCountFeatures() <= iFeature0 || pEbmInteractionState->GetCountFeatures() <= iFeature1) {
+         LOG_0(TraceLevelError, "ERROR CountInteractionPairsScanned featureIndexPairs value must be less than the number of features");
+         return true;
+      }
+      if(2 <= aFeatures[iFeature0].GetCountBins() && 2 <= aFeatures[iFeature1].GetCountBins()) {
+         ++cPairsScanned;
+      }
+   }
+   *pcPairsScannedOut = cPairsScanned;
+   return false;
+}
+
+// puts the indexes of the cPairsScanned pairs that CountInteractionPairsScanned counted at the start of aiPairs
+static void FillInteractionPairsScanned(
+   const EbmInteractionState * const pEbmInteractionState,
+   const size_t cPairs,
+   const IntEbmType * const featureIndexPairs,
+   const size_t cPairsScanned,
+   size_t * const aiPairs
+) {
+   const Feature * const aFeatures = pEbmInteractionState->GetFeatures();
+   size_t iPairScanned = 0;
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      const size_t iFeature0 = static_cast<size_t>(featureIndexPairs[iPair << 1]);
+      const size_t iFeature1 = static_cast<size_t>(featureIndexPairs[(iPair << 1) + 1]);
+      if(2 <= aFeatures[iFeature0].GetCountBins() && 2 <= aFeatures[iFeature1].GetCountBins()) {
+         aiPairs[iPairScanned] = iPair;
+         ++iPairScanned;
+      }
+   }
+   EBM_ASSERT(cPairsScanned == iPairScanned);
+   UNUSED(cPairsScanned);
+}
+
+static std::atomic<int> g_cLogCalculateInteractionScorePairsParametersMessages { 10 };
+static std::atomic<int> g_cLogCalculateInteractionScorePairsScreeningMessages { 10 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScorePairs(
+   PEbmInteraction ebmInteraction,
+   IntEbmType countPairs,
+   const IntEbmType * featureIndexPairs,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   FloatEbmType * interactionScoresOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalculateInteractionScorePairsParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "CalculateInteractionScorePairs parameters: ebmInteraction=%p, countPairs=%" IntEbmTypePrintf ", featureIndexPairs=%p, countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", interactionScoresOut=%p",
+      static_cast<void *>(ebmInteraction),
+      countPairs,
+      static_cast<const void *>(featureIndexPairs),
+      countSamplesRequiredForChildSplitMin,
+      static_cast<void *>(interactionScoresOut)
+   );
+
+   EbmInteractionState * pEbmInteractionState = reinterpret_cast<EbmInteractionState *>(ebmInteraction);
+   if(nullptr == pEbmInteractionState) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs ebmInteraction cannot be nullptr");
+      return 1;
+   }
+
+   LOG_COUNTED_0(pEbmInteractionState->GetPointerCountLogEnterMessages(), TraceLevelInfo, TraceLevelVerbose, "Entered CalculateInteractionScorePairs");
+
+   if(countPairs < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs countPairs must be positive");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countPairs)) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs countPairs too large to index");
+      return 1;
+   }
+   const size_t cPairs = static_cast<size_t>(countPairs);
+   if(0 == cPairs) {
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScorePairs no pairs");
+      return 0;
+   }
+   if(nullptr == featureIndexPairs) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs featureIndexPairs cannot be nullptr if 0 < countPairs");
+      return 1;
+   }
+   if(nullptr == interactionScoresOut) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs interactionScoresOut cannot be nullptr if 0 < countPairs");
+      return 1;
+   }
+   if(IsMultiplyError(cPairs, size_t { 2 })) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScorePairs IsMultiplyError(cPairs, 2)");
+      return 1;
+   }
+
+   size_t cSamplesRequiredForChildSplitMin = size_t { 1 }; // this is the min value
+   if(IntEbmType { 1 } <= countSamplesRequiredForChildSplitMin) {
+      cSamplesRequiredForChildSplitMin = static_cast<size_t>(countSamplesRequiredForChildSplitMin);
+      if(!IsNumberConvertable<size_t>(countSamplesRequiredForChildSplitMin)) {
+         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to overflow because it will generate 
+         // the same results as if we used the true number
+         cSamplesRequiredForChildSplitMin = std::numeric_limits<size_t>::max();
+      }
+   } else {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScorePairs countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
+   }
+
+   // pairs that we don't scan below have no interaction, just like CalculateInteractionScore returns for them
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      interactionScoresOut[iPair] = FloatEbmType { 0 };
+   }
+
+   size_t cPairsScanned;
+   if(CountInteractionPairsScanned(pEbmInteractionState, cPairs, featureIndexPairs, &cPairsScanned)) {
+      return 1;
+   }
+
+   if(0 == pEbmInteractionState->GetDataSetByFeature()->GetCountSamples()) {
+      // if there are zero samples, there isn't much basis to say whether there are interactions, so just return zero
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScorePairs zero samples");
+      return 0;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+   if(ptrdiff_t { 0 } == runtimeLearningTypeOrCountTargetClasses || ptrdiff_t { 1 } == runtimeLearningTypeOrCountTargetClasses) {
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScorePairs target with 0/1 classes");
+      return 0;
+   }
+   if(0 == cPairsScanned) {
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScorePairs every pair has a feature with 0/1 value");
+      return 0;
+   }
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   if(GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScorePairs GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)");
+      return 1;
+   }
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
+
+   // we checked above that cPairs * 2 doesn't overflow, and cPairsScanned <= cPairs
+   if(IsAddError(cPairsScanned << 1, size_t { 1 })) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScorePairs IsAddError(cPairsScanned * 2, 1)");
+      return 1;
+   }
+   // there can't be more scans than pairs, so we need at most cPairsScanned + 1 scan boundaries
+   size_t * const aiPairs = EbmMalloc<size_t>((cPairsScanned << 1) + 1);
+   if(nullptr == aiPairs) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScorePairs nullptr == aiPairs");
+      return 1;
+   }
+
+   FillInteractionPairsScanned(pEbmInteractionState, cPairs, featureIndexPairs, cPairsScanned, aiPairs);
+
+   const DataSetByFeature * const pDataSetScreen = pEbmInteractionState->GetDataSetScreen();
+   const size_t cScreenCandidates = pEbmInteractionState->GetCountScreenCandidates();
+   size_t cPairsFinal = cPairsScanned;
+   if(0 != pDataSetScreen->GetCountSamples() && cScreenCandidates < cPairsScanned) {
+      // the screening scores every pair on a subset of the samples, and only the best candidates go on to be 
+      // scored on all the samples
+      if(ScoreInteractionPairs(
+         pEbmInteractionState,
+         pDataSetScreen,
+         featureIndexPairs,
+         cSamplesRequiredForChildSplitMin,
+         cBytesPerHistogramBucket,
+         cPairsScanned,
+         0,
+         aiPairs,
+         interactionScoresOut
+      )) {
+         free(aiPairs);
+         return 1;
+      }
+      std::partial_sort(
+         aiPairs, 
+         aiPairs + cScreenCandidates, 
+         aiPairs + cPairsScanned, 
+         InteractionPairsScoreGreater(interactionScoresOut)
+      );
+      LOG_COUNTED_N(
+         &g_cLogCalculateInteractionScorePairsScreeningMessages,
+         TraceLevelInfo,
+         TraceLevelVerbose,
+         "CalculateInteractionScorePairs screening kept %zu of %zu pairs.  Lowest kept screening score %" FloatEbmTypePrintf 
+         ", highest rejected screening score %" FloatEbmTypePrintf,
+         cScreenCandidates,
+         cPairsScanned,
+         interactionScoresOut[aiPairs[cScreenCandidates - 1]],
+         interactionScoresOut[aiPairs[cScreenCandidates]]
+      );
+      for(size_t iPairRejected = cScreenCandidates; iPairRejected < cPairsScanned; ++iPairRejected) {
+         interactionScoresOut[aiPairs[iPairRejected]] = FloatEbmType { 0 };
+      }
+      cPairsFinal = cScreenCandidates;
+   }
+
+   const bool bError = ScoreInteractionPairs(
+      pEbmInteractionState,
+      pEbmInteractionState->GetDataSetByFeature(),
+      featureIndexPairs,
+      cSamplesRequiredForChildSplitMin,
+      cBytesPerHistogramBucket,
+      cPairsFinal,
+      0,
+      aiPairs,
+      interactionScoresOut
+   );
+   free(aiPairs);
+   if(bError) {
+      return 1;
+   }
+
+   LOG_COUNTED_0(pEbmInteractionState->GetPointerCountLogExitMessages(), TraceLevelInfo, TraceLevelVerbose, "Exited CalculateInteractionScorePairs");
+   return 0;
+}
+
+static std::atomic<int> g_cLogCalculateInteractionScoreTopPairsParametersMessages { 10 };
+static std::atomic<int> g_cLogCalculateInteractionScoreTopPairsPrunedMessages { 10 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScoreTopPairs(
+   PEbmInteraction ebmInteraction,
+   IntEbmType countPairs,
+   const IntEbmType * featureIndexPairs,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType countTopPairs,
+   IntEbmType * topPairIndexesOut,
+   FloatEbmType * topInteractionScoresOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogCalculateInteractionScoreTopPairsParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "CalculateInteractionScoreTopPairs parameters: ebmInteraction=%p, countPairs=%" IntEbmTypePrintf ", featureIndexPairs=%p, countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf ", countTopPairs=%" IntEbmTypePrintf ", topPairIndexesOut=%p, topInteractionScoresOut=%p",
+      static_cast<void *>(ebmInteraction),
+      countPairs,
+      static_cast<const void *>(featureIndexPairs),
+      countSamplesRequiredForChildSplitMin,
+      countTopPairs,
+      static_cast<void *>(topPairIndexesOut),
+      static_cast<void *>(topInteractionScoresOut)
+   );
+
+   EbmInteractionState * pEbmInteractionState = reinterpret_cast<EbmInteractionState *>(ebmInteraction);
+   if(nullptr == pEbmInteractionState) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs ebmInteraction cannot be nullptr");
+      return 1;
+   }
+
+   LOG_COUNTED_0(pEbmInteractionState->GetPointerCountLogEnterMessages(), TraceLevelInfo, TraceLevelVerbose, "Entered CalculateInteractionScoreTopPairs");
+
+   if(countPairs < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs countPairs must be positive");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countPairs)) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs countPairs too large to index");
+      return 1;
+   }
+   if(countTopPairs < 0) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs countTopPairs must be positive");
+      return 1;
+   }
+   const size_t cPairs = static_cast<size_t>(countPairs);
+   // we return at most one item per pair, so a larger countTopPairs is the same as cPairs
+   const size_t cTopPairs = !IsNumberConvertable<size_t>(countTopPairs) || cPairs < static_cast<size_t>(countTopPairs) ? 
+      cPairs : static_cast<size_t>(countTopPairs);
+   if(0 == cTopPairs) {
+      LOG_0(TraceLevelInfo, "INFO CalculateInteractionScoreTopPairs no pairs");
+      return 0;
+   }
+   if(nullptr == featureIndexPairs) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs featureIndexPairs cannot be nullptr if 0 < countPairs");
+      return 1;
+   }
+   if(nullptr == topPairIndexesOut) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs topPairIndexesOut cannot be nullptr if 0 < countTopPairs");
+      return 1;
+   }
+   if(nullptr == topInteractionScoresOut) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs topInteractionScoresOut cannot be nullptr if 0 < countTopPairs");
+      return 1;
+   }
+   if(IsMultiplyError(cPairs, size_t { 2 })) {
+      LOG_0(TraceLevelError, "ERROR CalculateInteractionScoreTopPairs IsMultiplyError(cPairs, 2)");
+      return 1;
+   }
+
+   size_t cSamplesRequiredForChildSplitMin = size_t { 1 }; // this is the min value
+   if(IntEbmType { 1 } <= countSamplesRequiredForChildSplitMin) {
+      cSamplesRequiredForChildSplitMin = static_cast<size_t>(countSamplesRequiredForChildSplitMin);
+      if(!IsNumberConvertable<size_t>(countSamplesRequiredForChildSplitMin)) {
+         // we can never exceed a size_t number of samples, so let's just set it to the maximum if we were going to overflow because it will generate 
+         // the same results as if we used the true number
+         cSamplesRequiredForChildSplitMin = std::numeric_limits<size_t>::max();
+      }
+   } else {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreTopPairs countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
+   }
+
+   size_t cPairsScanned;
+   if(CountInteractionPairsScanned(pEbmInteractionState, cPairs, featureIndexPairs, &cPairsScanned)) {
+      return 1;
+   }
+
+   FloatEbmType * const aInteractionScores = EbmMalloc<FloatEbmType>(cPairs);
+   if(nullptr == aInteractionScores) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreTopPairs nullptr == aInteractionScores");
+      return 1;
+   }
+   // there can't be more scans than pairs, so aiPairs needs at most cPairsScanned + 1 scan boundaries after the 
+   // pairs.  We re-use it later to rank all of the pairs.  We checked above that cPairs * 2 doesn't overflow
+   const size_t cPairIndexes = cPairs < (cPairsScanned << 1) + 1 ? (cPairsScanned << 1) + 1 : cPairs;
+   size_t * const aiPairs = EbmMalloc<size_t>(cPairIndexes);
+   if(nullptr == aiPairs) {
+      LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreTopPairs nullptr == aiPairs");
+      free(aInteractionScores);
+      return 1;
+   }
+
+   // pairs that we don't scan below have no interaction, just like CalculateInteractionScore returns for them
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      aInteractionScores[iPair] = FloatEbmType { 0 };
+   }
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+   if(0 != pEbmInteractionState->GetDataSetByFeature()->GetCountSamples() && 
+      ptrdiff_t { 0 } != runtimeLearningTypeOrCountTargetClasses && 
+      ptrdiff_t { 1 } != runtimeLearningTypeOrCountTargetClasses &&
+      0 != cPairsScanned
+   ) {
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      if(GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)) {
+         LOG_0(TraceLevelWarning, "WARNING CalculateInteractionScoreTopPairs GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)");
+         free(aiPairs);
+         free(aInteractionScores);
+         return 1;
+      }
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
+
+      FillInteractionPairsScanned(pEbmInteractionState, cPairs, featureIndexPairs, cPairsScanned, aiPairs);
+      // unlike CalculateInteractionScorePairs we don't screen, since the screening scores are no bound on the full 
+      // scores and we promise the same top pairs as scoring every pair
+      if(ScoreInteractionPairs(
+         pEbmInteractionState,
+         pEbmInteractionState->GetDataSetByFeature(),
+         featureIndexPairs,
+         cSamplesRequiredForChildSplitMin,
+         cBytesPerHistogramBucket,
+         cPairsScanned,
+         cTopPairs,
+         aiPairs,
+         aInteractionScores
+      )) {
+         free(aiPairs);
+         free(aInteractionScores);
+         return 1;
+      }
+   }
+
+   size_t cPairsPruned = 0;
+   for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+      aiPairs[iPair] = iPair;
+      cPairsPruned += k_interactionScorePruned == aInteractionScores[iPair] ? size_t { 1 } : size_t { 0 };
+   }
+   LOG_COUNTED_N(
+      &g_cLogCalculateInteractionScoreTopPairsPrunedMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "CalculateInteractionScoreTopPairs skipped the cut sweep of %zu of %zu pairs",
+      cPairsPruned,
+      cPairsScanned
+   );
+
+   // a task only skips pairs once it has found cTopPairs scores above zero, so the skipped pairs sort below at 
+   // least cTopPairs scored pairs
+   std::partial_sort(aiPairs, aiPairs + cTopPairs, aiPairs + cPairs, InteractionPairsScoreGreater(aInteractionScores));
+   for(size_t iTopPair = 0; iTopPair < cTopPairs; ++iTopPair) {
+      const size_t iPair = aiPairs[iTopPair];
+      EBM_ASSERT(k_interactionScorePruned != aInteractionScores[iPair]);
+      topPairIndexesOut[iTopPair] = static_cast<IntEbmType>(iPair);
+      topInteractionScoresOut[iTopPair] = aInteractionScores[iPair];
+   }
+
+   free(aiPairs);
+   free(aInteractionScores);
+
+   LOG_COUNTED_0(pEbmInteractionState->GetPointerCountLogExitMessages(), TraceLevelInfo, TraceLevelVerbose, "Exited CalculateInteractionScoreTopPairs");
+   return 0;
+}
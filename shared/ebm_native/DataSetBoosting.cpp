@@ -11,11 +11,16 @@
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // FeatureType
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
+#include "EbmStatisticUtils.h"
 #include "FeatureAtomic.h"
 #include "FeatureGroup.h"
+#include "PackedData.h"
+#include "PackedDataBuilder.h" // ReadColumnBin
 #include "DataSetBoosting.h"
 
-INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(const size_t cSamples, const size_t cVectorLength) {
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static TFloat * ConstructResidualErrors(const size_t cSamples, const size_t cVectorLength) {
    LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructResidualErrors");
 
    EBM_ASSERT(1 <= cSamples);
@@ -27,13 +32,14 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(const s
    }
 
    const size_t cElements = cSamples * cVectorLength;
-   FloatEbmType * aResidualErrors = EbmMalloc<FloatEbmType>(cElements);
+   TFloat * aResidualErrors = AlignedMalloc<TFloat>(MemorySubsystem::DataSet, cElements);
 
    LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::ConstructResidualErrors");
    return aResidualErrors;
 }
 
-INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructPredictorScores(
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static TFloat * ConstructPredictorScores(
    const size_t cSamples, 
    const size_t cVectorLength, 
    const FloatEbmType * const aPredictorScoresFrom
@@ -50,23 +56,29 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructPredictorScores(
    }
 
    const size_t cElements = cSamples * cVectorLength;
-   FloatEbmType * const aPredictorScoresTo = EbmMalloc<FloatEbmType>(cElements);
+   TFloat * const aPredictorScoresTo = AlignedMalloc<TFloat>(MemorySubsystem::DataSet, cElements);
    if(nullptr == aPredictorScoresTo) {
       LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructPredictorScores nullptr == aPredictorScoresTo");
       return nullptr;
    }
 
-   const size_t cBytes = sizeof(FloatEbmType) * cElements;
    // if there are any NaN or +- infinity values we should just propagate them and exit during boosting
-   memcpy(aPredictorScoresTo, aPredictorScoresFrom, cBytes);
+   if(std::is_same<TFloat, FloatEbmType>::value) {
+      memcpy(aPredictorScoresTo, aPredictorScoresFrom, sizeof(FloatEbmType) * cElements);
+   } else {
+      // scores outside the float range become +-infinity, which we propagate the same way
+      for(size_t iElement = 0; iElement < cElements; ++iElement) {
+         aPredictorScoresTo[iElement] = static_cast<TFloat>(aPredictorScoresFrom[iElement]);
+      }
+   }
    constexpr bool bZeroingLogits = 0 <= k_iZeroClassificationLogitAtInitialize;
    if(bZeroingLogits) {
       // TODO : integrate this subtraction into the copy instead of doing it afterwards
-      FloatEbmType * pScore = aPredictorScoresTo;
-      const FloatEbmType * const pScoreExteriorEnd = pScore + cVectorLength * cSamples;
+      TFloat * pScore = aPredictorScoresTo;
+      const TFloat * const pScoreExteriorEnd = pScore + cVectorLength * cSamples;
       do {
-         FloatEbmType scoreShift = pScore[k_iZeroClassificationLogitAtInitialize];
-         const FloatEbmType * const pScoreInteriorEnd = pScore + cVectorLength;
+         TFloat scoreShift = pScore[k_iZeroClassificationLogitAtInitialize];
+         const TFloat * const pScoreInteriorEnd = pScore + cVectorLength;
          do {
             *pScore -= scoreShift;
             ++pScore;
@@ -90,7 +102,7 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * ConstructTargetData(
    EBM_ASSERT(1 <= runtimeLearningTypeOrCountTargetClasses); // this should be classification
    const size_t countTargetClasses = static_cast<size_t>(runtimeLearningTypeOrCountTargetClasses);
 
-   StorageDataType * const aTargetData = EbmMalloc<StorageDataType>(cSamples);
+   StorageDataType * const aTargetData = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cSamples);
    if(nullptr == aTargetData) {
       LOG_0(TraceLevelWarning, "WARNING nullptr == aTargetData");
       return nullptr;
@@ -103,27 +115,27 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * ConstructTargetData(
       const IntEbmType data = *pTargetFrom;
       if(data < 0) {
          LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructTargetData target value cannot be negative");
-         free(aTargetData);
+         AlignedFree(aTargetData);
          return nullptr;
       }
       if(!IsNumberConvertable<StorageDataType>(data)) {
          // this shouldn't be possible since we previously checked that we could convert our target,
          // so if this is failing then we'll be larger than the maximum number of classes
          LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructTargetData data target too big to reference memory");
-         free(aTargetData);
+         AlignedFree(aTargetData);
          return nullptr;
       }
       if(!IsNumberConvertable<size_t>(data)) {
          // this shouldn't be possible since we previously checked that we could convert our target,
          // so if this is failing then we'll be larger than the maximum number of classes
          LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructTargetData data target too big to reference memory");
-         free(aTargetData);
+         AlignedFree(aTargetData);
          return nullptr;
       }
       const StorageDataType iData = static_cast<StorageDataType>(data);
       if(countTargetClasses <= static_cast<size_t>(iData)) {
          LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructTargetData target value larger than number of classes");
-         free(aTargetData);
+         AlignedFree(aTargetData);
          return nullptr;
       }
       *pTargetTo = iData;
@@ -142,7 +154,9 @@ struct InputDataPointerAndCountBins {
    void * operator new(std::size_t) = delete; // we only use malloc/free in this library
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
-   const IntEbmType * m_pInputData;
+   const char * m_pInputData;
+   size_t m_cBytesStride;
+   size_t m_cBytesPerBin;
    size_t m_cBins;
 };
 static_assert(std::is_standard_layout<InputDataPointerAndCountBins>::value,
@@ -156,7 +170,8 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
    const size_t cFeatureGroups, 
    const FeatureGroup * const * const apFeatureGroup, 
    const size_t cSamples, 
-   const IntEbmType * const aInputDataFrom
+   const IntEbmType * const aInputDataFrom,
+   const EbmNativeBinnedColumn * const aColumnsFrom
 ) {
    LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructInputData");
 
@@ -193,7 +208,7 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
          EBM_ASSERT(0 < cSamples);
          const size_t cDataUnits = (cSamples - 1) / cItemsPerBitPackedDataUnit + 1; // this can't overflow or underflow
 
-         StorageDataType * pInputDataTo = EbmMalloc<StorageDataType>(cDataUnits);
+         StorageDataType * pInputDataTo = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cDataUnits);
          if(nullptr == pInputDataTo) {
             LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructInputData nullptr == pInputDataTo");
             goto free_all;
@@ -207,7 +222,7 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
             reinterpret_cast<const StorageDataType *>(reinterpret_cast<const char *>(pInputDataTo) + cBytesData) - 1;
          EBM_ASSERT(pInputDataTo <= pInputDataToLast); // we have 1 item or more, and therefore the last one can't be before the first item
 
-         EBM_ASSERT(nullptr != aInputDataFrom);
+         EBM_ASSERT(nullptr != aInputDataFrom || nullptr != aColumnsFrom);
 
          const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
          InputDataPointerAndCountBins dimensionInfo[k_cDimensionsMax];
@@ -216,7 +231,18 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
          const InputDataPointerAndCountBins * const pDimensionInfoEnd = &dimensionInfo[cFeatures];
          do {
             const Feature * const pFeature = pFeatureGroupEntry->m_pFeature;
-            pDimensionInfo->m_pInputData = &aInputDataFrom[pFeature->GetIndexFeatureData() * cSamples];
+            if(nullptr != aColumnsFrom) {
+               // our caller checked the columns, so the byte counts are valid
+               const EbmNativeBinnedColumn * const pColumn = &aColumnsFrom[pFeature->GetIndexFeatureData()];
+               pDimensionInfo->m_pInputData = static_cast<const char *>(pColumn->data);
+               pDimensionInfo->m_cBytesStride = static_cast<size_t>(pColumn->countBytesStride);
+               pDimensionInfo->m_cBytesPerBin = static_cast<size_t>(pColumn->countBytesPerBin);
+            } else {
+               pDimensionInfo->m_pInputData = 
+                  reinterpret_cast<const char *>(&aInputDataFrom[pFeature->GetIndexFeatureData() * cSamples]);
+               pDimensionInfo->m_cBytesStride = sizeof(IntEbmType);
+               pDimensionInfo->m_cBytesPerBin = sizeof(IntEbmType);
+            }
             pDimensionInfo->m_cBins = pFeature->GetCountBins();
             ++pFeatureGroupEntry;
             ++pDimensionInfo;
@@ -239,18 +265,15 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
                size_t tensorIndex = 0;
                pDimensionInfo = &dimensionInfo[0];
                do {
-                  const IntEbmType * pInputData = pDimensionInfo->m_pInputData;
-                  const IntEbmType inputData = *pInputData;
-                  pDimensionInfo->m_pInputData = pInputData + 1;
-                  if(inputData < 0) {
-                     LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructInputData inputData value cannot be negative");
-                     goto free_all;
-                  }
-                  if(!IsNumberConvertable<size_t>(inputData)) {
-                     LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructInputData inputData value too big to reference memory");
+                  const char * const pInputData = pDimensionInfo->m_pInputData;
+                  pDimensionInfo->m_pInputData = pInputData + pDimensionInfo->m_cBytesStride;
+                  size_t iData;
+                  // the branch on the bin width inside ReadColumnBin is the same for every sample of a column, so 
+                  // it predicts well
+                  if(ReadColumnBin(pInputData, pDimensionInfo->m_cBytesPerBin, &iData)) {
+                     LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructInputData inputData value cannot be negative or too big to reference memory");
                      goto free_all;
                   }
-                  const size_t iData = static_cast<size_t>(inputData);
 
                   if(pDimensionInfo->m_cBins <= iData) {
                      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructInputData iData value must be less than the number of bins");
@@ -293,25 +316,153 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
 free_all:
    while(aaInputDataTo != paInputDataTo) {
       --paInputDataTo;
-      free(*paInputDataTo);
+      AlignedFree(*paInputDataTo);
    }
    free(aaInputDataTo);
    return nullptr;
 }
 
+INLINE_RELEASE_UNTEMPLATED static size_t * ConstructSampleMaskBits(
+   const size_t cSamples,
+   const IntEbmType * const aSampleMask,
+   size_t * const pcSamplesIncludedOut
+) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructSampleMaskBits");
+
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(nullptr != aSampleMask);
+
+   // cSamples is at least 1, and this can't overflow since the division happens first
+   const size_t cSampleMaskUnits = (cSamples - 1) / k_cBitsForSizeT + 1;
+   size_t * const aSampleMaskBits = EbmMalloc<size_t>(cSampleMaskUnits);
+   if(nullptr == aSampleMaskBits) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructSampleMaskBits nullptr == aSampleMaskBits");
+      return nullptr;
+   }
+   for(size_t iSampleMaskUnit = 0; iSampleMaskUnit < cSampleMaskUnits; ++iSampleMaskUnit) {
+      aSampleMaskBits[iSampleMaskUnit] = 0;
+   }
+   size_t cSamplesIncluded = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      if(0 != aSampleMask[iSample]) {
+         aSampleMaskBits[iSample / k_cBitsForSizeT] |= size_t { 1 } << (iSample % k_cBitsForSizeT);
+         ++cSamplesIncluded;
+      }
+   }
+   if(0 == cSamplesIncluded) {
+      // a data set with samples that are all masked out would make us divide by zero in our metrics
+      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructSampleMaskBits the mask needs to include at least one sample");
+      free(aSampleMaskBits);
+      return nullptr;
+   }
+
+   *pcSamplesIncludedOut = cSamplesIncluded;
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::ConstructSampleMaskBits");
+   return aSampleMaskBits;
+}
+
+INLINE_RELEASE_UNTEMPLATED static size_t * ConstructWeights(
+   const size_t cSamples,
+   const IntEbmType * const aWeights,
+   const size_t * const aSampleMaskBits,
+   size_t * const pcWeightTotalOut
+) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructWeights");
+
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(nullptr != aWeights);
+
+   size_t * const aWeightsTo = EbmMalloc<size_t>(cSamples);
+   if(nullptr == aWeightsTo) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructWeights nullptr == aWeightsTo");
+      return nullptr;
+   }
+   size_t cWeightTotal = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const IntEbmType weight = aWeights[iSample];
+      EBM_ASSERT(0 <= weight); // AllocateBoosting checked this
+      if(!IsNumberConvertable<size_t>(weight)) {
+         LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructWeights weight is too large");
+         free(aWeightsTo);
+         return nullptr;
+      }
+      size_t cWeight = static_cast<size_t>(weight);
+      // samples outside of our mask belong to other boosters, so we give them no weight in our bags
+      if(nullptr != aSampleMaskBits && 0 == ((aSampleMaskBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 })) {
+         cWeight = 0;
+      }
+      if(IsAddError(cWeightTotal, cWeight)) {
+         LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructWeights the sum of the weights is too large");
+         free(aWeightsTo);
+         return nullptr;
+      }
+      cWeightTotal += cWeight;
+      aWeightsTo[iSample] = cWeight;
+   }
+   if(0 == cWeightTotal) {
+      // we'd divide by zero in our metrics and have nothing to draw our bags from
+      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructWeights at least one sample needs a non-zero weight");
+      free(aWeightsTo);
+      return nullptr;
+   }
+
+   *pcWeightTotalOut = cWeightTotal;
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::ConstructWeights");
+   return aWeightsTo;
+}
+
+INLINE_RELEASE_UNTEMPLATED static StorageDataType * * MapInputData(
+   const size_t cFeatureGroups, 
+   const FeatureGroup * const * const apFeatureGroup, 
+   const size_t cSamples, 
+   const PackedData * const pPackedData
+) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::MapInputData");
+
+   EBM_ASSERT(0 < cFeatureGroups);
+   EBM_ASSERT(nullptr != apFeatureGroup);
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(nullptr != pPackedData);
+
+   if(pPackedData->IsMismatched(cFeatureGroups, apFeatureGroup, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::MapInputData pPackedData->IsMismatched");
+      return nullptr;
+   }
+
+   StorageDataType ** const aaInputDataTo = EbmMalloc<StorageDataType *>(cFeatureGroups);
+   if(nullptr == aaInputDataTo) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::MapInputData nullptr == aaInputDataTo");
+      return nullptr;
+   }
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      // the mapping is read-only, but we only ever read our input data after constructing it
+      aaInputDataTo[iFeatureGroup] = const_cast<StorageDataType *>(pPackedData->GetInputData(iFeatureGroup));
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::MapInputData");
+   return aaInputDataTo;
+}
+
 bool DataSetByFeatureGroup::Initialize(
    const bool bAllocateResidualErrors, 
+   const bool bAllocateDenominators, 
    const bool bAllocatePredictorScores, 
    const bool bAllocateTargetData, 
+   const bool bFloat32, 
    const size_t cFeatureGroups, 
    const FeatureGroup * const * const apFeatureGroup, 
    const size_t cSamples, 
    const IntEbmType * const aInputDataFrom, 
+   const EbmNativeBinnedColumn * const aColumnsFrom, 
    const void * const aTargets, 
    const FloatEbmType * const aPredictorScoresFrom, 
-   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   PackedData * const pPackedData,
+   const IntEbmType * const aSampleMask,
+   const IntEbmType * const aWeights
 ) {
    EBM_ASSERT(nullptr == m_aResidualErrors);
+   EBM_ASSERT(nullptr == m_aDenominators);
    EBM_ASSERT(nullptr == m_aPredictorScores);
    EBM_ASSERT(nullptr == m_aTargetData);
    EBM_ASSERT(nullptr == m_aaInputData);
@@ -320,19 +471,34 @@ bool DataSetByFeatureGroup::Initialize(
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
 
    if(0 != cSamples) {
-      FloatEbmType * aResidualErrors = nullptr;
+      void * aResidualErrors = nullptr;
       if(bAllocateResidualErrors) {
-         aResidualErrors = ConstructResidualErrors(cSamples, cVectorLength);
+         aResidualErrors = bFloat32 ? static_cast<void *>(ConstructResidualErrors<float>(cSamples, cVectorLength)) :
+            static_cast<void *>(ConstructResidualErrors<FloatEbmType>(cSamples, cVectorLength));
          if(nullptr == aResidualErrors) {
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aResidualErrors");
             return true;
          }
       }
-      FloatEbmType * aPredictorScores = nullptr;
+      void * aDenominators = nullptr;
+      if(bAllocateDenominators) {
+         // the denominators have the same shape and type as the residuals
+         aDenominators = bFloat32 ? static_cast<void *>(ConstructResidualErrors<float>(cSamples, cVectorLength)) :
+            static_cast<void *>(ConstructResidualErrors<FloatEbmType>(cSamples, cVectorLength));
+         if(nullptr == aDenominators) {
+            AlignedFree(aResidualErrors);
+            LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aDenominators");
+            return true;
+         }
+      }
+      void * aPredictorScores = nullptr;
       if(bAllocatePredictorScores) {
-         aPredictorScores = ConstructPredictorScores(cSamples, cVectorLength, aPredictorScoresFrom);
+         aPredictorScores = bFloat32 ? 
+            static_cast<void *>(ConstructPredictorScores<float>(cSamples, cVectorLength, aPredictorScoresFrom)) :
+            static_cast<void *>(ConstructPredictorScores<FloatEbmType>(cSamples, cVectorLength, aPredictorScoresFrom));
          if(nullptr == aPredictorScores) {
-            free(aResidualErrors);
+            AlignedFree(aResidualErrors);
+            AlignedFree(aDenominators);
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aPredictorScores");
             return true;
          }
@@ -341,30 +507,85 @@ bool DataSetByFeatureGroup::Initialize(
       if(bAllocateTargetData) {
          aTargetData = ConstructTargetData(cSamples, static_cast<const IntEbmType *>(aTargets), runtimeLearningTypeOrCountTargetClasses);
          if(nullptr == aTargetData) {
-            free(aResidualErrors);
-            free(aPredictorScores);
+            AlignedFree(aResidualErrors);
+            AlignedFree(aDenominators);
+            AlignedFree(aPredictorScores);
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aTargetData");
             return true;
          }
       }
       StorageDataType ** aaInputData = nullptr;
       if(0 != cFeatureGroups) {
-         aaInputData = ConstructInputData(cFeatureGroups, apFeatureGroup, cSamples, aInputDataFrom);
+         if(nullptr != pPackedData) {
+            aaInputData = MapInputData(cFeatureGroups, apFeatureGroup, cSamples, pPackedData);
+         } else {
+            aaInputData = ConstructInputData(cFeatureGroups, apFeatureGroup, cSamples, aInputDataFrom, aColumnsFrom);
+         }
          if(nullptr == aaInputData) {
-            free(aResidualErrors);
-            free(aPredictorScores);
-            free(aTargetData);
+            AlignedFree(aResidualErrors);
+            AlignedFree(aDenominators);
+            AlignedFree(aPredictorScores);
+            AlignedFree(aTargetData);
             LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aaInputData");
             return true;
          }
       }
+      size_t * aSampleMaskBits = nullptr;
+      size_t cSamplesIncluded = cSamples;
+      if(nullptr != aSampleMask) {
+         aSampleMaskBits = ConstructSampleMaskBits(cSamples, aSampleMask, &cSamplesIncluded);
+         if(nullptr == aSampleMaskBits) {
+            AlignedFree(aResidualErrors);
+            AlignedFree(aDenominators);
+            AlignedFree(aPredictorScores);
+            AlignedFree(aTargetData);
+            if(nullptr != aaInputData && nullptr == pPackedData) {
+               for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+                  AlignedFree(aaInputData[iFeatureGroup]);
+               }
+            }
+            free(aaInputData);
+            LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aSampleMaskBits");
+            return true;
+         }
+      }
+      size_t * aWeightsTo = nullptr;
+      size_t cWeightTotal = cSamplesIncluded;
+      if(nullptr != aWeights) {
+         aWeightsTo = ConstructWeights(cSamples, aWeights, aSampleMaskBits, &cWeightTotal);
+         if(nullptr == aWeightsTo) {
+            AlignedFree(aResidualErrors);
+            AlignedFree(aDenominators);
+            AlignedFree(aPredictorScores);
+            AlignedFree(aTargetData);
+            if(nullptr != aaInputData && nullptr == pPackedData) {
+               for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+                  AlignedFree(aaInputData[iFeatureGroup]);
+               }
+            }
+            free(aaInputData);
+            free(aSampleMaskBits);
+            LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeatureGroup::Initialize nullptr == aWeightsTo");
+            return true;
+         }
+      }
 
       m_aResidualErrors = aResidualErrors;
+      m_aDenominators = aDenominators;
       m_aPredictorScores = aPredictorScores;
       m_aTargetData = aTargetData;
       m_aaInputData = aaInputData;
       m_cSamples = cSamples;
       m_cFeatureGroups = cFeatureGroups;
+      m_aSampleMaskBits = aSampleMaskBits;
+      m_cSamplesIncluded = cSamplesIncluded;
+      m_aWeights = aWeightsTo;
+      m_cWeightTotal = cWeightTotal;
+      m_bFloat32 = bFloat32;
+      if(nullptr != pPackedData) {
+         pPackedData->AddReference();
+         m_pPackedData = pPackedData;
+      }
    }
 
    LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::Initialize");
@@ -372,25 +593,461 @@ bool DataSetByFeatureGroup::Initialize(
    return false;
 }
 
+bool DataSetByFeatureGroup::Save(const char * const filePath, const FeatureGroup * const * const apFeatureGroup) const {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::Save");
+
+   if(0 == m_cSamples) {
+      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::Save there are no samples to save");
+      return true;
+   }
+   if(PackedData::Write(filePath, m_cFeatureGroups, apFeatureGroup, m_cSamples, m_aaInputData)) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::Save PackedData::Write");
+      return true;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::Save");
+   return false;
+}
+
+PackedData * DataSetByFeatureGroup::CreatePackedData(const FeatureGroup * const * const apFeatureGroup) const {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::CreatePackedData");
+
+   if(0 == m_cSamples) {
+      LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::CreatePackedData there are no samples to pack");
+      return nullptr;
+   }
+   PackedData * const pPackedData = PackedData::Create(m_cFeatureGroups, apFeatureGroup, m_cSamples, m_aaInputData);
+   if(nullptr == pPackedData) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::CreatePackedData nullptr == pPackedData");
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::CreatePackedData");
+   return pPackedData;
+}
+
+template<typename TFloat>
+void DataSetByFeatureGroup::UpdateDenominatorsInternal(const size_t cVectorLength) {
+   EBM_ASSERT(nullptr != m_aDenominators);
+   EBM_ASSERT(nullptr != m_aResidualErrors);
+   EBM_ASSERT(0 < m_cSamples); // we don't allocate denominators if there are no samples
+   EBM_ASSERT(!IsMultiplyError(m_cSamples, cVectorLength)); // we allocated this memory already
+
+   const TFloat * pResidualError = GetResidualPointer<TFloat>();
+   const TFloat * const pResidualErrorEnd = pResidualError + m_cSamples * cVectorLength;
+   TFloat * pDenominator = static_cast<TFloat *>(m_aDenominators);
+   do {
+      *pDenominator = static_cast<TFloat>(EbmStatistics::ComputeNewtonRaphsonStep(*pResidualError));
+      ++pDenominator;
+      ++pResidualError;
+   } while(pResidualErrorEnd != pResidualError);
+}
+
+void DataSetByFeatureGroup::UpdateDenominators(const size_t cVectorLength) {
+   LOG_0(TraceLevelVerbose, "Entered DataSetByFeatureGroup::UpdateDenominators");
+
+   if(m_bFloat32) {
+      UpdateDenominatorsInternal<float>(cVectorLength);
+   } else {
+      UpdateDenominatorsInternal<FloatEbmType>(cVectorLength);
+   }
+
+   LOG_0(TraceLevelVerbose, "Exited DataSetByFeatureGroup::UpdateDenominators");
+}
+
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static TFloat * TransposeSamplesToClasses(
+   const size_t cSamples,
+   const size_t cVectorLength,
+   const TFloat * const aSampleMajor
+) {
+   EBM_ASSERT(!IsMultiplyError(cSamples, cVectorLength)); // we allocated this memory already
+   TFloat * const aClassMajor = AlignedMalloc<TFloat>(MemorySubsystem::DataSet, cSamples * cVectorLength);
+   if(nullptr != aClassMajor) {
+      const TFloat * pSampleMajor = aSampleMajor;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         TFloat * pClassMajor = aClassMajor + iSample;
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            *pClassMajor = *pSampleMajor;
+            pClassMajor += cSamples;
+            ++pSampleMajor;
+         }
+      }
+   }
+   return aClassMajor;
+}
+
+template<typename TFloat>
+bool DataSetByFeatureGroup::TransposeToClassMajorInternal(const size_t cVectorLength) {
+   EBM_ASSERT(nullptr != m_aResidualErrors);
+   EBM_ASSERT(nullptr != m_aPredictorScores);
+
+   if(IsAddError(cVectorLength, size_t { 1 }) || IsMultiplyError(k_cSamplesClassMajorBlock, cVectorLength + 1)) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::TransposeToClassMajor IsMultiplyError(k_cSamplesClassMajorBlock, cVectorLength + 1)");
+      return true;
+   }
+   size_t * const aTensorBins = EbmMalloc<size_t>(k_cSamplesClassMajorBlock);
+   FloatEbmType * const aExps = EbmMalloc<FloatEbmType>(k_cSamplesClassMajorBlock * (cVectorLength + 1));
+   TFloat * const aResidualErrors = TransposeSamplesToClasses(m_cSamples, cVectorLength, GetResidualPointer<TFloat>());
+   TFloat * const aPredictorScores = TransposeSamplesToClasses(m_cSamples, cVectorLength, GetPredictorScores<TFloat>());
+   if(nullptr == aTensorBins || nullptr == aExps || nullptr == aResidualErrors || nullptr == aPredictorScores) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::TransposeToClassMajor out of memory");
+      free(aTensorBins);
+      free(aExps);
+      AlignedFree(aResidualErrors);
+      AlignedFree(aPredictorScores);
+      return true;
+   }
+   AlignedFree(m_aResidualErrors);
+   m_aResidualErrors = aResidualErrors;
+   AlignedFree(m_aPredictorScores);
+   m_aPredictorScores = aPredictorScores;
+   m_aClassMajorTensorBins = aTensorBins;
+   m_aClassMajorExps = aExps;
+   m_bClassMajor = true;
+   return false;
+}
+
+bool DataSetByFeatureGroup::TransposeToClassMajor(const size_t cVectorLength) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::TransposeToClassMajor");
+
+   EBM_ASSERT(!m_bClassMajor);
+   EBM_ASSERT(2 <= cVectorLength);
+   EBM_ASSERT(0 < m_cSamples);
+
+   const bool bError = m_bFloat32 ? 
+      TransposeToClassMajorInternal<float>(cVectorLength) : TransposeToClassMajorInternal<FloatEbmType>(cVectorLength);
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::TransposeToClassMajor");
+   return bError;
+}
+
+// copies cSamplesFirst samples of aFirst, which is class-major if bClassMajor, followed by the sample-major 
+// cSamplesSecond samples of aSecond into a new array with the layout of aFirst.  Returns nullptr on error
+template<typename TFloat>
+INLINE_RELEASE_TEMPLATED static TFloat * ConcatenateSamples(
+   const size_t cSamplesFirst,
+   const TFloat * const aFirst,
+   const size_t cSamplesSecond,
+   const TFloat * const aSecond,
+   const size_t cVectorLength,
+   const bool bClassMajor
+) {
+   const size_t cSamples = cSamplesFirst + cSamplesSecond;
+   EBM_ASSERT(!IsMultiplyError(cSamples, cVectorLength)); // our caller checked this
+   TFloat * const aTo = AlignedMalloc<TFloat>(MemorySubsystem::DataSet, cSamples * cVectorLength);
+   if(nullptr != aTo) {
+      if(bClassMajor) {
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            TFloat * const aClassTo = aTo + iVector * cSamples;
+            memcpy(aClassTo, aFirst + iVector * cSamplesFirst, sizeof(TFloat) * cSamplesFirst);
+            for(size_t iSample = 0; iSample < cSamplesSecond; ++iSample) {
+               aClassTo[cSamplesFirst + iSample] = aSecond[iSample * cVectorLength + iVector];
+            }
+         }
+      } else {
+         memcpy(aTo, aFirst, sizeof(TFloat) * cSamplesFirst * cVectorLength);
+         memcpy(aTo + cSamplesFirst * cVectorLength, aSecond, sizeof(TFloat) * cSamplesSecond * cVectorLength);
+      }
+   }
+   return aTo;
+}
+
+template<typename TFloat>
+bool DataSetByFeatureGroup::ConcatenateValues(
+   const DataSetByFeatureGroup * const pDataSetFirst,
+   const DataSetByFeatureGroup * const pDataSetSecond,
+   const size_t cVectorLength
+) {
+   m_aResidualErrors = ConcatenateSamples(
+      pDataSetFirst->m_cSamples, 
+      pDataSetFirst->GetResidualPointer<TFloat>(), 
+      pDataSetSecond->m_cSamples, 
+      pDataSetSecond->GetResidualPointer<TFloat>(), 
+      cVectorLength, 
+      m_bClassMajor
+   );
+   if(nullptr == m_aResidualErrors) {
+      return true;
+   }
+   if(nullptr != pDataSetFirst->m_aPredictorScores) {
+      m_aPredictorScores = ConcatenateSamples(
+         pDataSetFirst->m_cSamples, 
+         static_cast<const TFloat *>(pDataSetFirst->m_aPredictorScores), 
+         pDataSetSecond->m_cSamples, 
+         static_cast<const TFloat *>(pDataSetSecond->m_aPredictorScores), 
+         cVectorLength, 
+         m_bClassMajor
+      );
+      if(nullptr == m_aPredictorScores) {
+         return true;
+      }
+   }
+   if(nullptr != pDataSetFirst->m_aDenominators) {
+      // UpdateDenominators fills these in from the concatenated residuals
+      m_aDenominators = AlignedMalloc<TFloat>(MemorySubsystem::DataSet, m_cSamples * cVectorLength);
+      if(nullptr == m_aDenominators) {
+         return true;
+      }
+   }
+   return false;
+}
+
+bool DataSetByFeatureGroup::InitializeConcatenated(
+   const DataSetByFeatureGroup * const pDataSetFirst,
+   const DataSetByFeatureGroup * const pDataSetSecond,
+   const FeatureGroup * const * const apFeatureGroup,
+   const size_t cVectorLength
+) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::InitializeConcatenated");
+
+   EBM_ASSERT(nullptr == m_aResidualErrors);
+   EBM_ASSERT(nullptr == m_aaInputData);
+   EBM_ASSERT(0 < pDataSetFirst->m_cSamples);
+   EBM_ASSERT(0 < pDataSetSecond->m_cSamples);
+   EBM_ASSERT(pDataSetFirst->m_cFeatureGroups == pDataSetSecond->m_cFeatureGroups);
+   EBM_ASSERT(pDataSetFirst->m_bFloat32 == pDataSetSecond->m_bFloat32);
+   EBM_ASSERT((nullptr == pDataSetFirst->m_aPredictorScores) == (nullptr == pDataSetSecond->m_aPredictorScores));
+   EBM_ASSERT((nullptr == pDataSetFirst->m_aTargetData) == (nullptr == pDataSetSecond->m_aTargetData));
+   EBM_ASSERT(nullptr == pDataSetFirst->m_pPackedData && nullptr == pDataSetSecond->m_pPackedData);
+   EBM_ASSERT(nullptr == pDataSetFirst->m_aSampleMaskBits && nullptr == pDataSetSecond->m_aSampleMaskBits);
+   EBM_ASSERT(nullptr == pDataSetFirst->m_aWeights && nullptr == pDataSetSecond->m_aWeights);
+   EBM_ASSERT(!pDataSetSecond->m_bClassMajor);
+   EBM_ASSERT(nullptr == pDataSetSecond->m_aDenominators);
+
+   const size_t cSamplesFirst = pDataSetFirst->m_cSamples;
+   const size_t cSamplesSecond = pDataSetSecond->m_cSamples;
+   if(IsAddError(cSamplesFirst, cSamplesSecond) || IsMultiplyError(cSamplesFirst + cSamplesSecond, cVectorLength)) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated too many samples to fit into memory");
+      return true;
+   }
+   const size_t cSamples = cSamplesFirst + cSamplesSecond;
+   const size_t cFeatureGroups = pDataSetFirst->m_cFeatureGroups;
+
+   // Destruct frees whatever we allocate here if we exit early
+   m_cSamples = cSamples;
+   m_cFeatureGroups = cFeatureGroups;
+   m_cSamplesIncluded = cSamples;
+   m_cWeightTotal = cSamples;
+   m_bFloat32 = pDataSetFirst->m_bFloat32;
+   m_bClassMajor = pDataSetFirst->m_bClassMajor;
+
+   const bool bValuesError = m_bFloat32 ? ConcatenateValues<float>(pDataSetFirst, pDataSetSecond, cVectorLength) :
+      ConcatenateValues<FloatEbmType>(pDataSetFirst, pDataSetSecond, cVectorLength);
+   if(bValuesError) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated ConcatenateValues");
+      return true;
+   }
+
+   if(nullptr != pDataSetFirst->m_aTargetData) {
+      m_aTargetData = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cSamples);
+      if(nullptr == m_aTargetData) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated nullptr == m_aTargetData");
+         return true;
+      }
+      memcpy(m_aTargetData, pDataSetFirst->m_aTargetData, sizeof(StorageDataType) * cSamplesFirst);
+      memcpy(m_aTargetData + cSamplesFirst, pDataSetSecond->m_aTargetData, sizeof(StorageDataType) * cSamplesSecond);
+   }
+
+   if(0 != cFeatureGroups) {
+      m_aaInputData = EbmMalloc<StorageDataType *>(cFeatureGroups);
+      if(nullptr == m_aaInputData) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated nullptr == m_aaInputData");
+         return true;
+      }
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         m_aaInputData[iFeatureGroup] = nullptr;
+      }
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+         if(0 == pFeatureGroup->GetCountFeatures()) {
+            continue;
+         }
+         const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+         EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+         const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+         EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+         const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+         const size_t cDataUnitsFirst = (cSamplesFirst - 1) / cItemsPerBitPackedDataUnit + 1;
+         const size_t cDataUnits = (cSamples - 1) / cItemsPerBitPackedDataUnit + 1;
+         StorageDataType * const aInputDataTo = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cDataUnits);
+         if(nullptr == aInputDataTo) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated nullptr == aInputDataTo");
+            return true;
+         }
+         m_aaInputData[iFeatureGroup] = aInputDataTo;
+
+         // ConstructInputData leaves the unused items of the last data unit as zeros, so the samples of 
+         // pDataSetSecond can be ORed into the room after our first samples
+         memcpy(aInputDataTo, pDataSetFirst->m_aaInputData[iFeatureGroup], sizeof(StorageDataType) * cDataUnitsFirst);
+         for(size_t iDataUnit = cDataUnitsFirst; iDataUnit < cDataUnits; ++iDataUnit) {
+            aInputDataTo[iDataUnit] = 0;
+         }
+         const StorageDataType * const aInputDataSecond = pDataSetSecond->m_aaInputData[iFeatureGroup];
+         for(size_t iSample = 0; iSample < cSamplesSecond; ++iSample) {
+            const size_t iTensor = maskBits & static_cast<size_t>(aInputDataSecond[iSample / cItemsPerBitPackedDataUnit] >> 
+               (iSample % cItemsPerBitPackedDataUnit * cBitsPerItemMax));
+            const size_t iSampleTo = cSamplesFirst + iSample;
+            aInputDataTo[iSampleTo / cItemsPerBitPackedDataUnit] |= 
+               static_cast<StorageDataType>(iTensor) << (iSampleTo % cItemsPerBitPackedDataUnit * cBitsPerItemMax);
+         }
+      }
+   }
+
+   if(m_bClassMajor) {
+      // the scratch space doesn't depend on the number of samples, and pDataSetFirst allocated it without overflowing
+      m_aClassMajorTensorBins = EbmMalloc<size_t>(k_cSamplesClassMajorBlock);
+      m_aClassMajorExps = EbmMalloc<FloatEbmType>(k_cSamplesClassMajorBlock * (cVectorLength + 1));
+      if(nullptr == m_aClassMajorTensorBins || nullptr == m_aClassMajorExps) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated out of memory");
+         return true;
+      }
+   }
+   if(nullptr != m_aDenominators) {
+      UpdateDenominators(cVectorLength);
+   }
+   if(nullptr != pDataSetFirst->m_aaSampleIndexes) {
+      if(ConstructSampleIndexes(cFeatureGroups, apFeatureGroup, pDataSetFirst->m_cSampleIndexBinsMax)) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::InitializeConcatenated ConstructSampleIndexes");
+         return true;
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::InitializeConcatenated");
+   return false;
+}
+
+bool DataSetByFeatureGroup::ConstructSampleIndexes(
+   const size_t cFeatureGroups, 
+   const FeatureGroup * const * const apFeatureGroup, 
+   const size_t cBinsMax
+) {
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::ConstructSampleIndexes");
+
+   EBM_ASSERT(nullptr == m_aaSampleIndexes);
+   EBM_ASSERT(cFeatureGroups == m_cFeatureGroups);
+   EBM_ASSERT(0 < m_cSamples);
+
+   m_cSampleIndexBinsMax = cBinsMax;
+
+   if(0 != cFeatureGroups) {
+      size_t * * const aaSampleIndexes = EbmMalloc<size_t *>(cFeatureGroups);
+      if(nullptr == aaSampleIndexes) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructSampleIndexes nullptr == aaSampleIndexes");
+         return true;
+      }
+      for(size_t iInputData = 0; iInputData < cFeatureGroups; ++iInputData) {
+         aaSampleIndexes[iInputData] = nullptr;
+      }
+      // Destruct frees whatever we've built if we exit early
+      m_aaSampleIndexes = aaSampleIndexes;
+
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+         if(1 != pFeatureGroup->GetCountFeatures()) {
+            continue;
+         }
+         const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
+         if(cBinsMax < cBins) {
+            continue;
+         }
+         // cBins is small, and m_cSamples items already fit into memory as packed data, so this only overflows if 
+         // we could never allocate it anyways
+         if(IsAddError(cBins + 1, m_cSamples)) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructSampleIndexes IsAddError(cBins + 1, m_cSamples)");
+            return true;
+         }
+         size_t * const aOffsets = EbmMalloc<size_t>(cBins + 1 + m_cSamples);
+         if(nullptr == aOffsets) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeatureGroup::ConstructSampleIndexes nullptr == aOffsets");
+            return true;
+         }
+         aaSampleIndexes[pFeatureGroup->GetIndexInputData()] = aOffsets;
+         size_t * const aSamples = aOffsets + cBins + 1;
+
+         const StorageDataType * const aInputData = GetInputDataPointer(pFeatureGroup);
+         const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+         EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+         const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+         EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+         const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+         // count the samples of bin iBin into aOffsets[iBin + 1] so that the running sum leaves the start of each 
+         // bin in aOffsets[iBin]
+         for(size_t iBin = 0; iBin <= cBins; ++iBin) {
+            aOffsets[iBin] = 0;
+         }
+         for(size_t iSample = 0; iSample < m_cSamples; ++iSample) {
+            const size_t iBin = maskBits & static_cast<size_t>(aInputData[iSample / cItemsPerBitPackedDataUnit] >> 
+               (iSample % cItemsPerBitPackedDataUnit * cBitsPerItemMax));
+            // packed data can come from a file, so we don't trust it to reference memory
+            if(cBins <= iBin) {
+               LOG_0(TraceLevelError, "ERROR DataSetByFeatureGroup::ConstructSampleIndexes the packed data has a bin outside of its feature");
+               return true;
+            }
+            ++aOffsets[iBin + 1];
+         }
+         for(size_t iBin = 1; iBin <= cBins; ++iBin) {
+            aOffsets[iBin] += aOffsets[iBin - 1];
+         }
+         EBM_ASSERT(m_cSamples == aOffsets[cBins]);
+
+         // we visit the samples in order, so they ascend within each bin.  Each insertion moves the start of its bin 
+         // up, which leaves aOffsets[iBin] at the start of bin iBin + 1 when we're done
+         for(size_t iSample = 0; iSample < m_cSamples; ++iSample) {
+            const size_t iBin = maskBits & static_cast<size_t>(aInputData[iSample / cItemsPerBitPackedDataUnit] >> 
+               (iSample % cItemsPerBitPackedDataUnit * cBitsPerItemMax));
+            aSamples[aOffsets[iBin]] = iSample;
+            ++aOffsets[iBin];
+         }
+         for(size_t iBin = cBins; 0 != iBin; --iBin) {
+            aOffsets[iBin] = aOffsets[iBin - 1];
+         }
+         aOffsets[0] = 0;
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::ConstructSampleIndexes");
+   return false;
+}
+
 WARNING_PUSH
 WARNING_DISABLE_USING_UNINITIALIZED_MEMORY
 void DataSetByFeatureGroup::Destruct() {
    LOG_0(TraceLevelInfo, "Entered DataSetByFeatureGroup::Destruct");
 
-   free(m_aResidualErrors);
-   free(m_aPredictorScores);
-   free(m_aTargetData);
+   AlignedFree(m_aResidualErrors);
+   AlignedFree(m_aDenominators);
+   AlignedFree(m_aPredictorScores);
+   AlignedFree(m_aTargetData);
+   free(m_aSampleMaskBits);
+   free(m_aWeights);
+   free(m_aClassMajorTensorBins);
+   free(m_aClassMajorExps);
+
+   if(nullptr != m_aaSampleIndexes) {
+      EBM_ASSERT(0 < m_cFeatureGroups);
+      for(size_t iInputData = 0; iInputData < m_cFeatureGroups; ++iInputData) {
+         free(m_aaSampleIndexes[iInputData]);
+      }
+      free(m_aaSampleIndexes);
+   }
 
    if(nullptr != m_aaInputData) {
       EBM_ASSERT(0 < m_cFeatureGroups);
-      StorageDataType * * paInputData = m_aaInputData;
-      const StorageDataType * const * const paInputDataEnd = m_aaInputData + m_cFeatureGroups;
-      do {
-         free(*paInputData);
-         ++paInputData;
-      } while(paInputDataEnd != paInputData);
+      if(nullptr == m_pPackedData) {
+         StorageDataType * * paInputData = m_aaInputData;
+         const StorageDataType * const * const paInputDataEnd = m_aaInputData + m_cFeatureGroups;
+         do {
+            AlignedFree(*paInputData);
+            ++paInputData;
+         } while(paInputDataEnd != paInputData);
+      }
       free(m_aaInputData);
    }
+   // we might be the last owner, in which case this frees the packed data
+   PackedData::Close(m_pPackedData);
 
    LOG_0(TraceLevelInfo, "Exited DataSetByFeatureGroup::Destruct");
 }
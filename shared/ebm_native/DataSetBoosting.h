@@ -13,13 +13,43 @@
 #include "Logging.h" // EBM_ASSERT & LOG
 #include "FeatureGroup.h"
 
+class PackedData;
+
 class DataSetByFeatureGroup final {
-   FloatEbmType * m_aResidualErrors;
-   FloatEbmType * m_aPredictorScores;
+   // the residuals, denominators and predictor scores are either all FloatEbmType or all float, depending on 
+   // m_bFloat32.  Kernels read them through the templated getters, but compute and accumulate in FloatEbmType
+   void * m_aResidualErrors;
+   // optional cache of the Newton-Raphson denominator for each residual.  nullptr if we compute them on the fly
+   void * m_aDenominators;
+   void * m_aPredictorScores;
    StorageDataType * m_aTargetData;
    StorageDataType * * m_aaInputData;
    size_t m_cSamples;
    size_t m_cFeatureGroups;
+   // if not nullptr, m_aaInputData points into this read-only PackedData and we hold one of its references
+   PackedData * m_pPackedData;
+   // bit (iSample % k_cBitsForSizeT) of m_aSampleMaskBits[iSample / k_cBitsForSizeT] is set if iSample belongs to 
+   // this data set.  nullptr if every sample belongs to it.  Masks let several boosters share one PackedData
+   size_t * m_aSampleMaskBits;
+   size_t m_cSamplesIncluded;
+   // the integer frequency weight of each sample, which is zero for samples outside of our mask.  nullptr if 
+   // every sample has a weight of 1.  A sample with weight w acts like w identical samples
+   size_t * m_aWeights;
+   size_t m_cWeightTotal;
+   // scratch space for ApplyModelUpdateTraining when the residuals and predictor scores are class-major.  It holds 
+   // k_cSamplesClassMajorBlock tensor bin offsets and k_cSamplesClassMajorBlock * (cVectorLength + 1) exps and sums
+   size_t * m_aClassMajorTensorBins;
+   FloatEbmType * m_aClassMajorExps;
+   // optional per input data index of our samples grouped by bin.  m_aaSampleIndexes[iInputData] holds cBins + 1 
+   // offsets where the samples of bin iBin are [aOffsets[iBin], aOffsets[iBin + 1]), followed by the cSamples sample 
+   // indexes which ascend within each bin.  The whole array and its items are nullptr for unindexed feature groups
+   size_t * * m_aaSampleIndexes;
+   // the cBinsMax of ConstructSampleIndexes, which InitializeConcatenated needs to index the same feature groups
+   size_t m_cSampleIndexBinsMax;
+   bool m_bFloat32;
+   // if true, the residuals, denominators and predictor scores hold all the samples of class 0, then all the samples 
+   // of class 1, and so on, instead of keeping the cVectorLength values of each sample together
+   bool m_bClassMajor;
 
 public:
 
@@ -30,39 +60,141 @@ public:
 
    INLINE_ALWAYS void InitializeZero() {
       m_aResidualErrors = nullptr;
+      m_aDenominators = nullptr;
       m_aPredictorScores = nullptr;
       m_aTargetData = nullptr;
       m_aaInputData = nullptr;
       m_cSamples = 0;
       m_cFeatureGroups = 0;
+      m_pPackedData = nullptr;
+      m_aSampleMaskBits = nullptr;
+      m_cSamplesIncluded = 0;
+      m_aWeights = nullptr;
+      m_cWeightTotal = 0;
+      m_aClassMajorTensorBins = nullptr;
+      m_aClassMajorExps = nullptr;
+      m_aaSampleIndexes = nullptr;
+      m_cSampleIndexBinsMax = 0;
+      m_bFloat32 = false;
+      m_bClassMajor = false;
    }
 
    void Destruct();
 
+   // if pPackedData isn't nullptr we use its bit packed data in place instead of packing aInputDataFrom, and we
+   // keep a reference to it until Destruct.  If aColumnsFrom isn't nullptr we pack its typed columns instead of the 
+   // IntEbmType data in aInputDataFrom.  If aSampleMask isn't nullptr, only the samples with a non-zero mask 
+   // value belong to this data set, but every per-sample array still has cSamples items.  If bFloat32 is true we 
+   // store the residuals, denominators and predictor scores as float, which halves the bandwidth of the kernels.  
+   // If aWeights isn't nullptr it holds a non-negative integer weight for each sample
    bool Initialize(
       const bool bAllocateResidualErrors, 
+      const bool bAllocateDenominators, 
       const bool bAllocatePredictorScores, 
       const bool bAllocateTargetData, 
+      const bool bFloat32, 
       const size_t cFeatureGroups, 
       const FeatureGroup * const * const apFeatureGroup, 
       const size_t cSamples, 
       const IntEbmType * const aInputDataFrom, 
+      const EbmNativeBinnedColumn * const aColumnsFrom, 
       const void * const aTargets, 
       const FloatEbmType * const aPredictorScoresFrom, 
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      PackedData * const pPackedData,
+      const IntEbmType * const aSampleMask,
+      const IntEbmType * const aWeights
+   );
+
+   // initializes us with the samples of pDataSetFirst followed by the samples of pDataSetSecond, in the layout of 
+   // pDataSetFirst.  We cache denominators, go class-major and index our samples if pDataSetFirst does, and 
+   // recompute those from the copied residuals.  pDataSetSecond needs to be a sample-major training set of the same 
+   // feature groups and precision straight out of Initialize.  Neither can have packed data, a mask or weights.  
+   // Returns true on error, in which case our caller needs to Destruct us
+   bool InitializeConcatenated(
+      const DataSetByFeatureGroup * const pDataSetFirst,
+      const DataSetByFeatureGroup * const pDataSetSecond,
+      const FeatureGroup * const * const apFeatureGroup,
+      const size_t cVectorLength
+   );
+
+   // writes our bit packed data in the format that PackedData::Open reads.  Returns true on error
+   bool Save(const char * const filePath, const FeatureGroup * const * const apFeatureGroup) const;
+
+   // copies our bit packed data into a new in-memory PackedData.  Returns nullptr on error
+   PackedData * CreatePackedData(const FeatureGroup * const * const apFeatureGroup) const;
+
+   // recomputes the cached denominators from the current residuals.  Call this whenever the residuals change
+   void UpdateDenominators(const size_t cVectorLength);
+
+   // rearranges the initialized residuals and predictor scores into the class-major layout.  Call this before the 
+   // denominators are first computed.  Returns true on error, in which case we keep the sample-major layout
+   bool TransposeToClassMajor(const size_t cVectorLength);
+
+   // groups the samples by bin for each single feature group with at most cBinsMax bins, which lets BinBoosting 
+   // visit the samples of one bin after another instead of unpacking every sample.  Returns true on error
+   bool ConstructSampleIndexes(
+      const size_t cFeatureGroups, 
+      const FeatureGroup * const * const apFeatureGroup, 
+      const size_t cBinsMax
    );
 
-   INLINE_ALWAYS FloatEbmType * GetResidualPointer() {
+   INLINE_ALWAYS bool IsFloat32() const {
+      return m_bFloat32;
+   }
+   INLINE_ALWAYS bool IsClassMajor() const {
+      return m_bClassMajor;
+   }
+   // the distance between the values of consecutive classes of one sample in the residuals, denominators and 
+   // predictor scores
+   INLINE_ALWAYS size_t GetClassStride() const {
+      return m_bClassMajor ? m_cSamples : size_t { 1 };
+   }
+   // the distance between the values of one class for consecutive samples
+   INLINE_ALWAYS size_t GetSampleStride(const size_t cVectorLength) const {
+      return m_bClassMajor ? size_t { 1 } : cVectorLength;
+   }
+   INLINE_ALWAYS size_t * GetClassMajorTensorBins() {
+      EBM_ASSERT(nullptr != m_aClassMajorTensorBins);
+      return m_aClassMajorTensorBins;
+   }
+   INLINE_ALWAYS FloatEbmType * GetClassMajorExps() {
+      EBM_ASSERT(nullptr != m_aClassMajorExps);
+      return m_aClassMajorExps;
+   }
+   // TFloat needs to be float if IsFloat32() and FloatEbmType otherwise
+   template<typename TFloat = FloatEbmType>
+   INLINE_ALWAYS TFloat * GetResidualPointer() {
+      EBM_ASSERT(IsStorageType<TFloat>());
       EBM_ASSERT(nullptr != m_aResidualErrors);
-      return m_aResidualErrors;
+      return static_cast<TFloat *>(m_aResidualErrors);
    }
-   INLINE_ALWAYS const FloatEbmType * GetResidualPointer() const {
+   template<typename TFloat = FloatEbmType>
+   INLINE_ALWAYS const TFloat * GetResidualPointer() const {
+      EBM_ASSERT(IsStorageType<TFloat>());
       EBM_ASSERT(nullptr != m_aResidualErrors);
-      return m_aResidualErrors;
+      return static_cast<const TFloat *>(m_aResidualErrors);
+   }
+   INLINE_ALWAYS bool IsDenominatorsCached() const {
+      return nullptr != m_aDenominators;
    }
-   INLINE_ALWAYS FloatEbmType * GetPredictorScores() {
+   template<typename TFloat = FloatEbmType>
+   INLINE_ALWAYS const TFloat * GetDenominatorPointer() const {
+      EBM_ASSERT(IsStorageType<TFloat>());
+      EBM_ASSERT(nullptr != m_aDenominators);
+      return static_cast<const TFloat *>(m_aDenominators);
+   }
+   template<typename TFloat = FloatEbmType>
+   INLINE_ALWAYS TFloat * GetDenominatorPointer() {
+      EBM_ASSERT(IsStorageType<TFloat>());
+      EBM_ASSERT(nullptr != m_aDenominators);
+      return static_cast<TFloat *>(m_aDenominators);
+   }
+   template<typename TFloat = FloatEbmType>
+   INLINE_ALWAYS TFloat * GetPredictorScores() {
+      EBM_ASSERT(IsStorageType<TFloat>());
       EBM_ASSERT(nullptr != m_aPredictorScores);
-      return m_aPredictorScores;
+      return static_cast<TFloat *>(m_aPredictorScores);
    }
    INLINE_ALWAYS const StorageDataType * GetTargetDataPointer() const {
       EBM_ASSERT(nullptr != m_aTargetData);
@@ -75,12 +207,62 @@ public:
       EBM_ASSERT(nullptr != m_aaInputData);
       return m_aaInputData[pFeatureGroup->GetIndexInputData()];
    }
+   // nullptr if ConstructSampleIndexes skipped this feature group.  See m_aaSampleIndexes for the layout
+   INLINE_ALWAYS const size_t * GetSampleIndex(const FeatureGroup * const pFeatureGroup) const {
+      EBM_ASSERT(nullptr != pFeatureGroup);
+      EBM_ASSERT(pFeatureGroup->GetIndexInputData() < m_cFeatureGroups);
+      return nullptr == m_aaSampleIndexes ? nullptr : m_aaSampleIndexes[pFeatureGroup->GetIndexInputData()];
+   }
    INLINE_ALWAYS size_t GetCountSamples() const {
       return m_cSamples;
    }
+   // true if our bit packed data lives in a shared PackedData instead of in arrays that we own
+   INLINE_ALWAYS bool IsPackedData() const {
+      return nullptr != m_pPackedData;
+   }
+   // nullptr if every sample belongs to this data set
+   INLINE_ALWAYS const size_t * GetSampleMaskBits() const {
+      return m_aSampleMaskBits;
+   }
+   // the number of samples that belong to this data set, which is GetCountSamples() without a mask
+   INLINE_ALWAYS size_t GetCountSamplesIncluded() const {
+      return m_cSamplesIncluded;
+   }
+   // nullptr if every sample has a weight of 1
+   INLINE_ALWAYS const size_t * GetWeights() const {
+      return m_aWeights;
+   }
+   // the sum of the weights of the samples that belong to this data set, which is GetCountSamplesIncluded() 
+   // without weights
+   INLINE_ALWAYS size_t GetWeightTotal() const {
+      return m_cWeightTotal;
+   }
    INLINE_ALWAYS size_t GetCountFeatureGroups() const {
       return m_cFeatureGroups;
    }
+
+private:
+
+   template<typename TFloat>
+   INLINE_ALWAYS bool IsStorageType() const {
+      static_assert(std::is_same<TFloat, FloatEbmType>::value || std::is_same<TFloat, float>::value,
+         "we only store FloatEbmType or float values");
+      return (std::is_same<TFloat, float>::value && std::is_same<FloatEbmType, float>::value) || 
+         m_bFloat32 == std::is_same<TFloat, float>::value;
+   }
+
+   template<typename TFloat>
+   void UpdateDenominatorsInternal(const size_t cVectorLength);
+
+   template<typename TFloat>
+   bool TransposeToClassMajorInternal(const size_t cVectorLength);
+
+   template<typename TFloat>
+   bool ConcatenateValues(
+      const DataSetByFeatureGroup * const pDataSetFirst,
+      const DataSetByFeatureGroup * const pDataSetSecond,
+      const size_t cVectorLength
+   );
 };
 static_assert(std::is_standard_layout<DataSetByFeatureGroup>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -6,12 +6,17 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // FeatureType
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
 #include "FeatureAtomic.h"
+#include "FeatureGroup.h"
 #include "DataSetInteraction.h"
+#include "DataSetBoosting.h"
+#include "RandomStream.h"
 
 extern void InitializeResiduals(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
@@ -45,7 +50,7 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(
    }
 
    const size_t cElements = cSamples * cVectorLength;
-   FloatEbmType * aResidualErrors = EbmMalloc<FloatEbmType>(cElements);
+   FloatEbmType * aResidualErrors = AlignedMalloc<FloatEbmType>(MemorySubsystem::DataSet, cElements);
 
    FloatEbmType * aTempFloatVector = nullptr;
    if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
@@ -53,7 +58,7 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType * ConstructResidualErrors(
          aTempFloatVector = EbmMalloc<FloatEbmType>(cVectorLength);
          if(UNLIKELY(nullptr == aTempFloatVector)) {
             LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::ConstructResidualErrors nullptr == aTempFloatVector");
-            free(aResidualErrors);
+            AlignedFree(aResidualErrors);
             return nullptr;
          }
       }
@@ -97,7 +102,7 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
    const Feature * pFeature = aFeatures;
    const Feature * const pFeatureEnd = aFeatures + cFeatures;
    do {
-      StorageDataType * pInputDataTo = EbmMalloc<StorageDataType>(cSamples);
+      StorageDataType * pInputDataTo = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cSamples);
       if(nullptr == pInputDataTo) {
          LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::ConstructInputData nullptr == pInputDataTo");
          goto free_all;
@@ -140,7 +145,7 @@ INLINE_RELEASE_UNTEMPLATED static StorageDataType * * ConstructInputData(
 free_all:
    while(aaInputDataTo != paInputDataTo) {
       --paInputDataTo;
-      free(*paInputDataTo);
+      AlignedFree(*paInputDataTo);
    }
    free(aaInputDataTo);
    return nullptr;
@@ -151,14 +156,14 @@ WARNING_DISABLE_USING_UNINITIALIZED_MEMORY
 void DataSetByFeature::Destruct() {
    LOG_0(TraceLevelInfo, "Entered DataSetByFeature::Destruct");
 
-   free(m_aResidualErrors);
+   AlignedFree(m_aResidualErrors);
    if(nullptr != m_aaInputData) {
       EBM_ASSERT(1 <= m_cFeatures);
       StorageDataType ** paInputData = m_aaInputData;
       const StorageDataType * const * const paInputDataEnd = m_aaInputData + m_cFeatures;
       do {
          EBM_ASSERT(nullptr != *paInputData);
-         free(*paInputData);
+         AlignedFree(*paInputData);
          ++paInputData;
       } while(paInputDataEnd != paInputData);
       free(m_aaInputData);
@@ -225,7 +230,7 @@ bool DataSetByFeature::Initialize(
       if(0 != cFeatures) {
          StorageDataType ** const aaInputData = ConstructInputData(cFeatures, aFeatures, cSamples, aBinnedData);
          if(nullptr == aaInputData) {
-            free(aResidualErrors);
+            AlignedFree(aResidualErrors);
             goto exit_error;
          }
          m_aaInputData = aaInputData;
@@ -242,3 +247,273 @@ exit_error:;
    LOG_0(TraceLevelWarning, "WARNING Exited DataSetByFeature::Initialize");
    return true;
 }
+
+bool DataSetByFeature::InitializeSubset(
+   const DataSetByFeature * const pDataSetFrom,
+   const size_t cVectorLength,
+   const size_t cSamplesIncluded,
+   RandomStream * const pRandomStream
+) {
+   EBM_ASSERT(nullptr == m_aResidualErrors); // we expect to start with zeroed values
+   EBM_ASSERT(nullptr == m_aaInputData); // we expect to start with zeroed values
+   EBM_ASSERT(0 == m_cSamples); // we expect to start with zeroed values
+   EBM_ASSERT(nullptr != pDataSetFrom);
+   EBM_ASSERT(1 <= cVectorLength);
+   EBM_ASSERT(1 <= cSamplesIncluded);
+   EBM_ASSERT(cSamplesIncluded <= pDataSetFrom->m_cSamples);
+   EBM_ASSERT(nullptr != pRandomStream);
+
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeature::InitializeSubset");
+
+   const size_t cFeatures = pDataSetFrom->m_cFeatures;
+
+   // the original residuals fit in memory, so a subset of them can't overflow
+   EBM_ASSERT(!IsMultiplyError(cSamplesIncluded, cVectorLength));
+   FloatEbmType * const aResidualErrors = AlignedMalloc<FloatEbmType>(MemorySubsystem::DataSet, cSamplesIncluded * cVectorLength);
+   if(nullptr == aResidualErrors) {
+      LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeSubset nullptr == aResidualErrors");
+      return true;
+   }
+
+   StorageDataType ** aaInputData = nullptr;
+   if(0 != cFeatures) {
+      aaInputData = EbmMalloc<StorageDataType *>(cFeatures);
+      if(nullptr == aaInputData) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeSubset nullptr == aaInputData");
+         AlignedFree(aResidualErrors);
+         return true;
+      }
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         StorageDataType * const aInputData = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cSamplesIncluded);
+         if(nullptr == aInputData) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeSubset nullptr == aInputData");
+            for(size_t iFeatureFree = 0; iFeatureFree < iFeature; ++iFeatureFree) {
+               AlignedFree(aaInputData[iFeatureFree]);
+            }
+            free(aaInputData);
+            AlignedFree(aResidualErrors);
+            return true;
+         }
+         aaInputData[iFeature] = aInputData;
+      }
+   }
+
+   // this is the same selection algorithm that SamplingSet uses for sampling without replacement, so every subset 
+   // of size cSamplesIncluded is equally likely
+   size_t cIncludedRemaining = cSamplesIncluded;
+   size_t cSamplesRemaining = pDataSetFrom->m_cSamples;
+   size_t iSampleTo = 0;
+   size_t iSampleFrom = 0;
+   while(0 != cIncludedRemaining) {
+      EBM_ASSERT(cIncludedRemaining <= cSamplesRemaining);
+      if(pRandomStream->Next(cSamplesRemaining) < cIncludedRemaining) {
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            aaInputData[iFeature][iSampleTo] = pDataSetFrom->m_aaInputData[iFeature][iSampleFrom];
+         }
+         const FloatEbmType * const pResidualErrorFrom = &pDataSetFrom->m_aResidualErrors[iSampleFrom * cVectorLength];
+         FloatEbmType * const pResidualErrorTo = &aResidualErrors[iSampleTo * cVectorLength];
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            pResidualErrorTo[iVector] = pResidualErrorFrom[iVector];
+         }
+         ++iSampleTo;
+         --cIncludedRemaining;
+      }
+      --cSamplesRemaining;
+      ++iSampleFrom;
+   }
+   EBM_ASSERT(cSamplesIncluded == iSampleTo);
+
+   m_aResidualErrors = aResidualErrors;
+   m_aaInputData = aaInputData;
+   m_cSamples = cSamplesIncluded;
+   m_cFeatures = cFeatures;
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeature::InitializeSubset");
+   return false;
+}
+
+// the number of times that iSample of a boosting data set appears in an interaction data set built from it
+INLINE_ALWAYS static size_t GetCountBoostingSampleCopies(const DataSetByFeatureGroup * const pDataSet, const size_t iSample) {
+   const size_t * const aWeights = pDataSet->GetWeights();
+   if(nullptr != aWeights) {
+      // weights are zero outside of the mask
+      return aWeights[iSample];
+   }
+   const size_t * const aSampleMaskBits = pDataSet->GetSampleMaskBits();
+   if(nullptr != aSampleMaskBits) {
+      return size_t { 1 } & (aSampleMaskBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT));
+   }
+   return size_t { 1 };
+}
+
+template<typename TFloat>
+static void CopyBoostingResiduals(
+   const DataSetByFeatureGroup * const pDataSetFrom, 
+   const size_t cVectorLength, 
+   FloatEbmType * pResidualErrorTo
+) {
+   const TFloat * const aResidualErrorsFrom = pDataSetFrom->GetResidualPointer<TFloat>();
+   const size_t cSampleStride = pDataSetFrom->GetSampleStride(cVectorLength);
+   const size_t cClassStride = pDataSetFrom->GetClassStride();
+   const size_t cSamples = pDataSetFrom->GetCountSamples();
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      const TFloat * const pResidualErrorFrom = &aResidualErrorsFrom[iSample * cSampleStride];
+      for(size_t cCopies = GetCountBoostingSampleCopies(pDataSetFrom, iSample); 0 != cCopies; --cCopies) {
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            *pResidualErrorTo = static_cast<FloatEbmType>(pResidualErrorFrom[iVector * cClassStride]);
+            ++pResidualErrorTo;
+         }
+      }
+   }
+}
+
+// writes the bin of pFeature for every sample copy of pDataSetFrom into aInputDataTo.  Returns true on error
+static bool UnpackBoostingFeature(
+   const Feature * const pFeature,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const DataSetByFeatureGroup * const pDataSetFrom,
+   StorageDataType * const aInputDataTo
+) {
+   const size_t cBins = pFeature->GetCountBins();
+
+   // the feature's bin is (tensorIndex / cBinsStride) % cBins within the packed tensor indexes of pFeatureGroupFrom.  
+   // Fewer dimensions mean fewer items per data unit to walk through
+   const FeatureGroup * pFeatureGroupFrom = nullptr;
+   size_t cBinsStride = 0;
+   size_t cTensorBins = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+      if(nullptr != pFeatureGroupFrom && pFeatureGroupFrom->GetCountFeatures() <= cDimensions) {
+         continue;
+      }
+      const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+      size_t cTensorBinsGroup = 1;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const Feature * const pDimensionFeature = aFeatureGroupEntries[iDimension].m_pFeature;
+         if(pFeature == pDimensionFeature) {
+            pFeatureGroupFrom = pFeatureGroup;
+            cBinsStride = cTensorBinsGroup;
+         }
+         // the booster checked that the tensor fits in memory
+         cTensorBinsGroup *= pDimensionFeature->GetCountBins();
+      }
+      if(pFeatureGroup == pFeatureGroupFrom) {
+         cTensorBins = cTensorBinsGroup;
+      }
+   }
+
+   const size_t cSamplesFrom = pDataSetFrom->GetCountSamples();
+   StorageDataType * pInputDataTo = aInputDataTo;
+   if(nullptr == pFeatureGroupFrom) {
+      // features with a single bin are dropped from the feature groups, but we know all their bins anyways
+      if(1 < cBins) {
+         LOG_0(TraceLevelError, "ERROR DataSetByFeature::InitializeFromBoosting every feature with more than one bin must be in a feature group");
+         return true;
+      }
+      for(size_t iSample = 0; iSample < cSamplesFrom; ++iSample) {
+         for(size_t cCopies = GetCountBoostingSampleCopies(pDataSetFrom, iSample); 0 != cCopies; --cCopies) {
+            *pInputDataTo = StorageDataType { 0 };
+            ++pInputDataTo;
+         }
+      }
+      return false;
+   }
+
+   const StorageDataType * const aInputDataFrom = pDataSetFrom->GetInputDataPointer(pFeatureGroupFrom);
+   const size_t cItemsPerBitPackedDataUnit = pFeatureGroupFrom->GetCountItemsPerBitPackedDataUnit();
+   EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+   const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+   EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+   const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+
+   for(size_t iSample = 0; iSample < cSamplesFrom; ++iSample) {
+      size_t cCopies = GetCountBoostingSampleCopies(pDataSetFrom, iSample);
+      if(0 != cCopies) {
+         const size_t tensorIndex = maskBits & static_cast<size_t>(aInputDataFrom[iSample / cItemsPerBitPackedDataUnit] >> 
+            (iSample % cItemsPerBitPackedDataUnit * cBitsPerItemMax));
+         // packed data can come from a file, so we don't trust it to reference memory
+         if(cTensorBins <= tensorIndex) {
+            LOG_0(TraceLevelError, "ERROR DataSetByFeature::InitializeFromBoosting the packed data has a bin outside of its feature group");
+            return true;
+         }
+         const StorageDataType iBin = static_cast<StorageDataType>(tensorIndex / cBinsStride % cBins);
+         do {
+            *pInputDataTo = iBin;
+            ++pInputDataTo;
+            --cCopies;
+         } while(0 != cCopies);
+      }
+   }
+   return false;
+}
+
+bool DataSetByFeature::InitializeFromBoosting(
+   const size_t cFeatures,
+   const Feature * const aFeatures,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const DataSetByFeatureGroup * const pDataSetFrom,
+   const size_t cVectorLength
+) {
+   EBM_ASSERT(nullptr == m_aResidualErrors); // we expect to start with zeroed values
+   EBM_ASSERT(nullptr == m_aaInputData); // we expect to start with zeroed values
+   EBM_ASSERT(0 == m_cSamples); // we expect to start with zeroed values
+   EBM_ASSERT(0 == cFeatures || nullptr != aFeatures);
+   EBM_ASSERT(nullptr != pDataSetFrom);
+   EBM_ASSERT(1 <= cVectorLength);
+
+   LOG_0(TraceLevelInfo, "Entered DataSetByFeature::InitializeFromBoosting");
+
+   const size_t cSamplesFrom = pDataSetFrom->GetCountSamples();
+   const size_t cSamples = 0 == cSamplesFrom ? size_t { 0 } : 
+      nullptr != pDataSetFrom->GetWeights() ? pDataSetFrom->GetWeightTotal() : pDataSetFrom->GetCountSamplesIncluded();
+   if(0 != cSamples) {
+      if(IsMultiplyError(cSamples, cVectorLength)) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeFromBoosting IsMultiplyError(cSamples, cVectorLength)");
+         return true;
+      }
+      FloatEbmType * const aResidualErrors = AlignedMalloc<FloatEbmType>(MemorySubsystem::DataSet, cSamples * cVectorLength);
+      if(nullptr == aResidualErrors) {
+         LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeFromBoosting nullptr == aResidualErrors");
+         return true;
+      }
+      if(pDataSetFrom->IsFloat32()) {
+         CopyBoostingResiduals<float>(pDataSetFrom, cVectorLength, aResidualErrors);
+      } else {
+         CopyBoostingResiduals<FloatEbmType>(pDataSetFrom, cVectorLength, aResidualErrors);
+      }
+
+      StorageDataType ** aaInputData = nullptr;
+      if(0 != cFeatures) {
+         aaInputData = EbmMalloc<StorageDataType *>(cFeatures);
+         if(nullptr == aaInputData) {
+            LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeFromBoosting nullptr == aaInputData");
+            AlignedFree(aResidualErrors);
+            return true;
+         }
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            StorageDataType * const aInputData = AlignedMalloc<StorageDataType>(MemorySubsystem::DataSet, cSamples);
+            aaInputData[iFeature] = aInputData;
+            if(nullptr == aInputData || 
+               UnpackBoostingFeature(&aFeatures[iFeature], cFeatureGroups, apFeatureGroup, pDataSetFrom, aInputData)) {
+               LOG_0(TraceLevelWarning, "WARNING DataSetByFeature::InitializeFromBoosting could not construct aInputData");
+               for(size_t iFeatureFree = 0; iFeatureFree <= iFeature; ++iFeatureFree) {
+                  AlignedFree(aaInputData[iFeatureFree]);
+               }
+               free(aaInputData);
+               AlignedFree(aResidualErrors);
+               return true;
+            }
+         }
+      }
+      m_aResidualErrors = aResidualErrors;
+      m_aaInputData = aaInputData;
+      m_cSamples = cSamples;
+   }
+   m_cFeatures = cFeatures;
+
+   LOG_0(TraceLevelInfo, "Exited DataSetByFeature::InitializeFromBoosting");
+   return false;
+}
@@ -12,6 +12,10 @@
 #include "Logging.h" // EBM_ASSERT & LOG
 #include "FeatureAtomic.h"
 
+class RandomStream;
+class FeatureGroup;
+class DataSetByFeatureGroup;
+
 class DataSetByFeature final {
    FloatEbmType * m_aResidualErrors;
    StorageDataType * * m_aaInputData;
@@ -44,6 +48,29 @@ public:
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses
    );
 
+   // fills this zeroed DataSetByFeature with cSamplesIncluded samples of pDataSetFrom picked without replacement.  The
+   // samples keep their original order, and their residuals are copied so they're identical to the originals
+   bool InitializeSubset(
+      const DataSetByFeature * const pDataSetFrom,
+      const size_t cVectorLength,
+      const size_t cSamplesIncluded,
+      RandomStream * const pRandomStream
+   );
+
+   // fills this zeroed DataSetByFeature from the training set of a booster instead of from the binned data.  The 
+   // bins of each feature are unpacked from the boosting feature group with the fewest features that contains it, and 
+   // the current residuals are copied into our sample-major FloatEbmType layout.  Samples outside of the mask of 
+   // pDataSetFrom are skipped, and a sample with weight w is repeated w times.  aFeatures are the features of the 
+   // booster, which its feature groups point into
+   bool InitializeFromBoosting(
+      const size_t cFeatures,
+      const Feature * const aFeatures,
+      const size_t cFeatureGroups,
+      const FeatureGroup * const * const apFeatureGroup,
+      const DataSetByFeatureGroup * const pDataSetFrom,
+      const size_t cVectorLength
+   );
+
    INLINE_ALWAYS const FloatEbmType * GetResidualPointer() const {
       EBM_ASSERT(nullptr != m_aResidualErrors);
       return m_aResidualErrors;
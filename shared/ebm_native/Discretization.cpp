@@ -14,6 +14,8 @@
 #include "EbmInternal.h"
 #include "Logging.h" // EBM_ASSERT & LOG
 
+#include "SimdKernels.h"
+
 // python binning types
 //quantile
 //quantile_humanized
@@ -124,35 +126,17 @@
 //       transpose_8192 = 6.26907
 //       transpose_16384 = 7.73406
 
-// don't bother using a lock here.  We don't care if an extra log message is written out due to thread parallism
-static int g_cLogEnterDiscretizeParametersMessages = 25;
-static int g_cLogExitDiscretizeParametersMessages = 25;
+static std::atomic<int> g_cLogEnterDiscretizeParametersMessages { 25 };
+static std::atomic<int> g_cLogExitDiscretizeParametersMessages { 25 };
 
-EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretize(
+// this is Discretize without the entry and exit logging.  It's safe to call from multiple threads at once
+extern IntEbmType DiscretizeInternal(
    IntEbmType countSamples,
    const FloatEbmType * featureValues,
    IntEbmType countBinCuts,
    const FloatEbmType * binCutsLowerBoundInclusive,
    IntEbmType * discretizedOut
 ) {
-   LOG_COUNTED_N(
-      &g_cLogEnterDiscretizeParametersMessages,
-      TraceLevelInfo,
-      TraceLevelVerbose,
-      "Entered Discretize: "
-      "countSamples=%" IntEbmTypePrintf ", "
-      "featureValues=%p, "
-      "countBinCuts=%" IntEbmTypePrintf ", "
-      "binCutsLowerBoundInclusive=%p, "
-      "discretizedOut=%p"
-      ,
-      countSamples,
-      static_cast<const void *>(featureValues),
-      countBinCuts,
-      static_cast<const void *>(binCutsLowerBoundInclusive),
-      static_cast<void *>(discretizedOut)
-   );
-
    IntEbmType ret;
    if(UNLIKELY(countSamples <= IntEbmType { 0 })) {
       if(UNLIKELY(countSamples < IntEbmType { 0 })) {
@@ -455,6 +439,20 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretiz
          goto exit_with_log;
       }
 
+      {
+         // the SIMD search only uses comparisons, so it returns exactly what the scalar versions below would
+         const SimdKernels * const pSimdKernels = SimdKernels::GetBestAvailable(SimdInstructionSet::Avx512);
+         if(nullptr != pSimdKernels && IsNumberConvertable<size_t>(countBinCuts)) {
+            if(!pSimdKernels->Discretize(cSamples, featureValues, static_cast<size_t>(countBinCuts), 
+               binCutsLowerBoundInclusive, discretizedOut)) 
+            {
+               ret = IntEbmType { 0 };
+               goto exit_with_log;
+            }
+            // if we couldn't allocate the search tree, the scalar search below doesn't need any memory
+         }
+      }
+
       FloatEbmType binCutsLowerBoundInclusiveCopy[1023];
       if(PREDICTABLE(countBinCuts <= IntEbmType { 15 })) {
          constexpr size_t cPower = 16;
@@ -856,6 +854,41 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretiz
    }
 
 exit_with_log:;
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretize(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterDiscretizeParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered Discretize: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "countBinCuts=%" IntEbmTypePrintf ", "
+      "binCutsLowerBoundInclusive=%p, "
+      "discretizedOut=%p"
+      ,
+      countSamples,
+      static_cast<const void *>(featureValues),
+      countBinCuts,
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      static_cast<void *>(discretizedOut)
+   );
+
+   const IntEbmType ret = DiscretizeInternal(
+      countSamples,
+      featureValues,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      discretizedOut
+   );
 
    LOG_COUNTED_N(
       &g_cLogExitDiscretizeParametersMessages, 
@@ -870,3 +903,94 @@ exit_with_log:;
    return ret;
 }
 
+static std::atomic<int> g_cLogEnterDiscretizeFeaturesParametersMessages { 25 };
+static std::atomic<int> g_cLogExitDiscretizeFeaturesParametersMessages { 25 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION DiscretizeFeatures(
+   IntEbmType countSamples,
+   IntEbmType countFeatures,
+   const FloatEbmType * featureValues,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterDiscretizeFeaturesParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered DiscretizeFeatures: "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "discretizedOut=%p"
+      ,
+      countSamples,
+      countFeatures,
+      static_cast<const void *>(featureValues),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      static_cast<void *>(discretizedOut)
+   );
+
+   // one call for the whole matrix avoids the per feature overhead of crossing the language boundary, and the
+   // dispatch to our SIMD kernels happens once per column inside Discretize
+
+   IntEbmType ret = IntEbmType { 0 };
+   if(UNLIKELY(countSamples < IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR DiscretizeFeatures countSamples cannot be negative");
+      ret = IntEbmType { 1 };
+   } else if(UNLIKELY(countFeatures < IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR DiscretizeFeatures countFeatures cannot be negative");
+      ret = IntEbmType { 1 };
+   } else if(IntEbmType { 0 } != countSamples && IntEbmType { 0 } != countFeatures) {
+      if(UNLIKELY(!IsNumberConvertable<size_t>(countSamples) || !IsNumberConvertable<size_t>(countFeatures))) {
+         LOG_0(TraceLevelError, "ERROR DiscretizeFeatures countSamples or countFeatures was too large to fit into memory");
+         ret = IntEbmType { 1 };
+      } else if(UNLIKELY(IsMultiplyError(static_cast<size_t>(countSamples), static_cast<size_t>(countFeatures)))) {
+         LOG_0(TraceLevelError, "ERROR DiscretizeFeatures countSamples * countFeatures was too large to fit into memory");
+         ret = IntEbmType { 1 };
+      } else if(UNLIKELY(nullptr == countBinCuts)) {
+         LOG_0(TraceLevelError, "ERROR DiscretizeFeatures countBinCuts cannot be null");
+         ret = IntEbmType { 1 };
+      } else if(UNLIKELY(nullptr == featureValues)) {
+         LOG_0(TraceLevelError, "ERROR DiscretizeFeatures featureValues cannot be null");
+         ret = IntEbmType { 1 };
+      } else if(UNLIKELY(nullptr == discretizedOut)) {
+         LOG_0(TraceLevelError, "ERROR DiscretizeFeatures discretizedOut cannot be null");
+         ret = IntEbmType { 1 };
+      } else {
+         const size_t cSamples = static_cast<size_t>(countSamples);
+         const size_t cFeatures = static_cast<size_t>(countFeatures);
+         const FloatEbmType * pBinCuts = binCutsLowerBoundInclusive;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            const IntEbmType countBinCutsFeature = countBinCuts[iFeature];
+            // Discretize checks the individual cut counts, including that they fit into memory
+            ret = Discretize(
+               countSamples,
+               featureValues + iFeature * cSamples,
+               countBinCutsFeature,
+               pBinCuts,
+               discretizedOut + iFeature * cSamples
+            );
+            if(IntEbmType { 0 } != ret) {
+               break;
+            }
+            pBinCuts += static_cast<size_t>(countBinCutsFeature);
+         }
+      }
+   }
+
+   LOG_COUNTED_N(
+      &g_cLogExitDiscretizeFeaturesParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited DiscretizeFeatures: "
+      "return=%" IntEbmTypePrintf
+      ,
+      ret
+   );
+
+   return ret;
+}
@@ -9,7 +9,8 @@
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
 #include <type_traits> // is_integral
-#include <cmath> // std::exp, std::log
+#include <cmath> // std::exp, std::log, std::floor, std::isnan
+#include <string.h> // memcpy
 #include <stdlib.h> // free
 
 #include "ebm_native.h"
@@ -309,6 +310,13 @@ static_assert(
    "we special case binary classification to have only 1 output.  If we remove the compile time optimization for the binary class situation then we would "
    "output model files with two values instead of our special case 1");
 
+// above k_cCompilerOptimizedTargetClassesMax the hot loops walk the vector in tiles of this many items, which each have
+// a compile time count.  4 doubles fill an AVX register, and it keeps the templates from multiplying per class count
+constexpr size_t k_cTargetClassesTile = 4;
+// class-major multiclass updates work through the samples in blocks of this many so that the exps of every class for
+// one block stay in the L1 cache between computing them and turning them into residuals
+constexpr size_t k_cSamplesClassMajorBlock = 256;
+
 typedef size_t StorageDataType;
 typedef UIntEbmType ActiveDataType;
 
@@ -411,11 +419,45 @@ static_assert(k_cCompilerOptimizedCountDimensionsMax <= k_cDimensionsMax,
 
 constexpr size_t k_dynamicDimensions = 0;
 
+// feature groups with exactly this many dimensions get their own instantiation in the dimension templated kernels 
+// even though they're above k_cCompilerOptimizedCountDimensionsMax.  Unlike raising k_cCompilerOptimizedCountDimensionsMax 
+// this adds one instantiation per target class count instead of one for every count of dimensions up to it.  
+// k_dynamicDimensions turns it off
+#ifdef EBM_NATIVE_R
+constexpr size_t k_cCompilerOptimizedCountDimensionsExtra = k_dynamicDimensions;
+#else // EBM_NATIVE_R
+constexpr size_t k_cCompilerOptimizedCountDimensionsExtra = 3;
+#endif // EBM_NATIVE_R
+
+static_assert(k_dynamicDimensions == k_cCompilerOptimizedCountDimensionsExtra || 
+   (k_cCompilerOptimizedCountDimensionsMax < k_cCompilerOptimizedCountDimensionsExtra && k_cCompilerOptimizedCountDimensionsExtra <= k_cDimensionsMax),
+   "k_cCompilerOptimizedCountDimensionsExtra needs to be above the dimensions that are already optimized");
+
 constexpr size_t k_cBitsForStorageType = CountBitsRequiredPositiveMax<StorageDataType>();
 
 constexpr INLINE_ALWAYS size_t GetCountBits(const size_t cItemsBitPacked) {
    return k_cBitsForStorageType / cItemsBitPacked;
 }
+// the inverse of GetCountBits.  cBits needs to be 1 or more
+constexpr INLINE_ALWAYS size_t GetCountItemsBitPacked(const size_t cBits) {
+   return k_cBitsForStorageType / cBits;
+}
+// like GetCountItemsBitPacked, but first rounds cBits up to a power of two so that items never straddle a byte 
+// boundary once they are 8 bits or wider.  This never packs more items than GetCountItemsBitPacked
+INLINE_ALWAYS size_t GetCountItemsBitPackedAligned(const size_t cBits) {
+   size_t cBitsAligned = 1;
+   while(cBitsAligned < cBits) {
+      cBitsAligned <<= 1;
+   }
+   return k_cBitsForStorageType / cBitsAligned;
+}
+// the packings of 4, 8, 16 and 32 bits per item that GetCountItemsBitPackedAligned rounds up to.  Our kernels have 
+// specializations for these that unpack with compile time shifts and masks, which the compiler turns into nibble, byte, 
+// short and int extractions.  Tight packing also lands on these when the bins need exactly that many bits
+constexpr size_t k_cItemsPerBitPackedDataUnitAligned4 = GetCountItemsBitPacked(4);
+constexpr size_t k_cItemsPerBitPackedDataUnitAligned8 = GetCountItemsBitPacked(8);
+constexpr size_t k_cItemsPerBitPackedDataUnitAligned16 = GetCountItemsBitPacked(16);
+constexpr size_t k_cItemsPerBitPackedDataUnitAligned32 = GetCountItemsBitPacked(32);
 constexpr size_t k_cItemsPerBitPackedDataUnitDynamic = 0;
 constexpr size_t k_cItemsPerBitPackedDataUnitMax = 0; // if there are more than 16 (4 bits), then we should just use a loop since the code will be pretty big
 constexpr size_t k_cItemsPerBitPackedDataUnitMin = 0; // our default binning leads us to 256 values, which is 8 units per 64-bit data pack
@@ -510,11 +552,30 @@ constexpr bool k_bUseSIMD = false;
 static constexpr ptrdiff_t k_iZeroResidual = -1;
 static constexpr ptrdiff_t k_iZeroClassificationLogitAtInitialize = -1;
 
-// TODO eventually consider using these approximate functions for exp and log.  They make a BIG difference!
+// EbmExp and EbmLog default to std::exp and std::log.  Compiling with FAST_EXP and/or FAST_LOG defined replaces them
+// with the Cephes exp and log algorithms, written with the same operations in the same order as SimdFunctions::Exp
+// and SimdFunctions::Log, so each scalar result is bit identical to a SIMD lane.  Cephes reports a peak relative error
+// of 2e-16 for exp over [-708, 709] and 1.9e-16 for log over the positive normal numbers, which is about one ulp.
+// Against glibc we measured at most 3.2e-16 for exp and 2.3e-16 for log, so they agree with std::exp and std::log to
+// within two ulps.
+// std::exp and std::log can differ in their last bit between standard libraries, but these only use IEEE 754 adds,
+// multiplies, divides and bit manipulation, so they return the same results on x86 and ARM as long as the compiler
+// doesn't contract multiplies and adds into fused multiply-adds (we build with -ffp-contract=off)
 //#define FAST_EXP
 //#define FAST_LOG
 
 #ifdef FAST_EXP
+INLINE_ALWAYS FloatEbmType EbmExpPow2(const FloatEbmType n) {
+   // n holds an integer in [-1022, 1023].  Adding 2^52 + 1023 leaves the biased exponent of 2^n in the low mantissa bits
+   const FloatEbmType biased = n + FloatEbmType { 4503599627371519.0 };
+   uint64_t bits;
+   memcpy(&bits, &biased, sizeof(bits));
+   bits <<= 52;
+   FloatEbmType pow2;
+   memcpy(&pow2, &bits, sizeof(pow2));
+   return pow2;
+}
+
 INLINE_ALWAYS FloatEbmType EbmExp(FloatEbmType val) {
    // we use EbmExp to calculate the residual error, but we calculate the residual error with inputs only from the target and our logits
    // so if we introduce some noise in the residual error from approximations to exp, it will be seen and corrected by later boosting steps
@@ -528,22 +589,40 @@ INLINE_ALWAYS FloatEbmType EbmExp(FloatEbmType val) {
    // that divergence will NOT be affected by noise in the exp function since the noise in the exp function
    // will generate noise in the logit update, but it won't cause a divergence between the model and the error
 
-   // for algorithm, see https://codingforspeed.com/using-faster-exponential-approximation/
-   // TODO make the number of multiplications below a copmile time constant so we can try different values (9 in the code below)
-
-   // here's annohter implementation in AVX-512 (with a table)-> http://www.ecs.umass.edu/arith-2018/pdf/arith25_18.pdf
-
-   val = FloatEbmType { 1 } + val * (FloatEbmType { 1 } / FloatEbmType { 512 });
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   val *= val;
-   return val;
+   static_assert(sizeof(FloatEbmType) == sizeof(uint64_t), "EbmExp assumes IEEE 754 doubles");
+   constexpr FloatEbmType k_expMax = FloatEbmType { 709.782712893383973096 };
+   constexpr FloatEbmType k_expMin = FloatEbmType { -708.396418532264106224 };
+
+   if(UNLIKELY(k_expMax < val)) {
+      return std::numeric_limits<FloatEbmType>::infinity();
+   }
+   if(UNLIKELY(val < k_expMin)) {
+      return FloatEbmType { 0 };
+   }
+   // NaN fails both comparisons above and propagates through the math below
+
+   const FloatEbmType n = std::floor(val * FloatEbmType { 1.4426950408889634073599 } + FloatEbmType { 0.5 });
+   FloatEbmType r = val - n * FloatEbmType { 6.93145751953125E-1 };
+   r = r - n * FloatEbmType { 1.42860682030941723212E-6 };
+   const FloatEbmType rr = r * r;
+
+   FloatEbmType px = FloatEbmType { 1.26177193074810590878E-4 };
+   px = px * rr + FloatEbmType { 3.02994407707441961300E-2 };
+   px = px * rr + FloatEbmType { 9.99999999999999999910E-1 };
+   px = px * r;
+
+   FloatEbmType qx = FloatEbmType { 3.00198505138664455042E-6 };
+   qx = qx * rr + FloatEbmType { 2.52448340349684104192E-3 };
+   qx = qx * rr + FloatEbmType { 2.27265548208155028766E-1 };
+   qx = qx * rr + FloatEbmType { 2.00000000000000000009E0 };
+
+   FloatEbmType ret = px / (qx - px);
+   ret = FloatEbmType { 1 } + (ret + ret);
+
+   // n is within [-1022, 1024] here, but 2^1024 isn't a double, so we scale by 2^nLow and then 2^(n - nLow), which
+   // are both within [-511, 512].  ret is about 1, so the first multiplication is exact and only the second rounds
+   const FloatEbmType nLow = std::floor(n * FloatEbmType { 0.5 });
+   return ret * EbmExpPow2(nLow) * EbmExpPow2(n - nLow);
 }
 #else // FAST_EXP
 INLINE_ALWAYS FloatEbmType EbmExp(FloatEbmType val) {
@@ -552,52 +631,55 @@ INLINE_ALWAYS FloatEbmType EbmExp(FloatEbmType val) {
 #endif // FAST_EXP
 
 #ifdef FAST_LOG
-
-// possible approaches:
-// NOTE: even though memory lookup table approaches look to be the fastest and reasonable approach, we probably want to avoid lookup tables
-//   in order to avoid using too much of our cache memory which we need for other things
-// https://www.icsi.berkeley.edu/pubs/techreports/TR-07-002.pdf
-// https ://tech.ebayinc.com/engineering/fast-approximate-logarithms-part-i-the-basics/
-// https://tech.ebayinc.com/engineering/fast-approximate-logarithms-part-ii-rounding-error/
-// https://tech.ebayinc.com/engineering/fast-approximate-logarithms-part-iii-the-formulas/
-
-
-// TODO move this include up into the VS specific parts
-#include <intrin.h>
-#pragma intrinsic(_BitScanReverse)
-#pragma intrinsic(_BitScanReverse64)
-
-template<typename T>
-INLINE_ALWAYS unsigned int MostSignificantBit(T val) {
-   // TODO this only works in MS compiler.  This also doesn't work for numbers larger than uint64_t.  This has many problems, so review it.
-   unsigned long index;
-   return _BitScanReverse64(&index, static_cast<unsigned __int64>(val)) ? static_cast<unsigned int>(index) : static_cast<unsigned int>(0);
-}
-
 INLINE_ALWAYS FloatEbmType EbmLog(FloatEbmType val) {
-   // TODO: also look into whehter std::log1p has a good approximation directly
-
    // the log function is only used to calculate the log loss on the valididation set only
    // the log loss is calculated for the validation set and then returned as a single number to the caller
    // it never gets used as an input to anything inside our code, so any errors won't cyclically grow
 
-   // TODO : this only handles numbers x > 1.  I think I don't need results for less than x < 1 though, so check into that.   If we do have numbers below 1, 
-   //   we should do 1/x and figure out how much to multiply below
+   // we only take the log of 1 + exp(..) or of a sum of exps divided by one of them, so val is always a positive
+   // normal number, infinity or NaN.  Zero, negative numbers and denormals aren't handled
+   static_assert(sizeof(FloatEbmType) == sizeof(uint64_t), "EbmLog assumes IEEE 754 doubles");
 
-   // for various algorithms, see https://stackoverflow.com/questions/9799041/efficient-implementation-of-natural-logarithm-ln-and-exponentiation
- 
-   // TODO: this isn't going to work for us since we will often get vlaues greater than 2^64 in exp terms.  Let's figure out how to do the alternate where
-   // we extract the exponent term directly via IEEE 754
-   unsigned int shifts = MostSignificantBit(static_cast<uint64_t>(val));
-   val = val / static_cast<FloatEbmType>(uint64_t { 1 } << shifts);
+   if(UNLIKELY(std::isnan(val) || std::numeric_limits<FloatEbmType>::infinity() == val)) {
+      return val;
+   }
 
-   // this works sorta kinda well for numbers between 1 to 2 (we shifted our number to be within this range)
-   // TODO : increase precision of these magic numbers
-   val = FloatEbmType { -1.7417939 } + (FloatEbmType { 2.8212026 } + (FloatEbmType { -1.4699568 } + (FloatEbmType { 0.44717955 } + 
-      FloatEbmType { -0.056570851 } * val) * val) * val) * val;
-   val += static_cast<FloatEbmType>(shifts) * FloatEbmType { 0.69314718 };
+   // split val into m * 2^exponent with m in [0.5, 1)
+   uint64_t bits;
+   memcpy(&bits, &val, sizeof(bits));
+   FloatEbmType exponent = static_cast<FloatEbmType>(bits >> 52) - FloatEbmType { 1022 };
+   bits = (bits & uint64_t { 0x000FFFFFFFFFFFFF }) | uint64_t { 0x3FE0000000000000 };
+   FloatEbmType m;
+   memcpy(&m, &bits, sizeof(m));
+
+   if(m < FloatEbmType { 0.70710678118654752440 }) {
+      exponent = exponent - FloatEbmType { 1 };
+      m = (m + m) - FloatEbmType { 1 };
+   } else {
+      m = m - FloatEbmType { 1 };
+   }
 
-   return val;
+   const FloatEbmType z = m * m;
+
+   FloatEbmType p = FloatEbmType { 1.01875663804580931796E-4 };
+   p = p * m + FloatEbmType { 4.97494994976747001425E-1 };
+   p = p * m + FloatEbmType { 4.70579119878881725854E0 };
+   p = p * m + FloatEbmType { 1.44989225341610930846E1 };
+   p = p * m + FloatEbmType { 1.79368678507819816313E1 };
+   p = p * m + FloatEbmType { 7.70838733755885391666E0 };
+
+   FloatEbmType q = m + FloatEbmType { 1.12873587189167450590E1 };
+   q = q * m + FloatEbmType { 4.52279145837532221105E1 };
+   q = q * m + FloatEbmType { 8.29875266912776603211E1 };
+   q = q * m + FloatEbmType { 7.11544750618563894466E1 };
+   q = q * m + FloatEbmType { 2.31251620126765340583E1 };
+
+   FloatEbmType y = m * ((z * p) / q);
+   y = y - exponent * FloatEbmType { 2.121944400546905827679E-4 };
+   y = y - z * FloatEbmType { 0.5 };
+   FloatEbmType ret = m + y;
+   ret = ret + exponent * FloatEbmType { 0.693359375 };
+   return ret;
 }
 #else // FAST_LOG
 INLINE_ALWAYS FloatEbmType EbmLog(FloatEbmType val) {
@@ -608,4 +690,22 @@ INLINE_ALWAYS FloatEbmType EbmLog(FloatEbmType val) {
 }
 #endif // FAST_LOG
 
+// returns optionalTempParams[iParam] if the caller included that parameter (see ebm_native.h for the format), 
+// otherwise returns defaultValue.  Callers zero the parameters that they don't set, so 0 also returns defaultValue
+INLINE_ALWAYS FloatEbmType GetTempParam(
+   const FloatEbmType * const optionalTempParams, 
+   const IntEbmType iParam, 
+   const FloatEbmType defaultValue
+) {
+   if(nullptr == optionalTempParams) {
+      return defaultValue;
+   }
+   // the negated comparison treats a NaN count the same as a count of zero
+   if(!(static_cast<FloatEbmType>(iParam) <= optionalTempParams[0])) {
+      return defaultValue;
+   }
+   const FloatEbmType value = optionalTempParams[iParam];
+   return FloatEbmType { 0 } == value ? defaultValue : value;
+}
+
 #endif // EBM_INTERNAL_H
@@ -0,0 +1,458 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
+#include "SegmentedTensor.h" // ActiveDataType
+#include "HistogramBucket.h"
+#include "TreeNode.h"
+#include "TreeSweep.h"
+#include "Booster.h" // k_cBoostingShardsMax, k_cBoostingSlotsMax
+
+// These estimates repeat the sizing that EbmBoostingState::Allocate and DataSetByFeatureGroup::Initialize do, without
+// reading any samples.  If either of those changes what it allocates, this needs to change with it.  The
+// "estimates match" tests in BoostingUnusualInputs.cpp compare the two.
+
+static_assert(MemorySubsystemDataSet < MemoryEstimateCountItems && MemorySubsystemPackedData < MemoryEstimateCountItems &&
+   MemorySubsystemThreadBuffers < MemoryEstimateCountItems && MemoryEstimateHeap < MemoryEstimateCountItems,
+   "every item of the estimate needs to fit in countBytesOut");
+
+// an estimate that overflows is more memory than anyone can allocate, so we saturate instead of failing
+INLINE_ALWAYS static size_t AddSaturated(const size_t cBytes1, const size_t cBytes2) {
+   return IsAddError(cBytes1, cBytes2) ? std::numeric_limits<size_t>::max() : cBytes1 + cBytes2;
+}
+
+INLINE_ALWAYS static size_t MultiplySaturated(const size_t c1, const size_t c2) {
+   return IsMultiplyError(c1, c2) ? std::numeric_limits<size_t>::max() : c1 * c2;
+}
+
+// the thread arena rounds each of its buffers up to the next cache line
+INLINE_ALWAYS static size_t GetArenaBufferSizeSaturated(const size_t cBytes) {
+   const size_t cBytesRounded = AddSaturated(cBytes, k_cBytesAlignment - 1);
+   return std::numeric_limits<size_t>::max() == cBytesRounded ?
+      cBytesRounded : cBytesRounded / k_cBytesAlignment * k_cBytesAlignment;
+}
+
+// an AlignedMalloc of cItems items of cBytesPerItem, where nothing is allocated for zero items
+INLINE_ALWAYS static size_t GetAlignedBytes(
+   const MemorySubsystem memorySubsystem,
+   const size_t cItems,
+   const size_t cBytesPerItem
+) {
+   return GetAlignedMallocBytes(memorySubsystem, MultiplySaturated(cItems, cBytesPerItem));
+}
+
+static IntEbmType EstimateBoostingMemory(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const IntEbmType countTrainingSamples,
+   const IntEbmType countValidationSamples,
+   const IntEbmType countInnerBags,
+   const FloatEbmType * const optionalTempParams,
+   IntEbmType * const countBytesOut
+) {
+   if(nullptr == countBytesOut) {
+      LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory countBytesOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(countFeatures < 0 || countFeatureGroups < 0 || countTrainingSamples < 0 || countValidationSamples < 0 ||
+      countInnerBags < 0
+   ) {
+      LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory counts cannot be negative");
+      return IntEbmType { 1 };
+   }
+   if(0 != countFeatures && nullptr == features) {
+      LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory features cannot be nullptr if 0 < countFeatures");
+      return IntEbmType { 1 };
+   }
+   if(0 != countFeatureGroups && nullptr == featureGroups) {
+      LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory featureGroups cannot be nullptr if 0 < countFeatureGroups");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countFeatures) || !IsNumberConvertable<size_t>(countFeatureGroups) ||
+      !IsNumberConvertable<size_t>(countTrainingSamples) || !IsNumberConvertable<size_t>(countValidationSamples) ||
+      !IsNumberConvertable<size_t>(countInnerBags)
+   ) {
+      LOG_0(TraceLevelWarning, "WARNING EstimateBoostingMemory the counts are too high for us to allocate");
+      return IntEbmType { 1 };
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   const size_t cFeatureGroups = static_cast<size_t>(countFeatureGroups);
+   const size_t cTrainingSamples = static_cast<size_t>(countTrainingSamples);
+   const size_t cValidationSamples = static_cast<size_t>(countValidationSamples);
+   const size_t cInnerBags = static_cast<size_t>(countInnerBags);
+
+   const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   // the same parameters, with the same fallbacks, as EbmBoostingState::Allocate
+   size_t cShards = 1;
+   const FloatEbmType countShards = GetTempParam(optionalTempParams, TempParamBoostingCountShards, FloatEbmType { 1 });
+   if(static_cast<FloatEbmType>(k_cBoostingShardsMax) <= countShards) {
+      cShards = k_cBoostingShardsMax;
+   } else if(FloatEbmType { 1 } <= countShards) {
+      cShards = static_cast<size_t>(countShards);
+   }
+   size_t cSlots = 1;
+   const FloatEbmType countSlots = GetTempParam(optionalTempParams, TempParamBoostingConcurrentSlots, FloatEbmType { 1 });
+   if(static_cast<FloatEbmType>(k_cBoostingSlotsMax) <= countSlots) {
+      cSlots = k_cBoostingSlotsMax;
+   } else if(FloatEbmType { 1 } <= countSlots) {
+      cSlots = static_cast<size_t>(countSlots);
+   }
+   FloatEbmType alignedPackingGrowthMax = GetTempParam(optionalTempParams, TempParamBoostingAlignedPacking, FloatEbmType { 0 });
+   // the negated comparison also catches NaN
+   if(!(FloatEbmType { 0 } <= alignedPackingGrowthMax)) {
+      alignedPackingGrowthMax = FloatEbmType { 0 };
+   }
+   const bool bCacheDenominators = bClassification &&
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingCacheDenominators, FloatEbmType { 0 });
+   const size_t cBytesTrainingFloat =
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingSinglePrecision, FloatEbmType { 0 }) ?
+      sizeof(float) : sizeof(FloatEbmType);
+   const bool bClassMajor = ptrdiff_t { 3 } <= runtimeLearningTypeOrCountTargetClasses &&
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingClassMajor, FloatEbmType { 0 });
+   const bool bDeferValidation =
+      FloatEbmType { 0 } != GetTempParam(optionalTempParams, TempParamBoostingDeferValidation, FloatEbmType { 0 });
+   const FloatEbmType fractionIncluded =
+      GetTempParam(optionalTempParams, TempParamBoostingFractionWithoutReplacement, FloatEbmType { 0 });
+   const bool bWithoutReplacement = FloatEbmType { 0 } < fractionIncluded && fractionIncluded <= FloatEbmType { 1 };
+   const FloatEbmType sampleIndexBinsMax =
+      GetTempParam(optionalTempParams, TempParamBoostingSampleIndexBinsMax, FloatEbmType { 0 });
+   const size_t cSampleIndexBinsMax = !(FloatEbmType { 1 } <= sampleIndexBinsMax) ? size_t { 0 } :
+      static_cast<FloatEbmType>(std::numeric_limits<size_t>::max()) <= sampleIndexBinsMax ?
+      std::numeric_limits<size_t>::max() : static_cast<size_t>(sampleIndexBinsMax);
+
+   size_t cBytesDataSet = 0;
+   size_t cBytesHeap = 0;
+
+   size_t cBytesArrayEquivalentSplitMax = 0;
+   size_t cBytesThreadByteBuffer1Max = 0;
+   size_t cBytesThreadByteBuffer2Max = 0;
+   size_t cBytesShardHistogramBufferMax = 0;
+   size_t cBytesTreeNodeHeapMax = 0;
+   // the model tensors of every feature group once they are expanded, and the largest one, which the scratch
+   // tensors of each slot and bag grow to
+   size_t cBytesTensors = 0;
+   size_t cBytesTensorMax = 0;
+
+   if(0 != cFeatureGroups) {
+      if(GetSweepTreeNodeSizeOverflow(bClassification, cVectorLength) ||
+         GetHistogramBucketSizeOverflow(bClassification, cVectorLength) ||
+         GetTreeNodeSizeOverflow(bClassification, cVectorLength)
+      ) {
+         LOG_0(TraceLevelWarning, "WARNING EstimateBoostingMemory too many classes for us to allocate");
+         return IntEbmType { 1 };
+      }
+      const size_t cBytesPerSweepTreeNode = GetSweepTreeNodeSize(bClassification, cVectorLength);
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      const size_t cBytesPerTreeNode = GetTreeNodeSize(bClassification, cVectorLength);
+      const size_t cBytesPerTreeNodePointer = bClassification ? sizeof(TreeNode<true> *) : sizeof(TreeNode<false> *);
+
+      cBytesThreadByteBuffer1Max = cBytesPerHistogramBucket;
+      size_t cHistogramBucketsMax = 1;
+
+      const IntEbmType * pFeatureGroupIndex = featureGroupIndexes;
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const IntEbmType countFeaturesInGroup = featureGroups[iFeatureGroup].countFeaturesInGroup;
+         if(countFeaturesInGroup < 0 || !IsNumberConvertable<size_t>(countFeaturesInGroup)) {
+            LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory countFeaturesInGroup is not a valid count");
+            return IntEbmType { 1 };
+         }
+         const size_t cFeaturesInGroup = static_cast<size_t>(countFeaturesInGroup);
+         if(0 != cFeaturesInGroup && nullptr == pFeatureGroupIndex) {
+            LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory featureGroupIndexes cannot be nullptr when a feature group has features");
+            return IntEbmType { 1 };
+         }
+
+         size_t cSignificantFeaturesInGroup = 0;
+         size_t cTensorBins = 1;
+         size_t cEquivalentSplits = 1;
+         size_t cAuxillaryBucketsForBuildFastTotals = 0;
+         size_t cDivisions = 0;
+         bool bNominal = false;
+         for(size_t iFeatureInGroup = 0; iFeatureInGroup < cFeaturesInGroup; ++iFeatureInGroup) {
+            const IntEbmType indexFeature = *pFeatureGroupIndex;
+            ++pFeatureGroupIndex;
+            if(indexFeature < 0 || !IsNumberConvertable<size_t>(indexFeature) ||
+               cFeatures <= static_cast<size_t>(indexFeature)
+            ) {
+               LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory featureGroupIndexes value must be a feature index");
+               return IntEbmType { 1 };
+            }
+            const EbmNativeFeature * const pFeature = &features[static_cast<size_t>(indexFeature)];
+            if(pFeature->countBins < 0 || !IsNumberConvertable<size_t>(pFeature->countBins)) {
+               LOG_0(TraceLevelError, "ERROR EstimateBoostingMemory countBins is not a valid count");
+               return IntEbmType { 1 };
+            }
+            const size_t cBins = static_cast<size_t>(pFeature->countBins);
+            // features with a single bin drop out of their feature groups
+            if(1 < cBins) {
+               ++cSignificantFeaturesInGroup;
+               bNominal = FeatureTypeNominal == pFeature->featureType;
+               cAuxillaryBucketsForBuildFastTotals = AddSaturated(cAuxillaryBucketsForBuildFastTotals, cTensorBins);
+               cTensorBins = MultiplySaturated(cTensorBins, cBins);
+               cEquivalentSplits = MultiplySaturated(cEquivalentSplits, cBins - 1);
+               cDivisions += cBins - 1;
+            }
+         }
+         if(k_cDimensionsMax < cSignificantFeaturesInGroup) {
+            LOG_0(TraceLevelWarning, "WARNING EstimateBoostingMemory k_cDimensionsMax < cSignificantFeaturesInGroup");
+            return IntEbmType { 1 };
+         }
+
+         const size_t cBytesTensor = AddSaturated(
+            MultiplySaturated(MultiplySaturated(cTensorBins, cVectorLength), sizeof(FloatEbmType)),
+            MultiplySaturated(cDivisions, sizeof(ActiveDataType))
+         );
+         cBytesTensors = AddSaturated(cBytesTensors, cBytesTensor);
+         cBytesTensorMax = cBytesTensorMax < cBytesTensor ? cBytesTensor : cBytesTensorMax;
+
+         if(0 == cSignificantFeaturesInGroup) {
+            continue;
+         }
+
+         size_t cHistogramBuckets = cTensorBins;
+         if(1 == cSignificantFeaturesInGroup) {
+            const size_t cBytesArrayEquivalentSplit = MultiplySaturated(cEquivalentSplits, cBytesPerSweepTreeNode);
+            if(cBytesArrayEquivalentSplitMax < cBytesArrayEquivalentSplit) {
+               cBytesArrayEquivalentSplitMax = cBytesArrayEquivalentSplit;
+            }
+            const size_t cBytesTreeNodes = MultiplySaturated(cBytesPerTreeNode, MultiplySaturated(cTensorBins, 2) - 1);
+            if(cBytesThreadByteBuffer2Max < cBytesTreeNodes) {
+               cBytesThreadByteBuffer2Max = cBytesTreeNodes;
+            }
+            const size_t cBytesTreeNodeHeap = MultiplySaturated(cBytesPerTreeNodePointer, cTensorBins);
+            if(cBytesTreeNodeHeapMax < cBytesTreeNodeHeap) {
+               cBytesTreeNodeHeapMax = cBytesTreeNodeHeap;
+            }
+         } else {
+            const size_t cAuxillaryBucketsForSplitting = 24;
+            cHistogramBuckets = AddSaturated(cHistogramBuckets,
+               cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ?
+               cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals);
+         }
+         size_t cBytesHistogramBuckets = MultiplySaturated(cHistogramBuckets, cBytesPerHistogramBucket);
+         if(1 == cSignificantFeaturesInGroup && bNominal) {
+            if(GetNominalBucketScratchSizeOverflow(cBytesPerHistogramBucket, cVectorLength)) {
+               cBytesHistogramBuckets = std::numeric_limits<size_t>::max();
+            } else {
+               cBytesHistogramBuckets = AddSaturated(cBytesHistogramBuckets,
+                  MultiplySaturated(cTensorBins, GetNominalBucketScratchSize(cBytesPerHistogramBucket, cVectorLength)));
+            }
+         }
+         if(cBytesThreadByteBuffer1Max < cBytesHistogramBuckets) {
+            cBytesThreadByteBuffer1Max = cBytesHistogramBuckets;
+         }
+         if(cHistogramBucketsMax < cTensorBins) {
+            cHistogramBucketsMax = cTensorBins;
+         }
+
+         // the bit packing of this group, which CreatePackedData would also pick
+         size_t cItemsPerBitPackedDataUnit = GetCountItemsBitPacked(CountBitsRequired(cTensorBins - 1));
+         if(FloatEbmType { 0 } != alignedPackingGrowthMax) {
+            const size_t cItemsAligned = GetCountItemsBitPackedAligned(CountBitsRequired(cTensorBins - 1));
+            if(static_cast<FloatEbmType>(cItemsPerBitPackedDataUnit) <=
+               alignedPackingGrowthMax * static_cast<FloatEbmType>(cItemsAligned)
+            ) {
+               cItemsPerBitPackedDataUnit = cItemsAligned;
+            }
+         }
+         if(0 != cTrainingSamples) {
+            const size_t cDataUnits = (cTrainingSamples - 1) / cItemsPerBitPackedDataUnit + 1;
+            cBytesDataSet = AddSaturated(cBytesDataSet,
+               GetAlignedBytes(MemorySubsystem::DataSet, cDataUnits, sizeof(StorageDataType)));
+            if(1 == cSignificantFeaturesInGroup && cTensorBins <= cSampleIndexBinsMax) {
+               cBytesHeap = AddSaturated(cBytesHeap,
+                  MultiplySaturated(AddSaturated(cTensorBins + 1, cTrainingSamples), sizeof(size_t)));
+            }
+         }
+         if(0 != cValidationSamples) {
+            const size_t cDataUnits = (cValidationSamples - 1) / cItemsPerBitPackedDataUnit + 1;
+            cBytesDataSet = AddSaturated(cBytesDataSet,
+               GetAlignedBytes(MemorySubsystem::DataSet, cDataUnits, sizeof(StorageDataType)));
+         }
+      }
+
+      if(size_t { 1 } < cShards) {
+         const size_t cBytesPerHistogram = MultiplySaturated(cHistogramBucketsMax, cBytesPerHistogramBucket);
+         // EbmBoostingState::Allocate leaves out the shard copies if they overflow
+         if(!IsMultiplyError(cBytesPerHistogram, cShards - 1)) {
+            cBytesShardHistogramBufferMax = cBytesPerHistogram * (cShards - 1);
+         }
+      }
+
+      if(!bClassification || ptrdiff_t { 2 } <= runtimeLearningTypeOrCountTargetClasses) {
+         // the current and best models, and the updates that we hold back for the validation set
+         cBytesHeap = AddSaturated(cBytesHeap, MultiplySaturated(cBytesTensors, bDeferValidation ? size_t { 3 } : size_t { 2 }));
+      }
+   }
+
+   const size_t cCachedThreadResources = MultiplySaturated(0 == cInnerBags ? size_t { 1 } : cInnerBags, cSlots);
+   const size_t cBytesArena = AddSaturated(
+      AddSaturated(GetArenaBufferSizeSaturated(cBytesThreadByteBuffer1Max), GetArenaBufferSizeSaturated(cBytesThreadByteBuffer2Max)),
+      AddSaturated(GetArenaBufferSizeSaturated(cBytesShardHistogramBufferMax), GetArenaBufferSizeSaturated(cBytesTreeNodeHeapMax))
+   );
+   const size_t cBytesThreadBuffers =
+      MultiplySaturated(cCachedThreadResources, GetAlignedMallocBytes(MemorySubsystem::ThreadBuffers, cBytesArena));
+   // each bag keeps its equivalent splits and an update tensor, and each slot accumulates the updates of its bags
+   cBytesHeap = AddSaturated(cBytesHeap, MultiplySaturated(cCachedThreadResources,
+      AddSaturated(cBytesArrayEquivalentSplitMax, cBytesTensorMax)));
+   cBytesHeap = AddSaturated(cBytesHeap, MultiplySaturated(cSlots, cBytesTensorMax));
+
+   if(0 != cTrainingSamples) {
+      const size_t cValues = MultiplySaturated(cTrainingSamples, cVectorLength);
+      const size_t cBytesResiduals = GetAlignedBytes(MemorySubsystem::DataSet, cValues, cBytesTrainingFloat);
+      size_t cBytesTraining = cBytesResiduals;
+      if(bCacheDenominators) {
+         cBytesTraining = AddSaturated(cBytesTraining, cBytesResiduals);
+      }
+      if(bClassification) {
+         // predictor scores and targets
+         cBytesTraining = AddSaturated(cBytesTraining, cBytesResiduals);
+         cBytesTraining = AddSaturated(cBytesTraining,
+            GetAlignedBytes(MemorySubsystem::DataSet, cTrainingSamples, sizeof(StorageDataType)));
+      }
+      // the class-major transpose holds new residuals and scores before it frees the old ones
+      if(bClassMajor) {
+         cBytesTraining = AddSaturated(cBytesTraining, AddSaturated(cBytesResiduals, cBytesResiduals));
+      }
+      cBytesDataSet = AddSaturated(cBytesDataSet, cBytesTraining);
+
+      // bags without replacement are a bit per sample, and bags with replacement a count per sample.  Without any
+      // bags we boost on the flat training set, which needs no per sample storage
+      if(0 != cInnerBags) {
+         const size_t cBytesBag = bWithoutReplacement ?
+            ((cTrainingSamples - 1) / k_cBitsForSizeT + 1) * sizeof(size_t) : MultiplySaturated(cTrainingSamples, sizeof(size_t));
+         cBytesHeap = AddSaturated(cBytesHeap, MultiplySaturated(cInnerBags, cBytesBag));
+      }
+   }
+
+   if(0 != cValidationSamples) {
+      const size_t cValues = MultiplySaturated(cValidationSamples, cVectorLength);
+      // the validation set keeps residuals for regression and scores for classification, always in FloatEbmType
+      cBytesDataSet = AddSaturated(cBytesDataSet, GetAlignedBytes(MemorySubsystem::DataSet, cValues, sizeof(FloatEbmType)));
+      if(bClassification) {
+         cBytesDataSet = AddSaturated(cBytesDataSet,
+            GetAlignedBytes(MemorySubsystem::DataSet, cValidationSamples, sizeof(StorageDataType)));
+      }
+   }
+
+   for(IntEbmType iItem = 0; iItem < MemoryEstimateCountItems; ++iItem) {
+      countBytesOut[iItem] = 0;
+   }
+   countBytesOut[MemorySubsystemDataSet] = IsNumberConvertable<IntEbmType>(cBytesDataSet) ?
+      static_cast<IntEbmType>(cBytesDataSet) : std::numeric_limits<IntEbmType>::max();
+   countBytesOut[MemorySubsystemThreadBuffers] = IsNumberConvertable<IntEbmType>(cBytesThreadBuffers) ?
+      static_cast<IntEbmType>(cBytesThreadBuffers) : std::numeric_limits<IntEbmType>::max();
+   countBytesOut[MemoryEstimateHeap] = IsNumberConvertable<IntEbmType>(cBytesHeap) ?
+      static_cast<IntEbmType>(cBytesHeap) : std::numeric_limits<IntEbmType>::max();
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION EstimateBoostingMemoryClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   IntEbmType countValidationSamples,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   IntEbmType * countBytesOut
+) {
+   LOG_N(TraceLevelInfo, "Entered EstimateBoostingMemoryClassification: countTargetClasses=%" IntEbmTypePrintf
+      ", countFeatures=%" IntEbmTypePrintf ", features=%p, countFeatureGroups=%" IntEbmTypePrintf
+      ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%" IntEbmTypePrintf
+      ", countValidationSamples=%" IntEbmTypePrintf ", countInnerBags=%" IntEbmTypePrintf
+      ", optionalTempParams=%p, countBytesOut=%p",
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(features),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      countTrainingSamples,
+      countValidationSamples,
+      countInnerBags,
+      static_cast<const void *>(optionalTempParams),
+      static_cast<void *>(countBytesOut)
+   );
+   if(countTargetClasses < 0) {
+      LOG_0(TraceLevelError, "ERROR EstimateBoostingMemoryClassification countTargetClasses can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING EstimateBoostingMemoryClassification !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return IntEbmType { 1 };
+   }
+   return EstimateBoostingMemory(
+      static_cast<ptrdiff_t>(countTargetClasses),
+      countFeatures,
+      features,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      countTrainingSamples,
+      countValidationSamples,
+      countInnerBags,
+      optionalTempParams,
+      countBytesOut
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION EstimateBoostingMemoryRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   IntEbmType countValidationSamples,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   IntEbmType * countBytesOut
+) {
+   LOG_N(TraceLevelInfo, "Entered EstimateBoostingMemoryRegression: countFeatures=%" IntEbmTypePrintf
+      ", features=%p, countFeatureGroups=%" IntEbmTypePrintf ", featureGroups=%p, featureGroupIndexes=%p, countTrainingSamples=%"
+      IntEbmTypePrintf ", countValidationSamples=%" IntEbmTypePrintf ", countInnerBags=%" IntEbmTypePrintf
+      ", optionalTempParams=%p, countBytesOut=%p",
+      countFeatures,
+      static_cast<const void *>(features),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      countTrainingSamples,
+      countValidationSamples,
+      countInnerBags,
+      static_cast<const void *>(optionalTempParams),
+      static_cast<void *>(countBytesOut)
+   );
+   return EstimateBoostingMemory(
+      k_regression,
+      countFeatures,
+      features,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      countTrainingSamples,
+      countValidationSamples,
+      countInnerBags,
+      optionalTempParams,
+      countBytesOut
+   );
+}
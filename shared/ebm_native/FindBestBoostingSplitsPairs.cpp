@@ -4,7 +4,11 @@
 
 #include "PrecompiledHeader.h"
 
+#include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+#include <limits> // numeric_limits
+#include <algorithm> // min
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
@@ -21,6 +25,7 @@
 #include "Booster.h"
 
 #include "TensorTotalsSum.h"
+#include "ThreadPool.h"
 
 template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 static FloatEbmType SweepMultiDiemensional(
@@ -36,6 +41,7 @@ static FloatEbmType SweepMultiDiemensional(
 #ifndef NDEBUG
    , const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy
    , const unsigned char * const aHistogramBucketsEndDebug
+   , const unsigned char * const pHistogramBucketBestAndTempEndDebug
 #endif // NDEBUG
 ) {
    constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
@@ -69,11 +75,11 @@ static FloatEbmType SweepMultiDiemensional(
 
    HistogramBucket<bClassification> * const pTotalsLow =
       GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketBestAndTemp, 2);
-   ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsLow, aHistogramBucketsEndDebug);
+   ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsLow, pHistogramBucketBestAndTempEndDebug);
 
    HistogramBucket<bClassification> * const pTotalsHigh =
       GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketBestAndTemp, 3);
-   ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsHigh, aHistogramBucketsEndDebug);
+   ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pTotalsHigh, pHistogramBucketBestAndTempEndDebug);
 
    EBM_ASSERT(0 < cSamplesRequiredForChildSplitMin);
 
@@ -82,7 +88,7 @@ static FloatEbmType SweepMultiDiemensional(
    do {
       *piBin = iBin;
 
-      TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+      TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bClassification>(
          runtimeLearningTypeOrCountTargetClasses,
          pFeatureGroup,
          aHistogramBuckets,
@@ -95,7 +101,7 @@ static FloatEbmType SweepMultiDiemensional(
 #endif // NDEBUG
          );
       if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsLow->GetCountSamplesInBucket())) {
-         TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+         TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bClassification>(
             runtimeLearningTypeOrCountTargetClasses,
             pFeatureGroup,
             aHistogramBuckets,
@@ -150,12 +156,12 @@ static FloatEbmType SweepMultiDiemensional(
                      pHistogramBucketBestAndTemp,
                      1
                      ),
-                  aHistogramBucketsEndDebug
+                  pHistogramBucketBestAndTempEndDebug
                );
                ASSERT_BINNED_BUCKET_OK(
                   cBytesPerHistogramBucket,
                   GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pTotalsLow, 1),
-                  aHistogramBucketsEndDebug
+                  pHistogramBucketBestAndTempEndDebug
                );
                memcpy(pHistogramBucketBestAndTemp, pTotalsLow, cBytesPerTwoHistogramBuckets); // this copies both pTotalsLow and pTotalsHigh
             } else {
@@ -171,6 +177,349 @@ static FloatEbmType SweepMultiDiemensional(
    return bestSplit;
 }
 
+// the cut combinations that we evaluate for each cut of the first dimension.  SweepPairCuts writes the totals of the 4 
+// quadrants of it's best combination into the first of these scratch buckets, and SweepMultiDiemensional uses the rest
+constexpr size_t k_cPairSweepScratchBuckets = 12;
+
+// sweeps the cuts [iCutBegin, iCutEnd) of dimension iDimensionCut, and for each of them the best cut of the other 
+// dimension on either side.  aiBestCutsOut gets the first cut, then the low and high side cuts of the best combination
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+static FloatEbmType SweepPairCuts(
+   const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets,
+   const FeatureGroup * const pFeatureGroup,
+   const unsigned int iDimensionCut,
+   const size_t iCutBegin,
+   const size_t iCutEnd,
+   const size_t cSamplesRequiredForChildSplitMin,
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pHistogramBucketScratch,
+   size_t * const aiBestCutsOut
+#ifndef NDEBUG
+   , const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+   , const unsigned char * const pHistogramBucketScratchEndDebug
+#endif // NDEBUG
+) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+   EBM_ASSERT(iDimensionCut <= 1);
+   EBM_ASSERT(iCutBegin < iCutEnd);
+
+   const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+      compilerLearningTypeOrCountTargetClasses,
+      runtimeLearningTypeOrCountTargetClasses
+   );
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
+   const unsigned int iDimensionSweep = 0 == iDimensionCut ? 1 : 0;
+   const size_t directionVectorHigh = size_t { 1 } << iDimensionCut;
+
+   HistogramBucket<bClassification> * const pTotalsLowLowBest =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 0);
+   HistogramBucket<bClassification> * const pTotalsLowHighBest =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 1);
+   HistogramBucket<bClassification> * const pTotalsHighLowBest =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 2);
+   HistogramBucket<bClassification> * const pTotalsHighHighBest =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 3);
+   HistogramBucket<bClassification> * const pTotalsLowLow =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 4);
+   HistogramBucket<bClassification> * const pTotalsLowHigh =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 5);
+   HistogramBucket<bClassification> * const pTotalsHighLow =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 8);
+   HistogramBucket<bClassification> * const pTotalsHighHigh =
+      GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, 9);
+
+   size_t aiStart[k_cDimensionsMax];
+
+   FloatEbmType bestSplittingScore = k_illegalGain;
+   size_t iCut = iCutBegin;
+   do {
+      aiStart[iDimensionCut] = iCut;
+
+      size_t cutSecondLowBest;
+      const FloatEbmType splittingScoreNew1 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
+         aHistogramBuckets,
+         pFeatureGroup,
+         aiStart,
+         0x0,
+         iDimensionSweep,
+         cSamplesRequiredForChildSplitMin,
+         runtimeLearningTypeOrCountTargetClasses,
+         pTotalsLowLow,
+         &cutSecondLowBest
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
+         , pHistogramBucketScratchEndDebug
+#endif // NDEBUG
+         );
+
+      // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are all
+      // false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, no big deal.  
+      // NaN values will get us soon and shut down boosting.
+      if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/ !(k_illegalGain == splittingScoreNew1))) {
+         EBM_ASSERT(std::isnan(splittingScoreNew1) || FloatEbmType { 0 } <= splittingScoreNew1);
+
+         size_t cutSecondHighBest;
+         const FloatEbmType splittingScoreNew2 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
+            aHistogramBuckets,
+            pFeatureGroup,
+            aiStart,
+            directionVectorHigh,
+            iDimensionSweep,
+            cSamplesRequiredForChildSplitMin,
+            runtimeLearningTypeOrCountTargetClasses,
+            pTotalsHighLow,
+            &cutSecondHighBest
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+            , pHistogramBucketScratchEndDebug
+#endif // NDEBUG
+            );
+         // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are 
+         // all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
+         // no big deal.  NaN values will get us soon and shut down boosting.
+         if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
+            !(k_illegalGain == splittingScoreNew2))) {
+            EBM_ASSERT(std::isnan(splittingScoreNew2) || FloatEbmType { 0 } <= splittingScoreNew2);
+            const FloatEbmType splittingScore = splittingScoreNew1 + splittingScoreNew2;
+
+            // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons 
+            // are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
+            // no big deal.  NaN values will get us soon and shut down boosting.
+            if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
+               !(splittingScore <= bestSplittingScore))) {
+               bestSplittingScore = splittingScore;
+               aiBestCutsOut[0] = iCut;
+               aiBestCutsOut[1] = cutSecondLowBest;
+               aiBestCutsOut[2] = cutSecondHighBest;
+
+               pTotalsLowLowBest->Copy(*pTotalsLowLow, cVectorLength);
+               pTotalsLowHighBest->Copy(*pTotalsLowHigh, cVectorLength);
+               pTotalsHighLowBest->Copy(*pTotalsHighLow, cVectorLength);
+               pTotalsHighHighBest->Copy(*pTotalsHighHigh, cVectorLength);
+            } else {
+               EBM_ASSERT(!std::isnan(splittingScore));
+            }
+         } else {
+            EBM_ASSERT(!std::isnan(splittingScoreNew2));
+            EBM_ASSERT(k_illegalGain == splittingScoreNew2);
+         }
+      } else {
+         EBM_ASSERT(!std::isnan(splittingScoreNew1));
+         EBM_ASSERT(k_illegalGain == splittingScoreNew1);
+      }
+      ++iCut;
+   } while(iCut < iCutEnd);
+   return bestSplittingScore;
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class PairSweepContext final {
+public:
+   const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * m_aHistogramBuckets;
+   const FeatureGroup * m_pFeatureGroup;
+   unsigned int m_iDimensionCut;
+   size_t m_cCuts;
+   size_t m_cTasks;
+   size_t m_cSamplesRequiredForChildSplitMin;
+   ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
+   size_t m_cBytesPerHistogramBucket;
+   // each task gets k_cPairSweepScratchBuckets buckets of it's own
+   HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * m_aHistogramBucketsScratch;
+   FloatEbmType * m_aBestSplittingScores;
+   // 3 cuts per task in the order of SweepPairCuts
+   size_t * m_aiBestCuts;
+#ifndef NDEBUG
+   const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * m_aHistogramBucketsDebugCopy;
+   const unsigned char * m_aHistogramBucketsEndDebug;
+#endif // NDEBUG
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+static void PairSweepTask(void * const pContext, const size_t iTask) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+   // each task sweeps a contiguous range of the cuts with it's own scratch buckets, and only reads the histogram
+   const PairSweepContext<compilerLearningTypeOrCountTargetClasses> * const pPairSweepContext = 
+      static_cast<const PairSweepContext<compilerLearningTypeOrCountTargetClasses> *>(pContext);
+
+   const size_t cCuts = pPairSweepContext->m_cCuts;
+   const size_t cTasks = pPairSweepContext->m_cTasks;
+   EBM_ASSERT(iTask < cTasks);
+   EBM_ASSERT(cTasks <= cCuts);
+   // cCuts is below the number of bins of a feature, so none of these multiplications can overflow
+   const size_t iCutBegin = cCuts * iTask / cTasks;
+   const size_t iCutEnd = cCuts * (iTask + 1) / cTasks;
+
+   HistogramBucket<bClassification> * const pHistogramBucketScratch = GetHistogramBucketByIndex<bClassification>(
+      pPairSweepContext->m_cBytesPerHistogramBucket,
+      pPairSweepContext->m_aHistogramBucketsScratch,
+      iTask * k_cPairSweepScratchBuckets
+   );
+
+   pPairSweepContext->m_aBestSplittingScores[iTask] = SweepPairCuts<compilerLearningTypeOrCountTargetClasses>(
+      pPairSweepContext->m_aHistogramBuckets,
+      pPairSweepContext->m_pFeatureGroup,
+      pPairSweepContext->m_iDimensionCut,
+      iCutBegin,
+      iCutEnd,
+      pPairSweepContext->m_cSamplesRequiredForChildSplitMin,
+      pPairSweepContext->m_runtimeLearningTypeOrCountTargetClasses,
+      pHistogramBucketScratch,
+      &pPairSweepContext->m_aiBestCuts[iTask * 3]
+#ifndef NDEBUG
+      , pPairSweepContext->m_aHistogramBucketsDebugCopy
+      , pPairSweepContext->m_aHistogramBucketsEndDebug
+      , reinterpret_cast<const unsigned char *>(pHistogramBucketScratch) + 
+         pPairSweepContext->m_cBytesPerHistogramBucket * k_cPairSweepScratchBuckets
+#endif // NDEBUG
+   );
+}
+
+// sweeps every cut of dimension iDimensionCut and keeps the best combination if it beats *pBestSplittingScore, in 
+// which case the totals of it's 4 quadrants are in the first 4 buckets of pHistogramBucketScratch.  Large pairs are 
+// split into contiguous ranges of cuts that run on the thread pool.  We merge the ranges in cut order and only take 
+// strictly better scores, so we keep the same combination that a serial sweep would.  Returns true if we kept one
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+static bool SweepPairDimension(
+   const EbmBoostingState * const pEbmBoostingState,
+   const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets,
+   const FeatureGroup * const pFeatureGroup,
+   const unsigned int iDimensionCut,
+   const size_t cSamplesRequiredForChildSplitMin,
+   HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pHistogramBucketScratch,
+   FloatEbmType * const pBestSplittingScore,
+   size_t * const aiBestCutsOut
+#ifndef NDEBUG
+   , const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+      compilerLearningTypeOrCountTargetClasses,
+      runtimeLearningTypeOrCountTargetClasses
+   );
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
+   const size_t cBinsCut = pFeatureGroup->GetFeatureGroupEntries()[iDimensionCut].m_pFeature->GetCountBins();
+   const size_t cBinsSweep = pFeatureGroup->GetFeatureGroupEntries()[0 == iDimensionCut ? 1 : 0].m_pFeature->GetCountBins();
+   EBM_ASSERT(2 <= cBinsCut);
+   EBM_ASSERT(2 <= cBinsSweep);
+   const size_t cCuts = cBinsCut - 1;
+
+   const size_t cPairCutsPerTask = pEbmBoostingState->GetCountPairCutsPerTask();
+   EBM_ASSERT(1 <= cPairCutsPerTask);
+   const size_t cCombinations = IsMultiplyError(cCuts, cBinsSweep - 1) ? 
+      std::numeric_limits<size_t>::max() : cCuts * (cBinsSweep - 1);
+   size_t cTasks = std::min(std::min(cCombinations / cPairCutsPerTask, cCuts), ThreadPool::GetCountThreads());
+
+   HistogramBucket<bClassification> * aHistogramBucketsScratch = nullptr;
+   FloatEbmType * aBestSplittingScores = nullptr;
+   size_t * aiBestCuts = nullptr;
+   if(2 <= cTasks) {
+      // cTasks is at most the number of threads, so none of these multiplications can overflow
+      aHistogramBucketsScratch = EbmMalloc<HistogramBucket<bClassification>>(
+         cTasks * k_cPairSweepScratchBuckets, 
+         cBytesPerHistogramBucket
+      );
+      aBestSplittingScores = EbmMalloc<FloatEbmType>(cTasks);
+      aiBestCuts = EbmMalloc<size_t>(cTasks * 3);
+      if(UNLIKELY(nullptr == aHistogramBucketsScratch || nullptr == aBestSplittingScores || nullptr == aiBestCuts)) {
+         // the serial sweep needs no memory of it's own, so we can still find the same cuts
+         LOG_0(TraceLevelWarning, "WARNING SweepPairDimension out of memory.  Sweeping serially");
+         cTasks = 1;
+      }
+   }
+
+   bool bKept = false;
+   if(cTasks < 2) {
+      size_t aiCuts[3];
+      const FloatEbmType splittingScore = SweepPairCuts<compilerLearningTypeOrCountTargetClasses>(
+         aHistogramBuckets,
+         pFeatureGroup,
+         iDimensionCut,
+         0,
+         cCuts,
+         cSamplesRequiredForChildSplitMin,
+         runtimeLearningTypeOrCountTargetClasses,
+         pHistogramBucketScratch,
+         aiCuts
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+      // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons 
+      // are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
+      // no big deal.  NaN values will get us soon and shut down boosting.
+      if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
+         !(splittingScore <= *pBestSplittingScore))) {
+         *pBestSplittingScore = splittingScore;
+         memcpy(aiBestCutsOut, aiCuts, sizeof(aiCuts));
+         bKept = true;
+      }
+   } else {
+      PairSweepContext<compilerLearningTypeOrCountTargetClasses> pairSweepContext;
+      pairSweepContext.m_aHistogramBuckets = aHistogramBuckets;
+      pairSweepContext.m_pFeatureGroup = pFeatureGroup;
+      pairSweepContext.m_iDimensionCut = iDimensionCut;
+      pairSweepContext.m_cCuts = cCuts;
+      pairSweepContext.m_cTasks = cTasks;
+      pairSweepContext.m_cSamplesRequiredForChildSplitMin = cSamplesRequiredForChildSplitMin;
+      pairSweepContext.m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+      pairSweepContext.m_cBytesPerHistogramBucket = cBytesPerHistogramBucket;
+      pairSweepContext.m_aHistogramBucketsScratch = aHistogramBucketsScratch;
+      pairSweepContext.m_aBestSplittingScores = aBestSplittingScores;
+      pairSweepContext.m_aiBestCuts = aiBestCuts;
+#ifndef NDEBUG
+      pairSweepContext.m_aHistogramBucketsDebugCopy = aHistogramBucketsDebugCopy;
+      pairSweepContext.m_aHistogramBucketsEndDebug = aHistogramBucketsEndDebug;
+#endif // NDEBUG
+
+      ThreadPool::ParallelFor(cTasks, PairSweepTask<compilerLearningTypeOrCountTargetClasses>, &pairSweepContext);
+
+      for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+         const FloatEbmType splittingScore = aBestSplittingScores[iTask];
+         // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons 
+         // are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
+         // no big deal.  NaN values will get us soon and shut down boosting.
+         if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
+            !(splittingScore <= *pBestSplittingScore))) {
+            *pBestSplittingScore = splittingScore;
+            memcpy(aiBestCutsOut, &aiBestCuts[iTask * 3], sizeof(*aiBestCuts) * 3);
+
+            const HistogramBucket<bClassification> * const pTaskScratch = GetHistogramBucketByIndex<bClassification>(
+               cBytesPerHistogramBucket,
+               aHistogramBucketsScratch,
+               iTask * k_cPairSweepScratchBuckets
+            );
+            for(size_t iQuadrant = 0; iQuadrant < 4; ++iQuadrant) {
+               GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketScratch, iQuadrant)->Copy(
+                  *GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pTaskScratch, iQuadrant),
+                  cVectorLength
+               );
+            }
+            bKept = true;
+         }
+      }
+   }
+
+   free(aHistogramBucketsScratch);
+   free(aBestSplittingScores);
+   free(aiBestCuts);
+   return bKept;
+}
+
 template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 class FindBestBoostingSplitPairsInternal final {
 public:
@@ -196,8 +545,6 @@ public:
    ) {
       constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
 
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
-
       const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
          compilerLearningTypeOrCountTargetClasses,
          pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()
@@ -214,21 +561,8 @@ public:
       const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy = aHistogramBucketsDebugCopyBase->GetHistogramBucket<bClassification>();
 #endif // NDEBUG
 
-      size_t aiStart[k_cDimensionsMax];
-
-      FloatEbmType splittingScore;
-
-      const size_t cBinsDimension1 = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
-      const size_t cBinsDimension2 = pFeatureGroup->GetFeatureGroupEntries()[1].m_pFeature->GetCountBins();
-      EBM_ASSERT(2 <= cBinsDimension1);
-      EBM_ASSERT(2 <= cBinsDimension2);
-
       FloatEbmType bestSplittingScore = k_illegalGain;
 
-      size_t cutFirst1Best;
-      size_t cutFirst1LowBest;
-      size_t cutFirst1HighBest;
-
       HistogramBucket<bClassification> * pTotals1LowLowBest =
          GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 0);
       HistogramBucket<bClassification> * pTotals1LowHighBest =
@@ -263,101 +597,24 @@ public:
       EBM_ASSERT(std::isnan(splittingScoreParent) || FloatEbmType { 0 } <= splittingScoreParent); // sumation of positive numbers should be positive
 
       LOG_0(TraceLevelVerbose, "BoostMultiDimensional Starting FIRST bin sweep loop");
-      size_t iBin1 = 0;
-      do {
-         aiStart[0] = iBin1;
-
-         splittingScore = FloatEbmType { 0 };
-
-         size_t cutSecond1LowBest;
-         HistogramBucket<bClassification> * pTotals2LowLowBest =
-            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 4);
-         HistogramBucket<bClassification> * pTotals2LowHighBest =
-            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 5);
-         const FloatEbmType splittingScoreNew1 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
-            aHistogramBuckets,
-            pFeatureGroup,
-            aiStart,
-            0x0,
-            1,
-            cSamplesRequiredForChildSplitMin,
-            runtimeLearningTypeOrCountTargetClasses,
-            pTotals2LowLowBest,
-            &cutSecond1LowBest
-#ifndef NDEBUG
-            , aHistogramBucketsDebugCopy
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-            );
-
-         // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are all
-         // false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, no big deal.  
-         // NaN values will get us soon and shut down boosting.
-         if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/ !(k_illegalGain == splittingScoreNew1))) {
-            EBM_ASSERT(std::isnan(splittingScoreNew1) || FloatEbmType { 0 } <= splittingScoreNew1);
-            splittingScore += splittingScoreNew1;
-
-            size_t cutSecond1HighBest;
-            HistogramBucket<bClassification> * pTotals2HighLowBest =
-               GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 8);
-            HistogramBucket<bClassification> * pTotals2HighHighBest =
-               GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 9);
-            const FloatEbmType splittingScoreNew2 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
-               aHistogramBuckets,
-               pFeatureGroup,
-               aiStart,
-               0x1,
-               1,
-               cSamplesRequiredForChildSplitMin,
-               runtimeLearningTypeOrCountTargetClasses,
-               pTotals2HighLowBest,
-               &cutSecond1HighBest
+      size_t aiCutsFirst1[3] = { 0, 0, 0 };
+      SweepPairDimension<compilerLearningTypeOrCountTargetClasses>(
+         pEbmBoostingState,
+         aHistogramBuckets,
+         pFeatureGroup,
+         0,
+         cSamplesRequiredForChildSplitMin,
+         pTotals1LowLowBest,
+         &bestSplittingScore,
+         aiCutsFirst1
 #ifndef NDEBUG
-               , aHistogramBucketsDebugCopy
-               , aHistogramBucketsEndDebug
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
 #endif // NDEBUG
-               );
-            // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are 
-            // all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
-            // no big deal.  NaN values will get us soon and shut down boosting.
-            if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
-               !(k_illegalGain == splittingScoreNew2))) {
-               EBM_ASSERT(std::isnan(splittingScoreNew2) || FloatEbmType { 0 } <= splittingScoreNew2);
-               splittingScore += splittingScoreNew2;
-
-               // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons 
-               // are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
-               // no big deal.  NaN values will get us soon and shut down boosting.
-               if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
-                  !(splittingScore <= bestSplittingScore))) {
-                  bestSplittingScore = splittingScore;
-                  cutFirst1Best = iBin1;
-                  cutFirst1LowBest = cutSecond1LowBest;
-                  cutFirst1HighBest = cutSecond1HighBest;
-
-                  pTotals1LowLowBest->Copy(*pTotals2LowLowBest, cVectorLength);
-                  pTotals1LowHighBest->Copy(*pTotals2LowHighBest, cVectorLength);
-                  pTotals1HighLowBest->Copy(*pTotals2HighLowBest, cVectorLength);
-                  pTotals1HighHighBest->Copy(*pTotals2HighHighBest, cVectorLength);
-               } else {
-                  EBM_ASSERT(!std::isnan(splittingScore));
-               }
-            } else {
-               EBM_ASSERT(!std::isnan(splittingScoreNew2));
-               EBM_ASSERT(k_illegalGain == splittingScoreNew2);
-            }
-         } else {
-            EBM_ASSERT(!std::isnan(splittingScoreNew1));
-            EBM_ASSERT(k_illegalGain == splittingScoreNew1);
-         }
-         ++iBin1;
-      } while(iBin1 < cBinsDimension1 - 1);
-
-      bool bCutFirst2 = false;
-
-      size_t cutFirst2Best;
-      size_t cutFirst2LowBest;
-      size_t cutFirst2HighBest;
+      );
+      const size_t cutFirst1Best = aiCutsFirst1[0];
+      const size_t cutFirst1LowBest = aiCutsFirst1[1];
+      const size_t cutFirst1HighBest = aiCutsFirst1[2];
 
       HistogramBucket<bClassification> * pTotals2LowLowBest =
          GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 12);
@@ -369,96 +626,25 @@ public:
          GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 15);
 
       LOG_0(TraceLevelVerbose, "BoostMultiDimensional Starting SECOND bin sweep loop");
-      size_t iBin2 = 0;
-      do {
-         aiStart[1] = iBin2;
-
-         splittingScore = FloatEbmType { 0 };
-
-         size_t cutSecond2LowBest;
-         HistogramBucket<bClassification> * pTotals1LowLowBestInner =
-            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 16);
-         HistogramBucket<bClassification> * pTotals1LowHighBestInner =
-            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 17);
-         const FloatEbmType splittingScoreNew1 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
-            aHistogramBuckets,
-            pFeatureGroup,
-            aiStart,
-            0x0,
-            0,
-            cSamplesRequiredForChildSplitMin,
-            runtimeLearningTypeOrCountTargetClasses,
-            pTotals1LowLowBestInner,
-            &cutSecond2LowBest
-#ifndef NDEBUG
-            , aHistogramBucketsDebugCopy
-            , aHistogramBucketsEndDebug
-#endif // NDEBUG
-            );
-
-         // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are 
-         // all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, no big deal.
-         // NaN values will get us soon and shut down boosting.
-         if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/ !(k_illegalGain == splittingScoreNew1))) {
-            EBM_ASSERT(std::isnan(splittingScoreNew1) || FloatEbmType { 0 } <= splittingScoreNew1);
-            splittingScore += splittingScoreNew1;
-
-            size_t cutSecond2HighBest;
-            HistogramBucket<bClassification> * pTotals1HighLowBestInner =
-               GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 20);
-            HistogramBucket<bClassification> * pTotals1HighHighBestInner =
-               GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 21);
-            const FloatEbmType splittingScoreNew2 = SweepMultiDiemensional<compilerLearningTypeOrCountTargetClasses>(
-               aHistogramBuckets,
-               pFeatureGroup,
-               aiStart,
-               0x2,
-               0,
-               cSamplesRequiredForChildSplitMin,
-               runtimeLearningTypeOrCountTargetClasses,
-               pTotals1HighLowBestInner,
-               &cutSecond2HighBest
+      // this only keeps a cut of the second dimension if it's strictly better than the best cut of the first
+      size_t aiCutsFirst2[3] = { 0, 0, 0 };
+      const bool bCutFirst2 = SweepPairDimension<compilerLearningTypeOrCountTargetClasses>(
+         pEbmBoostingState,
+         aHistogramBuckets,
+         pFeatureGroup,
+         1,
+         cSamplesRequiredForChildSplitMin,
+         pTotals2LowLowBest,
+         &bestSplittingScore,
+         aiCutsFirst2
 #ifndef NDEBUG
-               , aHistogramBucketsDebugCopy
-               , aHistogramBucketsEndDebug
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
 #endif // NDEBUG
-               );
-            // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are 
-            // all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
-            // no big deal.  NaN values will get us soon and shut down boosting.
-            if(LIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
-               !(k_illegalGain == splittingScoreNew2))) {
-               EBM_ASSERT(std::isnan(splittingScoreNew2) || FloatEbmType { 0 } <= splittingScoreNew2);
-               splittingScore += splittingScoreNew2;
-               // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons 
-               // are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates NaN comparions rules, 
-               // no big deal.  NaN values will get us soon and shut down boosting.
-               if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
-                  !(splittingScore <= bestSplittingScore))) {
-                  bestSplittingScore = splittingScore;
-                  cutFirst2Best = iBin2;
-                  cutFirst2LowBest = cutSecond2LowBest;
-                  cutFirst2HighBest = cutSecond2HighBest;
-
-                  pTotals2LowLowBest->Copy(*pTotals1LowLowBestInner, cVectorLength);
-                  pTotals2LowHighBest->Copy(*pTotals1LowHighBestInner, cVectorLength);
-                  pTotals2HighLowBest->Copy(*pTotals1HighLowBestInner, cVectorLength);
-                  pTotals2HighHighBest->Copy(*pTotals1HighHighBestInner, cVectorLength);
-
-                  bCutFirst2 = true;
-               } else {
-                  EBM_ASSERT(!std::isnan(splittingScore));
-               }
-            } else {
-               EBM_ASSERT(!std::isnan(splittingScoreNew2));
-               EBM_ASSERT(k_illegalGain == splittingScoreNew2);
-            }
-         } else {
-            EBM_ASSERT(!std::isnan(splittingScoreNew1));
-            EBM_ASSERT(k_illegalGain == splittingScoreNew1);
-         }
-         ++iBin2;
-      } while(iBin2 < cBinsDimension2 - 1);
+      );
+      const size_t cutFirst2Best = aiCutsFirst2[0];
+      const size_t cutFirst2LowBest = aiCutsFirst2[1];
+      const size_t cutFirst2HighBest = aiCutsFirst2[2];
       LOG_0(TraceLevelVerbose, "BoostMultiDimensional Done sweep loops");
 
       FloatEbmType gain;
@@ -795,7 +981,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          return FindBestBoostingSplitPairsInternal<compilerLearningTypeOrCountTargetClassesPossible>::Func(
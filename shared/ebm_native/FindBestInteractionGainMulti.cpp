@@ -0,0 +1,340 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h" // FloatEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "EbmStatisticUtils.h"
+
+#include "FeatureAtomic.h"
+#include "FeatureGroup.h"
+
+#include "HistogramTargetEntry.h"
+#include "HistogramBucket.h"
+
+#include "InteractionDetection.h"
+
+#include "TensorTotalsSum.h"
+
+// This is the same cross bar search that we use for pairs, generalized to any number of dimensions.  At each point we 
+// look at the 2^N regions between the point and each corner.  With the mirrored totals each of these regions takes at 
+// most 2^(N/2) lookups.
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions>
+class FindBestInteractionGainMultiInternal final {
+public:
+
+   FindBestInteractionGainMultiInternal() = delete; // this is a static class.  Do not construct
+
+   static FloatEbmType Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const FeatureGroup * const pFeatureGroup,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZoneBase,
+      HistogramBucketBase * const aHistogramBucketsBase,
+      HistogramBucketBase * const aHistogramBucketsMirrorBase
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopyBase
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      constexpr bool bNeedDenominator = k_bInteractionNeedDenominator;
+
+      HistogramBucket<bNeedDenominator> * const pTotals = pAuxiliaryBucketZoneBase->GetHistogramBucket<bNeedDenominator>();
+
+      const HistogramBucket<bNeedDenominator> * const aHistogramBuckets =
+         aHistogramBucketsBase->GetHistogramBucket<bNeedDenominator>();
+
+      const HistogramBucket<bNeedDenominator> * const aHistogramBucketsMirror =
+         aHistogramBucketsMirrorBase->GetHistogramBucket<bNeedDenominator>();
+
+#ifndef NDEBUG
+      const HistogramBucket<bNeedDenominator> * const aHistogramBucketsDebugCopy =
+         nullptr == aHistogramBucketsDebugCopyBase ? nullptr : aHistogramBucketsDebugCopyBase->GetHistogramBucket<bNeedDenominator>();
+#endif // NDEBUG
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses()
+      );
+
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+
+      const size_t cDimensions = GET_ATTRIBUTE_COMBINATION_DIMENSIONS(compilerCountDimensions, pFeatureGroup->GetCountFeatures());
+      EBM_ASSERT(IsTensorTotalsMirrored(cDimensions));
+      EBM_ASSERT(cDimensions <= k_cDimensionsMax);
+      static_assert(k_cDimensionsMax < k_cBitsForSizeT, "reserve the highest bit for bit manipulation space");
+      const size_t directionVectorEnd = size_t { 1 } << cDimensions;
+
+      EBM_ASSERT(0 < cSamplesRequiredForChildSplitMin);
+
+      // never return anything above zero, which might happen due to numeric instability if we set this lower than 0
+      FloatEbmType bestSplittingScore = FloatEbmType { 0 };
+
+      size_t aiPoint[k_cDimensionsMax];
+      // the last bin of each dimension can't be a cut point
+      size_t acCuts[k_cDimensionsMax];
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+         // dimensions with 1 bin should have been filtered out before this function was called, so each dimension 
+         // has at least one cut point
+         EBM_ASSERT(2 <= cBins);
+         acCuts[iDimension] = cBins - 1;
+         aiPoint[iDimension] = 0;
+      }
+
+      while(true) {
+         FloatEbmType splittingScore = 0;
+         size_t directionVector = 0;
+         do {
+            TensorTotalsSumMirrored<compilerLearningTypeOrCountTargetClasses, compilerCountDimensions, bNeedDenominator>(
+               learningTypeOrCountTargetClasses,
+               pFeatureGroup,
+               aHistogramBuckets,
+               aHistogramBucketsMirror,
+               aiPoint,
+               directionVector,
+               pTotals
+#ifndef NDEBUG
+               , aHistogramBucketsDebugCopy
+               , aHistogramBucketsEndDebug
+#endif // NDEBUG
+            );
+            const size_t cSamplesInBucket = pTotals->GetCountSamplesInBucket();
+            if(UNLIKELY(cSamplesInBucket < cSamplesRequiredForChildSplitMin)) {
+               break;
+            }
+            const FloatEbmType cSamplesInBucketFloat = static_cast<FloatEbmType>(cSamplesInBucket);
+            const HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntryTotals =
+               pTotals->GetHistogramBucketVectorEntry();
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               const FloatEbmType splittingScoreUpdate = EbmStatistics::ComputeNodeSplittingScore(
+                  pHistogramBucketVectorEntryTotals[iVector].m_sumResidualError,
+                  cSamplesInBucketFloat
+               );
+               EBM_ASSERT(std::isnan(splittingScoreUpdate) || FloatEbmType { 0 } <= splittingScoreUpdate);
+               splittingScore += splittingScoreUpdate;
+            }
+            ++directionVector;
+         } while(directionVectorEnd != directionVector);
+
+         if(LIKELY(directionVectorEnd == directionVector)) {
+            // every region had enough samples
+            EBM_ASSERT(std::isnan(splittingScore) || FloatEbmType { 0 } <= splittingScore); // sumations of positive numbers should be positive
+
+            // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality
+            // comparisons are all false so, let's flip this comparison such that it should be true for NaN values.  If the compiler violates 
+            // NaN comparions rules, no big deal.  NaN values will get us soon and shut down boosting.
+            if(UNLIKELY(/* DO NOT CHANGE THIS WITHOUT READING THE ABOVE. WE DO THIS STRANGE COMPARISON FOR NaN values*/
+               !(splittingScore <= bestSplittingScore))) {
+               bestSplittingScore = splittingScore;
+            } else {
+               EBM_ASSERT(!std::isnan(splittingScore));
+            }
+         }
+
+         // move to the next cut point
+         size_t iDimension = 0;
+         while(true) {
+            ++aiPoint[iDimension];
+            if(LIKELY(acCuts[iDimension] != aiPoint[iDimension])) {
+               break;
+            }
+            aiPoint[iDimension] = 0;
+            ++iDimension;
+            if(UNLIKELY(cDimensions == iDimension)) {
+               return bestSplittingScore;
+            }
+         }
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
+class FindBestInteractionGainMultiDimensions final {
+public:
+
+   FindBestInteractionGainMultiDimensions() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const FeatureGroup * const pFeatureGroup,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZone,
+      HistogramBucketBase * const aHistogramBuckets,
+      HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      if(k_cCompilerOptimizedCountDimensionsExtra == pFeatureGroup->GetCountFeatures()) {
+         return FindBestInteractionGainMultiInternal<compilerLearningTypeOrCountTargetClasses, k_cCompilerOptimizedCountDimensionsExtra>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets,
+            aHistogramBucketsMirror
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         return FindBestInteractionGainMultiInternal<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets,
+            aHistogramBucketsMirror
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+class FindBestInteractionGainMultiTarget final {
+public:
+
+   FindBestInteractionGainMultiTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const FeatureGroup * const pFeatureGroup,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZone,
+      HistogramBucketBase * const aHistogramBuckets,
+      HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(compilerLearningTypeOrCountTargetClassesPossible), "compilerLearningTypeOrCountTargetClassesPossible needs to be a classification");
+      static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
+
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+      EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
+
+      if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
+         return FindBestInteractionGainMultiDimensions<compilerLearningTypeOrCountTargetClassesPossible>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets,
+            aHistogramBucketsMirror
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         return FindBestInteractionGainMultiTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+            pEbmInteractionState,
+            pFeatureGroup,
+            cSamplesRequiredForChildSplitMin,
+            pAuxiliaryBucketZone,
+            aHistogramBuckets,
+            aHistogramBucketsMirror
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   }
+};
+
+template<>
+class FindBestInteractionGainMultiTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+public:
+
+   FindBestInteractionGainMultiTarget() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static FloatEbmType Func(
+      EbmInteractionState * const pEbmInteractionState,
+      const FeatureGroup * const pFeatureGroup,
+      const size_t cSamplesRequiredForChildSplitMin,
+      HistogramBucketBase * pAuxiliaryBucketZone,
+      HistogramBucketBase * const aHistogramBuckets,
+      HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+      , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(IsClassification(k_cCompilerOptimizedTargetClassesMax), "k_cCompilerOptimizedTargetClassesMax needs to be a classification");
+
+      EBM_ASSERT(IsClassification(pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses()));
+      EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses());
+
+      return FindBestInteractionGainMultiDimensions<k_dynamicClassification>::Func(
+         pEbmInteractionState,
+         pFeatureGroup,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         aHistogramBuckets,
+         aHistogramBucketsMirror
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   }
+};
+
+extern FloatEbmType FindBestInteractionGainMulti(
+   EbmInteractionState * const pEbmInteractionState,
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cSamplesRequiredForChildSplitMin,
+   HistogramBucketBase * pAuxiliaryBucketZone,
+   HistogramBucketBase * const aHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+   , const HistogramBucketBase * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
+
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      return FindBestInteractionGainMultiTarget<2>::Func(
+         pEbmInteractionState,
+         pFeatureGroup,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         aHistogramBuckets,
+         aHistogramBucketsMirror
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   } else {
+      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+      return FindBestInteractionGainMultiDimensions<k_regression>::Func(
+         pEbmInteractionState,
+         pFeatureGroup,
+         cSamplesRequiredForChildSplitMin,
+         pAuxiliaryBucketZone,
+         aHistogramBuckets,
+         aHistogramBucketsMirror
+#ifndef NDEBUG
+         , aHistogramBucketsDebugCopy
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+   }
+}
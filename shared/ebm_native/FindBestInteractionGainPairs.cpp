@@ -38,17 +38,17 @@ public:
       , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
    ) {
-      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+      constexpr bool bNeedDenominator = k_bInteractionNeedDenominator;
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * pAuxiliaryBucketZone =
-         pAuxiliaryBucketZoneBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * pAuxiliaryBucketZone =
+         pAuxiliaryBucketZoneBase->GetHistogramBucket<bNeedDenominator>();
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets =
-         aHistogramBucketsBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * const aHistogramBuckets =
+         aHistogramBucketsBase->GetHistogramBucket<bNeedDenominator>();
 
 #ifndef NDEBUG
-      const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy =
-         aHistogramBucketsDebugCopyBase->GetHistogramBucket<bClassification>();
+      const HistogramBucket<bNeedDenominator> * const aHistogramBucketsDebugCopy =
+         aHistogramBucketsDebugCopyBase->GetHistogramBucket<bNeedDenominator>();
 #endif // NDEBUG
 
       const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
@@ -57,16 +57,16 @@ public:
       );
 
       const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
-      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
 
-      HistogramBucket<bClassification> * pTotalsLowLow =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 0);
-      HistogramBucket<bClassification> * pTotalsLowHigh =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 1);
-      HistogramBucket<bClassification> * pTotalsHighLow =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 2);
-      HistogramBucket<bClassification> * pTotalsHighHigh =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 3);
+      HistogramBucket<bNeedDenominator> * pTotalsLowLow =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 0);
+      HistogramBucket<bNeedDenominator> * pTotalsLowHigh =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 1);
+      HistogramBucket<bNeedDenominator> * pTotalsHighLow =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 2);
+      HistogramBucket<bNeedDenominator> * pTotalsHighHigh =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pAuxiliaryBucketZone, 3);
 
       const size_t cBinsDimension1 = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
       const size_t cBinsDimension2 = pFeatureGroup->GetFeatureGroupEntries()[1].m_pFeature->GetCountBins();
@@ -93,7 +93,7 @@ public:
          do {
             aiStart[1] = iBin2;
 
-            TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+            TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bNeedDenominator>(
                learningTypeOrCountTargetClasses,
                pFeatureGroup,
                aHistogramBuckets,
@@ -106,7 +106,7 @@ public:
 #endif // NDEBUG
                );
             if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsLowLow->GetCountSamplesInBucket())) {
-               TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+               TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bNeedDenominator>(
                   learningTypeOrCountTargetClasses,
                   pFeatureGroup,
                   aHistogramBuckets,
@@ -119,7 +119,7 @@ public:
 #endif // NDEBUG
                   );
                if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsLowHigh->GetCountSamplesInBucket())) {
-                  TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+                  TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bNeedDenominator>(
                      learningTypeOrCountTargetClasses,
                      pFeatureGroup,
                      aHistogramBuckets,
@@ -132,7 +132,7 @@ public:
 #endif // NDEBUG
                      );
                   if(LIKELY(cSamplesRequiredForChildSplitMin <= pTotalsHighLow->GetCountSamplesInBucket())) {
-                     TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2>(
+                     TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, 2, bNeedDenominator>(
                         learningTypeOrCountTargetClasses,
                         pFeatureGroup,
                         aHistogramBuckets,
@@ -152,13 +152,13 @@ public:
                         FloatEbmType cHighLowSamplesInBucket = static_cast<FloatEbmType>(pTotalsHighLow->GetCountSamplesInBucket());
                         FloatEbmType cHighHighSamplesInBucket = static_cast<FloatEbmType>(pTotalsHighHigh->GetCountSamplesInBucket());
 
-                        HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntryTotalsLowLow =
+                        HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntryTotalsLowLow =
                            pTotalsLowLow->GetHistogramBucketVectorEntry();
-                        HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntryTotalsLowHigh =
+                        HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntryTotalsLowHigh =
                            pTotalsLowHigh->GetHistogramBucketVectorEntry();
-                        HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntryTotalsHighLow =
+                        HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntryTotalsHighLow =
                            pTotalsHighLow->GetHistogramBucketVectorEntry();
-                        HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntryTotalsHighHigh =
+                        HistogramBucketVectorEntry<bNeedDenominator> * const pHistogramBucketVectorEntryTotalsHighHigh =
                            pTotalsHighHigh->GetHistogramBucketVectorEntry();
 
                         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
@@ -230,7 +230,7 @@ public:
 
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmInteractionState->GetRuntimeLearningTypeOrCountTargetClasses();
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
          return FindBestInteractionGainPairsInternal<compilerLearningTypeOrCountTargetClassesPossible>::Func(
@@ -7,6 +7,7 @@
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // numeric_limits
+#include <cmath> // floor
 
 #include "ebm_native.h"
 #include "EbmInternal.h"
@@ -28,9 +29,11 @@
 #include "Booster.h"
 
 #include "TensorTotalsSum.h"
+#include "ThreadPool.h"
 
 extern void BinBoosting(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
    const FeatureGroup * const pFeatureGroup,
    const SamplingSet * const pTrainingSet,
    HistogramBucketBase * const aHistogramBucketBase
@@ -39,6 +42,17 @@ extern void BinBoosting(
 #endif // NDEBUG
 );
 
+extern void BinBoostingMultiple(
+   EbmBoostingState * const pEbmBoostingState,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroups,
+   const SamplingSet * const pTrainingSet,
+   HistogramBucketBase * const * const aHistogramBucketBases
+#ifndef NDEBUG
+   , const unsigned char * const * const aHistogramBucketsEndsDebug
+#endif // NDEBUG
+);
+
 extern void SumHistogramBuckets(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
    const size_t cHistogramBuckets,
@@ -52,6 +66,8 @@ extern void SumHistogramBuckets(
 
 extern bool GrowDecisionTree(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const bool bNominal,
    const size_t cHistogramBuckets,
    const HistogramBucketBase * const aHistogramBucketBase,
    const size_t cSamplesTotal,
@@ -81,9 +97,213 @@ extern bool FindBestBoostingSplitPairs(
 );
 
 
+// counts travel through the reduce function as FloatEbmType, which holds every integer up 
+// to 2^53 exactly
+constexpr FloatEbmType k_flatCountMax = FloatEbmType { 9007199254740992 };
+
+// returns the buffer that holds cHistogramBuckets buckets in the flat layout of HISTOGRAM_REDUCE_FUNCTION, or 
+// nullptr on error.  The buffer is shared by all the bags, so only one bag at a time can use it
+static FloatEbmType * GetFlatHistogramValues(
+   EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const size_t cHistogramBuckets,
+   size_t * const pcValuesOut
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cValuesPerVectorEntry = IsClassification(runtimeLearningTypeOrCountTargetClasses) ? size_t { 2 } : size_t { 1 };
+   // our histogram buckets hold more than this in bytes, so it can't overflow
+   const size_t cValuesPerBucket = 1 + cValuesPerVectorEntry * GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   if(UNLIKELY(IsMultiplyError(cHistogramBuckets, cValuesPerBucket))) {
+      LOG_0(TraceLevelWarning, "WARNING GetFlatHistogramValues IsMultiplyError(cHistogramBuckets, cValuesPerBucket)");
+      return nullptr;
+   }
+   const size_t cValues = cHistogramBuckets * cValuesPerBucket;
+   if(UNLIKELY(!IsNumberConvertable<IntEbmType>(cValues))) {
+      LOG_0(TraceLevelWarning, "WARNING GetFlatHistogramValues !IsNumberConvertable<IntEbmType>(cValues)");
+      return nullptr;
+   }
+   *pcValuesOut = cValues;
+   return pCachedThreadResources->GetHistogramReduceValues(cValues);
+}
+
+template<bool bClassification>
+static void FlattenHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const HistogramBucketBase * const aHistogramBucketsBase,
+   FloatEbmType * const aValuesOut
+) {
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+   const HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketsBase->GetHistogramBucket<bClassification>();
+
+   FloatEbmType * pValue = aValuesOut;
+   for(size_t iBucket = 0; iBucket < cHistogramBuckets; ++iBucket) {
+      const HistogramBucket<bClassification> * const pHistogramBucket =
+         GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, iBucket);
+      *pValue = static_cast<FloatEbmType>(pHistogramBucket->GetCountSamplesInBucket());
+      ++pValue;
+      const HistogramBucketVectorEntry<bClassification> * const aVectorEntries = pHistogramBucket->GetHistogramBucketVectorEntry();
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         *pValue = aVectorEntries[iVector].m_sumResidualError;
+         ++pValue;
+         if(bClassification) {
+            *pValue = aVectorEntries[iVector].GetSumDenominator();
+            ++pValue;
+         }
+      }
+   }
+}
+
+// pcSamplesTotalOut receives the total count of samples in the buckets.  Returns true if a count is not a 
+// non-negative integer, which only happens if the reduce function gave us bad values
+template<bool bClassification>
+static bool UnflattenHistogramBuckets(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const FloatEbmType * const aValues,
+   HistogramBucketBase * const aHistogramBucketsBase,
+   size_t * const pcSamplesTotalOut
+) {
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+   HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketsBase->GetHistogramBucket<bClassification>();
+
+   size_t cSamplesTotal = 0;
+   const FloatEbmType * pValue = aValues;
+   for(size_t iBucket = 0; iBucket < cHistogramBuckets; ++iBucket) {
+      HistogramBucket<bClassification> * const pHistogramBucket =
+         GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, iBucket);
+      const FloatEbmType count = *pValue;
+      ++pValue;
+      // this also rejects NaN
+      if(UNLIKELY(!(FloatEbmType { 0 } <= count && count <= k_flatCountMax && std::floor(count) == count))) {
+         LOG_0(TraceLevelWarning, "WARNING UnflattenHistogramBuckets a count is not a non-negative integer");
+         return true;
+      }
+      const size_t cSamplesInBucket = static_cast<size_t>(count);
+      if(UNLIKELY(IsAddError(cSamplesTotal, cSamplesInBucket))) {
+         LOG_0(TraceLevelWarning, "WARNING UnflattenHistogramBuckets IsAddError(cSamplesTotal, cSamplesInBucket)");
+         return true;
+      }
+      cSamplesTotal += cSamplesInBucket;
+      pHistogramBucket->SetCountSamplesInBucket(cSamplesInBucket);
+      HistogramBucketVectorEntry<bClassification> * const aVectorEntries = pHistogramBucket->GetHistogramBucketVectorEntry();
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         aVectorEntries[iVector].m_sumResidualError = *pValue;
+         ++pValue;
+         if(bClassification) {
+            aVectorEntries[iVector].SetSumDenominator(*pValue);
+            ++pValue;
+         }
+      }
+   }
+
+   *pcSamplesTotalOut = cSamplesTotal;
+   return false;
+}
+
+static bool UnflattenHistogramBuckets(
+   EbmBoostingState * const pEbmBoostingState,
+   const size_t cHistogramBuckets,
+   const FloatEbmType * const aValues,
+   HistogramBucketBase * const aHistogramBuckets,
+   size_t * const pcSamplesTotalOut
+) {
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      return UnflattenHistogramBuckets<true>(cVectorLength, cHistogramBuckets, aValues, aHistogramBuckets, pcSamplesTotalOut);
+   } else {
+      return UnflattenHistogramBuckets<false>(cVectorLength, cHistogramBuckets, aValues, aHistogramBuckets, pcSamplesTotalOut);
+   }
+}
+
+static bool CallHistogramReduce(EbmBoostingState * const pEbmBoostingState, const size_t cValues, FloatEbmType * const aValues) {
+   EBM_ASSERT(nullptr != pEbmBoostingState->GetHistogramReduceFunction());
+   const IntEbmType ret = (*pEbmBoostingState->GetHistogramReduceFunction())(
+      static_cast<IntEbmType>(cValues),
+      aValues,
+      pEbmBoostingState->GetHistogramReduceContext()
+   );
+   if(0 != ret) {
+      LOG_N(TraceLevelWarning, "WARNING CallHistogramReduce the reduce function returned %" IntEbmTypePrintf, ret);
+      return true;
+   }
+   return false;
+}
+
+// fills the first cHistogramBuckets buckets with the histogram of bag iSamplingSet from BinBoosting.  When our 
+// training samples are one shard of a dataset that is spread over several nodes, the buckets are then replaced with 
+// their sums over all the nodes.  
+// pcSamplesTotalOut receives the total count of samples in the buckets.  Returns true on error
+static bool BuildHistogramBuckets(
+   EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const FeatureGroup * const pFeatureGroup,
+   const size_t iSamplingSet,
+   const size_t cHistogramBuckets,
+   HistogramBucketBase * const aHistogramBuckets,
+#ifndef NDEBUG
+   const unsigned char * const aHistogramBucketsEndDebug,
+#endif // NDEBUG
+   size_t * const pcSamplesTotalOut
+) {
+   const SamplingSet * const pTrainingSet = pEbmBoostingState->GetSamplingSets()[iSamplingSet];
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   if(nullptr == pEbmBoostingState->GetHistogramReduceFunction()) {
+      PERFORMANCE_COUNTER_START(startBinBoosting);
+      BinBoosting(
+         pEbmBoostingState,
+         pCachedThreadResources,
+         pFeatureGroup,
+         pTrainingSet,
+         aHistogramBuckets
+#ifndef NDEBUG
+         , aHistogramBucketsEndDebug
+#endif // NDEBUG
+      );
+      PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startBinBoosting, PerformanceCounterBinBoosting,
+         GetPerformanceCounterSampleBytes(pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples(), pFeatureGroup, cVectorLength));
+      *pcSamplesTotalOut = pTrainingSet->GetTotalCountSampleOccurrences();
+      return false;
+   }
+
+   size_t cValues;
+   FloatEbmType * const aValues = GetFlatHistogramValues(pEbmBoostingState, pCachedThreadResources, cHistogramBuckets, &cValues);
+   if(UNLIKELY(nullptr == aValues)) {
+      return true;
+   }
+
+   PERFORMANCE_COUNTER_START(startBinBoosting);
+   BinBoosting(
+      pEbmBoostingState,
+      pCachedThreadResources,
+      pFeatureGroup,
+      pTrainingSet,
+      aHistogramBuckets
+#ifndef NDEBUG
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+   if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      FlattenHistogramBuckets<true>(cVectorLength, cHistogramBuckets, aHistogramBuckets, aValues);
+   } else {
+      FlattenHistogramBuckets<false>(cVectorLength, cHistogramBuckets, aHistogramBuckets, aValues);
+   }
+   PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startBinBoosting, PerformanceCounterBinBoosting,
+      GetPerformanceCounterSampleBytes(pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples(), pFeatureGroup, cVectorLength));
+
+   if(CallHistogramReduce(pEbmBoostingState, cValues, aValues)) {
+      return true;
+   }
+   return UnflattenHistogramBuckets(pEbmBoostingState, cHistogramBuckets, aValues, aHistogramBuckets, pcSamplesTotalOut);
+}
+
 static bool BoostZeroDimensional(
    EbmBoostingState * const pEbmBoostingState,
-   const SamplingSet * const pTrainingSet,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const size_t iSamplingSet,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet
 ) {
    LOG_0(TraceLevelVerbose, "Entered BoostZeroDimensional");
@@ -92,38 +312,35 @@ static bool BoostZeroDimensional(
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
 
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)");
-      return true;
-   }
+   // EbmBoostingState::Allocate checked this and sized ThreadByteBuffer1 for our worst feature group
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
    const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
 
-   CachedBoostingThreadResources * const pCachedThreadResources = pEbmBoostingState->GetCachedThreadResources();
-
    HistogramBucketBase * const pHistogramBucket =
       pCachedThreadResources->GetThreadByteBuffer1(cBytesPerHistogramBucket);
 
-   if(UNLIKELY(nullptr == pHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING nullptr == pHistogramBucket");
-      return true;
-   }
-
    if(bClassification) {
       pHistogramBucket->GetHistogramBucket<true>()->Zero(cVectorLength);
    } else {
       pHistogramBucket->GetHistogramBucket<false>()->Zero(cVectorLength);
    }
 
-   BinBoosting(
+   size_t cSamplesTotalUnused;
+   if(BuildHistogramBuckets(
       pEbmBoostingState,
+      pCachedThreadResources,
       nullptr,
-      pTrainingSet,
-      pHistogramBucket
+      iSamplingSet,
+      1,
+      pHistogramBucket,
 #ifndef NDEBUG
-      , nullptr
+      nullptr,
 #endif // NDEBUG
-   );
+      &cSamplesTotalUnused
+   )) {
+      LOG_0(TraceLevelVerbose, "Exited BoostZeroDimensional with Error code");
+      return true;
+   }
 
    FloatEbmType * aValues = pSmallChangeToModelOverwriteSingleSamplingSet->GetValuePointer();
    if(bClassification) {
@@ -153,12 +370,27 @@ static bool BoostZeroDimensional(
    return false;
 }
 
+template<bool bClassification>
+static void ZeroSingleDimensionalHistogram(
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const size_t cBytesPerHistogramBucket,
+   HistogramBucketBase * const aHistogramBucketBase
+) {
+   HistogramBucket<bClassification> * const aHistogramBuckets = aHistogramBucketBase->GetHistogramBucket<bClassification>();
+   for(size_t i = 0; i < cHistogramBuckets; ++i) {
+      GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBuckets, i)->Zero(cVectorLength);
+   }
+}
+
 static bool BoostSingleDimensional(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
    const FeatureGroup * const pFeatureGroup,
-   const SamplingSet * const pTrainingSet,
+   const size_t iSamplingSet,
    const size_t cTreeSplitsMax,
    const size_t cSamplesRequiredForChildSplitMin,
+   const bool bHistogramBuilt,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
    FloatEbmType * const pTotalGain
 ) {
@@ -170,36 +402,20 @@ static bool BoostSingleDimensional(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "WARNING GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)");
-      return true;
-   }
+   // EbmBoostingState::Allocate checked these and sized ThreadByteBuffer1 for our worst feature group
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
    const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-   if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      // TODO : move this to initialization where we execute it only once
-      LOG_0(TraceLevelWarning, "WARNING IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
-      return true;
-   }
+   EBM_ASSERT(!IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket));
    const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
 
-   CachedBoostingThreadResources * const pCachedThreadResources = pEbmBoostingState->GetCachedThreadResources();
-
    HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostSingleDimensional nullptr == aHistogramBuckets");
-      return true;
-   }
 
    HistogramBucketVectorEntryBase * const aSumHistogramBucketVectorEntry =
       pCachedThreadResources->GetSumHistogramBucketVectorEntryArray();
 
    if(bClassification) {
-      HistogramBucket<true> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<true>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<true> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
+      if(!bHistogramBuilt) {
+         ZeroSingleDimensionalHistogram<true>(cVectorLength, cTotalBuckets, cBytesPerHistogramBucket, aHistogramBuckets);
       }
 
       HistogramBucketVectorEntry<true> * const aSumHistogramBucketVectorEntryLocal = aSumHistogramBucketVectorEntry->GetHistogramBucketVectorEntry<true>();
@@ -207,11 +423,8 @@ static bool BoostSingleDimensional(
          aSumHistogramBucketVectorEntryLocal[i].Zero();
       }
    } else {
-      HistogramBucket<false> * const aHistogramBucketsLocal = aHistogramBuckets->GetHistogramBucket<false>();
-      for(size_t i = 0; i < cTotalBuckets; ++i) {
-         HistogramBucket<false> * const pHistogramBucket =
-            GetHistogramBucketByIndex(cBytesPerHistogramBucket, aHistogramBucketsLocal, i);
-         pHistogramBucket->Zero(cVectorLength);
+      if(!bHistogramBuilt) {
+         ZeroSingleDimensionalHistogram<false>(cVectorLength, cTotalBuckets, cBytesPerHistogramBucket, aHistogramBuckets);
       }
 
       HistogramBucketVectorEntry<false> * const aSumHistogramBucketVectorEntryLocal = aSumHistogramBucketVectorEntry->GetHistogramBucketVectorEntry<false>();
@@ -224,20 +437,33 @@ static bool BoostSingleDimensional(
    const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
 #endif // NDEBUG
 
-   BinBoosting(
+   size_t cHistogramBuckets = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
+   // dimensions with 1 bin don't contribute anything since they always have the same value, 
+   // so we pre-filter these out and handle them separately
+   EBM_ASSERT(2 <= cHistogramBuckets);
+
+   size_t cSamplesTotal;
+   if(bHistogramBuilt) {
+      // BinMainEffectsSamplingSetTask already binned us together with the other main effects of the batch
+      cSamplesTotal = pEbmBoostingState->GetSamplingSets()[iSamplingSet]->GetTotalCountSampleOccurrences();
+   } else if(BuildHistogramBuckets(
       pEbmBoostingState,
+      pCachedThreadResources,
       pFeatureGroup,
-      pTrainingSet,
-      aHistogramBuckets
+      iSamplingSet,
+      cHistogramBuckets,
+      aHistogramBuckets,
 #ifndef NDEBUG
-      , aHistogramBucketsEndDebug
+      aHistogramBucketsEndDebug,
 #endif // NDEBUG
-   );
+      &cSamplesTotal
+   )) {
+      LOG_0(TraceLevelVerbose, "Exited BoostSingleDimensional with Error code");
+      return true;
+   }
+   EBM_ASSERT(1 <= cSamplesTotal);
 
-   size_t cHistogramBuckets = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
-   // dimensions with 1 bin don't contribute anything since they always have the same value, 
-   // so we pre-filter these out and handle them separately
-   EBM_ASSERT(2 <= cHistogramBuckets);
+   PERFORMANCE_COUNTER_START(startSumHistogramBuckets);
    SumHistogramBuckets(
       runtimeLearningTypeOrCountTargetClasses,
       cHistogramBuckets,
@@ -245,15 +471,17 @@ static bool BoostSingleDimensional(
       aSumHistogramBucketVectorEntry
 #ifndef NDEBUG
       , aHistogramBucketsEndDebug
-      , pTrainingSet->GetTotalCountSampleOccurrences()
+      , cSamplesTotal
 #endif // NDEBUG
    );
+   PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startSumHistogramBuckets, PerformanceCounterSumHistogramBuckets,
+      static_cast<uint64_t>(cHistogramBuckets) * cBytesPerHistogramBucket);
 
-   const size_t cSamplesTotal = pTrainingSet->GetTotalCountSampleOccurrences();
-   EBM_ASSERT(1 <= cSamplesTotal);
-
+   PERFORMANCE_COUNTER_START(startGrowDecisionTree);
    bool bRet = GrowDecisionTree(
       pEbmBoostingState,
+      pCachedThreadResources,
+      FeatureType::Nominal == pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetFeatureType(),
       cHistogramBuckets,
       aHistogramBuckets,
       cSamplesTotal,
@@ -266,6 +494,8 @@ static bool BoostSingleDimensional(
       , aHistogramBucketsEndDebug
 #endif // NDEBUG
    );
+   PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startGrowDecisionTree, PerformanceCounterGrowDecisionTree,
+      static_cast<uint64_t>(cHistogramBuckets) * cBytesPerHistogramBucket);
 
    LOG_0(TraceLevelVerbose, "Exited BoostSingleDimensional");
    return bRet;
@@ -276,8 +506,9 @@ static bool BoostSingleDimensional(
 //    go back to our original tensor after splits to determine the denominator
 static bool BoostMultiDimensional(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
    const FeatureGroup * const pFeatureGroup,
-   const SamplingSet * const pTrainingSet,
+   const size_t iSamplingSet,
    const size_t cSamplesRequiredForChildSplitMin,
    SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
    FloatEbmType * const pTotalGain
@@ -309,37 +540,20 @@ static bool BoostMultiDimensional(
    const size_t cAuxillaryBucketsForSplitting = 24;
    const size_t cAuxillaryBuckets =
       cAuxillaryBucketsForBuildFastTotals < cAuxillaryBucketsForSplitting ? cAuxillaryBucketsForSplitting : cAuxillaryBucketsForBuildFastTotals;
-   if(IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets)");
-      return true;
-   }
+   // EbmBoostingState::Allocate checked these and sized ThreadByteBuffer1 for our worst feature group
+   EBM_ASSERT(!IsAddError(cTotalBucketsMainSpace, cAuxillaryBuckets));
    const size_t cTotalBuckets = cTotalBucketsMainSpace + cAuxillaryBuckets;
 
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
    const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
-   if(GetHistogramBucketSizeOverflow(bClassification, cVectorLength)) {
-      LOG_0(
-         TraceLevelWarning,
-         "WARNING BoostMultiDimensional GetHistogramBucketSizeOverflow<bClassification>(cVectorLength)"
-      );
-      return true;
-   }
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
    const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
-   if(IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)");
-      return true;
-   }
+   EBM_ASSERT(!IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket));
    const size_t cBytesBuffer = cTotalBuckets * cBytesPerHistogramBucket;
 
-   CachedBoostingThreadResources * const pCachedThreadResources = pEbmBoostingState->GetCachedThreadResources();
-
    // we don't need to free this!  It's tracked and reused by pCachedThreadResources
    HistogramBucketBase * const aHistogramBuckets = pCachedThreadResources->GetThreadByteBuffer1(cBytesBuffer);
-   if(UNLIKELY(nullptr == aHistogramBuckets)) {
-      LOG_0(TraceLevelWarning, "WARNING BoostMultiDimensional nullptr == aHistogramBuckets");
-      return true;
-   }
 
 
    if(bClassification) {
@@ -368,15 +582,23 @@ static bool BoostMultiDimensional(
    const unsigned char * const aHistogramBucketsEndDebug = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
 #endif // NDEBUG
 
-   BinBoosting(
+   // TensorTotalsBuild fills the auxiliary buckets from the main space, so we only need to build the main space
+   size_t cSamplesTotalUnused;
+   if(BuildHistogramBuckets(
       pEbmBoostingState,
+      pCachedThreadResources,
       pFeatureGroup,
-      pTrainingSet,
-      aHistogramBuckets
+      iSamplingSet,
+      cTotalBucketsMainSpace,
+      aHistogramBuckets,
 #ifndef NDEBUG
-      , aHistogramBucketsEndDebug
+      aHistogramBucketsEndDebug,
 #endif // NDEBUG
-   );
+      &cSamplesTotalUnused
+   )) {
+      LOG_0(TraceLevelVerbose, "Exited BoostMultiDimensional with Error code");
+      return true;
+   }
 
 #ifndef NDEBUG
    // make a copy of the original binned buckets for debugging purposes
@@ -397,16 +619,22 @@ static bool BoostMultiDimensional(
    }
 #endif // NDEBUG
 
+   // we only boost pairs below, and pairs don't use the mirrored totals
+   PERFORMANCE_COUNTER_START(startTensorTotalsBuild);
    TensorTotalsBuild(
       runtimeLearningTypeOrCountTargetClasses,
+      IsClassification(runtimeLearningTypeOrCountTargetClasses),
       pFeatureGroup,
       pAuxiliaryBucketZone,
-      aHistogramBuckets
+      aHistogramBuckets,
+      nullptr
 #ifndef NDEBUG
       , aHistogramBucketsDebugCopy
       , aHistogramBucketsEndDebug
 #endif // NDEBUG
    );
+   PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startTensorTotalsBuild, PerformanceCounterTensorTotalsBuild,
+      static_cast<uint64_t>(cTotalBucketsMainSpace) * cBytesPerHistogramBucket);
 
    //permutation0
    //gain_permute0
@@ -516,6 +744,7 @@ static bool BoostMultiDimensional(
          cTotalBucketsMainSpace - 1
       );
 
+      PERFORMANCE_COUNTER_START(startFindBestBoostingSplitPairs);
       bool bError = FindBestBoostingSplitPairs(
          pEbmBoostingState,
          pFeatureGroup,
@@ -530,6 +759,8 @@ static bool BoostMultiDimensional(
          , aHistogramBucketsEndDebug
 #endif // NDEBUG
       );
+      PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startFindBestBoostingSplitPairs, PerformanceCounterFindBestBoostingSplitsPairs,
+         static_cast<uint64_t>(cTotalBucketsMainSpace) * cBytesPerHistogramBucket);
       if(bError) {
 #ifndef NDEBUG
          free(aHistogramBucketsDebugCopy);
@@ -565,23 +796,82 @@ static bool BoostMultiDimensional(
    return false;
 }
 
+class BoostSamplingSetContext final {
+public:
+   EbmBoostingState * m_pEbmBoostingState;
+   size_t m_iSlot;
+   const FeatureGroup * m_pFeatureGroup;
+   size_t m_cTreeSplitsMax;
+   size_t m_cSamplesRequiredForChildSplitMin;
+   bool m_bHistogramBuilt;
+};
+
+static void BoostSamplingSetTask(void * const pContext, const size_t iSamplingSet) {
+   // each bag only touches it's own CachedBoostingThreadResources and reads shared state, so bags can run in parallel
+   const BoostSamplingSetContext * const pBoostSamplingSetContext = static_cast<const BoostSamplingSetContext *>(pContext);
+   EbmBoostingState * const pEbmBoostingState = pBoostSamplingSetContext->m_pEbmBoostingState;
+   const FeatureGroup * const pFeatureGroup = pBoostSamplingSetContext->m_pFeatureGroup;
+
+   CachedBoostingThreadResources * const pCachedThreadResources = 
+      pEbmBoostingState->GetCachedThreadResources(pBoostSamplingSetContext->m_iSlot, iSamplingSet);
+   SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet = 
+      pCachedThreadResources->GetSmallChangeToModelOverwriteSingleSamplingSet();
+   pSmallChangeToModelOverwriteSingleSamplingSet->SetCountDimensions(pFeatureGroup->GetCountFeatures());
+
+   FloatEbmType gain = FloatEbmType { 0 };
+   bool bError;
+   if(UNLIKELY(UNLIKELY(0 == pBoostSamplingSetContext->m_cTreeSplitsMax) || UNLIKELY(0 == pFeatureGroup->GetCountFeatures()))) {
+      bError = BoostZeroDimensional(
+         pEbmBoostingState,
+         pCachedThreadResources,
+         iSamplingSet,
+         pSmallChangeToModelOverwriteSingleSamplingSet
+      );
+   } else if(1 == pFeatureGroup->GetCountFeatures()) {
+      bError = BoostSingleDimensional(
+         pEbmBoostingState,
+         pCachedThreadResources,
+         pFeatureGroup,
+         iSamplingSet,
+         pBoostSamplingSetContext->m_cTreeSplitsMax,
+         pBoostSamplingSetContext->m_cSamplesRequiredForChildSplitMin,
+         pBoostSamplingSetContext->m_bHistogramBuilt,
+         pSmallChangeToModelOverwriteSingleSamplingSet,
+         &gain
+      );
+   } else {
+      bError = BoostMultiDimensional(
+         pEbmBoostingState,
+         pCachedThreadResources,
+         pFeatureGroup,
+         iSamplingSet,
+         pBoostSamplingSetContext->m_cSamplesRequiredForChildSplitMin,
+         pSmallChangeToModelOverwriteSingleSamplingSet,
+         &gain
+      );
+   }
+   pCachedThreadResources->SetResult(bError, gain);
+}
+
 // a*PredictorScores = logOdds for binary classification
 // a*PredictorScores = logWeights for multiclass classification
 // a*PredictorScores = predictedValue for regression
 static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
    EbmBoostingState * const pEbmBoostingState,
+   const size_t iSlot,
    const size_t iFeatureGroup,
    const FloatEbmType learningRate,
    const size_t cTreeSplitsMax,
    const size_t cSamplesRequiredForChildSplitMin,
    const FloatEbmType * const aTrainingWeights,
    const FloatEbmType * const aValidationWeights,
+   const bool bHistogramBuilt,
    FloatEbmType * const pGainReturn
 ) {
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
    const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
 
-   // TODO remove this after we use aTrainingWeights and aValidationWeights into the GenerateModelFeatureGroupUpdatePerTargetClasses function
+   // sample weights are given when we initialize, and our exported function rejects these per-step weights
    UNUSED(aTrainingWeights);
    UNUSED(aValidationWeights);
 
@@ -591,66 +881,52 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
    const FeatureGroup * const pFeatureGroup = pEbmBoostingState->GetFeatureGroups()[iFeatureGroup];
    const size_t cDimensions = pFeatureGroup->GetCountFeatures();
 
-   pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->SetCountDimensions(cDimensions);
-   pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->Reset();
+   SegmentedTensor * const pSmallChangeToModelAccumulatedFromSamplingSets = 
+      pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets(iSlot);
+   pSmallChangeToModelAccumulatedFromSamplingSets->SetCountDimensions(cDimensions);
+   pSmallChangeToModelAccumulatedFromSamplingSets->Reset();
 
    // if pEbmBoostingState->m_apSamplingSets is nullptr, then we should have zero training samples
    // we can't be partially constructed here since then we wouldn't have returned our state pointer to our caller
 
    FloatEbmType totalGain = FloatEbmType { 0 };
    if(nullptr != pEbmBoostingState->GetSamplingSets()) {
-      pEbmBoostingState->GetSmallChangeToModelOverwriteSingleSamplingSet()->SetCountDimensions(cDimensions);
+      BoostSamplingSetContext boostSamplingSetContext;
+      boostSamplingSetContext.m_pEbmBoostingState = pEbmBoostingState;
+      boostSamplingSetContext.m_iSlot = iSlot;
+      boostSamplingSetContext.m_pFeatureGroup = pFeatureGroup;
+      boostSamplingSetContext.m_cTreeSplitsMax = cTreeSplitsMax;
+      boostSamplingSetContext.m_cSamplesRequiredForChildSplitMin = cSamplesRequiredForChildSplitMin;
+      boostSamplingSetContext.m_bHistogramBuilt = bHistogramBuilt;
+
+      if(nullptr != pEbmBoostingState->GetHistogramReduceFunction()) {
+         // every node needs to reduce the same histograms in the same order, so we can't let the bags race
+         for(size_t iSamplingSet = 0; iSamplingSet < cSamplingSetsAfterZero; ++iSamplingSet) {
+            BoostSamplingSetTask(&boostSamplingSetContext, iSamplingSet);
+         }
+      } else {
+         ThreadPool::ParallelFor(cSamplingSetsAfterZero, BoostSamplingSetTask, &boostSamplingSetContext);
+      }
 
+      // we combine the bags in bag order regardless of the order that they completed in.  Floating point addition isn't 
+      // associative, so this keeps our results identical to boosting the bags serially
       for(size_t iSamplingSet = 0; iSamplingSet < cSamplingSetsAfterZero; ++iSamplingSet) {
-         FloatEbmType gain = FloatEbmType { 0 };
-         if(UNLIKELY(UNLIKELY(0 == cTreeSplitsMax) || UNLIKELY(0 == pFeatureGroup->GetCountFeatures()))) {
-            if(BoostZeroDimensional(
-               pEbmBoostingState,
-               pEbmBoostingState->GetSamplingSets()[iSamplingSet],
-               pEbmBoostingState->GetSmallChangeToModelOverwriteSingleSamplingSet()
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
-               }
-               return nullptr;
-            }
-         } else if(1 == pFeatureGroup->GetCountFeatures()) {
-            if(BoostSingleDimensional(
-               pEbmBoostingState,
-               pFeatureGroup,
-               pEbmBoostingState->GetSamplingSets()[iSamplingSet],
-               cTreeSplitsMax,
-               cSamplesRequiredForChildSplitMin,
-               pEbmBoostingState->GetSmallChangeToModelOverwriteSingleSamplingSet(),
-               &gain
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
-               }
-               return nullptr;
-            }
-         } else {
-            if(BoostMultiDimensional(
-               pEbmBoostingState,
-               pFeatureGroup,
-               pEbmBoostingState->GetSamplingSets()[iSamplingSet],
-               cSamplesRequiredForChildSplitMin,
-               pEbmBoostingState->GetSmallChangeToModelOverwriteSingleSamplingSet(),
-               &gain
-            )) {
-               if(LIKELY(nullptr != pGainReturn)) {
-                  *pGainReturn = FloatEbmType { 0 };
-               }
-               return nullptr;
+         CachedBoostingThreadResources * const pCachedThreadResources = 
+            pEbmBoostingState->GetCachedThreadResources(iSlot, iSamplingSet);
+         if(pCachedThreadResources->IsError()) {
+            if(LIKELY(nullptr != pGainReturn)) {
+               *pGainReturn = FloatEbmType { 0 };
             }
+            return nullptr;
          }
+         const FloatEbmType gain = pCachedThreadResources->GetGain();
          // regression can be -infinity or slightly negative in extremely rare circumstances.  
          // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
          EBM_ASSERT(std::isnan(gain) || (!bClassification) && std::isinf(gain) || k_epsilonNegativeGainAllowed <= gain); // we previously normalized to 0
          totalGain += gain;
-         // TODO : when we thread this code, let's have each thread take a lock and update the combined line segment.  They'll each do it while the 
-         // others are working, so there should be no blocking and our final result won't require adding by the main thread
-         if(pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->Add(*pEbmBoostingState->GetSmallChangeToModelOverwriteSingleSamplingSet())) {
+         if(pSmallChangeToModelAccumulatedFromSamplingSets->Add(
+            *pCachedThreadResources->GetSmallChangeToModelOverwriteSingleSamplingSet()
+         )) {
             if(LIKELY(nullptr != pGainReturn)) {
                *pGainReturn = FloatEbmType { 0 };
             }
@@ -693,12 +969,12 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
 
          const bool bDividing = bExpandBinaryLogits && ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses;
          if(bDividing) {
-            bBad = pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero / 2);
+            bBad = pSmallChangeToModelAccumulatedFromSamplingSets->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero / 2);
          } else {
-            bBad = pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero);
+            bBad = pSmallChangeToModelAccumulatedFromSamplingSets->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero);
          }
       } else {
-         bBad = pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero);
+         bBad = pSmallChangeToModelAccumulatedFromSamplingSets->MultiplyAndCheckForIssues(learningRate / cSamplingSetsAfterZero);
       }
 
       // handle the case where totalGain is either +infinity or -infinity (very rare, see above), or NaN
@@ -709,8 +985,8 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
          UNLIKELY(totalGain <= std::numeric_limits<FloatEbmType>::lowest()) ||
          UNLIKELY(std::numeric_limits<FloatEbmType>::max() <= totalGain)
       )) {
-         pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->SetCountDimensions(cDimensions);
-         pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->Reset();
+         pSmallChangeToModelAccumulatedFromSamplingSets->SetCountDimensions(cDimensions);
+         pSmallChangeToModelAccumulatedFromSamplingSets->Reset();
          // declare there is no gain, so that our caller will think there is no benefit in splitting us, which there isn't since we're zeroed.
          totalGain = FloatEbmType { 0 };
       } else if(UNLIKELY(totalGain < FloatEbmType { 0 })) {
@@ -721,7 +997,7 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
    if(0 != cDimensions) {
       const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
 
-      // pEbmBoostingState->m_pSmallChangeToModelAccumulatedFromSamplingSets was reset above, so it isn't expanded.  We want to expand it before 
+      // pSmallChangeToModelAccumulatedFromSamplingSets was reset above, so it isn't expanded.  We want to expand it before 
       // calling ValidationSetInputFeatureLoop so that we can more efficiently lookup the results by index rather than do a binary search
       size_t acDivisionIntegersEnd[k_cDimensionsMax];
       size_t iDimension = 0;
@@ -729,7 +1005,7 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
          acDivisionIntegersEnd[iDimension] = pFeatureGroupEntry[iDimension].m_pFeature->GetCountBins();
          ++iDimension;
       } while(iDimension < cDimensions);
-      if(pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->Expand(acDivisionIntegersEnd)) {
+      if(pSmallChangeToModelAccumulatedFromSamplingSets->Expand(acDivisionIntegersEnd)) {
          if(LIKELY(nullptr != pGainReturn)) {
             *pGainReturn = FloatEbmType { 0 };
          }
@@ -742,13 +1018,90 @@ static FloatEbmType * GenerateModelFeatureGroupUpdateInternal(
    }
 
    LOG_0(TraceLevelVerbose, "Exited GenerateModelFeatureGroupUpdatePerTargetClasses");
-   return pEbmBoostingState->GetSmallChangeToModelAccumulatedFromSamplingSets()->GetValues();
+   return pSmallChangeToModelAccumulatedFromSamplingSets->GetValues();
+}
+
+class BinMainEffectsContext final {
+public:
+   EbmBoostingState * m_pEbmBoostingState;
+   size_t m_cMainEffects;
+   const size_t * m_aiSlots;
+   const FeatureGroup * const * m_apFeatureGroups;
+};
+
+// a pass over the samples reads the residuals once and the packed inputs of every main effect
+INLINE_ALWAYS static uint64_t GetPerformanceCounterMainEffectsBytes(
+   const size_t cSamples,
+   const size_t cMainEffects,
+   const FeatureGroup * const * const apFeatureGroups,
+   const size_t cVectorLength
+) {
+   uint64_t cBytes = GetPerformanceCounterSampleBytes(cSamples, nullptr, cVectorLength);
+   for(size_t iMainEffect = 0; iMainEffect < cMainEffects; ++iMainEffect) {
+      cBytes += GetPerformanceCounterSampleBytes(cSamples, apFeatureGroups[iMainEffect], 0);
+   }
+   return cBytes;
+}
+
+// builds the histograms of bag iSamplingSet for every main effect of the batch in a single pass over the residuals, 
+// each into the buffer of its own slot where BoostSingleDimensional expects it
+static void BinMainEffectsSamplingSetTask(void * const pContext, const size_t iSamplingSet) {
+   const BinMainEffectsContext * const pBinContext = static_cast<const BinMainEffectsContext *>(pContext);
+   EbmBoostingState * const pEbmBoostingState = pBinContext->m_pEbmBoostingState;
+   const size_t cMainEffects = pBinContext->m_cMainEffects;
+   EBM_ASSERT(cMainEffects <= k_cBoostingSlotsMax);
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses();
+   const bool bClassification = IsClassification(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   // EbmBoostingState::Allocate checked these and sized ThreadByteBuffer1 for our worst feature group
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength));
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+
+   HistogramBucketBase * aHistogramBucketBases[k_cBoostingSlotsMax];
+#ifndef NDEBUG
+   const unsigned char * aHistogramBucketsEndsDebug[k_cBoostingSlotsMax];
+#endif // NDEBUG
+   for(size_t iMainEffect = 0; iMainEffect < cMainEffects; ++iMainEffect) {
+      const FeatureGroup * const pFeatureGroup = pBinContext->m_apFeatureGroups[iMainEffect];
+      EBM_ASSERT(1 == pFeatureGroup->GetCountFeatures());
+      const size_t cHistogramBuckets = pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature->GetCountBins();
+      EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, cBytesPerHistogramBucket));
+      const size_t cBytesBuffer = cHistogramBuckets * cBytesPerHistogramBucket;
+      HistogramBucketBase * const aHistogramBuckets = pEbmBoostingState->GetCachedThreadResources(
+         pBinContext->m_aiSlots[iMainEffect], iSamplingSet)->GetThreadByteBuffer1(cBytesBuffer);
+      if(bClassification) {
+         ZeroSingleDimensionalHistogram<true>(cVectorLength, cHistogramBuckets, cBytesPerHistogramBucket, aHistogramBuckets);
+      } else {
+         ZeroSingleDimensionalHistogram<false>(cVectorLength, cHistogramBuckets, cBytesPerHistogramBucket, aHistogramBuckets);
+      }
+      aHistogramBucketBases[iMainEffect] = aHistogramBuckets;
+#ifndef NDEBUG
+      aHistogramBucketsEndsDebug[iMainEffect] = reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBytesBuffer;
+#endif // NDEBUG
+   }
+
+   const SamplingSet * const pTrainingSet = pEbmBoostingState->GetSamplingSets()[iSamplingSet];
+   PERFORMANCE_COUNTER_START(startBinBoosting);
+   BinBoostingMultiple(
+      pEbmBoostingState,
+      cMainEffects,
+      pBinContext->m_apFeatureGroups,
+      pTrainingSet,
+      aHistogramBucketBases
+#ifndef NDEBUG
+      , aHistogramBucketsEndsDebug
+#endif // NDEBUG
+   );
+   PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startBinBoosting, PerformanceCounterBinBoosting,
+      GetPerformanceCounterMainEffectsBytes(pTrainingSet->GetDataSetByFeatureGroup()->GetCountSamples(), cMainEffects, 
+         pBinContext->m_apFeatureGroups, cVectorLength));
 }
 
 // we made this a global because if we had put this variable inside the EbmBoostingState object, then we would need to dereference that before getting 
-// the count.  By making this global we can send a log message incase a bad EbmBoostingState object is sent into us we only decrease the count if the 
-// count is non-zero, so at worst if there is a race condition then we'll output this log message more times than desired, but we can live with that
-static int g_cLogGenerateModelFeatureGroupUpdateParametersMessages = 10;
+// the count.  By making this global we can send a log message incase a bad EbmBoostingState object is sent into us.  Concurrent slots call 
+// GenerateModelFeatureGroupUpdateSlot from several threads, so the count is atomic
+static std::atomic<int> g_cLogGenerateModelFeatureGroupUpdateParametersMessages { 10 };
 
 // TODO : change this so that our caller allocates the memory that contains the update, but this is complicated in various ways
 //        we don't want to just copy the internal tensor into the memory region that our caller provides, and we want to work with
@@ -767,11 +1120,13 @@ static int g_cLogGenerateModelFeatureGroupUpdateParametersMessages = 10;
 //        (which might happen in greedy algorithms)
 //        The other benefit of returning a compressed object is that our caller can store/copy it faster
 //        The other benefit of returning a compressed object is that it can be copied from process to process faster
-//        Lastly, with the memory allocated by our caller, we can call GenerateModelFeatureGroupUpdate in parallel on multiple feature_groups.  
-//        Right now you can't call it in parallel since we're updating our internal single tensor
+//        Lastly, with the memory allocated by our caller, we could call GenerateModelFeatureGroupUpdate in parallel on any 
+//        number of feature_groups.  Right now each slot has it's own internal tensor, so only as many calls as there are 
+//        slots can run in parallel, via GenerateModelFeatureGroupUpdateSlot
 
-EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdate(
+EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdateSlot(
    PEbmBoosting ebmBoosting,
+   IntEbmType indexSlot,
    IntEbmType indexFeatureGroup,
    FloatEbmType learningRate,
    IntEbmType countTreeSplitsMax,
@@ -784,10 +1139,11 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
       &g_cLogGenerateModelFeatureGroupUpdateParametersMessages,
       TraceLevelInfo,
       TraceLevelVerbose,
-      "GenerateModelFeatureGroupUpdate parameters: ebmBoosting=%p, indexFeatureGroup=%" IntEbmTypePrintf ", learningRate=%" FloatEbmTypePrintf
-      ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf
+      "GenerateModelFeatureGroupUpdateSlot parameters: ebmBoosting=%p, indexSlot=%" IntEbmTypePrintf ", indexFeatureGroup=%" IntEbmTypePrintf 
+      ", learningRate=%" FloatEbmTypePrintf ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" IntEbmTypePrintf
       ", trainingWeights=%p, validationWeights=%p, gainOut=%p",
       static_cast<void *>(ebmBoosting),
+      indexSlot,
       indexFeatureGroup,
       learningRate,
       countTreeSplitsMax,
@@ -805,6 +1161,21 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
       LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdate ebmBoosting cannot be nullptr");
       return nullptr;
    }
+   if(indexSlot < 0) {
+      if(LIKELY(nullptr != gainOut)) {
+         *gainOut = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdate indexSlot must be positive");
+      return nullptr;
+   }
+   if(!IsNumberConvertable<size_t>(indexSlot) || pEbmBoostingState->GetCountSlots() <= static_cast<size_t>(indexSlot)) {
+      if(LIKELY(nullptr != gainOut)) {
+         *gainOut = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdate indexSlot above the number of slots that we have");
+      return nullptr;
+   }
+   const size_t iSlot = static_cast<size_t>(indexSlot);
    if(indexFeatureGroup < 0) {
       if(LIKELY(nullptr != gainOut)) {
          *gainOut = FloatEbmType { 0 };
@@ -873,8 +1244,15 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
       LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdate countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
    }
 
-   EBM_ASSERT(nullptr == trainingWeights); // TODO : implement this later
-   EBM_ASSERT(nullptr == validationWeights); // TODO : implement this later
+   if(nullptr != trainingWeights || nullptr != validationWeights) {
+      // the weights change our bags and our metric denominators, so they need to be known when we initialize
+      if(LIKELY(nullptr != gainOut)) {
+         *gainOut = FloatEbmType { 0 };
+      }
+      LOG_0(TraceLevelError, 
+         "ERROR GenerateModelFeatureGroupUpdate trainingWeights and validationWeights must be nullptr.  Pass weights to InitializeBoostingClassificationWeighted or InitializeBoostingRegressionWeighted instead");
+      return nullptr;
+   }
    // gainOut can be nullptr
 
    if(ptrdiff_t { 0 } == pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses() || ptrdiff_t { 1 } == pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()) {
@@ -893,12 +1271,14 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
 
    FloatEbmType * aModelFeatureGroupUpdateTensor = GenerateModelFeatureGroupUpdateInternal(
       pEbmBoostingState,
+      iSlot,
       iFeatureGroup,
       learningRate,
       cTreeSplitsMax,
       cSamplesRequiredForChildSplitMin,
       trainingWeights,
       validationWeights,
+      false,
       gainOut
    );
 
@@ -928,3 +1308,187 @@ EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Gener
    return aModelFeatureGroupUpdateTensor;
 }
 
+EBM_NATIVE_IMPORT_EXPORT_BODY FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdate(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * validationWeights,
+   FloatEbmType * gainOut
+) {
+   // every booster has at least the first slot
+   return GenerateModelFeatureGroupUpdateSlot(
+      ebmBoosting,
+      IntEbmType { 0 },
+      indexFeatureGroup,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      trainingWeights,
+      validationWeights,
+      gainOut
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdateSlots(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSlots,
+   const IntEbmType * indexesFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   FloatEbmType ** modelFeatureGroupUpdateTensorsOut,
+   FloatEbmType * gainsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GenerateModelFeatureGroupUpdateSlots: ebmBoosting=%p, countSlots=%" IntEbmTypePrintf ", indexesFeatureGroup=%p"
+      ", learningRate=%" FloatEbmTypePrintf ", countTreeSplitsMax=%" IntEbmTypePrintf ", countSamplesRequiredForChildSplitMin=%" 
+      IntEbmTypePrintf ", modelFeatureGroupUpdateTensorsOut=%p, gainsOut=%p",
+      static_cast<void *>(ebmBoosting),
+      countSlots,
+      static_cast<const void *>(indexesFeatureGroup),
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      static_cast<void *>(modelFeatureGroupUpdateTensorsOut),
+      static_cast<void *>(gainsOut)
+   );
+
+   EbmBoostingState * pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots ebmBoosting cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(countSlots < 0) {
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots countSlots must be positive");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countSlots) || pEbmBoostingState->GetCountSlots() < static_cast<size_t>(countSlots)) {
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots countSlots above the number of slots that we have");
+      return IntEbmType { 1 };
+   }
+   const size_t cSlots = static_cast<size_t>(countSlots);
+   if(0 == cSlots) {
+      LOG_0(TraceLevelInfo, "Exited GenerateModelFeatureGroupUpdateSlots with no slots");
+      return IntEbmType { 0 };
+   }
+   if(nullptr == indexesFeatureGroup) {
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots indexesFeatureGroup cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(nullptr == modelFeatureGroupUpdateTensorsOut) {
+      LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots modelFeatureGroupUpdateTensorsOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   // gainsOut can be nullptr
+
+   size_t aiFeatureGroups[k_cBoostingSlotsMax];
+   for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+      modelFeatureGroupUpdateTensorsOut[iSlot] = nullptr;
+      if(nullptr != gainsOut) {
+         gainsOut[iSlot] = FloatEbmType { 0 };
+      }
+      const IntEbmType indexFeatureGroup = indexesFeatureGroup[iSlot];
+      if(indexFeatureGroup < 0 || !IsNumberConvertable<size_t>(indexFeatureGroup) || 
+         pEbmBoostingState->GetCountFeatureGroups() <= static_cast<size_t>(indexFeatureGroup)) 
+      {
+         LOG_0(TraceLevelError, "ERROR GenerateModelFeatureGroupUpdateSlots indexesFeatureGroup has an index outside of our feature groups");
+         return IntEbmType { 1 };
+      }
+      aiFeatureGroups[iSlot] = static_cast<size_t>(indexFeatureGroup);
+   }
+
+   if(std::isnan(learningRate)) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots learningRate is NaN");
+   } else if(std::isinf(learningRate)) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots learningRate is infinity");
+   } else if(0 == learningRate) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots learningRate is zero");
+   } else if(learningRate < FloatEbmType { 0 }) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots learningRate is negative");
+   }
+
+   size_t cTreeSplitsMax = 0;
+   if(countTreeSplitsMax < 0) {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots countTreeSplitsMax is negative.  Adjusting to zero.");
+   } else {
+      // we can never exceed a size_t number of splits, so the maximum generates the same results as the true number
+      cTreeSplitsMax = IsNumberConvertable<size_t>(countTreeSplitsMax) ? static_cast<size_t>(countTreeSplitsMax) : 
+         std::numeric_limits<size_t>::max();
+   }
+
+   size_t cSamplesRequiredForChildSplitMin = size_t { 1 }; // this is the min value
+   if(IntEbmType { 1 } <= countSamplesRequiredForChildSplitMin) {
+      cSamplesRequiredForChildSplitMin = IsNumberConvertable<size_t>(countSamplesRequiredForChildSplitMin) ? 
+         static_cast<size_t>(countSamplesRequiredForChildSplitMin) : std::numeric_limits<size_t>::max();
+   } else {
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots countSamplesRequiredForChildSplitMin can't be less than 1.  Adjusting to 1.");
+   }
+
+   if(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses() <= ptrdiff_t { 1 } && 
+      IsClassification(pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses())) 
+   {
+      // with fewer than 2 target classes there are no logits to update, so every slot is left with nullptr and no gain
+      LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots fewer than 2 target classes");
+      return IntEbmType { 0 };
+   }
+
+   // the main effects of the batch share a single pass over the residuals of each bag.  BinBoosting with several 
+   // shards and the histogram reduce function build each histogram their own way, so for those we 
+   // keep building the histogram of each slot separately, which gives the same updates
+   bool abHistogramBuilt[k_cBoostingSlotsMax];
+   size_t aiMainEffectSlots[k_cBoostingSlotsMax];
+   const FeatureGroup * apMainEffects[k_cBoostingSlotsMax];
+   size_t cMainEffects = 0;
+   const bool bShareBinning = nullptr != pEbmBoostingState->GetSamplingSets() && 0 != cTreeSplitsMax &&
+      size_t { 1 } == pEbmBoostingState->GetCountShards() && nullptr == pEbmBoostingState->GetHistogramReduceFunction();
+   for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+      const FeatureGroup * const pFeatureGroup = pEbmBoostingState->GetFeatureGroups()[aiFeatureGroups[iSlot]];
+      abHistogramBuilt[iSlot] = bShareBinning && size_t { 1 } == pFeatureGroup->GetCountFeatures();
+      if(abHistogramBuilt[iSlot]) {
+         aiMainEffectSlots[cMainEffects] = iSlot;
+         apMainEffects[cMainEffects] = pFeatureGroup;
+         ++cMainEffects;
+      }
+   }
+   if(0 != cMainEffects) {
+      BinMainEffectsContext binContext;
+      binContext.m_pEbmBoostingState = pEbmBoostingState;
+      binContext.m_cMainEffects = cMainEffects;
+      binContext.m_aiSlots = aiMainEffectSlots;
+      binContext.m_apFeatureGroups = apMainEffects;
+      const size_t cSamplingSetsAfterZero = 0 == pEbmBoostingState->GetCountSamplingSets() ? size_t { 1 } : 
+         pEbmBoostingState->GetCountSamplingSets();
+      ThreadPool::ParallelFor(cSamplingSetsAfterZero, BinMainEffectsSamplingSetTask, &binContext);
+   }
+
+   for(size_t iSlot = 0; iSlot < cSlots; ++iSlot) {
+      FloatEbmType gain = FloatEbmType { 0 };
+      FloatEbmType * const aModelFeatureGroupUpdateTensor = GenerateModelFeatureGroupUpdateInternal(
+         pEbmBoostingState,
+         iSlot,
+         aiFeatureGroups[iSlot],
+         learningRate,
+         cTreeSplitsMax,
+         cSamplesRequiredForChildSplitMin,
+         nullptr,
+         nullptr,
+         abHistogramBuilt[iSlot],
+         &gain
+      );
+      if(nullptr == aModelFeatureGroupUpdateTensor) {
+         LOG_0(TraceLevelWarning, "WARNING GenerateModelFeatureGroupUpdateSlots GenerateModelFeatureGroupUpdateInternal returned nullptr");
+         return IntEbmType { 1 };
+      }
+      modelFeatureGroupUpdateTensorsOut[iSlot] = aModelFeatureGroupUpdateTensor;
+      if(nullptr != gainsOut) {
+         gainsOut[iSlot] = gain;
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited GenerateModelFeatureGroupUpdateSlots");
+   return IntEbmType { 0 };
+}
@@ -7,8 +7,7 @@
 #include <type_traits> // std::is_standard_layout
 #include <stddef.h> // size_t, ptrdiff_t
 #include <string.h> // memcpy
-#include <vector>
-#include <queue>
+#include <algorithm> // std::push_heap, std::pop_heap, std::sort
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
@@ -75,9 +74,64 @@ static void Flatten(
 //   again on that side, then re-examine the second cut again.  For mains this would be very quick we have found that 2-3 cuts are optimimum.  
 //   Probably 1 cut isn't very good since with 2 cuts we can localize a region of high gain in the center somewhere
 
+// the extra pass over the buckets only pays for itself on nodes with at least this many cuts
+constexpr size_t k_cSweepScoresSimdCutsMin = 16;
+
+// fills the last 2 * cCutsMax items of aSweepScores with the node splitting scores of the left sides of the cuts that 
+// ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint would look at, followed by the scores of the right
+// sides.  We accumulate the sums in the same order as the sweep, so the scores are identical to the scalar ones.
+// This only works for a single logit
+template<bool bClassification>
+static void ComputeSweepScores(
+   const SimdKernels * const pSimdKernels,
+   const HistogramBucket<bClassification> * pHistogramBucketEntryCur,
+   const HistogramBucket<bClassification> * const pHistogramBucketEntryLast,
+   const size_t cBytesPerHistogramBucket,
+   size_t cSamplesRight,
+   FloatEbmType sumResidualErrorRight,
+   const size_t cSamplesRequiredForChildSplitMin,
+   const size_t cCutsMax,
+   FloatEbmType * const aSweepScores
+) {
+   FloatEbmType * const aSumsLeft = aSweepScores;
+   FloatEbmType * const aSumsRight = &aSweepScores[cCutsMax];
+   FloatEbmType * const aScoresLeft = &aSweepScores[cCutsMax * 2];
+   FloatEbmType * const aScoresRight = &aSweepScores[cCutsMax * 3];
+
+   size_t cSamplesLeft = 0;
+   FloatEbmType sumResidualErrorLeft = FloatEbmType { 0 };
+   size_t cCuts = 0;
+   do {
+      const size_t CHANGE_cSamples = pHistogramBucketEntryCur->GetCountSamplesInBucket();
+      cSamplesRight -= CHANGE_cSamples;
+      if(UNLIKELY(cSamplesRight < cSamplesRequiredForChildSplitMin)) {
+         break;
+      }
+      cSamplesLeft += CHANGE_cSamples;
+
+      const FloatEbmType CHANGE_sumResidualError = pHistogramBucketEntryCur->GetHistogramBucketVectorEntry()[0].m_sumResidualError;
+      sumResidualErrorRight = sumResidualErrorRight - CHANGE_sumResidualError;
+      sumResidualErrorLeft = sumResidualErrorLeft + CHANGE_sumResidualError;
+
+      EBM_ASSERT(cCuts < cCutsMax);
+      aSumsLeft[cCuts] = sumResidualErrorLeft;
+      aSumsRight[cCuts] = sumResidualErrorRight;
+      // cuts with too few samples on the left get a garbage score, which the sweep never reads
+      aScoresLeft[cCuts] = static_cast<FloatEbmType>(cSamplesLeft);
+      aScoresRight[cCuts] = static_cast<FloatEbmType>(cSamplesRight);
+      ++cCuts;
+
+      pHistogramBucketEntryCur = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketEntryCur, 1);
+   } while(pHistogramBucketEntryLast != pHistogramBucketEntryCur);
+
+   (*pSimdKernels->m_pNodeSplittingScores)(cCuts, aSumsLeft, aScoresLeft);
+   (*pSimdKernels->m_pNodeSplittingScores)(cCuts, aSumsRight, aScoresRight);
+}
+
 template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
    const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucket,
    TreeNode<IsClassification(compilerLearningTypeOrCountTargetClasses)> * pTreeNode,
    TreeNode<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pTreeNodeChildrenAvailableStorageSpaceCur,
@@ -107,8 +161,6 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    );
    const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
 
-   CachedBoostingThreadResources * const pCachedThreadResources = pEbmBoostingState->GetCachedThreadResources();
-
    HistogramBucketVectorEntry<bClassification> * const aSumHistogramBucketVectorEntryLeft =
       pCachedThreadResources->GetSumHistogramBucketVectorEntry1Array<bClassification>();
    for(size_t i = 0; i < cVectorLength; ++i) {
@@ -157,6 +209,34 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    FloatEbmType BEST_nodeSplittingScore = k_illegalGain;
    EBM_ASSERT(0 < cSamplesRequiredForChildSplitMin);
    EBM_ASSERT(pHistogramBucketEntryLast != pHistogramBucketEntryCur); // we wouldn't call this function on a non-splittable node
+
+   // the SIMD kernels compute the node splitting scores of all the cuts up front, which leaves the bookkeeping of the
+   // best cuts to the sweep below.  If we can't get the memory we compute the same scores in the sweep
+   const size_t cCutsMax = static_cast<size_t>(reinterpret_cast<const char *>(pHistogramBucketEntryLast) - 
+      reinterpret_cast<const char *>(pHistogramBucketEntryCur)) / cBytesPerHistogramBucket;
+   const FloatEbmType * aScoresLeft = nullptr;
+   const FloatEbmType * aScoresRight = nullptr;
+   const SimdKernels * const pSimdKernels = pEbmBoostingState->GetSimdKernels();
+   if(nullptr != pSimdKernels && 1 == cVectorLength && k_cSweepScoresSimdCutsMin <= cCutsMax && !IsMultiplyError(4, cCutsMax)) {
+      FloatEbmType * const aSweepScores = pCachedThreadResources->GetSweepScores(cCutsMax * 4);
+      if(nullptr != aSweepScores) {
+         ComputeSweepScores<bClassification>(
+            pSimdKernels,
+            pHistogramBucketEntryCur,
+            pHistogramBucketEntryLast,
+            cBytesPerHistogramBucket,
+            cSamplesRight,
+            aSumResidualErrorsRight[0],
+            cSamplesRequiredForChildSplitMin,
+            cCutsMax,
+            aSweepScores
+         );
+         aScoresLeft = &aSweepScores[cCutsMax * 2];
+         aScoresRight = &aSweepScores[cCutsMax * 3];
+      }
+   }
+
+   size_t iCut = 0;
    do {
       ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucketEntryCur, aHistogramBucketsEndDebug);
 
@@ -176,7 +256,9 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
 
          const FloatEbmType cSamplesRightFloatEbmType = static_cast<FloatEbmType>(cSamplesRight);
          const FloatEbmType cSamplesLeftFloatEbmType = static_cast<FloatEbmType>(cSamplesLeft);
-         FloatEbmType nodeSplittingScore = 0;
+         // keep the sides apart so that the children can reuse their own scores if we choose this split
+         FloatEbmType nodeSplittingScoreRightTotal = 0;
+         FloatEbmType nodeSplittingScoreLeftTotal = 0;
 
          for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
             const FloatEbmType CHANGE_sumResidualError = pHistogramBucketVectorEntry[iVector].m_sumResidualError;
@@ -186,18 +268,24 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
 
             // TODO : we can make this faster by doing the division in ComputeNodeSplittingScore after we add all the numerators 
             // (but only do this after we've determined the best node splitting score for classification, and the NewtonRaphsonStep for gain
-            const FloatEbmType nodeSplittingScoreRight = EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorRight, cSamplesRightFloatEbmType);
+            const FloatEbmType nodeSplittingScoreRight = nullptr != aScoresRight ? aScoresRight[iCut] :
+               EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorRight, cSamplesRightFloatEbmType);
             EBM_ASSERT(std::isnan(nodeSplittingScoreRight) || FloatEbmType { 0 } <= nodeSplittingScoreRight);
-            nodeSplittingScore += nodeSplittingScoreRight;
+            EBM_ASSERT(nullptr == aScoresRight || std::isnan(nodeSplittingScoreRight) || 
+               EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorRight, cSamplesRightFloatEbmType) == nodeSplittingScoreRight);
+            nodeSplittingScoreRightTotal += nodeSplittingScoreRight;
 
             const FloatEbmType sumResidualErrorLeft = aSumHistogramBucketVectorEntryLeft[iVector].m_sumResidualError + CHANGE_sumResidualError;
             aSumHistogramBucketVectorEntryLeft[iVector].m_sumResidualError = sumResidualErrorLeft;
 
             // TODO : we can make this faster by doing the division in ComputeNodeSplittingScore after we add all the numerators 
             // (but only do this after we've determined the best node splitting score for classification, and the NewtonRaphsonStep for gain
-            const FloatEbmType nodeSplittingScoreLeft = EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorLeft, cSamplesLeftFloatEbmType);
+            const FloatEbmType nodeSplittingScoreLeft = nullptr != aScoresLeft ? aScoresLeft[iCut] :
+               EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorLeft, cSamplesLeftFloatEbmType);
             EBM_ASSERT(std::isnan(nodeSplittingScoreLeft) || FloatEbmType { 0 } <= nodeSplittingScoreLeft);
-            nodeSplittingScore += nodeSplittingScoreLeft;
+            EBM_ASSERT(nullptr == aScoresLeft || std::isnan(nodeSplittingScoreLeft) || 
+               EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorLeft, cSamplesLeftFloatEbmType) == nodeSplittingScoreLeft);
+            nodeSplittingScoreLeftTotal += nodeSplittingScoreLeft;
 
             if(bClassification) {
                aSumHistogramBucketVectorEntryLeft[iVector].SetSumDenominator(
@@ -206,6 +294,7 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
                );
             }
          }
+         const FloatEbmType nodeSplittingScore = nodeSplittingScoreRightTotal + nodeSplittingScoreLeftTotal;
          EBM_ASSERT(std::isnan(nodeSplittingScore) || FloatEbmType { 0 } <= nodeSplittingScore);
 
          // if we get a NaN result, we'd like to propagate it by making bestSplit NaN.  The rules for NaN values say that non equality comparisons are 
@@ -242,6 +331,8 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
 
             pSweepTreeNodeCur->SetBestHistogramBucketEntry(pHistogramBucketEntryCur);
             pSweepTreeNodeCur->SetCountBestSamplesLeft(cSamplesLeft);
+            pSweepTreeNodeCur->SetBestSplittingScoreLeft(nodeSplittingScoreLeftTotal);
+            pSweepTreeNodeCur->SetBestSplittingScoreRight(nodeSplittingScoreRightTotal);
             memcpy(
                pSweepTreeNodeCur->GetBestHistogramBucketVectorEntry(), aSumHistogramBucketVectorEntryLeft,
                sizeof(*aSumHistogramBucketVectorEntryLeft) * cVectorLength
@@ -265,6 +356,7 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
          }
       }
       pHistogramBucketEntryCur = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucketEntryCur, 1);
+      ++iCut;
    } while(pHistogramBucketEntryLast != pHistogramBucketEntryCur);
 
    // handle the case where BEST_nodeSplittingScore is +infinity 
@@ -278,7 +370,7 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    }
    EBM_ASSERT(FloatEbmType { 0 } <= BEST_nodeSplittingScore);
 
-   RandomStream * const pRandomStream = pEbmBoostingState->GetRandomStream();
+   RandomStream * const pRandomStream = pCachedThreadResources->GetRandomStream();
 
    const size_t cSweepItems = CountSweepTreeNode(pSweepTreeNodeStart, pSweepTreeNodeCur, cBytesPerSweepTreeNode);
    if(UNLIKELY(1 < cSweepItems)) {
@@ -293,6 +385,7 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    pLeftChild->BEFORE_SetHistogramBucketEntryLast(BEST_pHistogramBucketEntry);
    const size_t BEST_cSamplesLeft = pSweepTreeNodeStart->GetCountBestSamplesLeft();
    pLeftChild->AMBIGUOUS_SetSamples(BEST_cSamplesLeft);
+   pLeftChild->BEFORE_SetSplittingScore(pSweepTreeNodeStart->GetBestSplittingScoreLeft());
 
    const HistogramBucket<bClassification> * const BEST_pHistogramBucketEntryNext =
       GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, BEST_pHistogramBucketEntry, 1);
@@ -303,8 +396,7 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    pRightChild->BEFORE_SetHistogramBucketEntryFirst(BEST_pHistogramBucketEntryNext);
    const size_t cSamplesParent = pTreeNode->AMBIGUOUS_GetSamples();
    pRightChild->AMBIGUOUS_SetSamples(cSamplesParent - BEST_cSamplesLeft);
-
-   const FloatEbmType cSamplesParentFloatEbmType = static_cast<FloatEbmType>(cSamplesParent);
+   pRightChild->BEFORE_SetSplittingScore(pSweepTreeNodeStart->GetBestSplittingScoreRight());
 
    // if the total samples is 0 then we should be using our specialty handling of that case
    // if the total samples if not 0, then our splitting code should never split any node that has zero on either the left or right, so no new 
@@ -323,8 +415,8 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
    const HistogramBucketVectorEntry<bClassification> * pHistogramBucketVectorEntrySweep =
       pSweepTreeNodeStart->GetBestHistogramBucketVectorEntry();
 
-   // TODO: usually we've done this calculation for the parent already.  Why not keep the result arround to avoid extra work?
-   FloatEbmType originalParentScore = 0;
+   // our parent computed our score when it chose its split (or GrowDecisionTree did for the root), so don't recompute it
+   const FloatEbmType originalParentScore = pTreeNode->BEFORE_GetSplittingScore();
    for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
       const FloatEbmType BEST_sumResidualErrorLeft = pHistogramBucketVectorEntrySweep[iVector].m_sumResidualError;
       pHistogramBucketVectorEntryLeftChild[iVector].m_sumResidualError = BEST_sumResidualErrorLeft;
@@ -332,10 +424,6 @@ static bool ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint(
       const FloatEbmType sumResidualErrorParent = pHistogramBucketVectorEntryTreeNode[iVector].m_sumResidualError;
       pHistogramBucketVectorEntryRightChild[iVector].m_sumResidualError = sumResidualErrorParent - BEST_sumResidualErrorLeft;
 
-      const FloatEbmType originalParentScoreUpdate = EbmStatistics::ComputeNodeSplittingScore(sumResidualErrorParent, cSamplesParentFloatEbmType);
-      EBM_ASSERT(std::isnan(originalParentScoreUpdate) || FloatEbmType { 0 } <= originalParentScoreUpdate);
-      originalParentScore += originalParentScoreUpdate;
-
       if(bClassification) {
          const FloatEbmType BEST_sumDenominatorLeft = pHistogramBucketVectorEntrySweep[iVector].GetSumDenominator();
          pHistogramBucketVectorEntryLeftChild[iVector].SetSumDenominator(BEST_sumDenominatorLeft);
@@ -396,14 +484,81 @@ public:
    }
 };
 
+class NominalBucketKeyLess final {
+   const FloatEbmType * const m_aKeys;
+
+public:
+
+   NominalBucketKeyLess(const FloatEbmType * const aKeys) :
+      m_aKeys(aKeys) {
+   }
+
+   INLINE_ALWAYS bool operator() (const size_t iBucket1, const size_t iBucket2) const {
+      // the bucket index breaks ties so that our trees don't depend on the std::sort implementation
+      const FloatEbmType key1 = m_aKeys[iBucket1];
+      const FloatEbmType key2 = m_aKeys[iBucket2];
+      return key1 < key2 || key1 == key2 && iBucket1 < iBucket2;
+   }
+};
+
+// the tree in pSmallChangeToModel was grown over the reordered buckets, so its divisions are in that order.  Rewrite it
+// with a division between every bucket in the original order and the value of the leaf that holds each bucket
+static bool SpreadNominalUpdate(
+   SegmentedTensor * const pSmallChangeToModel,
+   const size_t cVectorLength,
+   const size_t cHistogramBuckets,
+   const size_t * const aiOriginalBuckets,
+   FloatEbmType * const aValues
+) {
+   const size_t cDivisions = pSmallChangeToModel->GetCountDivisions(0);
+   if(size_t { 0 } == cDivisions) {
+      // a single value applies to every category regardless of their order
+      return false;
+   }
+   EBM_ASSERT(cDivisions < cHistogramBuckets);
+
+   const ActiveDataType * const aDivisions = pSmallChangeToModel->GetDivisionPointer(0);
+   const FloatEbmType * const aLeafValues = pSmallChangeToModel->GetValuePointer();
+   size_t iLeaf = 0;
+   for(size_t iOrdered = 0; iOrdered < cHistogramBuckets; ++iOrdered) {
+      memcpy(
+         &aValues[aiOriginalBuckets[iOrdered] * cVectorLength],
+         &aLeafValues[iLeaf * cVectorLength],
+         sizeof(*aValues) * cVectorLength
+      );
+      // each division is the index of the last bucket in the lower leaf
+      if(iLeaf < cDivisions && static_cast<size_t>(aDivisions[iLeaf]) == iOrdered) {
+         ++iLeaf;
+      }
+   }
+   EBM_ASSERT(cDivisions == iLeaf);
+
+   if(UNLIKELY(pSmallChangeToModel->SetCountDivisions(0, cHistogramBuckets - size_t { 1 }))) {
+      LOG_0(TraceLevelWarning, "WARNING SpreadNominalUpdate pSmallChangeToModel->SetCountDivisions(0, cHistogramBuckets - 1)");
+      return true;
+   }
+   // EbmBoostingState::Initialize checked that cHistogramBuckets * cVectorLength FloatEbmType values fit into memory
+   if(UNLIKELY(pSmallChangeToModel->EnsureValueCapacity(cVectorLength * cHistogramBuckets))) {
+      LOG_0(TraceLevelWarning, "WARNING SpreadNominalUpdate pSmallChangeToModel->EnsureValueCapacity(cVectorLength * cHistogramBuckets)");
+      return true;
+   }
+   ActiveDataType * const aNewDivisions = pSmallChangeToModel->GetDivisionPointer(0);
+   for(size_t iDivision = 0; iDivision < cHistogramBuckets - size_t { 1 }; ++iDivision) {
+      aNewDivisions[iDivision] = static_cast<ActiveDataType>(iDivision);
+   }
+   memcpy(pSmallChangeToModel->GetValuePointer(), aValues, sizeof(*aValues) * cVectorLength * cHistogramBuckets);
+   return false;
+}
+
 template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
 class GrowDecisionTreeInternal final {
 public:
 
    GrowDecisionTreeInternal() = delete; // this is a static class.  Do not construct
 
-   static bool Func(
+   static bool GrowOrdinal(
       EbmBoostingState * const pEbmBoostingState,
+      CachedBoostingThreadResources * const pCachedThreadResources,
       const size_t cHistogramBuckets,
       const HistogramBucketBase * const aHistogramBucketBase,
       const size_t cSamplesTotal,
@@ -446,24 +601,14 @@ public:
       EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
       const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
 
-   retry_with_bigger_tree_node_children_array:
-
-      CachedBoostingThreadResources * pCachedThreadResources = pEbmBoostingState->GetCachedThreadResources();
-
-      size_t cBytesBuffer2 = pCachedThreadResources->GetThreadByteBuffer2Size();
       // we need 1 TreeNode for the root, 1 for the left child of the root and 1 for the right child of the root
       const size_t cBytesInitialNeededAllocation = 3 * cBytesPerTreeNode;
-      if(cBytesBuffer2 < cBytesInitialNeededAllocation) {
-         // TODO : we can eliminate this check as long as we ensure that the ThreadByteBuffer2 is always initialized to be equal to the size of three 
-         // TreeNodes (left and right) == GET_SIZEOF_ONE_TREE_NODE_CHILDREN(cBytesPerTreeNode), or the number of bins (interactions multiply bins) on the 
-         // highest bin count feature
-         if(pCachedThreadResources->GrowThreadByteBuffer2(cBytesInitialNeededAllocation)) {
-            LOG_0(TraceLevelWarning, "WARNING GrowDecisionTree pCachedThreadResources->GrowThreadByteBuffer2(cBytesInitialNeededAllocation)");
-            return true;
-         }
-         cBytesBuffer2 = pCachedThreadResources->GetThreadByteBuffer2Size();
-         EBM_ASSERT(cBytesInitialNeededAllocation <= cBytesBuffer2);
-      }
+      // EbmBoostingState::Allocate sized ThreadByteBuffer2 for the largest tree that any of our features can grow.  Every 
+      // node that we examine successfully consumes 2 TreeNodes for its children, and each of those nodes splits between a 
+      // different pair of neighbouring buckets, so after the root and its children we examine at most 
+      // cHistogramBuckets - 2 more nodes successfully, which is 2 * cHistogramBuckets - 1 TreeNodes in total
+      EBM_ASSERT(!IsMultiplyError(cBytesPerTreeNode, (cHistogramBuckets << 1) - 1));
+      EBM_ASSERT(cBytesPerTreeNode * ((cHistogramBuckets << 1) - 1) <= pCachedThreadResources->GetThreadByteBuffer2Size());
       TreeNode<bClassification> * pRootTreeNode =
          static_cast<TreeNode<bClassification> *>(pCachedThreadResources->GetThreadByteBuffer2());
 
@@ -482,6 +627,17 @@ public:
       );
       pRootTreeNode->AMBIGUOUS_SetSamples(cSamplesTotal);
 
+      // the children get their scores from the sweep that splits their parent, but the root has no parent
+      const FloatEbmType cSamplesTotalFloatEbmType = static_cast<FloatEbmType>(cSamplesTotal);
+      FloatEbmType rootSplittingScore = 0;
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         const FloatEbmType rootSplittingScoreUpdate = EbmStatistics::ComputeNodeSplittingScore(
+            aSumHistogramBucketVectorEntry[iVector].m_sumResidualError, cSamplesTotalFloatEbmType);
+         EBM_ASSERT(std::isnan(rootSplittingScoreUpdate) || FloatEbmType { 0 } <= rootSplittingScoreUpdate);
+         rootSplittingScore += rootSplittingScoreUpdate;
+      }
+      pRootTreeNode->BEFORE_SetSplittingScore(rootSplittingScore);
+
       // copying existing mem
       memcpy(
          pRootTreeNode->GetHistogramBucketVectorEntry(),
@@ -492,6 +648,7 @@ public:
       size_t cSplits;
       if(ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint<compilerLearningTypeOrCountTargetClasses>(
          pEbmBoostingState,
+         pCachedThreadResources,
          aHistogramBucket,
          pRootTreeNode,
          AddBytesTreeNode<bClassification>(pRootTreeNode, cBytesPerTreeNode),
@@ -607,165 +764,160 @@ public:
       // since it handles all scenarios without any real cost and is simpler
       // than implementing an optional array scan PLUS a priority queue for deep trees.
 
-      // TODO: someday see if we can replace this with an in-class priority queue that stores it's info inside
-      //       the TreeNode datastructure
-
-      try {
-         std::priority_queue<
-            TreeNode<bClassification> *,
-            std::vector<TreeNode<bClassification> *>,
-            CompareTreeNodeSplittingGain<bClassification>
-         > bestTreeNodeToSplit;
-
-         cSplits = 0;
-         TreeNode<bClassification> * pParentTreeNode = pRootTreeNode;
-
-         // we skip 3 tree nodes.  The root, the left child of the root, and the right child of the root
-         TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceCur =
-            AddBytesTreeNode<bClassification>(pRootTreeNode, cBytesInitialNeededAllocation);
-
-         FloatEbmType totalGain = FloatEbmType { 0 };
-
-         goto skip_first_push_pop;
-
-         do {
-            // there is no way to get the top and pop at the same time.. would be good to get a better queue, but our code isn't bottlenecked by it
-            pParentTreeNode = bestTreeNodeToSplit.top();
-            // In theory we can have nodes with equal gain values here, but this is very very rare to occur in practice
-            // We handle equal gain values in ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint because we 
-            // can have zero instnaces in bins, in which case it occurs, but those equivalent situations have been cleansed by
-            // the time we reach this code, so the only realistic scenario where we might get equivalent gains is if we had an almost
-            // symetric distribution samples bin distributions AND two tail ends that happen to have the same statistics AND
-            // either this is our first cut, or we've only made a single cut in the center in the case where there is symetry in the center
-            // Even if all of these things are true, after one non-symetric cut, we won't see that scenario anymore since the residuals won't be
-            // symetric anymore.  This is so rare, and limited to one cut, so we shouldn't bother to handle it since the complexity of doing so
-            // outweights the benefits.
-            bestTreeNodeToSplit.pop();
-
-         skip_first_push_pop:
-
-            // ONLY AFTER WE'VE POPPED pParentTreeNode OFF the priority queue is it considered to have been split.  Calling SPLIT_THIS_NODE makes it formal
-            const FloatEbmType totalGainUpdate = pParentTreeNode->EXTRACT_GAIN_BEFORE_SPLITTING();
-            EBM_ASSERT(std::isnan(totalGainUpdate) || (!bClassification) && std::isinf(totalGainUpdate) ||
-               k_epsilonNegativeGainAllowed <= totalGainUpdate);
-            totalGain += totalGainUpdate;
-
-            pParentTreeNode->SPLIT_THIS_NODE();
-
-            TreeNode<bClassification> * const pLeftChild =
-               GetLeftTreeNodeChild<bClassification>(
-                  pParentTreeNode->AFTER_GetTreeNodeChildren(),
-                  cBytesPerTreeNode
-                  );
-            if(pLeftChild->IsSplittable()) {
-               TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceNext =
-                  AddBytesTreeNode<bClassification>(pTreeNodeChildrenAvailableStorageSpaceCur, cBytesPerTreeNode << 1);
-               if(cBytesBuffer2 <
-                  static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceNext) - reinterpret_cast<char *>(pRootTreeNode))) {
-                  if(pCachedThreadResources->GrowThreadByteBuffer2(cBytesPerTreeNode)) {
-                     LOG_0(TraceLevelWarning, "WARNING GrowDecisionTree pCachedThreadResources->GrowThreadByteBuffer2(cBytesPerTreeNode)");
-                     return true;
-                  }
-                  goto retry_with_bigger_tree_node_children_array;
-               }
-               // the act of splitting it implicitly sets INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED
-               // because splitting sets splitGain to a non-illegalGain value
-               if(!ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint<compilerLearningTypeOrCountTargetClasses>(
-                  pEbmBoostingState,
-                  aHistogramBucket,
-                  pLeftChild,
-                  pTreeNodeChildrenAvailableStorageSpaceCur,
-                  cSamplesRequiredForChildSplitMin
+      // the priority queue is a heap of TreeNode pointers in a buffer that EbmBoostingState::Allocate sized for our 
+      // largest feature, so growing the tree doesn't allocate or throw.  We use std::push_heap and std::pop_heap, which is what 
+      // std::priority_queue uses, so we split nodes in exactly the same order that it would.
+      //
+      // each split pops one node and pushes at most two, so after cSplits splits we hold at most cSplits + 1 nodes, 
+      // and we can't ever hold more nodes than there are leaves, which is at most cHistogramBuckets
+      const size_t cTreeNodeHeapMax = std::min(cTreeSplitsMax, cHistogramBuckets - 1) + 1;
+      EBM_ASSERT(!IsMultiplyError(sizeof(TreeNode<bClassification> *), cTreeNodeHeapMax)); // we have this many buckets
+      TreeNode<bClassification> ** const apTreeNodeHeap = static_cast<TreeNode<bClassification> **>(
+         pCachedThreadResources->GetTreeNodeHeap(sizeof(TreeNode<bClassification> *) * cTreeNodeHeapMax));
+      size_t cTreeNodeHeap = 0;
+      const CompareTreeNodeSplittingGain<bClassification> compareTreeNodeSplittingGain {};
+
+      cSplits = 0;
+      TreeNode<bClassification> * pParentTreeNode = pRootTreeNode;
+
+      // we skip 3 tree nodes.  The root, the left child of the root, and the right child of the root
+      TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceCur =
+         AddBytesTreeNode<bClassification>(pRootTreeNode, cBytesInitialNeededAllocation);
+
+      FloatEbmType totalGain = FloatEbmType { 0 };
+
+      goto skip_first_push_pop;
+
+      do {
+         pParentTreeNode = apTreeNodeHeap[0];
+         // In theory we can have nodes with equal gain values here, but this is very very rare to occur in practice
+         // We handle equal gain values in ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint because we 
+         // can have zero instnaces in bins, in which case it occurs, but those equivalent situations have been cleansed by
+         // the time we reach this code, so the only realistic scenario where we might get equivalent gains is if we had an almost
+         // symetric distribution samples bin distributions AND two tail ends that happen to have the same statistics AND
+         // either this is our first cut, or we've only made a single cut in the center in the case where there is symetry in the center
+         // Even if all of these things are true, after one non-symetric cut, we won't see that scenario anymore since the residuals won't be
+         // symetric anymore.  This is so rare, and limited to one cut, so we shouldn't bother to handle it since the complexity of doing so
+         // outweights the benefits.
+         std::pop_heap(apTreeNodeHeap, apTreeNodeHeap + cTreeNodeHeap, compareTreeNodeSplittingGain);
+         --cTreeNodeHeap;
+
+      skip_first_push_pop:
+
+         // ONLY AFTER WE'VE POPPED pParentTreeNode OFF the priority queue is it considered to have been split.  Calling SPLIT_THIS_NODE makes it formal
+         const FloatEbmType totalGainUpdate = pParentTreeNode->EXTRACT_GAIN_BEFORE_SPLITTING();
+         EBM_ASSERT(std::isnan(totalGainUpdate) || (!bClassification) && std::isinf(totalGainUpdate) ||
+            k_epsilonNegativeGainAllowed <= totalGainUpdate);
+         totalGain += totalGainUpdate;
+
+         pParentTreeNode->SPLIT_THIS_NODE();
+
+         TreeNode<bClassification> * const pLeftChild =
+            GetLeftTreeNodeChild<bClassification>(
+               pParentTreeNode->AFTER_GetTreeNodeChildren(),
+               cBytesPerTreeNode
+               );
+         if(pLeftChild->IsSplittable()) {
+            TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceNext =
+               AddBytesTreeNode<bClassification>(pTreeNodeChildrenAvailableStorageSpaceCur, cBytesPerTreeNode << 1);
+            EBM_ASSERT(static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceNext) - 
+               reinterpret_cast<char *>(pRootTreeNode)) <= pCachedThreadResources->GetThreadByteBuffer2Size());
+            // the act of splitting it implicitly sets INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED
+            // because splitting sets splitGain to a non-illegalGain value
+            if(!ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint<compilerLearningTypeOrCountTargetClasses>(
+               pEbmBoostingState,
+               pCachedThreadResources,
+               aHistogramBucket,
+               pLeftChild,
+               pTreeNodeChildrenAvailableStorageSpaceCur,
+               cSamplesRequiredForChildSplitMin
 #ifndef NDEBUG
-                  , aHistogramBucketsEndDebug
+               , aHistogramBucketsEndDebug
 #endif // NDEBUG
-                  )) {
-                  pTreeNodeChildrenAvailableStorageSpaceCur = pTreeNodeChildrenAvailableStorageSpaceNext;
-                  bestTreeNodeToSplit.push(pLeftChild);
-               } else {
-                  goto no_left_split;
-               }
+               )) {
+               pTreeNodeChildrenAvailableStorageSpaceCur = pTreeNodeChildrenAvailableStorageSpaceNext;
+               EBM_ASSERT(cTreeNodeHeap < cTreeNodeHeapMax);
+               apTreeNodeHeap[cTreeNodeHeap] = pLeftChild;
+               ++cTreeNodeHeap;
+               std::push_heap(apTreeNodeHeap, apTreeNodeHeap + cTreeNodeHeap, compareTreeNodeSplittingGain);
             } else {
-            no_left_split:;
-               // we aren't going to split this TreeNode because we can't.  We need to set the splitGain value here because otherwise it is filled with 
-               // garbage that could be k_illegalGain (meaning the node was a branch) we can't call INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
-               // before calling SplitTreeNode because INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED sets 
-               // m_UNION.m_afterExaminationForPossibleSplitting.m_splitGain and the m_UNION.m_beforeExaminationForPossibleSplitting values are 
-               // needed if we had decided to call ExamineNodeForSplittingAndDetermineBestPossibleSplit
+               goto no_left_split;
+            }
+         } else {
+         no_left_split:;
+            // we aren't going to split this TreeNode because we can't.  We need to set the splitGain value here because otherwise it is filled with 
+            // garbage that could be k_illegalGain (meaning the node was a branch) we can't call INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
+            // before calling SplitTreeNode because INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED sets 
+            // m_UNION.m_afterExaminationForPossibleSplitting.m_splitGain and the m_UNION.m_beforeExaminationForPossibleSplitting values are 
+            // needed if we had decided to call ExamineNodeForSplittingAndDetermineBestPossibleSplit
 
 #ifndef NDEBUG
-               pLeftChild->SetExaminedForPossibleSplitting(true);
+            pLeftChild->SetExaminedForPossibleSplitting(true);
 #endif // NDEBUG
 
-               pLeftChild->INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED();
-            }
+            pLeftChild->INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED();
+         }
 
-            TreeNode<bClassification> * const pRightChild = GetRightTreeNodeChild<bClassification>(
-               pParentTreeNode->AFTER_GetTreeNodeChildren(),
-               cBytesPerTreeNode
-               );
-            if(pRightChild->IsSplittable()) {
-               TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceNext =
-                  AddBytesTreeNode<bClassification>(pTreeNodeChildrenAvailableStorageSpaceCur, cBytesPerTreeNode << 1);
-               if(cBytesBuffer2 <
-                  static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceNext) - reinterpret_cast<char *>(pRootTreeNode))) {
-                  if(pCachedThreadResources->GrowThreadByteBuffer2(cBytesPerTreeNode)) {
-                     LOG_0(TraceLevelWarning, "WARNING GrowDecisionTree pCachedThreadResources->GrowThreadByteBuffer2(cBytesPerTreeNode)");
-                     return true;
-                  }
-                  goto retry_with_bigger_tree_node_children_array;
-               }
-               // the act of splitting it implicitly sets INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
-               // because splitting sets splitGain to a non-NaN value
-               if(!ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint<compilerLearningTypeOrCountTargetClasses>(
-                  pEbmBoostingState,
-                  aHistogramBucket,
-                  pRightChild,
-                  pTreeNodeChildrenAvailableStorageSpaceCur,
-                  cSamplesRequiredForChildSplitMin
+         TreeNode<bClassification> * const pRightChild = GetRightTreeNodeChild<bClassification>(
+            pParentTreeNode->AFTER_GetTreeNodeChildren(),
+            cBytesPerTreeNode
+            );
+         if(pRightChild->IsSplittable()) {
+            TreeNode<bClassification> * pTreeNodeChildrenAvailableStorageSpaceNext =
+               AddBytesTreeNode<bClassification>(pTreeNodeChildrenAvailableStorageSpaceCur, cBytesPerTreeNode << 1);
+            EBM_ASSERT(static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceNext) - 
+               reinterpret_cast<char *>(pRootTreeNode)) <= pCachedThreadResources->GetThreadByteBuffer2Size());
+            // the act of splitting it implicitly sets INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
+            // because splitting sets splitGain to a non-NaN value
+            if(!ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint<compilerLearningTypeOrCountTargetClasses>(
+               pEbmBoostingState,
+               pCachedThreadResources,
+               aHistogramBucket,
+               pRightChild,
+               pTreeNodeChildrenAvailableStorageSpaceCur,
+               cSamplesRequiredForChildSplitMin
 #ifndef NDEBUG
-                  , aHistogramBucketsEndDebug
+               , aHistogramBucketsEndDebug
 #endif // NDEBUG
-                  )) {
-                  pTreeNodeChildrenAvailableStorageSpaceCur = pTreeNodeChildrenAvailableStorageSpaceNext;
-                  bestTreeNodeToSplit.push(pRightChild);
-               } else {
-                  goto no_right_split;
-               }
+               )) {
+               pTreeNodeChildrenAvailableStorageSpaceCur = pTreeNodeChildrenAvailableStorageSpaceNext;
+               EBM_ASSERT(cTreeNodeHeap < cTreeNodeHeapMax);
+               apTreeNodeHeap[cTreeNodeHeap] = pRightChild;
+               ++cTreeNodeHeap;
+               std::push_heap(apTreeNodeHeap, apTreeNodeHeap + cTreeNodeHeap, compareTreeNodeSplittingGain);
             } else {
-            no_right_split:;
-               // we aren't going to split this TreeNode because we can't.  We need to set the splitGain value here because otherwise it is filled with 
-               // garbage that could be k_illegalGain (meaning the node was a branch) we can't call INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
-               // before calling SplitTreeNode because INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED sets 
-               // m_UNION.m_afterExaminationForPossibleSplitting.m_splitGain and the m_UNION.m_beforeExaminationForPossibleSplitting values are needed 
-               // if we had decided to call ExamineNodeForSplittingAndDetermineBestPossibleSplit
+               goto no_right_split;
+            }
+         } else {
+         no_right_split:;
+            // we aren't going to split this TreeNode because we can't.  We need to set the splitGain value here because otherwise it is filled with 
+            // garbage that could be k_illegalGain (meaning the node was a branch) we can't call INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED 
+            // before calling SplitTreeNode because INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED sets 
+            // m_UNION.m_afterExaminationForPossibleSplitting.m_splitGain and the m_UNION.m_beforeExaminationForPossibleSplitting values are needed 
+            // if we had decided to call ExamineNodeForSplittingAndDetermineBestPossibleSplit
 
 #ifndef NDEBUG
-               pRightChild->SetExaminedForPossibleSplitting(true);
+            pRightChild->SetExaminedForPossibleSplitting(true);
 #endif // NDEBUG
 
-               pRightChild->INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED();
-            }
-            ++cSplits;
-         } while(cSplits < cTreeSplitsMax && UNLIKELY(!bestTreeNodeToSplit.empty()));
-         // we DON'T need to call SetLeafAfterDone() on any items that remain in the bestTreeNodeToSplit queue because everything in that queue has set 
-         // a non-NaN nodeSplittingScore value
-
-         // regression can be -infinity or slightly negative in extremely rare circumstances.
-         // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
-         EBM_ASSERT(std::isnan(totalGain) || (!bClassification) && std::isinf(totalGain) ||
-            k_epsilonNegativeGainAllowed <= totalGain);
-         // we might as well dump this value out to our pointer, even if later fail the function below.  If the function is failed, we make no guarantees 
-         // about what we did with the value pointed to at *pTotalGain don't normalize totalGain here, because we normalize the average outside of this function!
-         *pTotalGain = totalGain;
-         EBM_ASSERT(
-            static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceCur) - reinterpret_cast<char *>(pRootTreeNode)) <= cBytesBuffer2
-         );
-      } catch(...) {
-         // calling anything inside bestTreeNodeToSplit can throw exceptions
-         LOG_0(TraceLevelWarning, "WARNING GrowDecisionTree exception");
-         return true;
-      }
+            pRightChild->INDICATE_THIS_NODE_EXAMINED_FOR_SPLIT_AND_REJECTED();
+         }
+         ++cSplits;
+      } while(cSplits < cTreeSplitsMax && UNLIKELY(0 != cTreeNodeHeap));
+      // we DON'T need to call SetLeafAfterDone() on any items that remain in the apTreeNodeHeap queue because everything in that queue has set 
+      // a non-NaN nodeSplittingScore value
+
+      // regression can be -infinity or slightly negative in extremely rare circumstances.
+      // See ExamineNodeForPossibleFutureSplittingAndDetermineBestSplitPoint for details, and the equivalent interaction function
+      EBM_ASSERT(std::isnan(totalGain) || (!bClassification) && std::isinf(totalGain) ||
+         k_epsilonNegativeGainAllowed <= totalGain);
+      // we might as well dump this value out to our pointer, even if later fail the function below.  If the function is failed, we make no guarantees 
+      // about what we did with the value pointed to at *pTotalGain don't normalize totalGain here, because we normalize the average outside of this function!
+      *pTotalGain = totalGain;
+      EBM_ASSERT(
+         static_cast<size_t>(reinterpret_cast<char *>(pTreeNodeChildrenAvailableStorageSpaceCur) - reinterpret_cast<char *>(pRootTreeNode)) <= 
+         pCachedThreadResources->GetThreadByteBuffer2Size()
+      );
 
       if(UNLIKELY(pSmallChangeToModelOverwriteSingleSamplingSet->SetCountDivisions(0, cSplits))) {
          LOG_0(TraceLevelWarning, "WARNING GrowDecisionTree pSmallChangeToModelOverwriteSingleSamplingSet->SetCountDivisions(0, cSplits)");
@@ -793,10 +945,135 @@ public:
 
       return false;
    }
+
+   static bool Func(
+      EbmBoostingState * const pEbmBoostingState,
+      CachedBoostingThreadResources * const pCachedThreadResources,
+      const bool bNominal,
+      const size_t cHistogramBuckets,
+      const HistogramBucketBase * const aHistogramBucketBase,
+      const size_t cSamplesTotal,
+      const HistogramBucketVectorEntryBase * const aSumHistogramBucketVectorEntryBase,
+      const size_t cTreeSplitsMax,
+      const size_t cSamplesRequiredForChildSplitMin,
+      SegmentedTensor * const pSmallChangeToModelOverwriteSingleSamplingSet,
+      FloatEbmType * const pTotalGain
+#ifndef NDEBUG
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      if(PREDICTABLE(!bNominal) || UNLIKELY(size_t { 2 } == cHistogramBuckets)) {
+         // every order of 2 categories has the same single split
+         return GrowOrdinal(
+            pEbmBoostingState,
+            pCachedThreadResources,
+            cHistogramBuckets,
+            aHistogramBucketBase,
+            cSamplesTotal,
+            aSumHistogramBucketVectorEntryBase,
+            cTreeSplitsMax,
+            cSamplesRequiredForChildSplitMin,
+            pSmallChangeToModelOverwriteSingleSamplingSet,
+            pTotalGain
+#ifndef NDEBUG
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+
+      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         pEbmBoostingState->GetRuntimeLearningTypeOrCountTargetClasses()
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+
+      // for nominal features we use the classic trick of ordering the categories by their gradient statistics and then
+      // growing an ordinal tree over that order.  Every leaf of that tree holds a contiguous run of the ordered
+      // categories.  Each node holds the full buckets of its categories, so re-sorting the categories of any node
+      // would reproduce the root order, which means we get per-split ordering by sorting once here
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      // EbmBoostingState::Initialize reserved this space after the buckets of any nominal feature group
+      EBM_ASSERT(!GetNominalBucketScratchSizeOverflow(cBytesPerHistogramBucket, cVectorLength));
+      EBM_ASSERT(!IsMultiplyError(cHistogramBuckets, GetNominalBucketScratchSize(cBytesPerHistogramBucket, cVectorLength)));
+      const size_t cBytesBuckets = cHistogramBuckets * cBytesPerHistogramBucket;
+      char * const pBuffer1 = reinterpret_cast<char *>(pCachedThreadResources->GetThreadByteBuffer1(cBytesBuckets +
+         cHistogramBuckets * GetNominalBucketScratchSize(cBytesPerHistogramBucket, cVectorLength)));
+      EBM_ASSERT(reinterpret_cast<const char *>(aHistogramBucketBase) == pBuffer1);
+
+      HistogramBucket<bClassification> * const aOrderedHistogramBucket =
+         reinterpret_cast<HistogramBucket<bClassification> *>(pBuffer1 + cBytesBuckets);
+      // we first use aValues for the sort keys, and later for the model update of each bucket
+      FloatEbmType * const aValues = reinterpret_cast<FloatEbmType *>(pBuffer1 + cBytesBuckets + cBytesBuckets);
+      size_t * const aiOriginalBuckets = reinterpret_cast<size_t *>(aValues + cHistogramBuckets * cVectorLength);
+
+      const HistogramBucket<bClassification> * const aHistogramBucket =
+         aHistogramBucketBase->GetHistogramBucket<bClassification>();
+      for(size_t iBucket = 0; iBucket < cHistogramBuckets; ++iBucket) {
+         const HistogramBucket<bClassification> * const pHistogramBucket =
+            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aHistogramBucket, iBucket);
+         const HistogramBucketVectorEntry<bClassification> * const pHistogramBucketVectorEntry =
+            pHistogramBucket->GetHistogramBucketVectorEntry();
+         // multiclass grows one tree for all the classes, so we order by the first class, which is a reasonable
+         // proxy since the softmax residuals of the classes are strongly correlated
+         const FloatEbmType denominator = bClassification ? pHistogramBucketVectorEntry->GetSumDenominator() :
+            static_cast<FloatEbmType>(pHistogramBucket->GetCountSamplesInBucket());
+         FloatEbmType key = FloatEbmType { 0 };
+         if(LIKELY(FloatEbmType { 0 } != denominator)) {
+            key = pHistogramBucketVectorEntry->m_sumResidualError / denominator;
+            // NaN would break the ordering that std::sort requires.  NaN residuals will end boosting soon anyways
+            key = UNLIKELY(std::isnan(key)) ? FloatEbmType { 0 } : key;
+         }
+         aValues[iBucket] = key;
+         aiOriginalBuckets[iBucket] = iBucket;
+      }
+      std::sort(aiOriginalBuckets, aiOriginalBuckets + cHistogramBuckets, NominalBucketKeyLess(aValues));
+      for(size_t iOrdered = 0; iOrdered < cHistogramBuckets; ++iOrdered) {
+         memcpy(
+            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aOrderedHistogramBucket, iOrdered),
+            GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aHistogramBucket, aiOriginalBuckets[iOrdered]),
+            cBytesPerHistogramBucket
+         );
+      }
+
+      if(GrowOrdinal(
+         pEbmBoostingState,
+         pCachedThreadResources,
+         cHistogramBuckets,
+         aOrderedHistogramBucket,
+         cSamplesTotal,
+         aSumHistogramBucketVectorEntryBase,
+         cTreeSplitsMax,
+         cSamplesRequiredForChildSplitMin,
+         pSmallChangeToModelOverwriteSingleSamplingSet,
+         pTotalGain
+#ifndef NDEBUG
+         , reinterpret_cast<const unsigned char *>(pBuffer1 + cBytesBuckets + cBytesBuckets)
+#endif // NDEBUG
+      )) {
+         return true;
+      }
+
+#ifndef NDEBUG
+      UNUSED(aHistogramBucketsEndDebug);
+#endif // NDEBUG
+
+      return SpreadNominalUpdate(
+         pSmallChangeToModelOverwriteSingleSamplingSet,
+         cVectorLength,
+         cHistogramBuckets,
+         aiOriginalBuckets,
+         aValues
+      );
+   }
 };
 
 extern bool GrowDecisionTree(
    EbmBoostingState * const pEbmBoostingState,
+   CachedBoostingThreadResources * const pCachedThreadResources,
+   const bool bNominal,
    const size_t cHistogramBuckets,
    const HistogramBucketBase * const aHistogramBucketBase,
    const size_t cSamplesTotal,
@@ -818,6 +1095,8 @@ extern bool GrowDecisionTree(
       if(IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
          bRet = GrowDecisionTreeInternal<2>::Func(
             pEbmBoostingState,
+            pCachedThreadResources,
+            bNominal,
             cHistogramBuckets,
             aHistogramBucketBase,
             cSamplesTotal,
@@ -833,6 +1112,8 @@ extern bool GrowDecisionTree(
       } else {
          bRet = GrowDecisionTreeInternal<k_dynamicClassification>::Func(
             pEbmBoostingState,
+            pCachedThreadResources,
+            bNominal,
             cHistogramBuckets,
             aHistogramBucketBase,
             cSamplesTotal,
@@ -850,6 +1131,8 @@ extern bool GrowDecisionTree(
       EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
       bRet = GrowDecisionTreeInternal<k_regression>::Func(
          pEbmBoostingState,
+         pCachedThreadResources,
+         bNominal,
          cHistogramBuckets,
          aHistogramBucketBase,
          cSamplesTotal,
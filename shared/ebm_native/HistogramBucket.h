@@ -185,6 +185,26 @@ INLINE_ALWAYS size_t GetHistogramBucketSize(const bool bClassification, const si
    return cBytesHistogramBucketComponent + cBytesHistogramTargetEntry * cVectorLength;
 }
 
+// GrowDecisionTree reorders the buckets of a nominal feature in the ThreadByteBuffer1 space after the original buckets.
+// For each bucket it needs a reordered copy of the bucket, cVectorLength FloatEbmType values and a size_t index
+INLINE_ALWAYS bool GetNominalBucketScratchSizeOverflow(const size_t cBytesPerHistogramBucket, const size_t cVectorLength) {
+   if(UNLIKELY(IsMultiplyError(sizeof(FloatEbmType), cVectorLength))) {
+      return true;
+   }
+   const size_t cBytesValues = sizeof(FloatEbmType) * cVectorLength;
+   if(UNLIKELY(IsAddError(cBytesPerHistogramBucket, cBytesValues))) {
+      return true;
+   }
+   if(UNLIKELY(IsAddError(cBytesPerHistogramBucket + cBytesValues, sizeof(size_t)))) {
+      return true;
+   }
+   return false;
+}
+
+INLINE_ALWAYS size_t GetNominalBucketScratchSize(const size_t cBytesPerHistogramBucket, const size_t cVectorLength) {
+   return cBytesPerHistogramBucket + sizeof(FloatEbmType) * cVectorLength + sizeof(size_t);
+}
+
 template<bool bClassification>
 INLINE_ALWAYS HistogramBucket<bClassification> * GetHistogramBucketByIndex(
    const size_t cBytesPerHistogramBucket,
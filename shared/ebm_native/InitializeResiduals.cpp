@@ -4,11 +4,17 @@
 
 #include "PrecompiledHeader.h"
 
+#include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
 
 #include "ebm_native.h"
 #include "EbmStatisticUtils.h"
 #include "Logging.h" // EBM_ASSERT & LOG
+#include "ThreadPool.h"
+
+// each task initializes whole blocks of samples, and blocks are big enough that the cost of handing them out to 
+// threads is small compared to the exps inside them
+static constexpr size_t k_cInitializeResidualsBlockSamples = 16384;
 
 // a*PredictorScores = logOdds for binary classification
 // a*PredictorScores = logWeights for multiclass classification
@@ -19,18 +25,19 @@ public:
 
    InitializeResidualsInternal() = delete; // this is a static class.  Do not construct
 
+   template<typename TFloat>
    static void Func(
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
       const size_t cSamples,
       const void * const aTargetData,
       const FloatEbmType * const aPredictorScores,
       FloatEbmType * const aTempFloatVector,
-      FloatEbmType * pResidualError
+      TFloat * pResidualError
    ) {
       static_assert(IsClassification(compilerLearningTypeOrCountTargetClasses), "must be classification");
       static_assert(!IsBinaryClassification(compilerLearningTypeOrCountTargetClasses), "must be multiclass");
 
-      LOG_0(TraceLevelInfo, "Entered InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Entered InitializeResidualsBlock");
 
       // TODO : review this function to see if iZeroResidual was set to a valid index, does that affect the number of items in pPredictorScores (I assume so), 
       //   and does it affect any calculations below like sumExp += std::exp(predictionScore) and the equivalent.  Should we use cVectorLength or 
@@ -54,7 +61,7 @@ public:
 
       const IntEbmType * pTargetData = static_cast<const IntEbmType *>(aTargetData);
       const FloatEbmType * pPredictorScores = aPredictorScores;
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cSamples * cVectorLength;
+      const TFloat * const pResidualErrorEnd = pResidualError + cSamples * cVectorLength;
 
       do {
          const IntEbmType targetOriginal = *pTargetData;
@@ -89,7 +96,7 @@ public:
          do {
             const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorMulticlass(sumExp, *pExpVector, target, iVector);
             ++pExpVector;
-            *pResidualError = residualError;
+            *pResidualError = static_cast<TFloat>(residualError);
             ++pResidualError;
             ++iVector;
          } while(iVector < cVectorLength);
@@ -109,7 +116,7 @@ public:
          }
       } while(pResidualErrorEnd != pResidualError);
 
-      LOG_0(TraceLevelInfo, "Exited InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Exited InitializeResidualsBlock");
    }
 };
 
@@ -120,17 +127,18 @@ public:
 
    InitializeResidualsInternal() = delete; // this is a static class.  Do not construct
 
+   template<typename TFloat>
    static void Func(
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
       const size_t cSamples,
       const void * const aTargetData,
       const FloatEbmType * const aPredictorScores,
       FloatEbmType * const aTempFloatVector,
-      FloatEbmType * pResidualError
+      TFloat * pResidualError
    ) {
       UNUSED(runtimeLearningTypeOrCountTargetClasses);
       UNUSED(aTempFloatVector);
-      LOG_0(TraceLevelInfo, "Entered InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Entered InitializeResidualsBlock");
 
       // TODO : review this function to see if iZeroResidual was set to a valid index, does that affect the number of items in pPredictorScores (I assume so), 
       //   and does it affect any calculations below like sumExp += std::exp(predictionScore) and the equivalent.  Should we use cVectorLength or 
@@ -143,7 +151,7 @@ public:
 
       const IntEbmType * pTargetData = static_cast<const IntEbmType *>(aTargetData);
       const FloatEbmType * pPredictorScores = aPredictorScores;
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cSamples;
+      const TFloat * const pResidualErrorEnd = pResidualError + cSamples;
 
       do {
          const IntEbmType targetOriginal = *pTargetData;
@@ -156,10 +164,10 @@ public:
          const FloatEbmType predictionScore = *pPredictorScores;
          ++pPredictorScores;
          const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorBinaryClassification(predictionScore, target);
-         *pResidualError = residualError;
+         *pResidualError = static_cast<TFloat>(residualError);
          ++pResidualError;
       } while(pResidualErrorEnd != pResidualError);
-      LOG_0(TraceLevelInfo, "Exited InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Exited InitializeResidualsBlock");
    }
 };
 #endif // EXPAND_BINARY_LOGITS
@@ -170,17 +178,18 @@ public:
 
    InitializeResidualsInternal() = delete; // this is a static class.  Do not construct
 
+   template<typename TFloat>
    static void Func(
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
       const size_t cSamples,
       const void * const aTargetData,
       const FloatEbmType * const aPredictorScores,
       FloatEbmType * const aTempFloatVector,
-      FloatEbmType * pResidualError
+      TFloat * pResidualError
    ) {
       UNUSED(runtimeLearningTypeOrCountTargetClasses);
       UNUSED(aTempFloatVector);
-      LOG_0(TraceLevelInfo, "Entered InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Entered InitializeResidualsBlock");
 
       // TODO : review this function to see if iZeroResidual was set to a valid index, does that affect the number of items in pPredictorScores (I assume so), 
       //   and does it affect any calculations below like sumExp += std::exp(predictionScore) and the equivalent.  Should we use cVectorLength or 
@@ -193,7 +202,7 @@ public:
 
       const FloatEbmType * pTargetData = static_cast<const FloatEbmType *>(aTargetData);
       const FloatEbmType * pPredictorScores = aPredictorScores;
-      const FloatEbmType * const pResidualErrorEnd = pResidualError + cSamples;
+      const TFloat * const pResidualErrorEnd = pResidualError + cSamples;
       do {
          // TODO : our caller should handle NaN *pTargetData values, which means that the target is missing, which means we should delete that sample 
          //   from the input data
@@ -208,24 +217,25 @@ public:
          const FloatEbmType predictionScore = *pPredictorScores;
          ++pPredictorScores;
          const FloatEbmType residualError = EbmStatistics::ComputeResidualErrorRegressionInit(predictionScore, data);
-         *pResidualError = residualError;
+         *pResidualError = static_cast<TFloat>(residualError);
          ++pResidualError;
       } while(pResidualErrorEnd != pResidualError);
-      LOG_0(TraceLevelInfo, "Exited InitializeResiduals");
+      LOG_0(TraceLevelVerbose, "Exited InitializeResidualsBlock");
    }
 };
 
-extern void InitializeResiduals(
+template<typename TFloat>
+static void InitializeResidualsStorage(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
    const size_t cSamples,
    const void * const aTargetData,
    const FloatEbmType * const aPredictorScores,
    FloatEbmType * const aTempFloatVector,
-   FloatEbmType * pResidualError
+   TFloat * pResidualError
 ) {
    if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
       if(IsBinaryClassification(runtimeLearningTypeOrCountTargetClasses)) {
-         InitializeResidualsInternal<2>::Func(
+         InitializeResidualsInternal<2>::Func<TFloat>(
             runtimeLearningTypeOrCountTargetClasses,
             cSamples,
             aTargetData,
@@ -234,7 +244,7 @@ extern void InitializeResiduals(
             pResidualError
          );
       } else {
-         InitializeResidualsInternal<k_dynamicClassification>::Func(
+         InitializeResidualsInternal<k_dynamicClassification>::Func<TFloat>(
             runtimeLearningTypeOrCountTargetClasses,
             cSamples,
             aTargetData,
@@ -245,7 +255,7 @@ extern void InitializeResiduals(
       }
    } else {
       EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-      InitializeResidualsInternal<k_regression>::Func(
+      InitializeResidualsInternal<k_regression>::Func<TFloat>(
          runtimeLearningTypeOrCountTargetClasses,
          cSamples,
          aTargetData,
@@ -255,3 +265,157 @@ extern void InitializeResiduals(
       );
    }
 }
+
+template<typename TFloat>
+class InitializeResidualsContext final {
+public:
+
+   InitializeResidualsContext() = default; // preserve our POD status
+   ~InitializeResidualsContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
+   size_t m_cVectorLength;
+   size_t m_cSamples;
+   size_t m_cBlocks;
+   size_t m_cTasks;
+   const void * m_aTargetData;
+   const FloatEbmType * m_aPredictorScores;
+   // cTasks exp vectors of cVectorLength items for multiclass, or nullptr if we don't need them
+   FloatEbmType * m_aTempFloatVectors;
+   TFloat * m_aResidualErrors;
+};
+static_assert(std::is_standard_layout<InitializeResidualsContext<FloatEbmType>>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<InitializeResidualsContext<FloatEbmType>>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<InitializeResidualsContext<FloatEbmType>>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+template<typename TFloat>
+static void InitializeResidualsTask(void * const pContextVoid, const size_t iTask) {
+   const InitializeResidualsContext<TFloat> * const pContext = static_cast<const InitializeResidualsContext<TFloat> *>(pContextVoid);
+   const bool bClassification = IsClassification(pContext->m_runtimeLearningTypeOrCountTargetClasses);
+   const size_t cVectorLength = pContext->m_cVectorLength;
+   FloatEbmType * const aTempFloatVector = nullptr == pContext->m_aTempFloatVectors ? nullptr : 
+      pContext->m_aTempFloatVectors + iTask * cVectorLength;
+   for(size_t iBlock = iTask; iBlock < pContext->m_cBlocks; iBlock += pContext->m_cTasks) {
+      const size_t iSampleBegin = iBlock * k_cInitializeResidualsBlockSamples;
+      EBM_ASSERT(iSampleBegin < pContext->m_cSamples);
+      const size_t cSamplesRemaining = pContext->m_cSamples - iSampleBegin;
+      const size_t cSamplesBlock = 
+         cSamplesRemaining < k_cInitializeResidualsBlockSamples ? cSamplesRemaining : k_cInitializeResidualsBlockSamples;
+      // classification targets are IntEbmType and regression targets are FloatEbmType
+      const void * const aTargetDataBlock = bClassification ? 
+         static_cast<const void *>(static_cast<const IntEbmType *>(pContext->m_aTargetData) + iSampleBegin) :
+         static_cast<const void *>(static_cast<const FloatEbmType *>(pContext->m_aTargetData) + iSampleBegin);
+      InitializeResidualsStorage<TFloat>(
+         pContext->m_runtimeLearningTypeOrCountTargetClasses,
+         cSamplesBlock,
+         aTargetDataBlock,
+         pContext->m_aPredictorScores + iSampleBegin * cVectorLength,
+         aTempFloatVector,
+         pContext->m_aResidualErrors + iSampleBegin * cVectorLength
+      );
+   }
+}
+
+template<typename TFloat>
+static void InitializeResidualsParallel(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   TFloat * const aResidualErrors
+) {
+   LOG_0(TraceLevelInfo, "Entered InitializeResiduals");
+
+   EBM_ASSERT(0 < cSamples);
+
+   // every sample is independent, so the blocks can run in any order and the residuals are identical to 
+   // initializing them serially
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   const size_t cBlocks = (cSamples - 1) / k_cInitializeResidualsBlockSamples + 1;
+   const size_t cThreads = ThreadPool::GetCountThreads();
+   size_t cTasks = cBlocks < cThreads ? cBlocks : cThreads;
+
+   // only multiclass needs an exp vector, and each task needs its own
+   const bool bMulticlass = IsMulticlass(runtimeLearningTypeOrCountTargetClasses);
+   FloatEbmType * aTempFloatVectors = nullptr;
+   if(size_t { 1 } < cTasks && bMulticlass) {
+      // cTasks is at most cSamples, and our caller allocated cSamples * cVectorLength residuals, so this can't overflow
+      aTempFloatVectors = EbmMalloc<FloatEbmType>(cTasks * cVectorLength);
+      if(nullptr == aTempFloatVectors) {
+         // we can still do the work without helpers since our caller gave us one exp vector
+         LOG_0(TraceLevelWarning, "WARNING InitializeResiduals nullptr == aTempFloatVectors.  Initializing serially");
+         cTasks = 1;
+      }
+   }
+
+   if(size_t { 1 } == cTasks) {
+      InitializeResidualsStorage<TFloat>(
+         runtimeLearningTypeOrCountTargetClasses,
+         cSamples,
+         aTargetData,
+         aPredictorScores,
+         aTempFloatVector,
+         aResidualErrors
+      );
+   } else {
+      InitializeResidualsContext<TFloat> context;
+      context.m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+      context.m_cVectorLength = cVectorLength;
+      context.m_cSamples = cSamples;
+      context.m_cBlocks = cBlocks;
+      context.m_cTasks = cTasks;
+      context.m_aTargetData = aTargetData;
+      context.m_aPredictorScores = aPredictorScores;
+      context.m_aTempFloatVectors = aTempFloatVectors;
+      context.m_aResidualErrors = aResidualErrors;
+
+      ThreadPool::ParallelFor(cTasks, InitializeResidualsTask<TFloat>, &context);
+
+      free(aTempFloatVectors);
+   }
+
+   LOG_0(TraceLevelInfo, "Exited InitializeResiduals");
+}
+
+extern void InitializeResiduals(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   FloatEbmType * pResidualError
+) {
+   InitializeResidualsParallel<FloatEbmType>(
+      runtimeLearningTypeOrCountTargetClasses,
+      cSamples,
+      aTargetData,
+      aPredictorScores,
+      aTempFloatVector,
+      pResidualError
+   );
+}
+
+// we compute in FloatEbmType either way and only round the residuals when we store them
+extern void InitializeResiduals(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const void * const aTargetData,
+   const FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aTempFloatVector,
+   float * pResidualError
+) {
+   InitializeResidualsParallel<float>(
+      runtimeLearningTypeOrCountTargetClasses,
+      cSamples,
+      aTargetData,
+      aPredictorScores,
+      aTempFloatVector,
+      pResidualError
+   );
+}
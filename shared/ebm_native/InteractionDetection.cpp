@@ -19,11 +19,98 @@
 #include "CachedThreadResourcesInteraction.h"
 
 #include "InteractionDetection.h"
+#include "Booster.h"
+
+#include "HistogramTargetEntry.h"
+#include "HistogramBucket.h"
+#include "ThreadPool.h"
+#include "RandomStream.h"
+
+extern bool GetInteractionBucketCounts(
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cBytesPerHistogramBucket,
+   size_t * const pcTotalBucketsMainSpaceOut,
+   size_t * const pcAuxillaryBucketsOut,
+   size_t * const pcBytesBufferOut
+);
+
+// returns the bytes that one thread needs to bin and score any scan of pairs of distinct features, or 0 if no pair
+// can be scored.  Pairs of a feature with itself can be larger, and those grow the buffer when they're needed
+static size_t GetInteractionScanBytesMax(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cFeatures,
+   const Feature * const aFeatures
+) {
+   if(ptrdiff_t { 0 } == runtimeLearningTypeOrCountTargetClasses || ptrdiff_t { 1 } == runtimeLearningTypeOrCountTargetClasses) {
+      // we never bin anything with 0/1 target classes
+      return 0;
+   }
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   if(GetHistogramBucketSizeOverflow(k_bInteractionNeedDenominator, cVectorLength)) {
+      return 0;
+   }
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(k_bInteractionNeedDenominator, cVectorLength);
+
+   // the largest pair is made from the two features with the most bins
+   const Feature * pFeatureBiggest = nullptr;
+   const Feature * pFeatureSecond = nullptr;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const Feature * const pFeature = &aFeatures[iFeature];
+      if(pFeature->GetCountBins() <= 1) {
+         // features with 0/1 bins are never binned
+         continue;
+      }
+      if(nullptr == pFeatureBiggest || pFeatureBiggest->GetCountBins() < pFeature->GetCountBins()) {
+         pFeatureSecond = pFeatureBiggest;
+         pFeatureBiggest = pFeature;
+      } else if(nullptr == pFeatureSecond || pFeatureSecond->GetCountBins() < pFeature->GetCountBins()) {
+         pFeatureSecond = pFeature;
+      }
+   }
+   if(nullptr == pFeatureSecond) {
+      // with only one feature that has bins, the only pair possible is the feature with itself
+      pFeatureSecond = pFeatureBiggest;
+   }
+   if(nullptr == pFeatureBiggest) {
+      return 0;
+   }
+
+   char FeatureGroupBuffer[FeatureGroup::GetFeatureGroupCountBytes(2)];
+   FeatureGroup * const pFeatureGroup = reinterpret_cast<FeatureGroup *>(&FeatureGroupBuffer);
+   pFeatureGroup->Initialize(2, 0);
+   pFeatureGroup->GetFeatureGroupEntries()[0].m_pFeature = pFeatureBiggest;
+   pFeatureGroup->GetFeatureGroupEntries()[1].m_pFeature = pFeatureSecond;
+
+   size_t cTotalBucketsMainSpace;
+   size_t cAuxillaryBuckets;
+   size_t cBytesPairMax;
+   if(GetInteractionBucketCounts(pFeatureGroup, cBytesPerHistogramBucket, &cTotalBucketsMainSpace, &cAuxillaryBuckets, &cBytesPairMax)) {
+      // any call that uses this pair will fail the same way, so there's no point in making space for it
+      return 0;
+   }
+
+   // a scan with more than one pair stays within our budget, and a scan with a single pair can be any size
+   if(k_cBytesInteractionScanBudget <= cBytesPairMax) {
+      return cBytesPairMax;
+   }
+   const size_t cPairsPerScanMax = k_cBytesInteractionScanBudget / cBytesPairMax;
+   return (cPairsPerScanMax < k_cInteractionPairsPerScanMax ? k_cBytesInteractionScanBudget : k_cInteractionPairsPerScanMax * cBytesPairMax);
+}
 
 void EbmInteractionState::Free(EbmInteractionState * const pInteractionDetection) {
    LOG_0(TraceLevelInfo, "Entered EbmInteractionState::Free");
 
    if(nullptr != pInteractionDetection) {
+      if(nullptr != pInteractionDetection->m_apCachedThreadResources) {
+         for(size_t iCachedThreadResources = 0; iCachedThreadResources < pInteractionDetection->m_cCachedThreadResources; ++iCachedThreadResources) {
+            CachedInteractionThreadResources * const pCachedThreadResources = pInteractionDetection->m_apCachedThreadResources[iCachedThreadResources];
+            if(nullptr != pCachedThreadResources) {
+               CachedInteractionThreadResources::Free(pCachedThreadResources);
+            }
+         }
+         free(pInteractionDetection->m_apCachedThreadResources);
+      }
+      pInteractionDetection->m_dataSetScreen.Destruct();
       pInteractionDetection->m_dataSet.Destruct();
       free(pInteractionDetection->m_aFeatures);
       free(pInteractionDetection);
@@ -32,6 +119,85 @@ void EbmInteractionState::Free(EbmInteractionState * const pInteractionDetection
    LOG_0(TraceLevelInfo, "Exited EbmInteractionState::Free");
 }
 
+bool EbmInteractionState::InitializeScoring(const FloatEbmType * const optionalTempParams) {
+   LOG_0(TraceLevelInfo, "Entered EbmInteractionState::InitializeScoring");
+
+   const size_t cSamples = m_dataSet.GetCountSamples();
+
+   const FloatEbmType countScreenSamples = 
+      GetTempParam(optionalTempParams, TempParamInteractionScreenSamples, FloatEbmType { 0 });
+   if(FloatEbmType { 0 } != countScreenSamples) {
+      const FloatEbmType countScreenCandidates = GetTempParam(
+         optionalTempParams, 
+         TempParamInteractionScreenCandidates, 
+         static_cast<FloatEbmType>(k_cInteractionScreenCandidatesDefault)
+      );
+      // the negated comparisons also catch NaN
+      if(!(FloatEbmType { 1 } <= countScreenSamples)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring countScreenSamples must be 1 or more.  Not screening");
+      } else if(!(FloatEbmType { 1 } <= countScreenCandidates)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring countScreenCandidates must be 1 or more.  Not screening");
+      } else if(static_cast<FloatEbmType>(cSamples) <= countScreenSamples) {
+         // screening on all the samples would be slower than scoring every pair once
+         LOG_0(TraceLevelInfo, "INFO EbmInteractionState::InitializeScoring countScreenSamples includes every sample.  Not screening");
+      } else if(ptrdiff_t { 0 } != m_runtimeLearningTypeOrCountTargetClasses && ptrdiff_t { 1 } != m_runtimeLearningTypeOrCountTargetClasses) {
+         // we checked above that countScreenSamples is less than cSamples, so it fits into a size_t
+         const size_t cScreenSamples = static_cast<size_t>(countScreenSamples);
+         m_cScreenCandidates = static_cast<FloatEbmType>(std::numeric_limits<size_t>::max()) <= countScreenCandidates ?
+            std::numeric_limits<size_t>::max() : static_cast<size_t>(countScreenCandidates);
+
+         const FloatEbmType screenSeed = GetTempParam(optionalTempParams, TempParamInteractionScreenSeed, FloatEbmType { 0 });
+         IntEbmType randomSeed = 0;
+         // the negated comparison also catches NaN.  2^63 is exactly representable, so these bounds are exact
+         if(!(FloatEbmType { -9223372036854775808.0 } <= screenSeed && screenSeed < FloatEbmType { 9223372036854775808.0 })) {
+            LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring screenSeed must fit into an IntEbmType.  Using 0");
+         } else {
+            randomSeed = static_cast<IntEbmType>(screenSeed);
+         }
+         RandomStream randomStream;
+         randomStream.Initialize(randomSeed);
+         if(m_dataSetScreen.InitializeSubset(
+            &m_dataSet,
+            GetVectorLength(m_runtimeLearningTypeOrCountTargetClasses),
+            cScreenSamples,
+            &randomStream
+         )) {
+            LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring m_dataSetScreen.InitializeSubset");
+            return true;
+         }
+      }
+   }
+
+   const size_t cBytesScanMax = GetInteractionScanBytesMax(m_runtimeLearningTypeOrCountTargetClasses, m_cFeatures, m_aFeatures);
+   const size_t cCachedThreadResources = ThreadPool::GetCountThreads();
+   EBM_ASSERT(1 <= cCachedThreadResources);
+   m_apCachedThreadResources = EbmMalloc<CachedInteractionThreadResources *>(cCachedThreadResources);
+   if(UNLIKELY(nullptr == m_apCachedThreadResources)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring nullptr == m_apCachedThreadResources");
+      return true;
+   }
+   for(size_t iCachedThreadResources = 0; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+      // set these to nullptr first so that we can free a partially allocated array
+      m_apCachedThreadResources[iCachedThreadResources] = nullptr;
+   }
+   m_cCachedThreadResources = cCachedThreadResources;
+   for(size_t iCachedThreadResources = 0; iCachedThreadResources < cCachedThreadResources; ++iCachedThreadResources) {
+      // only the first thread's buffer is needed when there is nothing to scan in parallel, but we can't predict how 
+      // many pairs our caller will send, so we size them all
+      CachedInteractionThreadResources * const pCachedThreadResources = CachedInteractionThreadResources::Allocate(
+         0 == cSamples ? size_t { 0 } : cBytesScanMax
+      );
+      if(UNLIKELY(nullptr == pCachedThreadResources)) {
+         LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::InitializeScoring nullptr == pCachedThreadResources");
+         return true;
+      }
+      m_apCachedThreadResources[iCachedThreadResources] = pCachedThreadResources;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited EbmInteractionState::InitializeScoring");
+   return false;
+}
+
 EbmInteractionState * EbmInteractionState::Allocate(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
    const size_t cFeatures,
@@ -44,7 +210,6 @@ EbmInteractionState * EbmInteractionState::Allocate(
 ) {
    // optionalTempParams isn't used by default.  It's meant to provide an easy way for python or other higher
    // level languages to pass EXPERIMENTAL temporary parameters easily to the C++ code.
-   UNUSED(optionalTempParams);
 
    LOG_0(TraceLevelInfo, "Entered EbmInteractionState::Allocate");
 
@@ -110,8 +275,8 @@ EbmInteractionState * EbmInteractionState::Allocate(
 
          aFeatures[iFeatureInitialize].Initialize(cBins, iFeatureInitialize, featureType, bMissing);
 
-         EBM_ASSERT(EBM_FALSE == pFeatureInitialize->hasMissing); // TODO : implement this, then remove this assert
-         EBM_ASSERT(FeatureTypeOrdinal == pFeatureInitialize->featureType); // TODO : implement this, then remove this assert
+         // TODO : interaction scores walk nominal bins in their index order like ordinal bins, which is only an
+         //        approximation since the best nominal cuts would first order the bins by their residuals
 
          ++iFeatureInitialize;
          ++pFeatureInitialize;
@@ -146,10 +311,82 @@ EbmInteractionState * EbmInteractionState::Allocate(
       return nullptr;
    }
 
+   if(pRet->InitializeScoring(optionalTempParams)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::Allocate InitializeScoring");
+      EbmInteractionState::Free(pRet);
+      return nullptr;
+   }
+
    LOG_0(TraceLevelInfo, "Exited EbmInteractionState::Allocate");
    return pRet;
 }
 
+EbmInteractionState * EbmInteractionState::AllocateFromBoosting(
+   EbmBoostingState * const pBoosterFrom,
+   const FloatEbmType * const optionalTempParams
+) {
+   LOG_0(TraceLevelInfo, "Entered EbmInteractionState::AllocateFromBoosting");
+
+   EBM_ASSERT(nullptr != pBoosterFrom);
+
+   const size_t cFeatures = pBoosterFrom->GetCountFeatures();
+   const Feature * const aFeaturesFrom = pBoosterFrom->GetFeatures();
+   Feature * aFeatures = nullptr;
+   if(0 != cFeatures) {
+      aFeatures = EbmMalloc<Feature>(cFeatures);
+      if(nullptr == aFeatures) {
+         LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::AllocateFromBoosting nullptr == aFeatures");
+         return nullptr;
+      }
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const Feature * const pFeatureFrom = &aFeaturesFrom[iFeature];
+         aFeatures[iFeature].Initialize(
+            pFeatureFrom->GetCountBins(), 
+            iFeature, 
+            pFeatureFrom->GetFeatureType(), 
+            pFeatureFrom->GetIsMissing()
+         );
+      }
+   }
+
+   EbmInteractionState * const pRet = EbmMalloc<EbmInteractionState>();
+   if(nullptr == pRet) {
+      free(aFeatures);
+      return nullptr;
+   }
+   pRet->InitializeZero();
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pBoosterFrom->GetRuntimeLearningTypeOrCountTargetClasses();
+   pRet->m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+   pRet->m_cFeatures = cFeatures;
+   pRet->m_aFeatures = aFeatures;
+   pRet->m_cLogEnterMessages = 1000;
+   pRet->m_cLogExitMessages = 1000;
+
+   // the feature groups of the booster point into its own features, so we match them against aFeaturesFrom
+   if(pRet->m_dataSet.InitializeFromBoosting(
+      cFeatures,
+      aFeaturesFrom,
+      pBoosterFrom->GetCountFeatureGroups(),
+      pBoosterFrom->GetFeatureGroups(),
+      pBoosterFrom->GetTrainingSet(),
+      GetVectorLength(runtimeLearningTypeOrCountTargetClasses)
+   )) {
+      LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::AllocateFromBoosting m_dataSet.InitializeFromBoosting");
+      EbmInteractionState::Free(pRet);
+      return nullptr;
+   }
+
+   if(pRet->InitializeScoring(optionalTempParams)) {
+      LOG_0(TraceLevelWarning, "WARNING EbmInteractionState::AllocateFromBoosting InitializeScoring");
+      EbmInteractionState::Free(pRet);
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited EbmInteractionState::AllocateFromBoosting");
+   return pRet;
+}
+
 // a*PredictorScores = logOdds for binary classification
 // a*PredictorScores = logWeights for multiclass classification
 // a*PredictorScores = predictedValue for regression
@@ -301,6 +538,27 @@ EBM_NATIVE_IMPORT_EXPORT_BODY PEbmInteraction EBM_NATIVE_CALLING_CONVENTION Init
    return pEbmInteraction;
 }
 
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmInteraction EBM_NATIVE_CALLING_CONVENTION InitializeInteractionFromBoosting(
+   PEbmBoosting ebmBoosting,
+   const FloatEbmType * optionalTempParams
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered InitializeInteractionFromBoosting: ebmBoosting=%p, optionalTempParams=%p",
+      static_cast<void *>(ebmBoosting),
+      static_cast<const void *>(optionalTempParams)
+   );
+   EbmBoostingState * const pEbmBoostingState = reinterpret_cast<EbmBoostingState *>(ebmBoosting);
+   if(nullptr == pEbmBoostingState) {
+      LOG_0(TraceLevelError, "ERROR InitializeInteractionFromBoosting ebmBoosting cannot be nullptr");
+      return nullptr;
+   }
+   PEbmInteraction pEbmInteraction = reinterpret_cast<PEbmInteraction>(
+      EbmInteractionState::AllocateFromBoosting(pEbmBoostingState, optionalTempParams));
+   LOG_N(TraceLevelInfo, "Exited InitializeInteractionFromBoosting %p", static_cast<void *>(pEbmInteraction));
+   return pEbmInteraction;
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeInteraction(
    PEbmInteraction ebmInteraction
 ) {
@@ -16,6 +16,24 @@
 #include "FeatureAtomic.h"
 // dataset depends on features
 #include "DataSetInteraction.h"
+#include "CachedThreadResourcesInteraction.h"
+
+class EbmBoostingState;
+
+// CalculateInteractionScorePairs bins up to this many pairs that share their first feature in one pass over the samples.
+// Each extra pair adds a histogram that the binning loop writes to randomly, so we stop before the histograms of a
+// single scan fall out of the cache.  A single pair that exceeds the byte budget gets a scan of its own
+constexpr size_t k_cInteractionPairsPerScanMax = 16;
+constexpr size_t k_cBytesInteractionScanBudget = size_t { 4 } * 1024 * 1024;
+
+// interaction scores only look at the residual sums and the counts, so our interaction histograms use the
+// HistogramBucket<false> layout even for classification.  Skipping the denominators halves the size of the histograms
+// and keeps the Newton-Raphson step out of the binning loops
+constexpr bool k_bInteractionNeedDenominator = false;
+
+// the number of pairs that CalculateInteractionScorePairs re-scores on all the samples after screening, unless the
+// caller sets TempParamInteractionScreenCandidates
+constexpr size_t k_cInteractionScreenCandidatesDefault = 64;
 
 class EbmInteractionState final {
    ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
@@ -25,6 +43,18 @@ class EbmInteractionState final {
 
    DataSetByFeature m_dataSet;
 
+   // if the caller asked for screening, m_dataSetScreen holds a random subset of the samples in m_dataSet that 
+   // CalculateInteractionScorePairs scores every pair on first.  Only the best m_cScreenCandidates pairs of the 
+   // screening are then scored on m_dataSet.  m_dataSetScreen has zero samples if we don't screen
+   DataSetByFeature m_dataSetScreen;
+   size_t m_cScreenCandidates;
+
+   // we have one CachedInteractionThreadResources per thread that ThreadPool::ParallelFor can run on.  They're sized 
+   // when we're created to hold our largest pair scan, so scoring pairs doesn't allocate.  This also means that calls
+   // that score interactions on the same EbmInteractionState can't overlap
+   size_t m_cCachedThreadResources;
+   CachedInteractionThreadResources ** m_apCachedThreadResources;
+
    int m_cLogEnterMessages;
    int m_cLogExitMessages;
 
@@ -43,6 +73,12 @@ public:
 
       m_dataSet.InitializeZero();
 
+      m_dataSetScreen.InitializeZero();
+      m_cScreenCandidates = 0;
+
+      m_cCachedThreadResources = 0;
+      m_apCachedThreadResources = nullptr;
+
       m_cLogEnterMessages = 0;
       m_cLogExitMessages = 0;
    }
@@ -63,6 +99,14 @@ public:
       return &m_dataSet;
    }
 
+   INLINE_ALWAYS const DataSetByFeature * GetDataSetScreen() const {
+      return &m_dataSetScreen;
+   }
+
+   INLINE_ALWAYS size_t GetCountScreenCandidates() const {
+      return m_cScreenCandidates;
+   }
+
    INLINE_ALWAYS const Feature * GetFeatures() const {
       return m_aFeatures;
    }
@@ -71,6 +115,15 @@ public:
       return m_cFeatures;
    }
 
+   INLINE_ALWAYS size_t GetCountCachedThreadResources() const {
+      return m_cCachedThreadResources;
+   }
+
+   INLINE_ALWAYS CachedInteractionThreadResources * GetCachedThreadResources(const size_t iThread) const {
+      EBM_ASSERT(iThread < m_cCachedThreadResources);
+      return m_apCachedThreadResources[iThread];
+   }
+
    static void Free(EbmInteractionState * const pInteractionDetection);
    static EbmInteractionState * Allocate(
       const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
@@ -82,6 +135,18 @@ public:
       const IntEbmType * const aBinnedData,
       const FloatEbmType * const aPredictorScores
    );
+   // scores interactions on the training set of pBoosterFrom with its current residuals.  We copy what we need, so 
+   // pBoosterFrom can keep boosting or be freed afterwards
+   static EbmInteractionState * AllocateFromBoosting(
+      EbmBoostingState * const pBoosterFrom,
+      const FloatEbmType * const optionalTempParams
+   );
+
+private:
+
+   // sets up screening and the per thread buffers once m_dataSet holds our samples.  Returns true on error, in which 
+   // case our caller frees us
+   bool InitializeScoring(const FloatEbmType * const optionalTempParams);
 };
 static_assert(std::is_standard_layout<EbmInteractionState>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
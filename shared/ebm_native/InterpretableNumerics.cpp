@@ -6,7 +6,11 @@
 
 #include <stddef.h> // size_t, ptrdiff_t
 #include <limits> // std::numeric_limits
-#include <string.h> // strchr, memmove
+#include <algorithm> // std::sort
+#include <inttypes.h> // uint64_t
+#include <string.h> // strchr, memmove, memcpy, memset
+#include <float.h> // FLT_EVAL_METHOD
+#include <type_traits> // std::is_same
 
 #include "ebm_native.h"
 #include "EbmInternal.h"
@@ -168,6 +172,332 @@ INLINE_RELEASE_UNTEMPLATED static FloatEbmType GeometricMeanPositives(const Floa
    return result;
 }
 
+// snprintf and strtod dominate the time that we spend finding interpretable cut points, so we first try to format 
+// and parse with exact integer arithmetic, and only fall back to them for values our integers can't hold.  Both 
+// fast paths produce exactly the result of a correctly rounded snprintf or strtod, so humanized cut points don't 
+// change.  The parsing fast path relies on each double operation being rounded once, which FLT_EVAL_METHOD promises
+constexpr bool k_bFloatFastPaths = std::is_same<FloatEbmType, double>::value && 0 == FLT_EVAL_METHOD;
+
+constexpr size_t k_cBitsMantissa = size_t { 52 };
+constexpr int k_exponentBias = int { 1075 };
+constexpr size_t k_cSignificantDigits = k_cDigitsAfterPeriod + size_t { 1 };
+// 5^27 is the largest power of five below 2^64, which limits how far right of the period we can format
+constexpr size_t k_cPowersOfFive = size_t { 28 };
+// 10^22 is the largest power of ten that a double holds exactly
+constexpr size_t k_cExactPowersOfTen = size_t { 23 };
+constexpr uint64_t k_mantissaExactMax = uint64_t { 1 } << (k_cBitsMantissa + size_t { 1 });
+
+static_assert(size_t { 17 } == k_cSignificantDigits, "our integer formatting assumes the 17 digits of a double");
+
+static const uint64_t k_aPowersOfTenInteger[] = {
+   uint64_t { 1 }, uint64_t { 10 }, uint64_t { 100 }, uint64_t { 1000 }, uint64_t { 10000 }, uint64_t { 100000 },
+   uint64_t { 1000000 }, uint64_t { 10000000 }, uint64_t { 100000000 }, uint64_t { 1000000000 },
+   uint64_t { 10000000000 }, uint64_t { 100000000000 }, uint64_t { 1000000000000 }, uint64_t { 10000000000000 },
+   uint64_t { 100000000000000 }, uint64_t { 1000000000000000 }, uint64_t { 10000000000000000 },
+   uint64_t { 100000000000000000 }, uint64_t { 1000000000000000000 }, uint64_t { 10000000000000000000u }
+};
+constexpr uint64_t k_significandMin = uint64_t { 10000000000000000 };
+constexpr uint64_t k_significandMax = uint64_t { 100000000000000000 };
+
+static const double k_aPowersOfTen[k_cExactPowersOfTen] = {
+   1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+INLINE_ALWAYS static void MultiplyWide(
+   const uint64_t a, 
+   const uint64_t b, 
+   uint64_t * const pHighOut, 
+   uint64_t * const pLowOut
+) noexcept {
+   const uint64_t aLow = a & uint64_t { 0xFFFFFFFF };
+   const uint64_t aHigh = a >> 32;
+   const uint64_t bLow = b & uint64_t { 0xFFFFFFFF };
+   const uint64_t bHigh = b >> 32;
+
+   const uint64_t lowLow = aLow * bLow;
+   const uint64_t lowHigh = aLow * bHigh;
+   const uint64_t highLow = aHigh * bLow;
+   const uint64_t highHigh = aHigh * bHigh;
+
+   const uint64_t middle = (lowLow >> 32) + (lowHigh & uint64_t { 0xFFFFFFFF }) + (highLow & uint64_t { 0xFFFFFFFF });
+   *pLowOut = (middle << 32) | (lowLow & uint64_t { 0xFFFFFFFF });
+   *pHighOut = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+}
+
+// rounds the 128 bit value high:low shifted right by cShift bits to the nearest integer, with ties to even.  Returns 
+// true if the result doesn't fit into 64 bits
+static bool ShiftRightRounded(
+   const uint64_t high, 
+   const uint64_t low, 
+   const size_t cShift, 
+   uint64_t * const pResultOut
+) noexcept {
+   EBM_ASSERT(size_t { 0 } < cShift);
+   EBM_ASSERT(cShift < size_t { 128 });
+
+   uint64_t result;
+   uint64_t remainderHigh;
+   uint64_t remainderLow;
+   uint64_t halfHigh;
+   uint64_t halfLow;
+   if(cShift < size_t { 64 }) {
+      if(uint64_t { 0 } != high >> cShift) {
+         return true;
+      }
+      result = (low >> cShift) | (high << (size_t { 64 } - cShift));
+      remainderHigh = uint64_t { 0 };
+      remainderLow = low & ((uint64_t { 1 } << cShift) - uint64_t { 1 });
+      halfHigh = uint64_t { 0 };
+      halfLow = uint64_t { 1 } << (cShift - size_t { 1 });
+   } else if(size_t { 64 } == cShift) {
+      result = high;
+      remainderHigh = uint64_t { 0 };
+      remainderLow = low;
+      halfHigh = uint64_t { 0 };
+      halfLow = uint64_t { 1 } << 63;
+   } else {
+      result = high >> (cShift - size_t { 64 });
+      remainderHigh = high & ((uint64_t { 1 } << (cShift - size_t { 64 })) - uint64_t { 1 });
+      remainderLow = low;
+      halfHigh = uint64_t { 1 } << (cShift - size_t { 65 });
+      halfLow = uint64_t { 0 };
+   }
+   if(halfHigh < remainderHigh || (halfHigh == remainderHigh && halfLow < remainderLow)) {
+      ++result;
+   } else if(halfHigh == remainderHigh && halfLow == remainderLow) {
+      result += result & uint64_t { 1 };
+   }
+   *pResultOut = result;
+   return false;
+}
+
+// finds the 17 significant digits of val rounded to nearest with ties to even, which is what a correctly rounded 
+// "%.16e" prints.  pSignificandOut receives the digits as an integer from 10^16 up to but excluding 10^17 and 
+// pExponentOut the exponent of the first digit.  Returns true if our integers can't hold val exactly
+static bool GetSignificantDigits(
+   const FloatEbmType val, 
+   uint64_t * const pSignificandOut, 
+   int * const pExponentOut
+) noexcept {
+   EBM_ASSERT(FloatEbmType { 0 } < val);
+
+   uint64_t bits;
+   static_assert(sizeof(bits) == sizeof(val), "we can only take apart doubles");
+   memcpy(&bits, &val, sizeof(bits));
+   const int exponentBiased = static_cast<int>(bits >> k_cBitsMantissa);
+   if(int { 0 } == exponentBiased) {
+      // subnormals are far outside of our range anyways
+      return true;
+   }
+   const uint64_t mantissa = (bits & (k_mantissaExactMax / uint64_t { 2 } - uint64_t { 1 })) | 
+      k_mantissaExactMax / uint64_t { 2 };
+   // val == mantissa * 2^exponent2
+   const int exponent2 = exponentBiased - k_exponentBias;
+
+   // the mantissa has 53 bits, so the value is at least 2^(exponent2 + 52), and 78913 / 2^18 is just below log10(2).
+   // This can be up to 2 less than the exponent of the first digit, which we correct below
+   int exponent10 = static_cast<int>((static_cast<int64_t>(exponent2 + int { 52 }) * int64_t { 78913 }) >> 18);
+
+   uint64_t significand;
+   if(int { 0 } <= exponent2) {
+      if(int { 11 } < exponent2) {
+         // doesn't fit into 64 bits
+         return true;
+      }
+      const uint64_t integer = mantissa << exponent2;
+      size_t cDigits = size_t { 1 };
+      while(cDigits < sizeof(k_aPowersOfTenInteger) / sizeof(k_aPowersOfTenInteger[0]) && 
+         k_aPowersOfTenInteger[cDigits] <= integer) 
+      {
+         ++cDigits;
+      }
+      exponent10 = static_cast<int>(cDigits) - int { 1 };
+      if(cDigits <= k_cSignificantDigits) {
+         significand = integer * k_aPowersOfTenInteger[k_cSignificantDigits - cDigits];
+      } else {
+         const uint64_t divisor = k_aPowersOfTenInteger[cDigits - k_cSignificantDigits];
+         significand = integer / divisor;
+         const uint64_t remainder = integer - significand * divisor;
+         const uint64_t half = divisor / uint64_t { 2 };
+         if(half < remainder) {
+            ++significand;
+         } else if(half == remainder) {
+            significand += significand & uint64_t { 1 };
+         }
+      }
+   } else {
+      while(true) {
+         // val * 10^cShiftDigits has exactly 17 digits before the period if we guessed exponent10 right
+         const int cShiftDigits = static_cast<int>(k_cDigitsAfterPeriod) - exponent10;
+         if(cShiftDigits < int { 0 } || int { k_cPowersOfFive } <= cShiftDigits) {
+            return true;
+         }
+         // val * 10^cShiftDigits == mantissa * 5^cShiftDigits * 2^(exponent2 + cShiftDigits)
+         uint64_t powerOfFive = uint64_t { 1 };
+         for(int iPower = 0; iPower < cShiftDigits; ++iPower) {
+            powerOfFive *= uint64_t { 5 };
+         }
+         uint64_t high;
+         uint64_t low;
+         MultiplyWide(mantissa, powerOfFive, &high, &low);
+         const int exponentRemaining = exponent2 + cShiftDigits;
+         if(int { 0 } <= exponentRemaining) {
+            // val * 10^cShiftDigits is at least 10^16, so the product can't overflow 64 bits if we don't have to
+            // correct our guess
+            if(uint64_t { 0 } != high || int { 64 } <= exponentRemaining || 
+               (int { 0 } != exponentRemaining && uint64_t { 0 } != (low >> (int { 64 } - exponentRemaining)))) 
+            {
+               return true;
+            }
+            significand = low << exponentRemaining;
+         } else {
+            if(int { 128 } <= -exponentRemaining) {
+               return true;
+            }
+            if(ShiftRightRounded(high, low, static_cast<size_t>(-exponentRemaining), &significand)) {
+               return true;
+            }
+         }
+         // our guess of exponent10 is never too high, so val * 10^cShiftDigits is at least 10^16.  Rounding can 
+         // push it up to exactly 10^17, which we handle below the same way whether it started out just below or
+         // just above 10^17
+         if(UNLIKELY(significand < k_significandMin)) {
+            return true;
+         }
+         if(significand <= k_significandMax) {
+            break;
+         }
+         ++exponent10;
+      }
+   }
+   if(k_significandMax == significand) {
+      // we rounded up into the next power of ten, like snprintf does with 9.99999999999999999e+02 -> 1.0000e+03
+      significand = k_significandMin;
+      ++exponent10;
+   }
+   EBM_ASSERT(k_significandMin <= significand);
+   EBM_ASSERT(significand < k_significandMax);
+   *pSignificandOut = significand;
+   *pExponentOut = exponent10;
+   return false;
+}
+
+// writes val in our "+9.1234567890123456e-301" format.  Returns true if our integers can't hold val exactly
+static bool FloatToStringFast(const FloatEbmType val, char * const str) noexcept {
+   uint64_t significand;
+   int exponent10;
+   if(FloatEbmType { 0 } == val || GetSignificantDigits(val, &significand, &exponent10)) {
+      return true;
+   }
+
+   str[0] = '+';
+   char * pch = &str[k_iExp];
+   do {
+      --pch;
+      *pch = static_cast<char>('0' + static_cast<int>(significand % uint64_t { 10 }));
+      significand /= uint64_t { 10 };
+   } while(&str[3] != pch);
+   EBM_ASSERT(significand < uint64_t { 10 });
+   str[1] = static_cast<char>('0' + static_cast<int>(significand));
+   str[2] = '.';
+
+   pch = &str[k_iExp];
+   *pch = 'e';
+   ++pch;
+   unsigned int exponentAbs = static_cast<unsigned int>(int { 0 } <= exponent10 ? exponent10 : -exponent10);
+   *pch = int { 0 } <= exponent10 ? '+' : '-';
+   ++pch;
+   // like snprintf we print at least 2 exponent digits
+   char * const pExponentStart = pch;
+   do {
+      *pch = static_cast<char>('0' + exponentAbs % 10u);
+      exponentAbs /= 10u;
+      ++pch;
+   } while(0u != exponentAbs || pch < pExponentStart + size_t { 2 });
+   *pch = '\0';
+   std::reverse(pExponentStart, pch);
+   return false;
+}
+
+// parses strings of the form "+9.123e-301" or "+9e-301" when the digits and exponent give an exactly representable 
+// double and a single power of ten that is exact, so our one multiplication or division rounds just like strtod.
+// Returns true if we can't parse the string this way
+static bool StringToFloatFast(const char * const str, FloatEbmType * const pRetOut) noexcept {
+   EBM_ASSERT('+' == str[0]);
+
+   const char * pch = &str[1];
+   uint64_t significand = uint64_t { 0 };
+   int exponent10 = int { 0 };
+   size_t cDigits = size_t { 0 };
+   bool bAfterPeriod = false;
+   while(true) {
+      const char ch = *pch;
+      if('0' <= ch && ch <= '9') {
+         if(k_cSignificantDigits <= cDigits) {
+            return true;
+         }
+         significand = significand * uint64_t { 10 } + static_cast<uint64_t>(ch - '0');
+         ++cDigits;
+         if(bAfterPeriod) {
+            --exponent10;
+         }
+      } else if('.' == ch && !bAfterPeriod) {
+         bAfterPeriod = true;
+      } else {
+         break;
+      }
+      ++pch;
+   }
+   if('e' != *pch && 'E' != *pch) {
+      return true;
+   }
+   ++pch;
+   const bool bNegativeExponent = '-' == *pch;
+   if('-' == *pch || '+' == *pch) {
+      ++pch;
+   }
+   int exponentText = int { 0 };
+   const char * const pExponentStart = pch;
+   while('0' <= *pch && *pch <= '9') {
+      if(int { 10000 } <= exponentText) {
+         return true;
+      }
+      exponentText = exponentText * int { 10 } + static_cast<int>(*pch - '0');
+      ++pch;
+   }
+   if(pExponentStart == pch || '\0' != *pch) {
+      return true;
+   }
+   exponent10 += bNegativeExponent ? -exponentText : exponentText;
+
+   if(uint64_t { 0 } == significand) {
+      *pRetOut = FloatEbmType { 0 };
+      return false;
+   }
+   // move trailing zeros into the exponent, which lets more chopped strings use an exact power of ten
+   while(uint64_t { 0 } == significand % uint64_t { 10 }) {
+      significand /= uint64_t { 10 };
+      ++exponent10;
+   }
+   if(k_mantissaExactMax < significand) {
+      return true;
+   }
+   const FloatEbmType exact = static_cast<FloatEbmType>(significand);
+   if(exponent10 < int { 0 }) {
+      if(int { k_cExactPowersOfTen } <= -exponent10) {
+         return true;
+      }
+      *pRetOut = exact / k_aPowersOfTen[-exponent10];
+   } else {
+      if(int { k_cExactPowersOfTen } <= exponent10) {
+         return true;
+      }
+      *pRetOut = exact * k_aPowersOfTen[exponent10];
+   }
+   return false;
+}
+
 static bool FloatToString(const FloatEbmType val, char * const str) noexcept {
    EBM_ASSERT(!std::isnan(val));
    EBM_ASSERT(!std::isinf(val));
@@ -176,6 +506,10 @@ static bool FloatToString(const FloatEbmType val, char * const str) noexcept {
 
    // NOTE: str must be a buffer with k_cCharsFloatPrint characters available 
 
+   if(k_bFloatFastPaths && !FloatToStringFast(val, str)) {
+      return false;
+   }
+
    // the C++ standard is pretty good about harmonizing the "e" format.  There is some openess to what happens
    // in the exponent (2 or 3 digits with or without the leading sign character, etc).  If there is ever any
    // implementation observed that differs, this function should convert all formats to a common standard that
@@ -267,7 +601,10 @@ static FloatEbmType StringToFloatWithFixup(
    // +-infinity for at least some implementations.  We can't really take a ratio from those numbers, so convert
    // this to the lowest and max values
 
-   FloatEbmType ret = strtod(str, nullptr);
+   FloatEbmType ret;
+   if(!k_bFloatFastPaths || StringToFloatFast(str, &ret)) {
+      ret = strtod(str, nullptr);
+   }
 
    // this is a check for -infinity/-HUGE_VAL, without the -infinity value since some compilers make that illegal
    // even so far as to make isinf always FALSE with some compiler flags
@@ -831,6 +1168,119 @@ extern size_t RemoveMissingValuesAndReplaceInfinities(
    return cSamples;
 }
 
+// below this many values std::sort beats the fixed cost of the radix histograms and passes
+constexpr size_t k_cSamplesRadixSortMin = size_t { 4096 };
+constexpr size_t k_cRadixBits = size_t { 8 };
+constexpr size_t k_cRadixBuckets = size_t { 1 } << k_cRadixBits;
+constexpr size_t k_cRadixPasses = sizeof(uint64_t) * size_t { 8 } / k_cRadixBits;
+constexpr uint64_t k_radixSignBit = uint64_t { 1 } << (sizeof(uint64_t) * size_t { 8 } - size_t { 1 });
+
+static_assert(sizeof(uint64_t) == sizeof(FloatEbmType), "our radix keys hold the bits of a FloatEbmType");
+
+INLINE_ALWAYS static uint64_t ConvertToRadixKey(const FloatEbmType val) noexcept {
+   // flipping the sign bit of positive numbers and all the bits of negative numbers gives us unsigned keys that
+   // order the same way as the floats.  -0.0 and 0.0 compare equal, so we give both the key of 0.0, and since
+   // we decode values from their keys, this turns -0.0 into 0.0
+   uint64_t bits = uint64_t { 0 };
+   if(LIKELY(FloatEbmType { 0 } != val)) {
+      memcpy(&bits, &val, sizeof(bits));
+   }
+   return UNPREDICTABLE(uint64_t { 0 } != (k_radixSignBit & bits)) ? ~bits : bits | k_radixSignBit;
+}
+
+INLINE_ALWAYS static FloatEbmType ConvertFromRadixKey(const uint64_t key) noexcept {
+   const uint64_t bits = UNPREDICTABLE(uint64_t { 0 } != (k_radixSignBit & key)) ? key & ~k_radixSignBit : ~key;
+   FloatEbmType val;
+   memcpy(&val, &bits, sizeof(val));
+   return val;
+}
+
+extern void SortFeatureValues(const size_t cSamples, FloatEbmType * const aValues) noexcept {
+   // our callers have already called RemoveMissingValuesAndReplaceInfinities, so there are no NaN values that
+   // would break the ordering of our keys
+   EBM_ASSERT(nullptr != aValues || size_t { 0 } == cSamples);
+
+   if(PREDICTABLE(cSamples < k_cSamplesRadixSortMin)) {
+      std::sort(aValues, aValues + cSamples);
+      return;
+   }
+
+   uint64_t * const aKeys = EbmMalloc<uint64_t>(cSamples);
+   if(UNLIKELY(nullptr == aKeys)) {
+      // sorting is too important to fail on, and std::sort doesn't need any memory
+      LOG_0(TraceLevelWarning, "WARNING SortFeatureValues nullptr == aKeys");
+      std::sort(aValues, aValues + cSamples);
+      return;
+   }
+
+   // build the histograms for all the passes while converting our values into keys, which lets us skip any pass
+   // where all the keys have the same digit, like the top exponent bits of data with a narrow range
+   size_t aaCounts[k_cRadixPasses][k_cRadixBuckets];
+   memset(aaCounts, 0, sizeof(aaCounts));
+   for(size_t i = 0; i < cSamples; ++i) {
+      const uint64_t key = ConvertToRadixKey(aValues[i]);
+      aKeys[i] = key;
+      for(size_t iPass = 0; iPass < k_cRadixPasses; ++iPass) {
+         ++aaCounts[iPass][static_cast<size_t>(key >> (iPass * k_cRadixBits)) & (k_cRadixBuckets - size_t { 1 })];
+      }
+   }
+
+   // the histograms don't depend on the order of the keys, so any key tells us which bucket would hold them all
+   const uint64_t keyAny = aKeys[0];
+
+   // we ping-pong between aKeys and the memory of aValues, which we treat as keys through memcpy to avoid
+   // breaking the strict aliasing rules
+   bool bKeysInValues = false;
+   for(size_t iPass = 0; iPass < k_cRadixPasses; ++iPass) {
+      size_t * const aCounts = aaCounts[iPass];
+      const size_t shift = iPass * k_cRadixBits;
+      if(cSamples == aCounts[static_cast<size_t>(keyAny >> shift) & (k_cRadixBuckets - size_t { 1 })]) {
+         // every key has the same digit in this pass, so it wouldn't change the order
+         continue;
+      }
+
+      size_t iStart = 0;
+      for(size_t iBucket = 0; iBucket < k_cRadixBuckets; ++iBucket) {
+         const size_t cBucket = aCounts[iBucket];
+         aCounts[iBucket] = iStart;
+         iStart += cBucket;
+      }
+      EBM_ASSERT(cSamples == iStart);
+
+      if(bKeysInValues) {
+         for(size_t i = 0; i < cSamples; ++i) {
+            uint64_t key;
+            memcpy(&key, &aValues[i], sizeof(key));
+            const size_t iBucket = static_cast<size_t>(key >> shift) & (k_cRadixBuckets - size_t { 1 });
+            aKeys[aCounts[iBucket]] = key;
+            ++aCounts[iBucket];
+         }
+      } else {
+         for(size_t i = 0; i < cSamples; ++i) {
+            const uint64_t key = aKeys[i];
+            const size_t iBucket = static_cast<size_t>(key >> shift) & (k_cRadixBuckets - size_t { 1 });
+            memcpy(&aValues[aCounts[iBucket]], &key, sizeof(key));
+            ++aCounts[iBucket];
+         }
+      }
+      bKeysInValues = !bKeysInValues;
+   }
+
+   if(bKeysInValues) {
+      for(size_t i = 0; i < cSamples; ++i) {
+         uint64_t key;
+         memcpy(&key, &aValues[i], sizeof(key));
+         aValues[i] = ConvertFromRadixKey(key);
+      }
+   } else {
+      for(size_t i = 0; i < cSamples; ++i) {
+         aValues[i] = ConvertFromRadixKey(aKeys[i]);
+      }
+   }
+
+   free(aKeys);
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SuggestGraphBounds(
    IntEbmType countBinCuts,
    FloatEbmType lowestBinCut,
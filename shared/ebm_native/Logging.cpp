@@ -7,6 +7,7 @@
 #include <assert.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <atomic>
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // FeatureType
@@ -21,6 +22,62 @@ constexpr static char g_pLoggingParameterError[] = "Error in vsnprintf parameter
 signed char g_traceLevel = TraceLevelOff;
 static LOG_MESSAGE_FUNCTION g_pLogMessageFunc = nullptr;
 
+// messages longer than this are clipped, which is still legal
+constexpr static size_t k_cLogMessageCharsMax = 1024;
+
+// LogSlot is a cell in a bounded multi-producer queue in the style of Dmitry Vyukov's.  A slot is free for the producer
+// that claims position iPosition when m_iSequence == iPosition, and holds a published message for our single consumer
+// when m_iSequence == iPosition + 1.  The consumer hands the slot back for the next lap by storing
+// iPosition + cSlots.  Producers never wait on each other or on the consumer: if the slot for their position is still
+// in use, the buffer is full and they count the message as dropped
+struct LogSlot final {
+   std::atomic<size_t> m_iSequence;
+   signed char m_traceLevel;
+   char m_message[k_cLogMessageCharsMax];
+};
+// std::atomic isn't trivially copyable, so LogSlot isn't POD, but we never copy it
+static_assert(std::is_standard_layout<LogSlot>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+
+// these are only changed in SetLogBuffer, which the caller can't call while logging can happen on other threads
+static LogSlot * g_aLogSlots = nullptr;
+static size_t g_cLogSlots = 0;
+
+static std::atomic<size_t> g_iLogEnqueue { 0 };
+static std::atomic<size_t> g_cLogDropped { 0 };
+// only DrainLogMessages changes this, and only one thread can drain at a time
+static size_t g_iLogDequeue = 0;
+
+// returns nullptr if the buffer is full, in which case the message is counted as dropped
+static LogSlot * ClaimLogSlot(size_t * const piPositionOut) {
+   EBM_ASSERT(nullptr != g_aLogSlots);
+   size_t iPosition = g_iLogEnqueue.load(std::memory_order_relaxed);
+   while(true) {
+      LogSlot * const pSlot = &g_aLogSlots[iPosition & (g_cLogSlots - 1)];
+      const size_t iSequence = pSlot->m_iSequence.load(std::memory_order_acquire);
+      if(iSequence == iPosition) {
+         // compare_exchange_weak reloads iPosition on failure, in which case another thread claimed this slot first
+         if(g_iLogEnqueue.compare_exchange_weak(iPosition, iPosition + size_t { 1 }, std::memory_order_relaxed)) {
+            *piPositionOut = iPosition;
+            return pSlot;
+         }
+      } else if(static_cast<ptrdiff_t>(iSequence - iPosition) < ptrdiff_t { 0 }) {
+         // the consumer hasn't freed this slot since the previous lap
+         g_cLogDropped.fetch_add(1, std::memory_order_relaxed);
+         return nullptr;
+      } else {
+         // another producer claimed iPosition after we loaded it
+         iPosition = g_iLogEnqueue.load(std::memory_order_relaxed);
+      }
+   }
+}
+
+static void PublishLogSlot(LogSlot * const pSlot, const size_t iPosition, const signed char traceLevel) {
+   pSlot->m_traceLevel = traceLevel;
+   // the release pairs with the acquire in DrainLogMessages, so the consumer sees the whole message
+   pSlot->m_iSequence.store(iPosition + size_t { 1 }, std::memory_order_release);
+}
+
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetLogMessageFunction(LOG_MESSAGE_FUNCTION logMessageFunction) {
    assert(nullptr != logMessageFunction);
    assert(nullptr == g_pLogMessageFunc); /* "SetLogMessageFunction should only be called once" */
@@ -34,9 +91,102 @@ EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SetTraceLevel(s
    g_traceLevel = traceLevel;
 }
 
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SetLogBuffer(IntEbmType countMessages) {
+   if(countMessages < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR SetLogBuffer countMessages must be zero or positive");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countMessages)) {
+      LOG_0(TraceLevelWarning, "WARNING SetLogBuffer !IsNumberConvertable<size_t>(countMessages)");
+      return IntEbmType { 1 };
+   }
+   const size_t cMessages = static_cast<size_t>(countMessages);
+
+   LogSlot * aLogSlots = nullptr;
+   size_t cLogSlots = 0;
+   if(size_t { 0 } != cMessages) {
+      // we index slots with a mask, so round up to a power of two
+      cLogSlots = 1;
+      while(cLogSlots < cMessages) {
+         if(std::numeric_limits<size_t>::max() / size_t { 2 } < cLogSlots) {
+            LOG_0(TraceLevelWarning, "WARNING SetLogBuffer countMessages too large");
+            return IntEbmType { 1 };
+         }
+         cLogSlots <<= 1;
+      }
+      aLogSlots = EbmMalloc<LogSlot>(cLogSlots);
+      if(nullptr == aLogSlots) {
+         LOG_0(TraceLevelWarning, "WARNING SetLogBuffer nullptr == aLogSlots");
+         return IntEbmType { 1 };
+      }
+      for(size_t iSlot = 0; iSlot < cLogSlots; ++iSlot) {
+         aLogSlots[iSlot].m_iSequence.store(iSlot, std::memory_order_relaxed);
+      }
+   }
+
+   // don't lose anything that we've already buffered
+   DrainLogMessages(nullptr);
+   free(g_aLogSlots);
+
+   g_iLogEnqueue.store(0, std::memory_order_relaxed);
+   g_cLogDropped.store(0, std::memory_order_relaxed);
+   g_iLogDequeue = 0;
+   g_cLogSlots = cLogSlots;
+   g_aLogSlots = aLogSlots;
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION DrainLogMessages(IntEbmType * countDroppedOut) {
+   size_t cDelivered = 0;
+   size_t cDropped = 0;
+   if(nullptr != g_aLogSlots) {
+      while(true) {
+         LogSlot * const pSlot = &g_aLogSlots[g_iLogDequeue & (g_cLogSlots - 1)];
+         const size_t iSequence = pSlot->m_iSequence.load(std::memory_order_acquire);
+         if(iSequence != g_iLogDequeue + size_t { 1 }) {
+            // either the buffer is empty, or the next producer hasn't finished writing its message yet.  We stop
+            // either way so that messages are delivered in order, and the next drain picks up where we stopped
+            break;
+         }
+         // nothing can be logged unless there is a log function
+         EBM_ASSERT(nullptr != g_pLogMessageFunc);
+         (*g_pLogMessageFunc)(pSlot->m_traceLevel, pSlot->m_message);
+         pSlot->m_iSequence.store(g_iLogDequeue + g_cLogSlots, std::memory_order_release);
+         ++g_iLogDequeue;
+         ++cDelivered;
+      }
+      cDropped = g_cLogDropped.exchange(0, std::memory_order_relaxed);
+   }
+   if(nullptr != countDroppedOut) {
+      *countDroppedOut = IsNumberConvertable<IntEbmType>(cDropped) ? 
+         static_cast<IntEbmType>(cDropped) : std::numeric_limits<IntEbmType>::max();
+   }
+   return IsNumberConvertable<IntEbmType>(cDelivered) ?
+      static_cast<IntEbmType>(cDelivered) : std::numeric_limits<IntEbmType>::max();
+}
+
 WARNING_PUSH
 WARNING_DISABLE_NON_LITERAL_PRINTF_STRING
-extern void InteralLogWithArguments(const signed char traceLevel, const char * const pOriginalMessage, ...) {
+// returns true if vsnprintf failed, in which case pMessageOut holds g_pLoggingParameterError
+static bool FormatLogMessage(char * const pMessageOut, const char * const pOriginalMessage, va_list args) {
+   // vsnprintf specifically says that the count parameter is in bytes of buffer space, but let's be safe and assume someone might change this to a 
+   // unicode function someday and that new function might be in characters instead of bytes.  For us #bytes == #chars.  If a unicode specific version 
+   // is in bytes it won't overflow, but it will waste memory
+
+   // clang-tidy says va_list is uninitialized, despite the call to va_start above. This is a known bug in clang-tidy.
+   // DETAILS: https://stackoverflow.com/questions/58672959/why-does-clang-tidy-say-vsnprintf-has-an-uninitialized-va-list-argument
+   StopClangAnalysis();
+   if(vsnprintf(pMessageOut, k_cLogMessageCharsMax, pOriginalMessage, args) < 0) {
+      static_assert(sizeof(g_pLoggingParameterError) <= k_cLogMessageCharsMax, "g_pLoggingParameterError too long");
+      memcpy(pMessageOut, g_pLoggingParameterError, sizeof(g_pLoggingParameterError));
+      return true;
+   }
+   // if the message overflows, we clip it, but it's still legal
+   return false;
+}
+WARNING_POP
+
+static void LogSynchronousWithArgumentList(const signed char traceLevel, const char * const pOriginalMessage, va_list args) {
    assert(nullptr != g_pLogMessageFunc);
 
    // this function is here largely to clip the stack memory needed for messageSpace.  If we put the below functionality directly into a MACRO or an 
@@ -45,29 +195,53 @@ extern void InteralLogWithArguments(const signed char traceLevel, const char * c
    // then immedicately deallocate it, so our caller doesn't need to hold valuable stack space all the way down when calling it's offspring functions.  
    // We also don't need to allocate any stack when logging is turned off.
 
+   char messageSpace[k_cLogMessageCharsMax];
+   FormatLogMessage(messageSpace, pOriginalMessage, args);
+   (*g_pLogMessageFunc)(traceLevel, messageSpace);
+}
+
+static void LogSynchronousWithArguments(const signed char traceLevel, const char * const pOriginalMessage, ...) {
    va_list args;
-   char messageSpace[1024];
    va_start(args, pOriginalMessage);
-   // vsnprintf specifically says that the count parameter is in bytes of buffer space, but let's be safe and assume someone might change this to a 
-   // unicode function someday and that new function might be in characters instead of bytes.  For us #bytes == #chars.  If a unicode specific version 
-   // is in bytes it won't overflow, but it will waste memory
+   LogSynchronousWithArgumentList(traceLevel, pOriginalMessage, args);
+   va_end(args);
+}
 
-   // clang-tidy says va_list is uninitialized, despite the call to va_start above. This is a known bug in clang-tidy.
-   // DETAILS: https://stackoverflow.com/questions/58672959/why-does-clang-tidy-say-vsnprintf-has-an-uninitialized-va-list-argument
-   StopClangAnalysis();
-   if(vsnprintf(messageSpace, sizeof(messageSpace) / sizeof(messageSpace[0]), pOriginalMessage, args) < 0) {
-      (*g_pLogMessageFunc)(traceLevel, g_pLoggingParameterError);
+extern void InteralLogWithArguments(const signed char traceLevel, const char * const pOriginalMessage, ...) {
+   assert(nullptr != g_pLogMessageFunc);
+
+   va_list args;
+   va_start(args, pOriginalMessage);
+   if(nullptr != g_aLogSlots) {
+      size_t iPosition;
+      LogSlot * const pSlot = ClaimLogSlot(&iPosition);
+      if(nullptr != pSlot) {
+         // format directly into the slot, which needs no stack space and saves a copy
+         FormatLogMessage(pSlot->m_message, pOriginalMessage, args);
+         PublishLogSlot(pSlot, iPosition, traceLevel);
+      }
    } else {
-      // if messageSpace overflows, we clip the message, but it's still legal
-      (*g_pLogMessageFunc)(traceLevel, messageSpace);
+      LogSynchronousWithArgumentList(traceLevel, pOriginalMessage, args);
    }
    va_end(args);
 }
-WARNING_POP
 
 extern void InteralLogWithoutArguments(const signed char traceLevel, const char * const pOriginalMessage) {
    assert(nullptr != g_pLogMessageFunc);
-   (*g_pLogMessageFunc)(traceLevel, pOriginalMessage);
+   if(nullptr != g_aLogSlots) {
+      size_t iPosition;
+      LogSlot * const pSlot = ClaimLogSlot(&iPosition);
+      if(nullptr != pSlot) {
+         // our messages without arguments are string literals of known length, but we clip them like vsnprintf would
+         const size_t cChars = strlen(pOriginalMessage);
+         const size_t cCharsCopy = cChars < k_cLogMessageCharsMax ? cChars : k_cLogMessageCharsMax - size_t { 1 };
+         memcpy(pSlot->m_message, pOriginalMessage, cCharsCopy);
+         pSlot->m_message[cCharsCopy] = '\0';
+         PublishLogSlot(pSlot, iPosition, traceLevel);
+      }
+   } else {
+      (*g_pLogMessageFunc)(traceLevel, pOriginalMessage);
+   }
 }
 
 extern void LogAssertFailure(
@@ -77,6 +251,7 @@ extern void LogAssertFailure(
    const char * const assertText
 ) ANALYZER_NORETURN {
    if(UNLIKELY(TraceLevelError <= g_traceLevel)) {
-      InteralLogWithArguments(TraceLevelError, g_assertLogMessage, lineNumber, fileName, functionName, assertText);
+      // we assert immediately afterwards, so a buffered message would never be drained.  Deliver it directly instead
+      LogSynchronousWithArguments(TraceLevelError, g_assertLogMessage, lineNumber, fileName, functionName, assertText);
    }
 }
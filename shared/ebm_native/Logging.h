@@ -6,6 +6,7 @@
 #define LOGGING_H
 
 #include <assert.h>
+#include <atomic>
 
 #include "ebm_native.h" // LOG_MESSAGE_FUNCTION
 #include "EbmInternal.h" // UNLIKELY
@@ -36,6 +37,28 @@ constexpr INLINE_ALWAYS bool AlwaysFalse() {
    return false;
 }
 
+// LOG_COUNTED_* takes the remaining count of messages at the lower trace level and returns true if this message gets 
+// logged.  Global counters are decremented from any thread that calls into us, so they are atomic and stop at zero.  
+// Counters inside an EbmInteractionState are only changed by the thread that calls with that object
+INLINE_ALWAYS bool DecrementLogCount(int * const pLogCount) {
+   const int logCount = *pLogCount - int { 1 };
+   if(LIKELY(logCount < int { 0 })) {
+      return false;
+   }
+   *pLogCount = logCount;
+   return true;
+}
+
+INLINE_ALWAYS bool DecrementLogCount(std::atomic<int> * const pLogCount) {
+   int logCount = pLogCount->load(std::memory_order_relaxed);
+   do {
+      if(LIKELY(logCount <= int { 0 })) {
+         return false;
+      }
+   } while(!pLogCount->compare_exchange_weak(logCount, logCount - int { 1 }, std::memory_order_relaxed));
+   return true;
+}
+
 // We use separate macros for LOG_0 (zero parameters) and LOG_N (variadic parameters) because having zero parameters is non-standardized in C++11
 // In C++20, there will be __VA_OPT__, but I don't want to take a dependency on such a new standard yet
 // In GCC, you can use ##__VA_ARGS__, but it's non-standard
@@ -104,12 +127,9 @@ constexpr INLINE_ALWAYS bool AlwaysFalse() {
          do { \
             signed char LOG__traceLevelLogging; \
             if(LIKELY(LOG__traceLevel < LOG__traceLevelAfter)) { \
-               int * const LOG__pLogCountDecrement = (pLogCountDecrement); \
-               const int LOG__logCount = *LOG__pLogCountDecrement - int { 1 }; \
-               if(LIKELY(LOG__logCount < int { 0 })) { \
+               if(!DecrementLogCount(pLogCountDecrement)) { \
                   break; \
                } \
-               *LOG__pLogCountDecrement = LOG__logCount; \
                LOG__traceLevelLogging = LOG__traceLevelBefore; \
             } else { \
                LOG__traceLevelLogging = LOG__traceLevelAfter; \
@@ -139,12 +159,9 @@ constexpr INLINE_ALWAYS bool AlwaysFalse() {
          do { \
             signed char LOG__traceLevelLogging; \
             if(LIKELY(LOG__traceLevel < LOG__traceLevelAfter)) { \
-               int * const LOG__pLogCountDecrement = (pLogCountDecrement); \
-               const int LOG__logCount = *LOG__pLogCountDecrement - int { 1 }; \
-               if(LIKELY(LOG__logCount < int { 0 })) { \
+               if(!DecrementLogCount(pLogCountDecrement)) { \
                   break; \
                } \
-               *LOG__pLogCountDecrement = LOG__logCount; \
                LOG__traceLevelLogging = LOG__traceLevelBefore; \
             } else { \
                LOG__traceLevelLogging = LOG__traceLevelAfter; \
@@ -0,0 +1,536 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdio.h> // FILE, fopen, fwrite, fclose
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "ModelFile.h"
+
+extern const char * MapFile(const char * const filePath, size_t * const pcBytesOut);
+extern void UnmapFile(const char * const pMapped, const size_t cBytes);
+
+extern IntEbmType PredictBatch(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType * const countBinCuts,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const predictionsOut,
+   const bool bExplain
+);
+
+// every array of the file holds 8 byte items, which is what keeps all of them aligned
+static_assert(sizeof(IntEbmType) == sizeof(uint64_t), "the model file needs 8 byte IntEbmType");
+static_assert(sizeof(FloatEbmType) == sizeof(uint64_t), "the model file needs 8 byte FloatEbmType");
+static_assert(sizeof(EbmNativeFeature) == 3 * sizeof(uint64_t), "EbmNativeFeature should be 3 IntEbmType items");
+static_assert(sizeof(EbmNativeFeatureGroup) == sizeof(uint64_t), "EbmNativeFeatureGroup should be 1 IntEbmType item");
+static_assert(0 == sizeof(ModelFileHeader) % sizeof(uint64_t), "ModelFileHeader should only hold 8 byte items");
+
+INLINE_RELEASE_UNTEMPLATED static size_t GetModelVectorLength(const ptrdiff_t runtimeLearningTypeOrCountTargetClasses) {
+   // classification with 0 or 1 target classes has no logits, like the booster's models
+   return IsClassification(runtimeLearningTypeOrCountTargetClasses) && runtimeLearningTypeOrCountTargetClasses <= ptrdiff_t { 1 } ?
+      size_t { 0 } : GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+}
+
+INLINE_RELEASE_UNTEMPLATED static uint64_t GetModelLink(const ptrdiff_t runtimeLearningTypeOrCountTargetClasses) {
+   if(IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+      return k_modelLinkIdentity;
+   }
+   return size_t { 1 } == GetModelVectorLength(runtimeLearningTypeOrCountTargetClasses) ? k_modelLinkLogit : k_modelLinkSoftmax;
+}
+
+// returns true if the arrays that the header describes don't fit into memory
+static bool GetCountBytesFile(const ModelFileHeader * const pHeader, size_t * const pcBytesOut) {
+   // EbmNativeFeature is 3 items and countBinCuts is one more per feature
+   const uint64_t acItems[] {
+      pHeader->m_cFeatures, pHeader->m_cFeatures, pHeader->m_cFeatures, pHeader->m_cFeatures,
+      pHeader->m_cBinCuts,
+      pHeader->m_cFeatureGroups,
+      pHeader->m_cFeatureGroupIndexes,
+      pHeader->m_cVectorLength,
+      pHeader->m_cTensorValues
+   };
+   size_t cBytes = sizeof(ModelFileHeader);
+   for(const uint64_t cItems : acItems) {
+      if(!IsNumberConvertable<size_t>(cItems) || IsMultiplyError(static_cast<size_t>(cItems), sizeof(uint64_t))) {
+         return true;
+      }
+      const size_t cBytesArray = static_cast<size_t>(cItems) * sizeof(uint64_t);
+      if(IsAddError(cBytes, cBytesArray)) {
+         return true;
+      }
+      cBytes += cBytesArray;
+   }
+   *pcBytesOut = cBytes;
+   return false;
+}
+
+// checks that the features and feature groups describe a model that PredictBatch can score, and counts the items of
+// the arrays whose lengths follow from them.  aFeatureGroupIndexes holds at most cFeatureGroupIndexesMax items.
+// Returns true on error
+static bool CountModelItems(
+   const char * const sFunctionName,
+   const size_t cVectorLength,
+   const size_t cFeatures,
+   const EbmNativeFeature * const aFeatures,
+   const IntEbmType * const aCountBinCuts,
+   const size_t cFeatureGroups,
+   const EbmNativeFeatureGroup * const aFeatureGroups,
+   const IntEbmType * const aFeatureGroupIndexes,
+   const size_t cFeatureGroupIndexesMax,
+   size_t * const pcBinCutsOut,
+   size_t * const pcFeatureGroupIndexesOut,
+   size_t * const pcTensorValuesOut
+) {
+   size_t cBinCuts = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType countBins = aFeatures[iFeature].countBins;
+      if(countBins < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBins)) {
+         LOG_N(TraceLevelError, "ERROR %s countBins must be positive and fit into memory", sFunctionName);
+         return true;
+      }
+      const IntEbmType countBinCuts = aCountBinCuts[iFeature];
+      if(countBinCuts < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBinCuts) ||
+         IsAddError(cBinCuts, static_cast<size_t>(countBinCuts))
+      ) {
+         LOG_N(TraceLevelError, "ERROR %s countBinCuts must be positive and fit into memory", sFunctionName);
+         return true;
+      }
+      cBinCuts += static_cast<size_t>(countBinCuts);
+   }
+
+   size_t cFeatureGroupIndexes = 0;
+   size_t cTensorValues = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const IntEbmType countDimensions = aFeatureGroups[iFeatureGroup].countFeaturesInGroup;
+      if(countDimensions < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countDimensions) ||
+         cFeatureGroupIndexesMax - cFeatureGroupIndexes < static_cast<size_t>(countDimensions)
+      ) {
+         LOG_N(TraceLevelError, "ERROR %s countFeaturesInGroup is negative or beyond the featureGroupIndexes", sFunctionName);
+         return true;
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      size_t cTensorBins = cVectorLength;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType indexFeature = aFeatureGroupIndexes[cFeatureGroupIndexes + iDimension];
+         if(indexFeature < IntEbmType { 0 } || !IsNumberConvertable<size_t>(indexFeature) ||
+            cFeatures <= static_cast<size_t>(indexFeature)
+         ) {
+            LOG_N(TraceLevelError, "ERROR %s featureGroupIndexes must index into features", sFunctionName);
+            return true;
+         }
+         const size_t cBins = static_cast<size_t>(aFeatures[static_cast<size_t>(indexFeature)].countBins);
+         if(IsMultiplyError(cTensorBins, cBins)) {
+            LOG_N(TraceLevelError, "ERROR %s IsMultiplyError(cTensorBins, cBins)", sFunctionName);
+            return true;
+         }
+         cTensorBins *= cBins;
+      }
+      if(IsAddError(cTensorValues, cTensorBins)) {
+         LOG_N(TraceLevelError, "ERROR %s IsAddError(cTensorValues, cTensorBins)", sFunctionName);
+         return true;
+      }
+      cTensorValues += cTensorBins;
+      cFeatureGroupIndexes += cDimensions;
+   }
+
+   *pcBinCutsOut = cBinCuts;
+   *pcFeatureGroupIndexesOut = cFeatureGroupIndexes;
+   *pcTensorValuesOut = cTensorValues;
+   return false;
+}
+
+bool ModelFile::MapArrays() {
+   if(m_cBytesMapped < sizeof(ModelFileHeader)) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays file too small for the header");
+      return true;
+   }
+   const ModelFileHeader * const pHeader = reinterpret_cast<const ModelFileHeader *>(m_pMapped);
+   if(k_modelFileMagic != pHeader->m_magic) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays not a model file, or written with a different byte order");
+      return true;
+   }
+   if(k_modelFileVersion != pHeader->m_version) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays unsupported version");
+      return true;
+   }
+   if(sizeof(FloatEbmType) != pHeader->m_cBytesFloat) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays written with a different FloatEbmType size");
+      return true;
+   }
+   if(static_cast<uint64_t>(m_cBytesMapped) != pHeader->m_cBytesFile) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays file was truncated");
+      return true;
+   }
+   const int64_t learningTypeOrCountTargetClasses = pHeader->m_learningTypeOrCountTargetClasses;
+   if((learningTypeOrCountTargetClasses < int64_t { 0 } && k_regression != learningTypeOrCountTargetClasses) ||
+      !IsNumberConvertable<ptrdiff_t>(learningTypeOrCountTargetClasses)
+   ) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays invalid learning type");
+      return true;
+   }
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = static_cast<ptrdiff_t>(learningTypeOrCountTargetClasses);
+   if(GetModelLink(runtimeLearningTypeOrCountTargetClasses) != pHeader->m_link) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays unsupported link function for the learning type");
+      return true;
+   }
+   const size_t cVectorLength = GetModelVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   if(static_cast<uint64_t>(cVectorLength) != pHeader->m_cVectorLength) {
+      // binary models have 2 logits if EXPAND_BINARY_LOGITS is defined, so the writer was built differently than us
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays written with a different number of logits");
+      return true;
+   }
+   size_t cBytesFile;
+   if(GetCountBytesFile(pHeader, &cBytesFile) || cBytesFile != m_cBytesMapped) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays the arrays don't fill the file");
+      return true;
+   }
+   // the arrays fit into the file, so all of their counts fit into a size_t
+   const size_t cFeatures = static_cast<size_t>(pHeader->m_cFeatures);
+   const size_t cFeatureGroups = static_cast<size_t>(pHeader->m_cFeatureGroups);
+   if(!IsNumberConvertable<IntEbmType>(cFeatures) || !IsNumberConvertable<IntEbmType>(cFeatureGroups)) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays too many features or feature groups");
+      return true;
+   }
+
+   const char * pArray = m_pMapped + sizeof(ModelFileHeader);
+   m_aFeatures = reinterpret_cast<const EbmNativeFeature *>(pArray);
+   pArray += sizeof(EbmNativeFeature) * cFeatures;
+   m_aCountBinCuts = reinterpret_cast<const IntEbmType *>(pArray);
+   pArray += sizeof(IntEbmType) * cFeatures;
+   m_aBinCuts = reinterpret_cast<const FloatEbmType *>(pArray);
+   pArray += sizeof(FloatEbmType) * static_cast<size_t>(pHeader->m_cBinCuts);
+   m_aFeatureGroups = reinterpret_cast<const EbmNativeFeatureGroup *>(pArray);
+   pArray += sizeof(EbmNativeFeatureGroup) * cFeatureGroups;
+   m_aFeatureGroupIndexes = reinterpret_cast<const IntEbmType *>(pArray);
+   pArray += sizeof(IntEbmType) * static_cast<size_t>(pHeader->m_cFeatureGroupIndexes);
+   m_aIntercept = reinterpret_cast<const FloatEbmType *>(pArray);
+   pArray += sizeof(FloatEbmType) * cVectorLength;
+   m_aTensors = reinterpret_cast<const FloatEbmType *>(pArray);
+
+   size_t cBinCuts;
+   size_t cFeatureGroupIndexes;
+   size_t cTensorValues;
+   if(CountModelItems("ModelFile::MapArrays", cVectorLength, cFeatures, m_aFeatures, m_aCountBinCuts, cFeatureGroups,
+      m_aFeatureGroups, m_aFeatureGroupIndexes, static_cast<size_t>(pHeader->m_cFeatureGroupIndexes), &cBinCuts,
+      &cFeatureGroupIndexes, &cTensorValues)
+   ) {
+      return true;
+   }
+   if(static_cast<uint64_t>(cBinCuts) != pHeader->m_cBinCuts ||
+      static_cast<uint64_t>(cFeatureGroupIndexes) != pHeader->m_cFeatureGroupIndexes ||
+      static_cast<uint64_t>(cTensorValues) != pHeader->m_cTensorValues
+   ) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::MapArrays the arrays don't agree with the header");
+      return true;
+   }
+
+   m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+   m_cFeatures = cFeatures;
+   m_cFeatureGroups = cFeatureGroups;
+   return false;
+}
+
+ModelFile * ModelFile::Open(const char * const filePath) {
+   LOG_0(TraceLevelInfo, "Entered ModelFile::Open");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   size_t cBytesMapped;
+   const char * const pMapped = MapFile(filePath, &cBytesMapped);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING ModelFile::Open MapFile");
+      return nullptr;
+   }
+   ModelFile * const pModelFile = EbmMalloc<ModelFile>();
+   if(nullptr == pModelFile) {
+      LOG_0(TraceLevelWarning, "WARNING ModelFile::Open nullptr == pModelFile");
+      UnmapFile(pMapped, cBytesMapped);
+      return nullptr;
+   }
+   pModelFile->m_pMapped = pMapped;
+   pModelFile->m_cBytesMapped = cBytesMapped;
+   if(pModelFile->MapArrays()) {
+      Close(pModelFile);
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited ModelFile::Open");
+   return pModelFile;
+}
+
+void ModelFile::Close(ModelFile * const pModelFile) {
+   if(nullptr != pModelFile) {
+      UnmapFile(pModelFile->m_pMapped, pModelFile->m_cBytesMapped);
+      free(pModelFile);
+   }
+}
+
+// returns true on error
+static bool WriteItems(FILE * const pFile, const void * const aItems, const size_t cItems) {
+   return 0 != cItems && cItems != fwrite(aItems, sizeof(uint64_t), cItems, pFile);
+}
+
+bool ModelFile::Write(
+   const char * const filePath,
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cFeatures,
+   const EbmNativeFeature * const aFeatures,
+   const IntEbmType * const aCountBinCuts,
+   const FloatEbmType * const aBinCuts,
+   const size_t cFeatureGroups,
+   const EbmNativeFeatureGroup * const aFeatureGroups,
+   const IntEbmType * const aFeatureGroupIndexes,
+   const FloatEbmType * const aTensors,
+   const FloatEbmType * const aIntercept
+) {
+   LOG_0(TraceLevelInfo, "Entered ModelFile::Write");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   if(0 != cFeatures && (nullptr == aFeatures || nullptr == aCountBinCuts)) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::Write features and countBinCuts cannot be nullptr if there are features");
+      return true;
+   }
+   if(0 != cFeatureGroups && nullptr == aFeatureGroups) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::Write featureGroups cannot be nullptr if there are feature groups");
+      return true;
+   }
+   const size_t cVectorLength = GetModelVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   size_t cBinCuts;
+   size_t cFeatureGroupIndexes;
+   size_t cTensorValues;
+   // without featureGroupIndexes no feature group can have any features
+   if(CountModelItems("ModelFile::Write", cVectorLength, cFeatures, aFeatures, aCountBinCuts, cFeatureGroups, aFeatureGroups,
+      aFeatureGroupIndexes, nullptr == aFeatureGroupIndexes ? size_t { 0 } : std::numeric_limits<size_t>::max(), &cBinCuts,
+      &cFeatureGroupIndexes, &cTensorValues)
+   ) {
+      return true;
+   }
+   if(0 != cBinCuts && nullptr == aBinCuts) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::Write binCutsLowerBoundInclusive cannot be nullptr if there are cuts");
+      return true;
+   }
+   if(0 != cTensorValues && nullptr == aTensors) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::Write modelFeatureGroupTensors cannot be nullptr if there are tensors");
+      return true;
+   }
+
+   ModelFileHeader header;
+   header.m_magic = k_modelFileMagic;
+   header.m_version = k_modelFileVersion;
+   header.m_cBytesFloat = sizeof(FloatEbmType);
+   header.m_link = GetModelLink(runtimeLearningTypeOrCountTargetClasses);
+   header.m_learningTypeOrCountTargetClasses = static_cast<int64_t>(runtimeLearningTypeOrCountTargetClasses);
+   header.m_cFeatures = static_cast<uint64_t>(cFeatures);
+   header.m_cBinCuts = static_cast<uint64_t>(cBinCuts);
+   header.m_cFeatureGroups = static_cast<uint64_t>(cFeatureGroups);
+   header.m_cFeatureGroupIndexes = static_cast<uint64_t>(cFeatureGroupIndexes);
+   header.m_cVectorLength = static_cast<uint64_t>(cVectorLength);
+   header.m_cTensorValues = static_cast<uint64_t>(cTensorValues);
+   size_t cBytesFile;
+   if(GetCountBytesFile(&header, &cBytesFile)) {
+      LOG_0(TraceLevelError, "ERROR ModelFile::Write the model is too large for memory");
+      return true;
+   }
+   header.m_cBytesFile = static_cast<uint64_t>(cBytesFile);
+
+   FILE * const pFile = fopen(filePath, "wb");
+   if(nullptr == pFile) {
+      LOG_0(TraceLevelWarning, "WARNING ModelFile::Write fopen");
+      return true;
+   }
+   bool bError = 1 != fwrite(&header, sizeof(header), 1, pFile) ||
+      WriteItems(pFile, aFeatures, 3 * cFeatures) ||
+      WriteItems(pFile, aCountBinCuts, cFeatures) ||
+      WriteItems(pFile, aBinCuts, cBinCuts) ||
+      WriteItems(pFile, aFeatureGroups, cFeatureGroups) ||
+      WriteItems(pFile, aFeatureGroupIndexes, cFeatureGroupIndexes);
+   for(size_t iVector = 0; !bError && iVector < cVectorLength; ++iVector) {
+      const FloatEbmType intercept = nullptr == aIntercept ? FloatEbmType { 0 } : aIntercept[iVector];
+      bError = WriteItems(pFile, &intercept, 1);
+   }
+   bError = bError || WriteItems(pFile, aTensors, cTensorValues);
+   if(0 != fclose(pFile)) {
+      bError = true;
+   }
+   if(bError) {
+      LOG_0(TraceLevelWarning, "WARNING ModelFile::Write could not write the file");
+      return true;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited ModelFile::Write");
+   return false;
+}
+
+IntEbmType ModelFile::Predict(
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const predictionsOut
+) const {
+   // MapArrays checked everything that PredictBatch reads from our arrays, so it only needs to check the samples
+   return PredictBatch(
+      m_runtimeLearningTypeOrCountTargetClasses,
+      static_cast<IntEbmType>(m_cFeatures),
+      m_aFeatures,
+      m_aCountBinCuts,
+      m_aBinCuts,
+      static_cast<IntEbmType>(m_cFeatureGroups),
+      m_aFeatureGroups,
+      m_aFeatureGroupIndexes,
+      m_aTensors,
+      m_aIntercept,
+      countSamples,
+      featureValues,
+      predictionsOut,
+      false
+   );
+}
+
+static IntEbmType SaveModel(
+   const char * const sFunctionName,
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType * const countBinCuts,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const char * const filePath
+) {
+   if(countFeatures < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countFeatures)) {
+      LOG_N(TraceLevelError, "ERROR %s countFeatures must be positive and fit into memory", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   if(countFeatureGroups < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countFeatureGroups)) {
+      LOG_N(TraceLevelError, "ERROR %s countFeatureGroups must be positive and fit into memory", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   if(nullptr == filePath) {
+      LOG_N(TraceLevelError, "ERROR %s filePath cannot be nullptr", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   if(ModelFile::Write(filePath, runtimeLearningTypeOrCountTargetClasses, static_cast<size_t>(countFeatures), features,
+      countBinCuts, binCutsLowerBoundInclusive, static_cast<size_t>(countFeatureGroups), featureGroups, featureGroupIndexes,
+      modelFeatureGroupTensors, intercept)
+   ) {
+      LOG_N(TraceLevelWarning, "WARNING %s ModelFile::Write", sFunctionName);
+      return IntEbmType { 1 };
+   }
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveModelClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered SaveModelClassification: countTargetClasses=%" IntEbmTypePrintf ", countFeatures=%"
+      IntEbmTypePrintf ", countFeatureGroups=%" IntEbmTypePrintf ", filePath=%p", countTargetClasses, countFeatures,
+      countFeatureGroups, static_cast<const void *>(filePath));
+
+   if(countTargetClasses < IntEbmType { 0 } || !IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelError, "ERROR SaveModelClassification countTargetClasses must be positive and fit into memory");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = SaveModel("SaveModelClassification", static_cast<ptrdiff_t>(countTargetClasses), countFeatures,
+      features, countBinCuts, binCutsLowerBoundInclusive, countFeatureGroups, featureGroups, featureGroupIndexes,
+      modelFeatureGroupTensors, intercept, filePath);
+
+   LOG_N(TraceLevelInfo, "Exited SaveModelClassification %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveModelRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered SaveModelRegression: countFeatures=%" IntEbmTypePrintf ", countFeatureGroups=%"
+      IntEbmTypePrintf ", filePath=%p", countFeatures, countFeatureGroups, static_cast<const void *>(filePath));
+
+   const IntEbmType ret = SaveModel("SaveModelRegression", k_regression, countFeatures, features, countBinCuts,
+      binCutsLowerBoundInclusive, countFeatureGroups, featureGroups, featureGroupIndexes, modelFeatureGroupTensors,
+      intercept, filePath);
+
+   LOG_N(TraceLevelInfo, "Exited SaveModelRegression %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmModel EBM_NATIVE_CALLING_CONVENTION OpenModel(
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered OpenModel: filePath=%p", static_cast<const void *>(filePath));
+
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR OpenModel filePath cannot be nullptr");
+      return nullptr;
+   }
+   const PEbmModel model = reinterpret_cast<PEbmModel>(ModelFile::Open(filePath));
+
+   LOG_N(TraceLevelInfo, "Exited OpenModel %p", static_cast<void *>(model));
+   return model;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictModel(
+   PEbmModel model,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * predictionsOut
+) {
+   LOG_N(TraceLevelInfo, "Entered PredictModel: model=%p, countSamples=%" IntEbmTypePrintf ", featureValues=%p, predictionsOut=%p",
+      static_cast<void *>(model), countSamples, static_cast<const void *>(featureValues), static_cast<void *>(predictionsOut));
+
+   if(nullptr == model) {
+      LOG_0(TraceLevelError, "ERROR PredictModel model cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = reinterpret_cast<const ModelFile *>(model)->Predict(countSamples, featureValues, predictionsOut);
+
+   LOG_N(TraceLevelInfo, "Exited PredictModel %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION CloseModel(
+   PEbmModel model
+) {
+   LOG_N(TraceLevelInfo, "Entered CloseModel: model=%p", static_cast<void *>(model));
+
+   // it's legal to call CloseModel on nullptr, just like for free().  This is checked inside ModelFile::Close()
+   ModelFile::Close(reinterpret_cast<ModelFile *>(model));
+
+   LOG_0(TraceLevelInfo, "Exited CloseModel");
+}
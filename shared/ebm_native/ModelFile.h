@@ -0,0 +1,124 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef MODEL_FILE_H
+#define MODEL_FILE_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <inttypes.h> // uint64_t, int64_t
+
+#include "ebm_native.h" // IntEbmType, FloatEbmType, EbmNativeFeature, EbmNativeFeatureGroup
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+
+// The model file holds everything that PredictBatch needs to score a trained model: the features, their bin cuts,
+// the feature groups, the intercept and the tensors of all the feature groups.  Each array is stored in the same
+// format that PredictBatchClassification and PredictBatchRegression accept, so OpenModel maps the file read-only and
+// scores straight out of the mapping without parsing or copying anything.
+//
+// Layout: ModelFileHeader, then these arrays back to back
+//   m_cFeatures EbmNativeFeature items
+//   m_cFeatures IntEbmType countBinCuts items
+//   m_cBinCuts FloatEbmType bin cuts
+//   m_cFeatureGroups EbmNativeFeatureGroup items
+//   m_cFeatureGroupIndexes IntEbmType feature indexes
+//   m_cVectorLength FloatEbmType intercept values
+//   m_cTensorValues FloatEbmType tensor values
+// Every item is 8 bytes in the native byte order, so each array starts 8 byte aligned and a file written on a machine
+// with a different byte order fails the magic number check.
+
+constexpr uint64_t k_modelFileMagic = uint64_t { 0x314C444F4D4D4245 }; // "EBMMODL1" in little endian
+constexpr uint64_t k_modelFileVersion = 1;
+
+// the link function is implied by the learning type, but we record it so that later versions can add others
+constexpr uint64_t k_modelLinkIdentity = 0;
+constexpr uint64_t k_modelLinkLogit = 1;
+constexpr uint64_t k_modelLinkSoftmax = 2;
+
+struct ModelFileHeader final {
+   ModelFileHeader() = default; // preserve our POD status
+   ~ModelFileHeader() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_magic;
+   uint64_t m_version;
+   uint64_t m_cBytesFloat;
+   uint64_t m_cBytesFile;
+   uint64_t m_link;
+   // -1 for regression, or otherwise the number of target classes
+   int64_t m_learningTypeOrCountTargetClasses;
+   uint64_t m_cFeatures;
+   uint64_t m_cBinCuts;
+   uint64_t m_cFeatureGroups;
+   uint64_t m_cFeatureGroupIndexes;
+   // 0 for classification with fewer than 2 classes, which has no logits
+   uint64_t m_cVectorLength;
+   uint64_t m_cTensorValues;
+};
+static_assert(std::is_standard_layout<ModelFileHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ModelFileHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<ModelFileHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class ModelFile final {
+   // the whole file mapped read-only.  The arrays below point into this memory
+   const char * m_pMapped;
+   size_t m_cBytesMapped;
+
+   ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
+   size_t m_cFeatures;
+   size_t m_cFeatureGroups;
+   const EbmNativeFeature * m_aFeatures;
+   const IntEbmType * m_aCountBinCuts;
+   const FloatEbmType * m_aBinCuts;
+   const EbmNativeFeatureGroup * m_aFeatureGroups;
+   const IntEbmType * m_aFeatureGroupIndexes;
+   const FloatEbmType * m_aIntercept;
+   const FloatEbmType * m_aTensors;
+
+   // checks the mapped file and points our arrays into it.  Returns true on error
+   bool MapArrays();
+
+public:
+
+   ModelFile() = default; // preserve our POD status
+   ~ModelFile() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // maps the file and checks that every feature group indexes its features and that the tensors fill the rest of
+   // the file, so a corrupted file can't make us read outside of the mapping later.  Returns nullptr on error
+   static ModelFile * Open(const char * const filePath);
+   static void Close(ModelFile * const pModelFile);
+
+   // checks the model the same way that Open does, and writes it.  aIntercept can be nullptr for a zero intercept.
+   // Returns true on error
+   static bool Write(
+      const char * const filePath,
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const size_t cFeatures,
+      const EbmNativeFeature * const aFeatures,
+      const IntEbmType * const aCountBinCuts,
+      const FloatEbmType * const aBinCuts,
+      const size_t cFeatureGroups,
+      const EbmNativeFeatureGroup * const aFeatureGroups,
+      const IntEbmType * const aFeatureGroupIndexes,
+      const FloatEbmType * const aTensors,
+      const FloatEbmType * const aIntercept
+   );
+
+   // the same as PredictBatchClassification or PredictBatchRegression with the arrays of this model
+   IntEbmType Predict(const IntEbmType countSamples, const FloatEbmType * const featureValues, FloatEbmType * const predictionsOut) const;
+};
+static_assert(std::is_standard_layout<ModelFile>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ModelFile>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<ModelFile>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // MODEL_FILE_H
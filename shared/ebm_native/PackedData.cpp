@@ -0,0 +1,656 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdio.h> // FILE, fopen, fwrite, fclose
+#include <string.h> // memset, memcpy
+
+#ifdef _WIN32
+// we don't want windows.h in our precompiled header since then it would be needed in linux builds
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else // _WIN32
+#include <fcntl.h> // open
+#include <unistd.h> // close
+#include <sys/mman.h> // mmap, munmap
+#include <sys/stat.h> // fstat
+#endif // _WIN32
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
+#include "FeatureAtomic.h"
+#include "FeatureGroup.h"
+#include "PackedData.h"
+
+// returns nullptr on error, and otherwise a read-only view of the whole file in *pcBytesOut.  ModelFile.cpp maps its
+// files with this too
+const char * MapFile(const char * const filePath, size_t * const pcBytesOut) {
+#ifdef _WIN32
+   // TODO: filePath is UTF-8 for our other callers, so convert it and use CreateFileW
+   const HANDLE hFile = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if(INVALID_HANDLE_VALUE == hFile) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile CreateFileA");
+      return nullptr;
+   }
+   LARGE_INTEGER cBytesFile;
+   if(!GetFileSizeEx(hFile, &cBytesFile)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile GetFileSizeEx");
+      CloseHandle(hFile);
+      return nullptr;
+   }
+   if(cBytesFile.QuadPart <= 0 || !IsNumberConvertable<size_t>(cBytesFile.QuadPart)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile file size cannot be mapped");
+      CloseHandle(hFile);
+      return nullptr;
+   }
+   const HANDLE hMapping = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   // the mapping holds its own reference to the file
+   CloseHandle(hFile);
+   if(nullptr == hMapping) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile CreateFileMappingA");
+      return nullptr;
+   }
+   const void * const pMapped = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+   // the view holds its own reference to the mapping
+   CloseHandle(hMapping);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile MapViewOfFile");
+      return nullptr;
+   }
+   *pcBytesOut = static_cast<size_t>(cBytesFile.QuadPart);
+   return static_cast<const char *>(pMapped);
+#else // _WIN32
+   const int fd = open(filePath, O_RDONLY);
+   if(fd < 0) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile open");
+      return nullptr;
+   }
+   struct stat fileStatus;
+   if(0 != fstat(fd, &fileStatus)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile fstat");
+      close(fd);
+      return nullptr;
+   }
+   if(fileStatus.st_size <= 0 || !IsNumberConvertable<size_t>(fileStatus.st_size)) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile file size cannot be mapped");
+      close(fd);
+      return nullptr;
+   }
+   const size_t cBytes = static_cast<size_t>(fileStatus.st_size);
+   void * const pMapped = mmap(nullptr, cBytes, PROT_READ, MAP_SHARED, fd, 0);
+   // the mapping holds its own reference to the file
+   close(fd);
+   if(MAP_FAILED == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING MapFile mmap");
+      return nullptr;
+   }
+   *pcBytesOut = cBytes;
+   return static_cast<const char *>(pMapped);
+#endif // _WIN32
+}
+
+void UnmapFile(const char * const pMapped, const size_t cBytes) {
+#ifdef _WIN32
+   UNUSED(cBytes);
+   UnmapViewOfFile(pMapped);
+#else // _WIN32
+   munmap(const_cast<char *>(pMapped), cBytes);
+#endif // _WIN32
+}
+
+INLINE_RELEASE_UNTEMPLATED static size_t GetCountDataUnits(const size_t cSamples, const size_t cItemsPerBitPackedDataUnit) {
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+   return (cSamples - 1) / cItemsPerBitPackedDataUnit + 1; // this can't overflow or underflow
+}
+
+INLINE_RELEASE_UNTEMPLATED static size_t AlignPackedData(const size_t iByte) {
+   // the caller checks that this can't overflow
+   return (iByte + (k_cBytesPackedDataAlignment - 1)) / k_cBytesPackedDataAlignment * k_cBytesPackedDataAlignment;
+}
+
+bool PackedData::IsValid() const {
+   if(m_cBytesMapped < sizeof(PackedDataHeader)) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid file too small for the header");
+      return false;
+   }
+   const PackedDataHeader * const pHeader = GetHeader();
+   if(k_packedDataMagic != pHeader->m_magic) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid not a packed data file, or written with a different byte order");
+      return false;
+   }
+   if(k_packedDataVersion != pHeader->m_version) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid unsupported version");
+      return false;
+   }
+   if(sizeof(StorageDataType) != pHeader->m_cBytesStorageDataType) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid written with a different StorageDataType size");
+      return false;
+   }
+   if(static_cast<uint64_t>(m_cBytesMapped) != pHeader->m_cBytesFile) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid file was truncated");
+      return false;
+   }
+   if(0 == pHeader->m_cSamples || !IsNumberConvertable<size_t>(pHeader->m_cSamples)) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid number of samples");
+      return false;
+   }
+   if(!IsNumberConvertable<size_t>(pHeader->m_cFeatureGroups)) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid number of feature groups");
+      return false;
+   }
+   const size_t cSamples = GetCountSamples();
+   const size_t cFeatureGroups = GetCountFeatureGroups();
+
+   // the file size fits into a size_t, so if the records fit into the file they fit into a size_t
+   const size_t cBytesAfterHeader = m_cBytesMapped - sizeof(PackedDataHeader);
+   if(cBytesAfterHeader / sizeof(PackedFeatureGroupRecord) < cFeatureGroups) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsValid file too small for the feature group records");
+      return false;
+   }
+   const size_t cBytesAfterFeatureGroupRecords = cBytesAfterHeader - sizeof(PackedFeatureGroupRecord) * cFeatureGroups;
+   const size_t cFeatureRecordsMax = cBytesAfterFeatureGroupRecords / sizeof(PackedFeatureRecord);
+
+   const PackedFeatureGroupRecord * const aFeatureGroupRecords = GetFeatureGroupRecords();
+   const PackedFeatureRecord * const aFeatureRecords = GetFeatureRecords();
+   size_t cFeatureRecords = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const PackedFeatureGroupRecord * const pFeatureGroupRecord = &aFeatureGroupRecords[iFeatureGroup];
+      if(k_cDimensionsMax < pFeatureGroupRecord->m_cFeatures) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsValid feature group with too many features");
+         return false;
+      }
+      const size_t cFeatures = static_cast<size_t>(pFeatureGroupRecord->m_cFeatures);
+      if(static_cast<uint64_t>(cFeatureRecords) != pFeatureGroupRecord->m_iFirstFeatureRecord ||
+         cFeatureRecordsMax - cFeatureRecords < cFeatures
+      ) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid feature records");
+         return false;
+      }
+      if(0 == cFeatures) {
+         if(0 != pFeatureGroupRecord->m_iByteData) {
+            LOG_0(TraceLevelError, "ERROR PackedData::IsValid feature group without features has data");
+            return false;
+         }
+         continue;
+      }
+
+      size_t cTensorBins = 1;
+      const PackedFeatureRecord * pFeatureRecord = &aFeatureRecords[cFeatureRecords];
+      const PackedFeatureRecord * const pFeatureRecordEnd = pFeatureRecord + cFeatures;
+      do {
+         if(pFeatureRecord->m_cBins < 2 || !IsNumberConvertable<size_t>(pFeatureRecord->m_cBins)) {
+            LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid number of bins");
+            return false;
+         }
+         const size_t cBins = static_cast<size_t>(pFeatureRecord->m_cBins);
+         if(IsMultiplyError(cTensorBins, cBins)) {
+            LOG_0(TraceLevelError, "ERROR PackedData::IsValid IsMultiplyError(cTensorBins, cBins)");
+            return false;
+         }
+         cTensorBins *= cBins;
+         ++pFeatureRecord;
+      } while(pFeatureRecordEnd != pFeatureRecord);
+      cFeatureRecords += cFeatures;
+
+      // boosters can round the items up to aligned widths, so accept any packing that has room for every bin and 
+      // that GetCountItemsBitPacked can produce
+      const size_t cItemsPerBitPackedDataUnitMax = GetCountItemsBitPacked(CountBitsRequired(cTensorBins - 1));
+      if(0 == pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit ||
+         static_cast<uint64_t>(cItemsPerBitPackedDataUnitMax) < pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit
+      ) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid bit packing");
+         return false;
+      }
+      const size_t cItemsPerBitPackedDataUnit = static_cast<size_t>(pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit);
+      if(GetCountItemsBitPacked(GetCountBits(cItemsPerBitPackedDataUnit)) != cItemsPerBitPackedDataUnit) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid bit packing");
+         return false;
+      }
+      const size_t cDataUnits = GetCountDataUnits(cSamples, cItemsPerBitPackedDataUnit);
+      const uint64_t iByteData = pFeatureGroupRecord->m_iByteData;
+      if(0 == iByteData ||
+         0 != iByteData % k_cBytesPackedDataAlignment ||
+         static_cast<uint64_t>(m_cBytesMapped) < iByteData ||
+         (m_cBytesMapped - static_cast<size_t>(iByteData)) / sizeof(StorageDataType) < cDataUnits
+      ) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsValid invalid data location");
+         return false;
+      }
+
+      // unused items in the last data unit are zero, so we can check every item in every data unit
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      const size_t maskBits = std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax);
+      const StorageDataType * pInputData = GetInputData(iFeatureGroup);
+      const StorageDataType * const pInputDataEnd = pInputData + cDataUnits;
+      do {
+         size_t iTensorBinCombined = static_cast<size_t>(*pInputData);
+         for(size_t iItem = 0; iItem < cItemsPerBitPackedDataUnit; ++iItem) {
+            if(cTensorBins <= (maskBits & iTensorBinCombined)) {
+               LOG_0(TraceLevelError, "ERROR PackedData::IsValid bit packed value outside of the tensor");
+               return false;
+            }
+            iTensorBinCombined >>= cBitsPerItemMax;
+         }
+         ++pInputData;
+      } while(pInputDataEnd != pInputData);
+   }
+   return true;
+}
+
+PackedData * PackedData::Allocate(const char * const pMapped, const size_t cBytesMapped, const bool bAllocated) {
+   EBM_ASSERT(nullptr != pMapped);
+
+   PackedData * const pPackedData = EbmMalloc<PackedData>();
+   if(nullptr == pPackedData) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Allocate nullptr == pPackedData");
+      return nullptr;
+   }
+   pPackedData->m_pMapped = pMapped;
+   pPackedData->m_cBytesMapped = cBytesMapped;
+   pPackedData->m_bAllocated = bAllocated;
+   // the reference of our caller
+   pPackedData->m_cReferences.store(1, std::memory_order_relaxed);
+   return pPackedData;
+}
+
+PackedData * PackedData::Open(const char * const filePath) {
+   LOG_0(TraceLevelInfo, "Entered PackedData::Open");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   size_t cBytesMapped;
+   const char * const pMapped = MapFile(filePath, &cBytesMapped);
+   if(nullptr == pMapped) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Open nullptr == pMapped");
+      return nullptr;
+   }
+   PackedData * const pPackedData = Allocate(pMapped, cBytesMapped, false);
+   if(nullptr == pPackedData) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Open nullptr == pPackedData");
+      UnmapFile(pMapped, cBytesMapped);
+      return nullptr;
+   }
+   if(!pPackedData->IsValid()) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Open !IsValid()");
+      Close(pPackedData);
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedData::Open");
+   return pPackedData;
+}
+
+void PackedData::Close(PackedData * const pPackedData) {
+   LOG_0(TraceLevelInfo, "Entered PackedData::Close");
+   // fetch_sub returns the count before our release, so only the last owner frees the data.  acq_rel makes every 
+   // other owner's reads happen before we free the memory
+   if(nullptr != pPackedData && size_t { 1 } == pPackedData->m_cReferences.fetch_sub(1, std::memory_order_acq_rel)) {
+      if(pPackedData->m_bAllocated) {
+         AlignedFree(const_cast<char *>(pPackedData->m_pMapped));
+      } else {
+         UnmapFile(pPackedData->m_pMapped, pPackedData->m_cBytesMapped);
+      }
+      free(pPackedData);
+   }
+   LOG_0(TraceLevelInfo, "Exited PackedData::Close");
+}
+
+// fills in the header and the records that describe the bit packed data of the feature groups.  On success the 
+// caller frees *paFeatureGroupRecordsOut and *paFeatureRecordsOut.  Returns true on error
+static bool BuildLayout(
+   const char * const sFunctionName,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const size_t cSamples,
+   PackedDataHeader * const pHeaderOut,
+   PackedFeatureGroupRecord * * const paFeatureGroupRecordsOut,
+   PackedFeatureRecord * * const paFeatureRecordsOut,
+   size_t * const pcFeatureRecordsOut
+) {
+   UNUSED(sFunctionName);
+
+   size_t cFeatureRecords = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      // each feature group has at most k_cDimensionsMax features and we already hold the FeatureGroup objects in memory
+      cFeatureRecords += apFeatureGroup[iFeatureGroup]->GetCountFeatures();
+   }
+
+   // we already hold the bit packed data in memory, so the only way to overflow is with our padding
+   size_t iByteNext = sizeof(PackedDataHeader) +
+      sizeof(PackedFeatureGroupRecord) * cFeatureGroups + sizeof(PackedFeatureRecord) * cFeatureRecords;
+
+   PackedFeatureGroupRecord * const aFeatureGroupRecords = EbmMalloc<PackedFeatureGroupRecord>(cFeatureGroups);
+   PackedFeatureRecord * const aFeatureRecords = EbmMalloc<PackedFeatureRecord>(cFeatureRecords);
+   if((0 != cFeatureGroups && nullptr == aFeatureGroupRecords) || (0 != cFeatureRecords && nullptr == aFeatureRecords)) {
+      LOG_N(TraceLevelWarning, "WARNING %s out of memory", sFunctionName);
+      free(aFeatureGroupRecords);
+      free(aFeatureRecords);
+      return true;
+   }
+
+   size_t iFeatureRecord = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+      const size_t cFeatures = pFeatureGroup->GetCountFeatures();
+      PackedFeatureGroupRecord * const pFeatureGroupRecord = &aFeatureGroupRecords[iFeatureGroup];
+      pFeatureGroupRecord->m_cFeatures = static_cast<uint64_t>(cFeatures);
+      pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit = 0;
+      pFeatureGroupRecord->m_iFirstFeatureRecord = static_cast<uint64_t>(iFeatureRecord);
+      pFeatureGroupRecord->m_iByteData = 0;
+      if(0 != cFeatures) {
+         const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+         pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit = static_cast<uint64_t>(cItemsPerBitPackedDataUnit);
+
+         if(IsAddError(iByteNext, k_cBytesPackedDataAlignment)) {
+            LOG_N(TraceLevelWarning, "WARNING %s IsAddError(iByteNext, k_cBytesPackedDataAlignment)", sFunctionName);
+            free(aFeatureGroupRecords);
+            free(aFeatureRecords);
+            return true;
+         }
+         iByteNext = AlignPackedData(iByteNext);
+         pFeatureGroupRecord->m_iByteData = static_cast<uint64_t>(iByteNext);
+         // this data is already in memory, so its size can't overflow, but our padding can push us over
+         const size_t cBytesData = sizeof(StorageDataType) * GetCountDataUnits(cSamples, cItemsPerBitPackedDataUnit);
+         if(IsAddError(iByteNext, cBytesData)) {
+            LOG_N(TraceLevelWarning, "WARNING %s IsAddError(iByteNext, cBytesData)", sFunctionName);
+            free(aFeatureGroupRecords);
+            free(aFeatureRecords);
+            return true;
+         }
+         iByteNext += cBytesData;
+
+         const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
+         const FeatureGroupEntry * const pFeatureGroupEntryEnd = pFeatureGroupEntry + cFeatures;
+         do {
+            const Feature * const pFeature = pFeatureGroupEntry->m_pFeature;
+            aFeatureRecords[iFeatureRecord].m_iFeatureData = static_cast<uint64_t>(pFeature->GetIndexFeatureData());
+            aFeatureRecords[iFeatureRecord].m_cBins = static_cast<uint64_t>(pFeature->GetCountBins());
+            ++iFeatureRecord;
+            ++pFeatureGroupEntry;
+         } while(pFeatureGroupEntryEnd != pFeatureGroupEntry);
+      }
+   }
+   EBM_ASSERT(cFeatureRecords == iFeatureRecord);
+
+   pHeaderOut->m_magic = k_packedDataMagic;
+   pHeaderOut->m_version = k_packedDataVersion;
+   pHeaderOut->m_cBytesStorageDataType = static_cast<uint64_t>(sizeof(StorageDataType));
+   pHeaderOut->m_cSamples = static_cast<uint64_t>(cSamples);
+   pHeaderOut->m_cFeatureGroups = static_cast<uint64_t>(cFeatureGroups);
+   pHeaderOut->m_cBytesFile = static_cast<uint64_t>(iByteNext);
+
+   *paFeatureGroupRecordsOut = aFeatureGroupRecords;
+   *paFeatureRecordsOut = aFeatureRecords;
+   *pcFeatureRecordsOut = cFeatureRecords;
+   return false;
+}
+
+PackedData * PackedData::Create(
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const size_t cSamples,
+   const StorageDataType * const * const aaInputData
+) {
+   LOG_0(TraceLevelInfo, "Entered PackedData::Create");
+
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(0 == cFeatureGroups || nullptr != apFeatureGroup);
+   EBM_ASSERT(0 == cFeatureGroups || nullptr != aaInputData);
+
+   PackedDataHeader header;
+   PackedFeatureGroupRecord * aFeatureGroupRecords;
+   PackedFeatureRecord * aFeatureRecords;
+   size_t cFeatureRecords;
+   if(BuildLayout("PackedData::Create", cFeatureGroups, apFeatureGroup, cSamples, &header, &aFeatureGroupRecords, 
+      &aFeatureRecords, &cFeatureRecords)) 
+   {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Create BuildLayout");
+      return nullptr;
+   }
+
+   const size_t cBytes = static_cast<size_t>(header.m_cBytesFile);
+   char * const pMemory = static_cast<char *>(AlignedMalloc(MemorySubsystem::PackedData, cBytes));
+   if(nullptr == pMemory) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Create nullptr == pMemory");
+      free(aFeatureGroupRecords);
+      free(aFeatureRecords);
+      return nullptr;
+   }
+
+   size_t iByteWritten = 0;
+   memcpy(pMemory, &header, sizeof(header));
+   iByteWritten += sizeof(header);
+   memcpy(pMemory + iByteWritten, aFeatureGroupRecords, sizeof(PackedFeatureGroupRecord) * cFeatureGroups);
+   iByteWritten += sizeof(PackedFeatureGroupRecord) * cFeatureGroups;
+   memcpy(pMemory + iByteWritten, aFeatureRecords, sizeof(PackedFeatureRecord) * cFeatureRecords);
+   iByteWritten += sizeof(PackedFeatureRecord) * cFeatureRecords;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const PackedFeatureGroupRecord * const pFeatureGroupRecord = &aFeatureGroupRecords[iFeatureGroup];
+      if(0 != pFeatureGroupRecord->m_iByteData) {
+         const size_t iByteData = static_cast<size_t>(pFeatureGroupRecord->m_iByteData);
+         EBM_ASSERT(iByteWritten <= iByteData);
+         memset(pMemory + iByteWritten, 0, iByteData - iByteWritten);
+         const size_t cBytesData = sizeof(StorageDataType) * 
+            GetCountDataUnits(cSamples, static_cast<size_t>(pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit));
+         memcpy(pMemory + iByteData, aaInputData[iFeatureGroup], cBytesData);
+         iByteWritten = iByteData + cBytesData;
+      }
+   }
+   EBM_ASSERT(cBytes == iByteWritten);
+
+   free(aFeatureGroupRecords);
+   free(aFeatureRecords);
+
+   PackedData * const pPackedData = Allocate(pMemory, cBytes, true);
+   if(nullptr == pPackedData) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Create nullptr == pPackedData");
+      AlignedFree(pMemory);
+      return nullptr;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedData::Create");
+   return pPackedData;
+}
+
+bool PackedData::Write(
+   const char * const filePath,
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const size_t cSamples,
+   const StorageDataType * const * const aaInputData
+) {
+   LOG_0(TraceLevelInfo, "Entered PackedData::Write");
+
+   EBM_ASSERT(nullptr != filePath);
+   EBM_ASSERT(1 <= cSamples);
+   EBM_ASSERT(0 == cFeatureGroups || nullptr != apFeatureGroup);
+   EBM_ASSERT(0 == cFeatureGroups || nullptr != aaInputData);
+
+   PackedDataHeader header;
+   PackedFeatureGroupRecord * aFeatureGroupRecords;
+   PackedFeatureRecord * aFeatureRecords;
+   size_t cFeatureRecords;
+   if(BuildLayout("PackedData::Write", cFeatureGroups, apFeatureGroup, cSamples, &header, &aFeatureGroupRecords, 
+      &aFeatureRecords, &cFeatureRecords)) 
+   {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Write BuildLayout");
+      return true;
+   }
+   FILE * const pFile = fopen(filePath, "wb");
+   if(nullptr == pFile) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Write fopen");
+      free(aFeatureGroupRecords);
+      free(aFeatureRecords);
+      return true;
+   }
+
+   bool bError = 1 != fwrite(&header, sizeof(header), 1, pFile) ||
+      cFeatureGroups != fwrite(aFeatureGroupRecords, sizeof(PackedFeatureGroupRecord), cFeatureGroups, pFile) ||
+      cFeatureRecords != fwrite(aFeatureRecords, sizeof(PackedFeatureRecord), cFeatureRecords, pFile);
+   size_t iByteWritten = sizeof(PackedDataHeader) +
+      sizeof(PackedFeatureGroupRecord) * cFeatureGroups + sizeof(PackedFeatureRecord) * cFeatureRecords;
+
+   char padding[k_cBytesPackedDataAlignment];
+   memset(padding, 0, sizeof(padding));
+   for(size_t iFeatureGroup = 0; !bError && iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const PackedFeatureGroupRecord * const pFeatureGroupRecord = &aFeatureGroupRecords[iFeatureGroup];
+      if(0 != pFeatureGroupRecord->m_iByteData) {
+         const size_t iByteData = static_cast<size_t>(pFeatureGroupRecord->m_iByteData);
+         EBM_ASSERT(iByteWritten <= iByteData);
+         const size_t cBytesPadding = iByteData - iByteWritten;
+         EBM_ASSERT(cBytesPadding < k_cBytesPackedDataAlignment);
+         const size_t cDataUnits = GetCountDataUnits(cSamples, static_cast<size_t>(pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit));
+         bError = cBytesPadding != fwrite(padding, 1, cBytesPadding, pFile) ||
+            cDataUnits != fwrite(aaInputData[iFeatureGroup], sizeof(StorageDataType), cDataUnits, pFile);
+         iByteWritten = iByteData + sizeof(StorageDataType) * cDataUnits;
+      }
+   }
+   EBM_ASSERT(bError || static_cast<size_t>(header.m_cBytesFile) == iByteWritten);
+
+   free(aFeatureGroupRecords);
+   free(aFeatureRecords);
+
+   if(0 != fclose(pFile)) {
+      bError = true;
+   }
+   if(bError) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Write could not write the file");
+      return true;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedData::Write");
+   return false;
+}
+
+bool PackedData::Save(const char * const filePath) const {
+   LOG_0(TraceLevelInfo, "Entered PackedData::Save");
+
+   EBM_ASSERT(nullptr != filePath);
+
+   const size_t cBytesFile = static_cast<size_t>(GetHeader()->m_cBytesFile);
+   EBM_ASSERT(cBytesFile <= m_cBytesMapped);
+
+   FILE * const pFile = fopen(filePath, "wb");
+   if(nullptr == pFile) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Save fopen");
+      return true;
+   }
+   bool bError = 1 != fwrite(m_pMapped, cBytesFile, 1, pFile);
+   if(0 != fclose(pFile)) {
+      bError = true;
+   }
+   if(bError) {
+      LOG_0(TraceLevelWarning, "WARNING PackedData::Save could not write the file");
+      return true;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedData::Save");
+   return false;
+}
+
+bool PackedData::IsMismatched(
+   const size_t cFeatureGroups,
+   const FeatureGroup * const * const apFeatureGroup,
+   const size_t cSamples
+) const {
+   if(GetCountSamples() != cSamples) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsMismatched the number of samples does not match");
+      return true;
+   }
+   if(GetCountFeatureGroups() != cFeatureGroups) {
+      LOG_0(TraceLevelError, "ERROR PackedData::IsMismatched the number of feature groups does not match");
+      return true;
+   }
+   const PackedFeatureGroupRecord * const aFeatureGroupRecords = GetFeatureGroupRecords();
+   const PackedFeatureRecord * const aFeatureRecords = GetFeatureRecords();
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+      const PackedFeatureGroupRecord * const pFeatureGroupRecord = &aFeatureGroupRecords[iFeatureGroup];
+      const size_t cFeatures = pFeatureGroup->GetCountFeatures();
+      if(static_cast<uint64_t>(cFeatures) != pFeatureGroupRecord->m_cFeatures) {
+         LOG_0(TraceLevelError, "ERROR PackedData::IsMismatched the features of a feature group do not match");
+         return true;
+      }
+      if(0 != cFeatures) {
+         const PackedFeatureRecord * pFeatureRecord = &aFeatureRecords[static_cast<size_t>(pFeatureGroupRecord->m_iFirstFeatureRecord)];
+         const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
+         const FeatureGroupEntry * const pFeatureGroupEntryEnd = pFeatureGroupEntry + cFeatures;
+         do {
+            const Feature * const pFeature = pFeatureGroupEntry->m_pFeature;
+            if(static_cast<uint64_t>(pFeature->GetIndexFeatureData()) != pFeatureRecord->m_iFeatureData ||
+               static_cast<uint64_t>(pFeature->GetCountBins()) != pFeatureRecord->m_cBins
+            ) {
+               LOG_0(TraceLevelError, "ERROR PackedData::IsMismatched the features of a feature group do not match");
+               return true;
+            }
+            ++pFeatureRecord;
+            ++pFeatureGroupEntry;
+         } while(pFeatureGroupEntryEnd != pFeatureGroupEntry);
+         // the booster takes its packing from the packed data, but the training and validation sets can disagree
+         if(static_cast<uint64_t>(pFeatureGroup->GetCountItemsPerBitPackedDataUnit()) != 
+            pFeatureGroupRecord->m_cItemsPerBitPackedDataUnit
+         ) {
+            LOG_0(TraceLevelError, "ERROR PackedData::IsMismatched the bit packing of a feature group does not match");
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmPackedData EBM_NATIVE_CALLING_CONVENTION OpenPackedData(
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered OpenPackedData: filePath=%p", static_cast<const void *>(filePath));
+
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR OpenPackedData filePath cannot be nullptr");
+      return nullptr;
+   }
+   const PEbmPackedData packedData = reinterpret_cast<PEbmPackedData>(PackedData::Open(filePath));
+
+   LOG_N(TraceLevelInfo, "Exited OpenPackedData %p", static_cast<void *>(packedData));
+   return packedData;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SavePackedData(
+   PEbmPackedData packedData,
+   const char * filePath
+) {
+   LOG_N(TraceLevelInfo, "Entered SavePackedData: packedData=%p, filePath=%p", static_cast<void *>(packedData), 
+      static_cast<const void *>(filePath));
+
+   if(nullptr == packedData) {
+      LOG_0(TraceLevelError, "ERROR SavePackedData packedData cannot be nullptr");
+      return 1;
+   }
+   if(nullptr == filePath) {
+      LOG_0(TraceLevelError, "ERROR SavePackedData filePath cannot be nullptr");
+      return 1;
+   }
+   if(reinterpret_cast<const PackedData *>(packedData)->Save(filePath)) {
+      LOG_0(TraceLevelWarning, "WARNING SavePackedData PackedData::Save");
+      return 1;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited SavePackedData");
+   return 0;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION ClosePackedData(
+   PEbmPackedData packedData
+) {
+   LOG_N(TraceLevelInfo, "Entered ClosePackedData: packedData=%p", static_cast<void *>(packedData));
+
+   // it's legal to call ClosePackedData on nullptr, just like for free().  This is checked inside PackedData::Close()
+   PackedData::Close(reinterpret_cast<PackedData *>(packedData));
+
+   LOG_0(TraceLevelInfo, "Exited ClosePackedData");
+}
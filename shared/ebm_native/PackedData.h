@@ -0,0 +1,177 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef PACKED_DATA_H
+#define PACKED_DATA_H
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <inttypes.h> // uint64_t
+#include <atomic>
+
+#include "ebm_native.h" // IntEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "FeatureGroup.h"
+
+// The packed file holds the bit packed binned data of a DataSetByFeatureGroup exactly as we hold it in memory, so
+// that InitializeBoosting*Packed can map the file read-only and use it in place without re-packing anything.
+// Every process that maps the same file shares the same physical pages.  PackedData::Create builds the same layout
+// in memory instead, so that the boosters of several outer bags in one process can share one copy of the data.
+//
+// Layout: PackedDataHeader, then m_cFeatureGroups PackedFeatureGroupRecord items, then all the
+// PackedFeatureRecord items of the feature groups in order, then the bit packed data of each feature group starting
+// at an offset that is a multiple of k_cBytesPackedDataAlignment.  Every field is a uint64_t in the native byte
+// order, so a file written on a machine with a different byte order fails the magic number check.
+
+constexpr uint64_t k_packedDataMagic = uint64_t { 0x314B434150424D45 }; // "EBMPACK1" in little endian
+constexpr uint64_t k_packedDataVersion = 1;
+constexpr size_t k_cBytesPackedDataAlignment = 64;
+
+struct PackedDataHeader final {
+   PackedDataHeader() = default; // preserve our POD status
+   ~PackedDataHeader() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_magic;
+   uint64_t m_version;
+   uint64_t m_cBytesStorageDataType;
+   uint64_t m_cSamples;
+   uint64_t m_cFeatureGroups;
+   uint64_t m_cBytesFile;
+};
+static_assert(std::is_standard_layout<PackedDataHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PackedDataHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PackedDataHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+struct PackedFeatureGroupRecord final {
+   PackedFeatureGroupRecord() = default; // preserve our POD status
+   ~PackedFeatureGroupRecord() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // the number of significant features, which excludes features with 1 bin just like FeatureGroup does
+   uint64_t m_cFeatures;
+   uint64_t m_cItemsPerBitPackedDataUnit;
+   uint64_t m_iFirstFeatureRecord;
+   // 0 if the feature group has no significant features, since then there is no data
+   uint64_t m_iByteData;
+};
+static_assert(std::is_standard_layout<PackedFeatureGroupRecord>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PackedFeatureGroupRecord>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PackedFeatureGroupRecord>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+struct PackedFeatureRecord final {
+   PackedFeatureRecord() = default; // preserve our POD status
+   ~PackedFeatureRecord() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_iFeatureData;
+   uint64_t m_cBins;
+};
+static_assert(std::is_standard_layout<PackedFeatureRecord>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PackedFeatureRecord>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PackedFeatureRecord>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class PackedData final {
+   // the whole file mapped read-only, or our own allocation if m_bAllocated.  Everything we return points into this
+   // memory
+   const char * m_pMapped;
+   size_t m_cBytesMapped;
+   bool m_bAllocated;
+   // our caller holds one reference and every booster that uses us holds another, so our caller can close us as
+   // soon as it has handed us to its boosters.  Boosters on different threads can be freed at the same time
+   std::atomic<size_t> m_cReferences;
+
+   INLINE_ALWAYS const PackedDataHeader * GetHeader() const {
+      return reinterpret_cast<const PackedDataHeader *>(m_pMapped);
+   }
+   INLINE_ALWAYS const PackedFeatureGroupRecord * GetFeatureGroupRecords() const {
+      return reinterpret_cast<const PackedFeatureGroupRecord *>(m_pMapped + sizeof(PackedDataHeader));
+   }
+   INLINE_ALWAYS const PackedFeatureRecord * GetFeatureRecords() const {
+      return reinterpret_cast<const PackedFeatureRecord *>(m_pMapped + sizeof(PackedDataHeader) +
+         sizeof(PackedFeatureGroupRecord) * GetCountFeatureGroups());
+   }
+
+   bool IsValid() const;
+
+   static PackedData * Allocate(const char * const pMapped, const size_t cBytesMapped, const bool bAllocated);
+
+public:
+
+   PackedData() = default; // we're allocated with malloc, so keep these trivial
+   ~PackedData() = default; // we're allocated with malloc, so keep these trivial
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // maps the file and checks that every bit packed item fits inside its tensor, so a corrupted file can't make us
+   // index outside of our histograms later
+   static PackedData * Open(const char * const filePath);
+   // copies the bit packed data into a new in-memory PackedData.  Returns nullptr on error
+   static PackedData * Create(
+      const size_t cFeatureGroups,
+      const FeatureGroup * const * const apFeatureGroup,
+      const size_t cSamples,
+      const StorageDataType * const * const aaInputData
+   );
+   // releases one reference, and frees the data once nobody refers to it anymore
+   static void Close(PackedData * const pPackedData);
+
+   INLINE_ALWAYS void AddReference() {
+      m_cReferences.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   // returns true on error
+   static bool Write(
+      const char * const filePath,
+      const size_t cFeatureGroups,
+      const FeatureGroup * const * const apFeatureGroup,
+      const size_t cSamples,
+      const StorageDataType * const * const aaInputData
+   );
+
+   // writes our memory as is, since it already has the file layout that Open maps.  Returns true on error
+   bool Save(const char * const filePath) const;
+
+   // returns true if the feature groups were bit packed differently than in this file
+   bool IsMismatched(
+      const size_t cFeatureGroups,
+      const FeatureGroup * const * const apFeatureGroup,
+      const size_t cSamples
+   ) const;
+
+   INLINE_ALWAYS size_t GetCountSamples() const {
+      return static_cast<size_t>(GetHeader()->m_cSamples);
+   }
+   INLINE_ALWAYS size_t GetCountFeatureGroups() const {
+      return static_cast<size_t>(GetHeader()->m_cFeatureGroups);
+   }
+   INLINE_ALWAYS uint64_t GetCountItemsPerBitPackedDataUnit(const size_t iFeatureGroup) const {
+      EBM_ASSERT(iFeatureGroup < GetCountFeatureGroups());
+      return GetFeatureGroupRecords()[iFeatureGroup].m_cItemsPerBitPackedDataUnit;
+   }
+   // nullptr if the feature group has no significant features
+   INLINE_ALWAYS const StorageDataType * GetInputData(const size_t iFeatureGroup) const {
+      EBM_ASSERT(iFeatureGroup < GetCountFeatureGroups());
+      const uint64_t iByteData = GetFeatureGroupRecords()[iFeatureGroup].m_iByteData;
+      return 0 == iByteData ? nullptr : reinterpret_cast<const StorageDataType *>(m_pMapped + static_cast<size_t>(iByteData));
+   }
+};
+// std::atomic isn't trivially copyable, so PackedData isn't POD, but we never copy it and only hand out pointers
+static_assert(std::is_standard_layout<PackedData>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+
+#endif // PACKED_DATA_H
@@ -0,0 +1,246 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memset
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "AlignedMemory.h"
+#include "FeatureAtomic.h"
+#include "FeatureGroup.h"
+#include "Booster.h"
+#include "PackedData.h"
+#include "PackedDataBuilder.h"
+
+bool IsColumnsInvalid(const size_t cFeatures, const EbmNativeBinnedColumn * const aColumns, const size_t cSamples) {
+   EBM_ASSERT(0 < cFeatures);
+   EBM_ASSERT(0 < cSamples);
+
+   if(nullptr == aColumns) {
+      LOG_0(TraceLevelError, "ERROR IsColumnsInvalid columns cannot be nullptr if 0 < countFeatures");
+      return true;
+   }
+   const EbmNativeBinnedColumn * pColumn = aColumns;
+   const EbmNativeBinnedColumn * const pColumnsEnd = aColumns + cFeatures;
+   do {
+      if(nullptr == pColumn->data) {
+         LOG_0(TraceLevelError, "ERROR IsColumnsInvalid column data cannot be nullptr");
+         return true;
+      }
+      const IntEbmType countBytesPerBin = pColumn->countBytesPerBin;
+      if(IntEbmType { sizeof(uint8_t) } != countBytesPerBin &&
+         IntEbmType { sizeof(uint16_t) } != countBytesPerBin &&
+         IntEbmType { sizeof(uint32_t) } != countBytesPerBin &&
+         IntEbmType { sizeof(IntEbmType) } != countBytesPerBin)
+      {
+         LOG_0(TraceLevelError, "ERROR IsColumnsInvalid column countBytesPerBin must be 1, 2, 4 or 8");
+         return true;
+      }
+      const IntEbmType countBytesStride = pColumn->countBytesStride;
+      if(countBytesStride <= 0 || !IsNumberConvertable<size_t>(countBytesStride)) {
+         LOG_0(TraceLevelError, "ERROR IsColumnsInvalid column countBytesStride must be positive and fit in memory");
+         return true;
+      }
+      if(IsMultiplyError(static_cast<size_t>(countBytesStride), cSamples)) {
+         // the caller should not have been able to allocate a column this big
+         LOG_0(TraceLevelError, "ERROR IsColumnsInvalid IsMultiplyError(countBytesStride, cSamples)");
+         return true;
+      }
+      ++pColumn;
+   } while(pColumnsEnd != pColumn);
+   return false;
+}
+
+size_t PackedDataBuilder::GetCountFeatures() const {
+   return m_pEbmBoostingState->GetCountFeatures();
+}
+
+void PackedDataBuilder::Free(PackedDataBuilder * const pPackedDataBuilder) {
+   LOG_0(TraceLevelInfo, "Entered PackedDataBuilder::Free");
+
+   if(nullptr != pPackedDataBuilder) {
+      StorageDataType ** const aaInputData = pPackedDataBuilder->m_aaInputData;
+      if(nullptr != aaInputData) {
+         const size_t cFeatureGroups = pPackedDataBuilder->m_pEbmBoostingState->GetCountFeatureGroups();
+         for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            AlignedFree(aaInputData[iFeatureGroup]);
+         }
+         free(aaInputData);
+      }
+      EbmBoostingState::Free(pPackedDataBuilder->m_pEbmBoostingState);
+      free(pPackedDataBuilder);
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedDataBuilder::Free");
+}
+
+PackedDataBuilder * PackedDataBuilder::Allocate(EbmBoostingState * const pEbmBoostingState, const size_t cSamples) {
+   LOG_0(TraceLevelInfo, "Entered PackedDataBuilder::Allocate");
+
+   EBM_ASSERT(nullptr != pEbmBoostingState);
+   EBM_ASSERT(0 < cSamples);
+
+   PackedDataBuilder * const pPackedDataBuilder = EbmMalloc<PackedDataBuilder>();
+   if(nullptr == pPackedDataBuilder) {
+      LOG_0(TraceLevelWarning, "WARNING PackedDataBuilder::Allocate nullptr == pPackedDataBuilder");
+      EbmBoostingState::Free(pEbmBoostingState);
+      return nullptr;
+   }
+   pPackedDataBuilder->m_pEbmBoostingState = pEbmBoostingState;
+   pPackedDataBuilder->m_cSamples = cSamples;
+   pPackedDataBuilder->m_cSamplesAppended = 0;
+   pPackedDataBuilder->m_bFailed = false;
+   pPackedDataBuilder->m_aaInputData = nullptr;
+
+   const size_t cFeatureGroups = pEbmBoostingState->GetCountFeatureGroups();
+   if(0 != cFeatureGroups) {
+      StorageDataType ** const aaInputData = EbmMalloc<StorageDataType *>(cFeatureGroups);
+      if(nullptr == aaInputData) {
+         LOG_0(TraceLevelWarning, "WARNING PackedDataBuilder::Allocate nullptr == aaInputData");
+         Free(pPackedDataBuilder);
+         return nullptr;
+      }
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         // free will skip over these if we exit early
+         aaInputData[iFeatureGroup] = nullptr;
+      }
+      pPackedDataBuilder->m_aaInputData = aaInputData;
+
+      const FeatureGroup * const * const apFeatureGroup = pEbmBoostingState->GetFeatureGroups();
+      for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+         if(0 != pFeatureGroup->GetCountFeatures()) {
+            const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+            const size_t cDataUnits = (cSamples - 1) / cItemsPerBitPackedDataUnit + 1; // this can't overflow or underflow
+            StorageDataType * const aInputData = AlignedMalloc<StorageDataType>(MemorySubsystem::PackedData, cDataUnits);
+            if(nullptr == aInputData) {
+               LOG_0(TraceLevelWarning, "WARNING PackedDataBuilder::Allocate nullptr == aInputData");
+               Free(pPackedDataBuilder);
+               return nullptr;
+            }
+            // Append ORs each item into place, and the unused high bits of the last unit need to stay zero just like
+            // ConstructInputData leaves them
+            memset(aInputData, 0, sizeof(StorageDataType) * cDataUnits);
+            aaInputData[iFeatureGroup] = aInputData;
+         }
+      }
+   }
+
+   LOG_0(TraceLevelInfo, "Exited PackedDataBuilder::Allocate");
+   return pPackedDataBuilder;
+}
+
+bool PackedDataBuilder::Append(const size_t cSamples, const EbmNativeBinnedColumn * const aColumns) {
+   LOG_0(TraceLevelInfo, "Entered PackedDataBuilder::Append");
+
+   EBM_ASSERT(0 < cSamples);
+
+   if(m_bFailed) {
+      LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Append a previous chunk failed");
+      return true;
+   }
+   if(m_cSamples - m_cSamplesAppended < cSamples) {
+      LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Append more samples were appended than countSamples");
+      return true;
+   }
+   const size_t iSampleFirst = m_cSamplesAppended;
+
+   const size_t cFeatureGroups = m_pEbmBoostingState->GetCountFeatureGroups();
+   const FeatureGroup * const * const apFeatureGroup = m_pEbmBoostingState->GetFeatureGroups();
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FeatureGroup * const pFeatureGroup = apFeatureGroup[iFeatureGroup];
+      const size_t cFeatures = pFeatureGroup->GetCountFeatures();
+      if(0 == cFeatures) {
+         continue;
+      }
+      EBM_ASSERT(nullptr != aColumns);
+
+      const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+      EBM_ASSERT(cItemsPerBitPackedDataUnit <= CountBitsRequiredPositiveMax<StorageDataType>());
+      const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(cBitsPerItemMax <= CountBitsRequiredPositiveMax<StorageDataType>());
+
+      const EbmNativeBinnedColumn * apColumn[k_cDimensionsMax];
+      size_t acBins[k_cDimensionsMax];
+      const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
+      for(size_t iDimension = 0; iDimension < cFeatures; ++iDimension) {
+         const Feature * const pFeature = pFeatureGroupEntry->m_pFeature;
+         apColumn[iDimension] = &aColumns[pFeature->GetIndexFeatureData()];
+         acBins[iDimension] = pFeature->GetCountBins();
+         ++pFeatureGroupEntry;
+      }
+
+      // the chunk can start part way through a data unit, so pick up the item position where the last chunk stopped
+      StorageDataType * pInputData = &m_aaInputData[iFeatureGroup][iSampleFirst / cItemsPerBitPackedDataUnit];
+      size_t shift = (iSampleFirst % cItemsPerBitPackedDataUnit) * cBitsPerItemMax;
+      const size_t shiftEnd = cBitsPerItemMax * cItemsPerBitPackedDataUnit;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         size_t tensorMultiple = 1;
+         size_t tensorIndex = 0;
+         for(size_t iDimension = 0; iDimension < cFeatures; ++iDimension) {
+            const EbmNativeBinnedColumn * const pColumn = apColumn[iDimension];
+            // IsColumnsInvalid checked that this multiplication can't overflow
+            const char * const pBin = static_cast<const char *>(pColumn->data) +
+               iSample * static_cast<size_t>(pColumn->countBytesStride);
+            size_t iBin;
+            if(ReadColumnBin(pBin, static_cast<size_t>(pColumn->countBytesPerBin), &iBin)) {
+               LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Append bin value cannot be negative or too big to reference memory");
+               m_bFailed = true;
+               return true;
+            }
+            const size_t cBins = acBins[iDimension];
+            if(cBins <= iBin) {
+               LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Append bin value must be less than the number of bins");
+               m_bFailed = true;
+               return true;
+            }
+            // we check for overflows during FeatureGroup construction
+            EBM_ASSERT(!IsMultiplyError(tensorMultiple, cBins));
+            tensorIndex += tensorMultiple * iBin;
+            tensorMultiple *= cBins;
+         }
+         // first item in the least significant bits, just like ConstructInputData
+         EBM_ASSERT(shift < CountBitsRequiredPositiveMax<StorageDataType>());
+         const size_t bits = static_cast<size_t>(*pInputData) | (tensorIndex << shift);
+         EBM_ASSERT(IsNumberConvertable<StorageDataType>(bits));
+         *pInputData = static_cast<StorageDataType>(bits);
+         shift += cBitsPerItemMax;
+         if(shiftEnd == shift) {
+            shift = 0;
+            ++pInputData;
+         }
+      }
+   }
+   m_cSamplesAppended = iSampleFirst + cSamples;
+
+   LOG_0(TraceLevelInfo, "Exited PackedDataBuilder::Append");
+   return false;
+}
+
+PackedData * PackedDataBuilder::Finish() const {
+   LOG_0(TraceLevelInfo, "Entered PackedDataBuilder::Finish");
+
+   if(m_bFailed) {
+      LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Finish a previous chunk failed");
+      return nullptr;
+   }
+   if(m_cSamples != m_cSamplesAppended) {
+      LOG_0(TraceLevelError, "ERROR PackedDataBuilder::Finish fewer samples were appended than countSamples");
+      return nullptr;
+   }
+   PackedData * const pPackedData = PackedData::Create(
+      m_pEbmBoostingState->GetCountFeatureGroups(),
+      m_pEbmBoostingState->GetFeatureGroups(),
+      m_cSamples,
+      m_aaInputData
+   );
+
+   LOG_0(TraceLevelInfo, "Exited PackedDataBuilder::Finish");
+   return pPackedData;
+}
@@ -0,0 +1,86 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef PACKED_DATA_BUILDER_H
+#define PACKED_DATA_BUILDER_H
+
+#include <stdlib.h> // free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+
+#include "ebm_native.h" // IntEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "PackedData.h"
+
+class EbmBoostingState;
+
+// reads the bin of one sample from an EbmNativeBinnedColumn item, which can be unaligned.  Returns true if the bin
+// is negative or too big to reference memory, which only IntEbmType bins can be
+INLINE_ALWAYS bool ReadColumnBin(const char * const pBin, const size_t cBytesPerBin, size_t * const piBinOut) {
+   if(sizeof(uint8_t) == cBytesPerBin) {
+      uint8_t bin;
+      memcpy(&bin, pBin, sizeof(bin));
+      *piBinOut = static_cast<size_t>(bin);
+   } else if(sizeof(uint16_t) == cBytesPerBin) {
+      uint16_t bin;
+      memcpy(&bin, pBin, sizeof(bin));
+      *piBinOut = static_cast<size_t>(bin);
+   } else if(sizeof(uint32_t) == cBytesPerBin) {
+      uint32_t bin;
+      memcpy(&bin, pBin, sizeof(bin));
+      *piBinOut = static_cast<size_t>(bin);
+   } else {
+      EBM_ASSERT(sizeof(IntEbmType) == cBytesPerBin);
+      IntEbmType bin;
+      memcpy(&bin, pBin, sizeof(bin));
+      if(bin < 0 || !IsNumberConvertable<size_t>(bin)) {
+         return true;
+      }
+      *piBinOut = static_cast<size_t>(bin);
+   }
+   return false;
+}
+
+// returns true if any of the cFeatures columns can't be read for cSamples samples
+bool IsColumnsInvalid(const size_t cFeatures, const EbmNativeBinnedColumn * const aColumns, const size_t cSamples);
+
+// PackedDataBuilder bit packs chunks of samples straight into the per feature group storage, so that our caller
+// never needs to hold all of the binned data at once.  The storage is the same that
+// DataSetByFeatureGroup::ConstructInputData builds, so the PackedData that we finish with boosts identically
+class PackedDataBuilder final {
+   // owns the features and feature groups, and has no samples of its own
+   EbmBoostingState * m_pEbmBoostingState;
+   size_t m_cSamples;
+   size_t m_cSamplesAppended;
+   // once Append fails part way through a chunk, the storage holds part of that chunk, so we refuse to finish
+   bool m_bFailed;
+   StorageDataType ** m_aaInputData;
+
+public:
+
+   PackedDataBuilder() = default; // preserve our POD status
+   ~PackedDataBuilder() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // takes ownership of pEbmBoostingState, even on error.  Returns nullptr on error
+   static PackedDataBuilder * Allocate(EbmBoostingState * const pEbmBoostingState, const size_t cSamples);
+   static void Free(PackedDataBuilder * const pPackedDataBuilder);
+
+   // packs the next cSamples samples, reading one column per feature.  Returns true on error
+   bool Append(const size_t cSamples, const EbmNativeBinnedColumn * const aColumns);
+   // returns nullptr on error, or if fewer samples than promised were appended
+   PackedData * Finish() const;
+
+   size_t GetCountFeatures() const;
+};
+static_assert(std::is_standard_layout<PackedDataBuilder>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PackedDataBuilder>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PackedDataBuilder>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // PACKED_DATA_BUILDER_H
@@ -0,0 +1,83 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef PERFORMANCE_COUNTERS_H
+#define PERFORMANCE_COUNTERS_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <inttypes.h> // uint64_t
+#include <atomic>
+
+#include "ebm_native.h" // IntEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // AlwaysFalse
+#include "FeatureGroup.h"
+
+// compile with EBM_PERFORMANCE_COUNTERS defined to time our hot paths for GetPerformanceCounters.  Without it, the macros 
+// below expand to nothing, so their arguments are never evaluated and the counters cost nothing
+//#define EBM_PERFORMANCE_COUNTERS
+
+// the number of PerformanceCounter* values in ebm_native.h
+constexpr size_t k_cPerformanceCounters = 7;
+
+struct PerformanceCounterValues final {
+   PerformanceCounterValues() = default; // preserve our POD status
+   ~PerformanceCounterValues() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // the bags of a boosting step, the tasks of ThreadPool::ParallelFor and concurrent slots all stop their counters 
+   // from different threads, so the counters are atomic
+   std::atomic<uint64_t> m_cCalls;
+   std::atomic<uint64_t> m_cNanoseconds;
+   std::atomic<uint64_t> m_cBytesScanned;
+};
+// std::atomic isn't trivially copyable, so PerformanceCounterValues isn't POD, but we never copy it and EbmBoostingState
+// only holds a pointer to them, which keeps EbmBoostingState POD
+static_assert(std::is_standard_layout<PerformanceCounterValues>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+
+// the bytes that a pass over cSamples reads from a data set: the bit packed inputs of pFeatureGroup, if there are any, 
+// and cFloatsPerSample FloatEbmType values like residuals, scores and targets
+INLINE_ALWAYS uint64_t GetPerformanceCounterSampleBytes(
+   const size_t cSamples, 
+   const FeatureGroup * const pFeatureGroup, 
+   const size_t cFloatsPerSample
+) {
+   uint64_t cBytes = static_cast<uint64_t>(cSamples) * static_cast<uint64_t>(cFloatsPerSample) * sizeof(FloatEbmType);
+   if(nullptr != pFeatureGroup && 0 != pFeatureGroup->GetCountFeatures()) {
+      const uint64_t cItemsPerBitPackedDataUnit = static_cast<uint64_t>(pFeatureGroup->GetCountItemsPerBitPackedDataUnit());
+      const uint64_t cDataUnits = (static_cast<uint64_t>(cSamples) + cItemsPerBitPackedDataUnit - 1) / cItemsPerBitPackedDataUnit;
+      cBytes += cDataUnits * sizeof(StorageDataType);
+   }
+   return cBytes;
+}
+
+#ifdef EBM_PERFORMANCE_COUNTERS
+
+extern uint64_t GetPerformanceCounterNanoseconds();
+
+// relaxed ordering is enough since the counters are only read after the work that stops them has been joined
+#define PERFORMANCE_COUNTER_START(startName) \
+   const uint64_t startName = GetPerformanceCounterNanoseconds()
+
+#define PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startName, performanceCounter, cBytesScanned) \
+   do { \
+      PerformanceCounterValues * const PERF__pValues = (pEbmBoostingState)->GetPerformanceCounterValues(performanceCounter); \
+      PERF__pValues->m_cCalls.fetch_add(1, std::memory_order_relaxed); \
+      PERF__pValues->m_cNanoseconds.fetch_add(GetPerformanceCounterNanoseconds() - (startName), std::memory_order_relaxed); \
+      PERF__pValues->m_cBytesScanned.fetch_add((cBytesScanned), std::memory_order_relaxed); \
+   } while(AlwaysFalse())
+
+#else // EBM_PERFORMANCE_COUNTERS
+
+#define PERFORMANCE_COUNTER_START(startName) \
+   ((void)0)
+
+#define PERFORMANCE_COUNTER_STOP(pEbmBoostingState, startName, performanceCounter, cBytesScanned) \
+   ((void)0)
+
+#endif // EBM_PERFORMANCE_COUNTERS
+
+#endif // PERFORMANCE_COUNTERS_H
@@ -0,0 +1,1163 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "EbmStatisticUtils.h"
+
+#include "ThreadPool.h"
+
+extern IntEbmType DiscretizeInternal(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+);
+
+// we discretize this many samples of every feature at a time and then sum the tensor lookups of all the feature
+// groups over them.  The discretized bins of all features for a block fit in the L2 cache for typical models, and
+// the scores for the block stay in the L1 cache
+constexpr size_t k_cPredictBlockSamples = 256;
+
+// the candidate models that ScoreModelVariantsClassification and ScoreModelVariantsRegression evaluate
+class ModelVariants final {
+public:
+
+   ModelVariants() = default; // preserve our POD status
+   ~ModelVariants() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   size_t m_cVariants;
+   // cVariants * cFeatureGroups items.  A non-zero item includes that feature group in that variant
+   const IntEbmType * m_aVariantFeatureGroups;
+   // one of these is nullptr, depending on whether we're scoring classification or regression models
+   const IntEbmType * m_aTargetsClassification;
+   const FloatEbmType * m_aTargetsRegression;
+   FloatEbmType * m_aMetricsOut;
+};
+static_assert(std::is_standard_layout<ModelVariants>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ModelVariants>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<ModelVariants>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class PredictContext final {
+public:
+
+   PredictContext() = default; // preserve our POD status
+   ~PredictContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   ptrdiff_t m_runtimeLearningTypeOrCountTargetClasses;
+   size_t m_cVectorLength;
+   size_t m_cSamples;
+   size_t m_cFeatures;
+   size_t m_cFeatureGroups;
+   size_t m_cBlocks;
+   size_t m_cTasks;
+   // explaining writes the value of every feature group followed by the intercept for each sample, instead of summing 
+   // the values and applying the link function
+   bool m_bExplain;
+
+   const EbmNativeFeature * m_aFeatures;
+   const IntEbmType * m_aCountBinCuts;
+   const FloatEbmType * m_aBinCutsLowerBoundInclusive;
+   const EbmNativeFeatureGroup * m_aFeatureGroups;
+   const IntEbmType * m_aFeatureGroupIndexes;
+   const FloatEbmType * m_aModelFeatureGroupTensors;
+   const FloatEbmType * m_aIntercept;
+   const FloatEbmType * m_aFeatureValues;
+   // cOutputsPerSample values per sample, which are either the predictions or the explanations
+   FloatEbmType * m_aPredictionsOut;
+   size_t m_cOutputsPerSample;
+
+   // cFeatures items which hold the index of each feature's first cut within m_aBinCutsLowerBoundInclusive
+   const size_t * m_aiBinCutsStart;
+   // cFeatureGroups items which hold the index of each feature group's first value within m_aModelFeatureGroupTensors
+   const size_t * m_aiTensorsStart;
+   // cTasks sets of scratch space, each holding cFeatures * k_cPredictBlockSamples discretized bins followed by
+   // k_cPredictBlockSamples * cVectorLength scores
+   unsigned char * m_aScratch;
+   size_t m_cBytesScratchPerTask;
+
+   // nullptr unless we're scoring model variants, in which case the explanations of each block go into the scratch 
+   // space after the scores, and each block sums the metric of every variant into cVariants items of m_aBlockMetrics
+   const ModelVariants * m_pVariants;
+   FloatEbmType * m_aBlockMetrics;
+};
+static_assert(std::is_standard_layout<PredictContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<PredictContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<PredictContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void PredictBlock(
+   const PredictContext * const pContext, 
+   const size_t iBlock, 
+   unsigned char * const pScratch, 
+   FloatEbmType * const aOutputs
+) {
+   const size_t cVectorLength = pContext->m_cVectorLength;
+   const size_t cSamplesTotal = pContext->m_cSamples;
+   const size_t cFeatures = pContext->m_cFeatures;
+
+   const size_t iSampleStart = iBlock * k_cPredictBlockSamples;
+   EBM_ASSERT(iSampleStart < cSamplesTotal);
+   const size_t cSamplesRemaining = cSamplesTotal - iSampleStart;
+   const size_t cSamples = cSamplesRemaining < k_cPredictBlockSamples ? cSamplesRemaining : k_cPredictBlockSamples;
+
+   IntEbmType * const aBins = reinterpret_cast<IntEbmType *>(pScratch);
+   FloatEbmType * const aScores = reinterpret_cast<FloatEbmType *>(aBins + cFeatures * k_cPredictBlockSamples);
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType ret = DiscretizeInternal(
+         static_cast<IntEbmType>(cSamples),
+         pContext->m_aFeatureValues + iFeature * cSamplesTotal + iSampleStart,
+         pContext->m_aCountBinCuts[iFeature],
+         pContext->m_aBinCutsLowerBoundInclusive + pContext->m_aiBinCutsStart[iFeature],
+         aBins + iFeature * k_cPredictBlockSamples
+      );
+      // we checked all the parameters before launching the tasks, and discretization doesn't need to allocate
+      UNUSED(ret);
+      EBM_ASSERT(IntEbmType { 0 } == ret);
+   }
+
+   const bool bExplain = pContext->m_bExplain;
+   const size_t cFeatureGroups = pContext->m_cFeatureGroups;
+   const size_t cOutputsPerSample = pContext->m_cOutputsPerSample;
+   FloatEbmType * const aExplanations = aOutputs;
+
+   const FloatEbmType * const aIntercept = pContext->m_aIntercept;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // the intercept follows the feature groups in each explanation
+      FloatEbmType * const pScores = bExplain ? aExplanations + iSample * cOutputsPerSample + cFeatureGroups * cVectorLength : 
+         aScores + iSample * cVectorLength;
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         pScores[iVector] = nullptr == aIntercept ? FloatEbmType { 0 } : aIntercept[iVector];
+      }
+   }
+
+   // we add the feature groups in order for every sample, so our results don't depend on the number of threads
+   const EbmNativeFeature * const aFeatures = pContext->m_aFeatures;
+   const IntEbmType * piFeature = pContext->m_aFeatureGroupIndexes;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const size_t cDimensions = static_cast<size_t>(pContext->m_aFeatureGroups[iFeatureGroup].countFeaturesInGroup);
+      const FloatEbmType * const aTensor =
+         pContext->m_aModelFeatureGroupTensors + pContext->m_aiTensorsStart[iFeatureGroup];
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         // the first dimension is the fastest changing one, like in GetBestModelFeatureGroup
+         size_t iTensorBin = 0;
+         size_t cTensorBinsPrev = 1;
+         bool bUnknown = false;
+         for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+            const size_t iFeature = static_cast<size_t>(piFeature[iDimension]);
+            const size_t cBins = static_cast<size_t>(aFeatures[iFeature].countBins);
+            const size_t iBin = static_cast<size_t>(aBins[iFeature * k_cPredictBlockSamples + iSample]);
+            // missing values land in bin cBinCuts + 1, which won't exist if the model has no bin for them.  Like the
+            // python scoring code, we consider samples outside of the tensor to contribute nothing
+            bUnknown = bUnknown || cBins <= iBin;
+            iTensorBin += iBin * cTensorBinsPrev;
+            cTensorBinsPrev *= cBins;
+         }
+         if(bExplain) {
+            // every sample takes the same side of this branch, so it predicts well
+            FloatEbmType * const pExplanation = aExplanations + iSample * cOutputsPerSample + iFeatureGroup * cVectorLength;
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pExplanation[iVector] = bUnknown ? FloatEbmType { 0 } : aTensor[iTensorBin * cVectorLength + iVector];
+            }
+         } else if(!bUnknown) {
+            const FloatEbmType * const pValues = aTensor + iTensorBin * cVectorLength;
+            FloatEbmType * const pScores = aScores + iSample * cVectorLength;
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pScores[iVector] += pValues[iVector];
+            }
+         }
+      }
+      piFeature += cDimensions;
+   }
+
+   if(bExplain) {
+      // explanations are in logits, so there is no link function to apply
+      return;
+   }
+
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses = pContext->m_runtimeLearningTypeOrCountTargetClasses;
+   if(IsRegression(runtimeLearningTypeOrCountTargetClasses)) {
+      // regression uses the identity link
+      FloatEbmType * const pPredictions = aOutputs;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         pPredictions[iSample] = aScores[iSample];
+      }
+   } else {
+      const size_t cClasses = static_cast<size_t>(runtimeLearningTypeOrCountTargetClasses);
+      FloatEbmType * pProbabilities = aOutputs;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const FloatEbmType * const pScores = aScores + iSample * cVectorLength;
+         if(size_t { 1 } == cVectorLength && size_t { 2 } == cClasses) {
+            // the binary logit is the log odds of the second class
+            const FloatEbmType probability = FloatEbmType { 1 } / (FloatEbmType { 1 } + EbmExp(-pScores[0]));
+            pProbabilities[0] = FloatEbmType { 1 } - probability;
+            pProbabilities[1] = probability;
+         } else {
+            EBM_ASSERT(cVectorLength == cClasses);
+            // subtracting the maximum logit doesn't change the softmax, but it keeps our exponentials from overflowing
+            FloatEbmType maxScore = pScores[0];
+            for(size_t iVector = 1; iVector < cVectorLength; ++iVector) {
+               maxScore = maxScore < pScores[iVector] ? pScores[iVector] : maxScore;
+            }
+            FloatEbmType sumExp = FloatEbmType { 0 };
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               const FloatEbmType oneExp = EbmExp(pScores[iVector] - maxScore);
+               pProbabilities[iVector] = oneExp;
+               sumExp += oneExp;
+            }
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               pProbabilities[iVector] /= sumExp;
+            }
+         }
+         pProbabilities += cClasses;
+      }
+   }
+}
+
+static void PredictTask(void * const pContextVoid, const size_t iTask) {
+   const PredictContext * const pContext = static_cast<const PredictContext *>(pContextVoid);
+   unsigned char * const pScratch = pContext->m_aScratch + iTask * pContext->m_cBytesScratchPerTask;
+   for(size_t iBlock = iTask; iBlock < pContext->m_cBlocks; iBlock += pContext->m_cTasks) {
+      PredictBlock(pContext, iBlock, pScratch, 
+         pContext->m_aPredictionsOut + iBlock * k_cPredictBlockSamples * pContext->m_cOutputsPerSample);
+   }
+}
+
+static void ScoreVariantsBlock(
+   const PredictContext * const pContext, 
+   const size_t iBlock, 
+   const FloatEbmType * const aExplanations, 
+   FloatEbmType * const aScores
+) {
+   const ModelVariants * const pVariants = pContext->m_pVariants;
+   const size_t cVectorLength = pContext->m_cVectorLength;
+   const size_t cFeatureGroups = pContext->m_cFeatureGroups;
+   const size_t cOutputsPerSample = pContext->m_cOutputsPerSample;
+   const size_t cVariants = pVariants->m_cVariants;
+
+   const size_t iSampleStart = iBlock * k_cPredictBlockSamples;
+   EBM_ASSERT(iSampleStart < pContext->m_cSamples);
+   const size_t cSamplesRemaining = pContext->m_cSamples - iSampleStart;
+   const size_t cSamples = cSamplesRemaining < k_cPredictBlockSamples ? cSamplesRemaining : k_cPredictBlockSamples;
+
+   const IntEbmType * pVariantFeatureGroups = pVariants->m_aVariantFeatureGroups;
+   FloatEbmType * const aBlockMetrics = pContext->m_aBlockMetrics + iBlock * cVariants;
+   for(size_t iVariant = 0; iVariant < cVariants; ++iVariant) {
+      FloatEbmType sumMetric = FloatEbmType { 0 };
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const FloatEbmType * const pExplanation = aExplanations + iSample * cOutputsPerSample;
+         // like PredictBlock, we start from the intercept and add the feature groups in order, so a variant with every 
+         // feature group scores exactly what PredictBatch predicts
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            aScores[iVector] = pExplanation[cFeatureGroups * cVectorLength + iVector];
+         }
+         for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+            if(IntEbmType { 0 } != pVariantFeatureGroups[iFeatureGroup]) {
+               for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                  aScores[iVector] += pExplanation[iFeatureGroup * cVectorLength + iVector];
+               }
+            }
+         }
+
+         const size_t iSampleTotal = iSampleStart + iSample;
+         FloatEbmType metric;
+         if(nullptr != pVariants->m_aTargetsRegression) {
+            metric = EbmStatistics::ComputeSingleSampleSquaredErrorRegression(aScores[0] - pVariants->m_aTargetsRegression[iSampleTotal]);
+         } else {
+            const size_t iTarget = static_cast<size_t>(pVariants->m_aTargetsClassification[iSampleTotal]);
+            if(size_t { 1 } == cVectorLength) {
+               metric = EbmStatistics::ComputeSingleSampleLogLossBinaryClassification(aScores[0], iTarget);
+            } else {
+               // subtracting the maximum logit doesn't change the log loss, but it keeps our exponentials from overflowing
+               FloatEbmType maxScore = aScores[0];
+               for(size_t iVector = 1; iVector < cVectorLength; ++iVector) {
+                  maxScore = maxScore < aScores[iVector] ? aScores[iVector] : maxScore;
+               }
+               FloatEbmType sumExp = FloatEbmType { 0 };
+               for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+                  sumExp += EbmExp(aScores[iVector] - maxScore);
+               }
+               metric = EbmStatistics::ComputeSingleSampleLogLossMulticlass(sumExp, EbmExp(aScores[iTarget] - maxScore));
+            }
+         }
+         sumMetric += metric;
+      }
+      aBlockMetrics[iVariant] = sumMetric;
+      pVariantFeatureGroups += cFeatureGroups;
+   }
+}
+
+static void ScoreVariantsTask(void * const pContextVoid, const size_t iTask) {
+   const PredictContext * const pContext = static_cast<const PredictContext *>(pContextVoid);
+   unsigned char * const pScratch = pContext->m_aScratch + iTask * pContext->m_cBytesScratchPerTask;
+   // PredictBlock doesn't use its scores when explaining, so we score the variants there and keep the explanations
+   // after them
+   FloatEbmType * const aScores = reinterpret_cast<FloatEbmType *>(
+      pScratch + pContext->m_cFeatures * k_cPredictBlockSamples * sizeof(IntEbmType));
+   FloatEbmType * const aExplanations = aScores + pContext->m_cVectorLength * k_cPredictBlockSamples;
+   for(size_t iBlock = iTask; iBlock < pContext->m_cBlocks; iBlock += pContext->m_cTasks) {
+      PredictBlock(pContext, iBlock, pScratch, aExplanations);
+      ScoreVariantsBlock(pContext, iBlock, aExplanations, aScores);
+   }
+}
+
+static IntEbmType PredictBatchInternal(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType * const countBinCuts,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const predictionsOut,
+   const bool bExplain,
+   const ModelVariants * const pVariants
+) {
+   EBM_ASSERT(nullptr == pVariants || bExplain);
+
+   if(countFeatures < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch countFeatures must be positive");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countFeatures)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch !IsNumberConvertable<size_t>(countFeatures)");
+      return IntEbmType { 1 };
+   }
+   const size_t cFeatures = static_cast<size_t>(countFeatures);
+   if(0 != cFeatures && (nullptr == features || nullptr == countBinCuts)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch features and countBinCuts cannot be nullptr if 0 < countFeatures");
+      return IntEbmType { 1 };
+   }
+
+   if(countFeatureGroups < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch countFeatureGroups must be positive");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countFeatureGroups)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch !IsNumberConvertable<size_t>(countFeatureGroups)");
+      return IntEbmType { 1 };
+   }
+   const size_t cFeatureGroups = static_cast<size_t>(countFeatureGroups);
+   if(0 != cFeatureGroups && (nullptr == featureGroups || nullptr == modelFeatureGroupTensors)) {
+      LOG_0(TraceLevelError,
+         "ERROR PredictBatch featureGroups and modelFeatureGroupTensors cannot be nullptr if 0 < countFeatureGroups");
+      return IntEbmType { 1 };
+   }
+
+   if(countSamples < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch countSamples must be positive");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countSamples)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch !IsNumberConvertable<size_t>(countSamples)");
+      return IntEbmType { 1 };
+   }
+   const size_t cSamples = static_cast<size_t>(countSamples);
+   if(IsMultiplyError(cFeatures, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch IsMultiplyError(cFeatures, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(0 != cFeatures && 0 != cSamples && nullptr == featureValues) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch featureValues cannot be nullptr if there are features and samples");
+      return IntEbmType { 1 };
+   }
+
+   if(nullptr != pVariants) {
+      const size_t cVariants = pVariants->m_cVariants;
+      if(IsMultiplyError(cVariants, cFeatureGroups)) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch IsMultiplyError(cVariants, cFeatureGroups)");
+         return IntEbmType { 1 };
+      }
+      if(0 != cVariants) {
+         if(nullptr == pVariants->m_aMetricsOut) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch metricsOut cannot be nullptr if 0 < countVariants");
+            return IntEbmType { 1 };
+         }
+         if(0 != cFeatureGroups && nullptr == pVariants->m_aVariantFeatureGroups) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch variantFeatureGroups cannot be nullptr if there are variants and feature groups");
+            return IntEbmType { 1 };
+         }
+      }
+      if(0 != cSamples) {
+         if(nullptr == pVariants->m_aTargetsClassification && nullptr == pVariants->m_aTargetsRegression) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch targets cannot be nullptr if 0 < countSamples");
+            return IntEbmType { 1 };
+         }
+         if(nullptr != pVariants->m_aTargetsClassification) {
+            for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+               const IntEbmType target = pVariants->m_aTargetsClassification[iSample];
+               if(target < IntEbmType { 0 } || static_cast<IntEbmType>(runtimeLearningTypeOrCountTargetClasses) <= target) {
+                  LOG_0(TraceLevelError, "ERROR PredictBatch targets must be less than countTargetClasses");
+                  return IntEbmType { 1 };
+               }
+            }
+         }
+      }
+      // a data set without samples and a model without logits both have zero loss, and the early exits below leave 
+      // these in place
+      for(size_t iVariant = 0; iVariant < cVariants; ++iVariant) {
+         pVariants->m_aMetricsOut[iVariant] = FloatEbmType { 0 };
+      }
+      if(0 == cVariants) {
+         return IntEbmType { 0 };
+      }
+   }
+
+   size_t cOutputsPerSample = 1;
+   if(bExplain) {
+      // 1 class classification has no logits, so there is nothing to explain
+      const size_t cVectorLengthExplain = ptrdiff_t { 1 } == runtimeLearningTypeOrCountTargetClasses ? size_t { 0 } : 
+         GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      if(IsAddError(cFeatureGroups, size_t { 1 }) || IsMultiplyError(cFeatureGroups + 1, cVectorLengthExplain)) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch IsMultiplyError(cFeatureGroups + 1, cVectorLength)");
+         return IntEbmType { 1 };
+      }
+      cOutputsPerSample = (cFeatureGroups + 1) * cVectorLengthExplain;
+      if(ptrdiff_t { 0 } == runtimeLearningTypeOrCountTargetClasses && 0 != cSamples) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch countTargetClasses cannot be zero if 0 < countSamples");
+         return IntEbmType { 1 };
+      }
+      if(0 == cOutputsPerSample) {
+         return IntEbmType { 0 };
+      }
+   } else if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
+      if(ptrdiff_t { 0 } == runtimeLearningTypeOrCountTargetClasses) {
+         // there can't be any samples if there are no target classes
+         if(0 != cSamples) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch countTargetClasses cannot be zero if 0 < countSamples");
+            return IntEbmType { 1 };
+         }
+         return IntEbmType { 0 };
+      }
+      cOutputsPerSample = static_cast<size_t>(runtimeLearningTypeOrCountTargetClasses);
+   }
+   if(IsMultiplyError(cOutputsPerSample, cSamples)) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch IsMultiplyError(cOutputsPerSample, cSamples)");
+      return IntEbmType { 1 };
+   }
+   if(0 == cSamples) {
+      return IntEbmType { 0 };
+   }
+   if(nullptr == pVariants && nullptr == predictionsOut) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch the output cannot be nullptr if 0 < countSamples");
+      return IntEbmType { 1 };
+   }
+
+   if(ptrdiff_t { 1 } == runtimeLearningTypeOrCountTargetClasses) {
+      // with only one class we predict it with certainty, and there are no logits in our models
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         predictionsOut[iSample] = FloatEbmType { 1 };
+      }
+      return IntEbmType { 0 };
+   }
+
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+
+   const size_t cBlocks = (cSamples - 1) / k_cPredictBlockSamples + 1;
+   const size_t cThreads = ThreadPool::GetCountThreads();
+   const size_t cTasks = cBlocks < cThreads ? cBlocks : cThreads;
+
+   if(IsMultiplyError(cFeatures, k_cPredictBlockSamples * sizeof(IntEbmType)) ||
+      IsMultiplyError(cVectorLength, k_cPredictBlockSamples * sizeof(FloatEbmType))
+   ) {
+      LOG_0(TraceLevelWarning, "WARNING PredictBatch scratch space would overflow");
+      return IntEbmType { 1 };
+   }
+   const size_t cBytesBins = cFeatures * k_cPredictBlockSamples * sizeof(IntEbmType);
+   const size_t cBytesScores = cVectorLength * k_cPredictBlockSamples * sizeof(FloatEbmType);
+   if(IsAddError(cBytesBins, cBytesScores)) {
+      LOG_0(TraceLevelWarning, "WARNING PredictBatch scratch space would overflow");
+      return IntEbmType { 1 };
+   }
+   size_t cBytesScratchPerTask = cBytesBins + cBytesScores;
+   FloatEbmType * aBlockMetrics = nullptr;
+   if(nullptr != pVariants) {
+      if(IsMultiplyError(cOutputsPerSample, k_cPredictBlockSamples * sizeof(FloatEbmType)) || 
+         IsAddError(cBytesScratchPerTask, cOutputsPerSample * k_cPredictBlockSamples * sizeof(FloatEbmType)) ||
+         IsMultiplyError(cBlocks, pVariants->m_cVariants)
+      ) {
+         LOG_0(TraceLevelWarning, "WARNING PredictBatch scratch space would overflow");
+         return IntEbmType { 1 };
+      }
+      cBytesScratchPerTask += cOutputsPerSample * k_cPredictBlockSamples * sizeof(FloatEbmType);
+      aBlockMetrics = EbmMalloc<FloatEbmType>(cBlocks * pVariants->m_cVariants);
+      if(nullptr == aBlockMetrics) {
+         LOG_0(TraceLevelWarning, "WARNING PredictBatch nullptr == aBlockMetrics");
+         return IntEbmType { 1 };
+      }
+   }
+
+   size_t * const aiBinCutsStart = EbmMalloc<size_t>(cFeatures + cFeatureGroups);
+   if(nullptr == aiBinCutsStart) {
+      LOG_0(TraceLevelWarning, "WARNING PredictBatch nullptr == aiBinCutsStart");
+      free(aBlockMetrics);
+      return IntEbmType { 1 };
+   }
+   size_t * const aiTensorsStart = aiBinCutsStart + cFeatures;
+
+   size_t iBinCutsNext = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      const IntEbmType countBins = features[iFeature].countBins;
+      const IntEbmType countBinCutsFeature = countBinCuts[iFeature];
+      if(countBins < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBins)) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch countBins must be positive and fit into memory");
+         free(aiBinCutsStart);
+         free(aBlockMetrics);
+         return IntEbmType { 1 };
+      }
+      if(countBinCutsFeature < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBinCutsFeature) ||
+         IsAddError(iBinCutsNext, static_cast<size_t>(countBinCutsFeature))
+      ) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch countBinCuts must be positive and fit into memory");
+         free(aiBinCutsStart);
+         free(aBlockMetrics);
+         return IntEbmType { 1 };
+      }
+      aiBinCutsStart[iFeature] = iBinCutsNext;
+      iBinCutsNext += static_cast<size_t>(countBinCutsFeature);
+   }
+   if(0 != iBinCutsNext && nullptr == binCutsLowerBoundInclusive) {
+      LOG_0(TraceLevelError, "ERROR PredictBatch binCutsLowerBoundInclusive cannot be nullptr if there are cuts");
+      free(aiBinCutsStart);
+      free(aBlockMetrics);
+      return IntEbmType { 1 };
+   }
+
+   size_t iTensorNext = 0;
+   size_t iFeatureGroupIndexNext = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const IntEbmType countDimensions = featureGroups[iFeatureGroup].countFeaturesInGroup;
+      if(countDimensions < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countDimensions) ||
+         IsAddError(iFeatureGroupIndexNext, static_cast<size_t>(countDimensions))
+      ) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch countFeaturesInGroup must be positive and fit into memory");
+         free(aiBinCutsStart);
+         free(aBlockMetrics);
+         return IntEbmType { 1 };
+      }
+      const size_t cDimensions = static_cast<size_t>(countDimensions);
+      if(0 != cDimensions && nullptr == featureGroupIndexes) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch featureGroupIndexes cannot be nullptr if there are dimensions");
+         free(aiBinCutsStart);
+         free(aBlockMetrics);
+         return IntEbmType { 1 };
+      }
+      size_t cTensorBins = cVectorLength;
+      for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+         const IntEbmType indexFeature = featureGroupIndexes[iFeatureGroupIndexNext + iDimension];
+         if(indexFeature < IntEbmType { 0 } || countFeatures <= indexFeature) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch featureGroupIndexes must index into features");
+            free(aiBinCutsStart);
+            free(aBlockMetrics);
+            return IntEbmType { 1 };
+         }
+         const size_t cBins = static_cast<size_t>(features[static_cast<size_t>(indexFeature)].countBins);
+         if(IsMultiplyError(cTensorBins, cBins)) {
+            LOG_0(TraceLevelError, "ERROR PredictBatch IsMultiplyError(cTensorBins, cBins)");
+            free(aiBinCutsStart);
+            free(aBlockMetrics);
+            return IntEbmType { 1 };
+         }
+         cTensorBins *= cBins;
+      }
+      if(IsAddError(iTensorNext, cTensorBins)) {
+         LOG_0(TraceLevelError, "ERROR PredictBatch IsAddError(iTensorNext, cTensorBins)");
+         free(aiBinCutsStart);
+         free(aBlockMetrics);
+         return IntEbmType { 1 };
+      }
+      aiTensorsStart[iFeatureGroup] = iTensorNext;
+      iTensorNext += cTensorBins;
+      iFeatureGroupIndexNext += cDimensions;
+   }
+
+   unsigned char * const aScratch = EbmMalloc<unsigned char>(cTasks, cBytesScratchPerTask);
+   if(nullptr == aScratch) {
+      LOG_0(TraceLevelWarning, "WARNING PredictBatch nullptr == aScratch");
+      free(aiBinCutsStart);
+      free(aBlockMetrics);
+      return IntEbmType { 1 };
+   }
+
+   PredictContext context;
+   context.m_runtimeLearningTypeOrCountTargetClasses = runtimeLearningTypeOrCountTargetClasses;
+   context.m_cVectorLength = cVectorLength;
+   context.m_cSamples = cSamples;
+   context.m_cFeatures = cFeatures;
+   context.m_cFeatureGroups = cFeatureGroups;
+   context.m_cBlocks = cBlocks;
+   context.m_cTasks = cTasks;
+   context.m_bExplain = bExplain;
+   context.m_aFeatures = features;
+   context.m_aCountBinCuts = countBinCuts;
+   context.m_aBinCutsLowerBoundInclusive = binCutsLowerBoundInclusive;
+   context.m_aFeatureGroups = featureGroups;
+   context.m_aFeatureGroupIndexes = featureGroupIndexes;
+   context.m_aModelFeatureGroupTensors = modelFeatureGroupTensors;
+   context.m_aIntercept = intercept;
+   context.m_aFeatureValues = featureValues;
+   context.m_aPredictionsOut = predictionsOut;
+   context.m_cOutputsPerSample = cOutputsPerSample;
+   context.m_aiBinCutsStart = aiBinCutsStart;
+   context.m_aiTensorsStart = aiTensorsStart;
+   context.m_aScratch = aScratch;
+   context.m_cBytesScratchPerTask = cBytesScratchPerTask;
+   context.m_pVariants = pVariants;
+   context.m_aBlockMetrics = aBlockMetrics;
+
+   if(nullptr == pVariants) {
+      ThreadPool::ParallelFor(cTasks, PredictTask, &context);
+   } else {
+      ThreadPool::ParallelFor(cTasks, ScoreVariantsTask, &context);
+
+      // we sum the blocks in order, so the metrics don't depend on the number of threads
+      const size_t cVariants = pVariants->m_cVariants;
+      const FloatEbmType countSamplesFloat = static_cast<FloatEbmType>(cSamples);
+      for(size_t iVariant = 0; iVariant < cVariants; ++iVariant) {
+         FloatEbmType sumMetric = FloatEbmType { 0 };
+         for(size_t iBlock = 0; iBlock < cBlocks; ++iBlock) {
+            sumMetric += aBlockMetrics[iBlock * cVariants + iVariant];
+         }
+         pVariants->m_aMetricsOut[iVariant] = sumMetric / countSamplesFloat;
+      }
+   }
+
+   free(aBlockMetrics);
+   free(aScratch);
+   free(aiBinCutsStart);
+   return IntEbmType { 0 };
+}
+
+// ModelFile.cpp also calls this to score the arrays that it maps from a model file
+IntEbmType PredictBatch(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const IntEbmType countFeatures,
+   const EbmNativeFeature * const features,
+   const IntEbmType * const countBinCuts,
+   const FloatEbmType * const binCutsLowerBoundInclusive,
+   const IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * const featureGroups,
+   const IntEbmType * const featureGroupIndexes,
+   const FloatEbmType * const modelFeatureGroupTensors,
+   const FloatEbmType * const intercept,
+   const IntEbmType countSamples,
+   const FloatEbmType * const featureValues,
+   FloatEbmType * const predictionsOut,
+   const bool bExplain
+) {
+   return PredictBatchInternal(
+      runtimeLearningTypeOrCountTargetClasses,
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      predictionsOut,
+      bExplain,
+      nullptr
+   );
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictBatchClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * probabilitiesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered PredictBatchClassification: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "probabilitiesOut=%p"
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(probabilitiesOut)
+   );
+
+   if(countTargetClasses < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR PredictBatchClassification countTargetClasses can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING PredictBatchClassification !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = PredictBatch(
+      static_cast<ptrdiff_t>(countTargetClasses),
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      probabilitiesOut,
+      false
+   );
+
+   LOG_N(TraceLevelInfo, "Exited PredictBatchClassification %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictBatchRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * predictionsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered PredictBatchRegression: "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "predictionsOut=%p"
+      ,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(predictionsOut)
+   );
+
+   const IntEbmType ret = PredictBatch(
+      k_regression,
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      predictionsOut,
+      false
+   );
+
+   LOG_N(TraceLevelInfo, "Exited PredictBatchRegression %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainBatchClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * explanationsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ExplainBatchClassification: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "explanationsOut=%p"
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(explanationsOut)
+   );
+
+   if(countTargetClasses < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ExplainBatchClassification countTargetClasses can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING ExplainBatchClassification !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return IntEbmType { 1 };
+   }
+   const IntEbmType ret = PredictBatch(
+      static_cast<ptrdiff_t>(countTargetClasses),
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      explanationsOut,
+      true
+   );
+
+   LOG_N(TraceLevelInfo, "Exited ExplainBatchClassification %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainBatchRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * explanationsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ExplainBatchRegression: "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "explanationsOut=%p"
+      ,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<void *>(explanationsOut)
+   );
+
+   const IntEbmType ret = PredictBatch(
+      k_regression,
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      explanationsOut,
+      true
+   );
+
+   LOG_N(TraceLevelInfo, "Exited ExplainBatchRegression %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ScoreModelVariantsClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const IntEbmType * targets,
+   IntEbmType countVariants,
+   const IntEbmType * variantFeatureGroups,
+   FloatEbmType * metricsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ScoreModelVariantsClassification: "
+      "countTargetClasses=%" IntEbmTypePrintf ", "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "targets=%p, "
+      "countVariants=%" IntEbmTypePrintf ", "
+      "variantFeatureGroups=%p, "
+      "metricsOut=%p"
+      ,
+      countTargetClasses,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<const void *>(targets),
+      countVariants,
+      static_cast<const void *>(variantFeatureGroups),
+      static_cast<void *>(metricsOut)
+   );
+
+   if(countTargetClasses < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ScoreModelVariantsClassification countTargetClasses can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<ptrdiff_t>(countTargetClasses)) {
+      LOG_0(TraceLevelWarning, "WARNING ScoreModelVariantsClassification !IsNumberConvertable<ptrdiff_t>(countTargetClasses)");
+      return IntEbmType { 1 };
+   }
+   if(countVariants < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ScoreModelVariantsClassification countVariants can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countVariants)) {
+      LOG_0(TraceLevelWarning, "WARNING ScoreModelVariantsClassification !IsNumberConvertable<size_t>(countVariants)");
+      return IntEbmType { 1 };
+   }
+
+   ModelVariants variants;
+   variants.m_cVariants = static_cast<size_t>(countVariants);
+   variants.m_aVariantFeatureGroups = variantFeatureGroups;
+   variants.m_aTargetsClassification = targets;
+   variants.m_aTargetsRegression = nullptr;
+   variants.m_aMetricsOut = metricsOut;
+
+   const IntEbmType ret = PredictBatchInternal(
+      static_cast<ptrdiff_t>(countTargetClasses),
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      nullptr,
+      true,
+      &variants
+   );
+
+   LOG_N(TraceLevelInfo, "Exited ScoreModelVariantsClassification %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ScoreModelVariantsRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const FloatEbmType * targets,
+   IntEbmType countVariants,
+   const IntEbmType * variantFeatureGroups,
+   FloatEbmType * metricsOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered ScoreModelVariantsRegression: "
+      "countFeatures=%" IntEbmTypePrintf ", "
+      "features=%p, "
+      "countBinCuts=%p, "
+      "binCutsLowerBoundInclusive=%p, "
+      "countFeatureGroups=%" IntEbmTypePrintf ", "
+      "featureGroups=%p, "
+      "featureGroupIndexes=%p, "
+      "modelFeatureGroupTensors=%p, "
+      "intercept=%p, "
+      "countSamples=%" IntEbmTypePrintf ", "
+      "featureValues=%p, "
+      "targets=%p, "
+      "countVariants=%" IntEbmTypePrintf ", "
+      "variantFeatureGroups=%p, "
+      "metricsOut=%p"
+      ,
+      countFeatures,
+      static_cast<const void *>(features),
+      static_cast<const void *>(countBinCuts),
+      static_cast<const void *>(binCutsLowerBoundInclusive),
+      countFeatureGroups,
+      static_cast<const void *>(featureGroups),
+      static_cast<const void *>(featureGroupIndexes),
+      static_cast<const void *>(modelFeatureGroupTensors),
+      static_cast<const void *>(intercept),
+      countSamples,
+      static_cast<const void *>(featureValues),
+      static_cast<const void *>(targets),
+      countVariants,
+      static_cast<const void *>(variantFeatureGroups),
+      static_cast<void *>(metricsOut)
+   );
+
+   if(countVariants < IntEbmType { 0 }) {
+      LOG_0(TraceLevelError, "ERROR ScoreModelVariantsRegression countVariants can't be negative");
+      return IntEbmType { 1 };
+   }
+   if(!IsNumberConvertable<size_t>(countVariants)) {
+      LOG_0(TraceLevelWarning, "WARNING ScoreModelVariantsRegression !IsNumberConvertable<size_t>(countVariants)");
+      return IntEbmType { 1 };
+   }
+
+   ModelVariants variants;
+   variants.m_cVariants = static_cast<size_t>(countVariants);
+   variants.m_aVariantFeatureGroups = variantFeatureGroups;
+   variants.m_aTargetsClassification = nullptr;
+   variants.m_aTargetsRegression = targets;
+   variants.m_aMetricsOut = metricsOut;
+
+   const IntEbmType ret = PredictBatchInternal(
+      k_regression,
+      countFeatures,
+      features,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      countFeatureGroups,
+      featureGroups,
+      featureGroupIndexes,
+      modelFeatureGroupTensors,
+      intercept,
+      countSamples,
+      featureValues,
+      nullptr,
+      true,
+      &variants
+   );
+
+   LOG_N(TraceLevelInfo, "Exited ScoreModelVariantsRegression %" IntEbmTypePrintf, ret);
+   return ret;
+}
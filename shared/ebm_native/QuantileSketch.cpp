@@ -0,0 +1,789 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // std::numeric_limits
+#include <algorithm> // std::sort
+#include <cmath> // std::isnan, std::ceil
+#include <string.h> // memcpy
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "RandomStream.h"
+#include "QuantileSketch.h"
+
+extern IntEbmType GenerateQuantileBinCutsInternal(
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut,
+   FloatEbmType * aFeatureValuesScratch
+);
+
+// once the sketch has compacted, we expand it into this many evenly spaced pseudo samples per item that it holds
+// before handing them to the quantile cutter.  The rank error that the expansion adds is then well below the rank
+// error of the sketch itself
+constexpr size_t k_cPseudoSamplesPerSketchItem = 4;
+
+struct WeightedSketchItem final {
+   WeightedSketchItem() = default; // preserve our POD status
+   ~WeightedSketchItem() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   FloatEbmType m_value;
+   size_t m_weight;
+};
+static_assert(std::is_standard_layout<WeightedSketchItem>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<WeightedSketchItem>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<WeightedSketchItem>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class CompareWeightedSketchItem final {
+public:
+   INLINE_ALWAYS bool operator() (const WeightedSketchItem & lhs, const WeightedSketchItem & rhs) const noexcept {
+      return lhs.m_value < rhs.m_value;
+   }
+};
+
+void QuantileSketch::InitializeZero() {
+   m_cItemsPerLevel = 0;
+   m_cLevels = 0;
+   m_cSamples = 0;
+   m_cMissingValues = 0;
+   m_cNegativeInfinity = 0;
+   m_cPositiveInfinity = 0;
+   m_minNonInfinityValue = std::numeric_limits<FloatEbmType>::max();
+   m_maxNonInfinityValue = std::numeric_limits<FloatEbmType>::lowest();
+   for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevelsMax; ++iLevel) {
+      m_acItems[iLevel] = 0;
+      m_aaItems[iLevel] = nullptr;
+   }
+}
+
+QuantileSketch * QuantileSketch::Create(const size_t cItemsPerLevel, const IntEbmType randomSeed) {
+   // we need at least 2 items to promote one of them, and an even count so that compacting a full level never
+   // leaves an item behind
+   const size_t cItemsPerLevelEven = cItemsPerLevel < size_t { 2 } ? size_t { 2 } :
+      cItemsPerLevel + (cItemsPerLevel & size_t { 1 });
+   if(UNLIKELY(cItemsPerLevelEven < cItemsPerLevel ||
+      IsMultiplyError(cItemsPerLevelEven, size_t { 4 } * sizeof(FloatEbmType)))
+   ) {
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::Create cItemsPerLevel is too large");
+      return nullptr;
+   }
+
+   QuantileSketch * const pQuantileSketch = EbmMalloc<QuantileSketch>();
+   if(UNLIKELY(nullptr == pQuantileSketch)) {
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::Create nullptr == pQuantileSketch");
+      return nullptr;
+   }
+   pQuantileSketch->InitializeZero();
+   pQuantileSketch->m_cItemsPerLevel = cItemsPerLevelEven;
+   pQuantileSketch->m_randomStream.Initialize(randomSeed);
+   if(UNLIKELY(pQuantileSketch->EnsureLevel(0))) {
+      Free(pQuantileSketch);
+      return nullptr;
+   }
+   return pQuantileSketch;
+}
+
+void QuantileSketch::Free(QuantileSketch * const pQuantileSketch) {
+   if(nullptr != pQuantileSketch) {
+      for(size_t iLevel = 0; iLevel < k_cQuantileSketchLevelsMax; ++iLevel) {
+         free(pQuantileSketch->m_aaItems[iLevel]);
+      }
+      free(pQuantileSketch);
+   }
+}
+
+bool QuantileSketch::EnsureLevel(const size_t iLevel) {
+   if(UNLIKELY(k_cQuantileSketchLevelsMax <= iLevel)) {
+      // the weight of an item in this level would overflow a size_t, so we can't have more samples than this
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::EnsureLevel k_cQuantileSketchLevelsMax <= iLevel");
+      return true;
+   }
+   if(nullptr == m_aaItems[iLevel]) {
+      FloatEbmType * const aItems = EbmMalloc<FloatEbmType>(GetCapacityPerLevel());
+      if(UNLIKELY(nullptr == aItems)) {
+         LOG_0(TraceLevelWarning, "WARNING QuantileSketch::EnsureLevel nullptr == aItems");
+         return true;
+      }
+      m_aaItems[iLevel] = aItems;
+   }
+   if(m_cLevels <= iLevel) {
+      m_cLevels = iLevel + size_t { 1 };
+   }
+   return false;
+}
+
+bool QuantileSketch::Compact(const size_t iLevel) {
+   if(UNLIKELY(EnsureLevel(iLevel + size_t { 1 }))) {
+      return true;
+   }
+
+   FloatEbmType * const aItems = m_aaItems[iLevel];
+   const size_t cItems = m_acItems[iLevel];
+   std::sort(aItems, aItems + cItems);
+
+   // we compact an even number of items so that the promoted items carry exactly the weight that we remove
+   const size_t cItemsCompacted = cItems & ~size_t { 1 };
+   const size_t cItemsPromoted = cItemsCompacted >> 1;
+   FloatEbmType * const aItemsNext = m_aaItems[iLevel + size_t { 1 }];
+   const size_t cItemsNext = m_acItems[iLevel + size_t { 1 }];
+   EBM_ASSERT(cItemsNext + cItemsPromoted <= GetCapacityPerLevel());
+
+   const size_t iOffset = m_randomStream.Next() ? size_t { 1 } : size_t { 0 };
+   for(size_t iPromoted = 0; iPromoted < cItemsPromoted; ++iPromoted) {
+      aItemsNext[cItemsNext + iPromoted] = aItems[iPromoted * size_t { 2 } + iOffset];
+   }
+   m_acItems[iLevel + size_t { 1 }] = cItemsNext + cItemsPromoted;
+
+   // the largest item stays behind if we had an odd number of them
+   if(cItemsCompacted != cItems) {
+      aItems[0] = aItems[cItems - size_t { 1 }];
+   }
+   m_acItems[iLevel] = cItems - cItemsCompacted;
+   return false;
+}
+
+bool QuantileSketch::Add(const size_t cSamples, const FloatEbmType * const aValues) {
+   EBM_ASSERT(0 == cSamples || nullptr != aValues);
+   EBM_ASSERT(1 <= m_cLevels);
+
+   const size_t cItemsPerLevel = m_cItemsPerLevel;
+   FloatEbmType * const aItems = m_aaItems[0];
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      FloatEbmType val = aValues[iSample];
+      if(UNLIKELY(std::isnan(val))) {
+         ++m_cMissingValues;
+         continue;
+      }
+      if(UNLIKELY(std::numeric_limits<FloatEbmType>::infinity() == val)) {
+         val = std::numeric_limits<FloatEbmType>::max();
+         ++m_cPositiveInfinity;
+      } else if(UNLIKELY(-std::numeric_limits<FloatEbmType>::infinity() == val)) {
+         val = std::numeric_limits<FloatEbmType>::lowest();
+         ++m_cNegativeInfinity;
+      } else {
+         m_maxNonInfinityValue = UNPREDICTABLE(m_maxNonInfinityValue < val) ? val : m_maxNonInfinityValue;
+         m_minNonInfinityValue = UNPREDICTABLE(val < m_minNonInfinityValue) ? val : m_minNonInfinityValue;
+      }
+      ++m_cSamples;
+
+      const size_t cItems = m_acItems[0];
+      EBM_ASSERT(cItems < cItemsPerLevel);
+      aItems[cItems] = val;
+      m_acItems[0] = cItems + size_t { 1 };
+      size_t iLevel = 0;
+      while(UNLIKELY(cItemsPerLevel <= m_acItems[iLevel])) {
+         if(UNLIKELY(Compact(iLevel))) {
+            return true;
+         }
+         ++iLevel;
+      }
+   }
+   return false;
+}
+
+bool QuantileSketch::Merge(const QuantileSketch * const pOther) {
+   EBM_ASSERT(nullptr != pOther);
+   EBM_ASSERT(this != pOther);
+   if(UNLIKELY(m_cItemsPerLevel != pOther->m_cItemsPerLevel)) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Merge the sketches need the same countItemsPerLevel");
+      return true;
+   }
+   if(UNLIKELY(IsAddError(m_cSamples, pOther->m_cSamples) || IsAddError(m_cMissingValues, pOther->m_cMissingValues))) {
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::Merge too many samples");
+      return true;
+   }
+
+   m_cSamples += pOther->m_cSamples;
+   m_cMissingValues += pOther->m_cMissingValues;
+   m_cNegativeInfinity += pOther->m_cNegativeInfinity;
+   m_cPositiveInfinity += pOther->m_cPositiveInfinity;
+   m_minNonInfinityValue = UNPREDICTABLE(pOther->m_minNonInfinityValue < m_minNonInfinityValue) ?
+      pOther->m_minNonInfinityValue : m_minNonInfinityValue;
+   m_maxNonInfinityValue = UNPREDICTABLE(m_maxNonInfinityValue < pOther->m_maxNonInfinityValue) ?
+      pOther->m_maxNonInfinityValue : m_maxNonInfinityValue;
+
+   // we go from the bottom up so that the items promoted from one level are compacted together with the level above
+   for(size_t iLevel = 0; iLevel < m_cLevels || iLevel < pOther->m_cLevels; ++iLevel) {
+      if(iLevel < pOther->m_cLevels) {
+         const size_t cItemsOther = pOther->m_acItems[iLevel];
+         if(size_t { 0 } != cItemsOther) {
+            if(UNLIKELY(EnsureLevel(iLevel))) {
+               return true;
+            }
+            const size_t cItems = m_acItems[iLevel];
+            EBM_ASSERT(cItems + cItemsOther <= GetCapacityPerLevel());
+            memcpy(m_aaItems[iLevel] + cItems, pOther->m_aaItems[iLevel], sizeof(FloatEbmType) * cItemsOther);
+            m_acItems[iLevel] = cItems + cItemsOther;
+         }
+      }
+      if(m_cItemsPerLevel <= m_acItems[iLevel]) {
+         if(UNLIKELY(Compact(iLevel))) {
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+size_t QuantileSketch::GetCountBytesSerialized() const {
+   size_t cItems = 0;
+   for(size_t iLevel = 0; iLevel < m_cLevels; ++iLevel) {
+      cItems += m_acItems[iLevel];
+   }
+   // every level holds fewer than m_cItemsPerLevel items, and we checked in Create that the capacity of all our
+   // levels fits into memory, so none of this can overflow
+   return sizeof(QuantileSketchHeader) + sizeof(uint64_t) * m_cLevels + sizeof(FloatEbmType) * cItems;
+}
+
+void QuantileSketch::Serialize(void * const pBuffer) const {
+   EBM_ASSERT(nullptr != pBuffer);
+
+   // drawing the seed from a copy leaves our own stream untouched, so serializing doesn't change anything that
+   // this sketch generates later
+   RandomStream randomStreamCopy;
+   randomStreamCopy.Initialize(m_randomStream);
+
+   QuantileSketchHeader header;
+   header.m_magic = k_quantileSketchMagic;
+   header.m_version = k_quantileSketchVersion;
+   header.m_cItemsPerLevel = static_cast<uint64_t>(m_cItemsPerLevel);
+   header.m_cLevels = static_cast<uint64_t>(m_cLevels);
+   header.m_cSamples = static_cast<uint64_t>(m_cSamples);
+   header.m_cMissingValues = static_cast<uint64_t>(m_cMissingValues);
+   header.m_cNegativeInfinity = static_cast<uint64_t>(m_cNegativeInfinity);
+   header.m_cPositiveInfinity = static_cast<uint64_t>(m_cPositiveInfinity);
+   header.m_minNonInfinityValue = m_minNonInfinityValue;
+   header.m_maxNonInfinityValue = m_maxNonInfinityValue;
+   header.m_randomSeed = static_cast<uint64_t>(randomStreamCopy.NextEbmInt());
+
+   char * pWrite = static_cast<char *>(pBuffer);
+   memcpy(pWrite, &header, sizeof(header));
+   pWrite += sizeof(header);
+   for(size_t iLevel = 0; iLevel < m_cLevels; ++iLevel) {
+      const uint64_t cItems = static_cast<uint64_t>(m_acItems[iLevel]);
+      memcpy(pWrite, &cItems, sizeof(cItems));
+      pWrite += sizeof(cItems);
+   }
+   for(size_t iLevel = 0; iLevel < m_cLevels; ++iLevel) {
+      const size_t cBytesItems = sizeof(FloatEbmType) * m_acItems[iLevel];
+      if(size_t { 0 } != cBytesItems) {
+         memcpy(pWrite, m_aaItems[iLevel], cBytesItems);
+         pWrite += cBytesItems;
+      }
+   }
+   EBM_ASSERT(static_cast<size_t>(pWrite - static_cast<char *>(pBuffer)) == GetCountBytesSerialized());
+}
+
+QuantileSketch * QuantileSketch::Deserialize(const size_t cBytes, const void * const pBuffer) {
+   EBM_ASSERT(nullptr != pBuffer);
+
+   if(UNLIKELY(cBytes < sizeof(QuantileSketchHeader))) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize buffer is too small");
+      return nullptr;
+   }
+   QuantileSketchHeader header;
+   memcpy(&header, pBuffer, sizeof(header));
+   if(UNLIKELY(k_quantileSketchMagic != header.m_magic || k_quantileSketchVersion != header.m_version)) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize buffer is not a serialized sketch of this version");
+      return nullptr;
+   }
+   if(UNLIKELY(uint64_t { 2 } > header.m_cItemsPerLevel || uint64_t { 0 } != (header.m_cItemsPerLevel & uint64_t { 1 }) ||
+      !IsNumberConvertable<size_t>(header.m_cItemsPerLevel) || uint64_t { 1 } > header.m_cLevels ||
+      uint64_t { k_cQuantileSketchLevelsMax } < header.m_cLevels ||
+      !IsNumberConvertable<size_t>(header.m_cSamples) || !IsNumberConvertable<size_t>(header.m_cMissingValues) ||
+      header.m_cSamples < header.m_cNegativeInfinity || header.m_cSamples - header.m_cNegativeInfinity < header.m_cPositiveInfinity)
+   ) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize header is corrupt");
+      return nullptr;
+   }
+   const size_t cLevels = static_cast<size_t>(header.m_cLevels);
+   const size_t cBytesCounts = sizeof(uint64_t) * cLevels;
+   if(UNLIKELY(cBytes - sizeof(QuantileSketchHeader) < cBytesCounts)) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize buffer is too small");
+      return nullptr;
+   }
+
+   QuantileSketch * const pQuantileSketch = Create(static_cast<size_t>(header.m_cItemsPerLevel), IntEbmType { 0 });
+   if(UNLIKELY(nullptr == pQuantileSketch)) {
+      return nullptr;
+   }
+   pQuantileSketch->m_cSamples = static_cast<size_t>(header.m_cSamples);
+   pQuantileSketch->m_cMissingValues = static_cast<size_t>(header.m_cMissingValues);
+   pQuantileSketch->m_cNegativeInfinity = static_cast<size_t>(header.m_cNegativeInfinity);
+   pQuantileSketch->m_cPositiveInfinity = static_cast<size_t>(header.m_cPositiveInfinity);
+   pQuantileSketch->m_minNonInfinityValue = header.m_minNonInfinityValue;
+   pQuantileSketch->m_maxNonInfinityValue = header.m_maxNonInfinityValue;
+   pQuantileSketch->m_randomStream.Initialize(header.m_randomSeed);
+
+   const char * pRead = static_cast<const char *>(pBuffer) + sizeof(QuantileSketchHeader);
+   const char * pReadItems = pRead + cBytesCounts;
+   size_t cBytesItemsRemaining = cBytes - sizeof(QuantileSketchHeader) - cBytesCounts;
+   size_t cWeight = 0;
+   for(size_t iLevel = 0; iLevel < cLevels; ++iLevel) {
+      uint64_t cItems;
+      memcpy(&cItems, pRead, sizeof(cItems));
+      pRead += sizeof(cItems);
+      // every level holds fewer than m_cItemsPerLevel items between calls, which GetCapacityPerLevel relies on
+      if(UNLIKELY(header.m_cItemsPerLevel <= cItems || cBytesItemsRemaining / sizeof(FloatEbmType) < cItems)) {
+         LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize level is corrupt");
+         Free(pQuantileSketch);
+         return nullptr;
+      }
+      if(UNLIKELY(pQuantileSketch->EnsureLevel(iLevel))) {
+         Free(pQuantileSketch);
+         return nullptr;
+      }
+      const size_t cBytesItems = sizeof(FloatEbmType) * static_cast<size_t>(cItems);
+      if(size_t { 0 } != cBytesItems) {
+         memcpy(pQuantileSketch->m_aaItems[iLevel], pReadItems, cBytesItems);
+         pReadItems += cBytesItems;
+         cBytesItemsRemaining -= cBytesItems;
+      }
+      pQuantileSketch->m_acItems[iLevel] = static_cast<size_t>(cItems);
+      for(size_t iItem = 0; iItem < static_cast<size_t>(cItems); ++iItem) {
+         if(UNLIKELY(std::isnan(pQuantileSketch->m_aaItems[iLevel][iItem]))) {
+            LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize items cannot be missing values");
+            Free(pQuantileSketch);
+            return nullptr;
+         }
+      }
+      const size_t cLevelWeight = static_cast<size_t>(cItems) << iLevel;
+      if(UNLIKELY(size_t { 0 } != cItems && (cLevelWeight >> iLevel != cItems || IsAddError(cWeight, cLevelWeight)))) {
+         LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize level is corrupt");
+         Free(pQuantileSketch);
+         return nullptr;
+      }
+      cWeight += cLevelWeight;
+   }
+   if(UNLIKELY(size_t { 0 } != cBytesItemsRemaining || cWeight != pQuantileSketch->m_cSamples)) {
+      LOG_0(TraceLevelError, "ERROR QuantileSketch::Deserialize the items don't match the number of samples");
+      Free(pQuantileSketch);
+      return nullptr;
+   }
+   return pQuantileSketch;
+}
+
+IntEbmType QuantileSketch::GenerateBinCuts(
+   const IntEbmType countSamplesPerBinMin,
+   const IntEbmType isHumanized,
+   const IntEbmType randomSeed,
+   IntEbmType * const countBinCutsInOut,
+   FloatEbmType * const binCutsLowerBoundInclusiveOut,
+   IntEbmType * const countMissingValuesOut,
+   FloatEbmType * const minNonInfinityValueOut,
+   IntEbmType * const countNegativeInfinityOut,
+   FloatEbmType * const maxNonInfinityValueOut,
+   IntEbmType * const countPositiveInfinityOut
+) const {
+   size_t cItems = 0;
+   for(size_t iLevel = 0; iLevel < m_cLevels; ++iLevel) {
+      cItems += m_acItems[iLevel];
+   }
+
+   // until the first compaction we hold every sample, and we pass them through unchanged
+   const bool bExact = size_t { 1 } == m_cLevels || size_t { 0 } == cItems;
+   const size_t cPseudoSamples = bExact ? m_cSamples : std::min(m_cSamples, cItems * k_cPseudoSamplesPerSketchItem);
+   EBM_ASSERT(!bExact || cItems == m_cSamples);
+
+   // a single missing value is enough for the cutter to reserve a bin for the missing values.  We return the real
+   // count and stats below
+   const size_t cPseudoSamplesIncludingMissing = cPseudoSamples + (size_t { 0 } != m_cMissingValues ? size_t { 1 } : size_t { 0 });
+   if(UNLIKELY(!IsNumberConvertable<IntEbmType>(cPseudoSamplesIncludingMissing))) {
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::GenerateBinCuts too many samples");
+      return IntEbmType { 1 };
+   }
+
+   FloatEbmType * const aPseudoSamples = EbmMalloc<FloatEbmType>(std::max(cPseudoSamplesIncludingMissing, size_t { 1 }));
+   if(UNLIKELY(nullptr == aPseudoSamples)) {
+      LOG_0(TraceLevelWarning, "WARNING QuantileSketch::GenerateBinCuts nullptr == aPseudoSamples");
+      return IntEbmType { 1 };
+   }
+
+   IntEbmType countSamplesPerBinMinPseudo = countSamplesPerBinMin;
+   if(bExact) {
+      if(size_t { 0 } != cItems) {
+         memcpy(aPseudoSamples, m_aaItems[0], sizeof(FloatEbmType) * cItems);
+      }
+   } else {
+      WeightedSketchItem * const aWeightedItems = EbmMalloc<WeightedSketchItem>(cItems);
+      if(UNLIKELY(nullptr == aWeightedItems)) {
+         LOG_0(TraceLevelWarning, "WARNING QuantileSketch::GenerateBinCuts nullptr == aWeightedItems");
+         free(aPseudoSamples);
+         return IntEbmType { 1 };
+      }
+      WeightedSketchItem * pWeightedItem = aWeightedItems;
+      for(size_t iLevel = 0; iLevel < m_cLevels; ++iLevel) {
+         const FloatEbmType * const aItems = m_aaItems[iLevel];
+         for(size_t iItem = 0; iItem < m_acItems[iLevel]; ++iItem) {
+            pWeightedItem->m_value = aItems[iItem];
+            pWeightedItem->m_weight = size_t { 1 } << iLevel;
+            ++pWeightedItem;
+         }
+      }
+      std::sort(aWeightedItems, aWeightedItems + cItems, CompareWeightedSketchItem());
+
+      // pseudo sample iPseudoSample takes the value of the item whose weight covers the rank at the center of the
+      // iPseudoSample-th of cPseudoSamples equal slices of the total weight
+      const FloatEbmType weightPerPseudoSample = static_cast<FloatEbmType>(m_cSamples) / static_cast<FloatEbmType>(cPseudoSamples);
+      size_t iWeightedItem = 0;
+      FloatEbmType weightCovered = static_cast<FloatEbmType>(aWeightedItems[0].m_weight);
+      for(size_t iPseudoSample = 0; iPseudoSample < cPseudoSamples; ++iPseudoSample) {
+         const FloatEbmType rank = (static_cast<FloatEbmType>(iPseudoSample) + FloatEbmType { 0.5 }) * weightPerPseudoSample;
+         while(weightCovered <= rank && iWeightedItem + size_t { 1 } < cItems) {
+            ++iWeightedItem;
+            weightCovered += static_cast<FloatEbmType>(aWeightedItems[iWeightedItem].m_weight);
+         }
+         aPseudoSamples[iPseudoSample] = aWeightedItems[iWeightedItem].m_value;
+      }
+      free(aWeightedItems);
+
+      if(IntEbmType { 0 } < countSamplesPerBinMin) {
+         // each pseudo sample stands for weightPerPseudoSample samples, so a bin needs proportionally fewer of them
+         const FloatEbmType cSamplesPerBinMinPseudo = std::ceil(static_cast<FloatEbmType>(countSamplesPerBinMin) / weightPerPseudoSample);
+         countSamplesPerBinMinPseudo = cSamplesPerBinMinPseudo < FloatEbmType { 1 } ? IntEbmType { 1 } :
+            static_cast<FloatEbmType>(cPseudoSamples) < cSamplesPerBinMinPseudo ? static_cast<IntEbmType>(cPseudoSamples) :
+            static_cast<IntEbmType>(cSamplesPerBinMinPseudo);
+      }
+   }
+   if(size_t { 0 } != m_cMissingValues) {
+      aPseudoSamples[cPseudoSamples] = std::numeric_limits<FloatEbmType>::quiet_NaN();
+   }
+
+   // the pseudo samples are already sorted and cleaned, but going through GenerateQuantileBinCuts keeps every rule of
+   // the cut placement, including the humanized cuts, in one place
+   const IntEbmType ret = GenerateQuantileBinCutsInternal(
+      static_cast<IntEbmType>(cPseudoSamplesIncludingMissing),
+      aPseudoSamples,
+      countSamplesPerBinMinPseudo,
+      isHumanized,
+      randomSeed,
+      countBinCutsInOut,
+      binCutsLowerBoundInclusiveOut,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr
+   );
+   free(aPseudoSamples);
+
+   const bool bAllSpecial = m_cNegativeInfinity + m_cPositiveInfinity == m_cSamples;
+   if(nullptr != countMissingValuesOut) {
+      *countMissingValuesOut = IntEbmType { 0 } == ret ? static_cast<IntEbmType>(m_cMissingValues) : IntEbmType { 0 };
+   }
+   if(nullptr != minNonInfinityValueOut) {
+      *minNonInfinityValueOut = IntEbmType { 0 } == ret && !bAllSpecial ? m_minNonInfinityValue : FloatEbmType { 0 };
+   }
+   if(nullptr != countNegativeInfinityOut) {
+      *countNegativeInfinityOut = IntEbmType { 0 } == ret ? static_cast<IntEbmType>(m_cNegativeInfinity) : IntEbmType { 0 };
+   }
+   if(nullptr != maxNonInfinityValueOut) {
+      *maxNonInfinityValueOut = IntEbmType { 0 } == ret && !bAllSpecial ? m_maxNonInfinityValue : FloatEbmType { 0 };
+   }
+   if(nullptr != countPositiveInfinityOut) {
+      *countPositiveInfinityOut = IntEbmType { 0 } == ret ? static_cast<IntEbmType>(m_cPositiveInfinity) : IntEbmType { 0 };
+   }
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmQuantileSketch EBM_NATIVE_CALLING_CONVENTION CreateQuantileSketch(
+   IntEbmType countItemsPerLevel,
+   IntEbmType randomSeed
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered CreateQuantileSketch: countItemsPerLevel=%" IntEbmTypePrintf ", randomSeed=%" IntEbmTypePrintf,
+      countItemsPerLevel,
+      randomSeed
+   );
+
+   if(UNLIKELY(countItemsPerLevel <= IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR CreateQuantileSketch countItemsPerLevel must be positive");
+      return nullptr;
+   }
+   if(UNLIKELY(!IsNumberConvertable<size_t>(countItemsPerLevel))) {
+      LOG_0(TraceLevelWarning, "WARNING CreateQuantileSketch !IsNumberConvertable<size_t>(countItemsPerLevel)");
+      return nullptr;
+   }
+   const PEbmQuantileSketch quantileSketch = reinterpret_cast<PEbmQuantileSketch>(
+      QuantileSketch::Create(static_cast<size_t>(countItemsPerLevel), randomSeed));
+
+   LOG_N(TraceLevelInfo, "Exited CreateQuantileSketch %p", static_cast<void *>(quantileSketch));
+   return quantileSketch;
+}
+
+static std::atomic<int> g_cLogEnterAddToQuantileSketchParametersMessages { 25 };
+static std::atomic<int> g_cLogExitAddToQuantileSketchParametersMessages { 25 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION AddToQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterAddToQuantileSketchParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered AddToQuantileSketch: quantileSketch=%p, countSamples=%" IntEbmTypePrintf ", featureValues=%p",
+      static_cast<void *>(quantileSketch),
+      countSamples,
+      static_cast<const void *>(featureValues)
+   );
+
+   IntEbmType ret = IntEbmType { 0 };
+   if(UNLIKELY(nullptr == quantileSketch)) {
+      LOG_0(TraceLevelError, "ERROR AddToQuantileSketch quantileSketch cannot be nullptr");
+      ret = IntEbmType { 1 };
+   } else if(UNLIKELY(countSamples < IntEbmType { 0 })) {
+      LOG_0(TraceLevelError, "ERROR AddToQuantileSketch countSamples cannot be negative");
+      ret = IntEbmType { 1 };
+   } else if(IntEbmType { 0 } != countSamples) {
+      if(UNLIKELY(!IsNumberConvertable<size_t>(countSamples))) {
+         LOG_0(TraceLevelWarning, "WARNING AddToQuantileSketch !IsNumberConvertable<size_t>(countSamples)");
+         ret = IntEbmType { 1 };
+      } else if(UNLIKELY(nullptr == featureValues)) {
+         LOG_0(TraceLevelError, "ERROR AddToQuantileSketch featureValues cannot be nullptr");
+         ret = IntEbmType { 1 };
+      } else if(reinterpret_cast<QuantileSketch *>(quantileSketch)->Add(static_cast<size_t>(countSamples), featureValues)) {
+         ret = IntEbmType { 1 };
+      }
+   }
+
+   LOG_COUNTED_N(
+      &g_cLogExitAddToQuantileSketchParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited AddToQuantileSketch: return=%" IntEbmTypePrintf,
+      ret
+   );
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION MergeQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   PEbmQuantileSketch quantileSketchOther
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered MergeQuantileSketch: quantileSketch=%p, quantileSketchOther=%p",
+      static_cast<void *>(quantileSketch),
+      static_cast<void *>(quantileSketchOther)
+   );
+
+   IntEbmType ret = IntEbmType { 0 };
+   if(UNLIKELY(nullptr == quantileSketch || nullptr == quantileSketchOther)) {
+      LOG_0(TraceLevelError, "ERROR MergeQuantileSketch quantileSketch and quantileSketchOther cannot be nullptr");
+      ret = IntEbmType { 1 };
+   } else if(UNLIKELY(quantileSketch == quantileSketchOther)) {
+      LOG_0(TraceLevelError, "ERROR MergeQuantileSketch cannot merge a sketch into itself");
+      ret = IntEbmType { 1 };
+   } else if(reinterpret_cast<QuantileSketch *>(quantileSketch)->Merge(
+      reinterpret_cast<const QuantileSketch *>(quantileSketchOther))
+   ) {
+      ret = IntEbmType { 1 };
+   }
+
+   LOG_N(TraceLevelInfo, "Exited MergeQuantileSketch: return=%" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GetQuantileSketchSerializedSize(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType * countBytesOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered GetQuantileSketchSerializedSize: quantileSketch=%p, countBytesOut=%p",
+      static_cast<void *>(quantileSketch),
+      static_cast<void *>(countBytesOut)
+   );
+
+   if(UNLIKELY(nullptr == countBytesOut)) {
+      LOG_0(TraceLevelError, "ERROR GetQuantileSketchSerializedSize countBytesOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   *countBytesOut = IntEbmType { 0 };
+   if(UNLIKELY(nullptr == quantileSketch)) {
+      LOG_0(TraceLevelError, "ERROR GetQuantileSketchSerializedSize quantileSketch cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   const size_t cBytes = reinterpret_cast<const QuantileSketch *>(quantileSketch)->GetCountBytesSerialized();
+   if(UNLIKELY(!IsNumberConvertable<IntEbmType>(cBytes))) {
+      LOG_0(TraceLevelWarning, "WARNING GetQuantileSketchSerializedSize !IsNumberConvertable<IntEbmType>(cBytes)");
+      return IntEbmType { 1 };
+   }
+   *countBytesOut = static_cast<IntEbmType>(cBytes);
+
+   LOG_N(TraceLevelInfo, "Exited GetQuantileSketchSerializedSize: countBytes=%zu", cBytes);
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION SerializeQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countBytes,
+   void * bufferOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered SerializeQuantileSketch: quantileSketch=%p, countBytes=%" IntEbmTypePrintf ", bufferOut=%p",
+      static_cast<void *>(quantileSketch),
+      countBytes,
+      bufferOut
+   );
+
+   if(UNLIKELY(nullptr == quantileSketch)) {
+      LOG_0(TraceLevelError, "ERROR SerializeQuantileSketch quantileSketch cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   if(UNLIKELY(nullptr == bufferOut)) {
+      LOG_0(TraceLevelError, "ERROR SerializeQuantileSketch bufferOut cannot be nullptr");
+      return IntEbmType { 1 };
+   }
+   const QuantileSketch * const pQuantileSketch = reinterpret_cast<const QuantileSketch *>(quantileSketch);
+   const size_t cBytesNeeded = pQuantileSketch->GetCountBytesSerialized();
+   if(UNLIKELY(countBytes < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBytes) ||
+      static_cast<size_t>(countBytes) < cBytesNeeded)
+   ) {
+      LOG_0(TraceLevelError, "ERROR SerializeQuantileSketch countBytes is smaller than GetQuantileSketchSerializedSize");
+      return IntEbmType { 1 };
+   }
+   pQuantileSketch->Serialize(bufferOut);
+
+   LOG_0(TraceLevelInfo, "Exited SerializeQuantileSketch");
+   return IntEbmType { 0 };
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY PEbmQuantileSketch EBM_NATIVE_CALLING_CONVENTION DeserializeQuantileSketch(
+   IntEbmType countBytes,
+   const void * buffer
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered DeserializeQuantileSketch: countBytes=%" IntEbmTypePrintf ", buffer=%p",
+      countBytes,
+      buffer
+   );
+
+   if(UNLIKELY(nullptr == buffer)) {
+      LOG_0(TraceLevelError, "ERROR DeserializeQuantileSketch buffer cannot be nullptr");
+      return nullptr;
+   }
+   if(UNLIKELY(countBytes < IntEbmType { 0 } || !IsNumberConvertable<size_t>(countBytes))) {
+      LOG_0(TraceLevelError, "ERROR DeserializeQuantileSketch countBytes must be positive and fit into memory");
+      return nullptr;
+   }
+   const PEbmQuantileSketch quantileSketch = reinterpret_cast<PEbmQuantileSketch>(
+      QuantileSketch::Deserialize(static_cast<size_t>(countBytes), buffer));
+
+   LOG_N(TraceLevelInfo, "Exited DeserializeQuantileSketch %p", static_cast<void *>(quantileSketch));
+   return quantileSketch;
+}
+
+static std::atomic<int> g_cLogEnterGenerateQuantileBinCutsFromSketchParametersMessages { 25 };
+static std::atomic<int> g_cLogExitGenerateQuantileBinCutsFromSketchParametersMessages { 25 };
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQuantileBinCutsFromSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+) {
+   LOG_COUNTED_N(
+      &g_cLogEnterGenerateQuantileBinCutsFromSketchParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Entered GenerateQuantileBinCutsFromSketch: "
+      "quantileSketch=%p, "
+      "countSamplesPerBinMin=%" IntEbmTypePrintf ", "
+      "isHumanized=%s, "
+      "randomSeed=%" IntEbmTypePrintf ", "
+      "countBinCutsInOut=%p, "
+      "binCutsLowerBoundInclusiveOut=%p, "
+      "countMissingValuesOut=%p, "
+      "minNonInfinityValueOut=%p, "
+      "countNegativeInfinityOut=%p, "
+      "maxNonInfinityValueOut=%p, "
+      "countPositiveInfinityOut=%p"
+      ,
+      static_cast<void *>(quantileSketch),
+      countSamplesPerBinMin,
+      ObtainTruth(isHumanized),
+      randomSeed,
+      static_cast<void *>(countBinCutsInOut),
+      static_cast<void *>(binCutsLowerBoundInclusiveOut),
+      static_cast<void *>(countMissingValuesOut),
+      static_cast<void *>(minNonInfinityValueOut),
+      static_cast<void *>(countNegativeInfinityOut),
+      static_cast<void *>(maxNonInfinityValueOut),
+      static_cast<void *>(countPositiveInfinityOut)
+   );
+
+   IntEbmType ret;
+   if(UNLIKELY(nullptr == quantileSketch)) {
+      LOG_0(TraceLevelError, "ERROR GenerateQuantileBinCutsFromSketch quantileSketch cannot be nullptr");
+      if(nullptr != countBinCutsInOut) {
+         *countBinCutsInOut = IntEbmType { 0 };
+      }
+      ret = IntEbmType { 1 };
+   } else {
+      ret = reinterpret_cast<const QuantileSketch *>(quantileSketch)->GenerateBinCuts(
+         countSamplesPerBinMin,
+         isHumanized,
+         randomSeed,
+         countBinCutsInOut,
+         binCutsLowerBoundInclusiveOut,
+         countMissingValuesOut,
+         minNonInfinityValueOut,
+         countNegativeInfinityOut,
+         maxNonInfinityValueOut,
+         countPositiveInfinityOut
+      );
+   }
+
+   LOG_COUNTED_N(
+      &g_cLogExitGenerateQuantileBinCutsFromSketchParametersMessages,
+      TraceLevelInfo,
+      TraceLevelVerbose,
+      "Exited GenerateQuantileBinCutsFromSketch: return=%" IntEbmTypePrintf,
+      ret
+   );
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION FreeQuantileSketch(
+   PEbmQuantileSketch quantileSketch
+) {
+   LOG_N(TraceLevelInfo, "Entered FreeQuantileSketch: quantileSketch=%p", static_cast<void *>(quantileSketch));
+
+   // it's legal to call FreeQuantileSketch on nullptr, just like for free().  This is checked inside QuantileSketch::Free()
+   QuantileSketch::Free(reinterpret_cast<QuantileSketch *>(quantileSketch));
+
+   LOG_0(TraceLevelInfo, "Exited FreeQuantileSketch");
+}
@@ -0,0 +1,129 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef QUANTILE_SKETCH_H
+#define QUANTILE_SKETCH_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <inttypes.h> // uint64_t
+
+#include "ebm_native.h" // IntEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "RandomStream.h"
+
+// QuantileSketch is a mergeable quantile summary built from a stack of compactors, in the style of the MRL and KLL
+// sketches.  Level iLevel holds items that each stand for 2^iLevel samples.  When a level reaches
+// m_cItemsPerLevel items we sort it and promote every other item, starting at a random offset, to the next level.
+// Compacting an even number of items preserves the total weight exactly, so the sketch always knows the exact number
+// of samples even though it only keeps O(m_cItemsPerLevel * log(cSamples / m_cItemsPerLevel)) of them.  Until the
+// first compaction the sketch holds every sample, and the cuts it generates are identical to GenerateQuantileBinCuts.
+//
+// Like RemoveMissingValuesAndReplaceInfinities, we count missing values instead of storing them, and we store
+// +-infinity as max/lowest, while keeping exact counts and the exact non-infinity min/max on the side.
+//
+// Serialized layout: QuantileSketchHeader, then m_cLevels uint64_t item counts, then the FloatEbmType items of each
+// level in order.  Everything is in the native byte order, so a buffer from a machine with a different byte order
+// fails the magic number check.
+
+constexpr uint64_t k_quantileSketchMagic = uint64_t { 0x3148434B534D4245 }; // "EBMSKCH1" in little endian
+constexpr uint64_t k_quantileSketchVersion = 1;
+// level iLevel items have a weight of 2^iLevel, so 64 levels can hold any number of samples that fits into a size_t
+constexpr size_t k_cQuantileSketchLevelsMax = 64;
+
+struct QuantileSketchHeader final {
+   QuantileSketchHeader() = default; // preserve our POD status
+   ~QuantileSketchHeader() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_magic;
+   uint64_t m_version;
+   uint64_t m_cItemsPerLevel;
+   uint64_t m_cLevels;
+   uint64_t m_cSamples;
+   uint64_t m_cMissingValues;
+   uint64_t m_cNegativeInfinity;
+   uint64_t m_cPositiveInfinity;
+   FloatEbmType m_minNonInfinityValue;
+   FloatEbmType m_maxNonInfinityValue;
+   // RandomStream isn't meant to be copied across machines, so we store a seed drawn from it instead
+   uint64_t m_randomSeed;
+};
+static_assert(std::is_standard_layout<QuantileSketchHeader>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<QuantileSketchHeader>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<QuantileSketchHeader>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class QuantileSketch final {
+   size_t m_cItemsPerLevel;
+   size_t m_cLevels;
+   // the samples that are not missing, which is also the total weight of all our items
+   size_t m_cSamples;
+   size_t m_cMissingValues;
+   size_t m_cNegativeInfinity;
+   size_t m_cPositiveInfinity;
+   FloatEbmType m_minNonInfinityValue;
+   FloatEbmType m_maxNonInfinityValue;
+   RandomStream m_randomStream;
+
+   size_t m_acItems[k_cQuantileSketchLevelsMax];
+   // the levels are allocated as we reach them, and each holds up to GetCapacityPerLevel() items
+   FloatEbmType * m_aaItems[k_cQuantileSketchLevelsMax];
+
+   INLINE_ALWAYS size_t GetCapacityPerLevel() const {
+      // between public calls each level holds fewer than m_cItemsPerLevel items.  Merging can add another
+      // m_cItemsPerLevel - 1 items and the promoted half of the level below, which stays below 4 * m_cItemsPerLevel
+      return m_cItemsPerLevel * size_t { 4 };
+   }
+
+   void InitializeZero();
+   bool EnsureLevel(const size_t iLevel);
+   bool Compact(const size_t iLevel);
+
+public:
+
+   QuantileSketch() = default; // preserve our POD status
+   ~QuantileSketch() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   // cItemsPerLevel is rounded up to an even number.  Returns nullptr on error
+   static QuantileSketch * Create(const size_t cItemsPerLevel, const IntEbmType randomSeed);
+   static void Free(QuantileSketch * const pQuantileSketch);
+   // returns nullptr if the buffer isn't a serialized sketch
+   static QuantileSketch * Deserialize(const size_t cBytes, const void * const pBuffer);
+
+   // returns true on error, after which the sketch can only be freed
+   bool Add(const size_t cSamples, const FloatEbmType * const aValues);
+   // adds the samples of pOther, which is unchanged.  Both sketches need the same cItemsPerLevel.  Returns true on
+   // error, after which the sketch can only be freed
+   bool Merge(const QuantileSketch * const pOther);
+
+   size_t GetCountBytesSerialized() const;
+   void Serialize(void * const pBuffer) const;
+
+   IntEbmType GenerateBinCuts(
+      const IntEbmType countSamplesPerBinMin,
+      const IntEbmType isHumanized,
+      const IntEbmType randomSeed,
+      IntEbmType * const countBinCutsInOut,
+      FloatEbmType * const binCutsLowerBoundInclusiveOut,
+      IntEbmType * const countMissingValuesOut,
+      FloatEbmType * const minNonInfinityValueOut,
+      IntEbmType * const countNegativeInfinityOut,
+      FloatEbmType * const maxNonInfinityValueOut,
+      IntEbmType * const countPositiveInfinityOut
+   ) const;
+};
+static_assert(std::is_standard_layout<QuantileSketch>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<QuantileSketch>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<QuantileSketch>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // QUANTILE_SKETCH_H
@@ -17,9 +17,8 @@ EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateR
    return ret;
 }
 
-// we don't care if an extra log message is outputted due to the non-atomic nature of the decrement to this value
-static int g_cLogEnterSamplingWithoutReplacementParametersMessages = 5;
-static int g_cLogExitSamplingWithoutReplacementParametersMessages = 5;
+static std::atomic<int> g_cLogEnterSamplingWithoutReplacementParametersMessages { 5 };
+static std::atomic<int> g_cLogExitSamplingWithoutReplacementParametersMessages { 5 };
 
 EBM_NATIVE_IMPORT_EXPORT_BODY void EBM_NATIVE_CALLING_CONVENTION SamplingWithoutReplacement(
    IntEbmType randomSeed,
@@ -4,9 +4,13 @@
 
 #include "PrecompiledHeader.h"
 
+#include <algorithm> // std::min
+#include <limits> // numeric_limits
+
 #include "ebm_native.h" // IntEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "RandomStream.h"
+#include "SimdKernels.h"
 
 // I generated these as purely random numbers from 0 to 2^64-1
 static constexpr uint_fast64_t k_oneTimePadRandomSeed[64] {
@@ -156,3 +160,70 @@ exit_loop:;
    m_state2 = sanitizedSeed;
    m_stateSeedConst = sanitizedSeed;
 }
+
+void FillRandomLanes(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+   // this is Rand32 for each lane, written so that each lane is independent of the others
+   uint32_t * pOut = aOut;
+   for(size_t iRound = 0; iRound < cRounds; ++iRound) {
+      for(size_t iLane = 0; iLane < k_cRandomLanes; ++iLane) {
+         uint64_t state1 = pLanes->m_aState1[iLane];
+         const uint64_t state2 = pLanes->m_aState2[iLane] + pLanes->m_aStateSeedConst[iLane];
+         state1 = state1 * state1 + state2;
+         state1 = (state1 >> 32) | (state1 << 32);
+         pLanes->m_aState1[iLane] = state1;
+         pLanes->m_aState2[iLane] = state2;
+         *pOut = static_cast<uint32_t>(state1);
+         ++pOut;
+      }
+   }
+}
+
+// the lanes hold this many rounds on the stack between mapping passes
+constexpr size_t k_cFillRandomRoundsPerChunk = 64;
+
+void RandomStream::FillRandom(
+   const SimdKernels * const pSimdKernels,
+   const size_t maxValueExclusive,
+   const size_t cItems,
+   uint32_t * const aOut
+) {
+   EBM_ASSERT(size_t { 1 } <= maxValueExclusive);
+   EBM_ASSERT(maxValueExclusive - size_t { 1 } <= size_t { std::numeric_limits<uint32_t>::max() });
+
+   RandomLanes lanes;
+   for(size_t iLane = 0; iLane < k_cRandomLanes; ++iLane) {
+      // each lane is a full Middle Square Weyl stream with it's own seed constant, seeded from this stream
+      RandomStream lane;
+      lane.Initialize(static_cast<uint64_t>(Rand64()));
+      lanes.m_aState1[iLane] = static_cast<uint64_t>(lane.m_state1);
+      lanes.m_aState2[iLane] = static_cast<uint64_t>(lane.m_state2);
+      lanes.m_aStateSeedConst[iLane] = static_cast<uint64_t>(lane.m_stateSeedConst);
+   }
+
+   // we map the 32 bit numbers onto [0, maxValueExclusive) by multiplying and keeping the high bits (Lemire's method).
+   // The results are unbiased once we reject the low products below 2^32 % maxValueExclusive, which is rare enough 
+   // that we replace them with draws from this scalar stream instead of breaking up the lanes
+   const uint64_t maxValue = static_cast<uint64_t>(maxValueExclusive);
+   const uint32_t threshold = static_cast<uint32_t>((uint64_t { 1 } << 32) % maxValue);
+
+   uint32_t aRaw[k_cFillRandomRoundsPerChunk * k_cRandomLanes];
+   size_t iItem = 0;
+   while(iItem != cItems) {
+      const size_t cItemsChunk = std::min(cItems - iItem, k_cFillRandomRoundsPerChunk * k_cRandomLanes);
+      const size_t cRounds = (cItemsChunk + k_cRandomLanes - 1) / k_cRandomLanes;
+      if(nullptr == pSimdKernels) {
+         FillRandomLanes(cRounds, &lanes, aRaw);
+      } else {
+         (*pSimdKernels->m_pFillRandom)(cRounds, &lanes, aRaw);
+      }
+      for(size_t i = 0; i < cItemsChunk; ++i) {
+         const uint64_t product = static_cast<uint64_t>(aRaw[i]) * maxValue;
+         uint32_t result = static_cast<uint32_t>(product >> 32);
+         if(UNLIKELY(static_cast<uint32_t>(product) < threshold)) {
+            result = static_cast<uint32_t>(Next(maxValueExclusive));
+         }
+         aOut[iItem + i] = result;
+      }
+      iItem += cItemsChunk;
+   }
+}
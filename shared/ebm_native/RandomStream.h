@@ -7,11 +7,42 @@
 
 #include <inttypes.h> // uint32_t, uint_fast64_t
 #include <stddef.h> // size_t, ptrdiff_t
+#include <type_traits> // is_standard_layout
 
 #include "ebm_native.h" // IntEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h"
 
+class SimdKernels;
+
+// FillRandom runs k_cRandomLanes independent Middle Square Weyl streams side by side, which lets the multiplications
+// of the different streams happen in parallel in SIMD registers.  Item i of a fill comes from lane i % k_cRandomLanes,
+// so the numbers are identical no matter which instruction set, if any, generates them
+constexpr size_t k_cRandomLanes = 8;
+
+struct RandomLanes final {
+   RandomLanes() = default; // preserve our POD status
+   ~RandomLanes() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   uint64_t m_aState1[k_cRandomLanes];
+   uint64_t m_aState2[k_cRandomLanes];
+   uint64_t m_aStateSeedConst[k_cRandomLanes];
+};
+static_assert(std::is_standard_layout<RandomLanes>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<RandomLanes>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<RandomLanes>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+// the scalar version of the SIMD_FILL_RANDOM_FUNCTION kernels.  Writes cRounds * k_cRandomLanes raw 32 bit numbers
+extern void FillRandomLanes(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut);
+
+// the number of 64 bit words in RandomStream::GetState and RandomStream::SetState
+constexpr size_t k_cRandomStreamStateItems = 3;
+
 class RandomStream final {
    // If the RandomStream object is stored inside a class/struct, and used inside a hotspot loop, to get the best 
    // performance copy this structure to the stack before using it, and then copy it back to the struct/class 
@@ -42,7 +73,8 @@ class RandomStream final {
    // 64 bit numbers, according to the paper.
 
    // If we had memcopied RandomStream cross machine we would want these to be uint64_t instead of uint_fast64_t
-   // but we only copy seeds cross machine, so we can leave them as uint_fast64_t
+   // but we only copy seeds cross machine, and checkpoints go through GetState and SetState, so we can leave them 
+   // as uint_fast64_t
 
    uint_fast64_t m_state1;
    uint_fast64_t m_state2;
@@ -93,6 +125,30 @@ public:
       m_stateSeedConst = other.m_stateSeedConst;
    }
 
+   // our state as k_cRandomStreamStateItems 64 bit words, so that a boosting checkpoint can resume the stream exactly 
+   // where it left off.  uint_fast64_t is 64 bits on every platform that we build for, so the conversions are exact
+   INLINE_ALWAYS void GetState(uint64_t * const aStateOut) const {
+      aStateOut[0] = static_cast<uint64_t>(m_state1);
+      aStateOut[1] = static_cast<uint64_t>(m_state2);
+      aStateOut[2] = static_cast<uint64_t>(m_stateSeedConst);
+   }
+
+   INLINE_ALWAYS void SetState(const uint64_t * const aState) {
+      m_state1 = static_cast<uint_fast64_t>(aState[0]);
+      m_state2 = static_cast<uint_fast64_t>(aState[1]);
+      m_stateSeedConst = static_cast<uint_fast64_t>(aState[2]);
+   }
+
+   // fills aOut with cItems random numbers in [0, maxValueExclusive), which needs to fit into 32 bits.  The lanes are 
+   // seeded from this stream, so the result only depends on the state of this stream.  pSimdKernels can be nullptr, 
+   // and the result is the same either way
+   void FillRandom(
+      const SimdKernels * const pSimdKernels,
+      const size_t maxValueExclusive,
+      const size_t cItems,
+      uint32_t * const aOut
+   );
+
    INLINE_ALWAYS IntEbmType NextEbmInt() {
       static_assert(std::numeric_limits<IntEbmType>::lowest() < IntEbmType { 0 },
          "IntEbmType must be signed");
@@ -0,0 +1,213 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stdlib.h> // malloc, free
+#include <stddef.h> // size_t, ptrdiff_t
+#include <stdint.h> // uint64_t
+#include <string.h> // memcpy, memcmp
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "SampleDeduplication.h"
+
+INLINE_ALWAYS static size_t HashCombine(const size_t hash, const size_t value) {
+   // the boost hash_combine mix, which spreads each value over all the bits of the hash
+   return hash ^ (value + size_t { 0x9e3779b9 } + (hash << 6) + (hash >> 2));
+}
+
+INLINE_ALWAYS static size_t HashBits(size_t hash, const char * pBytes, const size_t cBytes) {
+   // targets and predictor scores are 8 byte items.  We hash and compare their bits, so -0.0 and 0.0 are different
+   // samples, which is harmless, and NaN values match if they have the same bits
+   EBM_ASSERT(0 == cBytes % sizeof(uint64_t));
+   const char * const pBytesEnd = pBytes + cBytes;
+   while(pBytesEnd != pBytes) {
+      uint64_t bits;
+      memcpy(&bits, pBytes, sizeof(bits));
+      hash = HashCombine(hash, static_cast<size_t>(bits));
+      hash = HashCombine(hash, static_cast<size_t>(bits >> 32));
+      pBytes += sizeof(bits);
+   }
+   return hash;
+}
+
+void DeduplicatedSamples::Destruct() {
+   free(m_aBinnedData);
+   free(m_aTargets);
+   free(m_aPredictorScores);
+   free(m_aWeights);
+}
+
+bool DeduplicatedSamples::Initialize(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const size_t cFeatures,
+   const size_t cSamples,
+   const IntEbmType * const aBinnedData,
+   const void * const aTargets,
+   const FloatEbmType * const aPredictorScores,
+   const IntEbmType * const aWeights
+) {
+   LOG_0(TraceLevelInfo, "Entered DeduplicatedSamples::Initialize");
+
+   EBM_ASSERT(nullptr == m_aBinnedData);
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(0 == cFeatures || nullptr != aBinnedData);
+   EBM_ASSERT(nullptr != aTargets);
+   EBM_ASSERT(nullptr != aPredictorScores);
+
+   static_assert(sizeof(IntEbmType) == sizeof(uint64_t), "we hash the targets as 8 byte items");
+   static_assert(sizeof(FloatEbmType) == sizeof(uint64_t), "we hash the targets and scores as 8 byte items");
+   const size_t cBytesPerTarget = IsClassification(runtimeLearningTypeOrCountTargetClasses) ?
+      sizeof(IntEbmType) : sizeof(FloatEbmType);
+   const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+   // AllocateBoosting checked that the predictor scores fit into memory
+   EBM_ASSERT(!IsMultiplyError(cVectorLength, cSamples));
+   const size_t cBytesPerPredictorScores = sizeof(FloatEbmType) * cVectorLength;
+
+   const char * const aTargetBytes = static_cast<const char *>(aTargets);
+   const char * const aPredictorScoreBytes = reinterpret_cast<const char *>(aPredictorScores);
+
+   // open addressing with at least twice as many buckets as samples keeps our probe sequences short.  Each bucket
+   // holds 1 + the index of a unique sample, or zero if it's empty
+   size_t cBuckets = 1;
+   while(cBuckets < cSamples) {
+      cBuckets <<= 1;
+   }
+   if(IsMultiplyError(cBuckets, size_t { 2 })) {
+      LOG_0(TraceLevelWarning, "WARNING DeduplicatedSamples::Initialize IsMultiplyError(cBuckets, size_t { 2 })");
+      return true;
+   }
+   cBuckets <<= 1;
+   const size_t maskBuckets = cBuckets - 1;
+
+   size_t * const aBuckets = EbmMalloc<size_t>(cBuckets);
+   // the original sample that each unique sample was first seen as, along with its hash and total weight
+   size_t * const aiFirstSamples = EbmMalloc<size_t>(cSamples);
+   size_t * const aHashes = EbmMalloc<size_t>(cSamples);
+   size_t * const aUniqueWeights = EbmMalloc<size_t>(cSamples);
+   if(nullptr == aBuckets || nullptr == aiFirstSamples || nullptr == aHashes || nullptr == aUniqueWeights) {
+      LOG_0(TraceLevelWarning, "WARNING DeduplicatedSamples::Initialize out of memory");
+      free(aBuckets);
+      free(aiFirstSamples);
+      free(aHashes);
+      free(aUniqueWeights);
+      return true;
+   }
+   for(size_t iBucket = 0; iBucket < cBuckets; ++iBucket) {
+      aBuckets[iBucket] = 0;
+   }
+
+   size_t cUniqueSamples = 0;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      size_t hash = 0;
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         hash = HashCombine(hash, static_cast<size_t>(aBinnedData[iFeature * cSamples + iSample]));
+      }
+      const char * const pTarget = aTargetBytes + cBytesPerTarget * iSample;
+      const char * const pPredictorScores = aPredictorScoreBytes + cBytesPerPredictorScores * iSample;
+      hash = HashBits(hash, pTarget, cBytesPerTarget);
+      hash = HashBits(hash, pPredictorScores, cBytesPerPredictorScores);
+
+      // AllocateBoosting checked that the weights are non-negative
+      EBM_ASSERT(nullptr == aWeights || 0 <= aWeights[iSample]);
+      const size_t cWeight = nullptr == aWeights ? size_t { 1 } : static_cast<size_t>(aWeights[iSample]);
+
+      size_t iBucket = hash & maskBuckets;
+      while(true) {
+         const size_t iUniquePlusOne = aBuckets[iBucket];
+         if(0 == iUniquePlusOne) {
+            aBuckets[iBucket] = cUniqueSamples + 1;
+            aiFirstSamples[cUniqueSamples] = iSample;
+            aHashes[cUniqueSamples] = hash;
+            aUniqueWeights[cUniqueSamples] = cWeight;
+            ++cUniqueSamples;
+            break;
+         }
+         const size_t iUnique = iUniquePlusOne - 1;
+         if(hash == aHashes[iUnique]) {
+            const size_t iFirstSample = aiFirstSamples[iUnique];
+            bool bSame = 0 == memcmp(pTarget, aTargetBytes + cBytesPerTarget * iFirstSample, cBytesPerTarget) &&
+               0 == memcmp(pPredictorScores, aPredictorScoreBytes + cBytesPerPredictorScores * iFirstSample,
+                  cBytesPerPredictorScores);
+            for(size_t iFeature = 0; bSame && iFeature < cFeatures; ++iFeature) {
+               bSame = aBinnedData[iFeature * cSamples + iSample] == aBinnedData[iFeature * cSamples + iFirstSample];
+            }
+            if(bSame) {
+               if(IsAddError(aUniqueWeights[iUnique], cWeight)) {
+                  LOG_0(TraceLevelError, "ERROR DeduplicatedSamples::Initialize the sum of the weights is too large");
+                  free(aBuckets);
+                  free(aiFirstSamples);
+                  free(aHashes);
+                  free(aUniqueWeights);
+                  return true;
+               }
+               aUniqueWeights[iUnique] += cWeight;
+               break;
+            }
+         }
+         iBucket = (iBucket + 1) & maskBuckets;
+      }
+   }
+   free(aBuckets);
+   free(aHashes);
+   EBM_ASSERT(0 < cUniqueSamples);
+   EBM_ASSERT(cUniqueSamples <= cSamples);
+
+   LOG_N(TraceLevelInfo, "INFO DeduplicatedSamples::Initialize %zu samples collapsed into %zu unique samples",
+      cSamples, cUniqueSamples);
+
+   // cFeatures * cSamples can't overflow since our caller holds that much binned data, so this can't either
+   IntEbmType * const aBinnedDataTo = 0 == cFeatures ? nullptr : EbmMalloc<IntEbmType>(cFeatures * cUniqueSamples);
+   void * const aTargetsTo = EbmMalloc<void>(cUniqueSamples, cBytesPerTarget);
+   FloatEbmType * const aPredictorScoresTo = EbmMalloc<FloatEbmType>(cVectorLength * cUniqueSamples);
+   IntEbmType * const aWeightsTo = EbmMalloc<IntEbmType>(cUniqueSamples);
+   if((0 != cFeatures && nullptr == aBinnedDataTo) || nullptr == aTargetsTo || nullptr == aPredictorScoresTo ||
+      nullptr == aWeightsTo)
+   {
+      LOG_0(TraceLevelWarning, "WARNING DeduplicatedSamples::Initialize out of memory");
+      free(aiFirstSamples);
+      free(aUniqueWeights);
+      free(aBinnedDataTo);
+      free(aTargetsTo);
+      free(aPredictorScoresTo);
+      free(aWeightsTo);
+      return true;
+   }
+
+   for(size_t iUnique = 0; iUnique < cUniqueSamples; ++iUnique) {
+      const size_t iFirstSample = aiFirstSamples[iUnique];
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         aBinnedDataTo[iFeature * cUniqueSamples + iUnique] = aBinnedData[iFeature * cSamples + iFirstSample];
+      }
+      memcpy(static_cast<char *>(aTargetsTo) + cBytesPerTarget * iUnique, aTargetBytes + cBytesPerTarget * iFirstSample, 
+         cBytesPerTarget);
+      memcpy(&aPredictorScoresTo[cVectorLength * iUnique], &aPredictorScores[cVectorLength * iFirstSample], 
+         cBytesPerPredictorScores);
+      const size_t cWeight = aUniqueWeights[iUnique];
+      if(!IsNumberConvertable<IntEbmType>(cWeight)) {
+         LOG_0(TraceLevelError, "ERROR DeduplicatedSamples::Initialize the sum of the weights is too large");
+         free(aiFirstSamples);
+         free(aUniqueWeights);
+         free(aBinnedDataTo);
+         free(aTargetsTo);
+         free(aPredictorScoresTo);
+         free(aWeightsTo);
+         return true;
+      }
+      aWeightsTo[iUnique] = static_cast<IntEbmType>(cWeight);
+   }
+   free(aiFirstSamples);
+   free(aUniqueWeights);
+
+   m_cSamples = cUniqueSamples;
+   m_aBinnedData = aBinnedDataTo;
+   m_aTargets = aTargetsTo;
+   m_aPredictorScores = aPredictorScoresTo;
+   m_aWeights = aWeightsTo;
+
+   LOG_0(TraceLevelInfo, "Exited DeduplicatedSamples::Initialize");
+   return false;
+}
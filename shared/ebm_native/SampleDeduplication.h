@@ -0,0 +1,78 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef SAMPLE_DEDUPLICATION_H
+#define SAMPLE_DEDUPLICATION_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h" // IntEbmType, FloatEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+
+// Once features are discretized many samples become indistinguishable, so boosting on them repeats the same work.
+// DeduplicatedSamples collapses the samples that have identical binned data, targets and predictor scores into a
+// single sample whose weight is the sum of their weights.  The arrays have the same layout that AllocateBoosting
+// accepts, with GetCountSamples() samples, and the weights are in the order that the samples first appeared
+class DeduplicatedSamples final {
+   size_t m_cSamples;
+   IntEbmType * m_aBinnedData;
+   // either IntEbmType or FloatEbmType targets, depending on the learning type
+   void * m_aTargets;
+   FloatEbmType * m_aPredictorScores;
+   IntEbmType * m_aWeights;
+
+public:
+
+   DeduplicatedSamples() = default; // preserve our POD status
+   ~DeduplicatedSamples() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void InitializeZero() {
+      m_cSamples = 0;
+      m_aBinnedData = nullptr;
+      m_aTargets = nullptr;
+      m_aPredictorScores = nullptr;
+      m_aWeights = nullptr;
+   }
+
+   void Destruct();
+
+   // aBinnedData holds cFeatures columns of cSamples bins each, and aWeights can be nullptr to give every sample a
+   // weight of 1.  cSamples needs to be non-zero.  Returns true on error
+   bool Initialize(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const size_t cFeatures,
+      const size_t cSamples,
+      const IntEbmType * const aBinnedData,
+      const void * const aTargets,
+      const FloatEbmType * const aPredictorScores,
+      const IntEbmType * const aWeights
+   );
+
+   INLINE_ALWAYS size_t GetCountSamples() const {
+      return m_cSamples;
+   }
+   INLINE_ALWAYS const IntEbmType * GetBinnedData() const {
+      return m_aBinnedData;
+   }
+   INLINE_ALWAYS const void * GetTargets() const {
+      return m_aTargets;
+   }
+   INLINE_ALWAYS const FloatEbmType * GetPredictorScores() const {
+      return m_aPredictorScores;
+   }
+   INLINE_ALWAYS const IntEbmType * GetWeights() const {
+      return m_aWeights;
+   }
+};
+static_assert(std::is_standard_layout<DeduplicatedSamples>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<DeduplicatedSamples>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<DeduplicatedSamples>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // SAMPLE_DEDUPLICATION_H
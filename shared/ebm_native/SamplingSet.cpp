@@ -6,16 +6,148 @@
 
 #include <stdlib.h> // free
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
+#include <algorithm> // std::upper_bound
+#include <limits> // numeric_limits
 
 #include "EbmInternal.h" // INLINE_ALWAYS & UNLIKLEY
 #include "Logging.h" // EBM_ASSERT & LOG
 #include "RandomStream.h" // our header didn't need the full definition, but we use the RandomStream in here, so we need it
+#include "SimdKernels.h"
+#include "ThreadPool.h"
 #include "DataSetBoosting.h"
 #include "SamplingSet.h"
 
+// each block of draws gets it's own RandomStream seeded from the booster's stream in block order, so the bags only 
+// depend on the seed, and not on the number of threads or the instruction set that generated them
+constexpr size_t k_cDrawsPerBlock = size_t { 1 } << 16;
+// we generate this many blocks per thread before counting them, which bounds our memory use on large weight totals
+constexpr size_t k_cDrawBlocksPerThread = 4;
+
+class DrawContext final {
+public:
+
+   DrawContext() = default; // preserve our POD status
+   ~DrawContext() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   const SimdKernels * m_pSimdKernels;
+   size_t m_cRange;
+   size_t m_cDraws;
+   const IntEbmType * m_aSeeds;
+   uint32_t * m_aDraws;
+};
+static_assert(std::is_standard_layout<DrawContext>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<DrawContext>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<DrawContext>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+static void DrawTask(void * const pContextVoid, const size_t iBlock) {
+   const DrawContext * const pContext = static_cast<const DrawContext *>(pContextVoid);
+   const size_t iDrawStart = iBlock * k_cDrawsPerBlock;
+   EBM_ASSERT(iDrawStart < pContext->m_cDraws);
+   const size_t cDrawsBlock = std::min(pContext->m_cDraws - iDrawStart, k_cDrawsPerBlock);
+
+   RandomStream randomStream;
+   randomStream.Initialize(pContext->m_aSeeds[iBlock]);
+   randomStream.FillRandom(pContext->m_pSimdKernels, pContext->m_cRange, cDrawsBlock, &pContext->m_aDraws[iDrawStart]);
+}
+
+INLINE_ALWAYS static size_t MapDraw(
+   const size_t iDraw,
+   const size_t cSamples,
+   const size_t * const aWeightEnds,
+   const size_t * const aIncludedSamples
+) {
+   if(nullptr != aWeightEnds) {
+      // the sample that owns iDraw is the first one whose weight ends after it
+      const size_t iSample = 
+         static_cast<size_t>(std::upper_bound(aWeightEnds, aWeightEnds + cSamples, iDraw) - aWeightEnds);
+      EBM_ASSERT(iSample < cSamples);
+      return iSample;
+   }
+   if(nullptr != aIncludedSamples) {
+      return aIncludedSamples[iDraw];
+   }
+   return iDraw;
+}
+
+// makes cDraws draws from [0, cRange) and increments the count of the sample that MapDraw maps each draw onto.  
+// Without bBlockDraws every draw comes from pRandomStream in order, which are the bags that we've always made for a 
+// given seed.  Returns true if we were unable to allocate our buffers
+static bool CountDraws(
+   RandomStream * const pRandomStream,
+   const bool bBlockDraws,
+   const size_t cRange,
+   const size_t cDraws,
+   const size_t cSamples,
+   const size_t * const aWeightEnds,
+   const size_t * const aIncludedSamples,
+   size_t * const aCountOccurrences
+) {
+   EBM_ASSERT(0 < cRange);
+
+   // FillRandom only generates 32 bit numbers.  It would take more memory than exists to exceed that, but be safe
+   if(!bBlockDraws || size_t { std::numeric_limits<uint32_t>::max() } < cRange - size_t { 1 }) {
+      for(size_t iDraw = 0; iDraw < cDraws; ++iDraw) {
+         ++aCountOccurrences[MapDraw(pRandomStream->Next(cRange), cSamples, aWeightEnds, aIncludedSamples)];
+      }
+      return false;
+   }
+
+   const size_t cBlocks = (cDraws + k_cDrawsPerBlock - 1) / k_cDrawsPerBlock;
+   const size_t cBlocksPerGroup = std::min(cBlocks, ThreadPool::GetCountThreads() * k_cDrawBlocksPerThread);
+   if(0 == cBlocksPerGroup) {
+      return false;
+   }
+
+   IntEbmType * const aSeeds = EbmMalloc<IntEbmType>(cBlocksPerGroup);
+   if(nullptr == aSeeds) {
+      LOG_0(TraceLevelWarning, "WARNING CountDraws nullptr == aSeeds");
+      return true;
+   }
+   uint32_t * const aDraws = EbmMalloc<uint32_t>(std::min(cDraws, cBlocksPerGroup * k_cDrawsPerBlock));
+   if(nullptr == aDraws) {
+      LOG_0(TraceLevelWarning, "WARNING CountDraws nullptr == aDraws");
+      free(aSeeds);
+      return true;
+   }
+
+   DrawContext context;
+   context.m_pSimdKernels = SimdKernels::GetBestAvailable(SimdInstructionSet::Avx512);
+   context.m_cRange = cRange;
+   context.m_aSeeds = aSeeds;
+   context.m_aDraws = aDraws;
+
+   for(size_t iBlock = 0; iBlock < cBlocks; iBlock += cBlocksPerGroup) {
+      const size_t cBlocksGroup = std::min(cBlocks - iBlock, cBlocksPerGroup);
+      for(size_t iSeed = 0; iSeed < cBlocksGroup; ++iSeed) {
+         aSeeds[iSeed] = pRandomStream->NextEbmInt();
+      }
+      const size_t iDrawStart = iBlock * k_cDrawsPerBlock;
+      context.m_cDraws = std::min(cDraws - iDrawStart, cBlocksGroup * k_cDrawsPerBlock);
+
+      ThreadPool::ParallelFor(cBlocksGroup, DrawTask, &context);
+
+      // counting is a scatter into memory that the threads would share, so we leave it serial
+      const uint32_t * const pDrawsEnd = aDraws + context.m_cDraws;
+      for(const uint32_t * pDraw = aDraws; pDrawsEnd != pDraw; ++pDraw) {
+         ++aCountOccurrences[MapDraw(static_cast<size_t>(*pDraw), cSamples, aWeightEnds, aIncludedSamples)];
+      }
+   }
+
+   free(aDraws);
+   free(aSeeds);
+   return false;
+}
+
 SamplingSet * SamplingSet::GenerateSingleSamplingSet(
    RandomStream * const pRandomStream, 
-   const DataSetByFeatureGroup * const pOriginDataSet
+   const DataSetByFeatureGroup * const pOriginDataSet,
+   const bool bBlockDraws
 ) {
    LOG_0(TraceLevelVerbose, "Entered SamplingSet::GenerateSingleSamplingSet");
 
@@ -34,9 +166,62 @@ SamplingSet * SamplingSet::GenerateSingleSamplingSet(
       aCountOccurrences[i] = size_t { 0 };
    }
 
-   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
-      const size_t iCountOccurrences = pRandomStream->Next(cSamples);
-      ++aCountOccurrences[iCountOccurrences];
+   const size_t * const aWeights = pOriginDataSet->GetWeights();
+   const size_t * const aSampleMaskBits = pOriginDataSet->GetSampleMaskBits();
+   const size_t cSamplesIncluded = pOriginDataSet->GetCountSamplesIncluded();
+   const size_t cWeightTotal = pOriginDataSet->GetWeightTotal();
+   if(nullptr != aWeights) {
+      // a sample with weight w stands in for w identical samples, so we make GetWeightTotal() draws in proportion 
+      // to the weights, which gives the bags the same distribution as bagging the samples that they stand in for.  
+      // Masked samples have zero weight, so they are never drawn
+      size_t * const aWeightEnds = EbmMalloc<size_t>(cSamples);
+      if(nullptr == aWeightEnds) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSet nullptr == aWeightEnds");
+         free(aCountOccurrences);
+         return nullptr;
+      }
+      size_t weightEnd = 0;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         weightEnd += aWeights[iSample];
+         aWeightEnds[iSample] = weightEnd;
+      }
+      EBM_ASSERT(cWeightTotal == weightEnd);
+      const bool bFailed = 
+         CountDraws(pRandomStream, bBlockDraws, cWeightTotal, cWeightTotal, cSamples, aWeightEnds, nullptr, aCountOccurrences);
+      free(aWeightEnds);
+      if(bFailed) {
+         free(aCountOccurrences);
+         return nullptr;
+      }
+   } else if(nullptr == aSampleMaskBits) {
+      if(CountDraws(pRandomStream, bBlockDraws, cSamples, cSamples, cSamples, nullptr, nullptr, aCountOccurrences)) {
+         free(aCountOccurrences);
+         return nullptr;
+      }
+   } else {
+      // we draw from the samples in the mask in order, which gives the same bag as drawing from a data set that 
+      // only holds those samples
+      size_t * const aIncludedSamples = EbmMalloc<size_t>(cSamplesIncluded);
+      if(nullptr == aIncludedSamples) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSet nullptr == aIncludedSamples");
+         free(aCountOccurrences);
+         return nullptr;
+      }
+      size_t * pIncludedSample = aIncludedSamples;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         if(0 != ((aSampleMaskBits[iSample / k_cBitsForSizeT] >> (iSample % k_cBitsForSizeT)) & size_t { 1 })) {
+            *pIncludedSample = iSample;
+            ++pIncludedSample;
+         }
+      }
+      EBM_ASSERT(aIncludedSamples + cSamplesIncluded == pIncludedSample);
+      const bool bFailed = CountDraws(pRandomStream, bBlockDraws, cSamplesIncluded, cSamplesIncluded, cSamples, nullptr, 
+         aIncludedSamples, aCountOccurrences);
+      free(aIncludedSamples);
+      if(bFailed) {
+         free(aCountOccurrences);
+         return nullptr;
+      }
    }
 
    SamplingSet * pRet = EbmMalloc<SamplingSet>();
@@ -47,39 +232,185 @@ SamplingSet * SamplingSet::GenerateSingleSamplingSet(
    }
 
    pRet->m_pOriginDataSet = pOriginDataSet;
+   pRet->m_cTotalCountSampleOccurrences = cWeightTotal;
    pRet->m_aCountOccurrences = aCountOccurrences;
+   pRet->m_aIncludedBits = nullptr;
 
    LOG_0(TraceLevelVerbose, "Exited SamplingSet::GenerateSingleSamplingSet");
    return pRet;
 }
 
-SamplingSet * SamplingSet::GenerateFlatSamplingSet(const DataSetByFeatureGroup * const pOriginDataSet) {
-   LOG_0(TraceLevelInfo, "Entered SamplingSet::GenerateFlatSamplingSet");
+SamplingSet * SamplingSet::GenerateSingleSamplingSetWithoutReplacement(
+   RandomStream * const pRandomStream, 
+   const DataSetByFeatureGroup * const pOriginDataSet,
+   const size_t cSamplesIncluded
+) {
+   LOG_0(TraceLevelVerbose, "Entered SamplingSet::GenerateSingleSamplingSetWithoutReplacement");
 
-   // TODO: someday eliminate the need for generating this flat set by specially handling the case of no internal bagging
+   EBM_ASSERT(nullptr != pRandomStream);
    EBM_ASSERT(nullptr != pOriginDataSet);
+
    const size_t cSamples = pOriginDataSet->GetCountSamples();
    EBM_ASSERT(0 < cSamples); // if there were no samples, we wouldn't be called
+   EBM_ASSERT(0 < cSamplesIncluded);
+   EBM_ASSERT(cSamplesIncluded <= pOriginDataSet->GetWeightTotal());
 
-   size_t * const aCountOccurrences = EbmMalloc<size_t>(cSamples);
-   if(nullptr == aCountOccurrences) {
-      LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateFlatSamplingSet nullptr == aCountOccurrences");
+   const size_t * const aWeights = pOriginDataSet->GetWeights();
+   if(nullptr != aWeights) {
+      // a sample with weight w stands in for w identical samples, and we need to know how many of them are in the 
+      // bag, so we store counts instead of bits.  Making the same choice for each of the w samples that the 
+      // unweighted algorithm below makes keeps every subset of size cSamplesIncluded equally likely
+      size_t * const aCountOccurrences = EbmMalloc<size_t>(cSamples);
+      if(nullptr == aCountOccurrences) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSetWithoutReplacement nullptr == aCountOccurrences");
+         return nullptr;
+      }
+      size_t cIncludedRemaining = cSamplesIncluded;
+      size_t cWeightRemaining = pOriginDataSet->GetWeightTotal();
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         size_t cOccurrences = 0;
+         for(size_t iWeight = aWeights[iSample]; 0 != iWeight; --iWeight) {
+            const size_t iRandom = pRandomStream->Next(cWeightRemaining);
+            const size_t bIncluded = UNPREDICTABLE(iRandom < cIncludedRemaining) ? size_t { 1 } : size_t { 0 };
+            cIncludedRemaining -= bIncluded;
+            cOccurrences += bIncluded;
+            --cWeightRemaining;
+         }
+         aCountOccurrences[iSample] = cOccurrences;
+      }
+      EBM_ASSERT(0 == cWeightRemaining);
+      EBM_ASSERT(0 == cIncludedRemaining);
+
+      SamplingSet * pRet = EbmMalloc<SamplingSet>();
+      if(nullptr == pRet) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSetWithoutReplacement nullptr == pRet");
+         free(aCountOccurrences);
+         return nullptr;
+      }
+
+      pRet->m_pOriginDataSet = pOriginDataSet;
+      pRet->m_cTotalCountSampleOccurrences = cSamplesIncluded;
+      pRet->m_aCountOccurrences = aCountOccurrences;
+      pRet->m_aIncludedBits = nullptr;
+
+      LOG_0(TraceLevelVerbose, "Exited SamplingSet::GenerateSingleSamplingSetWithoutReplacement");
+      return pRet;
+   }
+
+   // cSamples is at least 1, and this can't overflow since the division happens first
+   const size_t cIncludedBitsUnits = (cSamples - 1) / k_cBitsForSizeT + 1;
+   size_t * const aIncludedBits = EbmMalloc<size_t>(cIncludedBitsUnits);
+   if(nullptr == aIncludedBits) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSetWithoutReplacement nullptr == aIncludedBits");
       return nullptr;
    }
 
-   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
-      aCountOccurrences[iSample] = 1;
+   // this is the same selection algorithm that our exported SamplingWithoutReplacement uses, so every subset of 
+   // size cSamplesIncluded is equally likely
+   const size_t * const aSampleMaskBits = pOriginDataSet->GetSampleMaskBits();
+   size_t cIncludedRemaining = cSamplesIncluded;
+   if(nullptr == aSampleMaskBits) {
+      size_t cSamplesRemaining = cSamples;
+      size_t * pIncludedBits = aIncludedBits;
+      do {
+         size_t bits = 0;
+         size_t iBit = 0;
+         do {
+            const size_t iRandom = pRandomStream->Next(cSamplesRemaining);
+            const size_t bIncluded = UNPREDICTABLE(iRandom < cIncludedRemaining) ? size_t { 1 } : size_t { 0 };
+            cIncludedRemaining -= bIncluded;
+            bits |= bIncluded << iBit;
+            --cSamplesRemaining;
+            ++iBit;
+         } while(0 != cSamplesRemaining && iBit < k_cBitsForSizeT);
+         *pIncludedBits = bits;
+         ++pIncludedBits;
+      } while(0 != cSamplesRemaining);
+      EBM_ASSERT(aIncludedBits + cIncludedBitsUnits == pIncludedBits);
+   } else {
+      // only the samples in the mask are candidates, and we consume random numbers only for them so that we pick 
+      // the same bag as we would from a data set that only holds those samples
+      size_t cSamplesRemaining = pOriginDataSet->GetCountSamplesIncluded();
+      for(size_t iIncludedBitsUnit = 0; iIncludedBitsUnit < cIncludedBitsUnits; ++iIncludedBitsUnit) {
+         const size_t maskBits = aSampleMaskBits[iIncludedBitsUnit];
+         size_t bits = 0;
+         for(size_t iBit = 0; iBit < k_cBitsForSizeT; ++iBit) {
+            if(0 != ((maskBits >> iBit) & size_t { 1 })) {
+               const size_t iRandom = pRandomStream->Next(cSamplesRemaining);
+               const size_t bIncluded = UNPREDICTABLE(iRandom < cIncludedRemaining) ? size_t { 1 } : size_t { 0 };
+               cIncludedRemaining -= bIncluded;
+               bits |= bIncluded << iBit;
+               --cSamplesRemaining;
+            }
+         }
+         aIncludedBits[iIncludedBitsUnit] = bits;
+      }
+      EBM_ASSERT(0 == cSamplesRemaining);
+   }
+   EBM_ASSERT(0 == cIncludedRemaining); // this should be all used up too now
+
+   SamplingSet * pRet = EbmMalloc<SamplingSet>();
+   if(nullptr == pRet) {
+      LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSingleSamplingSetWithoutReplacement nullptr == pRet");
+      free(aIncludedBits);
+      return nullptr;
+   }
+
+   pRet->m_pOriginDataSet = pOriginDataSet;
+   pRet->m_cTotalCountSampleOccurrences = cSamplesIncluded;
+   pRet->m_aCountOccurrences = nullptr;
+   pRet->m_aIncludedBits = aIncludedBits;
+
+   LOG_0(TraceLevelVerbose, "Exited SamplingSet::GenerateSingleSamplingSetWithoutReplacement");
+   return pRet;
+}
+
+SamplingSet * SamplingSet::GenerateFlatSamplingSet(const DataSetByFeatureGroup * const pOriginDataSet) {
+   LOG_0(TraceLevelInfo, "Entered SamplingSet::GenerateFlatSamplingSet");
+
+   EBM_ASSERT(nullptr != pOriginDataSet);
+   const size_t cSamples = pOriginDataSet->GetCountSamples();
+   EBM_ASSERT(0 < cSamples); // if there were no samples, we wouldn't be called
+
+   // every sample occurs exactly once, so we don't need any per-sample storage.  The binning kernels have a 
+   // specialization for OccurrenceStorage::Flat that doesn't read or multiply by counts.  If our data set has a 
+   // sample mask, then the samples in the mask occur once and the others not at all, which is what 
+   // OccurrenceStorage::IncludedBits records.  Weighted samples occur as many times as their weight, which 
+   // already is zero outside of our mask
+   size_t * aCountOccurrences = nullptr;
+   size_t * aIncludedBits = nullptr;
+   const size_t * const aWeights = pOriginDataSet->GetWeights();
+   const size_t * const aSampleMaskBits = pOriginDataSet->GetSampleMaskBits();
+   if(nullptr != aWeights) {
+      aCountOccurrences = EbmMalloc<size_t>(cSamples);
+      if(nullptr == aCountOccurrences) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateFlatSamplingSet nullptr == aCountOccurrences");
+         return nullptr;
+      }
+      memcpy(aCountOccurrences, aWeights, sizeof(size_t) * cSamples);
+   } else if(nullptr != aSampleMaskBits) {
+      // cSamples is at least 1, and this can't overflow since the division happens first
+      const size_t cIncludedBitsUnits = (cSamples - 1) / k_cBitsForSizeT + 1;
+      aIncludedBits = EbmMalloc<size_t>(cIncludedBitsUnits);
+      if(nullptr == aIncludedBits) {
+         LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateFlatSamplingSet nullptr == aIncludedBits");
+         return nullptr;
+      }
+      memcpy(aIncludedBits, aSampleMaskBits, sizeof(size_t) * cIncludedBitsUnits);
    }
 
    SamplingSet * pRet = EbmMalloc<SamplingSet>();
    if(nullptr == pRet) {
       LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateFlatSamplingSet nullptr == pRet");
       free(aCountOccurrences);
+      free(aIncludedBits);
       return nullptr;
    }
 
    pRet->m_pOriginDataSet = pOriginDataSet;
+   pRet->m_cTotalCountSampleOccurrences = pOriginDataSet->GetWeightTotal();
    pRet->m_aCountOccurrences = aCountOccurrences;
+   pRet->m_aIncludedBits = aIncludedBits;
 
    LOG_0(TraceLevelInfo, "Exited SamplingSet::GenerateFlatSamplingSet");
    return pRet;
@@ -94,6 +425,7 @@ void SamplingSet::FreeSamplingSets(const size_t cSamplingSets, SamplingSet ** co
       for(size_t iSamplingSet = 0; iSamplingSet < cSamplingSetsAfterZero; ++iSamplingSet) {
          if(nullptr != apSamplingSets[iSamplingSet]) {
             free(apSamplingSets[iSamplingSet]->m_aCountOccurrences);
+            free(apSamplingSets[iSamplingSet]->m_aIncludedBits);
             free(apSamplingSets[iSamplingSet]);
          }
       }
@@ -106,12 +438,15 @@ WARNING_POP
 SamplingSet ** SamplingSet::GenerateSamplingSets(
    RandomStream * const pRandomStream, 
    const DataSetByFeatureGroup * const pOriginDataSet, 
-   const size_t cSamplingSets
+   const size_t cSamplingSets,
+   const size_t cSamplesIncluded,
+   const bool bBlockDraws
 ) {
    LOG_0(TraceLevelInfo, "Entered SamplingSet::GenerateSamplingSets");
 
    EBM_ASSERT(nullptr != pRandomStream);
    EBM_ASSERT(nullptr != pOriginDataSet);
+   EBM_ASSERT(cSamplesIncluded <= pOriginDataSet->GetWeightTotal());
 
    const size_t cSamplingSetsAfterZero = 0 == cSamplingSets ? 1 : cSamplingSets;
 
@@ -135,7 +470,9 @@ SamplingSet ** SamplingSet::GenerateSamplingSets(
       apSamplingSets[0] = pSingleSamplingSet;
    } else {
       for(size_t iSamplingSet = 0; iSamplingSet < cSamplingSets; ++iSamplingSet) {
-         SamplingSet * const pSingleSamplingSet = GenerateSingleSamplingSet(pRandomStream, pOriginDataSet);
+         SamplingSet * const pSingleSamplingSet = 0 == cSamplesIncluded ? 
+            GenerateSingleSamplingSet(pRandomStream, pOriginDataSet, bBlockDraws) :
+            GenerateSingleSamplingSetWithoutReplacement(pRandomStream, pOriginDataSet, cSamplesIncluded);
          if(UNLIKELY(nullptr == pSingleSamplingSet)) {
             LOG_0(TraceLevelWarning, "WARNING SamplingSet::GenerateSamplingSets nullptr == pSingleSamplingSet");
             FreeSamplingSets(cSamplingSets, apSamplingSets);
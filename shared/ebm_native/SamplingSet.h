@@ -13,23 +13,38 @@
 class RandomStream;
 class DataSetByFeatureGroup;
 
+// how a SamplingSet records the number of times each sample occurs in it.  Flat sets are used when we don't 
+// bag and they have no per-sample storage since every sample occurs exactly once
+enum class OccurrenceStorage { Flat = 0, Counts = 1, IncludedBits = 2 };
+
 class SamplingSet final {
    // Sampling with replacement is the more theoretically correct method of sampling, but it has the drawback that 
    // we need to keep a count of the number of times each sample is selected in the dataset.  
-   // Sampling without replacement would require 1 bit per case, so it can be faster.
+   // Sampling without replacement only requires 1 bit per case, so it can be faster.  We support both.  At most 
+   // one of m_aCountOccurrences and m_aIncludedBits is non-null.  If both are null we hold every sample once.
 
    const DataSetByFeatureGroup * m_pOriginDataSet;
+   size_t m_cTotalCountSampleOccurrences;
 
    // TODO : make this a struct of FractionalType and size_t counts and use MACROS to have either size_t or 
    // FractionalType or both, and perf how this changes things.  We don't get a benefit anywhere by storing 
    // the raw data in both formats since it is never converted anyways, but this count is!
    size_t * m_aCountOccurrences;
 
+   // bit (iSample % k_cBitsForSizeT) of m_aIncludedBits[iSample / k_cBitsForSizeT] is set if iSample is in the bag
+   size_t * m_aIncludedBits;
+
    // we take owernship of the aCounts array.  We do not take ownership of the pOriginDataSet since many 
    // SamplingSet objects will refer to the original one
    static SamplingSet * GenerateSingleSamplingSet(
       RandomStream * const pRandomStream, 
-      const DataSetByFeatureGroup * const pOriginDataSet
+      const DataSetByFeatureGroup * const pOriginDataSet,
+      const bool bBlockDraws
+   );
+   static SamplingSet * GenerateSingleSamplingSetWithoutReplacement(
+      RandomStream * const pRandomStream, 
+      const DataSetByFeatureGroup * const pOriginDataSet,
+      const size_t cSamplesIncluded
    );
    static SamplingSet * GenerateFlatSamplingSet(const DataSetByFeatureGroup * const pOriginDataSet);
 
@@ -41,12 +56,15 @@ public:
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
    size_t GetTotalCountSampleOccurrences() const {
-      // for SamplingSet (bootstrap sampling), we have the same number of samples as our original dataset
-      size_t cTotalCountSampleOccurrences = m_pOriginDataSet->GetCountSamples();
+      // for bootstrap sampling we have the same number of samples as our original dataset, but when sampling 
+      // without replacement we only have the samples that were included in the bag
+      size_t cTotalCountSampleOccurrences = m_cTotalCountSampleOccurrences;
 #ifndef NDEBUG
       size_t cTotalCountSampleOccurrencesDebug = 0;
       for(size_t i = 0; i < m_pOriginDataSet->GetCountSamples(); ++i) {
-         cTotalCountSampleOccurrencesDebug += m_aCountOccurrences[i];
+         cTotalCountSampleOccurrencesDebug += nullptr != m_aIncludedBits ? 
+            (m_aIncludedBits[i / k_cBitsForSizeT] >> (i % k_cBitsForSizeT)) & size_t { 1 } : 
+            nullptr != m_aCountOccurrences ? m_aCountOccurrences[i] : size_t { 1 };
       }
       EBM_ASSERT(cTotalCountSampleOccurrencesDebug == cTotalCountSampleOccurrences);
 #endif // NDEBUG
@@ -57,15 +75,34 @@ public:
       return m_pOriginDataSet;
    }
 
+   OccurrenceStorage GetOccurrenceStorage() const {
+      return nullptr != m_aIncludedBits ? OccurrenceStorage::IncludedBits : 
+         nullptr != m_aCountOccurrences ? OccurrenceStorage::Counts : OccurrenceStorage::Flat;
+   }
+
+   // only valid for OccurrenceStorage::Counts
    const size_t * GetCountOccurrences() const {
+      EBM_ASSERT(nullptr != m_aCountOccurrences);
       return m_aCountOccurrences;
    }
 
+   // only valid for OccurrenceStorage::IncludedBits
+   const size_t * GetIncludedBits() const {
+      EBM_ASSERT(nullptr != m_aIncludedBits);
+      return m_aIncludedBits;
+   }
+
    static void FreeSamplingSets(const size_t cSamplingSets, SamplingSet ** const apSamplingSets);
+
+   // if cSamplesIncluded is zero we sample with replacement.  Otherwise each bag holds exactly cSamplesIncluded 
+   // distinct samples.  cSamplesIncluded is ignored if cSamplingSets is zero since then we use all the samples.  
+   // bBlockDraws selects the parallel block draws of TempParamBoostingBlockDraws for sampling with replacement
    static SamplingSet ** GenerateSamplingSets(
       RandomStream * const pRandomStream, 
       const DataSetByFeatureGroup * const pOriginDataSet, 
-      const size_t cSamplingSets
+      const size_t cSamplingSets,
+      const size_t cSamplesIncluded,
+      const bool bBlockDraws
    );
 };
 static_assert(std::is_standard_layout<SamplingSet>::value,
@@ -23,6 +23,18 @@ SegmentedTensor * SegmentedTensor::Allocate(const size_t cDimensionsMax, const s
       return nullptr;
    }
    const size_t cValueCapacity = cVectorLength * k_initialValueCapacity;
+   if(IsMultiplyError(sizeof(FloatEbmType), cValueCapacity)) {
+      LOG_0(TraceLevelWarning, "WARNING Allocate IsMultiplyError(sizeof(FloatEbmType), cValueCapacity)");
+      return nullptr;
+   }
+   const size_t cBytesValues = sizeof(FloatEbmType) * cValueCapacity;
+   // this can't overflow since cDimensionsMax can't be bigger than k_cDimensionsMax, which is arround 64
+   const size_t cBytesDivisions = sizeof(ActiveDataType) * k_initialDivisionCapacity * cDimensionsMax;
+   if(IsAddError(cBytesValues, cBytesDivisions)) {
+      LOG_0(TraceLevelWarning, "WARNING Allocate IsAddError(cBytesValues, cBytesDivisions)");
+      return nullptr;
+   }
+   const size_t cBytesBuffer = cBytesValues + cBytesDivisions;
 
    // this can't overflow since cDimensionsMax can't be bigger than k_cDimensionsMax, which is arround 64
    const size_t cBytesSegmentedRegion = sizeof(SegmentedTensor) - sizeof(DimensionInfo) + sizeof(DimensionInfo) * cDimensionsMax;
@@ -32,13 +44,14 @@ SegmentedTensor * SegmentedTensor::Allocate(const size_t cDimensionsMax, const s
       return nullptr;
    }
 
+   pSegmentedRegion->m_cBytesBufferCapacity = cBytesBuffer;
    pSegmentedRegion->m_cVectorLength = cVectorLength;
    pSegmentedRegion->m_cDimensionsMax = cDimensionsMax;
    pSegmentedRegion->m_cDimensions = cDimensionsMax;
    pSegmentedRegion->m_cValueCapacity = cValueCapacity;
    pSegmentedRegion->m_bExpanded = false;
 
-   FloatEbmType * const aValues = EbmMalloc<FloatEbmType>(cValueCapacity);
+   FloatEbmType * const aValues = static_cast<FloatEbmType *>(EbmMalloc<void>(cBytesBuffer));
    if(UNLIKELY(nullptr == aValues)) {
       LOG_0(TraceLevelWarning, "WARNING Allocate nullptr == aValues");
       free(pSegmentedRegion); // don't need to call the full Free(*) yet
@@ -52,45 +65,22 @@ SegmentedTensor * SegmentedTensor::Allocate(const size_t cDimensionsMax, const s
       aValues[i] = FloatEbmType { 0 };
    }
 
-   if(0 != cDimensionsMax) {
-      DimensionInfo * pDimension = pSegmentedRegion->GetDimensions();
-      size_t iDimension = 0;
-      do {
-         pDimension->m_cDivisions = 0;
-         pDimension->m_cDivisionCapacity = k_initialDivisionCapacity;
-         pDimension->m_aDivisions = nullptr;
-         ++pDimension;
-         ++iDimension;
-      } while(iDimension < cDimensionsMax);
-
-      pDimension = pSegmentedRegion->GetDimensions();
-      iDimension = 0;
-      do {
-         ActiveDataType * const aDivisions = EbmMalloc<ActiveDataType>(k_initialDivisionCapacity);
-         if(UNLIKELY(nullptr == aDivisions)) {
-            LOG_0(TraceLevelWarning, "WARNING Allocate nullptr == aDivisions");
-            Free(pSegmentedRegion); // free everything!
-            return nullptr;
-         }
-         pDimension->m_aDivisions = aDivisions;
-         ++pDimension;
-         ++iDimension;
-      } while(iDimension < cDimensionsMax);
+   DimensionInfo * pDimension = pSegmentedRegion->GetDimensions();
+   size_t iByteDivisions = cBytesValues;
+   for(size_t iDimension = 0; iDimension < cDimensionsMax; ++iDimension) {
+      pDimension->m_cDivisions = 0;
+      pDimension->m_iByteDivisions = iByteDivisions;
+      pDimension->m_cDivisionCapacity = k_initialDivisionCapacity;
+      iByteDivisions += sizeof(ActiveDataType) * k_initialDivisionCapacity;
+      ++pDimension;
    }
+   EBM_ASSERT(cBytesBuffer == iByteDivisions);
    return pSegmentedRegion;
 }
 
 void SegmentedTensor::Free(SegmentedTensor * const pSegmentedRegion) {
    if(LIKELY(nullptr != pSegmentedRegion)) {
       free(pSegmentedRegion->m_aValues);
-      if(LIKELY(0 != pSegmentedRegion->m_cDimensionsMax)) {
-         const DimensionInfo * pDimensionInfo = pSegmentedRegion->GetDimensions();
-         const DimensionInfo * const pDimensionInfoEnd = &pDimensionInfo[pSegmentedRegion->m_cDimensionsMax];
-         do {
-            free(pDimensionInfo->m_aDivisions);
-            ++pDimensionInfo;
-         } while(pDimensionInfoEnd != pDimensionInfo);
-      }
       free(pSegmentedRegion);
    }
 }
@@ -108,6 +98,42 @@ void SegmentedTensor::Reset() {
    m_bExpanded = false;
 }
 
+bool SegmentedTensor::InsertBytes(const size_t iByteInsert, const size_t cBytesInsert) {
+   const size_t cBytesUsed = GetCountBytesUsed();
+   EBM_ASSERT(iByteInsert <= cBytesUsed);
+   EBM_ASSERT(cBytesUsed <= m_cBytesBufferCapacity);
+
+   if(IsAddError(cBytesUsed, cBytesInsert)) {
+      LOG_0(TraceLevelWarning, "WARNING InsertBytes IsAddError(cBytesUsed, cBytesInsert)");
+      return true;
+   }
+   const size_t cBytesNew = cBytesUsed + cBytesInsert;
+   if(UNLIKELY(m_cBytesBufferCapacity < cBytesNew)) {
+      LOG_N(TraceLevelInfo, "InsertBytes Growing to size %zu", cBytesNew);
+      FloatEbmType * const aNewValues = static_cast<FloatEbmType *>(realloc(m_aValues, cBytesNew));
+      if(UNLIKELY(nullptr == aNewValues)) {
+         // according to the realloc spec, if realloc fails to allocate the new memory, it returns nullptr BUT the old memory is valid.
+         // we leave m_aValues alone in this instance and will free that memory later in Free
+         LOG_0(TraceLevelWarning, "WARNING InsertBytes nullptr == aNewValues");
+         return true;
+      }
+      m_aValues = aNewValues;
+      m_cBytesBufferCapacity = cBytesNew;
+   }
+
+   char * const pInsert = reinterpret_cast<char *>(m_aValues) + iByteInsert;
+   memmove(pInsert + cBytesInsert, pInsert, cBytesUsed - iByteInsert);
+
+   DimensionInfo * pDimension = GetDimensions();
+   const DimensionInfo * const pDimensionEnd = &pDimension[m_cDimensionsMax];
+   for(; pDimensionEnd != pDimension; ++pDimension) {
+      if(iByteInsert <= pDimension->m_iByteDivisions) {
+         pDimension->m_iByteDivisions += cBytesInsert;
+      }
+   }
+   return false;
+}
+
 bool SegmentedTensor::SetCountDivisions(const size_t iDimension, const size_t cDivisions) {
    EBM_ASSERT(iDimension < m_cDimensions);
    DimensionInfo * const pDimension = &GetDimensions()[iDimension];
@@ -129,15 +155,13 @@ bool SegmentedTensor::SetCountDivisions(const size_t iDimension, const size_t cD
          LOG_0(TraceLevelWarning, "WARNING SetCountDivisions IsMultiplyError(sizeof(ActiveDataType), cNewDivisionCapacity)");
          return true;
       }
-      size_t cBytes = sizeof(ActiveDataType) * cNewDivisionCapacity;
-      ActiveDataType * const aNewDivisions = static_cast<ActiveDataType *>(realloc(pDimension->m_aDivisions, cBytes));
-      if(UNLIKELY(nullptr == aNewDivisions)) {
-         // according to the realloc spec, if realloc fails to allocate the new memory, it returns nullptr BUT the old memory is valid.
-         // we leave m_aThreadByteBuffer1 alone in this instance and will free that memory later in the destructor
-         LOG_0(TraceLevelWarning, "WARNING SetCountDivisions nullptr == aNewDivisions");
+      // our existing divisions are already allocated, so this can't overflow
+      const size_t cBytesOld = sizeof(ActiveDataType) * pDimension->m_cDivisionCapacity;
+      const size_t cBytesInsert = sizeof(ActiveDataType) * cNewDivisionCapacity - cBytesOld;
+      if(UNLIKELY(InsertBytes(pDimension->m_iByteDivisions + cBytesOld, cBytesInsert))) {
+         LOG_0(TraceLevelWarning, "WARNING SetCountDivisions InsertBytes(pDimension->m_iByteDivisions + cBytesOld, cBytesInsert)");
          return true;
       }
-      pDimension->m_aDivisions = aNewDivisions;
       pDimension->m_cDivisionCapacity = cNewDivisionCapacity;
    } // never shrink our array unless the user chooses to Trim()
    pDimension->m_cDivisions = cDivisions;
@@ -160,15 +184,13 @@ bool SegmentedTensor::EnsureValueCapacity(const size_t cValues) {
          LOG_0(TraceLevelWarning, "WARNING EnsureValueCapacity IsMultiplyError(sizeof(FloatEbmType), cNewValueCapacity)");
          return true;
       }
-      size_t cBytes = sizeof(FloatEbmType) * cNewValueCapacity;
-      FloatEbmType * const aNewValues = static_cast<FloatEbmType *>(realloc(m_aValues, cBytes));
-      if(UNLIKELY(nullptr == aNewValues)) {
-         // according to the realloc spec, if realloc fails to allocate the new memory, it returns nullptr BUT the old memory is valid.
-         // we leave m_aThreadByteBuffer1 alone in this instance and will free that memory later in the destructor
-         LOG_0(TraceLevelWarning, "WARNING EnsureValueCapacity nullptr == aNewValues");
+      // our existing values are already allocated, so this can't overflow
+      const size_t cBytesOld = sizeof(FloatEbmType) * m_cValueCapacity;
+      // the divisions sit right above our values, so they all move up
+      if(UNLIKELY(InsertBytes(cBytesOld, sizeof(FloatEbmType) * cNewValueCapacity - cBytesOld))) {
+         LOG_0(TraceLevelWarning, "WARNING EnsureValueCapacity InsertBytes(cBytesOld, sizeof(FloatEbmType) * cNewValueCapacity - cBytesOld)");
          return true;
       }
-      m_aValues = aNewValues;
       m_cValueCapacity = cNewValueCapacity;
    } // never shrink our array unless the user chooses to Trim()
    return false;
@@ -176,29 +198,26 @@ bool SegmentedTensor::EnsureValueCapacity(const size_t cValues) {
 
 bool SegmentedTensor::Copy(const SegmentedTensor & rhs) {
    EBM_ASSERT(m_cDimensions == rhs.m_cDimensions);
-
-   const DimensionInfo * pThisDimensionInfo = GetDimensions();
-   const DimensionInfo * pRhsDimensionInfo = rhs.GetDimensions();
-
-   size_t cValues = m_cVectorLength;
-   for(size_t iDimension = 0; iDimension < m_cDimensions; ++iDimension) {
-      const DimensionInfo * const pDimension = &pRhsDimensionInfo[iDimension];
-      size_t cDivisions = pDimension->m_cDivisions;
-      EBM_ASSERT(!IsMultiplyError(cValues, cDivisions + 1)); // we're copying this memory, so multiplication can't overflow
-      cValues *= (cDivisions + 1);
-      if(UNLIKELY(SetCountDivisions(iDimension, cDivisions))) {
-         LOG_0(TraceLevelWarning, "WARNING Copy SetCountDivisions(iDimension, cDivisions)");
+   EBM_ASSERT(m_cDimensionsMax == rhs.m_cDimensionsMax);
+   EBM_ASSERT(m_cVectorLength == rhs.m_cVectorLength);
+
+   // we take on the layout of rhs, so the whole tensor is a single memcpy of the buffer and our dimension offsets
+   const size_t cBytes = rhs.GetCountBytesUsed();
+   if(UNLIKELY(m_cBytesBufferCapacity < cBytes)) {
+      // we overwrite everything, so there's no need for realloc to preserve our existing values
+      FloatEbmType * const aNewValues = static_cast<FloatEbmType *>(EbmMalloc<void>(cBytes));
+      if(UNLIKELY(nullptr == aNewValues)) {
+         LOG_0(TraceLevelWarning, "WARNING Copy nullptr == aNewValues");
          return true;
       }
-      EBM_ASSERT(!IsMultiplyError(sizeof(ActiveDataType), cDivisions)); // we're copying this memory, so multiplication can't overflow
-      memcpy(pThisDimensionInfo[iDimension].m_aDivisions, pDimension->m_aDivisions, sizeof(ActiveDataType) * cDivisions);
-   }
-   if(UNLIKELY(EnsureValueCapacity(cValues))) {
-      LOG_0(TraceLevelWarning, "WARNING Copy EnsureValueCapacity(cValues)");
-      return true;
+      free(m_aValues);
+      m_aValues = aNewValues;
+      m_cBytesBufferCapacity = cBytes;
    }
-   EBM_ASSERT(!IsMultiplyError(sizeof(FloatEbmType), cValues)); // we're copying this memory, so multiplication can't overflow
-   memcpy(m_aValues, rhs.m_aValues, sizeof(FloatEbmType) * cValues);
+   memcpy(m_aValues, rhs.m_aValues, cBytes);
+   // this can't overflow since we allocated the same number of dimensions
+   memcpy(GetDimensions(), rhs.GetDimensions(), sizeof(DimensionInfo) * m_cDimensionsMax);
+   m_cValueCapacity = rhs.m_cValueCapacity;
    m_bExpanded = rhs.m_bExpanded;
    return false;
 }
@@ -266,7 +285,6 @@ bool SegmentedTensor::Expand(const size_t * const acValuesPerDimension) {
       EBM_ASSERT(!IsMultiplyError(cValues1, cDivisions1 + 1)); // this is accessing existing memory, so it can't overflow
       cValues1 *= cDivisions1 + 1;
 
-      pDimensionInfoStackFirst->m_pDivision1 = &pDimensionFirst1->m_aDivisions[cDivisions1];
       const size_t cValuesPerDimension = *pcValuesPerDimension;
       // we check for simple multiplication overflow from m_cBins in EbmBoostingState->Initialize when we unpack featureGroupIndexes 
       // and in CalculateInteractionScore for interactions
@@ -294,7 +312,12 @@ bool SegmentedTensor::Expand(const size_t * const acValuesPerDimension) {
    }
 
    FloatEbmType * const aValues = m_aValues;
-   const DimensionInfo * const aDimension1 = GetDimensions();
+   DimensionInfo * const aDimension1 = GetDimensions();
+
+   // EnsureValueCapacity can move our divisions, so we only point into them afterwards
+   for(size_t iDimension = 0; iDimension < m_cDimensions; ++iDimension) {
+      aDimensionInfoStackExpand[iDimension].m_pDivision1 = &GetDivisions(&aDimension1[iDimension])[aDimension1[iDimension].m_cDivisions];
+   }
 
    EBM_ASSERT(cValues1 <= cNewValues);
    EBM_ASSERT(!IsMultiplyError(m_cVectorLength, cValues1)); // we checked against cNewValues above, and cValues1 should be smaller
@@ -332,7 +355,7 @@ bool SegmentedTensor::Expand(const size_t * const acValuesPerDimension) {
          const ActiveDataType * const pDivision1 = pDimensionInfoStackSecond->m_pDivision1;
          size_t iDivision2 = pDimensionInfoStackSecond->m_iDivision2;
 
-         ActiveDataType * const aDivisions1 = pDimensionSecond1->m_aDivisions;
+         const ActiveDataType * const aDivisions1 = GetDivisions(pDimensionSecond1);
 
          if(UNPREDICTABLE(aDivisions1 < pDivision1)) {
             EBM_ASSERT(0 < iDivision2);
@@ -391,8 +414,9 @@ bool SegmentedTensor::Expand(const size_t * const acValuesPerDimension) {
          return true;
       }
 
+      ActiveDataType * const aDivisions = GetDivisions(&aDimension1[iDimension]);
       for(size_t iDivision = 0; iDivision < cDivisions; ++iDivision) {
-         aDimension1[iDimension].m_aDivisions[iDivision] = iDivision;
+         aDivisions[iDivision] = iDivision;
       }
    }
 
@@ -463,11 +487,28 @@ bool SegmentedTensor::Add(const SegmentedTensor & rhs) {
       return false;
    }
 
-   if(m_bExpanded) {
-      // TODO: the existing code below works, but handle this differently (we can do it more efficiently)
+   if(m_bExpanded && rhs.m_bExpanded) {
+      // expanded tensors of the same feature group have identical divisions, so we only need to add the values
+      const DimensionInfo * const aDimension1 = GetDimensions();
+      size_t cValues = m_cVectorLength;
+      for(size_t iDimension = 0; iDimension < m_cDimensions; ++iDimension) {
+         EBM_ASSERT(aDimension1[iDimension].m_cDivisions == rhs.GetDimensions()[iDimension].m_cDivisions);
+         cValues *= aDimension1[iDimension].m_cDivisions + 1; // this can't overflow since we're counting existing allocated memory
+      }
+
+      FloatEbmType * pTo = &m_aValues[0];
+      const FloatEbmType * pFrom = &rhs.m_aValues[0];
+      const FloatEbmType * const pToEnd = &pTo[cValues];
+      do {
+         *pTo += *pFrom;
+         ++pTo;
+         ++pFrom;
+      } while(pToEnd != pTo);
+
+      return false;
    }
 
-   if(rhs.m_bExpanded) {
+   if(m_bExpanded || rhs.m_bExpanded) {
       // TODO: the existing code below works, but handle this differently (we can do it more efficiently)
    }
 
@@ -485,17 +526,17 @@ bool SegmentedTensor::Add(const SegmentedTensor & rhs) {
    // first, get basic counts of how many divisions and values we'll have in our final result
    do {
       const size_t cDivisions1 = pDimensionFirst1->m_cDivisions;
-      ActiveDataType * p1Cur = pDimensionFirst1->m_aDivisions;
+      const ActiveDataType * p1Cur = GetDivisions(pDimensionFirst1);
       const size_t cDivisions2 = pDimensionFirst2->m_cDivisions;
-      ActiveDataType * p2Cur = pDimensionFirst2->m_aDivisions;
+      const ActiveDataType * p2Cur = rhs.GetDivisions(pDimensionFirst2);
 
       cValues1 *= cDivisions1 + 1; // this can't overflow since we're counting existing allocated memory
       cValues2 *= cDivisions2 + 1; // this can't overflow since we're counting existing allocated memory
 
-      ActiveDataType * const p1End = &p1Cur[cDivisions1];
-      ActiveDataType * const p2End = &p2Cur[cDivisions2];
+      const ActiveDataType * const p1End = &p1Cur[cDivisions1];
+      const ActiveDataType * const p2End = &p2Cur[cDivisions2];
 
-      pDimensionInfoStackFirst->m_pDivision1 = p1End;
+      // EnsureValueCapacity below can move our own divisions, so we set m_pDivision1 after calling it
       pDimensionInfoStackFirst->m_pDivision2 = p2End;
 
       size_t cNewSingleDimensionDivisions = 0;
@@ -550,6 +591,10 @@ bool SegmentedTensor::Add(const SegmentedTensor & rhs) {
    FloatEbmType * const aValues = m_aValues;
    const DimensionInfo * const aDimension1 = GetDimensions();
 
+   for(size_t iDimension = 0; iDimension < m_cDimensions; ++iDimension) {
+      dimensionStack[iDimension].m_pDivision1 = &GetDivisions(&aDimension1[iDimension])[aDimension1[iDimension].m_cDivisions];
+   }
+
    const FloatEbmType * pValue1 = &aValues[m_cVectorLength * cValues1]; // we're accessing allocated memory, so it can't overflow
    FloatEbmType * pValueTop = &aValues[m_cVectorLength * cNewValues]; // we're accessing allocated memory, so it can't overflow
 
@@ -588,8 +633,8 @@ bool SegmentedTensor::Add(const SegmentedTensor & rhs) {
          const ActiveDataType * const pDivision1 = pDimensionInfoStackSecond->m_pDivision1;
          const ActiveDataType * const pDivision2 = pDimensionInfoStackSecond->m_pDivision2;
 
-         ActiveDataType * const aDivisions1 = pDimensionSecond1->m_aDivisions;
-         ActiveDataType * const aDivisions2 = pDimensionSecond2->m_aDivisions;
+         const ActiveDataType * const aDivisions1 = GetDivisions(pDimensionSecond1);
+         const ActiveDataType * const aDivisions2 = rhs.GetDivisions(pDimensionSecond2);
 
          if(UNPREDICTABLE(aDivisions1 < pDivision1)) {
             if(UNPREDICTABLE(aDivisions2 < pDivision2)) {
@@ -660,40 +705,42 @@ bool SegmentedTensor::Add(const SegmentedTensor & rhs) {
       const size_t cOriginalDivisionsBeforeSetting = pDimension1Cur->m_cDivisions;
 
       // this will increase our capacity, if required.  It will also change m_cDivisions, so we get that before calling it.  
-      // SetCountDivisions might change m_aValuesAndDivisions, so we need to actually keep it here after getting m_cDivisions but 
+      // SetCountDivisions might move our buffer, so we need to actually keep it here after getting m_cDivisions but 
       // before set set all our pointers
       if(UNLIKELY(SetCountDivisions(iDimension, cNewDivisions))) {
          LOG_0(TraceLevelWarning, "WARNING Add SetCountDivisions(iDimension, cNewDivisions)");
          return true;
       }
+      ActiveDataType * const aDivisions1 = GetDivisions(pDimension1Cur);
+      const ActiveDataType * const aDivisions2 = rhs.GetDivisions(pDimension2Cur);
 
-      const ActiveDataType * p1Cur = &pDimension1Cur->m_aDivisions[cOriginalDivisionsBeforeSetting];
-      const ActiveDataType * p2Cur = &pDimension2Cur->m_aDivisions[pDimension2Cur->m_cDivisions];
-      ActiveDataType * pTopCur = &pDimension1Cur->m_aDivisions[cNewDivisions];
+      const ActiveDataType * p1Cur = &aDivisions1[cOriginalDivisionsBeforeSetting];
+      const ActiveDataType * p2Cur = &aDivisions2[pDimension2Cur->m_cDivisions];
+      ActiveDataType * pTopCur = &aDivisions1[cNewDivisions];
 
       // traverse in reverse so that we can put our results at the higher order indexes where we are guaranteed not to overwrite our existing values
       // which we still need to copy
       while(true) {
-         EBM_ASSERT(pDimension1Cur->m_aDivisions <= pTopCur);
-         EBM_ASSERT(pDimension1Cur->m_aDivisions <= p1Cur);
-         EBM_ASSERT(pDimension2Cur->m_aDivisions <= p2Cur);
+         EBM_ASSERT(aDivisions1 <= pTopCur);
+         EBM_ASSERT(aDivisions1 <= p1Cur);
+         EBM_ASSERT(aDivisions2 <= p2Cur);
          EBM_ASSERT(p1Cur <= pTopCur);
-         EBM_ASSERT(static_cast<size_t>(p2Cur - pDimension2Cur->m_aDivisions) <= static_cast<size_t>(pTopCur - pDimension1Cur->m_aDivisions));
+         EBM_ASSERT(static_cast<size_t>(p2Cur - aDivisions2) <= static_cast<size_t>(pTopCur - aDivisions1));
 
          if(UNLIKELY(pTopCur == p1Cur)) {
             // since we've finished the rhs divisions, our SegmentedRegion already has the right divisions in place, so all we need is to add the value
             // of the last region in rhs to our remaining values
             break;
          }
-         // pTopCur is an index above pDimension1Cur->m_aDivisions.  p2Cur is an index above pDimension2Cur->m_aDivisions.  We want to decide if they
+         // pTopCur is an index above aDivisions1.  p2Cur is an index above aDivisions2.  We want to decide if they
          // are at the same index above their respective arrays
-         if(UNLIKELY(static_cast<size_t>(pTopCur - pDimension1Cur->m_aDivisions) == static_cast<size_t>(p2Cur - pDimension2Cur->m_aDivisions))) {
-            EBM_ASSERT(pDimension1Cur->m_aDivisions < pTopCur);
+         if(UNLIKELY(static_cast<size_t>(pTopCur - aDivisions1) == static_cast<size_t>(p2Cur - aDivisions2))) {
+            EBM_ASSERT(aDivisions1 < pTopCur);
             // direct copy the remaining divisions.  There should be at least one
             memcpy(
-               pDimension1Cur->m_aDivisions,
-               pDimension2Cur->m_aDivisions,
-               static_cast<size_t>(pTopCur - pDimension1Cur->m_aDivisions) * sizeof(ActiveDataType)
+               aDivisions1,
+               aDivisions2,
+               static_cast<size_t>(pTopCur - aDivisions1) * sizeof(ActiveDataType)
             );
             break;
          }
@@ -743,8 +790,8 @@ bool SegmentedTensor::IsEqual(const SegmentedTensor & rhs) const {
          EBM_ASSERT(!IsMultiplyError(cValues, cDivisions + 1)); // we're accessing allocated memory, so it can't overflow
          cValues *= cDivisions + 1;
 
-         const ActiveDataType * pD1Cur = pDimension1->m_aDivisions;
-         const ActiveDataType * pD2Cur = pDimension2->m_aDivisions;
+         const ActiveDataType * pD1Cur = GetDivisions(pDimension1);
+         const ActiveDataType * pD2Cur = rhs.GetDivisions(pDimension2);
          const ActiveDataType * const pD1End = pD1Cur + cDivisions;
          do {
             if(UNLIKELY(*pD1Cur != *pD2Cur)) {
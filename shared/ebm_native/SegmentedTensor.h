@@ -13,10 +13,14 @@
 #include "EbmInternal.h" // INLINE_ALWAYS
 #include "Logging.h" // EBM_ASSERT & LOG
 
-// TODO: we need to radically change this data structure so that we can efficiently pass it between machines in a 
-// cluster AND within/between a GPU/CPU.  This stucture should be:
+// All the values and divisions of a SegmentedTensor live in a single buffer that starts with the values, followed by the 
+// divisions of each dimension in order.  Each section is sized by it's capacity, and the DimensionInfo items hold byte 
+// offsets into the buffer instead of pointers, so the buffer together with the DimensionInfo array can be copied 
+// between tensors, threads or processes with memcpy.  Growing a section moves everything above it upwards in place.
 //
-// IntEbmType m_cBytes; // our caller can fetch the memory size of this SegmentedTensor and memcpy it over the network
+// TODO: to pass this data structure between machines in a cluster or to a GPU we still need:
+//
+// IntEbmType m_cBytes; // at the top of the buffer so that our caller can memcpy it over the network
 //// The first thing our caller should do is call into the C++ to fix the endian nature of this struct
 //// 0x3333333333333333 non-expanded, big endian
 //// 0x2222222222222222 non-expanded, little endian
@@ -25,41 +29,22 @@
 //// if (m_endianAndExpanded < 0x2000000000000000) bExpanded = true;
 //// if (0 != (0x1 & m_endianAndExpanded)) bBigEndian = true;
 // UIntEbmType m_endianAndIsExpanded;
-// NO m_cValueCapacity -> we have a function that calculates the maximum capacity and we allocate it all at the start
 // NO m_cVectorLength -> we don't need to pass this arround from process to process since it's global info and can be passed to the individual functions
 // NO m_cDimensionsMax -> we pre-determine the maximum size and always allocate the max max size
 // NO m_cDimensions; -> we can pass in the FeatureGroup object to know the # of dimensions
-// FloatEbmType m_values[]; // a space for our values
-// UIntEbmType DIMENSION_1_CUT_POINTS
-// UIntEbmType DIMENSION_1_COUNT -> we find this by traversing the 0th dimension items
-// UIntEbmType DIMENSION_0_CUT_POINTS -> we travel backwards by the count
-// UIntEbmType DIMENSION_0_COUNT -> we find this using m_cBytes to find the end, then subtract sizeof(UIntEbmType)
 //
 // Reasons:
 //   - our super-parallel algorithm needs to split up the data and have separate processing cores process their data
 //     their outputs will be partial histograms. After a single cores does the tree buiding, that core will need to 
 //     push the model updates to all the children nodes
-//   - in an MPI environment, or a Spark cluster, or in a GPU, we'll need to pass this data structure between nodes, 
-//     so it will need to be memcopy-able, which means no pointers (use 64-bit offsets), and it means that the data 
-//     needs to be in a single contiguous byte array
 //   - we might want our external caller to allocate this memory, because perhaps we might want the MPI communication 
 //     layer or other network protocol to sit outside of C++, so we want to allocate the memory just once and we need 
 //     to be able to determine the memory size before allocating it.  We know ahead of time how many dimensions AND 
 //     the maximum split points in all dimensions, so it's possible to pre-determine this at startup.
-//   - our first data structure member is a count of the number of bytes, so any high level language can extract
-//     this without knowing our structure internals.  This helps our caller to use memcpy since they know the size
-//   - when two tensors are combined, we exectue the following steps:
-//     1) Determine the number of new cut points for each dimension.  Store that info on the stack (64 entries max)
-//     2) Determine the new value tensor size (with splits).  If that new tensor size PLUS the size of the cut point
-//        information is greater than a pure expanded tensor without cuts, then expand the tensor and merge and we're 
-//        done. If it's still more compact as a segmented tensor, then continue below.
-//     3) memcpy all the dimension cut information to the new end of our data space to give us room
-//     4) Expand and merge the values using the non-changed dimension info
-//     5) Expand the dimension into upwards starting from the Nth dimension at the top and working downwards
+//   - when two tensors are combined, if the new tensor size PLUS the size of the cut point information is greater than 
+//     a pure expanded tensor without cuts, then we should expand the tensor and merge
 //   - the maximum number of cuts is part of the feature_group definition, so we don't need to store that and pass 
-//     that reduntant information arround. We do store the current number of cuts because that changes.  This data 
-//     structure should therefore have a dependency on the feature_group definition since we'll need to read the 
-//     maximum number of cuts.  The pointer to the feature_group class can be passed in via the stack to any 
+//     that reduntant information arround. The pointer to the feature_group class can be passed in via the stack to any 
 //     function that needs that information
 //   - use 64 bit values for all offsets, since nobody will ever need more than 64 bits 
 //     (you need a non-trivial amount of mass even if you store one bit per atom) and we might pass these 
@@ -116,7 +101,8 @@ class SegmentedTensor final {
       void operator delete (void *) = delete; // we only use malloc/free in this library
 
       size_t m_cDivisions;
-      ActiveDataType * m_aDivisions;
+      // the offset in bytes from the start of m_aValues to our divisions
+      size_t m_iByteDivisions;
       size_t m_cDivisionCapacity;
    };
    static_assert(std::is_standard_layout<DimensionInfo>::value,
@@ -132,10 +118,13 @@ class SegmentedTensor final {
    static constexpr size_t k_initialDivisionCapacity = 1;
    static constexpr size_t k_initialValueCapacity = 2;
 
+   // the number of bytes allocated for m_aValues, which can be more than the sections use after a Copy
+   size_t m_cBytesBufferCapacity;
    size_t m_cValueCapacity;
    size_t m_cVectorLength;
    size_t m_cDimensionsMax;
    size_t m_cDimensions;
+   // the start of our buffer.  The values come first, so this is also our values array
    FloatEbmType * m_aValues;
    bool m_bExpanded;
    // use the "struct hack" since Flexible array member method is not available in C++
@@ -152,6 +141,25 @@ class SegmentedTensor final {
       return ArrayToPointer(m_aDimensions);
    }
 
+   INLINE_ALWAYS const ActiveDataType * GetDivisions(const DimensionInfo * const pDimension) const {
+      return reinterpret_cast<const ActiveDataType *>(reinterpret_cast<const char *>(m_aValues) + pDimension->m_iByteDivisions);
+   }
+   INLINE_ALWAYS ActiveDataType * GetDivisions(const DimensionInfo * const pDimension) {
+      return reinterpret_cast<ActiveDataType *>(reinterpret_cast<char *>(m_aValues) + pDimension->m_iByteDivisions);
+   }
+
+   // the number of bytes that the values and all the division sections occupy
+   INLINE_ALWAYS size_t GetCountBytesUsed() const {
+      if(0 == m_cDimensionsMax) {
+         return sizeof(FloatEbmType) * m_cValueCapacity;
+      }
+      const DimensionInfo * const pDimensionLast = &GetDimensions()[m_cDimensionsMax - 1];
+      return pDimensionLast->m_iByteDivisions + sizeof(ActiveDataType) * pDimensionLast->m_cDivisionCapacity;
+   }
+
+   // opens a gap of cBytesInsert bytes at iByteInsert by moving every section above it upwards.  Returns true on error
+   bool InsertBytes(const size_t iByteInsert, const size_t cBytesInsert);
+
 public:
 
    SegmentedTensor() = default; // preserve our POD status
@@ -159,19 +167,6 @@ public:
    void * operator new(std::size_t) = delete; // we only use malloc/free in this library
    void operator delete (void *) = delete; // we only use malloc/free in this library
 
-   // TODO: In the future we'll be splitting our work into small sets of residuals and logits owned by
-   // a node in a distributed system.  After each node calculates it's model update (represented by this
-   // SegmentedTensor class), we'll need to reduce them accross all nodes, before adding together all the
-   // SegmentedTensor classes and sending back a full update to the Nodes.  Since we'll be ferrying info
-   // back and forth, we'll want to keep it in a more compressed format keeping division and not expanding
-   // to a direct indexable tensor until after recieved by the nodes.  We'll NEED to keep the entire strucutre
-   // as a single continuous chunk of memory.  At the very start will be our regular struct (containing the
-   // full size of the data region at the top (64 bit since we don't know what processor we'll be on)
-   // We know the number of dimensions for an feature group at allocation, so we can put the values right below
-   // that.  When we find ourselves expanding dimensions, we can first figure out how much all the values and dimension
-   // need to grow and then we can directly move each dimension pointed to object without needing to move the full
-   // values array.
-
    static void Free(SegmentedTensor * const pSegmentedRegion);
    static SegmentedTensor * Allocate(const size_t cDimensionsMax, const size_t cVectorLength);
    void Reset();
@@ -204,15 +199,23 @@ public:
       m_cDimensions = cDimensions;
    }
 
+   INLINE_ALWAYS size_t GetCountDivisions(const size_t iDimension) const {
+      EBM_ASSERT(iDimension < m_cDimensions);
+      return GetDimensions()[iDimension].m_cDivisions;
+   }
+
+   // the division and value pointers stay valid until the next call that can grow the tensor
    INLINE_ALWAYS ActiveDataType * GetDivisionPointer(const size_t iDimension) {
       EBM_ASSERT(iDimension < m_cDimensions);
-      return GetDimensions()[iDimension].m_aDivisions;
+      return GetDivisions(&GetDimensions()[iDimension]);
    }
 
    INLINE_ALWAYS FloatEbmType * GetValuePointer() {
       return &m_aValues[0];
    }
 };
+static_assert(0 == sizeof(FloatEbmType) % alignof(ActiveDataType) && alignof(ActiveDataType) <= alignof(FloatEbmType),
+   "our divisions follow our values in the same buffer, so they need to stay aligned");
 static_assert(std::is_standard_layout<SegmentedTensor>::value,
    "We use the struct hack in several places, so disallow non-standard_layout types in general");
 static_assert(std::is_trivial<SegmentedTensor>::value,
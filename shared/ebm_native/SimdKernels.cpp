@@ -0,0 +1,326 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+// very independent includes
+#include "Logging.h" // EBM_ASSERT & LOG
+// FeatureGroup.h depends on FeatureInternal.h
+#include "FeatureGroup.h"
+// dataset depends on features
+#include "DataSetBoosting.h"
+
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#ifdef _MSC_VER
+#include <intrin.h> // __cpuid, __cpuidex, _xgetbv
+#endif // _MSC_VER
+
+// these are defined in their own translation units, which are compiled for their instruction set
+extern const SimdKernels g_simdKernelsSse42;
+extern const SimdKernels g_simdKernelsAvx2;
+extern const SimdKernels g_simdKernelsAvx512;
+
+// ordered from best to worst
+static const SimdKernels * const k_apSimdKernels[] = { &g_simdKernelsAvx512, &g_simdKernelsAvx2, &g_simdKernelsSse42 };
+
+static SimdInstructionSet DetectInstructionSet() {
+   // every CPU with AVX2 also has SSE4.2, and every CPU with AVX-512F also has AVX2, so we only need the best one
+#if defined(_MSC_VER) && !defined(__clang__)
+   int aRegisters[4]; // eax, ebx, ecx, edx
+   __cpuid(aRegisters, 0);
+   const int iFunctionMax = aRegisters[0];
+   if(iFunctionMax < 1) {
+      return SimdInstructionSet::None;
+   }
+   __cpuid(aRegisters, 1);
+   const bool bSse42 = 0 != (aRegisters[2] & (1 << 20));
+   if(!bSse42) {
+      return SimdInstructionSet::None;
+   }
+   // the OS needs to save the AVX registers (OSXSAVE), and the CPU needs to support AVX itself
+   constexpr int k_osxsaveAndAvx = (1 << 27) | (1 << 28);
+   if(iFunctionMax < 7 || k_osxsaveAndAvx != (aRegisters[2] & k_osxsaveAndAvx)) {
+      return SimdInstructionSet::Sse42;
+   }
+   const unsigned __int64 xcr0 = _xgetbv(0);
+   __cpuidex(aRegisters, 7, 0);
+   // AVX-512 requires the OS to save the opmask and upper zmm registers in addition to the AVX state
+   if(0xE6 == (xcr0 & 0xE6) && 0 != (aRegisters[1] & (1 << 16))) {
+      return SimdInstructionSet::Avx512;
+   }
+   if(0x6 == (xcr0 & 0x6) && 0 != (aRegisters[1] & (1 << 5))) {
+      return SimdInstructionSet::Avx2;
+   }
+   return SimdInstructionSet::Sse42;
+#else // defined(_MSC_VER) && !defined(__clang__)
+   // __builtin_cpu_supports also checks that the OS has enabled the registers
+   __builtin_cpu_init();
+   if(__builtin_cpu_supports("avx512f")) {
+      return SimdInstructionSet::Avx512;
+   }
+   if(__builtin_cpu_supports("avx2")) {
+      return SimdInstructionSet::Avx2;
+   }
+   if(__builtin_cpu_supports("sse4.2")) {
+      return SimdInstructionSet::Sse42;
+   }
+   return SimdInstructionSet::None;
+#endif // defined(_MSC_VER) && !defined(__clang__)
+}
+
+#elif defined(__aarch64__) || defined(_M_ARM64)
+
+extern const SimdKernels g_simdKernelsNeon;
+
+static const SimdKernels * const k_apSimdKernels[] = { &g_simdKernelsNeon };
+
+static SimdInstructionSet DetectInstructionSet() {
+   // NEON is mandatory on 64 bit ARM
+   return SimdInstructionSet::Neon;
+}
+
+#else // CPU architecture
+
+static const SimdKernels * const k_apSimdKernels[] = { nullptr };
+
+static SimdInstructionSet DetectInstructionSet() {
+   return SimdInstructionSet::None;
+}
+
+#endif // CPU architecture
+
+const SimdKernels * SimdKernels::GetBestAvailable(const SimdInstructionSet maxInstructionSet) {
+   // C++11 guarantees that this is initialized exactly once, even if there are multiple threads
+   static const SimdInstructionSet s_instructionSetCpu = DetectInstructionSet();
+
+   for(const SimdKernels * const pSimdKernels : k_apSimdKernels) {
+      if(nullptr != pSimdKernels && 
+         pSimdKernels->m_instructionSet <= s_instructionSetCpu && 
+         pSimdKernels->m_instructionSet <= maxInstructionSet
+      ) {
+         return pSimdKernels;
+      }
+   }
+   return nullptr;
+}
+
+// we look up the updates for this many samples at a time.  It's small enough that aUpdates stays in the L1 cache
+// and on the stack, and big enough that the call overhead of the kernels is negligible
+constexpr size_t k_cSimdBlockSamplesMax = 512;
+
+void SimdKernels::GatherUpdates(
+   const FeatureGroup * const pFeatureGroup,
+   const StorageDataType * const pInputData,
+   const size_t cSamples,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+) const {
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(cSamples <= k_cSimdBlockSamplesMax);
+
+   if(0 == pFeatureGroup->GetCountFeatures()) {
+      // with zero features there is only one bin
+      const FloatEbmType update = aModelFeatureGroupUpdateTensor[0];
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         aUpdatesOut[iSample] = update;
+      }
+      return;
+   }
+
+   const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+   EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+   EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cBitsForStorageType);
+   const size_t cBitsPerItemMax = GetCountBits(cItemsPerBitPackedDataUnit);
+   EBM_ASSERT(1 <= cBitsPerItemMax);
+   EBM_ASSERT(cBitsPerItemMax <= k_cBitsForStorageType);
+
+   (*m_pGatherUpdates)(cSamples, cItemsPerBitPackedDataUnit, cBitsPerItemMax, pInputData, 
+      aModelFeatureGroupUpdateTensor, aUpdatesOut);
+}
+
+// for every block after the first we need whole bit packed units, so that each block starts on a unit boundary
+INLINE_ALWAYS static size_t GetCountBlockSamples(const FeatureGroup * const pFeatureGroup) {
+   if(0 == pFeatureGroup->GetCountFeatures()) {
+      return k_cSimdBlockSamplesMax;
+   }
+   const size_t cItemsPerBitPackedDataUnit = pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+   EBM_ASSERT(cItemsPerBitPackedDataUnit <= k_cSimdBlockSamplesMax);
+   return k_cSimdBlockSamplesMax / cItemsPerBitPackedDataUnit * cItemsPerBitPackedDataUnit;
+}
+
+void SimdKernels::ApplyModelUpdateTraining(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const FeatureGroup * const pFeatureGroup,
+   DataSetByFeatureGroup * const pTrainingSet,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor
+) const {
+   EBM_ASSERT(IsSupported(runtimeLearningTypeOrCountTargetClasses));
+
+   const bool bRegression = IsRegression(runtimeLearningTypeOrCountTargetClasses);
+   const bool bZeroFeatures = 0 == pFeatureGroup->GetCountFeatures();
+   const size_t cSamples = pTrainingSet->GetCountSamples();
+   EBM_ASSERT(0 < cSamples);
+
+   const size_t cBlockSamplesMax = GetCountBlockSamples(pFeatureGroup);
+   const size_t cItemsPerBitPackedDataUnit = bZeroFeatures ? size_t { 1 } : pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+
+   const bool bFloat32 = pTrainingSet->IsFloat32();
+   FloatEbmType * const aResidualErrors = bFloat32 ? nullptr : pTrainingSet->GetResidualPointer();
+   float * const aResidualErrorsFloat = bFloat32 ? pTrainingSet->GetResidualPointer<float>() : nullptr;
+   const StorageDataType * const aTargets = bRegression ? nullptr : pTrainingSet->GetTargetDataPointer();
+   FloatEbmType * const aPredictorScores = bRegression || bFloat32 ? nullptr : pTrainingSet->GetPredictorScores();
+   float * const aPredictorScoresFloat = bRegression || !bFloat32 ? nullptr : pTrainingSet->GetPredictorScores<float>();
+   const StorageDataType * pInputData = bZeroFeatures ? nullptr : pTrainingSet->GetInputDataPointer(pFeatureGroup);
+
+   FloatEbmType aUpdates[k_cSimdBlockSamplesMax];
+   // the kernels only work on FloatEbmType, so float storage is widened into these one block at a time.  The block 
+   // stays in L1, so we still only read and write half the bytes from main memory
+   FloatEbmType aBlockResidualErrors[k_cSimdBlockSamplesMax];
+   FloatEbmType aBlockPredictorScores[k_cSimdBlockSamplesMax];
+   size_t iSample = 0;
+   do {
+      const size_t cRemaining = cSamples - iSample;
+      const size_t cBlockSamples = cRemaining < cBlockSamplesMax ? cRemaining : cBlockSamplesMax;
+      // with zero features every update is identical, so we only need to fill the buffer once
+      if(!bZeroFeatures || 0 == iSample) {
+         GatherUpdates(pFeatureGroup, pInputData, cBlockSamples, aModelFeatureGroupUpdateTensor, aUpdates);
+         pInputData += cBlockSamples / cItemsPerBitPackedDataUnit;
+      }
+      if(bFloat32) {
+         if(bRegression) {
+            for(size_t iBlockSample = 0; iBlockSample < cBlockSamples; ++iBlockSample) {
+               aBlockResidualErrors[iBlockSample] = static_cast<FloatEbmType>(aResidualErrorsFloat[iSample + iBlockSample]);
+            }
+            (*m_pTrainingRegression)(cBlockSamples, aUpdates, aBlockResidualErrors);
+         } else {
+            for(size_t iBlockSample = 0; iBlockSample < cBlockSamples; ++iBlockSample) {
+               aBlockPredictorScores[iBlockSample] = static_cast<FloatEbmType>(aPredictorScoresFloat[iSample + iBlockSample]);
+            }
+            (*m_pTrainingBinary)(cBlockSamples, aUpdates, &aTargets[iSample], aBlockPredictorScores, aBlockResidualErrors);
+            for(size_t iBlockSample = 0; iBlockSample < cBlockSamples; ++iBlockSample) {
+               aPredictorScoresFloat[iSample + iBlockSample] = static_cast<float>(aBlockPredictorScores[iBlockSample]);
+            }
+         }
+         for(size_t iBlockSample = 0; iBlockSample < cBlockSamples; ++iBlockSample) {
+            aResidualErrorsFloat[iSample + iBlockSample] = static_cast<float>(aBlockResidualErrors[iBlockSample]);
+         }
+      } else if(bRegression) {
+         (*m_pTrainingRegression)(cBlockSamples, aUpdates, &aResidualErrors[iSample]);
+      } else {
+         (*m_pTrainingBinary)(cBlockSamples, aUpdates, &aTargets[iSample], &aPredictorScores[iSample], &aResidualErrors[iSample]);
+      }
+      iSample += cBlockSamples;
+   } while(cSamples != iSample);
+}
+
+FloatEbmType SimdKernels::ApplyModelUpdateValidation(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const FeatureGroup * const pFeatureGroup,
+   DataSetByFeatureGroup * const pValidationSet,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor
+) const {
+   EBM_ASSERT(IsSupported(runtimeLearningTypeOrCountTargetClasses));
+
+   const bool bRegression = IsRegression(runtimeLearningTypeOrCountTargetClasses);
+   const bool bZeroFeatures = 0 == pFeatureGroup->GetCountFeatures();
+   const size_t cSamples = pValidationSet->GetCountSamples();
+   EBM_ASSERT(0 < cSamples);
+
+   const size_t cBlockSamplesMax = GetCountBlockSamples(pFeatureGroup);
+   const size_t cItemsPerBitPackedDataUnit = bZeroFeatures ? size_t { 1 } : pFeatureGroup->GetCountItemsPerBitPackedDataUnit();
+
+   FloatEbmType * const aResidualErrors = bRegression ? pValidationSet->GetResidualPointer() : nullptr;
+   const StorageDataType * const aTargets = bRegression ? nullptr : pValidationSet->GetTargetDataPointer();
+   FloatEbmType * const aPredictorScores = bRegression ? nullptr : pValidationSet->GetPredictorScores();
+   const StorageDataType * pInputData = bZeroFeatures ? nullptr : pValidationSet->GetInputDataPointer(pFeatureGroup);
+
+   FloatEbmType aUpdates[k_cSimdBlockSamplesMax];
+   FloatEbmType sumMetric = FloatEbmType { 0 };
+   size_t iSample = 0;
+   do {
+      const size_t cRemaining = cSamples - iSample;
+      const size_t cBlockSamples = cRemaining < cBlockSamplesMax ? cRemaining : cBlockSamplesMax;
+      // with zero features every update is identical, so we only need to fill the buffer once
+      if(!bZeroFeatures || 0 == iSample) {
+         GatherUpdates(pFeatureGroup, pInputData, cBlockSamples, aModelFeatureGroupUpdateTensor, aUpdates);
+         pInputData += cBlockSamples / cItemsPerBitPackedDataUnit;
+      }
+      if(bRegression) {
+         sumMetric += (*m_pValidationRegression)(cBlockSamples, aUpdates, &aResidualErrors[iSample]);
+      } else {
+         sumMetric += (*m_pValidationBinary)(cBlockSamples, aUpdates, &aTargets[iSample], &aPredictorScores[iSample]);
+      }
+      iSample += cBlockSamples;
+   } while(cSamples != iSample);
+
+   return sumMetric / static_cast<FloatEbmType>(cSamples);
+}
+
+// 1023 cuts fit into an 8KB tree which we keep on the stack.  Bigger trees go on the heap
+constexpr size_t k_cSimdDiscretizeStackNodes = 1024;
+
+bool SimdKernels::Discretize(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const FloatEbmType * const aBinCutsLowerBoundInclusive,
+   IntEbmType * const aDiscretizedOut
+) const {
+   EBM_ASSERT(0 < cSamples);
+   EBM_ASSERT(1 <= cBinCuts);
+
+   if(UNLIKELY(std::numeric_limits<size_t>::max() / 2 < cBinCuts)) {
+      // cPower would overflow
+      return true;
+   }
+   size_t cPower = 2;
+   while(cPower <= cBinCuts) {
+      cPower <<= 1;
+   }
+
+   FloatEbmType aEytzingerStack[k_cSimdDiscretizeStackNodes];
+   FloatEbmType * aEytzinger = aEytzingerStack;
+   if(k_cSimdDiscretizeStackNodes < cPower) {
+      aEytzinger = EbmMalloc<FloatEbmType>(cPower);
+      if(UNLIKELY(nullptr == aEytzinger)) {
+         LOG_0(TraceLevelWarning, "WARNING SimdKernels::Discretize nullptr == aEytzinger");
+         return true;
+      }
+   }
+
+   // conceptually the sorted cuts are padded at the front with cSkip -infinity values up to cPower - 1 cuts.  Node k
+   // at depth t (2^t <= k < 2^(t+1)) holds padded cut ((k - 2^t) * 2 + 1) * (cPower >> (t + 1)) - 1, which is the
+   // same cut that the breadth first walk of our binary search would compare against
+   const size_t cSkip = cPower - 1 - cBinCuts;
+   aEytzinger[0] = -std::numeric_limits<FloatEbmType>::infinity();
+   size_t iNodeLevelStart = 1;
+   size_t cSpacing = cPower >> 1;
+   do {
+      const size_t iNodeLevelEnd = iNodeLevelStart << 1;
+      size_t iPadded = cSpacing - 1;
+      for(size_t iNode = iNodeLevelStart; iNode < iNodeLevelEnd; ++iNode) {
+         aEytzinger[iNode] = iPadded < cSkip ? -std::numeric_limits<FloatEbmType>::infinity() :
+            aBinCutsLowerBoundInclusive[iPadded - cSkip];
+         iPadded += cSpacing << 1;
+      }
+      iNodeLevelStart = iNodeLevelEnd;
+      cSpacing >>= 1;
+   } while(0 != cSpacing);
+   EBM_ASSERT(cPower == iNodeLevelStart);
+
+   (*m_pDiscretize)(cSamples, aFeatureValues, cBinCuts, cPower, aEytzinger, aDiscretizedOut);
+
+   if(aEytzingerStack != aEytzinger) {
+      free(aEytzinger);
+   }
+   return false;
+}
@@ -0,0 +1,178 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <inttypes.h> // uint32_t
+
+#include "ebm_native.h" // FloatEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS, StorageDataType
+#include "Logging.h" // EBM_ASSERT & LOG
+
+class FeatureGroup;
+class DataSetByFeatureGroup;
+struct RandomLanes;
+
+// the SIMD kernels work on contiguous blocks of samples where aUpdates holds the already looked up model update for
+// each sample.  The GatherUpdates kernel fills aUpdates by unpacking the bit packed tensor indexes and gathering the
+// update that each one refers to.  The kernels that return a value return the sum of the per-sample metric (log loss 
+// or squared error) for the block.
+
+typedef void (* SIMD_TRAINING_BINARY_FUNCTION)(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aResidualErrors
+);
+typedef FloatEbmType (* SIMD_VALIDATION_BINARY_FUNCTION)(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores
+);
+typedef void (* SIMD_TRAINING_REGRESSION_FUNCTION)(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+);
+typedef FloatEbmType (* SIMD_VALIDATION_REGRESSION_FUNCTION)(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+);
+// aEytzinger holds the cuts padded up to cPower - 1 with leading -infinity values, laid out breadth first as an
+// implicit binary tree (Eytzinger order) where node k has children 2k and 2k + 1.  Node 0 is unused.  The top levels
+// of the tree share cache lines, and every lane does the same number of branchless steps
+typedef void (* SIMD_DISCRETIZE_FUNCTION)(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const size_t cPower,
+   const FloatEbmType * const aEytzinger,
+   IntEbmType * const aDiscretizedOut
+);
+// advances each of the k_cRandomLanes streams in pLanes cRounds times and writes the raw 32 bit numbers round by
+// round, so that aOut[iRound * k_cRandomLanes + iLane] comes from lane iLane.  The lanes need 64 bit integer
+// multiplies, which we build out of 32 x 32 -> 64 bit multiplies since only AVX-512DQ has a 64 bit one
+typedef void (* SIMD_FILL_RANDOM_FUNCTION)(
+   const size_t cRounds,
+   RandomLanes * const pLanes,
+   uint32_t * const aOut
+);
+
+// decodes cSamples tensor indexes from aInputData, which starts at a data unit boundary, and writes the tensor value
+// that each refers to into aUpdatesOut.  The bits above the last item in each data unit need to be zero, which is
+// how DataSetByFeatureGroup packs them
+typedef void (* SIMD_GATHER_UPDATES_FUNCTION)(
+   const size_t cSamples,
+   const size_t cItemsPerBitPackedDataUnit,
+   const size_t cBitsPerItemMax,
+   const StorageDataType * const aInputData,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+);
+
+// replaces each of the cItems counts in aCountsInScoresOut with aSums[i] / count * aSums[i], which is the node 
+// splitting score of ComputeNodeSplittingScore.  Division and multiplication are exact per lane, so the scores are
+// identical to the scalar ones on every instruction set
+typedef void (* SIMD_NODE_SPLITTING_SCORES_FUNCTION)(
+   const size_t cItems,
+   const FloatEbmType * const aSums,
+   FloatEbmType * const aCountsInScoresOut
+);
+
+// ordered from least to most capable so that callers can cap the instruction set that we pick.  NEON only exists
+// on ARM and the others only on x86, so their relative order only matters for capping
+enum class SimdInstructionSet {
+   None = 0,
+   Sse42 = 1,
+   Neon = 2,
+   Avx2 = 3,
+   Avx512 = 4
+};
+
+class SimdKernels final {
+   // Each instruction set has one constant instance of this class which is defined in it's own translation unit
+   // (SimdKernelsSse42.cpp, SimdKernelsAvx2.cpp, SimdKernelsAvx512.cpp, SimdKernelsNeon.cpp).  The x86 translation
+   // units are compiled for their instruction set via target pragmas, so the rest of the library stays compatible
+   // with our baseline architecture and we pick the best kernels for the CPU at runtime.  NEON is part of the
+   // baseline on 64 bit ARM, so it's always available there.
+   //
+   // Discretize only compares values, FillRandom only does integer math and NodeSplittingScores only does exact per 
+   // lane arithmetic, so they return identical results on every instruction set.  We use the first two by default.  The model update kernels are opt-in for the reasons below.
+   //
+   // The vectorized exp and log are polynomial approximations, so results differ in the last few bits from the
+   // scalar code which uses std::exp and std::log unless it was compiled with FAST_EXP and FAST_LOG (see EbmExp in
+   // EbmInternal.h).  Every instruction set uses the same per-lane operations without
+   // fused multiply-add, so the per-sample values are identical between instruction sets, but sums are accumulated
+   // in a different order.
+
+   void GatherUpdates(
+      const FeatureGroup * const pFeatureGroup,
+      const StorageDataType * const pInputData,
+      const size_t cSamples,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      FloatEbmType * const aUpdatesOut
+   ) const;
+
+public:
+
+   SimdInstructionSet m_instructionSet;
+   SIMD_TRAINING_BINARY_FUNCTION m_pTrainingBinary;
+   SIMD_VALIDATION_BINARY_FUNCTION m_pValidationBinary;
+   SIMD_TRAINING_REGRESSION_FUNCTION m_pTrainingRegression;
+   SIMD_VALIDATION_REGRESSION_FUNCTION m_pValidationRegression;
+   SIMD_DISCRETIZE_FUNCTION m_pDiscretize;
+   SIMD_FILL_RANDOM_FUNCTION m_pFillRandom;
+   SIMD_GATHER_UPDATES_FUNCTION m_pGatherUpdates;
+   SIMD_NODE_SPLITTING_SCORES_FUNCTION m_pNodeSplittingScores;
+
+   // returns the kernels for the most capable instruction set that both the CPU and maxInstructionSet allow, or
+   // nullptr if there are none.  The CPU is only inspected on the first call
+   static const SimdKernels * GetBestAvailable(const SimdInstructionSet maxInstructionSet);
+
+   // we only have kernels for targets with a single logit (regression and binary classification)
+   INLINE_ALWAYS static bool IsSupported(const ptrdiff_t runtimeLearningTypeOrCountTargetClasses) {
+#ifdef EXPAND_BINARY_LOGITS
+      return IsRegression(runtimeLearningTypeOrCountTargetClasses);
+#else // EXPAND_BINARY_LOGITS
+      return IsRegression(runtimeLearningTypeOrCountTargetClasses) || ptrdiff_t { 2 } == runtimeLearningTypeOrCountTargetClasses;
+#endif // EXPAND_BINARY_LOGITS
+   }
+
+   // these are the vectorized equivalents of ApplyModelUpdateTraining and ApplyModelUpdateValidation
+   void ApplyModelUpdateTraining(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const FeatureGroup * const pFeatureGroup,
+      DataSetByFeatureGroup * const pTrainingSet,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) const;
+   FloatEbmType ApplyModelUpdateValidation(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const FeatureGroup * const pFeatureGroup,
+      DataSetByFeatureGroup * const pValidationSet,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor
+   ) const;
+
+   // the vectorized equivalent of our binary search in Discretize.  Returns true if we could not allocate memory for
+   // the search tree, in which case the caller needs to fall back to the scalar search
+   bool Discretize(
+      const size_t cSamples,
+      const FloatEbmType * const aFeatureValues,
+      const size_t cBinCuts,
+      const FloatEbmType * const aBinCutsLowerBoundInclusive,
+      IntEbmType * const aDiscretizedOut
+   ) const;
+};
+static_assert(std::is_standard_layout<SimdKernels>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<SimdKernels>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<SimdKernels>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,262 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+// very independent includes
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+// Everything after this point is compiled for AVX2.  None of it can be called unless GetBestAvailable has verified
+// that the CPU supports AVX2.  MSVC allows intrinsics from any instruction set without extra flags.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "SimdKernelsInternal.h"
+
+static_assert(std::is_same<FloatEbmType, double>::value, "our AVX2 kernels work on doubles");
+static_assert(8 == sizeof(StorageDataType) || 4 == sizeof(StorageDataType), "unexpected StorageDataType size");
+static_assert(8 == sizeof(IntEbmType), "we store 64 bit indexes into IntEbmType");
+
+class Avx2Double final {
+public:
+
+   typedef __m256d Vector;
+   typedef __m256d Mask;
+   typedef __m256i Index;
+
+   static constexpr size_t k_cLanes = 4;
+
+   Avx2Double() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static Vector Load(const FloatEbmType * const a) {
+      return _mm256_loadu_pd(a);
+   }
+   INLINE_ALWAYS static void Store(FloatEbmType * const a, const Vector val) {
+      _mm256_storeu_pd(a, val);
+   }
+   INLINE_ALWAYS static Vector Set(const FloatEbmType val) {
+      return _mm256_set1_pd(val);
+   }
+   INLINE_ALWAYS static Vector Add(const Vector val1, const Vector val2) {
+      return _mm256_add_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Sub(const Vector val1, const Vector val2) {
+      return _mm256_sub_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Mul(const Vector val1, const Vector val2) {
+      return _mm256_mul_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Div(const Vector val1, const Vector val2) {
+      return _mm256_div_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Min(const Vector val1, const Vector val2) {
+      return _mm256_min_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Max(const Vector val1, const Vector val2) {
+      return _mm256_max_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Floor(const Vector val) {
+      return _mm256_round_pd(val, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+   }
+   INLINE_ALWAYS static Vector Select(const Mask mask, const Vector valTrue, const Vector valFalse) {
+      return _mm256_blendv_pd(valFalse, valTrue, mask);
+   }
+   INLINE_ALWAYS static Mask LessThan(const Vector val1, const Vector val2) {
+      return _mm256_cmp_pd(val1, val2, _CMP_LT_OQ);
+   }
+   INLINE_ALWAYS static Mask GreaterThan(const Vector val1, const Vector val2) {
+      return _mm256_cmp_pd(val1, val2, _CMP_GT_OQ);
+   }
+   INLINE_ALWAYS static Mask LessEqual(const Vector val1, const Vector val2) {
+      return _mm256_cmp_pd(val1, val2, _CMP_LE_OQ);
+   }
+   INLINE_ALWAYS static Mask Equal(const Vector val1, const Vector val2) {
+      return _mm256_cmp_pd(val1, val2, _CMP_EQ_OQ);
+   }
+   INLINE_ALWAYS static Mask IsNaN(const Vector val) {
+      return _mm256_cmp_pd(val, val, _CMP_UNORD_Q);
+   }
+   INLINE_ALWAYS static Mask Or(const Mask mask1, const Mask mask2) {
+      return _mm256_or_pd(mask1, mask2);
+   }
+   INLINE_ALWAYS static Vector Pow2(const Vector n) {
+      // n holds integers in [-1022, 1023].  Adding 2^52 + 1023 puts the biased exponent into the low mantissa bits
+      const __m256i bits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(FloatEbmType { 4503599627371519.0 })));
+      return _mm256_castsi256_pd(_mm256_slli_epi64(bits, 52));
+   }
+   INLINE_ALWAYS static Vector Frexp(const Vector val, Vector * const pExponentOut) {
+      const __m256i bits = _mm256_castpd_si256(val);
+      // convert the biased exponent to a double by placing it into the mantissa of 2^52
+      const __m256i exponentBits = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+         _mm256_castpd_si256(_mm256_set1_pd(FloatEbmType { 4503599627370496.0 })));
+      *pExponentOut = _mm256_sub_pd(_mm256_castsi256_pd(exponentBits), _mm256_set1_pd(FloatEbmType { 4503599627371518.0 }));
+      const __m256i mantissaBits = _mm256_or_si256(
+         _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+         _mm256_set1_epi64x(0x3FE0000000000000LL)
+      );
+      return _mm256_castsi256_pd(mantissaBits);
+   }
+   INLINE_ALWAYS static Mask IsTargetZero(const StorageDataType * const a) {
+      __m256i targets;
+      if(8 == sizeof(StorageDataType)) {
+         targets = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+      } else {
+         targets = _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(a)));
+      }
+      return _mm256_castsi256_pd(_mm256_cmpeq_epi64(targets, _mm256_setzero_si256()));
+   }
+   INLINE_ALWAYS static FloatEbmType Sum(const Vector val) {
+      // sum in lane order so that our results don't depend on how the compiler arranges a horizontal add
+      FloatEbmType a[k_cLanes];
+      Store(a, val);
+      return a[0] + a[1] + a[2] + a[3];
+   }
+   INLINE_ALWAYS static Index SetIndex(const size_t val) {
+      return _mm256_set1_epi64x(static_cast<long long>(val));
+   }
+   INLINE_ALWAYS static Index AddIndex(const Index index1, const Index index2) {
+      return _mm256_add_epi64(index1, index2);
+   }
+   INLINE_ALWAYS static Index AddIndexMasked(const Index index, const Mask mask, const size_t val) {
+      return _mm256_add_epi64(index, _mm256_and_si256(_mm256_castpd_si256(mask), SetIndex(val)));
+   }
+   INLINE_ALWAYS static Index SubIndex(const Index index, const size_t val) {
+      return _mm256_sub_epi64(index, SetIndex(val));
+   }
+   INLINE_ALWAYS static Index SelectIndex(const Mask mask, const Index indexTrue, const Index indexFalse) {
+      return _mm256_castpd_si256(_mm256_blendv_pd(_mm256_castsi256_pd(indexFalse), _mm256_castsi256_pd(indexTrue), mask));
+   }
+   INLINE_ALWAYS static Vector Gather(const FloatEbmType * const a, const Index index) {
+      // the unmasked gather passes an undefined source to it's builtin, which makes GCC warn inside it's own headers
+      const __m256d zero = _mm256_setzero_pd();
+      return _mm256_mask_i64gather_pd(zero, a, index, _mm256_cmp_pd(zero, zero, _CMP_EQ_OQ), 8);
+   }
+   INLINE_ALWAYS static void StoreIndex(IntEbmType * const a, const Index index) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), index);
+   }
+   INLINE_ALWAYS static Index LoadIndexUnsigned(const uint64_t * const a) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+   }
+   INLINE_ALWAYS static void StoreIndexUnsigned(uint64_t * const a, const Index index) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), index);
+   }
+   INLINE_ALWAYS static Index SquareIndex(const Index index) {
+      // (hi * 2^32 + lo)^2 mod 2^64 is lo * lo + (lo * hi) * 2^33
+      const __m256i cross = _mm256_mul_epu32(index, _mm256_srli_epi64(index, 32));
+      return _mm256_add_epi64(_mm256_mul_epu32(index, index), _mm256_slli_epi64(cross, 33));
+   }
+   INLINE_ALWAYS static Index SwapHalvesIndex(const Index index) {
+      return _mm256_shuffle_epi32(index, 0xB1);
+   }
+   INLINE_ALWAYS static Index AndIndex(const Index index1, const Index index2) {
+      return _mm256_and_si256(index1, index2);
+   }
+   INLINE_ALWAYS static Index ShiftRightIndex(const Index index, const Index shifts) {
+      return _mm256_srlv_epi64(index, shifts);
+   }
+   INLINE_ALWAYS static void StoreIndexLow32(uint32_t * const a, const Index index) {
+      const __m256i packed = _mm256_permutevar8x32_epi32(index, _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(a), _mm256_castsi256_si128(packed));
+   }
+};
+
+static void TrainingBinaryAvx2(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Avx2Double>::TrainingBinary(cSamples, aUpdates, aTargets, aPredictorScores, aResidualErrors);
+}
+
+static FloatEbmType ValidationBinaryAvx2(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores
+) {
+   return SimdFunctions<Avx2Double>::ValidationBinary(cSamples, aUpdates, aTargets, aPredictorScores);
+}
+
+static void TrainingRegressionAvx2(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Avx2Double>::TrainingRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static FloatEbmType ValidationRegressionAvx2(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   return SimdFunctions<Avx2Double>::ValidationRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static void DiscretizeAvx2(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const size_t cPower,
+   const FloatEbmType * const aEytzinger,
+   IntEbmType * const aDiscretizedOut
+) {
+   SimdFunctions<Avx2Double>::Discretize(cSamples, aFeatureValues, cBinCuts, cPower, aEytzinger, aDiscretizedOut);
+}
+
+static void GatherUpdatesAvx2(
+   const size_t cSamples,
+   const size_t cItemsPerBitPackedDataUnit,
+   const size_t cBitsPerItemMax,
+   const StorageDataType * const aInputData,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+) {
+   SimdFunctions<Avx2Double>::GatherUpdates(cSamples, cItemsPerBitPackedDataUnit, cBitsPerItemMax, aInputData, 
+      aModelFeatureGroupUpdateTensor, aUpdatesOut);
+}
+
+static void FillRandomAvx2(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+   SimdFunctions<Avx2Double>::FillRandom(cRounds, pLanes, aOut);
+}
+
+static void NodeSplittingScoresAvx2(const size_t cItems, const FloatEbmType * const aSums, FloatEbmType * const aCountsInScoresOut) {
+   SimdFunctions<Avx2Double>::NodeSplittingScores(cItems, aSums, aCountsInScoresOut);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+extern const SimdKernels g_simdKernelsAvx2 = {
+   SimdInstructionSet::Avx2,
+   &TrainingBinaryAvx2,
+   &ValidationBinaryAvx2,
+   &TrainingRegressionAvx2,
+   &ValidationRegressionAvx2,
+   &DiscretizeAvx2,
+   &FillRandomAvx2,
+   &GatherUpdatesAvx2,
+   &NodeSplittingScoresAvx2
+};
+
+#endif // defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
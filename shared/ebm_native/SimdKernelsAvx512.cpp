@@ -0,0 +1,264 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+// very independent includes
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+// Everything after this point is compiled for AVX-512F.  None of it can be called unless GetBestAvailable has verified
+// that the CPU supports AVX-512F.  MSVC allows intrinsics from any instruction set without extra flags.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+#include "SimdKernelsInternal.h"
+
+static_assert(std::is_same<FloatEbmType, double>::value, "our AVX-512 kernels work on doubles");
+static_assert(8 == sizeof(StorageDataType) || 4 == sizeof(StorageDataType), "unexpected StorageDataType size");
+static_assert(8 == sizeof(IntEbmType), "we store 64 bit indexes into IntEbmType");
+
+// the unmasked versions of some intrinsics pass _mm512_undefined_pd to their builtin, which makes GCC warn about
+// uninitialized variables inside it's own headers.  Zero masking with every lane selected generates the same instruction
+constexpr __mmask8 k_maskAll = static_cast<__mmask8>(0xFF);
+
+class Avx512Double final {
+public:
+
+   typedef __m512d Vector;
+   typedef __mmask8 Mask;
+   typedef __m512i Index;
+
+   static constexpr size_t k_cLanes = 8;
+
+   Avx512Double() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static Vector Load(const FloatEbmType * const a) {
+      return _mm512_loadu_pd(a);
+   }
+   INLINE_ALWAYS static void Store(FloatEbmType * const a, const Vector val) {
+      _mm512_storeu_pd(a, val);
+   }
+   INLINE_ALWAYS static Vector Set(const FloatEbmType val) {
+      return _mm512_set1_pd(val);
+   }
+   INLINE_ALWAYS static Vector Add(const Vector val1, const Vector val2) {
+      return _mm512_add_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Sub(const Vector val1, const Vector val2) {
+      return _mm512_sub_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Mul(const Vector val1, const Vector val2) {
+      return _mm512_mul_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Div(const Vector val1, const Vector val2) {
+      return _mm512_div_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Min(const Vector val1, const Vector val2) {
+      return _mm512_maskz_min_pd(k_maskAll, val1, val2);
+   }
+   INLINE_ALWAYS static Vector Max(const Vector val1, const Vector val2) {
+      return _mm512_maskz_max_pd(k_maskAll, val1, val2);
+   }
+   INLINE_ALWAYS static Vector Floor(const Vector val) {
+      return _mm512_maskz_roundscale_pd(k_maskAll, val, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+   }
+   INLINE_ALWAYS static Vector Select(const Mask mask, const Vector valTrue, const Vector valFalse) {
+      return _mm512_mask_blend_pd(mask, valFalse, valTrue);
+   }
+   INLINE_ALWAYS static Mask LessThan(const Vector val1, const Vector val2) {
+      return _mm512_cmp_pd_mask(val1, val2, _CMP_LT_OQ);
+   }
+   INLINE_ALWAYS static Mask GreaterThan(const Vector val1, const Vector val2) {
+      return _mm512_cmp_pd_mask(val1, val2, _CMP_GT_OQ);
+   }
+   INLINE_ALWAYS static Mask LessEqual(const Vector val1, const Vector val2) {
+      return _mm512_cmp_pd_mask(val1, val2, _CMP_LE_OQ);
+   }
+   INLINE_ALWAYS static Mask Equal(const Vector val1, const Vector val2) {
+      return _mm512_cmp_pd_mask(val1, val2, _CMP_EQ_OQ);
+   }
+   INLINE_ALWAYS static Mask IsNaN(const Vector val) {
+      return _mm512_cmp_pd_mask(val, val, _CMP_UNORD_Q);
+   }
+   INLINE_ALWAYS static Mask Or(const Mask mask1, const Mask mask2) {
+      // the mask OR intrinsics for 8 bit masks require AVX-512DQ, so OR them as integers
+      return static_cast<Mask>(mask1 | mask2);
+   }
+   INLINE_ALWAYS static Vector Pow2(const Vector n) {
+      // n holds integers in [-1022, 1023].  Adding 2^52 + 1023 puts the biased exponent into the low mantissa bits
+      const __m512i bits = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(FloatEbmType { 4503599627371519.0 })));
+      return _mm512_castsi512_pd(_mm512_maskz_slli_epi64(k_maskAll, bits, 52));
+   }
+   INLINE_ALWAYS static Vector Frexp(const Vector val, Vector * const pExponentOut) {
+      const __m512i bits = _mm512_castpd_si512(val);
+      // convert the biased exponent to a double by placing it into the mantissa of 2^52
+      const __m512i exponentBits = _mm512_or_si512(_mm512_maskz_srli_epi64(k_maskAll, bits, 52),
+         _mm512_castpd_si512(_mm512_set1_pd(FloatEbmType { 4503599627370496.0 })));
+      *pExponentOut = _mm512_sub_pd(_mm512_castsi512_pd(exponentBits), _mm512_set1_pd(FloatEbmType { 4503599627371518.0 }));
+      const __m512i mantissaBits = _mm512_or_si512(
+         _mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)),
+         _mm512_set1_epi64(0x3FE0000000000000LL)
+      );
+      return _mm512_castsi512_pd(mantissaBits);
+   }
+   INLINE_ALWAYS static Mask IsTargetZero(const StorageDataType * const a) {
+      __m512i targets;
+      if(8 == sizeof(StorageDataType)) {
+         targets = _mm512_loadu_si512(a);
+      } else {
+         targets = _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(a)));
+      }
+      return _mm512_cmpeq_epi64_mask(targets, _mm512_setzero_si512());
+   }
+   INLINE_ALWAYS static FloatEbmType Sum(const Vector val) {
+      // sum in lane order so that our results don't depend on how the compiler arranges a horizontal add
+      FloatEbmType a[k_cLanes];
+      Store(a, val);
+      return a[0] + a[1] + a[2] + a[3] + a[4] + a[5] + a[6] + a[7];
+   }
+   INLINE_ALWAYS static Index SetIndex(const size_t val) {
+      return _mm512_set1_epi64(static_cast<long long>(val));
+   }
+   INLINE_ALWAYS static Index AddIndex(const Index index1, const Index index2) {
+      return _mm512_add_epi64(index1, index2);
+   }
+   INLINE_ALWAYS static Index AddIndexMasked(const Index index, const Mask mask, const size_t val) {
+      return _mm512_mask_add_epi64(index, mask, index, SetIndex(val));
+   }
+   INLINE_ALWAYS static Index SubIndex(const Index index, const size_t val) {
+      return _mm512_sub_epi64(index, SetIndex(val));
+   }
+   INLINE_ALWAYS static Index SelectIndex(const Mask mask, const Index indexTrue, const Index indexFalse) {
+      return _mm512_mask_blend_epi64(mask, indexFalse, indexTrue);
+   }
+   INLINE_ALWAYS static Vector Gather(const FloatEbmType * const a, const Index index) {
+      return _mm512_mask_i64gather_pd(_mm512_setzero_pd(), k_maskAll, index, a, 8);
+   }
+   INLINE_ALWAYS static void StoreIndex(IntEbmType * const a, const Index index) {
+      _mm512_storeu_si512(a, index);
+   }
+   INLINE_ALWAYS static Index LoadIndexUnsigned(const uint64_t * const a) {
+      return _mm512_loadu_si512(a);
+   }
+   INLINE_ALWAYS static void StoreIndexUnsigned(uint64_t * const a, const Index index) {
+      _mm512_storeu_si512(a, index);
+   }
+   INLINE_ALWAYS static Index SquareIndex(const Index index) {
+      // _mm512_mullo_epi64 needs AVX-512DQ, so we use the same decomposition as SSE4.2 and AVX2
+      const __m512i cross = _mm512_maskz_mul_epu32(k_maskAll, index, _mm512_maskz_srli_epi64(k_maskAll, index, 32));
+      return _mm512_add_epi64(_mm512_maskz_mul_epu32(k_maskAll, index, index), _mm512_maskz_slli_epi64(k_maskAll, cross, 33));
+   }
+   INLINE_ALWAYS static Index SwapHalvesIndex(const Index index) {
+      return _mm512_maskz_shuffle_epi32(static_cast<__mmask16>(0xFFFF), index, _MM_PERM_CDAB);
+   }
+   INLINE_ALWAYS static Index AndIndex(const Index index1, const Index index2) {
+      return _mm512_maskz_and_epi64(k_maskAll, index1, index2);
+   }
+   INLINE_ALWAYS static Index ShiftRightIndex(const Index index, const Index shifts) {
+      return _mm512_maskz_srlv_epi64(k_maskAll, index, shifts);
+   }
+   INLINE_ALWAYS static void StoreIndexLow32(uint32_t * const a, const Index index) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(a), _mm512_maskz_cvtepi64_epi32(k_maskAll, index));
+   }
+};
+
+static void TrainingBinaryAvx512(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Avx512Double>::TrainingBinary(cSamples, aUpdates, aTargets, aPredictorScores, aResidualErrors);
+}
+
+static FloatEbmType ValidationBinaryAvx512(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores
+) {
+   return SimdFunctions<Avx512Double>::ValidationBinary(cSamples, aUpdates, aTargets, aPredictorScores);
+}
+
+static void TrainingRegressionAvx512(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Avx512Double>::TrainingRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static FloatEbmType ValidationRegressionAvx512(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   return SimdFunctions<Avx512Double>::ValidationRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static void DiscretizeAvx512(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const size_t cPower,
+   const FloatEbmType * const aEytzinger,
+   IntEbmType * const aDiscretizedOut
+) {
+   SimdFunctions<Avx512Double>::Discretize(cSamples, aFeatureValues, cBinCuts, cPower, aEytzinger, aDiscretizedOut);
+}
+
+static void GatherUpdatesAvx512(
+   const size_t cSamples,
+   const size_t cItemsPerBitPackedDataUnit,
+   const size_t cBitsPerItemMax,
+   const StorageDataType * const aInputData,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+) {
+   SimdFunctions<Avx512Double>::GatherUpdates(cSamples, cItemsPerBitPackedDataUnit, cBitsPerItemMax, aInputData, 
+      aModelFeatureGroupUpdateTensor, aUpdatesOut);
+}
+
+static void FillRandomAvx512(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+   SimdFunctions<Avx512Double>::FillRandom(cRounds, pLanes, aOut);
+}
+
+static void NodeSplittingScoresAvx512(const size_t cItems, const FloatEbmType * const aSums, FloatEbmType * const aCountsInScoresOut) {
+   SimdFunctions<Avx512Double>::NodeSplittingScores(cItems, aSums, aCountsInScoresOut);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+extern const SimdKernels g_simdKernelsAvx512 = {
+   SimdInstructionSet::Avx512,
+   &TrainingBinaryAvx512,
+   &ValidationBinaryAvx512,
+   &TrainingRegressionAvx512,
+   &ValidationRegressionAvx512,
+   &DiscretizeAvx512,
+   &FillRandomAvx512,
+   &GatherUpdatesAvx512,
+   &NodeSplittingScoresAvx512
+};
+
+#endif // defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
@@ -0,0 +1,414 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef SIMD_KERNELS_INTERNAL_H
+#define SIMD_KERNELS_INTERNAL_H
+
+// This header holds the instruction set independent versions of our SIMD kernels.  It is only included by the
+// per instruction set translation units AFTER they have enabled their instruction set with a target pragma, so
+// everything in here is compiled for that instruction set.  TVector is a static class that wraps the intrinsics for
+// one vector type.  Its Min and Max need to return NaN if the second operand is NaN, which holds for both the x86
+// instructions (which return the second operand) and NEON (which propagates NaN).  TVector::Index holds one 64 bit
+// integer per lane, and index masks are the same as value masks.  The random number lanes also live in Index
+// vectors.
+//
+// We never use fused multiply-add in here so that every instruction set produces identical per-lane results.
+
+#include <stddef.h> // size_t, ptrdiff_t
+#include <limits> // numeric_limits
+
+#include "ebm_native.h" // FloatEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS, StorageDataType
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "RandomStream.h" // RandomLanes
+
+template<typename TVector>
+class SimdFunctions final {
+   typedef typename TVector::Vector Vector;
+   typedef typename TVector::Mask Mask;
+
+   static constexpr size_t k_cLanes = TVector::k_cLanes;
+
+public:
+
+   SimdFunctions() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static Vector Exp(const Vector x) {
+      // this is the Cephes exp algorithm.  We reduce x to r = x - n * ln(2) with |r| <= ln(2)/2, compute exp(r)
+      // with a Pade approximation, and then scale the result by 2^n.
+      constexpr FloatEbmType k_expMax = FloatEbmType { 709.782712893383973096 };
+      constexpr FloatEbmType k_expMin = FloatEbmType { -708.396418532264106224 };
+
+      // Max and Min preserve NaN since x is the second operand
+      const Vector xClamped = TVector::Min(TVector::Set(k_expMax), TVector::Max(TVector::Set(k_expMin), x));
+
+      const Vector n = TVector::Floor(TVector::Add(
+         TVector::Mul(xClamped, TVector::Set(FloatEbmType { 1.4426950408889634073599 })),
+         TVector::Set(FloatEbmType { 0.5 })
+      ));
+      Vector r = TVector::Sub(xClamped, TVector::Mul(n, TVector::Set(FloatEbmType { 6.93145751953125E-1 })));
+      r = TVector::Sub(r, TVector::Mul(n, TVector::Set(FloatEbmType { 1.42860682030941723212E-6 })));
+      const Vector rr = TVector::Mul(r, r);
+
+      Vector px = TVector::Set(FloatEbmType { 1.26177193074810590878E-4 });
+      px = TVector::Add(TVector::Mul(px, rr), TVector::Set(FloatEbmType { 3.02994407707441961300E-2 }));
+      px = TVector::Add(TVector::Mul(px, rr), TVector::Set(FloatEbmType { 9.99999999999999999910E-1 }));
+      px = TVector::Mul(px, r);
+
+      Vector qx = TVector::Set(FloatEbmType { 3.00198505138664455042E-6 });
+      qx = TVector::Add(TVector::Mul(qx, rr), TVector::Set(FloatEbmType { 2.52448340349684104192E-3 }));
+      qx = TVector::Add(TVector::Mul(qx, rr), TVector::Set(FloatEbmType { 2.27265548208155028766E-1 }));
+      qx = TVector::Add(TVector::Mul(qx, rr), TVector::Set(FloatEbmType { 2.00000000000000000009E0 }));
+
+      Vector ret = TVector::Div(px, TVector::Sub(qx, px));
+      ret = TVector::Add(TVector::Set(FloatEbmType { 1 }), TVector::Add(ret, ret));
+      // n is within [-1022, 1024] here, but 2^1024 isn't a double, so we scale in two steps that are both within
+      // [-511, 512].  This matches EbmExp bit for bit
+      const Vector nLow = TVector::Floor(TVector::Mul(n, TVector::Set(FloatEbmType { 0.5 })));
+      ret = TVector::Mul(TVector::Mul(ret, TVector::Pow2(nLow)), TVector::Pow2(TVector::Sub(n, nLow)));
+
+      ret = TVector::Select(TVector::GreaterThan(x, TVector::Set(k_expMax)),
+         TVector::Set(std::numeric_limits<FloatEbmType>::infinity()), ret);
+      ret = TVector::Select(TVector::LessThan(x, TVector::Set(k_expMin)), TVector::Set(FloatEbmType { 0 }), ret);
+      return ret;
+   }
+
+   INLINE_ALWAYS static Vector Log(const Vector x) {
+      // this is the Cephes log algorithm.  x needs to be a positive normal number, infinity or NaN.  We only take the
+      // log of 1 + exp(..) so we never see zero, negative numbers or denormals
+      Vector exponent;
+      Vector m = TVector::Frexp(x, &exponent); // [0.5, 1)
+
+      const Mask bSmall = TVector::LessThan(m, TVector::Set(FloatEbmType { 0.70710678118654752440 }));
+      exponent = TVector::Select(bSmall, TVector::Sub(exponent, TVector::Set(FloatEbmType { 1 })), exponent);
+      m = TVector::Select(bSmall, TVector::Sub(TVector::Add(m, m), TVector::Set(FloatEbmType { 1 })),
+         TVector::Sub(m, TVector::Set(FloatEbmType { 1 })));
+
+      const Vector z = TVector::Mul(m, m);
+
+      Vector p = TVector::Set(FloatEbmType { 1.01875663804580931796E-4 });
+      p = TVector::Add(TVector::Mul(p, m), TVector::Set(FloatEbmType { 4.97494994976747001425E-1 }));
+      p = TVector::Add(TVector::Mul(p, m), TVector::Set(FloatEbmType { 4.70579119878881725854E0 }));
+      p = TVector::Add(TVector::Mul(p, m), TVector::Set(FloatEbmType { 1.44989225341610930846E1 }));
+      p = TVector::Add(TVector::Mul(p, m), TVector::Set(FloatEbmType { 1.79368678507819816313E1 }));
+      p = TVector::Add(TVector::Mul(p, m), TVector::Set(FloatEbmType { 7.70838733755885391666E0 }));
+
+      Vector q = TVector::Add(m, TVector::Set(FloatEbmType { 1.12873587189167450590E1 }));
+      q = TVector::Add(TVector::Mul(q, m), TVector::Set(FloatEbmType { 4.52279145837532221105E1 }));
+      q = TVector::Add(TVector::Mul(q, m), TVector::Set(FloatEbmType { 8.29875266912776603211E1 }));
+      q = TVector::Add(TVector::Mul(q, m), TVector::Set(FloatEbmType { 7.11544750618563894466E1 }));
+      q = TVector::Add(TVector::Mul(q, m), TVector::Set(FloatEbmType { 2.31251620126765340583E1 }));
+
+      Vector y = TVector::Mul(m, TVector::Div(TVector::Mul(z, p), q));
+      y = TVector::Sub(y, TVector::Mul(exponent, TVector::Set(FloatEbmType { 2.121944400546905827679E-4 })));
+      y = TVector::Sub(y, TVector::Mul(z, TVector::Set(FloatEbmType { 0.5 })));
+      Vector ret = TVector::Add(m, y);
+      ret = TVector::Add(ret, TVector::Mul(exponent, TVector::Set(FloatEbmType { 0.693359375 })));
+
+      // Frexp doesn't understand infinity or NaN, but log returns those unchanged
+      const Mask bSpecial = TVector::Or(TVector::IsNaN(x),
+         TVector::Equal(x, TVector::Set(std::numeric_limits<FloatEbmType>::infinity())));
+      return TVector::Select(bSpecial, x, ret);
+   }
+
+   INLINE_ALWAYS static Vector TrainingBinaryStep(
+      const FloatEbmType * const pUpdates,
+      const StorageDataType * const pTargets,
+      FloatEbmType * const pPredictorScores
+   ) {
+      // this is the vectorized version of EbmStatistics::ComputeResidualErrorBinaryClassification
+      const Vector predictorScores = TVector::Add(TVector::Load(pPredictorScores), TVector::Load(pUpdates));
+      TVector::Store(pPredictorScores, predictorScores);
+      const Mask bZero = TVector::IsTargetZero(pTargets);
+      const Vector negated = TVector::Sub(TVector::Set(FloatEbmType { 0 }), predictorScores);
+      const Vector expVal = Exp(TVector::Select(bZero, negated, predictorScores));
+      const Vector numerator = TVector::Select(bZero, TVector::Set(FloatEbmType { -1 }), TVector::Set(FloatEbmType { 1 }));
+      return TVector::Div(numerator, TVector::Add(TVector::Set(FloatEbmType { 1 }), expVal));
+   }
+
+   INLINE_ALWAYS static Vector ValidationBinaryStep(
+      const FloatEbmType * const pUpdates,
+      const StorageDataType * const pTargets,
+      FloatEbmType * const pPredictorScores
+   ) {
+      // this is the vectorized version of EbmStatistics::ComputeSingleSampleLogLossBinaryClassification
+      const Vector predictorScores = TVector::Add(TVector::Load(pPredictorScores), TVector::Load(pUpdates));
+      TVector::Store(pPredictorScores, predictorScores);
+      const Mask bZero = TVector::IsTargetZero(pTargets);
+      const Vector negated = TVector::Sub(TVector::Set(FloatEbmType { 0 }), predictorScores);
+      const Vector expVal = Exp(TVector::Select(bZero, predictorScores, negated));
+      return Log(TVector::Add(TVector::Set(FloatEbmType { 1 }), expVal));
+   }
+
+   static void TrainingBinary(
+      const size_t cSamples,
+      const FloatEbmType * const aUpdates,
+      const StorageDataType * const aTargets,
+      FloatEbmType * const aPredictorScores,
+      FloatEbmType * const aResidualErrors
+   ) {
+      EBM_ASSERT(0 < cSamples);
+      size_t iSample = 0;
+      while(iSample + k_cLanes <= cSamples) {
+         TVector::Store(&aResidualErrors[iSample],
+            TrainingBinaryStep(&aUpdates[iSample], &aTargets[iSample], &aPredictorScores[iSample]));
+         iSample += k_cLanes;
+      }
+      if(cSamples != iSample) {
+         // process the last partial vector through padded copies so that we don't read or write past our arrays
+         FloatEbmType aUpdatesLast[k_cLanes] = {};
+         StorageDataType aTargetsLast[k_cLanes] = {};
+         FloatEbmType aPredictorScoresLast[k_cLanes] = {};
+         FloatEbmType aResidualErrorsLast[k_cLanes];
+         const size_t cRemaining = cSamples - iSample;
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aUpdatesLast[i] = aUpdates[iSample + i];
+            aTargetsLast[i] = aTargets[iSample + i];
+            aPredictorScoresLast[i] = aPredictorScores[iSample + i];
+         }
+         TVector::Store(aResidualErrorsLast, TrainingBinaryStep(aUpdatesLast, aTargetsLast, aPredictorScoresLast));
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aPredictorScores[iSample + i] = aPredictorScoresLast[i];
+            aResidualErrors[iSample + i] = aResidualErrorsLast[i];
+         }
+      }
+   }
+
+   static FloatEbmType ValidationBinary(
+      const size_t cSamples,
+      const FloatEbmType * const aUpdates,
+      const StorageDataType * const aTargets,
+      FloatEbmType * const aPredictorScores
+   ) {
+      EBM_ASSERT(0 < cSamples);
+      Vector sumLogLoss = TVector::Set(FloatEbmType { 0 });
+      size_t iSample = 0;
+      while(iSample + k_cLanes <= cSamples) {
+         sumLogLoss = TVector::Add(sumLogLoss,
+            ValidationBinaryStep(&aUpdates[iSample], &aTargets[iSample], &aPredictorScores[iSample]));
+         iSample += k_cLanes;
+      }
+      FloatEbmType ret = TVector::Sum(sumLogLoss);
+      if(cSamples != iSample) {
+         FloatEbmType aUpdatesLast[k_cLanes] = {};
+         StorageDataType aTargetsLast[k_cLanes] = {};
+         FloatEbmType aPredictorScoresLast[k_cLanes] = {};
+         FloatEbmType aLogLossLast[k_cLanes];
+         const size_t cRemaining = cSamples - iSample;
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aUpdatesLast[i] = aUpdates[iSample + i];
+            aTargetsLast[i] = aTargets[iSample + i];
+            aPredictorScoresLast[i] = aPredictorScores[iSample + i];
+         }
+         TVector::Store(aLogLossLast, ValidationBinaryStep(aUpdatesLast, aTargetsLast, aPredictorScoresLast));
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aPredictorScores[iSample + i] = aPredictorScoresLast[i];
+            // the padding lanes computed log(2), so we only sum the real samples
+            ret += aLogLossLast[i];
+         }
+      }
+      return ret;
+   }
+
+   static void TrainingRegression(
+      const size_t cSamples,
+      const FloatEbmType * const aUpdates,
+      FloatEbmType * const aResidualErrors
+   ) {
+      EBM_ASSERT(0 < cSamples);
+      size_t iSample = 0;
+      while(iSample + k_cLanes <= cSamples) {
+         TVector::Store(&aResidualErrors[iSample],
+            TVector::Sub(TVector::Load(&aResidualErrors[iSample]), TVector::Load(&aUpdates[iSample])));
+         iSample += k_cLanes;
+      }
+      while(cSamples != iSample) {
+         // subtraction is exact per lane, so the scalar tail gives identical results
+         aResidualErrors[iSample] -= aUpdates[iSample];
+         ++iSample;
+      }
+   }
+
+   INLINE_ALWAYS static typename TVector::Index DiscretizeStep(
+      const FloatEbmType * const pFeatureValues,
+      const size_t cBinCuts,
+      const size_t cPower,
+      const FloatEbmType * const aEytzinger
+   ) {
+      // each lane walks down the implicit tree from node 1, going to child 2k + 1 when the cut at node k is <= the
+      // value.  The tree is complete, so every lane takes the same number of steps and lands on a leaf number in
+      // [cPower, 2 * cPower) whose offset from cPower is the count of padded cuts <= the value
+      typedef typename TVector::Index Index;
+
+      const Vector val = TVector::Load(pFeatureValues);
+      Index iNode = TVector::SetIndex(1);
+      size_t cLevels = cPower >> 1;
+      do {
+         const Vector cut = TVector::Gather(aEytzinger, iNode);
+         iNode = TVector::AddIndexMasked(TVector::AddIndex(iNode, iNode), TVector::LessEqual(cut, val), 1);
+         cLevels >>= 1;
+      } while(0 != cLevels);
+      // the -infinity padding is <= every value except NaN, so we remove it from the count
+      iNode = TVector::SubIndex(iNode, cPower + (cPower - 1 - cBinCuts));
+      return TVector::SelectIndex(TVector::IsNaN(val), TVector::SetIndex(cBinCuts + 1), iNode);
+   }
+
+   static void Discretize(
+      const size_t cSamples,
+      const FloatEbmType * const aFeatureValues,
+      const size_t cBinCuts,
+      const size_t cPower,
+      const FloatEbmType * const aEytzinger,
+      IntEbmType * const aDiscretizedOut
+   ) {
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(cBinCuts < cPower);
+      EBM_ASSERT(2 <= cPower);
+      size_t iSample = 0;
+      while(iSample + k_cLanes <= cSamples) {
+         TVector::StoreIndex(&aDiscretizedOut[iSample],
+            DiscretizeStep(&aFeatureValues[iSample], cBinCuts, cPower, aEytzinger));
+         iSample += k_cLanes;
+      }
+      if(cSamples != iSample) {
+         FloatEbmType aFeatureValuesLast[k_cLanes] = {};
+         IntEbmType aDiscretizedLast[k_cLanes];
+         const size_t cRemaining = cSamples - iSample;
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aFeatureValuesLast[i] = aFeatureValues[iSample + i];
+         }
+         TVector::StoreIndex(aDiscretizedLast, DiscretizeStep(aFeatureValuesLast, cBinCuts, cPower, aEytzinger));
+         for(size_t i = 0; i < cRemaining; ++i) {
+            aDiscretizedOut[iSample + i] = aDiscretizedLast[i];
+         }
+      }
+   }
+
+   static void GatherUpdates(
+      const size_t cSamples,
+      const size_t cItemsPerBitPackedDataUnit,
+      const size_t cBitsPerItemMax,
+      const StorageDataType * const aInputData,
+      const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+      FloatEbmType * const aUpdatesOut
+   ) {
+      // each data unit is broadcast to every lane and shifted by a different amount in each lane, which decodes 
+      // k_cLanes tensor indexes at once that we then gather with.  Lanes past the last item shift in the zero bits 
+      // above the packed items (or shift by 64 or more, which also gives zero) so they read the valid 0th tensor bin
+      typedef typename TVector::Index Index;
+      EBM_ASSERT(0 < cSamples);
+      EBM_ASSERT(1 <= cItemsPerBitPackedDataUnit);
+      EBM_ASSERT(1 <= cBitsPerItemMax);
+      EBM_ASSERT(cItemsPerBitPackedDataUnit * cBitsPerItemMax <= k_cBitsForStorageType);
+
+      uint64_t aShifts[k_cLanes];
+      for(size_t iLane = 0; iLane < k_cLanes; ++iLane) {
+         aShifts[iLane] = static_cast<uint64_t>(iLane * cBitsPerItemMax);
+      }
+      const Index shiftsStart = TVector::LoadIndexUnsigned(aShifts);
+      const Index shiftsStep = TVector::SetIndex(k_cLanes * cBitsPerItemMax);
+      const Index maskBits = TVector::SetIndex(std::numeric_limits<size_t>::max() >> (k_cBitsForStorageType - cBitsPerItemMax));
+
+      const StorageDataType * pInputData = aInputData;
+      size_t iSample = 0;
+      do {
+         const Index bits = TVector::SetIndex(static_cast<size_t>(*pInputData));
+         ++pInputData;
+         const size_t cRemaining = cSamples - iSample;
+         const size_t cItems = cRemaining < cItemsPerBitPackedDataUnit ? cRemaining : cItemsPerBitPackedDataUnit;
+         Index shifts = shiftsStart;
+         size_t iItem = 0;
+         while(iItem + k_cLanes <= cItems) {
+            const Index iTensorBins = TVector::AndIndex(TVector::ShiftRightIndex(bits, shifts), maskBits);
+            TVector::Store(&aUpdatesOut[iSample + iItem], TVector::Gather(aModelFeatureGroupUpdateTensor, iTensorBins));
+            shifts = TVector::AddIndex(shifts, shiftsStep);
+            iItem += k_cLanes;
+         }
+         if(cItems != iItem) {
+            FloatEbmType aUpdatesLast[k_cLanes];
+            const Index iTensorBins = TVector::AndIndex(TVector::ShiftRightIndex(bits, shifts), maskBits);
+            TVector::Store(aUpdatesLast, TVector::Gather(aModelFeatureGroupUpdateTensor, iTensorBins));
+            for(size_t i = 0; iItem + i < cItems; ++i) {
+               aUpdatesOut[iSample + iItem + i] = aUpdatesLast[i];
+            }
+         }
+         iSample += cItems;
+      } while(cSamples != iSample);
+   }
+
+   static void FillRandom(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+      // this is FillRandomLanes with k_cRandomLanes / k_cLanes vectors of lanes.  Each vector is an independent
+      // dependency chain, so the CPU can overlap their multiplies
+      typedef typename TVector::Index Index;
+      static_assert(0 == k_cRandomLanes % k_cLanes, "each vector needs to hold whole lanes");
+      constexpr size_t k_cVectors = k_cRandomLanes / k_cLanes;
+
+      Index aState1[k_cVectors];
+      Index aState2[k_cVectors];
+      Index aStateSeedConst[k_cVectors];
+      for(size_t iVector = 0; iVector < k_cVectors; ++iVector) {
+         aState1[iVector] = TVector::LoadIndexUnsigned(&pLanes->m_aState1[iVector * k_cLanes]);
+         aState2[iVector] = TVector::LoadIndexUnsigned(&pLanes->m_aState2[iVector * k_cLanes]);
+         aStateSeedConst[iVector] = TVector::LoadIndexUnsigned(&pLanes->m_aStateSeedConst[iVector * k_cLanes]);
+      }
+      uint32_t * pOut = aOut;
+      for(size_t iRound = 0; iRound < cRounds; ++iRound) {
+         for(size_t iVector = 0; iVector < k_cVectors; ++iVector) {
+            aState2[iVector] = TVector::AddIndex(aState2[iVector], aStateSeedConst[iVector]);
+            aState1[iVector] = TVector::SwapHalvesIndex(
+               TVector::AddIndex(TVector::SquareIndex(aState1[iVector]), aState2[iVector]));
+            TVector::StoreIndexLow32(pOut, aState1[iVector]);
+            pOut += k_cLanes;
+         }
+      }
+      for(size_t iVector = 0; iVector < k_cVectors; ++iVector) {
+         TVector::StoreIndexUnsigned(&pLanes->m_aState1[iVector * k_cLanes], aState1[iVector]);
+         TVector::StoreIndexUnsigned(&pLanes->m_aState2[iVector * k_cLanes], aState2[iVector]);
+      }
+   }
+
+   static void NodeSplittingScores(
+      const size_t cItems,
+      const FloatEbmType * const aSums,
+      FloatEbmType * const aCountsInScoresOut
+   ) {
+      size_t iItem = 0;
+      while(iItem + k_cLanes <= cItems) {
+         const Vector sums = TVector::Load(&aSums[iItem]);
+         TVector::Store(&aCountsInScoresOut[iItem], TVector::Mul(TVector::Div(sums, TVector::Load(&aCountsInScoresOut[iItem])), sums));
+         iItem += k_cLanes;
+      }
+      while(cItems != iItem) {
+         // this is the same order of operations as ComputeNodeSplittingScore
+         aCountsInScoresOut[iItem] = aSums[iItem] / aCountsInScoresOut[iItem] * aSums[iItem];
+         ++iItem;
+      }
+   }
+
+   static FloatEbmType ValidationRegression(
+      const size_t cSamples,
+      const FloatEbmType * const aUpdates,
+      FloatEbmType * const aResidualErrors
+   ) {
+      EBM_ASSERT(0 < cSamples);
+      Vector sumSquareError = TVector::Set(FloatEbmType { 0 });
+      size_t iSample = 0;
+      while(iSample + k_cLanes <= cSamples) {
+         const Vector residualError = TVector::Sub(TVector::Load(&aResidualErrors[iSample]), TVector::Load(&aUpdates[iSample]));
+         TVector::Store(&aResidualErrors[iSample], residualError);
+         sumSquareError = TVector::Add(sumSquareError, TVector::Mul(residualError, residualError));
+         iSample += k_cLanes;
+      }
+      FloatEbmType ret = TVector::Sum(sumSquareError);
+      while(cSamples != iSample) {
+         const FloatEbmType residualError = aResidualErrors[iSample] - aUpdates[iSample];
+         aResidualErrors[iSample] = residualError;
+         ret += residualError * residualError;
+         ++iSample;
+      }
+      return ret;
+   }
+};
+
+#endif // SIMD_KERNELS_INTERNAL_H
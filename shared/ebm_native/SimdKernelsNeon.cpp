@@ -0,0 +1,251 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+// very independent includes
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "SimdKernels.h"
+
+// NEON with double precision lanes is part of the baseline on 64 bit ARM, so we don't need a target pragma.  32 bit
+// ARM NEON has no double precision lanes, so we don't have kernels for it
+#if defined(__aarch64__) || defined(_M_ARM64)
+
+#include <arm_neon.h>
+
+#include "SimdKernelsInternal.h"
+
+static_assert(std::is_same<FloatEbmType, double>::value, "our NEON kernels work on doubles");
+static_assert(8 == sizeof(StorageDataType) || 4 == sizeof(StorageDataType), "unexpected StorageDataType size");
+static_assert(8 == sizeof(IntEbmType), "we store 64 bit indexes into IntEbmType");
+
+class NeonDouble final {
+public:
+
+   typedef float64x2_t Vector;
+   typedef uint64x2_t Mask;
+   typedef uint64x2_t Index;
+
+   static constexpr size_t k_cLanes = 2;
+
+   NeonDouble() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static Vector Load(const FloatEbmType * const a) {
+      return vld1q_f64(a);
+   }
+   INLINE_ALWAYS static void Store(FloatEbmType * const a, const Vector val) {
+      vst1q_f64(a, val);
+   }
+   INLINE_ALWAYS static Vector Set(const FloatEbmType val) {
+      return vdupq_n_f64(val);
+   }
+   INLINE_ALWAYS static Vector Add(const Vector val1, const Vector val2) {
+      return vaddq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Sub(const Vector val1, const Vector val2) {
+      return vsubq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Mul(const Vector val1, const Vector val2) {
+      return vmulq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Div(const Vector val1, const Vector val2) {
+      return vdivq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Min(const Vector val1, const Vector val2) {
+      return vminq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Max(const Vector val1, const Vector val2) {
+      return vmaxq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Floor(const Vector val) {
+      return vrndmq_f64(val);
+   }
+   INLINE_ALWAYS static Vector Select(const Mask mask, const Vector valTrue, const Vector valFalse) {
+      return vbslq_f64(mask, valTrue, valFalse);
+   }
+   INLINE_ALWAYS static Mask LessThan(const Vector val1, const Vector val2) {
+      return vcltq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Mask GreaterThan(const Vector val1, const Vector val2) {
+      return vcgtq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Mask LessEqual(const Vector val1, const Vector val2) {
+      return vcleq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Mask Equal(const Vector val1, const Vector val2) {
+      return vceqq_f64(val1, val2);
+   }
+   INLINE_ALWAYS static Mask IsNaN(const Vector val) {
+      // NaN is the only value that isn't equal to itself
+      return vreinterpretq_u64_u32(vmvnq_u32(vreinterpretq_u32_u64(vceqq_f64(val, val))));
+   }
+   INLINE_ALWAYS static Mask Or(const Mask mask1, const Mask mask2) {
+      return vorrq_u64(mask1, mask2);
+   }
+   INLINE_ALWAYS static Vector Pow2(const Vector n) {
+      // n holds integers in [-1022, 1023].  Adding 2^52 + 1023 puts the biased exponent into the low mantissa bits
+      const uint64x2_t bits = vreinterpretq_u64_f64(vaddq_f64(n, vdupq_n_f64(FloatEbmType { 4503599627371519.0 })));
+      return vreinterpretq_f64_u64(vshlq_n_u64(bits, 52));
+   }
+   INLINE_ALWAYS static Vector Frexp(const Vector val, Vector * const pExponentOut) {
+      const uint64x2_t bits = vreinterpretq_u64_f64(val);
+      // convert the biased exponent to a double by placing it into the mantissa of 2^52
+      const uint64x2_t exponentBits = vorrq_u64(vshrq_n_u64(bits, 52),
+         vreinterpretq_u64_f64(vdupq_n_f64(FloatEbmType { 4503599627370496.0 })));
+      *pExponentOut = vsubq_f64(vreinterpretq_f64_u64(exponentBits), vdupq_n_f64(FloatEbmType { 4503599627371518.0 }));
+      const uint64x2_t mantissaBits = vorrq_u64(
+         vandq_u64(bits, vdupq_n_u64(0x000FFFFFFFFFFFFFULL)),
+         vdupq_n_u64(0x3FE0000000000000ULL)
+      );
+      return vreinterpretq_f64_u64(mantissaBits);
+   }
+   INLINE_ALWAYS static Mask IsTargetZero(const StorageDataType * const a) {
+      uint64x2_t targets;
+      if(8 == sizeof(StorageDataType)) {
+         targets = vld1q_u64(reinterpret_cast<const uint64_t *>(a));
+      } else {
+         targets = vmovl_u32(vld1_u32(reinterpret_cast<const uint32_t *>(a)));
+      }
+      return vceqzq_u64(targets);
+   }
+   INLINE_ALWAYS static FloatEbmType Sum(const Vector val) {
+      // sum in lane order so that our results don't depend on how the compiler arranges a horizontal add
+      return vgetq_lane_f64(val, 0) + vgetq_lane_f64(val, 1);
+   }
+   INLINE_ALWAYS static Index SetIndex(const size_t val) {
+      return vdupq_n_u64(static_cast<uint64_t>(val));
+   }
+   INLINE_ALWAYS static Index AddIndex(const Index index1, const Index index2) {
+      return vaddq_u64(index1, index2);
+   }
+   INLINE_ALWAYS static Index AddIndexMasked(const Index index, const Mask mask, const size_t val) {
+      return vaddq_u64(index, vandq_u64(mask, SetIndex(val)));
+   }
+   INLINE_ALWAYS static Index SubIndex(const Index index, const size_t val) {
+      return vsubq_u64(index, SetIndex(val));
+   }
+   INLINE_ALWAYS static Index SelectIndex(const Mask mask, const Index indexTrue, const Index indexFalse) {
+      return vbslq_u64(mask, indexTrue, indexFalse);
+   }
+   INLINE_ALWAYS static Vector Gather(const FloatEbmType * const a, const Index index) {
+      // NEON has no gather instruction, so we load each lane separately
+      return vcombine_f64(
+         vld1_f64(&a[static_cast<size_t>(vgetq_lane_u64(index, 0))]),
+         vld1_f64(&a[static_cast<size_t>(vgetq_lane_u64(index, 1))])
+      );
+   }
+   INLINE_ALWAYS static void StoreIndex(IntEbmType * const a, const Index index) {
+      vst1q_s64(reinterpret_cast<int64_t *>(a), vreinterpretq_s64_u64(index));
+   }
+   INLINE_ALWAYS static Index LoadIndexUnsigned(const uint64_t * const a) {
+      return vld1q_u64(a);
+   }
+   INLINE_ALWAYS static void StoreIndexUnsigned(uint64_t * const a, const Index index) {
+      vst1q_u64(a, index);
+   }
+   INLINE_ALWAYS static Index SquareIndex(const Index index) {
+      // (hi * 2^32 + lo)^2 mod 2^64 is lo * lo + (lo * hi) * 2^33
+      const uint32x2_t lo = vmovn_u64(index);
+      const uint32x2_t hi = vshrn_n_u64(index, 32);
+      return vaddq_u64(vmull_u32(lo, lo), vshlq_n_u64(vmull_u32(lo, hi), 33));
+   }
+   INLINE_ALWAYS static Index SwapHalvesIndex(const Index index) {
+      return vreinterpretq_u64_u32(vrev64q_u32(vreinterpretq_u32_u64(index)));
+   }
+   INLINE_ALWAYS static Index AndIndex(const Index index1, const Index index2) {
+      return vandq_u64(index1, index2);
+   }
+   INLINE_ALWAYS static Index ShiftRightIndex(const Index index, const Index shifts) {
+      // NEON shifts right by negative counts
+      return vshlq_u64(index, vnegq_s64(vreinterpretq_s64_u64(shifts)));
+   }
+   INLINE_ALWAYS static void StoreIndexLow32(uint32_t * const a, const Index index) {
+      vst1_u32(a, vmovn_u64(index));
+   }
+};
+
+static void TrainingBinaryNeon(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<NeonDouble>::TrainingBinary(cSamples, aUpdates, aTargets, aPredictorScores, aResidualErrors);
+}
+
+static FloatEbmType ValidationBinaryNeon(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores
+) {
+   return SimdFunctions<NeonDouble>::ValidationBinary(cSamples, aUpdates, aTargets, aPredictorScores);
+}
+
+static void TrainingRegressionNeon(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<NeonDouble>::TrainingRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static FloatEbmType ValidationRegressionNeon(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   return SimdFunctions<NeonDouble>::ValidationRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static void DiscretizeNeon(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const size_t cPower,
+   const FloatEbmType * const aEytzinger,
+   IntEbmType * const aDiscretizedOut
+) {
+   SimdFunctions<NeonDouble>::Discretize(cSamples, aFeatureValues, cBinCuts, cPower, aEytzinger, aDiscretizedOut);
+}
+
+static void GatherUpdatesNeon(
+   const size_t cSamples,
+   const size_t cItemsPerBitPackedDataUnit,
+   const size_t cBitsPerItemMax,
+   const StorageDataType * const aInputData,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+) {
+   SimdFunctions<NeonDouble>::GatherUpdates(cSamples, cItemsPerBitPackedDataUnit, cBitsPerItemMax, aInputData, 
+      aModelFeatureGroupUpdateTensor, aUpdatesOut);
+}
+
+static void FillRandomNeon(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+   SimdFunctions<NeonDouble>::FillRandom(cRounds, pLanes, aOut);
+}
+
+static void NodeSplittingScoresNeon(const size_t cItems, const FloatEbmType * const aSums, FloatEbmType * const aCountsInScoresOut) {
+   SimdFunctions<NeonDouble>::NodeSplittingScores(cItems, aSums, aCountsInScoresOut);
+}
+
+extern const SimdKernels g_simdKernelsNeon = {
+   SimdInstructionSet::Neon,
+   &TrainingBinaryNeon,
+   &ValidationBinaryNeon,
+   &TrainingRegressionNeon,
+   &ValidationRegressionNeon,
+   &DiscretizeNeon,
+   &FillRandomNeon,
+   &GatherUpdatesNeon,
+   &NodeSplittingScoresNeon
+};
+
+#endif // defined(__aarch64__) || defined(_M_ARM64)
@@ -0,0 +1,265 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h"
+#include "EbmInternal.h"
+// very independent includes
+#include "Logging.h" // EBM_ASSERT & LOG
+
+#include "SimdKernels.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+
+#include <immintrin.h>
+
+// Everything after this point is compiled for SSE4.2.  None of it can be called unless GetBestAvailable has verified
+// that the CPU supports SSE4.2.  MSVC allows intrinsics from any instruction set without extra flags.
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2"))), apply_to=function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#endif
+
+#include "SimdKernelsInternal.h"
+
+static_assert(std::is_same<FloatEbmType, double>::value, "our SSE4.2 kernels work on doubles");
+static_assert(8 == sizeof(StorageDataType) || 4 == sizeof(StorageDataType), "unexpected StorageDataType size");
+static_assert(8 == sizeof(IntEbmType), "we store 64 bit indexes into IntEbmType");
+
+class Sse42Double final {
+public:
+
+   typedef __m128d Vector;
+   typedef __m128d Mask;
+   typedef __m128i Index;
+
+   static constexpr size_t k_cLanes = 2;
+
+   Sse42Double() = delete; // this is a static class.  Do not construct
+
+   INLINE_ALWAYS static Vector Load(const FloatEbmType * const a) {
+      return _mm_loadu_pd(a);
+   }
+   INLINE_ALWAYS static void Store(FloatEbmType * const a, const Vector val) {
+      _mm_storeu_pd(a, val);
+   }
+   INLINE_ALWAYS static Vector Set(const FloatEbmType val) {
+      return _mm_set1_pd(val);
+   }
+   INLINE_ALWAYS static Vector Add(const Vector val1, const Vector val2) {
+      return _mm_add_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Sub(const Vector val1, const Vector val2) {
+      return _mm_sub_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Mul(const Vector val1, const Vector val2) {
+      return _mm_mul_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Div(const Vector val1, const Vector val2) {
+      return _mm_div_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Min(const Vector val1, const Vector val2) {
+      return _mm_min_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Max(const Vector val1, const Vector val2) {
+      return _mm_max_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Vector Floor(const Vector val) {
+      return _mm_round_pd(val, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+   }
+   INLINE_ALWAYS static Vector Select(const Mask mask, const Vector valTrue, const Vector valFalse) {
+      return _mm_blendv_pd(valFalse, valTrue, mask);
+   }
+   INLINE_ALWAYS static Mask LessThan(const Vector val1, const Vector val2) {
+      return _mm_cmplt_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Mask GreaterThan(const Vector val1, const Vector val2) {
+      return _mm_cmpgt_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Mask LessEqual(const Vector val1, const Vector val2) {
+      return _mm_cmple_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Mask Equal(const Vector val1, const Vector val2) {
+      return _mm_cmpeq_pd(val1, val2);
+   }
+   INLINE_ALWAYS static Mask IsNaN(const Vector val) {
+      return _mm_cmpunord_pd(val, val);
+   }
+   INLINE_ALWAYS static Mask Or(const Mask mask1, const Mask mask2) {
+      return _mm_or_pd(mask1, mask2);
+   }
+   INLINE_ALWAYS static Vector Pow2(const Vector n) {
+      // n holds integers in [-1022, 1023].  Adding 2^52 + 1023 puts the biased exponent into the low mantissa bits
+      const __m128i bits = _mm_castpd_si128(_mm_add_pd(n, _mm_set1_pd(FloatEbmType { 4503599627371519.0 })));
+      return _mm_castsi128_pd(_mm_slli_epi64(bits, 52));
+   }
+   INLINE_ALWAYS static Vector Frexp(const Vector val, Vector * const pExponentOut) {
+      const __m128i bits = _mm_castpd_si128(val);
+      // convert the biased exponent to a double by placing it into the mantissa of 2^52
+      const __m128i exponentBits = _mm_or_si128(_mm_srli_epi64(bits, 52),
+         _mm_castpd_si128(_mm_set1_pd(FloatEbmType { 4503599627370496.0 })));
+      *pExponentOut = _mm_sub_pd(_mm_castsi128_pd(exponentBits), _mm_set1_pd(FloatEbmType { 4503599627371518.0 }));
+      const __m128i mantissaBits = _mm_or_si128(
+         _mm_and_si128(bits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+         _mm_set1_epi64x(0x3FE0000000000000LL)
+      );
+      return _mm_castsi128_pd(mantissaBits);
+   }
+   INLINE_ALWAYS static Mask IsTargetZero(const StorageDataType * const a) {
+      __m128i targets;
+      if(8 == sizeof(StorageDataType)) {
+         targets = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+      } else {
+         targets = _mm_cvtepu32_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(a)));
+      }
+      return _mm_castsi128_pd(_mm_cmpeq_epi64(targets, _mm_setzero_si128()));
+   }
+   INLINE_ALWAYS static FloatEbmType Sum(const Vector val) {
+      // sum in lane order so that our results don't depend on how the compiler arranges a horizontal add
+      FloatEbmType a[k_cLanes];
+      Store(a, val);
+      return a[0] + a[1];
+   }
+   INLINE_ALWAYS static Index SetIndex(const size_t val) {
+      return _mm_set1_epi64x(static_cast<long long>(val));
+   }
+   INLINE_ALWAYS static Index AddIndex(const Index index1, const Index index2) {
+      return _mm_add_epi64(index1, index2);
+   }
+   INLINE_ALWAYS static Index AddIndexMasked(const Index index, const Mask mask, const size_t val) {
+      return _mm_add_epi64(index, _mm_and_si128(_mm_castpd_si128(mask), SetIndex(val)));
+   }
+   INLINE_ALWAYS static Index SubIndex(const Index index, const size_t val) {
+      return _mm_sub_epi64(index, SetIndex(val));
+   }
+   INLINE_ALWAYS static Index SelectIndex(const Mask mask, const Index indexTrue, const Index indexFalse) {
+      return _mm_castpd_si128(_mm_blendv_pd(_mm_castsi128_pd(indexFalse), _mm_castsi128_pd(indexTrue), mask));
+   }
+   INLINE_ALWAYS static Vector Gather(const FloatEbmType * const a, const Index index) {
+      // SSE has no gather instruction, so we load each lane separately
+      IntEbmType aIndexes[k_cLanes];
+      StoreIndex(aIndexes, index);
+      return _mm_set_pd(a[static_cast<size_t>(aIndexes[1])], a[static_cast<size_t>(aIndexes[0])]);
+   }
+   INLINE_ALWAYS static void StoreIndex(IntEbmType * const a, const Index index) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(a), index);
+   }
+   INLINE_ALWAYS static Index LoadIndexUnsigned(const uint64_t * const a) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+   }
+   INLINE_ALWAYS static void StoreIndexUnsigned(uint64_t * const a, const Index index) {
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(a), index);
+   }
+   INLINE_ALWAYS static Index SquareIndex(const Index index) {
+      // (hi * 2^32 + lo)^2 mod 2^64 is lo * lo + (lo * hi) * 2^33
+      const __m128i cross = _mm_mul_epu32(index, _mm_srli_epi64(index, 32));
+      return _mm_add_epi64(_mm_mul_epu32(index, index), _mm_slli_epi64(cross, 33));
+   }
+   INLINE_ALWAYS static Index SwapHalvesIndex(const Index index) {
+      return _mm_shuffle_epi32(index, 0xB1);
+   }
+   INLINE_ALWAYS static Index AndIndex(const Index index1, const Index index2) {
+      return _mm_and_si128(index1, index2);
+   }
+   INLINE_ALWAYS static Index ShiftRightIndex(const Index index, const Index shifts) {
+      // SSE only shifts every lane by the same count, so we shift twice and keep the high lane of the second shift
+      const __m128i shiftedLow = _mm_srl_epi64(index, shifts);
+      const __m128i shiftedHigh = _mm_srl_epi64(index, _mm_unpackhi_epi64(shifts, shifts));
+      return _mm_blend_epi16(shiftedLow, shiftedHigh, 0xF0);
+   }
+   INLINE_ALWAYS static void StoreIndexLow32(uint32_t * const a, const Index index) {
+      _mm_storel_epi64(reinterpret_cast<__m128i *>(a), _mm_shuffle_epi32(index, 0x08));
+   }
+};
+
+static void TrainingBinarySse42(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Sse42Double>::TrainingBinary(cSamples, aUpdates, aTargets, aPredictorScores, aResidualErrors);
+}
+
+static FloatEbmType ValidationBinarySse42(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   const StorageDataType * const aTargets,
+   FloatEbmType * const aPredictorScores
+) {
+   return SimdFunctions<Sse42Double>::ValidationBinary(cSamples, aUpdates, aTargets, aPredictorScores);
+}
+
+static void TrainingRegressionSse42(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   SimdFunctions<Sse42Double>::TrainingRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static FloatEbmType ValidationRegressionSse42(
+   const size_t cSamples,
+   const FloatEbmType * const aUpdates,
+   FloatEbmType * const aResidualErrors
+) {
+   return SimdFunctions<Sse42Double>::ValidationRegression(cSamples, aUpdates, aResidualErrors);
+}
+
+static void DiscretizeSse42(
+   const size_t cSamples,
+   const FloatEbmType * const aFeatureValues,
+   const size_t cBinCuts,
+   const size_t cPower,
+   const FloatEbmType * const aEytzinger,
+   IntEbmType * const aDiscretizedOut
+) {
+   SimdFunctions<Sse42Double>::Discretize(cSamples, aFeatureValues, cBinCuts, cPower, aEytzinger, aDiscretizedOut);
+}
+
+static void GatherUpdatesSse42(
+   const size_t cSamples,
+   const size_t cItemsPerBitPackedDataUnit,
+   const size_t cBitsPerItemMax,
+   const StorageDataType * const aInputData,
+   const FloatEbmType * const aModelFeatureGroupUpdateTensor,
+   FloatEbmType * const aUpdatesOut
+) {
+   SimdFunctions<Sse42Double>::GatherUpdates(cSamples, cItemsPerBitPackedDataUnit, cBitsPerItemMax, aInputData, 
+      aModelFeatureGroupUpdateTensor, aUpdatesOut);
+}
+
+static void FillRandomSse42(const size_t cRounds, RandomLanes * const pLanes, uint32_t * const aOut) {
+   SimdFunctions<Sse42Double>::FillRandom(cRounds, pLanes, aOut);
+}
+
+static void NodeSplittingScoresSse42(const size_t cItems, const FloatEbmType * const aSums, FloatEbmType * const aCountsInScoresOut) {
+   SimdFunctions<Sse42Double>::NodeSplittingScores(cItems, aSums, aCountsInScoresOut);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+extern const SimdKernels g_simdKernelsSse42 = {
+   SimdInstructionSet::Sse42,
+   &TrainingBinarySse42,
+   &ValidationBinarySse42,
+   &TrainingRegressionSse42,
+   &ValidationRegressionSse42,
+   &DiscretizeSse42,
+   &FillRandomSse42,
+   &GatherUpdatesSse42,
+   &NodeSplittingScoresSse42
+};
+
+#endif // defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
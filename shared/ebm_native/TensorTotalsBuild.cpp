@@ -5,6 +5,7 @@
 #include "PrecompiledHeader.h"
 
 #include <stddef.h> // size_t, ptrdiff_t
+#include <string.h> // memcpy
 
 #include "ebm_native.h" // FloatEbmType
 #include "EbmInternal.h" // INLINE_ALWAYS
@@ -136,10 +137,10 @@
 //- have a look at our final dimensionality.Is the totals calculation the bottleneck, or the point to corner totals function ?
 //- I think I understand the costs of all implementations of point to corner computation, so don't implement the (1,1,...,1,1) to point algorithm yet.. try implementing the more optimized totals calculation (with more memory).  After we have the optimized totals calculation, then try to re-do the splitting code to do splitting at the same time as totals calculation.  If that isn't better than our existing stuff, then optimzie the point to corner calculation code
 //- implement a function that calcualtes the total of any volume using just the(0, 0, ..., 0, 0) totals ..as a debugging function.We might use this for trying out more complicated splits where we allow 2 splits on some axies
-// TODO: build a pair and triple specific version of this function.  For pairs we can get ride of the pPrevious and just use the actual cell at (-1,-1) from our current cell, and we can use two loops with everything in memory [look at code above from before we incoporated the previous totals].  Triples would also benefit from pulling things out since we have low iterations of the inner loop and we can access indicies directly without additional add/subtract/bit operations.  Beyond triples, the combinatorial choices start to explode, so we should probably use this general N-dimensional code.
-// TODO: after we build pair and triple specific versions of this function, we don't need to have a compiler compilerCountDimensions, since the compiler won't really be able to simpify the loops that are exploding in dimensionality
+// TODO: pairs and triples use TensorTotalsBuildPair and TensorTotalsBuildTriple below, so this general version only handles 4+ dimensions where the 
+//       compiler can't simplify the loops anyways.  We could drop the compilerCountDimensions template parameter
 // TODO: sort our N-dimensional groups at initialization so that the longest dimension is first!  That way we can more efficiently walk through contiguous memory better in this function!  After we determine the cuts, we can undo the re-ordering for cutting the tensor, which has just a few cells, so will be efficient
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions>
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions, bool bNeedDenominator>
 class TensorTotalsBuildInternal final {
 public:
 
@@ -155,23 +156,24 @@ public:
       , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
    ) {
-      constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+      static_assert(!bNeedDenominator || IsClassification(compilerLearningTypeOrCountTargetClasses),
+         "only classification has denominators");
 
       struct FastTotalState {
-         HistogramBucket<bClassification> * m_pDimensionalCur;
-         HistogramBucket<bClassification> * m_pDimensionalWrap;
-         HistogramBucket<bClassification> * m_pDimensionalFirst;
+         HistogramBucket<bNeedDenominator> * m_pDimensionalCur;
+         HistogramBucket<bNeedDenominator> * m_pDimensionalWrap;
+         HistogramBucket<bNeedDenominator> * m_pDimensionalFirst;
          size_t m_iCur;
          size_t m_cBins;
       };
 
       LOG_0(TraceLevelVerbose, "Entered BuildFastTotals");
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * pBucketAuxiliaryBuildZone =
-         pBucketAuxiliaryBuildZoneBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * pBucketAuxiliaryBuildZone =
+         pBucketAuxiliaryBuildZoneBase->GetHistogramBucket<bNeedDenominator>();
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets =
-         aHistogramBucketBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * const aHistogramBuckets =
+         aHistogramBucketBase->GetHistogramBucket<bNeedDenominator>();
 
       const size_t cDimensions = GET_ATTRIBUTE_COMBINATION_DIMENSIONS(compilerCountDimensions, pFeatureGroup->GetCountFeatures());
       EBM_ASSERT(1 <= cDimensions);
@@ -181,8 +183,8 @@ public:
          runtimeLearningTypeOrCountTargetClasses
       );
       const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
-      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
-      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
 
       FastTotalState fastTotalState[k_cDimensionsMax];
       const FastTotalState * const pFastTotalStateEnd = &fastTotalState[cDimensions];
@@ -206,7 +208,7 @@ public:
             pFastTotalStateInitialize->m_pDimensionalCur = pBucketAuxiliaryBuildZone;
             // when we exit, pBucketAuxiliaryBuildZone should be == to aHistogramBucketsEndDebug, which is legal in C++ since it doesn't extend beyond 1 
             // item past the end of the array
-            pBucketAuxiliaryBuildZone = GetHistogramBucketByIndex<bClassification>(
+            pBucketAuxiliaryBuildZone = GetHistogramBucketByIndex<bNeedDenominator>(
                cBytesPerHistogramBucket,
                pBucketAuxiliaryBuildZone,
                multiply
@@ -222,9 +224,9 @@ public:
                // if this isn't the last iteration, then we'll actually be using this memory, so the entire bucket had better be useable
                EBM_ASSERT(reinterpret_cast<unsigned char *>(pBucketAuxiliaryBuildZone) + cBytesPerHistogramBucket <= aHistogramBucketsEndDebug);
             }
-            for(HistogramBucket<bClassification> * pDimensionalCur = pFastTotalStateInitialize->m_pDimensionalCur;
+            for(HistogramBucket<bNeedDenominator> * pDimensionalCur = pFastTotalStateInitialize->m_pDimensionalCur;
                pBucketAuxiliaryBuildZone != pDimensionalCur;
-               pDimensionalCur = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pDimensionalCur, 1)) 
+               pDimensionalCur = GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pDimensionalCur, 1)) 
             {
                pDimensionalCur->AssertZero(cVectorLength);
             }
@@ -243,27 +245,27 @@ public:
 
 #ifndef NDEBUG
 
-      HistogramBucket<bClassification> * const pDebugBucket =
-         EbmMalloc<HistogramBucket<bClassification>>(1, cBytesPerHistogramBucket);
+      HistogramBucket<bNeedDenominator> * const pDebugBucket =
+         EbmMalloc<HistogramBucket<bNeedDenominator>>(1, cBytesPerHistogramBucket);
 
-      HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * aHistogramBucketsDebugCopy =
-         aHistogramBucketsDebugCopyBase->GetHistogramBucket<bClassification>();
+      HistogramBucket<bNeedDenominator> * aHistogramBucketsDebugCopy =
+         aHistogramBucketsDebugCopyBase->GetHistogramBucket<bNeedDenominator>();
 
 #endif //NDEBUG
 
-      HistogramBucket<bClassification> * pHistogramBucket = aHistogramBuckets;
+      HistogramBucket<bNeedDenominator> * pHistogramBucket = aHistogramBuckets;
 
       while(true) {
          ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucket, aHistogramBucketsEndDebug);
 
-         HistogramBucket<bClassification> * pAddPrev = pHistogramBucket;
+         HistogramBucket<bNeedDenominator> * pAddPrev = pHistogramBucket;
          size_t iDimension = cDimensions;
          do {
             --iDimension;
-            HistogramBucket<bClassification> * pAddTo = fastTotalState[iDimension].m_pDimensionalCur;
+            HistogramBucket<bNeedDenominator> * pAddTo = fastTotalState[iDimension].m_pDimensionalCur;
             pAddTo->Add(*pAddPrev, cVectorLength);
             pAddPrev = pAddTo;
-            pAddTo = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pAddTo, 1);
+            pAddTo = GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pAddTo, 1);
             if(pAddTo == fastTotalState[iDimension].m_pDimensionalWrap) {
                pAddTo = fastTotalState[iDimension].m_pDimensionalFirst;
             }
@@ -279,7 +281,7 @@ public:
                aiStart[iDebugDimension] = 0;
                aiLast[iDebugDimension] = fastTotalState[iDebugDimension].m_iCur;
             }
-            TensorTotalsSumDebugSlow<bClassification>(
+            TensorTotalsSumDebugSlow<bNeedDenominator>(
                runtimeLearningTypeOrCountTargetClasses,
                pFeatureGroup,
                aHistogramBucketsDebugCopy,
@@ -293,7 +295,7 @@ public:
 
          // we're walking through all buckets, so just move to the next one in the flat array, 
          // with the knowledge that we'll figure out it's multi-dimenional index below
-         pHistogramBucket = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucket, 1);
+         pHistogramBucket = GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, pHistogramBucket, 1);
 
          FastTotalState * pFastTotalState = &fastTotalState[0];
          while(true) {
@@ -308,8 +310,8 @@ public:
             const char * const pEnd = reinterpret_cast<char *>(pFastTotalState->m_pDimensionalWrap);
             EBM_ASSERT(pCur != pEnd);
             do {
-               HistogramBucket<bClassification> * pHistogramBucketCur =
-                  reinterpret_cast<HistogramBucket<bClassification> *>(pCur);
+               HistogramBucket<bNeedDenominator> * pHistogramBucketCur =
+                  reinterpret_cast<HistogramBucket<bNeedDenominator> *>(pCur);
                pHistogramBucketCur->Zero(cVectorLength);
                pCur += cBytesPerHistogramBucket;
             } while(pEnd != pCur);
@@ -329,7 +331,270 @@ public:
    }
 };
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensionsPossible>
+#ifndef NDEBUG
+template<bool bClassification>
+static void TensorTotalsBuildCheckDebug(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const FeatureGroup * const pFeatureGroup,
+   const size_t cBytesPerHistogramBucket,
+   const HistogramBucket<bClassification> * const aHistogramBuckets,
+   const HistogramBucket<bClassification> * const aHistogramBucketsDebugCopy
+) {
+   // compare every cell against the slow version that sums the original histograms from the origin
+   if(nullptr == aHistogramBucketsDebugCopy) {
+      return;
+   }
+   HistogramBucket<bClassification> * const pDebugBucket =
+      EbmMalloc<HistogramBucket<bClassification>>(1, cBytesPerHistogramBucket);
+   if(nullptr == pDebugBucket) {
+      return;
+   }
+
+   const size_t cDimensions = pFeatureGroup->GetCountFeatures();
+   const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+
+   size_t aiStart[k_cDimensionsMax];
+   size_t aiLast[k_cDimensionsMax];
+   for(size_t iDimension = 0; iDimension < cDimensions; ++iDimension) {
+      aiStart[iDimension] = 0;
+      aiLast[iDimension] = 0;
+   }
+
+   const HistogramBucket<bClassification> * pHistogramBucket = aHistogramBuckets;
+   while(true) {
+      TensorTotalsSumDebugSlow<bClassification>(
+         runtimeLearningTypeOrCountTargetClasses,
+         pFeatureGroup,
+         aHistogramBucketsDebugCopy,
+         aiStart,
+         aiLast,
+         pDebugBucket
+      );
+      EBM_ASSERT(pDebugBucket->GetCountSamplesInBucket() == pHistogramBucket->GetCountSamplesInBucket());
+
+      pHistogramBucket = GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, pHistogramBucket, 1);
+
+      size_t iDimension = 0;
+      while(true) {
+         ++aiLast[iDimension];
+         if(LIKELY(aFeatureGroupEntries[iDimension].m_pFeature->GetCountBins() != aiLast[iDimension])) {
+            break;
+         }
+         aiLast[iDimension] = 0;
+         ++iDimension;
+         if(UNLIKELY(cDimensions == iDimension)) {
+            free(pDebugBucket);
+            return;
+         }
+      }
+   }
+}
+#endif // NDEBUG
+
+template<bool bClassification>
+INLINE_ALWAYS static void TensorTotalsSweep(
+   const size_t cVectorLength,
+   const size_t cBytesPerHistogramBucket,
+   HistogramBucket<bClassification> * const aHistogramBuckets,
+   const size_t cInner,
+   const size_t cSteps,
+   const size_t cOuter
+) {
+   // We view the tensor as [cOuter][cSteps][cInner] where cInner is contiguous in memory.  Adding each bucket into the 
+   // next one along the cSteps axis turns every line along that axis into running totals.  Doing this once for each 
+   // dimension leaves each bucket holding the totals from the origin to it, and we don't need any auxiliary memory.
+   //
+   // Each add depends on the add before it along the line, so we want the loop over the independent lines to be 
+   // innermost.  If the contiguous run in cInner is at least as long as the line then walking memory in order 
+   // already does that.  Otherwise (always for the first dimension, where cInner is 1) we put the steps in the outer 
+   // loop and walk across all the lines inside it, which puts the longer loop innermost regardless of how the 
+   // dimensions happen to be ordered in memory.
+
+   EBM_ASSERT(1 <= cInner);
+   EBM_ASSERT(1 <= cSteps);
+   EBM_ASSERT(1 <= cOuter);
+
+   if(UNLIKELY(1 == cSteps)) {
+      // a dimension with 1 bin has no lines to sum
+      return;
+   }
+
+   const size_t cBytesStep = cBytesPerHistogramBucket * cInner;
+   const size_t cBytesSlab = cBytesStep * cSteps;
+   char * const pStart = reinterpret_cast<char *>(aHistogramBuckets);
+   const char * const pEnd = pStart + cBytesSlab * cOuter;
+
+   if(cSteps <= cInner) {
+      char * pSlab = pStart;
+      do {
+         char * pCur = pSlab + cBytesStep;
+         const char * const pSlabEnd = pSlab + cBytesSlab;
+         do {
+            HistogramBucket<bClassification> * const pHistogramBucketCur =
+               reinterpret_cast<HistogramBucket<bClassification> *>(pCur);
+            const HistogramBucket<bClassification> * const pHistogramBucketPrev =
+               reinterpret_cast<const HistogramBucket<bClassification> *>(pCur - cBytesStep);
+            pHistogramBucketCur->Add(*pHistogramBucketPrev, cVectorLength);
+            pCur += cBytesPerHistogramBucket;
+         } while(pSlabEnd != pCur);
+         pSlab += cBytesSlab;
+      } while(pEnd != pSlab);
+   } else {
+      char * pStep = pStart + cBytesStep;
+      const char * const pStepEnd = pStart + cBytesSlab;
+      do {
+         char * pSlab = pStep;
+         do {
+            char * pCur = pSlab;
+            const char * const pRunEnd = pSlab + cBytesStep;
+            do {
+               HistogramBucket<bClassification> * const pHistogramBucketCur =
+                  reinterpret_cast<HistogramBucket<bClassification> *>(pCur);
+               const HistogramBucket<bClassification> * const pHistogramBucketPrev =
+                  reinterpret_cast<const HistogramBucket<bClassification> *>(pCur - cBytesStep);
+               pHistogramBucketCur->Add(*pHistogramBucketPrev, cVectorLength);
+               pCur += cBytesPerHistogramBucket;
+            } while(pRunEnd != pCur);
+            pSlab += cBytesSlab;
+         } while(pEnd + (pStep - pStart) != pSlab);
+         pStep += cBytesStep;
+      } while(pStepEnd != pStep);
+   }
+}
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, bool bNeedDenominator>
+class TensorTotalsBuildPair final {
+public:
+
+   TensorTotalsBuildPair() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const FeatureGroup * const pFeatureGroup,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , HistogramBucketBase * const aHistogramBucketsDebugCopyBase
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(!bNeedDenominator || IsClassification(compilerLearningTypeOrCountTargetClasses),
+         "only classification has denominators");
+
+      LOG_0(TraceLevelVerbose, "Entered TensorTotalsBuildPair");
+
+      HistogramBucket<bNeedDenominator> * const aHistogramBuckets =
+         aHistogramBucketBase->GetHistogramBucket<bNeedDenominator>();
+
+      EBM_ASSERT(2 == pFeatureGroup->GetCountFeatures());
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
+
+      const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+      const size_t cBins0 = aFeatureGroupEntries[0].m_pFeature->GetCountBins();
+      const size_t cBins1 = aFeatureGroupEntries[1].m_pFeature->GetCountBins();
+      // this function can handle 1 == cBins even though that's a degenerate case that shouldn't be boosted on
+      EBM_ASSERT(1 <= cBins0);
+      EBM_ASSERT(1 <= cBins1);
+      // we're accessing allocated memory, so this can't overflow
+      EBM_ASSERT(!IsMultiplyError(cBins0, cBins1));
+      EBM_ASSERT(reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBins0 * cBins1 * cBytesPerHistogramBucket <= 
+         aHistogramBucketsEndDebug);
+
+      // sum along the second dimension first since each of its adds covers an entire contiguous row of the first
+      TensorTotalsSweep<bNeedDenominator>(cVectorLength, cBytesPerHistogramBucket, aHistogramBuckets, cBins0, cBins1, 1);
+      TensorTotalsSweep<bNeedDenominator>(cVectorLength, cBytesPerHistogramBucket, aHistogramBuckets, 1, cBins0, cBins1);
+
+#ifndef NDEBUG
+      TensorTotalsBuildCheckDebug<bNeedDenominator>(
+         runtimeLearningTypeOrCountTargetClasses,
+         pFeatureGroup,
+         cBytesPerHistogramBucket,
+         aHistogramBuckets,
+         nullptr == aHistogramBucketsDebugCopyBase ? nullptr : 
+            aHistogramBucketsDebugCopyBase->GetHistogramBucket<bNeedDenominator>()
+      );
+#endif // NDEBUG
+
+      LOG_0(TraceLevelVerbose, "Exited TensorTotalsBuildPair");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, bool bNeedDenominator>
+class TensorTotalsBuildTriple final {
+public:
+
+   TensorTotalsBuildTriple() = delete; // this is a static class.  Do not construct
+
+   static void Func(
+      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+      const FeatureGroup * const pFeatureGroup,
+      HistogramBucketBase * const aHistogramBucketBase
+#ifndef NDEBUG
+      , HistogramBucketBase * const aHistogramBucketsDebugCopyBase
+      , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+   ) {
+      static_assert(!bNeedDenominator || IsClassification(compilerLearningTypeOrCountTargetClasses),
+         "only classification has denominators");
+
+      LOG_0(TraceLevelVerbose, "Entered TensorTotalsBuildTriple");
+
+      HistogramBucket<bNeedDenominator> * const aHistogramBuckets =
+         aHistogramBucketBase->GetHistogramBucket<bNeedDenominator>();
+
+      EBM_ASSERT(3 == pFeatureGroup->GetCountFeatures());
+
+      const ptrdiff_t learningTypeOrCountTargetClasses = GET_LEARNING_TYPE_OR_COUNT_TARGET_CLASSES(
+         compilerLearningTypeOrCountTargetClasses,
+         runtimeLearningTypeOrCountTargetClasses
+      );
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
+
+      const FeatureGroupEntry * const aFeatureGroupEntries = pFeatureGroup->GetFeatureGroupEntries();
+      const size_t cBins0 = aFeatureGroupEntries[0].m_pFeature->GetCountBins();
+      const size_t cBins1 = aFeatureGroupEntries[1].m_pFeature->GetCountBins();
+      const size_t cBins2 = aFeatureGroupEntries[2].m_pFeature->GetCountBins();
+      // this function can handle 1 == cBins even though that's a degenerate case that shouldn't be boosted on
+      EBM_ASSERT(1 <= cBins0);
+      EBM_ASSERT(1 <= cBins1);
+      EBM_ASSERT(1 <= cBins2);
+      // we're accessing allocated memory, so this can't overflow
+      EBM_ASSERT(!IsMultiplyError(cBins0, cBins1));
+      const size_t cBins01 = cBins0 * cBins1;
+      EBM_ASSERT(!IsMultiplyError(cBins01, cBins2));
+      EBM_ASSERT(reinterpret_cast<unsigned char *>(aHistogramBuckets) + cBins01 * cBins2 * cBytesPerHistogramBucket <=
+         aHistogramBucketsEndDebug);
+
+      // sum along the outermost dimension first since its adds cover entire contiguous planes, and the first
+      // dimension last since it's the only one where we need to walk across lines to avoid dependent adds
+      TensorTotalsSweep<bNeedDenominator>(cVectorLength, cBytesPerHistogramBucket, aHistogramBuckets, cBins01, cBins2, 1);
+      TensorTotalsSweep<bNeedDenominator>(cVectorLength, cBytesPerHistogramBucket, aHistogramBuckets, cBins0, cBins1, cBins2);
+      TensorTotalsSweep<bNeedDenominator>(cVectorLength, cBytesPerHistogramBucket, aHistogramBuckets, 1, cBins0, cBins1 * cBins2);
+
+#ifndef NDEBUG
+      TensorTotalsBuildCheckDebug<bNeedDenominator>(
+         runtimeLearningTypeOrCountTargetClasses,
+         pFeatureGroup,
+         cBytesPerHistogramBucket,
+         aHistogramBuckets,
+         nullptr == aHistogramBucketsDebugCopyBase ? nullptr :
+            aHistogramBucketsDebugCopyBase->GetHistogramBucket<bNeedDenominator>()
+      );
+#endif // NDEBUG
+
+      LOG_0(TraceLevelVerbose, "Exited TensorTotalsBuildTriple");
+   }
+};
+
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, bool bNeedDenominator>
 class TensorTotalsBuildDimensions final {
 public:
 
@@ -345,18 +610,24 @@ public:
       , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
    ) {
-      static_assert(2 <= compilerCountDimensionsPossible, "can't have less than 2 dimensions for interactions");
-      static_assert(compilerCountDimensionsPossible <= k_cDimensionsMax, "can't have more than the max dimensions");
-
-      const size_t runtimeCountDimensions = pFeatureGroup->GetCountFeatures();
+      const size_t cDimensions = pFeatureGroup->GetCountFeatures();
 
-      EBM_ASSERT(2 <= runtimeCountDimensions);
-      EBM_ASSERT(runtimeCountDimensions <= k_cDimensionsMax);
-      if(compilerCountDimensionsPossible == runtimeCountDimensions) {
-         TensorTotalsBuildInternal<compilerLearningTypeOrCountTargetClasses, compilerCountDimensionsPossible>::Func(
+      EBM_ASSERT(2 <= cDimensions);
+      EBM_ASSERT(cDimensions <= k_cDimensionsMax);
+      if(2 == cDimensions) {
+         TensorTotalsBuildPair<compilerLearningTypeOrCountTargetClasses, bNeedDenominator>::Func(
+            runtimeLearningTypeOrCountTargetClasses,
+            pFeatureGroup,
+            aHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else if(3 == cDimensions) {
+         TensorTotalsBuildTriple<compilerLearningTypeOrCountTargetClasses, bNeedDenominator>::Func(
             runtimeLearningTypeOrCountTargetClasses,
             pFeatureGroup,
-            pBucketAuxiliaryBuildZone,
             aHistogramBuckets
 #ifndef NDEBUG
             , aHistogramBucketsDebugCopy
@@ -364,7 +635,9 @@ public:
 #endif // NDEBUG
          );
       } else {
-         TensorTotalsBuildDimensions<compilerLearningTypeOrCountTargetClasses, compilerCountDimensionsPossible + 1>::Func(
+         // beyond triples the number of lines we'd sweep grows with each dimension, so the general version that
+         // makes a single pass using the auxiliary build zone is the better choice
+         TensorTotalsBuildInternal<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions, bNeedDenominator>::Func(
             runtimeLearningTypeOrCountTargetClasses,
             pFeatureGroup,
             pBucketAuxiliaryBuildZone,
@@ -378,38 +651,7 @@ public:
    }
 };
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses>
-class TensorTotalsBuildDimensions<compilerLearningTypeOrCountTargetClasses, k_cCompilerOptimizedCountDimensionsMax + 1> final {
-public:
-
-   TensorTotalsBuildDimensions() = delete; // this is a static class.  Do not construct
-
-   INLINE_ALWAYS static void Func(
-      const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
-      const FeatureGroup * const pFeatureGroup,
-      HistogramBucketBase * pBucketAuxiliaryBuildZone,
-      HistogramBucketBase * const aHistogramBuckets
-#ifndef NDEBUG
-      , HistogramBucketBase * const aHistogramBucketsDebugCopy
-      , const unsigned char * const aHistogramBucketsEndDebug
-#endif // NDEBUG
-   ) {
-      EBM_ASSERT(2 <= pFeatureGroup->GetCountFeatures());
-      EBM_ASSERT(pFeatureGroup->GetCountFeatures() <= k_cDimensionsMax);
-      TensorTotalsBuildInternal<compilerLearningTypeOrCountTargetClasses, k_dynamicDimensions>::Func(
-         runtimeLearningTypeOrCountTargetClasses,
-         pFeatureGroup,
-         pBucketAuxiliaryBuildZone,
-         aHistogramBuckets
-#ifndef NDEBUG
-         , aHistogramBucketsDebugCopy
-         , aHistogramBucketsEndDebug
-#endif // NDEBUG
-      );
-   }
-};
-
-template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible>
+template<ptrdiff_t compilerLearningTypeOrCountTargetClassesPossible, bool bNeedDenominator>
 class TensorTotalsBuildTarget final {
 public:
 
@@ -429,10 +671,10 @@ public:
       static_assert(compilerLearningTypeOrCountTargetClassesPossible <= k_cCompilerOptimizedTargetClassesMax, "We can't have this many items in a data pack.");
 
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
-      EBM_ASSERT(runtimeLearningTypeOrCountTargetClasses <= k_cCompilerOptimizedTargetClassesMax);
+      EBM_ASSERT(compilerLearningTypeOrCountTargetClassesPossible <= runtimeLearningTypeOrCountTargetClasses);
 
       if(compilerLearningTypeOrCountTargetClassesPossible == runtimeLearningTypeOrCountTargetClasses) {
-         TensorTotalsBuildDimensions<compilerLearningTypeOrCountTargetClassesPossible, 2>::Func(
+         TensorTotalsBuildDimensions<compilerLearningTypeOrCountTargetClassesPossible, bNeedDenominator>::Func(
             runtimeLearningTypeOrCountTargetClasses,
             pFeatureGroup,
             pBucketAuxiliaryBuildZone,
@@ -443,7 +685,7 @@ public:
 #endif // NDEBUG
          );
       } else {
-         TensorTotalsBuildTarget<compilerLearningTypeOrCountTargetClassesPossible + 1>::Func(
+         TensorTotalsBuildTarget<compilerLearningTypeOrCountTargetClassesPossible + 1, bNeedDenominator>::Func(
             runtimeLearningTypeOrCountTargetClasses,
             pFeatureGroup,
             pBucketAuxiliaryBuildZone,
@@ -457,8 +699,8 @@ public:
    }
 };
 
-template<>
-class TensorTotalsBuildTarget<k_cCompilerOptimizedTargetClassesMax + 1> final {
+template<bool bNeedDenominator>
+class TensorTotalsBuildTarget<k_cCompilerOptimizedTargetClassesMax + 1, bNeedDenominator> final {
 public:
 
    TensorTotalsBuildTarget() = delete; // this is a static class.  Do not construct
@@ -478,7 +720,7 @@ public:
       EBM_ASSERT(IsClassification(runtimeLearningTypeOrCountTargetClasses));
       EBM_ASSERT(k_cCompilerOptimizedTargetClassesMax < runtimeLearningTypeOrCountTargetClasses);
 
-      TensorTotalsBuildDimensions<k_dynamicClassification, 2>::Func(
+      TensorTotalsBuildDimensions<k_dynamicClassification, bNeedDenominator>::Func(
          runtimeLearningTypeOrCountTargetClasses,
          pFeatureGroup,
          pBucketAuxiliaryBuildZone,
@@ -491,8 +733,9 @@ public:
    }
 };
 
-extern void TensorTotalsBuild(
+static void TensorTotalsBuildTensor(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const bool bNeedDenominator,
    const FeatureGroup * const pFeatureGroup,
    HistogramBucketBase * pBucketAuxiliaryBuildZone,
    HistogramBucketBase * const aHistogramBuckets
@@ -502,7 +745,33 @@ extern void TensorTotalsBuild(
 #endif // NDEBUG
 ) {
    if(IsClassification(runtimeLearningTypeOrCountTargetClasses)) {
-      TensorTotalsBuildTarget<2>::Func(
+      if(bNeedDenominator) {
+         TensorTotalsBuildTarget<2, true>::Func(
+            runtimeLearningTypeOrCountTargetClasses,
+            pFeatureGroup,
+            pBucketAuxiliaryBuildZone,
+            aHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      } else {
+         TensorTotalsBuildTarget<2, false>::Func(
+            runtimeLearningTypeOrCountTargetClasses,
+            pFeatureGroup,
+            pBucketAuxiliaryBuildZone,
+            aHistogramBuckets
+#ifndef NDEBUG
+            , aHistogramBucketsDebugCopy
+            , aHistogramBucketsEndDebug
+#endif // NDEBUG
+         );
+      }
+   } else {
+      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
+      EBM_ASSERT(!bNeedDenominator);
+      TensorTotalsBuildDimensions<k_regression, false>::Func(
          runtimeLearningTypeOrCountTargetClasses,
          pFeatureGroup,
          pBucketAuxiliaryBuildZone,
@@ -512,19 +781,77 @@ extern void TensorTotalsBuild(
          , aHistogramBucketsEndDebug
 #endif // NDEBUG
       );
-   } else {
-      EBM_ASSERT(IsRegression(runtimeLearningTypeOrCountTargetClasses));
-      TensorTotalsBuildDimensions<k_regression, 2>::Func(
+   }
+}
+
+extern void TensorTotalsBuild(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const bool bNeedDenominator,
+   const FeatureGroup * const pFeatureGroup,
+   HistogramBucketBase * pBucketAuxiliaryBuildZone,
+   HistogramBucketBase * const aHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketsMirror
+#ifndef NDEBUG
+   , HistogramBucketBase * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   if(nullptr != aHistogramBucketsMirror) {
+      EBM_ASSERT(IsTensorTotalsMirrored(pFeatureGroup->GetCountFeatures()));
+
+      // the mirror holds the totals from each bin to the (1, 1, ..., 1, 1) corner.  Reversing the memory order reverses 
+      // the bins of every dimension, so we can copy the binned histograms in reverse and then build the usual totals 
+      // from the origin on the copy.  We need to copy before building our main totals since that overwrites the histograms.
+      const size_t cVectorLength = GetVectorLength(runtimeLearningTypeOrCountTargetClasses);
+      EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+      const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
+
+      size_t cTotalBuckets = 1;
+      const FeatureGroupEntry * pFeatureGroupEntry = pFeatureGroup->GetFeatureGroupEntries();
+      const FeatureGroupEntry * const pFeatureGroupEntryEnd = &pFeatureGroupEntry[pFeatureGroup->GetCountFeatures()];
+      do {
+         const size_t cBins = pFeatureGroupEntry->m_pFeature->GetCountBins();
+         EBM_ASSERT(!IsMultiplyError(cTotalBuckets, cBins)); // we're accessing allocated memory
+         cTotalBuckets *= cBins;
+         ++pFeatureGroupEntry;
+      } while(pFeatureGroupEntryEnd != pFeatureGroupEntry);
+      EBM_ASSERT(!IsMultiplyError(cTotalBuckets, cBytesPerHistogramBucket)); // we're accessing allocated memory
+
+      const unsigned char * pFrom = reinterpret_cast<const unsigned char *>(aHistogramBuckets);
+      unsigned char * pTo = reinterpret_cast<unsigned char *>(aHistogramBucketsMirror) + cTotalBuckets * cBytesPerHistogramBucket;
+      EBM_ASSERT(pTo <= aHistogramBucketsEndDebug);
+      do {
+         pTo -= cBytesPerHistogramBucket;
+         memcpy(pTo, pFrom, cBytesPerHistogramBucket);
+         pFrom += cBytesPerHistogramBucket;
+      } while(reinterpret_cast<unsigned char *>(aHistogramBucketsMirror) != pTo);
+
+      TensorTotalsBuildTensor(
          runtimeLearningTypeOrCountTargetClasses,
+         bNeedDenominator,
          pFeatureGroup,
          pBucketAuxiliaryBuildZone,
-         aHistogramBuckets
+         aHistogramBucketsMirror
 #ifndef NDEBUG
-         , aHistogramBucketsDebugCopy
+         // our debug copy isn't reversed, so we can't check the mirror here.  TensorTotalsSumMirrored checks each 
+         // region that it looks up in the mirror against the debug copy instead
+         , nullptr
          , aHistogramBucketsEndDebug
 #endif // NDEBUG
       );
    }
+
+   TensorTotalsBuildTensor(
+      runtimeLearningTypeOrCountTargetClasses,
+      bNeedDenominator,
+      pFeatureGroup,
+      pBucketAuxiliaryBuildZone,
+      aHistogramBuckets
+#ifndef NDEBUG
+      , aHistogramBucketsDebugCopy
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
 }
 
 // Boneyard of useful ideas below:
@@ -18,11 +18,32 @@
 #include "HistogramTargetEntry.h"
 #include "HistogramBucket.h"
 
+// Looking up the totals of a region that is on the high side of k dimensions takes 2^k lookups in the totals tensor, which 
+// gets expensive quickly for higher dimensional groups.  Groups with this many dimensions or more also keep a mirrored 
+// totals tensor that holds the totals from each bin to the far corner (1, 1, ..., 1, 1).  Any region is on the high side 
+// of at most half the dimensions in one of the two, so we need at most 2^(N/2) lookups for it instead of 2^N, 
+// for the price of twice the memory.  Pairs need at most 4 lookups anyways, so they don't bother.
+constexpr size_t k_cDimensionsTensorTotalsMirrorMin = 3;
+
+INLINE_ALWAYS bool IsTensorTotalsMirrored(const size_t cDimensions) {
+   return k_cDimensionsTensorTotalsMirrorMin <= cDimensions;
+}
+
+// the pair and triple builders in TensorTotalsBuild work in place, so only the general builder needs the auxiliary
+// zone to be zeroed before it runs.  The interaction gain functions overwrite any auxiliary bucket before they read it
+INLINE_ALWAYS bool IsTensorTotalsAuxiliaryZeroRequired(const size_t cDimensions) {
+   return 3 < cDimensions;
+}
+
+// bNeedDenominator selects the HistogramBucket<true> layout, which only classification boosting uses.  Interaction 
+// detection never looks at the denominators, so it builds its totals in the smaller HistogramBucket<false> layout
 extern void TensorTotalsBuild(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const bool bNeedDenominator,
    const FeatureGroup * const pFeatureGroup,
    HistogramBucketBase * pBucketAuxiliaryBuildZone,
-   HistogramBucketBase * const aHistogramBuckets
+   HistogramBucketBase * const aHistogramBuckets,
+   HistogramBucketBase * const aHistogramBucketsMirror
 #ifndef NDEBUG
    , HistogramBucketBase * const aHistogramBucketsDebugCopy
    , const unsigned char * const aHistogramBucketsEndDebug
@@ -142,16 +163,16 @@ void TensorTotalsCompareDebug(
 
 #endif // NDEBUG
 
-template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions>
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions, bool bNeedDenominator>
 void TensorTotalsSum(
    const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
    const FeatureGroup * const pFeatureGroup,
-   const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBuckets,
+   const HistogramBucket<bNeedDenominator> * const aHistogramBuckets,
    const size_t * const aiPoint,
    const size_t directionVector,
-   HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const pRet
+   HistogramBucket<bNeedDenominator> * const pRet
 #ifndef NDEBUG
-   , const HistogramBucket<IsClassification(compilerLearningTypeOrCountTargetClasses)> * const aHistogramBucketsDebugCopy
+   , const HistogramBucket<bNeedDenominator> * const aHistogramBucketsDebugCopy
    , const unsigned char * const aHistogramBucketsEndDebug
 #endif // NDEBUG
 ) {
@@ -160,7 +181,8 @@ void TensorTotalsSum(
       size_t m_cLast;
    };
 
-   constexpr bool bClassification = IsClassification(compilerLearningTypeOrCountTargetClasses);
+   static_assert(!bNeedDenominator || IsClassification(compilerLearningTypeOrCountTargetClasses),
+      "only classification has denominators");
 
    // don't LOG this!  It would create way too much chatter!
 
@@ -174,8 +196,8 @@ void TensorTotalsSum(
       runtimeLearningTypeOrCountTargetClasses
    );
    const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
-   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bClassification, cVectorLength)); // we're accessing allocated memory
-   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bClassification, cVectorLength);
+   EBM_ASSERT(!GetHistogramBucketSizeOverflow(bNeedDenominator, cVectorLength)); // we're accessing allocated memory
+   const size_t cBytesPerHistogramBucket = GetHistogramBucketSize(bNeedDenominator, cVectorLength);
 
    size_t multipleTotalInitialize = 1;
    size_t startingOffset = 0;
@@ -201,8 +223,8 @@ void TensorTotalsSum(
          ++pFeatureGroupEntry;
          ++piPointInitialize;
       } while(LIKELY(pFeatureGroupEntryEnd != pFeatureGroupEntry));
-      const HistogramBucket<bClassification> * const pHistogramBucket =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aHistogramBuckets, startingOffset);
+      const HistogramBucket<bNeedDenominator> * const pHistogramBucket =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, aHistogramBuckets, startingOffset);
       ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pRet, aHistogramBucketsEndDebug);
       ASSERT_BINNED_BUCKET_OK(cBytesPerHistogramBucket, pHistogramBucket, aHistogramBucketsEndDebug);
       pRet->Copy(*pHistogramBucket, cVectorLength);
@@ -273,8 +295,8 @@ void TensorTotalsSum(
       } while(LIKELY(pTotalsDimensionEnd != pTotalsDimensionLoop));
       // TODO : eliminate this multiplication of cBytesPerHistogramBucket by offsetPointer by multiplying both the startingOffset and the 
       // m_cLast & m_cIncrement values by cBytesPerHistogramBucket.  We can eliminate this multiplication each loop!
-      const HistogramBucket<bClassification> * const pHistogramBucket =
-         GetHistogramBucketByIndex<bClassification>(cBytesPerHistogramBucket, aHistogramBuckets, offsetPointer);
+      const HistogramBucket<bNeedDenominator> * const pHistogramBucket =
+         GetHistogramBucketByIndex<bNeedDenominator>(cBytesPerHistogramBucket, aHistogramBuckets, offsetPointer);
       // TODO : we can eliminate this really bad unpredictable branch if we use conditional negation on the values in pHistogramBucket.  
       // We can pass in a bool that indicates if we should take the negation value or the original at each step 
       // (so we don't need to store it beyond one value either).  We would then have an Add(bool bSubtract, ...) function
@@ -292,7 +314,7 @@ void TensorTotalsSum(
 
 #ifndef NDEBUG
    if(nullptr != aHistogramBucketsDebugCopy) {
-      TensorTotalsCompareDebug<bClassification>(
+      TensorTotalsCompareDebug<bNeedDenominator>(
          aHistogramBucketsDebugCopy,
          pFeatureGroup,
          aiPoint,
@@ -304,4 +326,96 @@ void TensorTotalsSum(
 #endif // NDEBUG
 }
 
+template<ptrdiff_t compilerLearningTypeOrCountTargetClasses, size_t compilerCountDimensions, bool bNeedDenominator>
+void TensorTotalsSumMirrored(
+   const ptrdiff_t runtimeLearningTypeOrCountTargetClasses,
+   const FeatureGroup * const pFeatureGroup,
+   const HistogramBucket<bNeedDenominator> * const aHistogramBuckets,
+   const HistogramBucket<bNeedDenominator> * const aHistogramBucketsMirror,
+   const size_t * const aiPoint,
+   const size_t directionVector,
+   HistogramBucket<bNeedDenominator> * const pRet
+#ifndef NDEBUG
+   , const HistogramBucket<bNeedDenominator> * const aHistogramBucketsDebugCopy
+   , const unsigned char * const aHistogramBucketsEndDebug
+#endif // NDEBUG
+) {
+   // The mirror is built from the tensor in reversed memory order, which reverses the bins in every dimension.  In the 
+   // mirror our point becomes (cBins - 2 - iPoint) and every dimension flips between the low and the high side, so if 
+   // we're on the high side of more than half the dimensions then the mirror needs fewer lookups.
+
+   // don't LOG this!  It would create way too much chatter!
+
+   if(nullptr != aHistogramBucketsMirror) {
+      const size_t cDimensions = GET_ATTRIBUTE_COMBINATION_DIMENSIONS(compilerCountDimensions, pFeatureGroup->GetCountFeatures());
+      EBM_ASSERT(IsTensorTotalsMirrored(cDimensions));
+      EBM_ASSERT(cDimensions < k_cBitsForSizeT);
+
+      size_t cHighDimensions = 0;
+      size_t directionVectorDestroy = directionVector;
+      while(0 != directionVectorDestroy) {
+         directionVectorDestroy &= directionVectorDestroy - 1;
+         ++cHighDimensions;
+      }
+      if(cDimensions < cHighDimensions * 2) {
+         size_t aiPointMirror[k_cDimensionsMax];
+         size_t iDimension = 0;
+         do {
+            const size_t cBins = pFeatureGroup->GetFeatureGroupEntries()[iDimension].m_pFeature->GetCountBins();
+            EBM_ASSERT(aiPoint[iDimension] < cBins);
+            if(UNLIKELY(cBins - 1 == aiPoint[iDimension])) {
+               // the point is on the last bin, which has no mirrored equivalent.  This doesn't happen when we're looking 
+               // at cuts, so just use the normal totals
+               break;
+            }
+            aiPointMirror[iDimension] = cBins - 2 - aiPoint[iDimension];
+            ++iDimension;
+         } while(cDimensions != iDimension);
+
+         if(LIKELY(cDimensions == iDimension)) {
+            const size_t directionVectorMirror = directionVector ^ ((size_t { 1 } << cDimensions) - 1);
+            TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, compilerCountDimensions, bNeedDenominator>(
+               runtimeLearningTypeOrCountTargetClasses,
+               pFeatureGroup,
+               aHistogramBucketsMirror,
+               aiPointMirror,
+               directionVectorMirror,
+               pRet
+#ifndef NDEBUG
+               // the debug copy isn't mirrored, so we compare against it below using our unmirrored point
+               , nullptr
+               , aHistogramBucketsEndDebug
+#endif // NDEBUG
+            );
+#ifndef NDEBUG
+            if(nullptr != aHistogramBucketsDebugCopy) {
+               TensorTotalsCompareDebug<bNeedDenominator>(
+                  aHistogramBucketsDebugCopy,
+                  pFeatureGroup,
+                  aiPoint,
+                  directionVector,
+                  runtimeLearningTypeOrCountTargetClasses,
+                  pRet
+               );
+            }
+#endif // NDEBUG
+            return;
+         }
+      }
+   }
+
+   TensorTotalsSum<compilerLearningTypeOrCountTargetClasses, compilerCountDimensions, bNeedDenominator>(
+      runtimeLearningTypeOrCountTargetClasses,
+      pFeatureGroup,
+      aHistogramBuckets,
+      aiPoint,
+      directionVector,
+      pRet
+#ifndef NDEBUG
+      , aHistogramBucketsDebugCopy
+      , aHistogramBucketsEndDebug
+#endif // NDEBUG
+   );
+}
+
 #endif // TENSOR_TOTALS_SUM_H
\ No newline at end of file
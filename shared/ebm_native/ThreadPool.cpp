@@ -0,0 +1,771 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeader.h"
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#ifndef EBM_NATIVE_R
+// R packages are not allowed to start threads that could call back into R (our logging does), so in R we
+// execute all work synchronously on the caller's thread
+#include <new> // placement new
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#ifdef __linux__
+#include <pthread.h> // pthread_setaffinity_np
+#include <sched.h> // cpu_set_t, sched_getaffinity
+#include <stdio.h> // fopen, fgets, snprintf
+#include <stdlib.h> // strtoul
+#endif // __linux__
+#endif // EBM_NATIVE_R
+
+#include "ebm_native.h"
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+#include "ThreadPool.h"
+#include "AlignedMemory.h" // GetNumaPlacement
+
+#ifndef EBM_NATIVE_R
+
+class ThreadPoolState final {
+public:
+   std::mutex m_mutex;
+   // signalled when new work is queued or when completed work might have unblocked work with the same key
+   std::condition_variable m_workAvailable;
+   // signalled when any work completes
+   std::condition_variable m_workCompleted;
+   std::vector<std::thread> m_threads;
+
+   // this list holds all work that has been submitted, but that has not yet completed, in submission order
+   AsyncWork * m_pWorkHead;
+   AsyncWork * m_pWorkTail;
+
+   // idle threads of the current generation.  Shutdown starts a new generation, and the threads of older 
+   // generations exit as soon as they wake up
+   size_t m_cThreadsIdle;
+   size_t m_iGeneration;
+
+#ifdef __linux__
+   // the CPUs that we may run on in each NUMA node that has any, which we read the first time that we pin a thread
+   std::vector<cpu_set_t> m_aNumaNodeCpus;
+   std::once_flag m_numaNodesRead;
+#endif // __linux__
+
+   ThreadPoolState() :
+      m_pWorkHead(nullptr),
+      m_pWorkTail(nullptr),
+      m_cThreadsIdle(0),
+      m_iGeneration(0) {
+   }
+};
+// our state is constructed in static storage and never destroyed.  A static destructor would run inside 
+// DLL_PROCESS_DETACH on Windows, where joining our threads deadlocks on the loader lock, and destroying the mutex 
+// and condition variables while our threads still wait on them is undefined.  At process exit the OS ends our 
+// threads, and callers that unload the library before then call ShutdownThreadPool first
+alignas(ThreadPoolState) static unsigned char g_threadPoolStateStorage[sizeof(ThreadPoolState)];
+static ThreadPoolState & g_threadPoolState = *new(static_cast<void *>(g_threadPoolStateStorage)) ThreadPoolState();
+
+INLINE_RELEASE_UNTEMPLATED static size_t GetCountThreadsMax() {
+   // hardware_concurrency returns 0 if it can't determine the number of hardware threads
+   const unsigned int cHardwareThreads = std::thread::hardware_concurrency();
+   return 0 == cHardwareThreads ? size_t { 1 } : static_cast<size_t>(cHardwareThreads);
+}
+
+#ifdef __linux__
+// reads a sysfs list like "0-3,8-11" into *pSet.  Returns true on error
+static bool ReadSysfsList(const char * const sPath, cpu_set_t * const pSet) {
+   CPU_ZERO(pSet);
+   FILE * const pFile = fopen(sPath, "r");
+   if(nullptr == pFile) {
+      return true;
+   }
+   char sLine[4096];
+   const bool bRead = nullptr != fgets(sLine, sizeof(sLine), pFile);
+   fclose(pFile);
+   if(!bRead) {
+      return true;
+   }
+   const char * pc = sLine;
+   while(true) {
+      char * pEnd;
+      const unsigned long iBegin = strtoul(pc, &pEnd, 10);
+      if(pEnd == pc) {
+         // nodes that only have memory have an empty cpu list
+         return false;
+      }
+      pc = pEnd;
+      unsigned long iEnd = iBegin;
+      if('-' == *pc) {
+         ++pc;
+         iEnd = strtoul(pc, &pEnd, 10);
+         if(pEnd == pc || iEnd < iBegin) {
+            return true;
+         }
+         pc = pEnd;
+      }
+      for(unsigned long i = iBegin; i <= iEnd && i < static_cast<unsigned long>(CPU_SETSIZE); ++i) {
+         CPU_SET(static_cast<size_t>(i), pSet);
+      }
+      if(',' != *pc) {
+         return false;
+      }
+      ++pc;
+   }
+}
+
+static void ReadNumaNodes() {
+   cpu_set_t allowed;
+   CPU_ZERO(&allowed);
+   if(0 != sched_getaffinity(0, sizeof(allowed), &allowed)) {
+      LOG_0(TraceLevelInfo, "INFO ReadNumaNodes sched_getaffinity failed.  Threads will not be pinned");
+      return;
+   }
+   // cpu_set_t is also a handy bit set for the node numbers, which are far below CPU_SETSIZE
+   cpu_set_t nodes;
+   if(ReadSysfsList("/sys/devices/system/node/online", &nodes)) {
+      LOG_0(TraceLevelInfo, "INFO ReadNumaNodes could not read the online NUMA nodes.  Threads will not be pinned");
+      return;
+   }
+   for(size_t iNode = 0; iNode < static_cast<size_t>(CPU_SETSIZE); ++iNode) {
+      if(CPU_ISSET(iNode, &nodes)) {
+         char sPath[64];
+         snprintf(sPath, sizeof(sPath), "/sys/devices/system/node/node%zu/cpulist", iNode);
+         cpu_set_t cpus;
+         if(!ReadSysfsList(sPath, &cpus)) {
+            // a container can restrict us to some of the CPUs of a node
+            CPU_AND(&cpus, &cpus, &allowed);
+            if(0 != CPU_COUNT(&cpus)) {
+               g_threadPoolState.m_aNumaNodeCpus.push_back(cpus);
+            }
+         }
+      }
+   }
+}
+
+static size_t GetCountNumaNodesPinned() {
+   if(NumaPlacementInterleavePinned != GetNumaPlacement()) {
+      return size_t { 1 };
+   }
+   try {
+      std::call_once(g_threadPoolState.m_numaNodesRead, ReadNumaNodes);
+   } catch(...) {
+      // call_once lets us try again next time
+      LOG_0(TraceLevelWarning, "WARNING GetCountNumaNodesPinned exception");
+      return size_t { 1 };
+   }
+   const size_t cNodes = g_threadPoolState.m_aNumaNodeCpus.size();
+   return size_t { 0 } == cNodes ? size_t { 1 } : cNodes;
+}
+
+static void PinThread(std::thread & thread, const size_t iThread) {
+   const size_t cNodes = GetCountNumaNodesPinned();
+   if(size_t { 1 } < cNodes) {
+      // spreading our threads round robin puts each node's share of the threads next to it's share of the interleaved 
+      // pages, and keeps the scheduler from moving a thread away from the histograms that it has first touched
+      const cpu_set_t * const pCpus = &g_threadPoolState.m_aNumaNodeCpus[iThread % cNodes];
+      if(0 != pthread_setaffinity_np(thread.native_handle(), sizeof(*pCpus), pCpus)) {
+         LOG_0(TraceLevelInfo, "INFO PinThread pthread_setaffinity_np failed.  The thread will not be pinned");
+      }
+   }
+}
+#else // __linux__
+static size_t GetCountNumaNodesPinned() {
+   return size_t { 1 };
+}
+
+static void PinThread(std::thread & thread, const size_t iThread) {
+   UNUSED(thread);
+   UNUSED(iThread);
+}
+#endif // __linux__
+
+bool ThreadPool::IsRunnable(const AsyncWork * const pAsyncWork) {
+   // the lock must be held by our caller
+
+   // work can run if it isn't running already and it doesn't share it's serialization key with any older work
+   EBM_ASSERT(nullptr != pAsyncWork);
+   if(pAsyncWork->m_bRunning) {
+      return false;
+   }
+   const void * const pSerializationKey = pAsyncWork->m_pSerializationKey;
+   if(nullptr == pSerializationKey) {
+      return true;
+   }
+   const AsyncWork * pOlder = g_threadPoolState.m_pWorkHead;
+   while(pOlder != pAsyncWork && pOlder->m_pSerializationKey != pSerializationKey) {
+      pOlder = pOlder->m_pNext;
+   }
+   return pOlder == pAsyncWork;
+}
+
+AsyncWork * ThreadPool::FindRunnableWork() {
+   // the lock must be held by our caller
+
+   // we're searching for the oldest runnable work.  There are rarely more than a handful of items in this list, so 
+   // the O(N^2) search is fine
+   for(AsyncWork * pAsyncWork = g_threadPoolState.m_pWorkHead; nullptr != pAsyncWork; pAsyncWork = pAsyncWork->m_pNext) {
+      if(IsRunnable(pAsyncWork)) {
+         return pAsyncWork;
+      }
+   }
+   return nullptr;
+}
+
+size_t ThreadPool::CountRunnableWork() {
+   // the lock must be held by our caller
+
+   size_t cRunnable = 0;
+   for(const AsyncWork * pAsyncWork = g_threadPoolState.m_pWorkHead; nullptr != pAsyncWork; pAsyncWork = pAsyncWork->m_pNext) {
+      if(IsRunnable(pAsyncWork)) {
+         ++cRunnable;
+      }
+   }
+   return cRunnable;
+}
+
+void ThreadPool::UnlinkWork(AsyncWork * const pAsyncWork) {
+   // the lock must be held by our caller
+
+   EBM_ASSERT(nullptr != pAsyncWork);
+
+   AsyncWork * pPrev = nullptr;
+   AsyncWork * pCur = g_threadPoolState.m_pWorkHead;
+   while(pCur != pAsyncWork) {
+      EBM_ASSERT(nullptr != pCur);
+      pPrev = pCur;
+      pCur = pCur->m_pNext;
+   }
+   if(nullptr == pPrev) {
+      g_threadPoolState.m_pWorkHead = pAsyncWork->m_pNext;
+   } else {
+      pPrev->m_pNext = pAsyncWork->m_pNext;
+   }
+   if(g_threadPoolState.m_pWorkTail == pAsyncWork) {
+      g_threadPoolState.m_pWorkTail = pPrev;
+   }
+   pAsyncWork->m_pNext = nullptr;
+}
+
+void ThreadPool::CompleteWork(AsyncWork * const pAsyncWork, const IntEbmType result, const FloatEbmType metric) {
+   // the lock must be held by our caller
+
+   EBM_ASSERT(nullptr != pAsyncWork);
+   EBM_ASSERT(pAsyncWork->m_bRunning);
+   EBM_ASSERT(!pAsyncWork->m_bDone);
+
+   UnlinkWork(pAsyncWork);
+
+   pAsyncWork->m_result = result;
+   pAsyncWork->m_metric = metric;
+   pAsyncWork->m_bRunning = false;
+   pAsyncWork->m_bDone = true;
+}
+
+void ThreadPool::WorkerThread(const size_t iGeneration) {
+   try {
+      std::unique_lock<std::mutex> lock(g_threadPoolState.m_mutex);
+      while(true) {
+         AsyncWork * pAsyncWork;
+         while(true) {
+            if(iGeneration != g_threadPoolState.m_iGeneration) {
+               return;
+            }
+            pAsyncWork = FindRunnableWork();
+            if(nullptr != pAsyncWork) {
+               break;
+            }
+            ++g_threadPoolState.m_cThreadsIdle;
+            g_threadPoolState.m_workAvailable.wait(lock);
+            // Shutdown zeroes the idle count of the generation that it ends
+            if(iGeneration == g_threadPoolState.m_iGeneration) {
+               --g_threadPoolState.m_cThreadsIdle;
+            }
+         }
+         pAsyncWork->m_bRunning = true;
+         lock.unlock();
+
+         FloatEbmType metric = FloatEbmType { 0 };
+         const IntEbmType result = (*pAsyncWork->m_pWorkFunction)(pAsyncWork, &metric);
+
+         lock.lock();
+         CompleteWork(pAsyncWork, result, metric);
+         // completing this work might allow queued work with the same serialization key to run
+         g_threadPoolState.m_workAvailable.notify_all();
+         g_threadPoolState.m_workCompleted.notify_all();
+      }
+   } catch(...) {
+      // std::mutex only throws if the OS can't lock, and there is nobody we can report the error to on this thread
+   }
+}
+
+bool ThreadPool::Submit(AsyncWork * const pAsyncWork) {
+   EBM_ASSERT(nullptr != pAsyncWork);
+   EBM_ASSERT(nullptr == pAsyncWork->m_pNext);
+   EBM_ASSERT(!pAsyncWork->m_bRunning);
+   EBM_ASSERT(!pAsyncWork->m_bDone);
+
+   try {
+      std::unique_lock<std::mutex> lock(g_threadPoolState.m_mutex);
+
+      if(nullptr == g_threadPoolState.m_pWorkTail) {
+         g_threadPoolState.m_pWorkHead = pAsyncWork;
+      } else {
+         g_threadPoolState.m_pWorkTail->m_pNext = pAsyncWork;
+      }
+      g_threadPoolState.m_pWorkTail = pAsyncWork;
+
+      // idle threads that we've already notified stay idle until they wake up and claim their work, so compare the 
+      // idle threads against all the work that they could claim rather than only our new work.  Otherwise two quick
+      // submissions could both count on the same idle thread and run one after the other
+      if(g_threadPoolState.m_cThreadsIdle < CountRunnableWork() && 
+         g_threadPoolState.m_threads.size() < GetCountThreadsMax()) 
+      {
+         try {
+            g_threadPoolState.m_threads.emplace_back(&ThreadPool::WorkerThread, g_threadPoolState.m_iGeneration);
+            PinThread(g_threadPoolState.m_threads.back(), g_threadPoolState.m_threads.size() - 1);
+         } catch(...) {
+            // we can continue with the threads that we already have
+            LOG_0(TraceLevelWarning, "WARNING ThreadPool::Submit could not start a new thread");
+         }
+      }
+
+      if(g_threadPoolState.m_threads.empty()) {
+         // we have no threads to run this work, so run it now on the caller's thread.  There can't be any other
+         // work in progress since all previous work would also have been run synchronously
+         EBM_ASSERT(g_threadPoolState.m_pWorkHead == pAsyncWork);
+         pAsyncWork->m_bRunning = true;
+         lock.unlock();
+
+         FloatEbmType metric = FloatEbmType { 0 };
+         const IntEbmType result = (*pAsyncWork->m_pWorkFunction)(pAsyncWork, &metric);
+
+         lock.lock();
+         CompleteWork(pAsyncWork, result, metric);
+         return false;
+      }
+   } catch(...) {
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::Submit exception");
+      return true;
+   }
+   g_threadPoolState.m_workAvailable.notify_one();
+   return false;
+}
+
+bool ThreadPool::Wait(
+   const size_t cAsyncWorks,
+   AsyncWork * const * const apAsyncWorks,
+   const bool bWaitAll,
+   ptrdiff_t * const piCompletedOut
+) {
+   EBM_ASSERT(0 == cAsyncWorks || nullptr != apAsyncWorks);
+   EBM_ASSERT(nullptr != piCompletedOut);
+
+   try {
+      std::unique_lock<std::mutex> lock(g_threadPoolState.m_mutex);
+      while(true) {
+         ptrdiff_t iCompleted = ptrdiff_t { -1 };
+         bool bPending = false;
+         for(size_t iAsyncWork = 0; iAsyncWork < cAsyncWorks; ++iAsyncWork) {
+            const AsyncWork * const pAsyncWork = apAsyncWorks[iAsyncWork];
+            if(nullptr != pAsyncWork) {
+               if(pAsyncWork->m_bDone) {
+                  if(ptrdiff_t { -1 } == iCompleted) {
+                     iCompleted = static_cast<ptrdiff_t>(iAsyncWork);
+                  }
+               } else {
+                  bPending = true;
+               }
+            }
+         }
+         if(!bPending || !bWaitAll && ptrdiff_t { -1 } != iCompleted) {
+            *piCompletedOut = iCompleted;
+            return false;
+         }
+         g_threadPoolState.m_workCompleted.wait(lock);
+      }
+   } catch(...) {
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::Wait exception");
+      return true;
+   }
+}
+
+void ThreadPool::WaitForSerializationKey(const void * const pSerializationKey) {
+   EBM_ASSERT(nullptr != pSerializationKey);
+
+   try {
+      std::unique_lock<std::mutex> lock(g_threadPoolState.m_mutex);
+      while(true) {
+         const AsyncWork * pAsyncWork = g_threadPoolState.m_pWorkHead;
+         while(nullptr != pAsyncWork && pAsyncWork->m_pSerializationKey != pSerializationKey) {
+            pAsyncWork = pAsyncWork->m_pNext;
+         }
+         if(nullptr == pAsyncWork) {
+            return;
+         }
+         g_threadPoolState.m_workCompleted.wait(lock);
+      }
+   } catch(...) {
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::WaitForSerializationKey exception");
+   }
+}
+
+bool ThreadPool::Shutdown() {
+   std::vector<std::thread> threads;
+   try {
+      {
+         std::lock_guard<std::mutex> lock(g_threadPoolState.m_mutex);
+         if(nullptr != g_threadPoolState.m_pWorkHead) {
+            LOG_0(TraceLevelError, "ERROR ThreadPool::Shutdown there is work in progress");
+            return true;
+         }
+         ++g_threadPoolState.m_iGeneration;
+         g_threadPoolState.m_cThreadsIdle = 0;
+         threads.swap(g_threadPoolState.m_threads);
+      }
+      g_threadPoolState.m_workAvailable.notify_all();
+      for(std::thread & thread : threads) {
+         thread.join();
+      }
+   } catch(...) {
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::Shutdown exception");
+      // std::thread's destructor terminates the process if the thread is still joinable.  Our threads exit on their
+      // own once they see the new generation
+      for(std::thread & thread : threads) {
+         try {
+            if(thread.joinable()) {
+               thread.detach();
+            }
+         } catch(...) {
+         }
+      }
+      return true;
+   }
+   return false;
+}
+
+class ParallelForState final {
+public:
+   // tasks are claimed by incrementing this counter, so each task is executed exactly once regardless of how many
+   // helpers manage to start before the caller finishes all the tasks itself
+   std::atomic<size_t> m_iTaskNext;
+   size_t m_cTasks;
+   PARALLEL_TASK_FUNCTION m_pTaskFunction;
+   void * m_pContext;
+};
+
+class ParallelForHelper final {
+public:
+   // m_asyncWork must be the first member since the work function casts the AsyncWork pointer back to us
+   AsyncWork m_asyncWork;
+   ParallelForState * m_pState;
+};
+static_assert(std::is_standard_layout<ParallelForHelper>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<ParallelForHelper>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+
+static void RunParallelTasks(ParallelForState * const pState) {
+   while(true) {
+      const size_t iTask = pState->m_iTaskNext.fetch_add(1, std::memory_order_relaxed);
+      if(pState->m_cTasks <= iTask) {
+         return;
+      }
+      (*pState->m_pTaskFunction)(pState->m_pContext, iTask);
+   }
+}
+
+static IntEbmType ParallelForHelperWorkFunction(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut) {
+   UNUSED(pMetricOut);
+   RunParallelTasks(reinterpret_cast<ParallelForHelper *>(pAsyncWork)->m_pState);
+   return IntEbmType { 0 };
+}
+
+void ThreadPool::WithdrawOrWait(AsyncWork * const pAsyncWork) {
+   EBM_ASSERT(nullptr != pAsyncWork);
+
+   try {
+      std::unique_lock<std::mutex> lock(g_threadPoolState.m_mutex);
+      if(!pAsyncWork->m_bRunning && !pAsyncWork->m_bDone) {
+         // nobody has picked this up yet, and there are no tasks left for it to do, so pull it out of the queue
+         UnlinkWork(pAsyncWork);
+         pAsyncWork->m_bDone = true;
+         return;
+      }
+      while(!pAsyncWork->m_bDone) {
+         g_threadPoolState.m_workCompleted.wait(lock);
+      }
+   } catch(...) {
+      // we can't return while a helper might still be referencing our stack, so spin without the condition variable
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::WithdrawOrWait exception");
+      while(true) {
+         try {
+            std::lock_guard<std::mutex> lock(g_threadPoolState.m_mutex);
+            if(pAsyncWork->m_bDone) {
+               return;
+            }
+         } catch(...) {
+         }
+         std::this_thread::yield();
+      }
+   }
+}
+
+size_t ThreadPool::GetCountThreads() {
+   return GetCountThreadsMax();
+}
+
+size_t ThreadPool::GetCountNumaNodes() {
+   return GetCountNumaNodesPinned();
+}
+
+void ThreadPool::ParallelFor(const size_t cTasks, const PARALLEL_TASK_FUNCTION pTaskFunction, void * const pContext) {
+   EBM_ASSERT(nullptr != pTaskFunction);
+
+   if(cTasks <= size_t { 1 }) {
+      if(size_t { 1 } == cTasks) {
+         (*pTaskFunction)(pContext, 0);
+      }
+      return;
+   }
+
+   ParallelForState state;
+   state.m_iTaskNext.store(0, std::memory_order_relaxed);
+   state.m_cTasks = cTasks;
+   state.m_pTaskFunction = pTaskFunction;
+   state.m_pContext = pContext;
+
+   // the caller executes tasks too, so we need one less helper than there are threads
+   const size_t cThreadsMax = GetCountThreadsMax();
+   size_t cHelpers = (cTasks < cThreadsMax ? cTasks : cThreadsMax) - size_t { 1 };
+   ParallelForHelper * aHelpers = nullptr;
+   if(size_t { 0 } != cHelpers) {
+      aHelpers = EbmMalloc<ParallelForHelper>(cHelpers);
+      if(nullptr == aHelpers) {
+         LOG_0(TraceLevelWarning, "WARNING ThreadPool::ParallelFor nullptr == aHelpers.  Executing serially");
+         cHelpers = 0;
+      }
+   }
+
+   size_t cSubmitted = 0;
+   while(cSubmitted < cHelpers) {
+      ParallelForHelper * const pHelper = &aHelpers[cSubmitted];
+      pHelper->m_asyncWork.Initialize(nullptr, ParallelForHelperWorkFunction);
+      pHelper->m_pState = &state;
+      if(Submit(&pHelper->m_asyncWork)) {
+         // the helpers that were submitted will pick up the slack
+         break;
+      }
+      ++cSubmitted;
+   }
+
+   RunParallelTasks(&state);
+
+   for(size_t iHelper = 0; iHelper < cSubmitted; ++iHelper) {
+      WithdrawOrWait(&aHelpers[iHelper].m_asyncWork);
+   }
+   free(aHelpers);
+}
+
+#else // EBM_NATIVE_R
+
+AsyncWork * ThreadPool::FindRunnableWork() {
+   return nullptr;
+}
+
+void ThreadPool::UnlinkWork(AsyncWork * const pAsyncWork) {
+   UNUSED(pAsyncWork);
+}
+
+void ThreadPool::CompleteWork(AsyncWork * const pAsyncWork, const IntEbmType result, const FloatEbmType metric) {
+   EBM_ASSERT(nullptr != pAsyncWork);
+   pAsyncWork->m_result = result;
+   pAsyncWork->m_metric = metric;
+   pAsyncWork->m_bRunning = false;
+   pAsyncWork->m_bDone = true;
+}
+
+bool ThreadPool::IsRunnable(const AsyncWork * const pAsyncWork) {
+   UNUSED(pAsyncWork);
+   return false;
+}
+
+size_t ThreadPool::CountRunnableWork() {
+   return 0;
+}
+
+void ThreadPool::WorkerThread(const size_t iGeneration) {
+   UNUSED(iGeneration);
+}
+
+bool ThreadPool::Submit(AsyncWork * const pAsyncWork) {
+   EBM_ASSERT(nullptr != pAsyncWork);
+   EBM_ASSERT(!pAsyncWork->m_bDone);
+
+   pAsyncWork->m_bRunning = true;
+   FloatEbmType metric = FloatEbmType { 0 };
+   const IntEbmType result = (*pAsyncWork->m_pWorkFunction)(pAsyncWork, &metric);
+   CompleteWork(pAsyncWork, result, metric);
+   return false;
+}
+
+bool ThreadPool::Wait(
+   const size_t cAsyncWorks,
+   AsyncWork * const * const apAsyncWorks,
+   const bool bWaitAll,
+   ptrdiff_t * const piCompletedOut
+) {
+   UNUSED(bWaitAll);
+   EBM_ASSERT(0 == cAsyncWorks || nullptr != apAsyncWorks);
+   EBM_ASSERT(nullptr != piCompletedOut);
+
+   // all work is completed synchronously inside Submit
+   for(size_t iAsyncWork = 0; iAsyncWork < cAsyncWorks; ++iAsyncWork) {
+      if(nullptr != apAsyncWorks[iAsyncWork]) {
+         EBM_ASSERT(apAsyncWorks[iAsyncWork]->m_bDone);
+         *piCompletedOut = static_cast<ptrdiff_t>(iAsyncWork);
+         return false;
+      }
+   }
+   *piCompletedOut = ptrdiff_t { -1 };
+   return false;
+}
+
+void ThreadPool::WaitForSerializationKey(const void * const pSerializationKey) {
+   UNUSED(pSerializationKey);
+}
+
+bool ThreadPool::Shutdown() {
+   return false;
+}
+
+void ThreadPool::WithdrawOrWait(AsyncWork * const pAsyncWork) {
+   UNUSED(pAsyncWork);
+}
+
+size_t ThreadPool::GetCountThreads() {
+   return size_t { 1 };
+}
+
+size_t ThreadPool::GetCountNumaNodes() {
+   return size_t { 1 };
+}
+
+void ThreadPool::ParallelFor(const size_t cTasks, const PARALLEL_TASK_FUNCTION pTaskFunction, void * const pContext) {
+   EBM_ASSERT(nullptr != pTaskFunction);
+   for(size_t iTask = 0; iTask < cTasks; ++iTask) {
+      (*pTaskFunction)(pContext, iTask);
+   }
+}
+
+#endif // EBM_NATIVE_R
+
+IntEbmType ThreadPool::Finish(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut) {
+   EBM_ASSERT(nullptr != pAsyncWork);
+
+   ptrdiff_t iCompleted;
+   if(Wait(1, &pAsyncWork, true, &iCompleted)) {
+      LOG_0(TraceLevelWarning, "WARNING ThreadPool::Finish Wait(1, &pAsyncWork, true, &iCompleted)");
+      if(nullptr != pMetricOut) {
+         *pMetricOut = FloatEbmType { 0 };
+      }
+      return IntEbmType { 1 };
+   }
+   EBM_ASSERT(0 == iCompleted);
+   // the lock inside Wait provides the memory barrier that makes the worker thread's writes visible here
+   if(nullptr != pMetricOut) {
+      *pMetricOut = pAsyncWork->m_metric;
+   }
+   return pAsyncWork->m_result;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION WaitForWork(
+   IntEbmType countWorks,
+   const PEbmWork * works,
+   IntEbmType isWaitAll,
+   IntEbmType * indexCompletedOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered WaitForWork: countWorks=%" IntEbmTypePrintf ", works=%p, isWaitAll=%" IntEbmTypePrintf ", indexCompletedOut=%p",
+      countWorks,
+      static_cast<const void *>(works),
+      isWaitAll,
+      static_cast<void *>(indexCompletedOut)
+   );
+
+   if(countWorks < 0) {
+      LOG_0(TraceLevelError, "ERROR WaitForWork countWorks must not be negative");
+      return 1;
+   }
+   if(0 != countWorks && nullptr == works) {
+      LOG_0(TraceLevelError, "ERROR WaitForWork works cannot be nullptr if 0 < countWorks");
+      return 1;
+   }
+   if(!IsNumberConvertable<size_t>(countWorks)) {
+      // the caller should not have been able to allocate enough memory in "works" if this didn't fit in memory
+      LOG_0(TraceLevelError, "ERROR WaitForWork !IsNumberConvertable<size_t>(countWorks)");
+      return 1;
+   }
+
+   ptrdiff_t iCompleted;
+   if(ThreadPool::Wait(
+      static_cast<size_t>(countWorks),
+      reinterpret_cast<AsyncWork * const *>(works),
+      EBM_FALSE != isWaitAll,
+      &iCompleted
+   )) {
+      LOG_0(TraceLevelWarning, "WARNING WaitForWork ThreadPool::Wait");
+      return 1;
+   }
+   if(nullptr != indexCompletedOut) {
+      *indexCompletedOut = static_cast<IntEbmType>(iCompleted);
+   }
+
+   LOG_N(TraceLevelInfo, "Exited WaitForWork %td", iCompleted);
+   return 0;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION FinishWork(
+   PEbmWork work,
+   FloatEbmType * metricOut
+) {
+   LOG_N(
+      TraceLevelInfo,
+      "Entered FinishWork: work=%p, metricOut=%p",
+      static_cast<void *>(work),
+      static_cast<void *>(metricOut)
+   );
+
+   if(nullptr == work) {
+      LOG_0(TraceLevelError, "ERROR FinishWork work cannot be nullptr");
+      if(nullptr != metricOut) {
+         *metricOut = FloatEbmType { 0 };
+      }
+      return 1;
+   }
+
+   AsyncWork * const pAsyncWork = reinterpret_cast<AsyncWork *>(work);
+   const IntEbmType ret = ThreadPool::Finish(pAsyncWork, metricOut);
+   // AsyncWork is the first member of the allocation made by the *Async function, so this frees the entire thing
+   free(pAsyncWork);
+
+   LOG_N(TraceLevelInfo, "Exited FinishWork %" IntEbmTypePrintf, ret);
+   return ret;
+}
+
+EBM_NATIVE_IMPORT_EXPORT_BODY IntEbmType EBM_NATIVE_CALLING_CONVENTION ShutdownThreadPool() {
+   LOG_0(TraceLevelInfo, "Entered ShutdownThreadPool");
+
+   if(ThreadPool::Shutdown()) {
+      LOG_0(TraceLevelWarning, "WARNING ShutdownThreadPool ThreadPool::Shutdown()");
+      return 1;
+   }
+
+   LOG_0(TraceLevelInfo, "Exited ShutdownThreadPool");
+   return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stddef.h> // size_t, ptrdiff_t
+
+#include "ebm_native.h" // IntEbmType, FloatEbmType
+#include "EbmInternal.h" // INLINE_ALWAYS
+#include "Logging.h" // EBM_ASSERT & LOG
+
+class AsyncWork;
+
+// the work function returns the same error code that the equivalent synchronous exported function would return.
+// It can optionally write a metric into *pMetricOut, which is handed back to the caller through FinishWork
+typedef IntEbmType (* ASYNC_WORK_FUNCTION)(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut);
+
+// a parallel task is called once for each iTask in [0, cTasks).  Tasks must not depend on the order in which they
+// execute, and they cannot report errors, so anything that can fail needs to happen before the tasks are launched
+typedef void (* PARALLEL_TASK_FUNCTION)(void * const pContext, const size_t iTask);
+
+class AsyncWork final {
+   // AsyncWork is a header that is placed as the FIRST member of a larger standard layout class which holds the
+   // parameters of the work (struct hack).  The work function casts the AsyncWork pointer back to the larger class.
+   //
+   // All the non-const members below are protected by the thread pool lock after the work has been submitted.
+
+   AsyncWork * m_pNext;
+
+   // work items that share the same non-null serialization key are executed one at a time in the order that
+   // they were submitted.  We use the EbmBoostingState pointer as our key since a single booster is not
+   // thread safe, but different boosters can be processed in parallel without any coordination.  Each step on a
+   // booster also reads the residuals that the previous step wrote, so there is nothing to overlap within one key
+   const void * m_pSerializationKey;
+
+   ASYNC_WORK_FUNCTION m_pWorkFunction;
+
+   IntEbmType m_result;
+   FloatEbmType m_metric;
+
+   bool m_bRunning;
+   bool m_bDone;
+
+   friend class ThreadPool;
+
+public:
+
+   AsyncWork() = default; // preserve our POD status
+   ~AsyncWork() = default; // preserve our POD status
+   void * operator new(std::size_t) = delete; // we only use malloc/free in this library
+   void operator delete (void *) = delete; // we only use malloc/free in this library
+
+   INLINE_ALWAYS void Initialize(const void * const pSerializationKey, const ASYNC_WORK_FUNCTION pWorkFunction) {
+      EBM_ASSERT(nullptr != pWorkFunction);
+
+      m_pNext = nullptr;
+      m_pSerializationKey = pSerializationKey;
+      m_pWorkFunction = pWorkFunction;
+      m_result = IntEbmType { 1 };
+      m_metric = FloatEbmType { 0 };
+      m_bRunning = false;
+      m_bDone = false;
+   }
+};
+static_assert(std::is_standard_layout<AsyncWork>::value,
+   "We use the struct hack in several places, so disallow non-standard_layout types in general");
+static_assert(std::is_trivial<AsyncWork>::value,
+   "We use memcpy in several places, so disallow non-trivial types in general");
+static_assert(std::is_pod<AsyncWork>::value,
+   "We use a lot of C constructs, so disallow non-POD types in general");
+
+class ThreadPool final {
+   // The thread pool is a process wide singleton.  Threads are started lazily on the first submission and live
+   // until Shutdown or the end of the process.  All the state lives inside ThreadPool.cpp since it requires STL classes
+   // that we don't want to leak into all our other translation units.
+   //
+   // If we can't start any threads (or threading is disabled, as it is in R), work is executed synchronously
+   // inside Submit, which means that callers never need to special case single threaded environments.
+
+public:
+
+   ThreadPool() = delete; // this is a static class.  Do not construct
+
+   // returns true on error, in which case the work was not queued and the caller still owns it
+   static bool Submit(AsyncWork * const pAsyncWork);
+
+   // waits until all the non-null works are done if bWaitAll is true, otherwise until at least one is done.
+   // Returns the lowest index of a completed work through *piCompletedOut, or -1 if there are no non-null works.
+   // Returns true on error
+   static bool Wait(
+      const size_t cAsyncWorks,
+      AsyncWork * const * const apAsyncWorks,
+      const bool bWaitAll,
+      ptrdiff_t * const piCompletedOut
+   );
+
+   // waits for a single work to complete and then returns it's result.  The caller still owns the memory.
+   static IntEbmType Finish(AsyncWork * const pAsyncWork, FloatEbmType * const pMetricOut);
+
+   // blocks until there is no queued or running work for pSerializationKey.  We call this before freeing the
+   // object that the key refers to, since otherwise a worker thread could be using the object as we free it
+   static void WaitForSerializationKey(const void * const pSerializationKey);
+
+   // executes all cTasks and returns once every task has completed.  The calling thread executes tasks too, and
+   // we never wait on helper work that hasn't started, so this is safe to call from inside work that is already
+   // running on the pool.  If we can't obtain helpers the tasks are executed serially on the caller's thread
+   static void ParallelFor(const size_t cTasks, const PARALLEL_TASK_FUNCTION pTaskFunction, void * const pContext);
+
+   // joins all our threads, which must happen before the library is unloaded from a running process.  Work submitted
+   // afterwards starts new threads.  Returns true on error, including if there is any work in progress
+   static bool Shutdown();
+
+   // the number of NUMA nodes that we pin our threads over, which is 1 unless SetNumaPlacement asked for 
+   // NumaPlacementInterleavePinned on a linux machine with several nodes.  Callers that reduce per node use this
+   static size_t GetCountNumaNodes();
+
+   // the most threads, including the caller's, that ParallelFor will execute tasks on.  Callers that need scratch
+   // memory per task can use this to avoid creating more tasks than can run at once
+   static size_t GetCountThreads();
+
+private:
+
+   static void WorkerThread(const size_t iGeneration);
+   static bool IsRunnable(const AsyncWork * const pAsyncWork);
+   static AsyncWork * FindRunnableWork();
+   static size_t CountRunnableWork();
+   static void UnlinkWork(AsyncWork * const pAsyncWork);
+   static void CompleteWork(AsyncWork * const pAsyncWork, const IntEbmType result, const FloatEbmType metric);
+   static void WithdrawOrWait(AsyncWork * const pAsyncWork);
+};
+
+#endif // THREAD_POOL_H
@@ -37,6 +37,8 @@ struct TreeNodeData<true> {
       const HistogramBucket<true> * m_pHistogramBucketEntryFirst;
       const HistogramBucket<true> * m_pHistogramBucketEntryLast;
       size_t m_cSamples;
+      // our parent computed this while choosing its split, so we keep it instead of recomputing it to get our gain
+      FloatEbmType m_splittingScore;
    };
    static_assert(std::is_standard_layout<BeforeExaminationForPossibleSplitting>::value,
       "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -113,6 +115,15 @@ struct TreeNodeData<true> {
       m_UNION.m_beforeExaminationForPossibleSplitting.m_pHistogramBucketEntryLast = pHistogramBucketEntryLast;
    }
 
+   INLINE_ALWAYS FloatEbmType BEFORE_GetSplittingScore() const {
+      EBM_ASSERT(!IsExaminedForPossibleSplitting());
+      return m_UNION.m_beforeExaminationForPossibleSplitting.m_splittingScore;
+   }
+   INLINE_ALWAYS void BEFORE_SetSplittingScore(const FloatEbmType splittingScore) {
+      EBM_ASSERT(!IsExaminedForPossibleSplitting());
+      m_UNION.m_beforeExaminationForPossibleSplitting.m_splittingScore = splittingScore;
+   }
+
    INLINE_ALWAYS const TreeNode<true> * AFTER_GetTreeNodeChildren() const {
       EBM_ASSERT(IsExaminedForPossibleSplitting());
       return m_UNION.m_afterExaminationForPossibleSplitting.m_pTreeNodeChildren;
@@ -203,6 +214,8 @@ struct TreeNodeData<false> {
 
       const HistogramBucket<false> * m_pHistogramBucketEntryFirst;
       const HistogramBucket<false> * m_pHistogramBucketEntryLast;
+      // our parent computed this while choosing its split, so we keep it instead of recomputing it to get our gain
+      FloatEbmType m_splittingScore;
    };
    static_assert(std::is_standard_layout<BeforeExaminationForPossibleSplitting>::value,
       "We use the struct hack in several places, so disallow non-standard_layout types in general");
@@ -277,6 +290,15 @@ struct TreeNodeData<false> {
       m_UNION.m_beforeExaminationForPossibleSplitting.m_pHistogramBucketEntryLast = pHistogramBucketEntryLast;
    }
 
+   INLINE_ALWAYS FloatEbmType BEFORE_GetSplittingScore() const {
+      EBM_ASSERT(!IsExaminedForPossibleSplitting());
+      return m_UNION.m_beforeExaminationForPossibleSplitting.m_splittingScore;
+   }
+   INLINE_ALWAYS void BEFORE_SetSplittingScore(const FloatEbmType splittingScore) {
+      EBM_ASSERT(!IsExaminedForPossibleSplitting());
+      m_UNION.m_beforeExaminationForPossibleSplitting.m_splittingScore = splittingScore;
+   }
+
    INLINE_ALWAYS const TreeNode<false> * AFTER_GetTreeNodeChildren() const {
       EBM_ASSERT(IsExaminedForPossibleSplitting());
       return m_UNION.m_afterExaminationForPossibleSplitting.m_pTreeNodeChildren;
@@ -20,6 +20,9 @@ struct SweepTreeNode final {
 private:
    size_t m_cBestSamplesLeft;
    const HistogramBucket<bClassification> * m_pBestHistogramBucketEntry;
+   // the splitting scores of each side, which become the splitting scores of the children if we choose this split
+   FloatEbmType m_bestSplittingScoreLeft;
+   FloatEbmType m_bestSplittingScoreRight;
 
    // use the "struct hack" since Flexible array member method is not available in C++
    // m_aBestHistogramBucketVectorEntry must be the last item in this struct
@@ -51,6 +54,22 @@ public:
       m_pBestHistogramBucketEntry = pBestHistogramBucketEntry;
    }
 
+   INLINE_ALWAYS FloatEbmType GetBestSplittingScoreLeft() {
+      return m_bestSplittingScoreLeft;
+   }
+
+   INLINE_ALWAYS void SetBestSplittingScoreLeft(FloatEbmType bestSplittingScoreLeft) {
+      m_bestSplittingScoreLeft = bestSplittingScoreLeft;
+   }
+
+   INLINE_ALWAYS FloatEbmType GetBestSplittingScoreRight() {
+      return m_bestSplittingScoreRight;
+   }
+
+   INLINE_ALWAYS void SetBestSplittingScoreRight(FloatEbmType bestSplittingScoreRight) {
+      m_bestSplittingScoreRight = bestSplittingScoreRight;
+   }
+
    INLINE_ALWAYS HistogramBucketVectorEntry<bClassification> * GetBestHistogramBucketVectorEntry() {
       return ArrayToPointer(m_aBestHistogramBucketVectorEntry);
    }
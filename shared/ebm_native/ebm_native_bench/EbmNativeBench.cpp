@@ -0,0 +1,997 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+// ebm_native_bench times the public entry points of ebm_native on synthetic data.  It only uses the public C API, so
+// it measures exactly what our python and R callers see.  Each benchmark is run -repeat times and we report the
+// min, median and mean wall clock time of a repeat along with the number of calls that a repeat makes.  The min is
+// the most stable number to compare between builds.  Results are written as one JSON object per line, or as CSV,
+// so that a release script can diff them against a previous run:
+//
+//   ebm_native_bench -rows 100000 -features 10 -bins 256 -classes 2 -output bench.json
+//
+// -classes 0 benchmarks regression.  -filter runs only the benchmarks whose name contains the given text
+
+#define _CRT_SECURE_NO_DEPRECATE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <inttypes.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "ebm_native.h"
+
+struct BenchOptions final {
+   size_t m_cRows;
+   size_t m_cFeatures;
+   size_t m_cBins;
+   size_t m_cClasses;
+   size_t m_cPairs;
+   size_t m_cRounds;
+   size_t m_cRepeat;
+   uint64_t m_seed;
+   bool m_bCsv;
+   const char * m_sFilter;
+   const char * m_sOutput;
+};
+
+static BenchOptions g_options;
+static FILE * g_pOutput = nullptr;
+static bool g_bCsvHeaderWritten = false;
+
+static void Usage() {
+   fprintf(stderr,
+      "usage: ebm_native_bench [-rows N] [-features N] [-bins N] [-classes N] [-pairs N] [-rounds N] [-repeat N]\n"
+      "                        [-seed N] [-format json|csv] [-filter TEXT] [-output FILE]\n"
+      "  -classes 0 benchmarks regression, 2 binary classification and above 2 multiclass\n"
+   );
+}
+
+static bool ParseCount(const char * const sValue, size_t * const pCountOut) {
+   if(nullptr == sValue) {
+      return true;
+   }
+   char * pEnd = nullptr;
+   const unsigned long long value = strtoull(sValue, &pEnd, 10);
+   if(pEnd == sValue || '\0' != *pEnd) {
+      return true;
+   }
+   *pCountOut = static_cast<size_t>(value);
+   return false;
+}
+
+static bool ParseOptions(const int argc, char ** const argv) {
+   g_options.m_cRows = 100000;
+   g_options.m_cFeatures = 10;
+   g_options.m_cBins = 256;
+   g_options.m_cClasses = 2;
+   g_options.m_cPairs = 10;
+   g_options.m_cRounds = 5;
+   g_options.m_cRepeat = 5;
+   g_options.m_seed = 42;
+   g_options.m_bCsv = false;
+   g_options.m_sFilter = nullptr;
+   g_options.m_sOutput = nullptr;
+
+   for(int iArg = 1; iArg < argc; ++iArg) {
+      const char * const sArg = argv[iArg];
+      const char * const sValue = iArg + 1 < argc ? argv[iArg + 1] : nullptr;
+      ++iArg;
+      size_t seed;
+      if(0 == strcmp(sArg, "-rows")) {
+         if(ParseCount(sValue, &g_options.m_cRows)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-features")) {
+         if(ParseCount(sValue, &g_options.m_cFeatures)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-bins")) {
+         if(ParseCount(sValue, &g_options.m_cBins)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-classes")) {
+         if(ParseCount(sValue, &g_options.m_cClasses)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-pairs")) {
+         if(ParseCount(sValue, &g_options.m_cPairs)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-rounds")) {
+         if(ParseCount(sValue, &g_options.m_cRounds)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-repeat")) {
+         if(ParseCount(sValue, &g_options.m_cRepeat)) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-seed")) {
+         if(ParseCount(sValue, &seed)) {
+            return true;
+         }
+         g_options.m_seed = static_cast<uint64_t>(seed);
+      } else if(0 == strcmp(sArg, "-format")) {
+         if(nullptr == sValue) {
+            return true;
+         }
+         if(0 == strcmp(sValue, "csv")) {
+            g_options.m_bCsv = true;
+         } else if(0 != strcmp(sValue, "json")) {
+            return true;
+         }
+      } else if(0 == strcmp(sArg, "-filter")) {
+         if(nullptr == sValue) {
+            return true;
+         }
+         g_options.m_sFilter = sValue;
+      } else if(0 == strcmp(sArg, "-output")) {
+         if(nullptr == sValue) {
+            return true;
+         }
+         g_options.m_sOutput = sValue;
+      } else {
+         return true;
+      }
+   }
+
+   if(g_options.m_cRows < 2 || 0 == g_options.m_cFeatures || g_options.m_cBins < 2 || 1 == g_options.m_cClasses ||
+      0 == g_options.m_cRepeat || 0 == g_options.m_cRounds)
+   {
+      return true;
+   }
+   return false;
+}
+
+static bool IsRegression() {
+   return 0 == g_options.m_cClasses;
+}
+
+static size_t GetVectorLength() {
+   return g_options.m_cClasses <= 2 ? size_t { 1 } : g_options.m_cClasses;
+}
+
+static bool IsSelected(const char * const sName) {
+   return nullptr == g_options.m_sFilter || nullptr != strstr(sName, g_options.m_sFilter);
+}
+
+static void CheckSuccess(const bool bFailed, const char * const sName) {
+   if(bFailed) {
+      fprintf(stderr, "ebm_native_bench: %s failed\n", sName);
+      exit(1);
+   }
+}
+
+// we generate our own random numbers instead of using the library's so that the data does not change if the
+// library's random number generator changes
+class BenchRandom final {
+   uint64_t m_state;
+
+public:
+
+   explicit BenchRandom(const uint64_t seed) : m_state(seed) {
+   }
+
+   uint64_t Next() {
+      // splitmix64
+      m_state += uint64_t { 0x9E3779B97F4A7C15 };
+      uint64_t z = m_state;
+      z = (z ^ (z >> 30)) * uint64_t { 0xBF58476D1CE4E5B9 };
+      z = (z ^ (z >> 27)) * uint64_t { 0x94D049BB133111EB };
+      return z ^ (z >> 31);
+   }
+
+   double NextUnit() {
+      return static_cast<double>(Next() >> 11) * (1.0 / 9007199254740992.0);
+   }
+};
+
+// a repeat is timed as a whole, and cCalls is the number of calls into the library that it makes, so that the time
+// per call can be derived from the output
+class BenchTimer final {
+   std::vector<uint64_t> m_nanoseconds;
+   std::chrono::steady_clock::time_point m_start;
+
+public:
+
+   void Start() {
+      m_start = std::chrono::steady_clock::now();
+   }
+
+   void Stop() {
+      const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+      m_nanoseconds.push_back(static_cast<uint64_t>(
+         std::chrono::duration_cast<std::chrono::nanoseconds>(stop - m_start).count()));
+   }
+
+   // for repeats that are timed in pieces, so that the setup between the calls isn't counted
+   void Add(const uint64_t nanoseconds) {
+      m_nanoseconds.push_back(nanoseconds);
+   }
+
+   void Report(const char * const sName, const size_t cCalls, const size_t cRowsPerCall) {
+      std::sort(m_nanoseconds.begin(), m_nanoseconds.end());
+      const size_t cRepeat = m_nanoseconds.size();
+      uint64_t total = 0;
+      for(const uint64_t nanoseconds : m_nanoseconds) {
+         total += nanoseconds;
+      }
+      const uint64_t minNanoseconds = m_nanoseconds[0];
+      const uint64_t medianNanoseconds = m_nanoseconds[cRepeat / 2];
+      const uint64_t meanNanoseconds = total / cRepeat;
+      const double nanosecondsPerCall = static_cast<double>(minNanoseconds) / static_cast<double>(cCalls);
+      const double rowsPerSecond = 0 == minNanoseconds ? 0.0 :
+         static_cast<double>(cRowsPerCall) * static_cast<double>(cCalls) * 1e9 / static_cast<double>(minNanoseconds);
+
+      if(g_options.m_bCsv) {
+         if(!g_bCsvHeaderWritten) {
+            g_bCsvHeaderWritten = true;
+            fprintf(g_pOutput, "benchmark,rows,features,bins,classes,repeat,calls,min_ns,median_ns,mean_ns,"
+               "ns_per_call,rows_per_second\n");
+         }
+         fprintf(g_pOutput, "%s,%zu,%zu,%zu,%zu,%zu,%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f,%.1f\n",
+            sName, g_options.m_cRows, g_options.m_cFeatures, g_options.m_cBins, g_options.m_cClasses, cRepeat, cCalls,
+            minNanoseconds, medianNanoseconds, meanNanoseconds, nanosecondsPerCall, rowsPerSecond);
+      } else {
+         fprintf(g_pOutput, "{\"benchmark\": \"%s\", \"rows\": %zu, \"features\": %zu, \"bins\": %zu, "
+            "\"classes\": %zu, \"repeat\": %zu, \"calls\": %zu, \"min_ns\": %" PRIu64 ", \"median_ns\": %" PRIu64
+            ", \"mean_ns\": %" PRIu64 ", \"ns_per_call\": %.1f, \"rows_per_second\": %.1f}\n",
+            sName, g_options.m_cRows, g_options.m_cFeatures, g_options.m_cBins, g_options.m_cClasses, cRepeat, cCalls,
+            minNanoseconds, medianNanoseconds, meanNanoseconds, nanosecondsPerCall, rowsPerSecond);
+      }
+      fflush(g_pOutput);
+      m_nanoseconds.clear();
+   }
+};
+
+// the synthetic data set.  Raw feature values and binned data are column major, like DiscretizeFeatures
+struct BenchData final {
+   size_t m_cTrainingSamples;
+   size_t m_cValidationSamples;
+
+   std::vector<FloatEbmType> m_trainingValues;
+   std::vector<FloatEbmType> m_validationValues;
+   std::vector<FloatEbmType> m_trainingTargetsRegression;
+   std::vector<FloatEbmType> m_validationTargetsRegression;
+   std::vector<IntEbmType> m_trainingTargetsClassification;
+   std::vector<IntEbmType> m_validationTargetsClassification;
+   std::vector<FloatEbmType> m_trainingScores;
+   std::vector<FloatEbmType> m_validationScores;
+
+   std::vector<IntEbmType> m_countBinCuts;
+   std::vector<FloatEbmType> m_binCuts;
+   std::vector<IntEbmType> m_trainingBinned;
+   std::vector<IntEbmType> m_validationBinned;
+
+   std::vector<EbmNativeFeature> m_features;
+   std::vector<EbmNativeFeatureGroup> m_featureGroups;
+   std::vector<IntEbmType> m_featureGroupIndexes;
+   size_t m_cMainGroups;
+   std::vector<IntEbmType> m_pairIndexes;
+};
+
+static FloatEbmType GenerateValue(BenchRandom & random, const size_t iFeature) {
+   const double unit = random.NextUnit();
+   switch(iFeature % 4) {
+   case 0:
+      // continuous and uniform
+      return unit * 100.0;
+   case 1:
+      // continuous with a long tail
+      return -log(1.0 - unit);
+   case 2:
+      // lots of duplicates, like a rounded measurement
+      return floor(unit * 50.0) * 0.5;
+   default:
+      // a handful of distinct values, like a categorical encoded as a number
+      return floor(unit * unit * 8.0);
+   }
+}
+
+static void GenerateSamples(
+   BenchRandom & random,
+   const size_t cSamples,
+   std::vector<FloatEbmType> & values,
+   std::vector<FloatEbmType> & targetsRegression,
+   std::vector<IntEbmType> & targetsClassification
+) {
+   const size_t cFeatures = g_options.m_cFeatures;
+   values.resize(cSamples * cFeatures);
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         values[iFeature * cSamples + iSample] = GenerateValue(random, iFeature);
+      }
+   }
+
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      // an additive signal with one interaction, so that both the mains and the pairs have something to find
+      double signal = 0.0;
+      for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+         const double value = values[iFeature * cSamples + iSample];
+         signal += sin(value * 0.1 + static_cast<double>(iFeature));
+      }
+      if(2 <= cFeatures) {
+         signal += values[iSample] * 0.01 * values[cSamples + iSample];
+      }
+      const double noise = random.NextUnit() - 0.5;
+      if(IsRegression()) {
+         targetsRegression.push_back(signal + noise);
+      } else {
+         const double unit = 1.0 / (1.0 + exp(-(signal + noise)));
+         const size_t iClass = std::min(static_cast<size_t>(unit * static_cast<double>(g_options.m_cClasses)),
+            g_options.m_cClasses - 1);
+         targetsClassification.push_back(static_cast<IntEbmType>(iClass));
+      }
+   }
+}
+
+static void GenerateData(BenchData & data) {
+   BenchRandom random(g_options.m_seed);
+
+   const size_t cFeatures = g_options.m_cFeatures;
+   data.m_cTrainingSamples = g_options.m_cRows;
+   data.m_cValidationSamples = std::max(g_options.m_cRows / 4, size_t { 1 });
+
+   GenerateSamples(random, data.m_cTrainingSamples, data.m_trainingValues, data.m_trainingTargetsRegression,
+      data.m_trainingTargetsClassification);
+   GenerateSamples(random, data.m_cValidationSamples, data.m_validationValues, data.m_validationTargetsRegression,
+      data.m_validationTargetsClassification);
+
+   data.m_trainingScores.resize(data.m_cTrainingSamples * GetVectorLength());
+   data.m_validationScores.resize(data.m_cValidationSamples * GetVectorLength());
+
+   // the binning used for boosting is the quantile binning that our python code uses by default
+   const IntEbmType cBinCutsMax = static_cast<IntEbmType>(g_options.m_cBins - 1);
+   data.m_countBinCuts.resize(cFeatures, cBinCutsMax);
+   data.m_binCuts.resize(cFeatures * (g_options.m_cBins - 1));
+   CheckSuccess(0 != GenerateBinCutsFeatures(
+      BinningTypeQuantile,
+      static_cast<IntEbmType>(data.m_cTrainingSamples),
+      static_cast<IntEbmType>(cFeatures),
+      &data.m_trainingValues[0],
+      1,
+      EBM_FALSE,
+      static_cast<IntEbmType>(g_options.m_seed),
+      &data.m_countBinCuts[0],
+      &data.m_binCuts[0],
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr,
+      nullptr
+   ), "GenerateBinCutsFeatures");
+
+   data.m_trainingBinned.resize(data.m_cTrainingSamples * cFeatures);
+   data.m_validationBinned.resize(data.m_cValidationSamples * cFeatures);
+   CheckSuccess(0 != DiscretizeFeatures(static_cast<IntEbmType>(data.m_cTrainingSamples),
+      static_cast<IntEbmType>(cFeatures), &data.m_trainingValues[0], &data.m_countBinCuts[0], &data.m_binCuts[0],
+      &data.m_trainingBinned[0]), "DiscretizeFeatures");
+   CheckSuccess(0 != DiscretizeFeatures(static_cast<IntEbmType>(data.m_cValidationSamples),
+      static_cast<IntEbmType>(cFeatures), &data.m_validationValues[0], &data.m_countBinCuts[0], &data.m_binCuts[0],
+      &data.m_validationBinned[0]), "DiscretizeFeatures");
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      EbmNativeFeature feature;
+      feature.featureType = FeatureTypeOrdinal;
+      feature.hasMissing = EBM_FALSE;
+      // we have no missing values, so Discretize never uses the bin above the last cut
+      feature.countBins = data.m_countBinCuts[iFeature] + 1;
+      data.m_features.push_back(feature);
+   }
+
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      EbmNativeFeatureGroup featureGroup;
+      featureGroup.countFeaturesInGroup = 1;
+      data.m_featureGroups.push_back(featureGroup);
+      data.m_featureGroupIndexes.push_back(static_cast<IntEbmType>(iFeature));
+   }
+   data.m_cMainGroups = cFeatures;
+
+   // pairs of neighbouring features, then pairs further apart, until we have m_cPairs of them
+   for(size_t iDistance = 1; iDistance < cFeatures; ++iDistance) {
+      for(size_t iFeature = 0; iFeature + iDistance < cFeatures; ++iFeature) {
+         if(g_options.m_cPairs <= data.m_pairIndexes.size() / 2) {
+            break;
+         }
+         data.m_pairIndexes.push_back(static_cast<IntEbmType>(iFeature));
+         data.m_pairIndexes.push_back(static_cast<IntEbmType>(iFeature + iDistance));
+      }
+   }
+   for(const IntEbmType iFeature : data.m_pairIndexes) {
+      data.m_featureGroupIndexes.push_back(iFeature);
+   }
+   for(size_t iPair = 0; iPair < data.m_pairIndexes.size() / 2; ++iPair) {
+      EbmNativeFeatureGroup featureGroup;
+      featureGroup.countFeaturesInGroup = 2;
+      data.m_featureGroups.push_back(featureGroup);
+   }
+}
+
+static PEbmBoosting InitializeBoosting(
+   const BenchData & data,
+   const size_t cInnerBags,
+   const FloatEbmType * const optionalTempParams = nullptr
+) {
+   if(IsRegression()) {
+      return InitializeBoostingRegression(
+         static_cast<IntEbmType>(data.m_features.size()),
+         &data.m_features[0],
+         static_cast<IntEbmType>(data.m_featureGroups.size()),
+         &data.m_featureGroups[0],
+         &data.m_featureGroupIndexes[0],
+         static_cast<IntEbmType>(data.m_cTrainingSamples),
+         &data.m_trainingBinned[0],
+         &data.m_trainingTargetsRegression[0],
+         &data.m_trainingScores[0],
+         static_cast<IntEbmType>(data.m_cValidationSamples),
+         &data.m_validationBinned[0],
+         &data.m_validationTargetsRegression[0],
+         &data.m_validationScores[0],
+         static_cast<IntEbmType>(cInnerBags),
+         static_cast<IntEbmType>(g_options.m_seed),
+         optionalTempParams
+      );
+   } else {
+      return InitializeBoostingClassification(
+         static_cast<IntEbmType>(g_options.m_cClasses),
+         static_cast<IntEbmType>(data.m_features.size()),
+         &data.m_features[0],
+         static_cast<IntEbmType>(data.m_featureGroups.size()),
+         &data.m_featureGroups[0],
+         &data.m_featureGroupIndexes[0],
+         static_cast<IntEbmType>(data.m_cTrainingSamples),
+         &data.m_trainingBinned[0],
+         &data.m_trainingTargetsClassification[0],
+         &data.m_trainingScores[0],
+         static_cast<IntEbmType>(data.m_cValidationSamples),
+         &data.m_validationBinned[0],
+         &data.m_validationTargetsClassification[0],
+         &data.m_validationScores[0],
+         static_cast<IntEbmType>(cInnerBags),
+         static_cast<IntEbmType>(g_options.m_seed),
+         optionalTempParams
+      );
+   }
+}
+
+static PEbmInteraction InitializeInteraction(const BenchData & data) {
+   if(IsRegression()) {
+      return InitializeInteractionRegression(
+         static_cast<IntEbmType>(data.m_features.size()),
+         &data.m_features[0],
+         static_cast<IntEbmType>(data.m_cTrainingSamples),
+         &data.m_trainingBinned[0],
+         &data.m_trainingTargetsRegression[0],
+         &data.m_trainingScores[0],
+         nullptr
+      );
+   } else {
+      return InitializeInteractionClassification(
+         static_cast<IntEbmType>(g_options.m_cClasses),
+         static_cast<IntEbmType>(data.m_features.size()),
+         &data.m_features[0],
+         static_cast<IntEbmType>(data.m_cTrainingSamples),
+         &data.m_trainingBinned[0],
+         &data.m_trainingTargetsClassification[0],
+         &data.m_trainingScores[0],
+         nullptr
+      );
+   }
+}
+
+static void BenchBinning(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cTrainingSamples;
+   const size_t cFeatures = g_options.m_cFeatures;
+   const size_t cBinCutsMax = g_options.m_cBins - 1;
+   std::vector<FloatEbmType> values(cSamples);
+   std::vector<FloatEbmType> binCuts(cFeatures * cBinCutsMax);
+   std::vector<IntEbmType> countBinCuts(cFeatures);
+
+   static const IntEbmType k_binningTypes[] = { BinningTypeQuantile, BinningTypeWinsorized, BinningTypeUniform };
+   static const char * const k_binningNames[] = {
+      "GenerateQuantileBinCuts", "GenerateWinsorizedBinCuts", "GenerateUniformBinCuts"
+   };
+   for(size_t iType = 0; iType < sizeof(k_binningTypes) / sizeof(k_binningTypes[0]); ++iType) {
+      const char * const sName = k_binningNames[iType];
+      if(!IsSelected(sName)) {
+         continue;
+      }
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         IntEbmType ret = 0;
+         uint64_t nanoseconds = 0;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            // these sort featureValues in place, so each call gets a fresh copy that we don't time
+            memcpy(&values[0], &data.m_trainingValues[iFeature * cSamples], sizeof(FloatEbmType) * cSamples);
+            IntEbmType countBinCutsInOut = static_cast<IntEbmType>(cBinCutsMax);
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if(BinningTypeQuantile == k_binningTypes[iType]) {
+               ret = GenerateQuantileBinCuts(static_cast<IntEbmType>(cSamples), &values[0], 1, EBM_FALSE,
+                  static_cast<IntEbmType>(g_options.m_seed), &countBinCutsInOut, &binCuts[0], nullptr, nullptr,
+                  nullptr, nullptr, nullptr);
+            } else if(BinningTypeWinsorized == k_binningTypes[iType]) {
+               ret = GenerateWinsorizedBinCuts(static_cast<IntEbmType>(cSamples), &values[0], &countBinCutsInOut,
+                  &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr);
+            } else {
+               GenerateUniformBinCuts(static_cast<IntEbmType>(cSamples), &values[0], &countBinCutsInOut,
+                  &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr);
+            }
+            const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+            nanoseconds += static_cast<uint64_t>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+            CheckSuccess(0 != ret, sName);
+         }
+         timer.Add(nanoseconds);
+      }
+      timer.Report(sName, cFeatures, cSamples);
+   }
+
+   if(IsSelected("GenerateQuantileBinCutsHumanized")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         uint64_t nanoseconds = 0;
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            memcpy(&values[0], &data.m_trainingValues[iFeature * cSamples], sizeof(FloatEbmType) * cSamples);
+            IntEbmType countBinCutsInOut = static_cast<IntEbmType>(cBinCutsMax);
+            const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            const IntEbmType ret = GenerateQuantileBinCuts(static_cast<IntEbmType>(cSamples), &values[0], 1, 
+               EBM_TRUE, static_cast<IntEbmType>(g_options.m_seed), &countBinCutsInOut, &binCuts[0], nullptr, 
+               nullptr, nullptr, nullptr, nullptr);
+            const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+            nanoseconds += static_cast<uint64_t>(
+               std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count());
+            CheckSuccess(0 != ret, "GenerateQuantileBinCutsHumanized");
+         }
+         timer.Add(nanoseconds);
+      }
+      timer.Report("GenerateQuantileBinCutsHumanized", cFeatures, cSamples);
+   }
+
+   if(IsSelected("GenerateBinCutsFeatures")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            countBinCuts[iFeature] = static_cast<IntEbmType>(cBinCutsMax);
+         }
+         timer.Start();
+         const IntEbmType ret = GenerateBinCutsFeatures(BinningTypeQuantile, static_cast<IntEbmType>(cSamples),
+            static_cast<IntEbmType>(cFeatures), &data.m_trainingValues[0], 1, EBM_FALSE,
+            static_cast<IntEbmType>(g_options.m_seed), &countBinCuts[0], &binCuts[0], nullptr, nullptr, nullptr,
+            nullptr, nullptr);
+         timer.Stop();
+         CheckSuccess(0 != ret, "GenerateBinCutsFeatures");
+      }
+      timer.Report("GenerateBinCutsFeatures", 1, cSamples * cFeatures);
+   }
+
+   if(IsSelected("QuantileSketch")) {
+      // a sketch of one feature streamed in chunks, the way a caller binning a column too large to copy would
+      const size_t cChunk = 4096;
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         IntEbmType countBinCutsInOut = static_cast<IntEbmType>(cBinCutsMax);
+         timer.Start();
+         PEbmQuantileSketch pSketch = CreateQuantileSketch(1024, static_cast<IntEbmType>(g_options.m_seed));
+         CheckSuccess(nullptr == pSketch, "CreateQuantileSketch");
+         for(size_t iSample = 0; iSample < cSamples; iSample += cChunk) {
+            const size_t cAdd = std::min(cChunk, cSamples - iSample);
+            CheckSuccess(0 != AddToQuantileSketch(pSketch, static_cast<IntEbmType>(cAdd),
+               &data.m_trainingValues[iSample]), "AddToQuantileSketch");
+         }
+         const IntEbmType ret = GenerateQuantileBinCutsFromSketch(pSketch, 1, EBM_FALSE,
+            static_cast<IntEbmType>(g_options.m_seed), &countBinCutsInOut, &binCuts[0], nullptr, nullptr, nullptr,
+            nullptr, nullptr);
+         FreeQuantileSketch(pSketch);
+         timer.Stop();
+         CheckSuccess(0 != ret, "GenerateQuantileBinCutsFromSketch");
+      }
+      timer.Report("QuantileSketch", 1, cSamples);
+   }
+}
+
+static void BenchDiscretize(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cTrainingSamples;
+   const size_t cFeatures = g_options.m_cFeatures;
+   std::vector<IntEbmType> discretized(cSamples * cFeatures);
+
+   if(IsSelected("Discretize")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         const FloatEbmType * pBinCuts = &data.m_binCuts[0];
+         for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+            CheckSuccess(0 != Discretize(static_cast<IntEbmType>(cSamples), &data.m_trainingValues[iFeature * cSamples],
+               data.m_countBinCuts[iFeature], pBinCuts, &discretized[iFeature * cSamples]), "Discretize");
+            pBinCuts += data.m_countBinCuts[iFeature];
+         }
+         timer.Stop();
+      }
+      timer.Report("Discretize", cFeatures, cSamples);
+   }
+
+   if(IsSelected("DiscretizeFeatures")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         const IntEbmType ret = DiscretizeFeatures(static_cast<IntEbmType>(cSamples), static_cast<IntEbmType>(cFeatures),
+            &data.m_trainingValues[0], &data.m_countBinCuts[0], &data.m_binCuts[0], &discretized[0]);
+         timer.Stop();
+         CheckSuccess(0 != ret, "DiscretizeFeatures");
+      }
+      timer.Report("DiscretizeFeatures", 1, cSamples * cFeatures);
+   }
+
+   if(IsSelected("CreatePackedData")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         PEbmPackedData pPackedData = CreatePackedData(static_cast<IntEbmType>(data.m_features.size()),
+            &data.m_features[0], static_cast<IntEbmType>(data.m_featureGroups.size()), &data.m_featureGroups[0],
+            &data.m_featureGroupIndexes[0], static_cast<IntEbmType>(cSamples), &data.m_trainingBinned[0]);
+         CheckSuccess(nullptr == pPackedData, "CreatePackedData");
+         ClosePackedData(pPackedData);
+         timer.Stop();
+      }
+      timer.Report("CreatePackedData", 1, cSamples);
+   }
+}
+
+static void BenchBoosting(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cTrainingSamples;
+   const size_t cMainGroups = data.m_cMainGroups;
+   const size_t cPairGroups = data.m_featureGroups.size() - cMainGroups;
+   const FloatEbmType learningRate = 0.01;
+   const IntEbmType countTreeSplitsMax = 3;
+   const IntEbmType countSamplesRequiredForChildSplitMin = 2;
+
+   if(IsSelected("InitializeBoosting")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+         timer.Stop();
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("InitializeBoosting", 1, cSamples);
+   }
+
+   if(IsSelected("GenerateModelFeatureGroupUpdate") || IsSelected("ApplyModelFeatureGroupUpdate")) {
+      BenchTimer timerApply;
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         uint64_t nanosecondsGenerate = 0;
+         uint64_t nanosecondsApply = 0;
+         for(size_t iRound = 0; iRound < g_options.m_cRounds; ++iRound) {
+            for(size_t iFeatureGroup = 0; iFeatureGroup < cMainGroups; ++iFeatureGroup) {
+               FloatEbmType gain;
+               FloatEbmType validationMetric;
+               const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+               FloatEbmType * const pUpdate = GenerateModelFeatureGroupUpdate(pBoosting,
+                  static_cast<IntEbmType>(iFeatureGroup), learningRate, countTreeSplitsMax,
+                  countSamplesRequiredForChildSplitMin, nullptr, nullptr, &gain);
+               const std::chrono::steady_clock::time_point middle = std::chrono::steady_clock::now();
+               CheckSuccess(nullptr == pUpdate, "GenerateModelFeatureGroupUpdate");
+               const IntEbmType ret = ApplyModelFeatureGroupUpdate(pBoosting, static_cast<IntEbmType>(iFeatureGroup),
+                  pUpdate, &validationMetric);
+               const std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now();
+               CheckSuccess(0 != ret, "ApplyModelFeatureGroupUpdate");
+               nanosecondsGenerate += static_cast<uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count());
+               nanosecondsApply += static_cast<uint64_t>(
+                  std::chrono::duration_cast<std::chrono::nanoseconds>(stop - middle).count());
+            }
+         }
+         FreeBoosting(pBoosting);
+         timer.Add(nanosecondsGenerate);
+         timerApply.Add(nanosecondsApply);
+      }
+      timer.Report("GenerateModelFeatureGroupUpdate", g_options.m_cRounds * cMainGroups, cSamples);
+      timerApply.Report("ApplyModelFeatureGroupUpdate", g_options.m_cRounds * cMainGroups, cSamples);
+   }
+
+   if(IsSelected("BoostingStep")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         timer.Start();
+         for(size_t iRound = 0; iRound < g_options.m_cRounds; ++iRound) {
+            for(size_t iFeatureGroup = 0; iFeatureGroup < cMainGroups; ++iFeatureGroup) {
+               FloatEbmType validationMetric;
+               CheckSuccess(0 != BoostingStep(pBoosting, static_cast<IntEbmType>(iFeatureGroup), learningRate,
+                  countTreeSplitsMax, countSamplesRequiredForChildSplitMin, nullptr, nullptr, &validationMetric),
+                  "BoostingStep");
+            }
+         }
+         timer.Stop();
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("BoostingStep", g_options.m_cRounds * cMainGroups, cSamples);
+   }
+
+   if(IsSelected("BoostingStepAlignedPacking")) {
+      // compare against BoostingStep.  Bin counts that don't need a power of two bits, like 100, are where aligning 
+      // moves us off the dynamic unpacking loop and onto the byte, short and int specializations
+      std::vector<FloatEbmType> tempParams(TempParamBoostingAlignedPacking + 1, FloatEbmType { 0 });
+      tempParams[0] = static_cast<FloatEbmType>(TempParamBoostingAlignedPacking);
+      tempParams[TempParamBoostingAlignedPacking] = FloatEbmType { 2 };
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0, &tempParams[0]);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         timer.Start();
+         for(size_t iRound = 0; iRound < g_options.m_cRounds; ++iRound) {
+            for(size_t iFeatureGroup = 0; iFeatureGroup < cMainGroups; ++iFeatureGroup) {
+               FloatEbmType validationMetric;
+               CheckSuccess(0 != BoostingStep(pBoosting, static_cast<IntEbmType>(iFeatureGroup), learningRate,
+                  countTreeSplitsMax, countSamplesRequiredForChildSplitMin, nullptr, nullptr, &validationMetric),
+                  "BoostingStep");
+            }
+         }
+         timer.Stop();
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("BoostingStepAlignedPacking", g_options.m_cRounds * cMainGroups, cSamples);
+   }
+
+   if(0 != cPairGroups && IsSelected("BoostingStepPairs")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         timer.Start();
+         for(size_t iRound = 0; iRound < g_options.m_cRounds; ++iRound) {
+            for(size_t iFeatureGroup = cMainGroups; iFeatureGroup < data.m_featureGroups.size(); ++iFeatureGroup) {
+               FloatEbmType validationMetric;
+               CheckSuccess(0 != BoostingStep(pBoosting, static_cast<IntEbmType>(iFeatureGroup), learningRate,
+                  countTreeSplitsMax, countSamplesRequiredForChildSplitMin, nullptr, nullptr, &validationMetric),
+                  "BoostingStep");
+            }
+         }
+         timer.Stop();
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("BoostingStepPairs", g_options.m_cRounds * cPairGroups, cSamples);
+   }
+
+   if(IsSelected("BoostingStepInnerBags")) {
+      // inner bags multiply the work of each step, which is where our per-bag loops show up
+      const size_t cInnerBags = 4;
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, cInnerBags);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         timer.Start();
+         for(size_t iFeatureGroup = 0; iFeatureGroup < cMainGroups; ++iFeatureGroup) {
+            FloatEbmType validationMetric;
+            CheckSuccess(0 != BoostingStep(pBoosting, static_cast<IntEbmType>(iFeatureGroup), learningRate,
+               countTreeSplitsMax, countSamplesRequiredForChildSplitMin, nullptr, nullptr, &validationMetric),
+               "BoostingStep");
+         }
+         timer.Stop();
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("BoostingStepInnerBags", cMainGroups, cSamples);
+   }
+
+   if(IsSelected("BoostingRun")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+         CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+         FloatEbmType validationMetric;
+         IntEbmType indexRound;
+         timer.Start();
+         // no early stopping, so that every repeat does the same amount of work
+         const IntEbmType ret = BoostingRun(pBoosting, static_cast<IntEbmType>(g_options.m_cRounds), learningRate,
+            countTreeSplitsMax, countSamplesRequiredForChildSplitMin, -1, 0.0, nullptr, nullptr, &validationMetric,
+            &indexRound);
+         timer.Stop();
+         CheckSuccess(0 != ret, "BoostingRun");
+         FreeBoosting(pBoosting);
+      }
+      timer.Report("BoostingRun", g_options.m_cRounds * data.m_featureGroups.size(), cSamples);
+   }
+}
+
+static void BenchInteraction(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cTrainingSamples;
+   const size_t cPairs = data.m_pairIndexes.size() / 2;
+   const IntEbmType countSamplesRequiredForChildSplitMin = 2;
+
+   if(IsSelected("InitializeInteraction")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         PEbmInteraction pInteraction = InitializeInteraction(data);
+         timer.Stop();
+         CheckSuccess(nullptr == pInteraction, "InitializeInteraction");
+         FreeInteraction(pInteraction);
+      }
+      timer.Report("InitializeInteraction", 1, cSamples);
+   }
+
+   if(0 == cPairs) {
+      return;
+   }
+
+   PEbmInteraction pInteraction = InitializeInteraction(data);
+   CheckSuccess(nullptr == pInteraction, "InitializeInteraction");
+
+   if(IsSelected("CalculateInteractionScore")) {
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         for(size_t iPair = 0; iPair < cPairs; ++iPair) {
+            FloatEbmType score;
+            CheckSuccess(0 != CalculateInteractionScore(pInteraction, 2, &data.m_pairIndexes[iPair * 2],
+               countSamplesRequiredForChildSplitMin, &score), "CalculateInteractionScore");
+         }
+         timer.Stop();
+      }
+      timer.Report("CalculateInteractionScore", cPairs, cSamples);
+   }
+
+   if(IsSelected("CalculateInteractionScorePairs")) {
+      std::vector<FloatEbmType> scores(cPairs);
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         const IntEbmType ret = CalculateInteractionScorePairs(pInteraction, static_cast<IntEbmType>(cPairs),
+            &data.m_pairIndexes[0], countSamplesRequiredForChildSplitMin, &scores[0]);
+         timer.Stop();
+         CheckSuccess(0 != ret, "CalculateInteractionScorePairs");
+      }
+      timer.Report("CalculateInteractionScorePairs", 1, cSamples * cPairs);
+   }
+
+   if(IsSelected("CalculateInteractionScoreTriples") && 3 <= g_options.m_cFeatures) {
+      // consecutive features, which gives every feature a turn in each position of the triple
+      const size_t cTriples = g_options.m_cFeatures;
+      std::vector<IntEbmType> tripleIndexes;
+      for(size_t iTriple = 0; iTriple < cTriples; ++iTriple) {
+         for(size_t iDimension = 0; iDimension < 3; ++iDimension) {
+            tripleIndexes.push_back(static_cast<IntEbmType>((iTriple + iDimension) % cTriples));
+         }
+      }
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         for(size_t iTriple = 0; iTriple < cTriples; ++iTriple) {
+            FloatEbmType score;
+            CheckSuccess(0 != CalculateInteractionScore(pInteraction, 3, &tripleIndexes[iTriple * 3],
+               countSamplesRequiredForChildSplitMin, &score), "CalculateInteractionScoreTriples");
+         }
+         timer.Stop();
+      }
+      timer.Report("CalculateInteractionScoreTriples", cTriples, cSamples);
+   }
+
+   FreeInteraction(pInteraction);
+}
+
+static void BenchPredict(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cValidationSamples;
+   const size_t cVectorLength = GetVectorLength();
+
+   if(!IsSelected("PredictBatch")) {
+      return;
+   }
+
+   // a model that has seen a few rounds of boosting, so that the tensors aren't all zeros
+   PEbmBoosting pBoosting = InitializeBoosting(data, 0);
+   CheckSuccess(nullptr == pBoosting, "InitializeBoosting");
+   FloatEbmType validationMetric;
+   IntEbmType indexRound;
+   CheckSuccess(0 != BoostingRun(pBoosting, 1, 0.01, 3, 2, -1, 0.0, nullptr, nullptr, &validationMetric,
+      &indexRound), "BoostingRun");
+
+   std::vector<FloatEbmType> modelTensors;
+   size_t iFeatureIndex = 0;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < data.m_featureGroups.size(); ++iFeatureGroup) {
+      size_t cTensorScores = cVectorLength;
+      for(IntEbmType iDimension = 0; iDimension < data.m_featureGroups[iFeatureGroup].countFeaturesInGroup;
+         ++iDimension)
+      {
+         const IntEbmType iFeature = data.m_featureGroupIndexes[iFeatureIndex];
+         ++iFeatureIndex;
+         cTensorScores *= static_cast<size_t>(data.m_features[static_cast<size_t>(iFeature)].countBins);
+      }
+      const FloatEbmType * const pTensor = GetBestModelFeatureGroup(pBoosting, static_cast<IntEbmType>(iFeatureGroup));
+      CheckSuccess(nullptr == pTensor, "GetBestModelFeatureGroup");
+      modelTensors.insert(modelTensors.end(), pTensor, pTensor + cTensorScores);
+   }
+   FreeBoosting(pBoosting);
+
+   std::vector<FloatEbmType> intercept(cVectorLength);
+   std::vector<FloatEbmType> predictions(cSamples * (IsRegression() ? size_t { 1 } : g_options.m_cClasses));
+   for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+      IntEbmType ret;
+      timer.Start();
+      if(IsRegression()) {
+         ret = PredictBatchRegression(static_cast<IntEbmType>(data.m_features.size()), &data.m_features[0],
+            &data.m_countBinCuts[0], &data.m_binCuts[0], static_cast<IntEbmType>(data.m_featureGroups.size()),
+            &data.m_featureGroups[0], &data.m_featureGroupIndexes[0], &modelTensors[0], &intercept[0],
+            static_cast<IntEbmType>(cSamples), &data.m_validationValues[0], &predictions[0]);
+      } else {
+         ret = PredictBatchClassification(static_cast<IntEbmType>(g_options.m_cClasses),
+            static_cast<IntEbmType>(data.m_features.size()), &data.m_features[0], &data.m_countBinCuts[0],
+            &data.m_binCuts[0], static_cast<IntEbmType>(data.m_featureGroups.size()), &data.m_featureGroups[0],
+            &data.m_featureGroupIndexes[0], &modelTensors[0], &intercept[0], static_cast<IntEbmType>(cSamples),
+            &data.m_validationValues[0], &predictions[0]);
+      }
+      timer.Stop();
+      CheckSuccess(0 != ret, "PredictBatch");
+   }
+   timer.Report("PredictBatch", 1, cSamples);
+}
+
+static void BenchUtilities(const BenchData & data) {
+   BenchTimer timer;
+   const size_t cSamples = data.m_cTrainingSamples;
+
+   if(IsSelected("GenerateRandomNumber")) {
+      const size_t cCalls = 10000;
+      IntEbmType randomSeed = static_cast<IntEbmType>(g_options.m_seed);
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         for(size_t iCall = 0; iCall < cCalls; ++iCall) {
+            // chain the seeds so that the calls can't be hoisted
+            randomSeed = GenerateRandomNumber(randomSeed);
+         }
+         timer.Stop();
+      }
+      timer.Report("GenerateRandomNumber", cCalls, 1);
+   }
+
+   if(IsSelected("SamplingWithoutReplacement")) {
+      std::vector<IntEbmType> isIncluded(cSamples);
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         timer.Start();
+         SamplingWithoutReplacement(static_cast<IntEbmType>(g_options.m_seed + iRepeat),
+            static_cast<IntEbmType>(cSamples / 2), static_cast<IntEbmType>(cSamples), &isIncluded[0]);
+         timer.Stop();
+      }
+      timer.Report("SamplingWithoutReplacement", 1, cSamples);
+   }
+
+   if(IsSelected("SuggestGraphBounds")) {
+      const size_t cCalls = 10000;
+      for(size_t iRepeat = 0; iRepeat < g_options.m_cRepeat; ++iRepeat) {
+         FloatEbmType lowGraphBound;
+         FloatEbmType highGraphBound;
+         timer.Start();
+         for(size_t iCall = 0; iCall < cCalls; ++iCall) {
+            SuggestGraphBounds(static_cast<IntEbmType>(g_options.m_cBins - 1), 1.0, 99.0,
+               static_cast<FloatEbmType>(iCall) * -1e-6, 100.0, &lowGraphBound, &highGraphBound);
+         }
+         timer.Stop();
+      }
+      timer.Report("SuggestGraphBounds", cCalls, 1);
+   }
+}
+
+int main(int argc, char ** argv) {
+   if(ParseOptions(argc, argv)) {
+      Usage();
+      return 1;
+   }
+
+   g_pOutput = stdout;
+   if(nullptr != g_options.m_sOutput) {
+      g_pOutput = fopen(g_options.m_sOutput, "w");
+      if(nullptr == g_pOutput) {
+         fprintf(stderr, "ebm_native_bench: could not open %s\n", g_options.m_sOutput);
+         return 1;
+      }
+   }
+
+   BenchData data;
+   GenerateData(data);
+
+   BenchBinning(data);
+   BenchDiscretize(data);
+   BenchBoosting(data);
+   BenchInteraction(data);
+   BenchPredict(data);
+   BenchUtilities(data);
+
+   if(stdout != g_pOutput) {
+      fclose(g_pOutput);
+   }
+   return 0;
+}
@@ -0,0 +1,38 @@
+@ECHO OFF
+SETLOCAL
+
+REM ebm_native_bench only makes sense against the release library, so unlike ebm_native_test we only build Release x64.
+REM Any arguments other than -nobuildebmnative are passed through to ebm_native_bench.exe
+
+SET root_path=%~dp0..\..\..\
+
+SET build_ebm_native=1
+SET bench_args=
+for %%x in (%*) do (
+   IF "%%x"=="-nobuildebmnative" (
+      SET build_ebm_native=0
+   ) ELSE (
+      CALL SET bench_args=%%bench_args%% %%x
+   )
+)
+
+IF %build_ebm_native% EQU 1 (
+   ECHO Building ebm_native library...
+   CALL "%root_path%build.bat"
+) ELSE (
+   ECHO ebm_native library NOT being built
+)
+
+MSBuild.exe "%root_path%shared\ebm_native\ebm_native_bench\ebm_native_bench.vcxproj" /p:Configuration=Release /p:Platform=x64
+IF %ERRORLEVEL% NEQ 0 (
+   ECHO MSBuild for Release x64 returned error code %ERRORLEVEL%
+   EXIT /B %ERRORLEVEL%
+)
+
+"%root_path%tmp\vs\bin\Release\win\x64\ebm_native_bench\ebm_native_bench.exe" %bench_args%
+IF %ERRORLEVEL% NEQ 0 (
+   ECHO ebm_native_bench.exe for Release x64 failed with error code %ERRORLEVEL%
+   EXIT /B %ERRORLEVEL%
+)
+
+EXIT /B 0
@@ -77,6 +77,47 @@ TEST_CASE("Test data bit packing extremes, boosting, binary") {
    }
 }
 
+TEST_CASE("aligned bit packing matches tight bit packing, boosting, regression") {
+   // a growth limit of 4 aligns every bin count, and 1.2 only aligns those where rounding up costs little, like 7 bits
+   for(const FloatEbmType alignedPacking : { FloatEbmType { 1.2 }, FloatEbmType { 4 } }) {
+      for(size_t exponentialBins = 2; exponentialBins < 10; ++exponentialBins) {
+         const IntEbmType exponential = static_cast<IntEbmType>(std::pow(2, exponentialBins));
+         for(IntEbmType iRange = IntEbmType { -1 }; iRange <= IntEbmType { 1 }; ++iRange) {
+            const IntEbmType cBins = exponential + iRange;
+            for(const size_t cSamples : { size_t { 1 }, size_t { 15 }, size_t { 16 }, size_t { 17 }, size_t { 65 } }) {
+               std::vector<RegressionSample> trainingSamples;
+               for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+                  const IntEbmType bin = static_cast<IntEbmType>(iSample * 5 % static_cast<size_t>(cBins));
+                  trainingSamples.push_back(RegressionSample(static_cast<FloatEbmType>(bin % 7), { bin }));
+               }
+
+               TestApi testTight = TestApi(k_learningTypeRegression);
+               testTight.AddFeatures({ FeatureTest(cBins) });
+               testTight.AddFeatureGroups({ { 0 } });
+               testTight.AddTrainingSamples(trainingSamples);
+               testTight.AddValidationSamples({ RegressionSample(8, { cBins - 1 }) });
+               testTight.InitializeBoosting(0, {});
+
+               TestApi testAligned = TestApi(k_learningTypeRegression);
+               testAligned.AddFeatures({ FeatureTest(cBins) });
+               testAligned.AddFeatureGroups({ { 0 } });
+               testAligned.AddTrainingSamples(trainingSamples);
+               testAligned.AddValidationSamples({ RegressionSample(8, { cBins - 1 }) });
+               testAligned.InitializeBoosting(0, MakeTempParams({ { TempParamBoostingAlignedPacking, alignedPacking } }));
+
+               for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+                  CHECK(testAligned.Boost(0) == testTight.Boost(0));
+               }
+               for(size_t iBin = 0; iBin < static_cast<size_t>(cBins); ++iBin) {
+                  CHECK(testAligned.GetCurrentModelPredictorScore(0, { iBin }, 0) ==
+                     testTight.GetCurrentModelPredictorScore(0, { iBin }, 0));
+               }
+            }
+         }
+      }
+   }
+}
+
 TEST_CASE("Test data bit packing extremes, interaction, regression") {
    for(size_t exponentialBins = 1; exponentialBins < 10; ++exponentialBins) {
       IntEbmType exponential = static_cast<IntEbmType>(std::pow(2, exponentialBins));
@@ -0,0 +1,290 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingAppend;
+
+static constexpr size_t k_cSamplesBeforeAppend = 61;
+static constexpr size_t k_cSamplesAppended = 37;
+static constexpr size_t k_cValidationSamplesAppend = 29;
+static constexpr int k_cRoundsBeforeAppend = 2;
+static constexpr int k_cRoundsAfterAppend = 3;
+
+// cached denominators, single precision, class-major multiclass and sample indexes, which all have to be rebuilt over
+// the concatenated samples
+static const std::vector<FloatEbmType> k_tempParamsAppend = MakeTempParams({ 
+   { TempParamBoostingCacheDenominators, 1 }, 
+   { TempParamBoostingSinglePrecision, 1 }, 
+   { TempParamBoostingClassMajor, 1 }, 
+   { TempParamBoostingSampleIndexBinsMax, 16 } 
+});
+
+static const std::vector<EbmNativeFeature> k_featuresAppend { { 0, 0, 5 }, { 0, 0, 4 } };
+static const std::vector<EbmNativeFeatureGroup> k_featureGroupsAppend { { 0 }, { 1 }, { 1 }, { 2 } };
+static const std::vector<IntEbmType> k_featureGroupIndexesAppend { 0, 1, 0, 1 };
+static constexpr size_t k_acTensorBinsAppend[] { 1, 5, 4, 5 * 4 };
+
+class AppendData final {
+public:
+   std::vector<IntEbmType> m_binnedData;
+   std::vector<IntEbmType> m_classificationTargets;
+   std::vector<FloatEbmType> m_regressionTargets;
+   std::vector<FloatEbmType> m_offsets;
+
+   // the samples only depend on their index, so the samples [0, a) followed by [a, b) are the samples [0, b)
+   AppendData(const ptrdiff_t learningTypeOrCountTargetClasses, const size_t cSamples, const size_t iSampleStart) {
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         m_binnedData.push_back(static_cast<IntEbmType>(iSample * 7 % 5));
+      }
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         m_binnedData.push_back(static_cast<IntEbmType>(iSample / 3 % 4));
+      }
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+            m_regressionTargets.push_back(static_cast<FloatEbmType>(iSample * 7 % 5) - static_cast<FloatEbmType>(iSample % 9) / 4);
+         } else {
+            m_classificationTargets.push_back(
+               static_cast<IntEbmType>((iSample * 7 % 5 + iSample % 4) % static_cast<size_t>(learningTypeOrCountTargetClasses)));
+         }
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            m_offsets.push_back(static_cast<FloatEbmType>((iSample + iVector) % 5) / 8);
+         }
+      }
+   }
+
+   IntEbmType GetCountSamples() const {
+      return static_cast<IntEbmType>(m_binnedData.size() / k_featuresAppend.size());
+   }
+};
+
+static PEbmBoosting InitializeBoostingAppend(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const AppendData & training,
+   const AppendData & validation,
+   const FloatEbmType * const initialModelFeatureGroupTensors,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const FloatEbmType * const tempParams = optionalTempParams.empty() ? nullptr : &optionalTempParams[0];
+   const IntEbmType countFeatures = static_cast<IntEbmType>(k_featuresAppend.size());
+   const IntEbmType countFeatureGroups = static_cast<IntEbmType>(k_featureGroupsAppend.size());
+   if(nullptr == initialModelFeatureGroupTensors) {
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         return InitializeBoostingRegression(countFeatures, &k_featuresAppend[0], countFeatureGroups,
+            &k_featureGroupsAppend[0], &k_featureGroupIndexesAppend[0], training.GetCountSamples(),
+            &training.m_binnedData[0], &training.m_regressionTargets[0], &training.m_offsets[0],
+            validation.GetCountSamples(), &validation.m_binnedData[0], &validation.m_regressionTargets[0],
+            &validation.m_offsets[0], 0, k_randomSeed, tempParams);
+      }
+      return InitializeBoostingClassification(learningTypeOrCountTargetClasses, countFeatures, &k_featuresAppend[0],
+         countFeatureGroups, &k_featureGroupsAppend[0], &k_featureGroupIndexesAppend[0], training.GetCountSamples(),
+         &training.m_binnedData[0], &training.m_classificationTargets[0], &training.m_offsets[0],
+         validation.GetCountSamples(), &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+         &validation.m_offsets[0], 0, k_randomSeed, tempParams);
+   }
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return InitializeBoostingRegressionWarmStart(countFeatures, &k_featuresAppend[0], countFeatureGroups,
+         &k_featureGroupsAppend[0], &k_featureGroupIndexesAppend[0], initialModelFeatureGroupTensors,
+         training.GetCountSamples(), &training.m_binnedData[0], &training.m_regressionTargets[0], &training.m_offsets[0],
+         nullptr, validation.GetCountSamples(), &validation.m_binnedData[0], &validation.m_regressionTargets[0],
+         &validation.m_offsets[0], nullptr, 0, k_randomSeed, tempParams);
+   }
+   return InitializeBoostingClassificationWarmStart(learningTypeOrCountTargetClasses, countFeatures, &k_featuresAppend[0],
+      countFeatureGroups, &k_featureGroupsAppend[0], &k_featureGroupIndexesAppend[0], initialModelFeatureGroupTensors,
+      training.GetCountSamples(), &training.m_binnedData[0], &training.m_classificationTargets[0], &training.m_offsets[0],
+      nullptr, validation.GetCountSamples(), &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+      &validation.m_offsets[0], nullptr, 0, k_randomSeed, tempParams);
+}
+
+static IntEbmType AppendSamples(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const PEbmBoosting ebmBoosting,
+   const AppendData & appended
+) {
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return AppendBoostingTrainingSamplesRegression(ebmBoosting, appended.GetCountSamples(), &appended.m_binnedData[0],
+         &appended.m_regressionTargets[0], &appended.m_offsets[0]);
+   }
+   return AppendBoostingTrainingSamplesClassification(ebmBoosting, appended.GetCountSamples(), &appended.m_binnedData[0],
+      &appended.m_classificationTargets[0], &appended.m_offsets[0]);
+}
+
+static void BoostRounds(
+   TestCaseHidden & testCaseHidden,
+   const PEbmBoosting ebmBoosting,
+   const int cRounds,
+   std::vector<FloatEbmType> & metrics
+) {
+   for(int iRound = 0; iRound < cRounds; ++iRound) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < k_featureGroupsAppend.size(); ++iFeatureGroup) {
+         FloatEbmType metric = 0;
+         CHECK(0 == BoostingStep(ebmBoosting, static_cast<IntEbmType>(iFeatureGroup), k_learningRateDefault,
+            k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metric));
+         metrics.push_back(metric);
+      }
+   }
+}
+
+static void CheckAppendMatchesInitialize(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const AppendData before(learningTypeOrCountTargetClasses, k_cSamplesBeforeAppend, 0);
+   const AppendData appended(learningTypeOrCountTargetClasses, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   const AppendData all(learningTypeOrCountTargetClasses, k_cSamplesBeforeAppend + k_cSamplesAppended, 0);
+   const AppendData validation(learningTypeOrCountTargetClasses, k_cValidationSamplesAppend, 1000);
+
+   const PEbmBoosting ebmBoostingAppended =
+      InitializeBoostingAppend(learningTypeOrCountTargetClasses, before, validation, nullptr, optionalTempParams);
+   const PEbmBoosting ebmBoostingAll =
+      InitializeBoostingAppend(learningTypeOrCountTargetClasses, all, validation, nullptr, optionalTempParams);
+   CHECK(nullptr != ebmBoostingAppended);
+   CHECK(nullptr != ebmBoostingAll);
+   if(nullptr == ebmBoostingAppended || nullptr == ebmBoostingAll) {
+      FreeBoosting(ebmBoostingAppended);
+      FreeBoosting(ebmBoostingAll);
+      return;
+   }
+
+   // the model is still empty, so the appended samples start from their offsets, just like the samples of a
+   // booster that had them all along
+   CHECK(0 == AppendSamples(learningTypeOrCountTargetClasses, ebmBoostingAppended, appended));
+
+   std::vector<FloatEbmType> metricsAppended;
+   BoostRounds(testCaseHidden, ebmBoostingAppended, k_cRoundsAfterAppend, metricsAppended);
+   std::vector<FloatEbmType> metricsAll;
+   BoostRounds(testCaseHidden, ebmBoostingAll, k_cRoundsAfterAppend, metricsAll);
+   CHECK(metricsAll == metricsAppended);
+
+   for(size_t iFeatureGroup = 0; iFeatureGroup < k_featureGroupsAppend.size(); ++iFeatureGroup) {
+      const FloatEbmType * const pModelAppended =
+         GetCurrentModelFeatureGroup(ebmBoostingAppended, static_cast<IntEbmType>(iFeatureGroup));
+      const FloatEbmType * const pModelAll = GetCurrentModelFeatureGroup(ebmBoostingAll, static_cast<IntEbmType>(iFeatureGroup));
+      const size_t cScores = k_acTensorBinsAppend[iFeatureGroup] * GetVectorLength(learningTypeOrCountTargetClasses);
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(pModelAll[iScore] == pModelAppended[iScore]);
+      }
+   }
+
+   FreeBoosting(ebmBoostingAppended);
+   FreeBoosting(ebmBoostingAll);
+}
+
+static void CheckAppendAfterBoostingMatchesWarmStart(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses
+) {
+   const AppendData before(learningTypeOrCountTargetClasses, k_cSamplesBeforeAppend, 0);
+   const AppendData appended(learningTypeOrCountTargetClasses, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   const AppendData all(learningTypeOrCountTargetClasses, k_cSamplesBeforeAppend + k_cSamplesAppended, 0);
+   const AppendData validation(learningTypeOrCountTargetClasses, k_cValidationSamplesAppend, 1000);
+
+   const PEbmBoosting ebmBoostingAppended =
+      InitializeBoostingAppend(learningTypeOrCountTargetClasses, before, validation, nullptr, {});
+   CHECK(nullptr != ebmBoostingAppended);
+   if(nullptr == ebmBoostingAppended) {
+      return;
+   }
+   std::vector<FloatEbmType> metricsBefore;
+   BoostRounds(testCaseHidden, ebmBoostingAppended, k_cRoundsBeforeAppend, metricsBefore);
+   CHECK(0 == AppendSamples(learningTypeOrCountTargetClasses, ebmBoostingAppended, appended));
+
+   // the appended samples start from the current model, so they match a booster that was warm started on all of
+   // the samples with that model, up to the order in which the scores were summed
+   std::vector<FloatEbmType> tensors;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < k_featureGroupsAppend.size(); ++iFeatureGroup) {
+      const FloatEbmType * const pModel =
+         GetCurrentModelFeatureGroup(ebmBoostingAppended, static_cast<IntEbmType>(iFeatureGroup));
+      const size_t cScores = k_acTensorBinsAppend[iFeatureGroup] * GetVectorLength(learningTypeOrCountTargetClasses);
+      tensors.insert(tensors.end(), pModel, pModel + cScores);
+   }
+   const PEbmBoosting ebmBoostingWarmStart =
+      InitializeBoostingAppend(learningTypeOrCountTargetClasses, all, validation, &tensors[0], {});
+   CHECK(nullptr != ebmBoostingWarmStart);
+   if(nullptr == ebmBoostingWarmStart) {
+      FreeBoosting(ebmBoostingAppended);
+      return;
+   }
+
+   std::vector<FloatEbmType> metricsAppended;
+   BoostRounds(testCaseHidden, ebmBoostingAppended, k_cRoundsAfterAppend, metricsAppended);
+   std::vector<FloatEbmType> metricsWarmStart;
+   BoostRounds(testCaseHidden, ebmBoostingWarmStart, k_cRoundsAfterAppend, metricsWarmStart);
+   CHECK(metricsWarmStart.size() == metricsAppended.size());
+   for(size_t iMetric = 0; iMetric < metricsAppended.size(); ++iMetric) {
+      CHECK(IsApproxEqual(metricsAppended[iMetric], metricsWarmStart[iMetric], FloatEbmType { 1e-9 }));
+   }
+
+   FreeBoosting(ebmBoostingAppended);
+   FreeBoosting(ebmBoostingWarmStart);
+}
+
+TEST_CASE("appended samples match initializing with them, boosting, regression") {
+   CheckAppendMatchesInitialize(testCaseHidden, k_learningTypeRegression, {});
+   CheckAppendMatchesInitialize(testCaseHidden, k_learningTypeRegression, k_tempParamsAppend);
+}
+
+TEST_CASE("appended samples match initializing with them, boosting, binary") {
+   CheckAppendMatchesInitialize(testCaseHidden, 2, {});
+   CheckAppendMatchesInitialize(testCaseHidden, 2, k_tempParamsAppend);
+}
+
+TEST_CASE("appended samples match initializing with them, boosting, multiclass") {
+   CheckAppendMatchesInitialize(testCaseHidden, 3, {});
+   CheckAppendMatchesInitialize(testCaseHidden, 3, k_tempParamsAppend);
+}
+
+TEST_CASE("samples appended after boosting start from the current model, boosting") {
+   CheckAppendAfterBoostingMatchesWarmStart(testCaseHidden, k_learningTypeRegression);
+   CheckAppendAfterBoostingMatchesWarmStart(testCaseHidden, 2);
+   CheckAppendAfterBoostingMatchesWarmStart(testCaseHidden, 3);
+}
+
+TEST_CASE("invalid appended samples are rejected, boosting") {
+   const AppendData before(3, k_cSamplesBeforeAppend, 0);
+   const AppendData validation(3, k_cValidationSamplesAppend, 1000);
+   const PEbmBoosting ebmBoostingFresh = InitializeBoostingAppend(3, before, validation, nullptr, {});
+   const PEbmBoosting ebmBoostingRejected = InitializeBoostingAppend(3, before, validation, nullptr, {});
+   CHECK(nullptr != ebmBoostingFresh);
+   CHECK(nullptr != ebmBoostingRejected);
+
+   AppendData outOfRange(3, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   outOfRange.m_binnedData[k_cSamplesAppended + 3] = 4;
+   CHECK(0 != AppendSamples(3, ebmBoostingRejected, outOfRange));
+   AppendData badTarget(3, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   badTarget.m_classificationTargets[5] = 3;
+   CHECK(0 != AppendSamples(3, ebmBoostingRejected, badTarget));
+   const AppendData regression(k_learningTypeRegression, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   CHECK(0 != AppendSamples(k_learningTypeRegression, ebmBoostingRejected, regression));
+   CHECK(0 != AppendBoostingTrainingSamplesClassification(ebmBoostingRejected, -1, &badTarget.m_binnedData[0],
+      &badTarget.m_classificationTargets[0], nullptr));
+   CHECK(0 == AppendBoostingTrainingSamplesClassification(ebmBoostingRejected, 0, nullptr, nullptr, nullptr));
+
+   // a rejected append leaves the booster as it was
+   std::vector<FloatEbmType> metricsFresh;
+   BoostRounds(testCaseHidden, ebmBoostingFresh, 1, metricsFresh);
+   std::vector<FloatEbmType> metricsRejected;
+   BoostRounds(testCaseHidden, ebmBoostingRejected, 1, metricsRejected);
+   CHECK(metricsFresh == metricsRejected);
+
+   FreeBoosting(ebmBoostingFresh);
+   FreeBoosting(ebmBoostingRejected);
+
+   const IntEbmType aWeights[k_cSamplesBeforeAppend] { 1 };
+   const PEbmBoosting ebmBoostingWeighted = InitializeBoostingClassificationWeighted(3,
+      static_cast<IntEbmType>(k_featuresAppend.size()), &k_featuresAppend[0],
+      static_cast<IntEbmType>(k_featureGroupsAppend.size()), &k_featureGroupsAppend[0], &k_featureGroupIndexesAppend[0],
+      before.GetCountSamples(), &before.m_binnedData[0], &before.m_classificationTargets[0], &before.m_offsets[0],
+      aWeights, validation.GetCountSamples(), &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+      &validation.m_offsets[0], nullptr, 0, k_randomSeed, nullptr);
+   CHECK(nullptr != ebmBoostingWeighted);
+   const AppendData appended(3, k_cSamplesAppended, k_cSamplesBeforeAppend);
+   CHECK(0 != AppendSamples(3, ebmBoostingWeighted, appended));
+   FreeBoosting(ebmBoostingWeighted);
+}
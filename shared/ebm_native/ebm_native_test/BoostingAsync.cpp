@@ -0,0 +1,333 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingAsync;
+
+TEST_CASE("BoostingStepAsync matches BoostingStep, boosting, regression") {
+   TestApi testSync = TestApi(k_learningTypeRegression);
+   testSync.AddFeatures({ FeatureTest(3) });
+   testSync.AddFeatureGroups({ { 0 } });
+   testSync.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }), RegressionSample(30, { 2 }) });
+   testSync.AddValidationSamples({ RegressionSample(12, { 0 }), RegressionSample(19, { 1 }) });
+   testSync.InitializeBoosting();
+
+   TestApi testAsync = TestApi(k_learningTypeRegression);
+   testAsync.AddFeatures({ FeatureTest(3) });
+   testAsync.AddFeatureGroups({ { 0 } });
+   testAsync.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }), RegressionSample(30, { 2 }) });
+   testAsync.AddValidationSamples({ RegressionSample(12, { 0 }), RegressionSample(19, { 1 }) });
+   testAsync.InitializeBoosting();
+
+   for(int iEpoch = 0; iEpoch < 100; ++iEpoch) {
+      const FloatEbmType validationMetricSync = testSync.Boost(0);
+
+      const PEbmWork work = testAsync.BoostAsync(0);
+      FloatEbmType validationMetricAsync = FloatEbmType { -1 };
+      const IntEbmType ret = FinishWork(work, &validationMetricAsync);
+      CHECK(0 == ret);
+      CHECK(validationMetricSync == validationMetricAsync);
+   }
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(testSync.GetCurrentModelPredictorScore(0, { iBin }, 0) == testAsync.GetCurrentModelPredictorScore(0, { iBin }, 0));
+      CHECK(testSync.GetBestModelPredictorScore(0, { iBin }, 0) == testAsync.GetBestModelPredictorScore(0, { iBin }, 0));
+   }
+}
+
+TEST_CASE("BoostingStepAsync queued on the same booster runs in order, boosting, binary") {
+   TestApi testSync = TestApi(2, 0);
+   testSync.AddFeatures({ FeatureTest(2), FeatureTest(3) });
+   testSync.AddFeatureGroups({ { 0 }, { 1 } });
+   testSync.AddTrainingSamples({ ClassificationSample(0, { 0, 1 }), ClassificationSample(1, { 1, 2 }), ClassificationSample(1, { 1, 0 }) });
+   testSync.AddValidationSamples({ ClassificationSample(0, { 0, 2 }), ClassificationSample(1, { 1, 1 }) });
+   testSync.InitializeBoosting(2);
+
+   TestApi testAsync = TestApi(2, 0);
+   testAsync.AddFeatures({ FeatureTest(2), FeatureTest(3) });
+   testAsync.AddFeatureGroups({ { 0 }, { 1 } });
+   testAsync.AddTrainingSamples({ ClassificationSample(0, { 0, 1 }), ClassificationSample(1, { 1, 2 }), ClassificationSample(1, { 1, 0 }) });
+   testAsync.AddValidationSamples({ ClassificationSample(0, { 0, 2 }), ClassificationSample(1, { 1, 1 }) });
+   testAsync.InitializeBoosting(2);
+
+   constexpr size_t cWorks = 20;
+   PEbmWork works[cWorks];
+   for(size_t iWork = 0; iWork < cWorks; ++iWork) {
+      works[iWork] = testAsync.BoostAsync(static_cast<IntEbmType>(iWork % 2));
+   }
+
+   IntEbmType indexCompleted = IntEbmType { -2 };
+   IntEbmType ret = WaitForWork(static_cast<IntEbmType>(cWorks), works, EBM_TRUE, &indexCompleted);
+   CHECK(0 == ret);
+   CHECK(0 == indexCompleted);
+
+   for(size_t iWork = 0; iWork < cWorks; ++iWork) {
+      const FloatEbmType validationMetricSync = testSync.Boost(static_cast<IntEbmType>(iWork % 2));
+      FloatEbmType validationMetricAsync = FloatEbmType { -1 };
+      ret = FinishWork(works[iWork], &validationMetricAsync);
+      CHECK(0 == ret);
+      CHECK(validationMetricSync == validationMetricAsync);
+   }
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(testSync.GetCurrentModelPredictorScore(1, { iBin }, 1) == testAsync.GetCurrentModelPredictorScore(1, { iBin }, 1));
+   }
+}
+
+TEST_CASE("WaitForWork, wait any across boosters, boosting, regression") {
+   TestApi test0 = TestApi(k_learningTypeRegression);
+   test0.AddFeatures({ FeatureTest(2) });
+   test0.AddFeatureGroups({ { 0 } });
+   test0.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+   test0.AddValidationSamples({ RegressionSample(12, { 0 }) });
+   test0.InitializeBoosting();
+
+   TestApi test1 = TestApi(k_learningTypeRegression);
+   test1.AddFeatures({ FeatureTest(2) });
+   test1.AddFeatureGroups({ { 0 } });
+   test1.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+   test1.AddValidationSamples({ RegressionSample(12, { 0 }) });
+   test1.InitializeBoosting();
+
+   PEbmWork works[3];
+   works[0] = test0.BoostAsync(0);
+   works[1] = nullptr; // nullptr entries are ignored
+   works[2] = test1.BoostAsync(0);
+
+   IntEbmType indexCompleted = IntEbmType { -2 };
+   IntEbmType ret = WaitForWork(3, works, EBM_FALSE, &indexCompleted);
+   CHECK(0 == ret);
+   CHECK(0 == indexCompleted || 2 == indexCompleted);
+
+   FloatEbmType validationMetric0 = FloatEbmType { -1 };
+   ret = FinishWork(works[0], &validationMetric0);
+   CHECK(0 == ret);
+   FloatEbmType validationMetric1 = FloatEbmType { -1 };
+   ret = FinishWork(works[2], &validationMetric1);
+   CHECK(0 == ret);
+   // both boosters were given identical data, so running them in parallel must produce identical results
+   CHECK(validationMetric0 == validationMetric1);
+}
+
+TEST_CASE("WaitForWork, zero works") {
+   IntEbmType indexCompleted = IntEbmType { -2 };
+   IntEbmType ret = WaitForWork(0, nullptr, EBM_TRUE, &indexCompleted);
+   CHECK(0 == ret);
+   CHECK(-1 == indexCompleted);
+
+   PEbmWork works[1];
+   works[0] = nullptr;
+   indexCompleted = IntEbmType { -2 };
+   ret = WaitForWork(1, works, EBM_FALSE, &indexCompleted);
+   CHECK(0 == ret);
+   CHECK(-1 == indexCompleted);
+}
+
+TEST_CASE("WaitForWork, negative countWorks") {
+   IntEbmType indexCompleted = IntEbmType { -2 };
+   const IntEbmType ret = WaitForWork(-1, nullptr, EBM_TRUE, &indexCompleted);
+   CHECK(0 != ret);
+}
+
+TEST_CASE("BoostingStepAsync, nullptr ebmBoosting") {
+   const PEbmWork work = BoostingStepAsync(
+      nullptr,
+      0,
+      k_learningRateDefault,
+      k_countTreeSplitsMaxDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      nullptr,
+      nullptr
+   );
+   CHECK(nullptr == work);
+}
+
+TEST_CASE("FreeBoosting with unfinished work, boosting, regression") {
+   PEbmWork work;
+   {
+      TestApi test = TestApi(k_learningTypeRegression);
+      test.AddFeatures({ FeatureTest(2) });
+      test.AddFeatureGroups({ { 0 } });
+      test.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+      test.AddValidationSamples({ RegressionSample(12, { 0 }) });
+      test.InitializeBoosting();
+
+      work = test.BoostAsync(0);
+      // test goes out of scope here, which calls FreeBoosting.  FreeBoosting needs to wait for our work to complete
+   }
+   FloatEbmType validationMetric = FloatEbmType { -1 };
+   const IntEbmType ret = FinishWork(work, &validationMetric);
+   CHECK(0 == ret);
+}
+
+static void InitializeBoostingRunAsync(TestApi & test) {
+   test.AddFeatures({ FeatureTest(2), FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 }, { 1 } });
+   test.AddTrainingSamples({ ClassificationSample(0, { 0, 1 }), ClassificationSample(1, { 1, 2 }), ClassificationSample(1, { 1, 0 }) });
+   test.AddValidationSamples({ ClassificationSample(0, { 0, 2 }), ClassificationSample(1, { 1, 1 }) });
+   test.InitializeBoosting(2);
+}
+
+TEST_CASE("BoostingRunAsync matches BoostingRun, boosting, binary") {
+   TestApi testSync = TestApi(2, 0);
+   InitializeBoostingRunAsync(testSync);
+   TestApi testAsync = TestApi(2, 0);
+   InitializeBoostingRunAsync(testAsync);
+
+   FloatEbmType validationMetricSync = FloatEbmType { -1 };
+   const IntEbmType indexRoundSync = testSync.BoostRun(50, 5, FloatEbmType { 0 }, nullptr, nullptr, &validationMetricSync);
+
+   IntEbmType indexRoundAsync = IntEbmType { -1 };
+   const PEbmWork work = BoostingRunAsync(
+      testAsync.GetBoosting(),
+      50,
+      k_learningRateDefault,
+      k_countTreeSplitsMaxDefault,
+      k_countSamplesRequiredForChildSplitMinDefault,
+      5,
+      FloatEbmType { 0 },
+      nullptr,
+      nullptr,
+      &indexRoundAsync
+   );
+   CHECK(nullptr != work);
+   FloatEbmType validationMetricAsync = FloatEbmType { -1 };
+   const IntEbmType ret = FinishWork(work, &validationMetricAsync);
+   CHECK(0 == ret);
+
+   CHECK(validationMetricSync == validationMetricAsync);
+   CHECK(indexRoundSync == indexRoundAsync);
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(testSync.GetCurrentModelPredictorScore(1, { iBin }, 1) == testAsync.GetCurrentModelPredictorScore(1, { iBin }, 1));
+      CHECK(testSync.GetBestModelPredictorScore(1, { iBin }, 1) == testAsync.GetBestModelPredictorScore(1, { iBin }, 1));
+   }
+}
+
+class ConcurrentRendezvous final {
+public:
+   std::atomic<int> m_cArrived;
+   bool m_bWait;
+};
+
+class ConcurrentProgress final {
+public:
+   ConcurrentRendezvous * m_pRendezvous;
+   bool m_bArrived;
+   bool m_bMetOther;
+};
+
+static IntEbmType EBM_NATIVE_CALLING_CONVENTION ConcurrentProgressFunction(
+   IntEbmType indexRound,
+   FloatEbmType validationMetric,
+   void * progressContext
+) {
+   UNUSED(indexRound);
+   UNUSED(validationMetric);
+   ConcurrentProgress * const pProgress = static_cast<ConcurrentProgress *>(progressContext);
+   if(!pProgress->m_bArrived) {
+      pProgress->m_bArrived = true;
+      pProgress->m_pRendezvous->m_cArrived.fetch_add(1);
+      // the other booster can only get here while we're waiting if it runs on another thread at the same time.  If 
+      // the two runs were serialized we give up after the deadline instead of waiting forever
+      const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+      while(pProgress->m_pRendezvous->m_bWait && pProgress->m_pRendezvous->m_cArrived.load() < 2 && 
+         std::chrono::steady_clock::now() < deadline) 
+      {
+         std::this_thread::yield();
+      }
+      pProgress->m_bMetOther = 2 <= pProgress->m_pRendezvous->m_cArrived.load();
+   }
+   return 0;
+}
+
+TEST_CASE("BoostingRunAsync boosts two boosters concurrently, boosting, binary") {
+   TestApi testSync = TestApi(2, 0);
+   InitializeBoostingRunAsync(testSync);
+   FloatEbmType validationMetricSync = FloatEbmType { -1 };
+   const IntEbmType indexRoundSync = testSync.BoostRun(20, -1, FloatEbmType { 0 }, nullptr, nullptr, &validationMetricSync);
+
+   TestApi test0 = TestApi(2, 0);
+   InitializeBoostingRunAsync(test0);
+   TestApi test1 = TestApi(2, 0);
+   InitializeBoostingRunAsync(test1);
+
+   // with a single hardware thread the pool has only one thread, so the boosters can't meet
+   const bool bConcurrent = 2 <= std::thread::hardware_concurrency();
+   ConcurrentRendezvous rendezvous;
+   rendezvous.m_cArrived.store(0);
+   rendezvous.m_bWait = bConcurrent;
+   ConcurrentProgress progress[2];
+   IntEbmType indexRound[2];
+   PEbmWork works[2];
+   TestApi * const aTests[2] = { &test0, &test1 };
+   for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+      progress[iBooster].m_pRendezvous = &rendezvous;
+      progress[iBooster].m_bArrived = false;
+      progress[iBooster].m_bMetOther = false;
+      indexRound[iBooster] = IntEbmType { -1 };
+      works[iBooster] = BoostingRunAsync(
+         aTests[iBooster]->GetBoosting(),
+         20,
+         k_learningRateDefault,
+         k_countTreeSplitsMaxDefault,
+         k_countSamplesRequiredForChildSplitMinDefault,
+         -1,
+         FloatEbmType { 0 },
+         ConcurrentProgressFunction,
+         &progress[iBooster],
+         &indexRound[iBooster]
+      );
+      CHECK(nullptr != works[iBooster]);
+   }
+
+   IntEbmType indexCompleted = IntEbmType { -2 };
+   IntEbmType ret = WaitForWork(2, works, EBM_TRUE, &indexCompleted);
+   CHECK(0 == ret);
+
+   for(size_t iBooster = 0; iBooster < 2; ++iBooster) {
+      FloatEbmType validationMetric = FloatEbmType { -1 };
+      ret = FinishWork(works[iBooster], &validationMetric);
+      CHECK(0 == ret);
+      CHECK(validationMetricSync == validationMetric);
+      CHECK(indexRoundSync == indexRound[iBooster]);
+      CHECK(progress[iBooster].m_bArrived);
+      if(bConcurrent) {
+         CHECK(progress[iBooster].m_bMetOther);
+      }
+   }
+}
+
+TEST_CASE("ShutdownThreadPool, work afterwards starts new threads, boosting, regression") {
+   TestApi testSync = TestApi(k_learningTypeRegression);
+   testSync.AddFeatures({ FeatureTest(2) });
+   testSync.AddFeatureGroups({ { 0 } });
+   testSync.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+   testSync.AddValidationSamples({ RegressionSample(12, { 0 }) });
+   testSync.InitializeBoosting();
+
+   TestApi testAsync = TestApi(k_learningTypeRegression);
+   testAsync.AddFeatures({ FeatureTest(2) });
+   testAsync.AddFeatureGroups({ { 0 } });
+   testAsync.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+   testAsync.AddValidationSamples({ RegressionSample(12, { 0 }) });
+   testAsync.InitializeBoosting();
+
+   for(int iShutdown = 0; iShutdown < 3; ++iShutdown) {
+      IntEbmType ret = ShutdownThreadPool();
+      CHECK(0 == ret);
+
+      const FloatEbmType validationMetricSync = testSync.Boost(0);
+      const PEbmWork work = testAsync.BoostAsync(0);
+      FloatEbmType validationMetricAsync = FloatEbmType { -1 };
+      ret = FinishWork(work, &validationMetricAsync);
+      CHECK(0 == ret);
+      CHECK(validationMetricSync == validationMetricAsync);
+   }
+}
@@ -0,0 +1,225 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include <stdio.h> // remove
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingCheckpoint;
+
+static const char * const k_checkpointFilePath = "ebm_native_test_checkpoint.bin";
+
+static constexpr size_t k_cSamplesCheckpoint = 77;
+static constexpr int k_cEpochsBeforeCheckpoint = 3;
+static constexpr int k_cEpochsAfterCheckpoint = 4;
+
+// sampling without replacement, cached denominators, single precision residuals and class-major multiclass, which
+// are all state that the checkpoint has to carry over exactly
+static const std::vector<FloatEbmType> k_tempParamsCheckpoint = MakeTempParams({ 
+   { TempParamBoostingFractionWithoutReplacement, 0.5 }, 
+   { TempParamBoostingCacheDenominators, 1 }, 
+   { TempParamBoostingSinglePrecision, 1 }, 
+   { TempParamBoostingClassMajor, 1 } 
+});
+
+// BoostingRun skips feature groups below a fifth of the best gain and probes them again every 4 rounds
+static const std::vector<FloatEbmType> k_tempParamsCheckpointScheduled = MakeTempParams({ 
+   { TempParamBoostingScheduleGainFraction, 0.2 }, 
+   { TempParamBoostingScheduleReprobeRounds, 4 } 
+});
+static constexpr IntEbmType k_cRoundsBeforeCheckpoint = 13;
+static constexpr IntEbmType k_cRoundsAfterCheckpoint = 17;
+
+static void InitializeCheckpoint(
+   TestApi & test,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const size_t cSamples,
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ {}, { 0 }, { 1 }, { 0, 1 } });
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      std::vector<RegressionSample> trainingSamples;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+         const FloatEbmType target = static_cast<FloatEbmType>(bin0 * 3 - bin1 * 2) + static_cast<FloatEbmType>(iSample % 13) / 10;
+         trainingSamples.push_back(RegressionSample(target, { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(trainingSamples);
+      test.AddValidationSamples({ RegressionSample(3, { 1, 0 }), RegressionSample(-1, { 0, 3 }), RegressionSample(8, { 4, 2 }) });
+   } else {
+      const IntEbmType countTargetClasses = static_cast<IntEbmType>(learningTypeOrCountTargetClasses);
+      std::vector<ClassificationSample> trainingSamples;
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+         const IntEbmType target = (bin0 + bin1 + static_cast<IntEbmType>(iSample % 11 / 9)) % countTargetClasses;
+         trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(trainingSamples);
+      std::vector<ClassificationSample> validationSamples;
+      for(size_t iSample = 0; iSample < 31; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample * 3 % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample % 4);
+         const IntEbmType target = (bin0 + bin1 + static_cast<IntEbmType>(iSample % 7 / 5)) % countTargetClasses;
+         validationSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+      }
+      test.AddValidationSamples(validationSamples);
+   }
+   test.InitializeBoosting(2, optionalTempParams);
+}
+
+static void BoostEpochs(TestApi & test, const int cEpochs, std::vector<FloatEbmType> & metrics) {
+   for(int iEpoch = 0; iEpoch < cEpochs; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         metrics.push_back(test.Boost(iFeatureGroup));
+      }
+   }
+}
+
+static void CheckCheckpointResumes(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   TestApi testUninterrupted = TestApi(learningTypeOrCountTargetClasses);
+   InitializeCheckpoint(testUninterrupted, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, optionalTempParams);
+   std::vector<FloatEbmType> metricsUninterrupted;
+   BoostEpochs(testUninterrupted, k_cEpochsBeforeCheckpoint + k_cEpochsAfterCheckpoint, metricsUninterrupted);
+
+   std::vector<FloatEbmType> metricsResumed;
+   {
+      TestApi testPreempted = TestApi(learningTypeOrCountTargetClasses);
+      InitializeCheckpoint(testPreempted, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, optionalTempParams);
+      BoostEpochs(testPreempted, k_cEpochsBeforeCheckpoint, metricsResumed);
+      CHECK(0 == SaveBoostingCheckpoint(testPreempted.GetBoosting(), k_checkpointFilePath));
+   }
+   TestApi testResumed = TestApi(learningTypeOrCountTargetClasses);
+   InitializeCheckpoint(testResumed, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, optionalTempParams);
+   CHECK(0 == LoadBoostingCheckpoint(testResumed.GetBoosting(), k_checkpointFilePath));
+   remove(k_checkpointFilePath);
+   BoostEpochs(testResumed, k_cEpochsAfterCheckpoint, metricsResumed);
+
+   CHECK(metricsUninterrupted == metricsResumed);
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      // binary classification keeps its single logit in class 1
+      const size_t iClass = 2 == learningTypeOrCountTargetClasses ? size_t { 1 } : iVector;
+      CHECK(testUninterrupted.GetCurrentModelPredictorScore(0, {}, iClass) ==
+         testResumed.GetCurrentModelPredictorScore(0, {}, iClass));
+      CHECK(testUninterrupted.GetBestModelPredictorScore(0, {}, iClass) ==
+         testResumed.GetBestModelPredictorScore(0, {}, iClass));
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK(testUninterrupted.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+               testResumed.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+            CHECK(testUninterrupted.GetBestModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+               testResumed.GetBestModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+         }
+      }
+   }
+}
+
+TEST_CASE("checkpoint resumes identically, boosting, regression") {
+   CheckCheckpointResumes(testCaseHidden, k_learningTypeRegression, {});
+   CheckCheckpointResumes(testCaseHidden, k_learningTypeRegression, k_tempParamsCheckpoint);
+}
+
+TEST_CASE("checkpoint resumes identically, boosting, binary") {
+   CheckCheckpointResumes(testCaseHidden, 2, {});
+   CheckCheckpointResumes(testCaseHidden, 2, k_tempParamsCheckpoint);
+}
+
+TEST_CASE("checkpoint resumes identically, boosting, multiclass") {
+   CheckCheckpointResumes(testCaseHidden, 3, {});
+   CheckCheckpointResumes(testCaseHidden, 3, k_tempParamsCheckpoint);
+}
+
+static void CheckScheduledCheckpointResumes(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi testUninterrupted = TestApi(learningTypeOrCountTargetClasses);
+   InitializeCheckpoint(testUninterrupted, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, k_tempParamsCheckpointScheduled);
+   // BoostingRun reports the best metric of the call, so the uninterrupted booster splits its rounds the same way
+   testUninterrupted.BoostRun(k_cRoundsBeforeCheckpoint, -1, 0);
+   FloatEbmType metricUninterrupted;
+   testUninterrupted.BoostRun(k_cRoundsAfterCheckpoint, -1, 0, nullptr, nullptr, &metricUninterrupted);
+
+   {
+      TestApi testPreempted = TestApi(learningTypeOrCountTargetClasses);
+      InitializeCheckpoint(testPreempted, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, k_tempParamsCheckpointScheduled);
+      testPreempted.BoostRun(k_cRoundsBeforeCheckpoint, -1, 0);
+      CHECK(0 == SaveBoostingCheckpoint(testPreempted.GetBoosting(), k_checkpointFilePath));
+   }
+   TestApi testResumed = TestApi(learningTypeOrCountTargetClasses);
+   InitializeCheckpoint(testResumed, learningTypeOrCountTargetClasses, k_cSamplesCheckpoint, k_tempParamsCheckpointScheduled);
+   CHECK(0 == LoadBoostingCheckpoint(testResumed.GetBoosting(), k_checkpointFilePath));
+   remove(k_checkpointFilePath);
+   FloatEbmType metricResumed;
+   testResumed.BoostRun(k_cRoundsAfterCheckpoint, -1, 0, nullptr, nullptr, &metricResumed);
+
+   CHECK(metricUninterrupted == metricResumed);
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      const size_t iClass = 2 == learningTypeOrCountTargetClasses ? size_t { 1 } : iVector;
+      CHECK(testUninterrupted.GetCurrentModelPredictorScore(0, {}, iClass) ==
+         testResumed.GetCurrentModelPredictorScore(0, {}, iClass));
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         CHECK(testUninterrupted.GetCurrentModelPredictorScore(1, { iBin0 }, iClass) ==
+            testResumed.GetCurrentModelPredictorScore(1, { iBin0 }, iClass));
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK(testUninterrupted.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+               testResumed.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+         }
+      }
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(testUninterrupted.GetCurrentModelPredictorScore(2, { iBin1 }, iClass) ==
+            testResumed.GetCurrentModelPredictorScore(2, { iBin1 }, iClass));
+      }
+   }
+}
+
+TEST_CASE("checkpoint resumes the BoostingRun schedule identically, boosting, regression") {
+   CheckScheduledCheckpointResumes(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("checkpoint resumes the BoostingRun schedule identically, boosting, multiclass") {
+   CheckScheduledCheckpointResumes(testCaseHidden, 3);
+}
+
+TEST_CASE("checkpoint of a different booster is rejected, boosting") {
+   {
+      TestApi testSaved = TestApi(3);
+      InitializeCheckpoint(testSaved, 3, k_cSamplesCheckpoint, {});
+      std::vector<FloatEbmType> metrics;
+      BoostEpochs(testSaved, 1, metrics);
+      CHECK(0 == SaveBoostingCheckpoint(testSaved.GetBoosting(), k_checkpointFilePath));
+   }
+
+   TestApi testFresh = TestApi(3);
+   InitializeCheckpoint(testFresh, 3, k_cSamplesCheckpoint + 1, {});
+   TestApi testRejected = TestApi(3);
+   InitializeCheckpoint(testRejected, 3, k_cSamplesCheckpoint + 1, {});
+   CHECK(0 != LoadBoostingCheckpoint(testRejected.GetBoosting(), k_checkpointFilePath));
+
+   TestApi testOtherType = TestApi(2);
+   InitializeCheckpoint(testOtherType, 2, k_cSamplesCheckpoint, {});
+   CHECK(0 != LoadBoostingCheckpoint(testOtherType.GetBoosting(), k_checkpointFilePath));
+
+   TestApi testOtherPrecision = TestApi(3);
+   InitializeCheckpoint(testOtherPrecision, 3, k_cSamplesCheckpoint, k_tempParamsCheckpoint);
+   CHECK(0 != LoadBoostingCheckpoint(testOtherPrecision.GetBoosting(), k_checkpointFilePath));
+   remove(k_checkpointFilePath);
+
+   CHECK(0 != LoadBoostingCheckpoint(testRejected.GetBoosting(), k_checkpointFilePath));
+
+   // a rejected checkpoint leaves the booster as it was
+   std::vector<FloatEbmType> metricsFresh;
+   BoostEpochs(testFresh, 1, metricsFresh);
+   std::vector<FloatEbmType> metricsRejected;
+   BoostEpochs(testRejected, 1, metricsRejected);
+   CHECK(metricsFresh == metricsRejected);
+}
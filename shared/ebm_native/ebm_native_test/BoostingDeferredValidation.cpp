@@ -0,0 +1,182 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingDeferredValidation;
+
+// more feature groups than the validation set takes in a single pass, so that we test applying them in several passes
+static constexpr size_t k_cFeaturesDeferred = 20;
+static constexpr size_t k_cBinsDeferred = 3;
+static constexpr size_t k_cTrainingSamplesDeferred = 60;
+static constexpr size_t k_cValidationSamplesDeferred = 40;
+
+// the deferred updates are summed before they reach the validation scores, which changes the floating point rounding
+static constexpr FloatEbmType k_toleranceDeferred = FloatEbmType { 1e-9 };
+
+static const std::vector<FloatEbmType> k_tempParamsDeferred = MakeTempParams({ { TempParamBoostingDeferValidation, 1 } });
+
+class DeferredData final {
+public:
+   std::vector<IntEbmType> m_binnedData;
+   std::vector<IntEbmType> m_classificationTargets;
+   std::vector<FloatEbmType> m_regressionTargets;
+   std::vector<FloatEbmType> m_predictorScores;
+   std::vector<IntEbmType> m_weights;
+
+   DeferredData(const ptrdiff_t learningTypeOrCountTargetClasses, const size_t cSamples, const size_t iSampleStart) {
+      for(size_t iFeature = 0; iFeature < k_cFeaturesDeferred; ++iFeature) {
+         for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+            m_binnedData.push_back(static_cast<IntEbmType>((iSample * (iFeature + 1) + iSample / 7) % k_cBinsDeferred));
+         }
+      }
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+            m_regressionTargets.push_back(static_cast<FloatEbmType>(iSample % 5) + static_cast<FloatEbmType>(iSample % 3));
+         } else {
+            m_classificationTargets.push_back(
+               static_cast<IntEbmType>((iSample % 5 + iSample % 3) % static_cast<size_t>(learningTypeOrCountTargetClasses)));
+         }
+         m_weights.push_back(static_cast<IntEbmType>(iSample % 3 + 1));
+      }
+      const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+      m_predictorScores.resize(cSamples * cVectorLength);
+   }
+};
+
+static PEbmBoosting InitializeBoostingDeferred(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const bool bWeighted,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   std::vector<EbmNativeFeature> features;
+   std::vector<EbmNativeFeatureGroup> featureGroups;
+   std::vector<IntEbmType> featureGroupIndexes;
+   for(size_t iFeature = 0; iFeature < k_cFeaturesDeferred; ++iFeature) {
+      features.push_back({ 0, 0, static_cast<IntEbmType>(k_cBinsDeferred) });
+      featureGroups.push_back({ 1 });
+      featureGroupIndexes.push_back(static_cast<IntEbmType>(iFeature));
+   }
+   // a pair makes the bit packing of one group differ from the rest
+   featureGroups.push_back({ 2 });
+   featureGroupIndexes.push_back(0);
+   featureGroupIndexes.push_back(1);
+
+   const DeferredData training(learningTypeOrCountTargetClasses, k_cTrainingSamplesDeferred, 0);
+   const DeferredData validation(learningTypeOrCountTargetClasses, k_cValidationSamplesDeferred, 1000);
+   const IntEbmType * const trainingWeights = bWeighted ? &training.m_weights[0] : nullptr;
+   const IntEbmType * const validationWeights = bWeighted ? &validation.m_weights[0] : nullptr;
+   const FloatEbmType * const tempParams = optionalTempParams.empty() ? nullptr : &optionalTempParams[0];
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return InitializeBoostingRegressionWeighted(static_cast<IntEbmType>(features.size()), &features[0],
+         static_cast<IntEbmType>(featureGroups.size()), &featureGroups[0], &featureGroupIndexes[0], k_cTrainingSamplesDeferred,
+         &training.m_binnedData[0], &training.m_regressionTargets[0], &training.m_predictorScores[0], trainingWeights,
+         k_cValidationSamplesDeferred, &validation.m_binnedData[0], &validation.m_regressionTargets[0],
+         &validation.m_predictorScores[0], validationWeights, 0, k_randomSeed, tempParams);
+   }
+   return InitializeBoostingClassificationWeighted(learningTypeOrCountTargetClasses, static_cast<IntEbmType>(features.size()),
+      &features[0], static_cast<IntEbmType>(featureGroups.size()), &featureGroups[0], &featureGroupIndexes[0],
+      k_cTrainingSamplesDeferred, &training.m_binnedData[0], &training.m_classificationTargets[0], &training.m_predictorScores[0],
+      trainingWeights, k_cValidationSamplesDeferred, &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+      &validation.m_predictorScores[0], validationWeights, 0, k_randomSeed, tempParams);
+}
+
+static void CheckDeferredMatchesImmediate(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const bool bWeighted
+) {
+   const PEbmBoosting ebmBoostingImmediate = InitializeBoostingDeferred(learningTypeOrCountTargetClasses, bWeighted, {});
+   const PEbmBoosting ebmBoostingDeferred = InitializeBoostingDeferred(learningTypeOrCountTargetClasses, bWeighted, k_tempParamsDeferred);
+   CHECK(nullptr != ebmBoostingImmediate);
+   CHECK(nullptr != ebmBoostingDeferred);
+   if(nullptr == ebmBoostingImmediate || nullptr == ebmBoostingDeferred) {
+      FreeBoosting(ebmBoostingImmediate);
+      FreeBoosting(ebmBoostingDeferred);
+      return;
+   }
+
+   const IntEbmType cFeatureGroups = static_cast<IntEbmType>(k_cFeaturesDeferred + 1);
+   for(int iRound = 0; iRound < 5; ++iRound) {
+      // ask for the metric after a single step, after a few steps, and after more steps than fit in a single pass
+      const IntEbmType aiMetricSteps[] { 0, 3, cFeatureGroups - 1 };
+      size_t iMetricStep = 0;
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         const bool bMetric = aiMetricSteps[iMetricStep] == iFeatureGroup;
+         iMetricStep += bMetric ? 1 : 0;
+
+         FloatEbmType metricImmediate = 0;
+         CHECK(0 == BoostingStep(ebmBoostingImmediate, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricImmediate));
+         FloatEbmType metricDeferred = 0;
+         CHECK(0 == BoostingStep(ebmBoostingDeferred, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, bMetric ? &metricDeferred : nullptr));
+         if(bMetric) {
+            CHECK(std::abs(metricImmediate - metricDeferred) < k_toleranceDeferred);
+         }
+      }
+   }
+
+   // the training side is unaffected, so the current models are identical
+   const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+   for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FloatEbmType * const pModelImmediate = GetCurrentModelFeatureGroup(ebmBoostingImmediate, iFeatureGroup);
+      const FloatEbmType * const pModelDeferred = GetCurrentModelFeatureGroup(ebmBoostingDeferred, iFeatureGroup);
+      const size_t cScores = (k_cFeaturesDeferred == static_cast<size_t>(iFeatureGroup) ? k_cBinsDeferred * k_cBinsDeferred : k_cBinsDeferred) *
+         cVectorLength;
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(pModelImmediate[iScore] == pModelDeferred[iScore]);
+      }
+   }
+   FreeBoosting(ebmBoostingImmediate);
+   FreeBoosting(ebmBoostingDeferred);
+}
+
+TEST_CASE("deferred validation matches immediate validation, boosting, regression") {
+   CheckDeferredMatchesImmediate(testCaseHidden, k_learningTypeRegression, false);
+}
+
+TEST_CASE("deferred validation matches immediate validation, boosting, binary") {
+   CheckDeferredMatchesImmediate(testCaseHidden, 2, false);
+}
+
+TEST_CASE("deferred validation matches immediate validation, boosting, multiclass") {
+   CheckDeferredMatchesImmediate(testCaseHidden, 3, false);
+}
+
+TEST_CASE("deferred validation matches immediate validation, weighted, boosting, binary") {
+   CheckDeferredMatchesImmediate(testCaseHidden, 2, true);
+}
+
+TEST_CASE("deferred validation with BoostingRun matches the metric at the end of each round, boosting, binary") {
+   const PEbmBoosting ebmBoostingRun = InitializeBoostingDeferred(2, false, k_tempParamsDeferred);
+   const PEbmBoosting ebmBoostingStep = InitializeBoostingDeferred(2, false, {});
+   CHECK(nullptr != ebmBoostingRun);
+   CHECK(nullptr != ebmBoostingStep);
+   if(nullptr != ebmBoostingRun && nullptr != ebmBoostingStep) {
+      FloatEbmType metricRun = 0;
+      IntEbmType iRound = 0;
+      CHECK(0 == BoostingRun(ebmBoostingRun, 10, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+         k_countSamplesRequiredForChildSplitMinDefault, -1, 0, nullptr, nullptr, &metricRun, &iRound));
+      CHECK(9 == iRound);
+
+      FloatEbmType metricStepMin = std::numeric_limits<FloatEbmType>::infinity();
+      for(int iRoundStep = 0; iRoundStep < 10; ++iRoundStep) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < static_cast<IntEbmType>(k_cFeaturesDeferred + 1); ++iFeatureGroup) {
+            FloatEbmType metric = 0;
+            CHECK(0 == BoostingStep(ebmBoostingStep, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metric));
+            if(static_cast<IntEbmType>(k_cFeaturesDeferred) == iFeatureGroup) {
+               metricStepMin = std::min(metricStepMin, metric);
+            }
+         }
+      }
+      CHECK(std::abs(metricStepMin - metricRun) < k_toleranceDeferred);
+   }
+   FreeBoosting(ebmBoostingRun);
+   FreeBoosting(ebmBoostingStep);
+}
@@ -0,0 +1,698 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include <stdio.h> // remove, fopen, fwrite, fclose
+#include <string.h> // memcpy
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingPacked;
+
+static const char * const k_trainingFilePath = "ebm_native_test_packed_training.bin";
+static const char * const k_validationFilePath = "ebm_native_test_packed_validation.bin";
+
+static constexpr size_t k_cTrainingSamplesPacked = 300;
+static constexpr size_t k_cValidationSamplesPacked = 70;
+
+// feature 2 has a single bin, so it drops out of the feature groups that include it
+static const EbmNativeFeature k_featuresPacked[] { { 0, 0, 5 }, { 0, 0, 3 }, { 0, 0, 1 }, { 0, 0, 200 } };
+static const EbmNativeFeatureGroup k_featureGroupsPacked[] { { 1 }, { 0 }, { 2 }, { 2 }, { 2 }, { 1 } };
+static const IntEbmType k_featureGroupIndexesPacked[] { 0, 0, 1, 2, 1, 1, 3, 3 };
+// the number of tensor bins of each feature group after dropping the feature with 1 bin
+static const size_t k_cTensorBinsPacked[] { 5, 1, 15, 3, 600, 200 };
+static constexpr IntEbmType k_cFeatureGroupsPacked = 6;
+
+class PackedTestData final {
+public:
+   std::vector<IntEbmType> m_trainingBinnedData;
+   std::vector<IntEbmType> m_trainingClassificationTargets;
+   std::vector<FloatEbmType> m_trainingRegressionTargets;
+   std::vector<FloatEbmType> m_trainingPredictorScores;
+   std::vector<IntEbmType> m_validationBinnedData;
+   std::vector<IntEbmType> m_validationClassificationTargets;
+   std::vector<FloatEbmType> m_validationRegressionTargets;
+   std::vector<FloatEbmType> m_validationPredictorScores;
+
+   PackedTestData(const ptrdiff_t learningTypeOrCountTargetClasses) {
+      const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+      FillData(k_cTrainingSamplesPacked, 0, learningTypeOrCountTargetClasses, m_trainingBinnedData, m_trainingClassificationTargets,
+         m_trainingRegressionTargets);
+      FillData(k_cValidationSamplesPacked, 1000, learningTypeOrCountTargetClasses, m_validationBinnedData, m_validationClassificationTargets,
+         m_validationRegressionTargets);
+      m_trainingPredictorScores.resize(k_cTrainingSamplesPacked * cVectorLength);
+      m_validationPredictorScores.resize(k_cValidationSamplesPacked * cVectorLength);
+   }
+
+private:
+   static void FillData(
+      const size_t cSamples,
+      const size_t iSampleStart,
+      const ptrdiff_t learningTypeOrCountTargetClasses,
+      std::vector<IntEbmType> & binnedData,
+      std::vector<IntEbmType> & classificationTargets,
+      std::vector<FloatEbmType> & regressionTargets
+   ) {
+      binnedData.resize(4 * cSamples);
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const size_t iSampleShifted = iSampleStart + iSample;
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSampleShifted % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSampleShifted * 7 % 3);
+         const IntEbmType bin3 = static_cast<IntEbmType>(iSampleShifted * 13 % 200);
+         binnedData[iSample] = bin0;
+         binnedData[cSamples + iSample] = bin1;
+         binnedData[2 * cSamples + iSample] = 0;
+         binnedData[3 * cSamples + iSample] = bin3;
+         if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+            regressionTargets.push_back(static_cast<FloatEbmType>(bin0 * bin1 + bin3 % 7) +
+               static_cast<FloatEbmType>(iSampleShifted % 11) / FloatEbmType { 10 });
+         } else {
+            classificationTargets.push_back((bin0 + bin1 * bin0 + bin3 % 3 + static_cast<IntEbmType>(iSampleShifted % 13 / 11)) %
+               static_cast<IntEbmType>(learningTypeOrCountTargetClasses));
+         }
+      }
+   }
+};
+
+static PEbmBoosting InitializeBoostingPacked(
+   const PackedTestData & data,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const IntEbmType countFeatureGroups,
+   const PEbmPackedData trainingPackedData,
+   const PEbmPackedData validationPackedData
+) {
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      if(nullptr == trainingPackedData) {
+         return InitializeBoostingRegression(4, k_featuresPacked, countFeatureGroups, k_featureGroupsPacked,
+            k_featureGroupIndexesPacked, k_cTrainingSamplesPacked, &data.m_trainingBinnedData[0],
+            &data.m_trainingRegressionTargets[0], &data.m_trainingPredictorScores[0], k_cValidationSamplesPacked,
+            &data.m_validationBinnedData[0], &data.m_validationRegressionTargets[0], &data.m_validationPredictorScores[0],
+            0, k_randomSeed, nullptr);
+      }
+      return InitializeBoostingRegressionPacked(4, k_featuresPacked, countFeatureGroups, k_featureGroupsPacked,
+         k_featureGroupIndexesPacked, k_cTrainingSamplesPacked, trainingPackedData, nullptr, &data.m_trainingRegressionTargets[0],
+         &data.m_trainingPredictorScores[0], k_cValidationSamplesPacked, validationPackedData, nullptr,
+         &data.m_validationRegressionTargets[0], &data.m_validationPredictorScores[0], 0, k_randomSeed, nullptr);
+   }
+   if(nullptr == trainingPackedData) {
+      return InitializeBoostingClassification(learningTypeOrCountTargetClasses, 4, k_featuresPacked, countFeatureGroups,
+         k_featureGroupsPacked, k_featureGroupIndexesPacked, k_cTrainingSamplesPacked, &data.m_trainingBinnedData[0],
+         &data.m_trainingClassificationTargets[0], &data.m_trainingPredictorScores[0], k_cValidationSamplesPacked,
+         &data.m_validationBinnedData[0], &data.m_validationClassificationTargets[0], &data.m_validationPredictorScores[0],
+         0, k_randomSeed, nullptr);
+   }
+   return InitializeBoostingClassificationPacked(learningTypeOrCountTargetClasses, 4, k_featuresPacked, countFeatureGroups,
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, k_cTrainingSamplesPacked, trainingPackedData,
+      nullptr, &data.m_trainingClassificationTargets[0], &data.m_trainingPredictorScores[0], k_cValidationSamplesPacked,
+      validationPackedData, nullptr, &data.m_validationClassificationTargets[0], &data.m_validationPredictorScores[0], 0,
+      k_randomSeed, nullptr);
+}
+
+static void CheckPackedMatchesBinned(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   const PackedTestData data(learningTypeOrCountTargetClasses);
+   const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+
+   const PEbmBoosting ebmBoostingBinned = InitializeBoostingPacked(data, learningTypeOrCountTargetClasses, k_cFeatureGroupsPacked, nullptr, nullptr);
+   CHECK(nullptr != ebmBoostingBinned);
+   CHECK(0 == SaveBoostingPackedData(ebmBoostingBinned, k_trainingFilePath, k_validationFilePath));
+
+   const PEbmPackedData trainingPackedData = OpenPackedData(k_trainingFilePath);
+   const PEbmPackedData validationPackedData = OpenPackedData(k_validationFilePath);
+   CHECK(nullptr != trainingPackedData);
+   CHECK(nullptr != validationPackedData);
+   if(nullptr != trainingPackedData && nullptr != validationPackedData) {
+      const PEbmBoosting ebmBoostingPacked =
+         InitializeBoostingPacked(data, learningTypeOrCountTargetClasses, k_cFeatureGroupsPacked, trainingPackedData, validationPackedData);
+      CHECK(nullptr != ebmBoostingPacked);
+
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+            FloatEbmType metricBinned = 0;
+            FloatEbmType metricPacked = 0;
+            CHECK(0 == BoostingStep(ebmBoostingBinned, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricBinned));
+            CHECK(0 == BoostingStep(ebmBoostingPacked, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricPacked));
+            // the packed data is identical, so the boosting should be identical too
+            CHECK(metricBinned == metricPacked);
+         }
+      }
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+         const FloatEbmType * const pModelBinned = GetBestModelFeatureGroup(ebmBoostingBinned, iFeatureGroup);
+         const FloatEbmType * const pModelPacked = GetBestModelFeatureGroup(ebmBoostingPacked, iFeatureGroup);
+         const size_t cScores = k_cTensorBinsPacked[iFeatureGroup] * cVectorLength;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK(pModelBinned[iScore] == pModelPacked[iScore]);
+         }
+      }
+
+      FreeBoosting(ebmBoostingPacked);
+   }
+   ClosePackedData(trainingPackedData);
+   ClosePackedData(validationPackedData);
+   FreeBoosting(ebmBoostingBinned);
+   remove(k_trainingFilePath);
+   remove(k_validationFilePath);
+}
+
+TEST_CASE("packed data boosts the same as binned data, regression") {
+   CheckPackedMatchesBinned(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("packed data boosts the same as binned data, binary") {
+   CheckPackedMatchesBinned(testCaseHidden, 2);
+}
+
+TEST_CASE("packed data boosts the same as binned data, multiclass") {
+   CheckPackedMatchesBinned(testCaseHidden, 3);
+}
+
+TEST_CASE("packed data with different feature groups, boosting, regression") {
+   const PackedTestData data(k_learningTypeRegression);
+   const PEbmBoosting ebmBoostingBinned = InitializeBoostingPacked(data, k_learningTypeRegression, k_cFeatureGroupsPacked, nullptr, nullptr);
+   CHECK(nullptr != ebmBoostingBinned);
+   CHECK(0 == SaveBoostingPackedData(ebmBoostingBinned, k_trainingFilePath, nullptr));
+   FreeBoosting(ebmBoostingBinned);
+
+   const PEbmPackedData trainingPackedData = OpenPackedData(k_trainingFilePath);
+   CHECK(nullptr != trainingPackedData);
+   if(nullptr != trainingPackedData) {
+      // the packed data has one more feature group than we ask for
+      const PEbmBoosting ebmBoostingPacked =
+         InitializeBoostingPacked(data, k_learningTypeRegression, k_cFeatureGroupsPacked - 1, trainingPackedData, trainingPackedData);
+      CHECK(nullptr == ebmBoostingPacked);
+   }
+   ClosePackedData(trainingPackedData);
+   remove(k_trainingFilePath);
+}
+
+TEST_CASE("packed data keeps the aligned bit packing it was saved with, boosting, regression") {
+   const PackedTestData data(k_learningTypeRegression);
+   const std::vector<FloatEbmType> tempParamsAligned = MakeTempParams({ { TempParamBoostingAlignedPacking, 4 } });
+   const PEbmBoosting ebmBoostingBinned = InitializeBoostingRegression(4, k_featuresPacked, k_cFeatureGroupsPacked, 
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, k_cTrainingSamplesPacked, &data.m_trainingBinnedData[0],
+      &data.m_trainingRegressionTargets[0], &data.m_trainingPredictorScores[0], k_cValidationSamplesPacked,
+      &data.m_validationBinnedData[0], &data.m_validationRegressionTargets[0], &data.m_validationPredictorScores[0],
+      0, k_randomSeed, &tempParamsAligned[0]);
+   CHECK(nullptr != ebmBoostingBinned);
+   CHECK(0 == SaveBoostingPackedData(ebmBoostingBinned, k_trainingFilePath, k_validationFilePath));
+
+   const PEbmPackedData trainingPackedData = OpenPackedData(k_trainingFilePath);
+   const PEbmPackedData validationPackedData = OpenPackedData(k_validationFilePath);
+   const PEbmPackedData tightPackedData = CreatePackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, k_cValidationSamplesPacked, &data.m_validationBinnedData[0]);
+   CHECK(nullptr != trainingPackedData);
+   CHECK(nullptr != validationPackedData);
+   CHECK(nullptr != tightPackedData);
+   if(nullptr != trainingPackedData && nullptr != validationPackedData && nullptr != tightPackedData) {
+      // a booster without the temp param adopts the aligned packing from the files
+      const PEbmBoosting ebmBoostingPacked = 
+         InitializeBoostingPacked(data, k_learningTypeRegression, k_cFeatureGroupsPacked, trainingPackedData, validationPackedData);
+      CHECK(nullptr != ebmBoostingPacked);
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+         FloatEbmType metricBinned = 0;
+         FloatEbmType metricPacked = 0;
+         CHECK(0 == BoostingStep(ebmBoostingBinned, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricBinned));
+         CHECK(0 == BoostingStep(ebmBoostingPacked, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricPacked));
+         CHECK(metricBinned == metricPacked);
+      }
+      FreeBoosting(ebmBoostingPacked);
+
+      // the 200 bin feature groups are packed differently in the training and validation data
+      CHECK(nullptr == InitializeBoostingPacked(data, k_learningTypeRegression, k_cFeatureGroupsPacked, trainingPackedData, 
+         tightPackedData));
+   }
+   ClosePackedData(tightPackedData);
+   ClosePackedData(trainingPackedData);
+   ClosePackedData(validationPackedData);
+   FreeBoosting(ebmBoostingBinned);
+   remove(k_trainingFilePath);
+   remove(k_validationFilePath);
+}
+
+TEST_CASE("packed data corrupted file, boosting, regression") {
+   CHECK(nullptr == OpenPackedData(k_trainingFilePath));
+
+   const PackedTestData data(k_learningTypeRegression);
+   const PEbmBoosting ebmBoostingBinned = InitializeBoostingPacked(data, k_learningTypeRegression, k_cFeatureGroupsPacked, nullptr, nullptr);
+   CHECK(nullptr != ebmBoostingBinned);
+   CHECK(0 == SaveBoostingPackedData(ebmBoostingBinned, k_trainingFilePath, nullptr));
+   FreeBoosting(ebmBoostingBinned);
+
+   // overwrite the last data unit of the last feature group with bins outside of its 200 bin tensor
+   FILE * const pFile = fopen(k_trainingFilePath, "r+b");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      const uint64_t corrupt = ~uint64_t { 0 };
+      CHECK(0 == fseek(pFile, -static_cast<long>(sizeof(corrupt)), SEEK_END));
+      CHECK(1 == fwrite(&corrupt, sizeof(corrupt), 1, pFile));
+      fclose(pFile);
+   }
+   CHECK(nullptr == OpenPackedData(k_trainingFilePath));
+   remove(k_trainingFilePath);
+}
+
+// every fifth sample goes to validation, like an outer bag would split the data
+static bool IsValidationSampleShared(const size_t iSample, const size_t iBag) {
+   return iBag == iSample % 5;
+}
+
+class SharedTestData final {
+public:
+   static constexpr size_t k_cSamples = k_cTrainingSamplesPacked + k_cValidationSamplesPacked;
+
+   // the full data set that the shared packed data holds
+   PackedTestData m_all;
+   std::vector<IntEbmType> m_trainingMask;
+   std::vector<IntEbmType> m_validationMask;
+   // copies of the masked samples, which is what each outer bag passes us without shared data
+   std::vector<IntEbmType> m_trainingBinnedData;
+   std::vector<IntEbmType> m_trainingClassificationTargets;
+   std::vector<FloatEbmType> m_trainingRegressionTargets;
+   std::vector<FloatEbmType> m_trainingPredictorScores;
+   std::vector<IntEbmType> m_validationBinnedData;
+   std::vector<IntEbmType> m_validationClassificationTargets;
+   std::vector<FloatEbmType> m_validationRegressionTargets;
+   std::vector<FloatEbmType> m_validationPredictorScores;
+
+   SharedTestData(const ptrdiff_t learningTypeOrCountTargetClasses, const size_t iBag) : m_all(learningTypeOrCountTargetClasses) {
+      const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+      // PackedTestData gives us training and validation sets, but here we use them as one set of k_cSamples
+      AppendAll(m_all.m_trainingBinnedData, m_all.m_validationBinnedData, k_cTrainingSamplesPacked, k_cValidationSamplesPacked);
+      m_all.m_trainingClassificationTargets.insert(m_all.m_trainingClassificationTargets.end(),
+         m_all.m_validationClassificationTargets.begin(), m_all.m_validationClassificationTargets.end());
+      m_all.m_trainingRegressionTargets.insert(m_all.m_trainingRegressionTargets.end(),
+         m_all.m_validationRegressionTargets.begin(), m_all.m_validationRegressionTargets.end());
+      m_all.m_trainingPredictorScores.resize(k_cSamples * cVectorLength);
+
+      const bool bRegression = k_learningTypeRegression == learningTypeOrCountTargetClasses;
+      size_t cTraining = 0;
+      for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+         const bool bValidation = IsValidationSampleShared(iSample, iBag);
+         m_trainingMask.push_back(bValidation ? IntEbmType { 0 } : IntEbmType { 1 });
+         m_validationMask.push_back(bValidation ? IntEbmType { 7 } : IntEbmType { 0 });
+         if(bRegression) {
+            (bValidation ? m_validationRegressionTargets : m_trainingRegressionTargets).push_back(m_all.m_trainingRegressionTargets[iSample]);
+         } else {
+            (bValidation ? m_validationClassificationTargets : m_trainingClassificationTargets).push_back(
+               m_all.m_trainingClassificationTargets[iSample]);
+         }
+         cTraining += bValidation ? size_t { 0 } : size_t { 1 };
+      }
+      const size_t cValidation = k_cSamples - cTraining;
+      m_trainingBinnedData.resize(4 * cTraining);
+      m_validationBinnedData.resize(4 * cValidation);
+      for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+         size_t iTraining = 0;
+         size_t iValidation = 0;
+         for(size_t iSample = 0; iSample < k_cSamples; ++iSample) {
+            const IntEbmType bin = m_all.m_trainingBinnedData[iFeature * k_cSamples + iSample];
+            if(IsValidationSampleShared(iSample, iBag)) {
+               m_validationBinnedData[iFeature * cValidation + iValidation] = bin;
+               ++iValidation;
+            } else {
+               m_trainingBinnedData[iFeature * cTraining + iTraining] = bin;
+               ++iTraining;
+            }
+         }
+      }
+      m_trainingPredictorScores.resize(cTraining * cVectorLength);
+      m_validationPredictorScores.resize(cValidation * cVectorLength);
+   }
+
+   size_t GetCountTrainingSamples() const {
+      return m_trainingBinnedData.size() / 4;
+   }
+   size_t GetCountValidationSamples() const {
+      return m_validationBinnedData.size() / 4;
+   }
+
+private:
+   static void AppendAll(
+      std::vector<IntEbmType> & first,
+      const std::vector<IntEbmType> & second,
+      const size_t cFirst,
+      const size_t cSecond
+   ) {
+      // binned data is feature major, so we need to interleave the features of both
+      std::vector<IntEbmType> all;
+      for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+         all.insert(all.end(), first.begin() + iFeature * cFirst, first.begin() + (iFeature + 1) * cFirst);
+         all.insert(all.end(), second.begin() + iFeature * cSecond, second.begin() + (iFeature + 1) * cSecond);
+      }
+      first = all;
+   }
+};
+
+static PEbmBoosting InitializeBoostingShared(
+   const SharedTestData & data,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const PEbmPackedData packedData,
+   const IntEbmType countInnerBags,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const FloatEbmType * const aTempParams = 0 == optionalTempParams.size() ? nullptr : &optionalTempParams[0];
+   const IntEbmType cTraining = static_cast<IntEbmType>(data.GetCountTrainingSamples());
+   const IntEbmType cValidation = static_cast<IntEbmType>(data.GetCountValidationSamples());
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      if(nullptr == packedData) {
+         return InitializeBoostingRegression(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+            k_featureGroupIndexesPacked, cTraining, &data.m_trainingBinnedData[0], &data.m_trainingRegressionTargets[0],
+            &data.m_trainingPredictorScores[0], cValidation, &data.m_validationBinnedData[0],
+            &data.m_validationRegressionTargets[0], &data.m_validationPredictorScores[0], countInnerBags, k_randomSeed,
+            aTempParams);
+      }
+      return InitializeBoostingRegressionPacked(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+         k_featureGroupIndexesPacked, SharedTestData::k_cSamples, packedData, &data.m_trainingMask[0],
+         &data.m_all.m_trainingRegressionTargets[0], &data.m_all.m_trainingPredictorScores[0], SharedTestData::k_cSamples,
+         packedData, &data.m_validationMask[0], &data.m_all.m_trainingRegressionTargets[0],
+         &data.m_all.m_trainingPredictorScores[0], countInnerBags, k_randomSeed, aTempParams);
+   }
+   if(nullptr == packedData) {
+      return InitializeBoostingClassification(learningTypeOrCountTargetClasses, 4, k_featuresPacked, k_cFeatureGroupsPacked,
+         k_featureGroupsPacked, k_featureGroupIndexesPacked, cTraining, &data.m_trainingBinnedData[0],
+         &data.m_trainingClassificationTargets[0], &data.m_trainingPredictorScores[0], cValidation,
+         &data.m_validationBinnedData[0], &data.m_validationClassificationTargets[0], &data.m_validationPredictorScores[0],
+         countInnerBags, k_randomSeed, aTempParams);
+   }
+   return InitializeBoostingClassificationPacked(learningTypeOrCountTargetClasses, 4, k_featuresPacked, k_cFeatureGroupsPacked,
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, SharedTestData::k_cSamples, packedData, &data.m_trainingMask[0],
+      &data.m_all.m_trainingClassificationTargets[0], &data.m_all.m_trainingPredictorScores[0], SharedTestData::k_cSamples,
+      packedData, &data.m_validationMask[0], &data.m_all.m_trainingClassificationTargets[0],
+      &data.m_all.m_trainingPredictorScores[0], countInnerBags, k_randomSeed, aTempParams);
+}
+
+static void CheckSharedMatchesBinned(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const IntEbmType countInnerBags,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+   const size_t cBags = 3;
+   std::vector<SharedTestData> data;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      data.emplace_back(learningTypeOrCountTargetClasses, iBag);
+   }
+
+   // every bag has the same full data set, so any of them can create the shared packed data
+   const PEbmPackedData packedData = CreatePackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, SharedTestData::k_cSamples, &data[0].m_all.m_trainingBinnedData[0]);
+   CHECK(nullptr != packedData);
+   if(nullptr == packedData) {
+      return;
+   }
+   std::vector<PEbmBoosting> boostersBinned;
+   std::vector<PEbmBoosting> boostersShared;
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      boostersBinned.push_back(InitializeBoostingShared(data[iBag], learningTypeOrCountTargetClasses, nullptr, countInnerBags,
+         optionalTempParams));
+      boostersShared.push_back(InitializeBoostingShared(data[iBag], learningTypeOrCountTargetClasses, packedData, countInnerBags,
+         optionalTempParams));
+      CHECK(nullptr != boostersBinned.back());
+      CHECK(nullptr != boostersShared.back());
+   }
+   // the boosters hold their own references, so we don't need ours anymore
+   ClosePackedData(packedData);
+
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      if(nullptr == boostersBinned[iBag] || nullptr == boostersShared[iBag]) {
+         continue;
+      }
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+            FloatEbmType metricBinned = 0;
+            FloatEbmType metricShared = 0;
+            CHECK(0 == BoostingStep(boostersBinned[iBag], iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricBinned));
+            CHECK(0 == BoostingStep(boostersShared[iBag], iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricShared));
+            // the masks select the same samples in the same order as the copies, so boosting should be identical
+            CHECK(metricBinned == metricShared);
+         }
+      }
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+         const FloatEbmType * const pModelBinned = GetBestModelFeatureGroup(boostersBinned[iBag], iFeatureGroup);
+         const FloatEbmType * const pModelShared = GetBestModelFeatureGroup(boostersShared[iBag], iFeatureGroup);
+         const size_t cScores = k_cTensorBinsPacked[iFeatureGroup] * cVectorLength;
+         for(size_t iScore = 0; iScore < cScores; ++iScore) {
+            CHECK(pModelBinned[iScore] == pModelShared[iScore]);
+         }
+      }
+   }
+   for(size_t iBag = 0; iBag < cBags; ++iBag) {
+      FreeBoosting(boostersBinned[iBag]);
+      FreeBoosting(boostersShared[iBag]);
+   }
+}
+
+TEST_CASE("shared packed data with sample masks boosts the same as copies, regression") {
+   CheckSharedMatchesBinned(testCaseHidden, k_learningTypeRegression, 0, {});
+}
+
+TEST_CASE("shared packed data with sample masks boosts the same as copies, binary") {
+   CheckSharedMatchesBinned(testCaseHidden, 2, 0, {});
+}
+
+TEST_CASE("shared packed data with sample masks boosts the same as copies, multiclass") {
+   CheckSharedMatchesBinned(testCaseHidden, 3, 0, {});
+}
+
+TEST_CASE("shared packed data with sample masks and inner bags boosts the same as copies, regression") {
+   CheckSharedMatchesBinned(testCaseHidden, k_learningTypeRegression, 2, {});
+}
+
+TEST_CASE("shared packed data with sample masks and inner bags without replacement boosts the same as copies, binary") {
+   CheckSharedMatchesBinned(testCaseHidden, 2, 2, MakeTempParams({ { TempParamBoostingFractionWithoutReplacement, 0.6 } }));
+}
+
+TEST_CASE("shared packed data with an empty sample mask, boosting, regression") {
+   const SharedTestData data(k_learningTypeRegression, 0);
+   const PEbmPackedData packedData = CreatePackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, SharedTestData::k_cSamples, &data.m_all.m_trainingBinnedData[0]);
+   CHECK(nullptr != packedData);
+   const std::vector<IntEbmType> emptyMask(SharedTestData::k_cSamples, 0);
+   const PEbmBoosting ebmBoosting = InitializeBoostingRegressionPacked(4, k_featuresPacked, k_cFeatureGroupsPacked,
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, SharedTestData::k_cSamples, packedData, &data.m_trainingMask[0],
+      &data.m_all.m_trainingRegressionTargets[0], &data.m_all.m_trainingPredictorScores[0], SharedTestData::k_cSamples,
+      packedData, &emptyMask[0], &data.m_all.m_trainingRegressionTargets[0], &data.m_all.m_trainingPredictorScores[0], 0,
+      k_randomSeed, nullptr);
+   CHECK(nullptr == ebmBoosting);
+   ClosePackedData(packedData);
+}
+
+TEST_CASE("shared packed data saved and opened by several workers boosts the same as in memory, binary") {
+   const ptrdiff_t learningTypeOrCountTargetClasses = 2;
+   const SharedTestData data(learningTypeOrCountTargetClasses, 2);
+   const PEbmPackedData packedMemory = CreatePackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, SharedTestData::k_cSamples, &data.m_all.m_trainingBinnedData[0]);
+   CHECK(nullptr != packedMemory);
+   CHECK(0 != SavePackedData(nullptr, k_trainingFilePath));
+   CHECK(0 != SavePackedData(packedMemory, nullptr));
+   CHECK(0 == SavePackedData(packedMemory, k_trainingFilePath));
+
+   // each worker process opens the file on its own, so they only share the mapped pages
+   const PEbmPackedData packedWorker0 = OpenPackedData(k_trainingFilePath);
+   const PEbmPackedData packedWorker1 = OpenPackedData(k_trainingFilePath);
+   CHECK(nullptr != packedWorker0);
+   CHECK(nullptr != packedWorker1);
+   if(nullptr != packedMemory && nullptr != packedWorker0 && nullptr != packedWorker1) {
+      const PEbmBoosting boosterMemory = InitializeBoostingShared(data, learningTypeOrCountTargetClasses, packedMemory, 0, {});
+      const PEbmBoosting boosterWorker0 = InitializeBoostingShared(data, learningTypeOrCountTargetClasses, packedWorker0, 0, {});
+      const PEbmBoosting boosterWorker1 = InitializeBoostingShared(data, learningTypeOrCountTargetClasses, packedWorker1, 0, {});
+      CHECK(nullptr != boosterMemory);
+      CHECK(nullptr != boosterWorker0);
+      CHECK(nullptr != boosterWorker1);
+      if(nullptr != boosterMemory && nullptr != boosterWorker0 && nullptr != boosterWorker1) {
+         for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+            for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+               FloatEbmType metricMemory = 0;
+               FloatEbmType metricWorker0 = 0;
+               FloatEbmType metricWorker1 = 0;
+               CHECK(0 == BoostingStep(boosterMemory, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricMemory));
+               CHECK(0 == BoostingStep(boosterWorker0, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricWorker0));
+               CHECK(0 == BoostingStep(boosterWorker1, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricWorker1));
+               CHECK(metricMemory == metricWorker0);
+               CHECK(metricMemory == metricWorker1);
+            }
+         }
+      }
+      FreeBoosting(boosterMemory);
+      FreeBoosting(boosterWorker0);
+      FreeBoosting(boosterWorker1);
+   }
+   ClosePackedData(packedMemory);
+   ClosePackedData(packedWorker0);
+   ClosePackedData(packedWorker1);
+   remove(k_trainingFilePath);
+}
+
+// if chunks is empty we pack all of the columns at once, and otherwise we append chunks of those sizes to a builder
+static PEbmPackedData PackColumns(
+   TestCaseHidden & testCaseHidden, 
+   const std::vector<EbmNativeBinnedColumn> & columns, 
+   const std::vector<size_t> & chunks
+) {
+   const IntEbmType cSamples = static_cast<IntEbmType>(SharedTestData::k_cSamples);
+   if(chunks.empty()) {
+      return CreatePackedDataFromColumns(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+         k_featureGroupIndexesPacked, cSamples, &columns[0]);
+   }
+   const PEbmPackedDataBuilder builder = BeginPackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, cSamples);
+   CHECK(nullptr != builder);
+   if(nullptr == builder) {
+      return nullptr;
+   }
+   size_t iSample = 0;
+   for(const size_t cChunk : chunks) {
+      std::vector<EbmNativeBinnedColumn> chunkColumns(columns);
+      for(EbmNativeBinnedColumn & column : chunkColumns) {
+         column.data = static_cast<const char *>(column.data) + iSample * static_cast<size_t>(column.countBytesStride);
+      }
+      CHECK(0 == AppendPackedData(builder, static_cast<IntEbmType>(cChunk), &chunkColumns[0]));
+      iSample += cChunk;
+   }
+   const PEbmPackedData packedData = FinishPackedData(builder);
+   FreePackedDataBuilder(builder);
+   return packedData;
+}
+
+static void CheckColumnsMatchBinned(
+   TestCaseHidden & testCaseHidden, 
+   const ptrdiff_t learningTypeOrCountTargetClasses, 
+   const std::vector<size_t> & chunks
+) {
+   const SharedTestData data(learningTypeOrCountTargetClasses, 1);
+   const std::vector<IntEbmType> & binnedData = data.m_all.m_trainingBinnedData;
+   const size_t cSamples = SharedTestData::k_cSamples;
+
+   // interleave the features into unaligned rows of { uint8_t, uint16_t, uint8_t, uint16_t }, which is the kind of 
+   // narrow strided data that the caller has before widening it into IntEbmType
+   static constexpr size_t k_cBytesRow = 6;
+   static const size_t k_iByteFeature[] { 0, 1, 3, 4 };
+   static const size_t k_cBytesFeature[] { 1, 2, 1, 2 };
+   std::vector<unsigned char> rows(k_cBytesRow * cSamples);
+   std::vector<EbmNativeBinnedColumn> columns;
+   for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         unsigned char * const pBin = &rows[iSample * k_cBytesRow + k_iByteFeature[iFeature]];
+         const IntEbmType bin = binnedData[iFeature * cSamples + iSample];
+         if(1 == k_cBytesFeature[iFeature]) {
+            const uint8_t bin8 = static_cast<uint8_t>(bin);
+            memcpy(pBin, &bin8, sizeof(bin8));
+         } else {
+            const uint16_t bin16 = static_cast<uint16_t>(bin);
+            memcpy(pBin, &bin16, sizeof(bin16));
+         }
+      }
+      columns.push_back({ &rows[k_iByteFeature[iFeature]], static_cast<IntEbmType>(k_cBytesFeature[iFeature]),
+         static_cast<IntEbmType>(k_cBytesRow) });
+   }
+
+   const PEbmPackedData packedBinned = CreatePackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, static_cast<IntEbmType>(cSamples), &binnedData[0]);
+   const PEbmPackedData packedColumns = PackColumns(testCaseHidden, columns, chunks);
+   CHECK(nullptr != packedBinned);
+   CHECK(nullptr != packedColumns);
+   if(nullptr != packedBinned && nullptr != packedColumns) {
+      const PEbmBoosting boosterBinned = InitializeBoostingShared(data, learningTypeOrCountTargetClasses, packedBinned, 0, {});
+      const PEbmBoosting boosterColumns = InitializeBoostingShared(data, learningTypeOrCountTargetClasses, packedColumns, 0, {});
+      CHECK(nullptr != boosterBinned);
+      CHECK(nullptr != boosterColumns);
+      if(nullptr != boosterBinned && nullptr != boosterColumns) {
+         for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+            for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsPacked; ++iFeatureGroup) {
+               FloatEbmType metricBinned = 0;
+               FloatEbmType metricColumns = 0;
+               CHECK(0 == BoostingStep(boosterBinned, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricBinned));
+               CHECK(0 == BoostingStep(boosterColumns, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+                  k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricColumns));
+               // both paths bit pack the same bins, so boosting should be identical
+               CHECK(metricBinned == metricColumns);
+            }
+         }
+      }
+      FreeBoosting(boosterBinned);
+      FreeBoosting(boosterColumns);
+   }
+   ClosePackedData(packedBinned);
+   ClosePackedData(packedColumns);
+}
+
+TEST_CASE("packed data from narrow strided columns boosts the same as binned data, regression") {
+   CheckColumnsMatchBinned(testCaseHidden, k_learningTypeRegression, {});
+}
+
+TEST_CASE("packed data from narrow strided columns boosts the same as binned data, multiclass") {
+   CheckColumnsMatchBinned(testCaseHidden, 3, {});
+}
+
+TEST_CASE("packed data from columns with an invalid bin width, boosting, regression") {
+   const SharedTestData data(k_learningTypeRegression, 0);
+   const IntEbmType * const aBinnedData = &data.m_all.m_trainingBinnedData[0];
+   std::vector<EbmNativeBinnedColumn> columns;
+   for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+      columns.push_back({ &aBinnedData[iFeature * SharedTestData::k_cSamples], IntEbmType { sizeof(IntEbmType) },
+         IntEbmType { sizeof(IntEbmType) } });
+   }
+   columns[2].countBytesPerBin = 3;
+   const PEbmPackedData packedData = CreatePackedDataFromColumns(4, k_featuresPacked, k_cFeatureGroupsPacked,
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, SharedTestData::k_cSamples, &columns[0]);
+   CHECK(nullptr == packedData);
+}
+
+TEST_CASE("packed data from columns with a bin past the end, boosting, regression") {
+   const SharedTestData data(k_learningTypeRegression, 0);
+   std::vector<uint8_t> bins(SharedTestData::k_cSamples * 4, 0);
+   bins[SharedTestData::k_cSamples + 7] = 3; // the second feature only has 3 bins
+   std::vector<EbmNativeBinnedColumn> columns;
+   for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+      columns.push_back({ &bins[iFeature * SharedTestData::k_cSamples], 1, 1 });
+   }
+   const PEbmPackedData packedData = CreatePackedDataFromColumns(4, k_featuresPacked, k_cFeatureGroupsPacked,
+      k_featureGroupsPacked, k_featureGroupIndexesPacked, SharedTestData::k_cSamples, &columns[0]);
+   CHECK(nullptr == packedData);
+}
+
+TEST_CASE("packed data appended in chunks boosts the same as binned data, regression") {
+   // the chunks start part way through the bit packed data units of every feature group
+   CheckColumnsMatchBinned(testCaseHidden, k_learningTypeRegression, { 1, 63, 0, 100, 7, 199 });
+}
+
+TEST_CASE("packed data appended in chunks boosts the same as binned data, binary") {
+   CheckColumnsMatchBinned(testCaseHidden, 2, { 185, 185 });
+}
+
+TEST_CASE("packed data appended in chunks of one sample boosts the same as binned data, multiclass") {
+   CheckColumnsMatchBinned(testCaseHidden, 3, std::vector<size_t>(SharedTestData::k_cSamples, 1));
+}
+
+TEST_CASE("packed data builder with missing or extra samples, boosting, regression") {
+   const SharedTestData data(k_learningTypeRegression, 0);
+   const IntEbmType * const aBinnedData = &data.m_all.m_trainingBinnedData[0];
+   std::vector<EbmNativeBinnedColumn> columns;
+   for(size_t iFeature = 0; iFeature < 4; ++iFeature) {
+      columns.push_back({ &aBinnedData[iFeature * SharedTestData::k_cSamples], IntEbmType { sizeof(IntEbmType) },
+         IntEbmType { sizeof(IntEbmType) } });
+   }
+   const PEbmPackedDataBuilder builder = BeginPackedData(4, k_featuresPacked, k_cFeatureGroupsPacked, k_featureGroupsPacked,
+      k_featureGroupIndexesPacked, SharedTestData::k_cSamples + 1);
+   CHECK(nullptr != builder);
+   CHECK(0 == AppendPackedData(builder, SharedTestData::k_cSamples, &columns[0]));
+   // one sample short
+   CHECK(nullptr == FinishPackedData(builder));
+   // one sample past the end
+   CHECK(0 != AppendPackedData(builder, 2, &columns[0]));
+   CHECK(nullptr == FinishPackedData(builder));
+   FreePackedDataBuilder(builder);
+}
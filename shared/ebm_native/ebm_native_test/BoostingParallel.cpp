@@ -0,0 +1,1312 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingParallel;
+
+static constexpr size_t k_cSamplesParallel = 1000;
+
+static std::vector<FloatEbmType> MakeTempParamsShards(const FloatEbmType countShards) {
+   return MakeTempParams({ { TempParamBoostingCountShards, countShards } });
+}
+
+static std::vector<FloatEbmType> MakeTempParamsWithoutReplacement(const FloatEbmType countShards, const FloatEbmType fraction) {
+   return MakeTempParams({ 
+      { TempParamBoostingCountShards, countShards }, 
+      { TempParamBoostingFractionWithoutReplacement, fraction } 
+   });
+}
+
+static std::vector<FloatEbmType> MakeTempParamsSimd(const FloatEbmType simd) {
+   return MakeTempParams({ { TempParamBoostingSimd, simd } });
+}
+
+static void InitializeRegressionParallel(
+   TestApi & test, 
+   const IntEbmType countInnerBags, 
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ {}, { 0 }, { 1 }, { 0, 1 } });
+   std::vector<RegressionSample> trainingSamples;
+   for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+      const FloatEbmType target = static_cast<FloatEbmType>(bin0 * 3 - bin1 * 2) + static_cast<FloatEbmType>(iSample % 13) / 10;
+      trainingSamples.push_back(RegressionSample(target, { bin0, bin1 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   test.AddValidationSamples({ RegressionSample(3, { 1, 0 }), RegressionSample(-1, { 0, 3 }), RegressionSample(8, { 4, 2 }) });
+   test.InitializeBoosting(countInnerBags, optionalTempParams);
+}
+
+static void InitializeMulticlassParallel(
+   TestApi & test, 
+   const IntEbmType countInnerBags, 
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ {}, { 0 }, { 1 }, { 0, 1 } });
+   std::vector<ClassificationSample> trainingSamples;
+   for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+      const IntEbmType target = static_cast<IntEbmType>((bin0 + bin1 + static_cast<IntEbmType>(iSample % 11 / 9)) % 3);
+      trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   test.AddValidationSamples({ ClassificationSample(0, { 1, 2 }), ClassificationSample(2, { 0, 3 }), ClassificationSample(1, { 4, 1 }) });
+   test.InitializeBoosting(countInnerBags, optionalTempParams);
+}
+
+static void InitializeBinaryParallel(
+   TestApi & test, 
+   const IntEbmType countInnerBags, 
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ {}, { 0 }, { 1 }, { 0, 1 } });
+   // we use sample counts that aren't multiples of the SIMD width so that we exercise the partial vectors at the end
+   std::vector<ClassificationSample> trainingSamples;
+   for(size_t iSample = 0; iSample < k_cSamplesParallel + 3; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+      const IntEbmType target = static_cast<IntEbmType>((bin0 + bin1 + static_cast<IntEbmType>(iSample % 11 / 9)) % 2);
+      trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   std::vector<ClassificationSample> validationSamples;
+   for(size_t iSample = 0; iSample < 101; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample * 3 % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample % 4);
+      const IntEbmType target = static_cast<IntEbmType>((bin0 + bin1 + static_cast<IntEbmType>(iSample % 7 / 5)) % 2);
+      validationSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+   }
+   test.AddValidationSamples(validationSamples);
+   test.InitializeBoosting(countInnerBags, optionalTempParams);
+}
+
+TEST_CASE("sharded BinBoosting matches unsharded, boosting, regression") {
+   TestApi testSerial = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSerial, k_countInnerBagsDefault, {});
+   TestApi testSharded = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSharded, k_countInnerBagsDefault, MakeTempParamsShards(4));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSerial.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetricSerial = testSerial.Boost(iFeatureGroup);
+         const FloatEbmType validationMetricSharded = testSharded.Boost(iFeatureGroup);
+         CHECK_APPROX(validationMetricSharded, validationMetricSerial);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK_APPROX(testSharded.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0),
+            testSerial.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0));
+      }
+   }
+}
+
+TEST_CASE("sharded BinBoosting matches unsharded, boosting, multiclass") {
+   TestApi testSerial = TestApi(3);
+   InitializeMulticlassParallel(testSerial, 2, {});
+   TestApi testSharded = TestApi(3);
+   InitializeMulticlassParallel(testSharded, 2, MakeTempParamsShards(3));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSerial.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetricSerial = testSerial.Boost(iFeatureGroup);
+         const FloatEbmType validationMetricSharded = testSharded.Boost(iFeatureGroup);
+         CHECK_APPROX(validationMetricSharded, validationMetricSerial);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK_APPROX(testSharded.GetCurrentModelPredictorScore(1, { iBin0 }, iClass),
+            testSerial.GetCurrentModelPredictorScore(1, { iBin0 }, iClass));
+      }
+   }
+}
+
+TEST_CASE("sharded BinBoosting is repeatable, boosting, multiclass") {
+   TestApi test0 = TestApi(3);
+   InitializeMulticlassParallel(test0, k_countInnerBagsDefault, MakeTempParamsShards(7));
+   TestApi test1 = TestApi(3);
+   InitializeMulticlassParallel(test1, k_countInnerBagsDefault, MakeTempParamsShards(7));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test0.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetric0 = test0.Boost(iFeatureGroup);
+         const FloatEbmType validationMetric1 = test1.Boost(iFeatureGroup);
+         CHECK(validationMetric0 == validationMetric1);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(test0.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 2) ==
+            test1.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 2));
+      }
+   }
+}
+
+TEST_CASE("pinned NUMA placement is repeatable and matches unsharded, boosting, multiclass") {
+   TestApi testSerial = TestApi(3);
+   InitializeMulticlassParallel(testSerial, 2, {});
+
+   // threads are pinned when they start, so restart them under the pinned placement.  On a machine with several nodes
+   // the 7 shards are reduced within each node first, which only changes the last bits of our sums
+   CHECK(0 == ShutdownThreadPool());
+   SetNumaPlacement(NumaPlacementInterleavePinned);
+   TestApi test0 = TestApi(3);
+   InitializeMulticlassParallel(test0, 2, MakeTempParamsShards(7));
+   TestApi test1 = TestApi(3);
+   InitializeMulticlassParallel(test1, 2, MakeTempParamsShards(7));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSerial.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetricSerial = testSerial.Boost(iFeatureGroup);
+         const FloatEbmType validationMetric0 = test0.Boost(iFeatureGroup);
+         const FloatEbmType validationMetric1 = test1.Boost(iFeatureGroup);
+         CHECK(validationMetric0 == validationMetric1);
+         CHECK_APPROX(validationMetric0, validationMetricSerial);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(test0.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1) ==
+            test1.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1));
+         CHECK_APPROX(test0.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1),
+            testSerial.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1));
+      }
+   }
+
+   SetNumaPlacement(NumaPlacementFirstTouch);
+   CHECK(0 == ShutdownThreadPool());
+}
+
+// residual initialization hands out blocks of 16384 samples to threads, so 40 copies of 1000 samples span several 
+// blocks.  Every copy adds the same gradients, which keeps the updates equal to boosting a single copy
+static constexpr size_t k_cCopiesInitializeResiduals = 40;
+
+static void InitializeMulticlassCopies(TestApi & test, const size_t cCopies) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ { 0 }, { 1 } });
+   std::vector<ClassificationSample> trainingSamples;
+   for(size_t iSample = 0; iSample < k_cSamplesParallel * cCopies; ++iSample) {
+      const size_t iOriginal = iSample % k_cSamplesParallel;
+      const IntEbmType bin0 = static_cast<IntEbmType>(iOriginal % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iOriginal * 7 % 4);
+      const IntEbmType target = static_cast<IntEbmType>((bin0 + bin1 + static_cast<IntEbmType>(iOriginal % 11 / 9)) % 3);
+      const FloatEbmType logit = static_cast<FloatEbmType>(iOriginal % 17) / 10;
+      trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }, { logit, -logit, logit / 2 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   test.AddValidationSamples({ ClassificationSample(0, { 1, 2 }), ClassificationSample(2, { 0, 3 }), ClassificationSample(1, { 4, 1 }) });
+   test.InitializeBoosting(0);
+}
+
+TEST_CASE("residual initialization over many blocks matches a single block, boosting, multiclass") {
+   TestApi testSingle = TestApi(3);
+   InitializeMulticlassCopies(testSingle, 1);
+   TestApi testCopies = TestApi(3);
+   InitializeMulticlassCopies(testCopies, k_cCopiesInitializeResiduals);
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSingle.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK_APPROX(testCopies.Boost(iFeatureGroup), testSingle.Boost(iFeatureGroup));
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK_APPROX(testCopies.GetCurrentModelPredictorScore(0, { iBin0 }, iClass),
+            testSingle.GetCurrentModelPredictorScore(0, { iBin0 }, iClass));
+      }
+   }
+}
+
+TEST_CASE("residual initialization over many blocks matches a single block, boosting, regression") {
+   TestApi testSingle = TestApi(k_learningTypeRegression);
+   TestApi testCopies = TestApi(k_learningTypeRegression);
+   for(TestApi * const pTest : { &testSingle, &testCopies }) {
+      const size_t cCopies = &testSingle == pTest ? size_t { 1 } : k_cCopiesInitializeResiduals;
+      pTest->AddFeatures({ FeatureTest(5) });
+      pTest->AddFeatureGroups({ { 0 } });
+      std::vector<RegressionSample> trainingSamples;
+      for(size_t iSample = 0; iSample < k_cSamplesParallel * cCopies; ++iSample) {
+         const size_t iOriginal = iSample % k_cSamplesParallel;
+         const IntEbmType bin0 = static_cast<IntEbmType>(iOriginal % 5);
+         const FloatEbmType target = static_cast<FloatEbmType>(bin0 * 3) + static_cast<FloatEbmType>(iOriginal % 13) / 10;
+         trainingSamples.push_back(RegressionSample(target, { bin0 }, static_cast<FloatEbmType>(iOriginal % 7)));
+      }
+      pTest->AddTrainingSamples(trainingSamples);
+      pTest->AddValidationSamples({ RegressionSample(3, { 1 }), RegressionSample(8, { 4 }) });
+      pTest->InitializeBoosting(0);
+   }
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      CHECK_APPROX(testCopies.Boost(0), testSingle.Boost(0));
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      CHECK_APPROX(testCopies.GetCurrentModelPredictorScore(0, { iBin0 }, 0), testSingle.GetCurrentModelPredictorScore(0, { iBin0 }, 0));
+   }
+}
+
+TEST_CASE("more shards than packed data units, boosting, regression") {
+   TestApi testSerial = TestApi(k_learningTypeRegression);
+   testSerial.AddFeatures({ FeatureTest(2) });
+   testSerial.AddFeatureGroups({ { 0 } });
+   testSerial.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }), RegressionSample(30, { 1 }) });
+   testSerial.AddValidationSamples({ RegressionSample(12, { 0 }), RegressionSample(19, { 1 }) });
+   testSerial.InitializeBoosting();
+
+   TestApi testSharded = TestApi(k_learningTypeRegression);
+   testSharded.AddFeatures({ FeatureTest(2) });
+   testSharded.AddFeatureGroups({ { 0 } });
+   testSharded.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }), RegressionSample(30, { 1 }) });
+   testSharded.AddValidationSamples({ RegressionSample(12, { 0 }), RegressionSample(19, { 1 }) });
+   testSharded.InitializeBoosting(k_countInnerBagsDefault, MakeTempParamsShards(100000));
+
+   for(int iEpoch = 0; iEpoch < 100; ++iEpoch) {
+      // all 3 samples fit inside a single packed data unit, so we can only use 1 shard and the results are exact
+      CHECK(testSerial.Boost(0) == testSharded.Boost(0));
+   }
+}
+
+TEST_CASE("invalid shard counts are ignored, boosting, regression") {
+   const std::vector<FloatEbmType> invalidParams[] = {
+      MakeTempParamsShards(0),
+      MakeTempParamsShards(-3),
+      MakeTempParamsShards(std::numeric_limits<FloatEbmType>::quiet_NaN()),
+      // a count of zero means that there are no parameters, so the shard count is never read
+      std::vector<FloatEbmType> { 0, 4 }
+   };
+   for(const std::vector<FloatEbmType> & optionalTempParams : invalidParams) {
+      TestApi testSerial = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testSerial, k_countInnerBagsDefault, {});
+      TestApi testInvalid = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testInvalid, k_countInnerBagsDefault, optionalTempParams);
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testSerial.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(testSerial.Boost(iFeatureGroup) == testInvalid.Boost(iFeatureGroup));
+         }
+      }
+   }
+}
+
+TEST_CASE("parallel inner bags are repeatable, boosting, regression") {
+   TestApi test0 = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test0, 8, {});
+   TestApi test1 = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test1, 8, {});
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test0.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetric0 = test0.Boost(iFeatureGroup);
+         const FloatEbmType validationMetric1 = test1.Boost(iFeatureGroup);
+         CHECK(validationMetric0 == validationMetric1);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(test0.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0) ==
+            test1.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0));
+      }
+   }
+}
+
+TEST_CASE("parallel inner bags with sharding are repeatable, boosting, multiclass") {
+   TestApi test0 = TestApi(3);
+   InitializeMulticlassParallel(test0, 5, MakeTempParamsShards(3));
+   TestApi test1 = TestApi(3);
+   InitializeMulticlassParallel(test1, 5, MakeTempParamsShards(3));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test0.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetric0 = test0.Boost(iFeatureGroup);
+         const FloatEbmType validationMetric1 = test1.Boost(iFeatureGroup);
+         CHECK(validationMetric0 == validationMetric1);
+      }
+   }
+   for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK(test0.GetCurrentModelPredictorScore(2, { iBin1 }, iClass) == test1.GetCurrentModelPredictorScore(2, { iBin1 }, iClass));
+      }
+   }
+}
+
+TEST_CASE("sampling without replacement of all samples matches no bagging, boosting, regression") {
+   TestApi testFlat = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testFlat, k_countInnerBagsDefault, {});
+   TestApi testBits = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testBits, 1, MakeTempParamsWithoutReplacement(1, 1));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testFlat.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetricFlat = testFlat.Boost(iFeatureGroup);
+         const FloatEbmType validationMetricBits = testBits.Boost(iFeatureGroup);
+         CHECK_APPROX(validationMetricBits, validationMetricFlat);
+      }
+   }
+}
+
+TEST_CASE("sampling without replacement sharded matches unsharded, boosting, multiclass") {
+   // 1000 samples split 3 ways don't begin on the boundaries of our inclusion bit units
+   TestApi testSerial = TestApi(3);
+   InitializeMulticlassParallel(testSerial, 3, MakeTempParamsWithoutReplacement(1, FloatEbmType { 0.5 }));
+   TestApi testSharded = TestApi(3);
+   InitializeMulticlassParallel(testSharded, 3, MakeTempParamsWithoutReplacement(3, FloatEbmType { 0.5 }));
+
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSerial.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetricSerial = testSerial.Boost(iFeatureGroup);
+         const FloatEbmType validationMetricSharded = testSharded.Boost(iFeatureGroup);
+         CHECK_APPROX(validationMetricSharded, validationMetricSerial);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK_APPROX(testSharded.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1),
+            testSerial.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1));
+      }
+   }
+}
+
+TEST_CASE("sampling without replacement differs from sampling with replacement, boosting, regression") {
+   TestApi testWith = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testWith, 4, {});
+   TestApi testWithout = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testWithout, 4, MakeTempParamsWithoutReplacement(1, FloatEbmType { 0.3 }));
+
+   bool bDifferent = false;
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testWith.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         bDifferent |= testWith.Boost(iFeatureGroup) != testWithout.Boost(iFeatureGroup);
+      }
+   }
+   CHECK(bDifferent);
+}
+
+TEST_CASE("invalid sampling without replacement fractions are ignored, boosting, regression") {
+   const FloatEbmType invalidFractions[] = {
+      FloatEbmType { -0.5 },
+      FloatEbmType { 1.5 },
+      std::numeric_limits<FloatEbmType>::quiet_NaN()
+   };
+   for(const FloatEbmType fraction : invalidFractions) {
+      TestApi testWith = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testWith, 3, {});
+      TestApi testInvalid = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testInvalid, 3, MakeTempParamsWithoutReplacement(1, fraction));
+      for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testWith.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(testWith.Boost(iFeatureGroup) == testInvalid.Boost(iFeatureGroup));
+         }
+      }
+   }
+}
+
+TEST_CASE("cached denominators match recomputed denominators, boosting, multiclass") {
+   // the cached values are computed by the same function, so the results need to be identical
+   const std::vector<FloatEbmType> cachedParams[] = {
+      MakeTempParams({ { TempParamBoostingCacheDenominators, 1 } }),
+      MakeTempParams({ { TempParamBoostingCountShards, 3 }, { TempParamBoostingCacheDenominators, 1 } }),
+      MakeTempParams({ { TempParamBoostingFractionWithoutReplacement, 0.5 }, { TempParamBoostingCacheDenominators, 1 } })
+   };
+   for(const std::vector<FloatEbmType> & optionalTempParams : cachedParams) {
+      std::vector<FloatEbmType> recomputeParams = optionalTempParams;
+      recomputeParams[3] = 0;
+
+      TestApi testRecompute = TestApi(3);
+      InitializeMulticlassParallel(testRecompute, 2, recomputeParams);
+      TestApi testCached = TestApi(3);
+      InitializeMulticlassParallel(testCached, 2, optionalTempParams);
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testRecompute.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(testRecompute.Boost(iFeatureGroup) == testCached.Boost(iFeatureGroup));
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK(testRecompute.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 2) ==
+               testCached.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 2));
+         }
+      }
+   }
+}
+
+TEST_CASE("cached denominators are ignored for regression, boosting, regression") {
+   TestApi testRecompute = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testRecompute, 2, {});
+   TestApi testCached = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testCached, 2, MakeTempParams({ { TempParamBoostingCacheDenominators, 1 } }));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testRecompute.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testRecompute.Boost(iFeatureGroup) == testCached.Boost(iFeatureGroup));
+      }
+   }
+}
+
+TEST_CASE("SIMD model updates match scalar, boosting, binary") {
+   // SIMD won't be used if the CPU doesn't support it, in which case this compares the scalar code against itself
+   for(const FloatEbmType simd : { FloatEbmType { 1 }, FloatEbmType { 2 } }) {
+      TestApi testScalar = TestApi(2);
+      InitializeBinaryParallel(testScalar, 2, {});
+      TestApi testSimd = TestApi(2);
+      InitializeBinaryParallel(testSimd, 2, MakeTempParamsSimd(simd));
+      for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testScalar.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            const FloatEbmType validationMetricScalar = testScalar.Boost(iFeatureGroup);
+            const FloatEbmType validationMetricSimd = testSimd.Boost(iFeatureGroup);
+            CHECK_APPROX(validationMetricSimd, validationMetricScalar);
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK_APPROX(testSimd.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1),
+               testScalar.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1));
+         }
+      }
+   }
+}
+
+TEST_CASE("SIMD instruction sets produce identical models, boosting, binary") {
+   // every instruction set computes identical per-sample residuals, so only the validation sums can differ
+   TestApi testAvx2 = TestApi(2);
+   InitializeBinaryParallel(testAvx2, 2, MakeTempParamsSimd(1));
+   TestApi testAvx512 = TestApi(2);
+   InitializeBinaryParallel(testAvx512, 2, MakeTempParamsSimd(2));
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testAvx2.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK_APPROX(testAvx512.Boost(iFeatureGroup), testAvx2.Boost(iFeatureGroup));
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(testAvx512.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1) ==
+            testAvx2.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1));
+      }
+   }
+}
+
+TEST_CASE("SIMD model updates match scalar, boosting, regression") {
+   for(const FloatEbmType simd : { FloatEbmType { 1 }, FloatEbmType { 2 } }) {
+      TestApi testScalar = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testScalar, 2, {});
+      TestApi testSimd = TestApi(k_learningTypeRegression);
+      InitializeRegressionParallel(testSimd, 2, MakeTempParamsSimd(simd));
+      for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testScalar.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            const FloatEbmType validationMetricScalar = testScalar.Boost(iFeatureGroup);
+            const FloatEbmType validationMetricSimd = testSimd.Boost(iFeatureGroup);
+            CHECK_APPROX(validationMetricSimd, validationMetricScalar);
+         }
+      }
+      // subtraction is exact, so the residuals and therefore the models are identical
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK(testSimd.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0) ==
+               testScalar.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0));
+         }
+      }
+   }
+}
+
+TEST_CASE("SIMD sweep scores match scalar, boosting, regression") {
+   // the node splitting scores are exact per lane, so the splits and therefore the models are identical.  The bin 
+   // counts leave partial vectors at the end of the sweep, and the targets repeat so that some cuts tie
+   for(const size_t cBins : { size_t { 17 }, size_t { 61 }, size_t { 130 } }) {
+      std::vector<RegressionSample> trainingSamples;
+      for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+         const IntEbmType bin = static_cast<IntEbmType>(iSample * 7 % cBins);
+         const FloatEbmType target = static_cast<FloatEbmType>(bin % 9) - static_cast<FloatEbmType>(iSample % 5) / 4;
+         trainingSamples.push_back(RegressionSample(target, { bin }));
+      }
+      for(const FloatEbmType simd : { FloatEbmType { 1 }, FloatEbmType { 2 } }) {
+         TestApi testScalar = TestApi(k_learningTypeRegression);
+         testScalar.AddFeatures({ FeatureTest(static_cast<IntEbmType>(cBins)) });
+         testScalar.AddFeatureGroups({ { 0 } });
+         testScalar.AddTrainingSamples(trainingSamples);
+         testScalar.AddValidationSamples({ RegressionSample(3, { 1 }), RegressionSample(8, { 4 }) });
+         testScalar.InitializeBoosting(2, {});
+
+         TestApi testSimd = TestApi(k_learningTypeRegression);
+         testSimd.AddFeatures({ FeatureTest(static_cast<IntEbmType>(cBins)) });
+         testSimd.AddFeatureGroups({ { 0 } });
+         testSimd.AddTrainingSamples(trainingSamples);
+         testSimd.AddValidationSamples({ RegressionSample(3, { 1 }), RegressionSample(8, { 4 }) });
+         testSimd.InitializeBoosting(2, MakeTempParamsSimd(simd));
+
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            const FloatEbmType validationMetricScalar = testScalar.Boost(0);
+            CHECK_APPROX(testSimd.Boost(0), validationMetricScalar);
+         }
+         for(size_t iBin = 0; iBin < cBins; ++iBin) {
+            CHECK(testSimd.GetCurrentModelPredictorScore(0, { iBin }, 0) == testScalar.GetCurrentModelPredictorScore(0, { iBin }, 0));
+         }
+      }
+   }
+}
+
+TEST_CASE("SIMD unpacking matches scalar for every bit packing, boosting, regression") {
+   // the bin counts give 1 to 64 items per data unit, and the sample counts end on, just before and just after data 
+   // unit and vector boundaries.  Regression residuals are exact, so any misdecoded tensor index changes the model
+   for(const IntEbmType cBins : { IntEbmType { 2 }, IntEbmType { 3 }, IntEbmType { 5 }, IntEbmType { 9 }, IntEbmType { 300 } }) {
+      for(const size_t cSamples : { size_t { 1 }, size_t { 7 }, size_t { 63 }, size_t { 64 }, size_t { 65 }, size_t { 1029 } }) {
+         for(const FloatEbmType simd : { FloatEbmType { 1 }, FloatEbmType { 2 } }) {
+            std::vector<RegressionSample> trainingSamples;
+            for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+               const IntEbmType bin0 = static_cast<IntEbmType>(iSample * 7 % static_cast<size_t>(cBins));
+               const IntEbmType bin1 = static_cast<IntEbmType>(iSample % 3);
+               trainingSamples.push_back(RegressionSample(static_cast<FloatEbmType>(bin0 - bin1 * 5), { bin0, bin1 }));
+            }
+            const std::vector<RegressionSample> validationSamples(trainingSamples.begin(), 
+               trainingSamples.begin() + (cSamples < size_t { 13 } ? cSamples : size_t { 13 }));
+
+            TestApi testScalar = TestApi(k_learningTypeRegression);
+            testScalar.AddFeatures({ FeatureTest(cBins), FeatureTest(3) });
+            testScalar.AddFeatureGroups({ { 0 }, { 0, 1 } });
+            testScalar.AddTrainingSamples(trainingSamples);
+            testScalar.AddValidationSamples(validationSamples);
+            testScalar.InitializeBoosting(0, {});
+
+            TestApi testSimd = TestApi(k_learningTypeRegression);
+            testSimd.AddFeatures({ FeatureTest(cBins), FeatureTest(3) });
+            testSimd.AddFeatureGroups({ { 0 }, { 0, 1 } });
+            testSimd.AddTrainingSamples(trainingSamples);
+            testSimd.AddValidationSamples(validationSamples);
+            testSimd.InitializeBoosting(0, MakeTempParamsSimd(simd));
+
+            for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+               for(size_t iFeatureGroup = 0; iFeatureGroup < testScalar.GetFeatureGroupsCount(); ++iFeatureGroup) {
+                  const FloatEbmType validationMetricScalar = testScalar.Boost(iFeatureGroup);
+                  CHECK_APPROX(testSimd.Boost(iFeatureGroup), validationMetricScalar);
+               }
+            }
+            for(size_t iBin = 0; iBin < static_cast<size_t>(cBins); ++iBin) {
+               CHECK(testSimd.GetCurrentModelPredictorScore(1, { iBin, 2 }, 0) ==
+                  testScalar.GetCurrentModelPredictorScore(1, { iBin, 2 }, 0));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("SIMD is ignored for multiclass and invalid values, boosting, multiclass") {
+   const std::vector<FloatEbmType> ignoredParams[] = {
+      MakeTempParamsSimd(2),
+      MakeTempParamsSimd(-1),
+      MakeTempParamsSimd(std::numeric_limits<FloatEbmType>::quiet_NaN())
+   };
+   for(const std::vector<FloatEbmType> & optionalTempParams : ignoredParams) {
+      TestApi testScalar = TestApi(3);
+      InitializeMulticlassParallel(testScalar, 2, {});
+      TestApi testIgnored = TestApi(3);
+      InitializeMulticlassParallel(testIgnored, 2, optionalTempParams);
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testScalar.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(testScalar.Boost(iFeatureGroup) == testIgnored.Boost(iFeatureGroup));
+         }
+      }
+   }
+}
+
+static std::vector<FloatEbmType> MakeTempParamsSinglePrecision(const FloatEbmType cacheDenominators, const FloatEbmType simd) {
+   return MakeTempParams({ 
+      { TempParamBoostingCacheDenominators, cacheDenominators }, 
+      { TempParamBoostingSimd, simd }, 
+      { TempParamBoostingSinglePrecision, 1 } 
+   });
+}
+
+// float storage rounds every residual and score, so we only expect the models to agree to about float precision
+static constexpr double k_toleranceSinglePrecision = 1e-4;
+
+TEST_CASE("single precision storage matches double precision, boosting, regression") {
+   TestApi testDouble = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testDouble, 2, {});
+   TestApi testSingle = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSingle, 2, MakeTempParamsSinglePrecision(0, 0));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testDouble.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(std::abs(testSingle.Boost(iFeatureGroup) - testDouble.Boost(iFeatureGroup)) < k_toleranceSinglePrecision);
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(std::abs(testSingle.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0) -
+            testDouble.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0)) < k_toleranceSinglePrecision);
+      }
+   }
+}
+
+TEST_CASE("single precision storage matches double precision, boosting, binary") {
+   // SIMD widens each block of float storage, so check it along with the scalar code
+   for(const FloatEbmType simd : { FloatEbmType { 0 }, FloatEbmType { 2 } }) {
+      TestApi testDouble = TestApi(2);
+      InitializeBinaryParallel(testDouble, 2, MakeTempParamsSimd(simd));
+      TestApi testSingle = TestApi(2);
+      InitializeBinaryParallel(testSingle, 2, MakeTempParamsSinglePrecision(0, simd));
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testDouble.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(std::abs(testSingle.Boost(iFeatureGroup) - testDouble.Boost(iFeatureGroup)) < k_toleranceSinglePrecision);
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            CHECK(std::abs(testSingle.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1) -
+               testDouble.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 1)) < k_toleranceSinglePrecision);
+         }
+      }
+   }
+}
+
+TEST_CASE("single precision storage matches double precision, boosting, multiclass") {
+   for(const FloatEbmType cacheDenominators : { FloatEbmType { 0 }, FloatEbmType { 1 } }) {
+      TestApi testDouble = TestApi(3);
+      InitializeMulticlassParallel(testDouble, 2, MakeTempParams({ { TempParamBoostingCacheDenominators, cacheDenominators } }));
+      TestApi testSingle = TestApi(3);
+      InitializeMulticlassParallel(testSingle, 2, MakeTempParamsSinglePrecision(cacheDenominators, 0));
+      for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+         for(size_t iFeatureGroup = 0; iFeatureGroup < testDouble.GetFeatureGroupsCount(); ++iFeatureGroup) {
+            CHECK(std::abs(testSingle.Boost(iFeatureGroup) - testDouble.Boost(iFeatureGroup)) < k_toleranceSinglePrecision);
+         }
+      }
+      for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+            for(size_t iClass = 0; iClass < 3; ++iClass) {
+               CHECK(std::abs(testSingle.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) -
+                  testDouble.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass)) < k_toleranceSinglePrecision);
+            }
+         }
+      }
+   }
+}
+
+static void InitializeManyClassesParallel(
+   TestApi & test,
+   const IntEbmType countClasses,
+   const IntEbmType shiftClasses,
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   test.AddFeatures({ FeatureTest(5), FeatureTest(4) });
+   test.AddFeatureGroups({ { 0 }, { 0, 1 } });
+   std::vector<ClassificationSample> trainingSamples;
+   for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+      const IntEbmType target = (bin0 * 3 + bin1 + static_cast<IntEbmType>(iSample % 11 / 9) + shiftClasses) % countClasses;
+      trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   test.AddValidationSamples({ 
+      ClassificationSample(shiftClasses % countClasses, { 1, 2 }), 
+      ClassificationSample((countClasses - 1 + shiftClasses) % countClasses, { 4, 3 }) 
+   });
+   test.InitializeBoosting(0, optionalTempParams);
+}
+
+TEST_CASE("class counts beyond the compile time specializations are symmetric in the classes, boosting, multiclass") {
+   // above the compile time class counts the vector is walked in tiles plus a remainder.  Shifting the class labels
+   // moves each class between the tiles and the remainder, but the model needs to stay the same up to the shift
+   for(const IntEbmType countClasses : { IntEbmType { 11 }, IntEbmType { 12 }, IntEbmType { 13 } }) {
+      for(const std::vector<FloatEbmType> & optionalTempParams : 
+         { std::vector<FloatEbmType> {}, MakeTempParams({ { TempParamBoostingCountShards, 3 }, { TempParamBoostingCacheDenominators, 1 } }) }) 
+      {
+         constexpr IntEbmType k_shiftClasses = 5;
+         TestApi test = TestApi(countClasses);
+         InitializeManyClassesParallel(test, countClasses, 0, optionalTempParams);
+         TestApi testShifted = TestApi(countClasses);
+         InitializeManyClassesParallel(testShifted, countClasses, k_shiftClasses, optionalTempParams);
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+               const FloatEbmType validationMetric = test.Boost(iFeatureGroup);
+               CHECK(!std::isnan(validationMetric));
+               CHECK_APPROX(testShifted.Boost(iFeatureGroup), validationMetric);
+            }
+         }
+         for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+            for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+               for(size_t iClass = 0; iClass < static_cast<size_t>(countClasses); ++iClass) {
+                  const size_t iClassShifted = (iClass + static_cast<size_t>(k_shiftClasses)) % static_cast<size_t>(countClasses);
+                  CHECK_APPROX(testShifted.GetCurrentModelPredictorScore(1, { iBin0, iBin1 }, iClassShifted),
+                     test.GetCurrentModelPredictorScore(1, { iBin0, iBin1 }, iClass));
+               }
+            }
+         }
+      }
+   }
+}
+
+static std::vector<FloatEbmType> MakeTempParamsClassMajor(
+   const FloatEbmType countShards, 
+   const FloatEbmType cacheDenominators, 
+   const FloatEbmType singlePrecision, 
+   const FloatEbmType classMajor
+) {
+   return MakeTempParams({ 
+      { TempParamBoostingCountShards, countShards }, 
+      { TempParamBoostingCacheDenominators, cacheDenominators }, 
+      { TempParamBoostingSinglePrecision, singlePrecision }, 
+      { TempParamBoostingClassMajor, classMajor } 
+   });
+}
+
+TEST_CASE("class-major residuals match sample-major residuals, boosting, multiclass") {
+   // the class-major layout only changes the order that we visit the values in, so the results need to be identical.
+   // 1000 samples span several update blocks and end in a partial block
+   for(const FloatEbmType countShards : { FloatEbmType { 1 }, FloatEbmType { 3 } }) {
+      for(const FloatEbmType cacheDenominators : { FloatEbmType { 0 }, FloatEbmType { 1 } }) {
+         for(const FloatEbmType singlePrecision : { FloatEbmType { 0 }, FloatEbmType { 1 } }) {
+            TestApi testSampleMajor = TestApi(3);
+            InitializeMulticlassParallel(testSampleMajor, 2, MakeTempParamsClassMajor(countShards, cacheDenominators, singlePrecision, 0));
+            TestApi testClassMajor = TestApi(3);
+            InitializeMulticlassParallel(testClassMajor, 2, MakeTempParamsClassMajor(countShards, cacheDenominators, singlePrecision, 1));
+            for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+               for(size_t iFeatureGroup = 0; iFeatureGroup < testSampleMajor.GetFeatureGroupsCount(); ++iFeatureGroup) {
+                  CHECK(testSampleMajor.Boost(iFeatureGroup) == testClassMajor.Boost(iFeatureGroup));
+               }
+            }
+            for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+               for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+                  for(size_t iClass = 0; iClass < 3; ++iClass) {
+                     CHECK(testSampleMajor.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+                        testClassMajor.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+                  }
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("class-major residuals match sample-major residuals beyond the compile time class counts, boosting, multiclass") {
+   constexpr IntEbmType k_countClasses = 11;
+   TestApi testSampleMajor = TestApi(k_countClasses);
+   InitializeManyClassesParallel(testSampleMajor, k_countClasses, 0, MakeTempParamsClassMajor(1, 1, 0, 0));
+   TestApi testClassMajor = TestApi(k_countClasses);
+   InitializeManyClassesParallel(testClassMajor, k_countClasses, 0, MakeTempParamsClassMajor(1, 1, 0, 1));
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSampleMajor.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testSampleMajor.Boost(iFeatureGroup) == testClassMajor.Boost(iFeatureGroup));
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         for(size_t iClass = 0; iClass < static_cast<size_t>(k_countClasses); ++iClass) {
+            CHECK(testSampleMajor.GetCurrentModelPredictorScore(1, { iBin0, iBin1 }, iClass) ==
+               testClassMajor.GetCurrentModelPredictorScore(1, { iBin0, iBin1 }, iClass));
+         }
+      }
+   }
+}
+
+static std::vector<FloatEbmType> MakeTempParamsSampleIndex(
+   const FloatEbmType countShards, 
+   const FloatEbmType fraction, 
+   const FloatEbmType cacheDenominators, 
+   const FloatEbmType classMajor, 
+   const FloatEbmType sampleIndexBinsMax
+) {
+   return MakeTempParams({ 
+      { TempParamBoostingCountShards, countShards }, 
+      { TempParamBoostingFractionWithoutReplacement, fraction }, 
+      { TempParamBoostingCacheDenominators, cacheDenominators }, 
+      { TempParamBoostingClassMajor, classMajor }, 
+      { TempParamBoostingSampleIndexBinsMax, sampleIndexBinsMax } 
+   });
+}
+
+static void CheckSampleIndexMatchesScan(
+   TestCaseHidden & testCaseHidden, 
+   const ptrdiff_t learningTypeOrCountTargetClasses, 
+   const FloatEbmType cacheDenominators, 
+   const FloatEbmType classMajor
+) {
+   // 4 indexes only the feature with 4 bins and 5 indexes both, so each pair feature group is still scanned
+   for(const FloatEbmType sampleIndexBinsMax : { FloatEbmType { 4 }, FloatEbmType { 5 } }) {
+      for(const FloatEbmType countShards : { FloatEbmType { 1 }, FloatEbmType { 3 } }) {
+         for(const FloatEbmType fraction : { FloatEbmType { 0 }, FloatEbmType { 0.5 } }) {
+            TestApi testScan = TestApi(learningTypeOrCountTargetClasses);
+            TestApi testIndex = TestApi(learningTypeOrCountTargetClasses);
+            const std::vector<FloatEbmType> tempParamsScan = 
+               MakeTempParamsSampleIndex(countShards, fraction, cacheDenominators, classMajor, 0);
+            const std::vector<FloatEbmType> tempParamsIndex = 
+               MakeTempParamsSampleIndex(countShards, fraction, cacheDenominators, classMajor, sampleIndexBinsMax);
+            if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+               InitializeRegressionParallel(testScan, 2, tempParamsScan);
+               InitializeRegressionParallel(testIndex, 2, tempParamsIndex);
+            } else if(2 == learningTypeOrCountTargetClasses) {
+               InitializeBinaryParallel(testScan, 2, tempParamsScan);
+               InitializeBinaryParallel(testIndex, 2, tempParamsIndex);
+            } else {
+               InitializeMulticlassParallel(testScan, 2, tempParamsScan);
+               InitializeMulticlassParallel(testIndex, 2, tempParamsIndex);
+            }
+            for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+               for(size_t iFeatureGroup = 0; iFeatureGroup < testScan.GetFeatureGroupsCount(); ++iFeatureGroup) {
+                  CHECK(testScan.Boost(iFeatureGroup) == testIndex.Boost(iFeatureGroup));
+               }
+            }
+            const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+            for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+               // binary classification keeps its single logit in class 1
+               const size_t iClass = 2 == learningTypeOrCountTargetClasses ? size_t { 1 } : iVector;
+               for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+                  CHECK(testScan.GetCurrentModelPredictorScore(1, { iBin0 }, iClass) == 
+                     testIndex.GetCurrentModelPredictorScore(1, { iBin0 }, iClass));
+                  for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+                     CHECK(testScan.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+                        testIndex.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+                  }
+               }
+               for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+                  CHECK(testScan.GetCurrentModelPredictorScore(2, { iBin1 }, iClass) ==
+                     testIndex.GetCurrentModelPredictorScore(2, { iBin1 }, iClass));
+               }
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("sample index matches scanning the packed data, boosting, regression") {
+   CheckSampleIndexMatchesScan(testCaseHidden, k_learningTypeRegression, 0, 0);
+}
+
+TEST_CASE("sample index matches scanning the packed data, boosting, binary") {
+   CheckSampleIndexMatchesScan(testCaseHidden, 2, 0, 0);
+   CheckSampleIndexMatchesScan(testCaseHidden, 2, 1, 0);
+}
+
+TEST_CASE("sample index matches scanning the packed data, boosting, multiclass") {
+   CheckSampleIndexMatchesScan(testCaseHidden, 3, 0, 0);
+   CheckSampleIndexMatchesScan(testCaseHidden, 3, 1, 1);
+}
+
+class HistogramReduceTest final {
+public:
+   IntEbmType m_cCalls;
+   bool m_bPoisonCount;
+};
+
+// pretends that a second node holds an exact copy of our samples.  Doubling is exact in floating point, so the 
+// updates need to be identical to boosting our samples alone
+static IntEbmType EBM_NATIVE_CALLING_CONVENTION DoublingHistogramReduce(
+   IntEbmType countValues, 
+   FloatEbmType * values, 
+   void * reduceContext
+) {
+   HistogramReduceTest * const pHistogramReduceTest = static_cast<HistogramReduceTest *>(reduceContext);
+   ++pHistogramReduceTest->m_cCalls;
+   for(IntEbmType iValue = 0; iValue < countValues; ++iValue) {
+      values[iValue] *= 2;
+   }
+   if(pHistogramReduceTest->m_bPoisonCount) {
+      // the first value is the count of the first bucket, which needs to be a whole number
+      values[0] += FloatEbmType { 0.5 };
+   }
+   return 0;
+}
+
+TEST_CASE("histogram reduce over identical shards matches a single node, boosting, regression") {
+   HistogramReduceTest histogramReduceTest;
+   histogramReduceTest.m_cCalls = 0;
+   histogramReduceTest.m_bPoisonCount = false;
+
+   TestApi testSingle = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSingle, 2, MakeTempParamsShards(1));
+   TestApi testReduced = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testReduced, 2, MakeTempParamsShards(1));
+   CHECK(0 == SetBoostingHistogramReduce(testReduced.GetBoosting(), DoublingHistogramReduce, &histogramReduceTest));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSingle.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testSingle.Boost(iFeatureGroup) == testReduced.Boost(iFeatureGroup));
+      }
+   }
+   // one reduction per inner bag per step
+   CHECK(2 * 10 * static_cast<IntEbmType>(testSingle.GetFeatureGroupsCount()) == histogramReduceTest.m_cCalls);
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         CHECK(testSingle.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0) ==
+            testReduced.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, 0));
+      }
+   }
+}
+
+TEST_CASE("histogram reduce over identical shards matches a single node, boosting, multiclass") {
+   HistogramReduceTest histogramReduceTest;
+   histogramReduceTest.m_cCalls = 0;
+   histogramReduceTest.m_bPoisonCount = false;
+
+   TestApi testSingle = TestApi(3);
+   InitializeMulticlassParallel(testSingle, 2, MakeTempParamsShards(1));
+   TestApi testReduced = TestApi(3);
+   InitializeMulticlassParallel(testReduced, 2, MakeTempParamsShards(1));
+   CHECK(0 == SetBoostingHistogramReduce(testReduced.GetBoosting(), DoublingHistogramReduce, &histogramReduceTest));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSingle.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testSingle.Boost(iFeatureGroup) == testReduced.Boost(iFeatureGroup));
+      }
+   }
+   for(size_t iBin0 = 0; iBin0 < 5; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 4; ++iBin1) {
+         for(size_t iClass = 0; iClass < 3; ++iClass) {
+            CHECK(testSingle.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass) ==
+               testReduced.GetCurrentModelPredictorScore(3, { iBin0, iBin1 }, iClass));
+         }
+      }
+   }
+}
+
+TEST_CASE("histogram reduce that returns a fractional count fails the step, boosting, regression") {
+   HistogramReduceTest histogramReduceTest;
+   histogramReduceTest.m_cCalls = 0;
+   histogramReduceTest.m_bPoisonCount = true;
+
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test, 0, MakeTempParamsShards(1));
+   CHECK(0 == SetBoostingHistogramReduce(test.GetBoosting(), DoublingHistogramReduce, &histogramReduceTest));
+   FloatEbmType validationMetric = FloatEbmType { 0 };
+   CHECK(0 != BoostingStep(test.GetBoosting(), 1, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+      k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &validationMetric));
+   CHECK(1 == histogramReduceTest.m_cCalls);
+}
+
+static std::vector<FloatEbmType> MakeTempParamsSlots(const FloatEbmType countSlots) {
+   return MakeTempParams({ { TempParamBoostingConcurrentSlots, countSlots } });
+}
+
+// copies the update out of the slot, since the slot reuses it's tensor on the next call.  Returns false on error, 
+// which leaves updateOut zeroed so that applying it is harmless
+static bool GenerateSlotUpdate(
+   const TestApi & test, 
+   const IntEbmType indexSlot, 
+   const IntEbmType indexFeatureGroup, 
+   std::vector<FloatEbmType> & updateOut
+) {
+   FloatEbmType gain = FloatEbmType { 0 };
+   const FloatEbmType * const aUpdate = GenerateModelFeatureGroupUpdateSlot(test.GetBoosting(), indexSlot, indexFeatureGroup, 
+      k_learningRateDefault, k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &gain);
+   if(nullptr == aUpdate) {
+      std::fill(updateOut.begin(), updateOut.end(), FloatEbmType { 0 });
+      return false;
+   }
+   std::copy(aUpdate, aUpdate + updateOut.size(), updateOut.begin());
+   return true;
+}
+
+TEST_CASE("slot 0 matches a booster with 1 slot, boosting, regression") {
+   TestApi testSingle = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSingle, 2, {});
+   TestApi testSlots = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testSlots, 2, MakeTempParamsSlots(3));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testSingle.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testSingle.Boost(iFeatureGroup) == testSlots.Boost(iFeatureGroup));
+      }
+   }
+}
+
+TEST_CASE("slot updates don't depend on the order of the slot calls, boosting, regression") {
+   // updates from different slots only read the residuals, so generating them in either order (or at the same time 
+   // on separate threads) and then applying them in a fixed order gives the same model
+   TestApi testForward = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testForward, 2, MakeTempParamsSlots(2));
+   TestApi testReverse = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(testReverse, 2, MakeTempParamsSlots(2));
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      // feature group 1 has 5 bins and feature group 2 has 4
+      std::vector<FloatEbmType> updateForward1(5);
+      std::vector<FloatEbmType> updateForward2(4);
+      CHECK(GenerateSlotUpdate(testForward, 0, 1, updateForward1));
+      CHECK(GenerateSlotUpdate(testForward, 1, 2, updateForward2));
+
+      std::vector<FloatEbmType> updateReverse1(5);
+      std::vector<FloatEbmType> updateReverse2(4);
+      CHECK(GenerateSlotUpdate(testReverse, 1, 2, updateReverse2));
+      CHECK(GenerateSlotUpdate(testReverse, 0, 1, updateReverse1));
+
+      CHECK(updateForward1 == updateReverse1);
+      CHECK(updateForward2 == updateReverse2);
+
+      FloatEbmType validationMetricForward = FloatEbmType { 0 };
+      FloatEbmType validationMetricReverse = FloatEbmType { 0 };
+      CHECK(0 == ApplyModelFeatureGroupUpdate(testForward.GetBoosting(), 2, &updateForward2[0], nullptr));
+      CHECK(0 == ApplyModelFeatureGroupUpdate(testForward.GetBoosting(), 1, &updateForward1[0], &validationMetricForward));
+      CHECK(0 == ApplyModelFeatureGroupUpdate(testReverse.GetBoosting(), 2, &updateReverse2[0], nullptr));
+      CHECK(0 == ApplyModelFeatureGroupUpdate(testReverse.GetBoosting(), 1, &updateReverse1[0], &validationMetricReverse));
+      CHECK(validationMetricForward == validationMetricReverse);
+   }
+}
+
+TEST_CASE("slot index beyond the slot count, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test, 0, MakeTempParamsSlots(2));
+   FloatEbmType gain = FloatEbmType { 1 };
+   CHECK(nullptr == GenerateModelFeatureGroupUpdateSlot(test.GetBoosting(), 2, 1, k_learningRateDefault, 
+      k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &gain));
+   CHECK(FloatEbmType { 0 } == gain);
+   CHECK(nullptr == GenerateModelFeatureGroupUpdateSlot(test.GetBoosting(), -1, 1, k_learningRateDefault, 
+      k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &gain));
+}
+
+TEST_CASE("zero slots means the default of 1 slot, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test, 0, MakeTempParamsSlots(0));
+   std::vector<FloatEbmType> update(5);
+   CHECK(GenerateSlotUpdate(test, 0, 1, update));
+   CHECK(!GenerateSlotUpdate(test, 1, 1, update));
+}
+
+TEST_CASE("temp params that are all 0 match no temp params, boosting, multiclass") {
+   // every index that we have up to the last one, set to 0
+   std::vector<FloatEbmType> zeroParams(static_cast<size_t>(TempParamBoostingScheduleReprobeRounds) + 1, FloatEbmType { 0 });
+   zeroParams[0] = static_cast<FloatEbmType>(TempParamBoostingScheduleReprobeRounds);
+
+   TestApi testDefault = TestApi(3);
+   InitializeMulticlassParallel(testDefault, 2, {});
+   TestApi testZero = TestApi(3);
+   InitializeMulticlassParallel(testZero, 2, zeroParams);
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < testDefault.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         CHECK(testDefault.Boost(iFeatureGroup) == testZero.Boost(iFeatureGroup));
+      }
+   }
+}
+
+static constexpr size_t k_cSamplesBatch = 5000;
+static const std::vector<size_t> k_cBinsBatch { 5, 300, 3, 37 };
+
+static void InitializeBatch(TestApi & test, const ptrdiff_t learningTypeOrCountTargetClasses, const std::vector<FloatEbmType> optionalTempParams) {
+   std::vector<FeatureTest> features;
+   for(const size_t cBins : k_cBinsBatch) {
+      features.push_back(FeatureTest(static_cast<IntEbmType>(cBins)));
+   }
+   test.AddFeatures(features);
+   test.AddFeatureGroups({ { 0 }, { 1 }, { 2 }, { 3 }, { 0, 2 } });
+   std::vector<RegressionSample> trainingSamplesRegression;
+   std::vector<ClassificationSample> trainingSamplesClassification;
+   for(size_t iSample = 0; iSample < k_cSamplesBatch; ++iSample) {
+      std::vector<IntEbmType> bins;
+      for(size_t iFeature = 0; iFeature < k_cBinsBatch.size(); ++iFeature) {
+         bins.push_back(static_cast<IntEbmType>((iSample * (2 * iFeature + 3) + iSample / 7) % k_cBinsBatch[iFeature]));
+      }
+      const IntEbmType signal = bins[0] + bins[1] / 50 - bins[2] * bins[0] + bins[3] / 8;
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         trainingSamplesRegression.push_back(RegressionSample(static_cast<FloatEbmType>(signal) + 
+            static_cast<FloatEbmType>(iSample % 13) / 10, bins));
+      } else {
+         const IntEbmType target = static_cast<IntEbmType>(((signal % 7 + 7) / 3 + static_cast<IntEbmType>(iSample % 11 / 9)) % 
+            learningTypeOrCountTargetClasses);
+         trainingSamplesClassification.push_back(ClassificationSample(target, bins));
+      }
+   }
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      test.AddTrainingSamples(trainingSamplesRegression);
+      test.AddValidationSamples({ RegressionSample(3, { 1, 100, 0, 20 }), RegressionSample(-1, { 4, 299, 2, 0 }) });
+   } else {
+      test.AddTrainingSamples(trainingSamplesClassification);
+      test.AddValidationSamples({ ClassificationSample(0, { 1, 100, 0, 20 }), ClassificationSample(1, { 4, 299, 2, 0 }) });
+   }
+   test.InitializeBoosting(2, optionalTempParams);
+}
+
+static void CheckBatchMatchesSlots(
+   TestCaseHidden & testCaseHidden, 
+   const ptrdiff_t learningTypeOrCountTargetClasses, 
+   const FloatEbmType countSampleIndexBinsMax
+) {
+   const std::vector<FloatEbmType> tempParams = MakeTempParams({ 
+      { TempParamBoostingConcurrentSlots, 5 }, 
+      { TempParamBoostingSampleIndexBinsMax, countSampleIndexBinsMax } 
+   });
+
+   TestApi testSlots = TestApi(learningTypeOrCountTargetClasses);
+   InitializeBatch(testSlots, learningTypeOrCountTargetClasses, tempParams);
+   TestApi testBatch = TestApi(learningTypeOrCountTargetClasses);
+   InitializeBatch(testBatch, learningTypeOrCountTargetClasses, tempParams);
+
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   // the pair in slot 2 bins separately while the main effects around it share their pass
+   const std::vector<IntEbmType> indexesFeatureGroup { 3, 0, 4, 1, 2 };
+   const std::vector<size_t> cTensorBins { k_cBinsBatch[3], k_cBinsBatch[0], k_cBinsBatch[0] * k_cBinsBatch[2], k_cBinsBatch[1], 
+      k_cBinsBatch[2] };
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      std::vector<FloatEbmType *> tensorsBatch(indexesFeatureGroup.size());
+      std::vector<FloatEbmType> gainsBatch(indexesFeatureGroup.size());
+      CHECK(0 == GenerateModelFeatureGroupUpdateSlots(testBatch.GetBoosting(), static_cast<IntEbmType>(indexesFeatureGroup.size()), 
+         &indexesFeatureGroup[0], k_learningRateDefault, k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault,
+         &tensorsBatch[0], &gainsBatch[0]));
+
+      std::vector<std::vector<FloatEbmType>> updatesSlots;
+      for(size_t iSlot = 0; iSlot < indexesFeatureGroup.size(); ++iSlot) {
+         FloatEbmType gainSlot = FloatEbmType { 0 };
+         const FloatEbmType * const aUpdateSlot = GenerateModelFeatureGroupUpdateSlot(testSlots.GetBoosting(), 
+            static_cast<IntEbmType>(iSlot), indexesFeatureGroup[iSlot], k_learningRateDefault, k_countTreeSplitsMaxDefault, 
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &gainSlot);
+         CHECK(nullptr != aUpdateSlot);
+         CHECK(nullptr != tensorsBatch[iSlot]);
+         if(nullptr == aUpdateSlot || nullptr == tensorsBatch[iSlot]) {
+            return;
+         }
+         CHECK(gainSlot == gainsBatch[iSlot]);
+         const size_t cValues = cTensorBins[iSlot] * cVectorLength;
+         updatesSlots.push_back(std::vector<FloatEbmType>(aUpdateSlot, aUpdateSlot + cValues));
+         CHECK(updatesSlots.back() == std::vector<FloatEbmType>(tensorsBatch[iSlot], tensorsBatch[iSlot] + cValues));
+      }
+
+      for(size_t iSlot = 0; iSlot < indexesFeatureGroup.size(); ++iSlot) {
+         FloatEbmType validationMetricSlots = FloatEbmType { 0 };
+         FloatEbmType validationMetricBatch = FloatEbmType { 0 };
+         CHECK(0 == ApplyModelFeatureGroupUpdate(testSlots.GetBoosting(), indexesFeatureGroup[iSlot], &updatesSlots[iSlot][0], 
+            &validationMetricSlots));
+         CHECK(0 == ApplyModelFeatureGroupUpdate(testBatch.GetBoosting(), indexesFeatureGroup[iSlot], tensorsBatch[iSlot], 
+            &validationMetricBatch));
+         CHECK(validationMetricSlots == validationMetricBatch);
+      }
+   }
+}
+
+TEST_CASE("batched main effects match separate slots, boosting, regression") {
+   CheckBatchMatchesSlots(testCaseHidden, k_learningTypeRegression, 0);
+}
+
+TEST_CASE("batched main effects match separate slots, boosting, binary") {
+   CheckBatchMatchesSlots(testCaseHidden, 2, 0);
+}
+
+TEST_CASE("batched main effects match separate slots, boosting, multiclass") {
+   // indexing the smaller features mixes indexed and packed main effects in the same batch
+   CheckBatchMatchesSlots(testCaseHidden, 3, 40);
+}
+
+TEST_CASE("batch larger than the slot count, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeRegressionParallel(test, 0, MakeTempParamsSlots(2));
+   const IntEbmType indexesFeatureGroup[] { 1, 2, 3 };
+   FloatEbmType * tensors[3];
+   CHECK(0 != GenerateModelFeatureGroupUpdateSlots(test.GetBoosting(), 3, indexesFeatureGroup, k_learningRateDefault,
+      k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, tensors, nullptr));
+   CHECK(0 == GenerateModelFeatureGroupUpdateSlots(test.GetBoosting(), 2, indexesFeatureGroup, k_learningRateDefault,
+      k_countTreeSplitsMaxDefault, k_countSamplesRequiredForChildSplitMinDefault, tensors, nullptr));
+   CHECK(nullptr != tensors[0]);
+   CHECK(nullptr != tensors[1]);
+}
+
+static std::vector<FloatEbmType> MakeTempParamsPairCutsPerTask(const FloatEbmType countPairCutsPerTask) {
+   return MakeTempParams({ { TempParamBoostingPairCutsPerTask, countPairCutsPerTask } });
+}
+
+static constexpr size_t k_cBinsPairSweep0 = 37;
+static constexpr size_t k_cBinsPairSweep1 = 23;
+
+static void InitializePairSweep(TestApi & test, const ptrdiff_t learningTypeOrCountTargetClasses, const std::vector<FloatEbmType> optionalTempParams) {
+   test.AddFeatures({ FeatureTest(k_cBinsPairSweep0), FeatureTest(k_cBinsPairSweep1) });
+   test.AddFeatureGroups({ { 0, 1 } });
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      std::vector<RegressionSample> trainingSamples;
+      for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample * 11 % k_cBinsPairSweep0);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 5 % k_cBinsPairSweep1);
+         const FloatEbmType target = static_cast<FloatEbmType>((bin0 / 9) * (bin1 / 6)) + static_cast<FloatEbmType>(iSample % 13) / 10;
+         trainingSamples.push_back(RegressionSample(target, { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(trainingSamples);
+      test.AddValidationSamples({ RegressionSample(3, { 20, 10 }), RegressionSample(-1, { 0, 3 }), RegressionSample(8, { 36, 22 }) });
+   } else {
+      std::vector<ClassificationSample> trainingSamples;
+      for(size_t iSample = 0; iSample < k_cSamplesParallel; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample * 11 % k_cBinsPairSweep0);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 5 % k_cBinsPairSweep1);
+         const IntEbmType target = static_cast<IntEbmType>((bin0 / 9 + bin1 / 6 + static_cast<IntEbmType>(iSample % 11 / 9)) % 
+            learningTypeOrCountTargetClasses);
+         trainingSamples.push_back(ClassificationSample(target, { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(trainingSamples);
+      test.AddValidationSamples({ ClassificationSample(0, { 20, 10 }), ClassificationSample(1, { 0, 3 }), ClassificationSample(1, { 36, 22 }) });
+   }
+   test.InitializeBoosting(2, optionalTempParams);
+}
+
+static void CheckPairSweepMatchesSerial(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi testSerial = TestApi(learningTypeOrCountTargetClasses);
+   // more cut combinations per task than the pair has keeps the whole sweep on the calling thread
+   InitializePairSweep(testSerial, learningTypeOrCountTargetClasses, 
+      MakeTempParamsPairCutsPerTask(static_cast<FloatEbmType>(k_cBinsPairSweep0 * k_cBinsPairSweep1)));
+   // 1 cut combination per task splits the sweep into as many tasks as there are threads
+   TestApi testParallel = TestApi(learningTypeOrCountTargetClasses);
+   InitializePairSweep(testParallel, learningTypeOrCountTargetClasses, MakeTempParamsPairCutsPerTask(1));
+   TestApi testDefault = TestApi(learningTypeOrCountTargetClasses);
+   InitializePairSweep(testDefault, learningTypeOrCountTargetClasses, {});
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      const FloatEbmType validationMetricSerial = testSerial.Boost(0);
+      CHECK(validationMetricSerial == testParallel.Boost(0));
+      CHECK(validationMetricSerial == testDefault.Boost(0));
+   }
+   const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      // binary classification keeps its single logit in class 1
+      const size_t iClass = 2 == learningTypeOrCountTargetClasses ? size_t { 1 } : iVector;
+      for(size_t iBin0 = 0; iBin0 < k_cBinsPairSweep0; ++iBin0) {
+         for(size_t iBin1 = 0; iBin1 < k_cBinsPairSweep1; ++iBin1) {
+            const FloatEbmType scoreSerial = testSerial.GetCurrentModelPredictorScore(0, { iBin0, iBin1 }, iClass);
+            CHECK(scoreSerial == testParallel.GetCurrentModelPredictorScore(0, { iBin0, iBin1 }, iClass));
+            CHECK(scoreSerial == testDefault.GetCurrentModelPredictorScore(0, { iBin0, iBin1 }, iClass));
+         }
+      }
+   }
+}
+
+TEST_CASE("parallel pair sweep matches serial, boosting, regression") {
+   CheckPairSweepMatchesSerial(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("parallel pair sweep matches serial, boosting, binary") {
+   CheckPairSweepMatchesSerial(testCaseHidden, 2);
+}
+
+TEST_CASE("parallel pair sweep matches serial, boosting, multiclass") {
+   CheckPairSweepMatchesSerial(testCaseHidden, 3);
+}
+
+// the validation samples all have target 0 and a logit of score, so their log loss is log(1 + exp(score)), which
+// is score itself to within rounding until exp(score) overflows just above 709.78, after which the metric is
+// reported as the worst possible one
+static FloatEbmType GetLogLossNearExpOverflow(const FloatEbmType score, const std::vector<FloatEbmType> optionalTempParams) {
+   TestApi test = TestApi(2);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddFeatureGroups({ { 0 } });
+   test.AddTrainingSamples({ ClassificationSample(0, { 0 }), ClassificationSample(1, { 1 }) });
+   std::vector<ClassificationSample> validationSamples;
+   // more samples than the widest SIMD vector so that full vectors see the score
+   for(size_t iSample = 0; iSample < 19; ++iSample) {
+      validationSamples.push_back(ClassificationSample(0, { static_cast<IntEbmType>(iSample % 2) }, { 0, score }));
+   }
+   test.AddValidationSamples(validationSamples);
+   test.InitializeBoosting(0, optionalTempParams);
+   return test.Boost(0, {}, {}, FloatEbmType { 0 });
+}
+
+static void CheckLogLossNearExpOverflow(TestCaseHidden & testCaseHidden, const std::vector<FloatEbmType> optionalTempParams) {
+   for(const FloatEbmType score : { FloatEbmType { 709.0 }, FloatEbmType { 709.5 }, FloatEbmType { 709.78 } }) {
+      const FloatEbmType logLoss = GetLogLossNearExpOverflow(score, optionalTempParams);
+      CHECK(!std::isinf(logLoss));
+      CHECK(IsApproxEqual(logLoss, score, FloatEbmType { 1e-12 }));
+   }
+   CHECK(std::numeric_limits<FloatEbmType>::max() == GetLogLossNearExpOverflow(FloatEbmType { 709.79 }, optionalTempParams));
+}
+
+TEST_CASE("exp is finite up to its overflow threshold, boosting, binary") {
+   CheckLogLossNearExpOverflow(testCaseHidden, {});
+}
+
+TEST_CASE("exp is finite up to its overflow threshold in every SIMD lane, boosting, binary") {
+   // SIMD won't be used if the CPU doesn't support it, in which case this checks the scalar code again
+   for(const FloatEbmType simd : { FloatEbmType { 1 }, FloatEbmType { 2 } }) {
+      CheckLogLossNearExpOverflow(testCaseHidden, MakeTempParamsSimd(simd));
+   }
+}
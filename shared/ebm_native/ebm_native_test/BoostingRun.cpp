@@ -0,0 +1,254 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingRun;
+
+static void AddRegressionData(TestApi & test) {
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2) });
+   test.AddFeatureGroups({ { 0 }, { 1 } });
+   test.AddTrainingSamples({ RegressionSample(10, { 0, 1 }), RegressionSample(20, { 1, 0 }), RegressionSample(30, { 2, 1 }),
+      RegressionSample(15, { 0, 0 }) });
+   test.AddValidationSamples({ RegressionSample(12, { 0, 1 }), RegressionSample(26, { 1, 1 }), RegressionSample(11, { 2, 0 }) });
+   test.InitializeBoosting();
+}
+
+// the cyclic boosting loop with early stopping that python ran before BoostingRun existed
+static IntEbmType ReferenceRun(
+   TestApi & test,
+   const IntEbmType countRoundsMax,
+   const IntEbmType earlyStoppingRounds,
+   const FloatEbmType earlyStoppingTolerance,
+   FloatEbmType * const pMetricMinOut
+) {
+   FloatEbmType metricMin = std::numeric_limits<FloatEbmType>::infinity();
+   FloatEbmType metricWindowStart = metricMin;
+   IntEbmType cRoundsNoChange = 0;
+   IntEbmType iRound = 0;
+   for(; iRound < countRoundsMax; ++iRound) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         metricMin = std::min(metricMin, test.Boost(static_cast<IntEbmType>(iFeatureGroup)));
+      }
+      if(0 == cRoundsNoChange) {
+         metricWindowStart = metricMin;
+      }
+      if(metricMin + earlyStoppingTolerance < metricWindowStart) {
+         cRoundsNoChange = 0;
+      } else {
+         ++cRoundsNoChange;
+      }
+      if(0 <= earlyStoppingRounds && earlyStoppingRounds <= cRoundsNoChange) {
+         break;
+      }
+   }
+   *pMetricMinOut = metricMin;
+   return countRoundsMax == iRound && 0 != iRound ? iRound - 1 : iRound;
+}
+
+static void CheckSameModels(TestCaseHidden & testCaseHidden, const TestApi & test0, const TestApi & test1) {
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(test0.GetCurrentModelPredictorScore(0, { iBin }, 0) == test1.GetCurrentModelPredictorScore(0, { iBin }, 0));
+      CHECK(test0.GetBestModelPredictorScore(0, { iBin }, 0) == test1.GetBestModelPredictorScore(0, { iBin }, 0));
+   }
+   for(size_t iBin = 0; iBin < 2; ++iBin) {
+      CHECK(test0.GetCurrentModelPredictorScore(1, { iBin }, 0) == test1.GetCurrentModelPredictorScore(1, { iBin }, 0));
+      CHECK(test0.GetBestModelPredictorScore(1, { iBin }, 0) == test1.GetBestModelPredictorScore(1, { iBin }, 0));
+   }
+}
+
+static IntEbmType EBM_NATIVE_CALLING_CONVENTION StopAfterFiveRounds(
+   IntEbmType indexRound,
+   FloatEbmType validationMetric,
+   void * progressContext
+) {
+   UNUSED(validationMetric);
+   IntEbmType * const pcCalls = static_cast<IntEbmType *>(progressContext);
+   *pcCalls += 1;
+   return 4 <= indexRound ? EBM_TRUE : EBM_FALSE;
+}
+
+TEST_CASE("BoostingRun without early stopping matches BoostingStep, boosting, regression") {
+   TestApi testStep = TestApi(k_learningTypeRegression);
+   AddRegressionData(testStep);
+   TestApi testRun = TestApi(k_learningTypeRegression);
+   AddRegressionData(testRun);
+
+   FloatEbmType metricStep;
+   const IntEbmType iRoundStep = ReferenceRun(testStep, 50, -1, 0, &metricStep);
+   FloatEbmType metricRun;
+   const IntEbmType iRoundRun = testRun.BoostRun(50, -1, 0, nullptr, nullptr, &metricRun);
+   CHECK(49 == iRoundStep);
+   CHECK(iRoundStep == iRoundRun);
+   CHECK(metricStep == metricRun);
+   CheckSameModels(testCaseHidden, testStep, testRun);
+}
+
+TEST_CASE("BoostingRun with early stopping matches BoostingStep, boosting, regression") {
+   TestApi testStep = TestApi(k_learningTypeRegression);
+   AddRegressionData(testStep);
+   TestApi testRun = TestApi(k_learningTypeRegression);
+   AddRegressionData(testRun);
+
+   FloatEbmType metricStep;
+   const IntEbmType iRoundStep = ReferenceRun(testStep, 5000, 10, FloatEbmType { 1e-4 }, &metricStep);
+   FloatEbmType metricRun;
+   const IntEbmType iRoundRun = testRun.BoostRun(5000, 10, FloatEbmType { 1e-4 }, nullptr, nullptr, &metricRun);
+   CHECK(iRoundRun < 4999);
+   CHECK(iRoundStep == iRoundRun);
+   CHECK(metricStep == metricRun);
+   CheckSameModels(testCaseHidden, testStep, testRun);
+}
+
+TEST_CASE("BoostingRun progress function stops boosting, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   AddRegressionData(test);
+
+   IntEbmType cCalls = 0;
+   const IntEbmType iRound = test.BoostRun(100, -1, 0, StopAfterFiveRounds, &cCalls);
+   CHECK(4 == iRound);
+   CHECK(5 == cCalls);
+}
+
+TEST_CASE("BoostingRun zero rounds, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   AddRegressionData(test);
+
+   FloatEbmType metric = 0;
+   const IntEbmType iRound = test.BoostRun(0, 3, 0, nullptr, nullptr, &metric);
+   CHECK(0 == iRound);
+   CHECK(std::numeric_limits<FloatEbmType>::infinity() == metric);
+   CHECK(0 == test.GetCurrentModelPredictorScore(0, { 0 }, 0));
+}
+
+TEST_CASE("BoostingRun invalid parameters, boosting, regression") {
+   FloatEbmType metric = 0;
+   IntEbmType iRound = -1;
+   CHECK(0 != BoostingRun(nullptr, 10, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+      k_countSamplesRequiredForChildSplitMinDefault, -1, 0, nullptr, nullptr, &metric, &iRound));
+   CHECK(0 == iRound);
+}
+
+// every feature group gains more than this tiny fraction of the best group, so every group is boosted every round
+static const std::vector<FloatEbmType> k_tempParamsScheduleTiny = MakeTempParams({ 
+   { TempParamBoostingScheduleGainFraction, 1e-12 }, 
+   { TempParamBoostingScheduleReprobeRounds, 1000 } 
+});
+// groups gaining less than half of the best group are skipped until they are probed again 1000 rounds later
+static const std::vector<FloatEbmType> k_tempParamsScheduleHalf = MakeTempParams({ 
+   { TempParamBoostingScheduleGainFraction, 0.5 }, 
+   { TempParamBoostingScheduleReprobeRounds, 1000 } 
+});
+static const std::vector<FloatEbmType> k_tempParamsScheduleHalfDeferred = MakeTempParams({ 
+   { TempParamBoostingDeferValidation, 1 }, 
+   { TempParamBoostingScheduleGainFraction, 0.5 }, 
+   { TempParamBoostingScheduleReprobeRounds, 1000 } 
+});
+// the same with the skipped groups probed again every 3 rounds
+static const std::vector<FloatEbmType> k_tempParamsScheduleReprobe = MakeTempParams({ 
+   { TempParamBoostingScheduleGainFraction, 0.5 }, 
+   { TempParamBoostingScheduleReprobeRounds, 3 } 
+});
+
+// feature 0 explains nearly all of the target and feature 1 only a small remainder.  The target is centered so that
+// neither group has to learn an intercept
+static void InitializeScheduleData(TestApi & test, const std::vector<FloatEbmType> optionalTempParams) {
+   test.AddFeatures({ FeatureTest(4), FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 }, { 1 } });
+   std::vector<RegressionSample> trainingSamples;
+   for(size_t iSample = 0; iSample < 60; ++iSample) {
+      const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 4);
+      const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 3);
+      trainingSamples.push_back(RegressionSample(static_cast<FloatEbmType>(bin0 * 10 - 15) + 
+         static_cast<FloatEbmType>(bin1) / 100, { bin0, bin1 }));
+   }
+   test.AddTrainingSamples(trainingSamples);
+   test.AddValidationSamples({ RegressionSample(-15, { 0, 2 }), RegressionSample(-4, { 1, 0 }), 
+      RegressionSample(4, { 2, 1 }), RegressionSample(15, { 3, 2 }) });
+   test.InitializeBoosting(0, optionalTempParams);
+}
+
+TEST_CASE("BoostingRun scheduling that boosts every group matches BoostingRun, boosting, regression") {
+   TestApi testUnscheduled = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testUnscheduled, {});
+   TestApi testScheduled = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testScheduled, k_tempParamsScheduleTiny);
+
+   FloatEbmType metricUnscheduled;
+   const IntEbmType iRoundUnscheduled = testUnscheduled.BoostRun(40, -1, 0, nullptr, nullptr, &metricUnscheduled);
+   FloatEbmType metricScheduled;
+   const IntEbmType iRoundScheduled = testScheduled.BoostRun(40, -1, 0, nullptr, nullptr, &metricScheduled);
+   CHECK(iRoundUnscheduled == iRoundScheduled);
+   CHECK(metricUnscheduled == metricScheduled);
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(testUnscheduled.GetCurrentModelPredictorScore(1, { iBin }, 0) == 
+         testScheduled.GetCurrentModelPredictorScore(1, { iBin }, 0));
+   }
+}
+
+TEST_CASE("BoostingRun scheduling skips feature groups with little gain, boosting, regression") {
+   TestApi testUnscheduled = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testUnscheduled, {});
+   TestApi testScheduled = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testScheduled, k_tempParamsScheduleHalf);
+
+   FloatEbmType metricUnscheduled;
+   testUnscheduled.BoostRun(40, -1, 0, nullptr, nullptr, &metricUnscheduled);
+   FloatEbmType metricScheduled;
+   testScheduled.BoostRun(20, -1, 0, nullptr, nullptr, &metricScheduled);
+   const FloatEbmType scoreStrong = testScheduled.GetCurrentModelPredictorScore(0, { 3 }, 0);
+   const FloatEbmType scoreWeak = testScheduled.GetCurrentModelPredictorScore(1, { 2 }, 0);
+   // the gains carry over into the next call, so the weak group stays skipped
+   testScheduled.BoostRun(20, -1, 0, nullptr, nullptr, &metricScheduled);
+   CHECK(scoreStrong < testScheduled.GetCurrentModelPredictorScore(0, { 3 }, 0));
+   CHECK(scoreWeak == testScheduled.GetCurrentModelPredictorScore(1, { 2 }, 0));
+   CHECK(IsApproxEqual(metricScheduled, metricUnscheduled, FloatEbmType { 1e-2 }));
+}
+
+TEST_CASE("BoostingRun scheduling probes skipped feature groups again, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(test, k_tempParamsScheduleReprobe);
+
+   test.BoostRun(20, -1, 0);
+   const FloatEbmType scoreWeak = test.GetCurrentModelPredictorScore(1, { 2 }, 0);
+   test.BoostRun(4, -1, 0);
+   CHECK(scoreWeak != test.GetCurrentModelPredictorScore(1, { 2 }, 0));
+}
+
+TEST_CASE("BoostingRun scheduling with 0 reprobe rounds uses the default of 10, boosting, regression") {
+   TestApi testDefault = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testDefault, MakeTempParams({ 
+      { TempParamBoostingScheduleGainFraction, 0.5 }, 
+      { TempParamBoostingScheduleReprobeRounds, 0 } 
+   }));
+   TestApi testTen = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testTen, MakeTempParams({ 
+      { TempParamBoostingScheduleGainFraction, 0.5 }, 
+      { TempParamBoostingScheduleReprobeRounds, 10 } 
+   }));
+
+   // enough rounds that the weak group is skipped and then probed again
+   testDefault.BoostRun(40, -1, 0);
+   testTen.BoostRun(40, -1, 0);
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(testDefault.GetCurrentModelPredictorScore(1, { iBin }, 0) == testTen.GetCurrentModelPredictorScore(1, { iBin }, 0));
+   }
+}
+
+TEST_CASE("BoostingRun scheduling with deferred validation matches the metric of the last boosted group, boosting, regression") {
+   TestApi testImmediate = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testImmediate, k_tempParamsScheduleHalf);
+   TestApi testDeferred = TestApi(k_learningTypeRegression);
+   InitializeScheduleData(testDeferred, k_tempParamsScheduleHalfDeferred);
+
+   FloatEbmType metricImmediate;
+   testImmediate.BoostRun(30, -1, 0, nullptr, nullptr, &metricImmediate);
+   FloatEbmType metricDeferred;
+   testDeferred.BoostRun(30, -1, 0, nullptr, nullptr, &metricDeferred);
+   CHECK(IsApproxEqual(metricDeferred, metricImmediate, FloatEbmType { 1e-9 }));
+   CHECK(testImmediate.GetCurrentModelPredictorScore(1, { 2 }, 0) == testDeferred.GetCurrentModelPredictorScore(1, { 2 }, 0));
+}
@@ -1041,3 +1041,626 @@ TEST_CASE("3 dimensional featureGroup with one dimension reduced in different wa
 
 
 
+
+TEST_CASE("best model picks up feature groups changed by steps that did not improve, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({});
+   test.AddFeatureGroups({ {}, {} });
+   test.AddTrainingSamples({ RegressionSample(10, {}) });
+   test.AddValidationSamples({ RegressionSample(12, {}) });
+   test.InitializeBoosting();
+
+   // improves, so the best model is the current model
+   test.Boost(0);
+   CHECK(test.GetBestModelPredictorScore(0, {}, 0) == test.GetCurrentModelPredictorScore(0, {}, 0));
+   CHECK(0 == test.GetBestModelPredictorScore(1, {}, 0));
+
+   // gets worse, so the best model keeps the old value of feature group 1
+   test.Boost(1, {}, {}, -k_learningRateDefault);
+   CHECK(0 == test.GetBestModelPredictorScore(1, {}, 0));
+   CHECK(0 != test.GetCurrentModelPredictorScore(1, {}, 0));
+
+   // improves again, so the best model needs the change to feature group 1 from the step that got worse
+   test.Boost(0);
+   CHECK(test.GetBestModelPredictorScore(0, {}, 0) == test.GetCurrentModelPredictorScore(0, {}, 0));
+   CHECK(test.GetBestModelPredictorScore(1, {}, 0) == test.GetCurrentModelPredictorScore(1, {}, 0));
+}
+
+TEST_CASE("memory statistics track the data sets of a booster, boosting, regression") {
+   IntEbmType cBytesCurrentBefore = -1;
+   IntEbmType cBytesPeakBefore = -1;
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemDataSet, &cBytesCurrentBefore, &cBytesPeakBefore));
+   CHECK(0 <= cBytesCurrentBefore);
+   CHECK(cBytesCurrentBefore <= cBytesPeakBefore);
+   {
+      TestApi test = TestApi(k_learningTypeRegression);
+      test.AddFeatures({ FeatureTest(2) });
+      test.AddFeatureGroups({ { 0 } });
+      test.AddTrainingSamples({ RegressionSample(10, { 0 }), RegressionSample(20, { 1 }) });
+      test.AddValidationSamples({ RegressionSample(12, { 1 }) });
+      test.InitializeBoosting();
+
+      IntEbmType cBytesCurrent = -1;
+      IntEbmType cBytesPeak = -1;
+      CHECK(0 == GetMemoryStatistics(MemorySubsystemDataSet, &cBytesCurrent, &cBytesPeak));
+      CHECK(cBytesCurrentBefore < cBytesCurrent);
+      CHECK(cBytesCurrent <= cBytesPeak);
+
+      IntEbmType cBytesThreadBuffers = -1;
+      CHECK(0 == GetMemoryStatistics(MemorySubsystemThreadBuffers, &cBytesThreadBuffers, nullptr));
+      CHECK(0 < cBytesThreadBuffers);
+   }
+   IntEbmType cBytesCurrentAfter = -1;
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemDataSet, &cBytesCurrentAfter, nullptr));
+   CHECK(cBytesCurrentBefore == cBytesCurrentAfter);
+
+   CHECK(0 != GetMemoryStatistics(-1, nullptr, nullptr));
+   CHECK(0 != GetMemoryStatistics(MemorySubsystemThreadBuffers + 1, nullptr, nullptr));
+}
+
+// boosts nothing, so every byte that the booster holds comes from InitializeBoosting.  The estimate needs to match it
+// exactly unless bUpperBound, for layouts that briefly hold more during initialization than they keep afterwards
+static void CheckEstimateMatches(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const IntEbmType countInnerBags,
+   const std::vector<FloatEbmType> optionalTempParams,
+   const bool bUpperBound
+) {
+   constexpr IntEbmType cTrainingSamples = 211;
+   constexpr IntEbmType cValidationSamples = 37;
+   EbmNativeFeature features[3];
+   features[0].featureType = FeatureTypeOrdinal;
+   features[0].hasMissing = EBM_FALSE;
+   features[0].countBins = 7;
+   features[1].featureType = FeatureTypeNominal;
+   features[1].hasMissing = EBM_FALSE;
+   features[1].countBins = 5;
+   features[2].featureType = FeatureTypeOrdinal;
+   features[2].hasMissing = EBM_FALSE;
+   features[2].countBins = 300;
+   // an empty group, a nominal main, a main with more than 256 bins and a pair
+   EbmNativeFeatureGroup featureGroups[4];
+   featureGroups[0].countFeaturesInGroup = 0;
+   featureGroups[1].countFeaturesInGroup = 1;
+   featureGroups[2].countFeaturesInGroup = 1;
+   featureGroups[3].countFeaturesInGroup = 2;
+   const IntEbmType featureGroupIndexes[] = { 1, 2, 0, 1 };
+
+   const bool bClassification = k_learningTypeRegression != learningTypeOrCountTargetClasses;
+   const IntEbmType countTargetClasses = bClassification ? static_cast<IntEbmType>(learningTypeOrCountTargetClasses) : 0;
+   const size_t cScores = GetVectorLength(learningTypeOrCountTargetClasses);
+   std::vector<IntEbmType> trainingBinnedData(3 * cTrainingSamples);
+   std::vector<IntEbmType> trainingClasses(cTrainingSamples);
+   std::vector<FloatEbmType> trainingTargets(cTrainingSamples);
+   std::vector<FloatEbmType> trainingScores(cTrainingSamples * cScores, 0);
+   for(IntEbmType iSample = 0; iSample < cTrainingSamples; ++iSample) {
+      for(IntEbmType iFeature = 0; iFeature < 3; ++iFeature) {
+         trainingBinnedData[iFeature * cTrainingSamples + iSample] = iSample * (iFeature + 3) % features[iFeature].countBins;
+      }
+      trainingClasses[iSample] = bClassification ? iSample % countTargetClasses : 0;
+      trainingTargets[iSample] = static_cast<FloatEbmType>(iSample % 17);
+   }
+   std::vector<IntEbmType> validationBinnedData(3 * cValidationSamples);
+   std::vector<IntEbmType> validationClasses(cValidationSamples);
+   std::vector<FloatEbmType> validationTargets(cValidationSamples);
+   std::vector<FloatEbmType> validationScores(cValidationSamples * cScores, 0);
+   for(IntEbmType iSample = 0; iSample < cValidationSamples; ++iSample) {
+      for(IntEbmType iFeature = 0; iFeature < 3; ++iFeature) {
+         validationBinnedData[iFeature * cValidationSamples + iSample] = iSample * (iFeature + 2) % features[iFeature].countBins;
+      }
+      validationClasses[iSample] = bClassification ? (iSample + 1) % countTargetClasses : 0;
+      validationTargets[iSample] = static_cast<FloatEbmType>(iSample % 11);
+   }
+   const FloatEbmType * const pTempParams = optionalTempParams.empty() ? nullptr : &optionalTempParams[0];
+
+   IntEbmType countBytesEstimate[MemoryEstimateCountItems];
+   const IntEbmType error = bClassification ?
+      EstimateBoostingMemoryClassification(countTargetClasses, 3, features, 4, featureGroups, featureGroupIndexes,
+         cTrainingSamples, cValidationSamples, countInnerBags, pTempParams, countBytesEstimate) :
+      EstimateBoostingMemoryRegression(3, features, 4, featureGroups, featureGroupIndexes,
+         cTrainingSamples, cValidationSamples, countInnerBags, pTempParams, countBytesEstimate);
+   CHECK(0 == error);
+   CHECK(0 == countBytesEstimate[MemorySubsystemPackedData]);
+   CHECK(0 < countBytesEstimate[MemoryEstimateHeap]);
+
+   IntEbmType cBytesDataSetBefore = -1;
+   IntEbmType cBytesThreadBuffersBefore = -1;
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemDataSet, &cBytesDataSetBefore, nullptr));
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemThreadBuffers, &cBytesThreadBuffersBefore, nullptr));
+   const PEbmBoosting pEbmBoosting = bClassification ?
+      InitializeBoostingClassification(countTargetClasses, 3, features, 4, featureGroups, featureGroupIndexes,
+         cTrainingSamples, &trainingBinnedData[0], &trainingClasses[0], &trainingScores[0],
+         cValidationSamples, &validationBinnedData[0], &validationClasses[0], &validationScores[0],
+         countInnerBags, k_randomSeed, pTempParams) :
+      InitializeBoostingRegression(3, features, 4, featureGroups, featureGroupIndexes,
+         cTrainingSamples, &trainingBinnedData[0], &trainingTargets[0], &trainingScores[0],
+         cValidationSamples, &validationBinnedData[0], &validationTargets[0], &validationScores[0],
+         countInnerBags, k_randomSeed, pTempParams);
+   CHECK(nullptr != pEbmBoosting);
+   IntEbmType cBytesDataSetAfter = -1;
+   IntEbmType cBytesThreadBuffersAfter = -1;
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemDataSet, &cBytesDataSetAfter, nullptr));
+   CHECK(0 == GetMemoryStatistics(MemorySubsystemThreadBuffers, &cBytesThreadBuffersAfter, nullptr));
+   FreeBoosting(pEbmBoosting);
+
+   const IntEbmType cBytesDataSet = cBytesDataSetAfter - cBytesDataSetBefore;
+   const IntEbmType cBytesThreadBuffers = cBytesThreadBuffersAfter - cBytesThreadBuffersBefore;
+   CHECK(0 < cBytesDataSet);
+   CHECK(0 < cBytesThreadBuffers);
+   if(bUpperBound) {
+      CHECK(cBytesDataSet < countBytesEstimate[MemorySubsystemDataSet]);
+   } else {
+      CHECK(cBytesDataSet == countBytesEstimate[MemorySubsystemDataSet]);
+   }
+   CHECK(cBytesThreadBuffers == countBytesEstimate[MemorySubsystemThreadBuffers]);
+}
+
+TEST_CASE("estimates match the memory of InitializeBoosting, boosting, regression") {
+   CheckEstimateMatches(testCaseHidden, k_learningTypeRegression, 0, {}, false);
+   CheckEstimateMatches(testCaseHidden, k_learningTypeRegression, 3, MakeTempParams({ 
+      { TempParamBoostingCountShards, 3 }, 
+      { TempParamBoostingFractionWithoutReplacement, 0.5 }, 
+      { TempParamBoostingSinglePrecision, 1 } 
+   }), false);
+   CheckEstimateMatches(testCaseHidden, k_learningTypeRegression, 2, MakeTempParams({ 
+      { TempParamBoostingDeferValidation, 1 }, 
+      { TempParamBoostingAlignedPacking, 1.5 }, 
+      { TempParamBoostingConcurrentSlots, 2 }, 
+      { TempParamBoostingSampleIndexBinsMax, 512 } 
+   }), false);
+}
+
+TEST_CASE("estimates match the memory of InitializeBoosting, boosting, binary") {
+   CheckEstimateMatches(testCaseHidden, 2, 0, {}, false);
+   CheckEstimateMatches(testCaseHidden, 2, 2, MakeTempParams({ 
+      { TempParamBoostingCountShards, 2 }, 
+      { TempParamBoostingCacheDenominators, 1 }, 
+      { TempParamBoostingSinglePrecision, 1 } 
+   }), false);
+}
+
+TEST_CASE("estimates match the memory of InitializeBoosting, boosting, multiclass") {
+   CheckEstimateMatches(testCaseHidden, 3, 0, {}, false);
+   CheckEstimateMatches(testCaseHidden, 4, 3, MakeTempParams({ 
+      { TempParamBoostingCountShards, 4 }, 
+      { TempParamBoostingFractionWithoutReplacement, 0.25 }, 
+      { TempParamBoostingCacheDenominators, 1 } 
+   }), false);
+   // the transpose to class-major briefly holds a second copy of the residuals and scores
+   CheckEstimateMatches(testCaseHidden, 3, 1, MakeTempParams({ { TempParamBoostingClassMajor, 1 } }), true);
+}
+
+TEST_CASE("estimates reject invalid shapes, boosting") {
+   EbmNativeFeature feature;
+   feature.featureType = FeatureTypeOrdinal;
+   feature.hasMissing = EBM_FALSE;
+   feature.countBins = 3;
+   EbmNativeFeatureGroup featureGroup;
+   featureGroup.countFeaturesInGroup = 1;
+   const IntEbmType index = 1;
+   IntEbmType countBytes[MemoryEstimateCountItems];
+   CHECK(0 != EstimateBoostingMemoryRegression(1, &feature, 1, &featureGroup, &index, 10, 10, 0, nullptr, countBytes));
+   const IntEbmType indexValid = 0;
+   CHECK(0 != EstimateBoostingMemoryRegression(1, &feature, 1, &featureGroup, &indexValid, -1, 10, 0, nullptr, countBytes));
+   CHECK(0 != EstimateBoostingMemoryClassification(-1, 1, &feature, 1, &featureGroup, &indexValid, 10, 10, 0, nullptr, countBytes));
+   CHECK(0 != EstimateBoostingMemoryRegression(1, &feature, 1, &featureGroup, &indexValid, 10, 10, 0, nullptr, nullptr));
+   CHECK(0 == EstimateBoostingMemoryRegression(1, &feature, 1, &featureGroup, &indexValid, 10, 10, 0, nullptr, countBytes));
+}
+
+TEST_CASE("huge pages do not change the model, boosting, regression") {
+   // enough samples that the residuals are bigger than a 2MB huge page
+   constexpr size_t cSamples = 300000;
+   std::vector<RegressionSample> samples;
+   samples.reserve(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      samples.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 7), { static_cast<IntEbmType>(iSample % 3) }));
+   }
+
+   FloatEbmType aModel[2][3];
+   const IntEbmType aHugePages[2] = { HugePagesOff, HugePagesTransparent };
+   for(size_t iRun = 0; iRun < 2; ++iRun) {
+      SetHugePages(aHugePages[iRun]);
+      TestApi test = TestApi(k_learningTypeRegression);
+      test.AddFeatures({ FeatureTest(3) });
+      test.AddFeatureGroups({ { 0 } });
+      test.AddTrainingSamples(samples);
+      test.AddValidationSamples({ RegressionSample(3, { 0 }), RegressionSample(4, { 2 }) });
+      test.InitializeBoosting();
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         test.Boost(0);
+      }
+      for(size_t iBin = 0; iBin < 3; ++iBin) {
+         aModel[iRun][iBin] = test.GetCurrentModelPredictorScore(0, { iBin }, 0);
+      }
+   }
+   SetHugePages(HugePagesOff);
+
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(aModel[0][iBin] == aModel[1][iBin]);
+   }
+}
+
+TEST_CASE("NUMA interleaving does not change the model, boosting, regression") {
+   // enough samples that the residuals are big enough to be interleaved.  Single node machines skip the interleaving
+   constexpr size_t cSamples = 300000;
+   std::vector<RegressionSample> samples;
+   samples.reserve(cSamples);
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      samples.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 7), { static_cast<IntEbmType>(iSample % 3) }));
+   }
+
+   FloatEbmType aModel[2][3];
+   const IntEbmType aNumaPlacement[2] = { NumaPlacementFirstTouch, NumaPlacementInterleave };
+   for(size_t iRun = 0; iRun < 2; ++iRun) {
+      SetNumaPlacement(aNumaPlacement[iRun]);
+      TestApi test = TestApi(k_learningTypeRegression);
+      test.AddFeatures({ FeatureTest(3) });
+      test.AddFeatureGroups({ { 0 } });
+      test.AddTrainingSamples(samples);
+      test.AddValidationSamples({ RegressionSample(3, { 0 }), RegressionSample(4, { 2 }) });
+      test.InitializeBoosting();
+      for(int iEpoch = 0; iEpoch < 3; ++iEpoch) {
+         test.Boost(0);
+      }
+      for(size_t iBin = 0; iBin < 3; ++iBin) {
+         aModel[iRun][iBin] = test.GetCurrentModelPredictorScore(0, { iBin }, 0);
+      }
+   }
+   SetNumaPlacement(NumaPlacementFirstTouch);
+
+   for(size_t iBin = 0; iBin < 3; ++iBin) {
+      CHECK(aModel[0][iBin] == aModel[1][iBin]);
+   }
+}
+
+static void CheckSparseUpdate(TestCaseHidden & testCaseHidden, const ptrdiff_t learningType) {
+   // the first update leaves 3 of the 4 bins at zero, so only the samples in bin 0 change, and the second update 
+   // leaves bin 0 alone.  Adding zero is exact, so applying both has to leave every score and residual exactly where 
+   // applying their sum in one dense update does
+   constexpr size_t cBins = 4;
+   const size_t cVectorLength = GetVectorLength(learningType);
+   const size_t cClasses = k_learningTypeRegression == learningType ? size_t { 2 } : static_cast<size_t>(learningType);
+   std::vector<RegressionSample> regressionTrainingSamples;
+   std::vector<ClassificationSample> classificationTrainingSamples;
+   for(size_t iSample = 0; iSample < 40; ++iSample) {
+      const IntEbmType iBin = static_cast<IntEbmType>(iSample % cBins);
+      regressionTrainingSamples.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 7), { iBin }));
+      classificationTrainingSamples.push_back(ClassificationSample(static_cast<IntEbmType>(iSample % 5 % cClasses), { iBin }));
+   }
+
+   std::vector<FloatEbmType> updateSparse;
+   std::vector<FloatEbmType> updateDense;
+   std::vector<FloatEbmType> updateCombined;
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         const FloatEbmType value = static_cast<FloatEbmType>(iBin + 1) * FloatEbmType { 0.125 } - static_cast<FloatEbmType>(iVector) * FloatEbmType { 0.0625 };
+         updateSparse.push_back(0 == iBin ? value : FloatEbmType { 0 });
+         updateDense.push_back(0 == iBin ? FloatEbmType { 0 } : value);
+         updateCombined.push_back(value);
+      }
+   }
+
+   FloatEbmType aValidationMetric[2];
+   FloatEbmType aBoostedModel[2][cBins];
+   for(size_t iRun = 0; iRun < 2; ++iRun) {
+      TestApi test = k_learningTypeRegression == learningType ? TestApi(k_learningTypeRegression) : TestApi(learningType);
+      test.AddFeatures({ FeatureTest(static_cast<IntEbmType>(cBins)) });
+      test.AddFeatureGroups({ { 0 } });
+      if(k_learningTypeRegression == learningType) {
+         test.AddTrainingSamples(regressionTrainingSamples);
+         test.AddValidationSamples({ RegressionSample(3, { 0 }), RegressionSample(1, { 2 }) });
+      } else {
+         test.AddTrainingSamples(classificationTrainingSamples);
+         test.AddValidationSamples({ ClassificationSample(1, { 0 }), ClassificationSample(0, { 2 }) });
+      }
+      test.InitializeBoosting(0);
+
+      if(0 == iRun) {
+         CHECK(0 == ApplyModelFeatureGroupUpdate(test.GetBoosting(), 0, &updateSparse[0], nullptr));
+         CHECK(0 == ApplyModelFeatureGroupUpdate(test.GetBoosting(), 0, &updateDense[0], &aValidationMetric[iRun]));
+      } else {
+         CHECK(0 == ApplyModelFeatureGroupUpdate(test.GetBoosting(), 0, &updateCombined[0], &aValidationMetric[iRun]));
+      }
+      // the next update is generated from the residuals, so it shows whether any training sample differs
+      test.Boost(0);
+      for(size_t iBin = 0; iBin < cBins; ++iBin) {
+         aBoostedModel[iRun][iBin] = test.GetCurrentModelPredictorScore(0, { iBin }, k_learningTypeRegression == learningType ? 0 : 1);
+      }
+   }
+   CHECK(aValidationMetric[0] == aValidationMetric[1]);
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      CHECK(aBoostedModel[0][iBin] == aBoostedModel[1][iBin]);
+   }
+}
+
+TEST_CASE("sparse update applies the same as a dense update, boosting, regression") {
+   CheckSparseUpdate(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("sparse update applies the same as a dense update, boosting, binary") {
+   CheckSparseUpdate(testCaseHidden, 2);
+}
+
+TEST_CASE("sparse update applies the same as a dense update, boosting, multiclass") {
+   CheckSparseUpdate(testCaseHidden, 3);
+}
+
+TEST_CASE("all zero update leaves the model unchanged, boosting, binary") {
+   TestApi test = TestApi(2);
+   test.AddFeatures({ FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 } });
+   test.AddTrainingSamples({ ClassificationSample(0, { 0 }), ClassificationSample(1, { 1 }), ClassificationSample(1, { 2 }) });
+   test.AddValidationSamples({ ClassificationSample(1, { 1 }) });
+   test.InitializeBoosting(0);
+   const FloatEbmType validationMetricBefore = test.Boost(0);
+   const FloatEbmType aZeros[3] = { 0, 0, 0 };
+   FloatEbmType validationMetricAfter = FloatEbmType { 0 };
+   CHECK(0 == ApplyModelFeatureGroupUpdate(test.GetBoosting(), 0, aZeros, &validationMetricAfter));
+   CHECK(validationMetricBefore == validationMetricAfter);
+}
+
+static void CheckNominalSplitsAlternatingCategories(TestCaseHidden & testCaseHidden, const ptrdiff_t learningType) {
+   // the even categories have high targets and the odd categories have low targets, so an ordinal split can't separate 
+   // them, but a nominal split orders the categories by their residuals and separates them with a single cut
+   constexpr size_t cBins = 7;
+   std::vector<RegressionSample> regressionSamples;
+   std::vector<ClassificationSample> classificationSamples;
+   for(size_t iSample = 0; iSample < cBins * 4; ++iSample) {
+      const size_t iBin = iSample % cBins;
+      const bool bHigh = 0 == iBin % 2;
+      regressionSamples.push_back(RegressionSample(bHigh ? 10 : -10, { static_cast<IntEbmType>(iBin) }));
+      classificationSamples.push_back(ClassificationSample(bHigh ? 1 : 0, { static_cast<IntEbmType>(iBin) }));
+   }
+
+   TestApi test = k_learningTypeRegression == learningType ? TestApi(k_learningTypeRegression) : TestApi(2, 0);
+   test.AddFeatures({ FeatureTest(static_cast<IntEbmType>(cBins), FeatureType::Nominal) });
+   test.AddFeatureGroups({ { 0 } });
+   if(k_learningTypeRegression == learningType) {
+      test.AddTrainingSamples(regressionSamples);
+      test.AddValidationSamples({ RegressionSample(10, { 0 }) });
+   } else {
+      test.AddTrainingSamples(classificationSamples);
+      test.AddValidationSamples({ ClassificationSample(1, { 0 }) });
+   }
+   test.InitializeBoosting(0);
+
+   test.Boost(0, {}, {}, k_learningRateDefault, 1);
+
+   const FloatEbmType high = test.GetCurrentModelPredictorScore(0, { 0 }, k_learningTypeRegression == learningType ? 0 : 1);
+   const FloatEbmType low = test.GetCurrentModelPredictorScore(0, { 1 }, k_learningTypeRegression == learningType ? 0 : 1);
+   CHECK(low < high);
+   for(size_t iBin = 0; iBin < cBins; ++iBin) {
+      const FloatEbmType modelValue = test.GetCurrentModelPredictorScore(0, { iBin }, 
+         k_learningTypeRegression == learningType ? 0 : 1);
+      CHECK(modelValue == (0 == iBin % 2 ? high : low));
+   }
+}
+
+TEST_CASE("nominal feature splits alternating categories, boosting, regression") {
+   CheckNominalSplitsAlternatingCategories(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("nominal feature splits alternating categories, boosting, binary") {
+   CheckNominalSplitsAlternatingCategories(testCaseHidden, 2);
+}
+
+TEST_CASE("nominal feature, boosting, multiclass") {
+   TestApi test = TestApi(3);
+   test.AddFeatures({ FeatureTest(5, FeatureType::Nominal), FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 }, { 0, 1 } });
+   std::vector<ClassificationSample> samples;
+   for(size_t iSample = 0; iSample < 60; ++iSample) {
+      samples.push_back(ClassificationSample(static_cast<IntEbmType>(iSample * 7 % 3), 
+         { static_cast<IntEbmType>(iSample % 5), static_cast<IntEbmType>(iSample % 3) }));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ ClassificationSample(0, { 1, 2 }) });
+   test.InitializeBoosting();
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetric = test.Boost(iFeatureGroup);
+         CHECK(!std::isnan(validationMetric));
+      }
+   }
+   for(size_t iBin = 0; iBin < 5; ++iBin) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK(!std::isnan(test.GetCurrentModelPredictorScore(0, { iBin }, iClass)));
+      }
+   }
+}
+
+static void CheckMissingBinSplitsOff(TestCaseHidden & testCaseHidden, const ptrdiff_t learningType) {
+   // the missing values are in the 0th bin and have high targets while every non-missing bin has low targets, so a 
+   // single cut should separate the missing bin from the rest
+   constexpr size_t cBins = 5;
+   std::vector<RegressionSample> regressionSamples;
+   std::vector<ClassificationSample> classificationSamples;
+   for(size_t iSample = 0; iSample < cBins * 4; ++iSample) {
+      const size_t iBin = iSample % cBins;
+      const bool bMissing = 0 == iBin;
+      regressionSamples.push_back(RegressionSample(bMissing ? 10 : -10, { static_cast<IntEbmType>(iBin) }));
+      classificationSamples.push_back(ClassificationSample(bMissing ? 1 : 0, { static_cast<IntEbmType>(iBin) }));
+   }
+
+   TestApi test = k_learningTypeRegression == learningType ? TestApi(k_learningTypeRegression) : TestApi(2, 0);
+   test.AddFeatures({ FeatureTest(static_cast<IntEbmType>(cBins), FeatureType::Ordinal, true) });
+   test.AddFeatureGroups({ { 0 } });
+   if(k_learningTypeRegression == learningType) {
+      test.AddTrainingSamples(regressionSamples);
+      test.AddValidationSamples({ RegressionSample(10, { 0 }) });
+   } else {
+      test.AddTrainingSamples(classificationSamples);
+      test.AddValidationSamples({ ClassificationSample(1, { 0 }) });
+   }
+   test.InitializeBoosting(1);
+
+   test.Boost(0, {}, {}, k_learningRateDefault, 1);
+
+   const size_t iClass = k_learningTypeRegression == learningType ? 0 : 1;
+   const FloatEbmType missing = test.GetCurrentModelPredictorScore(0, { 0 }, iClass);
+   const FloatEbmType low = test.GetCurrentModelPredictorScore(0, { 1 }, iClass);
+   CHECK(low < missing);
+   for(size_t iBin = 1; iBin < cBins; ++iBin) {
+      CHECK(low == test.GetCurrentModelPredictorScore(0, { iBin }, iClass));
+   }
+}
+
+TEST_CASE("missing bin splits off, boosting, regression") {
+   CheckMissingBinSplitsOff(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("missing bin splits off, boosting, binary") {
+   CheckMissingBinSplitsOff(testCaseHidden, 2);
+}
+
+TEST_CASE("missing bins in a pair, boosting, multiclass") {
+   TestApi test = TestApi(3);
+   test.AddFeatures({ FeatureTest(4, FeatureType::Ordinal, true), FeatureTest(3, FeatureType::Nominal, true) });
+   test.AddFeatureGroups({ { 0 }, { 1 }, { 0, 1 } });
+   std::vector<ClassificationSample> samples;
+   for(size_t iSample = 0; iSample < 48; ++iSample) {
+      samples.push_back(ClassificationSample(static_cast<IntEbmType>(iSample * 5 % 3),
+         { static_cast<IntEbmType>(iSample % 4), static_cast<IntEbmType>(iSample % 3) }));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ ClassificationSample(0, { 0, 0 }) });
+   test.InitializeBoosting();
+
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         const FloatEbmType validationMetric = test.Boost(iFeatureGroup);
+         CHECK(!std::isnan(validationMetric));
+      }
+   }
+   for(size_t iBin = 0; iBin < 4; ++iBin) {
+      for(size_t iClass = 0; iClass < 3; ++iClass) {
+         CHECK(!std::isnan(test.GetCurrentModelPredictorScore(2, { iBin, 0 }, iClass)));
+      }
+   }
+}
+
+TEST_CASE("GetPerformanceCounters, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(3), FeatureTest(4) });
+   test.AddFeatureGroups({ { 0 }, { 0, 1 } });
+   std::vector<RegressionSample> samples;
+   for(size_t iSample = 0; iSample < 24; ++iSample) {
+      samples.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 5), 
+         { static_cast<IntEbmType>(iSample % 3), static_cast<IntEbmType>(iSample % 4) }));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ RegressionSample(1, { 0, 1 }), RegressionSample(2, { 2, 3 }) });
+   test.InitializeBoosting();
+
+   constexpr IntEbmType cRounds = 3;
+   for(IntEbmType iRound = 0; iRound < cRounds; ++iRound) {
+      test.Boost(0);
+      test.Boost(1);
+   }
+
+   IntEbmType countCalls = -1;
+   IntEbmType countNanoseconds = -1;
+   IntEbmType countBytesScanned = -1;
+   const IntEbmType ret = GetPerformanceCounters(test.GetBoosting(), PerformanceCounterBinBoosting, 
+      &countCalls, &countNanoseconds, &countBytesScanned);
+   if(0 == ret) {
+      // the library was compiled with EBM_PERFORMANCE_COUNTERS
+      CHECK(2 * cRounds == countCalls);
+      CHECK(0 <= countNanoseconds);
+      CHECK(0 < countBytesScanned);
+
+      CHECK(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterGrowDecisionTree, &countCalls, nullptr, nullptr));
+      CHECK(cRounds == countCalls);
+      CHECK(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterFindBestBoostingSplitsPairs, &countCalls, nullptr, nullptr));
+      CHECK(cRounds == countCalls);
+      CHECK(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterApplyModelUpdateValidation, &countCalls, nullptr, nullptr));
+      CHECK(2 * cRounds == countCalls);
+   } else {
+      CHECK(0 == countCalls);
+      CHECK(0 == countNanoseconds);
+      CHECK(0 == countBytesScanned);
+   }
+
+   CHECK(0 != GetPerformanceCounters(test.GetBoosting(), 7, &countCalls, nullptr, nullptr));
+   CHECK(0 != GetPerformanceCounters(nullptr, PerformanceCounterBinBoosting, &countCalls, nullptr, nullptr));
+}
+
+TEST_CASE("GetPerformanceCounters with bags boosted in parallel, boosting, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(3), FeatureTest(4) });
+   test.AddFeatureGroups({ { 0 }, { 0, 1 } });
+   std::vector<RegressionSample> samples;
+   for(size_t iSample = 0; iSample < 240; ++iSample) {
+      samples.push_back(RegressionSample(static_cast<FloatEbmType>(iSample % 5), 
+         { static_cast<IntEbmType>(iSample % 3), static_cast<IntEbmType>(iSample % 4) }));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ RegressionSample(1, { 0, 1 }), RegressionSample(2, { 2, 3 }) });
+   // the bags of each step are boosted on the thread pool, so their counters are stopped concurrently
+   constexpr IntEbmType cBags = 16;
+   test.InitializeBoosting(cBags);
+
+   constexpr IntEbmType cRounds = 20;
+   for(IntEbmType iRound = 0; iRound < cRounds; ++iRound) {
+      test.Boost(0);
+      test.Boost(1);
+   }
+
+   IntEbmType countCalls = -1;
+   if(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterBinBoosting, &countCalls, nullptr, nullptr)) {
+      // the library was compiled with EBM_PERFORMANCE_COUNTERS
+      CHECK(2 * cRounds * cBags == countCalls);
+      CHECK(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterGrowDecisionTree, &countCalls, nullptr, nullptr));
+      CHECK(cRounds * cBags == countCalls);
+      CHECK(0 == GetPerformanceCounters(test.GetBoosting(), PerformanceCounterFindBestBoostingSplitsPairs, &countCalls, nullptr, nullptr));
+      CHECK(cRounds * cBags == countCalls);
+   } else {
+      CHECK(0 == countCalls);
+   }
+}
+
+TEST_CASE("CopyBestModelFeatureGroup and CopyCurrentModelFeatureGroup with strides, boosting, multiclass") {
+   TestApi test = TestApi(3);
+   test.AddFeatures({ FeatureTest(4), FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 }, { 0, 1 } });
+   std::vector<ClassificationSample> samples;
+   for(size_t iSample = 0; iSample < 36; ++iSample) {
+      samples.push_back(ClassificationSample(static_cast<IntEbmType>(iSample * 7 % 3),
+         { static_cast<IntEbmType>(iSample % 4), static_cast<IntEbmType>(iSample % 3) }));
+   }
+   test.AddTrainingSamples(samples);
+   test.AddValidationSamples({ ClassificationSample(0, { 0, 0 }), ClassificationSample(2, { 3, 1 }) });
+   test.InitializeBoosting();
+   for(int iEpoch = 0; iEpoch < 5; ++iEpoch) {
+      test.Boost(0);
+      test.Boost(1);
+   }
+
+   // without strides we get the layout of GetCurrentModelFeatureGroup
+   const FloatEbmType * const aCurrent = GetCurrentModelFeatureGroup(test.GetBoosting(), 1);
+   CHECK(nullptr != aCurrent);
+   std::vector<FloatEbmType> contiguous(4 * 3 * 3);
+   CHECK(0 == CopyCurrentModelFeatureGroup(test.GetBoosting(), 1, nullptr, &contiguous[0]));
+   if(nullptr != aCurrent) {
+      CHECK(std::equal(contiguous.begin(), contiguous.end(), aCurrent));
+   }
+
+   // a [class][bin1][bin0] layout with the classes reversed, which exercises a negative stride
+   constexpr IntEbmType k_cBytes = static_cast<IntEbmType>(sizeof(FloatEbmType));
+   const IntEbmType countBytesStrides[] = { k_cBytes, 4 * k_cBytes, -12 * k_cBytes };
+   std::vector<FloatEbmType> transposed(4 * 3 * 3);
+   CHECK(0 == CopyBestModelFeatureGroup(test.GetBoosting(), 1, countBytesStrides, &transposed[2 * 12]));
+   for(size_t iBin0 = 0; iBin0 < 4; ++iBin0) {
+      for(size_t iBin1 = 0; iBin1 < 3; ++iBin1) {
+         for(size_t iClass = 0; iClass < 3; ++iClass) {
+            CHECK(test.GetBestModelPredictorScore(1, { iBin0, iBin1 }, iClass) == 
+               transposed[(2 - iClass) * 12 + iBin1 * 4 + iBin0]);
+         }
+      }
+   }
+
+   CHECK(0 != CopyBestModelFeatureGroup(test.GetBoosting(), 2, nullptr, &transposed[0]));
+   CHECK(0 != CopyBestModelFeatureGroup(test.GetBoosting(), 0, nullptr, nullptr));
+}
@@ -0,0 +1,230 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingWarmStart;
+
+static constexpr size_t k_cTrainingSamplesWarmStart = 53;
+static constexpr size_t k_cValidationSamplesWarmStart = 29;
+static constexpr int k_cRoundsWarmStart = 4;
+
+// deduplication merges samples by their scores, so the warm start scores have to be in place before it runs
+static const std::vector<FloatEbmType> k_tempParamsWarmStart = MakeTempParams({ { TempParamBoostingDeduplicate, 1 } });
+
+class WarmStartModel final {
+public:
+   std::vector<EbmNativeFeature> m_features;
+   std::vector<EbmNativeFeatureGroup> m_featureGroups;
+   std::vector<IntEbmType> m_featureGroupIndexes;
+   std::vector<FloatEbmType> m_tensors;
+   size_t m_cVectorLength;
+
+   WarmStartModel(const ptrdiff_t learningTypeOrCountTargetClasses) :
+      m_features { { 0, 0, 5 }, { 0, 0, 4 } },
+      m_featureGroups { { 0 }, { 1 }, { 1 }, { 2 } },
+      m_featureGroupIndexes { 0, 1, 0, 1 },
+      m_cVectorLength(GetVectorLength(learningTypeOrCountTargetClasses)) {
+
+      const size_t cTensorValues = (1 + 5 + 4 + 5 * 4) * m_cVectorLength;
+      for(size_t iValue = 0; iValue < cTensorValues; ++iValue) {
+         m_tensors.push_back(static_cast<FloatEbmType>(static_cast<int>(iValue * 7 % 11) - 5) / 8);
+      }
+   }
+
+   // the scores that our caller would otherwise compute with the model, added in feature group order just like
+   // boosting would have added them
+   std::vector<FloatEbmType> Score(const std::vector<IntEbmType> & binnedData, const std::vector<FloatEbmType> & base) const {
+      const size_t cSamples = binnedData.size() / m_features.size();
+      std::vector<FloatEbmType> scores(base);
+      if(scores.empty()) {
+         scores.resize(cSamples * m_cVectorLength);
+      }
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         const size_t iBin0 = static_cast<size_t>(binnedData[iSample]);
+         const size_t iBin1 = static_cast<size_t>(binnedData[cSamples + iSample]);
+         const size_t aiTensor[] { 0, 1 + iBin0, 1 + 5 + iBin1, 1 + 5 + 4 + iBin0 + 5 * iBin1 };
+         for(const size_t iTensor : aiTensor) {
+            for(size_t iVector = 0; iVector < m_cVectorLength; ++iVector) {
+               scores[iSample * m_cVectorLength + iVector] += m_tensors[iTensor * m_cVectorLength + iVector];
+            }
+         }
+      }
+      return scores;
+   }
+};
+
+class WarmStartData final {
+public:
+   std::vector<IntEbmType> m_binnedData;
+   std::vector<IntEbmType> m_classificationTargets;
+   std::vector<FloatEbmType> m_regressionTargets;
+   std::vector<FloatEbmType> m_offsets;
+
+   WarmStartData(const ptrdiff_t learningTypeOrCountTargetClasses, const size_t cSamples, const size_t iSampleStart) {
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         m_binnedData.push_back(static_cast<IntEbmType>(iSample % 5));
+      }
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         m_binnedData.push_back(static_cast<IntEbmType>(iSample * 3 / 2 % 4));
+      }
+      const size_t cVectorLength = GetVectorLength(learningTypeOrCountTargetClasses);
+      for(size_t iSample = iSampleStart; iSample < iSampleStart + cSamples; ++iSample) {
+         if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+            m_regressionTargets.push_back(static_cast<FloatEbmType>(iSample % 5) - static_cast<FloatEbmType>(iSample % 7) / 2);
+         } else {
+            m_classificationTargets.push_back(
+               static_cast<IntEbmType>((iSample % 5 + iSample % 3) % static_cast<size_t>(learningTypeOrCountTargetClasses)));
+         }
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            m_offsets.push_back(static_cast<FloatEbmType>((iSample + iVector) % 3) / 4);
+         }
+      }
+   }
+};
+
+static PEbmBoosting InitializeBoostingWarmStart(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const WarmStartModel & model,
+   const WarmStartData & training,
+   const WarmStartData & validation,
+   const FloatEbmType * const initialModelFeatureGroupTensors,
+   const FloatEbmType * const trainingPredictorScores,
+   const FloatEbmType * const validationPredictorScores,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const FloatEbmType * const tempParams = optionalTempParams.empty() ? nullptr : &optionalTempParams[0];
+   const IntEbmType countFeatures = static_cast<IntEbmType>(model.m_features.size());
+   const IntEbmType countFeatureGroups = static_cast<IntEbmType>(model.m_featureGroups.size());
+   if(nullptr == initialModelFeatureGroupTensors) {
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         return InitializeBoostingRegressionWeighted(countFeatures, &model.m_features[0], countFeatureGroups,
+            &model.m_featureGroups[0], &model.m_featureGroupIndexes[0], k_cTrainingSamplesWarmStart,
+            &training.m_binnedData[0], &training.m_regressionTargets[0], trainingPredictorScores, nullptr,
+            k_cValidationSamplesWarmStart, &validation.m_binnedData[0], &validation.m_regressionTargets[0],
+            validationPredictorScores, nullptr, 0, k_randomSeed, tempParams);
+      }
+      return InitializeBoostingClassificationWeighted(learningTypeOrCountTargetClasses, countFeatures, &model.m_features[0],
+         countFeatureGroups, &model.m_featureGroups[0], &model.m_featureGroupIndexes[0], k_cTrainingSamplesWarmStart,
+         &training.m_binnedData[0], &training.m_classificationTargets[0], trainingPredictorScores, nullptr,
+         k_cValidationSamplesWarmStart, &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+         validationPredictorScores, nullptr, 0, k_randomSeed, tempParams);
+   }
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return InitializeBoostingRegressionWarmStart(countFeatures, &model.m_features[0], countFeatureGroups,
+         &model.m_featureGroups[0], &model.m_featureGroupIndexes[0], initialModelFeatureGroupTensors,
+         k_cTrainingSamplesWarmStart, &training.m_binnedData[0], &training.m_regressionTargets[0], trainingPredictorScores,
+         nullptr, k_cValidationSamplesWarmStart, &validation.m_binnedData[0], &validation.m_regressionTargets[0],
+         validationPredictorScores, nullptr, 0, k_randomSeed, tempParams);
+   }
+   return InitializeBoostingClassificationWarmStart(learningTypeOrCountTargetClasses, countFeatures, &model.m_features[0],
+      countFeatureGroups, &model.m_featureGroups[0], &model.m_featureGroupIndexes[0], initialModelFeatureGroupTensors,
+      k_cTrainingSamplesWarmStart, &training.m_binnedData[0], &training.m_classificationTargets[0], trainingPredictorScores,
+      nullptr, k_cValidationSamplesWarmStart, &validation.m_binnedData[0], &validation.m_classificationTargets[0],
+      validationPredictorScores, nullptr, 0, k_randomSeed, tempParams);
+}
+
+static void CheckWarmStartMatchesScored(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const bool bOffsets,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const WarmStartModel model(learningTypeOrCountTargetClasses);
+   const WarmStartData training(learningTypeOrCountTargetClasses, k_cTrainingSamplesWarmStart, 0);
+   const WarmStartData validation(learningTypeOrCountTargetClasses, k_cValidationSamplesWarmStart, 1000);
+
+   const std::vector<FloatEbmType> trainingOffsets = bOffsets ? training.m_offsets : std::vector<FloatEbmType>();
+   const std::vector<FloatEbmType> validationOffsets = bOffsets ? validation.m_offsets : std::vector<FloatEbmType>();
+   const std::vector<FloatEbmType> trainingScores = model.Score(training.m_binnedData, trainingOffsets);
+   const std::vector<FloatEbmType> validationScores = model.Score(validation.m_binnedData, validationOffsets);
+
+   const PEbmBoosting ebmBoostingScored = InitializeBoostingWarmStart(learningTypeOrCountTargetClasses, model, training,
+      validation, nullptr, &trainingScores[0], &validationScores[0], optionalTempParams);
+   const PEbmBoosting ebmBoostingWarmStart = InitializeBoostingWarmStart(learningTypeOrCountTargetClasses, model, training,
+      validation, &model.m_tensors[0], bOffsets ? &trainingOffsets[0] : nullptr,
+      bOffsets ? &validationOffsets[0] : nullptr, optionalTempParams);
+   CHECK(nullptr != ebmBoostingScored);
+   CHECK(nullptr != ebmBoostingWarmStart);
+   if(nullptr == ebmBoostingScored || nullptr == ebmBoostingWarmStart) {
+      FreeBoosting(ebmBoostingScored);
+      FreeBoosting(ebmBoostingWarmStart);
+      return;
+   }
+
+   const IntEbmType cFeatureGroups = static_cast<IntEbmType>(model.m_featureGroups.size());
+   for(int iRound = 0; iRound < k_cRoundsWarmStart; ++iRound) {
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+         FloatEbmType metricScored = 0;
+         CHECK(0 == BoostingStep(ebmBoostingScored, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricScored));
+         FloatEbmType metricWarmStart = 0;
+         CHECK(0 == BoostingStep(ebmBoostingWarmStart, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+            k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metricWarmStart));
+         CHECK(metricScored == metricWarmStart);
+      }
+   }
+
+   // both boosters start from the same scores, so everything that boosting adds is identical too
+   size_t iTensorStart = 0;
+   const size_t acTensorBins[] { 1, 5, 4, 5 * 4 };
+   for(IntEbmType iFeatureGroup = 0; iFeatureGroup < cFeatureGroups; ++iFeatureGroup) {
+      const FloatEbmType * const pModelScored = GetBestModelFeatureGroup(ebmBoostingScored, iFeatureGroup);
+      const FloatEbmType * const pModelWarmStart = GetBestModelFeatureGroup(ebmBoostingWarmStart, iFeatureGroup);
+      const size_t cScores = acTensorBins[iFeatureGroup] * model.m_cVectorLength;
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(pModelScored[iScore] == pModelWarmStart[iScore]);
+      }
+      iTensorStart += cScores;
+   }
+   CHECK(model.m_tensors.size() == iTensorStart);
+
+   FreeBoosting(ebmBoostingScored);
+   FreeBoosting(ebmBoostingWarmStart);
+}
+
+TEST_CASE("warm start matches scoring with the model, boosting, regression") {
+   CheckWarmStartMatchesScored(testCaseHidden, k_learningTypeRegression, false, {});
+   CheckWarmStartMatchesScored(testCaseHidden, k_learningTypeRegression, true, {});
+   CheckWarmStartMatchesScored(testCaseHidden, k_learningTypeRegression, true, k_tempParamsWarmStart);
+}
+
+TEST_CASE("warm start matches scoring with the model, boosting, binary") {
+   CheckWarmStartMatchesScored(testCaseHidden, 2, false, {});
+   CheckWarmStartMatchesScored(testCaseHidden, 2, true, {});
+   CheckWarmStartMatchesScored(testCaseHidden, 2, true, k_tempParamsWarmStart);
+}
+
+TEST_CASE("warm start matches scoring with the model, boosting, multiclass") {
+   CheckWarmStartMatchesScored(testCaseHidden, 3, false, {});
+   CheckWarmStartMatchesScored(testCaseHidden, 3, true, {});
+   CheckWarmStartMatchesScored(testCaseHidden, 3, true, k_tempParamsWarmStart);
+}
+
+TEST_CASE("warm start without tensors is rejected, boosting") {
+   const WarmStartModel model(3);
+   const WarmStartData training(3, k_cTrainingSamplesWarmStart, 0);
+   const WarmStartData validation(3, k_cValidationSamplesWarmStart, 1000);
+
+   const PEbmBoosting ebmBoostingClassification = InitializeBoostingClassificationWarmStart(3,
+      static_cast<IntEbmType>(model.m_features.size()), &model.m_features[0],
+      static_cast<IntEbmType>(model.m_featureGroups.size()), &model.m_featureGroups[0], &model.m_featureGroupIndexes[0],
+      nullptr, k_cTrainingSamplesWarmStart, &training.m_binnedData[0], &training.m_classificationTargets[0], nullptr,
+      nullptr, k_cValidationSamplesWarmStart, &validation.m_binnedData[0], &validation.m_classificationTargets[0], nullptr,
+      nullptr, 0, k_randomSeed, nullptr);
+   CHECK(nullptr == ebmBoostingClassification);
+
+   const WarmStartData trainingRegression(k_learningTypeRegression, k_cTrainingSamplesWarmStart, 0);
+   const WarmStartData validationRegression(k_learningTypeRegression, k_cValidationSamplesWarmStart, 1000);
+   const PEbmBoosting ebmBoostingRegression = InitializeBoostingRegressionWarmStart(
+      static_cast<IntEbmType>(model.m_features.size()), &model.m_features[0],
+      static_cast<IntEbmType>(model.m_featureGroups.size()), &model.m_featureGroups[0], &model.m_featureGroupIndexes[0],
+      nullptr, k_cTrainingSamplesWarmStart, &trainingRegression.m_binnedData[0], &trainingRegression.m_regressionTargets[0],
+      nullptr, nullptr, k_cValidationSamplesWarmStart, &validationRegression.m_binnedData[0],
+      &validationRegression.m_regressionTargets[0], nullptr, nullptr, 0, k_randomSeed, nullptr);
+   CHECK(nullptr == ebmBoostingRegression);
+}
@@ -0,0 +1,228 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::BoostingWeighted;
+
+static constexpr size_t k_cTrainingSamplesWeighted = 80;
+static constexpr size_t k_cValidationSamplesWeighted = 30;
+
+static const EbmNativeFeature k_featuresWeighted[] { { 0, 0, 5 }, { 0, 0, 4 } };
+static const EbmNativeFeatureGroup k_featureGroupsWeighted[] { { 1 }, { 1 }, { 2 } };
+static const IntEbmType k_featureGroupIndexesWeighted[] { 0, 1, 0, 1 };
+static const size_t k_cTensorBinsWeighted[] { 5, 4, 20 };
+static constexpr IntEbmType k_cFeatureGroupsWeighted = 3;
+
+// weighted and duplicated samples only differ in the order that we sum their floating point values
+static constexpr FloatEbmType k_toleranceWeighted = FloatEbmType { 1e-9 };
+
+static const std::vector<FloatEbmType> k_tempParamsDeduplicate = MakeTempParams({ { TempParamBoostingDeduplicate, 1 } });
+
+class WeightedData final {
+public:
+   size_t m_cSamples;
+   std::vector<IntEbmType> m_binnedData;
+   std::vector<IntEbmType> m_classificationTargets;
+   std::vector<FloatEbmType> m_regressionTargets;
+   std::vector<FloatEbmType> m_predictorScores;
+   std::vector<IntEbmType> m_weights;
+
+   // if bDuplicate is true, each sample is repeated as many times as its weight instead of being weighted
+   WeightedData(
+      const ptrdiff_t learningTypeOrCountTargetClasses,
+      const size_t cSamplesUnique,
+      const size_t iSampleStart,
+      const bool bDuplicate
+   ) {
+      std::vector<IntEbmType> bins0;
+      std::vector<IntEbmType> bins1;
+      for(size_t iSampleUnique = 0; iSampleUnique < cSamplesUnique; ++iSampleUnique) {
+         const size_t iSample = iSampleStart + iSampleUnique;
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+         // every fourth sample has a weight of zero
+         const IntEbmType weight = static_cast<IntEbmType>(iSample * 3 % 4);
+         const size_t cCopies = bDuplicate ? static_cast<size_t>(weight) : size_t { 1 };
+         for(size_t iCopy = 0; iCopy < cCopies; ++iCopy) {
+            bins0.push_back(bin0);
+            bins1.push_back(bin1);
+            if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+               m_regressionTargets.push_back(static_cast<FloatEbmType>(bin0 * 3 - bin1 * 2) +
+                  static_cast<FloatEbmType>(iSample % 13) / FloatEbmType { 10 });
+            } else {
+               m_classificationTargets.push_back((bin0 + bin1 + static_cast<IntEbmType>(iSample % 11 / 9)) %
+                  static_cast<IntEbmType>(learningTypeOrCountTargetClasses));
+            }
+            if(!bDuplicate) {
+               m_weights.push_back(weight);
+            }
+         }
+      }
+      m_cSamples = bins0.size();
+      m_binnedData = bins0;
+      m_binnedData.insert(m_binnedData.end(), bins1.begin(), bins1.end());
+      const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+      m_predictorScores.resize(m_cSamples * cVectorLength);
+   }
+};
+
+static PEbmBoosting InitializeBoostingWeighted(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const WeightedData & training,
+   const WeightedData & validation,
+   const IntEbmType countInnerBags,
+   const std::vector<FloatEbmType> & optionalTempParams
+) {
+   const IntEbmType * const trainingWeights = training.m_weights.empty() ? nullptr : &training.m_weights[0];
+   const IntEbmType * const validationWeights = validation.m_weights.empty() ? nullptr : &validation.m_weights[0];
+   const FloatEbmType * const tempParams = optionalTempParams.empty() ? nullptr : &optionalTempParams[0];
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return InitializeBoostingRegressionWeighted(2, k_featuresWeighted, k_cFeatureGroupsWeighted, k_featureGroupsWeighted,
+         k_featureGroupIndexesWeighted, training.m_cSamples, &training.m_binnedData[0], &training.m_regressionTargets[0],
+         &training.m_predictorScores[0], trainingWeights, validation.m_cSamples, &validation.m_binnedData[0],
+         &validation.m_regressionTargets[0], &validation.m_predictorScores[0], validationWeights, countInnerBags, k_randomSeed,
+         tempParams);
+   }
+   return InitializeBoostingClassificationWeighted(learningTypeOrCountTargetClasses, 2, k_featuresWeighted, k_cFeatureGroupsWeighted,
+      k_featureGroupsWeighted, k_featureGroupIndexesWeighted, training.m_cSamples, &training.m_binnedData[0],
+      &training.m_classificationTargets[0], &training.m_predictorScores[0], trainingWeights, validation.m_cSamples,
+      &validation.m_binnedData[0], &validation.m_classificationTargets[0], &validation.m_predictorScores[0], validationWeights,
+      countInnerBags, k_randomSeed, tempParams);
+}
+
+static void CheckBoostSame(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses,
+   const PEbmBoosting ebmBoosting0, const PEbmBoosting ebmBoosting1) {
+   const size_t cVectorLength = 3 <= learningTypeOrCountTargetClasses ? static_cast<size_t>(learningTypeOrCountTargetClasses) : size_t { 1 };
+   CHECK(nullptr != ebmBoosting0);
+   CHECK(nullptr != ebmBoosting1);
+   if(nullptr == ebmBoosting0 || nullptr == ebmBoosting1) {
+      return;
+   }
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsWeighted; ++iFeatureGroup) {
+         FloatEbmType metric0 = 0;
+         FloatEbmType metric1 = 0;
+         CHECK(0 == BoostingStep(ebmBoosting0, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault, 3, nullptr,
+            nullptr, &metric0));
+         CHECK(0 == BoostingStep(ebmBoosting1, iFeatureGroup, k_learningRateDefault, k_countTreeSplitsMaxDefault, 3, nullptr,
+            nullptr, &metric1));
+         CHECK(std::abs(metric0 - metric1) < k_toleranceWeighted);
+      }
+   }
+   for(IntEbmType iFeatureGroup = 0; iFeatureGroup < k_cFeatureGroupsWeighted; ++iFeatureGroup) {
+      const FloatEbmType * const pModel0 = GetBestModelFeatureGroup(ebmBoosting0, iFeatureGroup);
+      const FloatEbmType * const pModel1 = GetBestModelFeatureGroup(ebmBoosting1, iFeatureGroup);
+      const size_t cScores = k_cTensorBinsWeighted[iFeatureGroup] * cVectorLength;
+      for(size_t iScore = 0; iScore < cScores; ++iScore) {
+         CHECK(std::abs(pModel0[iScore] - pModel1[iScore]) < k_toleranceWeighted);
+      }
+   }
+}
+
+static void CheckWeightedMatchesDuplicated(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   const WeightedData trainingWeighted(learningTypeOrCountTargetClasses, k_cTrainingSamplesWeighted, 0, false);
+   const WeightedData validationWeighted(learningTypeOrCountTargetClasses, k_cValidationSamplesWeighted, 1000, false);
+   const WeightedData trainingDuplicated(learningTypeOrCountTargetClasses, k_cTrainingSamplesWeighted, 0, true);
+   const WeightedData validationDuplicated(learningTypeOrCountTargetClasses, k_cValidationSamplesWeighted, 1000, true);
+
+   const PEbmBoosting ebmBoostingWeighted =
+      InitializeBoostingWeighted(learningTypeOrCountTargetClasses, trainingWeighted, validationWeighted, 0, {});
+   const PEbmBoosting ebmBoostingDuplicated =
+      InitializeBoostingWeighted(learningTypeOrCountTargetClasses, trainingDuplicated, validationDuplicated, 0, {});
+   CheckBoostSame(testCaseHidden, learningTypeOrCountTargetClasses, ebmBoostingWeighted, ebmBoostingDuplicated);
+   FreeBoosting(ebmBoostingWeighted);
+   FreeBoosting(ebmBoostingDuplicated);
+}
+
+static void CheckDeduplicatedMatchesOriginal(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   const WeightedData training(learningTypeOrCountTargetClasses, k_cTrainingSamplesWeighted, 0, true);
+   const WeightedData validation(learningTypeOrCountTargetClasses, k_cValidationSamplesWeighted, 1000, true);
+
+   const PEbmBoosting ebmBoostingOriginal = InitializeBoostingWeighted(learningTypeOrCountTargetClasses, training, validation, 0, {});
+   const PEbmBoosting ebmBoostingDeduplicated =
+      InitializeBoostingWeighted(learningTypeOrCountTargetClasses, training, validation, 0, k_tempParamsDeduplicate);
+   CheckBoostSame(testCaseHidden, learningTypeOrCountTargetClasses, ebmBoostingOriginal, ebmBoostingDeduplicated);
+   FreeBoosting(ebmBoostingOriginal);
+   FreeBoosting(ebmBoostingDeduplicated);
+}
+
+TEST_CASE("weighted samples boost the same as duplicated samples, regression") {
+   CheckWeightedMatchesDuplicated(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("weighted samples boost the same as duplicated samples, binary") {
+   CheckWeightedMatchesDuplicated(testCaseHidden, 2);
+}
+
+TEST_CASE("weighted samples boost the same as duplicated samples, multiclass") {
+   CheckWeightedMatchesDuplicated(testCaseHidden, 3);
+}
+
+TEST_CASE("deduplicated samples boost the same as the original samples, regression") {
+   CheckDeduplicatedMatchesOriginal(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("deduplicated samples boost the same as the original samples, binary") {
+   CheckDeduplicatedMatchesOriginal(testCaseHidden, 2);
+}
+
+TEST_CASE("deduplicated samples boost the same as the original samples, multiclass") {
+   CheckDeduplicatedMatchesOriginal(testCaseHidden, 3);
+}
+
+TEST_CASE("deduplicated samples with inner bags, boosting, binary") {
+   const WeightedData training(2, k_cTrainingSamplesWeighted, 0, true);
+   const WeightedData validation(2, k_cValidationSamplesWeighted, 1000, true);
+   // with and without replacement
+   std::vector<FloatEbmType> tempParams = k_tempParamsDeduplicate;
+   for(int iFraction = 0; iFraction < 2; ++iFraction) {
+      tempParams[TempParamBoostingFractionWithoutReplacement] = 0 == iFraction ? FloatEbmType { 0 } : FloatEbmType { 0.5 };
+      const PEbmBoosting ebmBoosting = InitializeBoostingWeighted(2, training, validation, 3, tempParams);
+      CHECK(nullptr != ebmBoosting);
+      if(nullptr != ebmBoosting) {
+         FloatEbmType metricPrev = std::numeric_limits<FloatEbmType>::max();
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            FloatEbmType metric = 0;
+            CHECK(0 == BoostingStep(ebmBoosting, 2, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+               k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metric));
+            CHECK(0 < metric && metric < metricPrev);
+            metricPrev = metric;
+         }
+         FreeBoosting(ebmBoosting);
+      }
+   }
+}
+
+TEST_CASE("weighted samples with invalid weights, boosting, regression") {
+   WeightedData training(k_learningTypeRegression, k_cTrainingSamplesWeighted, 0, false);
+   WeightedData validation(k_learningTypeRegression, k_cValidationSamplesWeighted, 1000, false);
+
+   training.m_weights[1] = -1;
+   CHECK(nullptr == InitializeBoostingWeighted(k_learningTypeRegression, training, validation, 0, {}));
+
+   for(IntEbmType & weight : training.m_weights) {
+      weight = 0;
+   }
+   CHECK(nullptr == InitializeBoostingWeighted(k_learningTypeRegression, training, validation, 0, {}));
+}
+
+TEST_CASE("weighted samples reject per step weights, boosting, regression") {
+   const WeightedData training(k_learningTypeRegression, k_cTrainingSamplesWeighted, 0, false);
+   const WeightedData validation(k_learningTypeRegression, k_cValidationSamplesWeighted, 1000, false);
+   const PEbmBoosting ebmBoosting = InitializeBoostingWeighted(k_learningTypeRegression, training, validation, 0, {});
+   CHECK(nullptr != ebmBoosting);
+   if(nullptr != ebmBoosting) {
+      const std::vector<FloatEbmType> weights(k_cTrainingSamplesWeighted, FloatEbmType { 1 });
+      FloatEbmType metric = 0;
+      CHECK(0 != BoostingStep(ebmBoosting, 0, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+         k_countSamplesRequiredForChildSplitMinDefault, &weights[0], nullptr, &metric));
+      CHECK(0 == BoostingStep(ebmBoosting, 0, k_learningRateDefault, k_countTreeSplitsMaxDefault,
+         k_countSamplesRequiredForChildSplitMinDefault, nullptr, nullptr, &metric));
+      FreeBoosting(ebmBoosting);
+   }
+}
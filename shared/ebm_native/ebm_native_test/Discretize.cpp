@@ -101,3 +101,55 @@ TEST_CASE("Discretize, increasing lengths") {
    delete[] singleFeatureDiscretized;
 }
 
+
+TEST_CASE("DiscretizeFeatures, column major") {
+   UNUSED(testCaseHidden);
+   // the last feature has enough cuts that the SIMD search tree no longer fits on the stack
+   constexpr size_t cBinCutsLarge = 3000;
+   constexpr IntEbmType cSamples = 5;
+   constexpr IntEbmType cFeatures = 3;
+
+   FloatEbmType binCutsLowerBoundInclusive[2 + cBinCutsLarge];
+   binCutsLowerBoundInclusive[0] = 1;
+   binCutsLowerBoundInclusive[1] = 2;
+   for(size_t iCut = 0; iCut < cBinCutsLarge; ++iCut) {
+      binCutsLowerBoundInclusive[2 + iCut] = static_cast<FloatEbmType>(iCut);
+   }
+   const IntEbmType countBinCuts[cFeatures] { 0, 2, static_cast<IntEbmType>(cBinCutsLarge) };
+
+   const FloatEbmType featureValues[cSamples * cFeatures] {
+      -1, std::numeric_limits<FloatEbmType>::quiet_NaN(), 0, 5, 1,
+      0.5, 1, 1.5, 2, std::numeric_limits<FloatEbmType>::quiet_NaN(),
+      -0.5, 0, 1234.5, 2999, std::numeric_limits<FloatEbmType>::quiet_NaN()
+   };
+   const IntEbmType expected[cSamples * cFeatures] {
+      0, 1, 0, 0, 0,
+      0, 1, 1, 2, 3,
+      0, 1, 1235, 3000, 3001
+   };
+
+   IntEbmType discretized[cSamples * cFeatures];
+   const IntEbmType ret = DiscretizeFeatures(
+      cSamples,
+      cFeatures,
+      featureValues,
+      countBinCuts,
+      binCutsLowerBoundInclusive,
+      discretized
+   );
+   CHECK(IntEbmType { 0 } == ret);
+   for(size_t i = 0; i < static_cast<size_t>(cSamples * cFeatures); ++i) {
+      CHECK(expected[i] == discretized[i]);
+   }
+
+   const IntEbmType countBinCutsNegative[cFeatures] { 0, -1, 2 };
+   const IntEbmType retNegative = DiscretizeFeatures(
+      cSamples,
+      cFeatures,
+      featureValues,
+      countBinCutsNegative,
+      binCutsLowerBoundInclusive,
+      discretized
+   );
+   CHECK(IntEbmType { 0 } != retNegative);
+}
@@ -66,6 +66,19 @@ extern int RegisterTestHidden(const TestCaseHidden & testCaseHidden) {
    return 0;
 }
 
+extern std::vector<FloatEbmType> MakeTempParams(const std::vector<TempParam> & params) {
+   IntEbmType cParams = 0;
+   for(const TempParam & param : params) {
+      cParams = std::max(cParams, param.m_iParam);
+   }
+   std::vector<FloatEbmType> tempParams(static_cast<size_t>(cParams) + 1, FloatEbmType { 0 });
+   tempParams[0] = static_cast<FloatEbmType>(cParams);
+   for(const TempParam & param : params) {
+      tempParams[static_cast<size_t>(param.m_iParam)] = param.m_value;
+   }
+   return tempParams;
+}
+
 extern bool IsApproxEqual(const double value, const double expected, const double percentage) {
    bool isEqual = false;
    if(!std::isnan(value)) {
@@ -616,7 +629,7 @@ void TestApi::AddValidationSamples(const std::vector<ClassificationSample> sampl
    m_stage = Stage::ValidationAdded;
 }
 
-void TestApi::InitializeBoosting(const IntEbmType countInnerBags) {
+void TestApi::InitializeBoosting(const IntEbmType countInnerBags, const std::vector<FloatEbmType> optionalTempParams) {
    if(Stage::ValidationAdded != m_stage) {
       exit(1);
    }
@@ -649,7 +662,7 @@ void TestApi::InitializeBoosting(const IntEbmType countInnerBags) {
          0 == m_validationClassificationTargets.size() ? nullptr : &m_validationPredictionScores[0],
          countInnerBags,
          k_randomSeed,
-         nullptr
+         0 == optionalTempParams.size() ? nullptr : &optionalTempParams[0]
       );
    } else if(k_learningTypeRegression == m_learningTypeOrCountTargetClasses) {
       if(m_bNullTrainingPredictionScores) {
@@ -674,7 +687,7 @@ void TestApi::InitializeBoosting(const IntEbmType countInnerBags) {
          0 == m_validationRegressionTargets.size() ? nullptr : &m_validationPredictionScores[0],
          countInnerBags,
          k_randomSeed,
-         nullptr
+         0 == optionalTempParams.size() ? nullptr : &optionalTempParams[0]
       );
    } else {
       exit(1);
@@ -734,6 +747,91 @@ FloatEbmType TestApi::Boost(
    return validationMetricOut;
 }
 
+PEbmWork TestApi::BoostAsync(
+   const IntEbmType indexFeatureGroup,
+   const FloatEbmType learningRate,
+   const IntEbmType countTreeSplitsMax,
+   const IntEbmType countSamplesRequiredForChildSplitMin
+) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   if(indexFeatureGroup < IntEbmType { 0 }) {
+      exit(1);
+   }
+   if(m_featureGroups.size() <= static_cast<size_t>(indexFeatureGroup)) {
+      exit(1);
+   }
+   if(std::isnan(learningRate)) {
+      exit(1);
+   }
+   if(std::isinf(learningRate)) {
+      exit(1);
+   }
+   if(countTreeSplitsMax < FloatEbmType { 0 }) {
+      exit(1);
+   }
+   if(countSamplesRequiredForChildSplitMin < FloatEbmType { 0 }) {
+      exit(1);
+   }
+
+   const PEbmWork work = BoostingStepAsync(
+      m_pEbmBoosting,
+      indexFeatureGroup,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      nullptr,
+      nullptr
+   );
+   if(nullptr == work) {
+      exit(1);
+   }
+   return work;
+}
+
+IntEbmType TestApi::BoostRun(
+   const IntEbmType countRoundsMax,
+   const IntEbmType earlyStoppingRounds,
+   const FloatEbmType earlyStoppingTolerance,
+   BOOSTING_PROGRESS_FUNCTION progressFunction,
+   void * const progressContext,
+   FloatEbmType * const validationMetricOut,
+   const FloatEbmType learningRate,
+   const IntEbmType countTreeSplitsMax,
+   const IntEbmType countSamplesRequiredForChildSplitMin
+) {
+   if(Stage::InitializedBoosting != m_stage) {
+      exit(1);
+   }
+   if(countRoundsMax < IntEbmType { 0 }) {
+      exit(1);
+   }
+
+   FloatEbmType validationMetric = FloatEbmType { 0 };
+   IntEbmType indexRound = IntEbmType { -1 };
+   const IntEbmType ret = BoostingRun(
+      m_pEbmBoosting,
+      countRoundsMax,
+      learningRate,
+      countTreeSplitsMax,
+      countSamplesRequiredForChildSplitMin,
+      earlyStoppingRounds,
+      earlyStoppingTolerance,
+      progressFunction,
+      progressContext,
+      &validationMetric,
+      &indexRound
+   );
+   if(0 != ret) {
+      exit(1);
+   }
+   if(nullptr != validationMetricOut) {
+      *validationMetricOut = validationMetric;
+   }
+   return indexRound;
+}
+
 FloatEbmType TestApi::GetBestModelPredictorScore(
    const size_t iFeatureGroup, 
    const std::vector<size_t> indexes, 
@@ -956,7 +1054,7 @@ void TestApi::AddInteractionSamples(const std::vector<ClassificationSample> samp
    m_stage = Stage::InteractionAdded;
 }
 
-void TestApi::InitializeInteraction() {
+void TestApi::InitializeInteraction(const std::vector<FloatEbmType> optionalTempParams) {
    if(Stage::InteractionAdded != m_stage) {
       exit(1);
    }
@@ -974,7 +1072,7 @@ void TestApi::InitializeInteraction() {
          0 == m_interactionBinnedData.size() ? nullptr : &m_interactionBinnedData[0],
          0 == m_interactionClassificationTargets.size() ? nullptr : &m_interactionClassificationTargets[0],
          0 == m_interactionClassificationTargets.size() ? nullptr : &m_interactionPredictionScores[0],
-         nullptr
+         0 == optionalTempParams.size() ? nullptr : &optionalTempParams[0]
       );
    } else if(k_learningTypeRegression == m_learningTypeOrCountTargetClasses) {
       if(m_bNullInteractionPredictionScores) {
@@ -987,7 +1085,7 @@ void TestApi::InitializeInteraction() {
          0 == m_interactionBinnedData.size() ? nullptr : &m_interactionBinnedData[0],
          0 == m_interactionRegressionTargets.size() ? nullptr : &m_interactionRegressionTargets[0],
          0 == m_interactionRegressionTargets.size() ? nullptr : &m_interactionPredictionScores[0],
-         nullptr
+         0 == optionalTempParams.size() ? nullptr : &optionalTempParams[0]
       );
    } else {
       exit(1);
@@ -1029,6 +1127,82 @@ FloatEbmType TestApi::InteractionScore(
    return interactionScoreOut;
 }
 
+std::vector<FloatEbmType> TestApi::InteractionScorePairs(
+   const std::vector<IntEbmType> featureIndexPairs,
+   const IntEbmType countSamplesRequiredForChildSplitMin
+) const {
+   if(Stage::InitializedInteraction != m_stage) {
+      exit(1);
+   }
+   if(0 != featureIndexPairs.size() % 2) {
+      exit(1);
+   }
+   for(const IntEbmType oneFeatureIndex : featureIndexPairs) {
+      if(oneFeatureIndex < IntEbmType { 0 }) {
+         exit(1);
+      }
+      if(m_features.size() <= static_cast<size_t>(oneFeatureIndex)) {
+         exit(1);
+      }
+   }
+
+   std::vector<FloatEbmType> interactionScoresOut(featureIndexPairs.size() / 2);
+   const IntEbmType ret = CalculateInteractionScorePairs(
+      m_pEbmInteraction,
+      interactionScoresOut.size(),
+      0 == featureIndexPairs.size() ? nullptr : &featureIndexPairs[0],
+      countSamplesRequiredForChildSplitMin,
+      0 == interactionScoresOut.size() ? nullptr : &interactionScoresOut[0]
+   );
+   if(0 != ret) {
+      exit(1);
+   }
+   return interactionScoresOut;
+}
+
+std::vector<IntEbmType> TestApi::InteractionScoreTopPairs(
+   const std::vector<IntEbmType> featureIndexPairs,
+   const IntEbmType countTopPairs,
+   std::vector<FloatEbmType> & topInteractionScoresOut,
+   const IntEbmType countSamplesRequiredForChildSplitMin
+) const {
+   if(Stage::InitializedInteraction != m_stage) {
+      exit(1);
+   }
+   if(0 != featureIndexPairs.size() % 2) {
+      exit(1);
+   }
+   if(countTopPairs < IntEbmType { 0 }) {
+      exit(1);
+   }
+   for(const IntEbmType oneFeatureIndex : featureIndexPairs) {
+      if(oneFeatureIndex < IntEbmType { 0 }) {
+         exit(1);
+      }
+      if(m_features.size() <= static_cast<size_t>(oneFeatureIndex)) {
+         exit(1);
+      }
+   }
+
+   const size_t cPairs = featureIndexPairs.size() / 2;
+   const size_t cTopPairs = cPairs < static_cast<size_t>(countTopPairs) ? cPairs : static_cast<size_t>(countTopPairs);
+   std::vector<IntEbmType> topPairIndexesOut(cTopPairs);
+   topInteractionScoresOut.resize(cTopPairs);
+   const IntEbmType ret = CalculateInteractionScoreTopPairs(
+      m_pEbmInteraction,
+      cPairs,
+      0 == featureIndexPairs.size() ? nullptr : &featureIndexPairs[0],
+      countSamplesRequiredForChildSplitMin,
+      countTopPairs,
+      0 == cTopPairs ? nullptr : &topPairIndexesOut[0],
+      0 == cTopPairs ? nullptr : &topInteractionScoresOut[0]
+   );
+   if(0 != ret) {
+      exit(1);
+   }
+   return topPairIndexesOut;
+}
+
 extern void DisplayCuts(
    IntEbmType countSamples,
    FloatEbmType * featureValues,
@@ -18,7 +18,19 @@ enum class TestPriority {
    BoostingUnusualInputs,
    InteractionUnusualInputs,
    Rehydration,
-   BitPackingExtremes
+   BitPackingExtremes,
+   BoostingAsync,
+   BoostingParallel,
+   PredictBatch,
+   BoostingPacked,
+   BoostingWeighted,
+   BoostingRun,
+   BoostingDeferredValidation,
+   BoostingCheckpoint,
+   BoostingWarmStart,
+   BoostingAppend,
+   QuantileSketch,
+   LogBuffer
 };
 
 class TestCaseHidden;
@@ -126,6 +138,27 @@ enum class FeatureType : IntEbmType {
    Ordinal = FeatureTypeOrdinal, Nominal = FeatureTypeNominal
 };
 
+// one entry for MakeTempParams.  iParam is one of the TempParam* indexes in ebm_native.h
+class TempParam final {
+public:
+
+   const IntEbmType m_iParam;
+   const FloatEbmType m_value;
+
+   inline TempParam(const IntEbmType iParam, const FloatEbmType value) :
+      m_iParam(iParam),
+      m_value(value) {
+      if(iParam < 1) {
+         exit(1);
+      }
+   }
+};
+
+// builds an optionalTempParams array from parameters set by name, like 
+// MakeTempParams({ { TempParamBoostingCountShards, 3 }, { TempParamBoostingCacheDenominators, 1 } }).  The parameters 
+// that aren't listed are 0, which means their default
+std::vector<FloatEbmType> MakeTempParams(const std::vector<TempParam> & params);
+
 class FeatureTest final {
 public:
 
@@ -273,13 +306,20 @@ public:
       return m_featureGroups.size();
    }
 
+   inline PEbmBoosting GetBoosting() const {
+      return m_pEbmBoosting;
+   }
+
    void AddFeatures(const std::vector<FeatureTest> features);
    void AddFeatureGroups(const std::vector<std::vector<size_t>> featureGroups);
    void AddTrainingSamples(const std::vector<RegressionSample> samples);
    void AddTrainingSamples(const std::vector<ClassificationSample> samples);
    void AddValidationSamples(const std::vector<RegressionSample> samples);
    void AddValidationSamples(const std::vector<ClassificationSample> samples);
-   void InitializeBoosting(const IntEbmType countInnerBags = k_countInnerBagsDefault);
+   void InitializeBoosting(
+      const IntEbmType countInnerBags = k_countInnerBagsDefault, 
+      const std::vector<FloatEbmType> optionalTempParams = {}
+   );
    FloatEbmType Boost(const IntEbmType indexFeatureGroup, 
       const std::vector<FloatEbmType> trainingWeights = {}, 
       const std::vector<FloatEbmType> validationWeights = {}, 
@@ -287,6 +327,23 @@ public:
       const IntEbmType countTreeSplitsMax = k_countTreeSplitsMaxDefault, 
       const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
    );
+   PEbmWork BoostAsync(const IntEbmType indexFeatureGroup,
+      const FloatEbmType learningRate = k_learningRateDefault,
+      const IntEbmType countTreeSplitsMax = k_countTreeSplitsMaxDefault,
+      const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
+   );
+   // returns the index of the last round that BoostingRun completed
+   IntEbmType BoostRun(
+      const IntEbmType countRoundsMax,
+      const IntEbmType earlyStoppingRounds,
+      const FloatEbmType earlyStoppingTolerance,
+      BOOSTING_PROGRESS_FUNCTION progressFunction = nullptr,
+      void * const progressContext = nullptr,
+      FloatEbmType * const validationMetricOut = nullptr,
+      const FloatEbmType learningRate = k_learningRateDefault,
+      const IntEbmType countTreeSplitsMax = k_countTreeSplitsMaxDefault,
+      const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
+   );
    FloatEbmType GetBestModelPredictorScore(
       const size_t iFeatureGroup, 
       const std::vector<size_t> indexes, 
@@ -301,11 +358,22 @@ public:
    const FloatEbmType * GetCurrentModelFeatureGroupRaw(const size_t iFeatureGroup) const;
    void AddInteractionSamples(const std::vector<RegressionSample> samples);
    void AddInteractionSamples(const std::vector<ClassificationSample> samples);
-   void InitializeInteraction();
+   void InitializeInteraction(const std::vector<FloatEbmType> optionalTempParams = {});
    FloatEbmType InteractionScore(
       const std::vector<IntEbmType> featuresInGroup, 
       const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
    ) const;
+   std::vector<FloatEbmType> InteractionScorePairs(
+      const std::vector<IntEbmType> featureIndexPairs,
+      const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
+   ) const;
+   // returns the indexes of the best pairs and puts their scores into topInteractionScoresOut
+   std::vector<IntEbmType> InteractionScoreTopPairs(
+      const std::vector<IntEbmType> featureIndexPairs,
+      const IntEbmType countTopPairs,
+      std::vector<FloatEbmType> & topInteractionScoresOut,
+      const IntEbmType countSamplesRequiredForChildSplitMin = k_countSamplesRequiredForChildSplitMinDefault
+   ) const;
 };
 
 void DisplayCuts(
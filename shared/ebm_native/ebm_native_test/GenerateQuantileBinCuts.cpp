@@ -1228,6 +1228,121 @@ TEST_CASE("GenerateQuantileBinCuts, maximum non-overflow interpretable ends") {
    );
 }
 
+// the humanized cut between two values goes through our string formatting and parsing, so unlike 
+// TestQuantileBinning we require the cut to come back bit for bit
+static void TestInterpretableCutRoundTrip(
+   TestCaseHidden & testCaseHidden,
+   const bool bTestReverse,
+   const FloatEbmType low,
+   const FloatEbmType high,
+   const FloatEbmType expectedCut
+) {
+   for(int iDirection = 0; iDirection < (bTestReverse ? 2 : 1); ++iDirection) {
+      FloatEbmType featureValues[2];
+      featureValues[0] = 0 == iDirection ? low : -high;
+      featureValues[1] = 0 == iDirection ? high : -low;
+
+      IntEbmType countBinCuts = 2;
+      FloatEbmType binCutsLowerBoundInclusive[2];
+      IntEbmType countMissingValues;
+      FloatEbmType minNonInfinityValue;
+      IntEbmType countNegativeInfinity;
+      FloatEbmType maxNonInfinityValue;
+      IntEbmType countPositiveInfinity;
+
+      const IntEbmType ret = GenerateQuantileBinCuts(
+         2,
+         featureValues,
+         1,
+         EBM_TRUE,
+         k_randomSeed,
+         &countBinCuts,
+         binCutsLowerBoundInclusive,
+         &countMissingValues,
+         &minNonInfinityValue,
+         &countNegativeInfinity,
+         &maxNonInfinityValue,
+         &countPositiveInfinity
+      );
+      CHECK(0 == ret);
+      CHECK(1 == countBinCuts);
+      if(1 == countBinCuts) {
+         CHECK((0 == iDirection ? expectedCut : -expectedCut) == binCutsLowerBoundInclusive[0]);
+      }
+   }
+}
+
+TEST_CASE("GenerateQuantileBinCuts, round trip denormals") {
+   const FloatEbmType denormMin = std::numeric_limits<FloatEbmType>::denorm_min();
+   const FloatEbmType normalMin = std::numeric_limits<FloatEbmType>::min();
+
+   TestInterpretableCutRoundTrip(testCaseHidden, true, denormMin, denormMin * 2, denormMin * 2);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, denormMin, denormMin * 3, denormMin * 2);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, normalMin / 2, normalMin, 1.7000000000000002e-308);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, std::nextafter(normalMin, FloatEbmType { 0 }), normalMin, normalMin);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, normalMin, normalMin * 2, 3.3000000000000003e-308);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, normalMin, std::nextafter(normalMin, FloatEbmType { 1 }), 
+      std::nextafter(normalMin, FloatEbmType { 1 }));
+}
+
+TEST_CASE("GenerateQuantileBinCuts, round trip signed zeros") {
+   const FloatEbmType denormMin = std::numeric_limits<FloatEbmType>::denorm_min();
+   const FloatEbmType negativeZero = -FloatEbmType { 0 };
+
+   // a range that straddles zero cuts at zero, so these are not symmetric when reversed
+   TestInterpretableCutRoundTrip(testCaseHidden, false, FloatEbmType { 0 }, denormMin, denormMin);
+   TestInterpretableCutRoundTrip(testCaseHidden, false, negativeZero, denormMin, denormMin);
+   TestInterpretableCutRoundTrip(testCaseHidden, false, -denormMin, negativeZero, FloatEbmType { 0 });
+   TestInterpretableCutRoundTrip(testCaseHidden, false, negativeZero, std::numeric_limits<FloatEbmType>::min(), 
+      1.0000000000000004e-308);
+   TestInterpretableCutRoundTrip(testCaseHidden, false, negativeZero, FloatEbmType { 1 }, FloatEbmType { 0.5 });
+   TestInterpretableCutRoundTrip(testCaseHidden, false, FloatEbmType { -1 }, negativeZero, FloatEbmType { -0.5 });
+}
+
+TEST_CASE("GenerateQuantileBinCuts, round trip max and lowest") {
+   const FloatEbmType max = std::numeric_limits<FloatEbmType>::max();
+   const FloatEbmType lowest = std::numeric_limits<FloatEbmType>::lowest();
+
+   // neighbouring values at the ends cut on the value with the larger magnitude, so each of these is the reverse of
+   // the other
+   TestInterpretableCutRoundTrip(testCaseHidden, false, std::nextafter(max, FloatEbmType { 0 }), max, max);
+   TestInterpretableCutRoundTrip(testCaseHidden, false, lowest, std::nextafter(lowest, FloatEbmType { 0 }), lowest);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, FloatEbmType { 1 }, max, 1e+154);
+   TestInterpretableCutRoundTrip(testCaseHidden, false, lowest, max, FloatEbmType { 0 });
+}
+
+TEST_CASE("GenerateQuantileBinCuts, round trip halfway cases") {
+   // 1 + 2^-17 and 1 + 3 * 2^-17 need 18 digits that end in 5, so printing them with 17 digits is a tie that 
+   // rounds down to an even digit for the first and up to an even digit for the second
+   const FloatEbmType tieEven = FloatEbmType { 1 } + std::ldexp(FloatEbmType { 1 }, -17);
+   const FloatEbmType tieOdd = FloatEbmType { 1 } + FloatEbmType { 3 } * std::ldexp(FloatEbmType { 1 }, -17);
+
+   TestInterpretableCutRoundTrip(testCaseHidden, true, tieEven, tieOdd, 1.0000150000000001);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, tieEven, std::nextafter(tieEven, FloatEbmType { 2 }), 
+      std::nextafter(tieEven, FloatEbmType { 2 }));
+   TestInterpretableCutRoundTrip(testCaseHidden, true, tieOdd, std::nextafter(tieOdd, FloatEbmType { 2 }), 
+      std::nextafter(tieOdd, FloatEbmType { 2 }));
+   // averages that land exactly halfway between two shorter strings
+   TestInterpretableCutRoundTrip(testCaseHidden, true, FloatEbmType { 0.5 }, FloatEbmType { 1.5 }, FloatEbmType { 1 });
+   TestInterpretableCutRoundTrip(testCaseHidden, true, FloatEbmType { 2.5 }, FloatEbmType { 3.5 }, FloatEbmType { 3 });
+   TestInterpretableCutRoundTrip(testCaseHidden, true, FloatEbmType { 0.1 }, FloatEbmType { 0.2 }, 0.15000000000000002);
+}
+
+TEST_CASE("GenerateQuantileBinCuts, round trip at the limits of exact integers and powers of ten") {
+   const FloatEbmType two53 = std::ldexp(FloatEbmType { 1 }, 53);
+   const FloatEbmType two64 = std::ldexp(FloatEbmType { 1 }, 64);
+
+   TestInterpretableCutRoundTrip(testCaseHidden, true, two53, two53 + FloatEbmType { 2 }, two53 + FloatEbmType { 2 });
+   TestInterpretableCutRoundTrip(testCaseHidden, true, std::ldexp(FloatEbmType { 1 }, 63), two64, 1.4e+19);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, std::nextafter(two64, FloatEbmType { 0 }), two64, two64);
+   TestInterpretableCutRoundTrip(testCaseHidden, true, std::nextafter(FloatEbmType { 1e17 }, FloatEbmType { 0 }), 
+      FloatEbmType { 1e17 }, FloatEbmType { 1e17 });
+   TestInterpretableCutRoundTrip(testCaseHidden, true, std::nextafter(FloatEbmType { 1e22 }, FloatEbmType { 0 }), 
+      FloatEbmType { 1e22 }, FloatEbmType { 1e22 });
+   TestInterpretableCutRoundTrip(testCaseHidden, true, FloatEbmType { 1e22 }, FloatEbmType { 1e23 }, 
+      5.0000000000000004e+22);
+}
+
 TEST_CASE("GenerateQuantileBinCuts, stress test the guarantee of one split per SplittingRange, by 2") {
    constexpr IntEbmType countSamplesPerBinMin = 1;
    constexpr size_t cItemsPerRange = 10;
@@ -1599,3 +1714,211 @@ TEST_CASE("GenerateQuantileBinCuts, chunky randomized check") {
    }
 }
 
+
+static void CheckBinCutsFeaturesMatchesSingleFeature(
+   TestCaseHidden & testCaseHidden,
+   const IntEbmType binningType,
+   const IntEbmType isHumanized
+) {
+   constexpr size_t cSamples = 97;
+   constexpr size_t cFeatures = 11;
+   const IntEbmType countSamplesPerBinMin = 3;
+
+   std::vector<FloatEbmType> featureValues;
+   std::vector<IntEbmType> countBinCutsMax;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+         FloatEbmType val = static_cast<FloatEbmType>((iSample * (iFeature * 7 + 3)) % (iFeature * 5 + 2)) * 
+            static_cast<FloatEbmType>(0.25) - static_cast<FloatEbmType>(iFeature);
+         if(0 == (iSample + iFeature) % 13) {
+            val = std::numeric_limits<FloatEbmType>::quiet_NaN();
+         } else if(0 == (iSample + iFeature) % 29) {
+            val = std::numeric_limits<FloatEbmType>::infinity();
+         } else if(3 == iFeature) {
+            // a feature with nothing but missing values
+            val = std::numeric_limits<FloatEbmType>::quiet_NaN();
+         }
+         featureValues.push_back(val);
+      }
+      // vary the maximums so that the cuts have to be moved to pack them, including a feature without any cut room
+      countBinCutsMax.push_back(static_cast<IntEbmType>(iFeature % 4 * 3));
+   }
+   const std::vector<FloatEbmType> featureValuesOriginal(featureValues);
+
+   IntEbmType cBinCutsTotal = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      cBinCutsTotal += countBinCutsMax[iFeature];
+   }
+   std::vector<IntEbmType> countBinCuts(countBinCutsMax);
+   std::vector<FloatEbmType> binCuts(static_cast<size_t>(cBinCutsTotal), 0);
+   std::vector<IntEbmType> countMissingValues(cFeatures);
+   std::vector<FloatEbmType> minNonInfinityValue(cFeatures);
+   std::vector<IntEbmType> countNegativeInfinity(cFeatures);
+   std::vector<FloatEbmType> maxNonInfinityValue(cFeatures);
+   std::vector<IntEbmType> countPositiveInfinity(cFeatures);
+   const IntEbmType ret = GenerateBinCutsFeatures(
+      binningType,
+      static_cast<IntEbmType>(cSamples),
+      static_cast<IntEbmType>(cFeatures),
+      &featureValues[0],
+      countSamplesPerBinMin,
+      isHumanized,
+      k_randomSeed,
+      &countBinCuts[0],
+      &binCuts[0],
+      &countMissingValues[0],
+      &minNonInfinityValue[0],
+      &countNegativeInfinity[0],
+      &maxNonInfinityValue[0],
+      &countPositiveInfinity[0]
+   );
+   CHECK(0 == ret);
+   // the batched function copies the values before sorting them
+   for(size_t iValue = 0; iValue < featureValues.size(); ++iValue) {
+      CHECK(std::isnan(featureValuesOriginal[iValue]) && std::isnan(featureValues[iValue]) || 
+         featureValuesOriginal[iValue] == featureValues[iValue]);
+   }
+
+   size_t iBinCut = 0;
+   for(size_t iFeature = 0; iFeature < cFeatures; ++iFeature) {
+      std::vector<FloatEbmType> featureValuesSingle(featureValuesOriginal.begin() + iFeature * cSamples, 
+         featureValuesOriginal.begin() + (iFeature + 1) * cSamples);
+      IntEbmType countBinCutsSingle = countBinCutsMax[iFeature];
+      std::vector<FloatEbmType> binCutsSingle(static_cast<size_t>(countBinCutsSingle) + 1, 0);
+      IntEbmType countMissingValuesSingle;
+      FloatEbmType minNonInfinityValueSingle;
+      IntEbmType countNegativeInfinitySingle;
+      FloatEbmType maxNonInfinityValueSingle;
+      IntEbmType countPositiveInfinitySingle;
+      IntEbmType retSingle = 0;
+      if(BinningTypeQuantile == binningType) {
+         retSingle = GenerateQuantileBinCuts(static_cast<IntEbmType>(cSamples), &featureValuesSingle[0], countSamplesPerBinMin,
+            isHumanized, k_randomSeed, &countBinCutsSingle, &binCutsSingle[0], &countMissingValuesSingle,
+            &minNonInfinityValueSingle, &countNegativeInfinitySingle, &maxNonInfinityValueSingle, &countPositiveInfinitySingle);
+      } else if(BinningTypeWinsorized == binningType) {
+         retSingle = GenerateWinsorizedBinCuts(static_cast<IntEbmType>(cSamples), &featureValuesSingle[0], &countBinCutsSingle,
+            &binCutsSingle[0], &countMissingValuesSingle, &minNonInfinityValueSingle, &countNegativeInfinitySingle,
+            &maxNonInfinityValueSingle, &countPositiveInfinitySingle);
+      } else {
+         GenerateUniformBinCuts(static_cast<IntEbmType>(cSamples), &featureValuesSingle[0], &countBinCutsSingle,
+            &binCutsSingle[0], &countMissingValuesSingle, &minNonInfinityValueSingle, &countNegativeInfinitySingle,
+            &maxNonInfinityValueSingle, &countPositiveInfinitySingle);
+      }
+      CHECK(0 == retSingle);
+
+      CHECK(countBinCutsSingle == countBinCuts[iFeature]);
+      CHECK(countMissingValuesSingle == countMissingValues[iFeature]);
+      CHECK(minNonInfinityValueSingle == minNonInfinityValue[iFeature]);
+      CHECK(countNegativeInfinitySingle == countNegativeInfinity[iFeature]);
+      CHECK(maxNonInfinityValueSingle == maxNonInfinityValue[iFeature]);
+      CHECK(countPositiveInfinitySingle == countPositiveInfinity[iFeature]);
+      if(countBinCutsSingle == countBinCuts[iFeature]) {
+         for(IntEbmType iCut = 0; iCut < countBinCutsSingle; ++iCut) {
+            CHECK(binCutsSingle[static_cast<size_t>(iCut)] == binCuts[iBinCut]);
+            ++iBinCut;
+         }
+      }
+   }
+}
+
+TEST_CASE("GenerateBinCutsFeatures, matches GenerateQuantileBinCuts") {
+   CheckBinCutsFeaturesMatchesSingleFeature(testCaseHidden, BinningTypeQuantile, EBM_FALSE);
+}
+
+TEST_CASE("GenerateBinCutsFeatures, matches GenerateQuantileBinCuts, humanized") {
+   CheckBinCutsFeaturesMatchesSingleFeature(testCaseHidden, BinningTypeQuantile, EBM_TRUE);
+}
+
+TEST_CASE("GenerateBinCutsFeatures, matches GenerateWinsorizedBinCuts") {
+   CheckBinCutsFeaturesMatchesSingleFeature(testCaseHidden, BinningTypeWinsorized, EBM_FALSE);
+}
+
+TEST_CASE("GenerateBinCutsFeatures, matches GenerateUniformBinCuts") {
+   CheckBinCutsFeaturesMatchesSingleFeature(testCaseHidden, BinningTypeUniform, EBM_FALSE);
+}
+
+TEST_CASE("GenerateBinCutsFeatures, zero features") {
+   const IntEbmType ret = GenerateBinCutsFeatures(BinningTypeQuantile, 10, 0, nullptr, 1, EBM_FALSE, k_randomSeed,
+      nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+   CHECK(0 == ret);
+}
+
+TEST_CASE("GenerateBinCutsFeatures, invalid parameters") {
+   const std::vector<FloatEbmType> featureValues { 1, 2, 3, 4, 5, 6 };
+   std::vector<IntEbmType> countBinCuts { 2, 2 };
+   std::vector<FloatEbmType> binCuts(4);
+
+   CHECK(0 != GenerateBinCutsFeatures(99, 3, 2, &featureValues[0], 1, EBM_FALSE, k_randomSeed,
+      &countBinCuts[0], &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr));
+   CHECK(0 != GenerateBinCutsFeatures(BinningTypeQuantile, -1, 2, &featureValues[0], 1, EBM_FALSE, k_randomSeed,
+      &countBinCuts[0], &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr));
+   CHECK(0 != GenerateBinCutsFeatures(BinningTypeQuantile, 3, 2, &featureValues[0], 1, EBM_FALSE, k_randomSeed,
+      nullptr, &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr));
+   CHECK(0 != GenerateBinCutsFeatures(BinningTypeQuantile, 3, 2, &featureValues[0], 1, EBM_FALSE, k_randomSeed,
+      &countBinCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr, nullptr));
+   countBinCuts[1] = -1;
+   CHECK(0 != GenerateBinCutsFeatures(BinningTypeQuantile, 3, 2, &featureValues[0], 1, EBM_FALSE, k_randomSeed,
+      &countBinCuts[0], &binCuts[0], nullptr, nullptr, nullptr, nullptr, nullptr));
+}
+
+TEST_CASE("GenerateQuantileBinCuts, large column order doesn't matter") {
+   // large enough to use the radix sort, with negatives, both zeros, duplicates, infinities and missing values
+   constexpr size_t cSamples = 20011;
+   constexpr IntEbmType countBinCutsMax = 50;
+
+   std::vector<FloatEbmType> featureValuesAscending;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      FloatEbmType val = static_cast<FloatEbmType>(static_cast<ptrdiff_t>(iSample / 3) - 3000) * 
+         static_cast<FloatEbmType>(0.125);
+      if(0 == iSample % 17) {
+         val = -val;
+      }
+      featureValuesAscending.push_back(val);
+   }
+   featureValuesAscending.push_back(-std::numeric_limits<FloatEbmType>::infinity());
+   featureValuesAscending.push_back(std::numeric_limits<FloatEbmType>::infinity());
+   featureValuesAscending.push_back(-FloatEbmType { 0 });
+   std::sort(featureValuesAscending.begin(), featureValuesAscending.end());
+   featureValuesAscending.push_back(std::numeric_limits<FloatEbmType>::quiet_NaN());
+
+   const size_t cValues = featureValuesAscending.size();
+   std::vector<FloatEbmType> featureValuesShuffled;
+   for(size_t i = 0; i < cValues; ++i) {
+      // 7919 is prime and doesn't divide cValues, so this visits every value once
+      featureValuesShuffled.push_back(featureValuesAscending[i * 7919 % cValues]);
+   }
+   std::vector<FloatEbmType> featureValuesDescending(featureValuesAscending.rbegin(), featureValuesAscending.rend());
+
+   const std::vector<FloatEbmType> * const apFeatureValues[] = { 
+      &featureValuesAscending, &featureValuesShuffled, &featureValuesDescending };
+
+   std::vector<FloatEbmType> binCutsExpected;
+   for(const std::vector<FloatEbmType> * const pFeatureValues : apFeatureValues) {
+      std::vector<FloatEbmType> featureValues(*pFeatureValues);
+      IntEbmType countBinCuts = countBinCutsMax;
+      std::vector<FloatEbmType> binCuts(static_cast<size_t>(countBinCutsMax));
+      IntEbmType countMissingValues;
+      FloatEbmType minNonInfinityValue;
+      IntEbmType countNegativeInfinity;
+      FloatEbmType maxNonInfinityValue;
+      IntEbmType countPositiveInfinity;
+
+      const IntEbmType ret = GenerateQuantileBinCuts(static_cast<IntEbmType>(cValues), &featureValues[0], 3, EBM_FALSE,
+         k_randomSeed, &countBinCuts, &binCuts[0], &countMissingValues, &minNonInfinityValue, &countNegativeInfinity,
+         &maxNonInfinityValue, &countPositiveInfinity);
+      CHECK(0 == ret);
+      CHECK(1 == countMissingValues);
+      CHECK(1 == countNegativeInfinity);
+      CHECK(1 == countPositiveInfinity);
+      CHECK(2 <= countBinCuts);
+      binCuts.resize(static_cast<size_t>(countBinCuts));
+      for(size_t iCut = 1; iCut < binCuts.size(); ++iCut) {
+         CHECK(binCuts[iCut - 1] < binCuts[iCut]);
+      }
+      if(binCutsExpected.empty()) {
+         binCutsExpected = binCuts;
+      } else {
+         CHECK(binCutsExpected == binCuts);
+      }
+   }
+}
@@ -135,3 +135,461 @@ TEST_CASE("FeatureGroup with one feature with one state, interaction, multiclass
 }
 
 
+TEST_CASE("FeatureGroup with three features, interaction, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2), FeatureTest(4) });
+   std::vector<RegressionSample> samples;
+   for(IntEbmType iSample = 0; iSample < 96; ++iSample) {
+      const IntEbmType bin0 = iSample % 3;
+      const IntEbmType bin1 = iSample / 3 % 2;
+      const IntEbmType bin2 = iSample / 6 % 4;
+      const FloatEbmType target = 0 == bin0 && 1 == bin1 && 2 <= bin2 ? FloatEbmType { 10 } : FloatEbmType { 0 };
+      samples.push_back(RegressionSample(target + static_cast<FloatEbmType>(iSample % 5), { bin0, bin1, bin2 }));
+   }
+   test.AddInteractionSamples(samples);
+   test.InitializeInteraction();
+
+   const FloatEbmType metricReturn = test.InteractionScore({ 0, 1, 2 });
+   CHECK(0 < metricReturn);
+   // the score shouldn't depend on the order of the features
+   CHECK_APPROX(metricReturn, test.InteractionScore({ 2, 0, 1 }));
+   CHECK_APPROX(metricReturn, test.InteractionScore({ 1, 2, 0 }));
+}
+
+TEST_CASE("FeatureGroup with three features, interaction, binary") {
+   TestApi test = TestApi(2, 0);
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2), FeatureTest(4) });
+   std::vector<ClassificationSample> samples;
+   for(IntEbmType iSample = 0; iSample < 96; ++iSample) {
+      const IntEbmType bin0 = iSample % 3;
+      const IntEbmType bin1 = iSample / 3 % 2;
+      const IntEbmType bin2 = iSample / 6 % 4;
+      const IntEbmType target = (0 == bin0 && 1 == bin1 && 2 <= bin2) || 0 == iSample % 7 ? 1 : 0;
+      samples.push_back(ClassificationSample(target, { bin0, bin1, bin2 }));
+   }
+   test.AddInteractionSamples(samples);
+   test.InitializeInteraction();
+
+   const FloatEbmType metricReturn = test.InteractionScore({ 0, 1, 2 });
+   CHECK(0 < metricReturn);
+   // the score shouldn't depend on the order of the features
+   CHECK_APPROX(metricReturn, test.InteractionScore({ 2, 0, 1 }));
+}
+
+TEST_CASE("FeatureGroup with four features, interaction, multiclass") {
+   TestApi test = TestApi(3);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(3), FeatureTest(2), FeatureTest(3) });
+   std::vector<ClassificationSample> samples;
+   for(IntEbmType iSample = 0; iSample < 144; ++iSample) {
+      const IntEbmType bin0 = iSample % 2;
+      const IntEbmType bin1 = iSample / 2 % 3;
+      const IntEbmType bin2 = iSample / 6 % 2;
+      const IntEbmType bin3 = iSample / 12 % 3;
+      samples.push_back(ClassificationSample((bin0 + bin1 * bin2 + bin3 + iSample % 5 / 4) % 3, { bin0, bin1, bin2, bin3 }));
+   }
+   test.AddInteractionSamples(samples);
+   test.InitializeInteraction();
+
+   const FloatEbmType metricReturn = test.InteractionScore({ 0, 1, 2, 3 }, 1);
+   CHECK(0 < metricReturn);
+   // the score shouldn't depend on the order of the features
+   CHECK_APPROX(metricReturn, test.InteractionScore({ 3, 2, 1, 0 }, 1));
+}
+
+static void CheckInteractionScorePairs(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   // the feature with 1 bin can't have any interactions
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2), FeatureTest(4), FeatureTest(1), FeatureTest(5) });
+   std::vector<RegressionSample> regressionSamples;
+   std::vector<ClassificationSample> classificationSamples;
+   for(IntEbmType iSample = 0; iSample < 120; ++iSample) {
+      const IntEbmType bin0 = iSample % 3;
+      const IntEbmType bin1 = iSample / 3 % 2;
+      const IntEbmType bin2 = iSample / 6 % 4;
+      const IntEbmType bin4 = iSample * 7 % 5;
+      const std::vector<IntEbmType> binnedFeatureValues { bin0, bin1, bin2, 0, bin4 };
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         const FloatEbmType target = static_cast<FloatEbmType>(bin0 * bin2 + bin1 * bin4 + iSample % 5);
+         regressionSamples.push_back(RegressionSample(target, binnedFeatureValues));
+      } else {
+         const IntEbmType target = (bin0 * bin2 + bin1 * bin4 + iSample % 7 / 6) % learningTypeOrCountTargetClasses;
+         classificationSamples.push_back(ClassificationSample(target, binnedFeatureValues));
+      }
+   }
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      test.AddInteractionSamples(regressionSamples);
+   } else {
+      test.AddInteractionSamples(classificationSamples);
+   }
+   test.InitializeInteraction();
+
+   // every ordered pair, including pairs of a feature with itself, and then enough repeats of the first feature that 
+   // its pairs need more than one scan
+   std::vector<IntEbmType> featureIndexPairs;
+   for(IntEbmType iFeature0 = 0; iFeature0 < 5; ++iFeature0) {
+      for(IntEbmType iFeature1 = 0; iFeature1 < 5; ++iFeature1) {
+         featureIndexPairs.push_back(iFeature0);
+         featureIndexPairs.push_back(iFeature1);
+      }
+   }
+   for(IntEbmType iRepeat = 0; iRepeat < 20; ++iRepeat) {
+      featureIndexPairs.push_back(0);
+      featureIndexPairs.push_back(iRepeat % 5);
+   }
+
+   for(IntEbmType countSamplesRequiredForChildSplitMin = 1; countSamplesRequiredForChildSplitMin <= 3; countSamplesRequiredForChildSplitMin += 2) {
+      const std::vector<FloatEbmType> scores = test.InteractionScorePairs(featureIndexPairs, countSamplesRequiredForChildSplitMin);
+      CHECK(featureIndexPairs.size() / 2 == scores.size());
+      for(size_t iPair = 0; iPair < scores.size(); ++iPair) {
+         const IntEbmType iFeature0 = featureIndexPairs[iPair * 2];
+         const IntEbmType iFeature1 = featureIndexPairs[iPair * 2 + 1];
+         const FloatEbmType score = test.InteractionScore({ iFeature0, iFeature1 }, countSamplesRequiredForChildSplitMin);
+         CHECK_APPROX(scores[iPair], score);
+         if(3 == iFeature0 || 3 == iFeature1) {
+            CHECK(0 == scores[iPair]);
+         }
+      }
+   }
+   CHECK(0 < test.InteractionScorePairs({ 0, 2 }, 1)[0]);
+}
+
+TEST_CASE("InteractionScorePairs matches individual scores, regression") {
+   CheckInteractionScorePairs(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("InteractionScorePairs matches individual scores, binary") {
+   CheckInteractionScorePairs(testCaseHidden, 2);
+}
+
+TEST_CASE("InteractionScorePairs matches individual scores, multiclass") {
+   CheckInteractionScorePairs(testCaseHidden, 3);
+}
+
+TEST_CASE("InteractionScorePairs with no pairs, interaction, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2) });
+   test.AddInteractionSamples({ RegressionSample(1, { 1 }) });
+   test.InitializeInteraction();
+   CHECK(0 == test.InteractionScorePairs({}).size());
+}
+
+static std::vector<FloatEbmType> MakeTempParamsScreen(
+   const FloatEbmType countScreenSamples, 
+   const FloatEbmType countScreenCandidates, 
+   const FloatEbmType screenSeed
+) {
+   return MakeTempParams({ 
+      { TempParamInteractionScreenSamples, countScreenSamples }, 
+      { TempParamInteractionScreenCandidates, countScreenCandidates }, 
+      { TempParamInteractionScreenSeed, screenSeed } 
+   });
+}
+
+static std::vector<FloatEbmType> ScreenInteractionScorePairs(
+   const std::vector<IntEbmType> featureIndexPairs, 
+   const std::vector<FloatEbmType> optionalTempParams
+) {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2), FeatureTest(4), FeatureTest(1), FeatureTest(5) });
+   std::vector<RegressionSample> samples;
+   for(IntEbmType iSample = 0; iSample < 200; ++iSample) {
+      const IntEbmType bin0 = iSample % 3;
+      const IntEbmType bin1 = iSample / 3 % 2;
+      const IntEbmType bin2 = iSample / 6 % 4;
+      const IntEbmType bin4 = iSample * 7 % 5;
+      // the interaction between features 0 and 2 dominates everything else
+      const FloatEbmType target = static_cast<FloatEbmType>(100 * bin0 * bin2 + bin1 * bin4 + iSample % 5);
+      samples.push_back(RegressionSample(target, { bin0, bin1, bin2, 0, bin4 }));
+   }
+   test.AddInteractionSamples(samples);
+   test.InitializeInteraction(optionalTempParams);
+   return test.InteractionScorePairs(featureIndexPairs, 1);
+}
+
+static const std::vector<IntEbmType> k_screenFeatureIndexPairs { 0, 1, 0, 2, 0, 3, 0, 4, 1, 2, 1, 4, 2, 4, 4, 2 };
+
+TEST_CASE("InteractionScorePairs screening with enough candidates, interaction, regression") {
+   const std::vector<FloatEbmType> exact = ScreenInteractionScorePairs(k_screenFeatureIndexPairs, {});
+   const std::vector<FloatEbmType> screened = 
+      ScreenInteractionScorePairs(k_screenFeatureIndexPairs, MakeTempParamsScreen(50, 8, 1));
+   CHECK(exact.size() == screened.size());
+   for(size_t iPair = 0; iPair < exact.size(); ++iPair) {
+      CHECK_APPROX(screened[iPair], exact[iPair]);
+   }
+}
+
+TEST_CASE("InteractionScorePairs screening keeps the strongest pairs, interaction, regression") {
+   const std::vector<FloatEbmType> exact = ScreenInteractionScorePairs(k_screenFeatureIndexPairs, {});
+   const std::vector<FloatEbmType> screened = 
+      ScreenInteractionScorePairs(k_screenFeatureIndexPairs, MakeTempParamsScreen(50, 2, 1));
+   CHECK(exact.size() == screened.size());
+   size_t cKept = 0;
+   for(size_t iPair = 0; iPair < exact.size(); ++iPair) {
+      if(0 != screened[iPair]) {
+         ++cKept;
+         CHECK_APPROX(screened[iPair], exact[iPair]);
+      }
+   }
+   CHECK(2 == cKept);
+   // the pair of features 0 and 2 is the strongest and should never be screened out
+   CHECK_APPROX(screened[1], exact[1]);
+   // the feature with 1 bin can't have any interactions
+   CHECK(0 == screened[2]);
+}
+
+TEST_CASE("InteractionScorePairs screening is reproducible, interaction, regression") {
+   const std::vector<FloatEbmType> screened1 = 
+      ScreenInteractionScorePairs(k_screenFeatureIndexPairs, MakeTempParamsScreen(20, 3, 42));
+   const std::vector<FloatEbmType> screened2 = 
+      ScreenInteractionScorePairs(k_screenFeatureIndexPairs, MakeTempParamsScreen(20, 3, 42));
+   CHECK(screened1 == screened2);
+}
+
+TEST_CASE("InteractionScorePairs screening with every sample, interaction, regression") {
+   const std::vector<FloatEbmType> exact = ScreenInteractionScorePairs(k_screenFeatureIndexPairs, {});
+   const std::vector<FloatEbmType> screened = 
+      ScreenInteractionScorePairs(k_screenFeatureIndexPairs, MakeTempParamsScreen(1000, 1, 0));
+   CHECK(exact.size() == screened.size());
+   for(size_t iPair = 0; iPair < exact.size(); ++iPair) {
+      CHECK_APPROX(screened[iPair], exact[iPair]);
+   }
+}
+
+static void CheckInteractionScoreTopPairs(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   // the feature with 2 bins makes the bound of its pairs exact, and the feature with 1 bin can't have interactions
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2), FeatureTest(4), FeatureTest(1), FeatureTest(5), FeatureTest(6) });
+   std::vector<RegressionSample> regressionSamples;
+   std::vector<ClassificationSample> classificationSamples;
+   for(IntEbmType iSample = 0; iSample < 240; ++iSample) {
+      const IntEbmType bin0 = iSample % 3;
+      const IntEbmType bin1 = iSample / 3 % 2;
+      const IntEbmType bin2 = iSample / 6 % 4;
+      const IntEbmType bin4 = iSample * 7 % 5;
+      const IntEbmType bin5 = iSample * 5 / 3 % 6;
+      const std::vector<IntEbmType> binnedFeatureValues { bin0, bin1, bin2, 0, bin4, bin5 };
+      if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+         const FloatEbmType target = static_cast<FloatEbmType>(10 * bin0 * bin2 + bin1 * bin4 + iSample % 5);
+         regressionSamples.push_back(RegressionSample(target, binnedFeatureValues));
+      } else {
+         const IntEbmType target = (bin0 * bin2 + bin1 * bin4 + iSample % 7 / 6) % learningTypeOrCountTargetClasses;
+         classificationSamples.push_back(ClassificationSample(target, binnedFeatureValues));
+      }
+   }
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      test.AddInteractionSamples(regressionSamples);
+   } else {
+      test.AddInteractionSamples(classificationSamples);
+   }
+   test.InitializeInteraction();
+
+   // every ordered pair, so every score has a tie, and pairs of a feature with itself
+   std::vector<IntEbmType> featureIndexPairs;
+   for(IntEbmType iFeature0 = 0; iFeature0 < 6; ++iFeature0) {
+      for(IntEbmType iFeature1 = 0; iFeature1 < 6; ++iFeature1) {
+         featureIndexPairs.push_back(iFeature0);
+         featureIndexPairs.push_back(iFeature1);
+      }
+   }
+   const std::vector<FloatEbmType> scores = test.InteractionScorePairs(featureIndexPairs, 1);
+   std::vector<size_t> aiPairsSorted;
+   for(size_t iPair = 0; iPair < scores.size(); ++iPair) {
+      aiPairsSorted.push_back(iPair);
+   }
+   std::stable_sort(aiPairsSorted.begin(), aiPairsSorted.end(), 
+      [&scores](const size_t iPair1, const size_t iPair2) { return scores[iPair2] < scores[iPair1]; });
+
+   for(const IntEbmType countTopPairs : { 1, 2, 5, 36, 50 }) {
+      std::vector<FloatEbmType> topScores;
+      const std::vector<IntEbmType> topPairs = test.InteractionScoreTopPairs(featureIndexPairs, countTopPairs, topScores, 1);
+      const size_t cTopPairs = static_cast<size_t>(countTopPairs) < scores.size() ? static_cast<size_t>(countTopPairs) : scores.size();
+      CHECK(cTopPairs == topPairs.size());
+      CHECK(cTopPairs == topScores.size());
+      for(size_t iTopPair = 0; iTopPair < topPairs.size(); ++iTopPair) {
+         CHECK(static_cast<IntEbmType>(aiPairsSorted[iTopPair]) == topPairs[iTopPair]);
+         CHECK(scores[aiPairsSorted[iTopPair]] == topScores[iTopPair]);
+      }
+   }
+}
+
+TEST_CASE("InteractionScoreTopPairs matches sorted pair scores, interaction, regression") {
+   CheckInteractionScoreTopPairs(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("InteractionScoreTopPairs matches sorted pair scores, interaction, binary") {
+   CheckInteractionScoreTopPairs(testCaseHidden, 2);
+}
+
+TEST_CASE("InteractionScoreTopPairs matches sorted pair scores, interaction, multiclass") {
+   CheckInteractionScoreTopPairs(testCaseHidden, 3);
+}
+
+TEST_CASE("InteractionScoreTopPairs with no top pairs, interaction, regression") {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(2) });
+   test.AddInteractionSamples({ RegressionSample(1, { 1, 0 }), RegressionSample(2, { 0, 1 }) });
+   test.InitializeInteraction();
+   std::vector<FloatEbmType> topScores;
+   CHECK(0 == test.InteractionScoreTopPairs({ 0, 1 }, 0, topScores).size());
+   CHECK(0 == test.InteractionScoreTopPairs({}, 3, topScores).size());
+}
+
+static FloatEbmType MissingBinInteractionScore(const bool bMissing) {
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(3, FeatureType::Ordinal, bMissing), FeatureTest(4, FeatureType::Ordinal, bMissing) });
+   std::vector<RegressionSample> samples;
+   for(size_t iSample = 0; iSample < 36; ++iSample) {
+      const IntEbmType iBin0 = static_cast<IntEbmType>(iSample % 3);
+      const IntEbmType iBin1 = static_cast<IntEbmType>(iSample / 3 % 4);
+      samples.push_back(RegressionSample(0 == iBin0 || 0 == iBin1 ? 7 : static_cast<FloatEbmType>(iBin0 * iBin1), 
+         { iBin0, iBin1 }));
+   }
+   test.AddInteractionSamples(samples);
+   test.InitializeInteraction();
+   return test.InteractionScore({ 0, 1 });
+}
+
+TEST_CASE("missing bins, interaction, regression") {
+   // the missing bin is the 0th bin, so it is scored like any other bin
+   const FloatEbmType scoreMissing = MissingBinInteractionScore(true);
+   CHECK(0 < scoreMissing);
+   CHECK(scoreMissing == MissingBinInteractionScore(false));
+}
+
+static constexpr size_t k_cSamplesFromBoosting = 60;
+
+static IntEbmType GetBinFromBoosting(const size_t iSample, const size_t iFeature) {
+   static constexpr size_t k_cBins[] { 4, 3, 5, 1 };
+   return static_cast<IntEbmType>((iSample * (2 * iFeature + 1) + iSample / 7) % k_cBins[iFeature]);
+}
+
+// boosts a booster for cEpochs and then checks that the interactions scored on its training set match the 
+// interactions scored on the same samples with the booster's predictions as predictor scores
+static void CheckInteractionFromBoosting(
+   TestCaseHidden & testCaseHidden,
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const std::vector<FloatEbmType> optionalTempParams,
+   const int cEpochs,
+   const FloatEbmType tolerance
+) {
+   const std::vector<FeatureTest> features { FeatureTest(4), FeatureTest(3), FeatureTest(5), FeatureTest(1) };
+   TestApi testBoosting = TestApi(learningTypeOrCountTargetClasses);
+   testBoosting.AddFeatures(features);
+   // feature 0 is read from its own feature group and features 1 and 2 from a pair.  Feature 3 has a single bin
+   testBoosting.AddFeatureGroups({ { 0 }, { 1, 2 } });
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      std::vector<RegressionSample> samples;
+      for(size_t iSample = 0; iSample < k_cSamplesFromBoosting; ++iSample) {
+         const FloatEbmType target = static_cast<FloatEbmType>(GetBinFromBoosting(iSample, 0) * GetBinFromBoosting(iSample, 1) - 
+            GetBinFromBoosting(iSample, 2)) + static_cast<FloatEbmType>(iSample % 9) / FloatEbmType { 10 };
+         samples.push_back(RegressionSample(target, { GetBinFromBoosting(iSample, 0), GetBinFromBoosting(iSample, 1), 
+            GetBinFromBoosting(iSample, 2), GetBinFromBoosting(iSample, 3) }));
+      }
+      testBoosting.AddTrainingSamples(samples);
+      testBoosting.AddValidationSamples({ RegressionSample(2, { 1, 2, 3, 0 }) });
+   } else {
+      std::vector<ClassificationSample> samples;
+      for(size_t iSample = 0; iSample < k_cSamplesFromBoosting; ++iSample) {
+         const IntEbmType target = (GetBinFromBoosting(iSample, 0) * GetBinFromBoosting(iSample, 1) + 
+            static_cast<IntEbmType>(iSample % 5 / 4)) % static_cast<IntEbmType>(learningTypeOrCountTargetClasses);
+         samples.push_back(ClassificationSample(target, { GetBinFromBoosting(iSample, 0), GetBinFromBoosting(iSample, 1), 
+            GetBinFromBoosting(iSample, 2), GetBinFromBoosting(iSample, 3) }));
+      }
+      testBoosting.AddTrainingSamples(samples);
+      testBoosting.AddValidationSamples({ ClassificationSample(1, { 1, 2, 3, 0 }) });
+   }
+   testBoosting.InitializeBoosting(0, optionalTempParams);
+   for(int iEpoch = 0; iEpoch < cEpochs; ++iEpoch) {
+      testBoosting.Boost(0, {}, {}, FloatEbmType { 0.1 });
+      testBoosting.Boost(1, {}, {}, FloatEbmType { 0.1 });
+   }
+
+   TestApi testInteraction = TestApi(learningTypeOrCountTargetClasses);
+   testInteraction.AddFeatures(features);
+   const size_t cClasses = k_learningTypeRegression == learningTypeOrCountTargetClasses ? size_t { 1 } : 
+      static_cast<size_t>(learningTypeOrCountTargetClasses);
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      std::vector<RegressionSample> samples;
+      for(size_t iSample = 0; iSample < k_cSamplesFromBoosting; ++iSample) {
+         const size_t iBin0 = static_cast<size_t>(GetBinFromBoosting(iSample, 0));
+         const size_t iBin1 = static_cast<size_t>(GetBinFromBoosting(iSample, 1));
+         const size_t iBin2 = static_cast<size_t>(GetBinFromBoosting(iSample, 2));
+         const FloatEbmType target = static_cast<FloatEbmType>(GetBinFromBoosting(iSample, 0) * GetBinFromBoosting(iSample, 1) - 
+            GetBinFromBoosting(iSample, 2)) + static_cast<FloatEbmType>(iSample % 9) / FloatEbmType { 10 };
+         const FloatEbmType score = testBoosting.GetCurrentModelPredictorScore(0, { iBin0 }, 0) + 
+            testBoosting.GetCurrentModelPredictorScore(1, { iBin1, iBin2 }, 0);
+         samples.push_back(RegressionSample(target, { GetBinFromBoosting(iSample, 0), GetBinFromBoosting(iSample, 1),
+            GetBinFromBoosting(iSample, 2), GetBinFromBoosting(iSample, 3) }, score));
+      }
+      testInteraction.AddInteractionSamples(samples);
+   } else {
+      std::vector<ClassificationSample> samples;
+      for(size_t iSample = 0; iSample < k_cSamplesFromBoosting; ++iSample) {
+         const size_t iBin0 = static_cast<size_t>(GetBinFromBoosting(iSample, 0));
+         const size_t iBin1 = static_cast<size_t>(GetBinFromBoosting(iSample, 1));
+         const size_t iBin2 = static_cast<size_t>(GetBinFromBoosting(iSample, 2));
+         const IntEbmType target = (GetBinFromBoosting(iSample, 0) * GetBinFromBoosting(iSample, 1) +
+            static_cast<IntEbmType>(iSample % 5 / 4)) % static_cast<IntEbmType>(learningTypeOrCountTargetClasses);
+         std::vector<FloatEbmType> logits;
+         for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+            logits.push_back(testBoosting.GetCurrentModelPredictorScore(0, { iBin0 }, iClass) +
+               testBoosting.GetCurrentModelPredictorScore(1, { iBin1, iBin2 }, iClass));
+         }
+         samples.push_back(ClassificationSample(target, { GetBinFromBoosting(iSample, 0), GetBinFromBoosting(iSample, 1),
+            GetBinFromBoosting(iSample, 2), GetBinFromBoosting(iSample, 3) }, logits));
+      }
+      testInteraction.AddInteractionSamples(samples);
+   }
+   testInteraction.InitializeInteraction();
+
+   PEbmInteraction pEbmInteraction = InitializeInteractionFromBoosting(testBoosting.GetBoosting(), nullptr);
+   CHECK(nullptr != pEbmInteraction);
+   for(IntEbmType iFeature0 = 0; iFeature0 < 4; ++iFeature0) {
+      for(IntEbmType iFeature1 = iFeature0 + 1; iFeature1 < 4; ++iFeature1) {
+         const IntEbmType featureIndexes[] { iFeature0, iFeature1 };
+         FloatEbmType score = FloatEbmType { -1 };
+         CHECK(0 == CalculateInteractionScore(pEbmInteraction, 2, featureIndexes, k_countSamplesRequiredForChildSplitMinDefault, &score));
+         const FloatEbmType scoreExpected = testInteraction.InteractionScore({ iFeature0, iFeature1 });
+         CHECK(IsApproxEqual(score, scoreExpected, tolerance));
+      }
+   }
+   FreeInteraction(pEbmInteraction);
+}
+
+// after boosting, the booster sums the predictions of its feature groups in a different order than we do
+static constexpr FloatEbmType k_toleranceFromBoosting = FloatEbmType { 1e-9 };
+// single precision residuals and class-major multiclass
+static const std::vector<FloatEbmType> k_tempParamsFromBoostingFloat32 = MakeTempParams({ 
+   { TempParamBoostingSinglePrecision, 1 }, 
+   { TempParamBoostingClassMajor, 1 } 
+});
+
+TEST_CASE("interactions from boosting match interactions on the booster's predictions, interaction, regression") {
+   CheckInteractionFromBoosting(testCaseHidden, k_learningTypeRegression, {}, 0, FloatEbmType { 0 });
+   CheckInteractionFromBoosting(testCaseHidden, k_learningTypeRegression, {}, 5, k_toleranceFromBoosting);
+   CheckInteractionFromBoosting(testCaseHidden, k_learningTypeRegression, k_tempParamsFromBoostingFloat32, 5, FloatEbmType { 1e-5 });
+}
+
+TEST_CASE("interactions from boosting match interactions on the booster's predictions, interaction, binary") {
+   CheckInteractionFromBoosting(testCaseHidden, 2, {}, 0, FloatEbmType { 0 });
+   CheckInteractionFromBoosting(testCaseHidden, 2, {}, 5, k_toleranceFromBoosting);
+   CheckInteractionFromBoosting(testCaseHidden, 2, k_tempParamsFromBoostingFloat32, 5, FloatEbmType { 1e-5 });
+}
+
+TEST_CASE("interactions from boosting match interactions on the booster's predictions, interaction, multiclass") {
+   CheckInteractionFromBoosting(testCaseHidden, 3, {}, 0, FloatEbmType { 0 });
+   CheckInteractionFromBoosting(testCaseHidden, 3, {}, 5, k_toleranceFromBoosting);
+   CheckInteractionFromBoosting(testCaseHidden, 3, k_tempParamsFromBoostingFloat32, 5, FloatEbmType { 1e-5 });
+}
+
+TEST_CASE("interactions from boosting need every feature in a feature group, interaction, regression") {
+   CHECK(nullptr == InitializeInteractionFromBoosting(nullptr, nullptr));
+
+   TestApi test = TestApi(k_learningTypeRegression);
+   test.AddFeatures({ FeatureTest(2), FeatureTest(3) });
+   test.AddFeatureGroups({ { 0 } });
+   test.AddTrainingSamples({ RegressionSample(1, { 1, 0 }), RegressionSample(2, { 0, 2 }) });
+   test.AddValidationSamples({ RegressionSample(1, { 1, 1 }) });
+   test.InitializeBoosting();
+   CHECK(nullptr == InitializeInteractionFromBoosting(test.GetBoosting(), nullptr));
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::LogBuffer;
+
+static void InitializeLogBufferBoosting(TestApi & test) {
+   test.AddFeatures({ FeatureTest(3), FeatureTest(2) });
+   test.AddFeatureGroups({ { 0 }, { 1 } });
+   test.AddTrainingSamples({ RegressionSample(10, { 0, 1 }), RegressionSample(20, { 1, 0 }), RegressionSample(30, { 2, 1 }) });
+   test.AddValidationSamples({ RegressionSample(12, { 0, 0 }), RegressionSample(19, { 1, 1 }) });
+   test.InitializeBoosting();
+}
+
+TEST_CASE("SetLogBuffer, negative countMessages") {
+   CHECK(0 != SetLogBuffer(-1));
+   IntEbmType countDropped = -1;
+   CHECK(0 == DrainLogMessages(&countDropped));
+   CHECK(0 == countDropped);
+}
+
+TEST_CASE("DrainLogMessages, same messages as an identical run") {
+   CHECK(0 == SetLogBuffer(1 << 14));
+
+   IntEbmType countDelivered[2];
+   for(size_t iRun = 0; iRun < 2; ++iRun) {
+      {
+         // freeing the booster logs too, so drain after it's gone
+         TestApi test = TestApi(k_learningTypeRegression);
+         InitializeLogBufferBoosting(test);
+         for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+            test.Boost(iEpoch % 2);
+         }
+      }
+      IntEbmType countDropped = -1;
+      countDelivered[iRun] = DrainLogMessages(&countDropped);
+      CHECK(0 == countDropped);
+   }
+   CHECK(0 < countDelivered[0]);
+   CHECK(countDelivered[0] == countDelivered[1]);
+   CHECK(0 == DrainLogMessages(nullptr));
+
+   CHECK(0 == SetLogBuffer(0));
+}
+
+TEST_CASE("DrainLogMessages, full buffer drops messages") {
+   CHECK(0 == SetLogBuffer(3));
+
+   TestApi test = TestApi(k_learningTypeRegression);
+   InitializeLogBufferBoosting(test);
+   for(int iEpoch = 0; iEpoch < 10; ++iEpoch) {
+      test.Boost(iEpoch % 2);
+   }
+   IntEbmType countDropped = -1;
+   // 3 messages is rounded up to 4
+   CHECK(4 == DrainLogMessages(&countDropped));
+   CHECK(0 < countDropped);
+   CHECK(0 == DrainLogMessages(&countDropped));
+   CHECK(0 == countDropped);
+
+   CHECK(0 == SetLogBuffer(0));
+}
+
+TEST_CASE("DrainLogMessages, messages from background threads") {
+   CHECK(0 == SetLogBuffer(1 << 14));
+
+   TestApi test1 = TestApi(k_learningTypeRegression);
+   InitializeLogBufferBoosting(test1);
+   TestApi test2 = TestApi(k_learningTypeRegression);
+   InitializeLogBufferBoosting(test2);
+   DrainLogMessages(nullptr);
+
+   constexpr size_t cWorks = 20;
+   PEbmWork works[cWorks];
+   for(size_t iWork = 0; iWork < cWorks; ++iWork) {
+      TestApi & test = 0 == iWork % 2 ? test1 : test2;
+      works[iWork] = test.BoostAsync(static_cast<IntEbmType>(iWork / 2 % 2));
+   }
+   for(size_t iWork = 0; iWork < cWorks; ++iWork) {
+      FloatEbmType validationMetric = FloatEbmType { -1 };
+      CHECK(0 == FinishWork(works[iWork], &validationMetric));
+   }
+   IntEbmType countDropped = -1;
+   CHECK(0 < DrainLogMessages(&countDropped));
+   CHECK(0 == countDropped);
+
+   CHECK(0 == SetLogBuffer(0));
+}
@@ -0,0 +1,547 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include <stdio.h> // remove, fopen, fread, fwrite, fclose
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::PredictBatch;
+
+// more than one block of samples, and not a multiple of the block size
+static constexpr size_t k_cSamplesPredict = 1000;
+static constexpr IntEbmType k_cBins0 = 5;
+static constexpr IntEbmType k_cBins1 = 4;
+
+static const char * const k_modelFilePath = "ebm_native_test_model.bin";
+
+// feature values that land in bin b are in [b, b + 1), so the cuts are 1, 2, ... countBins - 1.  The second feature
+// gets an extra cut, so its last bin and missing values are outside of the tensor
+static const EbmNativeFeature k_featuresPredict[] { { 0, 0, k_cBins0 }, { 0, 0, k_cBins1 } };
+static const IntEbmType k_countBinCutsPredict[] { k_cBins0 - 1, k_cBins1 };
+static const FloatEbmType k_binCutsPredict[] { 1, 2, 3, 4, 1, 2, 3, 4 };
+static const EbmNativeFeatureGroup k_featureGroupsPredict[] { { 0 }, { 1 }, { 1 }, { 2 } };
+static const IntEbmType k_featureGroupIndexesPredict[] { 0, 1, 0, 1 };
+
+static void TrainPredictModel(TestApi & test, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   test.AddFeatures({ FeatureTest(k_cBins0), FeatureTest(k_cBins1) });
+   test.AddFeatureGroups({ {}, { 0 }, { 1 }, { 0, 1 } });
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      std::vector<RegressionSample> samples;
+      for(size_t iSample = 0; iSample < 200; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+         samples.push_back(RegressionSample(static_cast<FloatEbmType>(bin0 * 3 - bin1 * bin0), { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(samples);
+      test.AddValidationSamples({ RegressionSample(3, { 1, 0 }) });
+   } else {
+      std::vector<ClassificationSample> samples;
+      for(size_t iSample = 0; iSample < 200; ++iSample) {
+         const IntEbmType bin0 = static_cast<IntEbmType>(iSample % 5);
+         const IntEbmType bin1 = static_cast<IntEbmType>(iSample * 7 % 4);
+         const IntEbmType target = static_cast<IntEbmType>((bin0 + bin1 * bin0 + static_cast<IntEbmType>(iSample % 11 / 9)) %
+            learningTypeOrCountTargetClasses);
+         samples.push_back(ClassificationSample(target, { bin0, bin1 }));
+      }
+      test.AddTrainingSamples(samples);
+      test.AddValidationSamples({ ClassificationSample(0, { 1, 2 }) });
+   }
+   test.InitializeBoosting();
+   for(int iEpoch = 0; iEpoch < 20; ++iEpoch) {
+      for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
+         test.Boost(iFeatureGroup);
+      }
+   }
+}
+
+// the model tensors of TrainPredictModel back to back, which is the format of modelFeatureGroupTensors
+static std::vector<FloatEbmType> GetModelTensors(const TestApi & test, const size_t cVectorLength) {
+   const size_t cBins0 = static_cast<size_t>(k_cBins0);
+   const size_t cBins1 = static_cast<size_t>(k_cBins1);
+   const std::vector<size_t> cTensorBins { 1, cBins0, cBins1, cBins0 * cBins1 };
+   std::vector<FloatEbmType> modelTensors;
+   for(size_t iFeatureGroup = 0; iFeatureGroup < cTensorBins.size(); ++iFeatureGroup) {
+      const FloatEbmType * const pTensor = test.GetBestModelFeatureGroupRaw(iFeatureGroup);
+      modelTensors.insert(modelTensors.end(), pTensor, pTensor + cTensorBins[iFeatureGroup] * cVectorLength);
+   }
+   return modelTensors;
+}
+
+static std::vector<FloatEbmType> GetIntercept(const size_t cVectorLength) {
+   std::vector<FloatEbmType> intercept;
+   for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+      intercept.push_back(FloatEbmType { 0.25 } * static_cast<FloatEbmType>(iVector + 1));
+   }
+   return intercept;
+}
+
+static std::vector<FloatEbmType> GetFeatureValuesPredict() {
+   std::vector<FloatEbmType> featureValues(2 * k_cSamplesPredict);
+   for(size_t iSample = 0; iSample < k_cSamplesPredict; ++iSample) {
+      featureValues[iSample] = 0 == iSample % 17 ? std::numeric_limits<FloatEbmType>::quiet_NaN() :
+         static_cast<FloatEbmType>(iSample % 5) + FloatEbmType { 0.5 };
+      featureValues[k_cSamplesPredict + iSample] = static_cast<FloatEbmType>(iSample * 3 % 5);
+   }
+   return featureValues;
+}
+
+static IntEbmType PredictBatchTest(
+   const ptrdiff_t learningTypeOrCountTargetClasses,
+   const std::vector<FloatEbmType> & modelTensors,
+   const std::vector<FloatEbmType> & intercept,
+   const std::vector<FloatEbmType> & featureValues,
+   std::vector<FloatEbmType> & predictions
+) {
+   if(k_learningTypeRegression == learningTypeOrCountTargetClasses) {
+      return PredictBatchRegression(2, k_featuresPredict, k_countBinCutsPredict, k_binCutsPredict, 4, k_featureGroupsPredict,
+         k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0], k_cSamplesPredict, &featureValues[0], &predictions[0]);
+   }
+   return PredictBatchClassification(learningTypeOrCountTargetClasses, 2, k_featuresPredict, k_countBinCutsPredict,
+      k_binCutsPredict, 4, k_featureGroupsPredict, k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0],
+      k_cSamplesPredict, &featureValues[0], &predictions[0]);
+}
+
+static void CheckPredictBatch(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   TrainPredictModel(test, learningTypeOrCountTargetClasses);
+
+   const bool bRegression = k_learningTypeRegression == learningTypeOrCountTargetClasses;
+   const size_t cClasses = bRegression ? size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+   // binary classification has a single logit
+   const size_t cVectorLength = size_t { 2 } == cClasses ? size_t { 1 } : cClasses;
+   const size_t cBins0 = static_cast<size_t>(k_cBins0);
+   const size_t cBins1 = static_cast<size_t>(k_cBins1);
+
+   const std::vector<FloatEbmType> modelTensors = GetModelTensors(test, cVectorLength);
+   const std::vector<FloatEbmType> intercept = GetIntercept(cVectorLength);
+   const std::vector<FloatEbmType> featureValues = GetFeatureValuesPredict();
+
+   std::vector<FloatEbmType> predictions(k_cSamplesPredict * cClasses);
+   CHECK(0 == PredictBatchTest(learningTypeOrCountTargetClasses, modelTensors, intercept, featureValues, predictions));
+
+   const FloatEbmType * const pTensor0 = &modelTensors[cVectorLength];
+   const FloatEbmType * const pTensor1 = pTensor0 + cBins0 * cVectorLength;
+   const FloatEbmType * const pTensorPair = pTensor1 + cBins1 * cVectorLength;
+   for(size_t iSample = 0; iSample < k_cSamplesPredict; ++iSample) {
+      const bool bMissing0 = 0 == iSample % 17;
+      const size_t iBin0 = iSample % 5;
+      const size_t iBin1 = iSample * 3 % 5;
+      const bool bUnknown1 = cBins1 <= iBin1;
+
+      std::vector<FloatEbmType> scores(cVectorLength);
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         FloatEbmType score = intercept[iVector] + modelTensors[iVector];
+         if(!bMissing0) {
+            score += pTensor0[iBin0 * cVectorLength + iVector];
+         }
+         if(!bUnknown1) {
+            score += pTensor1[iBin1 * cVectorLength + iVector];
+         }
+         if(!bMissing0 && !bUnknown1) {
+            score += pTensorPair[(iBin0 + iBin1 * cBins0) * cVectorLength + iVector];
+         }
+         scores[iVector] = score;
+      }
+
+      if(bRegression) {
+         CHECK_APPROX(predictions[iSample], scores[0]);
+      } else if(size_t { 2 } == cClasses) {
+         const FloatEbmType probability = FloatEbmType { 1 } / (FloatEbmType { 1 } + std::exp(-scores[0]));
+         CHECK_APPROX(predictions[iSample * 2 + 0], FloatEbmType { 1 } - probability);
+         CHECK_APPROX(predictions[iSample * 2 + 1], probability);
+      } else {
+         FloatEbmType sumExp = 0;
+         for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+            sumExp += std::exp(scores[iClass]);
+         }
+         for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+            CHECK_APPROX(predictions[iSample * cClasses + iClass], std::exp(scores[iClass]) / sumExp);
+         }
+      }
+   }
+}
+
+TEST_CASE("PredictBatch matches the model tensors, regression") {
+   CheckPredictBatch(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("PredictBatch matches the model tensors, binary") {
+   CheckPredictBatch(testCaseHidden, 2);
+}
+
+TEST_CASE("PredictBatch matches the model tensors, multiclass") {
+   CheckPredictBatch(testCaseHidden, 3);
+}
+
+TEST_CASE("PredictBatch invalid feature index, regression") {
+   const EbmNativeFeature features[] { { 0, 0, 2 } };
+   const IntEbmType countBinCuts[] { 1 };
+   const FloatEbmType binCuts[] { 1 };
+   const EbmNativeFeatureGroup featureGroups[] { { 1 } };
+   const IntEbmType featureGroupIndexes[] { 1 };
+   const FloatEbmType modelTensors[] { 1, 2 };
+   const FloatEbmType featureValues[] { 0, 1, 2 };
+   FloatEbmType predictions[3];
+   const IntEbmType ret = PredictBatchRegression(1, features, countBinCuts, binCuts, 1, featureGroups,
+      featureGroupIndexes, modelTensors, nullptr, 3, featureValues, predictions);
+   CHECK(0 != ret);
+}
+
+static void CheckExplainBatch(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   TrainPredictModel(test, learningTypeOrCountTargetClasses);
+
+   const bool bRegression = k_learningTypeRegression == learningTypeOrCountTargetClasses;
+   const size_t cClasses = bRegression ? size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+   const size_t cVectorLength = size_t { 2 } == cClasses ? size_t { 1 } : cClasses;
+   const size_t cBins0 = static_cast<size_t>(k_cBins0);
+   const size_t cBins1 = static_cast<size_t>(k_cBins1);
+   const size_t cOutputsPerSample = 5 * cVectorLength;
+
+   const std::vector<FloatEbmType> modelTensors = GetModelTensors(test, cVectorLength);
+   const std::vector<FloatEbmType> intercept = GetIntercept(cVectorLength);
+   const std::vector<FloatEbmType> featureValues = GetFeatureValuesPredict();
+
+   std::vector<FloatEbmType> explanations(k_cSamplesPredict * cOutputsPerSample);
+   CHECK(0 == (bRegression ?
+      ExplainBatchRegression(2, k_featuresPredict, k_countBinCutsPredict, k_binCutsPredict, 4, k_featureGroupsPredict,
+         k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0], k_cSamplesPredict, &featureValues[0], 
+         &explanations[0]) :
+      ExplainBatchClassification(learningTypeOrCountTargetClasses, 2, k_featuresPredict, k_countBinCutsPredict,
+         k_binCutsPredict, 4, k_featureGroupsPredict, k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0],
+         k_cSamplesPredict, &featureValues[0], &explanations[0])));
+
+   std::vector<FloatEbmType> predictions(k_cSamplesPredict * cClasses);
+   CHECK(0 == PredictBatchTest(learningTypeOrCountTargetClasses, modelTensors, intercept, featureValues, predictions));
+
+   const FloatEbmType * const pTensor0 = &modelTensors[cVectorLength];
+   const FloatEbmType * const pTensor1 = pTensor0 + cBins0 * cVectorLength;
+   const FloatEbmType * const pTensorPair = pTensor1 + cBins1 * cVectorLength;
+   for(size_t iSample = 0; iSample < k_cSamplesPredict; ++iSample) {
+      const bool bMissing0 = 0 == iSample % 17;
+      const size_t iBin0 = iSample % 5;
+      const size_t iBin1 = iSample * 3 % 5;
+      const bool bUnknown1 = cBins1 <= iBin1;
+
+      const FloatEbmType * const pExplanation = &explanations[iSample * cOutputsPerSample];
+      std::vector<FloatEbmType> scores(cVectorLength);
+      for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+         CHECK(pExplanation[iVector] == modelTensors[iVector]);
+         CHECK(pExplanation[cVectorLength + iVector] == (bMissing0 ? FloatEbmType { 0 } : pTensor0[iBin0 * cVectorLength + iVector]));
+         CHECK(pExplanation[2 * cVectorLength + iVector] == 
+            (bUnknown1 ? FloatEbmType { 0 } : pTensor1[iBin1 * cVectorLength + iVector]));
+         CHECK(pExplanation[3 * cVectorLength + iVector] == (bMissing0 || bUnknown1 ? FloatEbmType { 0 } : 
+            pTensorPair[(iBin0 + iBin1 * cBins0) * cVectorLength + iVector]));
+         CHECK(pExplanation[4 * cVectorLength + iVector] == intercept[iVector]);
+
+         // PredictBatch adds the feature groups to the intercept in order
+         FloatEbmType score = pExplanation[4 * cVectorLength + iVector];
+         for(size_t iFeatureGroup = 0; iFeatureGroup < 4; ++iFeatureGroup) {
+            score += pExplanation[iFeatureGroup * cVectorLength + iVector];
+         }
+         scores[iVector] = score;
+      }
+      if(bRegression) {
+         CHECK(predictions[iSample] == scores[0]);
+      } else if(size_t { 2 } == cClasses) {
+         CHECK_APPROX(predictions[iSample * 2 + 1], FloatEbmType { 1 } / (FloatEbmType { 1 } + std::exp(-scores[0])));
+      }
+   }
+}
+
+TEST_CASE("ExplainBatch matches the model tensors, regression") {
+   CheckExplainBatch(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("ExplainBatch matches the model tensors, binary") {
+   CheckExplainBatch(testCaseHidden, 2);
+}
+
+TEST_CASE("ExplainBatch matches the model tensors, multiclass") {
+   CheckExplainBatch(testCaseHidden, 3);
+}
+
+TEST_CASE("ExplainBatch with one class writes nothing, classification") {
+   const EbmNativeFeature features[] { { 0, 0, 2 } };
+   const IntEbmType countBinCuts[] { 1 };
+   const FloatEbmType binCuts[] { 1 };
+   const EbmNativeFeatureGroup featureGroups[] { { 1 } };
+   const IntEbmType featureGroupIndexes[] { 0 };
+   // models with 1 class have no logits, so the tensors are empty
+   const FloatEbmType modelTensors[] { 0 };
+   const FloatEbmType featureValues[] { 0, 1, 2 };
+   FloatEbmType explanation = 7;
+   CHECK(0 == ExplainBatchClassification(1, 1, features, countBinCuts, binCuts, 1, featureGroups, featureGroupIndexes,
+      modelTensors, nullptr, 3, featureValues, &explanation));
+   CHECK(7 == explanation);
+}
+
+static void CheckScoreModelVariants(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   TrainPredictModel(test, learningTypeOrCountTargetClasses);
+
+   const bool bRegression = k_learningTypeRegression == learningTypeOrCountTargetClasses;
+   const size_t cClasses = bRegression ? size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+   const size_t cVectorLength = size_t { 2 } == cClasses ? size_t { 1 } : cClasses;
+   const size_t cOutputsPerSample = 5 * cVectorLength;
+
+   const std::vector<FloatEbmType> modelTensors = GetModelTensors(test, cVectorLength);
+   const std::vector<FloatEbmType> intercept = GetIntercept(cVectorLength);
+   const std::vector<FloatEbmType> featureValues = GetFeatureValuesPredict();
+
+   std::vector<IntEbmType> targetsClassification(k_cSamplesPredict);
+   std::vector<FloatEbmType> targetsRegression(k_cSamplesPredict);
+   for(size_t iSample = 0; iSample < k_cSamplesPredict; ++iSample) {
+      targetsClassification[iSample] = static_cast<IntEbmType>(iSample * 7 % 11 % cClasses);
+      targetsRegression[iSample] = static_cast<FloatEbmType>(iSample % 5 * 3) - static_cast<FloatEbmType>(iSample % 3);
+   }
+
+   // every feature group, only the intercept, and everything except the pair
+   const std::vector<IntEbmType> variantFeatureGroups { 1, 1, 1, 1, 0, 0, 0, 0, 1, 1, 1, 0 };
+   const size_t cVariants = variantFeatureGroups.size() / 4;
+   std::vector<FloatEbmType> metrics(cVariants);
+   CHECK(0 == (bRegression ?
+      ScoreModelVariantsRegression(2, k_featuresPredict, k_countBinCutsPredict, k_binCutsPredict, 4, k_featureGroupsPredict,
+         k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0], k_cSamplesPredict, &featureValues[0],
+         &targetsRegression[0], static_cast<IntEbmType>(cVariants), &variantFeatureGroups[0], &metrics[0]) :
+      ScoreModelVariantsClassification(learningTypeOrCountTargetClasses, 2, k_featuresPredict, k_countBinCutsPredict,
+         k_binCutsPredict, 4, k_featureGroupsPredict, k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0],
+         k_cSamplesPredict, &featureValues[0], &targetsClassification[0], static_cast<IntEbmType>(cVariants),
+         &variantFeatureGroups[0], &metrics[0])));
+
+   std::vector<FloatEbmType> explanations(k_cSamplesPredict * cOutputsPerSample);
+   CHECK(0 == (bRegression ?
+      ExplainBatchRegression(2, k_featuresPredict, k_countBinCutsPredict, k_binCutsPredict, 4, k_featureGroupsPredict,
+         k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0], k_cSamplesPredict, &featureValues[0],
+         &explanations[0]) :
+      ExplainBatchClassification(learningTypeOrCountTargetClasses, 2, k_featuresPredict, k_countBinCutsPredict,
+         k_binCutsPredict, 4, k_featureGroupsPredict, k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0],
+         k_cSamplesPredict, &featureValues[0], &explanations[0])));
+
+   std::vector<FloatEbmType> predictions(k_cSamplesPredict * cClasses);
+   CHECK(0 == PredictBatchTest(learningTypeOrCountTargetClasses, modelTensors, intercept, featureValues, predictions));
+
+   for(size_t iVariant = 0; iVariant < cVariants; ++iVariant) {
+      FloatEbmType sumMetric = 0;
+      FloatEbmType sumMetricPredictions = 0;
+      for(size_t iSample = 0; iSample < k_cSamplesPredict; ++iSample) {
+         const FloatEbmType * const pExplanation = &explanations[iSample * cOutputsPerSample];
+         std::vector<FloatEbmType> scores(cVectorLength);
+         for(size_t iVector = 0; iVector < cVectorLength; ++iVector) {
+            FloatEbmType score = pExplanation[4 * cVectorLength + iVector];
+            for(size_t iFeatureGroup = 0; iFeatureGroup < 4; ++iFeatureGroup) {
+               if(0 != variantFeatureGroups[iVariant * 4 + iFeatureGroup]) {
+                  score += pExplanation[iFeatureGroup * cVectorLength + iVector];
+               }
+            }
+            scores[iVector] = score;
+         }
+         const size_t iTarget = static_cast<size_t>(targetsClassification[iSample]);
+         if(bRegression) {
+            const FloatEbmType residual = scores[0] - targetsRegression[iSample];
+            sumMetric += residual * residual;
+            const FloatEbmType residualPrediction = predictions[iSample] - targetsRegression[iSample];
+            sumMetricPredictions += residualPrediction * residualPrediction;
+         } else if(size_t { 2 } == cClasses) {
+            sumMetric += std::log(FloatEbmType { 1 } + std::exp(0 == iTarget ? scores[0] : -scores[0]));
+            sumMetricPredictions -= std::log(predictions[iSample * 2 + iTarget]);
+         } else {
+            FloatEbmType sumExp = 0;
+            for(size_t iClass = 0; iClass < cClasses; ++iClass) {
+               sumExp += std::exp(scores[iClass]);
+            }
+            sumMetric += std::log(sumExp) - scores[iTarget];
+            sumMetricPredictions -= std::log(predictions[iSample * cClasses + iTarget]);
+         }
+      }
+      CHECK_APPROX(metrics[iVariant], sumMetric / k_cSamplesPredict);
+      if(0 == iVariant) {
+         // the variant with every feature group is the model that PredictBatch scores
+         CHECK_APPROX(metrics[iVariant], sumMetricPredictions / k_cSamplesPredict);
+      }
+   }
+   // the pair has something to contribute on this data, so dropping it shouldn't be free
+   CHECK(metrics[2] != metrics[0]);
+}
+
+TEST_CASE("ScoreModelVariants matches the explanations, regression") {
+   CheckScoreModelVariants(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("ScoreModelVariants matches the explanations, binary") {
+   CheckScoreModelVariants(testCaseHidden, 2);
+}
+
+TEST_CASE("ScoreModelVariants matches the explanations, multiclass") {
+   CheckScoreModelVariants(testCaseHidden, 3);
+}
+
+TEST_CASE("ScoreModelVariants target out of range, classification") {
+   const EbmNativeFeature features[] { { 0, 0, 2 } };
+   const IntEbmType countBinCuts[] { 1 };
+   const FloatEbmType binCuts[] { 1 };
+   const EbmNativeFeatureGroup featureGroups[] { { 1 } };
+   const IntEbmType featureGroupIndexes[] { 0 };
+   const FloatEbmType modelTensors[] { 1, 2 };
+   const FloatEbmType featureValues[] { 0, 1, 2 };
+   const IntEbmType targets[] { 0, 2, 1 };
+   const IntEbmType variantFeatureGroups[] { 1 };
+   FloatEbmType metric;
+   CHECK(0 != ScoreModelVariantsClassification(2, 1, features, countBinCuts, binCuts, 1, featureGroups, 
+      featureGroupIndexes, modelTensors, nullptr, 3, featureValues, targets, 1, variantFeatureGroups, &metric));
+}
+
+TEST_CASE("MergeBestModelFeatureGroup averages the boosters, multiclass") {
+   TestApi test0 = TestApi(3);
+   TrainPredictModel(test0, 3);
+   TestApi test1 = TestApi(3);
+   TrainPredictModel(test1, 3);
+   // one more round makes the second booster differ from the first
+   for(size_t iFeatureGroup = 0; iFeatureGroup < test1.GetFeatureGroupsCount(); ++iFeatureGroup) {
+      test1.Boost(iFeatureGroup);
+   }
+
+   const size_t cValues = static_cast<size_t>(k_cBins0 * k_cBins1) * 3;
+   const PEbmBoosting ebmBoostings[] { test0.GetBoosting(), test1.GetBoosting() };
+   std::vector<FloatEbmType> mean(cValues);
+   std::vector<FloatEbmType> standardDeviation(cValues);
+   CHECK(0 == MergeBestModelFeatureGroup(2, ebmBoostings, 3, &mean[0], &standardDeviation[0]));
+
+   const FloatEbmType * const pTensor0 = test0.GetBestModelFeatureGroupRaw(3);
+   const FloatEbmType * const pTensor1 = test1.GetBestModelFeatureGroupRaw(3);
+   bool bDifferent = false;
+   for(size_t iValue = 0; iValue < cValues; ++iValue) {
+      bDifferent = bDifferent || pTensor0[iValue] != pTensor1[iValue];
+      CHECK_APPROX(mean[iValue], (pTensor0[iValue] + pTensor1[iValue]) / 2);
+      CHECK_APPROX(standardDeviation[iValue] + 1, std::abs(pTensor0[iValue] - pTensor1[iValue]) / 2 + 1);
+   }
+   CHECK(bDifferent);
+
+   // the mean alone, from a single booster, is that booster's model
+   std::vector<FloatEbmType> meanSingle(cValues);
+   CHECK(0 == MergeBestModelFeatureGroup(1, ebmBoostings, 3, &meanSingle[0], nullptr));
+   for(size_t iValue = 0; iValue < cValues; ++iValue) {
+      CHECK(meanSingle[iValue] == pTensor0[iValue]);
+   }
+
+   TestApi testBinary = TestApi(2);
+   TrainPredictModel(testBinary, 2);
+   const PEbmBoosting ebmBoostingsMixed[] { test0.GetBoosting(), testBinary.GetBoosting() };
+   CHECK(0 != MergeBestModelFeatureGroup(2, ebmBoostingsMixed, 3, &mean[0], nullptr));
+}
+
+static void CheckModelFile(TestCaseHidden & testCaseHidden, const ptrdiff_t learningTypeOrCountTargetClasses) {
+   TestApi test = TestApi(learningTypeOrCountTargetClasses);
+   TrainPredictModel(test, learningTypeOrCountTargetClasses);
+
+   const bool bRegression = k_learningTypeRegression == learningTypeOrCountTargetClasses;
+   const size_t cClasses = bRegression ? size_t { 1 } : static_cast<size_t>(learningTypeOrCountTargetClasses);
+   const size_t cVectorLength = size_t { 2 } == cClasses ? size_t { 1 } : cClasses;
+
+   const std::vector<FloatEbmType> modelTensors = GetModelTensors(test, cVectorLength);
+   const std::vector<FloatEbmType> intercept = GetIntercept(cVectorLength);
+   const std::vector<FloatEbmType> featureValues = GetFeatureValuesPredict();
+
+   std::vector<FloatEbmType> predictionsBatch(k_cSamplesPredict * cClasses);
+   CHECK(0 == PredictBatchTest(learningTypeOrCountTargetClasses, modelTensors, intercept, featureValues, predictionsBatch));
+
+   for(int iSave = 0; iSave < 2; ++iSave) {
+      if(0 == iSave) {
+         CHECK(0 == (bRegression ?
+            SaveModelRegression(2, k_featuresPredict, k_countBinCutsPredict, k_binCutsPredict, 4, k_featureGroupsPredict,
+               k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0], k_modelFilePath) :
+            SaveModelClassification(learningTypeOrCountTargetClasses, 2, k_featuresPredict, k_countBinCutsPredict,
+               k_binCutsPredict, 4, k_featureGroupsPredict, k_featureGroupIndexesPredict, &modelTensors[0], &intercept[0],
+               k_modelFilePath)));
+      } else {
+         // the booster has the same features and feature groups, so it saves the same model
+         CHECK(0 == SaveBoostingModel(test.GetBoosting(), k_countBinCutsPredict, k_binCutsPredict, &intercept[0],
+            k_modelFilePath));
+      }
+      const PEbmModel model = OpenModel(k_modelFilePath);
+      CHECK(nullptr != model);
+      if(nullptr != model) {
+         std::vector<FloatEbmType> predictionsModel(k_cSamplesPredict * cClasses);
+         CHECK(0 == PredictModel(model, k_cSamplesPredict, &featureValues[0], &predictionsModel[0]));
+         // the mapped arrays are the same as ours, so the predictions should be identical
+         for(size_t iPrediction = 0; iPrediction < predictionsBatch.size(); ++iPrediction) {
+            CHECK(predictionsBatch[iPrediction] == predictionsModel[iPrediction]);
+         }
+         CloseModel(model);
+      }
+      remove(k_modelFilePath);
+   }
+}
+
+TEST_CASE("model file predicts the same as PredictBatch, regression") {
+   CheckModelFile(testCaseHidden, k_learningTypeRegression);
+}
+
+TEST_CASE("model file predicts the same as PredictBatch, binary") {
+   CheckModelFile(testCaseHidden, 2);
+}
+
+TEST_CASE("model file predicts the same as PredictBatch, multiclass") {
+   CheckModelFile(testCaseHidden, 3);
+}
+
+TEST_CASE("model file invalid feature index, regression") {
+   const EbmNativeFeature features[] { { 0, 0, 2 } };
+   const IntEbmType countBinCuts[] { 1 };
+   const FloatEbmType binCuts[] { 1 };
+   const EbmNativeFeatureGroup featureGroups[] { { 1 } };
+   const IntEbmType featureGroupIndexes[] { 1 };
+   const FloatEbmType modelTensors[] { 1, 2 };
+   CHECK(0 != SaveModelRegression(1, features, countBinCuts, binCuts, 1, featureGroups, featureGroupIndexes, modelTensors,
+      nullptr, k_modelFilePath));
+   CHECK(nullptr == OpenModel(k_modelFilePath));
+}
+
+TEST_CASE("model file truncated or from a later version, regression") {
+   const EbmNativeFeature features[] { { 0, 0, 2 } };
+   const IntEbmType countBinCuts[] { 1 };
+   const FloatEbmType binCuts[] { 1 };
+   const EbmNativeFeatureGroup featureGroups[] { { 1 } };
+   const IntEbmType featureGroupIndexes[] { 0 };
+   const FloatEbmType modelTensors[] { 1, 2 };
+   CHECK(0 == SaveModelRegression(1, features, countBinCuts, binCuts, 1, featureGroups, featureGroupIndexes, modelTensors,
+      nullptr, k_modelFilePath));
+
+   std::vector<char> file(4096);
+   FILE * pFile = fopen(k_modelFilePath, "rb");
+   CHECK(nullptr != pFile);
+   if(nullptr == pFile) {
+      return;
+   }
+   const size_t cBytes = fread(&file[0], 1, file.size(), pFile);
+   fclose(pFile);
+   CHECK(sizeof(IntEbmType) < cBytes && cBytes < file.size());
+
+   const PEbmModel model = OpenModel(k_modelFilePath);
+   CHECK(nullptr != model);
+   CloseModel(model);
+
+   // drop the last tensor value
+   pFile = fopen(k_modelFilePath, "wb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      fwrite(&file[0], 1, cBytes - sizeof(FloatEbmType), pFile);
+      fclose(pFile);
+   }
+   CHECK(nullptr == OpenModel(k_modelFilePath));
+
+   // the version follows the magic number
+   ++file[sizeof(IntEbmType)];
+   pFile = fopen(k_modelFilePath, "wb");
+   CHECK(nullptr != pFile);
+   if(nullptr != pFile) {
+      fwrite(&file[0], 1, cBytes, pFile);
+      fclose(pFile);
+   }
+   CHECK(nullptr == OpenModel(k_modelFilePath));
+   remove(k_modelFilePath);
+}
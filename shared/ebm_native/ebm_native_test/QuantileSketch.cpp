@@ -0,0 +1,245 @@
+// Copyright (c) 2018 Microsoft Corporation
+// Licensed under the MIT license.
+// Author: Paul Koch <code@koch.ninja>
+
+#include "PrecompiledHeaderEbmNativeTest.h"
+
+#include "ebm_native.h"
+#include "EbmNativeTest.h"
+
+static const TestPriority k_filePriority = TestPriority::QuantileSketch;
+
+static constexpr IntEbmType k_countItemsPerLevelSketch = 256;
+
+static std::vector<FloatEbmType> MakeSketchValues(const size_t cSamples, const size_t cDistinct) {
+   std::vector<FloatEbmType> values;
+   for(size_t iSample = 0; iSample < cSamples; ++iSample) {
+      FloatEbmType val = static_cast<FloatEbmType>((iSample * 7919 + iSample / 3) % cDistinct) * FloatEbmType { 0.5 };
+      if(0 == iSample % 17) {
+         val = std::numeric_limits<FloatEbmType>::quiet_NaN();
+      } else if(0 == iSample % 101) {
+         val = std::numeric_limits<FloatEbmType>::infinity();
+      } else if(0 == iSample % 103) {
+         val = -std::numeric_limits<FloatEbmType>::infinity();
+      }
+      values.push_back(val);
+   }
+   return values;
+}
+
+class BinCutsResult final {
+public:
+   IntEbmType m_ret;
+   std::vector<FloatEbmType> m_binCuts;
+   IntEbmType m_countMissingValues;
+   FloatEbmType m_minNonInfinityValue;
+   IntEbmType m_countNegativeInfinity;
+   FloatEbmType m_maxNonInfinityValue;
+   IntEbmType m_countPositiveInfinity;
+};
+
+static BinCutsResult ExactCuts(const std::vector<FloatEbmType> & values, const IntEbmType countBinCutsMax,
+   const IntEbmType countSamplesPerBinMin, const IntEbmType isHumanized
+) {
+   std::vector<FloatEbmType> valuesCopy(values);
+   BinCutsResult result;
+   IntEbmType countBinCuts = countBinCutsMax;
+   result.m_binCuts.resize(static_cast<size_t>(countBinCutsMax));
+   result.m_ret = GenerateQuantileBinCuts(static_cast<IntEbmType>(valuesCopy.size()), &valuesCopy[0], countSamplesPerBinMin,
+      isHumanized, k_randomSeed, &countBinCuts, &result.m_binCuts[0], &result.m_countMissingValues,
+      &result.m_minNonInfinityValue, &result.m_countNegativeInfinity, &result.m_maxNonInfinityValue,
+      &result.m_countPositiveInfinity);
+   result.m_binCuts.resize(static_cast<size_t>(countBinCuts));
+   return result;
+}
+
+static BinCutsResult SketchCuts(const PEbmQuantileSketch quantileSketch, const IntEbmType countBinCutsMax,
+   const IntEbmType countSamplesPerBinMin, const IntEbmType isHumanized
+) {
+   BinCutsResult result;
+   IntEbmType countBinCuts = countBinCutsMax;
+   result.m_binCuts.resize(static_cast<size_t>(countBinCutsMax));
+   result.m_ret = GenerateQuantileBinCutsFromSketch(quantileSketch, countSamplesPerBinMin, isHumanized, k_randomSeed,
+      &countBinCuts, &result.m_binCuts[0], &result.m_countMissingValues, &result.m_minNonInfinityValue,
+      &result.m_countNegativeInfinity, &result.m_maxNonInfinityValue, &result.m_countPositiveInfinity);
+   result.m_binCuts.resize(static_cast<size_t>(countBinCuts));
+   return result;
+}
+
+static PEbmQuantileSketch BuildSketch(const std::vector<FloatEbmType> & values, const size_t cChunks) {
+   const PEbmQuantileSketch quantileSketch = CreateQuantileSketch(k_countItemsPerLevelSketch, k_randomSeed);
+   const size_t cSamplesPerChunk = (values.size() + cChunks - 1) / cChunks;
+   for(size_t iStart = 0; iStart < values.size(); iStart += cSamplesPerChunk) {
+      const size_t cSamples = std::min(cSamplesPerChunk, values.size() - iStart);
+      if(0 != AddToQuantileSketch(quantileSketch, static_cast<IntEbmType>(cSamples), &values[iStart])) {
+         FreeQuantileSketch(quantileSketch);
+         return nullptr;
+      }
+   }
+   return quantileSketch;
+}
+
+static void CheckSameStats(TestCaseHidden & testCaseHidden, const BinCutsResult & expected, const BinCutsResult & actual) {
+   CHECK(expected.m_countMissingValues == actual.m_countMissingValues);
+   CHECK(expected.m_minNonInfinityValue == actual.m_minNonInfinityValue);
+   CHECK(expected.m_countNegativeInfinity == actual.m_countNegativeInfinity);
+   CHECK(expected.m_maxNonInfinityValue == actual.m_maxNonInfinityValue);
+   CHECK(expected.m_countPositiveInfinity == actual.m_countPositiveInfinity);
+}
+
+static void CheckSameCuts(TestCaseHidden & testCaseHidden, const BinCutsResult & expected, const BinCutsResult & actual) {
+   CHECK(0 == expected.m_ret);
+   CHECK(0 == actual.m_ret);
+   CheckSameStats(testCaseHidden, expected, actual);
+   CHECK(expected.m_binCuts.size() == actual.m_binCuts.size());
+   if(expected.m_binCuts.size() == actual.m_binCuts.size()) {
+      for(size_t iCut = 0; iCut < expected.m_binCuts.size(); ++iCut) {
+         CHECK(expected.m_binCuts[iCut] == actual.m_binCuts[iCut]);
+      }
+   }
+}
+
+static size_t CountBelow(const std::vector<FloatEbmType> & values, const FloatEbmType cut) {
+   size_t cBelow = 0;
+   for(const FloatEbmType val : values) {
+      if(!std::isnan(val) && val < cut) {
+         ++cBelow;
+      }
+   }
+   return cBelow;
+}
+
+TEST_CASE("GenerateQuantileBinCutsFromSketch, before compaction matches GenerateQuantileBinCuts") {
+   const std::vector<FloatEbmType> values = MakeSketchValues(200, 37);
+   for(IntEbmType isHumanized = EBM_FALSE; isHumanized <= EBM_TRUE; ++isHumanized) {
+      const BinCutsResult expected = ExactCuts(values, 9, 3, isHumanized);
+
+      const PEbmQuantileSketch quantileSketch = BuildSketch(values, 1);
+      CHECK(nullptr != quantileSketch);
+      CheckSameCuts(testCaseHidden, expected, SketchCuts(quantileSketch, 9, 3, isHumanized));
+      FreeQuantileSketch(quantileSketch);
+
+      // chunks merged from several sketches hold the same values
+      const std::vector<FloatEbmType> valuesLow(values.begin(), values.begin() + 77);
+      const std::vector<FloatEbmType> valuesHigh(values.begin() + 77, values.end());
+      const PEbmQuantileSketch quantileSketchLow = BuildSketch(valuesLow, 3);
+      const PEbmQuantileSketch quantileSketchHigh = BuildSketch(valuesHigh, 2);
+      CHECK(0 == MergeQuantileSketch(quantileSketchLow, quantileSketchHigh));
+      CheckSameCuts(testCaseHidden, expected, SketchCuts(quantileSketchLow, 9, 3, isHumanized));
+      FreeQuantileSketch(quantileSketchLow);
+      FreeQuantileSketch(quantileSketchHigh);
+   }
+}
+
+TEST_CASE("GenerateQuantileBinCutsFromSketch, compacted sketch places cuts near the exact quantiles") {
+   const std::vector<FloatEbmType> values = MakeSketchValues(100000, 5003);
+   const BinCutsResult expected = ExactCuts(values, 15, 100, EBM_FALSE);
+   CHECK(0 == expected.m_ret);
+
+   // building in one piece and merging many small sketches compact differently, but both stay accurate
+   const PEbmQuantileSketch quantileSketchWhole = BuildSketch(values, 7);
+   PEbmQuantileSketch quantileSketchMerged = CreateQuantileSketch(k_countItemsPerLevelSketch, k_randomSeed);
+   for(size_t iPart = 0; iPart < 10; ++iPart) {
+      const std::vector<FloatEbmType> part(values.begin() + iPart * 10000, values.begin() + (iPart + 1) * 10000);
+      const PEbmQuantileSketch quantileSketchPart = BuildSketch(part, 1);
+      CHECK(0 == MergeQuantileSketch(quantileSketchMerged, quantileSketchPart));
+      FreeQuantileSketch(quantileSketchPart);
+   }
+
+   const PEbmQuantileSketch aQuantileSketches[] { quantileSketchWhole, quantileSketchMerged };
+   for(const PEbmQuantileSketch quantileSketch : aQuantileSketches) {
+      const BinCutsResult actual = SketchCuts(quantileSketch, 15, 100, EBM_FALSE);
+      CHECK(0 == actual.m_ret);
+      CheckSameStats(testCaseHidden, expected, actual);
+      CHECK(expected.m_binCuts.size() == actual.m_binCuts.size());
+      if(expected.m_binCuts.size() == actual.m_binCuts.size()) {
+         for(size_t iCut = 0; iCut < expected.m_binCuts.size(); ++iCut) {
+            const size_t cBelowExpected = CountBelow(values, expected.m_binCuts[iCut]);
+            const size_t cBelowActual = CountBelow(values, actual.m_binCuts[iCut]);
+            const size_t cDifference = cBelowExpected < cBelowActual ? cBelowActual - cBelowExpected : cBelowExpected - cBelowActual;
+            CHECK(cDifference <= values.size() / 50);
+         }
+      }
+
+      // the sketch holds far fewer values than were added
+      IntEbmType countBytes = 0;
+      CHECK(0 == GetQuantileSketchSerializedSize(quantileSketch, &countBytes));
+      CHECK(static_cast<size_t>(countBytes) < values.size() * sizeof(FloatEbmType) / 10);
+   }
+   FreeQuantileSketch(quantileSketchWhole);
+   FreeQuantileSketch(quantileSketchMerged);
+}
+
+TEST_CASE("SerializeQuantileSketch, round trip") {
+   const std::vector<FloatEbmType> values = MakeSketchValues(20000, 1009);
+   const PEbmQuantileSketch quantileSketch = BuildSketch(values, 4);
+   CHECK(nullptr != quantileSketch);
+
+   IntEbmType countBytes = 0;
+   CHECK(0 == GetQuantileSketchSerializedSize(quantileSketch, &countBytes));
+   std::vector<char> buffer(static_cast<size_t>(countBytes));
+   CHECK(0 != SerializeQuantileSketch(quantileSketch, countBytes - 1, &buffer[0]));
+   CHECK(0 == SerializeQuantileSketch(quantileSketch, countBytes, &buffer[0]));
+
+   const PEbmQuantileSketch quantileSketchCopy = DeserializeQuantileSketch(countBytes, &buffer[0]);
+   CHECK(nullptr != quantileSketchCopy);
+   CheckSameCuts(testCaseHidden, SketchCuts(quantileSketch, 20, 10, EBM_TRUE), SketchCuts(quantileSketchCopy, 20, 10, EBM_TRUE));
+
+   // the copy keeps working like the original, since serializing doesn't change the original
+   const std::vector<FloatEbmType> moreValues = MakeSketchValues(3000, 401);
+   CHECK(0 == AddToQuantileSketch(quantileSketch, static_cast<IntEbmType>(moreValues.size()), &moreValues[0]));
+   CHECK(0 == AddToQuantileSketch(quantileSketchCopy, static_cast<IntEbmType>(moreValues.size()), &moreValues[0]));
+   const BinCutsResult original = SketchCuts(quantileSketch, 20, 10, EBM_FALSE);
+   const BinCutsResult copy = SketchCuts(quantileSketchCopy, 20, 10, EBM_FALSE);
+   CHECK(0 == copy.m_ret);
+   CheckSameStats(testCaseHidden, original, copy);
+
+   CHECK(nullptr == DeserializeQuantileSketch(countBytes - 1, &buffer[0]));
+   buffer[0] = static_cast<char>(buffer[0] + 1);
+   CHECK(nullptr == DeserializeQuantileSketch(countBytes, &buffer[0]));
+
+   FreeQuantileSketch(quantileSketch);
+   FreeQuantileSketch(quantileSketchCopy);
+}
+
+TEST_CASE("GenerateQuantileBinCutsFromSketch, empty and all missing") {
+   const PEbmQuantileSketch quantileSketch = CreateQuantileSketch(k_countItemsPerLevelSketch, k_randomSeed);
+   CHECK(nullptr != quantileSketch);
+   BinCutsResult result = SketchCuts(quantileSketch, 5, 1, EBM_FALSE);
+   CHECK(0 == result.m_ret);
+   CHECK(0 == result.m_binCuts.size());
+   CHECK(0 == result.m_countMissingValues);
+
+   const FloatEbmType missing[] { std::numeric_limits<FloatEbmType>::quiet_NaN(), std::numeric_limits<FloatEbmType>::quiet_NaN() };
+   CHECK(0 == AddToQuantileSketch(quantileSketch, 2, missing));
+   result = SketchCuts(quantileSketch, 5, 1, EBM_FALSE);
+   CHECK(0 == result.m_ret);
+   CHECK(0 == result.m_binCuts.size());
+   CHECK(2 == result.m_countMissingValues);
+   CHECK(0 == result.m_minNonInfinityValue);
+   CHECK(0 == result.m_maxNonInfinityValue);
+   FreeQuantileSketch(quantileSketch);
+}
+
+TEST_CASE("QuantileSketch, invalid parameters") {
+   CHECK(nullptr == CreateQuantileSketch(0, k_randomSeed));
+
+   const PEbmQuantileSketch quantileSketch = CreateQuantileSketch(k_countItemsPerLevelSketch, k_randomSeed);
+   const PEbmQuantileSketch quantileSketchOther = CreateQuantileSketch(k_countItemsPerLevelSketch * 2, k_randomSeed);
+   const FloatEbmType value = 1;
+   CHECK(0 != AddToQuantileSketch(nullptr, 1, &value));
+   CHECK(0 != AddToQuantileSketch(quantileSketch, -1, &value));
+   CHECK(0 != AddToQuantileSketch(quantileSketch, 1, nullptr));
+   CHECK(0 != MergeQuantileSketch(quantileSketch, quantileSketch));
+   CHECK(0 != MergeQuantileSketch(quantileSketch, quantileSketchOther));
+   CHECK(0 != MergeQuantileSketch(quantileSketch, nullptr));
+
+   IntEbmType countBinCuts = 3;
+   FloatEbmType binCuts[3];
+   CHECK(0 != GenerateQuantileBinCutsFromSketch(nullptr, 1, EBM_FALSE, k_randomSeed, &countBinCuts, binCuts,
+      nullptr, nullptr, nullptr, nullptr, nullptr));
+   CHECK(0 == countBinCuts);
+
+   FreeQuantileSketch(quantileSketch);
+   FreeQuantileSketch(quantileSketchOther);
+}
@@ -9,7 +9,7 @@
 
 static const TestPriority k_filePriority = TestPriority::RandomNumberEquivalency;
 
-TEST_CASE("test random number generator equivalency") {
+static FloatEbmType BoostRandomNumberEquivalency(const std::vector<FloatEbmType> optionalTempParams) {
    TestApi test = TestApi(2);
    test.AddFeatures({ FeatureTest(2) });
    test.AddFeatureGroups({ { 0 } });
@@ -22,7 +22,7 @@ TEST_CASE("test random number generator equivalency") {
    test.AddTrainingSamples(samples);
    test.AddValidationSamples({ ClassificationSample(0, { 0 }), ClassificationSample(1, { 1 }) });
 
-   test.InitializeBoosting(2);
+   test.InitializeBoosting(2, optionalTempParams);
 
    for(int iEpoch = 0; iEpoch < 100; ++iEpoch) {
       for(size_t iFeatureGroup = 0; iFeatureGroup < test.GetFeatureGroupsCount(); ++iFeatureGroup) {
@@ -30,10 +30,20 @@ TEST_CASE("test random number generator equivalency") {
       }
    }
 
-   FloatEbmType modelValue = test.GetCurrentModelPredictorScore(0, { 0 }, 1);
+   return test.GetCurrentModelPredictorScore(0, { 0 }, 1);
+}
+
+TEST_CASE("test random number generator equivalency") {
+   FloatEbmType modelValue = BoostRandomNumberEquivalency({});
    // this is meant to be an exact check for this value.  We are testing here if we can generate identical results
    // accross different OSes and C/C++ libraries.  We specificed 2 inner samples, which will use the random generator
    // and if there are any differences between environments then this will catch those
    CHECK_APPROX(modelValue, 0.0057459461127468267);
 }
 
+TEST_CASE("test random number generator equivalency with block draws") {
+   // block draws make different bags than the default, but they need to be just as identical across environments, 
+   // thread counts and instruction sets
+   FloatEbmType modelValue = BoostRandomNumberEquivalency(MakeTempParams({ { TempParamBoostingBlockDraws, 1 } }));
+   CHECK_APPROX(modelValue, 0.043670232461968404);
+}
@@ -27,12 +27,24 @@ compile_all=""
 compile_all="$compile_all \"$src_path/EbmNativeTest.cpp\""
 
 compile_all="$compile_all \"$src_path/BitPackingExtremes.cpp\""
+compile_all="$compile_all \"$src_path/BoostingAppend.cpp\""
+compile_all="$compile_all \"$src_path/BoostingAsync.cpp\""
+compile_all="$compile_all \"$src_path/BoostingCheckpoint.cpp\""
+compile_all="$compile_all \"$src_path/BoostingDeferredValidation.cpp\""
+compile_all="$compile_all \"$src_path/BoostingPacked.cpp\""
+compile_all="$compile_all \"$src_path/BoostingParallel.cpp\""
+compile_all="$compile_all \"$src_path/BoostingRun.cpp\""
 compile_all="$compile_all \"$src_path/BoostingUnusualInputs.cpp\""
+compile_all="$compile_all \"$src_path/BoostingWarmStart.cpp\""
+compile_all="$compile_all \"$src_path/BoostingWeighted.cpp\""
 compile_all="$compile_all \"$src_path/Discretize.cpp\""
 compile_all="$compile_all \"$src_path/GenerateQuantileBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/GenerateUniformBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/GenerateWinsorizedBinCuts.cpp\""
 compile_all="$compile_all \"$src_path/InteractionUnusualInputs.cpp\""
+compile_all="$compile_all \"$src_path/LogBuffer.cpp\""
+compile_all="$compile_all \"$src_path/PredictBatch.cpp\""
+compile_all="$compile_all \"$src_path/QuantileSketch.cpp\""
 compile_all="$compile_all \"$src_path/RandomInterface.cpp\""
 compile_all="$compile_all \"$src_path/RandomNumberEquivalency.cpp\""
 compile_all="$compile_all \"$src_path/Rehydration.cpp\""
@@ -86,6 +86,26 @@ typedef struct _EbmInteraction {
    // In C/C++ languages the caller will get an error if they try to mix these pointer types.
    char unused;
 } * PEbmInteraction;
+typedef struct _EbmPackedData {
+   // this struct exists to enforce that our caller doesn't mix packed data with EbmBoosting or EbmInteraction pointers
+   char unused;
+} * PEbmPackedData;
+typedef struct _EbmPackedDataBuilder {
+   // this struct exists to enforce that our caller doesn't mix packed data builders with PEbmPackedData pointers
+   char unused;
+} * PEbmPackedDataBuilder;
+typedef struct _EbmWork {
+   // this struct exists to enforce that our caller doesn't mix work tokens with EbmBoosting or EbmInteraction pointers
+   char unused;
+} * PEbmWork;
+typedef struct _EbmModel {
+   // this struct exists to enforce that our caller doesn't mix models with EbmBoosting or EbmPackedData pointers
+   char unused;
+} * PEbmModel;
+typedef struct _EbmQuantileSketch {
+   // this struct exists to enforce that our caller doesn't mix quantile sketches with our other pointer types
+   char unused;
+} * PEbmQuantileSketch;
 
 #ifndef PRId64
 // this should really be defined, but some compilers aren't compliant
@@ -114,7 +134,9 @@ const IntEbmType FeatureTypeNominal = 1;
 typedef struct _EbmNativeFeature {
    // enums and bools aren't standardized accross languages, so use IntEbmType values
    IntEbmType featureType;
-   // TODO: figure out if hasMissing is still this required now that we put missing in the top bin?
+   // if hasMissing is EBM_TRUE then the 0th bin holds the missing values and the remaining bins hold the non-missing 
+   // values in order, so callers don't need to impute.  Discretize puts missing values in the top bin, so its 
+   // results need to be rotated before they can be passed in with hasMissing set
    IntEbmType hasMissing;
    IntEbmType countBins;
 } EbmNativeFeature;
@@ -123,6 +145,14 @@ typedef struct _EbmNativeFeatureGroup {
    IntEbmType countFeaturesInGroup;
 } EbmNativeFeatureGroup;
 
+typedef struct _EbmNativeBinnedColumn {
+   // the bin of sample i is read from (const char *)data + i * countBytesStride, which does not need to be aligned
+   const void * data;
+   // 1, 2 or 4 for unsigned bins, or 8 for IntEbmType bins
+   IntEbmType countBytesPerBin;
+   IntEbmType countBytesStride;
+} EbmNativeBinnedColumn;
+
 // SetLogMessageFunction does not need to be called if the level is left at TraceLevelOff
 const signed char TraceLevelOff = 0; // no messages will be output
 const signed char TraceLevelError = 1; // invalid inputs to the C library or assert failure before exit
@@ -138,6 +168,53 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetLogMessag
 );
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetTraceLevel(signed char traceLevel);
 
+// by default, log messages are delivered to the LOG_MESSAGE_FUNCTION on whichever thread logs them, including our
+// background threads.  SetLogBuffer with a non-zero countMessages instead queues messages into a lock-free buffer that 
+// holds countMessages messages (rounded up to a power of two), and the caller delivers them on its own thread by 
+// calling DrainLogMessages.  Messages that arrive while the buffer is full are dropped and counted.  A countMessages of 
+// zero returns to direct delivery.  Anything still queued is delivered before the buffer changes, and SetLogBuffer must 
+// not be called while any other call into this library is in progress.  Returns 0 on success
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SetLogBuffer(IntEbmType countMessages);
+// delivers the queued messages in order on the calling thread and returns how many were delivered.  countDroppedOut
+// can be nullptr, otherwise it receives the number of messages dropped since the previous drain.  Only one thread can 
+// drain at a time, but other threads can keep logging while it does
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION DrainLogMessages(IntEbmType * countDroppedOut);
+
+// our largest buffers are the packed data, the residuals and scores of our data sets, and the scratch buffers of each
+// thread.  On linux, these can be backed by 2MB huge pages when they are at least that big.  SetHugePages only
+// changes allocations that happen after it is called
+const IntEbmType HugePagesOff = 0; // the default, which uses malloc for everything
+const IntEbmType HugePagesTransparent = 1; // ask the kernel to back our large buffers with transparent huge pages
+const IntEbmType HugePagesExplicit = 2; // use reserved huge pages, and transparent huge pages if none are reserved
+
+// on linux machines with several NUMA nodes, memory normally lands on the node of the thread that first writes it, 
+// which puts all of our data set and packed data on the node of the thread that called InitializeBoosting.  Our 
+// worker threads then all pull from that one memory controller.  Interleaving spreads the pages of those buffers 
+// round robin over the nodes, which uses the bandwidth of every socket.  Only buffers of at least 2MB are interleaved, 
+// and SetNumaPlacement only changes allocations that happen after it is called.  NumaPlacementInterleavePinned also 
+// pins the threads of our pool round robin to the nodes, and each boosting step then adds up its shard histograms 
+// within each node before it adds the node totals together.  Threads that are already running keep their affinity 
+// until ShutdownThreadPool.  The sums still add up the shards in a fixed order, so results are reproducible for a 
+// given number of shards and nodes, but with several nodes they can differ in the last bits from the other placements
+const IntEbmType NumaPlacementFirstTouch = 0; // the default, which leaves placement to the operating system
+const IntEbmType NumaPlacementInterleave = 1; // interleave our data set and packed data buffers over the NUMA nodes
+const IntEbmType NumaPlacementInterleavePinned = 2; // interleave, and keep each of our threads on a single node
+
+// the subsystems that GetMemoryStatistics reports on
+const IntEbmType MemorySubsystemDataSet = 0; // bit packed inputs, targets, residuals and scores of our data sets
+const IntEbmType MemorySubsystemPackedData = 1; // PEbmPackedData and PEbmPackedDataBuilder storage
+const IntEbmType MemorySubsystemThreadBuffers = 2; // histograms and tree nodes that each thread works in
+
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetHugePages(IntEbmType hugePages);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetNumaPlacement(IntEbmType numaPlacement);
+// the byte counts include our alignment padding and huge page rounding, since that's what the process holds.  Either 
+// output can be nullptr.  Returns 0 on success
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GetMemoryStatistics(
+   IntEbmType memorySubsystem,
+   IntEbmType * countBytesCurrentOut,
+   IntEbmType * countBytesPeakOut
+);
+
 // BINARY VS MULTICLASS AND LOGIT REDUCTION
 // - I initially considered storing our model files as negated logits [storing them as (0 - mathematical_logit)], but that's a bad choice because:
 //   - if you use the wrong formula, you need a negation for binary classification, but the best formula requires a logit without negation 
@@ -292,13 +369,117 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SetTraceLeve
 //         so we can initialze it by writing the cut model directly without bothering to handle inserting into the tree at the end
 
 
-// TODO: we should change our interface such that long running work items will return instantly but are working on
-//       a background thread.  The caller will get back a token to the work.  They can either start a number of
-//       work items simultaneously, or call a blocking function that waits on any/all work items to complete.
-//       The log in this world would be a circular buffer and wouldn't be writtent out unless the C++ code was
-//       controlling the main thread (either during calls to the non-blocking components, or while the caller is
-//       in the waiting function).  We would drop anything that exceeds the circular buffer.  This allows us to have
-//       threaded code inside non-threaded languages.
+// ASYNCHRONOUS WORK
+// - long running work items can be started with the *Async functions which return a PEbmWork token immediately while
+//   the work is processed on a background thread.  The caller can start a number of work items simultaneously, and then
+//   call WaitForWork to block until any or all of them complete.  Every token must be released with FinishWork, which
+//   also blocks until the work is complete and returns the same error code and metric as the synchronous function
+// - work items for the same PEbmBoosting object are executed one at a time in the order that they were started, so
+//   the results are identical to calling the synchronous functions in that order.  Work items for different
+//   PEbmBoosting objects run in parallel
+// - each boosting step depends on the residuals left behind by the previous step, so the parallelism comes from 
+//   boosting several PEbmBoosting objects at once, for instance one per outer bag.  BoostingRunAsync runs all the 
+//   rounds of BoostingRun as a single work item, so a caller can keep one outer bag boosting on each thread.  The 
+//   progressFunction of BoostingRunAsync is called on the background thread
+// - the threads are started when work is first submitted.  ShutdownThreadPool joins them, and needs to be called 
+//   before the library is unloaded from a process that keeps running.  It returns non-zero if any work is in 
+//   progress.  Work started afterwards starts new threads
+// - the caller must not call the synchronous functions on a PEbmBoosting object while it has work in progress. 
+//   FreeBoosting waits for any work in progress on the object before freeing it
+// - any pointers passed into the *Async functions must remain valid until the work completes
+// - log messages can be delivered from the background threads unless the caller uses SetLogBuffer, in which case they
+//   are only delivered on the thread that calls DrainLogMessages
+
+// optionalTempParams is either nullptr or an array where optionalTempParams[0] holds the number of parameters that
+// follow it.  Parameters that are not included take their default values, and so do parameters that are set to 0, 
+// which lets callers zero the whole array and then set only the parameters that they want.  These parameters are 
+// EXPERIMENTAL and can change or disappear in any release.  The constants below are indexes into the 
+// optionalTempParams array.
+// - TempParamBoostingCountShards: the number of contiguous sample shards that we build histograms on in parallel
+//   during boosting.  The default of 1 builds histograms serially.  Results are deterministic for any given
+//   number of shards, but floating point sums can differ slightly between different numbers of shards
+// - TempParamBoostingFractionWithoutReplacement: if non-zero, each inner bag is sampled without replacement and holds
+//   this fraction (0, 1] of the training samples.  Bag membership is then stored as a single bit per sample instead
+//   of a count.  The default of 0 samples with replacement.  Ignored when there are no inner bags
+// - TempParamBoostingCacheDenominators: if non-zero, the Newton-Raphson denominators for classification are computed
+//   once per residual update and stored per sample instead of being recomputed in every inner bag.  This trades
+//   memory bandwidth for CPU.  Results are identical either way.  Ignored for regression
+// - TempParamBoostingSimd: the most capable SIMD instruction set that we can use to apply model updates, where 0 is
+//   none (the default), 1 allows SSE4.2, AVX2 and NEON, and 2 also allows AVX-512.  We use the best one that the CPU
+//   supports.  The SIMD exp and log differ from the standard library in the last few bits, so results differ
+//   slightly from the scalar code.  Ignored for multiclass.  Discretize always uses SIMD when available since its
+//   results are exact
+// - TempParamBoostingSinglePrecision: if non-zero, the training set stores its residuals, cached denominators and 
+//   predictor scores as 32 bit floats, which halves the memory bandwidth of boosting.  Every calculation and the 
+//   histogram sums still use FloatEbmType, and the validation set is unaffected.  The default is 0
+// - TempParamBoostingDeduplicate: if non-zero, samples with identical binned data, targets and predictor scores are
+//   collapsed into a single sample whose weight is the sum of their weights before we pack them, which shrinks the 
+//   data that boosting reads when many samples fall into the same bins.  Without inner bags the results match boosting
+//   on the original samples up to floating point summation order.  Inner bags make the same number of draws, but the
+//   random numbers pick different samples.  Ignored for packed data since it is packed already.  The default is 0
+// - TempParamBoostingDeferValidation: if non-zero, ApplyModelFeatureGroupUpdate and BoostingStep only update the 
+//   validation set when validationMetricOut is not nullptr.  Updates applied with a nullptr validationMetricOut are
+//   held back until the next call that asks for the metric, which applies all of them in a single pass over the 
+//   validation set.  The best model is only updated when the metric is calculated, so it can not include updates that
+//   are still held back.  BoostingRun then only calculates the metric once per round.  The default is 0
+// - TempParamInteractionScreenSamples: if non-zero, CalculateInteractionScorePairs first scores every pair on a random
+//   subset of this many samples, and then re-scores only the best pairs of the screening on all the samples.  The
+//   default of 0 scores every pair on all the samples.  Ignored by the Boosting functions
+// - TempParamInteractionScreenCandidates: the number of pairs that are re-scored on all the samples after screening.
+//   The default is 64.  Ignored unless TempParamInteractionScreenSamples is set
+// - TempParamInteractionScreenSeed: the random seed that picks the samples for screening, with a default of 0.  The
+//   same seed picks the same samples, so screening is reproducible.  Ignored unless TempParamInteractionScreenSamples
+//   is set
+// - TempParamBoostingAlignedPacking: if non-zero, feature groups that need more than 2 bits per bin index round their
+//   bit packing up to 4, 8, 16 or 32 bits per item so that unpacking never shifts across a nibble or byte boundary.
+//   The value is the largest growth that we accept in the size of the bit packed data, so 1.5 aligns a group only if
+//   that needs at most 1.5 times as many data units.  Results are identical either way.  Ignored for packed data,
+//   which keeps the packing that it was created with.  The default of 0 packs as many items as fit
+// - TempParamBoostingClassMajor: if non-zero, multiclass training sets store the residuals, denominators and 
+//   predictor scores of each class contiguously instead of keeping the values of each sample together.  Model updates
+//   then run one class at a time over blocks of samples.  Results are identical either way.  Ignored for regression 
+//   and binary classification.  The default is 0
+// - TempParamBoostingConcurrentSlots: the number of slots that GenerateModelFeatureGroupUpdateSlot accepts, capped at
+//   64.  Each slot has its own copy of the per-bag boosting buffers, so memory grows with the count.  Slot 0 behaves
+//   exactly like a booster with 1 slot.  The default is 1
+// - TempParamBoostingSampleIndexBinsMax: if non-zero, each feature group with a single feature of at most this many
+//   bins gets an index of its training samples grouped by bin when boosting is initialized.  Histograms of those 
+//   groups are then built one bin at a time from the index instead of unpacking the bin of every sample.  The index 
+//   takes one size_t per training sample for each indexed group.  Results are identical either way.  The default of 0 
+//   indexes nothing
+// - TempParamBoostingPairCutsPerTask: pair feature groups evaluate every cut of one feature against the cuts of the
+//   other.  When a pair has enough cut combinations, the combinations are split across the thread pool with at least
+//   this many per task.  Results are identical either way.  A count above the cut combinations of every pair sweeps 
+//   them all on the calling thread.  The default is 4096
+// - TempParamBoostingScheduleGainFraction: if non-zero, BoostingRun skips each round the feature groups whose gain on
+//   their last step was below this fraction of the largest last gain of any group, which saves the passes over the
+//   data for groups that stopped improving the model in late rounds.  Must be from 0 to 1.  BoostingStep and the 
+//   other Boosting functions boost whichever group they are given.  The default of 0 boosts every group each round
+// - TempParamBoostingScheduleReprobeRounds: a feature group that BoostingRun has skipped for this many rounds in a row
+//   is boosted on the next round, which updates its gain in case it has started to matter again.  The default is 10.
+//   Ignored unless TempParamBoostingScheduleGainFraction is set
+// - TempParamBoostingBlockDraws: if non-zero, inner bags sampled with replacement draw their samples in blocks of 
+//   65536, each from its own stream seeded from the main one.  The blocks are generated in parallel with SIMD.  The 
+//   bags are still reproducible and don't depend on the thread count or instruction set, but they differ from the 
+//   bags of the default for the same seed.  The default of 0 draws every sample from the main stream
+const IntEbmType TempParamBoostingCountShards = 1;
+const IntEbmType TempParamBoostingFractionWithoutReplacement = 2;
+const IntEbmType TempParamBoostingCacheDenominators = 3;
+const IntEbmType TempParamBoostingSimd = 4;
+const IntEbmType TempParamInteractionScreenSamples = 5;
+const IntEbmType TempParamInteractionScreenCandidates = 6;
+const IntEbmType TempParamInteractionScreenSeed = 7;
+const IntEbmType TempParamBoostingSinglePrecision = 8;
+const IntEbmType TempParamBoostingDeduplicate = 9;
+const IntEbmType TempParamBoostingDeferValidation = 10;
+const IntEbmType TempParamBoostingAlignedPacking = 11;
+const IntEbmType TempParamBoostingClassMajor = 12;
+const IntEbmType TempParamBoostingConcurrentSlots = 13;
+const IntEbmType TempParamBoostingSampleIndexBinsMax = 14;
+const IntEbmType TempParamBoostingPairCutsPerTask = 15;
+const IntEbmType TempParamBoostingScheduleGainFraction = 16;
+const IntEbmType TempParamBoostingScheduleReprobeRounds = 17;
+const IntEbmType TempParamBoostingBlockDraws = 18;
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassification(
    IntEbmType countTargetClasses,
@@ -337,6 +518,268 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION Init
    IntEbmType randomSeed,
    const FloatEbmType * optionalTempParams
 );
+// SAMPLE WEIGHTS
+// - InitializeBoostingClassificationWeighted and InitializeBoostingRegressionWeighted are like their unweighted 
+//   versions, but each sample has a non-negative integer frequency weight, so a sample with weight w boosts exactly as
+//   w copies of it would.  The weights change how the bags are drawn, the hessian sums, 
+//   countSamplesRequiredForChildSplitMin, and the validation metric, which becomes a weighted average.  Either weight 
+//   array can be nullptr to give each of its samples a weight of 1.  A data set with samples needs at least one 
+//   non-zero weight.  Weights that aren't integers such as importance weights are not supported yet
+// - the trainingWeights and validationWeights parameters of GenerateModelFeatureGroupUpdate, BoostingStep and 
+//   BoostingStepAsync must be nullptr since the weights are known when boosting is initialized
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationWeighted(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionWeighted(
+   IntEbmType countFeatures, 
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups, 
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes, 
+   IntEbmType countTrainingSamples, 
+   const IntEbmType * trainingBinnedData, 
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples, 
+   const IntEbmType * validationBinnedData, 
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+// WARM START
+// - InitializeBoostingClassificationWarmStart and InitializeBoostingRegressionWarmStart are like their weighted 
+//   versions, but boosting continues from an existing model instead of having our caller score the data with it.  
+//   initialModelFeatureGroupTensors holds the tensor of each feature group in the layout of 
+//   GetCurrentModelFeatureGroup, one feature group after another, and its scores are added to the predictor scores 
+//   while the data sets are built.  The predictor scores can be nullptr here to start from zeros, or hold offsets 
+//   such as an intercept that the tensors don't include
+// - the initial model only moves the starting scores, like precomputed predictor scores would, so the models of the 
+//   booster hold what boosting adds to it and start out as zeros
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationWarmStart(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * initialModelFeatureGroupTensors,
+   IntEbmType countTrainingSamples,
+   const IntEbmType * trainingBinnedData,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples,
+   const IntEbmType * validationBinnedData,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionWarmStart(
+   IntEbmType countFeatures, 
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups, 
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes, 
+   const FloatEbmType * initialModelFeatureGroupTensors,
+   IntEbmType countTrainingSamples, 
+   const IntEbmType * trainingBinnedData, 
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   const IntEbmType * trainingWeights,
+   IntEbmType countValidationSamples, 
+   const IntEbmType * validationBinnedData, 
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   const IntEbmType * validationWeights,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+// MEMORY ESTIMATES
+// - EstimateBoostingMemoryClassification and EstimateBoostingMemoryRegression take the shapes that 
+//   InitializeBoostingClassification and InitializeBoostingRegression take, and estimate the peak number of bytes 
+//   that boosting with them holds, without reading or allocating any data.  A scheduler can use this to place jobs 
+//   on hosts before it loads their data.  Returns 0 on success
+// - countBytesOut receives MemoryEstimateCountItems values.  The MemorySubsystem* items estimate what 
+//   GetMemoryStatistics adds for the booster, with the current SetHugePages and SetNumaPlacement settings, and they 
+//   match it exactly for binned data without weights.  Deduplication can only lower them.  MemoryEstimateHeap is 
+//   everything else that we allocate with malloc, which GetMemoryStatistics doesn't track: the models once each of 
+//   their tensors is fully split, the inner bags, the sample indexes and the scratch tensors of each bag
+// - boosting from packed data moves the bit packed features out of MemorySubsystemDataSet into the packed data, 
+//   weights add a size_t per sample to the heap.  The heap also grows by a few vectors of FloatEbmType per bag 
+//   while boosting
+const IntEbmType MemoryEstimateHeap = 3;
+const IntEbmType MemoryEstimateCountItems = 4;
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION EstimateBoostingMemoryClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   IntEbmType countValidationSamples,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   IntEbmType * countBytesOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION EstimateBoostingMemoryRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   IntEbmType countValidationSamples,
+   IntEbmType countInnerBags,
+   const FloatEbmType * optionalTempParams,
+   IntEbmType * countBytesOut
+);
+// PACKED DATA
+// - SaveBoostingPackedData writes the bit packed binned data that a booster built during initialization.  Either 
+//   file path can be nullptr to skip that data set.  The file depends on the features and feature groups, so it can 
+//   only be used with the same features and feature groups later
+// - OpenPackedData maps such a file read-only.  Several processes that open the same file share its memory
+// - CreatePackedData bit packs binned data once into memory, so that the boosters of several outer bags in one 
+//   process can share a single copy of it
+// - CreatePackedDataFromColumns is like CreatePackedData, but reads one typed column per feature, so narrow or 
+//   column-major binned data can be packed without first widening it into IntEbmType binnedData
+// - BeginPackedData, AppendPackedData and FinishPackedData build the same packed data from chunks of samples, so 
+//   the caller never needs to hold all of the binned data at once.  countSamples is the total of all the chunks, 
+//   which are appended in sample order and in the same column format as CreatePackedDataFromColumns.  
+//   FinishPackedData fails unless exactly countSamples samples were appended.  A failed AppendPackedData leaves a 
+//   partial chunk behind, so FinishPackedData fails after it too.  FreePackedDataBuilder must be called whether or 
+//   not FinishPackedData succeeds, and the packed data outlives the builder
+// - SavePackedData writes packed data from any of the above to a file that OpenPackedData can map.  A parent 
+//   process can pack the data once and save it, for instance under /dev/shm on Linux, so that each worker process 
+//   maps the same physical pages by opening the file instead of holding its own copy.  Each worker then selects 
+//   the samples of its outer bag with the sample masks below
+// - InitializeBoostingClassificationPacked and InitializeBoostingRegressionPacked use the packed data in place 
+//   instead of bit packing the binned data again.  Each booster holds a reference to the packed data, so 
+//   ClosePackedData can be called as soon as the boosters are initialized.  The data is freed when the last one 
+//   goes away
+// - trainingSampleMask and validationSampleMask can be nullptr to use every sample of the packed data.  Otherwise 
+//   they have one item per sample of the packed data and only samples with a non-zero value belong to the data set.  
+//   The targets and predictor scores still have one item per sample of the packed data, but the values of samples 
+//   outside of the mask are never used for the metric or the model.  Each mask needs at least one non-zero value
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingClassificationPacked(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countTrainingSamples,
+   PEbmPackedData trainingPackedData,
+   const IntEbmType * trainingSampleMask,
+   const IntEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples,
+   PEbmPackedData validationPackedData,
+   const IntEbmType * validationSampleMask,
+   const IntEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmBoosting EBM_NATIVE_CALLING_CONVENTION InitializeBoostingRegressionPacked(
+   IntEbmType countFeatures, 
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups, 
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes, 
+   IntEbmType countTrainingSamples, 
+   PEbmPackedData trainingPackedData, 
+   const IntEbmType * trainingSampleMask,
+   const FloatEbmType * trainingTargets,
+   const FloatEbmType * trainingPredictorScores,
+   IntEbmType countValidationSamples, 
+   PEbmPackedData validationPackedData, 
+   const IntEbmType * validationSampleMask,
+   const FloatEbmType * validationTargets,
+   const FloatEbmType * validationPredictorScores,
+   IntEbmType countInnerBags,
+   IntEbmType randomSeed,
+   const FloatEbmType * optionalTempParams
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingPackedData(
+   PEbmBoosting ebmBoosting,
+   const char * trainingFilePath,
+   const char * validationFilePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmPackedData EBM_NATIVE_CALLING_CONVENTION OpenPackedData(
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmPackedData EBM_NATIVE_CALLING_CONVENTION CreatePackedData(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmPackedData EBM_NATIVE_CALLING_CONVENTION CreatePackedDataFromColumns(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples,
+   const EbmNativeBinnedColumn * columns
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmPackedDataBuilder EBM_NATIVE_CALLING_CONVENTION BeginPackedData(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   IntEbmType countSamples
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendPackedData(
+   PEbmPackedDataBuilder packedDataBuilder,
+   IntEbmType countSamples,
+   const EbmNativeBinnedColumn * columns
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmPackedData EBM_NATIVE_CALLING_CONVENTION FinishPackedData(
+   PEbmPackedDataBuilder packedDataBuilder
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreePackedDataBuilder(
+   PEbmPackedDataBuilder packedDataBuilder
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SavePackedData(
+   PEbmPackedData packedData,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION ClosePackedData(
+   PEbmPackedData packedData
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdate(
    PEbmBoosting ebmBoosting, 
    IntEbmType indexFeatureGroup, 
@@ -347,6 +790,39 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Ge
    const FloatEbmType * validationWeights, 
    FloatEbmType * gainOut
 );
+// GenerateModelFeatureGroupUpdateSlot is GenerateModelFeatureGroupUpdate with the update built in slot indexSlot 
+// instead of slot 0.  indexSlot must be less than TempParamBoostingConcurrentSlots.  Calls on different slots for 
+// different feature groups can run at the same time on separate threads, since they only read the shared residuals.  
+// They must not overlap with ApplyModelFeatureGroupUpdate or any other call on the same booster, and with a histogram 
+// reduce function every node still needs to make the same calls in the same order.  The returned tensor is owned by 
+// the slot and stays valid until the next call on that slot, so the caller can apply the updates of several slots 
+// afterwards in whichever order it chooses
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdateSlot(
+   PEbmBoosting ebmBoosting, 
+   IntEbmType indexSlot, 
+   IntEbmType indexFeatureGroup, 
+   FloatEbmType learningRate, 
+   IntEbmType countTreeSplitsMax, 
+   IntEbmType countSamplesRequiredForChildSplitMin, 
+   const FloatEbmType * trainingWeights, 
+   const FloatEbmType * validationWeights, 
+   FloatEbmType * gainOut
+);
+// GenerateModelFeatureGroupUpdateSlots generates the update of feature group indexesFeatureGroup[i] in slot i for the
+// first countSlots slots, exactly as GenerateModelFeatureGroupUpdateSlot would.  The histograms of all the main 
+// effects in the batch are built in a single pass over the training samples of each bag, which keeps the residuals in
+// cache instead of reading them once per feature group.  modelFeatureGroupUpdateTensorsOut receives the tensor of each 
+// slot, and gainsOut, which can be nullptr, the gain of each slot.  Returns 0 on success
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateModelFeatureGroupUpdateSlots(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSlots,
+   const IntEbmType * indexesFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   FloatEbmType ** modelFeatureGroupUpdateTensorsOut,
+   FloatEbmType * gainsOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ApplyModelFeatureGroupUpdate(
    PEbmBoosting ebmBoosting, 
    IntEbmType indexFeatureGroup, 
@@ -363,6 +839,108 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Boosti
    const FloatEbmType * validationWeights,
    FloatEbmType * validationMetricOut
 );
+// BoostingRun calls BoostingStep on every feature group in order for up to countRoundsMax rounds, or only on the 
+// groups that TempParamBoostingScheduleGainFraction schedules for each round.  After each round
+// it stops early if earlyStoppingRounds is non-negative and that many rounds in a row have not improved the best
+// validation metric by more than earlyStoppingTolerance.  progressFunction can be nullptr.  Otherwise it is called
+// after each round with the index of the round and the best validation metric so far, and returning non-zero from
+// it stops boosting.  validationMetricOut receives the best validation metric and indexRoundOut the index of the
+// last round that completed (0 if there were no rounds).  Returns 0 on success
+typedef IntEbmType (EBM_NATIVE_CALLING_CONVENTION * BOOSTING_PROGRESS_FUNCTION)(
+   IntEbmType indexRound,
+   FloatEbmType validationMetric,
+   void * progressContext
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION BoostingRun(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countRoundsMax,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType earlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   BOOSTING_PROGRESS_FUNCTION progressFunction,
+   void * progressContext,
+   FloatEbmType * validationMetricOut,
+   IntEbmType * indexRoundOut
+);
+// AppendBoostingTrainingSamples* adds countSamples training samples to a booster without rebuilding it, which lets 
+// a model trained on historical data be updated with a new batch of samples by calling BoostingRun for a bounded 
+// number of rounds afterwards.  binnedData, targets and predictorScores have the layout of the training samples of 
+// InitializeBoosting*.  The new samples start from predictorScores plus the scores of the current model, so 
+// predictorScores holds only the initial scores, like those given to InitializeBoosting*, and can be nullptr for 
+// zeros.  The existing samples keep their scores, the validation samples and the best model are unchanged, and the 
+// bags are redrawn over all of the training samples.  The booster cannot have packed data, sample masks, weights 
+// or deduplicated training samples.  Returns 0 on success, and on error the booster keeps its previous samples
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendBoostingTrainingSamplesClassification(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const IntEbmType * targets,
+   const FloatEbmType * predictorScores
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION AppendBoostingTrainingSamplesRegression(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countSamples,
+   const IntEbmType * binnedData,
+   const FloatEbmType * targets,
+   const FloatEbmType * predictorScores
+);
+// SetBoostingHistogramReduce lets several boosters on separate nodes train a single model when each node holds a 
+// different shard of the training samples.  Each node creates its booster with the same features, feature groups, 
+// inner bag count, random seed and parameters, and each one then calls BoostingStep with the same arguments in the same 
+// order.  Before looking for splits, every histogram is passed to reduceFunction, which must replace the countValues 
+// items in values with their elementwise sum over all the nodes (an all-reduce) and return 0, or return non-zero to 
+// fail the step.  For each histogram bucket the values hold the count of samples in the bucket followed by the sum of 
+// the residuals of each score, and for classification the sum of the denominators of each score after its residual.  
+// Since every node sees the same sums, every node makes the same model update and no broadcast of the model is needed.  
+// The validation metric and the best model only cover the validation samples of the local node, so early stopping 
+// needs to be decided the same way on every node.  Every node needs at least one training sample.  A nullptr 
+// reduceFunction goes back to boosting on the local samples alone.  Returns 0 on success
+typedef IntEbmType (EBM_NATIVE_CALLING_CONVENTION * HISTOGRAM_REDUCE_FUNCTION)(
+   IntEbmType countValues,
+   FloatEbmType * values,
+   void * reduceContext
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SetBoostingHistogramReduce(
+   PEbmBoosting ebmBoosting,
+   HISTOGRAM_REDUCE_FUNCTION reduceFunction,
+   void * reduceContext
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmWork EBM_NATIVE_CALLING_CONVENTION BoostingStepAsync(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   const FloatEbmType * trainingWeights,
+   const FloatEbmType * validationWeights
+);
+// FinishWork returns the best validation metric of the run through metricOut, and indexRoundOut receives the index 
+// of the last round that completed once the work is done
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmWork EBM_NATIVE_CALLING_CONVENTION BoostingRunAsync(
+   PEbmBoosting ebmBoosting,
+   IntEbmType countRoundsMax,
+   FloatEbmType learningRate,
+   IntEbmType countTreeSplitsMax,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType earlyStoppingRounds,
+   FloatEbmType earlyStoppingTolerance,
+   BOOSTING_PROGRESS_FUNCTION progressFunction,
+   void * progressContext,
+   IntEbmType * indexRoundOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION WaitForWork(
+   IntEbmType countWorks,
+   const PEbmWork * works, /* nullptr entries are ignored */
+   IntEbmType isWaitAll,
+   IntEbmType * indexCompletedOut /* lowest index of a completed work, or -1 if works has no non-nullptr entries */
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION FinishWork(
+   PEbmWork work,
+   FloatEbmType * metricOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ShutdownThreadPool(void);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION GetBestModelFeatureGroup(
    PEbmBoosting ebmBoosting, 
    IntEbmType indexFeatureGroup
@@ -371,10 +949,63 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE FloatEbmType * EBM_NATIVE_CALLING_CONVENTION Ge
    PEbmBoosting ebmBoosting,
    IntEbmType indexFeatureGroup
 );
+// CopyBestModelFeatureGroup and CopyCurrentModelFeatureGroup write the tensor that GetBestModelFeatureGroup or 
+// GetCurrentModelFeatureGroup would return into the caller's tensorOut, so the caller can fill an array that it owns 
+// in whatever layout it uses.  countBytesStrides holds the byte distance between neighbouring bins of each feature 
+// in the feature group, in feature group order, followed by the byte distance between the scores of a cell.  Strides 
+// can be negative, and every value they address needs to be aligned for FloatEbmType.  countBytesStrides can be 
+// nullptr to write the layout that GetBestModelFeatureGroup returns.  Nothing is written for classification with 
+// fewer than 2 target classes, which has no scores.  Returns 0 on success
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CopyBestModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   const IntEbmType * countBytesStrides,
+   FloatEbmType * tensorOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CopyCurrentModelFeatureGroup(
+   PEbmBoosting ebmBoosting,
+   IntEbmType indexFeatureGroup,
+   const IntEbmType * countBytesStrides,
+   FloatEbmType * tensorOut
+);
+// MergeBestModelFeatureGroup combines the best models of one feature group from several boosters, typically trained 
+// on different bags of the same data.  meanOut and standardDeviationOut receive, in the layout that 
+// GetBestModelFeatureGroup returns, the mean and the population standard deviation of every score across the 
+// boosters.  standardDeviationOut can be nullptr.  The boosters need the same learning type and the same number of 
+// bins in each feature of the feature group.  Nothing is written for classification with fewer than 2 target classes.
+// Returns 0 on success
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION MergeBestModelFeatureGroup(
+   IntEbmType countBoosters,
+   const PEbmBoosting * ebmBoostings,
+   IntEbmType indexFeatureGroup,
+   FloatEbmType * meanOut,
+   FloatEbmType * standardDeviationOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeBoosting(
    PEbmBoosting ebmBoosting
 );
 
+// the hot paths that GetPerformanceCounters reports on.  The library only keeps these counters when it is compiled 
+// with EBM_PERFORMANCE_COUNTERS defined, since timing every call has a cost
+const IntEbmType PerformanceCounterBinBoosting = 0; // building the histograms of the training set
+const IntEbmType PerformanceCounterSumHistogramBuckets = 1; // totalling the histogram of a single feature
+const IntEbmType PerformanceCounterTensorTotalsBuild = 2; // building the cumulative totals of a pair histogram
+const IntEbmType PerformanceCounterGrowDecisionTree = 3; // growing the tree of a single feature
+const IntEbmType PerformanceCounterFindBestBoostingSplitsPairs = 4; // choosing the cuts of a pair
+const IntEbmType PerformanceCounterApplyModelUpdateTraining = 5; // updating the residuals of the training set
+const IntEbmType PerformanceCounterApplyModelUpdateValidation = 6; // updating the scores and metric of the validation set
+
+// the counters accumulate from InitializeBoosting*.  The bytes scanned are the samples, or the histogram buckets, that 
+// the calls read.  Any of the outputs can be nullptr.  Returns 0 on success, or non-zero and zeros the outputs if the 
+// library was compiled without EBM_PERFORMANCE_COUNTERS.  This can't be called while ebmBoosting has work in progress
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GetPerformanceCounters(
+   PEbmBoosting ebmBoosting,
+   IntEbmType performanceCounter,
+   IntEbmType * countCallsOut,
+   IntEbmType * countNanosecondsOut,
+   IntEbmType * countBytesScannedOut
+);
+
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmInteraction EBM_NATIVE_CALLING_CONVENTION InitializeInteractionClassification(
    IntEbmType countTargetClasses,
@@ -395,6 +1026,17 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmInteraction EBM_NATIVE_CALLING_CONVENTION I
    const FloatEbmType * predictorScores,
    const FloatEbmType * optionalTempParams
 );
+// InitializeInteractionFromBoosting scores interactions on the training set of ebmBoosting with its current residuals, 
+// which skips binning the data again and recomputing the residuals from the predictor scores.  The features keep the 
+// indexes that they have in ebmBoosting.  The bins of each feature are read from a feature group that contains it, so 
+// every feature with more than one bin must be in at least one feature group, and single feature groups are the 
+// fastest to read.  A training sample with weight w counts as w samples.  The returned PEbmInteraction holds its own 
+// copies and is independent of ebmBoosting afterwards, but it can't be created while ebmBoosting has work in 
+// progress.  Free it with FreeInteraction
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmInteraction EBM_NATIVE_CALLING_CONVENTION InitializeInteractionFromBoosting(
+   PEbmBoosting ebmBoosting,
+   const FloatEbmType * optionalTempParams
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScore(
    PEbmInteraction ebmInteraction, 
    IntEbmType countFeaturesInGroup, 
@@ -402,6 +1044,40 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Calcul
    IntEbmType countSamplesRequiredForChildSplitMin,
    FloatEbmType * interactionScoreOut
 );
+// CalculateInteractionScorePairs scores many pairs at once.  featureIndexPairs holds countPairs pairs of feature
+// indexes back to back, and interactionScoresOut receives one score per pair.  Each score is identical to what
+// CalculateInteractionScore returns for the same pair.  Pairs that share their first feature are binned in a single
+// pass over the samples, and the passes are spread across the thread pool.  If ebmInteraction was initialized with
+// TempParamInteractionScreenSamples, every pair is first scored on the screening samples and only the best
+// TempParamInteractionScreenCandidates of them are scored on all the samples.  Those get the same scores as 
+// CalculateInteractionScore, and the pairs that the screening rejected get a score of 0.  CalculateInteractionScore and
+// CalculateInteractionScorePairs share per thread buffers that belong to ebmInteraction, so calls on the same
+// ebmInteraction must not overlap
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScorePairs(
+   PEbmInteraction ebmInteraction,
+   IntEbmType countPairs,
+   const IntEbmType * featureIndexPairs,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   FloatEbmType * interactionScoresOut
+);
+// CalculateInteractionScoreTopPairs finds the best countTopPairs pairs of featureIndexPairs.  topPairIndexesOut 
+// receives the indexes of the pairs within featureIndexPairs and topInteractionScoresOut their scores, which are 
+// identical to what CalculateInteractionScore returns for them.  The pairs are in order of decreasing score, with ties 
+// going to the lower index, and there are fewer of them if countPairs is smaller than countTopPairs.  After binning a 
+// pair we compute a bound on its score from its histogram, and once we have found countTopPairs scores we skip 
+// searching the cuts of pairs whose bound can't beat the worst of them.  Scores on the marginal histograms of single
+// features aren't a bound, since a pair can interact without either feature having a main effect, so every pair is
+// still binned.  TempParamInteractionScreenSamples is ignored here, and the same calls can't overlap as for 
+// CalculateInteractionScorePairs
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION CalculateInteractionScoreTopPairs(
+   PEbmInteraction ebmInteraction,
+   IntEbmType countPairs,
+   const IntEbmType * featureIndexPairs,
+   IntEbmType countSamplesRequiredForChildSplitMin,
+   IntEbmType countTopPairs,
+   IntEbmType * topPairIndexesOut,
+   FloatEbmType * topInteractionScoresOut
+);
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeInteraction(
    PEbmInteraction ebmInteraction
 );
@@ -443,6 +1119,94 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION GenerateUnif
    IntEbmType * countPositiveInfinityOut
 );
 
+const IntEbmType BinningTypeQuantile = 0; // GenerateQuantileBinCuts
+const IntEbmType BinningTypeWinsorized = 1; // GenerateWinsorizedBinCuts
+const IntEbmType BinningTypeUniform = 2; // GenerateUniformBinCuts
+
+// GenerateBinCutsFeatures generates the cuts of countFeatures features at once with the single feature function that
+// binningType selects, and spreads the features across the thread pool.  Each feature gets the same cuts that the
+// single feature function would give it.
+// - featureValues is column major with countSamples values per feature, and it is not modified
+// - countSamplesPerBinMin, isHumanized and randomSeed are only used by BinningTypeQuantile
+// - countBinCutsInOut holds the maximum number of cuts of each feature, and receives the number of cuts generated
+// - binCutsLowerBoundInclusiveOut needs room for the sum of the maximums, and receives the cuts of all the features
+//   back to back in the format that DiscretizeFeatures accepts
+// - countMissingValuesOut through countPositiveInfinityOut receive one value per feature and can be nullptr
+// If any feature fails we return non-zero, and the features that failed have no cuts
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateBinCutsFeatures(
+   IntEbmType binningType,
+   IntEbmType countSamples,
+   IntEbmType countFeatures,
+   const FloatEbmType * featureValues,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+);
+
+// A PEbmQuantileSketch summarizes the values of one feature in bounded memory, so that quantile cuts can be generated
+// for columns that are too large to copy and sort.  The values are streamed in with AddToQuantileSketch in chunks of
+// any size, and sketches built on other threads or machines can be combined with MergeQuantileSketch.
+// - countItemsPerLevel sets the accuracy.  The sketch holds about countItemsPerLevel * log2(countSamples /
+//   countItemsPerLevel) values, and its rank error shrinks proportionally to 1 / countItemsPerLevel.  Until
+//   countItemsPerLevel non-missing values are added, GenerateQuantileBinCutsFromSketch returns exactly the same cuts
+//   as GenerateQuantileBinCuts
+// - MergeQuantileSketch adds the values of quantileSketchOther, which is unchanged, to quantileSketch.  Both need the
+//   same countItemsPerLevel
+// - SerializeQuantileSketch writes GetQuantileSketchSerializedSize bytes in the native byte order, and
+//   DeserializeQuantileSketch creates a new sketch from them
+// - GenerateQuantileBinCutsFromSketch has the same parameters as GenerateQuantileBinCuts, and the missing value,
+//   infinity and min/max outputs are exact
+// - after a failed AddToQuantileSketch or MergeQuantileSketch the sketch can only be freed
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmQuantileSketch EBM_NATIVE_CALLING_CONVENTION CreateQuantileSketch(
+   IntEbmType countItemsPerLevel,
+   IntEbmType randomSeed
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION AddToQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION MergeQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   PEbmQuantileSketch quantileSketchOther
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GetQuantileSketchSerializedSize(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType * countBytesOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SerializeQuantileSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countBytes,
+   void * bufferOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmQuantileSketch EBM_NATIVE_CALLING_CONVENTION DeserializeQuantileSketch(
+   IntEbmType countBytes,
+   const void * buffer
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION GenerateQuantileBinCutsFromSketch(
+   PEbmQuantileSketch quantileSketch,
+   IntEbmType countSamplesPerBinMin,
+   IntEbmType isHumanized,
+   IntEbmType randomSeed,
+   IntEbmType * countBinCutsInOut,
+   FloatEbmType * binCutsLowerBoundInclusiveOut,
+   IntEbmType * countMissingValuesOut,
+   FloatEbmType * minNonInfinityValueOut,
+   IntEbmType * countNegativeInfinityOut,
+   FloatEbmType * maxNonInfinityValueOut,
+   IntEbmType * countPositiveInfinityOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION FreeQuantileSketch(
+   PEbmQuantileSketch quantileSketch
+);
+
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Discretize(
    IntEbmType countSamples,
    const FloatEbmType * featureValues,
@@ -450,6 +1214,214 @@ EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION Discre
    const FloatEbmType * binCutsLowerBoundInclusive,
    IntEbmType * discretizedOut
 );
+// discretizes countFeatures features at once.  featureValues and discretizedOut are column major (all the samples of
+// the first feature, then all the samples of the second feature, etc).  countBinCuts holds the number of cuts for each
+// feature, and binCutsLowerBoundInclusive holds the cuts of all the features back to back
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION DiscretizeFeatures(
+   IntEbmType countSamples,
+   IntEbmType countFeatures,
+   const FloatEbmType * featureValues,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType * discretizedOut
+);
+
+// PredictBatchClassification and PredictBatchRegression score a trained model on raw feature values.  They discretize
+// the values, look up and sum the feature group tensors and apply the link function in a single multithreaded pass.
+// - features and featureGroups/featureGroupIndexes are in the same format as we accept for boosting.  Only countBins
+//   is used from the features.  Samples that discretize to a bin at or above countBins (such as missing values when
+//   the model has no bin for them) contribute nothing for the feature groups that include that feature
+// - countBinCuts and binCutsLowerBoundInclusive are in the same format that DiscretizeFeatures accepts
+// - modelFeatureGroupTensors holds the tensors of all feature groups back to back, each in the format that
+//   GetBestModelFeatureGroup returns
+// - intercept holds one value per logit and can be nullptr if it's zero
+// - featureValues is column major with countSamples values per feature
+// - probabilitiesOut receives countTargetClasses probabilities per sample, and predictionsOut one value per sample
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictBatchClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * probabilitiesOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictBatchRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * predictionsOut
+);
+
+// ExplainBatchClassification and ExplainBatchRegression take the same model and samples as PredictBatchClassification
+// and PredictBatchRegression, but write the local explanation of each sample instead of its prediction.  The 
+// explanation of a sample holds, for each feature group in order, the logits (or the regression score) that the 
+// feature group adds to the sample, followed by the intercept.  Feature groups that the sample is outside of 
+// contribute zeros.  The values of an explanation sum to the logits before the link function is applied.
+// - explanationsOut receives (countFeatureGroups + 1) * cVectorLength values per sample, where cVectorLength is 1 for
+//   regression and binary classification and countTargetClasses otherwise.  Nothing is written for 1 class
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainBatchClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * explanationsOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ExplainBatchRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * explanationsOut
+);
+
+// ScoreModelVariantsClassification and ScoreModelVariantsRegression evaluate many variants of one model on a 
+// labelled data set in a single pass over the samples.  A variant keeps some of the feature groups of the model and 
+// drops the others, which is what backward feature group elimination and ablations need.
+// - targets holds countSamples target classes, or regression targets
+// - variantFeatureGroups holds countFeatureGroups items for each of the countVariants variants.  A non-zero item 
+//   keeps that feature group in that variant
+// - metricsOut receives, for each variant, the average log loss of the samples for classification, or their mean 
+//   squared error for regression.  A variant that keeps every feature group scores the predictions of 
+//   PredictBatchClassification or PredictBatchRegression exactly
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ScoreModelVariantsClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const IntEbmType * targets,
+   IntEbmType countVariants,
+   const IntEbmType * variantFeatureGroups,
+   FloatEbmType * metricsOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION ScoreModelVariantsRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   const FloatEbmType * targets,
+   IntEbmType countVariants,
+   const IntEbmType * variantFeatureGroups,
+   FloatEbmType * metricsOut
+);
+
+// MODEL FILES
+// - SaveModelClassification and SaveModelRegression write a model in the format that PredictBatchClassification and 
+//   PredictBatchRegression accept to a versioned binary file.  intercept can be nullptr if it's zero
+// - SaveBoostingModel writes the best model of a booster, with the bin cuts and intercept of our caller.  Features 
+//   with 1 bin are left out of the saved feature groups like they are during boosting, so samples with an unknown 
+//   bin in such a feature still get the scores of the rest of their feature groups
+// - OpenModel maps a model file read-only and checks it once, so PredictModel scores straight out of the mapping 
+//   without copying the tensors.  Several threads can call PredictModel on the same model at once, but not while 
+//   CloseModel is freeing it.  Files are only readable by builds with the same byte order and binary logits
+// - PredictModel is PredictBatchClassification or PredictBatchRegression with the model of the file, and predictionsOut 
+//   receives the same values
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveModelClassification(
+   IntEbmType countTargetClasses,
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveModelRegression(
+   IntEbmType countFeatures,
+   const EbmNativeFeature * features,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   IntEbmType countFeatureGroups,
+   const EbmNativeFeatureGroup * featureGroups,
+   const IntEbmType * featureGroupIndexes,
+   const FloatEbmType * modelFeatureGroupTensors,
+   const FloatEbmType * intercept,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingModel(
+   PEbmBoosting ebmBoosting,
+   const IntEbmType * countBinCuts,
+   const FloatEbmType * binCutsLowerBoundInclusive,
+   const FloatEbmType * intercept,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE PEbmModel EBM_NATIVE_CALLING_CONVENTION OpenModel(
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION PredictModel(
+   PEbmModel model,
+   IntEbmType countSamples,
+   const FloatEbmType * featureValues,
+   FloatEbmType * predictionsOut
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION CloseModel(
+   PEbmModel model
+);
+
+// BOOSTING CHECKPOINTS
+// - SaveBoostingCheckpoint writes the current and best models, the best validation metric, the random streams of 
+//   the bags, the feature group schedule of BoostingRun and the residuals and predictor scores of a booster.  We don't write the file atomically, so write each 
+//   checkpoint to a new path and rename it over the previous one once SaveBoostingCheckpoint returns 0
+// - LoadBoostingCheckpoint restores a booster that was initialized with the same data, parameters and random seed 
+//   as the one that saved the checkpoint, and boosting then continues with results that are identical to never 
+//   having stopped.  The booster is left unchanged if the checkpoint doesn't match it
+// - a model update that was generated but not yet applied isn't part of a checkpoint.  Boosters that defer their 
+//   validation need to get the validation metric before saving
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION SaveBoostingCheckpoint(
+   PEbmBoosting ebmBoosting,
+   const char * filePath
+);
+EBM_NATIVE_IMPORT_EXPORT_INCLUDE IntEbmType EBM_NATIVE_CALLING_CONVENTION LoadBoostingCheckpoint(
+   PEbmBoosting ebmBoosting,
+   const char * filePath
+);
 
 EBM_NATIVE_IMPORT_EXPORT_INCLUDE void EBM_NATIVE_CALLING_CONVENTION SuggestGraphBounds(
    IntEbmType countBinCuts,